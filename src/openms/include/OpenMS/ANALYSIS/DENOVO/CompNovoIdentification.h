@@ -75,7 +75,7 @@ public:
     /** @name Accessors
      */
     //@{
-    /// performs an ProteinIdentification run on a PeakMap
+    /// performs an ProteinIdentification run on a PeakMap (spectra are processed in parallel if OpenMP is enabled)
     void getIdentifications(std::vector<PeptideIdentification> & ids, const PeakMap & exp) override;
 
     /// performs an ProteinIdentification run on a PeakSpectrum
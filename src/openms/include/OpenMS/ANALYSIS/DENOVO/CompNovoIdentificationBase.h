@@ -45,6 +45,8 @@
 #include <OpenMS/ANALYSIS/DENOVO/CompNovoIonScoringBase.h>
 
 // stl includes
+#include <map>
+#include <memory>
 #include <vector>
 
 namespace OpenMS
@@ -102,6 +104,15 @@ protected:
     /// produces mass decompositions using the given mass
     void getDecompositions_(std::vector<MassDecomposition> & decomps, double mass, bool no_caching = false);
 
+    /**
+      @brief produces mass decompositions using the given mass and tolerance
+
+      Unless @p no_caching is set, the mass is quantized to multiples of "decomp_weights_precision" and the
+      decompositions are looked up in (or added to) the decomposition cache, which is shared by all copies of
+      this instance (within getIdentifications) and safe to use from multiple threads.
+    */
+    void getDecompositions_(std::vector<MassDecomposition> & decomps, double mass, double tolerance, bool no_caching);
+
     /// permuts the String s adds the prefix and stores the results in permutations
     void permute_(String prefix, String s, std::set<String> & permutations);
 
@@ -171,7 +182,11 @@ protected:
 
     Size max_isotope_;
 
-    Map<double, std::vector<MassDecomposition> > decomp_cache_;
+    /// cache of filtered decompositions: (quantized mass, tolerance) -> decompositions
+    typedef std::map<std::pair<Int64, double>, std::vector<MassDecomposition> > DecompositionCache;
+
+    /// decomposition cache (shared with the per-thread copies used in getIdentifications, reset when parameters change)
+    std::shared_ptr<DecompositionCache> decomp_cache_;
 
     Map<String, std::set<String> > permute_cache_;
 
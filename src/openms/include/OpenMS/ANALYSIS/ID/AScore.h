@@ -158,6 +158,15 @@ namespace OpenMS
     /// Computes number of matched ions between windows and the given spectrum. All spectra have to be sorted by position!
     Size numberOfMatchedIons_(const PeakSpectrum& th, const PeakSpectrum& windows, Size depth) const;
 
+    /// Computes number of matched ions between a window (already reduced to the peak depth and sorted by position) and the given spectrum.
+    Size numberOfMatchedIons_(const PeakSpectrum& th, const PeakSpectrum& window_reduced) const;
+
+    /// Computes number of matched ions between all windows (already reduced to the peak depth and sorted by position) and the given spectrum.
+    Size numberOfMatchedIons_(const PeakSpectrum& th, const std::vector<PeakSpectrum>& windows_reduced) const;
+
+    /// Reduce the windows to the top 1 to 10 peaks (result index: depth - 1), each window sorted by position
+    std::vector<std::vector<PeakSpectrum>> reduceWindows_(const std::vector<PeakSpectrum>& windows_top10) const;
+
     /// Computes the peptide score according to Beausoleil et al. page 1291
     double peptideScore_(const std::vector<double>& scores) const;
 
@@ -176,7 +185,7 @@ namespace OpenMS
     /// Create variant of the peptide with all phosphorylations removed
     AASequence removePhosphositesFromSequence_(const String sequence) const;
     
-    /// Create theoretical spectra with all combinations with the number of phosphorylation events
+    /// Create theoretical spectra with all combinations with the number of phosphorylation events (the fragment ladder is computed once and shifted for each combination)
     std::vector<PeakSpectrum> createTheoreticalSpectra_(const std::vector<std::vector<Size>>& permutations, const AASequence& seq_without_phospho) const;
     
     /// Pick top 10 intensity peaks for each 100 Da windows
@@ -184,6 +193,9 @@ namespace OpenMS
     
     /// Create 10 scores for each theoretical spectrum (permutation), according to Beausoleil et al. Figure 3 b
     std::vector<std::vector<double>> calculatePermutationPeptideScores_(std::vector<PeakSpectrum>& th_spectra, const std::vector<PeakSpectrum>& windows_top10) const;
+
+    /// Create 10 scores for each theoretical spectrum (permutation), based on the windows reduced to each peak depth (see reduceWindows_())
+    std::vector<std::vector<double>> calculatePermutationPeptideScores_(const std::vector<PeakSpectrum>& th_spectra, const std::vector<std::vector<PeakSpectrum>>& windows_by_depth) const;
     
     /// Rank weighted permutation scores ascending
     std::multimap<double, Size> rankWeightedPermutationPeptideScores_(const std::vector<std::vector<double>>& peptide_site_scores) const;
@@ -263,11 +263,41 @@ public:
     /// Default destructor
     ~AccurateMassSearchEngine() override;
 
+    /// A database match of a batched query (see queryByMZ() for several m/z values)
+    struct MassMatch
+    {
+      Size query; ///< index of the query
+      Size adduct; ///< index of the adduct (in the adduct list of the ion mode)
+      Size db_entry; ///< index of the database entry (as AccurateMassSearchResult::getMatchingIndex())
+      double query_mass; ///< neutral mass of the query for the adduct
+      double calculated_mz; ///< m/z of the database entry with the adduct
+      double mz_error_ppm; ///< m/z error (observed vs. calculated) in ppm
+    };
+
     /**
       @brief search for a specific observed mass by enumerating all possible adducts and search M+X against database
 
        */
     void queryByMZ(const double& observed_mz, const Int& observed_charge, const String& ion_mode, std::vector<AccurateMassSearchResult>& results) const;
+
+    /**
+      @brief search for many observed masses at once
+
+      The queries are sorted by m/z and merged with the (sorted) database for
+      each adduct, which is much faster than searching each mass separately.
+      The matches are compact records that refer to the query, adduct and
+      database entry by index; they are ordered by query and (for each query)
+      as the results of the single query.
+
+      @param observed_mzs Observed m/z values
+      @param observed_charges Charges of the observed m/z values (0 for unknown)
+      @param ion_mode Ion mode ('positive' or 'negative')
+      @param matches The matches (not found masses are not reported)
+
+      @exception Exception::IllegalArgument is thrown if init() was not called or the two input vectors differ in size
+      @exception Exception::InvalidParameter is thrown if the ion mode is invalid
+    */
+    void queryByMZ(const std::vector<double>& observed_mzs, const std::vector<Int>& observed_charges, const String& ion_mode, std::vector<MassMatch>& matches) const;
     void queryByFeature(const Feature& feature, const Size& feature_index, const String& ion_mode, std::vector<AccurateMassSearchResult>& results) const;
     void queryByConsensusFeature(const ConsensusFeature& cfeat, const Size& cf_index, const Size& number_of_maps, const String& ion_mode, std::vector<AccurateMassSearchResult>& results) const;
 
@@ -338,6 +368,22 @@ private:
     void parseAdductsFile_(const String& filename, std::vector<AdductInfo>& result);
     void searchMass_(double neutral_query_mass, double diff_mass, std::pair<Size, Size>& hit_indices) const;
 
+    /// adducts of an ion mode ('positive' or 'negative')
+    /// @throw InvalidParameter for other ion modes
+    const std::vector<AdductInfo>& getAdducts_(const String& ion_mode) const;
+
+    /// converts a match of a batched query into a search result
+    AccurateMassSearchResult createResult_(const MassMatch& match, double observed_mz, const std::vector<AdductInfo>& adducts) const;
+
+    /// the 'not-found' indicator result (see parameter keep_unidentified_masses)
+    AccurateMassSearchResult createNotFoundResult_(double observed_mz, Int observed_charge) const;
+
+    /// adds the meta data of a feature to its search results
+    void addFeatureInfo_(const Feature& feature, Size feature_index, std::vector<AccurateMassSearchResult>& results) const;
+
+    /// adds the meta data of a consensus feature to its search results
+    void addConsensusFeatureInfo_(const ConsensusFeature& cfeat, Size cf_index, Size number_of_maps, std::vector<AccurateMassSearchResult>& results) const;
+
     /// add search results to a Consensus/Feature
     void annotate_(const std::vector<AccurateMassSearchResult>&, BaseFeature&) const;
 
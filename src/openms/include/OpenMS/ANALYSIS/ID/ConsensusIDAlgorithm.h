@@ -71,6 +71,19 @@ namespace OpenMS
     void apply(std::vector<PeptideIdentification>& ids, 
                Size number_of_runs = 0);
 
+    /**
+        @brief Calculates the consensus IDs for several sets of peptide identifications (e.g. for all spectra or features of a map).
+
+        The results are the same as when calling apply() for each set in turn, but work that can be shared between the sets is done for all of them beforehand - in parallel, if OpenMP is available. (The similarity-based algorithms compute all required sequence similarities at this stage.)
+
+        @param id_sets Peptide identifications of each spectrum or feature (see apply())
+        @param number_of_runs Number of ID runs for each set (if empty, the default of apply() is used for all sets)
+
+        @throw Exception::IllegalArgument if @p number_of_runs is neither empty nor of the same size as @p id_sets
+    */
+    void apply(std::vector<std::vector<PeptideIdentification>*>& id_sets,
+               const std::vector<Size>& number_of_runs = std::vector<Size>());
+
     /// Virtual destructor
     ~ConsensusIDAlgorithm() override;
 
@@ -103,6 +116,15 @@ namespace OpenMS
     virtual void apply_(std::vector<PeptideIdentification>& ids,
                         SequenceGrouping& results) = 0;
 
+    /**
+       @brief Preparations shared by several sets of peptide identifications (called by the batch version of apply(), after sorting/filtering the hits).
+
+       Derived classes can use this to precompute data for all sets at once. The default implementation does nothing.
+
+       @param id_sets Peptide identifications of each spectrum or feature
+    */
+    virtual void precompute_(const std::vector<std::vector<PeptideIdentification>*>& id_sets);
+
     /// Docu in base class
     void updateMembers_() override;
 
@@ -117,6 +139,13 @@ namespace OpenMS
     /// Not implemented
     ConsensusIDAlgorithm& operator=(const ConsensusIDAlgorithm&);
 
+    /// Sorts the peptide hits and removes those not considered for scoring (and duplicates)
+    void prepareIDs_(std::vector<PeptideIdentification>& ids) const;
+
+    /// Consensus computation for IDs prepared by prepareIDs_()
+    void computeConsensus_(std::vector<PeptideIdentification>& ids,
+                           Size number_of_runs);
+
   };
 
 } // namespace OpenMS
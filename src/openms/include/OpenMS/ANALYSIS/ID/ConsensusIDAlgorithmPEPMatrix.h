@@ -171,9 +171,6 @@ namespace OpenMS
     /// Similarity scoring method
     SeqAnScore scoring_method_;
 
-    /// Alignment data structure
-    ::seqan::Align<SeqAnSequence, ::seqan::ArrayGaps> alignment_;
-
     /// Not implemented
     ConsensusIDAlgorithmPEPMatrix(const ConsensusIDAlgorithmPEPMatrix&);
 
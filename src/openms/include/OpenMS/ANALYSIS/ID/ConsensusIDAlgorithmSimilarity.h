@@ -47,6 +47,8 @@ namespace OpenMS
 
     Derived classes should implement getSimilarity_(), which defines how similarity of two peptide sequences is quantified.
 
+    Sequence similarities are cached. When consensus IDs for many spectra/features are calculated at once (see ConsensusIDAlgorithm::apply() for several sets of IDs), all similarities that will be needed are computed beforehand - in parallel, if OpenMP is available.
+
     @htmlinclude OpenMS_ConsensusIDAlgorithmSimilarity.parameters
     
     @ingroup Analysis_ID
@@ -67,12 +69,20 @@ namespace OpenMS
     /**
        @brief Sequence similarity calculation (to be implemented by subclasses).
 
-       Implementations should use/update the cache of previously computed similarities.
+       Implementations should use/update the cache of previously computed similarities via getCachedSimilarity_() and cacheSimilarity_(). They are called from several threads at the same time and need to be thread-safe otherwise.
 
        @return Similarity between two sequences in the range [0, 1]
     */
     virtual double getSimilarity_(AASequence seq1, AASequence seq2) = 0;
 
+    /// Looks up a sequence similarity in the cache (thread-safe), returns whether it was found
+    bool getCachedSimilarity_(const std::pair<AASequence, AASequence>& seq_pair,
+                              double& similarity) const;
+
+    /// Stores a sequence similarity in the cache (thread-safe)
+    void cacheSimilarity_(const std::pair<AASequence, AASequence>& seq_pair,
+                          double similarity);
+
   private:
     /// Not implemented
     ConsensusIDAlgorithmSimilarity(const ConsensusIDAlgorithmSimilarity&);
@@ -83,6 +93,10 @@ namespace OpenMS
     /// Consensus scoring
     void apply_(std::vector<PeptideIdentification>& ids,
                         SequenceGrouping& results) override;
+
+    /// Computes the similarities of all sequences from different ID runs (in parallel)
+    void precompute_(const std::vector<std::vector<PeptideIdentification>*>&
+                     id_sets) override;
   };
 
 } // namespace OpenMS
@@ -99,6 +99,26 @@ public:
     */
     void apply(std::vector<ProteinIdentification> & ids) const;
 
+    /**
+        @brief Calculates q-values (or FDRs) for columns of scores and target/decoy labels
+
+        This is the engine behind all apply() methods. The (score, index)
+        pairs are sorted once (in parallel if OpenMP is available), the FDR
+        of each group of tied scores (#decoys / #targets with the same or a
+        better score) is computed in a single sweep and q-values are obtained
+        from a second, reverse sweep. Decoys get the value of the closest
+        target score (the worse one if both neighbors are equally close).
+
+        @param scores Scores of all hits
+        @param is_decoy Decoy flag of each hit (same size as @p scores)
+        @param higher_score_better Whether a higher score is better
+        @param q_value If false, strict FDRs are calculated instead of q-values
+        @param fdrs Output: the q-value/FDR of each hit, in the order of @p scores
+
+        @exception Exception::IllegalArgument is thrown if @p scores and @p is_decoy differ in size
+    */
+    static void calculateFDRs(const std::vector<double> & scores, const std::vector<bool> & is_decoy, bool higher_score_better, bool q_value, std::vector<double> & fdrs);
+
 private:
     ///Not implemented
     FalseDiscoveryRate(const FalseDiscoveryRate &);
@@ -106,9 +126,6 @@ private:
     ///Not implemented
     FalseDiscoveryRate & operator=(const FalseDiscoveryRate &);
 
-    /// calculates the fdr stored into fdrs, given two vectors of scores
-    void calculateFDRs_(Map<double, double> & score_to_fdr, std::vector<double> & target_scores, std::vector<double> & decoy_scores, bool q_value, bool higher_score_better) const;
-
   };
 
 } // namespace OpenMS
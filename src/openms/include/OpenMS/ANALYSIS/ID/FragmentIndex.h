@@ -0,0 +1,208 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2018.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: Hannes Roest $
+// $Authors: Hannes Roest $
+// --------------------------------------------------------------------------
+
+
+#pragma once
+
+#include <OpenMS/CHEMISTRY/TheoreticalSpectrumGenerator.h>
+#include <OpenMS/KERNEL/StandardTypes.h>
+#include <OpenMS/CONCEPT/Types.h>
+
+#include <vector>
+
+namespace OpenMS
+{
+  /**
+    @brief Fragment ion index for fast candidate selection in database searches
+
+    Instead of generating and scoring the theoretical spectrum of every
+    peptide within the precursor mass window of a spectrum, the fragment ions
+    of all peptides are computed once and stored in a table of fragment m/z
+    bins, each bin holding the fragments that fall into it ordered by the
+    precursor mass of their peptide. A spectrum is searched by looking up each
+    of its peaks in the bins within the fragment tolerance and counting the
+    matching fragments per peptide; only the (usually few) peptides of the
+    precursor mass window with enough matching peaks need to be scored. As the
+    work per peak only depends on the peptides actually sharing the fragment
+    m/z, this scales well to wide precursor windows (open searches) and to
+    searches with several precursor mass offsets.
+
+    Usage: add all peptides with addPeptide(), call build() and then query()
+    the index (concurrently, if needed). Peptides are identified by their
+    index in order of addition. The theoretical spectrum of a candidate can
+    be restored with getTheoreticalSpectrum() for scoring (e.g. with
+    HyperScore), so the scores are the same as without the index.
+
+    @note Fragment m/z values in the bins are stored in single precision,
+    the bin lookup therefore uses a slightly enlarged tolerance. The
+    theoretical spectra returned by getTheoreticalSpectrum() keep full
+    precision.
+
+    @ingroup ID
+  */
+  class OPENMS_DLLAPI FragmentIndex
+  {
+public:
+    /// A candidate peptide returned by query()
+    struct Candidate
+    {
+      /// Index of the peptide (in order of addition)
+      Size peptide;
+      /// Number of spectrum peaks matching a fragment of the peptide
+      Size matched_peaks;
+    };
+
+    /**
+      @brief Constructor
+
+      @param bin_size Width of the fragment m/z bins (in Th)
+
+      @exception Exception::IllegalArgument is thrown if @p bin_size is not positive
+    */
+    explicit FragmentIndex(double bin_size = 0.05);
+
+    /**
+      @brief Adds a peptide to the index
+
+      The theoretical spectrum (e.g. from TheoreticalSpectrumGenerator) needs
+      to carry the ion names as first StringDataArray ("add_metainfo"), only
+      the ion type (first character, e.g. 'b' or 'y') is kept.
+
+      @param precursor_mass The (uncharged) mass of the peptide
+      @param theo_spectrum The theoretical spectrum of the peptide
+      @return Index of the peptide
+
+      @exception Exception::IllegalArgument is thrown if the index is already built
+    */
+    Size addPeptide(double precursor_mass, const PeakSpectrum& theo_spectrum);
+
+    /**
+      @brief Adds a peptide to the index
+
+      Same as above, using the fragment ions generated by
+      TheoreticalSpectrumGenerator::getFragmentIons() (sorted by m/z).
+
+      @exception Exception::IllegalArgument is thrown if the index is already built
+    */
+    Size addPeptide(double precursor_mass, const std::vector<TheoreticalSpectrumGenerator::FragmentIon>& fragment_ions);
+
+    /// Builds the fragment table, needs to be called after all peptides are added and before query()
+    void build();
+
+    /// Returns whether build() was called
+    bool isBuilt() const;
+
+    /// Number of peptides
+    Size size() const;
+
+    /// Number of fragments of all peptides
+    Size getNumberOfFragments() const;
+
+    /// Width of the fragment m/z bins
+    double getBinSize() const;
+
+    /// Returns the mass of a peptide
+    double getPrecursorMass(Size peptide) const;
+
+    /**
+      @brief Restores the theoretical spectrum of a peptide
+
+      The spectrum is sorted by m/z and contains the original intensities and
+      a StringDataArray "IonNames" with the ion types of the fragments.
+    */
+    void getTheoreticalSpectrum(Size peptide, PeakSpectrum& theo_spectrum) const;
+
+    /**
+      @brief Finds the peptides of a precursor mass range matching a spectrum
+
+      A peak matches a fragment if their distance is below the fragment
+      tolerance (relative to the fragment m/z for ppm tolerances). Candidates
+      are appended to @p candidates in order of their precursor mass.
+
+      @param spectrum The spectrum (sorted by m/z, singly charged fragments)
+      @param precursor_mass_min Lower bound of the peptide mass
+      @param precursor_mass_max Upper bound of the peptide mass
+      @param fragment_mass_tolerance Fragment mass tolerance
+      @param fragment_mass_tolerance_unit_ppm Whether the tolerance is given in ppm
+      @param min_matched_peaks Minimal number of matching peaks of a candidate
+      @param candidates The matching peptides
+
+      @exception Exception::IllegalArgument is thrown if the index is not built
+    */
+    void query(const PeakSpectrum& spectrum,
+               double precursor_mass_min,
+               double precursor_mass_max,
+               double fragment_mass_tolerance,
+               bool fragment_mass_tolerance_unit_ppm,
+               Size min_matched_peaks,
+               std::vector<Candidate>& candidates) const;
+
+protected:
+    /// A fragment in the m/z bins
+    struct BinEntry_
+    {
+      /// Rank of the peptide by precursor mass
+      UInt32 rank;
+      /// m/z of the fragment
+      float mz;
+    };
+
+    /// Returns the bin of an m/z value
+    Size getBin_(double mz) const;
+
+    double bin_size_;
+    bool built_;
+
+    /// Precursor mass of each peptide (by index)
+    std::vector<double> precursor_masses_;
+    /// Start of the fragments of each peptide in fragment_mz_ (by index, one additional entry)
+    std::vector<Size> fragment_offsets_;
+    /// Fragment m/z values (by peptide index, sorted)
+    std::vector<double> fragment_mz_;
+    /// Fragment intensities
+    std::vector<float> fragment_intensities_;
+    /// Fragment ion types
+    std::vector<char> fragment_types_;
+
+    /// Peptide indices sorted by precursor mass
+    std::vector<UInt32> peptides_by_mass_;
+    /// Precursor masses sorted
+    std::vector<double> sorted_masses_;
+    /// Start of each m/z bin in bins_ (one additional entry)
+    std::vector<Size> bin_offsets_;
+    /// Fragments sorted by bin and peptide rank
+    std::vector<BinEntry_> bins_;
+  };
+
+}
@@ -50,6 +50,8 @@
 
 namespace OpenMS
 {
+  class BoundingBoxGrid;
+
   /**
     @brief Annotates an MSExperiment, FeatureMap or ConsensusMap with peptide identifications
 
@@ -383,6 +385,12 @@ protected:
     /// increase a bounding box by the given RT and m/z tolerances
     void increaseBoundingBox_(DBoundingBox<2>& box);
 
+    /// enlarges a bounding box, such that it contains all (RT, m/z) positions of peptides that can match the given position (see isMatch_())
+    void enlargeMatchBox_(DBoundingBox<2>& box, const double rt, const double mz) const;
+
+    /// finds the indexed boxes (features) that contain any of the positions (@p rt, @p mz_values), sorted by index
+    void getCandidates_(const BoundingBoxGrid& grid, const double rt, const DoubleList& mz_values, std::vector<Size>& candidates) const;
+
     /// try to determine the type of m/z value reported for features, return
     /// whether average peptide masses should be used for matching
     bool checkMassType_(const std::vector<DataProcessing>& processing) const;
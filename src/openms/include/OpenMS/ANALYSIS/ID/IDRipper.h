@@ -34,6 +34,7 @@
 #pragma once
 
 #include <OpenMS/DATASTRUCTURES/DefaultParamHandler.h>
+#include <OpenMS/DATASTRUCTURES/ListUtils.h>
 #include <OpenMS/METADATA/PeptideIdentification.h>
 #include <OpenMS/METADATA/ProteinIdentification.h>
 
@@ -72,6 +73,26 @@ public:
     */
     void rip(std::map<String, std::pair<std::vector<ProteinIdentification>, std::vector<PeptideIdentification> > > & ripped, std::vector<ProteinIdentification> & proteins, std::vector<PeptideIdentification> & peptides);
 
+    /**
+      @brief Ripping an idXML file according to file origin without loading it into memory
+
+      The input file is read twice via IdXMLFile's consumer interface. The first pass only keeps the protein
+      identifications (a single copy of every protein hit) and, for each file origin, the protein hits referenced by
+      its peptides. The second pass writes every peptide identification directly to the output file of its origin,
+      so memory use does not depend on the number of peptide identifications.
+
+      The output files are named according to the file origin and contain the same identifications as the result of
+      rip(), except that every protein hit is written only once per identification run.
+
+      @param in_file idXML file with peptide identifications annotated with file origin
+      @param output_directory Existing directory for the output files
+      @return The paths of the written files
+
+      @exception Exception::Precondition is thrown if the input contains no protein or no peptide identifications
+      @exception Exception::UnableToCreateFile is thrown if an output file cannot be written
+    */
+    StringList ripFile(const String & in_file, const String & output_directory);
+
 private:
 
     //Not implemented
@@ -159,9 +159,14 @@ namespace OpenMS
     ~MetaboliteSpectralMatching() override;
 
     /// hyperscore computation
-    double computeHyperScore(MSSpectrum, MSSpectrum, const double&, const double&);
+    double computeHyperScore(const MSSpectrum&, const MSSpectrum&, const double&, const double&) const;
 
-    /// main method of MetaboliteSpectralMatching
+    /**
+      @brief main method of MetaboliteSpectralMatching
+
+      @p spec_db is sorted by precursor m/z (once, later calls with the same database reuse the order).
+      Query spectra are matched in parallel if OpenMP is enabled, the reported order does not depend on the number of threads.
+    */
     void run(PeakMap &, PeakMap &, MzTab &);
 
   protected:
@@ -56,6 +56,8 @@
 #include <atomic>
 #include <algorithm>
 #include <fstream>
+#include <numeric>
+#include <vector>
 
 
 namespace OpenMS
@@ -277,7 +279,9 @@ public:
         return PEPTIDE_IDS_EMPTY;
       }
 
-      FoundProteinFunctor func(enzyme, xtandem_fix_parameters); // store the matches
+      FoundProteinFunctor func(enzyme, xtandem_fix_parameters); // statistics of all matches
+      std::vector<Size> pep_match_offsets; // peptide index --> first match in pep_matches (one additional entry)
+      std::vector<PeptideProteinMatchInformation> pep_matches; // matches of all peptides, sorted by peptide index and match
       Map<String, Size> acc_to_prot; // map: accessions --> FASTA protein index
       std::vector<bool> protein_is_decoy; // protein index -> is decoy?
       std::vector<std::string> protein_accessions; // protein index -> accession
@@ -347,12 +351,23 @@ public:
         const std::string jumpX(aaa_max_ + mm_max_ + 1, 'X'); // jump over stretches of 'X' which cost a lot of time; +1 because  AXXA is a valid hit for aaa_max == 2 (cannot split it)
         this->startProgress(0, proteins.size(), "Aho-Corasick");
         std::atomic<int> progress_prots(0);
+
+        // every thread collects its hits in its own buffer (the trie in 'pattern' is shared), buffers are merged after the search
+#ifdef _OPENMP
+        const Size nr_threads = omp_get_max_threads();
+#else
+        const Size nr_threads = 1;
+#endif
+        std::vector<FoundProteinFunctor> func_per_thread(nr_threads, FoundProteinFunctor(enzyme, xtandem_fix_parameters));
 #ifdef _OPENMP
 #pragma omp parallel
 #endif
         {
-          FoundProteinFunctor func_threads(enzyme, xtandem_fix_parameters);
-          Map<String, Size> acc_to_prot_thread; // map: accessions --> FASTA protein index
+#ifdef _OPENMP
+          FoundProteinFunctor& func_threads = func_per_thread[omp_get_thread_num()];
+#else
+          FoundProteinFunctor& func_threads = func_per_thread[0];
+#endif
           AhoCorasickAmbiguous fuzzyAC;
           String prot;
 
@@ -446,36 +461,38 @@ public:
               {
                 addHits_(fuzzyAC, pattern, pep_DB, prot, prot, prot_idx, 0, func_threads);
               }
-              // was protein found?
+              // was protein found? (each protein index is written by one thread only)
               if (hits_total < func_threads.filter_passed + func_threads.filter_rejected)
               {
                 protein_accessions[prot_idx] = proteins.chunkAt(i).identifier;
-                acc_to_prot_thread[protein_accessions[prot_idx]] = prot_idx;
               }
             } // end parallel FOR
-
-            // join results again
-            DEBUG_ONLY std::cerr << " critical now \n";
-            #ifdef _OPENMP
-            #pragma omp critical(PeptideIndexer_joinAC)
-            #endif
-            {
-              s.start();
-              // hits
-              func.merge(func_threads);
-              // accession -> index
-              acc_to_prot.insert(acc_to_prot_thread.begin(), acc_to_prot_thread.end());
-              acc_to_prot_thread.clear();
-              s.stop();
-            } // OMP end critical
           } // end readChunk
         } // OMP end parallel
         this->endProgress();
+
+        // join results
+        s.start();
+        mergeHits_(func_per_thread, (Size)length(pep_DB), func, pep_match_offsets, pep_matches);
+        // accession -> index (of the first protein with this accession)
+        for (Size prot_idx = 0; prot_idx < protein_accessions.size(); ++prot_idx)
+        {
+          if (!protein_accessions[prot_idx].empty() && !acc_to_prot.has(protein_accessions[prot_idx]))
+          {
+            acc_to_prot[protein_accessions[prot_idx]] = prot_idx;
+          }
+        }
+        s.stop();
         std::cout << "Merge took: " << s.toString() << "\n";
         mu.after();
         std::cout << mu.delta("Aho-Corasick") << "\n\n";
 
-        LOG_INFO << "\nAho-Corasick done:\n  found " << func.filter_passed << " hits for " << func.pep_to_prot.size() << " of " << length(pep_DB) << " peptides.\n";
+        Size found_peptides(0);
+        for (Size pep_idx = 0; pep_idx < length(pep_DB); ++pep_idx)
+        {
+          if (pep_match_offsets[pep_idx] != pep_match_offsets[pep_idx + 1]) ++found_peptides;
+        }
+        LOG_INFO << "\nAho-Corasick done:\n  found " << func.filter_passed << " hits for " << found_peptides << " of " << length(pep_DB) << " peptides.\n";
 
         // write some stats
         LOG_INFO << "Peptide hits passing enzyme filter: " << func.filter_passed << "\n"
@@ -532,8 +549,8 @@ public:
 
           std::set<Size> prot_indices; /// protein hits of this peptide
           // add new protein references
-          for (std::set<PeptideProteinMatchInformation>::const_iterator it_i = func.pep_to_prot[pep_idx].begin();
-            it_i != func.pep_to_prot[pep_idx].end(); ++it_i)
+          for (std::vector<PeptideProteinMatchInformation>::const_iterator it_i = pep_matches.begin() + pep_match_offsets[pep_idx];
+            it_i != pep_matches.begin() + pep_match_offsets[pep_idx + 1]; ++it_i)
           {
             prot_indices.insert(it_i->protein_index);
             const String& accession = protein_accessions[it_i->protein_index];
@@ -939,10 +956,11 @@ public:
     struct FoundProteinFunctor
     {
     public:
-      typedef std::map<OpenMS::Size, std::set<PeptideProteinMatchInformation> > MapType;
+      /// a match of a peptide (index) to a protein
+      typedef std::pair<OpenMS::Size, PeptideProteinMatchInformation> HitType;
 
-      /// peptide index --> protein indices
-      MapType pep_to_prot;
+      /// all accepted hits in order of discovery (may contain duplicates), see mergeHits_()
+      std::vector<HitType> hits;
 
       /// number of accepted hits (passing addHit() constraints)
       OpenMS::Size filter_passed;
@@ -958,31 +976,10 @@ public:
 
     public:
       explicit FoundProteinFunctor(const ProteaseDigestion& enzyme, bool xtandem) :
-        pep_to_prot(), filter_passed(0), filter_rejected(0), enzyme_(enzyme), xtandem_(xtandem)
+        hits(), filter_passed(0), filter_rejected(0), enzyme_(enzyme), xtandem_(xtandem)
       {
       }
 
-      void merge(FoundProteinFunctor& other)
-      {
-        if (pep_to_prot.empty())
-        { // first merge is easy
-          pep_to_prot.swap(other.pep_to_prot);
-        }
-        else
-        {
-          for (FoundProteinFunctor::MapType::const_iterator it = other.pep_to_prot.begin(); it != other.pep_to_prot.end(); ++it)
-          { // augment set
-            this->pep_to_prot[it->first].insert(other.pep_to_prot[it->first].begin(), other.pep_to_prot[it->first].end());
-          }
-          other.pep_to_prot.clear();
-        }
-        // cheap members
-        this->filter_passed += other.filter_passed;
-        other.filter_passed = 0;
-        this->filter_rejected += other.filter_rejected;
-        other.filter_rejected = 0;
-      }
-
       void addHit(const OpenMS::Size idx_pep,
         const OpenMS::Size idx_prot,
         const OpenMS::Size len_pep,
@@ -996,7 +993,7 @@ public:
           match.position = position;
           match.AABefore = (position == 0) ? PeptideEvidence::N_TERMINAL_AA : seq_prot[position - 1];
           match.AAAfter = (position + len_pep >= seq_prot.size()) ? PeptideEvidence::C_TERMINAL_AA : seq_prot[position + len_pep];
-          pep_to_prot[idx_pep].insert(match);
+          hits.push_back(HitType(idx_pep, match));
           ++filter_passed;
         }
         else
@@ -1009,6 +1006,80 @@ public:
 
     };
 
+    /**
+      @brief Merges the hits of all threads
+
+      Hits of each thread are sorted and made unique independently, the
+      sorted runs are then merged pairwise (in parallel, without locking).
+      The result is stored as one array of matches sorted by peptide index
+      and match plus the offsets of each peptide in it, which is much more
+      compact than one set of matches per peptide.
+
+      @param func_per_thread Hits of each thread (cleared afterwards)
+      @param nr_peptides Number of peptides
+      @param func Receives the statistics of all threads
+      @param pep_match_offsets Matches of peptide i are [pep_match_offsets[i], pep_match_offsets[i + 1]) in @p pep_matches
+      @param pep_matches All matches
+    */
+    static void mergeHits_(std::vector<FoundProteinFunctor>& func_per_thread, Size nr_peptides, FoundProteinFunctor& func,
+                           std::vector<Size>& pep_match_offsets, std::vector<PeptideProteinMatchInformation>& pep_matches)
+    {
+      typedef FoundProteinFunctor::HitType HitType;
+
+      // sort each buffer and compute its position in the joined array
+      std::vector<Size> run_offsets(func_per_thread.size() + 1, 0);
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic, 1)
+#endif
+      for (SignedSize t = 0; t < (SignedSize)func_per_thread.size(); ++t)
+      {
+        std::vector<HitType>& hits = func_per_thread[t].hits;
+        std::sort(hits.begin(), hits.end());
+        hits.erase(std::unique(hits.begin(), hits.end()), hits.end());
+      }
+      for (Size t = 0; t < func_per_thread.size(); ++t)
+      {
+        run_offsets[t + 1] = run_offsets[t] + func_per_thread[t].hits.size();
+        func.filter_passed += func_per_thread[t].filter_passed;
+        func.filter_rejected += func_per_thread[t].filter_rejected;
+      }
+
+      // copy all runs into one array
+      std::vector<HitType> all_hits(run_offsets.back());
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic, 1)
+#endif
+      for (SignedSize t = 0; t < (SignedSize)func_per_thread.size(); ++t)
+      {
+        std::copy(func_per_thread[t].hits.begin(), func_per_thread[t].hits.end(), all_hits.begin() + run_offsets[t]);
+        std::vector<HitType>().swap(func_per_thread[t].hits);
+      }
+
+      // merge neighbouring runs until only one is left (each protein is searched by one thread only, so there are no duplicates between runs)
+      for (Size width = 1; width < func_per_thread.size(); width *= 2)
+      {
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic, 1)
+#endif
+        for (SignedSize t = 0; t < (SignedSize)func_per_thread.size(); t += 2 * width)
+        {
+          if ((Size)t + width >= func_per_thread.size()) continue;
+          const Size end = std::min((Size)t + 2 * width, func_per_thread.size());
+          std::inplace_merge(all_hits.begin() + run_offsets[t], all_hits.begin() + run_offsets[t + width], all_hits.begin() + run_offsets[end]);
+        }
+      }
+
+      // compact representation: offsets per peptide
+      pep_match_offsets.assign(nr_peptides + 1, 0);
+      pep_matches.resize(all_hits.size());
+      for (Size i = 0; i < all_hits.size(); ++i)
+      {
+        ++pep_match_offsets[all_hits[i].first + 1];
+        pep_matches[i] = all_hits[i].second;
+      }
+      std::partial_sum(pep_match_offsets.begin(), pep_match_offsets.end(), pep_match_offsets.begin());
+    }
+
     inline void addHits_(AhoCorasickAmbiguous& fuzzyAC, const AhoCorasickAmbiguous::FuzzyACPattern& pattern, const AhoCorasickAmbiguous::PeptideDB& pep_DB, const String& prot, const String& full_prot, SignedSize idx_prot, Int offset, FoundProteinFunctor& func_threads) const
     {
       fuzzyAC.setProtein(prot);
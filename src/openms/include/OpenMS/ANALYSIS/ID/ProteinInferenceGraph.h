@@ -0,0 +1,190 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2018.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: Julianus Pfeuffer $
+// $Authors: Hannes Roest $
+// --------------------------------------------------------------------------
+
+
+#pragma once
+
+#include <OpenMS/CONCEPT/Types.h>
+#include <OpenMS/DATASTRUCTURES/String.h>
+#include <OpenMS/METADATA/ProteinIdentification.h>
+#include <OpenMS/METADATA/PeptideIdentification.h>
+
+#include <vector>
+
+namespace OpenMS
+{
+  /**
+    @brief Bipartite protein-peptide graph for in-process protein inference
+
+    The graph connects the protein hits of a ProteinIdentification with the
+    peptides (unmodified sequences of the best hits of the peptide
+    identifications) referencing them. Both directions are stored as compact
+    adjacency arrays and the graph is decomposed into connected components
+    once in build(). As no information flows between components, infer()
+    processes them independently and in parallel.
+
+    For every component, the proteins with the same set of peptides are
+    combined into indistinguishable protein groups (replacing the
+    indistinguishable proteins of the protein identification). Protein
+    scores are then computed with one of the following methods:
+
+    - @em PARSIMONY: Occam's razor. A minimal set of protein groups
+      explaining all peptides of the component is selected greedily (the
+      group explaining most of the not yet explained peptides first, ties
+      are resolved by the summed peptide probabilities and by order). The
+      proteins of the selected groups get a score of 1, all others 0, and
+      the selected groups are stored as protein groups.
+    - @em BAYESIAN: expectation-maximization of the peptide-to-protein
+      weights as in ProteinProphet. A protein probability is
+      @f$ P_i = 1 - \prod_j (1 - w_{ij} p_j) @f$ over its peptides with
+      probabilities @f$ p_j @f$, a shared peptide is apportioned to its
+      proteins by @f$ w_{ij} = P_i / \sum_k P_k @f$. All groups are stored
+      as protein groups with their probability.
+
+    Peptide probabilities are taken from the best hit of every peptide
+    identification: the score is used directly for higher-is-better scores
+    and as posterior error probability (@f$ p = 1 - s @f$) otherwise. For
+    several identifications of the same sequence, the highest probability
+    is used.
+
+    @see PeptideProteinResolution for the assignment of shared peptides
+    based on protein scores.
+
+    @ingroup Analysis_ID
+  */
+  class OPENMS_DLLAPI ProteinInferenceGraph
+  {
+public:
+    /// Protein scoring methods
+    enum InferenceMethod
+    {
+      PARSIMONY,
+      BAYESIAN
+    };
+
+    /// Default constructor (empty graph)
+    ProteinInferenceGraph();
+
+    /**
+      @brief Builds the graph
+
+      Peptide evidences referencing accessions missing from the protein
+      hits are ignored, as are peptide identifications without hits.
+
+      @param protein Protein identification run with the protein hits
+      @param peptides Peptide identifications with peptide evidences
+    */
+    void build(const ProteinIdentification& protein, const std::vector<PeptideIdentification>& peptides);
+
+    /**
+      @brief Infers proteins and protein groups
+
+      Scores of the protein hits are replaced (sorted by score afterwards),
+      indistinguishable proteins and protein groups of @p protein are
+      replaced by those computed.
+
+      @param protein The protein identification the graph was built from
+      @param method The scoring method
+      @param max_iterations Maximal number of EM iterations (BAYESIAN)
+      @param tolerance EM convergence threshold on protein probabilities (BAYESIAN)
+
+      @exception Exception::IllegalArgument is thrown if @p protein has a different number of hits than the graph
+      @exception Exception::InvalidValue is thrown if the peptide scores are not probabilities (BAYESIAN)
+    */
+    void infer(ProteinIdentification& protein, InferenceMethod method, Size max_iterations = 100, double tolerance = 1e-6) const;
+
+    /// Number of proteins
+    Size getNumberOfProteins() const;
+
+    /// Number of (distinct) peptides
+    Size getNumberOfPeptides() const;
+
+    /// Number of connected components
+    Size getNumberOfComponents() const;
+
+    /// Component of a protein (index into the protein hits)
+    Size getComponent(Size protein) const;
+
+    /// Peptides of a protein (sorted indices)
+    void getPeptides(Size protein, std::vector<Size>& peptides) const;
+
+    /// Proteins of a peptide (sorted indices)
+    void getProteins(Size peptide, std::vector<Size>& proteins) const;
+
+    /// Unmodified sequence of a peptide
+    const String& getPeptideSequence(Size peptide) const;
+
+    /// Probability of a peptide (see class documentation)
+    double getPeptideProbability(Size peptide) const;
+
+protected:
+    /// Indistinguishable protein group of a component (member proteins and shared peptides)
+    struct Group_
+    {
+      std::vector<UInt32> proteins;
+      std::vector<UInt32> peptides;
+    };
+
+    /// Maps the peptides of groups to local indices (0 to n - 1), returns n
+    static Size mapPeptides_(const std::vector<Group_>& groups, std::vector<std::vector<UInt32> >& local);
+
+    /// Computes the indistinguishable protein groups of a component
+    void buildGroups_(Size component, std::vector<Group_>& groups) const;
+
+    /// Greedy minimal set cover of the peptides of a component, returns the selected groups
+    void selectParsimonious_(const std::vector<Group_>& groups, std::vector<bool>& selected) const;
+
+    /// EM protein probabilities of a component (by group, as group members are equivalent)
+    void estimateProbabilities_(const std::vector<Group_>& groups, Size max_iterations, double tolerance, std::vector<double>& probabilities) const;
+
+    /// Start of the peptides of each protein in protein_peptides_ (one additional entry)
+    std::vector<Size> protein_offsets_;
+    std::vector<UInt32> protein_peptides_;
+    /// Start of the proteins of each peptide in peptide_proteins_ (one additional entry)
+    std::vector<Size> peptide_offsets_;
+    std::vector<UInt32> peptide_proteins_;
+
+    std::vector<String> peptide_sequences_;
+    std::vector<double> peptide_probabilities_;
+    /// Whether all peptide probabilities are in [0, 1]
+    bool probabilities_valid_;
+
+    /// Component of each protein
+    std::vector<UInt32> protein_components_;
+    /// Start of the proteins of each component in component_proteins_ (one additional entry)
+    std::vector<Size> component_offsets_;
+    std::vector<UInt32> component_proteins_;
+  };
+
+}
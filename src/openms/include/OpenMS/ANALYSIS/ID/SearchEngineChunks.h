@@ -0,0 +1,114 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2018.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: Timo Sachsenberg $
+// $Authors: Timo Sachsenberg $
+// --------------------------------------------------------------------------
+
+#pragma once
+
+#include <OpenMS/KERNEL/MSExperiment.h>
+#include <OpenMS/METADATA/PeptideIdentification.h>
+#include <OpenMS/METADATA/ProteinIdentification.h>
+
+#include <vector>
+
+namespace OpenMS
+{
+  /**
+    @brief Splits the input of an external search engine into chunks and merges the results of the chunks
+
+    Search engines that do not scale to many threads can be run as several
+    instances at the same time, each searching a part of the spectra with a
+    part of the thread budget (see TOPPBase::runExternalProcesses_ and the
+    @p chunks option of the search engine adapters). The spectra are split
+    into contiguous chunks, so the native IDs (and therefore the spectrum
+    references of the results) are the same as for the whole input, and
+    merged results are in the same order as the results of a single search.
+
+    @ingroup Analysis_ID
+  */
+  class OPENMS_DLLAPI SearchEngineChunks
+  {
+public:
+
+    /**
+      @brief Number of chunks actually used
+
+      @param requested Number of chunks requested by the user
+      @param nr_spectra Number of spectra to search
+
+      @return At least one and at most one chunk per spectrum
+    */
+    static Size getNumberOfChunks(Size requested, Size nr_spectra);
+
+    /**
+      @brief Number of threads each search engine instance may use
+
+      @param nr_chunks Number of instances running at the same time
+      @param threads Overall thread budget (see ExecutionResources::getThreads())
+
+      @return The budget divided evenly between the instances (at least one thread)
+    */
+    static Int getThreadsPerChunk(Size nr_chunks, Int threads);
+
+    /**
+      @brief Splits the spectra of @p exp into @p nr_chunks contiguous chunks of (almost) equal size
+
+      Each chunk gets the experimental settings of @p exp. Chromatograms are not copied.
+
+      @exception Exception::InvalidValue is thrown if @p nr_chunks is zero or larger than the number of spectra
+    */
+    static std::vector<PeakMap> split(const PeakMap& exp, Size nr_chunks);
+
+    /**
+      @brief Merges the results of the search engine instances into a single result
+
+      The runs (protein identifications) of all chunks are merged by
+      position: run @em i of the result gets the run information (identifier,
+      search parameters, ...) of run @em i of the first chunk and the union of
+      the protein hits of run @em i of all chunks (in order of first
+      occurrence). Peptide identifications are concatenated in chunk order
+      and refer to the identifier of the merged run.
+
+      @param chunk_proteins Protein identifications of each chunk (will be cleared)
+      @param chunk_peptides Peptide identifications of each chunk (will be cleared)
+      @param proteins Merged protein identifications (will be overwritten)
+      @param peptides Merged peptide identifications (will be overwritten)
+
+      @exception Exception::InvalidValue is thrown if the number of chunks differs between @p chunk_proteins and @p chunk_peptides
+    */
+    static void merge(std::vector<std::vector<ProteinIdentification> >& chunk_proteins,
+                      std::vector<std::vector<PeptideIdentification> >& chunk_peptides,
+                      std::vector<ProteinIdentification>& proteins,
+                      std::vector<PeptideIdentification>& peptides);
+  };
+
+} // namespace OpenMS
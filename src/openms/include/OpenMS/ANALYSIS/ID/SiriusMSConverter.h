@@ -70,6 +70,23 @@ public:
                       const int& isotope_pattern_iterations,
                       const bool no_mt_info);
 
+    /**
+      @brief Store the compounds in several .ms files
+
+      The compounds are distributed in order over @p msfiles (contiguous parts
+      of about equal size), e.g. to run several SIRIUS instances in parallel.
+      The concatenation of the files equals the single file written by the
+      overload above. Compounds are formatted in parallel if OpenMP is enabled.
+
+      @exception Exception::IllegalArgument if @p msfiles is empty
+    */
+    static void store(const PeakMap& spectra,
+                      const std::vector<OpenMS::String>& msfiles,
+                      const FeatureMapping::FeatureToMs2Indices& feature_mapping,
+                      const bool& feature_only,
+                      const int& isotope_pattern_iterations,
+                      const bool no_mt_info);
+
   };
 
 }
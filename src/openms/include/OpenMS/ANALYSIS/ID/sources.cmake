@@ -16,6 +16,7 @@ ConsensusIDAlgorithmRanks.h
 ConsensusIDAlgorithmSimilarity.h
 ConsensusIDAlgorithmWorst.h
 FalseDiscoveryRate.h
+FragmentIndex.h
 HiddenMarkovModel.h
 IDDecoyProbability.h
 IDConflictResolverAlgorithm.h
@@ -24,9 +25,11 @@ IDRipper.h
 MetaboliteSpectralMatching.h
 PeptideProteinResolution.h
 PrecursorPurity.h
+ProteinInferenceGraph.h
 ProtonDistributionModel.h
 PeptideIndexing.h
 PercolatorFeatureSetHelper.h
+SearchEngineChunks.h
 SiriusMSConverter.h
 )
 
@@ -35,6 +35,7 @@
 #pragma once
 
 #include <OpenMS/KERNEL/ConsensusMap.h>
+#include <OpenMS/KERNEL/ColumnarConsensusMap.h>
 #include <OpenMS/ANALYSIS/MAPMATCHING/ConsensusMapNormalizerAlgorithmThreshold.h>
 
 namespace OpenMS
@@ -88,6 +89,23 @@ public:
      */
     static Size computeMedians(const ConsensusMap & map, std::vector<double> & medians, const String& acc_filter, const String& desc_filter);
 
+    /**
+     * @brief normalizes the maps of a columnar consensus map
+     * @param map ColumnarConsensusMap (handle intensities are modified in place)
+     * @param method whether to use scaling or shifting to same median
+     * @param use_feature consensus features used for computing the medians (empty: all)
+     */
+    static void normalizeMaps(ColumnarConsensusMap & map, NormalizationMethod method, const std::vector<bool>& use_feature = std::vector<bool>());
+
+    /**
+     * @brief computes medians of all maps of a columnar consensus map and returns index of map with most features
+     * @param map ColumnarConsensusMap
+     * @param medians vector of medians to be filled
+     * @param use_feature consensus features used for computing the medians (empty: all)
+     * @return index of map with largest number of features
+     */
+    static Size computeMedians(const ColumnarConsensusMap & map, std::vector<double> & medians, const std::vector<bool>& use_feature = std::vector<bool>());
+
     /**
      * @brief returns whether consensus feature passes filters
      * returns whether consensus feature @p cf_it in @p map passes accession
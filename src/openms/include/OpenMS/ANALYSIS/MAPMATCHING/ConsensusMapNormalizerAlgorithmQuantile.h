@@ -35,6 +35,7 @@
 #pragma once
 
 #include <OpenMS/KERNEL/ConsensusMap.h>
+#include <OpenMS/KERNEL/ColumnarConsensusMap.h>
 
 namespace OpenMS
 {
@@ -65,6 +66,17 @@ public:
      */
     static void normalizeMaps(ConsensusMap & map);
 
+    /**
+     * @brief normalizes the maps of a columnar consensus map
+     *
+     * The handle intensities are normalized in place, the maps (columns) are
+     * sorted and ranked in parallel if OpenMP is enabled. Gives the same
+     * result as normalizeMaps(ConsensusMap&).
+     *
+     * @param map ColumnarConsensusMap
+     */
+    static void normalizeMaps(ColumnarConsensusMap & map);
+
     /**
      * @brief resamples data_in and writes the results to data_out
      * @param data_in the data to be resampled
@@ -203,6 +203,34 @@ public:
     void group(const std::vector<ConsensusMap>& maps,
                        ConsensusMap& out) override;
 
+    /**
+        @brief Applies the algorithm to featureXML files without loading all of them into memory
+
+        The input files are read one at a time (twice, or three times if
+        features are annotated with peptide identifications). In a first pass,
+        the m/z values are collected in bins of the size of the m/z tolerance
+        to determine the partition boundaries (@p nr_partitions). In a second
+        pass, the features (reduced to the information needed for linking)
+        are written to one temporary file per m/z partition. Each partition is
+        then loaded, aligned (if @p warp:enabled is set) and linked
+        independently of the others - in parallel, if OpenMP is enabled -
+        and the results are appended to @p out. Peptide identifications are
+        transferred to the consensus features afterwards.
+
+        Peak memory is dominated by the size of the result and by the size of
+        the partitions (one per thread), so @p nr_partitions should be
+        increased with the number of input maps.
+
+        The column headers of @p out are set (file name of the primary MS
+        run, or of the input file; size; unique id). Protein and unassigned
+        peptide identifications of the inputs are added to @p out.
+
+        @exception IllegalArgument is thrown if less than two input files are given.
+        @exception UnableToCreateFile is thrown if a temporary file cannot be written.
+        @exception FileNotReadable is thrown if a temporary file cannot be read.
+    */
+    void group(const StringList& feature_files, ConsensusMap& out);
+
     /// Creates a new instance of this class (for Factory)
     static FeatureGroupingAlgorithm* create()
     {
@@ -231,14 +259,24 @@ private:
     template <typename MapType>
     void group_(const std::vector<MapType>& input_maps, ConsensusMap& out);
 
-    /// Run the actual clustering algorithm
-    void runClustering_(const KDTreeFeatureMaps& kd_data, ConsensusMap& out);
+    /// Sets the linking tolerances and the feature distance functor
+    void setLinkingParameters_(double max_intensity);
+
+    /// Run the actual clustering algorithm (@p feature_distance is not thread-safe, use one per thread)
+    void runClustering_(const KDTreeFeatureMaps& kd_data, ConsensusMap& out, FeatureDistance& feature_distance) const;
 
     /// Update maximum possible sizes of potential consensus features for indices specified in @p update_these
-    void updateClusterProxies_(std::set<ClusterProxyKD>& potential_clusters, std::vector<ClusterProxyKD>& cluster_for_idx, const std::set<Size>& update_these, const std::vector<Int>& assigned, const KDTreeFeatureMaps& kd_data);
+    void updateClusterProxies_(std::set<ClusterProxyKD>& potential_clusters, std::vector<ClusterProxyKD>& cluster_for_idx, const std::set<Size>& update_these, const std::vector<Int>& assigned, const KDTreeFeatureMaps& kd_data, FeatureDistance& feature_distance) const;
 
     /// Compute the current best cluster with center index @p i (mutates @p proxy and @p cf_indices)
-    ClusterProxyKD computeBestClusterForCenter_(Size i, std::vector<Size>& cf_indices, const std::vector<Int>& assigned, const KDTreeFeatureMaps& kd_data) const;
+    ClusterProxyKD computeBestClusterForCenter_(Size i, std::vector<Size>& cf_indices, const std::vector<Int>& assigned, const KDTreeFeatureMaps& kd_data, FeatureDistance& feature_distance) const;
+
+    /**
+        @brief Loads a temporary partition file (written by group(const StringList&, ConsensusMap&))
+
+        @exception FileNotReadable is thrown if the file cannot be read
+    */
+    static void loadPartition_(const String& filename, std::vector<BaseFeature>& features, std::vector<Size>& map_indices);
 
     /// Construct consensus feature and add to out map
     void addConsensusFeature_(const std::vector<Size>& indices, const KDTreeFeatureMaps& kd_data, ConsensusMap& out) const;
@@ -45,6 +45,7 @@
 #include <OpenMS/METADATA/PeptideIdentification.h>
 
 #include <cmath> // for "abs"
+#include <exception> // for "exception_ptr"
 #include <limits> // for "max"
 #include <map>
 
@@ -95,6 +96,9 @@ public:
     /**
       @brief Align feature maps, consensus maps, peak maps, or peptide identifications.
 
+      RT data of the different maps is collected (and transformations are
+      computed) in parallel if OpenMP is enabled.
+
       @param data Vector of input data (FeatureMap, ConsensusMap, PeakMap or @p vector<PeptideIdentification>) that should be aligned.
       @param transformations Vector of RT transformations that will be computed.
       @param reference_index Index in @p data of the reference to align to, if any
@@ -121,17 +125,40 @@ public:
         setReference(data[reference_index]);
       }
 
-      // one set of RT data for each input map, except reference (if any):
+      // one set of RT data for each input map, except reference (if any);
+      // the maps are independent, so collect the RT data in parallel:
       std::vector<SeqToList> rt_data(data.size() - use_internal_reference);
       bool all_sorted = true;
-      for (Size i = 0, j = 0; i < data.size(); ++i)
+      Size err_count(0);
+      std::exception_ptr err;
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic) reduction(&& : all_sorted)
+#endif
+      for (SignedSize i = 0; i < SignedSize(data.size()); ++i)
       {
-        if ((reference_index >= 0) && (i == Size(reference_index)))
+        if ((reference_index >= 0) && (i == SignedSize(reference_index)))
         {
           continue; // skip reference map, if any
         }
-        all_sorted &= getRetentionTimes_(data[i], rt_data[j++]);
+        // index in "rt_data" (reference map is skipped):
+        Size j = ((reference_index >= 0) && (i > SignedSize(reference_index))) ? i - 1 : i;
+        try
+        {
+          bool sorted = getRetentionTimes_(data[i], rt_data[j]);
+          all_sorted = all_sorted && sorted;
+        }
+        catch (...)
+        {
+#ifdef _OPENMP
+#pragma omp critical (MapAlignmentAlgorithmIdentification_error)
+#endif
+          {
+            ++err_count;
+            err = std::current_exception();
+          }
+        }
       }
+      if (err_count != 0) std::rethrow_exception(err);
       setProgress(1);
 
       computeTransformations_(rt_data, transformations, all_sorted);
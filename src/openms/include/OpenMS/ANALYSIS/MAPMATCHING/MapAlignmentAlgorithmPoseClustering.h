@@ -57,6 +57,12 @@ namespace OpenMS
     computation, smaller values might lead to no or unstable trafos. Set to -1
     to use all features (might take very long for large maps).
 
+    The reference map is prepared for the superimposer once (in
+    setReference()). The align() functions do not modify the state of the
+    algorithm and can be called concurrently for different maps; the
+    overloads for several maps align them in parallel (if OpenMP is
+    enabled), with one superimposer and pair finder per thread.
+
     For further details see:
     @n Eva Lange et al.
     @n A Geometric Approach for the Alignment of Liquid Chromatography-Mass Spectrometry Data
@@ -82,24 +88,47 @@ public:
     void align(const PeakMap& map, TransformationDescription& trafo);
     void align(const ConsensusMap& map, TransformationDescription& trafo);
 
+    /// Aligns several maps to the reference (in parallel)
+    void align(const std::vector<FeatureMap>& maps, std::vector<TransformationDescription>& trafos);
+
+    /// Aligns several maps to the reference (in parallel)
+    void align(const std::vector<ConsensusMap>& maps, std::vector<TransformationDescription>& trafos);
+
     /// Sets the reference for the alignment
     template <typename MapType>
     void setReference(const MapType& map)
     {
       MapType map2 = map; // todo: avoid copy (MSExperiment version of convert() demands non-const version)
       MapConversion::convert(0, map2, reference_, max_num_peaks_considered_);
+      superimposer_.prepareMap(reference_, reference_prepared_);
     }
 
 protected:
 
     void updateMembers_() override;
 
+    /// Sets up a superimposer and a pair finder with the current parameters (e.g. for one thread)
+    void setUpWorkers_(PoseClusteringAffineSuperimposer& superimposer, StablePairFinder& pairfinder, bool log_progress) const;
+
+    /// Aligns a map to the reference using the given superimposer and pair finder
+    void align_(const ConsensusMap& map, PoseClusteringAffineSuperimposer& superimposer, StablePairFinder& pairfinder, TransformationDescription& trafo) const;
+
+    /// Aligns a map to the reference using the given superimposer and pair finder
+    void align_(const FeatureMap& map, PoseClusteringAffineSuperimposer& superimposer, StablePairFinder& pairfinder, TransformationDescription& trafo) const;
+
+    /// Aligns several maps to the reference (in parallel)
+    template <typename MapType>
+    void alignMaps_(const std::vector<MapType>& maps, std::vector<TransformationDescription>& trafos);
+
     PoseClusteringAffineSuperimposer superimposer_;
 
     StablePairFinder pairfinder_;
 
     ConsensusMap reference_;
 
+    /// The reference prepared for the superimposer
+    PoseClusteringAffineSuperimposer::PreparedMap reference_prepared_;
+
     Int max_num_peaks_considered_;
 
 private:
@@ -45,6 +45,11 @@ namespace OpenMS
   /**
       @brief A map alignment algorithm based on spectrum similarity (dynamic programming).
 
+      The dynamic programming is restricted to a band around the diagonal
+      between anchor points of high similarity. The spectrum similarities of
+      the band are calculated in parallel (if OpenMP is enabled) before the
+      recursion, the result does not depend on the number of threads.
+
       @htmlinclude OpenMS_MapAlignmentAlgorithmSpectrumAlignment.parameters
 
       @experimental This algorithm is work in progress and might change.
@@ -227,6 +232,43 @@ private:
     */
     float scoring_(const MSSpectrum& a, MSSpectrum& b);
 
+    /**
+        @brief maps a similarity score to the score used in the alignment matrix (mismatch score or 2 + similarity)
+    */
+    float transformScore_(float score) const;
+
+    /**
+        @brief calculates the scores of the given matrix cells in parallel and stores them in @p buffer
+
+        Cells which are already contained in @p buffer are skipped. The
+        indices of the cells and the meaning of the remaining arguments are
+        the same as for scoreCalculation_, which afterwards only looks up the
+        scores. Nothing is done in debug mode, there the scores are calculated
+        on demand by scoreCalculation_.
+
+        @param cells matrix cells (i,j) to be scored
+        @param patternbegin indicate the beginning of the template sequence
+        @param alignbegin  indicate the beginning of the aligned sequence
+        @param pattern vector of pointers of the template sequence
+        @param aligned vector of pointers of the aligned sequence
+        @param buffer  holds the calculated score of index i,j.
+        @param column_row_orientation indicate the order of the matrix
+    */
+    void precomputeScores_(const std::vector<std::pair<Size, Size> >& cells, Size patternbegin, Size alignbegin,
+                           const std::vector<MSSpectrum*>& pattern, std::vector<MSSpectrum*>& aligned,
+                           std::map<Size, std::map<Size, float> >& buffer, bool column_row_orientation);
+
+    /**
+        @brief calculates the (untransformed) scores of pairs of spectra (index into @p pattern, index into @p aligned) in parallel
+
+        @param pattern vector of pointers of the template sequence
+        @param aligned vector of pointers of the aligned sequence
+        @param pairs pairs of spectrum indices
+        @param scores output, the score of each pair
+    */
+    void scoreRange_(const std::vector<MSSpectrum*>& pattern, std::vector<MSSpectrum*>& aligned,
+                     const std::vector<std::pair<Size, Size> >& pairs, std::vector<float>& scores);
+
     /**
         @brief affine gap cost Alignment
 
@@ -52,6 +52,9 @@ namespace OpenMS
 
   /**
    * @brief This class collects functions for applying retention time transformations to data structures.
+   *
+   * All RTs of a data structure are collected first and transformed with a
+   * single (batch) call to TransformationDescription::apply().
    */
   class OPENMS_DLLAPI MapAlignmentTransformer
   {
@@ -78,21 +81,48 @@ namespace OpenMS
       const TransformationDescription& trafo, bool store_original_rt = false);
 
   private:
-    /// Applies a transformation to a feature
+    /**
+       @brief Applies a transformation to a feature
+
+       The transformed RTs are taken from @p rt_it (in the order in which
+       they are collected by collectRTs_()), the iterator is advanced past
+       them.
+    */
     static void applyToFeature_(Feature& feature,
-                                const TransformationDescription& trafo,
+                                std::vector<double>::const_iterator& rt_it,
                                 bool store_original_rt = false);
 
-    /// Applies a transformation to a basic feature
+    /// Applies a transformation to a basic feature (see applyToFeature_())
     static void applyToBaseFeature_(BaseFeature& feature,
-                                    const TransformationDescription& trafo,
+                                    std::vector<double>::const_iterator& rt_it,
                                     bool store_original_rt = false);
 
-    /// Applies a transformation to a consensus feature
+    /// Applies a transformation to a consensus feature (see applyToFeature_())
     static void applyToConsensusFeature_(
-      ConsensusFeature& feature, const TransformationDescription& trafo,
+      ConsensusFeature& feature, std::vector<double>::const_iterator& rt_it,
+      bool store_original_rt = false);
+
+    /// Applies a transformation to peptide identifications (see applyToFeature_())
+    static void applyToPeptideIds_(
+      std::vector<PeptideIdentification>& pep_ids,
+      std::vector<double>::const_iterator& rt_it,
       bool store_original_rt = false);
 
+    /// Appends all RTs of a basic feature (and its peptide identifications) to @p rts
+    static void collectRTs_(const BaseFeature& feature,
+                            std::vector<double>& rts);
+
+    /// Appends all RTs of a feature (including convex hulls and subordinates) to @p rts
+    static void collectRTs_(const Feature& feature, std::vector<double>& rts);
+
+    /// Appends all RTs of a consensus feature (including feature handles) to @p rts
+    static void collectRTs_(const ConsensusFeature& feature,
+                            std::vector<double>& rts);
+
+    /// Appends the RTs of all peptide identifications with RT to @p rts
+    static void collectRTs_(const std::vector<PeptideIdentification>& pep_ids,
+                            std::vector<double>& rts);
+
     /**
        @brief Stores the original RT in a meta value
 
@@ -100,6 +100,39 @@ public:
     /// Perform alignment on vector of 1D peaks
     virtual void run(const std::vector<Peak2D> & map_model, const std::vector<Peak2D> & map_scene, TransformationDescription & transformation);
 
+    /**
+      @brief A map prepared for pose clustering
+
+      Contains the most abundant data points (see @p num_used_points) sorted
+      by m/z, and the RT range of the full map. A map that is used for many
+      runs (e.g. the reference map of an alignment) only needs to be
+      prepared once.
+    */
+    struct PreparedMap
+    {
+      /// Selected data points (sorted by m/z)
+      std::vector<Peak2D> points;
+      /// Minimal RT of the full map
+      double min_rt;
+      /// Maximal RT of the full map
+      double max_rt;
+    };
+
+    /// Prepares a map for run(const PreparedMap&, const PreparedMap&, TransformationDescription&) (using the current parameters)
+    void prepareMap(const std::vector<Peak2D> & map, PreparedMap & prepared) const;
+
+    /// Prepares a consensus map for run(const PreparedMap&, const PreparedMap&, TransformationDescription&) (using the current parameters)
+    void prepareMap(const ConsensusMap & map, PreparedMap & prepared) const;
+
+    /**
+      @brief Estimates the transformation for two prepared maps (see prepareMap())
+
+      Gives the same result as running on the original maps.
+
+      @exception IllegalArgument is thrown if one of the maps is empty.
+    */
+    void run(const PreparedMap & model, const PreparedMap & scene, TransformationDescription & transformation);
+
     /// Returns an instance of this class
     static BaseSuperimposer * create()
     {
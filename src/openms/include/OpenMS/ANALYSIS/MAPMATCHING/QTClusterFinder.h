@@ -90,8 +90,16 @@ namespace OpenMS
 
    This algorithm includes a number of optimizations to reduce run-time:
    @li two-dimensional hashing of features,
-   @li a look-up table for feature distances,
-   @li a variant of QT clustering that requires only one round of clustering.
+   @li the neighborhoods of all cluster centers (features in adjacent grid
+       cells and their distances) are computed once and stored in a flat
+       (compressed sparse row) structure,
+   @li a variant of QT clustering that requires only one round of clustering,
+   @li the clusters are kept in an indexed priority queue; after the
+       extraction of a cluster, only the clusters that contained one of its
+       elements are recomputed (from their stored neighborhoods),
+   @li computing the neighborhoods and (re-)computing clusters is done in
+       parallel (if OpenMP is enabled); the result does not depend on the
+       number of threads.
 
    @see FeatureGroupingAlgorithmQT
 
@@ -105,16 +113,42 @@ namespace OpenMS
   {
 private:
 
-    /// Distances between pairs of grid features
-    typedef OpenMSBoost::unordered_map< 
-              std::pair<OpenMS::GridFeature*, OpenMS::GridFeature*>,
-              double> PairDistances;
+    typedef HashGrid<OpenMS::GridFeature*> Grid;
 
-    /// Map to store which grid features are next to which clusters
-    typedef OpenMSBoost::unordered_map<
-              OpenMS::GridFeature*, std::vector<QTCluster*> > ElementMapping;
+    /**
+       @brief Precomputed neighborhoods of all clusters
+
+       Clusters are indexed in the order of their center features in the hash
+       grid (the index of a feature is the index of the cluster it is the
+       center of). Row @p i of the compressed sparse row structure
+       (<tt>offsets[i]</tt> to <tt>offsets[i + 1]</tt>) contains all potential
+       cluster elements of cluster @p i together with their distances to the
+       center; the reverse structure contains all clusters that a feature is
+       a potential element of.
+    */
+    struct Neighborhoods_
+    {
+      std::vector<Size> offsets;
+      std::vector<Size> neighbors;
+      std::vector<double> distances;
+      std::vector<Size> reverse_offsets;
+      std::vector<Size> reverse;
+      /// Grid feature of each cluster (its center)
+      std::vector<OpenMS::GridFeature*> features;
+      /// Cluster index of each grid feature (in the order of storage)
+      std::vector<Size> cluster_index;
+      /// First grid feature (to compute storage positions)
+      const OpenMS::GridFeature* first_feature;
+
+      /// Returns the cluster index of a grid feature
+      Size clusterIndex(const OpenMS::GridFeature* feature) const
+      {
+        return cluster_index[feature - first_feature];
+      }
+    };
 
-    typedef HashGrid<OpenMS::GridFeature*> Grid;
+    /// Indexed priority queue of the clusters (by quality)
+    class ClusterQueue_;
 
     /// Number of input maps
     Size num_maps_;
@@ -134,25 +168,23 @@ private:
     /// Feature distance functor
     FeatureDistance feature_distance_;
 
-    /// Set of features already used
-    std::set<OpenMS::GridFeature*> already_used_;
-
-    /**
-       @brief Calculates the distance between two grid features.
-    */
-    double getDistance_(const OpenMS::GridFeature* left, const
-        OpenMS::GridFeature* right);
-
     /// Sets algorithm parameters
     void setParameters_(double max_intensity, double max_mz);
 
-    /// Generates a consensus feature from the best cluster and updates the clustering
-    void makeConsensusFeature_(std::list<QTCluster>& clustering,
+    /**
+       @brief Generates a consensus feature from the best cluster and updates the clustering
+
+       @returns False if there are no (valid) clusters left
+    */
+    bool makeConsensusFeature_(std::vector<QTCluster>& clustering,
                                ConsensusFeature& feature,
-                               ElementMapping& element_mapping, Grid&);
+                               ClusterQueue_& queue,
+                               const Neighborhoods_& neighborhoods,
+                               std::vector<bool>& used);
 
-    /// Computes an initial QT clustering of the points in the hash grid
-    void computeClustering_(Grid& grid, std::list<QTCluster>& clustering);
+    /// Computes the neighborhoods and an initial QT clustering of the points in the hash grid
+    void computeClustering_(const Grid& grid, const std::vector<OpenMS::GridFeature>& grid_features,
+                            std::vector<QTCluster>& clustering, Neighborhoods_& neighborhoods);
 
     /// Runs the algorithm on feature maps or consensus maps
     template <typename MapType>
@@ -163,9 +195,10 @@ private:
     void run_internal_(const std::vector<MapType>& input_maps,
                        ConsensusMap& result_map, bool do_progress);
 
-    /// Adds elements to the cluster based on the elements hashed in the grid
-    void addClusterElements_(int x, int y, const Grid& grid, QTCluster& cluster,
-      const OpenMS::GridFeature* center_feature);
+    /// (Re-)fills a cluster with its potential elements that have not been used yet
+    void fillCluster_(QTCluster& cluster, Size cluster_index,
+                      const Neighborhoods_& neighborhoods,
+                      const std::vector<bool>& used) const;
 
 protected:
 
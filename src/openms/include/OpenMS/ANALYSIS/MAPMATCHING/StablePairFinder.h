@@ -168,6 +168,14 @@ protected:
     bool compatibleIDs_(const ConsensusFeature& feat1,
                         const ConsensusFeature& feat2) const;
 
+    /**
+      @brief Updates the nearest and second nearest neighbor of a feature with the result of the feature distance to the element @p index of the other map.
+
+      Only elements that satisfy the distance constraints can become the nearest neighbor, all others count for the second nearest neighbor.
+    */
+    static void updateNeighbors_(const std::pair<bool, double>& result, UInt index,
+                                 UInt& nn_index, std::pair<double, double>& nn_distance);
+
     /// The distance to the second nearest neighbors must be by this factor larger than the distance to the matched element itself.
     double second_nearest_gap_;
 
@@ -125,6 +125,16 @@ public:
     */
     double apply(double value) const;
 
+    /**
+      @brief Applies the transformation to all @p values.
+
+      Gives the same results as calling apply() for each value, but is
+      considerably faster for large inputs (see
+      TransformationModel::evaluateBatch). @p results is resized to the size
+      of @p values and may be the same object as @p values.
+    */
+    void apply(const std::vector<double>& values, std::vector<double>& results) const;
+
     /// Gets the type of the fitted model
     const String& getModelType() const;
 
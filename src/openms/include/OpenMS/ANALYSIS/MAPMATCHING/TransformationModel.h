@@ -99,6 +99,19 @@ namespace OpenMS
 
     /// Evaluates the model at the given value
     virtual double evaluate(double value) const;
+
+    /**
+      @brief Evaluates the model at many values
+
+      Gives the same results as calling evaluate() for each value, but for
+      large inputs the work is distributed over multiple threads. Derived
+      classes may override this to avoid the per-value overhead (e.g. by
+      sweeping over sorted input instead of searching for each value).
+
+      @p results is resized to the size of @p values and may be the same
+      object as @p values.
+    */
+    virtual void evaluateBatch(const std::vector<double>& values, std::vector<double>& results) const;
     
     /**
     @brief Weight the data by the given weight function
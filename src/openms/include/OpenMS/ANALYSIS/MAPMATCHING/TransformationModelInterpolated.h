@@ -93,6 +93,17 @@ public:
      */
     double evaluate(double value) const override;
 
+    /**
+     * @brief Evaluate the interpolation model at many values
+     *
+     * The values are processed in blocks (distributed over threads), within
+     * a block the data point interval containing a value is found by
+     * sweeping forward from the interval of the previous value. This is
+     * particularly efficient for sorted input (e.g. retention times of
+     * consecutive spectra or chromatogram peaks).
+     */
+    void evaluateBatch(const std::vector<double>& values, std::vector<double>& results) const override;
+
     /// Gets the default parameters
     static void getDefaultParameters(Param& params);
 
@@ -124,6 +135,23 @@ public:
        */
       virtual double eval(const double& x) const = 0;
 
+      /**
+       * @brief Evaluate the underlying interpolation at a position x within a known interval.
+       *
+       * The default implementation ignores the interval and calls eval().
+       *
+       * @param x The position where the interpolation should be evaluated.
+       * @param index Index of the data point left of (or exactly at) x, i.e.
+       *        x[index] <= x < x[index + 1] (the last interval also contains the last data point).
+       *
+       * @return The interpolated value.
+       */
+      virtual double evalInInterval(const double& x, Size index) const
+      {
+        (void)index;
+        return eval(x);
+      }
+
       /**
        * @brief d'tor.
        */
@@ -72,6 +72,9 @@ public:
     /// Evaluates the model at the given value
     double evaluate(double value) const override;
 
+    /// Evaluates the model at many values (see TransformationModel::evaluateBatch)
+    void evaluateBatch(const std::vector<double>& values, std::vector<double>& results) const override;
+
     using TransformationModel::getParameters;
 
     /// Gets the "real" parameters
@@ -66,6 +66,12 @@ public:
       return model_->evaluate(value);
     }
 
+    /// Evaluates the model at many values (see TransformationModel::evaluateBatch)
+    void evaluateBatch(const std::vector<double>& values, std::vector<double>& results) const override
+    {
+      model_->evaluateBatch(values, results);
+    }
+
     using TransformationModel::getParameters;
 
     /// Gets the default parameters
@@ -37,8 +37,11 @@
 #include <OpenMS/CONCEPT/ProgressLogger.h>
 #include <OpenMS/OPENSWATHALGO/DATAACCESS/ISpectrumAccess.h>
 
+#include <functional>
+
 namespace OpenMS
 {
+  class CompactChromatogramList;
 
   /**
    * @brief The ChromatogramExtractorAlgorithm extracts chromatograms from a MS data.
@@ -107,6 +110,62 @@ public:
         double im_extraction_window,
         const String& filter);
 
+    /**
+     * @brief Extract chromatograms for several sets of coordinates in a single pass over the input.
+     *
+     * The result is identical to calling extractChromatograms() once for
+     * each set of coordinates (e.g. for each batch of compounds), but every
+     * spectrum of @p input is only retrieved and decoded once: all sets are
+     * merged into a single list sorted by m/z which is swept through each
+     * spectrum.
+     *
+     * @param input Input spectral map
+     * @param output Output chromatograms (XICs), one vector per set of coordinates
+     * @param extraction_coordinates Sets of extraction coordinates, each sorted by m/z
+     * @param mz_extraction_window Extracts a window of this size in m/z
+     * dimension in Th or ppm
+     * @param ppm Whether mz_extraction_window is in ppm or in Th
+     * @param im_extraction_window Extracts a window of this size in ion mobility (-1 to disable)
+     * @param filter Which function to apply in m/z space (currently "tophat" only)
+     *
+     * @throw Exception::IllegalArgument if the number or sizes of @p output and @p extraction_coordinates differ or a set is not sorted
+    */
+    void extractChromatograms(const OpenSwath::SpectrumAccessPtr input,
+        std::vector< std::vector< OpenSwath::ChromatogramPtr > >& output,
+        const std::vector< std::vector<ExtractionCoordinates> >& extraction_coordinates,
+        double mz_extraction_window,
+        bool ppm,
+        double im_extraction_window,
+        const String& filter);
+
+    /**
+     * @brief Extract chromatograms for several sets of coordinates in a single pass into compact chromatogram lists.
+     *
+     * Same as the overload above, but each set of coordinates is extracted
+     * into a CompactChromatogramList which stores the retention times of @p
+     * input once (shared by all sets) and the intensities in single
+     * precision. Chromatogram k of output[i] corresponds to
+     * extraction_coordinates[i][k].
+     *
+     * @param input Input spectral map
+     * @param output Output chromatograms (will be overwritten), one list per set of coordinates
+     * @param extraction_coordinates Sets of extraction coordinates, each sorted by m/z
+     * @param mz_extraction_window Extracts a window of this size in m/z
+     * dimension in Th or ppm
+     * @param ppm Whether mz_extraction_window is in ppm or in Th
+     * @param im_extraction_window Extracts a window of this size in ion mobility (-1 to disable)
+     * @param filter Which function to apply in m/z space (currently "tophat" only)
+     *
+     * @throw Exception::IllegalArgument if a set is not sorted
+    */
+    void extractChromatograms(const OpenSwath::SpectrumAccessPtr input,
+        std::vector<CompactChromatogramList>& output,
+        const std::vector< std::vector<ExtractionCoordinates> >& extraction_coordinates,
+        double mz_extraction_window,
+        bool ppm,
+        double im_extraction_window,
+        const String& filter);
+
     /**
      * @brief Extract the next mz value and add the integrated intensity to integrated_intensity.
      *
@@ -181,9 +240,46 @@ public:
                               const bool ppm);
 
 private:
+    /// Extraction coordinate together with the chromatogram it is extracted into
+    typedef std::pair<const ExtractionCoordinates*, OpenSwath::Chromatogram*> SweepEntry_;
 
     int getFilterNr_(const String& filter);
 
+    /// Receives the intensities extracted from spectrum scan_idx (at retention time rt) for all entries of the sweep
+    typedef std::function<void(Size scan_idx, double rt, const double* intensities)> AppendFunction_;
+
+    /**
+      @brief Extracts all spectra of @p input for all entries of @p sweep (sorted by m/z)
+
+      The intensities of each spectrum are passed to @p append, spectra are
+      passed in order. If OpenMP is available (and not already used by the
+      caller), blocks of spectra are extracted in parallel, each thread using
+      its own light clone of @p input. The result does not depend on the
+      number of threads.
+    */
+    void extractSweep_(const OpenSwath::SpectrumAccessPtr input,
+                       const std::vector<SweepEntry_>& sweep,
+                       double mz_extraction_window,
+                       bool ppm,
+                       double im_extraction_window,
+                       int used_filter,
+                       const AppendFunction_& append);
+
+    /// Extracts one spectrum for all entries of @p sweep (sorted by m/z) into @p intensities (one value per entry, entries outside their RT range are not set)
+    void extractSpectrum_(const OpenSwath::SpectrumPtr& sptr,
+                          double current_rt,
+                          const std::vector<SweepEntry_>& sweep,
+                          double mz_extraction_window,
+                          bool ppm,
+                          double im_extraction_window,
+                          int used_filter,
+                          double* intensities);
+
+    /// Appends the intensities extracted from a spectrum at @p current_rt to the chromatograms of @p sweep
+    void appendSpectrum_(double current_rt,
+                         const std::vector<SweepEntry_>& sweep,
+                         const double* intensities);
+
   };
 
 }
@@ -0,0 +1,122 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2018.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: Hannes Roest $
+// $Authors: Hannes Roest $
+// --------------------------------------------------------------------------
+
+#pragma once
+
+#include <OpenMS/config.h> // OPENMS_DLLAPI
+#include <OpenMS/CONCEPT/Types.h>
+#include <OpenMS/OPENSWATHALGO/DATAACCESS/DataStructures.h>
+
+#include <boost/shared_ptr.hpp>
+
+#include <vector>
+
+namespace OpenMS
+{
+  /**
+    @brief A list of chromatograms in single precision on a shared retention time axis
+
+    Chromatograms extracted from one SWATH map all sample the retention times
+    of the spectra of that map. Instead of storing a retention time and an
+    intensity (both double precision, 16 bytes) for every data point, the
+    list keeps the retention times of the map once and each chromatogram
+    only stores the position of its first data point on that axis and its
+    intensities in single precision (4 bytes per data point). Positions are
+    only stored explicitly for chromatograms whose data points are not
+    consecutive on the axis.
+
+    Used by ChromatogramExtractorAlgorithm to keep extracted chromatograms
+    in memory until they are scored (see ChromExtractParams::compact_chromatograms).
+  */
+  class OPENMS_DLLAPI CompactChromatogramList
+  {
+
+public:
+
+    /// Default constructor (no chromatograms)
+    CompactChromatogramList();
+
+    /// Creates @p size empty chromatograms on the retention time axis @p rt_axis
+    CompactChromatogramList(Size size, const boost::shared_ptr<const std::vector<double> >& rt_axis);
+
+    /// Number of chromatograms
+    Size size() const;
+
+    /// The shared retention time axis
+    const std::vector<double>& getRTAxis() const;
+
+    /**
+      @brief Appends the data point at position @p rt_index of the retention time axis with @p intensity to chromatogram @p chrom
+
+      Positions have to be appended in increasing order.
+    */
+    void push_back(Size chrom, Size rt_index, double intensity);
+
+    /// Number of data points of chromatogram @p chrom
+    Size getNrPoints(Size chrom) const;
+
+    /// Returns chromatogram @p chrom in double precision (retention times taken from the axis)
+    OpenSwath::ChromatogramPtr getChromatogram(Size chrom) const;
+
+    /// Returns all chromatograms in double precision
+    std::vector<OpenSwath::ChromatogramPtr> getChromatograms() const;
+
+    /// Releases all chromatograms
+    void clear();
+
+protected:
+
+    /// Data of a single chromatogram
+    struct Chromatogram_
+    {
+      Chromatogram_() :
+        first_rt_index(0)
+      {
+      }
+      /// Position of the first data point on the retention time axis
+      Size first_rt_index;
+      /// Positions of all data points (only used if they are not consecutive)
+      std::vector<UInt32> rt_indices;
+      /// Intensities of the data points
+      std::vector<float> intensities;
+    };
+
+    /// The retention time axis shared by all chromatograms
+    boost::shared_ptr<const std::vector<double> > rt_axis_;
+
+    /// The chromatograms
+    std::vector<Chromatogram_> chromatograms_;
+  };
+}
+
@@ -55,10 +55,12 @@ namespace OpenMS
     (ISpectrumAccess) using the CachedmzML class which is able to read and
     write a cached mzML file.
 
-    @note This implementation is @a not thread-safe since it keeps internally a
-    single file access pointer which it moves when accessing a specific
-    data item. The caller is responsible to ensure that access is performed
-    atomically.
+    @note If the cached file is memory-mapped (see CachedmzML::isMemoryMapped),
+    data items are read directly from memory and concurrent access is safe.
+    Otherwise this implementation is @a not thread-safe since it keeps
+    internally a single file access pointer which it moves when accessing a
+    specific data item. The caller is then responsible to ensure that access
+    is performed atomically.
 
   */
   class OPENMS_DLLAPI SpectrumAccessOpenMSCached :
@@ -94,6 +96,12 @@ public:
 
     OpenSwath::SpectrumPtr getSpectrumById(int id) override;
 
+    /// Reads the requested spectra in the order in which they are stored on disk
+    std::vector<OpenSwath::SpectrumPtr> getSpectraByIds(const std::vector<std::size_t>& ids) override;
+
+    /// Asks the operating system to read the spectra in the given RT range into the page cache (only for memory-mapped files)
+    void prefetchSpectraByRT(double RT, double deltaRT) override;
+
     OpenSwath::SpectrumMeta getSpectrumMetaById(int id) const override;
 
     std::vector<std::size_t> getSpectraByRT(double RT, double deltaRT) const override;
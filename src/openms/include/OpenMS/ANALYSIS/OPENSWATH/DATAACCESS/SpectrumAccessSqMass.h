@@ -109,6 +109,9 @@ public:
 
     OpenSwath::SpectrumPtr getSpectrumById(int /* id */) override;
 
+    /// Reads all requested spectra with a single database query
+    std::vector<OpenSwath::SpectrumPtr> getSpectraByIds(const std::vector<std::size_t>& ids) override;
+
     OpenSwath::SpectrumMeta getSpectrumMetaById(int /* id */) const override;
 
     /// Load all spectra from the underlying sqMass file into memory
@@ -118,7 +121,16 @@ public:
 
     size_t getNrSpectra() const override;
 
-    OpenSwath::ChromatogramPtr getChromatogramById(int /* id */) override;
+    OpenSwath::ChromatogramPtr getChromatogramById(int id) override;
+
+    /**
+      @brief Reads the requested chromatograms restricted to a retention time range
+
+      All chromatograms are read with a single pass over the sqMass file (see
+      MzMLSqliteHandler::readChromatogramsInRTRange), only data points with
+      retention times in [@p rt_min, @p rt_max] are returned.
+    */
+    std::vector<OpenSwath::ChromatogramPtr> getChromatogramsByRTRange(const std::vector<std::size_t>& ids, double rt_min, double rt_max) const;
 
     size_t getNrChromatograms() const override;
 
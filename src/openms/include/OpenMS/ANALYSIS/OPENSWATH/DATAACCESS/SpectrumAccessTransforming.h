@@ -61,6 +61,8 @@ public:
 
     std::vector<std::size_t> getSpectraByRT(double RT, double deltaRT) const override;
 
+    void prefetchSpectraByRT(double RT, double deltaRT) override;
+
     size_t getNrSpectra() const override;
 
     OpenSwath::ChromatogramPtr getChromatogramById(int id) override;
@@ -0,0 +1,185 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2018.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: Hannes Roest $
+// $Authors: Hannes Roest $
+// --------------------------------------------------------------------------
+
+#pragma once
+
+#include <OpenMS/CONCEPT/Types.h>
+#include <OpenMS/OPENSWATHALGO/DATAACCESS/ISpectrumAccess.h>
+
+#include <condition_variable>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace OpenMS
+{
+
+  /**
+    @brief Keeps SWATH maps in memory up to a given memory budget
+
+    The read options of SwathFile only allow to keep either all SWATH maps in
+    memory or none of them (reading them from the cached files on disk each
+    time they are accessed, optionally copying the current map to memory
+    while working on it). This class manages which maps are kept in memory
+    given a budget in bytes: acquire() returns an in-memory copy
+    (SpectrumAccessOpenMSInMemory) of a map if it is resident or fits into
+    the budget and the original (on-disk) map otherwise.
+
+    Maps that are not in use (i.e. that were passed to release() as many
+    times as to acquire()) stay in memory and are evicted in least recently
+    used order once space is needed for another map. If the order in which
+    the maps will be used is known (see setSchedule()), upcoming maps are
+    loaded in a background thread while the current ones are processed, as
+    long as this does not require evicting maps that are in use or were
+    prefetched but not used yet.
+
+    The memory usage of a map is only known after it has been loaded, until
+    then the largest map loaded so far is used as estimate.
+
+    @note All functions are thread-safe. Maps are copied from a light clone
+    (see OpenSwath::ISpectrumAccess::lightClone()) of the original map, the
+    returned in-memory maps are shared between all users and should be
+    light cloned for concurrent access just like the original maps.
+  */
+  class OPENMS_DLLAPI SwathMapResidencyManager
+  {
+public:
+    /**
+      @brief Constructor
+
+      @param memory_budget Maximal memory used for in-memory maps (in bytes)
+    */
+    explicit SwathMapResidencyManager(UInt64 memory_budget);
+
+    /// Destructor (stops prefetching)
+    ~SwathMapResidencyManager();
+
+    /// Not copyable (holds a thread and mutexes)
+    SwathMapResidencyManager(const SwathMapResidencyManager& rhs) = delete;
+    SwathMapResidencyManager& operator=(const SwathMapResidencyManager& rhs) = delete;
+
+    /**
+      @brief Sets the order in which the maps will be acquired next
+
+      Maps of the schedule are prefetched in this order, acquiring a map of
+      the schedule moves prefetching on to the maps after it. Passing an
+      empty schedule stops prefetching.
+    */
+    void setSchedule(const std::vector<OpenSwath::SpectrumAccessPtr>& schedule);
+
+    /**
+      @brief Returns an in-memory copy of @p map if possible, @p map otherwise
+
+      Each call needs to be matched by a call to release() with the same @p
+      map once the returned map is not used any more.
+    */
+    OpenSwath::SpectrumAccessPtr acquire(const OpenSwath::SpectrumAccessPtr& map);
+
+    /// Marks one use of @p map (see acquire()) as finished, the in-memory copy may be evicted afterwards
+    void release(const OpenSwath::SpectrumAccessPtr& map);
+
+    /// Removes all in-memory copies that are not in use
+    void clear();
+
+    /// The memory budget (in bytes)
+    UInt64 getMemoryBudget() const;
+
+    /// Memory currently used by in-memory maps and maps being loaded (in bytes)
+    UInt64 getResidentBytes() const;
+
+    /// Whether an in-memory copy of @p map is currently kept
+    bool isResident(const OpenSwath::SpectrumAccessPtr& map) const;
+
+    /// Memory used by the spectra and chromatograms of @p map (in bytes), reads all data of the map
+    static UInt64 getMemoryUsage(OpenSwath::ISpectrumAccess& map);
+
+protected:
+    struct Entry
+    {
+      /// The original map (keeps its address valid as key)
+      OpenSwath::SpectrumAccessPtr source;
+      /// The in-memory copy (empty if not resident)
+      OpenSwath::SpectrumAccessPtr resident;
+      /// Memory used by the in-memory copy (or reserved while loading)
+      UInt64 bytes;
+      /// Whether the memory usage was measured (otherwise bytes is an estimate)
+      bool measured;
+      /// Whether the map is currently being loaded
+      bool loading;
+      /// Whether the map was prefetched and not acquired since
+      bool prefetched;
+      /// Number of acquire() calls without matching release()
+      Size users;
+      /// Time stamp of the last use (for LRU eviction)
+      UInt64 last_use;
+    };
+
+    typedef std::map<const OpenSwath::ISpectrumAccess*, Entry> EntryMap;
+
+    /// Size estimate for a map that was not loaded yet
+    UInt64 estimate_(const Entry& entry) const;
+
+    /**
+      @brief Evicts unused maps (least recently used first) until @p bytes fit into the budget
+
+      Maps with a pending prefetch are only evicted if @p evict_prefetched is set.
+      Returns whether @p bytes fit into the budget afterwards, nothing is
+      evicted if this is not possible.
+    */
+    bool makeRoom_(UInt64 bytes, bool evict_prefetched);
+
+    /// Loads @p entry into memory (called with @p lock held, releases it during loading)
+    void load_(Entry& entry, std::unique_lock<std::mutex>& lock);
+
+    /// Main loop of the prefetch thread
+    void prefetch_();
+
+    UInt64 memory_budget_;
+    UInt64 resident_bytes_;
+    UInt64 largest_map_;
+    UInt64 clock_;
+    EntryMap entries_;
+
+    std::vector<OpenSwath::SpectrumAccessPtr> schedule_;
+    /// Position of the next map to be used in schedule_
+    Size schedule_pos_;
+    bool stop_;
+
+    mutable std::mutex mutex_;
+    std::condition_variable changed_;
+    std::thread prefetch_thread_;
+  };
+
+}
@@ -12,6 +12,7 @@ SpectrumAccessOpenMSInMemory.h
 SpectrumAccessSqMass.h
 SpectrumAccessTransforming.h
 SpectrumAccessQuadMZTransforming.h
+SwathMapResidencyManager.h
 )
 
 ### add path to the filenames
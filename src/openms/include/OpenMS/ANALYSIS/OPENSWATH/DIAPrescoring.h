@@ -92,10 +92,34 @@ public:
     /**
       @brief Compute manhattan and dotprod score for all spectra which can be accessed by
       the SpectrumAccessPtr for all transitions groups in the LightTargetedExperiment.
+
+      The theoretical spectra are computed once and the spectra are scored in
+      parallel (if OpenMP is enabled); the scores are written in the order of
+      the spectra.
     */
     void operator()(OpenSwath::SpectrumAccessPtr swath_ptr,
                     OpenSwath::LightTargetedExperiment& transition_exp_used,
                     OpenSwath::IDataFrameWriter* ivw);
+
+protected:
+
+    /// theoretical spectrum of a transition group (independent of the scored spectrum)
+    struct TheoreticalSpectrum_
+    {
+      std::vector<double> masses; ///< m/z of the theoretical peaks (incl. isotopes)
+      std::vector<double> intensities_manhattan; ///< sqrt intensities, normalized to sum 1
+      std::vector<double> intensities_dotprod; ///< sqrt intensities, normalized to unit length
+    };
+
+    /// Simulate the theoretical spectrum from the library intensities of a transition group
+    void getTheoreticalSpectrum_(const std::vector<OpenSwath::LightTransition>& lt,
+                                 TheoreticalSpectrum_& theoretical) const;
+
+    /// Score a spectrum against a precomputed theoretical spectrum
+    void score_(OpenSwath::SpectrumPtr spec,
+                const TheoreticalSpectrum_& theoretical,
+                double& dotprod,
+                double& manhattan) const;
   };
 
 
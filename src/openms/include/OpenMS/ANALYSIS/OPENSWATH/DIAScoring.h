@@ -46,6 +46,7 @@
 namespace OpenMS
 {
   class TheoreticalSpectrumGenerator;
+  class OpenSwathLibraryCache;
 
   /**
     @brief Scoring of an spectrum at the peak apex of an chromatographic elution peak.
@@ -141,6 +142,10 @@ public:
     void dia_by_ion_score(SpectrumPtrType spectrum, AASequence& sequence,
                           int charge, double& bseries_score, double& yseries_score);
 
+    /// b/y ion scores for precomputed b and y ion series (see getBYSeries())
+    void dia_by_ion_score(SpectrumPtrType spectrum, const std::vector<double>& bseries,
+                          const std::vector<double>& yseries, double& bseries_score, double& yseries_score);
+
     /// Dotproduct / Manhatten score with theoretical spectrum
     void score_with_isotopes(SpectrumPtrType spectrum,
                              const std::vector<TransitionType>& transitions,
@@ -148,6 +153,32 @@ public:
                              double& manhattan);
     //@}
 
+    ///@name Library-dependent values
+    //@{
+    /// Computes the b and y ion series of a peptide (as used by dia_by_ion_score)
+    void getBYSeries(const AASequence& sequence, int charge,
+                     std::vector<double>& bseries, std::vector<double>& yseries) const;
+
+    /// Computes the theoretical isotope pattern (scaled to a maximum of 1) of an ion with the given m/z and charge (as used by the isotope scores)
+    void getTheoreticalIsotopePattern(double product_mz, int putative_fragment_charge,
+                                      std::vector<double>& isotopes, const std::string& sum_formula = "") const;
+
+    /**
+      @brief Use precomputed library-dependent values
+
+      If set, b/y ion series and theoretical isotope patterns of fragment
+      ions are taken from the cache instead of being computed for each call.
+      Values missing from the cache are computed as usual. The cache is
+      ignored if it was computed for a different number of isotopes.
+
+      @param cache The cache (not owned, needs to outlive this object), nullptr to disable
+    */
+    void setLibraryCache(const OpenSwathLibraryCache* cache);
+
+    /// Returns the cache of precomputed library-dependent values (nullptr if not set or not applicable)
+    const OpenSwathLibraryCache* getLibraryCache() const;
+    //@}
+
 private:
 
     /// Copy constructor (algorithm class)
@@ -205,6 +236,10 @@ private:
                                 int putative_fragment_charge,
                                 const std::string& sum_formula = "");
 
+    /// Pearson correlation between an experimental and a theoretical isotope pattern
+    double scoreIsotopePattern_(const std::vector<double>& isotopes_int,
+                                const std::vector<double>& theoretical_isotopes) const;
+
     // Parameters
     double dia_extract_window_;
     double dia_centroided_;
@@ -216,6 +251,9 @@ private:
     bool dia_extraction_ppm_;
 
     TheoreticalSpectrumGenerator * generator;
+
+    /// Precomputed library-dependent values (not owned)
+    const OpenSwathLibraryCache* library_cache_;
   };
 }
 
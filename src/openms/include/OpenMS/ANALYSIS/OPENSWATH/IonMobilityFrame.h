@@ -0,0 +1,120 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2018.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: Hannes Roest $
+// $Authors: Hannes Roest $
+// --------------------------------------------------------------------------
+
+#pragma once
+
+#include <OpenMS/config.h> // OPENMS_DLLAPI
+#include <OpenMS/CONCEPT/Types.h>
+#include <OpenMS/OPENSWATHALGO/DATAACCESS/DataStructures.h>
+
+#include <vector>
+
+namespace OpenMS
+{
+  /**
+    @brief The data points of one ion mobility frame, indexed by ion mobility
+
+    Ion mobility data (e.g. timsTOF PASEF frames) arrives as a single spectrum
+    holding all data points of a frame, sorted by m/z, with the ion mobility
+    of each point in a separate data array ("Ion Mobility"). Restricting such
+    a spectrum to a window in ion mobility requires looking at every data
+    point in the m/z window.
+
+    The frame keeps mobility, m/z and intensity in separate arrays sorted by
+    ion mobility and, within each mobility scan (the data points sharing an
+    ion mobility value), by m/z. A window in (m/z, ion mobility) is then found
+    by binary search over the scans and within each scan, so a query only
+    visits the scans inside the mobility window. Building the frame sorts the
+    data once, which pays off as soon as several windows are queried in the
+    same spectrum (e.g. when extracting all transitions of a DIA window).
+
+    All windows are open intervals, as in ChromatogramExtractorAlgorithm.
+  */
+  class OPENMS_DLLAPI IonMobilityFrame
+  {
+
+public:
+
+    /// Default constructor (empty frame)
+    IonMobilityFrame();
+
+    /**
+      @brief Builds the frame from the data points of @p spectrum
+
+      @exception Exception::IllegalArgument is thrown if the spectrum has no ion mobility array ("Ion Mobility") of the correct size
+    */
+    explicit IonMobilityFrame(const OpenSwath::SpectrumPtr& spectrum);
+
+    /// Number of data points
+    Size size() const;
+
+    /// Number of mobility scans (distinct ion mobility values)
+    Size getNrScans() const;
+
+    /// Sum of the intensities of all data points inside (mz_lower, mz_upper) and (im_lower, im_upper)
+    double sumIntensity(double mz_lower, double mz_upper, double im_lower, double im_upper) const;
+
+    /**
+      @brief Returns the data points inside (im_lower, im_upper) as a spectrum sorted by m/z
+
+      The spectrum has an m/z, an intensity and an ion mobility array ("Ion Mobility").
+    */
+    OpenSwath::SpectrumPtr extractSpectrum(double im_lower, double im_upper) const;
+
+    /// Ion mobility of the data points (sorted)
+    const std::vector<double>& getMobilities() const;
+
+    /// m/z of the data points (sorted within each mobility scan)
+    const std::vector<double>& getMZs() const;
+
+    /// Intensities of the data points
+    const std::vector<double>& getIntensities() const;
+
+protected:
+
+    /// Range [first, last) of the scans strictly inside (im_lower, im_upper)
+    void scanRange_(double im_lower, double im_upper, Size& first, Size& last) const;
+
+    /// Ion mobility, m/z and intensity of the data points (structure of arrays)
+    std::vector<double> im_;
+    std::vector<double> mz_;
+    std::vector<double> int_;
+
+    /// Ion mobility of each scan
+    std::vector<double> scan_im_;
+    /// Position of the first data point of each scan (plus one past the last data point)
+    std::vector<Size> scan_begin_;
+  };
+}
+
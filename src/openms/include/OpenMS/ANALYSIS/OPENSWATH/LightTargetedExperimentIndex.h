@@ -0,0 +1,117 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2018.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: Hannes Roest $
+// $Authors: Hannes Roest $
+// --------------------------------------------------------------------------
+
+
+#pragma once
+
+#include <OpenMS/CONCEPT/Types.h>
+#include <OpenMS/OPENSWATHALGO/DATAACCESS/TransitionExperiment.h>
+
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace OpenMS
+{
+
+  /**
+    @brief Index over the transitions and compounds of a LightTargetedExperiment
+
+    Sorts the transitions by precursor m/z and the compounds by (normalized)
+    retention time and maps compound and protein identifiers to their
+    positions, such that transitions of a precursor m/z range (a SWATH
+    window), of a retention time range or of a set of compounds can be
+    selected in O(log n + k) instead of scanning the whole library. All
+    results are indices into the vectors of the indexed experiment and are
+    returned in library order.
+
+    @note The index stores a reference to the experiment, which needs to
+    stay unchanged while the index is in use. If several compounds (or
+    proteins) share the same identifier, only the first one is indexed.
+  */
+  class OPENMS_DLLAPI LightTargetedExperimentIndex
+  {
+public:
+    /// Builds the index for @p experiment
+    explicit LightTargetedExperimentIndex(const OpenSwath::LightTargetedExperiment& experiment);
+
+    /// The indexed experiment
+    const OpenSwath::LightTargetedExperiment& getExperiment() const;
+
+    /// Position of the compound with identifier @p id (-1 if not present)
+    SignedSize getCompoundIndex(const std::string& id) const;
+
+    /// Position of the protein with identifier @p id (-1 if not present)
+    SignedSize getProteinIndex(const std::string& id) const;
+
+    /// Position of the compound of the transition at @p transition_index (-1 if its compound is not present)
+    SignedSize getTransitionCompound(Size transition_index) const;
+
+    /// Positions of all transitions of the compound at @p compound_index
+    const std::vector<Size>& getCompoundTransitions(Size compound_index) const;
+
+    /// Selects all transitions with lower < precursor m/z < upper
+    void selectTransitions(double lower, double upper, std::vector<Size>& result) const;
+
+    /**
+      @brief Selects all transitions with lower < precursor m/z < upper of compounds with rt_start <= RT <= rt_end
+
+      Transitions without a compound are not selected.
+    */
+    void selectTransitions(double lower, double upper, double rt_start, double rt_end, std::vector<Size>& result) const;
+
+    /// Selects all compounds with rt_start <= RT <= rt_end
+    void selectCompounds(double rt_start, double rt_end, std::vector<Size>& result) const;
+
+    /// Appends the positions of all transitions of the given compounds to @p result (in library order)
+    void selectCompoundTransitions(const std::vector<Size>& compound_indices, std::vector<Size>& result) const;
+
+protected:
+    const OpenSwath::LightTargetedExperiment& experiment_;
+
+    /// (precursor m/z, transition position), sorted
+    std::vector<std::pair<double, Size> > transitions_by_mz_;
+    /// (RT, compound position), sorted
+    std::vector<std::pair<double, Size> > compounds_by_rt_;
+    /// compound position of each transition
+    std::vector<SignedSize> transition_compound_;
+    /// transition positions of each compound
+    std::vector<std::vector<Size> > compound_transitions_;
+
+    std::unordered_map<std::string, Size> compound_index_;
+    std::unordered_map<std::string, Size> protein_index_;
+  };
+
+}
@@ -209,6 +209,18 @@ public:
       ms1_map_ = ms1_map;
     }
 
+    /** @brief Use precomputed library-dependent values for DIA scoring
+     *
+     * The cache is not owned and has to stay valid during scoring (see
+     * DIAScoring::setLibraryCache). Pass nullptr to compute all values on the
+     * fly (the default).
+     *
+    */
+    void setLibraryCache(const OpenSwathLibraryCache* cache)
+    {
+      diascoring_.setLibraryCache(cache);
+    }
+
     /** @brief Map the chromatograms to the transitions.
      *
      * Map an input chromatogram experiment (mzML) and transition list (TraML)
@@ -51,8 +51,13 @@
 #include <OpenMS/OPENSWATHALGO/ALGO/Scoring.h>
 #include <OpenMS/OPENSWATHALGO/ALGO/StatsHelpers.h>
 
+#include <exception>
 #include <numeric>
 
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
 //#define DEBUG_TRANSITIONGROUPPICKER
 
 namespace OpenMS
@@ -108,6 +113,12 @@ public:
       - total_xic (fragment trace XIC sum)
       - peak_apices_sum
 
+      If "resample_to_common_grid" is set, all chromatograms of the group are
+      first resampled onto a shared RT grid (see resampleToCommonGrid).
+
+      @note The picked and smoothed chromatograms are kept in buffers of this
+      object and reused by the next call, an instance must therefore not be
+      shared between threads (use pickTransitionGroups for parallel picking).
     */
     template <typename SpectrumT, typename TransitionT>
     void pickTransitionGroup(MRMTransitionGroup<SpectrumT, TransitionT>& transition_group)
@@ -115,8 +126,15 @@ public:
       OPENMS_PRECONDITION(transition_group.isInternallyConsistent(), "Consistent state required")
       OPENMS_PRECONDITION(transition_group.chromatogramIdsMatch(), "Chromatogram native IDs need to match keys in transition group")
 
-      std::vector<MSChromatogram > picked_chroms;
-      std::vector<MSChromatogram > smoothed_chroms;
+      if (resample_to_common_grid_)
+      {
+        resampleToCommonGrid(transition_group);
+      }
+
+      // reuse the buffers of the last call (and the memory of their peak containers)
+      std::vector<MSChromatogram >& picked_chroms = picked_chroms_;
+      std::vector<MSChromatogram >& smoothed_chroms = smoothed_chroms_;
+      Size nr_picked = 0;
 
       // Pick fragment ion chromatograms
       for (Size k = 0; k < transition_group.getChromatograms().size(); k++)
@@ -132,11 +150,7 @@ public:
           continue;
         }
 
-        MSChromatogram picked_chrom, smoothed_chrom;
-        picker_.pickChromatogram(chromatogram, picked_chrom, smoothed_chrom);
-        picked_chrom.sortByIntensity();
-        picked_chroms.push_back(picked_chrom);
-        smoothed_chroms.push_back(smoothed_chrom);
+        pickChromatogramBuffered_(chromatogram, nr_picked++);
       }
 
       // Pick precursor chromatograms
@@ -144,15 +158,12 @@ public:
       {
         for (Size k = 0; k < transition_group.getPrecursorChromatograms().size(); k++)
         {
-          SpectrumT picked_chrom, smoothed_chrom;
           SpectrumT& chromatogram = transition_group.getPrecursorChromatograms()[k];
-
-          picker_.pickChromatogram(chromatogram, picked_chrom, smoothed_chrom);
-          picked_chrom.sortByIntensity();
-          picked_chroms.push_back(picked_chrom);
-          smoothed_chroms.push_back(smoothed_chrom);
+          pickChromatogramBuffered_(chromatogram, nr_picked++);
         }
       }
+      picked_chroms.resize(nr_picked);
+      smoothed_chroms.resize(nr_picked);
 
       // Find features (peak groups) in this group of transitions.
       // While there are still peaks left, one will be picked and used to create
@@ -210,6 +221,97 @@ public:
 
     }
 
+    /**
+      @brief Pick many transition groups at once
+
+      Equivalent to calling pickTransitionGroup on each group, but the groups
+      are processed in parallel if OpenMP is enabled. Every thread works on its
+      own copy of this picker, so the peak pickers and chromatogram buffers are
+      allocated once per thread instead of once per group. The result does not
+      depend on the number of threads.
+
+      @param transition_groups The groups to pick (features are added to each group)
+
+      @throw The first exception thrown while picking any of the groups
+    */
+    template <typename SpectrumT, typename TransitionT>
+    void pickTransitionGroups(const std::vector<MRMTransitionGroup<SpectrumT, TransitionT>* >& transition_groups) const
+    {
+#ifdef _OPENMP
+      std::vector<MRMTransitionGroupPicker> pickers(omp_get_max_threads(), *this);
+#else
+      std::vector<MRMTransitionGroupPicker> pickers(1, *this);
+#endif
+
+      Size err_count = 0;
+      std::exception_ptr first_error;
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic, 1)
+#endif
+      for (SignedSize i = 0; i < (SignedSize)transition_groups.size(); ++i)
+      {
+#ifdef _OPENMP
+        MRMTransitionGroupPicker& picker = pickers[omp_get_thread_num()];
+#else
+        MRMTransitionGroupPicker& picker = pickers[0];
+#endif
+        try
+        {
+          picker.pickTransitionGroup(*transition_groups[i]);
+        }
+        catch (...)
+        {
+#ifdef _OPENMP
+#pragma omp critical (MRMTransitionGroupPicker_error)
+#endif
+          {
+            if (err_count++ == 0) first_error = std::current_exception();
+          }
+        }
+      }
+      if (first_error) std::rethrow_exception(first_error);
+    }
+
+    /**
+      @brief Resample all chromatograms of a group onto a shared RT grid
+
+      The grid is given by the RT values of the fragment ion chromatogram with
+      the most data points. All other fragment and precursor chromatograms are
+      resampled onto it (conserving their total intensity, see
+      LinearResamplerAlign), chromatograms that are already sampled on the
+      grid are left untouched. Subsequent alignment of the traces during
+      picking and scoring then operates on identical time points.
+
+      @note Float data arrays of resampled chromatograms are removed, as they
+      no longer match the data points.
+    */
+    template <typename SpectrumT, typename TransitionT>
+    void resampleToCommonGrid(MRMTransitionGroup<SpectrumT, TransitionT>& transition_group) const
+    {
+      std::vector<SpectrumT>& chromatograms = transition_group.getChromatograms();
+      if (chromatograms.empty()) return;
+
+      Size ref_idx = 0;
+      for (Size k = 1; k < chromatograms.size(); k++)
+      {
+        if (chromatograms[k].size() > chromatograms[ref_idx].size()) ref_idx = k;
+      }
+      const SpectrumT& ref_chromatogram = chromatograms[ref_idx];
+      if (ref_chromatogram.size() < 2) return;
+
+      SpectrumT grid;
+      prepareMasterContainer_(ref_chromatogram, grid, ref_chromatogram.front().getRT(), ref_chromatogram.back().getRT());
+
+      for (Size k = 0; k < chromatograms.size(); k++)
+      {
+        if (k != ref_idx) resampleOntoGrid_(chromatograms[k], grid);
+      }
+      for (Size k = 0; k < transition_group.getPrecursorChromatograms().size(); k++)
+      {
+        resampleOntoGrid_(transition_group.getPrecursorChromatograms()[k], grid);
+      }
+    }
+
     /// Create feature from a vector of chromatograms and a specified peak
     template <typename SpectrumT, typename TransitionT>
     MRMFeature createMRMFeature(const MRMTransitionGroup<SpectrumT, TransitionT>& transition_group,
@@ -705,6 +807,34 @@ protected:
     /// Assignment operator is protected for algorithm
     MRMTransitionGroupPicker& operator=(const MRMTransitionGroupPicker& rhs);
 
+    /// Pick @p chromatogram into slot @p idx of the picked / smoothed buffers (growing them if needed)
+    void pickChromatogramBuffered_(const MSChromatogram& chromatogram, Size idx);
+
+    /**
+      @brief Resample a chromatogram in place onto the RT values of @p grid
+
+      Empty chromatograms and those already sampled at the RT values of the grid are not changed.
+    */
+    template <typename SpectrumT>
+    void resampleOntoGrid_(SpectrumT& chromatogram, const SpectrumT& grid) const
+    {
+      if (chromatogram.empty()) return;
+      if (chromatogram.size() == grid.size())
+      {
+        bool same_grid = true;
+        for (Size i = 0; i < grid.size() && same_grid; i++)
+        {
+          same_grid = (chromatogram[i].getRT() == grid[i].getRT());
+        }
+        if (same_grid) return;
+      }
+
+      SpectrumT resampled = resampleChromatogram_(chromatogram, grid, grid.front().getRT(), grid.back().getRT());
+      chromatogram.resize(resampled.size());
+      std::copy(resampled.begin(), resampled.end(), chromatogram.begin());
+      chromatogram.getFloatDataArrays().clear();
+    }
+
     /**
       @brief Select matching precursor or fragment ion chromatogram
     */
@@ -1001,7 +1131,7 @@ protected:
     */
     template <typename SpectrumT>
     void prepareMasterContainer_(const SpectrumT& ref_chromatogram,
-                                 SpectrumT& master_peak_container, double left_boundary, double right_boundary)
+                                 SpectrumT& master_peak_container, double left_boundary, double right_boundary) const
     {
       OPENMS_PRECONDITION(master_peak_container.empty(), "Master peak container must be empty")
 
@@ -1037,7 +1167,7 @@ protected:
     */
     template <typename SpectrumT>
     SpectrumT resampleChromatogram_(const SpectrumT& chromatogram,
-                                    const SpectrumT& master_peak_container, double left_boundary, double right_boundary)
+                                    const SpectrumT& master_peak_container, double left_boundary, double right_boundary) const
     {
       // get the start / end point of this chromatogram => then add one more
       // point beyond the two boundaries to make the resampling accurate also
@@ -1075,6 +1205,7 @@ protected:
     double min_peak_width_;
     double recalculate_peaks_max_z_;
     double resample_boundary_;
+    bool resample_to_common_grid_;
 
     /**
       @brief Which method to use for selecting peaks' boundaries
@@ -1085,6 +1216,10 @@ protected:
 
     PeakPickerMRM picker_;
     PeakIntegrator pi_;
+
+    /// buffers for the picked and smoothed chromatograms, reused across calls of pickTransitionGroup
+    std::vector<MSChromatogram> picked_chroms_;
+    std::vector<MSChromatogram> smoothed_chroms_;
   };
 }
 
@@ -76,6 +76,11 @@ namespace OpenMS
      * This assumes that the consensus feature is only from one (SWATH) map
      * This assumes that the consensus map is sorted by intensity
      *
+     * Candidate traces for each seed are found by binary search in an
+     * RT-sorted index (apex inside the seed trace and within
+     * max_rt_apex_difference), large candidate sets are scored in parallel.
+     * The result does not depend on the number of threads.
+     *
     */
     void createPseudoSpectra(const ConsensusMap& map, MSExperiment& pseudo_spectra,
         Size min_peak_nr, double min_correlation, int max_lag,
@@ -39,6 +39,7 @@
 #include <OpenMS/ANALYSIS/TARGETED/TargetedExperiment.h>
 #include <OpenMS/OPENSWATHALGO/DATAACCESS/TransitionExperiment.h>
 #include <OpenMS/ANALYSIS/OPENSWATH/MRMFeatureFinderScoring.h>
+#include <OpenMS/ANALYSIS/OPENSWATH/LightTargetedExperimentIndex.h>
 
 namespace OpenMS
 {
@@ -125,6 +126,24 @@ public:
                                        double min_upper_edge_dist,
                                        double lower, double upper);
 
+    /**
+      @brief Select transitions between lower and upper and write them into the new TargetedExperiment
+
+      Version for an indexed LightTargetedExperiment, produces the same
+      result as the version above without scanning all transitions of the
+      library.
+
+      @param[in] index Index of the transition list for selection
+      @param[out] selected_transitions Selected transitions for SWATH window
+      @param[in] min_upper_edge_dist Distance in Th to the upper edge
+      @param[in] lower Lower edge of SWATH window (in Th)
+      @param[in] upper Upper edge of SWATH window (in Th)
+    */
+    static void selectSwathTransitions(const LightTargetedExperimentIndex& index,
+                                       OpenSwath::LightTargetedExperiment& selected_transitions,
+                                       double min_upper_edge_dist,
+                                       double lower, double upper);
+
     /**
       @brief Get the lower / upper offset for this SWATH map and do some sanity checks
 
@@ -0,0 +1,132 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2018.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: Hannes Roest $
+// $Authors: Hannes Roest $
+// --------------------------------------------------------------------------
+
+#pragma once
+
+#include <OpenMS/CONCEPT/Types.h>
+#include <OpenMS/DATASTRUCTURES/String.h>
+#include <OpenMS/OPENSWATHALGO/DATAACCESS/TransitionExperiment.h>
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace OpenMS
+{
+  class DIAScoring;
+
+  /**
+    @brief Precomputed library-dependent values for DIA scoring
+
+    Some of the DIA scores (see DIAScoring) only depend on the assay library
+    and not on the data: the singly charged b and y ion series of each
+    peptide and the theoretical (averagine) isotope pattern of each fragment
+    ion. When the same library is used to analyze many runs, these can be
+    computed once with compute(), stored next to the library with store() and
+    loaded for each run with load(). DIAScoring will then use them instead of
+    computing them again for each peak group (see
+    DIAScoring::setLibraryCache()).
+
+    The cache contains a fingerprint of the library (identifiers, sequences,
+    m/z and charge states) and of the scoring parameters it was created with,
+    use matches() to decide whether a stored cache can be used for a given
+    library and DIAScoring object.
+
+    @note The cache is not modified during scoring and can be shared by
+    all threads.
+  */
+  class OPENMS_DLLAPI OpenSwathLibraryCache
+  {
+public:
+    /// Precomputed values of a compound
+    struct CompoundEntry
+    {
+      /// m/z values of the singly charged b ion series
+      std::vector<double> bseries;
+      /// m/z values of the singly charged y ion series
+      std::vector<double> yseries;
+    };
+
+    /// Default constructor (empty cache)
+    OpenSwathLibraryCache();
+
+    /**
+      @brief Computes all library-dependent values
+
+      @param library The assay library
+      @param diascoring The scoring object (with its final parameters) that will use the cache
+    */
+    void compute(const OpenSwath::LightTargetedExperiment& library, const DIAScoring& diascoring);
+
+    /// Returns whether the cache was computed for this library and these DIAScoring parameters
+    bool matches(const OpenSwath::LightTargetedExperiment& library, const DIAScoring& diascoring) const;
+
+    /**
+      @brief Stores the cache to a (binary) file
+
+      @exception Exception::UnableToCreateFile is thrown if the file cannot be created
+    */
+    void store(const String& filename) const;
+
+    /**
+      @brief Loads a cache from a file created by store()
+
+      @exception Exception::FileNotFound is thrown if the file does not exist
+      @exception Exception::ParseError is thrown if the file is not a valid cache file
+    */
+    void load(const String& filename);
+
+    /// Returns the precomputed values of a compound (nullptr if not available)
+    const CompoundEntry* getCompound(const std::string& compound_id) const;
+
+    /// Returns the theoretical isotope pattern of a transition (nullptr if not available)
+    const std::vector<double>* getIsotopePattern(const std::string& transition_id) const;
+
+    /// Number of isotopes the isotope patterns were computed for
+    Int getNrIsotopes() const;
+
+    /// Returns whether the cache is empty
+    bool empty() const;
+
+protected:
+    /// Fingerprint of the library and the parameters relevant for the cache
+    static UInt64 fingerprint_(const OpenSwath::LightTargetedExperiment& library, Int nr_isotopes);
+
+    Int nr_isotopes_;
+    UInt64 fingerprint_value_;
+    std::unordered_map<std::string, CompoundEntry> compounds_;
+    std::unordered_map<std::string, std::vector<double> > isotope_patterns_;
+  };
+
+}
@@ -43,10 +43,17 @@
 
 #include <sqlite3.h>
 
+#include <boost/shared_ptr.hpp>
+
 #include <fstream>
+#include <sstream>
 
 namespace OpenMS
 {
+  namespace Internal
+  {
+    class OSWInsertEngine;
+  }
 
   /**
    * @brief Class to write out an OpenSwath OSW SQLite output (PyProphet input)
@@ -54,9 +61,40 @@ namespace OpenMS
    * The class can take a FeatureMap and create a set of string from it
    * suitable for output to OSW using the prepareLine function.
    *
+   * Alternatively, prepareRows creates the table rows for a FeatureMap which
+   * can then be handed to writeRows. Rows can also be created directly by
+   * the caller (without a FeatureMap). writeRows returns immediately, the
+   * rows are inserted by a background thread through prepared statements
+   * (one transaction for all rows that accumulated in the meantime, the
+   * database is kept in WAL journal mode while writing). Call flush() to
+   * wait until all rows are written.
+   *
    */
   class OPENMS_DLLAPI OpenSwathOSWWriter
   {
+  public:
+
+    /// Tables (and sets of columns) that rows can be written to
+    enum Table
+    {
+      FEATURE,
+      FEATURE_MS1,
+      FEATURE_PRECURSOR,
+      FEATURE_MS2,
+      FEATURE_TRANSITION,     ///< FEATURE_TRANSITION table, standard columns
+      FEATURE_TRANSITION_UIS, ///< FEATURE_TRANSITION table, including the UIS score columns
+      SIZE_OF_TABLE
+    };
+
+    /// A single table row
+    struct Row
+    {
+      Table table;
+      /// Values in the order of getColumns(table) as SQL literals ("NULL" for missing values)
+      std::vector<String> values;
+    };
+
+  private:
     String output_filename_;
     String input_filename_;
     OpenMS::UInt64 run_id_;
@@ -64,6 +102,16 @@ namespace OpenMS
     bool use_ms1_traces_;
     bool sonar_;
     bool enable_uis_scoring_;
+    boost::shared_ptr<Internal::OSWInsertEngine> engine_;
+
+    /// Convert a value to an SQL literal (same formatting as streaming it into an SQL statement)
+    template <typename T>
+    static String toSQL_(const T& value)
+    {
+      std::stringstream ss;
+      ss << value;
+      return ss.str();
+    }
 
   public:
 
@@ -238,6 +286,11 @@ namespace OpenMS
       }
 
       sqlite3_close(db);
+
+      if (doWrite_)
+      {
+        startEngine_();
+      }
     }
 
     /**
@@ -298,29 +351,29 @@ namespace OpenMS
     }
 
     /**
-     * @brief Prepare a single line (feature) for output
+     * @brief Prepare the table rows of a single transition group for output
      *
-     * The result can be flushed to disk using writeLines (either line by line
-     * or after collecting several lines).
+     * The result can be written using writeRows (either for each transition
+     * group or after collecting rows of several transition groups).
      *
      * @param pep The compound (peptide/metabolite) used for extraction
-     * @param transition The transition used for extraction 
-     * @param output The feature map containing all features (each feature will generate one entry in the output)
+     * @param transition The transition used for extraction
+     * @param output The feature map containing all features (each feature will generate rows in several tables)
      * @param id The transition group identifier (peptide/metabolite id)
-     *
-     * @returns A string to be written using writeLines
+     * @param rows The rows are appended to this vector
      *
      */
-    String prepareLine(const OpenSwath::LightCompound& /* pep */,
+    void prepareRows(const OpenSwath::LightCompound& /* pep */,
         const OpenSwath::LightTransition* /* transition */,
-        FeatureMap& output, String id) const
+        FeatureMap& output, String id, std::vector<Row>& rows) const
     {
-      std::stringstream sql, sql_feature, sql_feature_ms1, sql_feature_ms1_precursor, sql_feature_ms2, sql_feature_ms2_transition, sql_feature_uis_transition;
+      std::vector<Row> rows_feature, rows_feature_ms1, rows_feature_ms1_precursor, rows_feature_ms2, rows_feature_ms2_transition, rows_feature_uis_transition;
+      const String run_id = toSQL_(*(int64_t*)&run_id_); // Conversion from UInt64 to int64_t to support SQLite
 
       for (FeatureMap::iterator feature_it = output.begin(); feature_it != output.end(); ++feature_it)
       {
         UInt64 uint64_feature_id = feature_it->getUniqueId();
-        int64_t feature_id = *(int64_t*)&uint64_feature_id; // Conversion from UInt64 to int64_t to support SQLite
+        const String feature_id = toSQL_(*(int64_t*)&uint64_feature_id); // Conversion from UInt64 to int64_t to support SQLite
 
         for (std::vector<Feature>::iterator sub_it = feature_it->getSubordinates().begin(); sub_it != feature_it->getSubordinates().end(); ++sub_it)
         {
@@ -331,198 +384,129 @@ namespace OpenMS
             {
               total_mi = sub_it->getMetaValue("total_mi").toString();
             }
-            sql_feature_ms2_transition  << "INSERT INTO FEATURE_TRANSITION (FEATURE_ID, TRANSITION_ID, AREA_INTENSITY, TOTAL_AREA_INTENSITY, APEX_INTENSITY, TOTAL_MI) VALUES (" 
-                                        << feature_id << ", " 
-                                        << sub_it->getMetaValue("native_id") << ", " 
-                                        << sub_it->getIntensity() << ", " 
-                                        << sub_it->getMetaValue("total_xic") << ", " 
-                                        << sub_it->getMetaValue("peak_apex_int") << ", " 
-                                        << total_mi << "); ";
+            Row row = {FEATURE_TRANSITION, std::vector<String>()};
+            row.values.push_back(feature_id);
+            row.values.push_back(toSQL_(sub_it->getMetaValue("native_id")));
+            row.values.push_back(toSQL_(sub_it->getIntensity()));
+            row.values.push_back(toSQL_(sub_it->getMetaValue("total_xic")));
+            row.values.push_back(toSQL_(sub_it->getMetaValue("peak_apex_int")));
+            row.values.push_back(total_mi);
+            rows_feature_ms2_transition.push_back(row);
           }
           else if (sub_it->metaValueExists("FeatureLevel") && sub_it->getMetaValue("FeatureLevel") == "MS1" && sub_it->getIntensity() > 0.0)
           {
             std::vector<String> precursor_id;
             OpenMS::String(sub_it->getMetaValue("native_id")).split(OpenMS::String("Precursor_i"), precursor_id);
-            sql_feature_ms1_precursor  << "INSERT INTO FEATURE_PRECURSOR (FEATURE_ID, ISOTOPE, AREA_INTENSITY, APEX_INTENSITY) VALUES (" 
-                                        << feature_id << ", " 
-                                        << precursor_id[1] << ", " 
-                                        << sub_it->getIntensity() << ", " 
-                                        << sub_it->getMetaValue("peak_apex_int") << "); ";
+            Row row = {FEATURE_PRECURSOR, std::vector<String>()};
+            row.values.push_back(feature_id);
+            row.values.push_back(precursor_id[1]);
+            row.values.push_back(toSQL_(sub_it->getIntensity()));
+            row.values.push_back(toSQL_(sub_it->getMetaValue("peak_apex_int")));
+            rows_feature_ms1_precursor.push_back(row);
           }
         }
 
-        sql_feature << "INSERT INTO FEATURE (ID, RUN_ID, PRECURSOR_ID, EXP_RT, NORM_RT, DELTA_RT, LEFT_WIDTH, RIGHT_WIDTH) VALUES (" 
-                    << feature_id << ", '" 
-                    << *(int64_t*)&run_id_ << "', " 
-                    << id << ", " 
-                    << feature_it->getRT() << ", " 
-                    << feature_it->getMetaValue("norm_RT") << ", " 
-                    << feature_it->getMetaValue("delta_rt") << ", " 
-                    << feature_it->getMetaValue("leftWidth") << ", " 
-                    << feature_it->getMetaValue("rightWidth") << "); ";
-
-        sql_feature_ms2 << "INSERT INTO FEATURE_MS2 (FEATURE_ID, AREA_INTENSITY, TOTAL_AREA_INTENSITY, APEX_INTENSITY, TOTAL_MI, VAR_BSERIES_SCORE, VAR_DOTPROD_SCORE, VAR_INTENSITY_SCORE, VAR_ISOTOPE_CORRELATION_SCORE, VAR_ISOTOPE_OVERLAP_SCORE, VAR_LIBRARY_CORR, VAR_LIBRARY_DOTPROD, VAR_LIBRARY_MANHATTAN, VAR_LIBRARY_RMSD, VAR_LIBRARY_ROOTMEANSQUARE, VAR_LIBRARY_SANGLE, VAR_LOG_SN_SCORE, VAR_MANHATTAN_SCORE, VAR_MASSDEV_SCORE, VAR_MASSDEV_SCORE_WEIGHTED, VAR_MI_SCORE, VAR_MI_WEIGHTED_SCORE, VAR_MI_RATIO_SCORE, VAR_NORM_RT_SCORE, VAR_XCORR_COELUTION,VAR_XCORR_COELUTION_WEIGHTED, VAR_XCORR_SHAPE, VAR_XCORR_SHAPE_WEIGHTED, VAR_YSERIES_SCORE, VAR_ELUTION_MODEL_FIT_SCORE, VAR_SONAR_LAG, VAR_SONAR_SHAPE, VAR_SONAR_LOG_SN, VAR_SONAR_LOG_DIFF, VAR_SONAR_LOG_TREND, VAR_SONAR_RSQ) VALUES (" 
-                        << feature_id << ", " 
-                        << feature_it->getIntensity() << ", " 
-                        << getScore(*feature_it, "total_xic") << ", " 
-                        << getScore(*feature_it, "peak_apices_sum") << ", " 
-                        << getScore(*feature_it, "total_mi") << ", " 
-                        << getScore(*feature_it, "var_bseries_score") << ", " 
-                        << getScore(*feature_it, "var_dotprod_score") << ", " 
-                        << getScore(*feature_it, "var_intensity_score") << ", " 
-                        << getScore(*feature_it, "var_isotope_correlation_score") << ", " 
-                        << getScore(*feature_it, "var_isotope_overlap_score") << ", " 
-                        << getScore(*feature_it, "var_library_corr") << ", " 
-                        << getScore(*feature_it, "var_library_dotprod") << ", " 
-                        << getScore(*feature_it, "var_library_manhattan") << ", " 
-                        << getScore(*feature_it, "var_library_rmsd") << ", " 
-                        << getScore(*feature_it, "var_library_rootmeansquare") << ", " 
-                        << getScore(*feature_it, "var_library_sangle") << ", " 
-                        << getScore(*feature_it, "var_log_sn_score") << ", " 
-                        << getScore(*feature_it, "var_manhatt_score") << ", " 
-                        << getScore(*feature_it, "var_massdev_score") << ", " 
-                        << getScore(*feature_it, "var_massdev_score_weighted") << ", " 
-                        << getScore(*feature_it, "var_mi_score") << ", " 
-                        << getScore(*feature_it, "var_mi_weighted_score") << ", " 
-                        << getScore(*feature_it, "var_mi_ratio_score") << ", " 
-                        << getScore(*feature_it, "var_norm_rt_score") << ", " 
-                        << getScore(*feature_it, "var_xcorr_coelution") << ", " 
-                        << getScore(*feature_it, "var_xcorr_coelution_weighted") << ", " 
-                        << getScore(*feature_it, "var_xcorr_shape") << ", " 
-                        << getScore(*feature_it, "var_xcorr_shape_weighted") << ", " 
-                        << getScore(*feature_it, "var_yseries_score") << ", " 
-                        << getScore(*feature_it, "var_elution_model_fit_score") << ", " 
-                        << getScore(*feature_it, "var_sonar_lag") << ", "
-                        << getScore(*feature_it, "var_sonar_shape") << ", " 
-                        << getScore(*feature_it, "var_sonar_log_sn") << ", " 
-                        << getScore(*feature_it, "var_sonar_log_diff") << ", " 
-                        << getScore(*feature_it, "var_sonar_log_trend") << ", " 
-                        << getScore(*feature_it, "var_sonar_rsq") << "); ";
-
-        if (use_ms1_traces_)
+        Row row_feature = {FEATURE, std::vector<String>()};
+        row_feature.values.push_back(feature_id);
+        row_feature.values.push_back(run_id);
+        row_feature.values.push_back(id);
+        row_feature.values.push_back(toSQL_(feature_it->getRT()));
+        row_feature.values.push_back(toSQL_(feature_it->getMetaValue("norm_RT")));
+        row_feature.values.push_back(toSQL_(feature_it->getMetaValue("delta_rt")));
+        row_feature.values.push_back(toSQL_(feature_it->getMetaValue("leftWidth")));
+        row_feature.values.push_back(toSQL_(feature_it->getMetaValue("rightWidth")));
+        rows_feature.push_back(row_feature);
+
+        static const char* ms2_scores[] = {"total_xic", "peak_apices_sum", "total_mi", "var_bseries_score", "var_dotprod_score",
+          "var_intensity_score", "var_isotope_correlation_score", "var_isotope_overlap_score", "var_library_corr",
+          "var_library_dotprod", "var_library_manhattan", "var_library_rmsd", "var_library_rootmeansquare",
+          "var_library_sangle", "var_log_sn_score", "var_manhatt_score", "var_massdev_score", "var_massdev_score_weighted",
+          "var_mi_score", "var_mi_weighted_score", "var_mi_ratio_score", "var_norm_rt_score", "var_xcorr_coelution",
+          "var_xcorr_coelution_weighted", "var_xcorr_shape", "var_xcorr_shape_weighted", "var_yseries_score",
+          "var_elution_model_fit_score", "var_sonar_lag", "var_sonar_shape", "var_sonar_log_sn", "var_sonar_log_diff",
+          "var_sonar_log_trend", "var_sonar_rsq"};
+        Row row_ms2 = {FEATURE_MS2, std::vector<String>()};
+        row_ms2.values.push_back(feature_id);
+        row_ms2.values.push_back(toSQL_(feature_it->getIntensity()));
+        for (Size i = 0; i < sizeof(ms2_scores) / sizeof(ms2_scores[0]); ++i)
         {
-          sql_feature_ms1 << "INSERT INTO FEATURE_MS1 (FEATURE_ID, AREA_INTENSITY, APEX_INTENSITY, VAR_MASSDEV_SCORE, VAR_MI_SCORE, VAR_MI_CONTRAST_SCORE, VAR_MI_COMBINED_SCORE, VAR_ISOTOPE_CORRELATION_SCORE, VAR_ISOTOPE_OVERLAP_SCORE, VAR_XCORR_COELUTION, VAR_XCORR_COELUTION_CONTRAST, VAR_XCORR_COELUTION_COMBINED, VAR_XCORR_SHAPE, VAR_XCORR_SHAPE_CONTRAST, VAR_XCORR_SHAPE_COMBINED) VALUES (" 
-                          << feature_id << ", " 
-                          << getScore(*feature_it, "ms1_area_intensity") << ", " 
-                          << getScore(*feature_it, "ms1_apex_intensity") << ", " 
-                          << getScore(*feature_it, "var_ms1_ppm_diff") << ", " 
-                          << getScore(*feature_it, "var_ms1_mi_score") << ", " 
-                          << getScore(*feature_it, "var_ms1_mi_contrast_score") << ", " 
-                          << getScore(*feature_it, "var_ms1_mi_combined_score") << ", " 
-                          << getScore(*feature_it, "var_ms1_isotope_correlation") << ", " 
-                          << getScore(*feature_it, "var_ms1_isotope_overlap") << ", " 
-                          << getScore(*feature_it, "var_ms1_xcorr_coelution") << ", " 
-                          << getScore(*feature_it, "var_ms1_xcorr_coelution_contrast") << ", " 
-                          << getScore(*feature_it, "var_ms1_xcorr_coelution_combined") << ", " 
-                          << getScore(*feature_it, "var_ms1_xcorr_shape") << ", " 
-                          << getScore(*feature_it, "var_ms1_xcorr_shape_contrast") << ", " 
-                          << getScore(*feature_it, "var_ms1_xcorr_shape_combined") << "); ";
+          row_ms2.values.push_back(getScore(*feature_it, ms2_scores[i]));
         }
+        rows_feature_ms2.push_back(row_ms2);
 
-        if (enable_uis_scoring_)
+        if (use_ms1_traces_)
         {
-          std::vector<String> id_target_transition_names = getSeparateScore(*feature_it, "id_target_transition_names");
-          std::vector<String> id_target_area_intensity = getSeparateScore(*feature_it, "id_target_area_intensity");
-          std::vector<String> id_target_total_area_intensity = getSeparateScore(*feature_it, "id_target_total_area_intensity");
-          std::vector<String> id_target_apex_intensity = getSeparateScore(*feature_it, "id_target_apex_intensity");
-          std::vector<String> id_target_total_mi = getSeparateScore(*feature_it, "id_target_apex_intensity");
-          std::vector<String> id_target_intensity_score = getSeparateScore(*feature_it, "id_target_intensity_score");
-          std::vector<String> id_target_intensity_ratio_score = getSeparateScore(*feature_it, "id_target_intensity_ratio_score");
-          std::vector<String> id_target_log_intensity = getSeparateScore(*feature_it, "id_target_ind_log_intensity");
-          std::vector<String> id_target_ind_xcorr_coelution = getSeparateScore(*feature_it, "id_target_ind_xcorr_coelution");
-          std::vector<String> id_target_ind_xcorr_shape = getSeparateScore(*feature_it, "id_target_ind_xcorr_shape");
-          std::vector<String> id_target_ind_log_sn_score = getSeparateScore(*feature_it, "id_target_ind_log_sn_score");
-          std::vector<String> id_target_ind_massdev_score = getSeparateScore(*feature_it, "id_target_ind_massdev_score");
-          std::vector<String> id_target_ind_mi_score = getSeparateScore(*feature_it, "id_target_ind_mi_score");
-          std::vector<String> id_target_ind_mi_ratio_score = getSeparateScore(*feature_it, "id_target_ind_mi_ratio_score");
-          std::vector<String> id_target_ind_isotope_correlation = getSeparateScore(*feature_it, "id_target_ind_isotope_correlation");
-          std::vector<String> id_target_ind_isotope_overlap = getSeparateScore(*feature_it, "id_target_ind_isotope_overlap");
-
-          if ((String)feature_it->getMetaValue("id_target_num_transitions") != "")
+          static const char* ms1_scores[] = {"ms1_area_intensity", "ms1_apex_intensity", "var_ms1_ppm_diff",
+            "var_ms1_mi_score", "var_ms1_mi_contrast_score", "var_ms1_mi_combined_score", "var_ms1_isotope_correlation",
+            "var_ms1_isotope_overlap", "var_ms1_xcorr_coelution", "var_ms1_xcorr_coelution_contrast",
+            "var_ms1_xcorr_coelution_combined", "var_ms1_xcorr_shape", "var_ms1_xcorr_shape_contrast",
+            "var_ms1_xcorr_shape_combined"};
+          Row row_ms1 = {FEATURE_MS1, std::vector<String>()};
+          row_ms1.values.push_back(feature_id);
+          for (Size i = 0; i < sizeof(ms1_scores) / sizeof(ms1_scores[0]); ++i)
           {
-            int id_target_num_transitions = feature_it->getMetaValue("id_target_num_transitions").toString().toInt();
-
-            for (int i = 0; i < id_target_num_transitions; ++i)
-            {
-              sql_feature_uis_transition  << "INSERT INTO FEATURE_TRANSITION (FEATURE_ID, TRANSITION_ID, AREA_INTENSITY, TOTAL_AREA_INTENSITY, APEX_INTENSITY, TOTAL_MI, VAR_INTENSITY_SCORE, VAR_INTENSITY_RATIO_SCORE, VAR_LOG_INTENSITY, VAR_XCORR_COELUTION, VAR_XCORR_SHAPE, VAR_LOG_SN_SCORE, VAR_MASSDEV_SCORE, VAR_MI_SCORE, VAR_MI_RATIO_SCORE, VAR_ISOTOPE_CORRELATION_SCORE, VAR_ISOTOPE_OVERLAP_SCORE) VALUES (" 
-                                          << feature_id << ", " 
-                                          << id_target_transition_names[i] << ", " 
-                                          << id_target_area_intensity[i] << ", " 
-                                          << id_target_total_area_intensity[i] << ", " 
-                                          << id_target_apex_intensity[i] << ", " 
-                                          << id_target_total_mi[i] << ", " 
-                                          << id_target_intensity_score[i] << ", " 
-                                          << id_target_intensity_ratio_score[i] << ", " 
-                                          << id_target_log_intensity[i] << ", " 
-                                          << id_target_ind_xcorr_coelution[i] << ", " 
-                                          << id_target_ind_xcorr_shape[i] << ", " 
-                                          << id_target_ind_log_sn_score[i] << ", " 
-                                          << id_target_ind_massdev_score[i] << ", " 
-                                          << id_target_ind_mi_score[i] << ", " 
-                                          << id_target_ind_mi_ratio_score[i] << ", " 
-                                          << id_target_ind_isotope_correlation[i] << ", " 
-                                          << id_target_ind_isotope_overlap[i] << "); ";
-            }
+            row_ms1.values.push_back(getScore(*feature_it, ms1_scores[i]));
           }
+          rows_feature_ms1.push_back(row_ms1);
+        }
 
-          std::vector<String> id_decoy_transition_names = getSeparateScore(*feature_it, "id_decoy_transition_names");
-          std::vector<String> id_decoy_area_intensity = getSeparateScore(*feature_it, "id_decoy_area_intensity");
-          std::vector<String> id_decoy_total_area_intensity = getSeparateScore(*feature_it, "id_decoy_total_area_intensity");
-          std::vector<String> id_decoy_apex_intensity = getSeparateScore(*feature_it, "id_decoy_apex_intensity");
-          std::vector<String> id_decoy_total_mi = getSeparateScore(*feature_it, "id_decoy_total_mi");
-          std::vector<String> id_decoy_intensity_score = getSeparateScore(*feature_it, "id_decoy_intensity_score");
-          std::vector<String> id_decoy_intensity_ratio_score = getSeparateScore(*feature_it, "id_decoy_intensity_ratio_score");
-          std::vector<String> id_decoy_log_intensity = getSeparateScore(*feature_it, "id_decoy_ind_log_intensity");
-          std::vector<String> id_decoy_ind_xcorr_coelution = getSeparateScore(*feature_it, "id_decoy_ind_xcorr_coelution");
-          std::vector<String> id_decoy_ind_xcorr_shape = getSeparateScore(*feature_it, "id_decoy_ind_xcorr_shape");
-          std::vector<String> id_decoy_ind_log_sn_score = getSeparateScore(*feature_it, "id_decoy_ind_log_sn_score");
-          std::vector<String> id_decoy_ind_massdev_score = getSeparateScore(*feature_it, "id_decoy_ind_massdev_score");
-          std::vector<String> id_decoy_ind_mi_score = getSeparateScore(*feature_it, "id_decoy_ind_mi_score");
-          std::vector<String> id_decoy_ind_mi_ratio_score = getSeparateScore(*feature_it, "id_decoy_ind_mi_ratio_score");
-          std::vector<String> id_decoy_ind_isotope_correlation = getSeparateScore(*feature_it, "id_decoy_ind_isotope_correlation");
-          std::vector<String> id_decoy_ind_isotope_overlap = getSeparateScore(*feature_it, "id_decoy_ind_isotope_overlap");
-
-          if ((String)feature_it->getMetaValue("id_decoy_num_transitions") != "")
-          {
-            int id_decoy_num_transitions = feature_it->getMetaValue("id_decoy_num_transitions").toString().toInt();
-
-            for (int i = 0; i < id_decoy_num_transitions; ++i)
-            {
-               sql_feature_uis_transition  << "INSERT INTO FEATURE_TRANSITION (FEATURE_ID, TRANSITION_ID, AREA_INTENSITY, TOTAL_AREA_INTENSITY, APEX_INTENSITY, TOTAL_MI, VAR_INTENSITY_SCORE, VAR_INTENSITY_RATIO_SCORE, VAR_LOG_INTENSITY, VAR_XCORR_COELUTION, VAR_XCORR_SHAPE, VAR_LOG_SN_SCORE, VAR_MASSDEV_SCORE, VAR_MI_SCORE, VAR_MI_RATIO_SCORE, VAR_ISOTOPE_CORRELATION_SCORE, VAR_ISOTOPE_OVERLAP_SCORE) VALUES (" 
-                                          << feature_id << ", " 
-                                          << id_decoy_transition_names[i] << ", " 
-                                          << id_decoy_area_intensity[i] << ", " 
-                                          << id_decoy_total_area_intensity[i] << ", " 
-                                          << id_decoy_apex_intensity[i] << ", " 
-                                          << id_decoy_total_mi[i] << ", " 
-                                          << id_decoy_intensity_score[i] << ", " 
-                                          << id_decoy_intensity_ratio_score[i] << ", " 
-                                          << id_decoy_log_intensity[i] << ", "
-                                          << id_decoy_ind_xcorr_coelution[i] << ", " 
-                                          << id_decoy_ind_xcorr_shape[i] << ", " 
-                                          << id_decoy_ind_log_sn_score[i] << ", " 
-                                          << id_decoy_ind_massdev_score[i] << ", " 
-                                          << id_decoy_ind_mi_score[i] << ", " 
-                                          << id_decoy_ind_mi_ratio_score[i] << ", " 
-                                          << id_decoy_ind_isotope_correlation[i] << ", " 
-                                          << id_decoy_ind_isotope_overlap[i] << "); ";
-            }
-          }
+        if (enable_uis_scoring_)
+        {
+          prepareUISRows_(*feature_it, feature_id, "id_target_", rows_feature_uis_transition);
+          prepareUISRows_(*feature_it, feature_id, "id_decoy_", rows_feature_uis_transition);
         }
       }
 
+      rows.insert(rows.end(), rows_feature.begin(), rows_feature.end());
+      rows.insert(rows.end(), rows_feature_ms1.begin(), rows_feature_ms1.end());
+      rows.insert(rows.end(), rows_feature_ms1_precursor.begin(), rows_feature_ms1_precursor.end());
+      rows.insert(rows.end(), rows_feature_ms2.begin(), rows_feature_ms2.end());
       if (enable_uis_scoring_)
       {
-        sql << sql_feature.str() << sql_feature_ms1.str() << sql_feature_ms1_precursor.str() << sql_feature_ms2.str() << sql_feature_uis_transition.str();
+        rows.insert(rows.end(), rows_feature_uis_transition.begin(), rows_feature_uis_transition.end());
       }
       else
       {
-        sql << sql_feature.str() << sql_feature_ms1.str() << sql_feature_ms1_precursor.str() << sql_feature_ms2.str() << sql_feature_ms2_transition.str();
+        rows.insert(rows.end(), rows_feature_ms2_transition.begin(), rows_feature_ms2_transition.end());
       }
+    }
+
+    /**
+     * @brief Prepare a single line (feature) for output
+     *
+     * The result can be flushed to disk using writeLines (either line by line
+     * or after collecting several lines).
+     *
+     * @param pep The compound (peptide/metabolite) used for extraction
+     * @param transition The transition used for extraction 
+     * @param output The feature map containing all features (each feature will generate one entry in the output)
+     * @param id The transition group identifier (peptide/metabolite id)
+     *
+     * @returns A string to be written using writeLines
+     *
+     */
+    String prepareLine(const OpenSwath::LightCompound& pep,
+        const OpenSwath::LightTransition* transition,
+        FeatureMap& output, String id) const
+    {
+      std::vector<Row> rows;
+      prepareRows(pep, transition, output, id, rows);
 
+      std::stringstream sql;
+      for (Size i = 0; i < rows.size(); ++i)
+      {
+        sql << "INSERT INTO " << getTableName(rows[i].table) << " (" << ListUtils::concatenate(getColumns(rows[i].table), ", ") << ") VALUES ("
+            << ListUtils::concatenate(rows[i].values, ", ") << "); ";
+      }
       return(sql.str());
     }
 
+    /// Name of the SQL table of @p table
+    static String getTableName(Table table);
+
+    /// Columns of @p table (in the order of Row::values)
+    static const std::vector<String>& getColumns(Table table);
+
     /**
      * @brief Write data to disk
      *
@@ -569,6 +553,72 @@ namespace OpenMS
       sqlite3_close(db);
     }
 
+    /**
+     * @brief Write rows to disk (asynchronously)
+     *
+     * The rows are handed to a background thread which inserts them using
+     * prepared statements, the function returns immediately. Safe to call
+     * from multiple threads at the same time.
+     *
+     * @param rows Rows generated by prepareRows (or assembled by the caller), moved and cleared
+     *
+     * @note writeHeader() needs to be called first
+     *
+     * @exception Exception::IllegalArgument is thrown if writeHeader() was not called or a previous insert failed
+     */
+    void writeRows(std::vector<Row>& rows);
+
+    /**
+     * @brief Wait until all rows passed to writeRows are written to disk
+     *
+     * @exception Exception::IllegalArgument is thrown if an insert failed
+     */
+    void flush();
+
+  protected:
+
+    /// Prepare the UIS rows of a feature (for the targets or decoys, given by the meta value @p prefix)
+    void prepareUISRows_(const Feature& feature, const String& feature_id, const String& prefix, std::vector<Row>& rows) const
+    {
+      static const char* uis_scores[] = {"transition_names", "area_intensity", "total_area_intensity", "apex_intensity",
+        "total_mi", "intensity_score", "intensity_ratio_score", "ind_log_intensity", "ind_xcorr_coelution",
+        "ind_xcorr_shape", "ind_log_sn_score", "ind_massdev_score", "ind_mi_score", "ind_mi_ratio_score",
+        "ind_isotope_correlation", "ind_isotope_overlap"};
+      const Size nr_scores = sizeof(uis_scores) / sizeof(uis_scores[0]);
+
+      if ((String)feature.getMetaValue(prefix + "num_transitions") == "")
+      {
+        return;
+      }
+
+      std::vector<std::vector<String> > scores(nr_scores);
+      for (Size k = 0; k < nr_scores; ++k)
+      {
+        String score_name = prefix + uis_scores[k];
+        // note: for the targets, TOTAL_MI has always been reported as the apex intensity
+        if (prefix == "id_target_" && String(uis_scores[k]) == "total_mi")
+        {
+          score_name = prefix + "apex_intensity";
+        }
+        scores[k] = getSeparateScore(feature, score_name);
+      }
+
+      int num_transitions = feature.getMetaValue(prefix + "num_transitions").toString().toInt();
+      for (int i = 0; i < num_transitions; ++i)
+      {
+        Row row = {FEATURE_TRANSITION_UIS, std::vector<String>()};
+        row.values.push_back(feature_id);
+        for (Size k = 0; k < nr_scores; ++k)
+        {
+          row.values.push_back(scores[k][i]);
+        }
+        rows.push_back(row);
+      }
+    }
+
+    /// Starts the background insert engine
+    void startEngine_();
+
   };
 
 }
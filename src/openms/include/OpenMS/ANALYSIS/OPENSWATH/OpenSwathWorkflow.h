@@ -47,10 +47,12 @@
 #include <OpenMS/ANALYSIS/OPENSWATH/DATAACCESS/SpectrumAccessOpenMS.h>
 #include <OpenMS/ANALYSIS/OPENSWATH/DATAACCESS/SpectrumAccessTransforming.h>
 #include <OpenMS/ANALYSIS/OPENSWATH/DATAACCESS/SpectrumAccessOpenMSInMemory.h>
+#include <OpenMS/ANALYSIS/OPENSWATH/DATAACCESS/SwathMapResidencyManager.h>
 #include <OpenMS/OPENSWATHALGO/DATAACCESS/SwathMap.h>
 
 // Helpers
 #include <OpenMS/ANALYSIS/OPENSWATH/OpenSwathHelper.h>
+#include <OpenMS/ANALYSIS/OPENSWATH/LightTargetedExperimentIndex.h>
 // #include <OpenMS/ANALYSIS/OPENSWATH/DATAACCESS/DataAccessHelper.h>
 #include <OpenMS/ANALYSIS/OPENSWATH/DATAACCESS/SimpleOpenMSSpectraAccessFactory.h>
 #include <OpenMS/ANALYSIS/OPENSWATH/OpenSwathTSVWriter.h>
@@ -66,6 +68,7 @@
 
 #include <cassert>
 #include <limits>
+#include <mutex>
 
 // #define OPENSWATH_WORKFLOW_DEBUG
 
@@ -95,42 +98,97 @@ namespace OpenMS
     double rt_extraction_window;
     /// Whether to extract some extra in the retention time (can be useful if one wants to look at the chromatogram outside the window)
     double extra_rt_extract;
+    /// Whether to keep extracted chromatograms in single precision on a shared retention time axis until they are scored (see CompactChromatogramList)
+    bool compact_chromatograms = false;
+  };
+
+  /** @brief Hands over prepared output lines from the scoring threads to the TSV / OSW writers
+   *
+   * Scoring threads pass their lines to write() which only appends them to a
+   * queue. The thread which finds the writers idle then drains the queue
+   * while all other threads return to scoring immediately instead of waiting
+   * for the (potentially slow) disk or database access. OSW rows are passed
+   * on to OpenSwathOSWWriter::writeRows directly, which inserts them from its
+   * own background thread. Call flush() once all threads are done to write
+   * out the remaining lines.
+   *
+  */
+  class OPENMS_DLLAPI OpenSwathOutputQueue
+  {
+  public:
+    OpenSwathOutputQueue(OpenSwathTSVWriter& tsv_writer, OpenSwathOSWWriter& osw_writer);
+
+    /// Not copyable (holds references and mutexes)
+    OpenSwathOutputQueue(const OpenSwathOutputQueue& rhs) = delete;
+    OpenSwathOutputQueue& operator=(const OpenSwathOutputQueue& rhs) = delete;
+
+    /// Queues lines prepared by OpenSwathTSVWriter::prepareLine and rows prepared by OpenSwathOSWWriter::prepareRows (input is moved and cleared)
+    void write(std::vector<String>& tsv_lines, std::vector<OpenSwathOSWWriter::Row>& osw_rows);
+
+    /// Writes all queued lines and waits until all OSW rows are written
+    void flush();
+
+  private:
+    /// Writes queued lines until the queue is empty, returns immediately if another thread is writing (unless @p wait is set)
+    void drain_(bool wait);
+
+    OpenSwathTSVWriter& tsv_writer_;
+    OpenSwathOSWWriter& osw_writer_;
+    std::vector<String> tsv_pending_;
+    /// Protects the pending lines
+    std::mutex queue_mutex_;
+    /// Held by the thread currently writing
+    std::mutex writer_mutex_;
   };
 
   class OPENMS_DLLAPI OpenSwathWorkflowBase :
     public ProgressLogger
   {
 
+public:
+
+    /** @brief Use a residency manager to decide which SWATH maps are kept in memory
+     *
+     * If set, all SWATH maps are accessed through the manager (which keeps
+     * them in memory within its memory budget) and the load_into_memory
+     * arguments of the workflow functions are ignored. The manager is not
+     * owned and needs to stay valid while the workflow is used, pass nullptr
+     * to stop using it.
+     *
+    */
+    void setResidencyManager(SwathMapResidencyManager* manager)
+    {
+      residency_manager_ = manager;
+    }
+
 protected:
 
     /** @brief Default constructor
      *
-     *  Will not use any ms1 traces and use all threads in the outer loop.
+     *  Will not use any ms1 traces and will not limit the number of SWATH windows analyzed at the same time.
      *
      **/
     OpenSwathWorkflowBase() :
       use_ms1_traces_(false),
       use_ms1_ion_mobility_(false),
-      threads_outer_loop_(-1)
+      threads_outer_loop_(-1),
+      residency_manager_(nullptr)
     {
     }
 
     /** @brief Constructor
      *
      *  @param use_ms1_traces Whether to use MS1 data
-     *  @param threads_outer_loop How many threads should be used for the outer
-     *  loop (-1 will use all threads in the outer loop)
-     *
-     *  @note The total number of threads should be divisible by this number
-     *  (e.g. use 8 in outer loop if you have 24 threads in total and 3 will be
-     *  used for the inner loop).
-     *
+     *  @param threads_outer_loop How many SWATH windows should be analyzed
+     *  (and kept in memory) at the same time (-1 for no limit). All threads
+     *  are used independent of this setting.
      *
      **/
     OpenSwathWorkflowBase(bool use_ms1_traces, bool use_ms1_ion_mobility, int threads_outer_loop) :
       use_ms1_traces_(use_ms1_traces),
       use_ms1_ion_mobility_(use_ms1_ion_mobility),
-      threads_outer_loop_(threads_outer_loop)
+      threads_outer_loop_(threads_outer_loop),
+      residency_manager_(nullptr)
     {
     }
 
@@ -182,6 +240,18 @@ protected:
                                        const bool ms1 = false,
                                        const int ms1_isotopes = -1) const;
 
+    /** @brief Returns the SWATH map to work on
+     *
+     * Uses the residency manager if set, otherwise returns an in-memory copy
+     * of @p map if @p load_into_memory is set and @p map itself if not. Each
+     * call needs to be matched by a call to releaseSwathMap_().
+     *
+    */
+    OpenSwath::SpectrumAccessPtr acquireSwathMap_(const OpenSwath::SpectrumAccessPtr& map, bool load_into_memory);
+
+    /// Ends working on a SWATH map returned by acquireSwathMap_() (@p map is the map passed to acquireSwathMap_())
+    void releaseSwathMap_(const OpenSwath::SpectrumAccessPtr& map);
+
 
     /**
      * @brief Spectrum Access to the MS1 map (note that this is *not* threadsafe!)
@@ -198,17 +268,19 @@ protected:
     /// Whether to use ion mobility extraction on MS1 traces
     bool use_ms1_ion_mobility_;
 
-    /** @brief How many threads should be used for the outer loop
-     *
-     *  @note A value of -1 will use all threads in the outer loop
+    /** @brief How many SWATH windows should be analyzed (and kept in memory) at the same time
      *
-     *  @note The total number of threads should be divisible by this number
-     *  (e.g. use 8 in outer loop if you have 24 threads in total and 3 will be
-     *  used for the inner loop).
+     *  @note A value of -1 will not limit the number of windows
      *
      **/
     int threads_outer_loop_;
 
+    /// Decides which SWATH maps are kept in memory (not owned, may be nullptr)
+    SwathMapResidencyManager* residency_manager_;
+
+    /// The MS1 map as passed to acquireSwathMap_() (ms1_map_ is in use until the next MS1 extraction)
+    OpenSwath::SpectrumAccessPtr ms1_map_source_;
+
 };
 
   /**
@@ -365,14 +437,14 @@ protected:
    *
    *    - Obtain precursor ion chromatograms (if enabled) through MS1Extraction_()
    *    - Perform scoring of precursor ion chromatograms if no MS2 is given
-   *    - Iterate through each SWATH-MS window:
-   *      - Select which transitions to extract (proceed in batches) using OpenSwathHelper::selectSwathTransitions()
-   *      - Iterate through each batch of transitions:
-   *        - Extract current batch of transitions from current SWATH window:
-   *          - Select transitions for current batch (see selectCompoundsForBatch_())
-   *          - Prepare transition extraction (see prepareExtractionCoordinates_())
-   *          - Extract transitions using ChromatogramExtractor::extractChromatograms()
-   *          - Convert data to OpenMS format using ChromatogramExtractor::return_chromatogram()
+   *    - For each SWATH-MS window, select which transitions to extract (proceed in batches) using OpenSwathHelper::selectSwathTransitions()
+   *    - Process all batches of all SWATH-MS windows (see GroupedTaskScheduler):
+   *      - Once per SWATH-MS window, extract all batches of transitions:
+   *        - Select transitions for each batch (see selectCompoundsForBatch_())
+   *        - Prepare transition extraction (see prepareExtractionCoordinates_())
+   *        - Extract transitions using ChromatogramExtractorAlgorithm::extractChromatograms()
+   *      - For each batch of transitions:
+   *        - Convert data to OpenMS format using ChromatogramExtractor::return_chromatogram()
    *        - Score extracted transitions (see scoreAllChromatograms_())
    *        - Write scored chromatograms and peak groups to disk (see writeOutFeaturesAndChroms_())
    *
@@ -388,20 +460,30 @@ protected:
     /** @brief Constructor
      *
      *  @param use_ms1_traces Whether to use MS1 data
-     *  @param threads_outer_loop How many threads should be used for the outer
-     *  loop (-1 will use all threads in the outer loop)
-     *
-     *  @note The total number of threads should be divisible by this number
-     *  (e.g. use 8 in outer loop if you have 24 threads in total and 3 will be
-     *  used for the inner loop).
-     *
+     *  @param threads_outer_loop How many SWATH windows should be analyzed
+     *  (and kept in memory) at the same time (-1 for no limit). All threads
+     *  are used independent of this setting.
      *
      **/
     OpenSwathWorkflow(bool use_ms1_traces, bool use_ms1_ion_mobility, int threads_outer_loop) :
-      OpenSwathWorkflowBase(use_ms1_traces, use_ms1_ion_mobility, threads_outer_loop)
+      OpenSwathWorkflowBase(use_ms1_traces, use_ms1_ion_mobility, threads_outer_loop),
+      library_cache_(nullptr)
     {
     }
 
+    /** @brief Use precomputed library-dependent scoring values
+     *
+     * The cache needs to be computed for the assay library passed to
+     * performExtraction() and stay valid during the analysis (it is not
+     * owned by the workflow). Values missing from the cache are computed on
+     * the fly.
+     *
+    */
+    void setLibraryCache(const OpenSwathLibraryCache* cache)
+    {
+      library_cache_ = cache;
+    }
+
     /** @brief Execute OpenSWATH analysis on a set of SwathMaps and transitions.
      *
      * See OpenSwathWorkflow class for a detailed description of this function.
@@ -499,6 +581,8 @@ protected:
      * @param tsv_writer TSV writer for storing output (on the fly)
      * @param osw_writer OSW Writer object to store identified features in SQLite format
      * @param ms1only If true, will only score on MS1 level and ignore MS2 level
+     * @param output_queue If given, output lines are handed to this queue
+     *        instead of being written directly in a critical section
      *
     */
     void scoreAllChromatograms_(
@@ -513,7 +597,8 @@ protected:
         OpenSwathTSVWriter & tsv_writer,
         OpenSwathOSWWriter & osw_writer,
         int nr_ms1_isotopes = 0,
-        bool ms1only = false) const;
+        bool ms1only = false,
+        OpenSwathOutputQueue* output_queue = nullptr) const;
 
     /** @brief Select which compounds to analyze in the next batch (and copy to output)
      *
@@ -533,6 +618,21 @@ protected:
     void selectCompoundsForBatch_(const OpenSwath::LightTargetedExperiment& transition_exp_used_all,
       OpenSwath::LightTargetedExperiment& transition_exp_used, int batch_size, size_t batch_idx);
 
+    /** @brief Select which compounds to analyze in the next batch (and copy to output)
+     *
+     * Same as above, but uses an index of the full transition list to look
+     * up the transitions of the selected compounds instead of scanning all
+     * transitions for each batch.
+     *
+     * @param index Index of the full transition list (see LightTargetedExperimentIndex::getExperiment())
+     * @param transition_exp_used Output list of transitions
+     * @param batch_size Number of compounds to add to the output
+     * @param batch_idx The batch index
+     *
+    */
+    void selectCompoundsForBatch_(const LightTargetedExperimentIndex& index,
+      OpenSwath::LightTargetedExperiment& transition_exp_used, int batch_size, size_t batch_idx);
+
     /** @brief Helper function for selectCompoundsForBatch_()
      *
      * Copy all transitions matching to one of the compounds in the selected
@@ -547,6 +647,9 @@ protected:
       const std::vector<OpenSwath::LightTransition>& all_transitions,
       std::vector<OpenSwath::LightTransition>& output);
 
+    /// Precomputed library-dependent scoring values (not owned, may be nullptr)
+    const OpenSwathLibraryCache* library_cache_;
+
   };
 
   /**
@@ -573,6 +676,9 @@ protected:
    *        - Score extracted transitions (see scoreAllChromatograms_())
    *        - Write scored chromatograms and peak groups to disk (see writeOutFeaturesAndChroms_())
    *
+   * In streaming mode (see setStreaming()), the maps are read only once
+   * instead (see performExtractionSonarStreaming_()).
+   *
    */
   class OPENMS_DLLAPI OpenSwathWorkflowSonar :
     public OpenSwathWorkflow
@@ -581,10 +687,28 @@ protected:
   public:
 
     explicit OpenSwathWorkflowSonar(bool use_ms1_traces) :
-      OpenSwathWorkflow(use_ms1_traces, false, -1)
+      OpenSwathWorkflow(use_ms1_traces, false, -1),
+      streaming_(false)
     {
     }
 
+    /** @brief Whether to extract all SONAR windows in a single pass over the maps
+     *
+     * By default, each (virtual) SONAR window reads all maps that overlap
+     * it (copying them into memory if load_into_memory is set), such that
+     * each map is read by many windows and several maps are held in memory
+     * by each thread. In streaming mode, each map is read once and the
+     * spectra are extracted for all windows overlapping it, a window is
+     * scored as soon as all its maps have been read (see
+     * performExtractionSonarStreaming_()). The load_into_memory argument of
+     * performExtractionSonar() is ignored in this mode.
+     *
+    */
+    void setStreaming(bool streaming)
+    {
+      streaming_ = streaming;
+    }
+
     /** @brief Execute OpenSWATH analysis on a set of SONAR SwathMaps and transitions.
      *
      * See OpenSwathWorkflowSonar class for a detailed description of this function.
@@ -644,6 +768,45 @@ protected:
      *
     */
     OpenSwath::ChromatogramPtr addChromatograms(OpenSwath::ChromatogramPtr base_chrom, OpenSwath::ChromatogramPtr newchrom);
+
+    /** @brief Extract and score all SONAR windows in a single pass over the maps
+     *
+     * The maps are processed in order of their lower m/z bound. For each
+     * map, all (virtual) SONAR windows overlapping it are set up (transition
+     * selection, batches and extraction coordinates) if this has not
+     * happened yet, and the transitions of all of them are extracted in a
+     * single pass over the spectra of the map (see
+     * ChromatogramExtractorAlgorithm::extractChromatograms()). The result
+     * is added to the chromatograms of each window. Once the next map
+     * starts above the upper end of a window, no further map can overlap
+     * it: its batches are scored in parallel and its data is released.
+     * Thus only the chromatograms of the windows overlapping the current map
+     * are kept in memory and no map is loaded into memory.
+     *
+     * @note The chromatograms of a window are aligned to the time points of
+     * the first map overlapping it, thus the result is the same as for the
+     * default mode if the maps are sorted by their lower m/z bound.
+     *
+    */
+    void performExtractionSonarStreaming_(const std::vector< OpenSwath::SwathMap > & swath_maps,
+                                          const LightTargetedExperimentIndex & library_index,
+                                          const std::vector< MSChromatogram > & ms1_chromatograms,
+                                          const TransformationDescription & trafo,
+                                          const TransformationDescription & trafo_inverse,
+                                          const ChromExtractParams & cp,
+                                          const Param & feature_finder_param,
+                                          double sonar_winsize,
+                                          double sonar_start,
+                                          int sonar_total_win,
+                                          FeatureMap& out_featureFile,
+                                          bool store_features,
+                                          OpenSwathTSVWriter & tsv_writer,
+                                          OpenSwathOSWWriter & osw_writer,
+                                          Interfaces::IMSDataConsumer * chromConsumer,
+                                          int batchSize);
+
+    /// Whether to use performExtractionSonarStreaming_()
+    bool streaming_;
   };
 
 }
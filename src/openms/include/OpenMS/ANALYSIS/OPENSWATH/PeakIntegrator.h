@@ -208,6 +208,36 @@ public:
     };
     ///@}
 
+    /** @name integratePeaks() input
+      A peak whose trace is given as flat arrays of positions (RT or m/z) and
+      intensities. The arrays are not owned and must outlive the call.
+    */
+    ///@{
+    struct PeakIntegrationJob
+    {
+      /**
+        The positions of the trace (sorted ascending)
+      */
+      const double* pos = nullptr;
+      /**
+        The intensities of the trace (same length as `pos`)
+      */
+      const double* intensity = nullptr;
+      /**
+        The number of points of the trace
+      */
+      Size size = 0;
+      /**
+        The left peak boundary
+      */
+      double left = 0.0;
+      /**
+        The right peak boundary
+      */
+      double right = 0.0;
+    };
+    ///@}
+
     /** @name Constant expressions for parameters
       
         Constants expressions used throughout the code and tests to set
@@ -434,6 +464,32 @@ public:
       const double peak_apex_pos
     ) const;
 
+    /**
+      @brief Compute area and background of many peaks given as flat arrays.
+
+      For every job, this computes the same values as integratePeak() followed
+      by estimateBackground() at the resulting apex position. Boundaries are
+      located by binary search and the integration kernels run over the
+      contiguous arrays, the jobs are processed in parallel if OpenMP is
+      enabled. If `fit_EMG` is set, each job is copied into a MSChromatogram
+      and processed by the container-based implementation.
+
+      Jobs without any point inside [left, right] get an empty area and background.
+
+      @throw Exception::InvalidParameter for class parameters `integration_type` and `baseline_type`.
+
+      @param[in] jobs The peaks to integrate
+      @param[out] areas The area of each job (same order as `jobs`)
+      @param[out] backgrounds The background of each job (same order as `jobs`)
+      @param[in] compute_hull_points Also fill PeakArea::hull_points (requires an allocation per job)
+    */
+    void integratePeaks(
+      const std::vector<PeakIntegrationJob>& jobs,
+      std::vector<PeakArea>& areas,
+      std::vector<PeakBackground>& backgrounds,
+      const bool compute_hull_points = false
+    ) const;
+
     /**
       @brief Calculate peak's shape metrics.
 
@@ -71,6 +71,9 @@ public:
      * @param mz_extraction_window Extraction window for calibration in Da or ppm (e.g. 50ppm means extraction +/- 25ppm)
      * @param ppm Whether the extraction window is given in ppm or Da
      *
+     * @note The spectra of the calibrants are extracted in parallel (if OpenMP
+     * is enabled), the regression does not depend on the number of threads.
+     *
      */
     static void correctMZ(const std::map<String, OpenMS::MRMFeatureFinderScoring::MRMTransitionGroupType *>& transition_group_map,
                           std::vector< OpenSwath::SwathMap > & swath_maps,
@@ -78,6 +81,17 @@ public:
                           const double mz_extr_window = 0.05,
                           const bool ppm = false);
 
+protected:
+
+    /// a data point extracted for a calibrating transition
+    struct CalibrationPoint_
+    {
+      double mz; ///< measured m/z
+      double theo_mz; ///< theoretical (product) m/z
+      double intensity; ///< integrated intensity
+      double rt; ///< RT of the spectrum
+    };
+
   };
 }
 
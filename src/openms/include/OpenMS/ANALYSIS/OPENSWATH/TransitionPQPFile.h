@@ -69,6 +69,21 @@ private:
     */
     void readPQPInput_(const char* filename, std::vector<TSVTransition>& transition_list, bool legacy_traml_id = false);
 
+    /** @brief Open a PQP SQLite file
+     *
+     * @param filename The input file
+     * @param db The opened database handle (to be closed by the caller)
+     *
+     * @return The number of transitions in the file
+    */
+    int openPQP_(const char* filename, sqlite3*& db);
+
+    /// SQL statement selecting all transitions (one row per transition, see readPQPRow_)
+    std::string getPQPSelectStatement_(bool legacy_traml_id);
+
+    /// Parse the current row of a statement created from getPQPSelectStatement_
+    void readPQPRow_(sqlite3_stmt* stmt, TSVTransition& transition);
+
     /** @brief Write a TargetedExperiment to a file
      *
      * @param filename Name of the output file
@@ -112,6 +127,23 @@ public:
     */
     void convertPQPToTargetedExperiment(const char* filename, OpenSwath::LightTargetedExperiment& targeted_exp, bool legacy_traml_id = false);
 
+    /** @brief Read in a PQP file and construct a targeted experiment (Light transition structure)
+     *
+     * The rows of the PQP file are converted one at a time, so no
+     * intermediate copy of the whole transition list is kept in memory. Only
+     * transitions with a precursor m/z inside one of the given ranges are
+     * loaded, which allows to load only the transitions of selected swath
+     * windows.
+     *
+     * @param filename The input file
+     * @param targeted_exp The output targeted experiment
+     * @param legacy_traml_id Should legacy TraML IDs be used (boolean)?
+     * @param precursor_ranges Precursor m/z ranges [lower, upper) to load (all transitions are loaded if empty)
+     *
+    */
+    void convertPQPToTargetedExperiment(const char* filename, OpenSwath::LightTargetedExperiment& targeted_exp, bool legacy_traml_id,
+                                        const std::vector<std::pair<double, double> >& precursor_ranges);
+
   };
 }
 
@@ -225,6 +225,26 @@ protected:
     */
     void TSVToTargetedExperiment_(std::vector<TSVTransition>& transition_list, OpenSwath::LightTargetedExperiment& exp);
 
+    /** @brief Add a single TSVTransition to a LightTargetedExperiment
+     *
+     * Adds the transition and, if not present yet, its compound (peptide) and
+     * protein. The maps hold the ids of the compounds and proteins already
+     * present in @p exp.
+     *
+    */
+    void addLightTransition_(std::vector<TSVTransition>::const_iterator tr_it,
+                             OpenSwath::LightTargetedExperiment& exp,
+                             std::map<String, int>& compound_map,
+                             std::map<String, int>& protein_map);
+
+    /** Resolve a mixed peptide label group for a single transition (see resolveMixedSequenceGroups_)
+     *
+     * @param transition The transition to be checked (and fixed)
+     * @param label_sequence_map The first peptide sequence seen for each peptide label group (updated)
+     *
+     */
+    void resolveMixedSequenceGroup_(TSVTransition& transition, std::map<String, String>& label_sequence_map);
+
     /** @name  Conversion functions from TSVTransition objects to TraML datastructures
      *
      * These functions convert the relevant data from a TSVTransition to the
@@ -321,6 +341,12 @@ private:
     */
     void writeTSVOutput_(const char* filename, OpenMS::TargetedExperiment& targeted_exp);
 
+    /// Write the header line of a TSV file
+    void writeTSVHeader_(std::ostream& os) const;
+
+    /// Write a single transition as a line of a TSV file
+    void writeTSVLine_(std::ostream& os, const TSVTransition& transition) const;
+
 public:
 
     //@{
@@ -339,6 +365,17 @@ public:
     */
     void convertTargetedExperimentToTSV(const char* filename, OpenMS::TargetedExperiment& targeted_exp);
 
+    /** @brief Convert a TraML file into a tsv file without loading all transitions
+     *
+     * The transitions are written to the tsv file while the TraML file is
+     * parsed, only the proteins, peptides and compounds are kept in memory.
+     *
+     * @param traml_file The input TraML file
+     * @param filename The output file
+     *
+    */
+    void convertTraMLToTSV(const String& traml_file, const char* filename);
+
     /** @brief Read in a tsv/mrm file and construct a targeted experiment (TraML structure)
      *
      * @param filename The input file
@@ -5,10 +5,13 @@ set(directory include/OpenMS/ANALYSIS/OPENSWATH)
 set(sources_list_h
   ChromatogramExtractor.h
   ChromatogramExtractorAlgorithm.h
+  CompactChromatogramList.h
   ConfidenceScoring.h
   DIAHelper.h
   DIAPrescoring.h
   DIAScoring.h
+  IonMobilityFrame.h
+  LightTargetedExperimentIndex.h
   MasstraceCorrelator.h
   MRMAssay.h
   MRMDecoy.h
@@ -20,6 +23,7 @@ set(sources_list_h
   MRMRTNormalizer.h
   MRMTransitionGroupPicker.h
   OpenSwathHelper.h
+  OpenSwathLibraryCache.h
   OpenSwathScores.h
   OpenSwathScoring.h
   OpenSwathTSVWriter.h
@@ -208,6 +208,8 @@ public:
         Note that the method will update the list of featureConcentrations in place.  The resulting
         components_concentrations will reflect the optimal set of points for downstream QC/QA.
 
+      @note The components are optimized in parallel if OpenMP is enabled.
+
     */ 
     void optimizeCalibrationCurves(std::map<String,std::vector<AbsoluteQuantitationStandards::featureConcentration>> & components_concentrations);    
 
@@ -261,6 +263,60 @@ public:
     void quantifyComponents(FeatureMap& unknowns);    
 
 protected:
+    /**
+      @brief The calibration points of a single component
+
+      The ratios are extracted once from the features and then reused for
+      all fits while searching for the optimal set of calibration points.
+    */
+    struct CalibrationPoints_
+    {
+      /// actual concentration ratios (component / IS)
+      std::vector<double> actual_ratios;
+      /// feature amount ratios, corrected for the dilution factor
+      std::vector<double> feature_amount_ratios;
+      /// feature ratios as used by applyCalibration (not corrected for the dilution factor)
+      std::vector<double> feature_ratios;
+      /// weighted actual concentration ratios (for the correlation coefficient)
+      std::vector<double> actual_ratios_weighted;
+      /// weighted feature amount ratios (for the correlation coefficient)
+      std::vector<double> feature_amount_ratios_weighted;
+    };
+
+    /// Extract the calibration points of @p component_concentrations, weighted according to @p transformation_model_params
+    void extractCalibrationPoints_(
+      const std::vector<AbsoluteQuantitationStandards::featureConcentration> & component_concentrations,
+      const String & feature_name,
+      const Param & transformation_model_params,
+      CalibrationPoints_ & points);
+
+    /// Same as fitCalibration() for the points at @p indices
+    Param fitCalibration_(
+      const CalibrationPoints_ & points,
+      const std::vector<size_t> & indices,
+      const String & transformation_model,
+      const Param & transformation_model_params);
+
+    /// Same as calculateBiasAndR() for the points at @p indices (the model is set up only once)
+    void calculateBiasAndR_(
+      const CalibrationPoints_ & points,
+      const std::vector<size_t> & indices,
+      const String & transformation_model,
+      const Param & transformation_model_params,
+      std::vector<double> & biases,
+      double & correlation_coefficient);
+
+    /**
+      @brief Same as jackknifeOutlierCandidate_() for the points at @p indices
+
+      The correlation coefficient of the weighted points does not depend on
+      the fitted model, so removing a single point is computed in closed form
+      by downdating the centered sums instead of refitting.
+    */
+    int jackknifeOutlierCandidate_(
+      const CalibrationPoints_ & points,
+      const std::vector<size_t> & indices);
+
     /**
       @brief This function extracts out the components.
 
@@ -35,10 +35,15 @@
 #pragma once
 
 #include <OpenMS/DATASTRUCTURES/DefaultParamHandler.h>
+#include <OpenMS/INTERFACES/IMSDataConsumer.h>
 #include <OpenMS/KERNEL/Peak2D.h>
 #include <OpenMS/KERNEL/MSExperiment.h>
 #include <OpenMS/KERNEL/StandardTypes.h>
 
+#include <map>
+#include <memory>
+#include <vector>
+
 namespace OpenMS
 {
   class IsobaricQuantitationMethod;
@@ -62,6 +67,20 @@ namespace OpenMS
     for improvement of protein identification and accuracy of isobaric mass tag quantification on Orbitrap-type mass
     spectrometers. Analytical chemistry 83: 8959-67. http://www.ncbi.nlm.nih.gov/pubmed/22017476
 
+    The extraction can either be performed on a complete experiment using extractChannels(), or while the
+    data is read using an IsobaricChannelExtractor::ExtractionConsumer, which only keeps the MS1 scans
+    needed for the purity computation (and the tandem spectra in between) in memory:
+
+    @code
+    ConsensusMap consensus_map;
+    IsobaricChannelExtractor::ExtractionConsumer consumer(extractor, consensus_map);
+    MzMLFile().transform(in, &consumer, true, true);
+    consumer.finish();
+    @endcode
+
+    In both cases the tandem spectra are processed in parallel (using OpenMP); the result does not depend on
+    the number of threads.
+
     @note Centroided MS and MS/MS data is required.
 
     @htmlinclude OpenMS_IsobaricChannelExtractor.parameters
@@ -92,47 +111,155 @@ public:
     void extractChannels(const PeakMap& ms_exp_data, ConsensusMap& consensus_map);
 
 private:
+    /// small quality control class, holding temporary data for reporting
+    struct ChannelQC_
+    {
+      ChannelQC_() :
+        mz_deltas(),
+        signal_not_unique(0)
+      {}
+
+      std::vector<double> mz_deltas; ///< m/z distance between expected and observed reporter ion closest to expected position
+      int signal_not_unique;  ///< counts if more than one peak was found within the search window of each reporter position
+    };
+
+    /**
+      @brief A tandem spectrum to extract, together with the MS1 scans needed for the purity computation.
+
+      The MS1 scans are shared between all spectra of a cycle and are released
+      once the last spectrum referring to them is extracted.
+    */
+    struct Job_
+    {
+      /// the spectrum holding the reporter ions
+      std::shared_ptr<const PeakMap::SpectrumType> spectrum;
+      /// the potential MS1 precursor scan (empty if there is none)
+      std::shared_ptr<const PeakMap::SpectrumType> precursor_scan;
+      /// the follow up MS1 scan (empty if there is none)
+      std::shared_ptr<const PeakMap::SpectrumType> follow_up_scan;
+      /// indicates if a parent MS2 scan was found (required for MS3 scans)
+      bool has_parent;
+      /// RT of the parent MS2 scan
+      double parent_rt;
+      /// precursor m/z of the parent MS2 scan
+      double parent_mz;
+    };
+
+    /// Result of the extraction of a single spectrum (computed in parallel)
+    struct JobResult_
+    {
+      /// precursor purity (-1 if it could not be computed)
+      double precursor_purity;
+      /// one entry per channel (empty if the spectrum failed the purity threshold)
+      std::vector<Peak2D> channels;
+      /// m/z deltas of the closest signal per channel (NaN if none within the QC distance)
+      std::vector<double> mz_deltas;
+      /// per channel: more than one signal within the reporter mass shift
+      std::vector<char> signal_not_unique;
+    };
+
+public:
     /**
-      @brief Small struct to capture the current state of the purity computation.
+      @brief Consumer which extracts the isobaric channels while the spectra are read
+
+      The spectra need to be consumed in the order of their retention
+      time. Only the MS level that is used for quantitation (the highest MS
+      level of tandem spectra passing the activation filter, e.g. MS3 if
+      present) is extracted. The last MS1 scan and the tandem spectra
+      waiting for the following MS1 scan (needed for the purity
+      interpolation) are kept in memory, while the extraction itself is
+      performed in parallel as soon as enough spectra have been collected.
+
+      The result is identical to extractChannels() on the complete
+      experiment.
 
-      It basically contains two iterators pointing to the current potential
-      MS1 precursor scan of an MS2 scan and the MS1 scan immediately
-      following the current MS2 scan.
+      @note Call finish() after the last spectrum to extract the remaining
+      spectra and to register the channels in the output map.
+
+      @note The extractor is not copied, it needs to stay alive (and must not
+      be modified) while the consumer is used.
     */
-    struct PuritySate_
+    class OPENMS_DLLAPI ExtractionConsumer :
+      public Interfaces::IMSDataConsumer
     {
-      /// Iterator pointing to the potential MS1 precursor scan
-      PeakMap::ConstIterator precursorScan;
-      /// Iterator pointing to the potential follow up MS1 scan
-      PeakMap::ConstIterator followUpScan;
+public:
+      /**
+        @brief Constructor
+
+        @param extractor The (configured) channel extractor
+        @param consensus_map Output map, will be cleared
+      */
+      ExtractionConsumer(const IsobaricChannelExtractor& extractor, ConsensusMap& consensus_map);
 
-      /// Indicates if a follow up scan was found
-      bool hasFollowUpScan;
-      /// reference to the experiment to analyze
-      const PeakMap& baseExperiment;
+      /// Destructor
+      ~ExtractionConsumer() override;
+
+      void setExpectedSize(Size, Size) override {}
+
+      void setExperimentalSettings(const ExperimentalSettings&) override {}
 
       /**
-        @brief C'tor taking the experiment that will be analyzed.
+        @brief Consume a spectrum (only MS1 scans and tandem spectra used for quantitation are copied)
 
-        @param targetExp The experiment that will be analyzed.
+        @exception Exception::InvalidParameter is thrown if the spectra are not sorted by retention time
+        @exception Exception::MissingInformation is thrown if an MS2 scan has no precursor
       */
-      PuritySate_(const PeakMap& targetExp);
+      void consumeSpectrum(SpectrumType& s) override;
+
+      /// Chromatograms are ignored
+      void consumeChromatogram(ChromatogramType&) override {}
 
       /**
-        @brief Searches the experiment for the next MS1 spectrum with a retention time bigger then @p rt.
+        @brief Extracts the remaining spectra, reports statistics and registers the channels in the output map
 
-        @param rt The next follow up scan should have a retention bigger then this value.
+        @exception Exception::MissingInformation is thrown if no spectra were consumed
       */
-      void advanceFollowUp(const double rt);
+      void finish();
+
+private:
+      friend class IsobaricChannelExtractor;
 
       /**
-        @brief Check if the currently selected follow up scan has a retention time bigger then the given value.
+        @brief Common implementation for copied and borrowed spectra
 
-        @param rt The retention time to check.
+        @param s The spectrum
+        @param borrowed If set, @p s outlives the consumer and is referenced instead of copied
       */
-      bool followUpValid(const double rt);
+      void consumeSpectrum_(const SpectrumType& s, bool borrowed);
+
+      /// extract the spectra which are ready (and the ones still waiting for a follow up scan if @p all is set)
+      void extractReady_(bool all);
+
+      /// do not allow copy
+      ExtractionConsumer(const ExtractionConsumer&);
+      /// do not allow assignment
+      ExtractionConsumer& operator=(const ExtractionConsumer&);
+
+      const IsobaricChannelExtractor& extractor_;
+      ConsensusMap& consensus_map_;
+      Size batch_size_;
+      Size spectra_count_;
+      double last_rt_;
+      /// number of tandem scans with valid activation per MS level
+      std::map<UInt, UInt> ms_level_;
+      /// number of tandem scans per activation method
+      std::map<String, int> activation_modes_;
+      UInt quant_ms_level_;
+      /// RT and precursor m/z of the last MS2 scan (if any since the last MS1 scan)
+      bool has_last_ms2_;
+      double last_ms2_rt_;
+      double last_ms2_mz_;
+      /// the last MS1 scan
+      std::shared_ptr<const SpectrumType> precursor_scan_;
+      /// spectra waiting for the next MS1 scan
+      std::vector<Job_> waiting_;
+      /// spectra ready for extraction
+      std::vector<Job_> ready_;
+      UInt64 element_index_;
+      std::vector<ChannelQC_> channel_qc_;
     };
 
+private:
     /// The used quantitation method (itraq4plex, tmt6plex,..).
     const IsobaricQuantitationMethod* quant_method_;
 
@@ -164,7 +291,28 @@ private:
     bool interpolate_precursor_purity_;
 
     /// add channel information to the map after it has been filled
-    void registerChannelsInOutputMap_(ConsensusMap& consensus_map);
+    void registerChannelsInOutputMap_(ConsensusMap& consensus_map) const;
+
+    /**
+      @brief Extracts the reporter ions of a single spectrum (thread-safe).
+
+      @param job The spectrum together with its MS1 scans.
+      @param result The extracted channels.
+    */
+    void extractSpectrum_(const Job_& job, JobResult_& result) const;
+
+    /**
+      @brief Extracts a batch of spectra in parallel and appends the resulting features (in the order of @p jobs).
+
+      @param jobs Spectra to extract.
+      @param consensus_map Output map.
+      @param element_index Running index of the extracted spectra (updated).
+      @param channel_qc Calibration statistics (updated).
+    */
+    void extractBatch_(const std::vector<Job_>& jobs, ConsensusMap& consensus_map, UInt64& element_index, std::vector<ChannelQC_>& channel_qc) const;
+
+    /// log the calibration statistics of the reporter ions
+    void reportChannelQC_(std::vector<ChannelQC_>& channel_qc) const;
 
     /**
       @brief Checks if the given precursor fulfills all constraints for extractions.
@@ -183,22 +331,21 @@ private:
     bool hasLowIntensityReporter_(const ConsensusFeature& cf) const;
 
     /**
-      @brief Computes the purity of the precursor given an iterator pointing to the MS/MS spectrum and one to the precursor spectrum.
+      @brief Computes the purity of the precursor of the given MS/MS spectrum (interpolated between the precursor and the follow up scan, if enabled).
 
-      @param ms2_spec Iterator pointing to the MS2 spectrum.
-      @param precursor Iterator pointing to the precursor spectrum of ms2_spec.
+      @param job The MS/MS spectrum together with its precursor (required) and follow up scan.
       @return Fraction of the total intensity in the isolation window of the precursor spectrum that was assigned to the precursor.
     */
-    double computePrecursorPurity_(const PeakMap::ConstIterator& ms2_spec, const PuritySate_& pState) const;
+    double computePrecursorPurity_(const Job_& job) const;
 
     /**
-      @brief Computes the purity of the precursor given an iterator pointing to the MS/MS spectrum and a reference to the potential precursor spectrum.
+      @brief Computes the purity of the precursor given the MS/MS spectrum and a reference to the potential precursor spectrum.
 
-      @param ms2_spec Iterator pointing to the MS2 spectrum.
-      @param precursor Iterator pointing to the precursor spectrum of ms2_spec.
+      @param ms2_spec The MS/MS spectrum.
+      @param precursor_spec The potential precursor spectrum of ms2_spec.
       @return Fraction of the total intensity in the isolation window of the precursor spectrum that was assigned to the precursor.
     */
-    double computeSingleScanPrecursorPurity_(const PeakMap::ConstIterator& ms2_spec, const PeakMap::SpectrumType& precursor_spec) const;
+    double computeSingleScanPrecursorPurity_(const PeakMap::SpectrumType& ms2_spec, const PeakMap::SpectrumType& precursor_spec) const;
 
     /**
       @brief Get the first (of potentially many) activation methods (HCD,CID,...) of this spectrum.
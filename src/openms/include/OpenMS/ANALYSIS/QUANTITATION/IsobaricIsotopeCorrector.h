@@ -57,6 +57,10 @@ public:
      @param consensus_map_out The map where the corrected values should be stored.
      @param IsobaricQuantitationMethod (e.g., iTRAQ 4 plex)
 
+     The correction matrix is factorized only once and the reporter intensities of all
+     consensus features are corrected with a single solve. The (slower) NNLS solver is only
+     used for features where the exact solution contains negative intensities.
+
      @throws Exception::FailedAPICall If the least-squares fit fails.
      @throws Exception::InvalidParameter If the given correction matrix is invalid.
      */
@@ -66,10 +70,10 @@ public:
 
 private:
     /**
-     @brief Fills the input vector for the Eigen/NNLS step given the ConsensusFeature.
+     @brief Fills column @p column of the right-hand side matrix for the Eigen/NNLS step given the ConsensusFeature.
      */
-    static void fillInputVector_(Eigen::VectorXd& b,
-                                 Matrix<double>& m_b,
+    static void fillInputVector_(Eigen::MatrixXd& b,
+                                 Size column,
                                  const ConsensusFeature& cf,
                                  const ConsensusMap& cm);
 
@@ -83,7 +87,7 @@ private:
      @brief
      */
     static void computeStats_(const Matrix<double>& m_x,
-                              const Eigen::MatrixXd& x,
+                              const Eigen::VectorXd& x,
                               const float cf_intensity,
                               const IsobaricQuantitationMethod* quant_method,
                               IsobaricQuantifierStatistics& stats);
@@ -100,6 +100,30 @@ public:
     /// Mapping: protein accession -> protein data
     typedef std::map<String, ProteinData> ProteinQuant;
 
+    /**
+         @brief Dense peptide x sample matrix of (total) peptide abundances.
+
+         Peptides (rows) and samples (columns) are referred to by their index into @p peptides and @p samples.
+         Abundances are stored in row-major order; missing values are zero.
+    */
+    struct PeptideMatrix
+    {
+      /// peptide sequences (modified), one per row
+      std::vector<AASequence> peptides;
+
+      /// sample IDs, one per column
+      std::vector<UInt64> samples;
+
+      /// abundances (size: number of peptides times number of samples)
+      std::vector<double> abundances;
+
+      /// abundance of peptide @p row in sample @p col
+      double operator()(Size row, Size col) const
+      {
+        return abundances[row * samples.size() + col];
+      }
+    };
+
     /// Statistics for processing summary
     struct Statistics
     {
@@ -167,6 +191,8 @@ public:
          @brief Compute protein abundances.
 
          Peptide abundances must be computed first with quantifyPeptides(). Optional protein inference information (e.g. from Fido or ProteinProphet) can be supplied via @p proteins.
+
+         Proteins are aggregated in parallel if OpenMP is enabled.
     */
     void quantifyProteins(const ProteinIdentification& proteins = 
                           ProteinIdentification());
@@ -180,6 +206,15 @@ public:
     /// Get protein abundance data
     const ProteinQuant& getProteinResults();
 
+    /**
+         @brief Get the peptide abundances as a dense matrix.
+
+         Contains all quantified peptides (in the order of getPeptideResults()) and all samples for which at least one peptide abundance is available (in ascending order of sample ID).
+
+         Peptide abundances must be computed first with quantifyPeptides().
+    */
+    PeptideMatrix getPeptideMatrix() const;
+
 private:
 
     /// Processing statistics for output in the end
@@ -41,6 +41,7 @@
 
 namespace OpenMS
 {
+  class TheoreticalSpectrumBatch;
 
 /**
  *  @brief An implementation of the X!Tandem HyperScore PSM scoring function
@@ -63,6 +64,17 @@ struct OPENMS_DLLAPI HyperScore
 
   static double compute(double fragment_mass_tolerance, bool fragment_mass_tolerance_unit_ppm, const PeakSpectrum& exp_spectrum, const PeakSpectrum& theo_spectrum);
 
+  /* @brief compute the HyperScore of one experimental spectrum against all theoretical spectra of a batch
+   *  Gives the same scores as calling compute() for each theoretical spectrum, but matches the peaks of all
+   *  theoretical spectra in a single (vectorizable) loop over the flat arrays of the batch.
+   * @param fragment_mass_tolerance mass tolerance applied left and right of the theoretical spectrum peak position
+   * @param fragment_mass_tolerance_unit_ppm Unit of the mass tolerance is: Thomson if false, ppm if true
+   * @param exp_spectrum measured spectrum
+   * @param theo_spectra theoretical spectra
+   * @param scores HyperScore of each spectrum of the batch (in order of the batch)
+   */
+  static void compute(double fragment_mass_tolerance, bool fragment_mass_tolerance_unit_ppm, const PeakSpectrum& exp_spectrum, const TheoreticalSpectrumBatch& theo_spectra, std::vector<double>& scores);
+
   private:
     // helper to compute the log factorial
     static double logfactorial_(UInt x);
@@ -37,6 +37,7 @@
 #include <OpenMS/KERNEL/StandardTypes.h>
 #include <OpenMS/CHEMISTRY/ResidueModification.h>
 #include <OpenMS/CHEMISTRY/AASequence.h>
+#include <limits>
 #include <vector>
 #include <map>
 #include <set>
@@ -57,7 +58,45 @@ namespace OpenMS
     // Applies variable modifications to a single peptide. If keep_original is set the original (e.g. unmodified version) is also returned
     static void applyVariableModifications(const std::vector<ResidueModification>::const_iterator& var_mods_begin, const std::vector<ResidueModification>::const_iterator& var_mods_end, const AASequence& peptide, Size max_variable_mods_per_peptide, std::vector<AASequence>& all_modified_peptides, bool keep_original=true);
 
+    // magic constants to distinguish N_TERM/C_TERM only modifications from ANYWHERE modifications placed at the terminal residues
+    static const int N_TERM_MODIFICATION_INDEX;
+    static const int C_TERM_MODIFICATION_INDEX;
+
+    // Sites of a peptide that are compatible with the variable modifications, in the order used by applyVariableModifications()
+    struct VariableModificationSites
+    {
+      std::vector<int> positions; ///< residue index of each site, or N_TERM_MODIFICATION_INDEX/C_TERM_MODIFICATION_INDEX
+      std::vector<std::vector<ResidueModification> > modifications; ///< compatible modifications of each site
+    };
+
+    // Mass-only representation of a variably modified peptide, see enumerateVariableModifications()
+    struct ModifiedPeptideMass
+    {
+      double mono_weight; ///< monoisotopic weight of the modified peptide
+      UInt64 site_mask; ///< bit i is set if site i of VariableModificationSites is modified
+      UInt64 modification_choice; ///< chosen modification of every modified site, as mixed-radix number (first modified site is least significant)
+    };
+
+    // Determines the sites of @p peptide compatible with the variable modifications (already modified residues and termini are skipped)
+    static void getVariableModificationSites(const std::vector<ResidueModification>::const_iterator& var_mods_begin, const std::vector<ResidueModification>::const_iterator& var_mods_end, const AASequence& peptide, VariableModificationSites& sites);
+
+    /*
+     * @brief Enumerates the same modification combinations as applyVariableModifications(), but without building AASequence objects.
+     *
+     * Only combinations with a monoisotopic weight in [min_mass, max_mass] are reported, branches that cannot reach the window are pruned.
+     * The result is sorted by weight, use createModifiedPeptide() to build the AASequence of a candidate that is actually needed.
+     *
+     * @throw Exception::IllegalArgument if more than 64 sites are compatible and modifications are allowed
+     */
+    static void enumerateVariableModifications(const AASequence& peptide, const VariableModificationSites& sites, Size max_variable_mods_per_peptide, std::vector<ModifiedPeptideMass>& candidates, bool keep_original = true, double min_mass = -std::numeric_limits<double>::max(), double max_mass = std::numeric_limits<double>::max());
+
+    // Builds the modified peptide described by @p candidate (as obtained from enumerateVariableModifications() with the same @p sites)
+    static AASequence createModifiedPeptide(const AASequence& peptide, const VariableModificationSites& sites, const ModifiedPeptideMass& candidate);
+
   protected:
+    // Builds the mapping of compatible sites (residue index or terminal magic index) to variable modifications
+    static void getCompatibilityMap_(const std::vector<ResidueModification>::const_iterator& var_mods_begin, const std::vector<ResidueModification>::const_iterator& var_mods_end, const AASequence& peptide, std::map<int, std::vector<ResidueModification> >& map_compatibility);
+
     // Recursively generate all combinatoric placements at compatible sites
     static void recurseAndGenerateVariableModifiedPeptides_(const std::vector<int>& subset_indices, const std::map<int, std::vector<ResidueModification> >& map_compatibility, int depth, const AASequence& current_peptide, std::vector<AASequence>& modified_peptides);
 
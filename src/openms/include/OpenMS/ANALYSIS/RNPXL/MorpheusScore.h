@@ -38,8 +38,11 @@
 #include <OpenMS/CONCEPT/Types.h>
 #include <OpenMS/CONCEPT/Macros.h>
 
+#include <vector>
+
 namespace OpenMS
 {
+  class TheoreticalSpectrumBatch;
 
 /**
  *  @brief An implementation of the Morpheus PSM scoring function
@@ -64,6 +67,13 @@ struct OPENMS_DLLAPI MorpheusScore
                         bool fragment_mass_tolerance_unit_ppm, 
                         const PeakSpectrum& exp_spectrum, 
                         const PeakSpectrum& theo_spectrum);
+
+  /// computes the Morpheus Score of one experimental spectrum against all theoretical spectra of a batch (same results as calling compute() for each of them)
+  static void compute(double fragment_mass_tolerance,
+                      bool fragment_mass_tolerance_unit_ppm,
+                      const PeakSpectrum& exp_spectrum,
+                      const TheoreticalSpectrumBatch& theo_spectra,
+                      std::vector<Result>& results);
 };
 
 }
@@ -0,0 +1,145 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2018.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: Timo Sachsenberg $
+// $Authors: Timo Sachsenberg $
+// --------------------------------------------------------------------------
+
+#pragma once
+
+#include <OpenMS/CHEMISTRY/TheoreticalSpectrumGenerator.h>
+#include <OpenMS/KERNEL/StandardTypes.h>
+#include <OpenMS/CONCEPT/Types.h>
+
+#include <vector>
+
+namespace OpenMS
+{
+
+/**
+ *  @brief A set of theoretical spectra stored in flat arrays
+ *
+ *  The peaks of all spectra are stored consecutively in one m/z, one
+ *  intensity and one ion type array, the peaks of spectrum i are found at
+ *  positions getOffsets()[i] to getOffsets()[i+1] - 1. This allows the
+ *  batched versions of HyperScore::compute() and MorpheusScore::compute() to
+ *  match an experimental spectrum against all candidates of a batch in a
+ *  single loop without branches that depend on the data, which the compiler
+ *  can vectorize.
+ *
+ *  The ion type of each peak is derived from the ion annotation
+ *  (StringDataArray "IonNames") as used by HyperScore: 'y' for y ions, 'b' for
+ *  b ions and 0 otherwise.
+ */
+class OPENMS_DLLAPI TheoreticalSpectrumBatch
+{
+public:
+  /// Default constructor (empty batch)
+  TheoreticalSpectrumBatch();
+
+  /**
+   *  @brief Appends a theoretical spectrum to the batch
+   *
+   *  @param theo_spectrum Theoretical spectrum, peaks need to be sorted by m/z
+   *  @return The index of the spectrum in the batch
+   */
+  Size add(const PeakSpectrum& theo_spectrum);
+
+  /**
+   *  @brief Appends the fragment ions generated by TheoreticalSpectrumGenerator::getFragmentIons()
+   *
+   *  @param fragment_ions Fragment ions, sorted by m/z
+   *  @return The index of the spectrum in the batch
+   */
+  Size add(const std::vector<TheoreticalSpectrumGenerator::FragmentIon>& fragment_ions);
+
+  /// Removes all spectra (the allocated memory is kept for the next batch)
+  void clear();
+
+  /// Reserves space for @p spectra spectra with @p peaks peaks in total
+  void reserve(Size spectra, Size peaks);
+
+  /// Number of spectra in the batch
+  Size size() const;
+
+  /// Returns whether the batch is empty
+  bool empty() const;
+
+  /// Total number of peaks of all spectra
+  Size getNumberOfPeaks() const;
+
+  /// m/z values of all peaks
+  const std::vector<double>& getMZArray() const;
+
+  /// Intensities of all peaks
+  const std::vector<float>& getIntensityArray() const;
+
+  /// Ion types of all peaks ('y', 'b' or 0)
+  const std::vector<char>& getIonTypeArray() const;
+
+  /// Start of the peaks of each spectrum in the flat arrays (size() + 1 entries)
+  const std::vector<Size>& getOffsets() const;
+
+  /// Returns whether spectrum @p index had an ion annotation (StringDataArray)
+  bool isAnnotated(Size index) const;
+
+  /**
+   *  @brief Returns the index of the first element of [first, first + n) for which @p pred is false
+   *
+   *  The range needs to be partitioned with respect to @p pred (e.g. sorted
+   *  m/z values and a comparison with a fixed value) and must not be empty.
+   *  In contrast to std::partition_point, the number of iterations only
+   *  depends on @p n and the loop contains no data-dependent branches, so a
+   *  surrounding loop over many values (e.g. all peaks of a batch) can be
+   *  vectorized.
+   */
+  template <typename Predicate>
+  static Size partitionPoint(const double* first, Size n, Predicate pred)
+  {
+    const double* base = first;
+    while (n > 1)
+    {
+      const Size half = n / 2;
+      base = pred(base[half]) ? base + half : base;
+      n -= half;
+    }
+    return (base - first) + (pred(*base) ? 1 : 0);
+  }
+
+protected:
+  std::vector<double> mz_;
+  std::vector<float> intensity_;
+  std::vector<char> ion_type_;
+  std::vector<Size> offsets_;
+  std::vector<bool> annotated_;
+};
+
+}
+
@@ -11,6 +11,7 @@ RNPxlFragmentAnnotationHelper.h
 RNPxlMarkerIonExtractor.h
 RNPxlModificationsGenerator.h
 RNPxlReport.h
+TheoreticalSpectrumBatch.h
 )
 
 ### add path to the filenames
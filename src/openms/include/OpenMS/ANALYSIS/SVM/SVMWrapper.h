@@ -205,6 +205,10 @@ public:
       @brief predicts the labels using the trained model
 
       The prediction process is started and the results are stored in 'predicted_labels'.
+
+      With the oligo kernel only the kernel values between the samples and the
+      support vectors are computed (instead of the full kernel matrix with the
+      training set). Samples are predicted in parallel if OpenMP is enabled.
     */
     void predict(struct svm_problem* problem, std::vector<double>& predicted_labels);
 
@@ -212,6 +216,9 @@ public:
       @brief predicts the labels using the trained model
 
       The prediction process is started and the results are stored in 'predicted_labels'.
+
+      Only the kernel values between the samples and the support vectors are
+      computed. Samples are predicted in parallel if OpenMP is enabled.
     */
     void predict(const SVMData& problem, std::vector<double>& results);
 
@@ -317,6 +324,10 @@ public:
 
        The prediction process is started and the results are stored in 'predicted_rts'.
 
+       Models with a linear kernel (regression, one-class and two-class
+       classification) are evaluated with the collapsed weight vector of the
+       support vectors, i.e. with one sparse dot product per vector. Vectors are
+       predicted in parallel if OpenMP is enabled.
     */
     void predict(const std::vector<svm_node*>& vectors, std::vector<double>& predicted_rts);
 
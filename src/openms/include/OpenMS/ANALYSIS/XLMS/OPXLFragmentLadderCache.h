@@ -0,0 +1,101 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2018.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: Eugen Netz $
+// $Authors: Eugen Netz $
+// --------------------------------------------------------------------------
+
+#pragma once
+
+#include <OpenMS/CHEMISTRY/TheoreticalSpectrumGeneratorXLMS.h>
+#include <OpenMS/CHEMISTRY/AASequence.h>
+#include <OpenMS/KERNEL/StandardTypes.h>
+
+#include <map>
+#include <memory>
+
+namespace OpenMS
+{
+  /**
+   * @brief Caches the linear fragment ion ladders of peptides for the scoring in OpenPepXL and OpenPepXLLF
+
+      The linear ions (see TheoreticalSpectrumGeneratorXLMS::getLinearIonSpectrum) only depend on
+      the peptide, the linked position(s), the role of the peptide (alpha or beta) and the maximal charge,
+      but the same peptide is part of many candidates and is matched against many spectra.
+      A ladder is generated once and then shared, until the cache holds more than max_size ladders and is cleared.
+
+      An instance is not thread-safe, it is meant to be used by one thread only (e.g. one instance per thread),
+      which avoids any synchronisation between the threads.
+   */
+  class OPENMS_DLLAPI OPXLFragmentLadderCache
+  {
+    public:
+
+      /// Shared, immutable fragment ladder, stays valid when the cache is cleared
+      typedef std::shared_ptr<const PeakSpectrum> LadderPtr;
+
+      /**
+       * @brief Constructor
+
+       * @param generator The spectrum generator used for ladders that are not cached yet. Has to outlive the cache.
+       * @param max_size The maximal number of ladders kept in the cache
+       */
+      explicit OPXLFragmentLadderCache(const TheoreticalSpectrumGeneratorXLMS& generator, Size max_size = 10000);
+
+      /**
+       * @brief Returns the linear ion ladder of a peptide, see TheoreticalSpectrumGeneratorXLMS::getLinearIonSpectrum for the parameters
+       */
+      LadderPtr getLinearIonSpectrum(const AASequence& peptide, Size link_pos, bool frag_alpha, int charge = 1, Size link_pos_2 = 0);
+
+      /// Returns the number of cached ladders
+      Size size() const;
+
+      /// Removes all cached ladders
+      void clear();
+
+    private:
+
+      /// Everything a linear ion ladder depends on
+      struct LadderKey_
+      {
+        AASequence peptide;
+        Size link_pos;
+        Size link_pos_2;
+        bool frag_alpha;
+        int charge;
+
+        bool operator<(const LadderKey_& other) const;
+      };
+
+      const TheoreticalSpectrumGeneratorXLMS* generator_;
+      Size max_size_;
+      std::map<LadderKey_, LadderPtr> ladders_;
+  };
+}
@@ -51,12 +51,17 @@ namespace OpenMS
     public:
     /**
        * @brief Enumerates precursor masses for all candidates in an XL-MS search
-       * @param peptides The peptides with precomputed masses from the digestDatabase function
+
+          Only candidates matching one of the @p spectrum_precursors are generated. Peptide pairs are
+          enumerated with a walk over the mass-sorted peptides, that only visits pairs within the
+          precursor mass window, so the runtime does not grow quadratically with the database size.
+
+       * @param peptides The peptides with precomputed masses from the digestDatabase function (sorted by mass)
        * @param cross_link_mass_light mass of the cross-linker, only the light one if a labeled linker is used
        * @param cross_link_mass_mono_link A list of possible masses for the cross-link, if it is attached to a peptide on one side
        * @param cross_link_residue1 A list of residues, to which the first side of the linker can react
        * @param cross_link_residue2 A list of residues, to which the second side of the linker can react
-       * @param spectrum_precursors A vector of all MS2 precursor masses of the searched spectra. Used to filter out candidates.
+       * @param spectrum_precursors A vector of all MS2 precursor masses of the searched spectra (sorted ascending). Used to filter out candidates.
        * @param precursor_correction_positions A vector of the position of the used precursor correction
        * @param precursor_mass_tolerance The precursor mass tolerance
        * @param precursor_mass_tolerance_unit_ppm The unit of the precursor mass tolerance ("Da" or "ppm")
@@ -169,7 +174,7 @@ namespace OpenMS
        * @param cross_link_residue2 A list of one-letter-code residues, that the second side of the cross-linker can attach to
        * @param cross_link_name The name of the cross-linker, e.g. "DSS" or "BS3"
        */
-      static std::vector <OPXLDataStructs::ProteinProteinCrossLink> collectPrecursorCandidates(IntList precursor_correction_steps, double precursor_mass, double precursor_mass_tolerance, bool precursor_mass_tolerance_unit_ppm, std::vector<OPXLDataStructs::AASeqWithMass> filtered_peptide_masses, double cross_link_mass, DoubleList cross_link_mass_mono_link, StringList cross_link_residue1, StringList cross_link_residue2, String cross_link_name);
+      static std::vector <OPXLDataStructs::ProteinProteinCrossLink> collectPrecursorCandidates(const IntList& precursor_correction_steps, double precursor_mass, double precursor_mass_tolerance, bool precursor_mass_tolerance_unit_ppm, const std::vector<OPXLDataStructs::AASeqWithMass>& filtered_peptide_masses, double cross_link_mass, const DoubleList& cross_link_mass_mono_link, const StringList& cross_link_residue1, const StringList& cross_link_residue2, const String& cross_link_name);
 
       /**
        * @brief Computes the mass error of a precursor mass to a hit
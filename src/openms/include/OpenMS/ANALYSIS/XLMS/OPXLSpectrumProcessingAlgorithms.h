@@ -53,7 +53,7 @@ namespace OpenMS
        * @param second_spectrum
        * @return A PeakSpectrum containing all peaks from both input spectra
        */
-      static PeakSpectrum mergeAnnotatedSpectra(PeakSpectrum & first_spectrum, PeakSpectrum & second_spectrum);
+      static PeakSpectrum mergeAnnotatedSpectra(const PeakSpectrum & first_spectrum, const PeakSpectrum & second_spectrum);
 
       /**
        * @brief Preprocesses spectra
@@ -6,6 +6,7 @@ set(sources_list_h
 OpenPepXLAlgorithm.h
 OpenPepXLLFAlgorithm.h
 OPXLDataStructs.h
+OPXLFragmentLadderCache.h
 OPXLHelper.h
 OPXLSpectrumProcessingAlgorithms.h
 XQuestScores.h
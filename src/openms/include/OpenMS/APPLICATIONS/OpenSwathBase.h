@@ -373,6 +373,7 @@ protected:
    *        the transformation parameters will be stored in this file)
    * @param irt_mzml_out Output Chromatogram mzML containing the iRT peptides (if not empty,
    *        iRT chromatograms will be stored in this file)
+   * @param residency_manager Decides which SWATH maps are kept in memory (optional, see OpenSwathWorkflowBase::setResidencyManager())
    *
    */
   TransformationDescription performCalibration(String trafo_in,
@@ -388,7 +389,8 @@ protected:
         bool sonar,
         bool load_into_memory,
         const String& irt_trafo_out,
-        const String& irt_mzml_out)
+        const String& irt_mzml_out,
+        SwathMapResidencyManager* residency_manager = nullptr)
   {
     TransformationDescription trafo_rtnorm;
 
@@ -416,6 +418,7 @@ protected:
       // perform extraction
       OpenSwathCalibrationWorkflow wf;
       wf.setLogType(log_type_);
+      wf.setResidencyManager(residency_manager);
       trafo_rtnorm = wf.performRTNormalization(irt_transitions, swath_maps, min_rsq, min_coverage,
       feature_finder_param, cp_irt, irt_detection_param, mz_correction_function, irt_mzml_out,
       debug_level, sonar, load_into_memory);
@@ -61,6 +61,7 @@ namespace OpenMS
 {
 
   class ConsensusMap;
+  class StopWatch;
   /**
     @brief Stores Citations for individual TOPP tools.
 
@@ -191,9 +192,12 @@ public:
     /**
       @brief Sets the maximal number of usable threads
 
-      @param num_threads The number of threads that should be usable.
+      @param num_threads The number of threads that should be usable (zero or negative: all available cores).
 
-      @note This method only works if %OpenMS is compiled with %OpenMP support.
+      The number is set for the whole process (see ExecutionResources), so
+      external programs started by adapters use the same budget. Only
+      library code needs %OpenMS to be compiled with %OpenMP support to run
+      in parallel.
     */
     static void setMaxNumberOfThreads(int num_threads);
 
@@ -818,6 +822,16 @@ protected:
     //@{
     /// Runs an external process via QProcess and reports its status in the logs
     ExitCodes runExternalProcess_(const QString& executable, const QStringList& arguments, const QString& workdir = "") const;
+
+    /**
+       @brief Runs several instances of an external program via QProcess at the same time and reports their status in the logs
+
+       One process is started for each entry of @p arguments, at most @p max_parallel of them run at the same time.
+       Used by search engine adapters to search chunks of the input in parallel (see SearchEngineChunks).
+
+       @return EXECUTION_OK if all processes succeeded, otherwise EXTERNAL_PROGRAM_ERROR (no further processes are started after the first failure)
+    */
+    ExitCodes runExternalProcesses_(const QString& executable, const std::vector<QStringList>& arguments, Size max_parallel, const QString& workdir = "") const;
     //@}
 
     /**
@@ -956,6 +970,34 @@ private:
     */
     ParameterInformation& getParameterByName_(const String& name);
 
+    /**
+      @brief Writes the performance report requested by the option @p -perf_report as JSON
+
+      The report contains the wall and CPU times of the tool run (@p sw), the
+      regions recorded by the Profiler, the peak memory usage, the bytes
+      read and written by the process during the run (@p bytes_read and @p
+      bytes_written, or -1 if unknown) and the sizes of all input and output
+      files given to the tool.
+
+      @exception Exception::UnableToCreateFile is thrown if the file cannot be written
+    */
+    void storePerformanceReport_(const String& filename, const StopWatch& sw, Int threads, SignedSize bytes_read, SignedSize bytes_written, ExitCodes result) const;
+
+    /**
+      @brief Runs the jobs requested by the option @p -batch
+
+      Reads one command line (without the program name) per line from @p
+      batch_file ("-" for standard input, which also allows a named pipe
+      to be used as job queue) and runs the tool with it. The process and
+      all loaded databases (e.g. ModificationsDB, ResidueDB, controlled
+      vocabularies) are reused between jobs. Empty lines and lines starting
+      with '#' are ignored, a line "quit" ends the batch. After each job a
+      line "batch job <n> finished: <exit code>" is written to the log.
+
+      @return The exit code of the first failed job or EXECUTION_OK
+    */
+    ExitCodes runBatch_(const String& batch_file);
+
   };
 
 } // namespace OpenMS
@@ -0,0 +1,115 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2018.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: Timo Sachsenberg $
+// $Authors: Timo Sachsenberg $
+// --------------------------------------------------------------------------
+
+#pragma once
+
+#include <OpenMS/APPLICATIONS/TOPPBase.h>
+
+#include <map>
+#include <memory>
+#include <set>
+#include <vector>
+
+namespace OpenMS
+{
+  /**
+    @brief Runs several TOPP tools in one process, passing data in memory
+
+    Each stage is a TOPP tool object together with its command line (without
+    the program name). Input and output file names starting with "mem:" (see
+    InMemoryFileStore) are handed from one stage to the next without touching
+    the disk, e.g.
+
+    @code
+    TOPPPipeline pipeline;
+    pipeline.addStage(new TOPPPeakPickerHiRes(), ListUtils::create<String>("-in,raw.mzML,-out,mem:picked.mzML"));
+    pipeline.addStage(new TOPPFeatureFinderCentroided(), ListUtils::create<String>("-in,mem:picked.mzML,-out,features.featureXML"));
+    pipeline.run();
+    @endcode
+
+    Stages run in the order they were added, which therefore has to be a
+    topological order of the data flow. Files are only written where a stage
+    is given a real file name. An in-memory data set is released as soon as
+    the last stage referring to it finished, unless it was marked with
+    keep().
+
+    @ingroup TOPP
+  */
+  class OPENMS_DLLAPI TOPPPipeline
+  {
+public:
+    /// Default constructor
+    TOPPPipeline();
+
+    /// Destructor
+    ~TOPPPipeline();
+
+    /// Appends stage @p tool (ownership is taken over) invoked with command line @p arguments
+    void addStage(TOPPBase* tool, const StringList& arguments);
+
+    /// Number of stages
+    Size size() const;
+
+    /// Keep the in-memory data set @p name after the pipeline ran (e.g. to access it via InMemoryFileStore)
+    void keep(const String& name);
+
+    /**
+      @brief Runs all stages in order
+
+      Stops at the first stage which fails. In this case all in-memory data
+      sets referenced by any stage (and not kept) are removed.
+
+      @return The exit code of the first failing stage or TOPPBase::EXECUTION_OK
+    */
+    TOPPBase::ExitCodes run();
+
+    /// Index of the stage which failed in the last run() (or size() if none failed)
+    Size getFailedStage() const;
+
+private:
+    /// Forbidden copy constructor
+    TOPPPipeline(const TOPPPipeline&);
+    /// Forbidden assignment operator
+    TOPPPipeline& operator=(const TOPPPipeline&);
+
+    /// Index of the last stage referencing each in-memory name
+    std::map<String, Size> lastUse_() const;
+
+    std::vector<std::unique_ptr<TOPPBase> > tools_;
+    std::vector<StringList> arguments_;
+    std::set<String> kept_;
+    Size failed_stage_;
+  };
+
+} // namespace OpenMS
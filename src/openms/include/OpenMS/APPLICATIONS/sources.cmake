@@ -9,6 +9,7 @@ MapAlignerBase.h
 ParameterInformation.h
 ToolHandler.h
 TOPPBase.h
+TOPPPipeline.h
 )
 
 ### add path to the filenames
@@ -445,6 +445,9 @@ protected:
     /// sets the N-terminal modification
     void setNTerminalModification(const String& modification);
 
+    /// sets the N-terminal modification (no lookup in ModificationsDB, nullptr removes the modification)
+    void setNTerminalModification(const ResidueModification* modification);
+
     /// returns the name (ID) of the N-terminal modification, or an empty string if none is set
     const String& getNTerminalModificationName() const;
 
@@ -454,6 +457,9 @@ protected:
     /// sets the C-terminal modification
     void setCTerminalModification(const String& modification);
 
+    /// sets the C-terminal modification (no lookup in ModificationsDB, nullptr removes the modification)
+    void setCTerminalModification(const ResidueModification* modification);
+
     /// returns the name (ID) of the C-terminal modification, or an empty string if none is set
     const String& getCTerminalModificationName() const;
 
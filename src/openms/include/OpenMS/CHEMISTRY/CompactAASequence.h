@@ -0,0 +1,222 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2018.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// --------------------------------------------------------------------------
+// $Maintainer: Timo Sachsenberg $
+// $Authors: Timo Sachsenberg $
+// --------------------------------------------------------------------------
+
+#pragma once
+
+#include <OpenMS/CHEMISTRY/AASequence.h>
+
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+namespace OpenMS
+{
+  class Residue;
+  class ResidueModification;
+
+  /**
+    @ingroup Chemistry
+
+    @brief Compact, hashable representation of a (modified) amino acid sequence
+
+    AASequence stores one Residue pointer per position, and AASequence::fromString()
+    parses modifications through ModificationsDB (which is locked) on every
+    call. Identification post-processing (e.g. filtering, inference and
+    indexing) mostly copies, compares and hashes sequences, which makes sets
+    and maps of AASequence objects expensive.
+
+    This class stores the one-letter codes of the residues as a string (one
+    byte per residue) and only keeps the Residue pointers of the modified
+    residues in a small table sorted by position, plus the terminal
+    modifications. The hash value is computed once on construction, so
+    hashing is free and comparisons of unequal sequences usually stop at the
+    hash. Unmodified sequences are parsed by fromString() via a table lookup
+    in ResidueDB without going through ModificationsDB.
+
+    Use intern() to obtain a canonical instance from a global pool: equal
+    sequences are interned to the same object, so that interned sequences can
+    be compared and hashed by address.
+
+    The comparison operators order sequences the same way as the
+    corresponding AASequence operators.
+  */
+  class OPENMS_DLLAPI CompactAASequence
+  {
+public:
+    /// Modified residues as (position, residue) pairs, sorted by position
+    typedef std::vector<std::pair<Size, const Residue*> > ModifiedResidues;
+
+    /// Hash functor, e.g. for std::unordered_set / std::unordered_map
+    struct Hash
+    {
+      std::size_t operator()(const CompactAASequence& sequence) const
+      {
+        return sequence.getHash();
+      }
+    };
+
+    /** @name Constructors
+    */
+    //@{
+    /// Default constructor (empty sequence)
+    CompactAASequence();
+
+    /// Conversion from AASequence
+    explicit CompactAASequence(const AASequence& sequence);
+
+    /**
+      @brief Creates a sequence from a string (same syntax as AASequence::fromString())
+
+      Sequences that consist of unmodified one-letter codes only are parsed
+      without ModificationsDB, everything else is parsed via AASequence::fromString().
+
+      @throw Exception::ParseError if the sequence cannot be parsed
+    */
+    static CompactAASequence fromString(const String& sequence);
+    //@}
+
+    /// Conversion to AASequence
+    AASequence toAASequence() const;
+
+    /** @name Accessors
+    */
+    //@{
+    /// returns the sequence as string with modifications (same as AASequence::toString())
+    String toString() const;
+
+    /// returns the one-letter codes of the residues (without modifications)
+    inline const String& toUnmodifiedString() const
+    {
+      return residues_;
+    }
+
+    /// returns the number of residues
+    inline Size size() const
+    {
+      return residues_.size();
+    }
+
+    /// returns true if the sequence has no residues
+    inline bool empty() const
+    {
+      return residues_.empty();
+    }
+
+    /// returns true if any residue or terminus is modified
+    inline bool isModified() const
+    {
+      return !modified_.empty() || n_term_mod_ != nullptr || c_term_mod_ != nullptr;
+    }
+
+    /// returns the residue at position @p index
+    const Residue* getResidue(Size index) const;
+
+    /// returns the modified residues, sorted by position
+    inline const ModifiedResidues& getModifiedResidues() const
+    {
+      return modified_;
+    }
+
+    /// returns the N-terminal modification, or nullptr if none is set
+    inline const ResidueModification* getNTerminalModification() const
+    {
+      return n_term_mod_;
+    }
+
+    /// returns the C-terminal modification, or nullptr if none is set
+    inline const ResidueModification* getCTerminalModification() const
+    {
+      return c_term_mod_;
+    }
+
+    /// returns the hash value (computed on construction)
+    inline std::size_t getHash() const
+    {
+      return hash_;
+    }
+    //@}
+
+    /** @name Predicates
+    */
+    //@{
+    /// equality operator
+    bool operator==(const CompactAASequence& rhs) const;
+
+    /// inequality operator
+    bool operator!=(const CompactAASequence& rhs) const;
+
+    /// less than operator (same order as AASequence::operator<)
+    bool operator<(const CompactAASequence& rhs) const;
+    //@}
+
+    /**
+      @brief Returns the canonical instance of @p sequence from a global pool
+
+      The returned reference stays valid until the end of the program. Equal
+      sequences yield the same instance. Thread-safe.
+    */
+    static const CompactAASequence& intern(const CompactAASequence& sequence);
+
+    /// returns the number of sequences in the global pool (see intern())
+    static Size getInternedCount();
+
+protected:
+    /// residue of @p index that is stored in the modification table, or nullptr
+    const Residue* getModifiedResidue_(Size index) const;
+
+    /// computes hash_ from the other members
+    void updateHash_();
+
+    /// one-letter codes
+    String residues_;
+
+    /// residues that are not the unmodified residue of their one-letter code
+    ModifiedResidues modified_;
+
+    /// N-terminal modification
+    const ResidueModification* n_term_mod_;
+
+    /// C-terminal modification
+    const ResidueModification* c_term_mod_;
+
+    /// cached hash value
+    std::size_t hash_;
+  };
+
+  /// Print the sequence to a stream (same as AASequence)
+  OPENMS_DLLAPI std::ostream& operator<<(std::ostream& os, const CompactAASequence& sequence);
+
+} // namespace OpenMS
+
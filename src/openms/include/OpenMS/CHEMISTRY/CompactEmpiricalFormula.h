@@ -0,0 +1,223 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2018.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: Chris Bielow $
+// $Authors: Chris Bielow $
+// --------------------------------------------------------------------------
+
+#pragma once
+
+#include <OpenMS/CHEMISTRY/EmpiricalFormula.h>
+
+#include <utility>
+#include <vector>
+
+namespace OpenMS
+{
+  class Element;
+
+  /**
+    @ingroup Chemistry
+
+    @brief Compact representation of an empirical formula for fast formula arithmetic
+
+    EmpiricalFormula stores the element counts in a std::map, every addition,
+    subtraction or mass computation therefore walks a tree and allocates
+    nodes. This class stores the counts of the elements C, H, N, O, P and S
+    inline (in a fixed array) and only uses a small sorted list for all other
+    elements (including specific isotopes such as (13)C). Arithmetic on
+    formulas consisting of these elements does not allocate memory, which is
+    useful when many formulas are enumerated (e.g. candidate compositions or
+    adduct combinations).
+
+    The element masses are taken from ElementDB once and cached, masses are
+    therefore the same as those of the corresponding EmpiricalFormula (up to
+    rounding, since the summation order may differ).
+
+    Use the constructor and toEmpiricalFormula() to convert from and to
+    EmpiricalFormula, e.g. to compute isotope distributions or to obtain a
+    string representation.
+  */
+  class OPENMS_DLLAPI CompactEmpiricalFormula
+  {
+public:
+    /// Elements whose counts are stored inline
+    enum CommonElement
+    {
+      C = 0,
+      H,
+      N,
+      O,
+      P,
+      S,
+      SIZE_OF_COMMONELEMENT
+    };
+
+    /// Element and count of all other elements (sorted by element, no zero counts)
+    typedef std::vector<std::pair<const Element*, SignedSize> > OtherElements;
+
+    /** @name Constructors
+    */
+    //@{
+    /// Default constructor (empty formula)
+    CompactEmpiricalFormula();
+
+    /// Conversion from EmpiricalFormula
+    explicit CompactEmpiricalFormula(const EmpiricalFormula& formula);
+
+    /**
+      @brief Constructor from a string (same syntax as EmpiricalFormula)
+
+      @throw Exception::ParseError if the formula cannot be parsed
+    */
+    explicit CompactEmpiricalFormula(const String& formula);
+
+    /// Constructor with element pointer and number
+    CompactEmpiricalFormula(SignedSize number, const Element* element, SignedSize charge = 0);
+    //@}
+
+    /// Conversion to EmpiricalFormula
+    EmpiricalFormula toEmpiricalFormula() const;
+
+    /** @name Accessors
+    */
+    //@{
+    /// returns the mono isotopic weight of the formula (includes proton charges)
+    double getMonoWeight() const;
+
+    /// returns the average weight of the formula (includes proton charges)
+    double getAverageWeight() const;
+
+    /// returns the number of atoms of a common element (can be negative)
+    inline SignedSize getNumberOf(CommonElement element) const
+    {
+      return counts_[element];
+    }
+
+    /// sets the number of atoms of a common element (can be negative)
+    inline void setNumberOf(CommonElement element, SignedSize number)
+    {
+      counts_[element] = number;
+    }
+
+    /// returns the number of atoms for a certain @p element (can be negative)
+    SignedSize getNumberOf(const Element* element) const;
+
+    /// returns the atoms total (negative counts reduce the overall count)
+    SignedSize getNumberOfAtoms() const;
+
+    /// returns the counts of all elements except C, H, N, O, P and S
+    inline const OtherElements& getOtherElements() const
+    {
+      return other_;
+    }
+
+    /// returns the charge
+    inline SignedSize getCharge() const
+    {
+      return charge_;
+    }
+
+    /// sets the charge
+    inline void setCharge(SignedSize charge)
+    {
+      charge_ = charge;
+    }
+
+    /// returns the formula as a string (charges are not included, see EmpiricalFormula::toString())
+    String toString() const;
+
+    /// returns the Element object of a common element
+    static const Element* getElement(CommonElement element);
+    //@}
+
+    /** @name Arithmetic
+    */
+    //@{
+    /// adds the elements (and charge) of the given formula
+    CompactEmpiricalFormula& operator+=(const CompactEmpiricalFormula& rhs);
+
+    /// subtracts the elements (and charge) of the given formula
+    CompactEmpiricalFormula& operator-=(const CompactEmpiricalFormula& rhs);
+
+    /// multiplies the elements and charge with a factor
+    CompactEmpiricalFormula& operator*=(SignedSize times);
+
+    /// adds the elements of the given formula and returns a new formula
+    CompactEmpiricalFormula operator+(const CompactEmpiricalFormula& rhs) const;
+
+    /// subtracts the elements of a formula and returns a new formula
+    CompactEmpiricalFormula operator-(const CompactEmpiricalFormula& rhs) const;
+
+    /// multiplies the elements and charge with a factor and returns a new formula
+    CompactEmpiricalFormula operator*(SignedSize times) const;
+    //@}
+
+    /** @name Predicates
+    */
+    //@{
+    /// returns true if the formula does not contain an element
+    bool isEmpty() const;
+
+    /// returns true if the formula only contains C, H, N, O, P and S
+    inline bool hasOnlyCommonElements() const
+    {
+      return other_.empty();
+    }
+
+    /// returns true if the formulas contain equal elements in equal quantities and have the same charge
+    bool operator==(const CompactEmpiricalFormula& rhs) const;
+
+    /// returns true if the formulas differ in elements composition or charge
+    bool operator!=(const CompactEmpiricalFormula& rhs) const;
+
+    /// less operator (arbitrary but strict weak ordering)
+    bool operator<(const CompactEmpiricalFormula& rhs) const;
+    //@}
+
+protected:
+    /// adds @p number atoms of an element which is not a common element
+    void addOther_(const Element* element, SignedSize number);
+
+    /// returns the index of a common element, or SIZE_OF_COMMONELEMENT
+    static Size commonIndex_(const Element* element);
+
+    SignedSize counts_[SIZE_OF_COMMONELEMENT];
+
+    SignedSize charge_;
+
+    OtherElements other_;
+  };
+
+  /// writes the formula to a stream (same format as for EmpiricalFormula)
+  OPENMS_DLLAPI std::ostream& operator<<(std::ostream& os, const CompactEmpiricalFormula& formula);
+
+} // namespace OpenMS
+
@@ -69,11 +69,7 @@ namespace OpenMS
     /// this member function serves as a replacement of the constructor
     static InstanceType* getInstance()
     {
-      static InstanceType* db_ = nullptr;
-      if (db_ == nullptr)
-      {
-        db_ = new InstanceType;
-      }
+      static InstanceType* db_ = new InstanceType;
       return db_;
     }
 
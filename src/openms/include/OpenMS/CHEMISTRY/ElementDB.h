@@ -76,11 +76,7 @@ public:
     /// returns a pointer to the singleton instance of the element db
     inline static const ElementDB * getInstance()
     {
-      static ElementDB * db_ = nullptr;
-      if (db_ == nullptr)
-      {
-        db_ = new ElementDB;
-      }
+      static ElementDB* db_ = new ElementDB;
       return db_;
     }
 
@@ -170,6 +170,13 @@ protected:
      */
     std::vector<int> tokenize_(const String& sequence, int start = 0, int end = -1) const;
 
+    /**
+      @brief Same as tokenize_(const String&, int, int), but writes the cleavage positions to @p positions
+
+      The buffer is cleared first, so it can be reused across calls without reallocation.
+     */
+    void tokenize_(const String& sequence, std::vector<int>& positions, int start = 0, int end = -1) const;
+
     /**
        @brief Helper function for digestUnmodified()
 
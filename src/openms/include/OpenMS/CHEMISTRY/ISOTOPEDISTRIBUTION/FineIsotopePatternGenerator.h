@@ -37,8 +37,12 @@
 #include <OpenMS/CHEMISTRY/ISOTOPEDISTRIBUTION/IsotopePatternGenerator.h>
 #include <OpenMS/CHEMISTRY/ISOTOPEDISTRIBUTION/IsotopeDistribution.h>
 
+#include <vector>
+
 namespace OpenMS
 {
+  class Element;
+  class IsoSpec;
 
   /**
     * @ingroup Chemistry
@@ -117,6 +121,39 @@ namespace OpenMS
       **/
     IsotopeDistribution run(const EmpiricalFormula&) const;
 
+    /**
+      * @brief Creates the isotope distributions of many sum formulas
+      *
+      * The result is the same as calling run() for each formula (up to
+      * rounding of probabilities exactly at the threshold), but the formulas
+      * are processed in parallel and, for a relative threshold, each thread
+      * computes the marginal distribution of each element and atom count only
+      * once (see IsoSpec::runCached()). An empty formula results in a
+      * distribution with a single peak at mass 0.
+      *
+      * @param formulas The sum formulas
+      * @return One isotope distribution (sorted by m/z) per formula
+      **/
+    std::vector<IsotopeDistribution> run(const std::vector<EmpiricalFormula>& formulas) const;
+
+    /**
+      * @brief Creates the isotope distributions of many sum formulas and stores them in flat arrays
+      *
+      * Same as above, but the peaks of all distributions are stored in
+      * @p masses and @p probabilities: the peaks of formula i (sorted by mass)
+      * are the entries offsets[i] to offsets[i + 1] - 1. This avoids
+      * creating one container per formula when scoring many candidates.
+      *
+      * @param formulas The sum formulas
+      * @param masses Masses of all peaks
+      * @param probabilities Probabilities of all peaks
+      * @param offsets Start of the peaks of each formula (size: number of formulas + 1)
+      **/
+    void run(const std::vector<EmpiricalFormula>& formulas,
+             std::vector<double>& masses,
+             std::vector<double>& probabilities,
+             std::vector<Size>& offsets) const;
+
     /// Set probability threshold (stop condition)
     void setThreshold(double threshold)
     {
@@ -142,6 +179,21 @@ namespace OpenMS
     }
 
  protected:
+    /// Isotope masses and probabilities of the elements used by @p formulas (in the format of IsoSpec::runCached())
+    struct ElementTable_
+    {
+      std::vector<const Element*> elements;
+      std::vector<std::vector<double> > masses;
+      std::vector<std::vector<double> > probabilities;
+    };
+
+    /// Collects the elements of all formulas
+    static void collectElements_(const std::vector<EmpiricalFormula>& formulas, ElementTable_& table);
+
+    /// Runs IsoSpec on @p formula (elements from @p table), the result is sorted by mass and stored in @p peaks
+    static void runCached_(const EmpiricalFormula& formula, const ElementTable_& table, IsoSpec& algorithm,
+                           std::vector<int>& element_ids, std::vector<int>& atom_counts, std::vector<Peak1D>& peaks);
+
     double threshold_ = 0.01;
     bool absolute_ = false;
 
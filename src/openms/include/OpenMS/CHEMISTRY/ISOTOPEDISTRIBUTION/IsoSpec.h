@@ -34,12 +34,16 @@
 
 #pragma once
 
+#include <map>
+#include <memory>
+#include <utility>
 #include <vector>
 
 #include <OpenMS/CONCEPT/Types.h>
 #include <OpenMS/CONCEPT/Constants.h>
 
 class Iso;
+class PrecalculatedMarginal;
 
 namespace OpenMS
 {
@@ -92,6 +96,39 @@ public:
       **/
     void run(const std::string&);
 
+    /**
+      * @brief Run the algorithm, reusing the marginal distributions of previous calls
+      *
+      * Same as run() above, but the elements are given as indices into a
+      * table of elements (@p elementMasses and @p elementProbabilities) and
+      * the precalculated marginal distribution of each element and atom count
+      * is kept in this object and reused by subsequent calls. For a relative
+      * threshold, the marginal distribution of an element does not depend on
+      * the other elements of the formula, results are therefore the same as
+      * those of run() (up to rounding of probabilities exactly at the
+      * threshold). For an absolute threshold, nothing is cached and run() is
+      * used.
+      *
+      * An empty formula results in a single configuration (mass 0,
+      * probability 1).
+      *
+      * @note The cache is not thread-safe, use one object per thread.
+      *
+      * @param elementIds Index of each element of the formula in the element table
+      * @param atomCounts How many atoms of each element we have
+      * @param elementMasses Isotopic masses of each element of the table (must not change between calls)
+      * @param elementProbabilities Isotopic probabilities of each element of the table (must not change between calls)
+      *
+      * @exception Exception::IllegalArgument is thrown if an isotope probability is not larger than zero
+      **/
+    void runCached(const std::vector<int>& elementIds,
+                   const std::vector<int>& atomCounts,
+                   const std::vector<std::vector<double> >& elementMasses,
+                   const std::vector<std::vector<double> >& elementProbabilities);
+
+    /// Removes all marginal distributions cached by runCached()
+    void clearCache();
+
     /// Get computed masses
     const std::vector<double>& getMasses();
 
@@ -110,11 +147,25 @@ protected:
       **/
     void run_(Iso* iso);
 
+    /// Enumerates all configurations above the threshold from the marginal distributions in marginals_
+    void enumerateCached_(double mode_lprob);
+
     double threshold_ = 0.01;
     bool absolute_ = false;
 
     std::vector<double> masses_;
     std::vector<double> probabilities_;
+
+    /// Marginal distributions of runCached() by (element index, atom count)
+    std::map<std::pair<int, int>, std::shared_ptr<PrecalculatedMarginal> > marginal_cache_;
+
+    /// Working memory of runCached()
+    std::vector<const PrecalculatedMarginal*> marginals_;
+    std::vector<int> counter_;
+    std::vector<double> max_confs_lp_sum_;
+    std::vector<double> partial_lprobs_;
+    std::vector<double> partial_masses_;
+    std::vector<double> partial_eprobs_;
   };
 }
 
@@ -0,0 +1,128 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2018.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: Chris Bielow $
+// $Authors: Hannes Roest $
+// --------------------------------------------------------------------------
+
+
+#pragma once
+
+#include <OpenMS/CONCEPT/Types.h>
+#include <OpenMS/DATASTRUCTURES/String.h>
+
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace OpenMS
+{
+  class EmpiricalFormula;
+
+  /**
+    @brief Process-wide cache of coarse isotope patterns
+
+    Several algorithms compare observed isotope intensities to theoretical
+    isotope patterns of the same masses or sum formulas over and over again
+    (e.g. FeatureFindingMetabo for the averagine model and
+    AccurateMassSearchEngine for the isotope similarity of database hits).
+    This cache computes each pattern once (with CoarseIsotopePatternGenerator)
+    and stores its intensities normalized to a maximum of 1.
+
+    Averagine patterns are cached per mass bin of getMassResolution() Da and
+    computed for the center of the bin, patterns of sum formulas per formula.
+    Patterns for different numbers of isotopes are cached separately.
+
+    The cache is shared by all users (see getInstance()) and can be queried
+    concurrently. Returned references stay valid until clear() is called.
+
+    @ingroup Chemistry
+  */
+  class OPENMS_DLLAPI IsotopePatternCache
+  {
+public:
+    /// Returns the process-wide instance
+    static IsotopePatternCache* getInstance();
+
+    /**
+      @brief Returns the (normalized) averagine isotope pattern of a peptide mass
+
+      @param mass Average weight of the peptide
+      @param max_isotope Maximal number of isotopes (0 for all)
+    */
+    const std::vector<double>& getAveragineIntensities(double mass, Size max_isotope);
+
+    /**
+      @brief Returns the (normalized) isotope pattern of a sum formula
+
+      @param formula The sum formula
+      @param max_isotope Maximal number of isotopes (0 for all)
+    */
+    const std::vector<double>& getFormulaIntensities(const EmpiricalFormula& formula, Size max_isotope);
+
+    /// Width of the mass bins for averagine patterns (in Da)
+    static double getMassResolution();
+
+    /// Number of cached patterns
+    Size size() const;
+
+    /// Removes all patterns (invalidates all references, must not be called concurrently with queries)
+    void clear();
+
+protected:
+    /// Key of an averagine pattern: (mass bin, maximal number of isotopes)
+    typedef std::pair<Int64, Size> MassKey_;
+    /// Key of a formula pattern: (formula, maximal number of isotopes)
+    typedef std::pair<std::string, Size> FormulaKey_;
+
+    struct MassKeyHash_
+    {
+      std::size_t operator()(const MassKey_& key) const;
+    };
+
+    struct FormulaKeyHash_
+    {
+      std::size_t operator()(const FormulaKey_& key) const;
+    };
+
+    /// Scales intensities to a maximum of 1
+    static void normalize_(std::vector<double>& intensities);
+
+    IsotopePatternCache();
+
+    IsotopePatternCache(const IsotopePatternCache&) = delete;
+    IsotopePatternCache& operator=(const IsotopePatternCache&) = delete;
+
+    std::unordered_map<MassKey_, std::vector<double>, MassKeyHash_> averagine_cache_;
+    std::unordered_map<FormulaKey_, std::vector<double>, FormulaKeyHash_> formula_cache_;
+  };
+
+}
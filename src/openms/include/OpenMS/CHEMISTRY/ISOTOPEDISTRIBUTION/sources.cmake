@@ -6,6 +6,7 @@ set(directory include/OpenMS/CHEMISTRY/ISOTOPEDISTRIBUTION)
 set(sources_list_h
   CoarseIsotopePatternGenerator.h
   IsotopeDistribution.h
+  IsotopePatternCache.h
   IsotopePatternGenerator.h
 )
 
@@ -119,14 +119,33 @@ public:
 
       /**
         Gets number of all possible decompositions for a given @c mass.
-        Since using getAllDecomposition() the usage of this function could
-        be @b consuming.
+        The decompositions are enumerated but not stored.
 
         @param mass Mass to be decomposed
         @return number of decompositions for a given mass.
       */
       decomposition_value_type getNumberOfDecompositions(value_type mass) override;
 
+      /**
+        Enumerates all possible decompositions for @c mass without storing
+        them. @p visitor is called as <tt>bool visitor(const decomposition_type&)</tt>
+        for every decomposition. The enumeration stops as soon as the visitor
+        returns false, which allows bounded enumeration and count-only queries.
+
+        The decomposer is not modified, therefore several threads may visit
+        decompositions of the same decomposer concurrently.
+
+        @param mass Mass to be decomposed.
+        @param visitor Functor called for every decomposition.
+        @return false if the enumeration was stopped by the visitor, otherwise true.
+      */
+      template <typename Visitor>
+      bool visitDecompositions(value_type mass, Visitor & visitor) const
+      {
+        decomposition_type decomposition(alphabet_.size());
+        return visitDecompositionsRecursively_(mass, alphabet_.size() - 1, decomposition, visitor);
+      }
+
 private:
 
       /**
@@ -188,15 +207,43 @@ private:
                                      witness_vector_type & _witness_vector, residues_table_type & _ertable);
 
       /**
-        Collects decompositions for @c mass by recursion.
+        Enumerates the decompositions for @c mass by recursion and hands each
+        one to @p visitor.
 
         @param mass Mass to be decomposed.
         @param alphabetMassIndex An index of the mass in alphabet that is used on this step of recursion.
-        @param decomposition Decomposition which is calculated on this step of recursion.
-        @param decompositionsStore Container where decompositions are collected.
+        @param decomposition Decomposition which is calculated on this step of recursion. Entries
+        below @p alphabetMassIndex are overwritten by the recursion.
+        @param visitor Called for every decomposition found, stops the recursion by returning false.
+        @return false if the enumeration was stopped by the visitor, otherwise true.
       */
-      void collectDecompositionsRecursively_(value_type mass, size_type alphabetMassIndex,
-                                             decomposition_type decomposition, decompositions_type & decompositionsStore);
+      template <typename Visitor>
+      bool visitDecompositionsRecursively_(value_type mass, size_type alphabetMassIndex,
+                                           decomposition_type & decomposition, Visitor & visitor) const;
+
+      /// Visitor collecting all decompositions into a container
+      struct DecompositionCollector_
+      {
+        decompositions_type & store;
+
+        bool operator()(const decomposition_type & decomposition)
+        {
+          store.push_back(decomposition);
+          return true;
+        }
+      };
+
+      /// Visitor counting decompositions without storing them
+      struct DecompositionCounter_
+      {
+        size_type count;
+
+        bool operator()(const decomposition_type &)
+        {
+          ++count;
+          return true;
+        }
+      };
     };
 
 
@@ -463,15 +510,16 @@ private:
     IntegerMassDecomposer<ValueType, DecompositionValueType>::getAllDecompositions(value_type mass)
     {
       decompositions_type decompositionsStore;
-      decomposition_type decomposition(alphabet_.size());
-      collectDecompositionsRecursively_(mass, alphabet_.size() - 1, decomposition, decompositionsStore);
+      DecompositionCollector_ collector = {decompositionsStore};
+      visitDecompositions(mass, collector);
       return decompositionsStore;
     }
 
     template <typename ValueType, typename DecompositionValueType>
-    void IntegerMassDecomposer<ValueType, DecompositionValueType>::
-    collectDecompositionsRecursively_(value_type mass, size_type alphabetMassIndex,
-                                      decomposition_type decomposition, decompositions_type & decompositionsStore)
+    template <typename Visitor>
+    bool IntegerMassDecomposer<ValueType, DecompositionValueType>::
+    visitDecompositionsRecursively_(value_type mass, size_type alphabetMassIndex,
+                                    decomposition_type & decomposition, Visitor & visitor) const
     {
       if (alphabetMassIndex == 0)
       {
@@ -479,9 +527,9 @@ private:
         if (numberOfMasses0 * alphabet_.getWeight(0) == mass)
         {
           decomposition[0] = static_cast<decomposition_value_type>(numberOfMasses0);
-          decompositionsStore.push_back(decomposition);
+          return visitor(static_cast<const decomposition_type &>(decomposition));
         }
-        return;
+        return true;
       }
 
       // tested: caching these values gives us 15% better performance, at least
@@ -515,7 +563,10 @@ private:
             // the condition of the 'for' loop (m >= r) and decrementing the mass
             // in steps of the lcm ensures that m is decomposable. Therefore
             // the recursion will result in at least one witness.
-            collectDecompositionsRecursively_(m, alphabetMassIndex - 1, decomposition, decompositionsStore);
+            if (!visitDecompositionsRecursively_(m, alphabetMassIndex - 1, decomposition, visitor))
+            {
+              return false;
+            }
             decomposition[alphabetMassIndex] += mass_in_lcm;
             // this check is needed because mass could have unsigned type and after reduction on i*alphabetMass will be still be positive but huge
             // and that will end up in infinite loop
@@ -535,13 +586,12 @@ private:
           mass_mod_alphabet0 -= mass_mod_decrement;
         }
       }
-
+      return true;
     }
 
     /**
       Gets number of all possible decompositions for a given @c mass.
-      Since using getAllDecomposition() the usage of this function could
-      be @b consuming.
+      The decompositions are only counted, not stored.
 
       @param mass Mass to be decomposed
       @return number of decompositions for given mass.
@@ -550,7 +600,9 @@ private:
     typename IntegerMassDecomposer<ValueType, DecompositionValueType>::decomposition_value_type IntegerMassDecomposer<ValueType,
                                                                                                                       DecompositionValueType>::getNumberOfDecompositions(value_type mass)
     {
-      return static_cast<typename IntegerMassDecomposer<ValueType, DecompositionValueType>::decomposition_value_type>(getAllDecompositions(mass).size());
+      DecompositionCounter_ counter = {0};
+      visitDecompositions(mass, counter);
+      return static_cast<typename IntegerMassDecomposer<ValueType, DecompositionValueType>::decomposition_value_type>(counter.count);
     }
 
   } // namespace ims
@@ -38,6 +38,7 @@
 #include <utility>
 #include <map>
 #include <memory>
+#include <vector>
 
 #include <OpenMS/CHEMISTRY/MASSDECOMPOSITION/IMS/IntegerMassDecomposer.h>
 
@@ -62,6 +63,10 @@ namespace OpenMS
       them using @c IntegerMassDecomposer, does some checks (i.e. on false
       positives appeared due to rounding) and collects decompositions together.
 
+      The extended residue table of the integer decomposer is computed once
+      in the constructor. All queries are const, so a single decomposer can
+      answer queries from several threads concurrently.
+
       @author Anton Pervukhin <Anton.Pervukhin@CeBiTec.Uni-Bielefeld.DE>
     */
     class OPENMS_DLLAPI RealMassDecomposer
@@ -96,9 +101,32 @@ public:
         @param error Error allowed between given and result decomposition.
         @return All possible decompositions for a given mass and error.
       */
-      decompositions_type getDecompositions(double mass, double error);
+      decompositions_type getDecompositions(double mass, double error) const;
 
-      decompositions_type getDecompositions(double mass, double error, const constraints_type & constraints);
+      decompositions_type getDecompositions(double mass, double error, const constraints_type & constraints) const;
+
+      /**
+        Gets at most @p max_decompositions decompositions for a @c mass with
+        an @c error allowed. The enumeration stops as soon as the limit is
+        reached, the returned decompositions are the first ones that
+        getDecompositions(double,double) would return.
+
+        @param mass Mass to be decomposed.
+        @param error Error allowed between given and result decomposition.
+        @param max_decompositions Maximal number of decompositions returned.
+        @return Decompositions for a given mass and error.
+      */
+      decompositions_type getDecompositions(double mass, double error, number_of_decompositions_type max_decompositions) const;
+
+      /**
+        Gets all decompositions for each of the @p masses with an @c error
+        allowed. The masses are decomposed in parallel if OpenMP is enabled.
+
+        @param masses Masses to be decomposed.
+        @param error Error allowed between given and result decomposition.
+        @return Decompositions for every mass, in the order of @p masses.
+      */
+      std::vector<decompositions_type> getDecompositions(const std::vector<double> & masses, double error) const;
 
       /**
        Gets a number of all decompositions for a @c mass with an @c error
@@ -109,9 +137,28 @@ public:
        @param error Error allowed between given and result decomposition.
        @return Number of all decompositions for a given mass and error.
       */
-      number_of_decompositions_type getNumberOfDecompositions(double mass, double error);
+      number_of_decompositions_type getNumberOfDecompositions(double mass, double error) const;
+
+      /**
+       Counts the decompositions for a @c mass with an @c error allowed, but
+       stops counting at @p max_decompositions. Useful to test whether a mass
+       has few or many decompositions without enumerating all of them.
+
+       @param mass Mass to be decomposed.
+       @param error Error allowed between given and result decomposition.
+       @param max_decompositions Upper bound of the count.
+       @return Number of decompositions, at most @p max_decompositions.
+      */
+      number_of_decompositions_type getNumberOfDecompositions(double mass, double error, number_of_decompositions_type max_decompositions) const;
 
 private:
+      /**
+        Decomposes all integer masses in [@p start_integer_mass, @p end_integer_mass)
+        and passes each decomposition to @p visitor until it returns false.
+      */
+      template <typename Visitor>
+      void visitRange_(integer_value_type start_integer_mass, integer_value_type end_integer_mass, Visitor & visitor) const;
+
       /// Weights over which values/masses to be decomposed.
       Weights weights_;
 
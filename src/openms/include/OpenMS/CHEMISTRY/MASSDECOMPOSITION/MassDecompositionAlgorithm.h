@@ -50,6 +50,7 @@
 #pragma warning( pop )
 #endif
 
+#include <memory>
 #include <vector>
 
 namespace OpenMS
@@ -59,7 +60,13 @@ namespace OpenMS
 
     A mass decomposition algorithm decomposes a mass or a mass difference into
     possible amino acids and frequencies of them, which add up to the given mass.
-    This class is a wrapper for the algorithm published in
+    This class is a wrapper for the algorithm published in "Efficient Mass
+    Decomposition", S. Böcker, Z. Lipták, ACM SAC-BIO, 2004.
+
+    The extended residue table of the decomposer only depends on the masses of
+    the alphabet and the precision. It is computed once per alphabet and shared
+    between all instances of this class, changing only the tolerance does not
+    trigger a recomputation.
 
     @htmlinclude OpenMS_MassDecompositionAlgorithm.parameters
 
@@ -86,7 +93,19 @@ public:
     */
     //@{
     /// returns the possible decompositions given the weight
-    void getDecompositions(std::vector<MassDecomposition> & decomps, double weight);
+    void getDecompositions(std::vector<MassDecomposition> & decomps, double weight) const;
+
+    /// returns the possible decompositions given the weight, using @p tolerance instead of the "tolerance" parameter
+    void getDecompositions(std::vector<MassDecomposition> & decomps, double weight, double tolerance) const;
+
+    /**
+      @brief returns the possible decompositions for each of the given weights
+
+      The weights are decomposed in parallel if OpenMP is enabled. @p decomps
+      is resized to the number of weights, entry i holds the decompositions
+      of weights[i].
+    */
+    void getDecompositions(std::vector<std::vector<MassDecomposition> > & decomps, const std::vector<double> & weights) const;
     //@}
 
 protected:
@@ -95,7 +114,11 @@ protected:
 
     ims::IMSAlphabet * alphabet_;
 
-    ims::RealMassDecomposer * decomposer_;
+    /// decomposer of the current alphabet, shared between all instances using the same alphabet and precision
+    std::shared_ptr<const ims::RealMassDecomposer> decomposer_;
+
+    /// converts the decompositions of the IMS decomposer to MassDecomposition objects
+    void convertDecompositions_(const ims::RealMassDecomposer::decompositions_type & decompositions, std::vector<MassDecomposition> & decomps) const;
 
 private:
 
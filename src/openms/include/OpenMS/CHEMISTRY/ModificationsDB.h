@@ -38,7 +38,9 @@
 #include <OpenMS/DATASTRUCTURES/String.h>
 #include <OpenMS/CHEMISTRY/ResidueModification.h>
 
+#include <map>
 #include <set>
+#include <vector>
 
 namespace OpenMS
 {
@@ -73,14 +75,16 @@ namespace OpenMS
   {
 public:
 
-    /// Returns a pointer to the modifications DB (singleton)
+    /**
+      @brief Returns a pointer to the modifications DB (singleton)
+
+      The database files are only read on the first call (the file arguments
+      are ignored afterwards). Initialization is thread-safe, the Unimod,
+      PSI-MOD and XLMOD files are parsed concurrently if OpenMP is enabled.
+    */
     inline static ModificationsDB* getInstance(OpenMS::String unimod_file = "CHEMISTRY/unimod.xml", OpenMS::String psimod_file = "CHEMISTRY/PSI-MOD.obo", OpenMS::String xlmod_file = "CHEMISTRY/XLMOD.obo")
     {
-      static ModificationsDB* db_ = nullptr;
-      if (db_ == nullptr)
-      {
-        db_ = new ModificationsDB(unimod_file, psimod_file, xlmod_file);
-      }
+      static ModificationsDB* db_ = new ModificationsDB(unimod_file, psimod_file, xlmod_file);
       return db_;
     }
 
@@ -243,6 +247,21 @@ private:
 
     /// Adds modifications from a given file in Unimod XML format
     void readFromUnimodXMLFile(const String& filename);
+
+    /**
+       @brief Parses a file in OBO format without modifying the database
+
+       Does not access any member, so several files can be parsed concurrently.
+
+       @throw Exception::ParseError if the file cannot be parsed correctly
+    */
+    static void parseOBOFile_(const String& filename, std::multimap<String, ResidueModification>& all_mods);
+
+    /// Adds modifications parsed by parseOBOFile_() (maps to known Unimod entries where possible)
+    void addOBOModifications_(const std::multimap<String, ResidueModification>& all_mods);
+
+    /// Adds modifications loaded from a Unimod XML file (takes ownership)
+    void addUnimodModifications_(const std::vector<ResidueModification*>& new_mods);
     
   };
 }
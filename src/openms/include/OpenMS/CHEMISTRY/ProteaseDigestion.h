@@ -37,6 +37,9 @@
 #include <OpenMS/CONCEPT/Types.h>
 #include <OpenMS/CHEMISTRY/AASequence.h>
 #include <OpenMS/CHEMISTRY/EnzymaticDigestion.h>
+#include <OpenMS/DATASTRUCTURES/FASTAContainer.h>
+
+#include <algorithm>
 
 #include <string>
 #include <vector>
@@ -77,6 +80,76 @@ namespace OpenMS
     */
     Size digest(const AASequence& protein, std::vector<AASequence>& output, Size min_length = 1, Size max_length = 0) const;
 
+    /// A peptide reported by digestChunk()
+    struct DigestionProduct
+    {
+      Size protein_index; ///< index of the protein in the active chunk of the FASTAContainer (see FASTAContainer::chunkAt())
+      Size start; ///< start position of the peptide in the protein sequence
+      Size length; ///< number of residues of the peptide
+      double mono_weight; ///< monoisotopic weight of the unmodified peptide (including water, uncharged)
+    };
+
+    /**
+      @brief Digests all proteins of the active chunk of a FASTAContainer (see FASTAContainer::activateCache()).
+
+      Peptides are reported as positions into the protein sequences, together
+      with their monoisotopic weight, which is computed from prefix sums over
+      the residue weights. Peptides are filtered by length and weight before
+      any sequence object is built, the caller can use
+      <tt>proteins.chunkAt(p.protein_index).sequence.substr(p.start, p.length)</tt>
+      for the peptides it keeps. Token and weight buffers are reused for all
+      proteins handled by a thread and proteins are digested in parallel if
+      OpenMP is enabled.
+
+      Peptides of the same protein are reported in the order of digest(), proteins in chunk order.
+      Peptides containing characters that are not one-letter codes of ResidueDB have no defined
+      weight and are discarded.
+
+      @param proteins FASTA container with an active chunk
+      @param output Digestion products (cleared first)
+      @param min_length Minimal length of reported products
+      @param max_length Maximal length of reported products (0 = no restriction)
+      @param min_mass Minimal monoisotopic weight of reported products
+      @param max_mass Maximal monoisotopic weight of reported products (0 = no restriction)
+      @return Number of discarded digestion products (which are not matching the length or weight restrictions)
+    */
+    template <typename TBackend>
+    Size digestChunk(const FASTAContainer<TBackend>& proteins, std::vector<DigestionProduct>& output, Size min_length = 1, Size max_length = 0, double min_mass = 0, double max_mass = 0) const
+    {
+      output.clear();
+      const SignedSize prot_count = (SignedSize)proteins.chunkSize();
+      Size wrong_size(0);
+
+#ifdef _OPENMP
+#pragma omp parallel reduction(+: wrong_size)
+#endif
+      {
+        // buffers are reused for all proteins of this thread
+        std::vector<int> positions;
+        std::vector<double> prefix_weights;
+        std::vector<Size> prefix_unknown;
+        std::vector<DigestionProduct> thread_output;
+
+#ifdef _OPENMP
+#pragma omp for schedule(dynamic, 100) nowait
+#endif
+        for (SignedSize i = 0; i < prot_count; ++i)
+        {
+          wrong_size += digestProtein_(proteins.chunkAt(i).sequence, i, positions, prefix_weights, prefix_unknown, thread_output, min_length, max_length, min_mass, max_mass);
+        }
+
+#ifdef _OPENMP
+#pragma omp critical (ProteaseDigestion_digestChunk)
+#endif
+        output.insert(output.end(), thread_output.begin(), thread_output.end());
+      }
+
+      // restore protein order; products of one protein come from the same thread and keep their order
+      std::stable_sort(output.begin(), output.end(),
+        [](const DigestionProduct& a, const DigestionProduct& b) { return a.protein_index < b.protein_index; });
+      return wrong_size;
+    }
+
     /// Returns the number of peptides a digestion of @p protein would yield under the current enzyme and missed cleavage settings.
     Size peptideCount(const AASequence& protein);
 
@@ -99,6 +172,21 @@ namespace OpenMS
     /// forwards to isValidProduct using protein.toUnmodifiedString()
     bool isValidProduct(const AASequence& protein, int pep_pos, int pep_length, bool ignore_missed_cleavages = true, bool allow_nterm_protein_cleavage = false, bool allow_random_asp_pro_cleavage = false) const;
 
+  protected:
+    /**
+      @brief Digests a single unmodified protein sequence for digestChunk()
+
+      @param protein Unmodified protein sequence
+      @param protein_index Index stored in the digestion products
+      @param positions Buffer for the cleavage positions
+      @param prefix_weights Buffer for the prefix sums of residue weights
+      @param prefix_unknown Buffer for the prefix counts of unknown residues
+      @param output Digestion products are appended here
+      @return Number of discarded digestion products
+    */
+    Size digestProtein_(const String& protein, Size protein_index, std::vector<int>& positions, std::vector<double>& prefix_weights, std::vector<Size>& prefix_unknown,
+                        std::vector<DigestionProduct>& output, Size min_length, Size max_length, double min_mass, double max_mass) const;
+
   };
 
 } // namespace OpenMS
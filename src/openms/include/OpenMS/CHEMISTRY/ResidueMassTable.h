@@ -0,0 +1,213 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2018.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: Timo Sachsenberg $
+// $Authors: Timo Sachsenberg $
+// --------------------------------------------------------------------------
+
+#pragma once
+
+#include <OpenMS/CHEMISTRY/ResidueModification.h>
+#include <OpenMS/DATASTRUCTURES/ListUtils.h>
+#include <OpenMS/DATASTRUCTURES/String.h>
+
+#include <map>
+#include <vector>
+
+namespace OpenMS
+{
+  class AASequence;
+
+  /**
+    @brief Immutable table of residue and modification masses for fast, lock-free mass computations
+
+    ResidueDB and ModificationsDB look up residues and modifications by name
+    and create modified residues on demand, which makes them unsuitable for
+    hot loops: they are slow and not thread-safe (e.g. creating AASequence
+    objects in parallel requires a critical section). This table is built
+    once (single-threaded) for the unmodified residues and the residues
+    carrying a given set of modifications, and afterwards only read, it can
+    therefore be shared by all threads without locking.
+
+    Each (modified) residue is identified by a small integer code, a peptide
+    is represented as an EncodedSequence (codes of its residues and indices
+    of the terminal modifications). Masses computed from an encoded sequence
+    are the same as those of the corresponding AASequence.
+
+    Example (mass range of all variants of a peptide before creating any AASequence):
+    @code
+    ResidueMassTable table(ListUtils::create<String>("Carbamidomethyl (C),Oxidation (M)"));
+    ResidueMassTable::EncodedSequence encoded;
+    table.encode("PEPTMCIDEK", encoded);
+    table.applyFixedModifications(fixed, encoded); // fixed = {table.getModificationIndex("Carbamidomethyl (C)")}
+    double min_mass, max_mass;
+    table.getMassRange(encoded, variable, 2, min_mass, max_mass);
+    @endcode
+  */
+  class OPENMS_DLLAPI ResidueMassTable
+  {
+public:
+    /// Code of a (possibly modified) residue
+    typedef UInt32 ResidueCode;
+
+    /// A peptide sequence encoded as residue codes
+    struct EncodedSequence
+    {
+      /// codes of the residues
+      std::vector<ResidueCode> residues;
+      /// index of the N-terminal modification (-1 if none)
+      Int n_term_modification = -1;
+      /// index of the C-terminal modification (-1 if none)
+      Int c_term_modification = -1;
+    };
+
+    /**
+      @brief Builds the table
+
+      Contains all residues of ResidueDB with a one letter code and a known
+      mass, plus, for each of the given modifications, the residues it can be
+      placed on (or the terminal modification).
+
+      @param modifications Names of the modifications (as understood by ModificationsDB, e.g. "Oxidation (M)")
+
+      @exception Exception::ElementNotFound is thrown if a modification is not known
+    */
+    explicit ResidueMassTable(const StringList& modifications = StringList());
+
+    /// Number of residue codes
+    Size getNumberOfResidues() const;
+
+    /// Number of modifications
+    Size getNumberOfModifications() const;
+
+    /// Returns the index of a modification given to the constructor (-1 if unknown)
+    Int getModificationIndex(const String& modification) const;
+
+    /// Internal mono-isotopic mass of a residue (as Residue::getMonoWeight(Residue::Internal))
+    double getResidueMass(ResidueCode code) const;
+
+    /// One letter code of a residue
+    char getOneLetterCode(ResidueCode code) const;
+
+    /// Index of the modification of a residue (-1 if unmodified)
+    Int getResidueModification(ResidueCode code) const;
+
+    /// Mono-isotopic mass difference of a modification
+    double getModificationMass(Size modification) const;
+
+    /**
+      @brief Returns the code of @p code carrying @p modification
+
+      @return Whether the (unmodified) residue can carry the modification (inside of a sequence)
+    */
+    bool getModifiedResidue(ResidueCode code, Size modification, ResidueCode& modified) const;
+
+    /**
+      @brief Encodes an unmodified sequence (one letter codes)
+
+      @return False if the sequence contains a residue without known mass (e.g. 'X' or 'B'), @p encoded is incomplete in this case
+    */
+    bool encode(const String& sequence, EncodedSequence& encoded) const;
+
+    /**
+      @brief Encodes a (modified) peptide
+
+      @exception Exception::ElementNotFound is thrown if a residue or modification of the peptide is not part of the table
+    */
+    void encode(const AASequence& peptide, EncodedSequence& encoded) const;
+
+    /**
+      @brief Applies fixed modifications to an encoded sequence
+
+      The modifications are placed in the same way as
+      ModifiedPeptideGenerator::applyFixedModifications() does for an
+      AASequence (modified residues and existing terminal modifications are
+      kept).
+
+      @param modifications Indices of the fixed modifications
+      @param encoded The sequence
+    */
+    void applyFixedModifications(const std::vector<Size>& modifications, EncodedSequence& encoded) const;
+
+    /**
+      @brief Computes the mass range of all variants with variable modifications
+
+      Determines, for each site of the sequence (residues and termini), the
+      smallest and largest mass difference of the variable modifications
+      ModifiedPeptideGenerator::applyVariableModifications() can place there,
+      and from this a range that contains the (full, uncharged) masses of all
+      variants with up to @p max_variable_mods modifications, including the
+      unmodified sequence. The range is not necessarily tight.
+
+      @param encoded The sequence (with fixed modifications applied)
+      @param modifications Indices of the variable modifications
+      @param max_variable_mods Maximal number of variable modifications per variant
+      @param min_mass Lower bound of the masses
+      @param max_mass Upper bound of the masses
+    */
+    void getMassRange(const EncodedSequence& encoded, const std::vector<Size>& modifications, Size max_variable_mods, double& min_mass, double& max_mass) const;
+
+    /// Mono-isotopic mass (as AASequence::getMonoWeight(Residue::Full, charge))
+    double getMonoWeight(const EncodedSequence& encoded, Int charge = 0) const;
+
+protected:
+    /// A (possibly modified) residue
+    struct ResidueEntry_
+    {
+      double mass;
+      char one_letter_code;
+      Int modification;
+    };
+
+    /// A modification
+    struct ModificationEntry_
+    {
+      String full_id;
+      double diff_mono_mass;
+      char origin;
+      ResidueModification::TermSpecificity term_specificity;
+    };
+
+    /// Code used for one letter codes without residue
+    static const ResidueCode INVALID_CODE_;
+
+    std::vector<ResidueEntry_> residues_;
+    std::vector<ModificationEntry_> modifications_;
+    /// residue code by one letter code
+    std::vector<ResidueCode> unmodified_codes_;
+    /// residue code by modification and one letter code (modification * 256 + letter)
+    std::vector<ResidueCode> modified_codes_;
+    std::map<String, Size> modification_index_;
+    /// mass of water (difference between internal and full residues)
+    double internal_to_full_;
+  };
+
+}
+
@@ -39,6 +39,8 @@
 #include <OpenMS/KERNEL/StandardTypes.h>
 #include <OpenMS/METADATA/DataArrays.h>
 
+#include <vector>
+
 namespace OpenMS
 {
   class AASequence;
@@ -65,6 +67,55 @@ namespace OpenMS
   {
     public:
 
+    /// A fragment ion as generated by getFragmentIons()
+    struct FragmentIon
+    {
+      /// m/z of the ion
+      double mz;
+      /// intensity (as set by the ion type intensity parameters)
+      float intensity;
+      /// number of residues of the ion (e.g. 3 for b3)
+      UInt32 ion_number;
+      /// charge of the ion
+      Int charge;
+      /// ion type ('a', 'b', 'c', 'x', 'y' or 'z')
+      char ion_type;
+    };
+
+    /**
+      @brief Reusable buffers for getFragmentIons()
+
+      The buffers keep their memory between calls, when generating the ions
+      of many peptides with the same buffer no memory is allocated once it
+      has grown to the size needed for the longest peptide.
+    */
+    class FragmentIonBuffer
+    {
+    public:
+      /// The ions generated by the last call of getFragmentIons(), sorted by m/z
+      std::vector<FragmentIon> ions;
+
+    protected:
+      friend class TheoreticalSpectrumGenerator;
+
+      /// State of one ion series (ion type and charge) while merging the series
+      struct Series_
+      {
+        const double* masses; ///< residue mass sums (prefix or suffix) the series is computed from
+        double offset; ///< mass added to the residue mass sums (terminal modification, ion type and protons)
+        double charge;
+        double next_mz; ///< m/z of the next ion of the series (std::numeric_limits<double>::max() if done)
+        Size next; ///< ion number of the next ion
+        Size last; ///< ion number of the last ion
+        float intensity;
+        char ion_type;
+      };
+
+      std::vector<double> prefix_masses_;
+      std::vector<double> suffix_masses_;
+      std::vector<Series_> series_;
+    };
+
     /** @name Constructors and Destructors
     */
     //@{
@@ -87,6 +138,33 @@ namespace OpenMS
     /// returns a spectrum with the ion types, that are set in the tool parameters
     virtual void getSpectrum(PeakSpectrum & spec, const AASequence & peptide, Int min_charge, Int max_charge) const;
 
+    /**
+      @brief Fast path for database searches: generates the fragment ion series of a peptide into a reusable buffer
+
+      Generates the same ions as getSpectrum() for the ion series selected
+      with the "add_*_ions" and "add_first_prefix_ion" parameters (using the
+      configured intensities), but without creating a PeakSpectrum and its
+      DataArrays: isotopes, losses, precursor and immonium ions are not
+      generated, independent of the parameters. The residue masses are only
+      computed once per peptide (prefix and suffix sums) and the ion series,
+      which are already sorted, are merged while computing them, so the ions
+      are emitted sorted by m/z and nothing needs to be sorted afterwards.
+      The buffer can (and should) be reused for all peptides, it only
+      allocates memory when a peptide needs more space than any peptide
+      before (never in a search once it has seen the longest peptide).
+
+      The m/z values are the same as those of getSpectrum() up to floating
+      point rounding (the terms are summed in a different order).
+
+      @param buffer The buffer, the ions are stored in buffer.ions (sorted by m/z)
+      @param peptide The peptide
+      @param min_charge Minimal charge of the ions
+      @param max_charge Maximal charge of the ions
+
+      @exception Exception::InvalidSize is thrown if c or x ions are requested for a peptide with less than two residues
+    */
+    void getFragmentIons(FragmentIonBuffer & buffer, const AASequence & peptide, Int min_charge, Int max_charge) const;
+
     /// overwrite
     void updateMembers_() override;
 
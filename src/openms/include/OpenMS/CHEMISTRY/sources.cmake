@@ -8,6 +8,8 @@ AASequence.h
 CrossLinksDB.h
 Element.h
 ElementDB.h
+CompactAASequence.h
+CompactEmpiricalFormula.h
 EmpiricalFormula.h
 EnzymaticDigestionLogModel.h
 EnzymaticDigestion.h
@@ -22,6 +24,7 @@ ProteaseDB.h
 ProteaseDigestion.h
 Residue.h
 ResidueDB.h
+ResidueMassTable.h
 ResidueModification.h
 RNaseDB.h
 RNaseDigestion.h
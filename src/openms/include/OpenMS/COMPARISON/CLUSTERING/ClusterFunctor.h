@@ -37,6 +37,8 @@
 #include <OpenMS/DATASTRUCTURES/DistanceMatrix.h>
 #include <OpenMS/CONCEPT/Exception.h>
 #include <OpenMS/COMPARISON/CLUSTERING/ClusterAnalyzer.h>
+#include <OpenMS/CONCEPT/ProgressLogger.h>
+#include <OpenMS/DATASTRUCTURES/String.h>
 
 #include <vector>
 
@@ -99,6 +101,172 @@ public:
     /// registers all derived products
     static void registerChildren();
 
+protected:
+
+    /**
+        @brief agglomerative clustering with a Lance-Williams type update of the distances
+
+        Repeatedly merges the two closest clusters until the smallest distance reaches @p threshold (or only two clusters remain).
+        After merging clusters i and j, the distance of the new cluster to every other cluster k is set to
+        @p update(d(i,k), d(j,k), size of i, size of j), where i is the cluster with the larger index in the current set of clusters.
+        Ties are resolved in favour of the pair with the smallest (row, column) index.
+
+        Merged clusters are not removed from @p original_distance, they are only marked inactive and the first minimal distance of
+        every row is cached. So each step costs O(n) instead of the O(n^2) of a full minimum search and a matrix reduction,
+        unless the merge invalidates many of the cached row minima.
+
+        @param original_distance the distances of the elements, will be changed during clustering
+        @param cluster_tree will hold the resulting tree (see operator())
+        @param threshold distance from which on no more clusters are merged
+        @param update the Lance-Williams update for the distances to a merged cluster
+        @param logger reports the progress of the clustering
+
+        @throw ClusterFunctor::InsufficientInput if @p original_distance contains less than two elements
+    */
+    template <typename UpdateFunction>
+    static void clusterLanceWilliams_(DistanceMatrix<float> & original_distance, std::vector<BinaryTreeNode> & cluster_tree, const float threshold, UpdateFunction update, const ProgressLogger & logger)
+    {
+      // input MUST have >= 2 elements!
+      const Size n = original_distance.dimensionsize();
+      if (n < 2)
+      {
+        throw ClusterFunctor::InsufficientInput(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "Distance matrix to start from only contains one element");
+      }
+
+      cluster_tree.clear();
+      cluster_tree.reserve(n - 1);
+
+      // clusters are identified by their smallest element, which also is the index of their row/column (slot) in the matrix
+      std::vector<bool> active(n, true);
+      std::vector<Size> cluster_size(n, 1);
+      Size active_count(n);
+
+      // first minimal distance in each row (to the active clusters with a smaller index)
+      std::vector<float> row_min(n, 0);
+      std::vector<Size> row_min_col(n, 0);
+      for (Size r = 1; r < n; ++r)
+      {
+        updateRowMinimum_(original_distance, active, r, row_min[r], row_min_col[r]);
+      }
+
+      logger.startProgress(0, n, "clustering data");
+
+      std::pair<Size, Size> min = findMinimum_(active, row_min, row_min_col);
+      while (original_distance.getValue(min.first, min.second) < threshold)
+      {
+        //grow the tree
+        const Size a = min.second; // keeps the merged cluster
+        const Size b = min.first;
+        cluster_tree.push_back(BinaryTreeNode(a, b, original_distance.getValue(b, a)));
+
+        if (active_count <= 2)
+        {
+          break;
+        }
+
+        //update the distances of the merged cluster to all other clusters
+        for (Size k = 0; k < n; ++k)
+        {
+          if (k == a || k == b || !active[k])
+          {
+            continue;
+          }
+          float dik = original_distance.getValue(b, k);
+          float djk = original_distance.getValue(a, k);
+          original_distance.setValueQuick(a, k, update(dik, djk, cluster_size[b], cluster_size[a]));
+        }
+        cluster_size[a] += cluster_size[b];
+        active[b] = false;
+        --active_count;
+
+        //update the cached row minima
+        updateRowMinimum_(original_distance, active, a, row_min[a], row_min_col[a]);
+        for (Size r = a + 1; r < n; ++r)
+        {
+          if (!active[r])
+          {
+            continue;
+          }
+          if (row_min_col[r] == a || row_min_col[r] == b)
+          {
+            updateRowMinimum_(original_distance, active, r, row_min[r], row_min_col[r]);
+          }
+          else
+          {
+            const float v = original_distance.getValue(r, a);
+            if (v < row_min[r] || (v == row_min[r] && a < row_min_col[r]))
+            {
+              row_min[r] = v;
+              row_min_col[r] = a;
+            }
+          }
+        }
+
+        min = findMinimum_(active, row_min, row_min_col);
+        logger.setProgress(n - active_count);
+      }
+
+      //fill tree with dummy nodes
+      Size first_active(0);
+      while (!active[first_active])
+      {
+        ++first_active;
+      }
+      for (Size i = first_active + 1; i < n && cluster_tree.size() < n - 1; ++i)
+      {
+        if (active[i])
+        {
+          cluster_tree.push_back(BinaryTreeNode(first_active, i, -1.0));
+        }
+      }
+
+      logger.endProgress();
+    }
+
+private:
+
+    /// first minimal distance of row @p r to the active clusters with a smaller index (value of @p r itself if there is none)
+    static void updateRowMinimum_(const DistanceMatrix<float> & distance, const std::vector<bool> & active, Size r, float & value, Size & col)
+    {
+      bool found(false);
+      value = 0;
+      col = r;
+      for (Size c = 0; c < r; ++c)
+      {
+        if (!active[c])
+        {
+          continue;
+        }
+        const float v = distance.getValue(r, c);
+        if (!found || v < value)
+        {
+          value = v;
+          col = c;
+          found = true;
+        }
+      }
+    }
+
+    /// position (row, column) of the first minimal distance between two active clusters
+    static std::pair<Size, Size> findMinimum_(const std::vector<bool> & active, const std::vector<float> & row_min, const std::vector<Size> & row_min_col)
+    {
+      std::pair<Size, Size> min(0, 0);
+      bool found(false);
+      for (Size r = 1; r < active.size(); ++r)
+      {
+        if (!active[r] || row_min_col[r] == r)
+        {
+          continue;
+        }
+        if (!found || row_min[r] < row_min[min.first])
+        {
+          min = std::make_pair(r, row_min_col[r]);
+          found = true;
+        }
+      }
+      return min;
+    }
+
   };
 
 }
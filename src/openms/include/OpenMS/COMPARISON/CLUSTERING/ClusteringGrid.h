@@ -43,7 +43,6 @@
 
 #include <map>
 #include <vector>
-#include <list>
 
 namespace OpenMS
 {
@@ -113,7 +112,7 @@ class OPENMS_DLLAPI ClusteringGrid
     * @param cell_index    cell index (i,j) on the grid
     * @return list of cluster indices (from the list of clusters) which are centred in this cell
     */
-    std::list<int> getClusters(const CellIndex &cell_index) const;
+    const std::vector<int>& getClusters(const CellIndex &cell_index) const;
 
     /**
     * @brief returns grid cell index (i,j) for the positions (x,y)
@@ -157,7 +156,7 @@ class OPENMS_DLLAPI ClusteringGrid
     /**
     * @brief grid cell index mapped to a list of clusters in it
     */
-    std::map<CellIndex, std::list<int> > cells_;
+    std::map<CellIndex, std::vector<int> > cells_;
 
 };
 
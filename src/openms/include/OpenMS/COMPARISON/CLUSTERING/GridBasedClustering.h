@@ -43,13 +43,18 @@
 
 #include <cmath>
 #include <limits>
+#include <list>
 #include <map>
 #include <set>
 #include <queue>
 #include <vector>
 #include <algorithm>
 #include <iostream>
-#include <boost/unordered_map.hpp>
+#include <exception>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
 
 namespace OpenMS
 {
@@ -120,6 +125,12 @@ private:
   * Each data point can have two additional properties A and B.
   * In each cluster all properties A need to be the same,
   * all properties B different.
+  *
+  * Groups of points which are separated by at least one empty row or
+  * column of grid cells can never be merged with each other. The data is
+  * split into such independent regions, which are clustered in parallel
+  * (if OpenMP is enabled). The result does not depend on the number of
+  * threads.
   */
   template <typename Metric>
   class GridBasedClustering :
@@ -133,7 +144,6 @@ public:
     typedef GridBasedCluster::Rectangle Rectangle; // DBoundingBox<2>
     typedef ClusteringGrid::CellIndex CellIndex; // std::pair<int,int>
     typedef std::multiset<MinimumDistance>::const_iterator MultisetIterator;
-    typedef boost::unordered::unordered_multimap<int, MultisetIterator>::const_iterator NNIterator;
 
     /**
      * @brief initialises all data structures
@@ -152,7 +162,7 @@ public:
       metric_(metric),
       grid_(grid_spacing_x, grid_spacing_y)
     {
-      init_(data_x, data_y, properties_A, properties_B);
+      addPoints_(data_x, data_y, properties_A, properties_B);
     }
 
     /**
@@ -172,7 +182,7 @@ public:
       // set properties A and B to -1, i.e. ignore properties when clustering
       std::vector<int> properties_A(data_x.size(), -1);
       std::vector<int> properties_B(data_x.size(), -1);
-      init_(data_x, data_y, properties_A, properties_B);
+      addPoints_(data_x, data_y, properties_A, properties_B);
     }
 
     /**
@@ -184,108 +194,75 @@ public:
       // progress logger
       // NOTE: for some reason, gcc7 chokes if we remove the OpenMS::String
       // below, so lets just not change it.
-      Size clusters_start = clusters_.size();
+      Size clusters_start = data_x_.size();
       startProgress(0, clusters_start, OpenMS::String("clustering"));
 
-      MinimumDistance zero_distance(-1, -1, 0);
-
-      // combine clusters until all have been moved to the final list
-      while (clusters_.size() > 0)
+      // split the data into regions which can be clustered independently
+      std::vector<int> points(data_x_.size());
+      for (Size i = 0; i < points.size(); ++i)
       {
-        setProgress(clusters_start - clusters_.size());
-
-        MultisetIterator smallest_distance_it = distances_.lower_bound(zero_distance);
-
-        int cluster_index1 = smallest_distance_it->getClusterIndex();
-        int cluster_index2 = smallest_distance_it->getNearestNeighbourIndex();
-
-        eraseMinDistance_(smallest_distance_it);
-
-        // update cluster list
-        std::map<int, GridBasedCluster>::iterator cluster1_it = clusters_.find(cluster_index1);
-        std::map<int, GridBasedCluster>::iterator cluster2_it = clusters_.find(cluster_index2);
-        const GridBasedCluster& cluster1 = cluster1_it->second;
-        const GridBasedCluster& cluster2 = cluster2_it->second;
-        const std::vector<int>& points1 = cluster1.getPoints();
-        const std::vector<int>& points2 = cluster2.getPoints();
-        std::vector<int> new_points;
-        new_points.reserve(points1.size() + points2.size());
-        new_points.insert(new_points.end(), points1.begin(), points1.end());
-        new_points.insert(new_points.end(), points2.begin(), points2.end());
-
-        double new_x = (cluster1.getCentre().getX() * points1.size() + cluster2.getCentre().getX() * points2.size()) / (points1.size() + points2.size());
-        double new_y = (cluster1.getCentre().getY() * points1.size() + cluster2.getCentre().getY() * points2.size()) / (points1.size() + points2.size());
-
-        // update grid
-        CellIndex cell_for_cluster1 = grid_.getIndex(cluster1.getCentre());
-        CellIndex cell_for_cluster2 = grid_.getIndex(cluster2.getCentre());
-        CellIndex cell_for_new_cluster = grid_.getIndex(DPosition<2>(new_x, new_y));
-        grid_.removeCluster(cell_for_cluster1, cluster_index1);
-        grid_.removeCluster(cell_for_cluster2, cluster_index2);
-        grid_.addCluster(cell_for_new_cluster, cluster_index1);
-
-        // merge clusters
-        const Rectangle& box1 = cluster1.getBoundingBox();
-        const Rectangle& box2 = cluster2.getBoundingBox();
-        Rectangle new_box(box1);
-        new_box.enlarge(box2.minPosition());
-        new_box.enlarge(box2.maxPosition());
-
-        // Properties A of both clusters should by now be the same. The merge veto has been checked
-        // when a new entry to the minimum distance list was added, @see findNearestNeighbour_.
-        if (cluster1.getPropertyA() != cluster2.getPropertyA())
+        points[i] = i;
+      }
+      std::vector<std::vector<int> > regions;
+      partitionRegions_(points, true, false, regions);
+
+      // one worker (with its own grid and cluster lists) per thread
+      GridBasedClustering worker(metric_, grid_.getGridSpacingX(), grid_.getGridSpacingY());
+#ifdef _OPENMP
+      std::vector<GridBasedClustering> workers(std::min<SignedSize>(omp_get_max_threads(), std::max<SignedSize>(regions.size(), 1)), worker);
+#else
+      std::vector<GridBasedClustering> workers(1, worker);
+#endif
+
+      Size clusters_done(0);
+      Size err_count(0);
+      std::exception_ptr first_error;
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic, 1) num_threads(workers.size())
+#endif
+      for (SignedSize r = 0; r < (SignedSize)regions.size(); ++r)
+      {
+#ifdef _OPENMP
+        GridBasedClustering& w = workers[omp_get_thread_num()];
+#else
+        GridBasedClustering& w = workers[0];
+#endif
+        try
         {
-          throw Exception::InvalidValue(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "Property A of both clusters not the same. ", "A");
+          w.clusterRegion_(*this, regions[r]);
         }
-        int new_A = cluster1.getPropertyA();
-
-        const std::vector<int>& B1 = cluster1.getPropertiesB();
-        const std::vector<int>& B2 = cluster2.getPropertiesB();
-        std::vector<int> new_B;
-        new_B.reserve(B1.size() + B2.size());
-        new_B.insert(new_B.end(), B1.begin(), B1.end());
-        new_B.insert(new_B.end(), B2.begin(), B2.end());
-
-        GridBasedCluster new_cluster(DPosition<2>(new_x, new_y), new_box, new_points, new_A, new_B);
-
-        clusters_.erase(cluster1_it);
-        clusters_.erase(cluster2_it);
-        clusters_.insert(std::make_pair(cluster_index1, new_cluster));
-
-        std::set<int> clusters_to_be_updated;
-        clusters_to_be_updated.insert(cluster_index1);
-
-        // erase distance object of cluster with cluster_index2 without updating (does not exist anymore!)
-        // (the one with cluster_index1 has already been erased at the top of the while loop)
-        eraseMinDistance_(distance_it_for_cluster_idx_[cluster_index2]);
-
-        // find out which clusters need to be updated
-        std::pair<NNIterator, NNIterator> nn_range = reverse_nns_.equal_range(cluster_index1);
-        for (NNIterator nn_it = nn_range.first; nn_it != nn_range.second;)
+        catch (...)
         {
-          clusters_to_be_updated.insert(nn_it->second->getClusterIndex());
-          eraseMinDistance_((nn_it++)->second);
+#ifdef _OPENMP
+#pragma omp critical (GridBasedClustering_error)
+#endif
+          {
+            if (err_count++ == 0) first_error = std::current_exception();
+          }
         }
-        nn_range = reverse_nns_.equal_range(cluster_index2);
-        for (NNIterator nn_it = nn_range.first; nn_it != nn_range.second;)
+#ifdef _OPENMP
+#pragma omp critical (GridBasedClustering_progress)
+#endif
         {
-          clusters_to_be_updated.insert(nn_it->second->getClusterIndex());
-          eraseMinDistance_((nn_it++)->second);
+          clusters_done += regions[r].size();
+          setProgress(clusters_done);
         }
+      }
+      if (first_error) std::rethrow_exception(first_error);
 
-        // update clusters
-        for (std::set<int>::const_iterator cluster_index = clusters_to_be_updated.begin(); cluster_index != clusters_to_be_updated.end(); ++cluster_index)
-        {
-          std::map<int, GridBasedCluster>::iterator c_it = clusters_.find(*cluster_index);
-          const GridBasedCluster& c = c_it->second;
-          if (findNearestNeighbour_(c, *cluster_index))
-          {
-            grid_.removeCluster(grid_.getIndex(c.getCentre()), *cluster_index);          // remove from grid
-            clusters_.erase(c_it);          // remove from cluster list
-          }
-        }
+      // collect the final clusters (cluster indices are unique across regions)
+      for (Size i = 0; i < workers.size(); ++i)
+      {
+        clusters_final_.insert(workers[i].clusters_final_.begin(), workers[i].clusters_final_.end());
       }
 
+      // all points have been clustered
+      data_x_.clear();
+      data_y_.clear();
+      properties_A_.clear();
+      properties_B_.clear();
+      cell_indices_.clear();
+
       endProgress();
     }
 
@@ -319,13 +296,13 @@ public:
         CellIndex grid_index(cell, 1);
         if (grid_x_only.isNonEmptyCell(grid_index))
         {
-          std::list<int> cluster_indices = grid_x_only.getClusters(grid_index);          // indices of clusters in this x-range
+          std::vector<int> cluster_indices = grid_x_only.getClusters(grid_index);          // indices of clusters in this x-range
           if (cluster_indices.size() > 1)
           {
             // First, order the clusters in ascending y.
             std::list<GridBasedCluster> cluster_list;            // list to order clusters in y
             std::map<GridBasedCluster, int> index_list;           // allows us to keep track of cluster indices after sorting
-            for (std::list<int>::const_iterator it = cluster_indices.begin(); it != cluster_indices.end(); ++it)
+            for (std::vector<int>::const_iterator it = cluster_indices.begin(); it != cluster_indices.end(); ++it)
             {
               cluster_list.push_back(clusters_final_.find(*it)->second);
               index_list.insert(std::make_pair(clusters_final_.find(*it)->second, *it));
@@ -459,10 +436,31 @@ private:
     ClusteringGrid grid_;
 
     /**
-    * @brief list of clusters
-    * maps cluster indices to clusters
+    * @brief points to be clustered
+    * i.e. their coordinates, properties A and B and grid cells
+    */
+    std::vector<double> data_x_;
+    std::vector<double> data_y_;
+    std::vector<int> properties_A_;
+    std::vector<int> properties_B_;
+    std::vector<CellIndex> cell_indices_;
+
+    /**
+    * @brief point indices of the region currently clustered
+    * maps the (local) cluster indices used below to point indices
+    */
+    std::vector<int> region_points_;
+
+    /**
+    * @brief list of clusters in the current region
+    * indexed by local cluster index, only clusters registered on the grid are still in use
     */
-    std::map<int, GridBasedCluster> clusters_;
+    std::vector<GridBasedCluster> clusters_;
+
+    /**
+    * @brief number of clusters in the current region which are still in use
+    */
+    Size active_clusters_;
 
     /**
     * @brief list of final clusters
@@ -480,61 +478,255 @@ private:
      * @brief reverse nearest neighbor lookup table
      * for finding out which clusters need to be updated faster
      */
-    boost::unordered::unordered_multimap<int, std::multiset<MinimumDistance>::const_iterator> reverse_nns_;
+    std::vector<std::vector<MultisetIterator> > reverse_nns_;
 
     /**
      * @brief cluster index to distance iterator lookup table
      * for finding out which clusters need to be updated faster
      */
-    boost::unordered::unordered_map<int, std::multiset<MinimumDistance>::const_iterator> distance_it_for_cluster_idx_;
+    std::vector<MultisetIterator> distance_it_for_cluster_idx_;
 
     /**
-     * @brief initialises all data structures
+     * @brief constructor of an (empty) worker clustering a single region
+     */
+    GridBasedClustering(Metric metric, const std::vector<double>& grid_spacing_x, const std::vector<double>& grid_spacing_y) :
+      metric_(metric),
+      grid_(grid_spacing_x, grid_spacing_y),
+      active_clusters_(0)
+    {
+    }
+
+    /**
+     * @brief stores the points to be clustered
      *
      * @param data_x    x-coordinates of points to be clustered
      * @param data_y    y-coordinates of points to be clustered
      * @param properties_A    property A of points (same in each cluster)
      * @param properties_B    property B of points (different in each cluster)
+     *
+     * @throw Exception::IllegalArgument if a point lies outside the grid
+     */
+    void addPoints_(const std::vector<double>& data_x, const std::vector<double>& data_y,
+                    const std::vector<int>& properties_A, const std::vector<int>& properties_B)
+    {
+      active_clusters_ = 0;
+      data_x_ = data_x;
+      data_y_ = data_y;
+      properties_A_ = properties_A;
+      properties_B_ = properties_B;
+      cell_indices_.reserve(data_x.size());
+      for (Size i = 0; i < data_x.size(); ++i)
+      {
+        cell_indices_.push_back(grid_.getIndex(Point(data_x[i], data_y[i])));
+      }
+    }
+
+    /**
+     * @brief splits points into regions which can be clustered independently
+     *
+     * The centre of a cluster always lies within the cells spanned by its points,
+     * and nearest neighbours are searched in the adjacent cells only. Hence points
+     * separated by an empty column (or row) of cells never end up in the same cluster.
+     * The points are split alternately along x and y until no further split is possible.
+     *
+     * @param points    points (in ascending order) to be split
+     * @param along_x    split along x (or y) direction
+     * @param other_failed    Could the points not be split along the other direction?
+     * @param regions    regions, each a list of points in ascending order
+     */
+    void partitionRegions_(const std::vector<int>& points, bool along_x, bool other_failed, std::vector<std::vector<int> >& regions) const
+    {
+      if (points.empty())
+      {
+        return;
+      }
+
+      // order points by their row/column
+      std::vector<std::pair<int, int> > cell_and_point;
+      cell_and_point.reserve(points.size());
+      for (std::vector<int>::const_iterator it = points.begin(); it != points.end(); ++it)
+      {
+        cell_and_point.push_back(std::make_pair(along_x ? cell_indices_[*it].first : cell_indices_[*it].second, *it));
+      }
+      std::sort(cell_and_point.begin(), cell_and_point.end());
+
+      std::vector<std::vector<int> > groups(1);
+      for (Size i = 0; i < cell_and_point.size(); ++i)
+      {
+        if (i > 0 && cell_and_point[i].first > cell_and_point[i - 1].first + 1)
+        {
+          groups.push_back(std::vector<int>());
+        }
+        groups.back().push_back(cell_and_point[i].second);
+      }
+
+      if (groups.size() == 1)
+      {
+        if (other_failed)
+        {
+          regions.push_back(points);
+        }
+        else
+        {
+          partitionRegions_(points, !along_x, true, regions);
+        }
+        return;
+      }
+
+      for (Size g = 0; g < groups.size(); ++g)
+      {
+        std::sort(groups[g].begin(), groups[g].end());
+        partitionRegions_(groups[g], !along_x, false, regions);
+      }
+    }
+
+    /**
+     * @brief clusters the points of a single region
+     * (final clusters are added to the list of final clusters)
+     *
+     * @param parent    clustering holding the points
+     * @param points    points of the region (in ascending order)
+     */
+    void clusterRegion_(const GridBasedClustering& parent, const std::vector<int>& points)
+    {
+      init_(parent, points);
+
+      MinimumDistance zero_distance(-1, -1, 0);
+
+      // combine clusters until all have been moved to the final list
+      while (active_clusters_ > 0)
+      {
+        MultisetIterator smallest_distance_it = distances_.lower_bound(zero_distance);
+
+        int cluster_index1 = smallest_distance_it->getClusterIndex();
+        int cluster_index2 = smallest_distance_it->getNearestNeighbourIndex();
+
+        eraseMinDistance_(smallest_distance_it);
+
+        // update cluster list
+        const GridBasedCluster& cluster1 = clusters_[cluster_index1];
+        const GridBasedCluster& cluster2 = clusters_[cluster_index2];
+        const std::vector<int>& points1 = cluster1.getPoints();
+        const std::vector<int>& points2 = cluster2.getPoints();
+        std::vector<int> new_points;
+        new_points.reserve(points1.size() + points2.size());
+        new_points.insert(new_points.end(), points1.begin(), points1.end());
+        new_points.insert(new_points.end(), points2.begin(), points2.end());
+
+        double new_x = (cluster1.getCentre().getX() * points1.size() + cluster2.getCentre().getX() * points2.size()) / (points1.size() + points2.size());
+        double new_y = (cluster1.getCentre().getY() * points1.size() + cluster2.getCentre().getY() * points2.size()) / (points1.size() + points2.size());
+
+        // update grid
+        CellIndex cell_for_cluster1 = grid_.getIndex(cluster1.getCentre());
+        CellIndex cell_for_cluster2 = grid_.getIndex(cluster2.getCentre());
+        CellIndex cell_for_new_cluster = grid_.getIndex(DPosition<2>(new_x, new_y));
+        grid_.removeCluster(cell_for_cluster1, cluster_index1);
+        grid_.removeCluster(cell_for_cluster2, cluster_index2);
+        grid_.addCluster(cell_for_new_cluster, cluster_index1);
+
+        // merge clusters
+        const Rectangle& box1 = cluster1.getBoundingBox();
+        const Rectangle& box2 = cluster2.getBoundingBox();
+        Rectangle new_box(box1);
+        new_box.enlarge(box2.minPosition());
+        new_box.enlarge(box2.maxPosition());
+
+        // Properties A of both clusters should by now be the same. The merge veto has been checked
+        // when a new entry to the minimum distance list was added, @see findNearestNeighbour_.
+        if (cluster1.getPropertyA() != cluster2.getPropertyA())
+        {
+          throw Exception::InvalidValue(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "Property A of both clusters not the same. ", "A");
+        }
+        int new_A = cluster1.getPropertyA();
+
+        const std::vector<int>& B1 = cluster1.getPropertiesB();
+        const std::vector<int>& B2 = cluster2.getPropertiesB();
+        std::vector<int> new_B;
+        new_B.reserve(B1.size() + B2.size());
+        new_B.insert(new_B.end(), B1.begin(), B1.end());
+        new_B.insert(new_B.end(), B2.begin(), B2.end());
+
+        clusters_[cluster_index1] = GridBasedCluster(DPosition<2>(new_x, new_y), new_box, new_points, new_A, new_B);
+        --active_clusters_;
+
+        std::set<int> clusters_to_be_updated;
+        clusters_to_be_updated.insert(cluster_index1);
+
+        // erase distance object of cluster with cluster_index2 without updating (does not exist anymore!)
+        // (the one with cluster_index1 has already been erased at the top of the while loop)
+        eraseMinDistance_(distance_it_for_cluster_idx_[cluster_index2]);
+
+        // find out which clusters need to be updated
+        while (!reverse_nns_[cluster_index1].empty())
+        {
+          clusters_to_be_updated.insert(reverse_nns_[cluster_index1].back()->getClusterIndex());
+          eraseMinDistance_(reverse_nns_[cluster_index1].back());
+        }
+        while (!reverse_nns_[cluster_index2].empty())
+        {
+          clusters_to_be_updated.insert(reverse_nns_[cluster_index2].back()->getClusterIndex());
+          eraseMinDistance_(reverse_nns_[cluster_index2].back());
+        }
+
+        // update clusters
+        for (std::set<int>::const_iterator cluster_index = clusters_to_be_updated.begin(); cluster_index != clusters_to_be_updated.end(); ++cluster_index)
+        {
+          const GridBasedCluster& c = clusters_[*cluster_index];
+          if (findNearestNeighbour_(c, *cluster_index))
+          {
+            grid_.removeCluster(grid_.getIndex(c.getCentre()), *cluster_index);          // remove from grid
+            --active_clusters_;          // remove from cluster list
+          }
+        }
+      }
+    }
+
+    /**
+     * @brief initialises all data structures for clustering a region
+     *
+     * @param parent    clustering holding the points
+     * @param points    points of the region (in ascending order)
      */
-    void init_(const std::vector<double>& data_x, const std::vector<double>& data_y,
-               const std::vector<int>& properties_A, const std::vector<int>& properties_B)
+    void init_(const GridBasedClustering& parent, const std::vector<int>& points)
     {
+      region_points_ = points;
+      clusters_.clear();
+      clusters_.reserve(points.size());
+      distances_.clear();
+      reverse_nns_.assign(points.size(), std::vector<MultisetIterator>());
+      distance_it_for_cluster_idx_.assign(points.size(), distances_.end());
+
       // fill the grid with points to be clustered (initially each cluster contains a single point)
-      for (unsigned i = 0; i < data_x.size(); ++i)
+      for (Size l = 0; l < points.size(); ++l)
       {
-        Point position(data_x[i], data_y[i]);
+        int i = points[l];
+        Point position(parent.data_x_[i], parent.data_y_[i]);
         Rectangle box(position, position);
 
         std::vector<int> pi;        // point indices
         pi.push_back(i);
         std::vector<int> pb;        // properties B
-        pb.push_back(properties_B[i]);
+        pb.push_back(parent.properties_B_[i]);
 
         // add to cluster list
-        GridBasedCluster cluster(position, box, pi, properties_A[i], pb);
-        clusters_.insert(std::make_pair(i, cluster));
+        clusters_.push_back(GridBasedCluster(position, box, pi, parent.properties_A_[i], pb));
 
         // register on grid
-        grid_.addCluster(grid_.getIndex(position), i);
+        grid_.addCluster(parent.cell_indices_[i], l);
       }
+      active_clusters_ = clusters_.size();
 
       // fill list of minimum distances
-      std::map<int, GridBasedCluster>::iterator iterator = clusters_.begin();
-      while (iterator != clusters_.end())
+      for (Size l = 0; l < clusters_.size(); ++l)
       {
-        int cluster_index = iterator->first;
-        const GridBasedCluster& cluster = iterator->second;
+        const GridBasedCluster& cluster = clusters_[l];
 
-        if (findNearestNeighbour_(cluster, cluster_index))
+        if (findNearestNeighbour_(cluster, l))
         {
           // remove from grid
-          grid_.removeCluster(grid_.getIndex(cluster.getCentre()), cluster_index);
+          grid_.removeCluster(grid_.getIndex(cluster.getCentre()), l);
           // remove from cluster list
-          clusters_.erase(iterator++);
-        }
-        else
-        {
-          ++iterator;
+          --active_clusters_;
         }
       }
     }
@@ -615,12 +807,12 @@ private:
           cell_index2.second += j;
           if (grid_.isNonEmptyCell(cell_index2))
           {
-            const std::list<int>& cluster_indices = grid_.getClusters(cell_index2);
-            for (std::list<int>::const_iterator cluster_index2 = cluster_indices.begin(); cluster_index2 != cluster_indices.end(); ++cluster_index2)
+            const std::vector<int>& cluster_indices = grid_.getClusters(cell_index2);
+            for (std::vector<int>::const_iterator cluster_index2 = cluster_indices.begin(); cluster_index2 != cluster_indices.end(); ++cluster_index2)
             {
               if (*cluster_index2 != cluster_index)
               {
-                const GridBasedCluster& cluster2 = clusters_.find(*cluster_index2)->second;
+                const GridBasedCluster& cluster2 = clusters_[*cluster_index2];
                 const Point& centre2 = cluster2.getCentre();
                 double distance = metric_(centre, centre2);
 
@@ -642,14 +834,14 @@ private:
       if (nearest_neighbour == -1)
       {
         // no other cluster nearby, hence move the cluster to the final results
-        clusters_final_.insert(std::make_pair(cluster_index, clusters_.find(cluster_index)->second));
+        clusters_final_.insert(std::make_pair(region_points_[cluster_index], clusters_[cluster_index]));
         return true;
       }
 
       // add to the list of minimal distances
       std::multiset<MinimumDistance>::const_iterator it = distances_.insert(MinimumDistance(cluster_index, nearest_neighbour, min_dist));
       // add to reverse nearest neighbor lookup table
-      reverse_nns_.insert(std::make_pair(nearest_neighbour, it));
+      reverse_nns_[nearest_neighbour].push_back(it);
       // add to cluster index -> distance lookup table
       distance_it_for_cluster_idx_[cluster_index] = it;
 
@@ -668,18 +860,20 @@ private:
     void eraseMinDistance_(const std::multiset<MinimumDistance>::const_iterator it)
     {
       // remove corresponding entries from nearest neighbor lookup table
-      std::pair<NNIterator, NNIterator> nn_range = reverse_nns_.equal_range(it->getNearestNeighbourIndex());
-      for (NNIterator nn_it = nn_range.first; nn_it != nn_range.second; ++nn_it)
+      // (searched from the back, where the entries usually are removed from)
+      std::vector<MultisetIterator>& nns = reverse_nns_[it->getNearestNeighbourIndex()];
+      for (Size i = nns.size(); i > 0; --i)
       {
-        if (nn_it->second == it)
+        if (nns[i - 1] == it)
         {
-          reverse_nns_.erase(nn_it);
+          nns[i - 1] = nns.back();
+          nns.pop_back();
           break;
         }
       }
 
       // remove corresponding entry from cluster index -> distance lookup table
-      distance_it_for_cluster_idx_.erase(it->getClusterIndex());
+      distance_it_for_cluster_idx_[it->getClusterIndex()] = distances_.end();
 
       // remove from distances_
       distances_.erase(it);
@@ -83,6 +83,33 @@ public:
     /// function call operator, calculates self similarity
     double operator()(const BinnedSpectrum& spec) const override;
 
+    /// a match of a query spectrum: index of the library spectrum and score
+    typedef std::pair<Size, double> Match;
+
+    /**
+      @brief Scores every query against every library spectrum and reports the best matches
+
+      Equivalent to calling operator()(query, library[j]) for all pairs, but
+      the library is first transposed into a compact bin-major (CSC) index, so
+      each query only visits the library spectra that share at least one bin
+      with it. Queries are processed in parallel if OpenMP is enabled. For an
+      all-vs-all comparison pass the same vector twice (self matches are then
+      reported as well).
+
+      Spectra without any intensity are never matched. Scores are accumulated
+      in double precision and may therefore differ from operator() in the
+      last digits.
+
+      @param queries  binned query spectra
+      @param library  binned library spectra
+      @param matches  output, one entry per query with its matches sorted by decreasing score (ties by library index)
+      @param top_k  maximum number of matches per query (0 = report all matches)
+      @param min_score  only report matches with a score of at least this value (matches always share a bin, i.e. score > 0)
+
+      @throw Exception::IllegalArgument if the spectra are not binned compatibly
+    */
+    void computeTopMatches(const std::vector<BinnedSpectrum>& queries, const std::vector<BinnedSpectrum>& library, std::vector<std::vector<Match> >& matches, Size top_k = 0, double min_score = 0.0) const;
+
     ///
     static BinnedSpectrumCompareFunctor* create() { return new BinnedSpectralContrastAngle(); }
 
@@ -40,6 +40,7 @@
 #include <map>
 #include <utility>
 #include <algorithm>
+#include <cmath>
 
 #define ALIGNMENT_DEBUG
 #undef  ALIGNMENT_DEBUG
@@ -52,10 +53,10 @@ namespace OpenMS
       Method 1: Using a banded (width via 'tolerance' parameter) alignment if absolute tolerances are given.
                 Scoring function is the m/z distance between peaks. Intensity does not play a role!
 
-      Method 2: If relative tolerance (ppm) is specified a simple matching of peaks is performed:
+      Method 2: If relative tolerance (ppm) is specified or 'matching_method' is set to 'nearest_peak' a simple matching of peaks is performed:
       Peaks from s1 (usually the theoretical spectrum) are assigned to the closest peak in s2 if it lies in the tolerance window
-      @note: a peak in s2 can be matched to none, one or multiple peaks in s1. Peaks in s1 may be matched to none or one peak in s2.
-      @note: intensity is ignored TODO: improve time complexity, currently O(|s1|*log(|s2|))
+      @note: a peak in s2 can be matched to none, one or multiple peaks in s1 (to none or one if 'one_to_one' is set). Peaks in s1 may be matched to none or one peak in s2.
+      @note: intensity is ignored. Both spectra are traversed once, so the matching is O(|s1|+|s2|) (see getNearestPeakMatches).
 
       @htmlinclude OpenMS_SpectrumAlignment.parameters
 
@@ -82,6 +83,79 @@ public:
     SpectrumAlignment & operator=(const SpectrumAlignment & source);
     // @}
 
+    /**
+      @brief Matches each peak of @p s1 to the closest peak of @p s2 within the tolerance
+
+      Both spectra have to be sorted by m/z, they are traversed simultaneously
+      (two pointers), so the runtime is O(|s1|+|s2|). The closest peak is
+      chosen as by MSSpectrum::findNearest (the peak with the lower m/z wins
+      ties). An absolute tolerance includes the borders of the window, a
+      relative (ppm) tolerance excludes them.
+
+      If @p one_to_one is set, each peak of @p s2 is matched to at most one
+      peak of @p s1: if two peaks of @p s1 share the closest peak of @p s2,
+      only the closer one is kept (first one on ties), the other one stays
+      unmatched.
+
+      @param alignment output, pairs of peak indices (s1, s2) sorted by s1 index. Cleared first; its capacity is kept so it can be reused for many calls.
+      @param s1 first spectrum (usually the theoretical spectrum)
+      @param s2 second spectrum
+      @param tolerance the tolerance in Da or ppm
+      @param is_relative_tolerance is @p tolerance given in ppm?
+      @param one_to_one match each peak of @p s2 at most once?
+    */
+    template <typename SpectrumType1, typename SpectrumType2>
+    static void getNearestPeakMatches(std::vector<std::pair<Size, Size> > & alignment, const SpectrumType1 & s1, const SpectrumType2 & s2, double tolerance, bool is_relative_tolerance, bool one_to_one = false)
+    {
+      alignment.clear();
+      if (s2.empty())
+      {
+        return;
+      }
+
+      // distance of the last match, only needed for the one-to-one constraint
+      double last_dist(0);
+      // first peak of s2 with m/z >= current peak of s1
+      Size j(0);
+      for (Size i = 0; i != s1.size(); ++i)
+      {
+        const double mz = s1[i].getMZ();
+        while (j < s2.size() && s2[j].getMZ() < mz)
+        {
+          ++j;
+        }
+
+        Size nearest = j;
+        if (j == s2.size())
+        {
+          nearest = j - 1;
+        }
+        else if (j != 0 && !(std::fabs(s2[j].getMZ() - mz) < std::fabs(s2[j - 1].getMZ() - mz)))
+        {
+          nearest = j - 1;
+        }
+
+        const double dist = std::fabs(mz - s2[nearest].getMZ());
+        const bool in_tolerance = is_relative_tolerance ? (dist < mz * tolerance * 1e-6) : (dist <= tolerance);
+        if (!in_tolerance)
+        {
+          continue;
+        }
+
+        if (one_to_one && !alignment.empty() && alignment.back().second == nearest)
+        {
+          if (dist < last_dist)
+          {
+            alignment.back().first = i;
+            last_dist = dist;
+          }
+          continue;
+        }
+        alignment.push_back(std::make_pair(i, nearest));
+        last_dist = dist;
+      }
+    }
+
     template <typename SpectrumType1, typename SpectrumType2>
     void getSpectrumAlignment(std::vector<std::pair<Size, Size> > & alignment, const SpectrumType1 & s1, const SpectrumType2 & s2) const
     {
@@ -92,9 +166,9 @@ public:
 
       // clear result
       alignment.clear();
-      double tolerance = (double)param_.getValue("tolerance");
+      const double tolerance = tolerance_;
 
-      if (!param_.getValue("is_relative_tolerance").toBool() )
+      if (!is_relative_tolerance_ && !nearest_peak_)
       {
         std::map<Size, std::map<Size, std::pair<Size, Size> > > traceback;
         std::map<Size, std::map<Size, double> > matrix;
@@ -304,24 +378,27 @@ public:
     #endif
     #endif
     }
-    else  // relative alignment (ppm tolerance)
-    {        
-      for (Size i = 0; i != s1.size(); ++i)
-      {
-        const double& theo_mz = s1[i].getMZ();
-        double max_dist_dalton = theo_mz * tolerance * 1e-6;
- 
-        // iterate over peaks in experimental spectrum in given fragment tolerance around theoretical peak
-        Size j = s2.findNearest(theo_mz);
-        double exp_mz = s2[j].getMZ();
-
-        // found peak match
-        if (std::abs(theo_mz - exp_mz) < max_dist_dalton)
-        {
-          alignment.push_back(std::make_pair(i, j));
-        }
-      }
+    else  // nearest peak matching (always used for ppm tolerance)
+    {
+      getNearestPeakMatches(alignment, s1, s2, tolerance, is_relative_tolerance_, one_to_one_);
     }
   }
+
+protected:
+
+    // docu in base class
+    void updateMembers_() override;
+
+    /// tolerance in Da or ppm
+    double tolerance_;
+
+    /// is the tolerance given in ppm?
+    bool is_relative_tolerance_;
+
+    /// use nearest peak matching for absolute tolerances
+    bool nearest_peak_;
+
+    /// match each peak of the second spectrum at most once (nearest peak matching only)
+    bool one_to_one_;
  };
 }
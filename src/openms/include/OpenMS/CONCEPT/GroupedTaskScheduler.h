@@ -0,0 +1,168 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2018.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: Hannes Roest $
+// $Authors: Hannes Roest $
+// --------------------------------------------------------------------------
+
+#pragma once
+
+#include <OpenMS/CONCEPT/Types.h>
+
+#include <condition_variable>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+namespace OpenMS
+{
+
+  /**
+    @brief Processes groups of tasks on all available threads
+
+    Each group consists of a setup step, a number of independent tasks that
+    depend on the setup and a finish step (e.g. load a data set, process parts
+    of it independently, release it). All tasks of all groups are processed in
+    a single, dynamically scheduled OpenMP loop: a thread that is done with
+    its task picks up the next one, independent of the group it belongs to.
+    Uneven group sizes therefore do not leave threads idle as long as there
+    is work left anywhere, which is not the case when splitting threads
+    between an outer loop over groups and nested inner loops.
+
+    Tasks are handed out in order of the groups. The first thread that picks
+    up a task of a group runs the setup of this group; other threads picking
+    up tasks of the same group wait until it is done. The thread that
+    completes the last task of a group runs its finish step. Groups without
+    tasks are skipped completely.
+
+    The number of groups that are set up but not yet finished at any time
+    can be limited (e.g. to bound memory usage), a thread that would need to
+    set up an additional group waits until another group is finished.
+
+    @note Setup, task and finish functions are called concurrently for
+    different groups and tasks and need to be thread-safe in that respect.
+  */
+  class GroupedTaskScheduler
+  {
+public:
+    /**
+      @brief Constructor
+
+      @param max_open_groups Maximal number of groups that are set up at the
+      same time (zero or negative values mean no limit)
+    */
+    explicit GroupedTaskScheduler(int max_open_groups = -1) :
+      max_open_groups_(max_open_groups)
+    {
+    }
+
+    /**
+      @brief Runs all tasks of all groups
+
+      @param tasks_per_group Number of tasks for each group
+      @param setup Called as setup(group) before any task of the group
+      @param task Called as task(group, task_index) for each task
+      @param finish Called as finish(group) after all tasks of the group are done
+    */
+    template <typename SetupFunction, typename TaskFunction, typename FinishFunction>
+    void run(const std::vector<Size>& tasks_per_group, SetupFunction setup, TaskFunction task, FinishFunction finish)
+    {
+      // flatten all (group, task) pairs into a single list
+      std::vector<std::pair<Size, Size> > tasks;
+      for (Size g = 0; g < tasks_per_group.size(); ++g)
+      {
+        for (Size t = 0; t < tasks_per_group[g]; ++t)
+        {
+          tasks.push_back(std::make_pair(g, t));
+        }
+      }
+
+      std::vector<GroupState_> state(tasks_per_group.size(), PENDING);
+      std::vector<Size> remaining(tasks_per_group);
+      Size open_groups = 0;
+      std::mutex mutex;
+      std::condition_variable changed;
+
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic, 1)
+#endif
+      for (SignedSize i = 0; i < (SignedSize)tasks.size(); ++i)
+      {
+        const Size group = tasks[i].first;
+
+        // make sure the group is set up (either by us or by another thread)
+        bool do_setup = false;
+        {
+          std::unique_lock<std::mutex> lock(mutex);
+          while (state[group] == SETTING_UP ||
+                 (state[group] == PENDING && max_open_groups_ > 0 && open_groups >= (Size)max_open_groups_))
+          {
+            changed.wait(lock);
+          }
+          if (state[group] == PENDING)
+          {
+            state[group] = SETTING_UP;
+            ++open_groups;
+            do_setup = true;
+          }
+        }
+        if (do_setup)
+        {
+          setup(group);
+          std::lock_guard<std::mutex> lock(mutex);
+          state[group] = READY;
+          changed.notify_all();
+        }
+
+        task(group, tasks[i].second);
+
+        bool do_finish = false;
+        {
+          std::lock_guard<std::mutex> lock(mutex);
+          do_finish = (--remaining[group] == 0);
+        }
+        if (do_finish)
+        {
+          finish(group);
+          std::lock_guard<std::mutex> lock(mutex);
+          state[group] = FINISHED;
+          --open_groups;
+          changed.notify_all();
+        }
+      }
+    }
+
+protected:
+    enum GroupState_ {PENDING, SETTING_UP, READY, FINISHED};
+
+    int max_open_groups_;
+  };
+
+}
@@ -43,6 +43,7 @@
 #include <vector>
 #include <ctime>
 #include <map>
+#include <memory>
 
 namespace OpenMS
 {
@@ -87,6 +88,16 @@ namespace OpenMS
       It also contains a list of streams that are associated with
       the LogStream object. This list contains pointers to the
       streams and their minimum and maximum log level.
+
+      Text written to the buffer is collected per thread until it is
+      synced, i.e. threads writing to the same LogStream concurrently do not
+      garble each other's lines and only take a lock once per sync (flush
+      or endl) to hand over their complete lines.
+
+      In asynchronous mode (see setAsynchronous()), the complete lines are
+      only queued when syncing and a background thread does the caching and
+      writes them to the associated streams, so logging threads never wait
+      for slow output streams.
       Each line entered in the LogStream is marked with its
       time (in fact, the time LogStreamBuf::sync was called) and its
       loglevel. The loglevel is determined by either the current
@@ -149,6 +160,26 @@ public:
         prevent a buffer overflow.
       */
       int overflow(int c = -1) override;
+
+      /**
+        Appends @p n characters to the text collected for the current
+        thread (which is distributed on the next sync).
+      */
+      std::streamsize xsputn(const char* s, std::streamsize n) override;
+      //@}
+
+      /// @name Asynchronous distribution
+      //@{
+      /**
+        @brief Enables or disables distributing the logged lines from a background thread
+
+        When disabled, all lines queued so far are distributed before this
+        method returns. Must not be called while other threads are logging.
+      */
+      void setAsynchronous(bool async);
+
+      /// Are lines distributed by a background thread?
+      bool isAsynchronous() const;
       //@}
 
 
@@ -205,10 +236,26 @@ protected:
       /// Interpret the prefix format string and return the expanded prefix.
       std::string expandPrefix_(const std::string & prefix, time_t time) const;
 
-      char * pbuf_;
+      /// Text written by the current thread that was not synced yet (nullptr if there is none and @p create is false)
+      std::string* threadText_(bool create);
+
+      /// Removes all complete lines from @p text and appends them to @p lines
+      static void extractLines_(std::string& text, std::vector<std::string>& lines);
+
+      /// Caches and distributes complete lines (the caller has to hold the lock)
+      void processLines_(const std::vector<std::string>& lines);
+
+      /// Main loop of the background thread in asynchronous mode
+      void runAsync_();
+
+      /// Unique id of this buffer (keys the per-thread text)
+      const Size id_;
       std::string             level_;
       std::list<StreamStruct> stream_list_;
-      std::string             incomplete_line_;
+
+      /// State of the background thread in asynchronous mode (nullptr in synchronous mode)
+      struct AsyncState;
+      std::unique_ptr<AsyncState> async_;
 
       /// @name Caching
       //@{
@@ -249,7 +296,7 @@ protected:
       /// Returns the next free index for a log message
       Size getNextLogCounter_();
 
-      /// Non-lock acquiring sync function called in the d'tor
+      /// Non-lock acquiring sync function called in the d'tor (handles the text of the current thread only)
       int syncLF_();
       //@}
     };
@@ -418,6 +465,9 @@ public:
       /// Set prefix of all output streams, details see setPrefix method with ostream
       void setPrefix(const std::string & prefix);
 
+      /// Enables or disables distributing the logged lines from a background thread (see LogStreamBuf::setAsynchronous)
+      void setAsynchronous(bool async);
+
       ///
       void flush();
       //@}
@@ -36,6 +36,8 @@
 
 #include <OpenMS/CONCEPT/Types.h>
 
+#include <atomic>
+#include <ctime>
 #include <map>
 
 namespace OpenMS
@@ -49,6 +51,11 @@ namespace OpenMS
 
     Use startProgress, setProgress and endProgress for the actual logging.
 
+    setProgress and nextProgress may be called concurrently from several
+    threads (e.g. inside of parallel loops) without any synchronization.
+    They are lock-free: nextProgress increments an atomic counter and at most
+    one call per second (the first one to claim the update) updates the display.
+
     @note All methods are const, so it can be used through a const reference or in const methods as well!
   */
   class OPENMS_DLLAPI ProgressLogger
@@ -111,18 +118,21 @@ public:
     */
     void startProgress(SignedSize begin, SignedSize end, const String& label) const;
 
-    /// Sets the current progress
+    /// Sets the current progress (thread-safe)
     void setProgress(SignedSize value) const;
 
     /// Ends the progress display
     void endProgress() const;
 
-    /// increment progress by 1 (according to range begin-end)
+    /// increment progress by 1 (according to range begin-end; thread-safe)
     void nextProgress() const;
 
 protected:
+    /// Returns true for at most one caller per second (the one updating the display)
+    bool claimUpdate_() const;
+
     mutable LogType type_;
-    mutable time_t last_invoke_;
+    mutable std::atomic<time_t> last_invoke_;
     static int recursion_depth_;
 
     /// Return the name of the factory product used for this log type
@@ -54,6 +54,14 @@ namespace OpenMS
     The class is implemented as a singleton.
     The random generator is implemented using boost::random.
 
+    Outside of parallel regions, all ids are drawn from a single generator,
+    i.e. the same seed always yields the same sequence of ids. Inside of
+    (active) OpenMP parallel regions, every thread draws from its own
+    generator without any locking. These per-thread generators are seeded
+    from the global seed and the OpenMP thread number, so the ids drawn by a
+    thread are reproducible as long as the work is distributed among the
+    threads in the same way (e.g. with a static schedule).
+
     @ingroup Concept
   */
   class OPENMS_DLLAPI UniqueIdGenerator
@@ -79,7 +79,7 @@ public:
     }
 
     /// Copy constructor - copies the unique id
-    UniqueIdInterface(const UniqueIdInterface & rhs) :
+    UniqueIdInterface(const UniqueIdInterface & rhs) noexcept :
       unique_id_(rhs.unique_id_)
     {
     }
@@ -9,6 +9,7 @@ Exception.h
 Factory.h
 FactoryBase.h
 FuzzyStringComparator.h
+GroupedTaskScheduler.h
 GlobalExceptionHandler.h
 Helpers.h
 LogConfigHandler.h
@@ -0,0 +1,112 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2018.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: Hannes Roest $
+// $Authors: Hannes Roest $
+// --------------------------------------------------------------------------
+
+#pragma once
+
+#include <OpenMS/CONCEPT/Types.h>
+#include <OpenMS/DATASTRUCTURES/DBoundingBox.h>
+
+#include <vector>
+
+namespace OpenMS
+{
+
+  /**
+    @brief Spatial index for point queries on a fixed set of 2D bounding boxes
+
+    The boxes are hashed into a regular grid (in compressed row storage):
+    every box is stored in all cells it overlaps. query() then only needs to
+    check the boxes of a single cell instead of all boxes. Unless given
+    explicitly, the cell sizes are chosen from the median box extents, so that
+    a typical box covers only a few cells; the total number of cells is
+    limited to a small multiple of the number of boxes.
+
+    The index is not modified by queries, so query() can be called from
+    several threads at the same time.
+
+    @ingroup Datastructures
+  */
+  class OPENMS_DLLAPI BoundingBoxGrid
+  {
+public:
+    /// Default constructor (empty index)
+    BoundingBoxGrid();
+
+    /**
+      @brief Builds the index for a set of boxes (replacing the current content)
+
+      @param boxes The boxes, they are referred to by their index in this vector
+      @param cell_size_x Cell size in the first dimension (automatic if not positive)
+      @param cell_size_y Cell size in the second dimension (automatic if not positive)
+    */
+    void build(const std::vector<DBoundingBox<2> >& boxes, double cell_size_x = 0.0, double cell_size_y = 0.0);
+
+    /**
+      @brief Finds all boxes that enclose a position
+
+      @param position The query position
+      @param result Output: indices of the enclosing boxes (in ascending order)
+    */
+    void query(const DPosition<2>& position, std::vector<Size>& result) const;
+
+    /// Returns the number of indexed boxes
+    Size size() const;
+
+    /// Returns the indexed box with index @p index
+    const DBoundingBox<2>& getBox(Size index) const;
+
+protected:
+    /// returns the grid cell of a coordinate (clamped to the grid)
+    Size cell_(double value, double min, double cell_size, Size cells) const;
+
+    /// the indexed boxes
+    std::vector<DBoundingBox<2> > boxes_;
+
+    /// bounding box of all boxes
+    DBoundingBox<2> extent_;
+
+    /// cell sizes
+    double cell_size_x_, cell_size_y_;
+
+    /// number of cells in each dimension
+    Size cells_x_, cells_y_;
+
+    /// start of the box indices of each cell in @p entries_ (one additional element at the end)
+    std::vector<Size> cell_begin_;
+
+    /// box indices of all cells
+    std::vector<Size> entries_;
+  };
+
+} // namespace OpenMS
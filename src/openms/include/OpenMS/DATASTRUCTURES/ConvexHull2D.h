@@ -82,9 +82,18 @@ public:
     /// default constructor
     ConvexHull2D();
 
+    /// copy constructor
+    ConvexHull2D(const ConvexHull2D&) = default;
+
+    /// move constructor
+    ConvexHull2D(ConvexHull2D&&) = default;
+
     /// assignment operator
     ConvexHull2D& operator=(const ConvexHull2D& rhs);
 
+    /// move assignment operator
+    ConvexHull2D& operator=(ConvexHull2D&&) = default;
+
     /// equality operator
     bool operator==(const ConvexHull2D& rhs) const;
 
@@ -133,6 +142,22 @@ public:
     void expandToBoundingBox();
 
 
+    /**
+      @brief Reduces the hull to its compact representation
+
+      The hull is compressed (see compress()) and only the outer hull points are
+      kept, in a vector of exactly the required size. The internal per-scan
+      structure is released, thus encloses() is not supported afterwards (as
+      for hulls loaded from featureXML). The shape of the hull does not change.
+
+      @param bounding_box_only Keep only the four corners of the bounding box
+      (see expandToBoundingBox())
+    **/
+    void compact(bool bounding_box_only = false);
+
+    /// returns if the hull is stored in its compact representation, i.e. without the internal per-scan structure (see compact())
+    bool isCompact() const;
+
     /**
               @brief returns if the @p point lies in the feature hull
 
@@ -102,7 +102,7 @@ public:
     }
 
     /// Copy constructor
-    DPosition(const DPosition& pos)
+    DPosition(const DPosition& pos) noexcept
     {
       std::copy(&(pos.coordinate_[0]), &(pos.coordinate_[D]),
                 &(coordinate_[0]));
@@ -43,6 +43,8 @@
 #include <cmath>
 #include <iomanip>
 #include <iostream>
+#include <new>
+#include <vector>
 
 namespace OpenMS
 {
@@ -80,10 +82,9 @@ public:
     //@}
 
     /** @brief default constructor
-
     */
     DistanceMatrix() :
-      matrix_(nullptr), init_size_(0), dimensionsize_(0), min_element_(0, 0)
+      matrix_(), init_size_(0), dimensionsize_(0), min_element_(0, 0)
     {
     }
 
@@ -95,36 +96,11 @@ public:
       @throw Exception::OutOfMemory if requested dimensionsize is to big to fit into memory
     */
     DistanceMatrix(SizeType dimensionsize, Value value = Value()) :
-      matrix_(new ValueType*[dimensionsize]), init_size_(dimensionsize), dimensionsize_(dimensionsize), min_element_(0, 0)
+      matrix_(), init_size_(0), dimensionsize_(0), min_element_(0, 0)
     {
-      matrix_[0] = NULL;
-      SizeType i = 1;
-      for (i = 1; i < dimensionsize; ++i)
-      {
-        matrix_[i] = new ValueType[i];
-        if (matrix_[i] == NULL)
-        {
-          SizeType j = i;
-          for (i = 1; i < j; i++)
-          {
-            delete[] matrix_[i];
-          }
-          delete[] matrix_;
-          matrix_ = NULL;
-          dimensionsize_ = 0;
-          init_size_ = 0;
-          throw Exception::OutOfMemory(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, (UInt)((((dimensionsize - 2) * (dimensionsize - 1)) / 2) * sizeof(ValueType)));
-        }
-      }
-      if (matrix_ != NULL)
+      allocate_(dimensionsize, value);
+      if (dimensionsize_ > 1)
       {
-        for (i = 1; i < dimensionsize; ++i)
-        {
-          for (SizeType j = 0; j < i; ++j)
-          {
-            matrix_[i][j] = value;
-          }
-        }
         min_element_ = std::make_pair(1, 0);
       }
     }
@@ -136,48 +112,24 @@ public:
       @throw Exception::OutOfMemory if requested dimensionsize is to big to fit into memory
     */
     DistanceMatrix(const DistanceMatrix& source) :
-      matrix_(new ValueType*[source.dimensionsize_]),
-      init_size_(source.dimensionsize_),
-      dimensionsize_(source.dimensionsize_),
-      min_element_(source.min_element_)
+      matrix_(), init_size_(0), dimensionsize_(0), min_element_(source.min_element_)
     {
-      matrix_[0] = NULL;
-      SizeType i = 1;
-      for (i = 1; i < dimensionsize_; ++i)
+      try
       {
-        matrix_[i] = new ValueType[i];
-        if (matrix_[i] == NULL)
-        {
-          SizeType j = i;
-          for (i = 1; i < j; i++)
-          {
-            delete[] matrix_[i];
-          }
-          delete[] matrix_;
-          matrix_ = NULL;
-          dimensionsize_ = 0;
-          init_size_ = 0;
-          min_element_ = std::make_pair(0, 0);
-          throw Exception::OutOfMemory(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, (UInt)((((dimensionsize_ - 2) * (dimensionsize_ - 1)) / 2) * sizeof(ValueType)));
-        }
+        matrix_.assign(source.matrix_.begin(), source.matrix_.begin() + elementCount_(source.dimensionsize_));
       }
-      if (matrix_ != NULL)
+      catch (std::bad_alloc&)
       {
-        for (i = 1; i < dimensionsize_; ++i)
-        {
-          std::copy(source.matrix_[i], source.matrix_[i] + i, matrix_[i]);
-        }
+        min_element_ = std::make_pair(0, 0);
+        throw Exception::OutOfMemory(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, (UInt)(elementCount_(source.dimensionsize_) * sizeof(ValueType)));
       }
+      init_size_ = source.dimensionsize_;
+      dimensionsize_ = source.dimensionsize_;
     }
 
     /// destructor
     ~DistanceMatrix()
     {
-      for (SizeType i = 1; i < init_size_; i++)
-      {
-        delete[] matrix_[i];
-      }
-      delete[] matrix_;
     }
 
     /**
@@ -224,7 +176,7 @@ public:
       {
         std::swap(i, j);
       }
-      return (const ValueType)(matrix_[i][j]);
+      return (const ValueType)(matrix_[index_(i, j)]);
     }
 
     /**
@@ -249,7 +201,7 @@ public:
       {
         std::swap(i, j);
       }
-      return matrix_[i][j];
+      return matrix_[index_(i, j)];
     }
 
     /**
@@ -273,23 +225,24 @@ public:
         {
           std::swap(i, j);
         }
+        const ValueType current_min = matrix_[index_(min_element_.first, min_element_.second)];
         if (i != min_element_.first && j != min_element_.second)
         {
-          matrix_[i][j] = value;
-          if (value < matrix_[min_element_.first][min_element_.second]) // keep min_element_ up-to-date
+          matrix_[index_(i, j)] = value;
+          if (value < current_min) // keep min_element_ up-to-date
           {
             min_element_ = std::make_pair(i, j);
           }
         }
         else
         {
-          if (value <= matrix_[min_element_.first][min_element_.second])
+          if (value <= current_min)
           {
-            matrix_[i][j] = value;
+            matrix_[index_(i, j)] = value;
           }
           else
           {
-            matrix_[i][j] = value;
+            matrix_[index_(i, j)] = value;
             updateMinElement();
           }
         }
@@ -319,19 +272,14 @@ public:
         {
           std::swap(i, j);
         }
-        matrix_[i][j] = value;
+        matrix_[index_(i, j)] = value;
       }
     }
 
     /// reset all
     void clear()
     {
-      for (SizeType i = 1; i < init_size_; i++)
-      {
-        delete[] matrix_[i];
-      }
-      delete[] matrix_;
-      matrix_ = nullptr;
+      std::vector<ValueType>().swap(matrix_);
       min_element_ = std::make_pair(0, 0);
       dimensionsize_ = 0;
       init_size_ = 0;
@@ -348,40 +296,10 @@ public:
     */
     void resize(SizeType dimensionsize, Value value = Value())
     {
-      for (SizeType j = 1; j < init_size_; j++)
-      {
-        delete[] matrix_[j];
-      }
-      delete[] matrix_;
-      dimensionsize_ = dimensionsize;
-      init_size_ = dimensionsize;
       min_element_ = std::make_pair(0, 0);
-      matrix_ = new ValueType*[dimensionsize_];
-      for (SizeType j = 1; j < dimensionsize_; ++j)
-      {
-        matrix_[j] = new ValueType[j];
-        if (matrix_[j] == nullptr)
-        {
-          for (SizeType k = 1; k < j; ++k)
-          {
-            delete[] matrix_[k];
-          }
-          delete[] matrix_;
-          matrix_ = nullptr;
-          dimensionsize_ = 0;
-          init_size_ = 0;
-          throw Exception::OutOfMemory(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, (UInt)((((dimensionsize_ - 2) * (dimensionsize_ - 1)) / 2) * sizeof(Value)));
-        }
-      }
-      if (matrix_ != nullptr)
+      allocate_(dimensionsize, value);
+      if (dimensionsize_ > 1)
       {
-        for (SizeType j = 0; j < dimensionsize; ++j)
-        {
-          for (SizeType k = 0; k < j; ++k)
-          {
-            matrix_[j][k] = value;
-          }
-        }
         min_element_ = std::make_pair(1, 0);
       }
     }
@@ -400,18 +318,18 @@ public:
       {
         throw Exception::OutOfRange(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION);
       }
-      //delete row j and therefor overwrite with row j+1 and iterate like this to last row
-      SizeType i = j + 1;
-      while (i < dimensionsize_ && matrix_[i] != nullptr)
+      // move the rows behind row j one row up, leaving out their jth element
+      // (rows are stored one after another, so the target is always in front
+      // of the source and the data can be moved in place)
+      typename std::vector<ValueType>::iterator target = matrix_.begin() + index_(j, 0);
+      for (SizeType i = j + 1; i < dimensionsize_; ++i)
       {
-        //left out in the copy is each rows jth element, pointer working here as iterators just fine
-        std::copy(matrix_[i] + j + 1, matrix_[i] + i, std::copy(matrix_[i], matrix_[i] + j, matrix_[i - 1]));
-        ++i;
+        typename std::vector<ValueType>::iterator row = matrix_.begin() + index_(i, 0);
+        target = std::copy(row, row + j, target);
+        target = std::copy(row + j + 1, row + i, target);
       }
-      //last row is freed and the pointer set to NULL (outer array's size is not changed)
-      delete[] matrix_[i - 1];
-      matrix_[i - 1] = nullptr;
       --dimensionsize_;
+      matrix_.resize(elementCount_(dimensionsize_));
     }
 
     /// gives the number of rows (i.e. number of columns)
@@ -423,6 +341,10 @@ public:
     /**
       @brief keep track of the actual minimum element after altering the matrix
 
+      All elements are stored in one contiguous block row after row, so this is
+      a linear search for the first minimal element (the one with the smallest
+      row index and, within the row, the smallest column index).
+
       @throw Exception::OutOfRange thrown if there is no element to access
     */
     void updateMinElement()
@@ -433,17 +355,14 @@ public:
       {
         throw Exception::OutOfRange(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION);
       }
-      if (dimensionsize_ != 1) //else matrix has one element: (1,0)
+      if (dimensionsize_ > 2) //else matrix has one element: (1,0)
       {
-        ValueType* row_min_;
-        for (SizeType r = 2; r < dimensionsize_ && matrix_[r] != nullptr; ++r)
-        {
-          row_min_ = std::min_element(matrix_[r], matrix_[r] + r);
-          if (*row_min_ < matrix_[min_element_.first][min_element_.second])
-          {
-            min_element_ = std::make_pair(r, row_min_ - matrix_[r]);
-          }
-        }
+        const SizeType pos = findMinElement_(&matrix_[0], elementCount_(dimensionsize_));
+        // row r holds the elements index_(r, 0) to index_(r, 0) + r - 1
+        SizeType r = (SizeType)((1.0 + std::sqrt(1.0 + 8.0 * (double)pos)) / 2.0);
+        while (r > 1 && index_(r, 0) > pos) --r;
+        while (index_(r + 1, 0) <= pos) ++r;
+        min_element_ = std::make_pair(r, pos - index_(r, 0));
       }
     }
 
@@ -455,17 +374,7 @@ public:
     bool operator==(DistanceMatrix<ValueType> const& rhs) const
     {
       OPENMS_PRECONDITION(dimensionsize_ == rhs.dimensionsize_, "DistanceMatrices have different sizes.");
-      for (Size i = 1; i < rhs.dimensionsize(); ++i)
-      {
-        for (Size j = 0; j < i; ++j)
-        {
-          if (matrix_[i][j] != rhs.matrix_[i][j])
-          {
-            return false;
-          }
-        }
-      }
-      return true;
+      return std::equal(matrix_.begin(), matrix_.begin() + elementCount_(rhs.dimensionsize()), rhs.matrix_.begin());
     }
 
     /**
@@ -483,27 +392,92 @@ public:
     }
 
 protected:
-    /// sparse element not to be included in base container
-    ValueType** matrix_;
-    /// number of actually stored rows
-    SizeType init_size_; // actual size of outer array
+    /// elements below the main diagonal, stored row after row (element (i, j), i > j, at index_(i, j))
+    std::vector<ValueType> matrix_;
+    /// number of rows the matrix was last allocated with
+    SizeType init_size_;
     /// number of accessibly stored rows (i.e. number of columns)
     SizeType dimensionsize_; //number of virtual elements: ((dimensionsize-1)*(dimensionsize))/2
     /// index of minimal element(i.e. number in underlying SparseVector)
     std::pair<SizeType, SizeType> min_element_;
 
+    /// position of element (i, j) with i > j in matrix_
+    static SizeType index_(SizeType i, SizeType j)
+    {
+      return (i * (i - 1)) / 2 + j;
+    }
+
+    /// number of stored elements of a matrix with @p dimensionsize rows
+    static SizeType elementCount_(SizeType dimensionsize)
+    {
+      return dimensionsize < 2 ? 0 : (dimensionsize * (dimensionsize - 1)) / 2;
+    }
+
+    /// (re)allocates the storage for @p dimensionsize rows and fills it with @p value
+    void allocate_(SizeType dimensionsize, Value value)
+    {
+      try
+      {
+        matrix_.assign(elementCount_(dimensionsize), value);
+      }
+      catch (std::bad_alloc&)
+      {
+        std::vector<ValueType>().swap(matrix_);
+        dimensionsize_ = 0;
+        init_size_ = 0;
+        throw Exception::OutOfMemory(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, (UInt)(elementCount_(dimensionsize) * sizeof(ValueType)));
+      }
+      dimensionsize_ = dimensionsize;
+      init_size_ = dimensionsize;
+    }
+
+    /**
+      @brief Position of the first minimal element of @p n (> 0) contiguous values
+
+      The minimum is determined with several independent partial minima (so
+      the compiler can vectorize the loop), then its first occurrence is
+      located. If the first value is not comparable (NaN), it is returned, as
+      no value compares less than it.
+    */
+    static SizeType findMinElement_(const ValueType* values, SizeType n)
+    {
+      if (!(values[0] == values[0]))
+      {
+        return 0;
+      }
+      const SizeType lanes = 8;
+      ValueType partial_min[lanes];
+      std::fill(partial_min, partial_min + lanes, values[0]);
+      SizeType i = 0;
+      for (; i + lanes <= n; i += lanes)
+      {
+        for (SizeType k = 0; k < lanes; ++k)
+        {
+          partial_min[k] = values[i + k] < partial_min[k] ? values[i + k] : partial_min[k];
+        }
+      }
+      ValueType min_value = partial_min[0];
+      for (SizeType k = 1; k < lanes; ++k)
+      {
+        min_value = partial_min[k] < min_value ? partial_min[k] : min_value;
+      }
+      for (; i < n; ++i)
+      {
+        min_value = values[i] < min_value ? values[i] : min_value;
+      }
+      return std::find(values, values + n, min_value) - values;
+    }
+
 private:
-    /// assignment operator (unsafe)
+    /// assignment operator
     DistanceMatrix& operator=(const DistanceMatrix& rhs)
     {
       matrix_ = rhs.matrix_;
       init_size_ = rhs.init_size_;
       dimensionsize_ = rhs.dimensionsize_;
       min_element_ = rhs.min_element_;
-
       return *this;
     }
-
   }; // class DistanceMatrix
 
   /**
@@ -77,7 +77,7 @@ public:
         preprocessing_tech(2), enable_feas_pump_heuristic(true), enable_gmi_cuts(true),
         enable_mir_cuts(true), enable_cov_cuts(true), enable_clq_cuts(true), mip_gap(0.0),
         time_limit((std::numeric_limits<Int>::max)()), output_freq(5000), output_delay(10000), enable_presolve(true),
-        enable_binarization(true)
+        enable_binarization(true), enable_warm_start(false)
       {
       }
 
@@ -96,6 +96,8 @@ public:
       Int output_delay;
       bool enable_presolve;
       bool enable_binarization; // only with presolve
+      /// (GLPK only) solve the LP relaxation with the simplex method, starting from the basis of the previous solve (if still valid), instead of presolving from scratch; speeds up re-solving a slightly modified problem
+      bool enable_warm_start;
     };
 
     enum Type
@@ -180,6 +182,21 @@ public:
     */
     Int addColumn(std::vector<Int>& column_indices, std::vector<double>& column_values, const String& name, double lower_bound, double upper_bound, Type type);
 
+    /**
+      @brief Adds several rows with boundaries to the LP matrix at once, returns index of the first new row
+
+      The matrix entries are given in compressed sparse row (CSR) format: the
+      entries of the i-th new row are @p column_indices and @p values at
+      positions @p row_starts[i] to @p row_starts[i + 1] - 1. Thus @p row_starts
+      has one more element than there are new rows, all other per-row vectors
+      (@p names, @p lower_bounds, @p upper_bounds, @p types) one element per row.
+
+      @throw Exception::IllegalArgument if the sizes of the vectors do not match
+    */
+    Int addRows(const std::vector<Int>& row_starts, const std::vector<Int>& column_indices, const std::vector<double>& values,
+                const std::vector<String>& names, const std::vector<double>& lower_bounds, const std::vector<double>& upper_bounds,
+                const std::vector<Type>& types);
+
     /// delete index-th row
     void deleteRow(Int index);
     /// sets name of the index-th column
@@ -0,0 +1,412 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2018.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: Timo Sachsenberg$
+// $Authors: Timo Sachsenberg $
+// --------------------------------------------------------------------------
+
+#pragma once
+
+#include <OpenMS/CONCEPT/Types.h>
+#include <OpenMS/DATASTRUCTURES/DPosition.h>
+
+#include <algorithm>
+#include <queue>
+#include <utility>
+#include <vector>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+namespace OpenMS
+{
+  /**
+    @brief Static k-d tree on points in @p D dimensions, stored implicitly in a flat array
+
+    KDTree::KDTree is a node based container which is filled by inserting
+    points one at a time. For large, fixed sets of points (e.g. all features
+    of many maps) this tree is built in one go instead: the points are
+    recursively partitioned at the median of one dimension (cycling through
+    the dimensions with the depth), and the median of a range is stored in
+    its middle, with its left and right sub-trees before and after it. No
+    nodes or pointers are needed, the coordinates and point indices are
+    contiguous in memory, and the sub-trees are built in parallel if OpenMP
+    is enabled.
+
+    Points are identified by their index in the vector the tree was built
+    from. Batch queries are answered in parallel, the results do not depend
+    on the number of threads.
+
+    @ingroup Datastructures
+  */
+  template <UInt D, typename CoordinateType = double>
+  class StaticKDTree
+  {
+public:
+    /// Position of a point
+    typedef DPosition<D, CoordinateType> PositionType;
+    /// Range (lower and upper corner, both inclusive) for range queries
+    typedef std::pair<PositionType, PositionType> RangeType;
+
+    /// Default constructor (empty tree)
+    StaticKDTree() :
+      nodes_()
+    {
+    }
+
+    /// Constructor building the tree on @p points
+    explicit StaticKDTree(const std::vector<PositionType>& points) :
+      nodes_()
+    {
+      build(points);
+    }
+
+    /// (Re-)builds the tree on @p points
+    void build(const std::vector<PositionType>& points)
+    {
+      nodes_.resize(points.size());
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
+      for (SignedSize i = 0; i < (SignedSize)points.size(); ++i)
+      {
+        for (UInt d = 0; d < D; ++d)
+        {
+          nodes_[i].coordinate[d] = points[i][d];
+        }
+        nodes_[i].index = i;
+      }
+
+      // partition the top levels until there are enough independent sub-trees, ...
+      std::vector<std::pair<Size, Size> > ranges(1, std::make_pair(Size(0), nodes_.size()));
+      UInt depth = 0;
+#ifdef _OPENMP
+      const Size min_subtrees = 4 * omp_get_max_threads();
+#else
+      const Size min_subtrees = 1;
+#endif
+      while (!ranges.empty() && ranges.size() < min_subtrees)
+      {
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
+        for (SignedSize r = 0; r < (SignedSize)ranges.size(); ++r)
+        {
+          partition_(ranges[r].first, ranges[r].second, depth);
+        }
+        std::vector<std::pair<Size, Size> > children;
+        for (Size r = 0; r < ranges.size(); ++r)
+        {
+          const Size mid = middle_(ranges[r].first, ranges[r].second);
+          if (mid > ranges[r].first + 1) children.push_back(std::make_pair(ranges[r].first, mid));
+          if (ranges[r].second > mid + 2) children.push_back(std::make_pair(mid + 1, ranges[r].second));
+        }
+        ranges.swap(children);
+        ++depth;
+      }
+
+      // ... and build those in parallel
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic, 1)
+#endif
+      for (SignedSize r = 0; r < (SignedSize)ranges.size(); ++r)
+      {
+        build_(ranges[r].first, ranges[r].second, depth);
+      }
+    }
+
+    /// Number of points in the tree
+    Size size() const
+    {
+      return nodes_.size();
+    }
+
+    /// Is the tree empty?
+    bool empty() const
+    {
+      return nodes_.empty();
+    }
+
+    /// Removes all points
+    void clear()
+    {
+      nodes_.clear();
+    }
+
+    /**
+      @brief Finds all points within a range
+
+      @param low lower corner of the range
+      @param high upper corner of the range
+      @param result_indices indices (ascending) of all points p with @p low <= p <= @p high in all dimensions
+    */
+    void queryRange(const PositionType& low, const PositionType& high, std::vector<Size>& result_indices) const
+    {
+      result_indices.clear();
+      std::vector<Frame_> stack;
+      if (!nodes_.empty())
+      {
+        stack.push_back(Frame_(0, nodes_.size(), 0, 0));
+      }
+      while (!stack.empty())
+      {
+        const Frame_ f = stack.back();
+        stack.pop_back();
+        if (f.end - f.begin <= leaf_size_)
+        {
+          for (Size i = f.begin; i < f.end; ++i)
+          {
+            if (inRange_(nodes_[i], low, high)) result_indices.push_back(nodes_[i].index);
+          }
+          continue;
+        }
+        const Size mid = middle_(f.begin, f.end);
+        const Node_& node = nodes_[mid];
+        const UInt dim = f.depth % D;
+        if (inRange_(node, low, high)) result_indices.push_back(node.index);
+        if (low[dim] <= node.coordinate[dim]) stack.push_back(Frame_(f.begin, mid, f.depth + 1, 0));
+        if (node.coordinate[dim] <= high[dim]) stack.push_back(Frame_(mid + 1, f.end, f.depth + 1, 0));
+      }
+      std::sort(result_indices.begin(), result_indices.end());
+    }
+
+    /**
+      @brief Finds all points within each of several ranges (in parallel)
+
+      @param ranges the ranges
+      @param result_indices for each range, the result of queryRange()
+    */
+    void queryRanges(const std::vector<RangeType>& ranges, std::vector<std::vector<Size> >& result_indices) const
+    {
+      result_indices.resize(ranges.size());
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic, 64)
+#endif
+      for (SignedSize i = 0; i < (SignedSize)ranges.size(); ++i)
+      {
+        queryRange(ranges[i].first, ranges[i].second, result_indices[i]);
+      }
+    }
+
+    /**
+      @brief Finds the @p k nearest points (Euclidean distance) to a position
+
+      @param position the query position
+      @param k number of neighbours
+      @param result_indices indices of the (at most @p k) nearest points, ordered by distance (ties by index)
+      @param squared_distances if not null, filled with the squared distances of these points
+    */
+    void nearestNeighbours(const PositionType& position, Size k, std::vector<Size>& result_indices, std::vector<CoordinateType>* squared_distances = nullptr) const
+    {
+      result_indices.clear();
+      if (squared_distances) squared_distances->clear();
+      if (k == 0 || nodes_.empty())
+      {
+        return;
+      }
+
+      // max-heap of the best candidates found so far
+      typedef std::pair<CoordinateType, Size> Candidate;
+      std::priority_queue<Candidate> best;
+      std::vector<Frame_> stack;
+      stack.push_back(Frame_(0, nodes_.size(), 0, 0));
+      while (!stack.empty())
+      {
+        const Frame_ f = stack.back();
+        stack.pop_back();
+        // sub-tree cannot contain a better point
+        if (best.size() == k && f.bound > best.top().first) continue;
+
+        if (f.end - f.begin <= leaf_size_)
+        {
+          for (Size i = f.begin; i < f.end; ++i)
+          {
+            offer_(best, k, Candidate(squaredDistance_(nodes_[i], position), nodes_[i].index));
+          }
+          continue;
+        }
+        const Size mid = middle_(f.begin, f.end);
+        const Node_& node = nodes_[mid];
+        const UInt dim = f.depth % D;
+        offer_(best, k, Candidate(squaredDistance_(node, position), node.index));
+
+        // visit the side of the splitting plane containing the position first
+        const CoordinateType diff = position[dim] - node.coordinate[dim];
+        const Frame_ left(f.begin, mid, f.depth + 1, diff < 0 ? f.bound : std::max(f.bound, diff * diff));
+        const Frame_ right(mid + 1, f.end, f.depth + 1, diff < 0 ? std::max(f.bound, diff * diff) : f.bound);
+        if (diff < 0)
+        {
+          stack.push_back(right);
+          stack.push_back(left);
+        }
+        else
+        {
+          stack.push_back(left);
+          stack.push_back(right);
+        }
+      }
+
+      result_indices.resize(best.size());
+      if (squared_distances) squared_distances->resize(best.size());
+      for (Size i = best.size(); i > 0; --i)
+      {
+        result_indices[i - 1] = best.top().second;
+        if (squared_distances) (*squared_distances)[i - 1] = best.top().first;
+        best.pop();
+      }
+    }
+
+    /**
+      @brief Finds the @p k nearest points for each of several positions (in parallel)
+
+      @param positions the query positions
+      @param k number of neighbours
+      @param result_indices for each position, the result of nearestNeighbours()
+    */
+    void nearestNeighbours(const std::vector<PositionType>& positions, Size k, std::vector<std::vector<Size> >& result_indices) const
+    {
+      result_indices.resize(positions.size());
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic, 64)
+#endif
+      for (SignedSize i = 0; i < (SignedSize)positions.size(); ++i)
+      {
+        nearestNeighbours(positions[i], k, result_indices[i]);
+      }
+    }
+
+protected:
+    /// Point stored in the tree
+    struct Node_
+    {
+      CoordinateType coordinate[D];
+      Size index;
+    };
+
+    /// Orders points by one coordinate (ties by index)
+    struct CompareDimension_
+    {
+      explicit CompareDimension_(UInt dim) :
+        dim_(dim)
+      {
+      }
+
+      bool operator()(const Node_& a, const Node_& b) const
+      {
+        return a.coordinate[dim_] < b.coordinate[dim_] || (a.coordinate[dim_] == b.coordinate[dim_] && a.index < b.index);
+      }
+
+      UInt dim_;
+    };
+
+    /// Sub-tree to be visited during a query
+    struct Frame_
+    {
+      Frame_(Size b, Size e, UInt d, CoordinateType lower_bound) :
+        begin(b), end(e), depth(d), bound(lower_bound)
+      {
+      }
+
+      Size begin;
+      Size end;
+      UInt depth;
+      /// lower bound of the squared distance of the sub-tree to the query position
+      CoordinateType bound;
+    };
+
+    /// Sub-trees of at most this many points are searched linearly
+    static const Size leaf_size_ = 8;
+
+    /// Position of the root of the sub-tree [@p begin, @p end)
+    static Size middle_(Size begin, Size end)
+    {
+      return begin + (end - begin) / 2;
+    }
+
+    /// Moves the median of [@p begin, @p end) to its middle (splitting dimension according to @p depth)
+    void partition_(Size begin, Size end, UInt depth)
+    {
+      if (end - begin <= 1) return;
+      std::nth_element(nodes_.begin() + begin, nodes_.begin() + middle_(begin, end), nodes_.begin() + end, CompareDimension_(depth % D));
+    }
+
+    /// Builds the sub-tree [@p begin, @p end)
+    void build_(Size begin, Size end, UInt depth)
+    {
+      while (end - begin > leaf_size_)
+      {
+        partition_(begin, end, depth);
+        const Size mid = middle_(begin, end);
+        build_(begin, mid, depth + 1);
+        begin = mid + 1;
+        ++depth;
+      }
+    }
+
+    static bool inRange_(const Node_& node, const PositionType& low, const PositionType& high)
+    {
+      for (UInt d = 0; d < D; ++d)
+      {
+        if (node.coordinate[d] < low[d] || high[d] < node.coordinate[d]) return false;
+      }
+      return true;
+    }
+
+    static CoordinateType squaredDistance_(const Node_& node, const PositionType& position)
+    {
+      CoordinateType sum = 0;
+      for (UInt d = 0; d < D; ++d)
+      {
+        const CoordinateType diff = node.coordinate[d] - position[d];
+        sum += diff * diff;
+      }
+      return sum;
+    }
+
+    template <typename Candidate>
+    static void offer_(std::priority_queue<Candidate>& best, Size k, const Candidate& candidate)
+    {
+      if (best.size() < k)
+      {
+        best.push(candidate);
+      }
+      else if (candidate < best.top())
+      {
+        best.pop();
+        best.push(candidate);
+      }
+    }
+
+    /// Points in tree order
+    std::vector<Node_> nodes_;
+  };
+
+} // namespace OpenMS
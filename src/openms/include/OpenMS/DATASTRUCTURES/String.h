@@ -504,6 +504,11 @@ public:
     {
     }
 
+    // create view on a character range (e.g. in a memory-mapped file)
+    StringView(const char* begin, Size size) : begin_(begin), size_(size)
+    {
+    }
+
     /// less operator
     bool operator<(const StringView other) const
     {
@@ -548,6 +553,69 @@ public:
       return String(begin_, begin_ + size_);
     }
 
+    /// pointer to the first character of the view (not null-terminated!)
+    inline const char* data() const
+    {
+      return begin_;
+    }
+
+    /// iterator to the first character
+    inline const char* begin() const
+    {
+      return begin_;
+    }
+
+    /// iterator past the last character
+    inline const char* end() const
+    {
+      return begin_ + size_;
+    }
+
+    /// true if the view is empty
+    inline bool empty() const
+    {
+      return size_ == 0;
+    }
+
+    /// access to the character at position @p i (unchecked)
+    inline char operator[](Size i) const
+    {
+      return begin_[i];
+    }
+
+    /// equality operator (compares the characters, not the addresses)
+    bool operator==(const StringView other) const
+    {
+      return size_ == other.size_ && std::equal(begin_, begin_ + size_, other.begin_);
+    }
+
+    /// inequality operator
+    bool operator!=(const StringView other) const
+    {
+      return !(*this == other);
+    }
+
+    /// returns a view without leading and trailing whitespaces (see String::trim())
+    StringView trim() const;
+
+    /**
+      @brief Splits the view into sub-views at every occurrence of @p splitter
+
+      Same semantics as String::split(const char, std::vector<String>&, bool)
+      without quote protection, but no characters are copied. The sub-views
+      are only valid as long as the viewed string exists.
+    */
+    bool split(const char splitter, std::vector<StringView>& substrings) const;
+
+    /// Conversion to Int without copying the characters (see String::toInt())
+    Int toInt() const;
+
+    /// Conversion to float without copying the characters (see String::toFloat())
+    float toFloat() const;
+
+    /// Conversion to double without copying the characters (see String::toDouble())
+    double toDouble() const;
+
     private:
       const char* begin_;
       Size size_;
@@ -673,57 +673,75 @@ public:
     }
 
     static Int toInt(const String & this_s)
+    {
+      return toInt(this_s.data(), this_s.data() + this_s.size());
+    }
+
+    /// Converts the character range [@p begin, @p end) to an integer without copying it (see String::toInt())
+    static Int toInt(const char* begin, const char* end)
     {
       Int ret;
 
       // boost::spirit::qi was found to be vastly superior to boost::lexical_cast or stringstream extraction (especially for VisualStudio),
       // so don't change this unless you have benchmarks for all platforms!
-      String::ConstIterator it = this_s.begin();
-      if (!boost::spirit::qi::phrase_parse(it, this_s.end(), boost::spirit::qi::int_, boost::spirit::ascii::space, ret))
+      const char* it = begin;
+      if (!boost::spirit::qi::phrase_parse(it, end, boost::spirit::qi::int_, boost::spirit::ascii::space, ret))
       {
-        throw Exception::ConversionError(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, String("Could not convert string '") + this_s + "' to an integer value");
+        throw Exception::ConversionError(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, String("Could not convert string '") + String(begin, end) + "' to an integer value");
       }
       // was the string parsed (white spaces are skipped automatically!) completely? If not, we have a problem because a previous split might have used the wrong split char
-      if (it != this_s.end())
+      if (it != end)
       {
-        throw Exception::ConversionError(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, String("Prefix of string '") + this_s + "' successfully converted to an integer value. Additional characters found at position " + (int)(distance(this_s.begin(), it) + 1));
+        throw Exception::ConversionError(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, String("Prefix of string '") + String(begin, end) + "' successfully converted to an integer value. Additional characters found at position " + (int)(it - begin + 1));
       }
       return ret;
     }
 
     static float toFloat(const String& this_s)
+    {
+      return toFloat(this_s.data(), this_s.data() + this_s.size());
+    }
+
+    /// Converts the character range [@p begin, @p end) to a float without copying it (see String::toFloat())
+    static float toFloat(const char* begin, const char* end)
     {
       float ret;
 
       // boost::spirit::qi was found to be vastly superior to boost::lexical_cast or stringstream extraction (especially for VisualStudio),
       // so don't change this unless you have benchmarks for all platforms!
-      String::ConstIterator it = this_s.begin();
-      if (!boost::spirit::qi::phrase_parse(it, this_s.end(), parse_float_, boost::spirit::ascii::space, ret))
+      const char* it = begin;
+      if (!boost::spirit::qi::phrase_parse(it, end, parse_float_, boost::spirit::ascii::space, ret))
       {
-        throw Exception::ConversionError(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, String("Could not convert string '") + this_s + "' to a float value");
+        throw Exception::ConversionError(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, String("Could not convert string '") + String(begin, end) + "' to a float value");
       }
       // was the string parsed (white spaces are skipped automatically!) completely? If not, we have a problem because a previous split might have used the wrong split char
-      if (it != this_s.end())
+      if (it != end)
       {
-        throw Exception::ConversionError(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, String("Prefix of string '") + this_s + "' successfully converted to a float value. Additional characters found at position " + (int)(distance(this_s.begin(), it) + 1));
+        throw Exception::ConversionError(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, String("Prefix of string '") + String(begin, end) + "' successfully converted to a float value. Additional characters found at position " + (int)(it - begin + 1));
       }
       return ret;
     }
 
     static double toDouble(const String& this_s)
+    {
+      return toDouble(this_s.data(), this_s.data() + this_s.size());
+    }
+
+    /// Converts the character range [@p begin, @p end) to a double without copying it (see String::toDouble())
+    static double toDouble(const char* begin, const char* end)
     {
       double ret;
       // boost::spirit::qi was found to be vastly superior to boost::lexical_cast or stringstream extraction (especially for VisualStudio),
       // so don't change this unless you have benchmarks for all platforms!
-      String::ConstIterator it = this_s.begin();
-      if (!boost::spirit::qi::phrase_parse(it, this_s.end(), parse_double_, boost::spirit::ascii::space, ret))
+      const char* it = begin;
+      if (!boost::spirit::qi::phrase_parse(it, end, parse_double_, boost::spirit::ascii::space, ret))
       {
-        throw Exception::ConversionError(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, String("Could not convert string '") + this_s + "' to a double value");
+        throw Exception::ConversionError(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, String("Could not convert string '") + String(begin, end) + "' to a double value");
       }
       // was the string parsed (white spaces are skipped automatically!) completely? If not, we have a problem because a previous split might have used the wrong split char
-      if (it != this_s.end())
+      if (it != end)
       {
-        throw Exception::ConversionError(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, String("Prefix of string '") + this_s + "' successfully converted to a double value. Additional characters found at position " + (int)(distance(this_s.begin(), it) + 1));
+        throw Exception::ConversionError(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, String("Prefix of string '") + String(begin, end) + "' successfully converted to a double value. Additional characters found at position " + (int)(it - begin + 1));
       }
       return ret;
     }
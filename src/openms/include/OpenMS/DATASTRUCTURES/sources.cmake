@@ -5,6 +5,7 @@ set(directory include/OpenMS/DATASTRUCTURES)
 set(sources_list_h
 Adduct.h
 BinaryTreeNode.h
+BoundingBoxGrid.h
 CalibrationData.h
 ChargePair.h
 Compomer.h
@@ -36,6 +37,7 @@ Matrix.h
 Param.h
 QTCluster.h
 SeqanIncludeWrapper.h
+StaticKDTree.h
 String.h
 StringUtils.h
 StringListUtils.h
@@ -43,6 +43,8 @@
 
 #include <algorithm>
 #include <iterator>
+#include <limits>
+#include <vector>
 
 namespace OpenMS
 {
@@ -199,71 +201,13 @@ public:
     template <typename InputIterator, typename OutputIterator>
     void filterRange(InputIterator input_begin, InputIterator input_end, OutputIterator output_begin)
     {
-      // the buffer is static only to avoid reallocation
-      static std::vector<typename InputIterator::value_type> buffer;
-      const UInt size = input_end - input_begin;
-
       //determine the struct size in data points if not already set
       if (struct_size_in_datapoints_ == 0)
       {
         struct_size_in_datapoints_ = (UInt)(double)param_.getValue("struc_elem_length");
       }
 
-      //apply the filtering
-      String method = param_.getValue("method");
-      if (method == "identity")
-      {
-        std::copy(input_begin, input_end, output_begin);
-      }
-      else if (method == "erosion")
-      {
-        applyErosion_(struct_size_in_datapoints_, input_begin, input_end, output_begin);
-      }
-      else if (method == "dilation")
-      {
-        applyDilation_(struct_size_in_datapoints_, input_begin, input_end, output_begin);
-      }
-      else if (method == "opening")
-      {
-        if (buffer.size() < size) buffer.resize(size);
-        applyErosion_(struct_size_in_datapoints_, input_begin, input_end, buffer.begin());
-        applyDilation_(struct_size_in_datapoints_, buffer.begin(), buffer.begin() + size, output_begin);
-      }
-      else if (method == "closing")
-      {
-        if (buffer.size() < size) buffer.resize(size);
-        applyDilation_(struct_size_in_datapoints_, input_begin, input_end, buffer.begin());
-        applyErosion_(struct_size_in_datapoints_, buffer.begin(), buffer.begin() + size, output_begin);
-      }
-      else if (method == "gradient")
-      {
-        if (buffer.size() < size) buffer.resize(size);
-        applyErosion_(struct_size_in_datapoints_, input_begin, input_end, buffer.begin());
-        applyDilation_(struct_size_in_datapoints_, input_begin, input_end, output_begin);
-        for (UInt i = 0; i < size; ++i) output_begin[i] -= buffer[i];
-      }
-      else if (method == "tophat")
-      {
-        if (buffer.size() < size) buffer.resize(size);
-        applyErosion_(struct_size_in_datapoints_, input_begin, input_end, buffer.begin());
-        applyDilation_(struct_size_in_datapoints_, buffer.begin(), buffer.begin() + size, output_begin);
-        for (UInt i = 0; i < size; ++i) output_begin[i] = input_begin[i] - output_begin[i];
-      }
-      else if (method == "bothat")
-      {
-        if (buffer.size() < size) buffer.resize(size);
-        applyDilation_(struct_size_in_datapoints_, input_begin, input_end, buffer.begin());
-        applyErosion_(struct_size_in_datapoints_, buffer.begin(), buffer.begin() + size, output_begin);
-        for (UInt i = 0; i < size; ++i) output_begin[i] = input_begin[i] - output_begin[i];
-      }
-      else if (method == "erosion_simple")
-      {
-        applyErosionSimple_(struct_size_in_datapoints_, input_begin, input_end, output_begin);
-      }
-      else if (method == "dilation_simple")
-      {
-        applyDilationSimple_(struct_size_in_datapoints_, input_begin, input_end, output_begin);
-      }
+      applyMethod_(struct_size_in_datapoints_, input_begin, input_end, output_begin);
 
       struct_size_in_datapoints_ = 0;
     }
@@ -281,8 +225,11 @@ public:
                 from struc_size and the average spacing, and rounded up to an odd
                 number.
         </ul>
+
+        The filter object is not modified, so several spectra can be filtered
+        concurrently.
     */
-    void filter(MSSpectrum & spectrum)
+    void filter(MSSpectrum & spectrum) const
     {
       //make sure the right peak type is set
       spectrum.setType(SpectrumSettings::PROFILE);
@@ -291,27 +238,29 @@ public:
       if (spectrum.size() <= 1) { return; }
 
       //Determine structuring element size in datapoints (depending on the unit)
+      UInt struct_size_in_datapoints;
       if ((String)(param_.getValue("struc_elem_unit")) == "Thomson")
       {
         const double struc_elem_length = (double)param_.getValue("struc_elem_length");
         const double mz_diff = spectrum.back().getMZ() - spectrum.begin()->getMZ();        
-        struct_size_in_datapoints_ = (UInt)(ceil(struc_elem_length*(double)(spectrum.size() - 1)/mz_diff));
+        struct_size_in_datapoints = (UInt)(ceil(struc_elem_length*(double)(spectrum.size() - 1)/mz_diff));
       }
       else
       {
-        struct_size_in_datapoints_ = (UInt)(double)param_.getValue("struc_elem_length");
+        struct_size_in_datapoints = (UInt)(double)param_.getValue("struc_elem_length");
       }
       //make it odd (needed for the algorithm)
-      if (!Math::isOdd(struct_size_in_datapoints_)) ++struct_size_in_datapoints_;
+      if (!Math::isOdd(struct_size_in_datapoints)) ++struct_size_in_datapoints;
 
-      //apply the filtering and overwrite the input data
+      //apply the filtering to a contiguous copy of the intensities and overwrite the input data
+      std::vector<Peak1D::IntensityType> input(spectrum.size());
+      for (Size i = 0; i < spectrum.size(); ++i)
+      {
+        input[i] = spectrum[i].getIntensity();
+      }
       std::vector<Peak1D::IntensityType> output(spectrum.size());
-      filterRange(Internal::intensityIteratorWrapper(spectrum.begin()),
-                  Internal::intensityIteratorWrapper(spectrum.end()),
-                  output.begin()
-                  );
+      applyMethod_(struct_size_in_datapoints, input.begin(), input.end(), output.begin());
 
-      //overwrite output with data
       for (Size i = 0; i < spectrum.size(); ++i)
       {
         spectrum[i].setIntensity(output[i]);
@@ -322,15 +271,18 @@ public:
         @brief Applies the morphological filtering operation to an MSExperiment.
 
         The size of the structuring element is computed for each spectrum individually, if it is given in 'Thomson'.
-        See the filtering method for MSSpectrum for details.
+        See the filtering method for MSSpectrum for details. The spectra are filtered in parallel.
     */
     void filterExperiment(PeakMap & exp)
     {
       startProgress(0, exp.size(), "filtering baseline");
-      for (UInt i = 0; i < exp.size(); ++i)
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic)
+#endif
+      for (SignedSize i = 0; i < (SignedSize)exp.size(); ++i)
       {
         filter(exp[i]);
-        setProgress(i);
+        nextProgress();
       }
       endProgress();
     }
@@ -340,209 +292,136 @@ protected:
     ///Member for struct size in data points
     UInt struct_size_in_datapoints_;
 
-    /** @brief Applies erosion.  This implementation uses van Herk's method.
-    Only 3 min/max comparisons are required per data point, independent of
-    struc_size.
-    */
+    /// Applies the operation given by the @em method parameter with a structuring element of @p struc_size data points
     template <typename InputIterator, typename OutputIterator>
-    void applyErosion_(Int struc_size, InputIterator input, InputIterator input_end, OutputIterator output)
+    void applyMethod_(UInt struc_size, InputIterator input_begin, InputIterator input_end, OutputIterator output_begin) const
     {
-      typedef typename InputIterator::value_type ValueType;
-      const Int size = input_end - input;
-      const Int struc_size_half = struc_size / 2;           // yes, integer division
-
-      static std::vector<ValueType> buffer;
-      if (Int(buffer.size()) < struc_size) buffer.resize(struc_size);
-
-      Int anchor;           // anchoring position of the current block
-      Int i;                // index relative to anchor, used for 'for' loops
-      Int ii = 0;           // input index
-      Int oi = 0;           // output index
-      ValueType current;           // current value
+      std::vector<typename InputIterator::value_type> buffer;
+      const UInt size = input_end - input_begin;
 
-      // we just can't get the case distinctions right in these cases, resorting to simple method.
-      if (size <= struc_size || size <= 5)
+      //apply the filtering
+      String method = param_.getValue("method");
+      if (method == "identity")
       {
-        applyErosionSimple_(struc_size, input, input_end, output);
-        return;
+        std::copy(input_begin, input_end, output_begin);
       }
+      else if (method == "erosion")
       {
-        // lower margin area
-        current = input[0];
-        for (++ii; ii < struc_size_half; ++ii) if (current > input[ii]) current = input[ii];
-        for (; ii < std::min(Int(struc_size), size); ++ii, ++oi)
-        {
-          if (current > input[ii]) current = input[ii];
-          output[oi] = current;
-        }
+        applyErosion_(struc_size, input_begin, input_end, output_begin);
       }
+      else if (method == "dilation")
       {
-        // middle (main) area
-        for (anchor = struc_size;
-             anchor <= size - struc_size;
-             anchor += struc_size
-             )
-        {
-          ii = anchor;
-          current = input[ii];
-          buffer[0] = current;
-          for (i = 1; i < struc_size; ++i, ++ii)
-          {
-            if (current > input[ii]) current = input[ii];
-            buffer[i] = current;
-          }
-          ii = anchor - 1;
-          oi = ii + struc_size_half;
-          current = input[ii];
-          for (i = 1; i < struc_size; ++i, --ii, --oi)
-          {
-            if (current > input[ii]) current = input[ii];
-            output[oi] = std::min(buffer[struc_size - i], current);
-          }
-          if (current > input[ii]) current = input[ii];
-          output[oi] = current;
-        }
+        applyDilation_(struc_size, input_begin, input_end, output_begin);
       }
+      else if (method == "opening")
       {
-        // higher margin area
-        ii = size - 1;
-        oi = ii;
-        current = input[ii];
-        for (--ii; ii >= size - struc_size_half; --ii) if (current > input[ii]) current = input[ii];
-        for (; ii >= std::max(size - Int(struc_size), 0); --ii, --oi)
-        {
-          if (current > input[ii]) current = input[ii];
-          output[oi] = current;
-        }
-        anchor = size - struc_size;
-        ii = anchor;
-        current = input[ii];
-        buffer[0] = current;
-        for (i = 1; i < struc_size; ++i, ++ii)
-        {
-          if (current > input[ii]) current = input[ii];
-          buffer[i] = current;
-        }
-        ii = anchor - 1;
-        oi = ii + struc_size_half;
-        current = input[ii];
-        for (i = 1; (ii >= 0) && (i < struc_size); ++i, --ii, --oi)
-        {
-          if (current > input[ii]) current = input[ii];
-          output[oi] = std::min(buffer[struc_size - i], current);
-        }
-        if (ii >= 0)
-        {
-          if (current > input[ii]) current = input[ii];
-          output[oi] = current;
-        }
+        buffer.resize(size);
+        applyErosion_(struc_size, input_begin, input_end, buffer.begin());
+        applyDilation_(struc_size, buffer.begin(), buffer.begin() + size, output_begin);
+      }
+      else if (method == "closing")
+      {
+        buffer.resize(size);
+        applyDilation_(struc_size, input_begin, input_end, buffer.begin());
+        applyErosion_(struc_size, buffer.begin(), buffer.begin() + size, output_begin);
+      }
+      else if (method == "gradient")
+      {
+        buffer.resize(size);
+        applyErosion_(struc_size, input_begin, input_end, buffer.begin());
+        applyDilation_(struc_size, input_begin, input_end, output_begin);
+        for (UInt i = 0; i < size; ++i) output_begin[i] -= buffer[i];
+      }
+      else if (method == "tophat")
+      {
+        buffer.resize(size);
+        applyErosion_(struc_size, input_begin, input_end, buffer.begin());
+        applyDilation_(struc_size, buffer.begin(), buffer.begin() + size, output_begin);
+        for (UInt i = 0; i < size; ++i) output_begin[i] = input_begin[i] - output_begin[i];
+      }
+      else if (method == "bothat")
+      {
+        buffer.resize(size);
+        applyDilation_(struc_size, input_begin, input_end, buffer.begin());
+        applyErosion_(struc_size, buffer.begin(), buffer.begin() + size, output_begin);
+        for (UInt i = 0; i < size; ++i) output_begin[i] = input_begin[i] - output_begin[i];
+      }
+      else if (method == "erosion_simple")
+      {
+        applyErosionSimple_(struc_size, input_begin, input_end, output_begin);
+      }
+      else if (method == "dilation_simple")
+      {
+        applyDilationSimple_(struc_size, input_begin, input_end, output_begin);
       }
-      return;
     }
 
-    /** @brief Applies dilation.  This implementation uses van Herk's method.
-    Only 3 min/max comparisons are required per data point, independent of
-    struc_size.
+    /** @brief Sliding window minimum (@p IsMax = false) or maximum (@p IsMax = true)
+
+    Uses the van Herk/Gil-Werman algorithm: the input is padded with the
+    neutral element at both ends and split into blocks of the window width.
+    For each block, the running extrema from the left and from the right are
+    computed, and the extremum of each window is the extremum of the right
+    running value at its start and the left running value at its end.  Only 3
+    min/max comparisons are required per data point, independent of
+    struc_size, and the last step is a branch-free element-wise min/max over
+    contiguous arrays, which the compiler can vectorize.
     */
-    template <typename InputIterator, typename OutputIterator>
-    void applyDilation_(Int struc_size, InputIterator input, InputIterator input_end, OutputIterator output)
+    template <bool IsMax, typename InputIterator, typename OutputIterator>
+    void applyVanHerkGilWerman_(Int struc_size, InputIterator input, InputIterator input_end, OutputIterator output) const
     {
       typedef typename InputIterator::value_type ValueType;
       const Int size = input_end - input;
-      const Int struc_size_half = struc_size / 2;           // yes, integer division
-
-      static std::vector<ValueType> buffer;
-      if (Int(buffer.size()) < struc_size) buffer.resize(struc_size);
+      if (size <= 0) return;
 
-      Int anchor;           // anchoring position of the current block
-      Int i;                // index relative to anchor, used for 'for' loops
-      Int ii = 0;           // input index
-      Int oi = 0;           // output index
-      ValueType current;           // current value
+      const Int struc_size_half = std::max(struc_size, 1) / 2;           // yes, integer division
+      const Int width = 2 * struc_size_half + 1;
+      const Int padded_size = (size + 2 * struc_size_half + width - 1) / width * width;
+      const ValueType neutral = IsMax ? std::numeric_limits<ValueType>::lowest() : (std::numeric_limits<ValueType>::max)();
 
-      // we just can't get the case distinctions right in these cases, resorting to simple method.
-      if (size <= struc_size || size <= 5)
-      {
-        applyDilationSimple_(struc_size, input, input_end, output);
-        return;
-      }
+      // left (g) and right (h) running extrema within each block
+      std::vector<ValueType> g(padded_size, neutral);
+      for (Int i = 0; i < size; ++i) g[i + struc_size_half] = input[i];
+      std::vector<ValueType> h(g);
+      for (Int anchor = 0; anchor < padded_size; anchor += width)
       {
-        // lower margin area
-        current = input[0];
-        for (++ii; ii < struc_size_half; ++ii) if (current < input[ii]) current = input[ii];
-        for (; ii < std::min(Int(struc_size), size); ++ii, ++oi)
+        for (Int i = anchor + 1; i < anchor + width; ++i)
         {
-          if (current < input[ii]) current = input[ii];
-          output[oi] = current;
+          g[i] = IsMax ? (g[i] < g[i - 1] ? g[i - 1] : g[i]) : (g[i - 1] < g[i] ? g[i - 1] : g[i]);
         }
-      }
-      {
-        // middle (main) area
-        for (anchor = struc_size;
-             anchor <= size - struc_size;
-             anchor += struc_size
-             )
+        for (Int i = anchor + width - 2; i >= anchor; --i)
         {
-          ii = anchor;
-          current = input[ii];
-          buffer[0] = current;
-          for (i = 1; i < struc_size; ++i, ++ii)
-          {
-            if (current < input[ii]) current = input[ii];
-            buffer[i] = current;
-          }
-          ii = anchor - 1;
-          oi = ii + struc_size_half;
-          current = input[ii];
-          for (i = 1; i < struc_size; ++i, --ii, --oi)
-          {
-            if (current < input[ii]) current = input[ii];
-            output[oi] = std::max(buffer[struc_size - i], current);
-          }
-          if (current < input[ii]) current = input[ii];
-          output[oi] = current;
+          h[i] = IsMax ? (h[i] < h[i + 1] ? h[i + 1] : h[i]) : (h[i + 1] < h[i] ? h[i + 1] : h[i]);
         }
       }
+
+      // window [i, i + width - 1] of the padded data is centered at input position i
+      const ValueType* g_end = &g[width - 1];
+      ValueType* h_begin = &h[0];
+      for (Int i = 0; i < size; ++i)
       {
-        // higher margin area
-        ii = size - 1;
-        oi = ii;
-        current = input[ii];
-        for (--ii; ii >= size - struc_size_half; --ii) if (current < input[ii]) current = input[ii];
-        for (; ii >= std::max(size - Int(struc_size), 0); --ii, --oi)
-        {
-          if (current < input[ii]) current = input[ii];
-          output[oi] = current;
-        }
-        anchor = size - struc_size;
-        ii = anchor;
-        current = input[ii];
-        buffer[0] = current;
-        for (i = 1; i < struc_size; ++i, ++ii)
-        {
-          if (current < input[ii]) current = input[ii];
-          buffer[i] = current;
-        }
-        ii = anchor - 1;
-        oi = ii + struc_size_half;
-        current = input[ii];
-        for (i = 1; (ii >= 0) && (i < struc_size); ++i, --ii, --oi)
-        {
-          if (current < input[ii]) current = input[ii];
-          output[oi] = std::max(buffer[struc_size - i], current);
-        }
-        if (ii >= 0)
-        {
-          if (current < input[ii]) current = input[ii];
-          output[oi] = current;
-        }
+        h_begin[i] = IsMax ? (h_begin[i] < g_end[i] ? g_end[i] : h_begin[i]) : (g_end[i] < h_begin[i] ? g_end[i] : h_begin[i]);
       }
-      return;
+      std::copy(h.begin(), h.begin() + size, output);
+    }
+
+    /// Applies erosion.  This implementation uses the van Herk/Gil-Werman method (see applyVanHerkGilWerman_()).
+    template <typename InputIterator, typename OutputIterator>
+    void applyErosion_(Int struc_size, InputIterator input, InputIterator input_end, OutputIterator output) const
+    {
+      applyVanHerkGilWerman_<false>(struc_size, input, input_end, output);
+    }
+
+    /// Applies dilation.  This implementation uses the van Herk/Gil-Werman method (see applyVanHerkGilWerman_()).
+    template <typename InputIterator, typename OutputIterator>
+    void applyDilation_(Int struc_size, InputIterator input, InputIterator input_end, OutputIterator output) const
+    {
+      applyVanHerkGilWerman_<true>(struc_size, input, input_end, output);
     }
 
     /// Applies erosion.  Simple implementation, possibly faster if struc_size is very small, and used in some special cases.
     template <typename InputIterator, typename OutputIterator>
-    void applyErosionSimple_(Int struc_size, InputIterator input_begin, InputIterator input_end, OutputIterator output_begin)
+    void applyErosionSimple_(Int struc_size, InputIterator input_begin, InputIterator input_end, OutputIterator output_begin) const
     {
       typedef typename InputIterator::value_type ValueType;
       const int size = input_end - input_begin;
@@ -560,7 +439,7 @@ protected:
 
     /// Applies dilation.  Simple implementation, possibly faster if struc_size is very small, and used in some special cases.
     template <typename InputIterator, typename OutputIterator>
-    void applyDilationSimple_(Int struc_size, InputIterator input_begin, InputIterator input_end, OutputIterator output_begin)
+    void applyDilationSimple_(Int struc_size, InputIterator input_begin, InputIterator input_end, OutputIterator output_begin) const
     {
       typedef typename InputIterator::value_type ValueType;
       const int size = input_end - input_begin;
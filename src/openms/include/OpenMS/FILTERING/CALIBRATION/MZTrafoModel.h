@@ -120,6 +120,10 @@ namespace OpenMS
       This is not done via member, to keep a small memory footprint since hundreds of
       MZTrafoModels are expected to be build at the same time and the RANSAC params
       should be identical for all of them.
+
+      @note Models may be trained in parallel (see InternalCalibration), so a custom
+      RNG function (Math::RANSACParam::rng) has to be thread-safe. Without one, RANSAC
+      uses its own seeded random number streams.
       
       @param p RANSAC params
     */
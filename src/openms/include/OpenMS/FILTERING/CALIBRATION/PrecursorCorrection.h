@@ -178,6 +178,49 @@ class OPENMS_DLLAPI PrecursorCorrection
 
   protected:
 
+      /// result of the search for a precursor peak in the MS1 spectrum
+      enum SearchResult_
+      {
+        NO_MS1_,    ///< no MS1 spectrum found for the precursor
+        NOT_FOUND_, ///< no peak within the tolerance
+        FOUND_      ///< peak found
+      };
+
+      /**
+      @brief Searches the corrected m/z of all precursors in their MS1 spectra (in parallel).
+
+      @param exp: constant MSExperiment.
+      @param precursors: constant vector of Precursor.
+      @param precursors_rt: constant vector double of precursors retention time.
+      @param mz_tolerance: double tolerance used for precursor correction in mass range.
+      @param ppm: bool enables usage of ppm.
+      @param highest_intensity: bool select the most intense peak within the tolerance (instead of the closest peak).
+      @param spectrum_idx: vector Size index of the MS2 spectrum of each precursor.
+      @param status: vector SearchResult_ outcome of the search for each precursor.
+      @param peak_mz: vector double corrected mass to charge (if status is FOUND_).
+      */
+      static void searchMS1_(const MSExperiment& exp,
+                             const std::vector<Precursor>& precursors,
+                             const std::vector<double>& precursors_rt,
+                             double mz_tolerance,
+                             bool ppm,
+                             bool highest_intensity,
+                             std::vector<Size>& spectrum_idx,
+                             std::vector<SearchResult_>& status,
+                             std::vector<double>& peak_mz);
+
+      /**
+      @brief Bounding box of a features convex hull extended by the retention time tolerance.
+
+      @param feature: constant Feature.
+      @param rt_tolerance: constant double retention time tolerance in seconds.
+      @param box: DBoundingBox<2> the extended bounding box.
+      @return static boolean false if the box cannot enclose any position (empty convex hull).
+      */
+      static bool extendedBoundingBox_(const Feature& feature,
+                                       const double rt_tolerance,
+                                       DBoundingBox<2>& box);
+
       /**
       @brief Check if precursor is located in the bounding box of a features convex hull.
       Here the bounding box of the feature is extended by the retention time tolerance and
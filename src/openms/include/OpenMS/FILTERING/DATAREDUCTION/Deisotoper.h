@@ -76,6 +76,22 @@ class OPENMS_DLLAPI Deisotoper
             unsigned int max_isopeaks = 10,
             bool make_single_charged = true,
             bool annotate_charge = false);
+
+  /* @brief Detect isotopic clusters in all spectra of an experiment.
+
+    Applies deisotopeAndSingleCharge() to each spectrum (unsorted spectra are
+    sorted by m/z first). The spectra are processed in parallel.
+   */
+  static void deisotopeAndSingleCharge(PeakMap& exp,
+            double fragment_tolerance,
+            bool fragment_unit_ppm,
+            int min_charge = 1,
+            int max_charge = 3,
+            bool keep_only_deisotoped = false,
+            unsigned int min_isopeaks = 3,
+            unsigned int max_isopeaks = 10,
+            bool make_single_charged = true,
+            bool annotate_charge = false);
 };
 
 }
@@ -60,14 +60,21 @@ public:
     /// default constructor
     FeatureHypothesis();
 
+    /// constructor for a hypothesis on (some of) the given mass traces, which need to outlive the hypothesis
+    explicit FeatureHypothesis(const std::vector<MassTrace>& mass_traces);
+
     /// default destructor
     ~FeatureHypothesis();
 
-    /// copy constructor
-    FeatureHypothesis(const FeatureHypothesis&);
+    /// hypotheses are not copied (but moved) during feature finding
+    FeatureHypothesis(const FeatureHypothesis&) = delete;
+    FeatureHypothesis& operator=(const FeatureHypothesis& rhs) = delete;
+
+    /// move constructor
+    FeatureHypothesis(FeatureHypothesis&&) = default;
 
-    /// assignment operator
-    FeatureHypothesis& operator=(const FeatureHypothesis& rhs);
+    /// move assignment operator
+    FeatureHypothesis& operator=(FeatureHypothesis&&) = default;
 
     // getter & setter
     Size getSize() const;
@@ -98,8 +105,12 @@ public:
 
     double getFWHM() const;
 
-    /// addMassTrace
-    void addMassTrace(const MassTrace&);
+    /// adds a mass trace (by index into the mass traces given in the constructor)
+    void addMassTrace(Size index);
+
+    /// indices of the mass traces of the hypothesis (monoisotopic trace first)
+    const std::vector<Size>& getMassTraceIndices() const;
+
     double getMonoisotopicFeatureIntensity(bool) const;
     double getSummedFeatureIntensity(bool) const;
 
@@ -109,8 +120,14 @@ public:
 
 private:
 
-    // pointers of MassTraces contained in isotopic pattern
-    std::vector<const MassTrace*> iso_pattern_;
+    /// returns the i-th mass trace of the isotopic pattern
+    const MassTrace& getTrace_(Size i) const;
+
+    // mass traces the indices refer to
+    const std::vector<MassTrace>* mass_traces_;
+
+    // indices of MassTraces contained in isotopic pattern
+    std::vector<Size> iso_pattern_;
 
     double feat_score_;
 
@@ -258,13 +275,14 @@ e conditions are fulfilled. Mainly the
 
     /** @brief Identify groupings of mass traces based on a set of reasonable candidates
      *
-     * Takes a set of reasonable candidates for mass trace grouping and checks
-     * all combinations of charge and isotopic positions on the candidates. It
-     * is assumed that candidates[0] is the monoisotopic trace.
+     * Takes a set of reasonable candidates for mass trace grouping (indices
+     * into mass_traces) and checks all combinations of charge and isotopic
+     * positions on the candidates. It is assumed that candidates[0] is the
+     * monoisotopic trace.
      *
      * The resulting possible groupings are appended to output_hypotheses.
     */
-    void findLocalFeatures_(const std::vector<const MassTrace*>& candidates, const double total_intensity, std::vector<FeatureHypothesis>& output_hypotheses) const;
+    void findLocalFeatures_(const std::vector<MassTrace>& mass_traces, const std::vector<Size>& candidates, const double total_intensity, std::vector<FeatureHypothesis>& output_hypotheses) const;
 
     /// SVM parameters
     svm_model* isotope_filt_svm_;
@@ -65,6 +65,17 @@ namespace OpenMS
     length as well as having the minimal sample rate criterion fulfilled) get
     added to the result.
 
+    For large maps, the detection can be partitioned into m/z slabs (see
+    parameter num_mz_slabs) that are processed in parallel. Each slab
+    contains the apices of an m/z range with about the same number of apices
+    and the peaks of this range enlarged by mz_slab_overlap on both sides, so
+    that traces starting close to a slab border can be extended completely.
+    A trace is reported by the slab containing its apex, traces sharing peaks
+    with a trace of higher apex intensity (from a neighbouring slab) are
+    removed. As long as the overlap is larger than the m/z extent of the
+    traces, the result is the same as for the serial detection (up to the
+    trace labels).
+
     @htmlinclude OpenMS_MassTraceDetection.parameters
 
     @ingroup Quantitation
@@ -104,12 +115,27 @@ private:
 
     typedef std::multimap<double, std::pair<Size, Size> > MapIdxSortedByInt;
 
-    /// The internal run method
+    /**
+      @brief The internal run method
+
+      If @p found_peaks is given, the (spectrum, peak) indices of the peaks of
+      each trace are stored (apex first). Progress is only reported if
+      @p report_progress is set.
+    */
     void run_(const MapIdxSortedByInt& chrom_apices,
               const Size peak_count, 
               const PeakMap & work_exp,
               const std::vector<Size>& spec_offsets,
-              std::vector<MassTrace> & found_masstraces);
+              std::vector<MassTrace> & found_masstraces,
+              std::vector<std::vector<std::pair<Size, Size> > >* found_peaks = nullptr,
+              bool report_progress = true);
+
+    /// The internal run method for partitioned detection in m/z slabs (see class documentation)
+    void runPartitioned_(const MapIdxSortedByInt& chrom_apices,
+                         const Size peak_count,
+                         const PeakMap & work_exp,
+                         const std::vector<Size>& spec_offsets,
+                         std::vector<MassTrace> & found_masstraces);
 
     // parameter stuff
     double mass_error_ppm_;
@@ -124,6 +150,9 @@ private:
     double max_trace_length_;
 
     bool reestimate_mt_sd_;
+
+    Size num_mz_slabs_;
+    double mz_slab_overlap_;
   };
 }
 
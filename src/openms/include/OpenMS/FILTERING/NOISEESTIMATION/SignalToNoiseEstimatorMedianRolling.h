@@ -0,0 +1,328 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2018.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: Chris Bielow $
+// $Authors: $
+// --------------------------------------------------------------------------
+//
+
+#pragma once
+
+#include <OpenMS/FILTERING/NOISEESTIMATION/SignalToNoiseEstimator.h>
+#include <OpenMS/CONCEPT/LogStream.h>
+#include <OpenMS/DATASTRUCTURES/ListUtils.h>
+
+#include <set>
+
+namespace OpenMS
+{
+  /**
+    @brief Estimates the signal/noise (S/N) ratio of each data point in a scan by using the exact median of a sliding window
+
+    For each datapoint in the given scan, we collect a range of data points
+    around it (param: <i>win_len</i>). The noise for a datapoint is estimated
+    to be the median of the intensities of the current window. If the number
+    of elements in the current window is not sufficient (param:
+    <i>min_required_elements</i>), the noise level is set to a default value
+    (param: <i>noise_for_empty_window</i>).
+
+    In contrast to SignalToNoiseEstimatorMedian, no histogram is used: the
+    intensities of the current window are kept in two sorted halves (the lower
+    and the upper half), which are updated as data points enter and leave the
+    window. Each update takes O(log w) time (w being the number of data points
+    in the window) and the median is available in constant time, so the
+    estimate neither depends on a maximal intensity nor on a number of bins.
+    As in SignalToNoiseEstimatorMedian, the lower median is used for windows
+    with an even number of elements and the noise is at least 1.
+
+    The parameters are a subset of the parameters of
+    SignalToNoiseEstimatorMedian (see also SignalToNoiseEstimatorMedianRapid
+    for a fast estimator using fixed, non-overlapping windows).
+
+    Changing any of the parameters will invalidate the S/N values (which will invoke a recomputation on the next request).
+
+    @note If more than 20 percent of windows have less than <i>min_required_elements</i> of elements, a warning is issued to <i>LOG_WARN</i> and noise estimates in those windows are set to the constant <i>noise_for_empty_window</i>.
+
+        @htmlinclude OpenMS_SignalToNoiseEstimatorMedianRolling.parameters
+
+    @ingroup SignalProcessing
+  */
+
+  template <typename Container = MSSpectrum>
+  class SignalToNoiseEstimatorMedianRolling :
+    public SignalToNoiseEstimator<Container>
+  {
+
+public:
+
+    using SignalToNoiseEstimator<Container>::stn_estimates_;
+    using SignalToNoiseEstimator<Container>::first_;
+    using SignalToNoiseEstimator<Container>::last_;
+    using SignalToNoiseEstimator<Container>::is_result_valid_;
+    using SignalToNoiseEstimator<Container>::defaults_;
+    using SignalToNoiseEstimator<Container>::param_;
+
+    typedef typename SignalToNoiseEstimator<Container>::PeakIterator PeakIterator;
+    typedef typename SignalToNoiseEstimator<Container>::PeakType PeakType;
+
+    /// default constructor
+    inline SignalToNoiseEstimatorMedianRolling()
+    {
+      //set the name for DefaultParamHandler error messages
+      this->setName("SignalToNoiseEstimatorMedianRolling");
+
+      defaults_.setValue("win_len", 200.0, "window length in Thomson");
+      defaults_.setMinFloat("win_len", 1.0);
+
+      defaults_.setValue("min_required_elements", 10, "minimum number of elements required in a window (otherwise it is considered sparse)");
+      defaults_.setMinInt("min_required_elements", 1);
+
+      defaults_.setValue("noise_for_empty_window", std::pow(10.0, 20), "noise value used for sparse windows", ListUtils::create<String>("advanced"));
+
+      defaults_.setValue("write_log_messages", "true", "Write out log messages in case of sparse windows");
+      defaults_.setValidStrings("write_log_messages", ListUtils::create<String>("true,false"));
+
+      SignalToNoiseEstimator<Container>::defaultsToParam_();
+    }
+
+    /// Copy Constructor
+    inline SignalToNoiseEstimatorMedianRolling(const SignalToNoiseEstimatorMedianRolling & source) :
+      SignalToNoiseEstimator<Container>(source)
+    {
+      updateMembers_();
+    }
+
+    /** @name Assignment
+     */
+    //@{
+    ///
+    inline SignalToNoiseEstimatorMedianRolling & operator=(const SignalToNoiseEstimatorMedianRolling & source)
+    {
+      if (&source == this) return *this;
+
+      SignalToNoiseEstimator<Container>::operator=(source);
+      updateMembers_();
+      return *this;
+    }
+
+    //@}
+
+    /// Destructor
+    ~SignalToNoiseEstimatorMedianRolling() override
+    {}
+
+    /// Returns how many percent of the windows were sparse
+    double getSparseWindowPercent() const
+    {
+      return sparse_window_percent_;
+    }
+
+protected:
+
+    /**
+      @brief Intensities of the current window, split into a lower and an upper half
+
+      All values in @p lower are smaller or equal to all values in @p upper
+      and @p lower holds at most one element more than @p upper, so the
+      largest element of @p lower is the (lower) median.
+    */
+    struct RollingMedian
+    {
+      std::multiset<double> lower;
+      std::multiset<double> upper;
+
+      Size size() const
+      {
+        return lower.size() + upper.size();
+      }
+
+      double median() const
+      {
+        return *lower.rbegin();
+      }
+
+      void insert(double value)
+      {
+        if (lower.empty() || value <= *lower.rbegin())
+        {
+          lower.insert(value);
+        }
+        else
+        {
+          upper.insert(value);
+        }
+        rebalance();
+      }
+
+      /// removes one element with the given value (which has to be present)
+      void erase(double value)
+      {
+        // the value is in the lower half if it is not larger than its maximum
+        if (!lower.empty() && value <= *lower.rbegin())
+        {
+          lower.erase(lower.find(value));
+        }
+        else
+        {
+          upper.erase(upper.find(value));
+        }
+        rebalance();
+      }
+
+      void rebalance()
+      {
+        if (lower.size() > upper.size() + 1)
+        {
+          typename std::multiset<double>::iterator it = --lower.end();
+          upper.insert(upper.begin(), *it);
+          lower.erase(it);
+        }
+        else if (upper.size() > lower.size())
+        {
+          typename std::multiset<double>::iterator it = upper.begin();
+          lower.insert(lower.end(), *it);
+          upper.erase(it);
+        }
+      }
+    };
+
+    /** Calculate signal-to-noise values for all data points given, by using a sliding window approach
+
+        @param scan_first_ first element in the scan
+        @param scan_last_ last element in the scan (disregarded)
+    */
+    void computeSTN_(const PeakIterator & scan_first_, const PeakIterator & scan_last_) override
+    {
+      // reset counter for sparse windows
+      sparse_window_percent_ = 0;
+
+      // reset the results
+      stn_estimates_.clear();
+
+      PeakIterator window_pos_center  = scan_first_;
+      PeakIterator window_pos_borderleft = scan_first_;
+      PeakIterator window_pos_borderright = scan_first_;
+
+      double window_half_size = win_len_ / 2;
+
+      RollingMedian window;
+
+      // number of windows
+      int window_count = 0;
+
+      double noise;    // noise value of a datapoint
+
+      // determine how many elements we need to estimate (for progress estimation)
+      int windows_overall = std::distance(scan_first_, scan_last_);
+      SignalToNoiseEstimator<Container>::startProgress(0, windows_overall, "noise estimation of data");
+
+      // MAIN LOOP
+      while (window_pos_center != scan_last_)
+      {
+        // remove all elements that leave the window on the LEFT side
+        while ((*window_pos_borderleft).getMZ() <  (*window_pos_center).getMZ() - window_half_size)
+        {
+          window.erase((*window_pos_borderleft).getIntensity());
+          ++window_pos_borderleft;
+        }
+
+        // add all elements that enter the window on the RIGHT side
+        while ((window_pos_borderright != scan_last_)
+              && ((*window_pos_borderright).getMZ() <= (*window_pos_center).getMZ() + window_half_size))
+        {
+          window.insert((*window_pos_borderright).getIntensity());
+          ++window_pos_borderright;
+        }
+
+        if ((int)window.size() < min_required_elements_)
+        {
+          noise = noise_for_empty_window_;
+          ++sparse_window_percent_;
+        }
+        else
+        {
+          // just avoid division by 0
+          noise = std::max(1.0, window.median());
+        }
+
+        // store result
+        stn_estimates_[*window_pos_center] = (*window_pos_center).getIntensity() / noise;
+
+        // advance the window center by one datapoint
+        ++window_pos_center;
+        ++window_count;
+        // update progress
+        SignalToNoiseEstimator<Container>::setProgress(window_count);
+
+      } // end while
+
+      SignalToNoiseEstimator<Container>::endProgress();
+
+      if (window_count == 0) return;
+
+      sparse_window_percent_ = sparse_window_percent_ * 100 / window_count;
+
+      // warn if percentage of sparse windows is above 20%
+      if (sparse_window_percent_ > 20 && write_log_messages_)
+      {
+        LOG_WARN << "WARNING in SignalToNoiseEstimatorMedianRolling: "
+                 << sparse_window_percent_
+                 << "% of all windows were sparse. You should consider increasing 'win_len' or decreasing 'min_required_elements'"
+                 << std::endl;
+      }
+    }
+
+    /// overridden function from DefaultParamHandler to keep members up to date, when a parameter is changed
+    void updateMembers_() override
+    {
+      win_len_                 = (double)param_.getValue("win_len");
+      min_required_elements_   = param_.getValue("min_required_elements");
+      noise_for_empty_window_  = (double)param_.getValue("noise_for_empty_window");
+      write_log_messages_      = (bool)param_.getValue("write_log_messages").toBool();
+      is_result_valid_         = false;
+    }
+
+    /// range of data points which belong to a window in Thomson
+    double win_len_;
+    /// minimal number of elements a window needs to cover to be used
+    int min_required_elements_;
+    /// used as noise value for windows which cover less than "min_required_elements_"
+    /// use a very high value if you want to get a low S/N result
+    double noise_for_empty_window_;
+
+    // whether to write out log messages in the case of failure
+    bool write_log_messages_;
+
+    // counter for sparse windows
+    double sparse_window_percent_;
+
+  };
+
+} // namespace OpenMS
@@ -101,6 +101,42 @@ namespace OpenMS
     int OPENMS_DLLAPI lowess(const std::vector<double>& x, const std::vector<double>& y,
                double f, int nsteps, double delta, std::vector<double>& result);
 
+    /**
+      @brief Working memory of a lowess fit
+
+      Holds all temporary vectors of lowess(), so that they do not need to be
+      allocated again if many fits are computed (e.g. one per alignment or
+      per run). The content is only meaningful during a call.
+    */
+    struct OPENMS_DLLAPI LowessWorkspace
+    {
+      std::vector<double> resid_weights; ///< robustness weights
+      std::vector<double> residuals; ///< residuals of the current fit
+      std::vector<std::vector<double> > thread_weights; ///< regression weights (one vector per thread)
+      std::vector<size_t> fit_index; ///< points at which the regression is computed
+      std::vector<size_t> fit_nleft; ///< left end of the neighborhood of each fit point
+      std::vector<size_t> fit_nright; ///< right end of the neighborhood of each fit point
+      std::vector<double> fit_values; ///< fitted value at each fit point
+    };
+
+    /**
+      @brief Computes a lowess smoothing fit on the input vectors using a reusable workspace
+
+      Same as lowess() above, but all temporary vectors are taken from
+      @p workspace. The points at which the local regressions are computed
+      only depend on @p x and @p delta; they are determined once, and the
+      regressions of each robustness iteration are computed in parallel. The
+      result does not depend on the number of threads.
+
+      For large inputs, use a positive @p delta (e.g. 0.01 * range of x):
+      the number of regressions is then bounded by about range / delta,
+      independent of the number of points, while with delta = 0 a regression
+      over f * n points is computed at each of the n points.
+    */
+    int OPENMS_DLLAPI lowess(const std::vector<double>& x, const std::vector<double>& y,
+               double f, int nsteps, double delta, std::vector<double>& result,
+               LowessWorkspace& workspace);
+
     /**
       @brief Computes a lowess smoothing fit on the input vectors with the recommended values
 
@@ -185,48 +185,38 @@ public:
     /**
       @brief Removed the noise from an MSSpectrum containing profile data.
     */
-    void filter(MSSpectrum & spectrum)
-    {
-      // copy the data AND META DATA to the output container
-      MSSpectrum output = spectrum;
-      // filter
-      filter(spectrum.begin(), spectrum.end(), output.begin());
-      // swap back
-      std::swap(spectrum, output);
-    }
+    void filter(MSSpectrum & spectrum) const;
 
     /**
       @brief Removed the noise from an MSChromatogram
     */
-    void filter(MSChromatogram & chromatogram)
-    {
-      // copy the data AND META DATA to the output container
-      MSChromatogram output = chromatogram;
-      // filter
-      filter(chromatogram.begin(), chromatogram.end(), output.begin());
-      // swap back
-      std::swap(chromatogram, output);
-    }
+    void filter(MSChromatogram & chromatogram) const;
+
+    /**
+      @brief Removed the noise from several spectra or chromatograms with the same number of data points at once
+
+      The intensities are stored point by point ("struct of arrays"): the
+      intensity of data point @em k of trace @em t is stored at position
+      <tt>k * nr_traces + t</tt> of @p intensities. This layout allows the
+      convolution to process all traces with the same coefficients at once,
+      which is considerably faster than smoothing many short chromatograms
+      one by one. Traces with less data points than the frame length are not
+      changed (as in filter()).
+
+      @param intensities The intensities of all traces (smoothed in place)
+      @param nr_traces The number of traces
+
+      @exception Exception::IllegalArgument is thrown if the size of @p intensities is not a multiple of @p nr_traces
+    */
+    void filterBatch(std::vector<double> & intensities, Size nr_traces) const;
 
     /**
       @brief Removed the noise from an MSExperiment containing profile data.
+
+      Spectra are smoothed in parallel, chromatograms with the same number of
+      data points are smoothed together using filterBatch().
     */
-    void filterExperiment(PeakMap & map)
-    {
-      Size progress = 0;
-      startProgress(0, map.size() + map.getChromatograms().size(), "smoothing data");
-      for (Size i = 0; i < map.size(); ++i)
-      {
-        filter(map[i]);
-        setProgress(++progress);
-      }
-      for (Size i = 0; i < map.getChromatograms().size(); ++i)
-      {
-        filter(map.getChromatogram(i));
-        setProgress(++progress);
-      }
-      endProgress();
-    }
+    void filterExperiment(PeakMap & map) const;
 
 protected:
     /// Coefficients
@@ -238,6 +228,18 @@ protected:
     /// The order of the smoothing polynomial.
     UInt order_;
 
+    /**
+      @brief The coefficients of all output positions in the order of the input data points
+
+      Row @em r (of length frame_size_) is used for the @em r-th data point
+      of the transient on (r <= frame_size_ / 2), row frame_size_ / 2 + 1 for
+      the steady state and the remaining rows for the transient off.
+    */
+    std::vector<double> kernel_;
+
+    /// Smoothes @p nr_traces traces of @p nr_points data points each (point-major layout, @p output has to be of the same size as @p input)
+    void smooth_(const double * input, double * output, Size nr_points, Size nr_traces) const;
+
     // Docu in base class
     void updateMembers_() override;
   };
@@ -142,14 +142,19 @@ public:
 
     /**
         @brief Resamples the data in an MSExperiment.
+
+        The spectra are resampled in parallel.
     */
     void rasterExperiment(PeakMap& exp)
     {
       startProgress(0, exp.size(), "resampling of data");
-      for (Size i = 0; i < exp.size(); ++i)
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic)
+#endif
+      for (SignedSize i = 0; i < (SignedSize)exp.size(); ++i)
       {
         raster(exp[i]);
-        setProgress(i);
+        nextProgress();
       }
       endProgress();
     }
@@ -295,6 +295,89 @@ public:
       }
     }
 
+    /**
+        @brief Applies the resampling algorithm to flat arrays and a uniform raster.
+
+        Same as raster() on separate m/z and intensity arrays, but the
+        resampling points are given implicitly by @p start_pos and @p spacing
+        (point i is at start_pos + i * spacing). The two closest resampling
+        points of each raw data point are computed directly instead of being
+        searched, and the raw data does not need to be sorted. This should be
+        used if many spectra are resampled onto the same raster, e.g. when
+        they are added up (see SpectrumAddition).
+
+        The intensities will be added to the intensities in the output array.
+        All intensity outside the range of the raster is added to the first or
+        last resampling point.
+
+        @param mz_raw_it Start of the input m/z data
+        @param mz_raw_end End of the input m/z data
+        @param int_raw_it Start of the input intensity data (same length as the m/z data)
+        @param start_pos Position of the first resampling point
+        @param spacing Distance between two resampling points (needs to be positive)
+        @param int_resample_it Start of the output intensities (one per resampling point)
+        @param int_resample_end End of the output intensities
+    */
+    template <typename MZIterator, typename IntensityIterator, typename OutputIterator>
+    static void rasterUniform(MZIterator mz_raw_it, MZIterator mz_raw_end, IntensityIterator int_raw_it,
+        double start_pos, double spacing, OutputIterator int_resample_it, OutputIterator int_resample_end)
+    {
+      OPENMS_PRECONDITION(spacing > 0, "Spacing needs to be positive")
+
+      const SignedSize nr_points = std::distance(int_resample_it, int_resample_end);
+      if (nr_points <= 0) return;
+
+      for (; mz_raw_it != mz_raw_end; ++mz_raw_it, ++int_raw_it)
+      {
+        const double mz = *mz_raw_it;
+        if (!(mz >= start_pos))
+        {
+          int_resample_it[0] += *int_raw_it;
+          continue;
+        }
+
+        // the left point is the last resampling point below mz (as in raster()), correct for rounding in the division
+        const double pos = (mz - start_pos) / spacing;
+        SignedSize left = pos < nr_points - 1 ? static_cast<SignedSize>(pos) : nr_points - 1;
+        while (left > 0 && start_pos + left * spacing >= mz) {--left;}
+        while (left + 1 < nr_points && start_pos + (left + 1) * spacing < mz) {++left;}
+
+        if (left + 1 == nr_points)
+        {
+          int_resample_it[left] += *int_raw_it;
+          continue;
+        }
+
+        // distribute the intensity of the raw point according to the distance to the two resampling points
+        const double dist_left = fabs(mz - (start_pos + left * spacing));
+        const double dist_right = fabs(mz - (start_pos + (left + 1) * spacing));
+        int_resample_it[left] += (*int_raw_it) * dist_right / (dist_left + dist_right);
+        int_resample_it[left + 1] += (*int_raw_it) * dist_left / (dist_left + dist_right);
+      }
+    }
+
+    /**
+        @brief Applies raster_align() to all spectra of an MSExperiment.
+
+        All spectra are resampled onto the same raster between @p start_pos
+        and @p end_pos. The spectra are resampled in parallel.
+    */
+    void rasterExperiment(PeakMap& exp, double start_pos, double end_pos)
+    {
+      startProgress(0, exp.size(), "resampling of data");
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic)
+#endif
+      for (SignedSize i = 0; i < (SignedSize)exp.size(); ++i)
+      {
+        raster_align(exp[i], start_pos, end_pos);
+        nextProgress();
+      }
+      endProgress();
+    }
+
+    using LinearResampler::rasterExperiment;
+
     /**
         @brief Applies the resampling algorithm using a linear interpolation
 
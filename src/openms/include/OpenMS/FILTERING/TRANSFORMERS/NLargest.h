@@ -79,14 +79,23 @@ public:
     {
       if (spectrum.size() <= peakcount_) return;
 
-      // sort by reverse intensity
-      spectrum.sortByIntensity(true);
+      // select the n largest peaks without sorting the whole spectrum
+      // (pairs of negative intensity and index: ties are resolved by the index, as in a stable sort)
+      std::vector<std::pair<double, Size> > order;
+      order.reserve(spectrum.size());
+      for (Size i = 0; i != spectrum.size(); ++i)
+      {
+        order.push_back(std::make_pair(-static_cast<double>(spectrum[i].getIntensity()), i));
+      }
+      std::nth_element(order.begin(), order.begin() + peakcount_, order.end());
 
-      // keep the n largest peaks if more than n are present
+      // keep the n largest peaks, ordered by reverse intensity
+      std::sort(order.begin(), order.begin() + peakcount_);
       std::vector<Size> indices;
+      indices.reserve(peakcount_);
       for (Size i = 0; i != peakcount_; ++i)
       {
-        indices.push_back(i);
+        indices.push_back(order[i].second);
       }
       spectrum.select(indices);
     }
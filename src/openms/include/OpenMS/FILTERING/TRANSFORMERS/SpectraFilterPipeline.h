@@ -0,0 +1,128 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2018.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: Timo Sachsenberg $
+// $Authors: Timo Sachsenberg $
+// --------------------------------------------------------------------------
+//
+#pragma once
+
+#include <OpenMS/DATASTRUCTURES/Param.h>
+#include <OpenMS/KERNEL/StandardTypes.h>
+
+#include <functional>
+#include <utility>
+#include <vector>
+
+namespace OpenMS
+{
+
+  /**
+    @brief Applies an ordered list of spectrum filters in a single pass
+
+    Each spectrum is passed through all filters of the pipeline before the next
+    spectrum is processed. The spectra are modified in place and filtered in
+    parallel (if OpenMP is enabled); every thread uses its own filter objects,
+    so the result does not depend on the number of threads.
+
+    Supported filters (see getFilterNames()):
+    BernNorm, NLargest, Normalizer, ParentPeakMower, Scaler, SqrtMower,
+    ThresholdMower and WindowMower. The parameters of each filter are the
+    parameters of the respective class.
+
+    @ingroup SpectraPreprocessers
+  */
+  class OPENMS_DLLAPI SpectraFilterPipeline
+  {
+public:
+
+    /// default constructor (empty pipeline)
+    SpectraFilterPipeline();
+
+    /// destructor
+    virtual ~SpectraFilterPipeline();
+
+    /**
+      @brief Appends a filter to the pipeline
+
+      @param name name of the filter (one of getFilterNames())
+      @param param parameters of the filter (missing values are set to their defaults)
+
+      @exception Exception::InvalidValue if @p name is not a supported filter
+      @exception Exception::InvalidParameter if a value of @p param is not valid for the filter
+    */
+    void addFilter(const String& name, const Param& param = Param());
+
+    /// removes all filters
+    void clear();
+
+    /// number of filters in the pipeline
+    Size size() const;
+
+    /// names of the filters in the pipeline (in order of application)
+    StringList getFilters() const;
+
+    /// names of all supported filters
+    static StringList getFilterNames();
+
+    /**
+      @brief Default parameters of a supported filter
+
+      @exception Exception::InvalidValue if @p name is not a supported filter
+    */
+    static Param getFilterDefaults(const String& name);
+
+    /**
+      @brief Applies all filters to a single spectrum
+
+      @note This creates the filter objects on every call; use filterPeakMap() for many spectra.
+    */
+    void filterPeakSpectrum(PeakSpectrum& spectrum) const;
+
+    /// Applies all filters to every spectrum of the map (in parallel)
+    void filterPeakMap(PeakMap& exp) const;
+
+protected:
+
+    /// a configured filter applied to one spectrum
+    typedef std::function<void (PeakSpectrum&)> Step_;
+
+    /// creates a configured filter object
+    static Step_ createStep_(const String& name, const Param& param);
+
+    /// creates one configured filter object per pipeline entry
+    std::vector<Step_> createSteps_() const;
+
+    /// filter names and their parameters, in order of application
+    std::vector<std::pair<String, Param> > filters_;
+
+  };
+
+}
@@ -203,6 +203,48 @@ public:
       return;
     }
 
+    /**
+      @brief Merges blocks of spectra like mergeSpectraBlockWise() by m/z binning
+
+      Uses the same blocks as mergeSpectraBlockWise() (parameters
+      "block_method:..."), but the blocks are only kept as index lists into
+      @p exp and each block is merged by a single k-way merge of its sorted
+      peak lists (see mergeBlockBinned()) instead of pairwise alignments of
+      spectrum copies. Blocks are merged in parallel.
+
+      This is considerably faster for blocks with many spectra (e.g. the
+      sub-spectra of ion mobility frames). Peaks are combined by binning,
+      thus the result is similar, but not identical, to
+      mergeSpectraBlockWise().
+    */
+    void mergeSpectraBlockWiseBinned(PeakMap& exp);
+
+    /**
+      @brief Merges a block of spectra into a single spectrum by m/z binning
+
+      The peaks of all spectra of the block (each sorted by m/z) are visited
+      in ascending m/z order by a k-way merge. Starting at the smallest m/z,
+      all peaks within @p mz_binning_width (in Da, or in ppm of the first
+      peak of the bin if @p ppm is true) are combined into one peak with the
+      summed intensity at the intensity-weighted mean m/z.
+
+      The meta data of @p merged are taken from the first spectrum of the
+      block and those of all other spectra are appended (see
+      SpectrumSettings::unify()). The RT is the average RT of the block, for
+      @p ms_level >= 2 a single precursor with the average precursor m/z is
+      kept. Data arrays are not merged.
+
+      @param block The spectra to merge (sorted by m/z, the first one is the master spectrum)
+      @param ms_level The MS level of the merged spectrum
+      @param mz_binning_width Maximal m/z distance of peaks to be combined
+      @param ppm Whether @p mz_binning_width is given in ppm (otherwise Da)
+      @param merged The merged spectrum
+
+      @exception Exception::IllegalArgument is thrown if @p block is empty
+    */
+    static void mergeBlockBinned(const std::vector<const MSSpectrum*>& block, UInt ms_level,
+                                 double mz_binning_width, bool ppm, MSSpectrum& merged);
+
     /// merges spectra with similar precursors (must have MS2 level)
     template <typename MapType>
     void mergeSpectraPrecursors(MapType& exp)
@@ -633,7 +675,7 @@ protected:
         }
         else
         {
-          merged_spectra.addSpectrum(consensus_spec);
+          merged_spectra.addSpectrum(std::move(consensus_spec));
         }
       }
 
@@ -648,27 +690,23 @@ protected:
               (int)count_peaks_overall, float(count_peaks_aligned) / float(count_peaks_overall) * 100.);
       LOG_INFO << "Number of merged peaks: " << String(buffer) << "\n";
 
-      // remove all spectra that were within a cluster
-      typename MapType::SpectrumType empty_spec;
-      MapType exp_tmp;
+      // remove all spectra that were within a cluster (moving, not copying the others)
+      std::vector<typename MapType::SpectrumType> spectra;
+      spectra.reserve(exp.size() - merged_indices.size() + merged_spectra.size());
       for (Size i = 0; i < exp.size(); ++i)
       {
         if (merged_indices.count(i) == 0) // save unclustered ones
         {
-          exp_tmp.addSpectrum(exp[i]);
-          exp[i] = empty_spec;
+          spectra.push_back(std::move(exp[i]));
         }
       }
 
-      //typedef std::vector<typename MapType::SpectrumType> Base;
-      //exp.Base::operator=(exp_tmp);
-      exp.clear(false);
-      exp.getSpectra().insert(exp.end(), exp_tmp.begin(), exp_tmp.end());
-
-      // exp.erase(remove_if(exp.begin(), exp.end(), InMSLevelRange<typename MapType::SpectrumType>(ListUtils::create<int>(String(ms_level)), false)), exp.end());
-
       // ... and add consensus spectra
-      exp.getSpectra().insert(exp.end(), merged_spectra.begin(), merged_spectra.end());
+      for (Size i = 0; i < merged_spectra.size(); ++i)
+      {
+        spectra.push_back(std::move(merged_spectra[i]));
+      }
+      exp.setSpectra(std::move(spectra));
 
     }
 
@@ -773,7 +811,7 @@ protected:
         }
 
         // store spectrum temporarily
-        exp_tmp.addSpectrum(average_spec);
+        exp_tmp.addSpectrum(std::move(average_spec));
       }
 
       endProgress();
@@ -783,7 +821,7 @@ protected:
       //typename MapType::SpectrumType empty_spec;
       for (AverageBlocks::ConstIterator it = spectra_to_average_over.begin(); it != spectra_to_average_over.end(); ++it)
       {
-        exp[it->first] = exp_tmp[n];
+        exp[it->first] = std::move(exp_tmp[n]);
         //exp_tmp[n] = empty_spec;
         ++n;
       }
@@ -891,7 +929,7 @@ protected:
         }
 
         // store spectrum temporarily
-        exp_tmp.addSpectrum(average_spec);
+        exp_tmp.addSpectrum(std::move(average_spec));
 
       }
 
@@ -901,7 +939,7 @@ protected:
       int n(0);
       for (AverageBlocks::ConstIterator it = spectra_to_average_over.begin(); it != spectra_to_average_over.end(); ++it)
       {
-        exp[it->first] = exp_tmp[n];
+        exp[it->first] = std::move(exp_tmp[n]);
         ++n;
       }
 
@@ -74,25 +74,30 @@ public:
     void filterPeakSpectrumForTopNInSlidingWindow(SpectrumType& spectrum)
     {
       typedef typename SpectrumType::ConstIterator ConstIterator;
+      typedef typename SpectrumType::PeakType PeakType;
 
       windowsize_ = (double)param_.getValue("windowsize");
       peakcount_ = (UInt)param_.getValue("peakcount");
 
-      //copy spectrum
-      SpectrumType old_spectrum = spectrum;
-      old_spectrum.sortByPosition();
+      //copy peaks
+      std::vector<PeakType> old_spectrum(spectrum.begin(), spectrum.end());
+      if (!spectrum.isSorted())
+      {
+        std::stable_sort(old_spectrum.begin(), old_spectrum.end(), typename PeakType::PositionLess());
+      }
 
       //find high peak positions
       bool end  = false;
       std::set<double> positions;
-      for (ConstIterator it = old_spectrum.begin(); it != old_spectrum.end(); ++it)
+      std::vector<std::pair<double, Size> > window; // reused for all windows
+      for (Size i = 0; i != old_spectrum.size(); ++i)
       {
-        // copy the window from the spectrum
-        SpectrumType window;
-        for (ConstIterator it2 = it; (it2->getPosition() - it->getPosition() < windowsize_); )
+        // collect the window starting at peak i
+        window.clear();
+        for (Size j = i; old_spectrum[j].getMZ() - old_spectrum[i].getMZ() < windowsize_; )
         {
-          window.push_back(*it2);
-          if (++it2 == old_spectrum.end())
+          window.push_back(std::make_pair(-static_cast<double>(old_spectrum[j].getIntensity()), j));
+          if (++j == old_spectrum.size())
           {
             end = true;
             break;
@@ -100,13 +105,10 @@ public:
         }
 
         //extract peakcount most intense peaks
-        window.sortByIntensity(true);
-        for (Size i = 0; i < peakcount_; ++i)
+        selectMostIntense_(window, peakcount_);
+        for (Size k = 0; k < window.size(); ++k)
         {
-          if (i < window.size())
-          {
-            positions.insert(window[i].getMZ());
-          }
+          positions.insert(old_spectrum[window[k].second].getMZ());
         }
         //abort at the end of the spectrum
         if (end) break;
@@ -138,93 +140,69 @@ public:
         return;
       }
 
-      spectrum.sortByPosition();
+      if (!spectrum.isSorted())
+      {
+        spectrum.sortByPosition();
+      }
 
       windowsize_ = static_cast<double>(param_.getValue("windowsize"));
       peakcount_ = static_cast<UInt>(param_.getValue("peakcount"));
 
-      // copy meta data
-      SpectrumType out = spectrum;
-      out.clear(false);
+      // retained peaks
+      std::vector<bool> keep(spectrum.size(), false);
 
-      SpectrumType peaks_in_window;
+      std::vector<std::pair<double, Size> > peaks_in_window;
       double window_start = spectrum[0].getMZ();
       for (Size i = 0; i != spectrum.size(); ++i)
       {
         if (spectrum[i].getMZ() - window_start < windowsize_) // collect peaks in window
         {
-          peaks_in_window.push_back(spectrum[i]);
+          peaks_in_window.push_back(std::make_pair(-static_cast<double>(spectrum[i].getIntensity()), i));
         }
         else // step over window boundaries
         {
           window_start = spectrum[i].getMZ(); // as there might be large gaps between peaks resulting in empty windows, set new window start to next peak
 
-          // copy N highest peaks to out
-          if (peaks_in_window.size() > peakcount_)
-          {
-            std::partial_sort(peaks_in_window.begin(), peaks_in_window.begin() + peakcount_, peaks_in_window.end(), reverseComparator(typename SpectrumType::PeakType::IntensityLess()));
-            copy(peaks_in_window.begin(), peaks_in_window.begin() + peakcount_, back_inserter(out));
-          }
-          else
+          // keep N highest peaks
+          selectMostIntense_(peaks_in_window, peakcount_);
+          for (Size k = 0; k < peaks_in_window.size(); ++k)
           {
-            std::sort(peaks_in_window.begin(), peaks_in_window.end(), reverseComparator(typename SpectrumType::PeakType::IntensityLess()));
-            copy(peaks_in_window.begin(), peaks_in_window.end(), back_inserter(out));
+            keep[peaks_in_window[k].second] = true;
           }
 
-          peaks_in_window.clear(false);
-          peaks_in_window.push_back(spectrum[i]);
+          peaks_in_window.clear();
+          peaks_in_window.push_back(std::make_pair(-static_cast<double>(spectrum[i].getIntensity()), i));
         }
       }
 
-      if (peaks_in_window.empty()) // last window is empty -> no special handling needed
-      {
-        // select peaks that were retained
-        std::vector<Size> indices;
-        for (typename SpectrumType::ConstIterator it = spectrum.begin(); it != spectrum.end(); ++it)
-        {
-          if (std::find(out.begin(), out.end(), *it) != out.end())
-          {
-            Size index(it - spectrum.begin());
-            indices.push_back(index);
-          }
-        }
-        spectrum.select(indices);
-        return;
-      }
-
       // Note that the last window might be much smaller than windowsize.
       // Therefor the number of peaks copied from this window should be adapted accordingly.
       // Otherwise a lot of noise peaks are copied from each end of a spectrum.
-
-      double last_window_size = peaks_in_window.back().getMZ() - window_start;
-      double last_window_size_fraction = last_window_size / windowsize_;
-      Size last_window_peakcount = last_window_size_fraction * peakcount_;
-
-      if (last_window_peakcount) // handle single peak in last window (will produce no proper fraction)
+      if (!peaks_in_window.empty())
       {
-        last_window_peakcount = 1;
-      }
+        double last_window_size = spectrum[peaks_in_window.back().second].getMZ() - window_start;
+        double last_window_size_fraction = last_window_size / windowsize_;
+        Size last_window_peakcount = last_window_size_fraction * peakcount_;
 
-      // sort for last_window_peakcount highest peaks
-      std::partial_sort(peaks_in_window.begin(), peaks_in_window.begin() + last_window_peakcount, peaks_in_window.end(), reverseComparator(typename SpectrumType::PeakType::IntensityLess()));
+        if (last_window_peakcount) // handle single peak in last window (will produce no proper fraction)
+        {
+          last_window_peakcount = 1;
+        }
 
-      if (peaks_in_window.size() > last_window_peakcount)
-      {
-        std::copy(peaks_in_window.begin(), peaks_in_window.begin() + last_window_peakcount, back_inserter(out));
-      }
-      else
-      {
-        std::copy(peaks_in_window.begin(), peaks_in_window.end(), std::back_inserter(out));
+        selectMostIntense_(peaks_in_window, last_window_peakcount);
+        for (Size k = 0; k < peaks_in_window.size(); ++k)
+        {
+          keep[peaks_in_window[k].second] = true;
+        }
       }
 
       // select peaks that were retained
       std::vector<Size> indices;
-      for (typename SpectrumType::ConstIterator it = spectrum.begin(); it != spectrum.end(); ++it)
+      for (Size i = 0; i != spectrum.size(); ++i)
       {
-        if (std::find(out.begin(), out.end(), *it) != out.end())
+        if (keep[i])
         {
-          Size index(it - spectrum.begin());
-          indices.push_back(index);
+          indices.push_back(i);
         }
       }
       spectrum.select(indices);
@@ -234,6 +212,16 @@ public:
 
     //TODO reimplement DefaultParamHandler::updateMembers_()
 
+protected:
+    /**
+      @brief Reduces @p window to its @p n most intense peaks (in no particular order)
+
+      The window holds pairs of negative intensity and peak index; equally
+      intense peaks are selected by increasing index (as with a stable sort).
+      Runs in linear time.
+    */
+    static void selectMostIntense_(std::vector<std::pair<double, Size> >& window, Size n);
+
 private:
     double windowsize_;
     UInt peakcount_;
@@ -167,6 +167,36 @@ private:
 
     static const char encoder_[];
     static const char decoder_[];
+
+    /**
+        @brief Decodes Base64 characters to raw bytes
+
+        Decodes four characters at a time through a 256 entry lookup table and
+        writes directly into @p dest. Trailing padding is ignored. Characters
+        outside of the Base64 alphabet (e.g. whitespace) are skipped.
+
+        @param src The Base64 characters
+        @param src_size The number of characters in @p src
+        @param dest Output buffer of at least 3 * ceil(src_size / 4) bytes
+        @return The number of bytes written to @p dest
+    */
+    static Size decodeBytes_(const char * src, Size src_size, Byte * dest);
+
+    /// Encodes @p src_size raw bytes to Base64 (replaces the content of @p out)
+    static void encodeBytes_(const Byte * src, Size src_size, String & out);
+
+    /**
+        @brief Inflates zlib-compressed data directly into the memory of @p out
+
+        @exception Exception::ConversionError is thrown if the data cannot be
+        decompressed or does not decompress to a multiple of sizeof(ToType) bytes
+    */
+    template <typename ToType>
+    static void inflate_(const std::string & compressed, std::vector<ToType> & out);
+
+    /// Reverses the byte order of all elements in @p data (elements of 4 or 8 bytes)
+    template <typename ToType>
+    static void swapByteOrder_(std::vector<ToType> & data);
     /// Decodes a Base64 string to a vector of floating point numbers
     template <typename ToType>
     static void decodeUncompressed_(const String & in, ByteOrder from_byte_order, std::vector<ToType> & out);
@@ -217,8 +247,6 @@ private:
     const Size element_size = sizeof(FromType);
     const Size input_bytes = element_size * in.size();
     String compressed;
-    Byte * it;
-    Byte * end;
     //Change endianness if necessary
     if ((OPENMS_IS_BIG_ENDIAN && to_byte_order == Base64::BYTEORDER_LITTLEENDIAN) || (!OPENMS_IS_BIG_ENDIAN && to_byte_order == Base64::BYTEORDER_BIGENDIAN))
     {
@@ -247,7 +275,7 @@ private:
     //encode with compression
     if (zlib_compression)
     {
-      unsigned long sourceLen =   (unsigned long)in.size();
+      unsigned long sourceLen =   (unsigned long)input_bytes;
       unsigned long compressed_length =       //compressBound((unsigned long)in.size());
                                         sourceLen + (sourceLen >> 12) + (sourceLen >> 14) + 11; // taken from zlib's compress.c, as we cannot use compressBound*
       //
@@ -277,60 +305,13 @@ private:
         throw Exception::ConversionError(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "Compression error?");
       }
 
-      String(compressed).swap(compressed);
-      it = reinterpret_cast<Byte *>(&compressed[0]);
-      end = it + compressed_length;
-      out.resize((Size)ceil(compressed_length / 3.) * 4);     //resize output array in order to have enough space for all characters
+      encodeBytes_(reinterpret_cast<Byte *>(&compressed[0]), compressed_length, out);
     }
     //encode without compression
     else
     {
-      out.resize((Size)ceil(input_bytes / 3.) * 4);     //resize output array in order to have enough space for all characters
-      it = reinterpret_cast<Byte *>(&in[0]);
-      end = it + input_bytes;
-    }
-
-    Byte * to = reinterpret_cast<Byte *>(&out[0]);
-
-
-    Size written = 0;
-
-    while (it != end)
-    {
-      Int int_24bit = 0;
-      Int padding_count = 0;
-
-      // construct 24-bit integer from 3 bytes
-      for (Size i = 0; i < 3; i++)
-      {
-        if (it != end)
-        {
-          int_24bit |= *it++ << ((2 - i) * 8);
-        }
-        else
-        {
-          padding_count++;
-        }
-      }
-
-      // write out 4 characters
-      for (Int i = 3; i >= 0; i--)
-      {
-        to[i] = encoder_[int_24bit & 0x3F];
-        int_24bit >>= 6;
-      }
-
-      // fixup for padding
-      if (padding_count > 0)
-        to[3] = '=';
-      if (padding_count > 1)
-        to[2] = '=';
-
-      to += 4;
-      written += 4;
+      encodeBytes_(reinterpret_cast<Byte *>(&in[0]), input_bytes, out);
     }
-
-    out.resize(written);         //no more space is needed
   }
 
   template <typename ToType>
@@ -352,57 +333,19 @@ private:
     out.clear();
     if (in == "") return;
 
-    const Size element_size = sizeof(ToType);
-
-    String decompressed;
-
-    QByteArray qt_byte_array = QByteArray::fromRawData(in.c_str(), (int) in.size());
-    QByteArray bazip = QByteArray::fromBase64(qt_byte_array);
-    QByteArray czip;
-    czip.resize(4);
-    czip[0] = (bazip.size() & 0xff000000) >> 24;
-    czip[1] = (bazip.size() & 0x00ff0000) >> 16;
-    czip[2] = (bazip.size() & 0x0000ff00) >> 8;
-    czip[3] = (bazip.size() & 0x000000ff);
-    czip += bazip;
-    QByteArray base64_uncompressed = qUncompress(czip);
-
-    if (base64_uncompressed.isEmpty())
-    {
-      throw Exception::ConversionError(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "Decompression error?");
-    }
-    decompressed.resize(base64_uncompressed.size());
-
-    std::copy(base64_uncompressed.begin(), base64_uncompressed.end(), decompressed.begin());
+    // decode the characters to the compressed bytes ...
+    std::string compressed;
+    compressed.resize((in.size() + 3) / 4 * 3);
+    compressed.resize(decodeBytes_(in.c_str(), in.size(), reinterpret_cast<Byte *>(&compressed[0])));
 
-    void* byte_buffer = reinterpret_cast<void *>(&decompressed[0]);
-    Size buffer_size = decompressed.size();
+    // ... and inflate them directly into the output vector
+    inflate_(compressed, out);
 
-    const ToType * float_buffer = reinterpret_cast<const ToType *>(byte_buffer);
-    if (buffer_size % element_size != 0)
-    {
-      throw Exception::ConversionError(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "Bad BufferCount?");
-    }
-    
-    Size float_count = buffer_size / element_size;
-    
     // change endianness if necessary
     if ((OPENMS_IS_BIG_ENDIAN && from_byte_order == Base64::BYTEORDER_LITTLEENDIAN) || (!OPENMS_IS_BIG_ENDIAN && from_byte_order == Base64::BYTEORDER_BIGENDIAN))
     {
-      if (element_size == 4) // 32 bit
-      {
-        UInt32 * p = reinterpret_cast<UInt32 *>(byte_buffer);
-        std::transform(p, p + float_count, p, endianize32);
-      }
-      else // 64 bit
-      {
-        UInt64 * p = reinterpret_cast<UInt64 *>(byte_buffer);
-        std::transform(p, p + float_count, p, endianize64);
-      }
+      swapByteOrder_(out);
     }
-
-    // copy values
-    out.assign(float_buffer, float_buffer + float_count);
   }
 
   template <typename ToType>
@@ -421,103 +364,84 @@ private:
       throw Exception::ConversionError(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "Malformed base64 input, length is not a multiple of 4.");
     }
 
-    Size src_size = in.size();
-    // last one or two '=' are skipped if contained
-    int padding = 0;
-    if (in[src_size - 1] == '=') padding++;
-    if (in[src_size - 2] == '=') padding++;
-
-    src_size -= padding;
-
-    UInt a;
-    UInt b;
-
-    UInt offset = 0;
-    int inc = 1;
-    UInt written = 0;
-
     const Size element_size = sizeof(ToType);
 
-    // enough for either float or double
-    char element[8] = "\x00\x00\x00\x00\x00\x00\x00";
+    // decode directly into the (zero-initialized) memory of the output
+    // vector. Padded positions of the last block count as zero bytes, an
+    // incomplete trailing element is dropped.
+    const Size max_bytes = in.size() / 4 * 3;
+    out.resize((max_bytes + element_size - 1) / element_size);
+    const Size written = decodeBytes_(in.c_str(), in.size(), reinterpret_cast<Byte *>(&out[0]));
+    out.resize((written + 2) / 3 * 3 / element_size);
 
     // Parse little endian data in big endian OpenMS (or other way round)
     if ((OPENMS_IS_BIG_ENDIAN && from_byte_order == Base64::BYTEORDER_LITTLEENDIAN) || 
        (!OPENMS_IS_BIG_ENDIAN && from_byte_order == Base64::BYTEORDER_BIGENDIAN))
     {
-      offset = (element_size - 1);              // other endian
-      inc = -1;
-    }
-    else
-    {
-      offset = 0;
-      inc = 1;
+      swapByteOrder_(out);
     }
+  }
 
-    //reserve enough space in the output vector
-    out.reserve((UInt)(std::ceil((4.0 * src_size) / 3.0) + 6.0));
+  template <typename ToType>
+  void Base64::inflate_(const std::string & compressed, std::vector<ToType> & out)
+  {
+    const Size element_size = sizeof(ToType);
 
-    // sort all read bytes correctly into a char[4] (double) or
-    // char[8] (float) and push_back when necessary.
-    for (Size i = 0; i < src_size; i += 4)
+    z_stream stream = z_stream();
+    stream.next_in = reinterpret_cast<Bytef *>(const_cast<char *>(compressed.data()));
+    stream.avail_in = (uInt) compressed.size();
+    if (inflateInit(&stream) != Z_OK)
     {
-      // decode 4 Base64-Chars to 3 Byte
-      // -------------------------------
-
-      // decode the first two chars
-      a = decoder_[(int)in[i] - 43] - 62;
-      b = decoder_[(int)in[i + 1] - 43] - 62;
-      if (i + 1 >= src_size)
-      {
-        b = 0;
-      }
-      // write first byte (6 bits from a and 2 highest bits from b)
-      element[offset] = (unsigned char) ((a << 2) | (b >> 4));
-      written++;
-      offset = (offset + inc) % element_size;
+      throw Exception::ConversionError(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "Decompression error?");
+    }
 
-      if (written % element_size == 0)
+    // numeric data rarely compresses better than 1:4, grow the output if needed
+    out.resize(std::max<Size>(compressed.size() * 4 / element_size, 16));
+    int zlib_error;
+    do
+    {
+      Size out_bytes = out.size() * element_size;
+      if (stream.total_out == out_bytes)
       {
-        ToType * to_type = reinterpret_cast<ToType *>(&element[0]);
-        out.push_back((*to_type));
-        strcpy(element, "");
+        out.resize(out.size() * 2);
+        out_bytes = out.size() * element_size;
       }
+      stream.next_out = reinterpret_cast<Bytef *>(&out[0]) + stream.total_out;
+      stream.avail_out = (uInt) (out_bytes - stream.total_out);
+      zlib_error = inflate(&stream, Z_NO_FLUSH);
+    }
+    while (zlib_error == Z_OK);
 
-      // decode the third char
-      a = decoder_[(int)in[i + 2] - 43] - 62;
-      if (i + 2 >= src_size)
-      {
-        a = 0;
-      }
-      // write second byte (4 lowest bits from b and 4 highest bits from a)
-      element[offset] = (unsigned char) (((b & 15) << 4) | (a >> 2));
-      written++;
-      offset = (offset + inc) % element_size;
+    const Size total_out = stream.total_out;
+    inflateEnd(&stream);
 
-      if (written % element_size == 0)
-      {
-        ToType * to_type = reinterpret_cast<ToType *>(&element[0]);
-        out.push_back((*to_type));
-        strcpy(element, "");
-      }
+    if (zlib_error != Z_STREAM_END)
+    {
+      out.clear();
+      throw Exception::ConversionError(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "Decompression error?");
+    }
+    if (total_out % element_size != 0)
+    {
+      out.clear();
+      throw Exception::ConversionError(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "Bad BufferCount?");
+    }
+    out.resize(total_out / element_size);
+  }
 
-      // decode the fourth char
-      b = decoder_[(int)in[i + 3] - 43] - 62;
-      if (i + 3 >= src_size)
-      {
-        b = 0;
-      }
-      // write third byte (2 lowest bits from a and 6 bits from b)
-      element[offset] = (unsigned char) (((a & 3) << 6) | b);
-      written++;
-      offset = (offset + inc) % element_size;
+  template <typename ToType>
+  void Base64::swapByteOrder_(std::vector<ToType> & data)
+  {
+    if (data.empty()) return;
 
-      if (written % element_size == 0)
-      {
-        ToType * to_type = reinterpret_cast<ToType *>(&element[0]);
-        out.push_back((*to_type));
-        strcpy(element, "");
-      }
+    if (sizeof(ToType) == 4) // 32 bit
+    {
+      UInt32 * p = reinterpret_cast<UInt32 *>(&data[0]);
+      std::transform(p, p + data.size(), p, endianize32);
+    }
+    else // 64 bit
+    {
+      UInt64 * p = reinterpret_cast<UInt64 *>(&data[0]);
+      std::transform(p, p + data.size(), p, endianize64);
     }
   }
 
@@ -532,8 +456,6 @@ private:
     const Size element_size = sizeof(FromType);
     const Size input_bytes = element_size * in.size();
     String compressed;
-    Byte * it;
-    Byte * end;
     //Change endianness if necessary
     if ((OPENMS_IS_BIG_ENDIAN && to_byte_order == Base64::BYTEORDER_LITTLEENDIAN) || (!OPENMS_IS_BIG_ENDIAN && to_byte_order == Base64::BYTEORDER_BIGENDIAN))
     {
@@ -568,64 +490,16 @@ private:
       while (compress(reinterpret_cast<Bytef *>(&compressed[0]), &compressed_length, reinterpret_cast<Bytef *>(&in[0]), (unsigned long)input_bytes) != Z_OK)
       {
         compressed_length *= 2;
-        compressed.reserve(compressed_length);
+        compressed.resize(compressed_length);
       }
 
-
-      String(compressed).swap(compressed);
-      it = reinterpret_cast<Byte *>(&compressed[0]);
-      end = it + compressed_length;
-      out.resize((Size)ceil(compressed_length / 3.) * 4);     //resize output array in order to have enough space for all characters
+      encodeBytes_(reinterpret_cast<Byte *>(&compressed[0]), compressed_length, out);
     }
     //encode without compression
     else
     {
-      out.resize((Size)ceil(input_bytes / 3.) * 4);     //resize output array in order to have enough space for all characters
-      it = reinterpret_cast<Byte *>(&in[0]);
-      end = it + input_bytes;
-    }
-
-    Byte * to = reinterpret_cast<Byte *>(&out[0]);
-
-
-    Size written = 0;
-
-    while (it != end)
-    {
-      Int int_24bit = 0;
-      Int padding_count = 0;
-
-      // construct 24-bit integer from 3 bytes
-      for (Size i = 0; i < 3; i++)
-      {
-        if (it != end)
-        {
-          int_24bit |= *it++ << ((2 - i) * 8);
-        }
-        else
-        {
-          padding_count++;
-        }
-      }
-
-      // write out 4 characters
-      for (Int i = 3; i >= 0; i--)
-      {
-        to[i] = encoder_[int_24bit & 0x3F];
-        int_24bit >>= 6;
-      }
-
-      // fixup for padding
-      if (padding_count > 0)
-        to[3] = '=';
-      if (padding_count > 1)
-        to[2] = '=';
-
-      to += 4;
-      written += 4;
+      encodeBytes_(reinterpret_cast<Byte *>(&in[0]), input_bytes, out);
     }
-
-    out.resize(written);         //no more space is needed
   }
 
   template <typename ToType>
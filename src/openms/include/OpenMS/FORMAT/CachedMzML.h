@@ -36,8 +36,18 @@
 
 #include <OpenMS/KERNEL/MSExperiment.h>
 
+#include <boost/shared_ptr.hpp>
+
 #include <fstream>
 
+namespace boost
+{
+  namespace interprocess
+  {
+    class mapped_region;
+  }
+}
+
 namespace OpenMS
 {
 
@@ -49,6 +59,14 @@ namespace OpenMS
     be very fast and done in random order (once the in-memory index is built
     for the file).
 
+    Whenever possible, the cached file is memory-mapped read-only and data
+    items are copied directly out of the mapping. In that case no file pointer
+    needs to be moved, the page cache of the operating system is used without
+    additional buffering and copies of this object share the same mapping
+    (reading from different copies concurrently is safe). If the file cannot
+    be mapped (e.g. insufficient address space on 32 bit systems), a regular
+    file stream is used instead.
+
   */
   class OPENMS_DLLAPI CachedmzML
   {
@@ -78,6 +96,9 @@ public:
 
     size_t getNrChromatograms() const;
 
+    /// Whether the cached file is accessed through a memory mapping (instead of a file stream)
+    bool isMemoryMapped() const;
+
     const MSExperiment& getMetaData() const
     {
       return meta_ms_experiment_;
@@ -108,12 +129,36 @@ protected:
 
     void load_(const String& filename);
 
+    /**
+      @brief Returns the memory-mapped data at position @p pos of the cached file
+
+      @param pos Position in the cached file (from spectra_index_ or chrom_index_)
+      @param available Output parameter, number of bytes available from the returned pointer onwards
+
+      @exception Exception::ParseError is thrown if @p pos lies outside of the file
+    */
+    const char* getMappedData_(std::streampos pos, Size& available) const;
+
+    /**
+      @brief Asks the operating system to asynchronously read the given range of the mapped file
+
+      This is only a hint and has no effect if the file is not memory-mapped
+      or the platform does not support it.
+
+      @param begin Start position in the cached file
+      @param end End position in the cached file (-1 for the end of the file)
+    */
+    void prefetchMappedData_(std::streampos begin, std::streampos end) const;
+
     /// Meta data
     MSExperiment meta_ms_experiment_;
 
-    /// Internal filestream 
+    /// Internal filestream (only used if the cached file could not be memory-mapped)
     std::ifstream ifs_;
 
+    /// Read-only memory mapping of the cached file (shared between copies, empty if not mapped)
+    boost::shared_ptr<boost::interprocess::mapped_region> mapped_region_;
+
     /// Name of the mzML file
     String filename_;
 
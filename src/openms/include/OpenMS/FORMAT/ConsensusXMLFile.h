@@ -82,6 +82,9 @@ public:
     /**
     @brief Stores a consensus map to file
 
+    Consensus elements are formatted in batches (in parallel if OpenMP is
+    enabled) and written in their original order.
+
     @exception Exception::UnableToCreateFile is thrown if the file name is not writable
     @exception Exception::IllegalArgument is thrown if the consensus map is not valid
     @exception Exception::MissingInformation is thrown if source files are missing/duplicated or map-IDs are referencing non-existing maps
@@ -109,6 +112,9 @@ protected:
     /// Writes a peptide identification to a stream (for assigned/unassigned peptide identifications)
     void writePeptideIdentification_(const String& filename, std::ostream& os, const PeptideIdentification& id, const String& tag_name, UInt indentation_level);
 
+    /// Writes a consensusElement (may be called concurrently while storing)
+    void writeConsensusFeature_(const String& filename, std::ostream& os, const ConsensusFeature& elem);
+
 
     /// Options that can be set
     PeakFileOptions options_;
@@ -114,6 +114,19 @@ public:
     */
     bool getRow(Size row, StringList& list);
 
+    /**
+      @brief Splits a row into views on its items without copying them
+
+      Same as getRow(Size, StringList&), but the items are returned as views
+      into the internal buffer. They stay valid until the file is cleared,
+      reloaded or destroyed.
+
+      @exception Exception::InvalidIterator is thrown if the row is not existing
+
+      @return  returns false if the given row could not be separated into items
+    */
+    bool getRow(Size row, std::vector<StringView>& list) const;
+
     /**
       @brief Returns the number of rows that were loaded from the file.
 
@@ -0,0 +1,176 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2018.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: Hannes Roest $
+// $Authors: Hannes Roest $
+// --------------------------------------------------------------------------
+
+#pragma once
+
+#include <OpenMS/INTERFACES/IMSDataConsumer.h>
+
+#include <OpenMS/KERNEL/StandardTypes.h>
+#include <OpenMS/KERNEL/MSSpectrum.h>
+#include <OpenMS/KERNEL/MSChromatogram.h>
+
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <mutex>
+#include <thread>
+
+namespace OpenMS
+{
+
+    /**
+      @brief Consumer which passes MS data to another consumer on a background thread
+
+      Spectra and chromatograms are copied into a bounded queue and handed to
+      the wrapped consumer (in their original order) by a dedicated writer
+      thread. This allows to write several output files concurrently from a
+      single reading thread, e.g. one file per SWATH window when splitting a
+      DIA file:
+
+      @code
+      std::vector<PlainMSDataWritingConsumer*> writers = ...;
+      std::vector<MSDataAsyncConsumer*> outputs;
+      for (Size i = 0; i < writers.size(); ++i)
+      {
+        outputs.push_back(new MSDataAsyncConsumer(writers[i]));
+      }
+      // route spectra to outputs[k]->consumeSpectrum(s) while reading
+      for (Size i = 0; i < outputs.size(); ++i)
+      {
+        outputs[i]->flush(); // wait for the writers and report errors
+        delete outputs[i];
+        delete writers[i];
+      }
+      @endcode
+
+      If the queue is full, consumeSpectrum()/consumeChromatogram() block
+      until the writer thread caught up (backpressure), which bounds the
+      memory used by each output.
+
+      The writer thread uses its own OpenMP thread budget (@p threads) for
+      the work done by the wrapped consumer (e.g. the parallel encoding of
+      PlainMSDataWritingConsumer), so that many concurrent outputs do not
+      oversubscribe the machine.
+
+      setExpectedSize() and setExperimentalSettings() wait for the queue to
+      be processed and are then passed on directly.
+
+      @note Exceptions thrown by the wrapped consumer are re-thrown by the
+      next call to consume*(), flush() or set*(); data queued after the error
+      is discarded. The destructor processes all queued data, but can only
+      report errors to the log.
+
+      @note It is essential to not delete the wrapped consumer before
+      deleting this object.
+    */
+    class OPENMS_DLLAPI MSDataAsyncConsumer :
+      public Interfaces::IMSDataConsumer
+    {
+
+    public:
+
+      /**
+        @brief Constructor (starts the writer thread)
+
+        @param consumer The consumer which receives the data on the writer thread (no ownership is transferred)
+        @param max_queue_size Number of spectra and chromatograms which can be queued before the caller blocks (0 = 64)
+        @param threads Number of OpenMP threads available to the wrapped consumer on the writer thread
+      */
+      MSDataAsyncConsumer(Interfaces::IMSDataConsumer* consumer, Size max_queue_size = 0, int threads = 1);
+
+      /// Destructor (processes all queued data and stops the writer thread)
+      ~MSDataAsyncConsumer() override;
+
+      void setExpectedSize(Size expectedSpectra, Size expectedChromatograms) override;
+
+      void setExperimentalSettings(const ExperimentalSettings& exp) override;
+
+      /// Queues a copy of @p s (blocks while the queue is full)
+      void consumeSpectrum(SpectrumType& s) override;
+
+      /// Queues a copy of @p c (blocks while the queue is full)
+      void consumeChromatogram(ChromatogramType& c) override;
+
+      /**
+        @brief Waits until all queued data was passed to the wrapped consumer
+
+        Re-throws the (first) exception of the wrapped consumer.
+      */
+      void flush();
+
+      /// Returns the maximal number of queued spectra and chromatograms
+      Size getMaxQueueSize() const;
+
+    protected:
+      /// A queued spectrum or chromatogram
+      struct Item_
+      {
+        bool is_spectrum;
+        SpectrumType spectrum;
+        ChromatogramType chromatogram;
+      };
+
+      /// Main loop of the writer thread
+      void run_();
+
+      /// Queues @p item (blocks while the queue is full)
+      void push_(Item_& item);
+
+      /// Re-throws the stored exception (requires the lock to be held)
+      void checkError_();
+
+      Interfaces::IMSDataConsumer* consumer_;
+      Size max_queue_size_;
+      int threads_;
+
+      std::mutex mutex_;
+      std::condition_variable work_available_;
+      std::condition_variable space_available_;
+      std::condition_variable work_done_;
+      std::deque<Item_> queue_;
+      bool busy_;
+      bool stop_;
+      std::exception_ptr error_;
+      bool error_reported_;
+      std::thread thread_;
+
+    private:
+      /// do not allow copy
+      MSDataAsyncConsumer(const MSDataAsyncConsumer&);
+      /// do not allow assignment
+      MSDataAsyncConsumer& operator=(const MSDataAsyncConsumer&);
+    };
+
+} //end namespace OpenMS
+
@@ -0,0 +1,150 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2018.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: Hannes Roest $
+// $Authors: Hannes Roest $
+// --------------------------------------------------------------------------
+
+#pragma once
+
+#include <OpenMS/INTERFACES/IMSDataConsumer.h>
+
+#include <OpenMS/KERNEL/StandardTypes.h>
+#include <OpenMS/KERNEL/MSSpectrum.h>
+#include <OpenMS/KERNEL/MSChromatogram.h>
+
+#include <deque>
+#include <map>
+#include <vector>
+
+namespace OpenMS
+{
+    class SpectraMerger;
+
+    /**
+      @brief Consumer of MS data which merges blocks of spectra on the fly
+
+      Merges blocks of consecutive spectra of the same MS level (e.g. the
+      sub-spectra of ion mobility frames) while the data is read, using the
+      same blocks as SpectraMerger::mergeSpectraBlockWise() (parameters
+      "block_method:ms_levels", "block_method:rt_block_size" and
+      "block_method:rt_max_length" of the SpectraMerger). Each block is
+      merged by m/z binning (see SpectraMerger::mergeBlockBinned() and the
+      parameters "mz_binning_width" and "mz_binning_width_unit").
+
+      Only the spectra of the currently open blocks (one per MS level) are
+      held in memory. Spectra of other MS levels are passed on unchanged, and
+      the output keeps the order of the input: a merged spectrum takes the
+      place of the first spectrum of its block. Chromatograms are passed on
+      directly.
+
+      @note Call flush() after the last spectrum to pass on the remaining
+      blocks. The destructor flushes as well.
+    */
+    class OPENMS_DLLAPI MSDataBlockMergingConsumer :
+      public Interfaces::IMSDataConsumer
+    {
+
+    public:
+
+      /**
+        @brief Constructor
+
+        @param next_consumer Consumer which receives the merged data
+        @param merger The parameters of this SpectraMerger are used
+
+        @note This does not transfer ownership of the consumer
+      */
+      MSDataBlockMergingConsumer(Interfaces::IMSDataConsumer* next_consumer, const SpectraMerger& merger);
+
+      /**
+        @brief Destructor
+
+        Flushes data to next consumer
+
+        @note It is essential to not delete the underlying next_consumer before
+        deleting this object, otherwise we risk a memory error
+      */
+      ~MSDataBlockMergingConsumer() override;
+
+      void setExpectedSize(Size, Size) override {}
+
+      void setExperimentalSettings(const ExperimentalSettings& exp) override;
+
+      void consumeSpectrum(SpectrumType& s) override;
+
+      void consumeChromatogram(ChromatogramType& c) override;
+
+      /// Merges all open blocks and passes all remaining spectra on to the next consumer
+      void flush();
+
+    protected:
+      /// A spectrum waiting to be passed on (the merged spectrum of a block is not ready before the block is closed)
+      struct PendingSpectrum_
+      {
+        SpectrumType spectrum;
+        bool ready;
+        bool discard; ///< merged blocks without peaks are not passed on
+      };
+
+      /// An open block: its spectra and its position in the output
+      struct OpenBlock_
+      {
+        std::vector<SpectrumType> spectra;
+        Size position;
+      };
+
+      /// Merges the open block of MS level @p ms_level
+      void closeBlock_(UInt ms_level);
+
+      /// Passes on all ready spectra at the front of the queue
+      void flushReady_();
+
+      Interfaces::IMSDataConsumer* next_consumer_;
+      std::vector<Int> ms_levels_;
+      Size rt_block_size_;
+      double rt_max_length_;
+      double mz_binning_width_;
+      bool ppm_;
+
+      std::deque<PendingSpectrum_> pending_;
+      /// Number of spectra already removed from the front of pending_
+      Size pending_offset_;
+      std::map<UInt, OpenBlock_> open_blocks_;
+
+    private:
+      /// do not allow copy
+      MSDataBlockMergingConsumer(const MSDataBlockMergingConsumer&);
+      /// do not allow assignment
+      MSDataBlockMergingConsumer& operator=(const MSDataBlockMergingConsumer&);
+    };
+
+} //end namespace OpenMS
+
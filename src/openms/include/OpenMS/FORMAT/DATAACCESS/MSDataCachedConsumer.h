@@ -76,10 +76,24 @@ namespace OpenMS
       */
       MSDataCachedConsumer(const String& filename, bool clearData=true);
 
+      /**
+        @brief Constructor
+
+        Opens the output file and writes the header using the given storage
+        options (file format version, compression).
+
+        @param filename The output file name to which data is written
+        @param options The options used for writing the data
+        @param clearData Whether to clear the spectral and chromatogram data
+        after writing (only keep meta-data)
+      */
+      MSDataCachedConsumer(const String& filename, const StorageOptions& options, bool clearData=true);
+
       /**
         @brief Destructor
 
-        Closes the output file and writes the footer.
+        Closes the output file and writes the footer (including the offset
+        table of all spectra and chromatograms for version 2 files).
       */
       ~MSDataCachedConsumer() override;
 
@@ -0,0 +1,162 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2018.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: Hannes Roest $
+// $Authors: Hannes Roest $
+// --------------------------------------------------------------------------
+
+
+#pragma once
+
+#include <OpenMS/INTERFACES/IMSDataConsumer.h>
+
+#include <OpenMS/KERNEL/StandardTypes.h>
+#include <OpenMS/KERNEL/MSSpectrum.h>
+#include <OpenMS/KERNEL/MSChromatogram.h>
+
+#include <functional>
+#include <vector>
+
+namespace OpenMS
+{
+
+    /**
+      @brief Transforming consumer of MS data which processes batches of spectra in parallel
+
+      Works like MSDataTransformingConsumer, but the spectra (and chromatograms)
+      are collected in batches, the batch is transformed in parallel (using
+      OpenMP) and the transformed spectra are then passed on to the next
+      consumer in their original order. This allows for example to pick the
+      peaks of a file on all cores while it is read, and to write the result
+      through an MSDataWritingConsumer without keeping either file in memory:
+
+      @code
+      PlainMSDataWritingConsumer writer(out);
+      MSDataParallelTransformingConsumer picking_consumer(&writer);
+      picking_consumer.setSpectraProcessingFunc([&pp](MSSpectrum& s)
+        {
+          MSSpectrum picked;
+          pp.pick(s, picked);
+          s = picked;
+        });
+      MzMLFile().transform(in, &picking_consumer);
+      picking_consumer.flush();
+      @endcode
+
+      Memory usage is bounded by the batch size (number of spectra held at the
+      same time). Experimental settings and the expected size are passed on
+      to the next consumer directly.
+
+      @note The processing functions are called concurrently from several
+      threads and need to be thread-safe.
+
+      @note Call flush() after the last spectrum to pass on remaining data (and
+      to receive exceptions thrown during processing). The destructor flushes
+      as well, but can only report errors to the log.
+    */
+    class OPENMS_DLLAPI MSDataParallelTransformingConsumer :
+      public Interfaces::IMSDataConsumer
+    {
+
+    public:
+
+      /**
+        @brief Constructor
+
+        @param next_consumer Consumer which receives the transformed data
+        @param batch_size Number of spectra (or chromatograms) which are collected before they are transformed (0 = 16 per thread)
+
+        @note This does not transfer ownership of the consumer
+      */
+      MSDataParallelTransformingConsumer(Interfaces::IMSDataConsumer* next_consumer, Size batch_size = 0);
+
+      /**
+        @brief Destructor
+
+        Flushes data to next consumer
+
+        @note It is essential to not delete the underlying next_consumer before
+        deleting this object, otherwise we risk a memory error
+      */
+      ~MSDataParallelTransformingConsumer() override;
+
+      void setExpectedSize(Size expectedSpectra, Size expectedChromatograms) override;
+
+      void setExperimentalSettings(const ExperimentalSettings& exp) override;
+
+      void consumeSpectrum(SpectrumType& s) override;
+
+      void consumeChromatogram(ChromatogramType& c) override;
+
+      /**
+        @brief Sets the function to be called for every spectrum
+
+        Pass a nullptr if the spectrum should be left unchanged.
+      */
+      void setSpectraProcessingFunc(std::function<void (SpectrumType&)> f_spec);
+
+      /**
+        @brief Sets the function to be called for every chromatogram
+
+        Pass a nullptr if the chromatogram should be left unchanged.
+      */
+      void setChromatogramProcessingFunc(std::function<void (ChromatogramType&)> f_chrom);
+
+      /**
+        @brief Transforms all collected data and passes it on to the next consumer
+
+        If a processing function throws an exception, the (first) exception
+        is re-thrown here and the current batch is discarded.
+      */
+      void flush();
+
+      /// Returns the batch size
+      Size getBatchSize() const;
+
+    protected:
+      void flushSpectra_();
+      void flushChromatograms_();
+
+      Interfaces::IMSDataConsumer* next_consumer_;
+      Size batch_size_;
+      std::function<void (SpectrumType&)> lambda_spec_;
+      std::function<void (ChromatogramType&)> lambda_chrom_;
+      std::vector<SpectrumType> spectra_;
+      std::vector<ChromatogramType> chromatograms_;
+
+    private:
+      /// do not allow copy
+      MSDataParallelTransformingConsumer(const MSDataParallelTransformingConsumer&);
+      /// do not allow assignment
+      MSDataParallelTransformingConsumer& operator=(const MSDataParallelTransformingConsumer&);
+    };
+
+} //end namespace OpenMS
+
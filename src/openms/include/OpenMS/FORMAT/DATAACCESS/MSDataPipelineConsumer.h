@@ -0,0 +1,164 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2018.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: Hannes Roest $
+// $Authors: Hannes Roest $
+// --------------------------------------------------------------------------
+
+#pragma once
+
+#include <OpenMS/INTERFACES/IMSDataConsumer.h>
+
+#include <OpenMS/KERNEL/StandardTypes.h>
+#include <OpenMS/KERNEL/MSSpectrum.h>
+#include <OpenMS/KERNEL/MSChromatogram.h>
+
+#include <vector>
+
+namespace OpenMS
+{
+
+    /**
+      @brief Consumer which passes MS data through a pipeline of stages, some of which may run in parallel
+
+      Works like MSDataChainingConsumer (every stage receives the data in the
+      order the stages were appended, after the previous stage modified it),
+      but each stage is marked as either parallel-safe or sequential. Spectra
+      (and chromatograms) are collected in bounded batches; each batch is
+      passed through the stages in order, where runs of consecutive
+      parallel-safe stages are applied to the spectra of the batch
+      concurrently (using OpenMP) and sequential stages receive the spectra
+      one by one in their original order. A typical pipeline transforms the
+      data in parallel and writes it sequentially:
+
+      @code
+      PlainMSDataWritingConsumer writer(out);
+      MSDataTransformingConsumer picker;
+      picker.setSpectraProcessingFunc([&pp](MSSpectrum& s)
+        {
+          MSSpectrum picked;
+          pp.pick(s, picked);
+          s = picked;
+        });
+
+      MSDataPipelineConsumer pipeline;
+      pipeline.appendStage(&picker, true);
+      pipeline.appendStage(&writer, false);
+      MzMLFile().transform(in, &pipeline);
+      pipeline.flush();
+      @endcode
+
+      Memory usage is bounded by the batch size (number of spectra held at the
+      same time). Experimental settings and the expected size are passed on
+      to all stages directly.
+
+      @note consumeSpectrum()/consumeChromatogram() of a parallel-safe stage
+      are called concurrently from several threads. Only mark consumers as
+      parallel-safe that do not modify shared state (such as
+      MSDataTransformingConsumer with a thread-safe function).
+
+      @note Call flush() after the last spectrum to pass on remaining data (and
+      to receive exceptions thrown by parallel stages). The destructor flushes
+      as well, but can only report errors to the log.
+    */
+    class OPENMS_DLLAPI MSDataPipelineConsumer :
+      public Interfaces::IMSDataConsumer
+    {
+
+    public:
+
+      /**
+        @brief Constructor
+
+        @param batch_size Number of spectra (or chromatograms) which are collected before they are passed through the stages (0 = 16 per thread)
+      */
+      MSDataPipelineConsumer(Size batch_size = 0);
+
+      /**
+        @brief Destructor
+
+        Flushes data to the stages
+
+        @note It is essential to not delete the stages before deleting this
+        object, otherwise we risk a memory error
+      */
+      ~MSDataPipelineConsumer() override;
+
+      /**
+        @brief Append a stage to the end of the pipeline
+
+        @param consumer The stage
+        @param parallel_safe Whether the stage may consume several spectra (chromatograms) concurrently
+
+        @note This does not transfer ownership of the consumer
+      */
+      void appendStage(Interfaces::IMSDataConsumer* consumer, bool parallel_safe);
+
+      /// Returns the number of stages
+      Size getNumberOfStages() const;
+
+      void setExpectedSize(Size expectedSpectra, Size expectedChromatograms) override;
+
+      void setExperimentalSettings(const ExperimentalSettings& exp) override;
+
+      void consumeSpectrum(SpectrumType& s) override;
+
+      void consumeChromatogram(ChromatogramType& c) override;
+
+      /**
+        @brief Passes all collected data through the pipeline
+
+        If a parallel stage throws an exception, the (first) exception is
+        re-thrown here and the current batch is discarded.
+      */
+      void flush();
+
+      /// Returns the batch size
+      Size getBatchSize() const;
+
+    protected:
+      void flushSpectra_();
+      void flushChromatograms_();
+
+      Size batch_size_;
+      std::vector<Interfaces::IMSDataConsumer*> stages_;
+      std::vector<bool> parallel_safe_;
+      std::vector<SpectrumType> spectra_;
+      std::vector<ChromatogramType> chromatograms_;
+
+    private:
+      /// do not allow copy
+      MSDataPipelineConsumer(const MSDataPipelineConsumer&);
+      /// do not allow assignment
+      MSDataPipelineConsumer& operator=(const MSDataPipelineConsumer&);
+    };
+
+} //end namespace OpenMS
+
@@ -84,6 +84,11 @@ namespace OpenMS
       inconsistent mzML if the count attribute of spectrumList or
       chromatogramList is incorrect.
 
+      @note Spectra and chromatograms are collected into batches (see
+      PeakFileOptions::setMaxDataPoolSize) which are encoded in parallel and
+      written in the order they were consumed. The file is complete only
+      after the consumer has been destroyed.
+
     */
     class OPENMS_DLLAPI MSDataWritingConsumer : 
       public Internal::MzMLHandler,
@@ -188,6 +193,12 @@ namespace OpenMS
       virtual void processChromatogram_(ChromatogramType & c) = 0;
       //@}
 
+      /// Write all spectra waiting in pending_spectra_
+      void flushSpectra_();
+
+      /// Write all chromatograms waiting in pending_chromatograms_
+      void flushChromatograms_();
+
       /**
         @brief Cleanup function called by the destructor.
 
@@ -206,9 +217,9 @@ namespace OpenMS
       bool writing_spectra_;
       /// Stores whether we are currently writing chromatograms
       bool writing_chromatograms_;
-      /// Number of spectra written
+      /// Number of spectra written (including the ones waiting to be written)
       Size spectra_written_;
-      /// Number of chromatograms written
+      /// Number of chromatograms written (including the ones waiting to be written)
       Size chromatograms_written_;
       /// Number of spectra expected
       Size spectra_expected_;
@@ -226,6 +237,10 @@ namespace OpenMS
       std::vector<std::vector< ConstDataProcessingPtr > > dps_;
       /// The dataprocessing to be added to each spectrum/chromatogram
       DataProcessingPtr additional_dataprocessing_;
+      /// Spectra consumed but not yet written (written as one batch)
+      std::vector<SpectrumType> pending_spectra_;
+      /// Chromatograms consumed but not yet written (written as one batch)
+      std::vector<ChromatogramType> pending_chromatograms_;
     };
 
     /**
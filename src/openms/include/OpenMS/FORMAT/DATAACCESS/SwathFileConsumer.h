@@ -41,6 +41,7 @@
 #include <OpenMS/OPENSWATHALGO/DATAACCESS/SwathMap.h>
 
 // Consumers
+#include <OpenMS/FORMAT/DATAACCESS/MSDataAsyncConsumer.h>
 #include <OpenMS/FORMAT/DATAACCESS/MSDataCachedConsumer.h>
 #include <OpenMS/FORMAT/DATAACCESS/MSDataWritingConsumer.h>
 #include <OpenMS/FORMAT/DATAACCESS/MSDataTransformingConsumer.h>
@@ -542,6 +543,12 @@ protected:
    * map) objects of MSDataCachedConsumer which can consume the spectra and
    * write them to disk immediately.
    *
+   * By default, each output file is written by its own writer thread (see
+   * MSDataAsyncConsumer), so that the encoding and writing of all files
+   * proceeds in parallel while the input is read. The available OpenMP
+   * threads are split among the writers. The content of the files does not
+   * depend on this setting.
+   *
    * Warning: no swathmaps (MS1 nor MS2) will be available when calling retrieveSwathMaps()
    *          for downstream use.
    *
@@ -558,6 +565,9 @@ public:
     MzMLSwathFileConsumer(const String& cachedir, const String& basename, Size nr_ms1_spectra, const std::vector<int>& nr_ms2_spectra) :
       ms1_consumer_(nullptr),
       swath_consumers_(),
+      ms1_writer_(nullptr),
+      swath_writers_(),
+      parallel_writing_(true),
       cachedir_(cachedir),
       basename_(basename),
       nr_ms1_spectra_(nr_ms1_spectra),
@@ -569,6 +579,9 @@ public:
       FullSwathFileConsumer(known_window_boundaries),
       ms1_consumer_(nullptr),
       swath_consumers_(),
+      ms1_writer_(nullptr),
+      swath_writers_(),
+      parallel_writing_(true),
       cachedir_(cachedir),
       basename_(basename),
       nr_ms1_spectra_(nr_ms1_spectra),
@@ -580,10 +593,31 @@ public:
       deleteSetNull_();
     }
 
+    /**
+      @brief Whether each output file is written by its own thread (default: true)
+
+      Has to be set before the first spectrum is consumed.
+    */
+    void setParallelWriting(bool parallel_writing)
+    {
+      parallel_writing_ = parallel_writing;
+    }
+
 protected:
 
     void deleteSetNull_()
     {
+      // stop the writer threads first (writes all queued data)
+      while (!swath_writers_.empty())
+      {
+        delete swath_writers_.back();
+        swath_writers_.pop_back();
+      }
+      if (ms1_writer_ != nullptr)
+      {
+        delete ms1_writer_;
+        ms1_writer_ = nullptr;
+      }
       // Properly delete the MSDataCachedConsumer -> free memory and _close_ file stream
       while (!swath_consumers_.empty())
       {
@@ -604,6 +638,20 @@ protected:
       consumer->getOptions().setCompression(true);
       consumer->setExpectedSize(nr_ms2_spectra_[swath_consumers_.size()], 0);
       swath_consumers_.push_back(consumer);
+      if (parallel_writing_)
+      {
+        swath_writers_.push_back(new MSDataAsyncConsumer(consumer, 0, writerThreads_()));
+      }
+    }
+
+    /// OpenMP threads available to each writer thread (one writer per SWATH and one for MS1)
+    int writerThreads_() const
+    {
+#ifdef _OPENMP
+      return std::max(1, omp_get_max_threads() / (int)(nr_ms2_spectra_.size() + 1));
+#else
+      return 1;
+#endif
     }
 
     void consumeSwathSpectrum_(MapType::SpectrumType& s, size_t swath_nr) override
@@ -613,7 +661,14 @@ protected:
       {
         addNewSwathMap_();
       }
-      swath_consumers_[swath_nr]->consumeSpectrum(s);
+      if (parallel_writing_)
+      {
+        swath_writers_[swath_nr]->consumeSpectrum(s);
+      }
+      else
+      {
+        swath_consumers_[swath_nr]->consumeSpectrum(s);
+      }
       s.clear(false);
     }
 
@@ -623,6 +678,10 @@ protected:
       ms1_consumer_ = new PlainMSDataWritingConsumer(mzml_file);
       ms1_consumer_->setExpectedSize(nr_ms1_spectra_, 0);
       ms1_consumer_->getOptions().setCompression(true);
+      if (parallel_writing_)
+      {
+        ms1_writer_ = new MSDataAsyncConsumer(ms1_consumer_, 0, writerThreads_());
+      }
     }
 
     void consumeMS1Spectrum_(MapType::SpectrumType& s) override
@@ -631,17 +690,38 @@ protected:
       {
         addMS1Map_();
       }
-      ms1_consumer_->consumeSpectrum(s);
+      if (parallel_writing_)
+      {
+        ms1_writer_->consumeSpectrum(s);
+      }
+      else
+      {
+        ms1_consumer_->consumeSpectrum(s);
+      }
     }
 
     void ensureMapsAreFilled_() override
     {
+      // wait for the writer threads and report their errors
+      for (Size i = 0; i < swath_writers_.size(); ++i)
+      {
+        swath_writers_[i]->flush();
+      }
+      if (ms1_writer_ != nullptr)
+      {
+        ms1_writer_->flush();
+      }
       deleteSetNull_();
     }
 
     PlainMSDataWritingConsumer* ms1_consumer_;
     std::vector<PlainMSDataWritingConsumer*> swath_consumers_;
 
+    /// writer threads of ms1_consumer_ and swath_consumers_ (if parallel_writing_ is set)
+    MSDataAsyncConsumer* ms1_writer_;
+    std::vector<MSDataAsyncConsumer*> swath_writers_;
+    bool parallel_writing_;
+
     String cachedir_;
     String basename_;
     int nr_ms1_spectra_;
@@ -5,8 +5,12 @@ set(directory include/OpenMS/FORMAT/DATAACCESS)
 set(sources_list_h
   CsiFingerIdMzTabWriter.h
   MSDataAggregatingConsumer.h
+  MSDataAsyncConsumer.h
+  MSDataBlockMergingConsumer.h
   MSDataCachedConsumer.h
   MSDataChainingConsumer.h
+  MSDataParallelTransformingConsumer.h
+  MSDataPipelineConsumer.h
   MSDataStoringConsumer.h
   MSDataSqlConsumer.h
   MSDataTransformingConsumer.h
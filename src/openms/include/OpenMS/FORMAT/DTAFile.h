@@ -92,6 +92,7 @@ public:
       // temporary variables
       String line;
       std::vector<String> strings(2);
+      std::vector<StringView> peak_fields; // views into 'line', re-used for all peaks
       typename SpectrumType::PeakType p;
       char delimiter;
 
@@ -158,16 +159,16 @@ public:
           delimiter = ' ';
         }
 
-        line.split(delimiter, strings);
-        if (strings.size() != 2)
+        StringView(line).split(delimiter, peak_fields);
+        if (peak_fields.size() != 2)
         {
-          throw Exception::ParseError(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, std::string("Bad data line (" + String(line_number) + "): \"") + line + "\" (got  " + String(strings.size()) + ", expected 2 entries)", filename);
+          throw Exception::ParseError(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, std::string("Bad data line (" + String(line_number) + "): \"") + line + "\" (got  " + String(peak_fields.size()) + ", expected 2 entries)", filename);
         }
         try
         {
           //fill peak
-          p.setPosition((typename SpectrumType::PeakType::PositionType)strings[0].toDouble());
-          p.setIntensity((typename SpectrumType::PeakType::IntensityType)strings[1].toDouble());
+          p.setPosition((typename SpectrumType::PeakType::PositionType)peak_fields[0].toDouble());
+          p.setIntensity((typename SpectrumType::PeakType::IntensityType)peak_fields[1].toDouble());
         }
         catch (Exception::BaseException & /*e*/)
         {
@@ -187,6 +187,16 @@ public:
     */
     void writeNext(const FASTAEntry& protein);
 
+    /**
+    @brief Stores all entries of @p proteins (in order). Call writeStart() once before.
+
+    The entries are formatted in parallel blocks (if OpenMP is enabled) and written in order,
+    the output is identical to calling writeNext() for each entry.
+
+    @exception Exception::UnableToCreateFile is thrown if the process is not able to write the file.
+    */
+    void writeNext(const std::vector<FASTAEntry>& proteins);
+
     /**
     @brief Closes the file (flush). Called implicitly when FASTAFile object does out of scope.
 
@@ -214,6 +224,9 @@ public:
     void static store(const String& filename, const std::vector<FASTAEntry>& data);
 
 protected:
+    /// formats a single entry (header line and sequence in lines of 80 characters)
+    static void writeEntry_(std::ostream& os, const FASTAEntry& protein);
+
     std::fstream infile_;   ///< filestream for reading; init using FastaFile::readStart()
     std::ofstream outfile_; ///< filestream for writing; init using FastaFile::writeStart()
     std::unique_ptr<void, std::function<void(void*) > > reader_; ///< filestream for reading; init using FastaFile::readStart(); needs to be a pointer, since its not copy-constructable; we use void* here, to avoid pulling in seqan includes
@@ -0,0 +1,172 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2018.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: Timo Sachsenberg $
+// $Authors: Timo Sachsenberg $
+// --------------------------------------------------------------------------
+
+#pragma once
+
+#include <OpenMS/FORMAT/FASTAFile.h>
+
+#include <unordered_map>
+#include <vector>
+
+namespace OpenMS
+{
+  /**
+    @brief Offset index of a FASTA file for random and parallel access
+
+    The index stores one line per sequence in the format of samtools faidx
+    (".fai" files): the name (identifier) of the sequence, its length, the
+    byte offset of its first residue and the number of residues and bytes per
+    line. Index files written by samtools can be read and vice versa.
+
+    With an index, single entries can be read by identifier in constant time
+    (getEntry()) and ranges of entries can be read in parallel (getEntries()),
+    every thread using its own file stream.
+
+    Like samtools, the index requires that all sequence lines of an entry
+    (except the last one) have the same length.
+
+    Sample usage:
+
+    @code
+      FASTAIndex index;
+      index.open("db.fasta"); // builds and stores "db.fasta.fai" on first use
+      FASTAFile::FASTAEntry entry;
+      if (index.getEntry("sp|P02769|ALBU_BOVIN", entry)) { ... }
+    @endcode
+  */
+  class OPENMS_DLLAPI FASTAIndex
+  {
+public:
+    /// Index record of a single sequence (one line of a .fai file)
+    struct Entry
+    {
+      String name; ///< identifier of the sequence (the header up to the first whitespace)
+      Size length; ///< number of residues
+      Size offset; ///< byte offset of the first residue in the FASTA file
+      Size line_bases; ///< number of residues per line
+      Size line_width; ///< number of bytes per line (including the line break)
+    };
+
+    /// Default constructor
+    FASTAIndex();
+
+    /**
+      @brief Opens the index of @p fasta_file
+
+      An existing index file "<fasta_file>.fai" is used if it is not older
+      than the FASTA file, otherwise the index is built from the FASTA file
+      and (if @p store_index is set) written to "<fasta_file>.fai". Failing
+      to write the index file (e.g. in read-only directories) is not an error.
+
+      @exception Exception::FileNotFound is thrown if the FASTA file does not exist
+      @exception Exception::ParseError is thrown if the FASTA file cannot be indexed
+    */
+    void open(const String& fasta_file, bool store_index = true);
+
+    /**
+      @brief Builds the index by reading @p fasta_file once
+
+      @exception Exception::FileNotFound is thrown if the file does not exist
+      @exception Exception::ParseError is thrown if the sequence lines of an entry have different lengths
+    */
+    void build(const String& fasta_file);
+
+    /**
+      @brief Reads the index of @p fasta_file from @p index_file
+
+      @exception Exception::FileNotFound is thrown if the index file does not exist
+      @exception Exception::ParseError is thrown if the index file is malformed
+    */
+    void load(const String& index_file, const String& fasta_file);
+
+    /**
+      @brief Writes the index to @p index_file
+
+      @exception Exception::UnableToCreateFile is thrown if the file cannot be written
+    */
+    void store(const String& index_file) const;
+
+    /// Number of indexed sequences
+    Size size() const;
+
+    /// The index records in file order
+    const std::vector<Entry>& getIndexEntries() const;
+
+    /// Index of the sequence with identifier @p name (-1 if not found, the first one for duplicate names)
+    SignedSize find(const String& name) const;
+
+    /**
+      @brief Reads the entry with identifier @p name from the FASTA file
+
+      @return false if the identifier is not part of the index
+      @exception Exception::ParseError is thrown if the index does not match the FASTA file
+    */
+    bool getEntry(const String& name, FASTAFile::FASTAEntry& entry) const;
+
+    /**
+      @brief Reads the entry at position @p index from the FASTA file
+
+      @exception Exception::IndexOverflow is thrown if @p index is not smaller than size()
+      @exception Exception::ParseError is thrown if the index does not match the FASTA file
+    */
+    void getEntry(Size index, FASTAFile::FASTAEntry& entry) const;
+
+    /**
+      @brief Reads the entries at positions [@p first, @p last) from the FASTA file
+
+      Entries are read in parallel if OpenMP is enabled, every thread with its
+      own file stream. The order of @p entries is the order in the file.
+
+      @exception Exception::IndexOverflow is thrown if @p last is larger than size()
+      @exception Exception::ParseError is thrown if the index does not match the FASTA file
+    */
+    void getEntries(Size first, Size last, std::vector<FASTAFile::FASTAEntry>& entries) const;
+
+protected:
+    /// Reads the entry described by @p record from @p is
+    void readEntry_(std::ifstream& is, const Entry& record, FASTAFile::FASTAEntry& entry) const;
+
+    /// Builds the identifier lookup table from entries_
+    void updateLookup_();
+
+    /// The indexed FASTA file
+    String fasta_file_;
+    /// Index records in file order
+    std::vector<Entry> entries_;
+    /// Identifier to position in entries_
+    std::unordered_map<std::string, Size> lookup_;
+  };
+
+} // namespace OpenMS
+
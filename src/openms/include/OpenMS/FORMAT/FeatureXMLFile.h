@@ -94,6 +94,9 @@ public:
     /**
         @brief stores the map @p feature_map in file with name @p filename.
 
+        Features are formatted in batches (in parallel if OpenMP is enabled)
+        and written in their original order.
+
         @exception Exception::UnableToCreateFile is thrown if the file could not be created
     */
     void store(const String& filename, const FeatureMap& feature_map);
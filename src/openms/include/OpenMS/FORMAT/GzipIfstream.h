@@ -38,10 +38,19 @@
 
 #include <zlib.h>
 
+#include <cstdio>
+#include <string>
+
 namespace OpenMS
 {
 /**
     @brief Decompresses files which are compressed in the gzip format (*.gzip)
+
+    Files in the blocked gzip format (BGZF, as written by bgzip or htslib)
+    consist of many independent gzip members of at most 64 kB. Such files are
+    detected when opening and their blocks are decompressed in batches, in
+    parallel if OpenMP is enabled. All other files are decompressed
+    sequentially using zlib.
 */
   class OPENMS_DLLAPI GzipIfstream
   {
@@ -95,6 +104,11 @@ public:
     */
     void close();
 
+    /**
+      * @brief returns whether the open file is in the blocked gzip format (BGZF) and decompressed in parallel
+    */
+    bool isBlockCompressed() const;
+
     /*
         @brief updates crc32 check sum whether the buffer is corrupted
         @note if this function is used it has to be called after every call of function read
@@ -124,6 +138,23 @@ protected:
     ///true if end of file is reached
     bool stream_at_end_;
 
+    ///file handle used when reading a BGZF file (instead of gzfile_)
+    std::FILE * bgzf_file_;
+    ///decompressed data of the current batch of BGZF blocks
+    std::string bgzf_buffer_;
+    ///read position in bgzf_buffer_
+    size_t bgzf_pos_;
+    ///true if all BGZF blocks were read from bgzf_file_
+    bool bgzf_file_end_;
+
+    /**
+      * @brief reads and decompresses the next batch of BGZF blocks into bgzf_buffer_
+      *
+      * @return false if no more blocks are available
+      * @exception Exception::ConversionError is thrown if a block is corrupted
+    */
+    bool fillBlockBuffer_();
+
     //needed if one wants to know whether file is okay
     //unsigned long original_crc;
     //needed if one wants to know whether file is okay
@@ -136,7 +167,12 @@ protected:
 
   inline bool GzipIfstream::isOpen() const
   {
-    return gzfile_ != nullptr;
+    return gzfile_ != nullptr || bgzf_file_ != nullptr;
+  }
+
+  inline bool GzipIfstream::isBlockCompressed() const
+  {
+    return bgzf_file_ != nullptr;
   }
 
   inline bool GzipIfstream::streamEnd() const
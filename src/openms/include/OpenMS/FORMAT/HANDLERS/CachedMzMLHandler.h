@@ -44,9 +44,13 @@
 #include <OpenMS/KERNEL/StandardTypes.h>
 #include <OpenMS/CONCEPT/ProgressLogger.h>
 
+#include <OpenMS/FORMAT/MSNumpressCoder.h>
+
 #include <fstream>
+#include <limits>
 
 #define CACHED_MZML_FILE_IDENTIFIER 8094
+#define CACHED_MZML_VERSIONED_FILE_IDENTIFIER 8095
 
 namespace OpenMS
 {
@@ -62,6 +66,25 @@ namespace Internal
     be very fast and done in random order (once the in-memory index is built
     for the file).
 
+    Two file layouts are supported for reading, the layout to write is chosen
+    through the StorageOptions:
+
+    - Version 1 (legacy): identifier CACHED_MZML_FILE_IDENTIFIER, all data
+      stored as raw doubles, the number of spectra and chromatograms at the end
+      of the file. Building the index requires a linear scan of the file.
+    - Version 2: identifier CACHED_MZML_VERSIONED_FILE_IDENTIFIER followed by
+      the format version. Each spectrum and chromatogram is a self-contained
+      block starting with CACHED_MZML_V2_BLOCK_MARKER in which every data
+      array carries its own encoding (double, float, numpress) and optional
+      zlib compression. The file ends with a table of all block offsets,
+      followed by the offset of that table and the number of spectra and
+      chromatograms, thus the index is loaded from the footer without
+      scanning the file.
+
+    The readers (readSpectrumFast, readChromatogramFast etc.) detect the
+    block layout automatically. Readers which only know version 1 fail with
+    a parse error on version 2 files instead of returning wrong data.
+
   */
   class OPENMS_DLLAPI CachedMzMLHandler :
     public ProgressLogger
@@ -80,6 +103,45 @@ public:
 
     typedef std::vector<DatumSingleton> Datavector;
 
+    /// Marker at the start of each spectrum and chromatogram block in the version 2 format (an invalid size for version 1 readers)
+    static const Size CACHED_MZML_V2_BLOCK_MARKER = std::numeric_limits<Size>::max();
+
+    /// Encoding of a single data array in the version 2 format
+    enum ArrayEncoding
+    {
+      ENCODING_DOUBLE, ///< raw 64 bit floating point values
+      ENCODING_FLOAT, ///< raw 32 bit floating point values
+      ENCODING_NUMPRESS_LINEAR, ///< MS-Numpress linear prediction compression
+      ENCODING_NUMPRESS_PIC, ///< MS-Numpress positive integer compression
+      ENCODING_NUMPRESS_SLOF, ///< MS-Numpress short logged float compression
+      SIZE_OF_ARRAYENCODING
+    };
+
+    /**
+      @brief Options for writing cached files
+
+      By default, the version 2 format is written where m/z and RT are stored
+      as doubles and spectrum intensities as floats (which is lossless since
+      peak intensities are single precision). Numpress and zlib compression
+      reduce the file size further at the cost of CPU time (numpress linear
+      and slof are lossy within the configured error tolerance).
+    */
+    struct OPENMS_DLLAPI StorageOptions
+    {
+      int format_version; ///< file format version to write (1 or 2)
+      bool zlib_compression; ///< apply zlib compression to each data array (version 2 only)
+      MSNumpressCoder::NumpressConfig np_config_mass_time; ///< numpress compression of m/z and RT arrays (version 2 only)
+      MSNumpressCoder::NumpressConfig np_config_intensity; ///< numpress compression of intensity arrays (version 2 only)
+
+      StorageOptions() :
+        format_version(2),
+        zlib_compression(false),
+        np_config_mass_time(),
+        np_config_intensity()
+      {
+      }
+    };
+
     /** @name Constructors and Destructor
     */
     //@{
@@ -93,11 +155,17 @@ public:
     CachedMzMLHandler& operator=(const CachedMzMLHandler& rhs);
     //@}
 
+    /// Set the options used for writing cached files
+    void setStorageOptions(const StorageOptions& options);
+
+    /// Get the options used for writing cached files
+    const StorageOptions& getStorageOptions() const;
+
     /** @name Read / Write a complete mass spectrometric experiment (or its meta data)
     */
     //@{
 
-    /// Write complete spectra as a dump to the disk
+    /// Write complete spectra as a dump to the disk (in the format given by the StorageOptions)
     void writeMemdump(const MapType& exp, const String& out) const;
 
     /// Write only the meta data of an MSExperiment
@@ -113,7 +181,15 @@ public:
     /** @name Access and creation of the binary indices
     */
     //@{
-    /// Create an index on the location of all the spectra and chromatograms
+    /**
+      @brief Create an index on the location of all the spectra and chromatograms
+
+      For version 2 files the index is read from the footer, for version 1
+      files the whole file is scanned.
+
+      @exception Exception::FileNotFound is thrown if the file could not be opened
+      @exception Exception::ParseError is thrown if the file is not a (supported) cached file
+    */
     void createMemdumpIndex(String filename);
 
     /// Access to a constant copy of the binary spectra index
@@ -183,6 +259,32 @@ public:
       @throws Exception::ParseError is thrown if the chromatogram size cannot be read
     */
     static std::vector<OpenSwath::BinaryDataArrayPtr> readChromatogramFast(std::ifstream& ifs);
+
+    /**
+      @brief Fast access to a spectrum in memory (e.g. a memory-mapped cached file)
+
+      Same as readSpectrumFast(std::ifstream&, int&, double&) but reads from a
+      memory buffer, which requires no system calls and no file pointer, thus
+      different spectra can be read concurrently from the same buffer.
+
+      @param buffer Start of the spectrum in memory (file start plus the offset from getSpectraIndex())
+      @param buffer_size Number of bytes available from @p buffer onwards
+      @param ms_level Output parameter to store the MS level of the spectrum (1, 2, 3 ...)
+      @param rt Output parameter to store the retention time of the spectrum
+
+      @throws Exception::ParseError is thrown if the spectrum cannot be read
+    */
+    static std::vector<OpenSwath::BinaryDataArrayPtr> readSpectrumFast(const char* buffer, Size buffer_size, int& ms_level, double& rt);
+
+    /**
+      @brief Fast access to a chromatogram in memory (e.g. a memory-mapped cached file)
+
+      @param buffer Start of the chromatogram in memory (file start plus the offset from getChromatogramIndex())
+      @param buffer_size Number of bytes available from @p buffer onwards
+
+      @throws Exception::ParseError is thrown if the chromatogram cannot be read
+    */
+    static std::vector<OpenSwath::BinaryDataArrayPtr> readChromatogramFast(const char* buffer, Size buffer_size);
     //@}
 
     /**
@@ -205,21 +307,74 @@ public:
     */
     static void readChromatogram(ChromatogramType& chromatogram, std::ifstream& ifs);
 
+    /// Read a single spectrum from memory directly into an OpenMS MSSpectrum (see readSpectrumFast(const char*, Size, int&, double&))
+    static void readSpectrum(SpectrumType& spectrum, const char* buffer, Size buffer_size);
+
+    /// Read a single chromatogram from memory directly into an OpenMS MSChromatogram (see readChromatogramFast(const char*, Size))
+    static void readChromatogram(ChromatogramType& chromatogram, const char* buffer, Size buffer_size);
+
 protected:
 
+    /// fill a spectrum with the arrays read by readSpectrumFast()
+    static void fillSpectrum_(SpectrumType& spectrum, const std::vector<OpenSwath::BinaryDataArrayPtr>& data, int ms_level, double rt);
+
+    /// fill a chromatogram with the arrays read by readChromatogramFast()
+    static void fillChromatogram_(ChromatogramType& chromatogram, const std::vector<OpenSwath::BinaryDataArrayPtr>& data);
+
+    /**
+      @brief read and check the file header, returns its size (the position of the first data block)
+
+      @exception Exception::ParseError is thrown if the file is not a (supported) cached file
+    */
+    static std::streamoff readHeader_(std::ifstream& ifs, const String& filename);
+
+    /// read spectra_index_ and chrom_index_ from the footer of a version 2 file
+    void readIndexV2_(std::ifstream& ifs, const String& filename);
+
+    /// write the file header (identifier and format version) to filestream
+    void writeHeader_(std::ofstream& ofs) const;
+
+    /// write the file footer to filestream (offset table in version 2, number of spectra and chromatograms)
+    void writeFooter_(std::ofstream& ofs, const std::vector<std::streampos>& spectra_index,
+      const std::vector<std::streampos>& chrom_index) const;
+
     /// write a single spectrum to filestream
     void writeSpectrum_(const SpectrumType& spectrum, std::ofstream& ofs) const;
 
     /// write a single chromatogram to filestream
     void writeChromatogram_(const ChromatogramType& chromatogram, std::ofstream& ofs) const;
 
-    /// helper method for fast reading of spectra and chromatograms
-    static inline void readDataFast_(std::ifstream& ifs, std::vector<OpenSwath::BinaryDataArrayPtr>& data, const Size& data_size, 
+    /// write a single spectrum to filestream (version 2 block)
+    void writeSpectrumV2_(const SpectrumType& spectrum, std::ofstream& ofs) const;
+
+    /// write a single chromatogram to filestream (version 2 block)
+    void writeChromatogramV2_(const ChromatogramType& chromatogram, std::ofstream& ofs) const;
+
+    /// write a single data array of a version 2 block (falls back to ENCODING_DOUBLE if numpress encoding fails)
+    void writeArrayV2_(std::ofstream& ofs, const String& name, const std::vector<double>& data,
+      ArrayEncoding encoding, const MSNumpressCoder::NumpressConfig& np_config) const;
+
+    /// reads a spectrum in version 1 or version 2 layout (from a file stream or from memory)
+    template <typename InputStreamType>
+    static std::vector<OpenSwath::BinaryDataArrayPtr> readSpectrumFast_(InputStreamType& ifs, int& ms_level, double& rt);
+
+    /// reads a chromatogram in version 1 or version 2 layout (from a file stream or from memory)
+    template <typename InputStreamType>
+    static std::vector<OpenSwath::BinaryDataArrayPtr> readChromatogramFast_(InputStreamType& ifs);
+
+    /// helper method for fast reading of spectra and chromatograms (from a file stream or from memory)
+    template <typename InputStreamType>
+    static inline void readDataFast_(InputStreamType& ifs, std::vector<OpenSwath::BinaryDataArrayPtr>& data, const Size& data_size, 
       const Size& nr_float_arrays);
 
+    /// helper method for reading the data arrays of a version 2 block (from a file stream or from memory)
+    template <typename InputStreamType>
+    static inline void readDataV2_(InputStreamType& ifs, std::vector<OpenSwath::BinaryDataArrayPtr>& data, const Size& nr_arrays);
+
     /// Members
     std::vector<std::streampos> spectra_index_;
     std::vector<std::streampos> chrom_index_;
+    StorageOptions storage_options_;
 
   };
 }
@@ -39,6 +39,8 @@
 #include <OpenMS/CONCEPT/Exception.h>
 #include <OpenMS/DATASTRUCTURES/String.h>
 
+#include <istream>
+
 namespace OpenMS 
 {
 
@@ -79,6 +81,9 @@ namespace OpenMS
     */
     int parseOffsets(String filename, std::streampos indexoffset, OffsetVector & spectra_offsets, OffsetVector& chromatograms_offsets);
 
+    /// Same as above, reading from a (seekable) input stream, e.g. a RemoteFileStream
+    int parseOffsets(std::istream& in, std::streampos indexoffset, OffsetVector & spectra_offsets, OffsetVector& chromatograms_offsets);
+
     /**
       @brief Tries to extract the indexList offset from an indexedmzML.
 
@@ -106,6 +111,9 @@ namespace OpenMS
     */
     std::streampos findIndexListOffset(String filename, int buffersize = 1023);
 
+    /// Same as above, reading from a (seekable) input stream, e.g. a RemoteFileStream
+    std::streampos findIndexListOffset(std::istream& in, int buffersize = 1023);
+
   protected:
 
     /**
@@ -42,11 +42,25 @@
 #include <OpenMS/KERNEL/MSSpectrum.h>
 #include <OpenMS/KERNEL/MSChromatogram.h>
 
+#include <boost/shared_ptr.hpp>
+
 #include <string>
 #include <fstream>
+#include <mutex>
+
+namespace boost
+{
+  namespace interprocess
+  {
+    class mapped_region;
+  }
+}
 
 namespace OpenMS
 {
+  class ExperimentalSettings;
+  class MSExperiment;
+  class RemoteFile;
 
 namespace Internal
 {
@@ -69,10 +83,18 @@ namespace Internal
     extracting all the offsets of the <chromatogram> and <spectrum> tags. These
     offsets are stored as members of this class as well as the offset to the <indexList> element
 
-    @note This implementation is @a not thread-safe since it keeps internally a
-    single file access pointer which it moves when accessing a specific
-    data item. The caller is responsible to ensure that access is performed
-    atomically.
+    The file is memory-mapped read-only whenever possible, data items are
+    then read with positional access into the mapping and spectra and
+    chromatograms can be retrieved concurrently from multiple threads without
+    any locking. Copies of this object share the same mapping. If the file
+    cannot be mapped (e.g. insufficient address space on 32 bit systems), a
+    single file stream is used and access to it is serialized internally.
+
+    URLs (http:// and https://, e.g. of an object store) are read with HTTP
+    range requests through a RemoteFile: only the footer is read when the
+    file is opened, and each spectrum or chromatogram only fetches the blocks
+    covering its byte range. Use prefetch() to fetch a known set of spectra
+    and chromatograms concurrently before reading them.
 
   */
   class OPENMS_DLLAPI IndexedMzMLHandler
@@ -87,8 +109,22 @@ namespace Internal
       std::streampos index_offset_;
       /// Whether spectra are written before chromatograms in this file
       bool spectra_before_chroms_;
-      /// The current filestream (opened by openFile)
+      /// The current filestream (opened by openFile, only used if the file could not be memory-mapped)
       std::ifstream filestream_;
+      /// Serializes access to filestream_
+      std::mutex filestream_mutex_;
+      /// Read-only memory mapping of the file (shared between copies, empty if not mapped)
+      boost::shared_ptr<boost::interprocess::mapped_region> mapped_region_;
+      /// The remote file if a URL was opened (shared between copies, empty otherwise)
+      boost::shared_ptr<RemoteFile> remote_file_;
+      /// Document up to the start tag of the first list (ends inside of the <run> element, empty if it could not be extracted)
+      std::string xml_prefix_;
+      /// Start tag of the <spectrumList> (with a count of 1)
+      std::string spectrum_list_tag_;
+      /// Start tag of the <chromatogramList> (with a count of 1)
+      std::string chromatogram_list_tag_;
+      /// Closing tags of the document following the lists
+      std::string xml_closing_;
       /// Whether parsing the indexedmzML file was successful
       bool parsing_success_;
       /// Whether to skip XML checks
@@ -104,8 +140,26 @@ namespace Internal
     */
     void parseFooter_(String filename);
 
+    /// Extracts the document prefix and the list start tags needed to parse single spectra and chromatograms with their meta data
+    void parseHeader_();
+
+    /// Returns the start tag of the list @p name preceding the element at @p offset (and its position in @p tag_offset), empty if not found
+    std::string listStartTag_(const std::string& name, std::streampos offset, std::streampos& tag_offset);
+
+    /// Parses the meta data (no peak data) of an mzML @p document (thread-safe)
+    void parseMetaData_(const std::string& document, MSExperiment& exp) const;
+
     std::string getChromatogramById_helper_(int id);
 
+    /// Byte range of the chromatogram at position @p id (which has to be valid)
+    std::pair<std::streampos, std::streampos> getChromatogramRange_(int id) const;
+
+    /// Byte range of the spectrum at position @p id (which has to be valid)
+    std::pair<std::streampos, std::streampos> getSpectrumRange_(int id) const;
+
+    /// Reads the text between the two file positions (thread-safe)
+    std::string readRange_(std::streampos startidx, std::streampos endidx);
+
     std::string getSpectrumById_helper_(int id);
 
     public:
@@ -152,6 +206,21 @@ namespace Internal
     /// Returns the number of chromatograms available
     size_t getNrChromatograms() const;
 
+    /// Whether the file is read from a URL (see RemoteFile)
+    bool isRemote() const;
+
+    /**
+      @brief Fetches the data of the given spectra and chromatograms concurrently
+
+      Only has an effect for remote files (local files are memory-mapped).
+      Ids outside of the valid range are ignored. The data is kept in the
+      cache of the RemoteFile, thus only as much as fits in the cache
+      should be prefetched at once.
+
+      @throw Exception::IOException if the data cannot be fetched
+    */
+    void prefetch(const std::vector<int>& spectra, const std::vector<int>& chromatograms = std::vector<int>());
+
     /**
       @brief Retrieve the raw data for the spectrum at position "id"
 
@@ -183,6 +252,23 @@ namespace Internal
     */
     void getMSSpectrumById(int id, OpenMS::MSSpectrum& s);
 
+    /**
+      @brief Retrieve the spectrum at position "id" including its meta data
+
+      Unlike getMSSpectrumById, which only decodes the data arrays, this
+      also parses the meta data from the XML of the spectrum (RT, MS level,
+      precursors, ...), e.g. if the meta data of the whole file is not
+      available (remote files).
+
+      @throw Exception if getParsingSuccess() returns false
+      @throw Exception if id is not within [0, getNrSpectra()-1]
+      @throw Exception::ParseError if the spectrum cannot be parsed
+
+      @param id The spectrum id
+      @param s The spectrum to be filled with data
+    */
+    void getMSSpectrumWithMetaDataById(int id, OpenMS::MSSpectrum& s);
+
     /**
       @brief Retrieve the raw data for the chromatogram at position "id"
 
@@ -214,6 +300,25 @@ namespace Internal
     */
     void getMSChromatogramById(int id, OpenMS::MSChromatogram& c);
 
+    /**
+      @brief Retrieve the chromatogram at position "id" including its meta data (see getMSSpectrumWithMetaDataById)
+
+      @throw Exception if getParsingSuccess() returns false
+      @throw Exception if id is not within [0, getNrChromatograms()-1]
+      @throw Exception::ParseError if the chromatogram cannot be parsed
+
+      @param id The chromatogram id
+      @param c The chromatogram to be filled with data
+    */
+    void getMSChromatogramWithMetaDataById(int id, OpenMS::MSChromatogram& c);
+
+    /**
+      @brief Parses the experimental settings from the header of the file (everything before the first spectrum or chromatogram)
+
+      @throw Exception::ParseError if the header cannot be parsed
+    */
+    void getExperimentalSettings(ExperimentalSettings& settings) const;
+
     /// Whether to skip some XML checks (removing whitespace from base64 arrays) and be fast instead
     void setSkipXMLChecks(bool skip)
     {
@@ -0,0 +1,194 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2018.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: Timo Sachsenberg $
+// $Authors: Timo Sachsenberg $
+// --------------------------------------------------------------------------
+
+#pragma once
+
+#include <OpenMS/config.h>
+#include <OpenMS/CONCEPT/Types.h>
+#include <OpenMS/DATASTRUCTURES/String.h>
+#include <OpenMS/KERNEL/MSSpectrum.h>
+
+#include <boost/shared_ptr.hpp>
+
+#include <string>
+#include <fstream>
+#include <mutex>
+#include <vector>
+
+namespace boost
+{
+  namespace interprocess
+  {
+    class mapped_region;
+  }
+}
+
+namespace OpenMS
+{
+
+namespace Internal
+{
+
+  /**
+    @brief A low-level class for random access to the scans of an indexed mzXML file.
+
+    This is the mzXML counterpart to IndexedMzMLHandler: the offsets of all
+    <scan> elements are read from the <index> at the end of the file (found
+    through <indexOffset>), scans are then read on demand without parsing the
+    whole file.
+
+    A scan is decoded by the regular MzXMLHandler, together with the file
+    header (everything up to the first scan), so spectra are identical to
+    the ones obtained by MzXMLFile::load (nested scans are returned as
+    individual spectra, as in a full load). When several scans are requested
+    at once using getMSSpectraByIds, their binary data is decoded in parallel.
+
+    The file is memory-mapped read-only whenever possible, otherwise a file
+    stream is used. Copies of this object share the same mapping.
+
+    @note Spectra are accessed by their position in the index (starting at
+    zero), not by their scan number.
+
+    @note Retrieving spectra is not thread-safe (the XML parser is not), use
+    getMSSpectraByIds to decode many spectra in parallel.
+  */
+  class OPENMS_DLLAPI IndexedMzXMLHandler
+  {
+    /// Name of the file
+    String filename_;
+    /// Scan numbers (id attribute of <offset>) and binary offsets of all scans, in index order
+    std::vector< std::pair<std::string, std::streampos> > spectra_offsets_;
+    /// End of the text of each scan (start of the scan following it in the file or the index)
+    std::vector<std::streampos> spectra_ends_;
+    /// offset to the <index> element
+    std::streampos index_offset_;
+    /// File header (up to the first scan) which is prepended to the scans for parsing
+    std::string header_;
+    /// The current filestream (only used if the file could not be memory-mapped)
+    std::ifstream filestream_;
+    /// Serializes access to filestream_
+    std::mutex filestream_mutex_;
+    /// Read-only memory mapping of the file (shared between copies, empty if not mapped)
+    boost::shared_ptr<boost::interprocess::mapped_region> mapped_region_;
+    /// Whether parsing the index was successful
+    bool parsing_success_;
+
+    /**
+      @brief Try to parse the index of the mzXML file
+
+      Upon success, the spectra offsets and the header will be populated and
+      parsing_success_ will be set to true.
+    */
+    void parseIndex_();
+
+    /// Reads the text between the two file positions
+    std::string readRange_(std::streampos startidx, std::streampos endidx);
+
+    /// Returns the text of scan @p id (without nested scans, always closed by </scan>)
+    std::string getScanText_(int id);
+
+    public:
+
+    /// Default constructor
+    IndexedMzXMLHandler();
+
+    /**
+      @brief Constructor
+
+      Tries to parse the file, success can be checked with getParsingSuccess()
+    */
+    explicit IndexedMzXMLHandler(const String& filename);
+
+    /// Copy constructor
+    IndexedMzXMLHandler(const IndexedMzXMLHandler& source);
+
+    /// Destructor
+    ~IndexedMzXMLHandler();
+
+    /**
+      @brief Open a file
+
+      Tries to parse the file, success can be checked with getParsingSuccess()
+
+      @throw FileNotFound is thrown if the file does not exist
+    */
+    void openFile(const String& filename);
+
+    /**
+      @brief Returns whether parsing was successful
+
+      @note It is invalid to call getMSSpectrumById if this function returns false
+
+      @return Whether reading the index was successful (if false, the file
+      most likely has no (valid) index)
+    */
+    bool getParsingSuccess() const;
+
+    /// Returns the number of spectra available
+    size_t getNrSpectra() const;
+
+    /// Returns the scan number of the spectrum at position @p id (as given in the index)
+    const std::string& getScanNumber(int id) const;
+
+    /**
+      @brief Retrieve the spectrum at position @p id
+
+      @throw Exception::ParseError if getParsingSuccess() returns false or the scan cannot be parsed
+      @throw Exception::IllegalArgument if id is not within [0, getNrSpectra()-1]
+    */
+    const MSSpectrum getMSSpectrumById(int id);
+
+    /**
+      @brief Retrieve the spectrum at position @p id
+
+      @throw Exception::ParseError if getParsingSuccess() returns false or the scan cannot be parsed
+      @throw Exception::IllegalArgument if id is not within [0, getNrSpectra()-1]
+    */
+    void getMSSpectrumById(int id, MSSpectrum& s);
+
+    /**
+      @brief Retrieve the spectra at the positions @p ids
+
+      All scans are parsed together and their binary data is decoded in
+      parallel.
+
+      @throw Exception::ParseError if getParsingSuccess() returns false or a scan cannot be parsed
+      @throw Exception::IllegalArgument if an id is not within [0, getNrSpectra()-1]
+    */
+    void getMSSpectraByIds(const std::vector<int>& ids, std::vector<MSSpectrum>& spectra);
+  };
+
+}
+}
+
@@ -63,6 +63,7 @@
 #include <xercesc/util/XMLUni.hpp>
 #include <xercesc//framework/psvi/XSValue.hpp>
 
+#include <functional>
 #include <string>
 #include <stdexcept>
 #include <vector>
@@ -110,6 +111,17 @@ public:
 
       /// Provides the functionality of reading a mzid with a handler object
       void readMzIdentMLFile(const std::string& mzid_file);
+      /**
+        @brief Reads a mzid while converting it, without keeping the spectrum identification results in memory
+
+        Each SpectrumIdentificationResult is converted as soon as it has been
+        parsed and then removed from the DOM tree, so only the search setup and
+        the SequenceCollection (proteins, peptides, peptide evidences) remain in
+        memory. If @p consumer is set, each resulting PeptideIdentification is
+        passed to it (in file order) instead of being appended to the
+        PeptideIdentification vector.
+      */
+      void readMzIdentMLFile(const std::string& mzid_file, const std::function<void(PeptideIdentification&)>& consumer);
       /// Provides the functionality to write a mzid with a handler object
       void writeMzIdentMLFile(const std::string& mzid_file);
 
@@ -153,12 +165,19 @@ protected:
       void parseSpectrumIdentificationProtocolElements_(xercesc::DOMNodeList* spectrumIdentificationProtocolElements);
       void parseInputElements_(xercesc::DOMNodeList* inputElements);
       void parseSpectrumIdentificationListElements_(xercesc::DOMNodeList* spectrumIdentificationListElements);
+      void parseSpectrumIdentificationResultElement_(xercesc::DOMElement* spectrumIdentificationResultElement, const String& spectrumIdentificationList_id);
       void parseSpectrumIdentificationItemSetXLMS(std::set<String>::const_iterator set_it, std::multimap<String, int> xl_val_map, xercesc::DOMElement* element_res, String spectrumID);
       void parseSpectrumIdentificationItemElement_(xercesc::DOMElement* spectrumIdentificationItemElement, PeptideIdentification& spectrum_identification, String& spectrumIdentificationList_ref);
       void parseProteinDetectionHypothesisElement_(xercesc::DOMElement* proteinDetectionHypothesisElement, ProteinIdentification& protein_identification);
       void parseProteinAmbiguityGroupElement_(xercesc::DOMElement* proteinAmbiguityGroupElement, ProteinIdentification& protein_identification);
       void parseProteinDetectionListElements_(xercesc::DOMNodeList* proteinDetectionListElements);
       static ProteinIdentification::SearchParameters findSearchParameters_(std::pair<CVTermList, std::map<String, DataValue> > as_params);
+      /// Checks that @p mzid_file can be read
+      static void checkFile_(const std::string& mzid_file);
+      /// Parses everything in front of the spectrum identification results (software, inputs, protocols, SequenceCollection)
+      void parseSearchSetup_(xercesc::DOMDocument* xmlDoc);
+      /// Parses the ProteinDetectionList and sorts the protein identifications
+      void parseProteinDetection_(xercesc::DOMDocument* xmlDoc);
       //@}
 
       /**@name Helper functions to build a DOM tree from the internal id structures*/
@@ -174,6 +193,9 @@ protected:
 
 
 private:
+      /// DOM parser filter used for reading in streaming mode
+      class SpectrumIdentificationResultFilter_;
+
       MzIdentMLDOMHandler();
       MzIdentMLDOMHandler(const MzIdentMLDOMHandler& rhs);
       MzIdentMLDOMHandler& operator=(const MzIdentMLDOMHandler& rhs);
@@ -49,6 +49,8 @@
 #include <OpenMS/FORMAT/ControlledVocabulary.h>
 #include <OpenMS/FORMAT/VALIDATORS/SemanticValidator.h>
 
+#include <future>
+
 
 //MISSING:
 // - more than one selected ion per precursor (warning if more than one)
@@ -217,19 +219,29 @@ protected:
       /**
           @brief Populate all spectra on the stack with data from input
 
-          Will populate all spectra on the current work stack with data (using
-          multiple threads if available) and append them to the result.
+          Hands the current work stack over to a background decoding stage
+          (which uses multiple threads if available) while the XML parser
+          continues with the next batch. The previously handed-over batch is
+          appended to the result first, thus the order of the output is
+          identical to the order in the file. At most one batch is decoded in
+          the background at any time, which bounds memory consumption to twice
+          PeakFileOptions::getMaxDataPoolSize() spectra.
       */
       void populateSpectraWithData_();
 
       /**
           @brief Populate all chromatograms on the stack with data from input
 
-          Will populate all chromatograms on the current work stack with data (using
-          multiple threads if available) and append them to the result.
+          Same as populateSpectraWithData_() for chromatograms.
       */
       void populateChromatogramsWithData_();
 
+      /// Waits for the spectrum batch currently decoded in the background and appends it to the result
+      void finishSpectraDecoding_();
+
+      /// Waits for the chromatogram batch currently decoded in the background and appends it to the result
+      void finishChromatogramsDecoding_();
+
       /**
           @brief Add extra data arrays to a spectrum
 
@@ -317,12 +329,49 @@ protected:
                           bool renew_native_ids,
                           std::vector<std::vector< ConstDataProcessingPtr > >& dps);
 
+      /**
+        @brief Write out the spectra [@p first, @p last), formatting and encoding them in parallel
+
+        The spectra get the indices @p first_idx, @p first_idx + 1, ... and
+        are written (and added to the index) in the given order. If a
+        spectrum cannot be written, all spectra before it are written and
+        the error is rethrown.
+      */
+      void writeSpectra_(std::ostream& os,
+                         std::vector<SpectrumType>::const_iterator first,
+                         std::vector<SpectrumType>::const_iterator last,
+                         Size first_idx,
+                         const Internal::MzMLValidator& validator,
+                         bool renew_native_ids,
+                         std::vector<std::vector< ConstDataProcessingPtr > >& dps);
+
+      /// Write out the <spectrum> element of a single spectrum (without recording its offset), returns the native id used
+      String writeSpectrumElement_(std::ostream& os,
+                                   const SpectrumType& spec,
+                                   Size spec_idx,
+                                   const Internal::MzMLValidator& validator,
+                                   bool renew_native_ids,
+                                   std::vector<std::vector< ConstDataProcessingPtr > >& dps);
+
       /// Write out a single chromatogram
       void writeChromatogram_(std::ostream& os,
                               const ChromatogramType& chromatogram,
                               Size chrom_idx,
                               const Internal::MzMLValidator& validator);
 
+      /// Write out the chromatograms [@p first, @p last), formatting and encoding them in parallel (see writeSpectra_)
+      void writeChromatograms_(std::ostream& os,
+                               std::vector<ChromatogramType>::const_iterator first,
+                               std::vector<ChromatogramType>::const_iterator last,
+                               Size first_idx,
+                               const Internal::MzMLValidator& validator);
+
+      /// Write out the <chromatogram> element of a single chromatogram (without recording its offset)
+      void writeChromatogramElement_(std::ostream& os,
+                                     const ChromatogramType& chromatogram,
+                                     Size chrom_idx,
+                                     const Internal::MzMLValidator& validator);
+
       template <typename ContainerT>
       void writeContainerData_(std::ostream& os, const PeakFileOptions& pf_options_, const ContainerT& container, String array_type);
 
@@ -462,6 +511,12 @@ protected:
       /// Vector of spectrum data stored for later parallel processing
       std::vector<SpectrumData> spectrum_data_;
 
+      /// Spectrum batch which is currently decoded in the background
+      std::vector<SpectrumData> spectrum_data_decoding_;
+
+      /// Pending background decoding of spectrum_data_decoding_ (invalid if none)
+      std::future<void> spectra_decoded_;
+
       /**
           @brief Data necessary to generate a single chromatogram
 
@@ -479,6 +534,12 @@ protected:
       /// Vector of chromatogram data stored for later parallel processing
       std::vector<ChromatogramData> chromatogram_data_;
 
+      /// Chromatogram batch which is currently decoded in the background
+      std::vector<ChromatogramData> chromatogram_data_decoding_;
+
+      /// Pending background decoding of chromatogram_data_decoding_ (invalid if none)
+      std::future<void> chromatograms_decoded_;
+
       //@}
       /**@name temporary data structures to hold written data
        *
@@ -504,9 +565,10 @@ protected:
       Int chrom_count_total_{ -1 }; ///< total number of chromatograms in mzML file (according to 'count' attribute)
       //@}
 
-      ///Controlled vocabulary (psi-ms from OpenMS/share/OpenMS/CV/psi-ms.obo)
-      ControlledVocabulary cv_;
-      CVMappings mapping_;
+      ///Controlled vocabulary (psi-ms from OpenMS/share/OpenMS/CV/psi-ms.obo), loaded once per process
+      const ControlledVocabulary& cv_;
+      /// CV mapping rules (from OpenMS/share/OpenMS/MAPPING/ms-mapping.xml), loaded once per process
+      const CVMappings& mapping_;
 
     };
 
@@ -114,12 +114,31 @@ public:
       /**
           @brief Read an set of chromatograms (potentially restricted to a subset)
 
+          The data of large sets of chromatograms is read in batches, the
+          batches are read and decoded in parallel (using one database
+          connection per thread) if OpenMP is enabled.
+
           @param exp The result
           @param indices A list of indices restricting the resulting chromatograms only to those specified here
           @param meta_only Only read the meta data
       */
       void readChromatograms(std::vector<MSChromatogram> & exp, const std::vector<int> & indices, bool meta_only = false) const;
 
+      /**
+          @brief Read a set of chromatograms restricted to a retention time range
+
+          Only the data points with retention times in [@p rt_min, @p rt_max]
+          are kept, the meta data of the chromatograms is read completely.
+
+          @param exp The result
+          @param indices A list of indices restricting the resulting chromatograms only to those specified here
+          @param rt_min Lower retention time boundary (inclusive)
+          @param rt_max Upper retention time boundary (inclusive)
+
+          @throw Exception::IllegalArgument if @p rt_min is larger than @p rt_max
+      */
+      void readChromatogramsInRTRange(std::vector<MSChromatogram> & exp, const std::vector<int> & indices, double rt_min, double rt_max) const;
+
       /**
           @brief Get number of spectra in the file
 
@@ -41,6 +41,8 @@
 #include <OpenMS/METADATA/CVTermList.h>
 #include <OpenMS/CONCEPT/ProgressLogger.h>
 
+#include <functional>
+
 namespace OpenMS
 {
   namespace Internal
@@ -59,6 +61,12 @@ public:
       typedef std::vector<ReactionMonitoringTransition::Product> ProductListType;
       typedef std::vector<ReactionMonitoringTransition::Configuration> ConfigurationListType;
 
+      /// Callback receiving each transition that is read
+      typedef std::function<void (const ReactionMonitoringTransition&)> TransitionConsumer;
+
+      /// Callback supplying the transitions to write, returns false if there are no more transitions
+      typedef std::function<bool (ReactionMonitoringTransition&)> TransitionSupplier;
+
       /**@name Constructors and destructor */
       //@{
       /// Constructor for a write-only handler
@@ -67,6 +75,26 @@ public:
       /// Constructor for a read-only handler
       TraMLHandler(TargetedExperiment & exp, const String & filename, const String & version, const ProgressLogger & logger);
 
+      /**
+        @brief Constructor for a streaming read-only handler
+
+        All content except for the transitions is stored in @p exp, each
+        transition is passed to @p consumer as soon as it is read (and not
+        stored). Since the TraML schema requires the protein and compound
+        lists to precede the transition list, @p exp already contains the
+        proteins, peptides and compounds when the first transition arrives.
+      */
+      TraMLHandler(TargetedExperiment & exp, const TransitionConsumer & consumer, const String & filename, const String & version, const ProgressLogger & logger);
+
+      /**
+        @brief Constructor for a streaming write-only handler
+
+        All content except for the transitions is taken from @p exp, the
+        transitions are written as they are returned by @p supplier (the
+        transitions of @p exp are ignored).
+      */
+      TraMLHandler(const TargetedExperiment & exp, const TransitionSupplier & supplier, const String & filename, const String & version, const ProgressLogger & logger);
+
       /// Destructor
       ~TraMLHandler() override;
       //@}
@@ -98,6 +126,12 @@ protected:
 
       const TargetedExperiment * cexp_;
 
+      /// Receives the transitions while reading (transitions are stored in exp_ if not set)
+      TransitionConsumer consumer_;
+
+      /// Supplies the transitions while writing (transitions are taken from cexp_ if not set)
+      TransitionSupplier supplier_;
+
       TargetedExperiment::Publication actual_publication_;
 
       TargetedExperiment::Contact actual_contact_;
@@ -167,6 +201,8 @@ protected:
       }
 
       // subfunctions of write
+      void writeTransition_(std::ostream & os, const ReactionMonitoringTransition & transition) const;
+
       void writeTarget_(std::ostream & os, const std::vector<IncludeExcludeTarget>::const_iterator & it) const;
 
       void writeRetentionTime_(std::ostream& os, const TargetedExperimentHelper::RetentionTime& rt) const;
@@ -7,6 +7,7 @@ AcqusHandler.h
 FidHandler.h
 IndexedMzMLDecoder.h
 IndexedMzMLHandler.h
+IndexedMzXMLHandler.h
 MascotXMLHandler.h
 MzDataHandler.h
 MzIdentMLDOMHandler.h
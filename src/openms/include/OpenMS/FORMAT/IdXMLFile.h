@@ -39,6 +39,7 @@
 #include <OpenMS/METADATA/PeptideIdentification.h>
 #include <OpenMS/FORMAT/HANDLERS/XMLHandler.h>
 #include <OpenMS/FORMAT/XMLFile.h>
+#include <OpenMS/INTERFACES/IDConsumer.h>
 
 #include <vector>
 
@@ -69,6 +70,8 @@ public:
     // both ConsensusXMLFile and FeatureXMLFile use some protected IdXML helper functions to parse identifications without code duplication
     friend class ConsensusXMLFile;
     friend class FeatureXMLFile;
+    // IDRipper writes its outputs incrementally using the helpers below
+    friend class IDRipper;
 
     /// Constructor
     IdXMLFile();
@@ -95,11 +98,27 @@ public:
     */
     void load(const String& filename, std::vector<ProteinIdentification>& protein_ids, std::vector<PeptideIdentification>& peptide_ids, String& document_id);
 
+    /**
+        @brief Loads the identifications of an idXML file and passes them to a consumer
+
+        Instead of collecting all identifications in memory, every
+        ProteinIdentification and PeptideIdentification is handed to @p
+        consumer as soon as it has been read. The consumer owns the decision
+        to keep, modify or discard it.
+
+        @exception Exception::FileNotFound is thrown if the file could not be opened
+        @exception Exception::ParseError is thrown if an error occurs during parsing
+    */
+    void load(const String& filename, Interfaces::IDConsumer& consumer);
+
     /**
         @brief Stores the data in an idXML file
 
         The data is read in and stored in the file 'filename'. PeptideHits are sorted by score.
 
+        PeptideIdentification elements are formatted in batches (in parallel
+        if OpenMP is enabled) and written in their original order.
+
         @exception Exception::UnableToCreateFile is thrown if the file could not be created
     */
     void store(String filename, const std::vector<ProteinIdentification>& protein_ids, const std::vector<PeptideIdentification>& peptide_ids, const String& document_id = "");
@@ -118,6 +137,15 @@ protected:
     /// Read and store ProteinGroup data
     void getProteinGroups_(std::vector<ProteinIdentification::ProteinGroup>& groups, const String& group_name);
 
+    /// Write the XML header and the (distinct) search parameters @p params, referenced as "SP_<index>"
+    void writeHeader_(std::ostream& os, const std::vector<ProteinIdentification::SearchParameters>& params, const String& document_id);
+
+    /// Open an IdentificationRun element and write its ProteinIdentification (protein hits are numbered starting at @p prot_count)
+    void writeIdentificationRunStart_(std::ostream& os, const ProteinIdentification& prot_id, const std::vector<ProteinIdentification::SearchParameters>& params, UInt& prot_count, std::map<String, UInt>& accession_to_id);
+
+    /// Write a single PeptideIdentification element (thread-safe, does not modify any members)
+    void writePeptideIdentification_(std::ostream& os, const PeptideIdentification& pep_id, const std::map<String, UInt>& accession_to_id) const;
+
     /**
       * Helper function to create the XML string for the amino acids before and after the peptide position in a protein.
       * Can be reused by e.g. ConsensusXML, FeatureXML to write PeptideHit elements  
@@ -149,6 +177,8 @@ protected:
     std::vector<ProteinIdentification>* prot_ids_;
     /// Pointer to fill in peptide identifications
     std::vector<PeptideIdentification>* pep_ids_;
+    /// Consumer of identifications (if set, peptide identifications are passed to it instead of being stored)
+    Interfaces::IDConsumer* consumer_;
     /// Pointer to last read object with MetaInfoInterface
     MetaInfoInterface* last_meta_;
     /// Search parameters map (key is the "id")
@@ -0,0 +1,107 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2018.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: Timo Sachsenberg $
+// $Authors: Timo Sachsenberg $
+// --------------------------------------------------------------------------
+
+#pragma once
+
+#include <OpenMS/KERNEL/MSExperiment.h>
+#include <OpenMS/KERNEL/FeatureMap.h>
+#include <OpenMS/KERNEL/ConsensusMap.h>
+
+#include <vector>
+
+namespace OpenMS
+{
+  /**
+    @brief Process-wide store of data sets addressed by "mem:" file names
+
+    Allows to pass data between processing steps (e.g. several TOPP tools run
+    in one process by TOPPPipeline) without writing and parsing files. A
+    file name starting with "mem:" (e.g. "mem:picked.mzML") does not refer
+    to a file on disk but to an entry of this store: MzMLFile,
+    FeatureXMLFile and ConsensusXMLFile store a copy of the data there and
+    load a copy from there instead of accessing the file system. Use the
+    extension of the format the data would be written in, so file types
+    are detected as usual.
+
+    Entries live until they are removed (see remove() and clear()).
+
+    @note All methods are thread-safe.
+
+    @ingroup FileIO
+  */
+  class OPENMS_DLLAPI InMemoryFileStore
+  {
+public:
+    /// Prefix of file names that refer to the store ("mem:")
+    static const String PREFIX;
+
+    /// Does @p filename refer to the store (i.e. start with PREFIX)?
+    static bool isMemoryPath(const String& filename);
+
+    /// Is there an entry for @p filename (of any type)?
+    static bool exists(const String& filename);
+
+    /**
+      @brief Stores a copy of @p data as @p filename (replacing an existing entry)
+
+      @exception Exception::UnableToCreateFile is thrown if @p filename does not start with PREFIX
+    */
+    static void store(const String& filename, const PeakMap& data);
+    /// @copydoc store(const String&, const PeakMap&)
+    static void store(const String& filename, const FeatureMap& data);
+    /// @copydoc store(const String&, const PeakMap&)
+    static void store(const String& filename, const ConsensusMap& data);
+
+    /**
+      @brief Copies the entry @p filename into @p data
+
+      @exception Exception::FileNotFound is thrown if there is no entry of this type
+    */
+    static void load(const String& filename, PeakMap& data);
+    /// @copydoc load(const String&, PeakMap&)
+    static void load(const String& filename, FeatureMap& data);
+    /// @copydoc load(const String&, PeakMap&)
+    static void load(const String& filename, ConsensusMap& data);
+
+    /// Removes the entry @p filename (if there is one)
+    static void remove(const String& filename);
+
+    /// Removes all entries
+    static void clear();
+
+    /// Names of all entries (sorted)
+    static std::vector<String> getNames();
+  };
+
+} // namespace OpenMS
@@ -99,6 +99,7 @@ public:
       typename MapType::SpectrumType::PeakType p;
 
       String line;
+      std::vector<StringView> peak_fields; // views into 'line', re-used for all peaks
       bool first_spec(true);
 
       // line number counter
@@ -163,17 +164,16 @@ public:
 
         // yet another peak, hopefully
         line.simplify();
-        std::vector<String> split;
-        line.split(' ', split);
-        if (split.size() != 2)
+        StringView(line).split(' ', peak_fields);
+        if (peak_fields.size() != 2)
         {
-          throw Exception::ParseError(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "line (" + String(line_number) + ") '" + line  + "' should contain two values, got " + String(split.size()) + "!", "");
+          throw Exception::ParseError(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "line (" + String(line_number) + ") '" + line  + "' should contain two values, got " + String(peak_fields.size()) + "!", "");
         }
 
         try
         {
-          p.setPosition(split[0].toDouble());
-          p.setIntensity(split[1].toFloat());
+          p.setPosition(peak_fields[0].toDouble());
+          p.setIntensity(peak_fields[1].toFloat());
         }
         catch (Exception::ConversionError /*&e*/)
         {
@@ -39,7 +39,13 @@
 #include <OpenMS/CONCEPT/ProgressLogger.h>
 #include <OpenMS/DATASTRUCTURES/DefaultParamHandler.h>
 #include <OpenMS/KERNEL/StandardTypes.h>
+#include <OpenMS/INTERFACES/IMSDataConsumer.h>
+#include <OpenMS/METADATA/Precursor.h>
 
+#include <algorithm>
+#include <cctype>
+#include <exception>
+#include <memory>
 #include <vector>
 #include <fstream>
 
@@ -84,6 +90,9 @@ public:
     /**
       @brief loads a Mascot Generic File into a PeakMap
 
+      The file is memory-mapped and its spectrum blocks ('BEGIN IONS' ...
+      'END IONS') are parsed in parallel.
+
       @param filename file name which the map should be read from
       @param exp the map which is filled with the data from the given file
       @throw FileNotFound is thrown if the given file could not be found
@@ -91,35 +100,29 @@ public:
     template <typename MapType>
     void load(const String& filename, MapType& exp)
     {
-      if (!File::exists(filename))
-      {
-        throw Exception::FileNotFound(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, filename);
-      }
-
       exp.reset();
 
-      std::ifstream is(filename.c_str());
-      // get size of file
-      is.seekg(0, std::ios::end);
-      startProgress(0, is.tellg(), "loading MGF");
-      is.seekg(0, std::ios::beg);
-
-      UInt spectrum_number(0);
-      Size line_number(0); // carry line number for error messages within getNextSpectrum()
+      std::vector<SpectrumBlock_> blocks;
+      std::shared_ptr<const void> mapping = findSpectrumBlocks_(filename, blocks);
+      exp.reserveSpaceSpectra(blocks.size());
 
-      typename MapType::SpectrumType spectrum;
-      spectrum.setMSLevel(2);
-      spectrum.getPrecursors().resize(1);
-      while (getNextSpectrum_(is, spectrum, line_number, spectrum_number))
+      parseSpectra_<typename MapType::SpectrumType>(blocks, [&exp](typename MapType::SpectrumType& spectrum)
       {
-        exp.addSpectrum(spectrum);
-        setProgress(is.tellg());
-        ++spectrum_number;
-      } // next spectrum
+        exp.addSpectrum(std::move(spectrum));
+      });
+    }
 
+    /**
+      @brief Reads a Mascot Generic File and passes the spectra to @p consumer (in file order)
 
-      endProgress();
-    }
+      Like load(), but only a batch of spectra is kept in memory at any time,
+      so arbitrarily large files can be processed.
+
+      @param filename file name which should be read
+      @param consumer consumer which receives the spectra
+      @throw FileNotFound is thrown if the given file could not be found
+    */
+    void transform(const String& filename, Interfaces::IMSDataConsumer* consumer);
 
     /**
       @brief enclosing Strings of the peak list body for HTTP submission
@@ -154,160 +157,265 @@ protected:
     /// writes the MSExperiment
     void writeMSExperiment_(std::ostream& os, const String& filename, const PeakMap& experiment);
 
-    /// reads a spectrum block, the section between 'BEGIN IONS' and 'END IONS' of a MGF file
-    template <typename SpectrumType>
-    bool getNextSpectrum_(std::ifstream& is, SpectrumType& spectrum, Size& line_number, const Size& spectrum_number)
+    /// location of a spectrum block, the section between 'BEGIN IONS' and 'END IONS' of a MGF file
+    struct SpectrumBlock_
+    {
+      const char* begin; ///< start of the line following 'BEGIN IONS'
+      const char* end; ///< start of the 'END IONS' line (or end of file)
+      Size line_number; ///< line number of the 'BEGIN IONS' line
+      bool complete; ///< false if the file ended before 'END IONS'
+      bool has_data; ///< false if the file ended before the first data line (only the parameters are parsed, the spectrum is dropped)
+    };
+
+    /// precursor information that was given in a spectrum block
+    enum BlockContent_
+    {
+      HAS_PRECURSOR_MZ = 1,
+      HAS_PRECURSOR_INTENSITY = 2,
+      HAS_PRECURSOR_CHARGE = 4,
+      HAS_RT = 8
+    };
+
+    /**
+      @brief Memory-maps @p filename and locates all spectrum blocks in it
+
+      @return handle that keeps the mapping (which @p blocks point into) alive
+      @throw FileNotFound is thrown if the given file could not be found
+    */
+    static std::shared_ptr<const void> findSpectrumBlocks_(const String& filename, std::vector<SpectrumBlock_>& blocks);
+
+    /**
+      @brief Parses the spectrum @p blocks in parallel and passes the spectra in file order to @p sink
+
+      Spectra are processed in batches, so only a limited number of them is
+      held in memory. If a block fails to parse, the spectra preceding it are
+      passed on and the (first) error is rethrown.
+    */
+    template <typename SpectrumType, typename SpectrumSink>
+    void parseSpectra_(const std::vector<SpectrumBlock_>& blocks, SpectrumSink sink)
     {
-      spectrum.resize(0);
+      const Size batch_size = 1000;
 
-      spectrum.setNativeID(String("index=") + (spectrum_number));
-      if (spectrum.metaValueExists("TITLE"))
+      startProgress(0, blocks.size(), "loading MGF");
+
+      // precursor information and RT not given in a block are taken from the
+      // previous spectrum (as the sequential reader did by re-using the spectrum)
+      SpectrumType previous;
+      previous.getPrecursors().resize(1);
+      const Precursor& previous_precursor = previous.getPrecursors()[0];
+
+      std::vector<SpectrumType> batch;
+      std::vector<UInt> contents;
+      for (Size batch_start = 0; batch_start < blocks.size(); batch_start += batch_size)
       {
-        spectrum.removeMetaValue("TITLE");
+        const Size n = std::min(batch_size, blocks.size() - batch_start);
+        batch.clear();
+        batch.resize(n);
+        contents.assign(n, 0);
+
+        std::exception_ptr error;
+        Size error_index = n;
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic, 16)
+#endif
+        for (SignedSize i = 0; i < (SignedSize)n; ++i)
+        {
+          try
+          {
+            parseSpectrumBlock_(blocks[batch_start + i], batch_start + i, batch[i], contents[i]);
+          }
+          catch (...)
+          {
+#ifdef _OPENMP
+#pragma omp critical (MascotGenericFile_parseSpectra)
+#endif
+            {
+              if ((Size)i < error_index)
+              {
+                error_index = i;
+                error = std::current_exception();
+              }
+            }
+          }
+        }
+
+        for (Size i = 0; i < std::min(n, error_index); ++i)
+        {
+          if (!blocks[batch_start + i].has_data) continue;
+          Precursor& precursor = batch[i].getPrecursors()[0];
+          if (!(contents[i] & HAS_PRECURSOR_MZ)) precursor.setMZ(previous_precursor.getMZ());
+          if (!(contents[i] & HAS_PRECURSOR_INTENSITY)) precursor.setIntensity(previous_precursor.getIntensity());
+          if (!(contents[i] & HAS_PRECURSOR_CHARGE)) precursor.setCharge(previous_precursor.getCharge());
+          if (!(contents[i] & HAS_RT)) batch[i].setRT(previous.getRT());
+          previous.getPrecursors()[0] = precursor;
+          previous.setRT(batch[i].getRT());
+          sink(batch[i]);
+        }
+        if (error)
+        {
+          std::rethrow_exception(error);
+        }
+        setProgress(batch_start + n);
       }
-      typename SpectrumType::PeakType p;
 
+      endProgress();
+    }
+
+    /// parses a single spectrum block, @p contents is set to the precursor information found (see BlockContent_)
+    template <typename SpectrumType>
+    static void parseSpectrumBlock_(const SpectrumBlock_& block, Size spectrum_number, SpectrumType& spectrum, UInt& contents)
+    {
+      spectrum.setMSLevel(2);
+      spectrum.getPrecursors().resize(1);
+      spectrum.setNativeID(String("index=") + spectrum_number);
+      contents = 0;
+
+      typename SpectrumType::PeakType p;
+      Size line_number = block.line_number;
+      bool in_peaks = false; // parameters come first, everything after the first data line is a peak
       String line;
-      // seek to next peak list block
-      while (getline(is, line, '\n'))
+      for (const char* pos = block.begin; pos != block.end; )
       {
+        const char* line_end = std::find(pos, block.end, '\n');
+        StringView view = StringView(pos, line_end - pos).trim(); // remove whitespaces, line-endings etc
+        pos = (line_end == block.end) ? line_end : line_end + 1;
         ++line_number;
 
-        line.trim(); // remove whitespaces, line-endings etc
+        if (view.empty()) continue;
 
-        // found peak list block?
-        if (line == "BEGIN IONS")
+        if (in_peaks || isdigit(view[0])) // actual data .. this comes first, since its the most common case
         {
-          while (getline(is, line, '\n'))
+          in_peaks = true;
+          // fields are separated by (any number of) spaces, also accept Tab (strictly, only space(s) are allowed)
+          const char* mz_end = std::find_if(view.begin(), view.end(), isWhitespace_);
+          if (mz_end == view.end())
+          {
+            throw Exception::ParseError(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "The content '" + simplified_(view) + "' at line #" + String(line_number) + " does not contain m/z and intensity values separated by whitespace (space or tab)!", "");
+          }
+          const char* int_begin = std::find_if_not(mz_end, view.end(), isWhitespace_);
+          const char* int_end = std::find_if(int_begin, view.end(), isWhitespace_);
+          try
           {
-            ++line_number;
-            line.trim(); // remove whitespaces, line-endings etc
+            p.setPosition(StringView(view.begin(), mz_end - view.begin()).toDouble());
+            p.setIntensity(StringView(int_begin, int_end - int_begin).toDouble());
+          }
+          catch (Exception::ConversionError& /*e*/)
+          {
+            throw Exception::ParseError(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "The content '" + simplified_(view) + "' at line #" + String(line_number) + " could not be converted to a number! Expected two (m/z int) or three (m/z int charge) numbers separated by whitespace (space or tab).", "");
+          }
+          spectrum.push_back(p);
+        }
+        else
+        {
+          line.assign(view.begin(), view.end());
+          parseParameterLine_(line, line_number, spectrum, contents);
+        }
+      }
 
-            if (line.empty()) continue;
+      if (block.has_data && !block.complete)
+      {
+        throw Exception::ParseError(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "Reached end of file. Found \"BEGIN IONS\" but not the corresponding \"END IONS\"!", "");
+      }
+    }
 
-            if (isdigit(line[0])) // actual data .. this comes first, since its the most common case
+    /// parses a (trimmed) parameter line of a spectrum block
+    template <typename SpectrumType>
+    static void parseParameterLine_(const String& line, Size line_number, SpectrumType& spectrum, UInt& contents)
+    {
+      if (line.hasPrefix("PEPMASS")) // parse precursor position
+      {
+        String tmp = line.substr(8); // copy since we might need the original line for error reporting later
+        tmp.substitute('\t', ' ');
+        std::vector<String> split;
+        tmp.split(' ', split);
+        if (split.size() == 1)
+        {
+          spectrum.getPrecursors()[0].setMZ(split[0].trim().toDouble());
+          contents |= HAS_PRECURSOR_MZ;
+        }
+        else if (split.size() == 2)
+        {
+          spectrum.getPrecursors()[0].setMZ(split[0].trim().toDouble());
+          spectrum.getPrecursors()[0].setIntensity(split[1].trim().toDouble());
+          contents |= HAS_PRECURSOR_MZ | HAS_PRECURSOR_INTENSITY;
+        }
+        else
+        {
+          throw Exception::ParseError(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "Cannot parse PEPMASS in '" + line + "' at line #" + String(line_number) + " (expected 1 or 2 entries, but " + String(split.size()) + " were present)!", "");
+        }
+      }
+      else if (line.hasPrefix("CHARGE"))
+      {
+        String tmp = line.substr(7);
+        tmp.remove('+');
+        spectrum.getPrecursors()[0].setCharge(tmp.toInt());
+        contents |= HAS_PRECURSOR_CHARGE;
+      }
+      else if (line.hasPrefix("RTINSECONDS"))
+      {
+        String tmp = line.substr(12);
+        spectrum.setRT(tmp.toDouble());
+        contents |= HAS_RT;
+      }
+      else if (line.hasPrefix("TITLE"))
+      {
+        // test if we have a line like "TITLE= Cmpd 1, +MSn(595.3), 10.9 min"
+        if (line.hasSubstring("min"))
+        {
+          try
+          {
+            std::vector<String> split;
+            line.split(',', split);
+            if (!split.empty())
             {
-              std::vector<String> split;
-              do
+              for (Size i = 0; i != split.size(); ++i)
               {
-                if (line.empty())
-                {
-                  continue;
-                }
-
-                line.simplify(); // merge double spaces (explicitly allowed by MGF), to prevent empty split() chunks and subsequent parse error
-                line.substitute('\t', ' '); // also accept Tab (strictly, only space(s) are allowed)
-                if (line.split(' ', split, false))
+                if (split[i].hasSubstring("min"))
                 {
-                  try 
+                  std::vector<String> split2;
+                  split[i].trim().split(' ', split2);
+                  if (!split2.empty())
                   {
-                    p.setPosition(split[0].toDouble());
-                    p.setIntensity(split[1].toDouble());
+                    spectrum.setRT(split2[0].trim().toDouble() * 60.0);
+                    contents |= HAS_RT;
                   }
-                  catch (Exception::ConversionError& /*e*/)
-                  {
-                    throw Exception::ParseError(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "The content '" + line + "' at line #" + String(line_number) + " could not be converted to a number! Expected two (m/z int) or three (m/z int charge) numbers separated by whitespace (space or tab).", "");
-                  }
-                  spectrum.push_back(p);
-                }
-                else
-                {
-                  throw Exception::ParseError(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "The content '" + line + "' at line #" + String(line_number) + " does not contain m/z and intensity values separated by whitespace (space or tab)!", "");
                 }
               }
-              while (getline(is, line, '\n') && ++line_number && line.trim() != "END IONS"); // line.trim() is important here!
-
-              if (line == "END IONS")
-              {
-                return true; // found end of spectrum
-              }
-              else
-              {
-                throw Exception::ParseError(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "Reached end of file. Found \"BEGIN IONS\" but not the corresponding \"END IONS\"!", "");
-              }
-            }
-            else if (line.hasPrefix("PEPMASS")) // parse precursor position
-            {
-              String tmp = line.substr(8); // copy since we might need the original line for error reporting later
-              tmp.substitute('\t', ' ');
-              std::vector<String> split;
-              tmp.split(' ', split);
-              if (split.size() == 1)
-              {
-                spectrum.getPrecursors()[0].setMZ(split[0].trim().toDouble());
-              }
-              else if (split.size() == 2)
-              {
-                spectrum.getPrecursors()[0].setMZ(split[0].trim().toDouble());
-                spectrum.getPrecursors()[0].setIntensity(split[1].trim().toDouble());
-              }
-              else
-              {
-                throw Exception::ParseError(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "Cannot parse PEPMASS in '" + line + "' at line #" + String(line_number) + " (expected 1 or 2 entries, but " + String(split.size()) + " were present)!", "");
-              }
-            }
-            else if (line.hasPrefix("CHARGE"))
-            {
-              String tmp = line.substr(7);
-              tmp.remove('+');
-              spectrum.getPrecursors()[0].setCharge(tmp.toInt());
-            }
-            else if (line.hasPrefix("RTINSECONDS"))
-            {
-              String tmp = line.substr(12);
-              spectrum.setRT(tmp.toDouble());
             }
-            else if (line.hasPrefix("TITLE"))
+          }
+          catch (Exception::BaseException& /*e*/)
+          {
+            // just do nothing and write the whole title to spec
+            std::vector<String> split;
+            if (line.split('=', split))
             {
-              // test if we have a line like "TITLE= Cmpd 1, +MSn(595.3), 10.9 min"
-              if (line.hasSubstring("min"))
-              {
-                try
-                {
-                  std::vector<String> split;
-                  line.split(',', split);
-                  if (!split.empty())
-                  {
-                    for (Size i = 0; i != split.size(); ++i)
-                    {
-                      if (split[i].hasSubstring("min"))
-                      {
-                        std::vector<String> split2;
-                        split[i].trim().split(' ', split2);
-                        if (!split2.empty())
-                        {
-                          spectrum.setRT(split2[0].trim().toDouble() * 60.0);
-                        }
-                      }
-                    }
-                  }
-                }
-                catch (Exception::BaseException& /*e*/)
-                {
-                  // just do nothing and write the whole title to spec
-                  std::vector<String> split;
-                  if (line.split('=', split))
-                  {
-                    if (split[1] != "") spectrum.setMetaValue("TITLE", split[1]);
-                  }
-                }
-              }
-              else // just write the title as metainfo to the spectrum
-              {
-                std::vector<String> split;
-                line.split('=', split);
-                if (split.size() == 2)
-                {
-                  if (split[1] != "") spectrum.setMetaValue("TITLE", split[1]);
-                }
-                // TODO concatenate the other parts if the title contains additional '=' chars
-              }
+              if (split[1] != "") spectrum.setMetaValue("TITLE", split[1]);
             }
           }
         }
+        else // just write the title as metainfo to the spectrum
+        {
+          std::vector<String> split;
+          line.split('=', split);
+          if (split.size() == 2)
+          {
+            if (split[1] != "") spectrum.setMetaValue("TITLE", split[1]);
+          }
+          // TODO concatenate the other parts if the title contains additional '=' chars
+        }
       }
+    }
 
-      return false; // found end of file
+    /// whitespace as merged by String::simplify()
+    static bool isWhitespace_(char c)
+    {
+      return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+    }
+
+    /// copy of @p view with merged whitespaces (for error messages)
+    static String simplified_(const StringView& view)
+    {
+      return view.getString().simplify();
     }
 
   };
@@ -41,6 +41,7 @@
 #include <OpenMS/METADATA/ProteinIdentification.h>
 #include <OpenMS/METADATA/PeptideIdentification.h>
 
+#include <functional>
 #include <vector>
 
 namespace OpenMS
@@ -82,6 +83,20 @@ public:
     */
     void load(const String& filename, std::vector<ProteinIdentification>& poid, std::vector<PeptideIdentification>& peid);
 
+    /**
+        @brief Loads the identifications from a MzIdentML file, passing each PeptideIdentification to @p consumer as soon as it is read.
+
+        Spectrum identification results are converted while the file is
+        parsed and are not kept in memory, so memory use depends on the
+        number of proteins and peptide sequences, not on the number of PSMs.
+        The PeptideIdentifications are identical to the ones of load() and
+        are passed in file order; @p poid is complete once the function returns.
+
+        @exception Exception::FileNotFound is thrown if the file could not be opened
+        @exception Exception::ParseError is thrown if an error occurs during parsing
+    */
+    void load(const String& filename, std::vector<ProteinIdentification>& poid, const std::function<void(PeptideIdentification&)>& consumer);
+
     /**
         @brief Stores the identifications in a MzIdentML file.
 
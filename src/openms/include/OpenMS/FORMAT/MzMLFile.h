@@ -77,6 +77,10 @@ public:
       @p filename The filename with the data
       @p map Is an MSExperiment
 
+      If PeakFileOptions::getUseIndexedSelection() is set and spectra are
+      filtered by RT or MS level, only the matching spectra of indexed mzML
+      files are read from disk (see MzMLSpectrumMetaIndex).
+
       @exception Exception::FileNotFound is thrown if the file could not be opened
       @exception Exception::ParseError is thrown if an error occurs during parsing
     */
@@ -183,6 +187,17 @@ protected:
     /// Safe parse that catches exceptions and handles them accordingly
     void safeParse_(const String & filename, Internal::XMLHandler * handler);
 
+    /**
+      @brief Loads only the spectra matching the RT/MS level filters of an indexed mzML file
+
+      Looks up the spectra in the MzMLSpectrumMetaIndex of the file and reads
+      them (plus header and chromatograms) using the offsets of the
+      indexedmzML index.
+
+      @return false if the file cannot be read this way (e.g. it has no index), @p map is unchanged in that case
+    */
+    bool loadIndexedSelection_(const String & filename, PeakMap & map);
+
 private:
 
     /// Options for loading / storing
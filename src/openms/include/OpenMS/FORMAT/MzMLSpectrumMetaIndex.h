@@ -0,0 +1,130 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2018.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: Timo Sachsenberg $
+// $Authors: Timo Sachsenberg $
+// --------------------------------------------------------------------------
+
+#pragma once
+
+#include <OpenMS/DATASTRUCTURES/String.h>
+#include <OpenMS/FORMAT/OPTIONS/PeakFileOptions.h>
+
+#include <vector>
+
+namespace OpenMS
+{
+  /**
+    @brief Small metadata index of the spectra of an mzML file
+
+    Stores retention time, MS level and (first) precursor m/z of every
+    spectrum in file order. Together with the offsets of an indexedmzML file
+    it allows to find and read only the spectra matching RT or MS level
+    filters (see PeakFileOptions::setUseIndexedSelection), without parsing
+    the whole file.
+
+    The index is kept as a tab-separated sidecar file next to the mzML file
+    ("<mzml_file>.smi"), with a header line holding the number of spectra and
+    one line per spectrum.
+
+    Sample usage:
+
+    @code
+      MzMLSpectrumMetaIndex index;
+      index.open("data.mzML"); // builds and stores "data.mzML.smi" on first use
+      std::vector<Size> ms1 = index.select(options);
+    @endcode
+  */
+  class OPENMS_DLLAPI MzMLSpectrumMetaIndex
+  {
+public:
+    /// Index record of a single spectrum
+    struct Entry
+    {
+      double rt; ///< retention time (seconds)
+      Int ms_level; ///< MS level
+      double precursor_mz; ///< m/z of the first precursor (0 if there is none)
+    };
+
+    /// Default constructor
+    MzMLSpectrumMetaIndex();
+
+    /**
+      @brief Opens the index of @p mzml_file
+
+      An existing index file "<mzml_file>.smi" is used if it is not older
+      than the mzML file, otherwise the index is built from the mzML file
+      and (if @p store_index is set) written to "<mzml_file>.smi". Failing
+      to write the index file (e.g. in read-only directories) is not an error.
+
+      @exception Exception::FileNotFound is thrown if the mzML file does not exist
+      @exception Exception::ParseError is thrown if the mzML file cannot be parsed
+    */
+    void open(const String& mzml_file, bool store_index = true);
+
+    /**
+      @brief Builds the index by reading the metadata of @p mzml_file once (without decoding any peak data)
+
+      @exception Exception::FileNotFound is thrown if the file does not exist
+      @exception Exception::ParseError is thrown if the file cannot be parsed
+    */
+    void build(const String& mzml_file);
+
+    /**
+      @brief Reads the index from @p index_file
+
+      @exception Exception::FileNotFound is thrown if the index file does not exist
+      @exception Exception::ParseError is thrown if the index file is malformed
+    */
+    void load(const String& index_file);
+
+    /**
+      @brief Writes the index to @p index_file
+
+      @exception Exception::UnableToCreateFile is thrown if the file cannot be written
+    */
+    void store(const String& index_file) const;
+
+    /// Number of indexed spectra
+    Size size() const;
+
+    /// The index records in file order
+    const std::vector<Entry>& getIndexEntries() const;
+
+    /// Positions of the spectra passing the RT range and MS level filters of @p options (in file order)
+    std::vector<Size> select(const PeakFileOptions& options) const;
+
+protected:
+    /// Index records in file order
+    std::vector<Entry> entries_;
+  };
+
+} // namespace OpenMS
+
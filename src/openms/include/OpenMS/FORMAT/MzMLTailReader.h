@@ -0,0 +1,162 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2018.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: Timo Sachsenberg $
+// $Authors: Timo Sachsenberg $
+// --------------------------------------------------------------------------
+
+#pragma once
+
+#include <OpenMS/KERNEL/StandardTypes.h>
+#include <OpenMS/FORMAT/XMLFile.h>
+#include <OpenMS/FORMAT/OPTIONS/PeakFileOptions.h>
+#include <OpenMS/CONCEPT/ProgressLogger.h>
+#include <OpenMS/INTERFACES/IMSDataConsumer.h>
+
+#include <string>
+
+namespace OpenMS
+{
+  /**
+    @brief Reads an mzML file incrementally while it is still being written
+
+    Each call to poll() reads the data appended to the file since the last
+    call. All spectra and chromatograms which are complete by then are passed
+    to the consumer, in file order. Elements which are still incomplete are
+    kept and handed over in a later call. This allows processing data during
+    acquisition, e.g. by calling poll() from the FileWatcher::fileChanged
+    signal or periodically.
+
+    The experimental settings (everything in front of the spectrum or
+    chromatogram list) are passed to the consumer once they are complete,
+    before the first spectrum or chromatogram.
+
+    Per-spectrum processing like peak picking can be chained in using
+    MSDataTransformingConsumer or MSDataChainingConsumer.
+
+    @note The file must only grow, i.e. it must not be rewritten from the start.
+
+    @ingroup FileIO
+  */
+  class OPENMS_DLLAPI MzMLTailReader :
+    public Internal::XMLFile,
+    public ProgressLogger
+  {
+public:
+    /**
+      @brief Constructor
+
+      @param filename The mzML file to follow (it does not need to exist yet)
+      @param consumer The consumer which receives the settings, spectra and chromatograms (not owned)
+    */
+    MzMLTailReader(const String& filename, Interfaces::IMSDataConsumer* consumer);
+
+    /// Destructor
+    ~MzMLTailReader() override;
+
+    /// Mutable access to the options for loading
+    PeakFileOptions& getOptions();
+
+    /// Non-mutable access to the options for loading
+    const PeakFileOptions& getOptions() const;
+
+    /**
+      @brief Reads the data appended since the last call
+
+      @return The number of spectra and chromatograms passed to the consumer
+
+      @exception Exception::ParseError is thrown if the file was truncated or if an error occurs during parsing
+    */
+    Size poll();
+
+    /// Returns true as soon as the end of the run has been read (no more data will follow)
+    bool isFinished() const;
+
+    /// Number of spectra passed to the consumer so far
+    Size getNrSpectra() const;
+
+    /// Number of chromatograms passed to the consumer so far
+    Size getNrChromatograms() const;
+
+protected:
+    /// Where the reader currently is in the document
+    enum State
+    {
+      HEADER,        ///< before the first spectrum or chromatogram list
+      SPECTRA,       ///< inside the spectrum list
+      CHROMATOGRAMS, ///< inside the chromatogram list
+      BETWEEN_LISTS, ///< after a list, before the next list or the end of the run
+      FINISHED       ///< after the end of the run
+    };
+
+    /// Starts a spectrum or chromatogram list at @p pos of the buffer, returns false if its opening tag is incomplete
+    bool startList_(Size pos);
+
+    /// Parses the complete elements in @p content (wrapped into the header and the current list) and returns the number of elements parsed
+    Size parseElements_(const std::string& content);
+
+    /// Returns the document closing tags for the current list
+    std::string closingTags_() const;
+
+    /// The file which is read
+    String filename_;
+
+    /// The consumer (not owned)
+    Interfaces::IMSDataConsumer* consumer_;
+
+    /// Options for loading
+    PeakFileOptions options_;
+
+    /// Current position in the document
+    State state_;
+
+    /// Number of bytes read from the file so far
+    Size offset_;
+
+    /// Data read but not yet parsed (incomplete elements)
+    std::string buffer_;
+
+    /// Document content in front of the first list (up to and including the run start tag)
+    std::string header_;
+
+    /// Opening tag of the current list
+    std::string list_start_;
+
+    /// Whether the file is an indexed mzML file
+    bool indexed_;
+
+    /// Number of spectra passed to the consumer
+    Size spectra_count_;
+
+    /// Number of chromatograms passed to the consumer
+    Size chromatogram_count_;
+  };
+} // namespace OpenMS
+
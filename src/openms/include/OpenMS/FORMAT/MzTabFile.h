@@ -45,6 +45,8 @@
 
 #include <vector>
 #include <algorithm>
+#include <functional>
+#include <iosfwd>
 
 namespace OpenMS
 {
@@ -65,9 +67,35 @@ public:
 
     typedef std::map<std::pair<String, String>, std::vector<PeptideHit> > MapAccPepType;
 
+    /**
+      @brief Generator of PSM rows
+
+      Called with an item index (e.g. the index of a PeptideIdentification),
+      appends the PSM rows of this item to the vector. Must be safe to call
+      concurrently and must give the same rows when called twice.
+    */
+    typedef std::function<void(Size, MzTabPSMSectionRows&)> PSMRowGenerator;
+
     // store MzTab file
     void store(const String& filename, const MzTab& mz_tab) const;
 
+    /**
+      @brief Store MzTab file, generating the PSM section on the fly
+
+      All sections but the PSM section are taken from @p mz_tab (its PSM rows
+      are ignored). The PSM rows are generated by @p psm_row_generator for
+      the items 0 to @p n_psm_items - 1 and written directly to the file in
+      item order, so the complete PSM section never needs to be held in
+      memory. Rows are generated and formatted in batches (in parallel if
+      OpenMP is enabled); the generator is called twice per item, first to
+      determine the optional PSM columns and then to write the rows.
+
+      Comment and empty rows stored in @p mz_tab are not written.
+
+      @exception Exception::UnableToCreateFile is thrown if the file could not be created
+    */
+    void store(const String& filename, const MzTab& mz_tab, Size n_psm_items, const PSMRowGenerator& psm_row_generator) const;
+
     // Set store behaviour of optional "reliability" and "uri" columns (default=no)
     void storeProteinReliabilityColumn(bool store);
     void storePeptideReliabilityColumn(bool store);
@@ -95,6 +123,15 @@ protected:
 
     void generateMzTabMetaDataSection_(const MzTabMetaData& map, StringList& sl) const;
 
+    /// Generate the meta data, protein and peptide sections
+    void generateMzTabSectionsBeforePSM_(const MzTab& mz_tab, StringList& out) const;
+
+    /// Generate the small molecule section
+    void generateMzTabSectionsAfterPSM_(const MzTab& mz_tab, StringList& out) const;
+
+    /// Write lines to a stream, with the line break handling of TextFile::store()
+    static void writeLines_(std::ostream& os, const StringList& lines);
+
     void generateMzTabProteinSection_(const MzTabProteinSectionRows& rows, StringList& sl, const std::vector<String>& optional_columns) const;
 
     String generateMzTabProteinHeader_(const MzTabProteinSectionRow& reference_row, const Size n_best_search_engine_scores, const std::vector<String>& optional_columns) const;
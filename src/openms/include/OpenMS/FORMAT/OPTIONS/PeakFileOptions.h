@@ -223,6 +223,21 @@ public:
 
     /// do these options skip spectra or chromatograms due to RT or MSLevel filters?
     bool hasFilters();
+
+    /**
+        @name Indexed selection
+
+        If enabled, RT and MS level filters are applied before parsing when
+        reading indexed mzML files: the spectra to load are looked up in a
+        metadata index (see MzMLSpectrumMetaIndex) and only their part of the
+        file is read (using the offsets of the indexedmzML index).
+    */
+    //@{
+    /// sets whether to select spectra through the file index (if possible)
+    void setUseIndexedSelection(bool use);
+    /// returns whether to select spectra through the file index (if possible)
+    bool getUseIndexedSelection() const;
+    //@}
     
 private:
     bool metadata_only_;
@@ -249,6 +264,7 @@ private:
     MSNumpressCoder::NumpressConfig np_config_int_;
     MSNumpressCoder::NumpressConfig np_config_fda_;
     Size maximal_data_pool_size_;
+    bool use_indexed_selection_;
 
   };
 
@@ -0,0 +1,222 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2018.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: Hannes Roest $
+// $Authors: Hannes Roest $
+// --------------------------------------------------------------------------
+
+
+#pragma once
+
+#include <OpenMS/CONCEPT/Types.h>
+#include <OpenMS/DATASTRUCTURES/ListUtils.h>
+#include <OpenMS/DATASTRUCTURES/String.h>
+#include <OpenMS/FORMAT/FASTAFile.h>
+
+#include <boost/shared_ptr.hpp>
+
+#include <utility>
+#include <vector>
+
+namespace boost
+{
+  namespace interprocess
+  {
+    class mapped_region;
+  }
+}
+
+namespace OpenMS
+{
+
+  /**
+    @brief A binary database of digested and modified peptides
+
+    Search engines need the unique peptides of a protein database, digested
+    with the search settings, with all their modified variants and masses.
+    Computing these takes a considerable amount of time for large databases
+    with variable modifications and is repeated for every search. This class
+    stores the result of digestion and modification in a binary file that
+    can be created once (see store() and the PeptideDatabaseBuilder tool) and
+    loaded quickly for each search (see load()).
+
+    The file contains the protein accessions, the unique unmodified peptides
+    with references to the proteins they occur in (protein, position and
+    flanking residues) and all modified variants of the peptides sorted by
+    their mass, so the variants within a mass window can be found with a
+    binary search (see getVariantRange()). All records have a fixed size and
+    are read directly from the file, which is memory-mapped read-only
+    whenever possible. Processes loading the same file therefore share its
+    pages in the page cache of the operating system. If the file cannot be
+    mapped, it is read into memory instead.
+
+    The digestion and modification settings are stored in the file, search
+    engines should compare them to their own settings (see getSettings()).
+
+    @note Peptides containing ambiguous residues (B, J, X, Z) are not stored.
+    The file uses the byte order of the machine it was created on.
+
+    @ingroup FileIO
+  */
+  class OPENMS_DLLAPI PeptideDatabaseFile
+  {
+public:
+    /// Digestion and modification settings of a database
+    struct OPENMS_DLLAPI Settings
+    {
+      /// Name of the enzyme (see ProteaseDB)
+      String enzyme = "Trypsin";
+      /// Number of missed cleavages
+      Size missed_cleavages = 1;
+      /// Minimal peptide length
+      Size min_length = 7;
+      /// Maximal peptide length (0 = no limit)
+      Size max_length = 40;
+      /// Fixed modifications (UniMod names, e.g. 'Carbamidomethyl (C)')
+      StringList fixed_modifications;
+      /// Variable modifications (UniMod names, e.g. 'Oxidation (M)')
+      StringList variable_modifications;
+      /// Maximal number of variable modifications per peptide
+      Size max_variable_mods_per_peptide = 2;
+
+      bool operator==(const Settings& rhs) const;
+      bool operator!=(const Settings& rhs) const;
+    };
+
+    /// Occurrence of a peptide in a protein
+    struct PeptideReference
+    {
+      /// Index of the protein
+      Size protein;
+      /// Position of the peptide in the protein sequence
+      Size start;
+      /// Residue before the peptide ('[' at the protein N-terminus)
+      char aa_before;
+      /// Residue after the peptide (']' at the protein C-terminus)
+      char aa_after;
+    };
+
+    /// Default constructor (empty database)
+    PeptideDatabaseFile();
+
+    /**
+      @brief Digests and modifies proteins and stores the result
+
+      @param filename The database file
+      @param proteins The proteins
+      @param settings Digestion and modification settings
+
+      @exception Exception::UnableToCreateFile is thrown if the file cannot be created
+      @exception Exception::ElementNotFound is thrown for unknown enzymes or modifications
+    */
+    static void store(const String& filename, const std::vector<FASTAFile::FASTAEntry>& proteins, const Settings& settings);
+
+    /**
+      @brief Loads a database file created by store()
+
+      Copies of this object share the loaded data.
+
+      @exception Exception::FileNotFound is thrown if the file does not exist
+      @exception Exception::ParseError is thrown if the file is not a valid database file
+    */
+    void load(const String& filename);
+
+    /// Whether the database file is accessed through a memory mapping
+    bool isMemoryMapped() const;
+
+    /// Settings the database was created with
+    const Settings& getSettings() const;
+
+    /// Number of proteins
+    Size getNrProteins() const;
+
+    /// Number of unique unmodified peptides
+    Size getNrPeptides() const;
+
+    /// Number of modified variants of all peptides
+    Size getNrVariants() const;
+
+    /// Accession of a protein
+    String getProteinAccession(Size protein) const;
+
+    /// Unmodified sequence of a peptide (valid as long as the database is loaded)
+    StringView getPeptideSequence(Size peptide) const;
+
+    /// Proteins a peptide occurs in
+    void getPeptideReferences(Size peptide, std::vector<PeptideReference>& references) const;
+
+    /// Mass of a variant (variants are sorted by mass)
+    double getVariantMass(Size variant) const;
+
+    /// Modified sequence of a variant as used by AASequence::fromString() (valid as long as the database is loaded)
+    StringView getVariantSequence(Size variant) const;
+
+    /// The (unmodified) peptide of a variant
+    Size getVariantPeptide(Size variant) const;
+
+    /// Returns the range [first, second) of variants with masses in [@p mass_min, @p mass_max]
+    std::pair<Size, Size> getVariantRange(double mass_min, double mass_max) const;
+
+protected:
+    /// File header
+    struct Header_;
+    struct ProteinRecord_;
+    struct PeptideRecord_;
+    struct ReferenceRecord_;
+    struct VariantRecord_;
+
+    /// Returns a pointer into the loaded file
+    const char* data_(UInt64 offset) const;
+
+    const ProteinRecord_& protein_(Size protein) const;
+    const PeptideRecord_& peptide_(Size peptide) const;
+    const VariantRecord_& variant_(Size variant) const;
+
+    String filename_;
+    Settings settings_;
+
+    /// Read-only memory mapping of the file (shared between copies, empty if not mapped)
+    boost::shared_ptr<boost::interprocess::mapped_region> mapped_region_;
+    /// File content (only used if the file could not be memory-mapped)
+    boost::shared_ptr<std::vector<char> > buffer_;
+    /// Start and size of the loaded file
+    const char* begin_;
+    UInt64 size_;
+
+    Size nr_proteins_;
+    Size nr_peptides_;
+    Size nr_variants_;
+    UInt64 protein_table_;
+    UInt64 peptide_table_;
+    UInt64 reference_table_;
+    UInt64 variant_table_;
+  };
+
+}
@@ -87,6 +87,8 @@ public:
       @param first_n If set, only @p first_n lines the lines from the beginning of the file are read
       @param skip_empty_lines Should empty lines be skipped? If used in conjunction with @p trim_lines, also lines with only whitespace will be skipped. Skipped lines do not count towards the total number of read lines.
 
+      Files compressed with gzip or bzip2 are detected by their content and decompressed transparently.
+
       @exception Exception::FileNotFound is thrown if the file could not be opened.
     */
     void load(const String& filename, bool trim_lines = false, Int first_n = -1, bool skip_empty_lines = false);
@@ -138,6 +140,12 @@ public:
 protected:
     /// Internal buffer storing the lines before writing them to the file.
     std::vector<String> buffer_;
+
+    /// Reads the lines from @p is (see load())
+    void load_(std::istream& is, bool trim_lines, Int first_n, bool skip_empty_lines);
+
+    /// Splits the complete file content @p content into lines (see load())
+    void loadBuffer_(const std::string& content, bool trim_lines, bool skip_empty_lines);
   };
 
 } // namespace OpenMS
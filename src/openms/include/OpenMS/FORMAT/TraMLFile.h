@@ -38,10 +38,13 @@
 #include <OpenMS/CONCEPT/ProgressLogger.h>
 #include <OpenMS/DATASTRUCTURES/ListUtils.h>
 
+#include <functional>
+
 namespace OpenMS
 {
   class Identification;
   class TargetedExperiment;
+  class ReactionMonitoringTransition;
 
   /**
       @brief File adapter for HUPO PSI TraML files
@@ -65,6 +68,12 @@ namespace OpenMS
     public ProgressLogger
   {
 public:
+    /// Callback receiving each transition that is read (see load())
+    typedef std::function<void (const ReactionMonitoringTransition&)> TransitionConsumer;
+
+    /// Callback supplying the transitions to write, returns false if there are no more transitions (see store())
+    typedef std::function<bool (ReactionMonitoringTransition&)> TransitionSupplier;
+
     ///Default constructor
     TraMLFile();
     ///Destructor
@@ -85,6 +94,31 @@ public:
     */
     void store(const String & filename, const TargetedExperiment & id) const;
 
+    /**
+        @brief Loads a TraML file without keeping its transitions in memory.
+
+        All content except for the transitions is stored in @p exp. Each
+        transition is passed to @p consumer as soon as it has been parsed and
+        is not stored in @p exp. The proteins, peptides and compounds precede
+        the transitions in a TraML file, they are thus already available in
+        @p exp when @p consumer is called.
+
+        @exception Exception::FileNotFound is thrown if the file could not be opened
+        @exception Exception::ParseError is thrown if an error occurs during parsing
+    */
+    void load(const String & filename, TargetedExperiment & exp, const TransitionConsumer & consumer);
+
+    /**
+        @brief Stores a TraML file without keeping its transitions in memory.
+
+        All content except for the transitions is taken from @p exp (its
+        transitions are ignored). The transitions are written one at a time,
+        @p supplier is called until it returns false.
+
+        @exception Exception::UnableToCreateFile is thrown if the file could not be created
+    */
+    void store(const String & filename, const TargetedExperiment & exp, const TransitionSupplier & supplier) const;
+
     /**
         @brief Checks if a file is valid with respect to the mapping file and the controlled vocabulary.
 
@@ -34,12 +34,14 @@ DTAFile.h
 EDTAFile.h
 ExperimentalDesignFile.h
 FASTAFile.h
+FASTAIndex.h
 FeatureXMLFile.h
 FileHandler.h
 GzipIfstream.h
 GzipInputStream.h
 IBSpectraFile.h
 IdXMLFile.h
+InMemoryFileStore.h
 IndexedMzMLFileLoader.h
 InspectInfile.h
 InspectOutfile.h
@@ -59,6 +61,8 @@ MascotXMLFile.h
 MsInspectFile.h
 MzDataFile.h
 MzMLFile.h
+MzMLSpectrumMetaIndex.h
+MzMLTailReader.h
 MzTab.h
 MzTabFile.h
 MzXMLFile.h
@@ -72,6 +76,7 @@ PepNovoInfile.h
 PepNovoOutfile.h
 PepXMLFile.h
 PepXMLFileMascot.h
+PeptideDatabaseFile.h
 PercolatorOutfile.h
 ProtXMLFile.h
 QcMLFile.h
@@ -0,0 +1,82 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2018.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: Timo Sachsenberg $
+// $Authors: Timo Sachsenberg $
+// --------------------------------------------------------------------------
+
+#pragma once
+
+#include <OpenMS/config.h>
+
+namespace OpenMS
+{
+  class ProteinIdentification;
+  class PeptideIdentification;
+
+namespace Interfaces
+{
+
+    /**
+      @brief The interface of a consumer of protein and peptide identifications
+
+      Analogous to IMSDataConsumer, the consumer is handed identifications one
+      at a time while a file is being read (see e.g. IdXMLFile::load) and may
+      process or modify them. This allows processing of large identification
+      files without ever holding all PeptideIdentification objects in memory.
+
+      Every ProteinIdentification (identification run) is consumed before the
+      PeptideIdentification objects that belong to it.
+    */
+    class OPENMS_DLLAPI IDConsumer
+    {
+    public:
+      virtual ~IDConsumer() {}
+
+      /**
+        @brief Consume a protein identification (run)
+
+        @param prot_id The protein identification to be consumed
+      */
+      virtual void consumeProteinID(ProteinIdentification& prot_id) = 0;
+
+      /**
+        @brief Consume a peptide identification
+
+        The peptide identification will be consumed by the implementation and possibly modified.
+
+        @param pep_id The peptide identification to be consumed
+      */
+      virtual void consumePeptideID(PeptideIdentification& pep_id) = 0;
+    };
+
+} //end namespace Interfaces
+} //end namespace OpenMS
+
@@ -88,6 +88,9 @@ public:
     /// Copy constructor
     BaseFeature(const BaseFeature& feature);
 
+    /// Move constructor
+    BaseFeature(BaseFeature&&) = default;
+
     /// Constructor from raw data point
     explicit BaseFeature(const Peak2D& point);
 
@@ -145,6 +148,9 @@ public:
     /// Assignment operator
     BaseFeature& operator=(const BaseFeature& rhs);
 
+    /// Move assignment operator
+    BaseFeature& operator=(BaseFeature&&) & = default;
+
     /// Equality operator
     bool operator==(const BaseFeature& rhs) const;
 
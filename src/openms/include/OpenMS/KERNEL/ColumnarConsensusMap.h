@@ -0,0 +1,225 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2018.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: Timo Sachsenberg$
+// $Authors: Timo Sachsenberg $
+// --------------------------------------------------------------------------
+
+#pragma once
+
+#include <OpenMS/CONCEPT/Types.h>
+
+#include <vector>
+
+namespace OpenMS
+{
+  class ConsensusMap;
+
+  /**
+    @brief Column-oriented (compressed sparse row) storage of the quantitative data of a ConsensusMap
+
+    ConsensusMap stores the feature handles of every ConsensusFeature in a
+    std::set<FeatureHandle>, i.e. one tree node per handle. For cohort-scale
+    studies with thousands of maps this dominates the memory consumption and
+    makes column-wise operations (e.g. computing per-map medians) slow.
+
+    This class stores the handles as a sparse consensus feature x map matrix
+    in compressed sparse row (CSR) layout: the handles of consensus feature
+    @em i are found at positions getRowOffsets()[i] to getRowOffsets()[i + 1]
+    (exclusive) of the handle columns (map index, unique id, RT, m/z,
+    intensity, charge and width), ordered by map index. The consensus
+    features themselves are stored column-wise as well (RT, m/z, intensity,
+    charge, quality, width and unique id).
+
+    Only the quantitative data is held. All other data (peptide
+    identifications, meta values, column headers, ...) remains with the
+    ConsensusMap the data was taken from: convert with
+    ColumnarConsensusMap(const ConsensusMap&) and write the data back with
+    exportFeatures().
+
+    @ingroup Kernel
+  */
+  class OPENMS_DLLAPI ColumnarConsensusMap
+  {
+public:
+
+    ///@name Type definitions
+    //@{
+    typedef std::vector<double> CoordinateContainer;
+    typedef std::vector<float> IntensityContainer;
+    //@}
+
+    /// Default constructor
+    ColumnarConsensusMap();
+
+    /// Constructor copying the quantitative data of a ConsensusMap
+    explicit ColumnarConsensusMap(const ConsensusMap& map);
+
+    /// Copy constructor
+    ColumnarConsensusMap(const ColumnarConsensusMap&) = default;
+
+    /// Move constructor
+    ColumnarConsensusMap(ColumnarConsensusMap&&) = default;
+
+    /// Assignment operator
+    ColumnarConsensusMap& operator=(const ColumnarConsensusMap&) = default;
+
+    /// Move assignment operator
+    ColumnarConsensusMap& operator=(ColumnarConsensusMap&&) = default;
+
+    /// Destructor
+    ~ColumnarConsensusMap() = default;
+
+    /// Equality operator (compares all columns)
+    bool operator==(const ColumnarConsensusMap& rhs) const;
+
+    /// Equality operator
+    bool operator!=(const ColumnarConsensusMap& rhs) const
+    {
+      return !(operator==(rhs));
+    }
+
+    ///@name Conversion from and to ConsensusMap
+    //@{
+    /**
+      @brief Replaces the content with the quantitative data of @p map
+
+      The number of maps is one more than the largest map index found in the
+      column headers or feature handles. Map sizes are taken from the column
+      headers (0 for indices without a header).
+    */
+    void assign(const ConsensusMap& map);
+
+    /**
+      @brief Writes the data stored here back into the consensus features of @p map
+
+      @p map is resized to getNumberOfFeatures(). RT, m/z, intensity, charge,
+      quality, width, unique id and the feature handles of each consensus feature
+      are replaced, all other data (peptide identifications, meta values) of
+      existing consensus features is kept.
+    */
+    void exportFeatures(ConsensusMap& map) const;
+
+    /**
+      @brief Writes the handle intensities back into @p map
+
+      Only the intensities of the feature handles are updated. This is
+      cheaper than exportFeatures() after e.g. normalization.
+
+      @exception Exception::IllegalArgument is thrown if @p map does not have the layout of this object (number of features or handles differ)
+    */
+    void exportIntensities(ConsensusMap& map) const;
+    //@}
+
+    ///@name Dimensions
+    //@{
+    /// Number of consensus features (rows)
+    Size getNumberOfFeatures() const { return rt_.size(); }
+    /// Number of maps (columns)
+    Size getNumberOfMaps() const { return map_sizes_.size(); }
+    /// Total number of feature handles (non-zero entries)
+    Size getNumberOfHandles() const { return handle_map_index_.size(); }
+    /// Number of features of each input map (from the column headers)
+    const std::vector<Size>& getMapSizes() const { return map_sizes_; }
+    bool empty() const { return rt_.empty(); }
+    void clear();
+    //@}
+
+    ///@name Consensus feature columns
+    //@{
+    const CoordinateContainer& getRTs() const { return rt_; }
+    const CoordinateContainer& getMZs() const { return mz_; }
+    const IntensityContainer& getIntensities() const { return intensity_; }
+    IntensityContainer& getIntensities() { return intensity_; }
+    const std::vector<Int>& getCharges() const { return charge_; }
+    const std::vector<float>& getQualities() const { return quality_; }
+    const std::vector<float>& getWidths() const { return width_; }
+    const std::vector<UInt64>& getUniqueIds() const { return unique_id_; }
+    //@}
+
+    ///@name Feature handle columns (CSR layout)
+    //@{
+    /// Row offsets into the handle columns (getNumberOfFeatures() + 1 elements)
+    const std::vector<Size>& getRowOffsets() const { return row_offsets_; }
+    const std::vector<UInt64>& getHandleMapIndices() const { return handle_map_index_; }
+    const std::vector<UInt64>& getHandleUniqueIds() const { return handle_unique_id_; }
+    const CoordinateContainer& getHandleRTs() const { return handle_rt_; }
+    const CoordinateContainer& getHandleMZs() const { return handle_mz_; }
+    const IntensityContainer& getHandleIntensities() const { return handle_intensity_; }
+    IntensityContainer& getHandleIntensities() { return handle_intensity_; }
+    const std::vector<Int>& getHandleCharges() const { return handle_charge_; }
+    const std::vector<float>& getHandleWidths() const { return handle_width_; }
+
+    /**
+      @brief Position of the handle of map @p map_index in consensus feature @p feature
+
+      @return The index into the handle columns (of the first handle if there are several), or -1 if the map has no handle in this consensus feature
+    */
+    SignedSize findHandle(Size feature, UInt64 map_index) const;
+    //@}
+
+    ///@name Dense matrices
+    //@{
+    /**
+      @brief Dense, row-major (consensus feature x map) matrix of handle intensities
+
+      Entries without a handle are set to @p missing.
+    */
+    void getIntensityMatrix(std::vector<double>& matrix, double missing = 0.0) const;
+
+    /// Intensities of all handles of map @p map_index (column of the matrix, missing entries are skipped)
+    void getMapIntensities(UInt64 map_index, std::vector<double>& intensities) const;
+    //@}
+
+protected:
+    /// consensus feature columns
+    CoordinateContainer rt_;
+    CoordinateContainer mz_;
+    IntensityContainer intensity_;
+    std::vector<Int> charge_;
+    std::vector<float> quality_;
+    std::vector<float> width_;
+    std::vector<UInt64> unique_id_;
+
+    /// handle columns, CSR layout
+    std::vector<Size> row_offsets_;
+    std::vector<UInt64> handle_map_index_;
+    std::vector<UInt64> handle_unique_id_;
+    CoordinateContainer handle_rt_;
+    CoordinateContainer handle_mz_;
+    IntensityContainer handle_intensity_;
+    std::vector<Int> handle_charge_;
+    std::vector<float> handle_width_;
+
+    /// number of features per input map
+    std::vector<Size> map_sizes_;
+  };
+
+} // namespace OpenMS
@@ -0,0 +1,321 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2018.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: Timo Sachsenberg$
+// $Authors: Hannes Roest $
+// --------------------------------------------------------------------------
+
+#pragma once
+
+#include <OpenMS/KERNEL/Peak1D.h>
+#include <OpenMS/CONCEPT/Types.h>
+
+#include <iterator>
+#include <vector>
+
+namespace OpenMS
+{
+  class MSSpectrum;
+
+  namespace Internal
+  {
+    /**
+      @brief Reference-like proxy to one peak of a ColumnarSpectrum
+
+      Provides the Peak1D accessors on top of an (m/z, intensity) pointer pair.
+      Setters are only available for the mutable variant.
+    */
+    template <typename MZType, typename IntensityT>
+    class ColumnarPeakProxy
+    {
+public:
+      ColumnarPeakProxy(MZType* mz, IntensityT* intensity) :
+        mz_(mz),
+        intensity_(intensity)
+      {}
+
+      Peak1D::CoordinateType getMZ() const { return *mz_; }
+      Peak1D::CoordinateType getPos() const { return *mz_; }
+      Peak1D::IntensityType getIntensity() const { return *intensity_; }
+
+      void setMZ(Peak1D::CoordinateType mz) { *mz_ = mz; }
+      void setPos(Peak1D::CoordinateType mz) { *mz_ = mz; }
+      void setIntensity(Peak1D::IntensityType intensity) { *intensity_ = intensity; }
+
+      /// Conversion to a stand-alone peak
+      operator Peak1D() const { return Peak1D(*mz_, *intensity_); }
+
+private:
+      MZType* mz_;
+      IntensityT* intensity_;
+    };
+
+    /**
+      @brief Random access iterator over the two columns of a ColumnarSpectrum
+
+      Dereferencing yields a ColumnarPeakProxy instead of a real reference,
+      therefore algorithms that swap elements through the iterator (e.g.
+      std::sort) are not supported. Use ColumnarSpectrum::sortByPosition()
+      instead. Searching algorithms (std::lower_bound etc.) work as expected.
+    */
+    template <typename MZType, typename IntensityT>
+    class ColumnarPeakIterator
+    {
+public:
+      typedef ColumnarPeakProxy<MZType, IntensityT> Proxy;
+
+      typedef std::random_access_iterator_tag iterator_category;
+      typedef Peak1D value_type;
+      typedef std::ptrdiff_t difference_type;
+      typedef Proxy reference;
+
+      /// Helper returned by operator-> to allow it->getMZ()
+      struct ArrowProxy
+      {
+        Proxy p;
+        Proxy* operator->() { return &p; }
+      };
+      typedef ArrowProxy pointer;
+
+      ColumnarPeakIterator() :
+        mz_(nullptr),
+        intensity_(nullptr)
+      {}
+
+      ColumnarPeakIterator(MZType* mz, IntensityT* intensity) :
+        mz_(mz),
+        intensity_(intensity)
+      {}
+
+      /// Conversion from mutable to non-mutable iterator
+      template <typename M, typename I>
+      ColumnarPeakIterator(const ColumnarPeakIterator<M, I>& rhs) :
+        mz_(rhs.mzPtr()),
+        intensity_(rhs.intensityPtr())
+      {}
+
+      reference operator*() const { return Proxy(mz_, intensity_); }
+      pointer operator->() const { ArrowProxy a = {Proxy(mz_, intensity_)}; return a; }
+      reference operator[](difference_type n) const { return Proxy(mz_ + n, intensity_ + n); }
+
+      ColumnarPeakIterator& operator++() { ++mz_; ++intensity_; return *this; }
+      ColumnarPeakIterator operator++(int) { ColumnarPeakIterator tmp(*this); ++(*this); return tmp; }
+      ColumnarPeakIterator& operator--() { --mz_; --intensity_; return *this; }
+      ColumnarPeakIterator operator--(int) { ColumnarPeakIterator tmp(*this); --(*this); return tmp; }
+      ColumnarPeakIterator& operator+=(difference_type n) { mz_ += n; intensity_ += n; return *this; }
+      ColumnarPeakIterator& operator-=(difference_type n) { mz_ -= n; intensity_ -= n; return *this; }
+      ColumnarPeakIterator operator+(difference_type n) const { return ColumnarPeakIterator(mz_ + n, intensity_ + n); }
+      ColumnarPeakIterator operator-(difference_type n) const { return ColumnarPeakIterator(mz_ - n, intensity_ - n); }
+      difference_type operator-(const ColumnarPeakIterator& rhs) const { return mz_ - rhs.mz_; }
+
+      bool operator==(const ColumnarPeakIterator& rhs) const { return mz_ == rhs.mz_; }
+      bool operator!=(const ColumnarPeakIterator& rhs) const { return mz_ != rhs.mz_; }
+      bool operator<(const ColumnarPeakIterator& rhs) const { return mz_ < rhs.mz_; }
+      bool operator>(const ColumnarPeakIterator& rhs) const { return mz_ > rhs.mz_; }
+      bool operator<=(const ColumnarPeakIterator& rhs) const { return mz_ <= rhs.mz_; }
+      bool operator>=(const ColumnarPeakIterator& rhs) const { return mz_ >= rhs.mz_; }
+
+      /// Pointer into the m/z column at the current position
+      MZType* mzPtr() const { return mz_; }
+      /// Pointer into the intensity column at the current position
+      IntensityT* intensityPtr() const { return intensity_; }
+
+private:
+      MZType* mz_;
+      IntensityT* intensity_;
+    };
+  }
+
+  /**
+    @brief Column-oriented (structure-of-arrays) storage of spectrum peak data
+
+    MSSpectrum stores its peaks as a vector of Peak1D, interleaving the m/z
+    (double) and intensity (float) of each peak, which occupies 16 bytes per
+    peak due to padding. Many algorithms only access one of the two values at
+    a time; for them this class stores m/z and intensity in two separate
+    contiguous arrays (12 bytes per peak) which can be processed with simple,
+    auto-vectorizable loops (see getMZData() and getIntensityData()).
+
+    Only the peak data together with retention time and MS level is held. All
+    other meta data (SpectrumSettings, data arrays) remains with the
+    MSSpectrum the data was taken from: convert with ColumnarSpectrum(const
+    MSSpectrum&) and write the peaks back with exportPeaks().
+
+    The iterators provide the Peak1D accessors (getMZ(), getIntensity(),
+    setMZ(), setIntensity()) through a proxy object.
+
+    @ingroup Kernel
+  */
+  class OPENMS_DLLAPI ColumnarSpectrum
+  {
+public:
+
+    ///@name Type definitions
+    //@{
+    typedef Peak1D PeakType;
+    typedef Peak1D::CoordinateType CoordinateType;
+    typedef Peak1D::IntensityType IntensityType;
+    typedef std::vector<CoordinateType> MZContainer;
+    typedef std::vector<IntensityType> IntensityContainer;
+
+    typedef Internal::ColumnarPeakIterator<CoordinateType, IntensityType> Iterator;
+    typedef Internal::ColumnarPeakIterator<const CoordinateType, const IntensityType> ConstIterator;
+    typedef Iterator iterator;
+    typedef ConstIterator const_iterator;
+    typedef Size size_type;
+    //@}
+
+    /// Default constructor
+    ColumnarSpectrum();
+
+    /// Constructor copying the peaks, RT and MS level of an MSSpectrum
+    explicit ColumnarSpectrum(const MSSpectrum& spectrum);
+
+    /// Copy constructor
+    ColumnarSpectrum(const ColumnarSpectrum&) = default;
+
+    /// Move constructor
+    ColumnarSpectrum(ColumnarSpectrum&&) = default;
+
+    /// Assignment operator
+    ColumnarSpectrum& operator=(const ColumnarSpectrum&) = default;
+
+    /// Move assignment operator
+    ColumnarSpectrum& operator=(ColumnarSpectrum&&) = default;
+
+    /// Destructor
+    ~ColumnarSpectrum() = default;
+
+    /// Equality operator (compares peaks, RT and MS level)
+    bool operator==(const ColumnarSpectrum& rhs) const;
+
+    /// Equality operator
+    bool operator!=(const ColumnarSpectrum& rhs) const
+    {
+      return !(operator==(rhs));
+    }
+
+    ///@name Conversion from and to MSSpectrum
+    //@{
+    /// Replaces the content with peaks, RT and MS level of @p spectrum
+    void assign(const MSSpectrum& spectrum);
+
+    /**
+      @brief Replaces the peaks of @p spectrum with the peaks stored here
+
+      Also sets RT and MS level. All other meta data of @p spectrum is kept,
+      but its data arrays need to match the new number of peaks.
+    */
+    void exportPeaks(MSSpectrum& spectrum) const;
+    //@}
+
+    ///@name Accessors
+    //@{
+    double getRT() const { return rt_; }
+    void setRT(double rt) { rt_ = rt; }
+    UInt getMSLevel() const { return ms_level_; }
+    void setMSLevel(UInt ms_level) { ms_level_ = ms_level; }
+
+    Size size() const { return mz_.size(); }
+    bool empty() const { return mz_.empty(); }
+    void clear() { mz_.clear(); intensity_.clear(); }
+    void reserve(Size n) { mz_.reserve(n); intensity_.reserve(n); }
+    void resize(Size n) { mz_.resize(n); intensity_.resize(n); }
+
+    void push_back(CoordinateType mz, IntensityType intensity)
+    {
+      mz_.push_back(mz);
+      intensity_.push_back(intensity);
+    }
+    void push_back(const PeakType& p) { push_back(p.getMZ(), p.getIntensity()); }
+
+    CoordinateType getMZ(Size i) const { return mz_[i]; }
+    IntensityType getIntensity(Size i) const { return intensity_[i]; }
+    void setMZ(Size i, CoordinateType mz) { mz_[i] = mz; }
+    void setIntensity(Size i, IntensityType intensity) { intensity_[i] = intensity; }
+
+    /// Contiguous m/z column (size() elements)
+    const CoordinateType* getMZData() const { return mz_.data(); }
+    CoordinateType* getMZData() { return mz_.data(); }
+    /// Contiguous intensity column (size() elements)
+    const IntensityType* getIntensityData() const { return intensity_.data(); }
+    IntensityType* getIntensityData() { return intensity_.data(); }
+
+    const MZContainer& getMZArray() const { return mz_; }
+    const IntensityContainer& getIntensityArray() const { return intensity_; }
+    //@}
+
+    ///@name Iterators
+    //@{
+    Iterator begin() { return Iterator(mz_.data(), intensity_.data()); }
+    Iterator end() { return begin() + static_cast<std::ptrdiff_t>(size()); }
+    ConstIterator begin() const { return ConstIterator(mz_.data(), intensity_.data()); }
+    ConstIterator end() const { return begin() + static_cast<std::ptrdiff_t>(size()); }
+    ConstIterator cbegin() const { return begin(); }
+    ConstIterator cend() const { return end(); }
+    //@}
+
+    ///@name Sorting and searching
+    //@{
+    /// Lexicographically sorts the peaks by their position (m/z)
+    void sortByPosition();
+
+    /// Checks if all peaks are sorted with respect to ascending m/z
+    bool isSorted() const;
+
+    /**
+      @brief Binary search for the peak nearest to a specific m/z
+
+      @return Index of the nearest peak
+      @note Make sure the spectrum is sorted with respect to m/z! Otherwise the result is undefined.
+      @exception Exception::Precondition is thrown if the spectrum is empty
+    */
+    Size findNearest(CoordinateType mz) const;
+
+    /// Binary search for the first peak with m/z >= @p mz (spectrum has to be sorted)
+    Iterator MZBegin(CoordinateType mz);
+    ConstIterator MZBegin(CoordinateType mz) const;
+
+    /// Binary search for the first peak with m/z > @p mz (spectrum has to be sorted)
+    Iterator MZEnd(CoordinateType mz);
+    ConstIterator MZEnd(CoordinateType mz) const;
+
+    /// Sum of all intensities
+    double calculateTIC() const;
+    //@}
+
+protected:
+    MZContainer mz_;
+    IntensityContainer intensity_;
+    double rt_;
+    UInt ms_level_;
+  };
+
+} // namespace OpenMS
@@ -162,6 +162,9 @@ public:
     /// Copy constructor
     ConsensusFeature(const ConsensusFeature& rhs);
 
+    /// Move constructor
+    ConsensusFeature(ConsensusFeature&&) = default;
+
     /// Constructor from basic feature
     explicit ConsensusFeature(const BaseFeature& feature);
 
@@ -184,6 +187,9 @@ public:
     /// Assignment operator
     ConsensusFeature& operator=(const ConsensusFeature& rhs);
 
+    /// Move assignment operator
+    ConsensusFeature& operator=(ConsensusFeature&&) & = default;
+
     /// Destructor
     ~ConsensusFeature() override;
     //@}
@@ -150,6 +150,9 @@ public:
     /// Copy constructor
     OPENMS_DLLAPI ConsensusMap(const ConsensusMap& source);
 
+    /// Move constructor
+    OPENMS_DLLAPI ConsensusMap(ConsensusMap&& source);
+
     /// Destructor
     OPENMS_DLLAPI ~ConsensusMap() override;
 
@@ -159,6 +162,9 @@ public:
     /// Assignment operator
     OPENMS_DLLAPI ConsensusMap& operator=(const ConsensusMap& source);
 
+    /// Move assignment operator
+    OPENMS_DLLAPI ConsensusMap& operator=(ConsensusMap&&) &;
+
     /**
       @brief Add consensus map entries as new rows.
 
@@ -80,6 +80,9 @@ public:
     /// Copy constructor
     Feature(const Feature& feature);
 
+    /// Move constructor
+    Feature(Feature&&) = default;
+
     /// Destructor
     ~Feature() override;
     //@}
@@ -120,11 +123,25 @@ public:
 
     /// Returns if the mass trace convex hulls of the feature enclose the position specified by @p rt and @p mz
     bool encloses(double rt, double mz) const;
+
+    /**
+      @brief Reduces the memory footprint of the convex hulls (including those of the subordinates)
+
+      All mass trace hulls are converted to their compact representation (see
+      ConvexHull2D::compact()), which is what is written to featureXML anyway.
+      Afterwards encloses() is no longer supported.
+
+      @param bounding_boxes_only Keep only the bounding box of each mass trace hull
+    */
+    void compactConvexHulls(bool bounding_boxes_only = false);
     //@}
 
     /// Assignment operator
     Feature& operator=(const Feature& rhs);
 
+    /// Move assignment operator
+    Feature& operator=(Feature&&) & = default;
+
     /// Equality operator
     bool operator==(const Feature& rhs) const;
 
@@ -153,6 +153,9 @@ public:
     /// Copy constructor
     OPENMS_DLLAPI FeatureMap(const FeatureMap& source);
 
+    /// Move constructor
+    OPENMS_DLLAPI FeatureMap(FeatureMap&& source);
+
     /// Destructor
     OPENMS_DLLAPI ~FeatureMap() override;
     //@}
@@ -160,6 +163,9 @@ public:
     /// Assignment operator
     OPENMS_DLLAPI FeatureMap& operator=(const FeatureMap& rhs);
 
+    /// Move assignment operator
+    OPENMS_DLLAPI FeatureMap& operator=(FeatureMap&&) &;
+
     /// Equality operator
     OPENMS_DLLAPI bool operator==(const FeatureMap& rhs) const;
 
@@ -213,6 +219,17 @@ public:
     // Docu in base class
     OPENMS_DLLAPI void updateRanges() override;
 
+    /**
+      @brief Reduces the memory footprint of the convex hulls of all features (see Feature::compactConvexHulls())
+
+      Useful for large maps (e.g. before storing them), once encloses() queries
+      are no longer needed. The features are processed in parallel if OpenMP
+      is enabled.
+
+      @param bounding_boxes_only Keep only the bounding box of each mass trace hull
+    */
+    OPENMS_DLLAPI void compactConvexHulls(bool bounding_boxes_only = false);
+
     /// Swaps the feature content (plus its range information) of this map with the content of @p from
     OPENMS_DLLAPI void swapFeaturesOnly(FeatureMap& from);
 
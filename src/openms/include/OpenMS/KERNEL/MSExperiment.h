@@ -331,6 +331,25 @@ public:
       }
     }
 
+    /**
+      @brief Copies the peaks of all spectra into concatenated arrays
+
+      The peaks of spectrum @em i are stored at positions [offsets[i], offsets[i + 1]) of @p mz and
+      @p intensity, i.e. @p offsets has size() + 1 entries. This allows bindings (e.g. pyOpenMS) to
+      access all peaks of an experiment with a single copy instead of one per spectrum.
+    */
+    void getPeakArrays(std::vector<double>& mz, std::vector<float>& intensity, std::vector<Size>& offsets) const;
+
+    /**
+      @brief Replaces the peaks of all spectra by concatenated arrays as returned by getPeakArrays()
+
+      Spectrum meta data is kept. The float, integer and string data arrays of a spectrum are
+      cleared if its number of peaks changes.
+
+      @exception Exception::InvalidParameter is thrown if the arrays do not fit to each other or to the number of spectra
+    */
+    void setPeakArrays(const std::vector<double>& mz, const std::vector<float>& intensity, const std::vector<Size>& offsets);
+
     //@}
 
 
@@ -342,7 +361,11 @@ public:
     /// Returns an invalid area iterator marking the end of an area
     AreaIterator areaEnd();
 
-    /// Returns a non-mutable area iterator for @p area
+    /**
+      @brief Returns a non-mutable area iterator for @p area
+
+      @see MSExperimentAreaIndex for issuing many area queries on the same (unchanged) experiment
+    */
     ConstAreaIterator areaBeginConst(CoordinateType min_rt, CoordinateType max_rt, CoordinateType min_mz, CoordinateType max_mz) const;
 
     /// Returns an non-mutable invalid area iterator marking the end of an area
@@ -395,9 +418,30 @@ public:
       @brief Updates the m/z, intensity, retention time and MS level ranges of all spectra with a certain ms level
 
       @param ms_level MS level to consider for m/z range , RT range and intensity range (All MS levels if negative)
+
+      The ranges of the individual spectra and chromatograms are updated in parallel if OpenMP is enabled.
     */
     void updateRanges(Int ms_level);
 
+    /**
+      @brief Updates the ranges after only some spectra were modified
+
+      Only the ranges of the spectra @p modified_spectra (indices) are
+      recomputed from their peaks. For all other spectra and all
+      chromatograms the ranges stored in them are used, so the cost is
+      proportional to the number of peaks in the modified spectra (plus
+      the number of spectra) instead of the number of all peaks.
+
+      @note This requires that the ranges of all unmodified spectra and
+      chromatograms are up to date, e.g. from a previous call of updateRanges().
+
+      @param modified_spectra Indices of the spectra whose peaks changed
+      @param ms_level MS level to consider (see updateRanges(Int))
+
+      @exception Exception::IndexOverflow is thrown if an index is not smaller than the number of spectra
+    */
+    void updateRanges(const std::vector<Size>& modified_spectra, Int ms_level = -1);
+
     /// returns the minimal m/z value
     CoordinateType getMinMZ() const;
 
@@ -450,6 +494,19 @@ public:
 
     //@}
 
+    /**
+      @brief Deduplicates the instrument settings, acquisition info and source file of all spectra
+
+      Each spectrum is compared to the preceding spectrum and to the last
+      preceding spectrum of the same MS level. Sub-objects that are equal are
+      shared instead of being stored once per spectrum (see
+      SpectrumSettings::shareMetaData()). This is done automatically when
+      loading mzML and sqMass files.
+
+      @return The number of spectra that share at least one sub-object with another spectrum
+    */
+    Size shareSpectrumMetaData();
+
     /// Resets all internal values
     void reset();
 
@@ -482,6 +539,9 @@ public:
     /// sets the spectrum list
     void setSpectra(const std::vector<MSSpectrum> & spectra);
 
+    /// sets the spectrum list (takes ownership without copying the spectra)
+    void setSpectra(std::vector<MSSpectrum> && spectra);
+
     /// adds a spectrum to the list
     void addSpectrum(const MSSpectrum & spectrum);
 
@@ -499,6 +559,9 @@ public:
     /// sets the chromatogram list
     void setChromatograms(const std::vector<MSChromatogram > & chromatograms);
 
+    /// sets the chromatogram list (takes ownership without copying the chromatograms)
+    void setChromatograms(std::vector<MSChromatogram > && chromatograms);
+
     /// adds a chromatogram to the list
     void addChromatogram(const MSChromatogram & chromatogram);
 
@@ -540,6 +603,8 @@ public:
 
 protected:
 
+    /// Computes the ranges of the experiment from the (already updated) ranges of its spectra and chromatograms
+    void combineRanges_(Int ms_level);
 
     /// MS levels of the data
     std::vector<UInt> ms_levels_;
@@ -0,0 +1,165 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2018.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: Timo Sachsenberg$
+// $Authors: Timo Sachsenberg $
+// --------------------------------------------------------------------------
+
+#pragma once
+
+#include <OpenMS/CONCEPT/Types.h>
+#include <OpenMS/DATASTRUCTURES/DRange.h>
+#include <OpenMS/KERNEL/PeakIndex.h>
+
+#include <vector>
+
+namespace OpenMS
+{
+  class MSExperiment;
+
+  /**
+    @brief Tiled RT x m/z index of the peaks of an MSExperiment for fast rectangular (area) queries
+
+    MSExperiment::areaBeginConst() binary searches the RT range and then visits
+    every spectrum in it, binary searching the m/z range in each. For many
+    narrow queries (e.g. extracted ion chromatograms) most of this work is
+    spent on spectra and cache lines that hold no matching peak.
+
+    This index groups consecutive spectra into RT blocks (@p spectra_per_block
+    spectra each) and the m/z axis into bins of width @p mz_bin_width. The
+    peaks of each (block, bin) tile are stored contiguously (m/z, intensity,
+    spectrum and peak index, ordered by spectrum within a tile), so a query
+    only reads the tiles overlapping the query rectangle. Boundaries are
+    inclusive in both dimensions. Like MSExperiment::ConstAreaIterator, only
+    MS1 spectra are indexed by default, i.e. a query returns the same peaks
+    (in the same order) as iterating from areaBeginConst() to areaEndConst().
+
+    The index is built once, from a snapshot of the experiment, when it is
+    constructed, and only needs to be created by code that issues many
+    queries. It does not observe the experiment: if spectra or peaks are
+    modified afterwards, the index has to be rebuilt. All queries are const
+    and can be used concurrently.
+
+    @note The spectra have to be sorted by RT. Peaks need not be sorted by m/z.
+
+    @ingroup Kernel
+  */
+  class OPENMS_DLLAPI MSExperimentAreaIndex
+  {
+public:
+
+    /// Area type of the batched queries (dimension Peak2D::RT and Peak2D::MZ)
+    typedef DRange<2> AreaType;
+
+    /// Default constructor (empty index)
+    MSExperimentAreaIndex();
+
+    /**
+      @brief Builds the index for all spectra of @p exp
+
+      @param exp The experiment
+      @param mz_bin_width Width of the m/z bins (in Th)
+      @param spectra_per_block Number of consecutive (indexed) spectra per RT block
+      @param ms_level Only spectra of this MS level are indexed (0 for all spectra)
+
+      @exception Exception::IllegalArgument is thrown if @p mz_bin_width is not positive, @p spectra_per_block is zero or the spectra are not sorted by RT
+    */
+    explicit MSExperimentAreaIndex(const MSExperiment& exp, double mz_bin_width = 1.0, Size spectra_per_block = 32, UInt ms_level = 1);
+
+    /// Copy constructor
+    MSExperimentAreaIndex(const MSExperimentAreaIndex&) = default;
+
+    /// Assignment operator
+    MSExperimentAreaIndex& operator=(const MSExperimentAreaIndex&) = default;
+
+    /// Destructor
+    ~MSExperimentAreaIndex() = default;
+
+    /// Number of indexed spectra
+    Size getNumberOfSpectra() const { return rt_.size(); }
+
+    /// Number of indexed peaks
+    Size size() const { return peak_mz_.size(); }
+
+    /// Returns the peaks (spectrum index in the experiment and peak index) in the given area, ordered by spectrum and peak index
+    void getPeaks(double min_rt, double max_rt, double min_mz, double max_mz, std::vector<PeakIndex>& peaks) const;
+
+    /// Returns the summed intensity of the peaks in the given area
+    double getIntensitySum(double min_rt, double max_rt, double min_mz, double max_mz) const;
+
+    /**
+      @brief Batched version of getPeaks()
+
+      @p peaks[i] contains the peaks of @p areas[i]. The areas are processed in parallel if OpenMP is enabled.
+    */
+    void getPeaks(const std::vector<AreaType>& areas, std::vector<std::vector<PeakIndex> >& peaks) const;
+
+    /**
+      @brief Batched version of getIntensitySum()
+
+      @p sums[i] is the summed intensity in @p areas[i]. The areas are processed in parallel if OpenMP is enabled.
+    */
+    void getIntensitySums(const std::vector<AreaType>& areas, std::vector<double>& sums) const;
+
+protected:
+
+    /// Determines the spectrum range [spectrum_begin, spectrum_end) and the bin range [bin_begin, bin_end] of an area, returns false if it is empty
+    bool getRange_(double min_rt, double max_rt, double min_mz, double max_mz,
+                   Size& spectrum_begin, Size& spectrum_end, Size& bin_begin, Size& bin_end) const;
+
+    /// m/z bin of @p mz (clamped to the valid bins)
+    Size getBin_(double mz) const;
+
+    /// m/z bin width
+    double bin_width_;
+    /// number of spectra per RT block
+    Size spectra_per_block_;
+    /// lower m/z boundary of the first bin
+    double min_mz_;
+    /// number of m/z bins
+    Size number_of_bins_;
+
+    /// retention time of each indexed spectrum
+    std::vector<double> rt_;
+    /// position of each indexed spectrum in the experiment
+    std::vector<Size> spectrum_index_;
+    /// offsets of the tiles (block-major) into the peak columns (number of blocks * number of bins + 1 entries)
+    std::vector<Size> tile_offsets_;
+
+    ///@name Peak columns (ordered by tile)
+    //@{
+    std::vector<double> peak_mz_;
+    std::vector<float> peak_intensity_;
+    std::vector<UInt32> peak_spectrum_; ///< position in rt_ (not in the experiment)
+    std::vector<UInt32> peak_index_;
+    //@}
+  };
+
+} // namespace OpenMS
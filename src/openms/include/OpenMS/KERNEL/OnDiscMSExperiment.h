@@ -46,6 +46,8 @@
 #include <vector>
 #include <algorithm>
 #include <limits>
+#include <memory>
+#include <mutex>
 
 #include <boost/shared_ptr.hpp>
 
@@ -56,14 +58,36 @@ namespace OpenMS
 
     @ingroup Kernel
 
-    @note This implementation is @a not thread-safe since it keeps internally a
-    single file access pointer which it moves when accessing a specific
-    data item. Please provide a separate copy to each thread, e.g. 
+    Spectra and chromatograms can be retrieved concurrently from multiple
+    threads using the same object, e.g.
 
     @code
-    #pragma omp parallel for firstprivate(ondisc_map) 
+    #pragma omp parallel for
+    for (SignedSize i = 0; i < (SignedSize)ondisc_map.size(); ++i)
+    {
+      MSSpectrum s = ondisc_map.getSpectrum(i);
+    }
     @endcode
 
+    The underlying file is memory-mapped and read using positional access
+    (see Internal::IndexedMzMLHandler). Only if the file cannot be mapped,
+    read access falls back to a single file stream and is serialized
+    internally. In that case providing a separate copy to each thread (e.g.
+    using firstprivate) avoids the contention.
+
+    Tools that only need a subset of the peak data, or need some spectra
+    repeatedly, can use getCachedSpectrum: the peak data of a spectrum is
+    decoded on its first access only and then shared by all callers.
+
+    Files can also be opened from a URL (http:// or https://, e.g. of an
+    object store), see Internal::IndexedMzMLHandler. Only the index and the
+    header are read when such a file is opened, the meta data of all spectra
+    is not loaded (a full parse would transfer the whole file) and
+    getMetaData() returns a null pointer. Instead, each spectrum and
+    chromatogram is parsed with its meta data from its own XML when it is
+    retrieved. prefetchSpectra() fetches a set of spectra concurrently
+    before they are accessed.
+
   */
   class OPENMS_DLLAPI OnDiscMSExperiment
   {
@@ -84,7 +108,8 @@ public:
       @brief Open a specific file on disk.
 
       This tries to read the indexed mzML by parsing the index and then reading
-      the meta information into memory.
+      the meta information into memory. For remote files (URLs) only the
+      experimental settings are read (see class documentation).
 
       @return Whether the parsing of the file was successful (if false, the
       file most likely was not an indexed mzML file)
@@ -92,11 +117,24 @@ public:
     bool openFile(const String& filename, bool skipMetaData = false)
     {
       filename_ = filename;
+      meta_ms_experiment_.reset();
+      experimental_settings_.reset();
       indexed_mzml_file_.openFile(filename);
-      if (filename != "" && !skipMetaData)
+      if (indexed_mzml_file_.isRemote())
+      {
+        // the meta data of each spectrum is parsed when it is retrieved
+        if (indexed_mzml_file_.getParsingSuccess())
+        {
+          boost::shared_ptr<ExperimentalSettings> settings(new ExperimentalSettings);
+          indexed_mzml_file_.getExperimentalSettings(*settings);
+          experimental_settings_ = settings;
+        }
+      }
+      else if (filename != "" && !skipMetaData)
       {
         loadMetaData_(filename);
       }
+      spectrum_cache_.reset(new SpectrumCache_(indexed_mzml_file_.getNrSpectra()));
       return indexed_mzml_file_.getParsingSuccess();
     }
 
@@ -104,7 +142,9 @@ public:
     OnDiscMSExperiment(const OnDiscMSExperiment& source) :
       filename_(source.filename_),
       indexed_mzml_file_(source.indexed_mzml_file_),
-      meta_ms_experiment_(source.meta_ms_experiment_)
+      meta_ms_experiment_(source.meta_ms_experiment_),
+      experimental_settings_(source.experimental_settings_),
+      spectrum_cache_(source.spectrum_cache_)
     {
     }
 
@@ -118,8 +158,9 @@ public:
     bool operator==(const OnDiscMSExperiment& rhs) const
     {
       // check if file and meta information is the same
-      return filename_ == rhs.filename_ &&
-             (*meta_ms_experiment_) == (*rhs.meta_ms_experiment_);
+      if (filename_ != rhs.filename_) return false;
+      if (!meta_ms_experiment_ || !rhs.meta_ms_experiment_) return meta_ms_experiment_ == rhs.meta_ms_experiment_;
+      return (*meta_ms_experiment_) == (*rhs.meta_ms_experiment_);
       // do not check if indexed_mzml_file_ is equal -> they have the same filename...
     }
 
@@ -134,9 +175,15 @@ public:
 
       Note that we cannot check whether all spectra are sorted (except if we
       were to load them all and check).
+
+      @exception Exception::IllegalArgument is thrown if the meta data was not loaded (remote files or skipMetaData)
     */
     bool isSortedByRT() const
     {
+      if (!meta_ms_experiment_)
+      {
+        throw Exception::IllegalArgument(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "The meta data of the spectra was not loaded.");
+      }
       return meta_ms_experiment_->isSorted(false);
     }
 
@@ -167,9 +214,11 @@ public:
     /// returns the meta information of this experiment (const access)
     boost::shared_ptr<const ExperimentalSettings> getExperimentalSettings() const
     {
+      if (!meta_ms_experiment_) return experimental_settings_;
       return boost::static_pointer_cast<const ExperimentalSettings>(meta_ms_experiment_);
     }
 
+    /// returns the meta data of all spectra and chromatograms (null for remote files or if skipMetaData was set)
     boost::shared_ptr<PeakMap> getMetaData() const
     {
       return meta_ms_experiment_;
@@ -184,15 +233,50 @@ public:
     /**
       @brief returns a single spectrum
 
+      If the meta data was not loaded (remote files or skipMetaData), the
+      meta data is parsed from the XML of the spectrum.
+
       @param id The index of the spectrum
     */
     MSSpectrum getSpectrum(Size id)
     {
+      if (!meta_ms_experiment_)
+      {
+        // parse the meta data from the XML of the spectrum
+        MSSpectrum spectrum;
+        indexed_mzml_file_.getMSSpectrumWithMetaDataById(static_cast<int>(id), spectrum);
+        return spectrum;
+      }
       MSSpectrum spectrum(meta_ms_experiment_->operator[](id));
       indexed_mzml_file_.getMSSpectrumById(static_cast<int>(id), spectrum);
       return spectrum;
     }
 
+    /**
+      @brief returns a single spectrum, decoding its peak data only once
+
+      The first access to a spectrum reads and decodes it, all further
+      accesses (also from other threads or copies of this object) return the
+      same spectrum. Concurrent first accesses to the same spectrum decode
+      it exactly once, the other threads wait for the result.
+
+      @param id The index of the spectrum
+
+      @exception Exception::IndexOverflow is thrown if @p id is not a valid spectrum index
+    */
+    boost::shared_ptr<const MSSpectrum> getCachedSpectrum(Size id);
+
+    /**
+      @brief releases the spectra decoded by getCachedSpectrum
+
+      Spectra still referenced by callers (or copies of this object) stay
+      valid. Must not be called concurrently with getCachedSpectrum.
+    */
+    void clearSpectrumCache();
+
+    /// returns the number of spectra decoded by getCachedSpectrum (and not yet released), not thread-safe
+    Size getNrCachedSpectra() const;
+
     /**
       @brief returns a single spectrum
     */
@@ -204,10 +288,20 @@ public:
     /**
       @brief returns a single chromatogram
 
+      If the meta data was not loaded (remote files or skipMetaData), the
+      meta data is parsed from the XML of the chromatogram.
+
       @param id The index of the chromatogram
     */
     MSChromatogram getChromatogram(Size id)
     {
+      if (!meta_ms_experiment_)
+      {
+        // parse the meta data from the XML of the chromatogram
+        MSChromatogram chromatogram;
+        indexed_mzml_file_.getMSChromatogramWithMetaDataById(static_cast<int>(id), chromatogram);
+        return chromatogram;
+      }
       MSChromatogram chromatogram(meta_ms_experiment_->getChromatogram(id));
       indexed_mzml_file_.getMSChromatogramById(static_cast<int>(id), chromatogram);
       return chromatogram;
@@ -221,6 +315,16 @@ public:
       return indexed_mzml_file_.getChromatogramById(id);
     }
 
+    /**
+      @brief fetches the data of the given spectra concurrently before they are accessed
+
+      Only has an effect for remote files (see Internal::IndexedMzMLHandler::prefetch()).
+    */
+    void prefetchSpectra(const std::vector<int>& ids)
+    {
+      indexed_mzml_file_.prefetch(ids);
+    }
+
     ///sets whether to skip some XML checks and be fast instead
     void setSkipXMLChecks(bool skip)
     {
@@ -242,6 +346,22 @@ protected:
     Internal::IndexedMzMLHandler indexed_mzml_file_;
     /// The meta-data
     boost::shared_ptr<PeakMap> meta_ms_experiment_;
+    /// The experimental settings if the meta data of the spectra was not loaded (remote files)
+    boost::shared_ptr<const ExperimentalSettings> experimental_settings_;
+
+    /// Spectra decoded on first access (one slot and one once_flag per spectrum)
+    struct SpectrumCache_
+    {
+      explicit SpectrumCache_(Size size) :
+        spectra(size),
+        decoded(new std::once_flag[size])
+      {
+      }
+      std::vector<boost::shared_ptr<const MSSpectrum> > spectra;
+      std::unique_ptr<std::once_flag[]> decoded;
+    };
+    /// The decoded spectra (shared by copies, since they access the same file)
+    boost::shared_ptr<SpectrumCache_> spectrum_cache_;
   };
 
 typedef OpenMS::OnDiscMSExperiment OnDiscPeakMap;
@@ -143,7 +143,7 @@ public:
     {}
 
     /// Copy constructor
-    Peak2D(const Peak2D & p) :
+    Peak2D(const Peak2D & p) noexcept :
       position_(p.position_),
       intensity_(p.intensity_)
     {}
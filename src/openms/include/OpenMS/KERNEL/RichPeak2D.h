@@ -70,6 +70,9 @@ public:
       UniqueIdInterface(p)
     {}
 
+    /// Move constructor
+    RichPeak2D(RichPeak2D&&) = default;
+
     /// Constructor from Peak2D
     explicit RichPeak2D(const Peak2D& p) :
       Peak2D(p),
@@ -88,6 +91,9 @@ public:
     ~RichPeak2D() override
     {}
 
+    /// Move assignment operator
+    RichPeak2D& operator=(RichPeak2D&&) & = default;
+
     /// Assignment operator
     RichPeak2D & operator=(const RichPeak2D& rhs)
     {
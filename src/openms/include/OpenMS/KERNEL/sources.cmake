@@ -7,6 +7,8 @@ AreaIterator.h
 BaseFeature.h
 ChromatogramPeak.h
 ChromatogramTools.h
+ColumnarConsensusMap.h
+ColumnarSpectrum.h
 ComparatorUtils.h
 ConsensusFeature.h
 ConversionHelper.h
@@ -21,6 +23,7 @@ MRMFeature.h
 MRMTransitionGroup.h
 MSChromatogram.h
 MSExperiment.h
+MSExperimentAreaIndex.h
 MSSpectrum.h
 OnDiscMSExperiment.h
 Peak1D.h
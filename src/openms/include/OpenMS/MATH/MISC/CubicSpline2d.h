@@ -35,6 +35,7 @@
 #pragma once
 
 #include <OpenMS/OpenMSConfig.h>
+#include <OpenMS/CONCEPT/Types.h>
 
 #include <vector>
 #include <map>
@@ -87,6 +88,18 @@ public:
      */
     double eval(double x) const;
 
+    /**
+     * @brief evaluates the spline at position x within a known interval
+     *
+     * Avoids the search for the interval containing @p x, e.g. when
+     * evaluating the spline at many sorted positions.
+     *
+     * @param x x-position
+     * @param i index of the closest knot left of (or exactly at) @p x, i.e.
+     *        x_i <= x < x_(i+1) (the last interval also contains the last knot)
+     */
+    double eval(double x, Size i) const;
+
     /**
      * @brief evaluates derivative of spline at position x
      *
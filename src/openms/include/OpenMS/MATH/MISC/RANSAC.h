@@ -43,7 +43,10 @@
 #include <OpenMS/MATH/MISC/RANSACModelLinear.h>
 
 #include <algorithm>    // std::random_shuffle
+#include <cmath>        // std::log, std::pow
+#include <exception>    // std::exception_ptr
 #include <limits>       // std::numeric_limits
+#include <random>       // std::mt19937
 #include <vector>       // std::vector
 #include <sstream>      // stringstream
 
@@ -59,12 +62,12 @@ namespace OpenMS
     {
       /// Default constructor
       RANSACParam()
-        : n(0), k(0), t(0), d(0), relative_d(false), rng(nullptr)
+        : n(0), k(0), t(0), d(0), relative_d(false), rng(nullptr), confidence(0), seed(0)
         {
         }
       /// Full constructor
       RANSACParam(size_t p_n, size_t p_k, double p_t, size_t p_d, bool p_relative_d = false, int (*p_rng)(int) = nullptr)
-        : n(p_n), k(p_k), t(p_t), d(p_d), relative_d(p_relative_d), rng(p_rng)
+        : n(p_n), k(p_k), t(p_t), d(p_d), relative_d(p_relative_d), rng(p_rng), confidence(0), seed(0)
       {
         if (relative_d)
         {
@@ -75,7 +78,7 @@ namespace OpenMS
       std::string toString() const
       {
         std::stringstream r;
-        r << "RANSAC param:\n  n: " << n << "\n  k: " << k << " iterations\n  t: " << t << " threshold\n  d: " << d << " inliers\n\n";
+        r << "RANSAC param:\n  n: " << n << "\n  k: " << k << " iterations\n  t: " << t << " threshold\n  d: " << d << " inliers\n  confidence: " << confidence << "\n  seed: " << seed << "\n\n";
         return r.str();
       }
 
@@ -84,7 +87,9 @@ namespace OpenMS
       double t; ///< Threshold value: for determining when a data point fits a model. Corresponds to the maximal squared deviation in units of the _second_ dimension (dim2).
       size_t d; ///< The number of close data values (according to 't') required to assert that a model fits well to data
       bool relative_d; ///< Should 'd' be interpreted as percentages (0-100) of data input size.
-      int (*rng)(int); ///< Optional RNG function (useful for testing with fixed seeds)
+      int (*rng)(int); ///< Optional RNG function (useful for testing with fixed seeds); if given, the serial implementation using this RNG is used
+      double confidence; ///< Adaptive termination (parallel implementation): stop once a sample without outliers was drawn with this probability (0 = always run 'k' iterations)
+      unsigned int seed; ///< Seed of the random number streams of the parallel implementation
     };
 
     /**
@@ -102,7 +107,11 @@ public:
         const std::vector<std::pair<double, double> >& pairs, 
         const RANSACParam& p)
       {
-        return ransac(pairs, p.n, p.k, p.t, p.d, p.relative_d, p.rng);
+        if (p.rng != nullptr)
+        {
+          return ransac(pairs, p.n, p.k, p.t, p.d, p.relative_d, p.rng);
+        }
+        return ransacParallel(pairs, p.n, p.k, p.t, p.d, p.relative_d, p.confidence, p.seed);
       }
 
       /**
@@ -131,7 +140,7 @@ public:
          _second_ dimension (dim2).
         @param d The number of close data values (according to 't') required to assert that a model fits well to data
         @param relative_d Should 'd' be interpreted as percentages (0-100) of data input size
-        @param rng Custom RNG function (useful for testing with fixed seeds)
+        @param rng Custom RNG function (useful for testing with fixed seeds). If none is given, ransacParallel() is used (with seed 0, without adaptive termination).
 
         @return A vector of pairs fitting the model well; data will be unsorted
       */
@@ -145,6 +154,11 @@ public:
           bool relative_d = false,
           int (*rng)(int) = nullptr)
       {
+        if (rng == nullptr)
+        {
+          return ransacParallel(pairs, n, k, t, d, relative_d);
+        }
+
         // translate relative percentages into actual numbers
         if (relative_d)
         {
@@ -237,6 +251,188 @@ public:
         return(bestdata);
       } // ransac()
 
+      /**
+        @brief Parallel version of ransac() with reproducible random numbers and optional adaptive termination.
+
+        Model hypotheses (iterations) are evaluated in parallel (if OpenMP is
+        enabled). Iteration @em i draws its @p n initial points from its own
+        random number stream, seeded by (@p seed, @em i), and the results are
+        compared in the order of the iterations. Thus, the result only depends
+        on @p seed, not on the number of threads. Models are accepted and
+        compared as in ransac().
+
+        If @p confidence is larger than zero, the number of iterations is
+        reduced according to the inlier ratio @em w of the best model so far:
+        the algorithm stops after log(1 - confidence) / log(1 - w^n)
+        iterations (at most @p k), i.e. once a sample of @p n inliers has been
+        drawn with probability @p confidence.
+
+        @param pairs Input data (paired data of type <dim1, dim2>)
+        @param n The minimum number of data points required to fit the model
+        @param k The maximum number of iterations allowed in the algorithm
+        @param t Threshold value for determining when a data point fits a model (see ransac())
+        @param d The number of close data values (according to 't') required to assert that a model fits well to data
+        @param relative_d Should 'd' be interpreted as percentages (0-100) of data input size
+        @param confidence Probability for adaptive termination (0 <= confidence < 1; 0 = always run @p k iterations)
+        @param seed Seed of the random number streams
+
+        @return A vector of pairs fitting the model well; data will be unsorted
+      */
+      static std::vector<std::pair<double, double> > ransacParallel(
+          const std::vector<std::pair<double, double> >& pairs,
+          size_t n,
+          size_t k,
+          double t,
+          size_t d,
+          bool relative_d = false,
+          double confidence = 0,
+          unsigned int seed = 0)
+      {
+        // translate relative percentages into actual numbers
+        if (relative_d)
+        {
+          if (d >= 100) throw Exception::Precondition(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, String("RANSAC: Relative 'd' >= 100% given. Use a lower value; the more outliers you expect, the lower it should be."));
+          d = pairs.size() * d / 100;
+        }
+        if (pairs.size() <= n)
+        {
+          throw Exception::Precondition(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION,
+                                        String("RANSAC: Number of total data points (") + String(pairs.size()) + ") must be larger than number of initial points (n=" + String(n) + ").");
+        }
+        if (confidence < 0 || confidence >= 1)
+        {
+          throw Exception::Precondition(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, String("RANSAC: 'confidence' must be in [0, 1), got ") + String(confidence) + ".");
+        }
+
+        TModelType model;
+        std::vector<std::pair<double, double> > bestdata;
+        double besterror = std::numeric_limits<double>::max();
+
+        // hypotheses are evaluated in batches, the number of iterations may shrink after each accepted model
+        const size_t batch_size = 64;
+        size_t iterations = k;
+        std::vector<Hypothesis_> batch;
+        for (size_t batch_begin = 0; batch_begin < iterations; batch_begin += batch_size)
+        {
+          // check if the model already includes all points
+          if (bestdata.size() == pairs.size()) break;
+
+          const size_t batch_end = std::min(iterations, batch_begin + batch_size);
+          batch.assign(batch_end - batch_begin, Hypothesis_());
+#ifdef _OPENMP
+#pragma omp parallel
+#endif
+          {
+            // the initial points are swapped to the front and back again, so the order of the remaining points only depends on the sample
+            std::vector<std::pair<double, double> > data = pairs;
+            std::vector<size_t> swaps(n);
+#ifdef _OPENMP
+#pragma omp for schedule(dynamic)
+#endif
+            for (SignedSize it = (SignedSize)batch_begin; it < (SignedSize)batch_end; ++it)
+            {
+              Hypothesis_& hypothesis = batch[it - batch_begin];
+              std::seed_seq seq{seed, (unsigned int)it, (unsigned int)((unsigned long long)it >> 32)};
+              std::mt19937 rng(seq); // the random number stream of this iteration
+              for (size_t i = 0; i < n; ++i)
+              {
+                swaps[i] = i + std::uniform_int_distribution<size_t>(0, data.size() - i - 1)(rng);
+                std::swap(data[i], data[swaps[i]]);
+              }
+              try
+              {
+                evaluateHypothesis_(model, data, n, t, d, hypothesis);
+              }
+              catch (...)
+              {
+                hypothesis.error_ptr = std::current_exception();
+              }
+              for (size_t i = n; i > 0; --i)
+              {
+                std::swap(data[i - 1], data[swaps[i - 1]]);
+              }
+            }
+          }
+
+          // compare the results in the order of the iterations
+          for (size_t it = batch_begin; it < batch_end; ++it)
+          {
+            // adaptive termination / all points explained: the remaining iterations are not run
+            if (it >= iterations || bestdata.size() == pairs.size()) break;
+
+            Hypothesis_& hypothesis = batch[it - batch_begin];
+            if (hypothesis.error_ptr)
+            {
+              std::rethrow_exception(hypothesis.error_ptr);
+            }
+            if (!hypothesis.accepted) continue;
+
+            if (hypothesis.data.size() > bestdata.size() || (hypothesis.data.size() == bestdata.size() && (hypothesis.error < besterror)))
+            {
+              besterror = hypothesis.error;
+              bestdata.swap(hypothesis.data);
+              if (confidence > 0)
+              {
+                iterations = std::min(k, std::max(it + 1, requiredIterations_(bestdata.size(), pairs.size(), n, confidence)));
+              }
+            }
+          }
+        }
+
+        return bestdata;
+      } // ransacParallel()
+
+protected:
+
+      /// result of a single iteration of ransacParallel()
+      struct Hypothesis_
+      {
+        Hypothesis_() :
+          accepted(false), error(0)
+        {
+        }
+
+        bool accepted; ///< enough inliers?
+        std::vector<std::pair<double, double> > data; ///< initial points and inliers
+        double error; ///< RSS of the model fitted to @p data
+        std::exception_ptr error_ptr; ///< exception thrown while fitting @p data
+      };
+
+      /// fits a model to the first @p n points of @p data and collects the inliers among the remaining points (as one iteration of ransac())
+      static void evaluateHypothesis_(const TModelType& model, const std::vector<std::pair<double, double> >& data, size_t n, double t, size_t d, Hypothesis_& hypothesis)
+      {
+        typename TModelType::ModelParameters coeff;
+        try
+        { // fitting might throw UnableToFit if points are 'unfortunate'
+          coeff = model.rm_fit(data.begin(), data.begin() + n);
+        }
+        catch (...)
+        {
+          return;
+        }
+        std::vector<std::pair<double, double> > alsoinliers = model.rm_inliers(data.begin() + n, data.end(), coeff, t);
+        if (alsoinliers.size() > d
+            || alsoinliers.size() >= (data.size() - n)) // maximum number of inliers we can possibly have (i.e. remaining data)
+        {
+          hypothesis.data.assign(data.begin(), data.begin() + n);
+          hypothesis.data.insert(hypothesis.data.end(), alsoinliers.begin(), alsoinliers.end());
+          typename TModelType::ModelParameters bettercoeff = model.rm_fit(hypothesis.data.begin(), hypothesis.data.end());
+          hypothesis.error = model.rm_rss(hypothesis.data.begin(), hypothesis.data.end(), bettercoeff);
+          hypothesis.accepted = true;
+        }
+      }
+
+      /// number of iterations needed to draw @p n inliers at least once with probability @p confidence, given the number of inliers of the best model
+      static size_t requiredIterations_(size_t inliers, size_t size, size_t n, double confidence)
+      {
+        const double p_good = std::pow(double(inliers) / size, double(n)); // probability of a sample without outliers
+        if (p_good >= 1) return 0;
+        if (p_good <= 0) return std::numeric_limits<size_t>::max();
+        const double iterations = std::ceil(std::log(1 - confidence) / std::log(1 - p_good));
+        if (iterations >= (double)std::numeric_limits<size_t>::max()) return std::numeric_limits<size_t>::max();
+        return (size_t)iterations;
+      }
+
     }; // class
   
   } // namespace Math
@@ -245,6 +245,29 @@ public:
         return bin_index;
       }
 
+      /**
+        @brief adds the bin values of @p histogram to the bins of this histogram
+
+        Both histograms must have the same range and bin size. This allows to
+        fill one histogram per thread (or per data chunk) and to reduce them
+        afterwards. Since only bin counts are added, the result does not
+        depend on the order of the merges.
+
+        @exception Exception::IllegalArgument is thrown if the bin layouts differ
+      */
+      void merge(const Histogram & histogram)
+      {
+        if (min_ != histogram.min_ || max_ != histogram.max_ ||
+            bin_size_ != histogram.bin_size_ || bins_.size() != histogram.bins_.size())
+        {
+          throw Exception::IllegalArgument(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "Histograms with different bin layouts cannot be merged.");
+        }
+        for (Size i = 0; i < bins_.size(); ++i)
+        {
+          bins_[i] += histogram.bins_[i];
+        }
+      }
+
       template< typename DataIterator >
       static void getCumulativeHistogram(DataIterator begin, DataIterator end,
                                          bool complement,
@@ -212,6 +212,19 @@ private:
       /// transform different score types to a range and score orientation that the model can handle (engine string is assumed in upper-case)
       static double transformScore_(const String & engine, const PeptideHit & hit);
 
+      /**
+          @brief Bins sorted scores into a histogram of @p number_of_bins equally sized bins
+
+          Each non-empty bin is represented by the mean of its scores (@p bin_scores) and the number of scores in the bin (@p bin_weights).
+      */
+      static void binScores_(const std::vector<double> & sorted_scores, Size number_of_bins, std::vector<double> & bin_scores, std::vector<double> & bin_weights);
+
+      /// weighted log-likelihood of the mixture (an empty @p weights vector gives every score weight one)
+      double computeLogLikelihood_(const std::vector<double> & incorrect_density, const std::vector<double> & correct_density, const std::vector<double> & weights) const;
+
+      /// weighted sum of the posterior probabilities (an empty @p weights vector gives every score weight one)
+      double sumPosterior_(const std::vector<double> & incorrect_density, const std::vector<double> & correct_density, const std::vector<double> & weights) const;
+
       /// assignment operator (not implemented)
       PosteriorErrorProbabilityModel & operator=(const PosteriorErrorProbabilityModel & rhs);
       ///Copy constructor (not implemented)
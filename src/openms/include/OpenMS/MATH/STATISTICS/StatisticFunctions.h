@@ -36,6 +36,7 @@
 #include <vector>
 #include <OpenMS/CONCEPT/Exception.h>
 #include <OpenMS/CONCEPT/Types.h>
+#include <OpenMS/MATH/STATISTICS/StreamingStatistics.h>
 
 // array_wrapper needs to be included before it is used
 // only in boost1.64+. See issue #2790
@@ -683,6 +684,31 @@ namespace OpenMS
         }
       }
 
+      /**
+        @brief Ctor with streaming accumulators (no data needs to be stored)
+
+        Mean, variance, minimum, maximum and count are exact, the quartiles
+        are approximated by the quantile sketch.
+      */
+      SummaryStatistics(const RunningStatistics& stats, const QuantileSketch& sketch)
+      {
+        count = stats.count();
+        if (count == 0 || sketch.empty())
+        {
+          mean = variance = min = lowerq = median = upperq = max = 0.0;
+        }
+        else
+        {
+          mean = stats.mean();
+          variance = stats.variance();
+          min = stats.min();
+          lowerq = sketch.quantile(0.25);
+          median = sketch.quantile(0.5);
+          upperq = sketch.quantile(0.75);
+          max = stats.max();
+        }
+      }
+
       double mean, variance, lowerq, median, upperq;
       typename T::value_type min, max;
       size_t count;
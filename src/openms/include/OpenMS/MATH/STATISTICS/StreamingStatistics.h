@@ -0,0 +1,236 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2018.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: Timo Sachsenberg $
+// $Authors: Timo Sachsenberg $
+// --------------------------------------------------------------------------
+
+#pragma once
+
+#include <OpenMS/CONCEPT/Types.h>
+
+#include <vector>
+
+namespace OpenMS
+{
+  namespace Math
+  {
+
+    /**
+      @brief Streaming accumulator for count, mean, variance, minimum and maximum
+
+      Values are added one at a time using Welford's algorithm, i.e. no data
+      needs to be stored and the result is numerically stable. Accumulators
+      filled independently (e.g. one per thread or per data chunk) can be
+      combined with merge(). The merged result equals the result of adding all
+      values to a single accumulator (up to rounding).
+
+      The variance uses the same (n-1) denominator as Math::variance().
+
+      @ingroup Math
+    */
+    class OPENMS_DLLAPI RunningStatistics
+    {
+public:
+      /// Default constructor (no values)
+      RunningStatistics();
+
+      /// Adds a value
+      void add(double value);
+
+      /// Adds all values of the range [@p begin, @p end)
+      template <typename IteratorType>
+      void add(IteratorType begin, IteratorType end)
+      {
+        for (IteratorType it = begin; it != end; ++it)
+        {
+          add(double(*it));
+        }
+      }
+
+      /// Adds the values summarized by @p other (parallel reduction)
+      void merge(const RunningStatistics& other);
+
+      /// Removes all values
+      void clear();
+
+      /// Returns the number of values
+      Size count() const;
+
+      /// Returns the sum of the values
+      double sum() const;
+
+      /// Returns the mean (0 if no values were added)
+      double mean() const;
+
+      /// Returns the sample variance (0 for less than two values)
+      double variance() const;
+
+      /// Returns the sample standard deviation (0 for less than two values)
+      double sd() const;
+
+      /// Returns the smallest value (0 if no values were added)
+      double min() const;
+
+      /// Returns the largest value (0 if no values were added)
+      double max() const;
+
+protected:
+      /// Number of values
+      Size count_;
+      /// Running mean
+      double mean_;
+      /// Sum of the squared deviations from the running mean
+      double m2_;
+      /// Smallest value
+      double min_;
+      /// Largest value
+      double max_;
+    };
+
+    /**
+      @brief Mergeable streaming sketch for approximate quantiles (t-digest)
+
+      Implements the merging variant of the t-digest by Dunning and Ertl
+      ("Computing extremely accurate quantiles using t-digests", 2019). Values
+      are clustered into weighted centroids whose size is bounded by the
+      arcsine scale function: clusters are small in the tails and larger
+      around the median. The memory needed is bounded by the @p compression
+      parameter (roughly 2 * compression centroids) and does not depend on the
+      number of values, while the relative error of the quantiles is small
+      (in particular close to q = 0 and q = 1).
+
+      As long as the number of values is small compared to the compression,
+      all centroids consist of single values and quantile() interpolates
+      between the data points like Math::median() does (e.g. the median of an
+      even number of values is the mean of the two central values).
+
+      Sketches filled independently (e.g. one per thread) can be combined with
+      merge(). The result is deterministic for a fixed data partition and
+      merge order, but, as with any sketch, it may differ slightly when the
+      data is partitioned differently.
+
+      @ingroup Math
+    */
+    class OPENMS_DLLAPI QuantileSketch
+    {
+public:
+      /**
+        @brief Constructor
+
+        @param compression Accuracy parameter (larger values give more accurate
+        results and use more memory)
+
+        @exception Exception::InvalidValue is thrown if @p compression is smaller than 10
+      */
+      explicit QuantileSketch(double compression = 100.0);
+
+      /// Adds a value with the given weight (ignored if @p weight is not positive)
+      void add(double value, double weight = 1.0);
+
+      /// Adds all values of the range [@p begin, @p end) with unit weight
+      template <typename IteratorType>
+      void add(IteratorType begin, IteratorType end)
+      {
+        for (IteratorType it = begin; it != end; ++it)
+        {
+          add(double(*it));
+        }
+      }
+
+      /// Adds the values summarized by @p other (parallel reduction)
+      void merge(const QuantileSketch& other);
+
+      /// Removes all values (the compression is retained)
+      void clear();
+
+      /**
+        @brief Returns the approximate @p q quantile (e.g. 0.5 for the median)
+
+        @exception Exception::InvalidRange is thrown if the sketch is empty
+        @exception Exception::InvalidValue is thrown if @p q is not in [0, 1]
+      */
+      double quantile(double q) const;
+
+      /// Returns the approximate median (same as quantile(0.5))
+      double median() const;
+
+      /// Merges all buffered values into the centroids (done automatically when needed)
+      void compress();
+
+      /// Returns the total weight (the number of values for unit weights)
+      double count() const;
+
+      /// Returns true if no values were added
+      bool empty() const;
+
+      /// Returns the smallest value (0 if the sketch is empty)
+      double min() const;
+
+      /// Returns the largest value (0 if the sketch is empty)
+      double max() const;
+
+      /// Returns the compression parameter
+      double getCompression() const;
+
+      /// Returns the number of centroids after compression (mainly for testing)
+      Size centroidCount() const;
+
+protected:
+      /// A cluster of values represented by its mean and total weight
+      struct Centroid
+      {
+        double mean;
+        double weight;
+      };
+
+      /// Merges the centroids in @p buffer (reordered in place) into @p result respecting the size bound
+      static void compress_(std::vector<Centroid>& buffer, double compression, std::vector<Centroid>& result);
+
+      /// Interpolates the @p q quantile from the compressed @p centroids
+      double quantile_(const std::vector<Centroid>& centroids, double q) const;
+
+      /// Accuracy parameter
+      double compression_;
+      /// Compressed centroids (sorted by mean)
+      std::vector<Centroid> centroids_;
+      /// Values not yet merged into the centroids
+      std::vector<Centroid> buffer_;
+      /// Total weight of the centroids and the buffer
+      double total_weight_;
+      /// Smallest value
+      double min_;
+      /// Largest value
+      double max_;
+    };
+
+  } // namespace Math
+} // namespace OpenMS
+
@@ -40,7 +40,7 @@
 #include <OpenMS/METADATA/MetaInfoRegistry.h>
 #include <OpenMS/DATASTRUCTURES/DataValue.h>
 
-#include <boost/container/flat_map.hpp>
+#include <utility>
 
 namespace OpenMS
 {
@@ -63,6 +63,11 @@ namespace OpenMS
       member. MetaInfoInterface implements a full interface to a MetaInfo
       member and is more memory efficient if no meta info gets added.
 
+      The values are kept in an array sorted by index. The first
+      INLINE_CAPACITY entries are stored inside the MetaInfo object itself,
+      only larger collections allocate memory on the heap. Since most objects
+      carry only a few meta values, this avoids one allocation per object.
+
       @ingroup Metadata
   */
   class OPENMS_DLLAPI MetaInfo
@@ -75,7 +80,7 @@ public:
     MetaInfo(const MetaInfo&) = default;
 
     /// Move constructor
-    MetaInfo(MetaInfo&&) = default;
+    MetaInfo(MetaInfo&&) noexcept;
 
     /// Destructor
     ~MetaInfo();
@@ -83,7 +88,7 @@ public:
     /// Assignment operator
     MetaInfo& operator=(const MetaInfo&) = default;
     /// Move assignment operator
-    MetaInfo& operator=(MetaInfo&&) & = default;
+    MetaInfo& operator=(MetaInfo&&) & noexcept;
 
     /// Equality operator
     bool operator==(const MetaInfo& rhs) const;
@@ -105,6 +110,12 @@ public:
     /// Sets the DataValue corresponding to an index
     void setValue(UInt index, const DataValue& value);
 
+    /// Sets the DataValue corresponding to a name (moves the value into place)
+    void setValue(const String& name, DataValue&& value);
+
+    /// Sets the DataValue corresponding to an index (moves the value into place)
+    void setValue(UInt index, DataValue&& value);
+
     /// Removes the DataValue corresponding to @p name if it exists
     void removeValue(const String& name);
     /// Removes the DataValue corresponding to @p index if it exists
@@ -125,12 +136,35 @@ public:
     /// Removes all meta values
     void clear();
 
+    /// Number of entries that are stored without heap allocation
+    static const Size INLINE_CAPACITY = 4;
+
 private:
-    using MapType = boost::container::flat_map<UInt, DataValue>;
+    typedef std::pair<UInt, DataValue> EntryType;
+
+    /// First entry (sorted by index)
+    EntryType* begin_();
+    const EntryType* begin_() const;
+    /// Past-the-end entry
+    EntryType* end_();
+    const EntryType* end_() const;
+    /// Returns the entry for @p index or end_() if not found
+    EntryType* find_(UInt index);
+    const EntryType* find_(UInt index) const;
+    /// Inserts a new (empty) entry for @p index at sorted position @p pos and returns it
+    EntryType* insert_(EntryType* pos, UInt index);
+    /// Removes the entry at @p pos
+    void erase_(EntryType* pos);
+
     /// Static MetaInfoRegistry
     static MetaInfoRegistry registry_;
-    /// The actual mapping of indexes to values
-    MapType index_to_value_;
+
+    /// Inline storage for the first entries (used as long as heap_values_ is empty)
+    EntryType inline_values_[INLINE_CAPACITY];
+    /// Number of used entries in inline_values_
+    Size inline_size_ = 0;
+    /// Storage once more than INLINE_CAPACITY entries are present
+    std::vector<EntryType> heap_values_;
   };
 
 } // namespace OpenMS
@@ -89,6 +89,10 @@ public:
     void setMetaValue(const String& name, const DataValue& value);
     /// Sets the DataValue corresponding to an index
     void setMetaValue(UInt index, const DataValue& value);
+    /// Sets the DataValue corresponding to a name (moves the value into place)
+    void setMetaValue(const String& name, DataValue&& value);
+    /// Sets the DataValue corresponding to an index (moves the value into place)
+    void setMetaValue(UInt index, DataValue&& value);
 
     /// Removes the DataValue corresponding to @p name if it exists
     void removeMetaValue(const String& name);
@@ -43,6 +43,8 @@
 #include <OpenMS/METADATA/PeptideIdentification.h>
 #include <OpenMS/METADATA/DataProcessing.h>
 
+#include <boost/shared_ptr.hpp>
+
 #include <map>
 #include <vector>
 
@@ -58,6 +60,18 @@ namespace OpenMS
       The precursor spectrum is the first spectrum before this spectrum, that has a lower MS-level than
       the current spectrum.
 
+      The instrument settings, acquisition info and source file are usually
+      identical for most spectra of a run. They are stored copy-on-write:
+      copies of a SpectrumSettings object (and objects merged using
+      shareMetaData()) share a single instance, which is only duplicated once
+      it is accessed through one of the mutable getters. A default-constructed
+      sub-object does not occupy any memory at all.
+
+      @note As a consequence, a mutable reference obtained from
+      getInstrumentSettings(), getAcquisitionInfo() or getSourceFile() must
+      not be held on to across a copy of the object, since the copy would
+      see the modifications as well. Call the mutable getter again instead.
+
       @ingroup Metadata
   */
   class OPENMS_DLLAPI SpectrumSettings :
@@ -135,6 +149,17 @@ public:
     /// sets the source file
     void setSourceFile(const SourceFile & source_file);
 
+    /**
+      @brief Shares instrument settings, acquisition info and source file with @p other where they are equal
+
+      Sub-objects that compare equal to the corresponding sub-object of @p
+      other are replaced by a shared reference to the instance held by @p
+      other, so that only one copy is kept in memory.
+
+      @return The number of sub-objects (0 to 3) that are shared after the call
+    */
+    Size shareMetaData(const SpectrumSettings & other);
+
     /// returns a const reference to the precursors
     const std::vector<Precursor> & getPrecursors() const;
     /// returns a mutable reference to the precursors
@@ -170,9 +195,12 @@ protected:
     SpectrumType type_;
     String native_id_;
     String comment_;
-    InstrumentSettings instrument_settings_;
-    SourceFile source_file_;
-    AcquisitionInfo acquisition_info_;
+    /// shared, copy-on-write (empty pointer means default-constructed)
+    boost::shared_ptr<InstrumentSettings> instrument_settings_;
+    /// shared, copy-on-write (empty pointer means default-constructed)
+    boost::shared_ptr<SourceFile> source_file_;
+    /// shared, copy-on-write (empty pointer means default-constructed)
+    boost::shared_ptr<AcquisitionInfo> acquisition_info_;
     std::vector<Precursor> precursors_;
     std::vector<Product> products_;
     std::vector<PeptideIdentification> identification_;
@@ -119,8 +119,9 @@ protected:
      @param feature The feature which should be simulated
      @param experiment The experiment to which the simulated signals should be added
      @param experiment_ct Ground truth for picked peaks
+     @param rng Random number generator for the m/z error (one per feature when simulating in parallel)
      */
-    void add2DSignal_(Feature& feature, SimTypes::MSSimExperiment& experiment, SimTypes::MSSimExperiment& experiment_ct);
+    void add2DSignal_(Feature& feature, SimTypes::MSSimExperiment& experiment, SimTypes::MSSimExperiment& experiment_ct, boost::random::mt19937_64& rng);
 
     /**
      @brief Samples signals for the given 1D model
@@ -150,6 +151,7 @@ protected:
      @param experiment Experiment to which the sampled signals will be added
      @param experiment_ct Experiment to which the centroided Ground Truth sampled signals will be added
      @param activeFeature The current feature that is simulated
+     @param rng Random number generator for the m/z error
      */
     void samplePeptideModel2D_(const ProductModel<2>& pm,
                                const SimTypes::SimCoordinateType mz_start,
@@ -158,7 +160,8 @@ protected:
                                SimTypes::SimCoordinateType rt_end,
                                SimTypes::MSSimExperiment& experiment,
                                SimTypes::MSSimExperiment& experiment_ct,
-                               Feature& activeFeature);
+                               Feature& activeFeature,
+                               boost::random::mt19937_64& rng);
 
     /**
      @brief Add the correct Elution profile to the passed ProductModel
@@ -261,19 +264,6 @@ protected:
 
     std::vector<ContaminantInfo> contaminants_;
 
-    /**
-    @p threaded_random_numbers keeps a set of random numbers for each thread simulating a feature.
-      */
-    std::vector<std::vector<double> > threaded_random_numbers_;
-
-    /**
-      Indicates which random numbers each thread has used already and if the random number pool
-      should be rebuild.
-      */
-    std::vector<Size> threaded_random_numbers_index_;
-
-    static const Size THREADED_RANDOM_NUMBER_POOL_SIZE_ = 500;
-
     bool contaminants_loaded_;
   };
 
@@ -41,6 +41,7 @@
 #include <boost/shared_ptr.hpp>
 
 #include <boost/random/mersenne_twister.hpp>
+#include <boost/cstdint.hpp>
 
 #include <OpenMS/CHEMISTRY/AASequence.h>
 #include <OpenMS/FORMAT/FASTAFile.h>
@@ -139,6 +140,22 @@ public:
         technical_rng_.seed(seed);
       }
 
+      /**
+        @brief Draws @p count seeds from the technical RNG
+
+        Used to give each item of a parallel loop its own random number stream
+        (e.g. one per feature), so results do not depend on the number of threads.
+      */
+      std::vector<boost::uint64_t> drawTechnicalRngSeeds(Size count)
+      {
+        std::vector<boost::uint64_t> seeds(count);
+        for (Size i = 0; i < count; ++i)
+        {
+          seeds[i] = technical_rng_();
+        }
+        return seeds;
+      }
+
       /// Initialize the RNGs
       void initialize(bool biological_random, bool technical_random)
       {
@@ -0,0 +1,128 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2018.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: Timo Sachsenberg $
+// $Authors: Timo Sachsenberg $
+// --------------------------------------------------------------------------
+
+#pragma once
+
+#include <OpenMS/CONCEPT/Types.h>
+
+#include <string>
+#include <vector>
+
+namespace OpenMS
+{
+  /**
+    @brief Process-wide thread budget shared by all algorithms and external tools
+
+    TOPP tools set the budget from their @p -threads option. OpenMP parallel
+    regions use it automatically. Code that starts external programs (see the
+    search engine adapters) or sizes its own buffers should ask getThreads()
+    instead of reading the option, so that "-threads N" means N cores
+    everywhere.
+
+    Nested OpenMP parallelism is disabled by default: a parallel region inside
+    another one runs on the thread that encounters it instead of starting
+    additional threads, which would oversubscribe the cores.
+
+    The OpenMP worker threads can be bound to cores (see setAffinity()). For
+    TOPP tools this is requested with the environment variable
+    @p OPENMS_THREAD_AFFINITY ("compact" or "spread").
+
+    @note Affinity is only supported on Linux.
+
+    @ingroup System
+  */
+  class OPENMS_DLLAPI ExecutionResources
+  {
+public:
+    /// Placement of the worker threads on the cores
+    enum Affinity
+    {
+      AFFINITY_NONE,    ///< threads may run on all cores available to the process
+      AFFINITY_COMPACT, ///< thread i is bound to the i-th available core (fill one NUMA node after the other)
+      AFFINITY_SPREAD,  ///< threads are distributed round-robin over the NUMA nodes (more memory bandwidth per thread)
+      SIZE_OF_AFFINITY
+    };
+
+    /// Names of the affinity types ("none", "compact", "spread")
+    static const std::string NamesOfAffinity[SIZE_OF_AFFINITY];
+
+    /// Number of cores the process may run on (respects the CPU affinity mask of the process, at least 1)
+    static Int getAvailableCores();
+
+    /**
+      @brief Sets the number of threads all parallel code of this process may use
+
+      @param threads Number of threads, zero or negative values mean all available cores (see getAvailableCores())
+    */
+    static void setThreads(Int threads);
+
+    /// Number of threads parallel code of this process may use (also without OpenMP support, e.g. for external programs)
+    static Int getThreads();
+
+    /**
+      @brief Number of threads available to a parallel region started at this point
+
+      Inside a parallel region with nested parallelism disabled this is 1.
+    */
+    static Int getThreadsForParallelRegion();
+
+    /// Allows or forbids nested OpenMP parallel regions (forbidden by default)
+    static void setNestedParallelism(bool allow);
+
+    /// Are nested OpenMP parallel regions allowed?
+    static bool getNestedParallelism();
+
+    /**
+      @brief Binds the OpenMP worker threads to cores
+
+      Takes effect for the current thread budget, call again after setThreads().
+
+      @return false if binding threads is not supported (e.g. without OpenMP or on other platforms than Linux)
+    */
+    static bool setAffinity(Affinity affinity);
+
+    /// Current placement of the worker threads
+    static Affinity getAffinity();
+
+    /**
+      @brief Cores available to the process in the order threads are bound to them
+
+      @p affinity selects the order: fill one NUMA node after the other
+      (AFFINITY_COMPACT and AFFINITY_NONE) or alternate between NUMA nodes
+      (AFFINITY_SPREAD). Without NUMA information all cores form one node.
+    */
+    static std::vector<Int> getCoreOrder(Affinity affinity);
+  };
+
+} // namespace OpenMS
@@ -0,0 +1,178 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2018.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: Timo Sachsenberg $
+// $Authors: Timo Sachsenberg $
+// --------------------------------------------------------------------------
+
+#pragma once
+
+#include <OpenMS/CONCEPT/Types.h>
+#include <OpenMS/DATASTRUCTURES/String.h>
+
+#include <iosfwd>
+#include <vector>
+
+namespace OpenMS
+{
+  /**
+    @brief Collects timings of named code regions and named counters
+
+    Code regions are instrumented with OPENMS_PROFILE_SCOPE("name"), which
+    records the wall time from the declaration to the end of the enclosing
+    scope. Nested regions are recorded hierarchically, i.e. the time spent in
+    a region excluding its nested regions ("self" time) is reported as well.
+    Counters are added with Profiler::addCount().
+
+    Recording is disabled by default and then only costs a single check per
+    region. Every thread records into its own buffer, so regions inside of
+    parallel loops do not need any synchronization.
+
+    The collected data can be written as a Chrome trace (JSON, viewable with
+    chrome://tracing or Perfetto) with storeChromeTrace() or summarized per
+    region with printSummary(). TOPP tools do both if the common option
+    @p -profile is given.
+
+    @note Region and counter names are not copied, they have to outlive the
+    profiler (usually they are string literals).
+
+    @note clear() and the output functions must not be called while other
+    threads are recording.
+
+    @ingroup System
+  */
+  class OPENMS_DLLAPI Profiler
+  {
+public:
+    /// A recorded region
+    struct Event
+    {
+      const char* name; ///< name of the region
+      Size thread; ///< index of the recording thread (in order of first use)
+      Size depth; ///< nesting depth on the recording thread
+      Int64 start; ///< start in nanoseconds since the profiler was first used
+      Int64 duration; ///< wall time in nanoseconds
+      Int64 self; ///< @p duration excluding nested regions
+    };
+
+    /// Aggregated timings of all events with the same name
+    struct RegionSummary
+    {
+      String name;
+      Size calls;
+      double total; ///< total wall time in seconds
+      double self; ///< total wall time excluding nested regions in seconds
+      double max; ///< longest single call in seconds
+    };
+
+    /// Enables or disables recording (disabled by default)
+    static void setEnabled(bool enabled);
+
+    /// Is recording enabled?
+    static bool isEnabled();
+
+    /// Removes all recorded events and counters
+    static void clear();
+
+    /// Adds @p value to the counter @p name (only if recording is enabled)
+    static void addCount(const char* name, double value = 1.0);
+
+    /// All recorded events (ordered by thread, then by end time)
+    static std::vector<Event> getEvents();
+
+    /// Timings aggregated per region name, sorted by decreasing total time
+    static std::vector<RegionSummary> getSummary();
+
+    /// Counter totals (summed over all threads), sorted by name
+    static std::vector<std::pair<String, double> > getCounts();
+
+    /// Prints the per-region summary and the counters as a table
+    static void printSummary(std::ostream& os);
+
+    /**
+      @brief Writes all events as a Chrome trace (JSON) file
+
+      @exception Exception::UnableToCreateFile is thrown if the file cannot be written
+    */
+    static void storeChromeTrace(const String& filename);
+
+    /// @name Internal interface used by ProfileScope
+    //@{
+    /// Current time in nanoseconds since the profiler was first used
+    static Int64 now();
+    /// Signals the start of a region on the current thread
+    static void beginRegion();
+    /// Records a region started at @p start on the current thread
+    static void endRegion(const char* name, Int64 start);
+    //@}
+  };
+
+  /**
+    @brief RAII helper recording the lifetime of the object as a region of the Profiler
+
+    Use the macro OPENMS_PROFILE_SCOPE instead of instantiating this class.
+  */
+  class OPENMS_DLLAPI ProfileScope
+  {
+public:
+    explicit ProfileScope(const char* name) :
+      name_(name),
+      active_(Profiler::isEnabled()),
+      start_(0)
+    {
+      if (active_)
+      {
+        Profiler::beginRegion();
+        start_ = Profiler::now();
+      }
+    }
+
+    ~ProfileScope()
+    {
+      if (active_) Profiler::endRegion(name_, start_);
+    }
+
+private:
+    const char* name_;
+    bool active_;
+    Int64 start_;
+
+    ProfileScope(const ProfileScope&) = delete;
+    ProfileScope& operator=(const ProfileScope&) = delete;
+  };
+
+} // namespace OpenMS
+
+#define OPENMS_PROFILE_CONCAT_IMPL_(a, b) a ## b
+#define OPENMS_PROFILE_CONCAT_(a, b) OPENMS_PROFILE_CONCAT_IMPL_(a, b)
+
+/// Records the time until the end of the enclosing scope as region @p name (see OpenMS::Profiler)
+#define OPENMS_PROFILE_SCOPE(name) OpenMS::ProfileScope OPENMS_PROFILE_CONCAT_(openms_profile_scope_, __LINE__)(name)
+
@@ -0,0 +1,229 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2018.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: Timo Sachsenberg $
+// $Authors: Timo Sachsenberg $
+// --------------------------------------------------------------------------
+
+#pragma once
+
+#include <OpenMS/CONCEPT/Types.h>
+#include <OpenMS/DATASTRUCTURES/String.h>
+
+#include <boost/shared_ptr.hpp>
+
+#include <istream>
+#include <list>
+#include <mutex>
+#include <streambuf>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace OpenMS
+{
+  /**
+    @brief Read-only random access to a file on an HTTP(S) server (e.g. an S3-compatible object store)
+
+    The file is read with HTTP range requests in blocks of a fixed size. The
+    blocks are kept in a least-recently-used cache, thus repeated and
+    neighbouring accesses do not cause additional requests. Missing blocks
+    of a single read are fetched concurrently (see Options::max_concurrent),
+    and when the file is read sequentially, the following blocks are fetched
+    along with the requested ones (read-ahead).
+
+    Readers that know in advance which byte ranges they need (e.g. from the
+    offset table of an indexed mzML file, see
+    Internal::IndexedMzMLHandler::prefetch()) can request all of them at once
+    with prefetch(), which fetches only what is needed, concurrently.
+
+    All read functions are thread-safe. Copies of an Internal::IndexedMzMLHandler
+    share the same RemoteFile and thus the same cache.
+
+    The server has to support range requests (HTTP status 206), e.g. public
+    or pre-signed object store URLs.
+
+    @note The requests are processed by Qt, which requires an instance of
+    QCoreApplication. If none exists, one is created when the first
+    RemoteFile is opened, which should therefore happen in the main thread.
+
+    @ingroup System
+  */
+  class OPENMS_DLLAPI RemoteFile
+  {
+public:
+    /// Options for reading and caching
+    struct OPENMS_DLLAPI Options
+    {
+      Options();
+
+      Size block_size; ///< size of a block (bytes), the unit of requests and caching (default: 1 MiB)
+      Size cache_blocks; ///< maximal number of blocks kept in the cache (default: 256)
+      Size read_ahead; ///< number of blocks fetched in addition on sequential access (default: 4)
+      Size max_concurrent; ///< maximal number of concurrent requests (default: 8)
+      Int timeout; ///< timeout of a single request (seconds, default: 60)
+      Size retries; ///< attempts per block before a read fails (default: 3)
+    };
+
+    /// Counters of the requests and the cache
+    struct OPENMS_DLLAPI Statistics
+    {
+      Statistics();
+
+      Size requests; ///< number of successful block requests
+      Size bytes_fetched; ///< bytes transferred from the server
+      Size cache_hits; ///< blocks that were read from the cache
+      Size cache_misses; ///< blocks that had to be fetched for a read
+    };
+
+    /**
+      @brief Opens the file at @p url and determines its size
+
+      @exception Exception::FileNotFound if the file cannot be accessed
+      @exception Exception::IllegalArgument if the server does not support range requests
+      @exception Exception::ParseError if the server does not report the size of the file
+    */
+    explicit RemoteFile(const String& url, const Options& options = Options());
+
+    /// Whether @p filename is a URL that can be read by this class (http:// or https://)
+    static bool isRemote(const String& filename);
+
+    /**
+      @brief Extracts the total size from the value of a Content-Range header
+
+      E.g. 'bytes 0-0/42949672960': the size follows the slash (the range
+      before it is '*' if the range could not be satisfied).
+
+      @exception Exception::ParseError if the size is missing, unknown ('*') or out of range
+    */
+    static Size parseContentRange(const String& content_range);
+
+    /// The URL of the file
+    const String& getURL() const;
+
+    /// Size of the file (bytes)
+    Size size() const;
+
+    /**
+      @brief Reads up to @p length bytes starting at @p offset into @p buffer
+
+      @return Number of bytes read (less than @p length only at the end of the file)
+      @exception Exception::IOException if a block cannot be fetched
+    */
+    Size read(Size offset, Size length, char* buffer);
+
+    /// Reads up to @p length bytes starting at @p offset (see above)
+    std::string read(Size offset, Size length);
+
+    /**
+      @brief Fetches all blocks overlapping the byte ranges [first, second) into the cache
+
+      Blocks already in the cache are not requested again. Only as many
+      blocks as fit in the cache are fetched.
+
+      @exception Exception::IOException if a block cannot be fetched
+    */
+    void prefetch(const std::vector<std::pair<Size, Size> >& ranges);
+
+    /// Request and cache counters
+    Statistics getStatistics() const;
+
+protected:
+    typedef boost::shared_ptr<const std::string> BlockPtr_;
+
+    /// Returns the cached block (null if not cached), updates the LRU order (not locked)
+    BlockPtr_ findBlock_(Size block);
+
+    /// Fetches @p blocks concurrently and adds them to the cache
+    std::vector<BlockPtr_> fetchBlocks_(const std::vector<Size>& blocks);
+
+    /// Adds a block to the cache and evicts the least recently used ones (not locked)
+    void insertBlock_(Size block, const BlockPtr_& data);
+
+    /// Number of blocks of the file
+    Size blockCount_() const;
+
+    String url_;
+    Options options_;
+    Size size_;
+
+    /// Guards the cache, the LRU list and the statistics
+    mutable std::mutex mutex_;
+    /// Block indices, most recently used first
+    std::list<Size> lru_;
+    /// Cached blocks and their position in lru_
+    std::unordered_map<Size, std::pair<BlockPtr_, std::list<Size>::iterator> > cache_;
+    /// Last block of the previous read (to detect sequential access)
+    Size last_block_;
+    Statistics statistics_;
+
+private:
+    RemoteFile(const RemoteFile&) = delete;
+    RemoteFile& operator=(const RemoteFile&) = delete;
+  };
+
+  /**
+    @brief A std::istream on a RemoteFile
+
+    Allows code that reads from standard streams (with seekg/read) to read
+    remote files. The stream itself is not thread-safe, use one per thread
+    (several streams may share a RemoteFile).
+  */
+  class OPENMS_DLLAPI RemoteFileStream :
+    public std::istream
+  {
+public:
+    /// Stream on @p file, @p buffer_size bytes are read at a time
+    explicit RemoteFileStream(const boost::shared_ptr<RemoteFile>& file, Size buffer_size = 1 << 16);
+
+    ~RemoteFileStream() override;
+
+protected:
+    /// Stream buffer reading from the RemoteFile
+    class StreamBuffer_ :
+      public std::streambuf
+    {
+public:
+      StreamBuffer_(const boost::shared_ptr<RemoteFile>& file, Size buffer_size);
+
+protected:
+      int_type underflow() override;
+      pos_type seekoff(off_type off, std::ios_base::seekdir dir, std::ios_base::openmode which) override;
+      pos_type seekpos(pos_type pos, std::ios_base::openmode which) override;
+
+      boost::shared_ptr<RemoteFile> file_;
+      std::vector<char> buffer_;
+      /// file position of the end of the buffered data
+      Size position_;
+    };
+
+    StreamBuffer_ buffer_;
+  };
+}
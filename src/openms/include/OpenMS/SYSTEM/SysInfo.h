@@ -58,18 +58,27 @@ namespace OpenMS
 			static bool getProcessMemoryConsumption(size_t& mem_virtual);
   
       /// Get peak memory consumption in KiloBytes (KB)
-      /// On Windows, this is equivalent to 'Working Set (Memory)' in Task Manager.
-      /// On other OS this might be very unreliable, depending on operating system and kernel version.
+      /// On Windows, this is equivalent to 'Peak Working Set (Memory)' in Task Manager.
+      /// On Linux, this is the peak resident set size ('VmHWM' in /proc/self/status), on macOS the maximum resident set size reported by getrusage().
       ///
       /// @param mem_virtual Total virtual memory allocated by this process
       /// @return True on success, false otherwise. If false is returned, then @p mem_virtual is set to 0.
       static bool getProcessPeakMemoryConsumption(size_t& mem_virtual);
 
+      /// Get the number of bytes this process has read and written so far (in Bytes)
+      /// On Linux, these are the 'rchar' and 'wchar' fields of /proc/self/io (i.e. including reads served from the page cache),
+      /// on Windows the transfer counts of GetProcessIoCounters(). Not supported on other OS.
+      ///
+      /// @param bytes_read Total number of bytes read
+      /// @param bytes_written Total number of bytes written
+      /// @return True on success, false otherwise. If false is returned, then both values are set to 0.
+      static bool getProcessIOCounters(size_t& bytes_read, size_t& bytes_written);
+
       /**
         @brief A convenience class to report either absolute or delta (between two timepoints) RAM usage
 
         Working RAM and Peak RAM usage are recorded at two time points ('before' and 'after').
-        @note Peak RAM is only supported on WindowsOS; other OS will only report Working RAM usage
+        @note Peak RAM is supported on Windows, Linux and macOS; other OS will only report Working RAM usage
         
         When constructed, MemUsage automatically queries the present RAM usage (first timepoint), i.e. calls @ref before().
         Data for the second timepoint can be recorded using @ref after().
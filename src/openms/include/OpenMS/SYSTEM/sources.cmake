@@ -19,10 +19,13 @@ source_group("Source Files\\OpenMS\\SYSTEM" FILES ${sources})
 
 ### list all header files of the directory here
 set(sources_list_h
+ExecutionResources.h
 File.h
 FileWatcher.h
 JavaInfo.h
 NetworkGetRequest.h
+Profiler.h
+RemoteFile.h
 StopWatch.h
 RWrapper.h
 SysInfo.h
@@ -67,6 +67,9 @@ namespace OpenMS
        - each subordinate has one convex hull
        - all convex hulls in one feature contain the same number (> 0) of points
        - the y coordinates of the hull points store the intensities
+
+       Features are fitted in parallel if OpenMP is enabled; the results do not
+       depend on the number of threads.
     */
     void fitElutionModels(FeatureMap& features);
 
@@ -77,6 +80,9 @@ namespace OpenMS
     /// Calculate quality of model fit (mean relative error)
     double calculateFitQuality_(const TraceFitter* fitter, 
                                 const MassTraces& traces);
+
+    /// Create a (Gauss or EGH) trace fitter; the caller takes ownership
+    TraceFitter* createFitter_(bool asymmetric, bool weighted) const;
   };
 }
 
@@ -38,6 +38,7 @@
 #include <OpenMS/ANALYSIS/TARGETED/TargetedExperiment.h>
 #include <OpenMS/ANALYSIS/MAPMATCHING/TransformationDescription.h>
 #include <OpenMS/ANALYSIS/OPENSWATH/MRMFeatureFinderScoring.h>
+#include <OpenMS/CHEMISTRY/ISOTOPEDISTRIBUTION/IsotopeDistribution.h>
 #include <OpenMS/CONCEPT/ProgressLogger.h>
 #include <OpenMS/DATASTRUCTURES/DefaultParamHandler.h>
 #include <OpenMS/KERNEL/MSExperiment.h>
@@ -49,8 +50,6 @@
 
 namespace OpenMS
 {
-  class IsotopeDistribution;
-
 class OPENMS_DLLAPI FeatureFinderIdentificationAlgorithm :
   public DefaultParamHandler
 {
@@ -69,6 +68,36 @@ public:
     FeatureMap& features
     );
 
+  /**
+    @brief Quantify several LC-MS runs ("cohort") based on the same external IDs
+
+    Equivalent to calling run() for every run, but the isotope distributions
+    for the assays (which do not depend on the run) are computed only once
+    for all peptides, and the runs are processed in parallel (if OpenMP is
+    enabled) by independent instances of this algorithm.
+
+    @param ms_data LC-MS data of the runs (moved into the workers, empty afterwards)
+    @param peptides Internal peptide IDs (one vector per run)
+    @param proteins Internal protein IDs (one vector per run)
+    @param peptides_ext External peptide IDs (used for all runs; may be empty)
+    @param proteins_ext External protein IDs (used for all runs)
+    @param features Output: one feature map per run
+
+    @note Parameters "candidates_out" and "svm:xval_out" are ignored here, as
+    all runs would write to the same files. Assay libraries and chromatograms
+    of the individual runs are not kept.
+
+    @throw Exception::IllegalArgument if the numbers of runs and of ID sets differ
+  */
+  void runCohort(
+    std::vector<PeakMap>& ms_data,
+    const std::vector<std::vector<PeptideIdentification> >& peptides,
+    const std::vector<std::vector<ProteinIdentification> >& proteins,
+    const std::vector<PeptideIdentification>& peptides_ext,
+    const std::vector<ProteinIdentification>& proteins_ext,
+    std::vector<FeatureMap>& features
+    );
+
   void runOnCandidates(FeatureMap& features);
 
   PeakMap& getMSData() { return ms_data_; }
@@ -131,6 +160,9 @@ protected:
 
   Size debug_level_;
 
+  /// don't change the global log streams during feature detection (set for parallel workers)
+  bool keep_log_streams_;
+
   void updateMembers_() override;
 
   /// region in RT in which a peptide elutes:
@@ -208,6 +240,7 @@ protected:
   /// TransformationDescription trafo_; // RT transformation (to range 0-1)
   TransformationDescription trafo_external_; //< transform. to external RT scale
   std::map<String, double> isotope_probs_; //< isotope probabilities of transitions
+  std::map<AASequence, IsotopeDistribution> iso_dist_cache_; //< isotope distributions of peptides (can be reused for several runs)
   MRMFeatureFinderScoring feat_finder_; //< OpenSWATH feature finder
 
   ProgressLogger prog_log_;
@@ -238,6 +271,9 @@ protected:
 
   void createAssayLibrary_(PeptideMap& peptide_map, PeptideRefRTMap& ref_rt_map);
 
+  /// compute isotope distributions for peptides that are not in the cache yet (in parallel)
+  void cacheIsotopeDistributions_(const std::vector<AASequence>& sequences);
+
   void addPeptideToMap_(PeptideIdentification& peptide, 
     PeptideMap& peptide_map,
     bool external = false) const;
@@ -38,6 +38,7 @@
 #include <OpenMS/KERNEL/StandardTypes.h>
 #include <OpenMS/CONCEPT/ProgressLogger.h>
 #include <OpenMS/TRANSFORMATIONS/RAW2PEAK/PeakPickerHiRes.h>
+#include <OpenMS/CHEMISTRY/ISOTOPEDISTRIBUTION/IsotopeDistribution.h>
 #include <OpenMS/TRANSFORMATIONS/FEATUREFINDER/MultiplexIsotopicPeakPattern.h>
 #include <OpenMS/TRANSFORMATIONS/FEATUREFINDER/MultiplexFiltering.h>
 #include <OpenMS/TRANSFORMATIONS/FEATUREFINDER/MultiplexFilteredPeak.h>
@@ -110,27 +111,47 @@ public:
     std::vector<std::vector<PeakPickerHiRes::PeakBoundary> >& getPeakBoundaries();
 
 private:
+    /**
+     * @brief sample the spline-interpolated profile data around a peak
+     *
+     * Scans the profile data from peak boundary to peak boundary. At each position, the satellites
+     * of the peak are sampled at the same m/z shift. If they pass the averagine and the peptide
+     * correlation filters, they are added to the peak.
+     *
+     * @param pattern    m/z pattern to search for
+     * @param peak    peak which passed the position filter
+     * @param navigators    navigators for all spline spectra (not shared between threads, since navigators store their last position)
+     */
+    void filterProfile_(const MultiplexIsotopicPeakPattern& pattern, MultiplexFilteredPeak& peak, std::vector<SplineSpectrum::Navigator>& navigators) const;
+
+    /**
+     * @brief averagine distribution for a given mass (according to <averagine_type_>)
+     *
+     * @throw Exception::InvalidParameter if the averagine type is unknown
+     */
+    IsotopeDistribution getAveragineDistribution_(double mass) const;
+
     /**
      * @brief averagine filter for profile mode
      *
      * @param pattern    m/z pattern to search for
-     * @param peak    peak to be filtered
-     * @param satellites    spline-interpolated satellites of the peak. If they pass, they will be added to the peak.
+     * @param distribution    averagine distribution of the peak
+     * @param satellites_profile    spline-interpolated satellites of the peak. If they pass, they will be added to the peak.
      *
      * @return boolean if this filter was passed i.e. the correlation coefficient is greater than <averagine_similarity_>
      */
-    bool filterAveragineModel_(const MultiplexIsotopicPeakPattern& pattern, const MultiplexFilteredPeak& peak, const std::multimap<size_t, MultiplexSatelliteProfile >& satellites_profile) const;
+    bool filterAveragineModel_(const MultiplexIsotopicPeakPattern& pattern, const IsotopeDistribution& distribution, const std::multimap<size_t, MultiplexSatelliteProfile >& satellites_profile) const;
 
     /**
      * @brief peptide correlation filter for profile mode
      *
      * @param pattern    m/z pattern to search for
-     * @param satellites    spline-interpolated satellites of the peak. If they pass, they will be added to the peak.
+     * @param satellites_profile    spline-interpolated satellites of the peak. If they pass, they will be added to the peak.
      *
      * @return boolean if this filter was passed i.e. the correlation coefficient is greater than <averagine_similarity_>
      */
-    bool filterPeptideCorrelation_(const MultiplexIsotopicPeakPattern& pattern, const std::multimap<size_t, MultiplexSatelliteProfile > satellites_profile) const;
-    
+    bool filterPeptideCorrelation_(const MultiplexIsotopicPeakPattern& pattern, const std::multimap<size_t, MultiplexSatelliteProfile >& satellites_profile) const;
+
     /**
      * @brief spline interpolated profile data and peak boundaries
      */
@@ -193,6 +193,8 @@ protected:
                        : (last - 1)->getMZ();
 
       InputPeakIterator help = x;
+      // index of the wavelet point corresponding to help, which is the adjacent point of the previous step
+      Size index_w_help = 0;
 
 #ifdef DEBUG_PEAK_PICKING
       std::cout << "integrate from middle to start_pos " << help->getMZ() << " until " << start_pos << std::endl;
@@ -201,23 +203,18 @@ protected:
       //integrate from middle to start_pos
       while ((help != first) && ((help - 1)->getMZ() > start_pos))
       {
-        // search for the corresponding data point of help in the wavelet (take the left most adjacent point)
-        double distance = fabs(x->getMZ() - help->getMZ());
-        Size index_w_r = (Size) Math::round(distance / spacing_);
-        if (index_w_r >= wavelet_.size())
-        {
-          index_w_r = wavelet_.size() - 1;
-        }
+        // the corresponding data point of help in the wavelet was already determined in the previous step
+        Size index_w_r = index_w_help;
         double wavelet_right =  wavelet_[index_w_r];
 
 #ifdef DEBUG_PEAK_PICKING
-        std::cout << "distance x help " << distance << std::endl;
+        std::cout << "help " << help->getMZ() << std::endl;
         std::cout << "distance in wavelet_ " << index_w_r * spacing_ << std::endl;
         std::cout << "wavelet_right "  <<  wavelet_right << std::endl;
 #endif
 
         // search for the corresponding datapoint for (help-1) in the wavelet (take the left most adjacent point)
-        distance = fabs(x->getMZ() - (help - 1)->getMZ());
+        double distance = fabs(x->getMZ() - (help - 1)->getMZ());
         Size index_w_l = (Size) Math::round(distance / spacing_);
         if (index_w_l >= wavelet_.size())
         {
@@ -237,34 +234,31 @@ protected:
 #endif
 
         v += fabs((help - 1)->getMZ() - help->getMZ()) / 2. * ((help - 1)->getIntensity() * wavelet_left + help->getIntensity() * wavelet_right);
+        index_w_help = index_w_l;
         --help;
       }
 
 
       //integrate from middle to end_pos
       help = x;
+      index_w_help = 0;
 #ifdef DEBUG_PEAK_PICKING
       std::cout << "integrate from middle to endpos " << (help)->getMZ() << " until " << end_pos << std::endl;
 #endif
       while ((help != (last - 1)) && ((help + 1)->getMZ() < end_pos))
       {
-        // search for the corresponding datapoint for help in the wavelet (take the left most adjacent point)
-        double distance = fabs(x->getMZ() - help->getMZ());
-        Size index_w_l = (Size) Math::round(distance / spacing_);
-        if (index_w_l >= wavelet_.size())
-        {
-          index_w_l = wavelet_.size() - 1;
-        }
+        // the corresponding data point of help in the wavelet was already determined in the previous step
+        Size index_w_l = index_w_help;
         double wavelet_left =  wavelet_[index_w_l];
 
 #ifdef DEBUG_PEAK_PICKING
-        std::cout << " help " << (help)->getMZ() << " distance x, help" << distance << std::endl;
+        std::cout << " help " << (help)->getMZ() << std::endl;
         std::cout << "distance in wavelet_ " << index_w_l * spacing_ << std::endl;
         std::cout << "wavelet_ at left " <<   wavelet_left << std::endl;
 #endif
 
         // search for the corresponding datapoint for (help+1) in the wavelet (take the left most adjacent point)
-        distance = fabs(x->getMZ() - (help + 1)->getMZ());
+        double distance = fabs(x->getMZ() - (help + 1)->getMZ());
         Size index_w_r = (Size) Math::round(distance / spacing_);
         if (index_w_r >= wavelet_.size())
         {
@@ -279,6 +273,7 @@ protected:
 #endif
 
         v += fabs(help->getMZ() - (help + 1)->getMZ()) / 2. * (help->getIntensity() * wavelet_left + (help + 1)->getIntensity() * wavelet_right);
+        index_w_help = index_w_r;
         ++help;
       }
 
@@ -154,6 +154,18 @@ protected:
     /// Switch for the 2D optimization of peak parameters
     bool two_d_optimization_;
 
+    /// The wavelet transformer with the tabulated wavelet for peak_width (copied for each spectrum)
+    ContinuousWaveletTransformNumIntegration wt_;
+
+    /// The wavelet transformer with the tabulated wavelet used for deconvolution (copied for each deconvolution)
+    ContinuousWaveletTransformNumIntegration wt_deconvolution_;
+
+    /// The minimal height which defines a peak in the CWT in the MS 1 level
+    double peak_bound_cwt_;
+
+    /// The minimal height which defines a peak in the CWT in the MS 2 level
+    double peak_bound_ms2_level_cwt_;
+
 
     void updateMembers_() override;
 
@@ -151,6 +151,10 @@ public:
      * @param boundaries_spec  boundaries of the picked peaks in spectra
      * @param boundaries_chrom  boundaries of the picked peaks in chromatograms
      * @param check_spectrum_type  if set, checks spectrum type and throws an exception if a centroided spectrum is passed 
+     *
+     * @note Spectra and chromatograms are picked in parallel if OpenMP is
+     * enabled, the output (including the order of the boundaries) does not
+     * depend on the number of threads.
      */
     void pickExperiment(const PeakMap& input, PeakMap& output, std::vector<std::vector<PeakBoundary> >& boundaries_spec, std::vector<std::vector<PeakBoundary> >& boundaries_chrom, const bool check_spectrum_type = true) const;
 
@@ -185,6 +189,12 @@ protected:
     /// unit of 'FWHM' float data array (can be absolute or ppm).
     bool report_FWHM_as_ppm_;
 
+    /// use SignalToNoiseEstimatorMedianRolling instead of SignalToNoiseEstimatorMedian
+    bool rolling_snt_;
+
+    /// parameters passed to the signal-to-noise estimator
+    Param snt_param_;
+
     // docu in base class
     void updateMembers_() override;
 
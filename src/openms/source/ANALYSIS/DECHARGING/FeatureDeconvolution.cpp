@@ -39,6 +39,8 @@
 #include <OpenMS/FORMAT/TextFile.h>
 #include <OpenMS/FORMAT/FeatureXMLFile.h>
 
+#include <exception>
+
 //DEBUG:
 #include <fstream>
 
@@ -320,12 +322,7 @@ namespace OpenMS
     me.compute();
     LOG_INFO << "done\n";
 
-    // holds query results for a mass difference
-    MassExplainer::CompomerIterator md_s, md_e;
     Compomer null_compomer(0, 0, -std::numeric_limits<double>::max());
-    SignedSize hits(0);
-
-    CoordinateType mz1, mz2, m1;
 
     Size possibleEdges(0), overallHits(0);
 
@@ -343,194 +340,253 @@ namespace OpenMS
     // Backbone adduct: implicit adducts don't cost anything
     Adduct proton(1, 1, Constants::PROTON_MASS_U, "H1", log(1.0), 0);
 
-    for (Size i_RT = 0; i_RT < fm_out.size(); ++i_RT) // ** RT-sweep line
+    // candidate edges of each feature (RT sweep line), found in parallel and merged in sweep line order afterwards,
+    // i.e. edge indices and adduct annotation are independent of the number of threads
+    struct CandidateEdge_
     {
-      mz1 = fm_out[i_RT].getMZ();
-
-      for (Size i_RT_window = i_RT + 1
-           ; (i_RT_window < fm_out.size())
-          && ((fm_out[i_RT_window].getRT() - fm_out[i_RT].getRT()) <= rt_diff_max)
-           ; ++i_RT_window)
-      { // ** RT-window
-
-        // knock-out criterion first: RT overlap
-        // use sorted structure and use 2nd start--1stend / 1st start--2ndend
-        const Feature& f1 = fm_out[i_RT];
-        const Feature& f2 = fm_out[i_RT_window];
+      ChargePair pair;
+      bool has_adducts_left = false;
+      bool has_adducts_right = false;
+      String adducts_left; // non-default adducts of the left feature
+      String adducts_right; // non-default adducts of the right feature
+    };
+    std::vector<std::vector<CandidateEdge_> > edges_per_feature(fm_out.size());
+
+    Size err_count(0);
+    std::exception_ptr err;
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic, 100) reduction(+: possibleEdges, overallHits, no_cmp_hit, cmp_hit)
+#endif
+    for (SignedSize i_RT = 0; i_RT < static_cast<SignedSize>(fm_out.size()); ++i_RT) // ** RT-sweep line
+    {
+      if (err_count) continue; // no need to search further if already an error was encountered
 
-        if (!(f1.getConvexHull().getBoundingBox().isEmpty() || f2.getConvexHull().getBoundingBox().isEmpty()))
-        {
-          double f_start1 = std::min(f1.getConvexHull().getBoundingBox().minX(), f2.getConvexHull().getBoundingBox().minX());
-          double f_start2 = std::max(f1.getConvexHull().getBoundingBox().minX(), f2.getConvexHull().getBoundingBox().minX());
-          double f_end1 = std::min(f1.getConvexHull().getBoundingBox().maxX(), f2.getConvexHull().getBoundingBox().maxX());
-          double f_end2 = std::max(f1.getConvexHull().getBoundingBox().maxX(), f2.getConvexHull().getBoundingBox().maxX());
+      try
+      {
+        // holds query results for a mass difference
+        MassExplainer::CompomerIterator md_s, md_e;
+        SignedSize hits(0);
+        CoordinateType mz2, m1;
+        const CoordinateType mz1 = fm_out[i_RT].getMZ();
+        std::vector<CandidateEdge_>& edges = edges_per_feature[i_RT];
+
+        for (Size i_RT_window = i_RT + 1
+             ; (i_RT_window < fm_out.size())
+            && ((fm_out[i_RT_window].getRT() - fm_out[i_RT].getRT()) <= rt_diff_max)
+             ; ++i_RT_window)
+        { // ** RT-window
+
+          // knock-out criterion first: RT overlap
+          // use sorted structure and use 2nd start--1stend / 1st start--2ndend
+          const Feature& f1 = fm_out[i_RT];
+          const Feature& f2 = fm_out[i_RT_window];
+
+          if (!(f1.getConvexHull().getBoundingBox().isEmpty() || f2.getConvexHull().getBoundingBox().isEmpty()))
+          {
+            double f_start1 = std::min(f1.getConvexHull().getBoundingBox().minX(), f2.getConvexHull().getBoundingBox().minX());
+            double f_start2 = std::max(f1.getConvexHull().getBoundingBox().minX(), f2.getConvexHull().getBoundingBox().minX());
+            double f_end1 = std::min(f1.getConvexHull().getBoundingBox().maxX(), f2.getConvexHull().getBoundingBox().maxX());
+            double f_end2 = std::max(f1.getConvexHull().getBoundingBox().maxX(), f2.getConvexHull().getBoundingBox().maxX());
 
-          double union_length = f_end2 - f_start1;
-          double intersect_length = std::max(0., f_end1 - f_start2);
+            double union_length = f_end2 - f_start1;
+            double intersect_length = std::max(0., f_end1 - f_start2);
 
-          if (intersect_length / union_length < rt_min_overlap)
-            continue;
-        }
+            if (intersect_length / union_length < rt_min_overlap)
+              continue;
+          }
 
-        // start guessing charges ...
-        mz2 = fm_out[i_RT_window].getMZ();
+          // start guessing charges ...
+          mz2 = fm_out[i_RT_window].getMZ();
 
-        for (Int q1 = q_min; q1 <= q_max; ++q1) // ** q1
-        {
-          if (!chargeTestworthy_(f1.getCharge(), q1, true))
-            continue;
-
-          //DEBUG:
-          /**if (fm_out[i_RT_window].getRT()>1930.08 && fm_out[i_RT_window].getRT()<1931.2 && mz1>1443 && mz2>1443 && mz1<2848 && mz2<2848)
+          for (Int q1 = q_min; q1 <= q_max; ++q1) // ** q1
           {
-            std::cout << "we are at debug location\n" << fm_out[i_RT_window].getRT() <<"   : " << mz1 << "; " << mz2 << "\n";
-          }
-          if (i_RT == 930 && i_RT_window == 931)
-          {
-            std::cout << "we are at debug location\n" << fm_out[i_RT_window].getRT() <<"   : " << mz1 << "; " << mz2 << "\n";
-          }*/
-          // \DEBUG
-
-          m1 = mz1 * q1;
-          // additionally: forbid q1 and q2 with distance greater than q_span
-          for (Int q2 = std::max(q_min, q1 - q_span + 1)
-               ; (q2 <= q_max) && (q2 <= q1 + q_span - 1)
-               ; ++q2)
-          { // ** q2
-            if (!chargeTestworthy_(f2.getCharge(), q2, f1.getCharge() == q1))
+            if (!chargeTestworthy_(f1.getCharge(), q1, true))
               continue;
 
-            ++possibleEdges; // internal count, not vital
-
-            // find possible adduct combinations
-            CoordinateType naive_mass_diff = mz2 * q2 - m1;
-            double abs_mass_diff = mz_diff_max * q1 + mz_diff_max * q2; // tolerance must increase when looking at M instead of m/z, as error margins increase as well
-            hits = me.query(q2 - q1, naive_mass_diff, abs_mass_diff, thresh_logp, md_s, md_e);
-            OPENMS_PRECONDITION(hits >= 0, "FeatureDeconvolution querying #hits got negative result!");
-
-            // DEBUG: write out all mass values that need explanation:
-            /*if (fabs(naive_mass_diff) < 150.0)
+            //DEBUG:
+            /**if (fm_out[i_RT_window].getRT()>1930.08 && fm_out[i_RT_window].getRT()<1931.2 && mz1>1443 && mz2>1443 && mz1<2848 && mz2<2848)
             {
-                if (q1 == f1.getCharge() &&
-                        q2 == f2.getCharge())
-                {
-                    dl_massdiff.push_back(naive_mass_diff - Constants::PROTON_MASS_U*	(q2-q1));
-                    il_chargediff.push_back(q2-q1);
-                }
+              std::cout << "we are at debug location\n" << fm_out[i_RT_window].getRT() <<"   : " << mz1 << "; " << mz2 << "\n";
             }
-            if (i_RT==429 && i_RT_window==432)
+            if (i_RT == 930 && i_RT_window == 931)
             {
-                std::cout << "DEBUG reached\n hits: " << hits << " with delta_m: " << naive_mass_diff << " and thres: " << thresh_logp << "\n";
-            }
-*/
-
-            overallHits += hits;
-            // choose most probable hit (TODO think of something clever here)
-            // for now, we take the one that has highest p in terms of the compomer structure
-            if (hits > 0)
-            {
-              Compomer best_hit = null_compomer;
-              for (; md_s != md_e; ++md_s)
+              std::cout << "we are at debug location\n" << fm_out[i_RT_window].getRT() <<"   : " << mz1 << "; " << mz2 << "\n";
+            }*/
+            // \DEBUG
+
+            m1 = mz1 * q1;
+            // additionally: forbid q1 and q2 with distance greater than q_span
+            for (Int q2 = std::max(q_min, q1 - q_span + 1)
+                 ; (q2 <= q_max) && (q2 <= q1 + q_span - 1)
+                 ; ++q2)
+            { // ** q2
+              if (!chargeTestworthy_(f2.getCharge(), q2, f1.getCharge() == q1))
+                continue;
+
+              ++possibleEdges; // internal count, not vital
+
+              // find possible adduct combinations
+              CoordinateType naive_mass_diff = mz2 * q2 - m1;
+              double abs_mass_diff = mz_diff_max * q1 + mz_diff_max * q2; // tolerance must increase when looking at M instead of m/z, as error margins increase as well
+              hits = me.query(q2 - q1, naive_mass_diff, abs_mass_diff, thresh_logp, md_s, md_e);
+              OPENMS_PRECONDITION(hits >= 0, "FeatureDeconvolution querying #hits got negative result!");
+
+              // DEBUG: write out all mass values that need explanation:
+              /*if (fabs(naive_mass_diff) < 150.0)
               {
-                // post-filter hits by local RT
-                if (fabs(f1.getRT() - f2.getRT() + md_s->getRTShift()) > rt_diff_max_local)
-                  continue;
-
-                //std::cout << "neg: " << md_s->getNegativeCharges() << " pos: " << md_s->getPositiveCharges() << " p: " << md_s->getLogP() << " \n";
-                if ( // compomer fits charge assignment of left & right feature
-                  (q1 >= md_s->getNegativeCharges()) && (q2 >= md_s->getPositiveCharges())
-                  )
-                {
-                  /*if (i_RT==528 && i_RT_window==550)
-                  {
-                      std::cout << "DEBUG reached\n hits: " << hits << " RT1: " << f1.getRT() << " RT2: " << f2.getRT() << " with intrinsic RT shift: " << md_s->getRTShift() << "smaller than " <<  rt_diff_max_local <<"\n";
-                  }*/
-
-                  // compomer has better probability
-                  if (best_hit.getLogP() < md_s->getLogP())
-                    best_hit = *md_s;
-
-
-                  /** testing: we just add every explaining edge
-                      - a first estimate shows that 90% of hits are of |1|
-                      - the remaining 10% have |2|, so the additional overhead is minimal
-                  **/
-#if 1
-                  Compomer cmp = me.getCompomerById(md_s->getID());
-                  if (((q1 - cmp.getNegativeCharges()) % proton.getCharge() != 0) ||
-                      ((q2 - cmp.getPositiveCharges()) % proton.getCharge() != 0))
+                  if (q1 == f1.getCharge() &&
+                          q2 == f2.getCharge())
                   {
-                    LOG_WARN << "Cannot add enough default adduct (" << proton.getFormula() << ") to exactly fit feature charge! Next...)\n";
-                    continue;
-                  }
-
-                  int hc_left  = (q1 - cmp.getNegativeCharges()) / proton.getCharge(); // this should always be positive! check!!
-                  int hc_right = (q2 - cmp.getPositiveCharges()) / proton.getCharge(); // this should always be positive! check!!
-
-
-                  if (hc_left < 0 || hc_right < 0)
-                  {
-                    throw Exception::Postcondition(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "WARNING!!! implicit number of H+ is negative!!! left:" + String(hc_left) + " right: " + String(hc_right) + "\n");
+                      dl_massdiff.push_back(naive_mass_diff - Constants::PROTON_MASS_U*	(q2-q1));
+                      il_chargediff.push_back(q2-q1);
                   }
+              }
+              if (i_RT==429 && i_RT_window==432)
+              {
+                  std::cout << "DEBUG reached\n hits: " << hits << " with delta_m: " << naive_mass_diff << " and thres: " << thresh_logp << "\n";
+              }
+  */
 
-                  // intensity constraint:
-                  // no edge is drawn if low-prob feature has higher intensity
-                  if (!intensityFilterPassed_(q1, q2, cmp, f1, f2))
+              overallHits += hits;
+              // choose most probable hit (TODO think of something clever here)
+              // for now, we take the one that has highest p in terms of the compomer structure
+              if (hits > 0)
+              {
+                Compomer best_hit = null_compomer;
+                for (; md_s != md_e; ++md_s)
+                {
+                  // post-filter hits by local RT
+                  if (fabs(f1.getRT() - f2.getRT() + md_s->getRTShift()) > rt_diff_max_local)
                     continue;
 
-                  // get non-default adducts of this edge
-                  Compomer cmp_stripped(cmp.removeAdduct(proton));
-
-                  // save new adduct candidate
-                  if (cmp_stripped.getComponent()[Compomer::LEFT].size() > 0)
+                  //std::cout << "neg: " << md_s->getNegativeCharges() << " pos: " << md_s->getPositiveCharges() << " p: " << md_s->getLogP() << " \n";
+                  if ( // compomer fits charge assignment of left & right feature
+                    (q1 >= md_s->getNegativeCharges()) && (q2 >= md_s->getPositiveCharges())
+                    )
                   {
-                    String tmp = cmp_stripped.getAdductsAsString(Compomer::LEFT);
-                    CmpInfo_ cmp_left(tmp, feature_relation.size(), Compomer::LEFT);
-                    feature_adducts[i_RT].insert(cmp_left);
-                  }
-                  if (cmp_stripped.getComponent()[Compomer::RIGHT].size() > 0)
-                  {
-                    String tmp = cmp_stripped.getAdductsAsString(Compomer::RIGHT);
-                    CmpInfo_ cmp_right(tmp, feature_relation.size(), Compomer::RIGHT);
-                    feature_adducts[i_RT_window].insert(cmp_right);
+                    /*if (i_RT==528 && i_RT_window==550)
+                    {
+                        std::cout << "DEBUG reached\n hits: " << hits << " RT1: " << f1.getRT() << " RT2: " << f2.getRT() << " with intrinsic RT shift: " << md_s->getRTShift() << "smaller than " <<  rt_diff_max_local <<"\n";
+                    }*/
+
+                    // compomer has better probability
+                    if (best_hit.getLogP() < md_s->getLogP())
+                      best_hit = *md_s;
+
+
+                    /** testing: we just add every explaining edge
+                        - a first estimate shows that 90% of hits are of |1|
+                        - the remaining 10% have |2|, so the additional overhead is minimal
+                    **/
+  #if 1
+                    Compomer cmp = me.getCompomerById(md_s->getID());
+                    if (((q1 - cmp.getNegativeCharges()) % proton.getCharge() != 0) ||
+                        ((q2 - cmp.getPositiveCharges()) % proton.getCharge() != 0))
+                    {
+                      LOG_WARN << "Cannot add enough default adduct (" << proton.getFormula() << ") to exactly fit feature charge! Next...)\n";
+                      continue;
+                    }
+
+                    int hc_left  = (q1 - cmp.getNegativeCharges()) / proton.getCharge(); // this should always be positive! check!!
+                    int hc_right = (q2 - cmp.getPositiveCharges()) / proton.getCharge(); // this should always be positive! check!!
+
+
+                    if (hc_left < 0 || hc_right < 0)
+                    {
+                      throw Exception::Postcondition(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "WARNING!!! implicit number of H+ is negative!!! left:" + String(hc_left) + " right: " + String(hc_right) + "\n");
+                    }
+
+                    // intensity constraint:
+                    // no edge is drawn if low-prob feature has higher intensity
+                    if (!intensityFilterPassed_(q1, q2, cmp, f1, f2))
+                      continue;
+
+                    // get non-default adducts of this edge
+                    Compomer cmp_stripped(cmp.removeAdduct(proton));
+
+                    // save new adduct candidate (registered when the edges are merged)
+                    CandidateEdge_ edge;
+                    edge.has_adducts_left = cmp_stripped.getComponent()[Compomer::LEFT].size() > 0;
+                    if (edge.has_adducts_left)
+                    {
+                      edge.adducts_left = cmp_stripped.getAdductsAsString(Compomer::LEFT);
+                    }
+                    edge.has_adducts_right = cmp_stripped.getComponent()[Compomer::RIGHT].size() > 0;
+                    if (edge.has_adducts_right)
+                    {
+                      edge.adducts_right = cmp_stripped.getAdductsAsString(Compomer::RIGHT);
+                    }
+
+                    // add implicit H+ (if != 0)
+                    if (hc_left > 0)
+                      cmp.add(proton * hc_left, Compomer::LEFT);
+                    if (hc_right > 0)
+                      cmp.add(proton * hc_right, Compomer::RIGHT);
+
+                    edge.pair = ChargePair(i_RT, i_RT_window, q1, q2, cmp, naive_mass_diff - md_s->getMass(), false);
+                    edges.push_back(edge);
+  #endif
                   }
+                } // ! hits loop
 
-                  // add implicit H+ (if != 0)
-                  if (hc_left > 0)
-                    cmp.add(proton * hc_left, Compomer::LEFT);
-                  if (hc_right > 0)
-                    cmp.add(proton * hc_right, Compomer::RIGHT);
-
-                  ChargePair cp(i_RT, i_RT_window, q1, q2, cmp, naive_mass_diff - md_s->getMass(), false);
-                  //std::cout << "CP # "<< feature_relation.size() << " :" << i_RT << " " << i_RT_window<< " " << q1<< " " << q2 << " score: " << cp.getCompomer().getLogP() << "\n";
+                if (best_hit == null_compomer)
+                {
+                  //std::cout << "FeatureDeconvolution.h:: could not find a compomer which complies with assumed q1 and q2 values!\n with q1: " << q1 << " q2: " << q2 << "\n";
+                  ++no_cmp_hit;
+                }
+                else
+                {
+                  ++cmp_hit;
+                  // disabled while we add every hit (and not only the best - see above)
+  #if 0
+                  TODO if reactivated : add implicits(see above)
+                  ChargePair cp(i_RT, i_RT_window, q1, q2, me.getCompomerById(best_hit.getID()), naive_mass_diff - best_hit.getMass(), false);
+                  //std::cout << "CP # "<< feature_relation.size() << " :" << i_RT << " " << i_RT_window<< " " << q1<< " " << q2 << "\n";
                   feature_relation.push_back(cp);
-#endif
+  #endif
                 }
-              } // ! hits loop
-
-              if (best_hit == null_compomer)
-              {
-                //std::cout << "FeatureDeconvolution.h:: could not find a compomer which complies with assumed q1 and q2 values!\n with q1: " << q1 << " q2: " << q2 << "\n";
-                ++no_cmp_hit;
               }
-              else
-              {
-                ++cmp_hit;
-                // disabled while we add every hit (and not only the best - see above)
-#if 0
-                TODO if reactivated : add implicits(see above)
-                ChargePair cp(i_RT, i_RT_window, q1, q2, me.getCompomerById(best_hit.getID()), naive_mass_diff - best_hit.getMass(), false);
-                //std::cout << "CP # "<< feature_relation.size() << " :" << i_RT << " " << i_RT_window<< " " << q1<< " " << q2 << "\n";
-                feature_relation.push_back(cp);
-#endif
-              }
-            }
 
-          } // q2
-        } // q1
-      } // RT-window
+            } // q2
+          } // q1
+        } // RT-window
+      }
+      catch (...)
+      {
+#ifdef _OPENMP
+#pragma omp critical (FeatureDeconvolution_error)
+#endif
+        {
+          if (!err_count) err = std::current_exception();
+          ++err_count;
+        }
+      }
     } // RT sweep line
 
+    if (err_count)
+    {
+      std::rethrow_exception(err);
+    }
+
+    for (Size i_RT = 0; i_RT < edges_per_feature.size(); ++i_RT)
+    {
+      for (CandidateEdge_& edge : edges_per_feature[i_RT])
+      {
+        if (edge.has_adducts_left)
+        {
+          CmpInfo_ cmp_left(edge.adducts_left, feature_relation.size(), Compomer::LEFT);
+          feature_adducts[edge.pair.getElementIndex(0)].insert(cmp_left);
+        }
+        if (edge.has_adducts_right)
+        {
+          CmpInfo_ cmp_right(edge.adducts_right, feature_relation.size(), Compomer::RIGHT);
+          feature_adducts[edge.pair.getElementIndex(1)].insert(cmp_right);
+        }
+        feature_relation.push_back(edge.pair);
+      }
+      edges_per_feature[i_RT].clear();
+    }
+
     LOG_INFO << no_cmp_hit << " of " << (no_cmp_hit + cmp_hit) << " valid net charge compomer results did not pass the feature charge constraints\n";
 
     inferMoreEdges_(feature_relation, feature_adducts);
@@ -51,7 +51,7 @@ namespace OpenMS
   {
   }
 
-  double ILPDCWrapper::compute(const FeatureMap fm, PairsType& pairs, Size verbose_level) const
+  double ILPDCWrapper::compute(const FeatureMap& fm, PairsType& pairs, Size verbose_level) const
   {
     if (fm.empty())
     {
@@ -193,14 +193,15 @@ namespace OpenMS
     time1.start();
 
     // split problem into slices and have each one solved by the ILPS
+    // (the slices contain whole connected components and write disjoint ranges of pairs, but GLPK is not
+    // thread-safe, so they are only solved in parallel with CoinOR)
     double score = 0;
-// OMP currently causes spurious segfaults in Release mode; OMP fix applied, however: disable if problem persists
-//#ifdef _OPENMP
-//#pragma omp parallel for schedule(dynamic, 1), reduction(+: score)
-//#endif
+#if defined(_OPENMP) && COINOR_SOLVER == 1
+#pragma omp parallel for schedule(dynamic, 1) reduction(+: score)
+#endif
     for (SignedSize i = 0; i < static_cast<SignedSize>(bins.size()); ++i)
     {
-      score = computeSlice_(fm, pairs, bins[i].first, bins[i].second, verbose_level);
+      score += computeSlice_(fm, pairs, bins[i].first, bins[i].second, verbose_level);
     }
     time1.stop();
     LOG_INFO << " Branch and cut took " << time1.getClockTime() << " seconds, "
@@ -215,7 +216,7 @@ namespace OpenMS
     f_set[rota_l].insert(v);
   }
 
-  double ILPDCWrapper::computeSlice_(const FeatureMap fm,
+  double ILPDCWrapper::computeSlice_(const FeatureMap& fm,
                                      PairsType& pairs,
                                      const PairsIndex margin_left,
                                      const PairsIndex margin_right,
@@ -252,12 +253,16 @@ namespace OpenMS
     }
 
     // ADD Features (multiple variants of one feature are constrained to size=1)
+    // (the constraints are collected in CSR format and added at once)
+    std::vector<Int> row_starts(1, 0), row_columns;
+    std::vector<double> row_elements, row_lower, row_upper;
+    std::vector<String> row_names;
+    std::vector<LPWrapper::Type> row_types;
     Size count(0); // each entry is a feature idx --->    Map["AdductCgf"]->adjacentEdges
     for (r_type::iterator it = features.begin(); it != features.end(); ++it)
     {
       ++count;
       std::vector<Int> columns;
-      std::vector<double> elements;
       for (FeatureType_::const_iterator iti = it->second.begin(); iti != it->second.end(); ++iti)
       {
         Int index = build.addColumn();
@@ -265,26 +270,32 @@ namespace OpenMS
         build.setColumnType(index, LPWrapper::INTEGER); // integer variable
         build.setObjective(index, 0); // obj value of feature must be a constant, as it must be neutral
         columns.push_back(index);
-        elements.push_back(1.0);
 
         /* allow connected edges only if this variant of the feature is chosen */
         /* get adjacent edges */
-        std::vector<Int> columns_e;
-        std::vector<double> elements_e;
         for (std::set<Size>::const_iterator it_e = iti->second.begin(); it_e != iti->second.end(); ++it_e)
         {
-          columns_e.push_back((Int) * it_e);
-          elements_e.push_back(-1.0);
+          row_columns.push_back((Int) * it_e);
+          row_elements.push_back(-1.0);
         }
-        columns_e.push_back((Int) index);
-        elements_e.push_back(iti->second.size()); // factor of variant is number of adjacent edges
-        String se = String("cv") + index;
-        build.addRow(columns_e, elements_e, se, 0, 10000, LPWrapper::LOWER_BOUND_ONLY);
+        row_columns.push_back((Int) index);
+        row_elements.push_back(iti->second.size()); // factor of variant is number of adjacent edges
+        row_starts.push_back((Int) row_columns.size());
+        row_names.push_back(String("cv") + index);
+        row_lower.push_back(0);
+        row_upper.push_back(10000);
+        row_types.push_back(LPWrapper::LOWER_BOUND_ONLY);
       }
-      String s = String("c") + count;
       // only allow exactly one charge variant
-      build.addRow(columns, elements, s, 1, 1, LPWrapper::FIXED);
+      row_columns.insert(row_columns.end(), columns.begin(), columns.end());
+      row_elements.insert(row_elements.end(), columns.size(), 1.0);
+      row_starts.push_back((Int) row_columns.size());
+      row_names.push_back(String("c") + count);
+      row_lower.push_back(1);
+      row_upper.push_back(1);
+      row_types.push_back(LPWrapper::FIXED);
     }
+    build.addRows(row_starts, row_columns, row_elements, row_names, row_lower, row_upper, row_types);
 
     LPWrapper::SolverParam param;
     param.enable_mir_cuts = true;
@@ -317,7 +328,7 @@ namespace OpenMS
 
   // old version, slower, as ILP has different layout (i.e, the same as described in paper)
 
-  double ILPDCWrapper::computeSliceOld_(const FeatureMap fm,
+  double ILPDCWrapper::computeSliceOld_(const FeatureMap& fm,
                                         PairsType& pairs,
                                         const PairsIndex margin_left,
                                         const PairsIndex margin_right,
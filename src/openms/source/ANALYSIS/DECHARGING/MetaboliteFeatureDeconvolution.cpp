@@ -41,6 +41,8 @@
 #include <OpenMS/FORMAT/TextFile.h>
 #include <OpenMS/FORMAT/FeatureXMLFile.h>
 
+#include <exception>
+
 //DEBUG:
 #include <fstream>
 
@@ -446,195 +448,251 @@ namespace OpenMS
     LOG_INFO << "done\n";
 
 
-    // holds query results for a mass difference
-    MassExplainer::CompomerIterator md_s, md_e;
     Compomer null_compomer(0, 0, -std::numeric_limits<double>::max());
-    SignedSize hits(0);
 
-    CoordinateType mz1, mz2, m1;
     Size possibleEdges(0), overallHits(0);
 
     // # compomer results that either passed or failed the feature charge constraints
     Size no_cmp_hit(0), cmp_hit(0);
 
-    for (Size i_RT = 0; i_RT < fm_out.size(); ++i_RT) // ** RT-sweep line
+    // candidate edges of each feature (RT sweep line), found in parallel and merged in sweep line order afterwards,
+    // i.e. edge indices and adduct annotation are independent of the number of threads
+    struct CandidateEdge_
     {
-      mz1 = fm_out[i_RT].getMZ();
-
-      for (Size i_RT_window = i_RT + 1
-           ; (i_RT_window < fm_out.size())
-          && ((fm_out[i_RT_window].getRT() - fm_out[i_RT].getRT()) <= rt_diff_max)
-           ; ++i_RT_window)
-      { // ** RT-window
-
-        // knock-out criterion first: RT overlap
-        // use sorted structure and use 2nd start--1stend / 1st start--2ndend
-        const Feature& f1 = fm_out[i_RT];
-        const Feature& f2 = fm_out[i_RT_window];
-
-        if (!(f1.getConvexHull().getBoundingBox().isEmpty() || f2.getConvexHull().getBoundingBox().isEmpty()))
-        {
-          double f_start1 = std::min(f1.getConvexHull().getBoundingBox().minX(), f2.getConvexHull().getBoundingBox().minX());
-          double f_start2 = std::max(f1.getConvexHull().getBoundingBox().minX(), f2.getConvexHull().getBoundingBox().minX());
-          double f_end1 = std::min(f1.getConvexHull().getBoundingBox().maxX(), f2.getConvexHull().getBoundingBox().maxX());
-          double f_end2 = std::max(f1.getConvexHull().getBoundingBox().maxX(), f2.getConvexHull().getBoundingBox().maxX());
-
-          double union_length = f_end2 - f_start1;
-          double intersect_length = std::max(0., f_end1 - f_start2);
+      ChargePair pair;
+      bool has_adducts_left = false;
+      bool has_adducts_right = false;
+      String adducts_left; // non-default adducts of the left feature
+      String adducts_right; // non-default adducts of the right feature
+    };
+    std::vector<std::vector<CandidateEdge_> > edges_per_feature(fm_out.size());
+
+    Size err_count(0);
+    std::exception_ptr err;
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic, 100) reduction(+: possibleEdges, overallHits, no_cmp_hit, cmp_hit)
+#endif
+    for (SignedSize i_RT = 0; i_RT < static_cast<SignedSize>(fm_out.size()); ++i_RT) // ** RT-sweep line
+    {
+      if (err_count) continue; // no need to search further if already an error was encountered
 
-          if (intersect_length / union_length < rt_min_overlap)
-            continue;
-        }
+      try
+      {
+        // holds query results for a mass difference
+        MassExplainer::CompomerIterator md_s, md_e;
+        SignedSize hits(0);
+        CoordinateType mz2, m1;
+        const CoordinateType mz1 = fm_out[i_RT].getMZ();
+        std::vector<CandidateEdge_>& edges = edges_per_feature[i_RT];
+
+        for (Size i_RT_window = i_RT + 1
+             ; (i_RT_window < fm_out.size())
+            && ((fm_out[i_RT_window].getRT() - fm_out[i_RT].getRT()) <= rt_diff_max)
+             ; ++i_RT_window)
+        { // ** RT-window
+
+          // knock-out criterion first: RT overlap
+          // use sorted structure and use 2nd start--1stend / 1st start--2ndend
+          const Feature& f1 = fm_out[i_RT];
+          const Feature& f2 = fm_out[i_RT_window];
+
+          if (!(f1.getConvexHull().getBoundingBox().isEmpty() || f2.getConvexHull().getBoundingBox().isEmpty()))
+          {
+            double f_start1 = std::min(f1.getConvexHull().getBoundingBox().minX(), f2.getConvexHull().getBoundingBox().minX());
+            double f_start2 = std::max(f1.getConvexHull().getBoundingBox().minX(), f2.getConvexHull().getBoundingBox().minX());
+            double f_end1 = std::min(f1.getConvexHull().getBoundingBox().maxX(), f2.getConvexHull().getBoundingBox().maxX());
+            double f_end2 = std::max(f1.getConvexHull().getBoundingBox().maxX(), f2.getConvexHull().getBoundingBox().maxX());
 
-        // start guessing charges ...
-        mz2 = fm_out[i_RT_window].getMZ();
+            double union_length = f_end2 - f_start1;
+            double intersect_length = std::max(0., f_end1 - f_start2);
 
-        for (Int q1 = q_min; q1 <= q_max; ++q1) // ** q1
-        {
-          //We assume that ionization modes won't get mixed in pipeline ->
-          //detected features should have same charge sign as provided to decharger settings for positive mode.
-          //For negative mode, this requirement is relaxed.
-          if (!chargeTestworthy_(f1.getCharge(), q1, true))
-            continue;
-
-          m1 = mz1 * abs(q1);
-          // additionally: forbid q1 and q2 with distance greater than q_span
-          for (Int q2 = std::max(q_min, q1 - q_span + 1)
-               ; (q2 <= q_max) && (q2 <= q1 + q_span - 1)
-               ; ++q2)
-          { // ** q2
-            //again, for negative mode relaxed, thus we consider the absolute of charge
-            if (!chargeTestworthy_(f2.getCharge(), q2, abs(f1.getCharge()) == abs(q1)))
+            if (intersect_length / union_length < rt_min_overlap)
               continue;
+          }
 
-            ++possibleEdges; // internal count, not vital
+          // start guessing charges ...
+          mz2 = fm_out[i_RT_window].getMZ();
 
-            // find possible adduct combinations
-            CoordinateType naive_mass_diff = mz2 * abs(q2) - m1;
-            double abs_mass_diff = mz_diff_max * abs(q1) + mz_diff_max * abs(q2); // tolerance must increase when looking at M instead of m/z, as error margins increase as well
-            //abs charge "3" to abs charge "1" -> simply invert charge delta for negative case?
-            hits = me.query(q2 - q1, naive_mass_diff, abs_mass_diff, thresh_logp, md_s, md_e);
-            OPENMS_PRECONDITION(hits >= 0, "MetaboliteFeatureDeconvolution querying #hits got negative result!");
+          for (Int q1 = q_min; q1 <= q_max; ++q1) // ** q1
+          {
+            //We assume that ionization modes won't get mixed in pipeline ->
+            //detected features should have same charge sign as provided to decharger settings for positive mode.
+            //For negative mode, this requirement is relaxed.
+            if (!chargeTestworthy_(f1.getCharge(), q1, true))
+              continue;
 
-            overallHits += hits;
-            // choose most probable hit (TODO think of something clever here)
-            // for now, we take the one that has highest p in terms of the compomer structure
-            if (hits > 0)
-            {
-              Compomer best_hit = null_compomer;
-              for (; md_s != md_e; ++md_s)
+            m1 = mz1 * abs(q1);
+            // additionally: forbid q1 and q2 with distance greater than q_span
+            for (Int q2 = std::max(q_min, q1 - q_span + 1)
+                 ; (q2 <= q_max) && (q2 <= q1 + q_span - 1)
+                 ; ++q2)
+            { // ** q2
+              //again, for negative mode relaxed, thus we consider the absolute of charge
+              if (!chargeTestworthy_(f2.getCharge(), q2, abs(f1.getCharge()) == abs(q1)))
+                continue;
+
+              ++possibleEdges; // internal count, not vital
+
+              // find possible adduct combinations
+              CoordinateType naive_mass_diff = mz2 * abs(q2) - m1;
+              double abs_mass_diff = mz_diff_max * abs(q1) + mz_diff_max * abs(q2); // tolerance must increase when looking at M instead of m/z, as error margins increase as well
+              //abs charge "3" to abs charge "1" -> simply invert charge delta for negative case?
+              hits = me.query(q2 - q1, naive_mass_diff, abs_mass_diff, thresh_logp, md_s, md_e);
+              OPENMS_PRECONDITION(hits >= 0, "MetaboliteFeatureDeconvolution querying #hits got negative result!");
+
+              overallHits += hits;
+              // choose most probable hit (TODO think of something clever here)
+              // for now, we take the one that has highest p in terms of the compomer structure
+              if (hits > 0)
               {
-                // post-filter hits by local RT
-                if (fabs(f1.getRT() - f2.getRT() + md_s->getRTShift()) > rt_diff_max_local)
-                  continue;
-
-                //std::cout << md_s->getAdductsAsString() << " neg: " << md_s->getNegativeCharges() << " pos: " << md_s->getPositiveCharges() << " p: " << md_s->getLogP() << " \n";
-                int left_charges, right_charges;
-                if (is_neg)
-                {
-                  left_charges = -md_s->getPositiveCharges();
-                  right_charges = -md_s->getNegativeCharges();//for negative, a pos charge means either losing an H-1 from the left (decreasing charge) or the Na  case. (We do H-1Na as neutral, because of the pos,negcharges)
-                }
-                else
-                {
-                  left_charges = md_s->getNegativeCharges();//for positive mode neutral switches still have to fulfill requirement that they have at most charge as each side
-                  right_charges = md_s->getPositiveCharges();
-                }
-
-                if ( // compomer fits charge assignment of left & right feature. doesnt consider charge sign switch over span!
-                  (abs(q1)  >= abs(left_charges)) && (abs(q2) >= abs(right_charges)))
+                Compomer best_hit = null_compomer;
+                for (; md_s != md_e; ++md_s)
                 {
-                  // compomer has better probability
-                  if (best_hit.getLogP() < md_s->getLogP())
-                    best_hit = *md_s;
-
+                  // post-filter hits by local RT
+                  if (fabs(f1.getRT() - f2.getRT() + md_s->getRTShift()) > rt_diff_max_local)
+                    continue;
 
-                  /** testing: we just add every explaining edge
-                      - a first estimate shows that 90% of hits are of |1|
-                      - the remaining 10% have |2|, so the additional overhead is minimal
-                  **/
-                  Compomer cmp = me.getCompomerById(md_s->getID());
+                  //std::cout << md_s->getAdductsAsString() << " neg: " << md_s->getNegativeCharges() << " pos: " << md_s->getPositiveCharges() << " p: " << md_s->getLogP() << " \n";
+                  int left_charges, right_charges;
                   if (is_neg)
                   {
-                    left_charges = -cmp.getPositiveCharges();
-                    right_charges = -cmp.getNegativeCharges();
+                    left_charges = -md_s->getPositiveCharges();
+                    right_charges = -md_s->getNegativeCharges();//for negative, a pos charge means either losing an H-1 from the left (decreasing charge) or the Na  case. (We do H-1Na as neutral, because of the pos,negcharges)
                   }
                   else
                   {
-                    left_charges = cmp.getNegativeCharges();
-                    right_charges = cmp.getPositiveCharges();
-                  }
-
-                  //this block should only be of interest if we have something multiply charges instead of protonation or deprotonation
-                  if (((q1 - left_charges) % default_adduct.getCharge() != 0) ||
-                      ((q2 - right_charges) % default_adduct.getCharge() != 0))
-                  {
-                    LOG_WARN << "Cannot add enough default adduct (" << default_adduct.getFormula() << ") to exactly fit feature charge! Next...)\n";
-                    continue;
+                    left_charges = md_s->getNegativeCharges();//for positive mode neutral switches still have to fulfill requirement that they have at most charge as each side
+                    right_charges = md_s->getPositiveCharges();
                   }
 
-                  int hc_left  = (q1 - left_charges) / default_adduct.getCharge();//this should always be positive! check!!
-                  int hc_right = (q2 - right_charges) / default_adduct.getCharge();//this should always be positive! check!!
-
-
-                  if (hc_left < 0 || hc_right < 0)
+                  if ( // compomer fits charge assignment of left & right feature. doesnt consider charge sign switch over span!
+                    (abs(q1)  >= abs(left_charges)) && (abs(q2) >= abs(right_charges)))
                   {
-                    throw Exception::Postcondition(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "WARNING!!! implicit number of default adduct is negative!!! left:" + String(hc_left) + " right: " + String(hc_right) + "\n");
+                    // compomer has better probability
+                    if (best_hit.getLogP() < md_s->getLogP())
+                      best_hit = *md_s;
+
+
+                    /** testing: we just add every explaining edge
+                        - a first estimate shows that 90% of hits are of |1|
+                        - the remaining 10% have |2|, so the additional overhead is minimal
+                    **/
+                    Compomer cmp = me.getCompomerById(md_s->getID());
+                    if (is_neg)
+                    {
+                      left_charges = -cmp.getPositiveCharges();
+                      right_charges = -cmp.getNegativeCharges();
+                    }
+                    else
+                    {
+                      left_charges = cmp.getNegativeCharges();
+                      right_charges = cmp.getPositiveCharges();
+                    }
+
+                    //this block should only be of interest if we have something multiply charges instead of protonation or deprotonation
+                    if (((q1 - left_charges) % default_adduct.getCharge() != 0) ||
+                        ((q2 - right_charges) % default_adduct.getCharge() != 0))
+                    {
+                      LOG_WARN << "Cannot add enough default adduct (" << default_adduct.getFormula() << ") to exactly fit feature charge! Next...)\n";
+                      continue;
+                    }
+
+                    int hc_left  = (q1 - left_charges) / default_adduct.getCharge();//this should always be positive! check!!
+                    int hc_right = (q2 - right_charges) / default_adduct.getCharge();//this should always be positive! check!!
+
+
+                    if (hc_left < 0 || hc_right < 0)
+                    {
+                      throw Exception::Postcondition(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "WARNING!!! implicit number of default adduct is negative!!! left:" + String(hc_left) + " right: " + String(hc_right) + "\n");
+                    }
+
+                    // intensity constraint:
+                    // no edge is drawn if low-prob feature has higher intensity
+                    if (!intensityFilterPassed_(q1, q2, cmp, f1, f2))
+                      continue;
+
+                    // get non-default adducts of this edge
+                    Compomer cmp_stripped(cmp.removeAdduct(default_adduct));
+
+                    // save new adduct candidate (registered when the edges are merged)
+                    CandidateEdge_ edge;
+                    edge.has_adducts_left = cmp_stripped.getComponent()[Compomer::LEFT].size() > 0;
+                    if (edge.has_adducts_left)
+                    {
+                      edge.adducts_left = cmp_stripped.getAdductsAsString(Compomer::LEFT);
+                    }
+                    edge.has_adducts_right = cmp_stripped.getComponent()[Compomer::RIGHT].size() > 0;
+                    if (edge.has_adducts_right)
+                    {
+                      edge.adducts_right = cmp_stripped.getAdductsAsString(Compomer::RIGHT);
+                    }
+
+                    // add implicit default adduct (H+ or H-) (if != 0)
+                    if (hc_left > 0)
+                    {
+                      cmp.add(default_adduct * hc_left, Compomer::LEFT);
+                    }
+                    if (hc_right > 0)
+                    {
+                      cmp.add(default_adduct * hc_right, Compomer::RIGHT);
+                    }
+
+                    edge.pair = ChargePair(i_RT, i_RT_window, q1, q2, cmp, naive_mass_diff - md_s->getMass(), false);
+                    edges.push_back(edge);
                   }
+                } // ! hits loop
 
-                  // intensity constraint:
-                  // no edge is drawn if low-prob feature has higher intensity
-                  if (!intensityFilterPassed_(q1, q2, cmp, f1, f2))
-                    continue;
-
-                  // get non-default adducts of this edge
-                  Compomer cmp_stripped(cmp.removeAdduct(default_adduct));
-
-                  // save new adduct candidate
-                  if (cmp_stripped.getComponent()[Compomer::LEFT].size() > 0)
-                  {
-                    String tmp = cmp_stripped.getAdductsAsString(Compomer::LEFT);
-                    CmpInfo_ cmp_left(tmp, feature_relation.size(), Compomer::LEFT);
-                    feature_adducts[i_RT].insert(cmp_left);
-                  }
-                  if (cmp_stripped.getComponent()[Compomer::RIGHT].size() > 0)
-                  {
-                    String tmp = cmp_stripped.getAdductsAsString(Compomer::RIGHT);
-                    CmpInfo_ cmp_right(tmp, feature_relation.size(), Compomer::RIGHT);
-                    feature_adducts[i_RT_window].insert(cmp_right);
-                  }
-
-                  // add implicit default adduct (H+ or H-) (if != 0)
-                  if (hc_left > 0)
-                  {
-                    cmp.add(default_adduct * hc_left, Compomer::LEFT);
-                  }
-                  if (hc_right > 0)
-                  {
-                    cmp.add(default_adduct * hc_right, Compomer::RIGHT);
-                  }
-
-                  ChargePair cp(i_RT, i_RT_window, q1, q2, cmp, naive_mass_diff - md_s->getMass(), false);
-                  feature_relation.push_back(cp);
+                if (best_hit == null_compomer)
+                {
+                  //std::cout << "MetaboliteFeatureDeconvolution.h:: could find no compomer complying with assumed q1 and q2 values!\n with q1: " << q1 << " q2: " << q2 << "\n";
+                  ++no_cmp_hit;
+                }
+                else
+                {
+                  ++cmp_hit;
                 }
-              } // ! hits loop
-
-              if (best_hit == null_compomer)
-              {
-                //std::cout << "MetaboliteFeatureDeconvolution.h:: could find no compomer complying with assumed q1 and q2 values!\n with q1: " << q1 << " q2: " << q2 << "\n";
-                ++no_cmp_hit;
-              }
-              else
-              {
-                ++cmp_hit;
               }
-            }
 
-          } // q2
-        } // q1
-      } // RT-window
+            } // q2
+          } // q1
+        } // RT-window
+      }
+      catch (...)
+      {
+#ifdef _OPENMP
+#pragma omp critical (FeatureDeconvolution_error)
+#endif
+        {
+          if (!err_count) err = std::current_exception();
+          ++err_count;
+        }
+      }
     } // RT sweep line
 
+    if (err_count)
+    {
+      std::rethrow_exception(err);
+    }
+
+    for (Size i_RT = 0; i_RT < edges_per_feature.size(); ++i_RT)
+    {
+      for (CandidateEdge_& edge : edges_per_feature[i_RT])
+      {
+        if (edge.has_adducts_left)
+        {
+          CmpInfo_ cmp_left(edge.adducts_left, feature_relation.size(), Compomer::LEFT);
+          feature_adducts[edge.pair.getElementIndex(0)].insert(cmp_left);
+        }
+        if (edge.has_adducts_right)
+        {
+          CmpInfo_ cmp_right(edge.adducts_right, feature_relation.size(), Compomer::RIGHT);
+          feature_adducts[edge.pair.getElementIndex(1)].insert(cmp_right);
+        }
+        feature_relation.push_back(edge.pair);
+      }
+      edges_per_feature[i_RT].clear();
+    }
+
 
     LOG_INFO << no_cmp_hit << " of " << (no_cmp_hit + cmp_hit) << " valid net charge compomer results did not pass the feature charge constraints\n";
 
@@ -40,6 +40,8 @@
 #include <OpenMS/CHEMISTRY/ResidueDB.h>
 #include <OpenMS/ANALYSIS/DENOVO/CompNovoIonScoring.h>
 
+#include <exception>
+
 //#define DAC_DEBUG
 //#define ESTIMATE_PRECURSOR_DEBUG
 
@@ -79,47 +81,83 @@ namespace OpenMS
 
   void CompNovoIdentification::getIdentifications(vector<PeptideIdentification> & pep_ids, const PeakMap & exp)
   {
-    Size count(1);
-    for (PeakMap::ConstIterator it = exp.begin(); it != exp.end(); ++it, ++count)
+    // collect the pairs of CID and ETD spectra first (indices into exp)
+    vector<pair<Size, Size> > spectrum_pairs;
+    for (Size i = 0; i < exp.size(); ++i)
     {
-      //cerr << count << "/" << exp.size() / 2 << endl;
-
-      PeptideIdentification id;
-      PeakSpectrum CID_spec(*it);
-      double cid_rt(it->getRT());
+      const PeakSpectrum& spec = exp[i];
+      double cid_rt(spec.getRT());
       double cid_mz(0);
-      if (!it->getPrecursors().empty())
+      if (!spec.getPrecursors().empty())
       {
-        cid_mz = it->getPrecursors().begin()->getMZ();
+        cid_mz = spec.getPrecursors().begin()->getMZ();
       }
 
-      if (it->getPrecursors().empty() || cid_mz == 0)
+      if (spec.getPrecursors().empty() || cid_mz == 0)
       {
-        cerr << "CompNovoIdentification: Spectrum id=\"" << it->getNativeID() << "\" at RT=" << cid_rt << " does not have valid precursor information." << endl;
+        cerr << "CompNovoIdentification: Spectrum id=\"" << spec.getNativeID() << "\" at RT=" << cid_rt << " does not have valid precursor information." << endl;
         continue;
       }
-      id.setRT(cid_rt);
-      id.setMZ(cid_mz);
 
-      if ((it + 1) != exp.end() && !(it + 1)->getPrecursors().empty())
+      if ((i + 1) < exp.size() && !exp[i + 1].getPrecursors().empty())
       {
-        double etd_rt = (it + 1)->getRT();
-        double etd_mz = (it + 1)->getPrecursors().begin()->getMZ();
+        double etd_rt = exp[i + 1].getRT();
+        double etd_mz = exp[i + 1].getPrecursors().begin()->getMZ();
 
         if (fabs(etd_rt - cid_rt) < 10 &&         // RT distance is not too large
             fabs(etd_mz - cid_mz) < 0.01)             // same precursor used
         {
-          PeakSpectrum ETD_spec(*(++it));
+          spectrum_pairs.push_back(make_pair(i, i + 1));
+          ++i;
+        }
+      }
+    }
 
-          subspec_to_sequences_.clear();
-          permute_cache_.clear();
+    // the pairs are identified independently of each other (in parallel), each
+    // thread uses its own copy of this instance, sharing the decomposition cache
+    vector<PeptideIdentification> ids(spectrum_pairs.size());
+    Size err_count(0);
+    std::exception_ptr err;
+#ifdef _OPENMP
+#pragma omp parallel
+#endif
+    {
+      CompNovoIdentification worker(*this);
+      worker.decomp_cache_ = decomp_cache_;
 
-          getIdentification(id, CID_spec, ETD_spec);
-          //cerr << "size_of id=" << id.getHits().size() << endl;
-          pep_ids.push_back(id);
+#ifdef _OPENMP
+#pragma omp for schedule(dynamic)
+#endif
+      for (SignedSize i = 0; i < SignedSize(spectrum_pairs.size()); ++i)
+      {
+        try
+        {
+          const PeakSpectrum& CID_spec = exp[spectrum_pairs[i].first];
+          PeptideIdentification& id = ids[i];
+          id.setRT(CID_spec.getRT());
+          id.setMZ(CID_spec.getPrecursors().begin()->getMZ());
+
+          worker.subspec_to_sequences_.clear();
+          worker.permute_cache_.clear();
+
+          worker.getIdentification(id, CID_spec, exp[spectrum_pairs[i].second]);
+        }
+        catch (...)
+        {
+#ifdef _OPENMP
+#pragma omp critical (CompNovoIdentification_error)
+#endif
+          {
+            if (err_count++ == 0) err = std::current_exception();
+          }
         }
       }
     }
+    if (err_count > 0)
+    {
+      std::rethrow_exception(err);
+    }
+    pep_ids.insert(pep_ids.end(), ids.begin(), ids.end());
     return;
   }
 
@@ -58,7 +58,8 @@ namespace OpenMS
     min_mz_(200.0),
     max_decomp_weight_(450.0),
     max_subscore_number_(30),
-    max_isotope_(3)
+    max_isotope_(3),
+    decomp_cache_(new DecompositionCache())
   {
     defaults_.setValue("max_number_aa_per_decomp", 4, "maximal amino acid frequency per decomposition", ListUtils::create<String>("advanced"));
     defaults_.setValue("tryptic_only", "true", "if set to true only tryptic peptides are reported");
@@ -349,25 +350,48 @@ namespace OpenMS
 
   void CompNovoIdentificationBase::getDecompositions_(vector<MassDecomposition> & decomps, double mass, bool no_caching)
   {
-    //static Map<double, vector<MassDecomposition> > decomp_cache;
-    if (!no_caching)
+    getDecompositions_(decomps, mass, fragment_mass_tolerance_, no_caching);
+  }
+
+  void CompNovoIdentificationBase::getDecompositions_(vector<MassDecomposition> & decomps, double mass, double tolerance, bool no_caching)
+  {
+    if (no_caching || decomp_weights_precision_ <= 0.0)
+    {
+      decomps.clear();
+      mass_decomp_algorithm_.getDecompositions(decomps, mass, tolerance);
+      filterDecomps_(decomps);
+      return;
+    }
+
+    // decompose the quantized mass, so that the result does not depend on which spectrum filled the cache first
+    const DecompositionCache::key_type key(static_cast<Int64>(floor(mass / decomp_weights_precision_ + 0.5)), tolerance);
+    bool found(false);
+#ifdef _OPENMP
+#pragma omp critical (CompNovoIdentificationBase_decomp_cache)
+#endif
     {
-      if (decomp_cache_.has(mass))
+      DecompositionCache::const_iterator pos = decomp_cache_->find(key);
+      if (pos != decomp_cache_->end())
       {
-        decomps = decomp_cache_[mass];
-        return;
+        decomps = pos->second;
+        found = true;
       }
     }
+    if (found)
+    {
+      return;
+    }
 
-    mass_decomp_algorithm_.getDecompositions(decomps, mass);
+    decomps.clear();
+    mass_decomp_algorithm_.getDecompositions(decomps, key.first * decomp_weights_precision_, tolerance);
     filterDecomps_(decomps);
 
-    if (!no_caching)
+#ifdef _OPENMP
+#pragma omp critical (CompNovoIdentificationBase_decomp_cache)
+#endif
     {
-      decomp_cache_[mass]  = decomps;
+      decomp_cache_->insert(make_pair(key, decomps));
     }
-
-    return;
   }
 
   void CompNovoIdentificationBase::selectPivotIons_(vector<Size> & pivots, Size left, Size right, Map<double, CompNovoIonScoringBase::IonScore> & ion_scores, const PeakSpectrum & CID_spec, double precursor_weight, bool full_range)
@@ -655,6 +679,9 @@ for (set<Size>::const_iterator it = used_pos.begin(); it != used_pos.end(); ++it
     max_subscore_number_ = param_.getValue("max_subscore_number");
     max_isotope_ = param_.getValue("max_isotope");
 
+    // decompositions depend on the parameters
+    decomp_cache_.reset(new DecompositionCache());
+
     name_to_residue_.clear();
     residue_to_name_.clear();
 
@@ -39,6 +39,8 @@
 #include <OpenMS/COMPARISON/SPECTRA/SpectrumAlignmentScore.h>
 #include <OpenMS/ANALYSIS/DENOVO/CompNovoIonScoringCID.h>
 
+#include <exception>
+
 //#define DAC_DEBUG
 
 //#define WRITE_SCORED_SPEC
@@ -84,32 +86,52 @@ namespace OpenMS
 
   void CompNovoIdentificationCID::getIdentifications(vector<PeptideIdentification> & pep_ids, const PeakMap & exp)
   {
-    Size count(1);
-    for (PeakMap::ConstIterator it = exp.begin(); it != exp.end(); ++it, ++count)
+    // spectra are identified independently of each other (in parallel), each
+    // thread uses its own copy of this instance, sharing the decomposition cache
+    vector<PeptideIdentification> ids(exp.size());
+    Size err_count(0);
+    std::exception_ptr err;
+#ifdef _OPENMP
+#pragma omp parallel
+#endif
+    {
+      CompNovoIdentificationCID worker(*this);
+      worker.decomp_cache_ = decomp_cache_;
+
+#ifdef _OPENMP
+#pragma omp for schedule(dynamic)
+#endif
+      for (SignedSize i = 0; i < SignedSize(exp.size()); ++i)
+      {
+        try
+        {
+          PeptideIdentification& id = ids[i];
+          // TODO check if both CID and ETD is present;
+          PeakSpectrum CID_spec(exp[i]);
+          id.setRT(exp[i].getRT());
+          id.setMZ(exp[i].getPrecursors().begin()->getMZ());
+
+          worker.subspec_to_sequences_.clear();
+          worker.permute_cache_.clear();
+
+          worker.getIdentification(id, CID_spec);
+        }
+        catch (...)
+        {
+#ifdef _OPENMP
+#pragma omp critical (CompNovoIdentificationCID_error)
+#endif
+          {
+            if (err_count++ == 0) err = std::current_exception();
+          }
+        }
+      }
+    }
+    if (err_count > 0)
     {
-      //cerr << count << "/" << exp.size() << endl;
-      PeptideIdentification id;
-      // TODO check if both CID and ETD is present;
-      PeakSpectrum CID_spec(*it);
-      id.setRT(it->getRT());
-      id.setMZ(it->getPrecursors().begin()->getMZ());
-
-      subspec_to_sequences_.clear();
-      permute_cache_.clear();
-      decomp_cache_.clear();
-
-      getIdentification(id, CID_spec);
-      //cerr << "size_of id=" << id.getHits().size() << endl;
-      pep_ids.push_back(id);
-
-      //++it;
-
-      //
-      //if (count == 10)
-      //{
-      //return;
-      //}
+      std::rethrow_exception(err);
     }
+    pep_ids.insert(pep_ids.end(), ids.begin(), ids.end());
     return;
   }
 
@@ -558,12 +580,7 @@ for (PeakSpectrum::ConstIterator it1 = CID_spec.begin(); it1 != CID_spec.end();
       // if we are at the C-terminus use precursor_mass_tolerance_
       if (offset_prefix < precursor_mass_tolerance_)
       {
-        Param decomp_param(mass_decomp_algorithm_.getParameters());
-        decomp_param.setValue("tolerance", precursor_mass_tolerance_);
-        mass_decomp_algorithm_.setParameters(decomp_param);
-        getDecompositions_(decomps, diff);
-        decomp_param.setValue("tolerance", fragment_mass_tolerance_);
-        mass_decomp_algorithm_.setParameters(decomp_param);
+        getDecompositions_(decomps, diff, precursor_mass_tolerance_, false);
       }
       else
       {
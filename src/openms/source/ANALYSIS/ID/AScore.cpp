@@ -124,9 +124,11 @@ namespace OpenMS
       real_spectrum.sortByPosition();
     }
     vector<PeakSpectrum> windows_top10 = peakPickingPerWindowsInSpectrum_(real_spectrum);
+    // the windows reduced to all peak depths are shared by all permutations
+    vector<vector<PeakSpectrum>> windows_by_depth = reduceWindows_(windows_top10);
 
     // calculate peptide score for each possible phospho site permutation
-    vector<vector<double>> peptide_site_scores = calculatePermutationPeptideScores_(th_spectra, windows_top10);
+    vector<vector<double>> peptide_site_scores = calculatePermutationPeptideScores_(th_spectra, windows_by_depth);
 
     // rank peptide permutations ascending
     multimap<double, Size> ranking = rankWeightedPermutationPeptideScores_(peptide_site_scores);
@@ -163,18 +165,11 @@ namespace OpenMS
         Size N = site_determining_ions[0].size(); // all possibilities have the same number so take the first one
         double p = static_cast<double>(s_it->peak_depth) / 100.0;
 
-        Size n_first = 0; // number of matching peaks for first peptide
-        for (Size window_idx = 0; window_idx != windows_top10.size(); ++window_idx) // for each 100 m/z window
-        {
-          n_first += numberOfMatchedIons_(site_determining_ions[0], windows_top10[window_idx], s_it->peak_depth);        
-        }
+        const vector<PeakSpectrum>& windows_reduced = windows_by_depth[s_it->peak_depth - 1];
+        Size n_first = numberOfMatchedIons_(site_determining_ions[0], windows_reduced); // number of matching peaks for first peptide
         double P_first = computeCumulativeScore_(N, n_first, p);
 
-        Size n_second = 0; // number of matching peaks for second peptide
-        for (Size window_idx = 0; window_idx <  windows_top10.size(); ++window_idx) //each 100 m/z window
-        {
-          n_second += numberOfMatchedIons_(site_determining_ions[1], windows_top10[window_idx], s_it->peak_depth);        
-        }
+        Size n_second = numberOfMatchedIons_(site_determining_ions[1], windows_reduced); // number of matching peaks for second peptide
         Size N2 = site_determining_ions[1].size(); // all possibilities have the same number so take the first one
         double P_second = computeCumulativeScore_(N2, n_second, p);
 
@@ -362,6 +357,11 @@ namespace OpenMS
     }
     
     window_reduced.sortByPosition();
+    return numberOfMatchedIons_(th, window_reduced);
+  }
+
+  Size AScore::numberOfMatchedIons_(const PeakSpectrum& th, const PeakSpectrum& window_reduced) const
+  {
     Size n = 0;
     for (Size i = 0; i < th.size(); ++i)
     {
@@ -390,6 +390,33 @@ namespace OpenMS
     return n;
   }
 
+  Size AScore::numberOfMatchedIons_(const PeakSpectrum& th, const vector<PeakSpectrum>& windows_reduced) const
+  {
+    Size n = 0;
+    for (vector<PeakSpectrum>::const_iterator win_it = windows_reduced.begin(); win_it != windows_reduced.end(); ++win_it) // count matched ions over all 100 Da windows
+    {
+      n += numberOfMatchedIons_(th, *win_it);
+    }
+    return n;
+  }
+
+  vector<vector<PeakSpectrum>> AScore::reduceWindows_(const vector<PeakSpectrum>& windows_top10) const
+  {
+    vector<vector<PeakSpectrum>> windows_by_depth(10, windows_top10);
+    for (Size depth = 1; depth <= 10; ++depth)
+    {
+      for (vector<PeakSpectrum>::iterator win_it = windows_by_depth[depth - 1].begin(); win_it != windows_by_depth[depth - 1].end(); ++win_it)
+      {
+        if (win_it->size() > depth)
+        {
+          win_it->resize(depth);
+        }
+        win_it->sortByPosition();
+      }
+    }
+    return windows_by_depth;
+  }
+
   double AScore::peptideScore_(const std::vector<double>& scores) const
   {
     OPENMS_PRECONDITION(scores.size() == 10, "Scores vector must contain a score for every peak level."); 
@@ -498,9 +525,36 @@ namespace OpenMS
   vector<PeakSpectrum> AScore::createTheoreticalSpectra_(const vector<vector<Size>>& permutations, const AASequence& seq_without_phospho) const
   {
     vector<PeakSpectrum> th_spectra;
-    TheoreticalSpectrumGenerator spectrum_generator;
-    
     th_spectra.resize(permutations.size());
+    if (permutations.empty())
+    {
+      return th_spectra;
+    }
+
+    // The fragment ladder of the peptide without phosphorylations is shared by all permutations:
+    // generate it only once and shift the fragments that contain phosphorylated sites.
+    // we mono-charge spectra, generating b- and y-ions is the default behavior of the TSG
+    TheoreticalSpectrumGenerator spectrum_generator;
+    TheoreticalSpectrumGenerator::FragmentIonBuffer ladder;
+    spectrum_generator.getFragmentIons(ladder, seq_without_phospho, 1, 1);
+
+    // mass shift caused by phosphorylation of each residue (zero for residues that aren't permuted)
+    const Size n = seq_without_phospho.size();
+    vector<double> phospho_shift(n, 0.0);
+    for (Size i = 0; i < permutations.size(); ++i)
+    {
+      for (vector<Size>::const_iterator site = permutations[i].begin(); site != permutations[i].end(); ++site)
+      {
+        if ((*site < n) && (phospho_shift[*site] == 0.0))
+        {
+          AASequence seq(seq_without_phospho);
+          seq.setModification(*site, "Phospho");
+          phospho_shift[*site] = seq[*site].getMonoWeight(Residue::Internal) - seq_without_phospho[*site].getMonoWeight(Residue::Internal);
+        }
+      }
+    }
+
+    vector<double> prefix_shift(n + 1); // prefix_shift[k]: mass shift of the first k residues
     for (Size i = 0; i < permutations.size(); ++i)
     {
       AASequence seq(seq_without_phospho);
@@ -520,9 +574,23 @@ namespace OpenMS
         }
       }
 
-      // we mono-charge spectra, generating b- and y-ions is the default behavior of the TSG
-      spectrum_generator.getSpectrum(th_spectra[i], seq, 1, 1);
-      th_spectra[i].setName(seq.toString());
+      prefix_shift[0] = 0.0;
+      for (Size k = 0; k < n; ++k)
+      {
+        bool phosphorylated = find(permutations[i].begin(), permutations[i].end(), k) != permutations[i].end();
+        prefix_shift[k + 1] = prefix_shift[k] + (phosphorylated ? phospho_shift[k] : 0.0);
+      }
+
+      PeakSpectrum& spectrum = th_spectra[i];
+      spectrum.reserve(ladder.ions.size());
+      for (vector<TheoreticalSpectrumGenerator::FragmentIon>::const_iterator ion = ladder.ions.begin(); ion != ladder.ions.end(); ++ion)
+      {
+        const bool prefix = (ion->ion_type == 'a') || (ion->ion_type == 'b') || (ion->ion_type == 'c');
+        const double shift = prefix ? prefix_shift[ion->ion_number] : prefix_shift[n] - prefix_shift[n - ion->ion_number];
+        spectrum.push_back(Peak1D(ion->mz + shift / ion->charge, ion->intensity));
+      }
+      spectrum.sortByPosition();
+      spectrum.setName(seq.toString());
     }
     return th_spectra;
   }
@@ -561,24 +629,25 @@ namespace OpenMS
   }
   
   std::vector<std::vector<double>> AScore::calculatePermutationPeptideScores_(vector<PeakSpectrum>& th_spectra, const vector<PeakSpectrum>& windows_top10) const
+  {
+    return calculatePermutationPeptideScores_(th_spectra, reduceWindows_(windows_top10));
+  }
+
+  std::vector<std::vector<double>> AScore::calculatePermutationPeptideScores_(const vector<PeakSpectrum>& th_spectra, const vector<vector<PeakSpectrum>>& windows_by_depth) const
   {
     //prepare peak depth for all windows in the actual spectrum
     vector<vector<double>> permutation_peptide_scores(th_spectra.size());
     vector<vector<double>>::iterator site_score = permutation_peptide_scores.begin();
     
     // for each phospho site assignment
-    for (vector<PeakSpectrum>::iterator it = th_spectra.begin(); it != th_spectra.end(); ++it, ++site_score)
+    for (vector<PeakSpectrum>::const_iterator it = th_spectra.begin(); it != th_spectra.end(); ++it, ++site_score)
     {
       // the number of theoretical peaks (all b- and y-ions) correspond to the number of trials N
       Size N = it->size();
       site_score->resize(10);
       for (Size i = 1; i <= 10; ++i)
       {
-        Size n = 0;
-        for (Size current_win = 0; current_win < windows_top10.size(); ++current_win) // count matched ions over all 100 Da windows
-        {
-          n += numberOfMatchedIons_(*it, windows_top10[current_win], i);
-        }
+        Size n = numberOfMatchedIons_(*it, windows_by_depth[i - 1]);
         double p = static_cast<double>(i) / 100.0;
         double cumulative_score = computeCumulativeScore_(N, n, p);
         
@@ -35,7 +35,7 @@
 #include <OpenMS/ANALYSIS/ID/AccurateMassSearchEngine.h>
 #include <OpenMS/CHEMISTRY/EmpiricalFormula.h>
 #include <OpenMS/CHEMISTRY/ISOTOPEDISTRIBUTION/IsotopeDistribution.h>
-#include <OpenMS/CHEMISTRY/ISOTOPEDISTRIBUTION/CoarseIsotopePatternGenerator.h>
+#include <OpenMS/CHEMISTRY/ISOTOPEDISTRIBUTION/IsotopePatternCache.h>
 #include <OpenMS/CONCEPT/Constants.h>
 #include <OpenMS/FORMAT/TextFile.h>
 #include <OpenMS/MATH/MISC/MathFunctions.h>
@@ -43,6 +43,7 @@
 #include <OpenMS/METADATA/PeptideIdentification.h>
 
 #include <numeric>
+#include <unordered_map>
 
 namespace OpenMS
 {
@@ -549,121 +550,170 @@ namespace OpenMS
 /// public methods
 
   void AccurateMassSearchEngine::queryByMZ(const double& observed_mz, const Int& observed_charge, const String& ion_mode, std::vector<AccurateMassSearchResult>& results) const
+  {
+    std::vector<MassMatch> matches;
+    queryByMZ(std::vector<double>(1, observed_mz), std::vector<Int>(1, observed_charge), ion_mode, matches);
+
+    // store information from query hits in AccurateMassSearchResult objects
+    const std::vector<AdductInfo>& adducts = getAdducts_(ion_mode);
+    for (Size i = 0; i < matches.size(); ++i)
+    {
+      results.push_back(createResult_(matches[i], observed_mz, adducts));
+    }
+
+    // if result is empty, add a 'not-found' indicator if empty hits should be stored
+    if (results.empty() && keep_unidentified_masses_)
+    {
+      results.push_back(createNotFoundResult_(observed_mz, observed_charge));
+    }
+
+    return;
+  }
+
+  void AccurateMassSearchEngine::queryByMZ(const std::vector<double>& observed_mzs, const std::vector<Int>& observed_charges, const String& ion_mode, std::vector<MassMatch>& matches) const
   {
     if (!is_initialized_)
     {
       throw Exception::IllegalArgument(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "AccurateMassSearchEngine::init() was not called!");
     }
-
-    // Depending on ion_mode_internal_, either positive or negative adducts are used
-    std::vector<AdductInfo>::const_iterator it_s, it_e;
-    if (ion_mode == "positive")
+    if (observed_mzs.size() != observed_charges.size())
     {
-      it_s = pos_adducts_.begin();
-      it_e = pos_adducts_.end();
+      throw Exception::IllegalArgument(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "Number of m/z values and charges differ!");
     }
-    else if (ion_mode == "negative")
+
+    // Depending on ion_mode_internal_, either positive or negative adducts are used
+    const std::vector<AdductInfo>& adducts = getAdducts_(ion_mode);
+
+    matches.clear();
+    if (observed_mzs.empty())
     {
-      it_s = neg_adducts_.begin();
-      it_e = neg_adducts_.end();
+      return;
     }
-    else
+    if (mass_mappings_.empty())
     {
-      throw Exception::InvalidParameter(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, String("Ion mode cannot be set to '") + ion_mode + "'. Must be 'positive' or 'negative'!");
+      throw Exception::InvalidValue(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "There are no entries found in mass-to-ids mapping file! Aborting... ", "0");
     }
 
-    std::pair<Size, Size> hit_idx;
-    for (std::vector<AdductInfo>::const_iterator it = it_s; it != it_e; ++it)
+    // sort the queries by m/z: the neutral masses (and the tolerance windows)
+    // of an adduct increase with the m/z, so the database can be merged with
+    // the queries instead of searching each of them
+    std::vector<Size> order(observed_mzs.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(), [&observed_mzs](Size a, Size b) { return observed_mzs[a] < observed_mzs[b]; });
+
+    const Size db_size = mass_mappings_.size();
+    for (Size adduct_idx = 0; adduct_idx < adducts.size(); ++adduct_idx)
     {
-      if (observed_charge != 0 && (std::abs(observed_charge) != std::abs(it->getCharge())))
-      { // charge of evidence and adduct must match in absolute terms (absolute, since any FeatureFinder gives only positive charges, even for negative-mode spectra)
-        // observed_charge==0 will pass, since we basically do not know its real charge (apparently, no isotopes were found)
-        continue;
-      }
+      const AdductInfo& adduct = adducts[adduct_idx];
+      // compatibility of database entries with the adduct (each formula is only parsed once)
+      std::unordered_map<Size, bool> compatible;
+      Size lower = 0, upper = 0; // current window [lower, upper) in the database
 
-      // get potential hits as indices in masskey_table
-      double neutral_mass = it->getNeutralMass(observed_mz); // calculate mass of uncharged small molecule without adduct mass
-
-      // Our database is just a set of neutral masses (i.e., without adducts)
-      // However, given is either an absolute m/z tolerance or a ppm tolerance for the observed m/z
-      // We now need an upper bound on the absolute allowed mass difference, given the above tolerance in m/z.
-      // The selected candidates then have an mass tolerance which corresponds to the user's m/z tolerance.
-      // (the other approach is to precompute m/z values for all combinations of adducts, charges and DB entries -- too much)
-      double diff_mz;
-      // check if mass error window is given in ppm or Da
-      if (mass_error_unit_ == "ppm")
+      for (Size q = 0; q < order.size(); ++q)
       {
-        // convert ppm to absolute m/z tolerance for the current candidate
-        diff_mz = (observed_mz / 1e6) * mass_error_value_;
-      }
-      else
-      {
-        diff_mz = mass_error_value_;
-      }
-      // convert absolute m/z diff to absolute mass diff
-      // What about the adduct?
-      // absolute mass error: the adduct itself is irrelevant here since its a constant for both the theoretical and observed mass
-      //       ppm tolerance: the diff_mz accounts for it already (heavy adducts lead to larger m/z tolerance)
-      double diff_mass = diff_mz * std::abs(it->getCharge()); // do not use observed charge (could be 0=unknown)
+        Size query = order[q];
+        double observed_mz = observed_mzs[query];
+        Int observed_charge = observed_charges[query];
+        if (observed_charge != 0 && (std::abs(observed_charge) != std::abs(adduct.getCharge())))
+        { // charge of evidence and adduct must match in absolute terms (absolute, since any FeatureFinder gives only positive charges, even for negative-mode spectra)
+          // observed_charge==0 will pass, since we basically do not know its real charge (apparently, no isotopes were found)
+          continue;
+        }
 
-      searchMass_(neutral_mass, diff_mass, hit_idx);
+        // calculate mass of uncharged small molecule without adduct mass
+        double neutral_mass = adduct.getNeutralMass(observed_mz);
 
-      //std::cerr << ion_mode_internal_ << " adduct: " << adduct_name << ", " << adduct_mass << " Da, " << query_mass << " qm(against DB), " << charge << " q\n";
+        // The m/z tolerance is converted into a tolerance of the neutral mass:
+        // absolute mass error: the adduct itself is irrelevant here since its a constant for both the theoretical and observed mass
+        //       ppm tolerance: the diff_mz accounts for it already (heavy adducts lead to larger m/z tolerance)
+        double diff_mz = (mass_error_unit_ == "ppm") ? (observed_mz / 1e6) * mass_error_value_ : mass_error_value_;
+        double diff_mass = diff_mz * std::abs(adduct.getCharge()); // do not use observed charge (could be 0=unknown)
+        double min_mass = neutral_mass - diff_mass, max_mass = neutral_mass + diff_mass;
 
-      // store information from query hits in AccurateMassSearchResult objects
-      for (Size i = hit_idx.first; i < hit_idx.second; ++i)
-      {
-        // check if DB entry is compatible to the adduct
-        if (!it->isCompatible(EmpiricalFormula(mass_mappings_[i].formula)))
+        // move the window (usually only forward, but be safe):
+        while (lower > 0 && mass_mappings_[lower - 1].mass >= min_mass) --lower;
+        while (lower < db_size && mass_mappings_[lower].mass < min_mass) ++lower;
+        upper = std::max(upper, lower);
+        while (upper > lower && mass_mappings_[upper - 1].mass > max_mass) --upper;
+        while (upper < db_size && mass_mappings_[upper].mass <= max_mass) ++upper;
+
+        for (Size i = lower; i < upper; ++i)
         {
-          // only written if TOPP tool has --debug
-          LOG_DEBUG << "'" << mass_mappings_[i].formula << "' cannot have adduct '" << it->getName() << "'. Omitting.\n";
-          continue;
+          // check if DB entry is compatible to the adduct
+          std::unordered_map<Size, bool>::iterator comp_it = compatible.find(i);
+          if (comp_it == compatible.end())
+          {
+            comp_it = compatible.insert(std::make_pair(i, adduct.isCompatible(EmpiricalFormula(mass_mappings_[i].formula)))).first;
+            if (!comp_it->second)
+            {
+              // only written if TOPP tool has --debug
+              LOG_DEBUG << "'" << mass_mappings_[i].formula << "' cannot have adduct '" << adduct.getName() << "'. Omitting.\n";
+            }
+          }
+          if (!comp_it->second) continue;
+
+          MassMatch match;
+          match.query = query;
+          match.adduct = adduct_idx;
+          match.db_entry = i;
+          match.query_mass = neutral_mass;
+          match.calculated_mz = adduct.getMZ(mass_mappings_[i].mass);
+          match.mz_error_ppm = Math::getPPM(observed_mz, match.calculated_mz); // negative values are allowed!
+          matches.push_back(match);
         }
-
-        // compute ppm errors
-        double db_mass = mass_mappings_[i].mass;
-        double theoretical_mz = it->getMZ(db_mass);
-        double error_ppm_mz = Math::getPPM(observed_mz, theoretical_mz); // negative values are allowed!
-
-        AccurateMassSearchResult ams_result;
-        ams_result.setObservedMZ(observed_mz);
-        ams_result.setCalculatedMZ(theoretical_mz);
-        ams_result.setQueryMass(neutral_mass);
-        ams_result.setFoundMass(db_mass);
-        ams_result.setCharge(std::abs(it->getCharge())); // use theoretical adducts charge (is always valid); native charge might be zero
-        ams_result.setMZErrorPPM(error_ppm_mz);
-        ams_result.setMatchingIndex(i);
-        ams_result.setFoundAdduct(it->getName());
-        ams_result.setEmpiricalFormula(mass_mappings_[i].formula);
-        ams_result.setMatchingHMDBids(mass_mappings_[i].massIDs);
-
-        results.push_back(ams_result);
-
-        // ams_result.outputResults();
-        // std::cout << "****************************************************" << std::endl;
       }
-
     }
 
-    // if result is empty, add a 'not-found' indicator if empty hits should be stored
-    if (results.empty() && keep_unidentified_masses_)
+    // group by query; within a query, matches stay ordered by adduct and database entry
+    std::stable_sort(matches.begin(), matches.end(), [](const MassMatch& a, const MassMatch& b) { return a.query < b.query; });
+  }
+
+  const std::vector<AdductInfo>& AccurateMassSearchEngine::getAdducts_(const String& ion_mode) const
+  {
+    if (ion_mode == "positive")
+    {
+      return pos_adducts_;
+    }
+    else if (ion_mode == "negative")
     {
-      AccurateMassSearchResult ams_result;
-      ams_result.setObservedMZ(observed_mz);
-      ams_result.setCalculatedMZ(std::numeric_limits<double>::quiet_NaN());
-      ams_result.setQueryMass(std::numeric_limits<double>::quiet_NaN());
-      ams_result.setFoundMass(std::numeric_limits<double>::quiet_NaN());
-      ams_result.setCharge(observed_charge);
-      ams_result.setMZErrorPPM(std::numeric_limits<double>::quiet_NaN());
-      ams_result.setMatchingIndex(-1); // this is checked to identify 'not-found'
-      ams_result.setFoundAdduct("null");
-      ams_result.setEmpiricalFormula("");
-      ams_result.setMatchingHMDBids(std::vector<String>(1, "null"));
-      results.push_back(ams_result);
+      return neg_adducts_;
     }
+    throw Exception::InvalidParameter(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, String("Ion mode cannot be set to '") + ion_mode + "'. Must be 'positive' or 'negative'!");
+  }
 
-    return;
+  AccurateMassSearchResult AccurateMassSearchEngine::createResult_(const MassMatch& match, double observed_mz, const std::vector<AdductInfo>& adducts) const
+  {
+    const MappingEntry_& entry = mass_mappings_[match.db_entry];
+    const AdductInfo& adduct = adducts[match.adduct];
+
+    AccurateMassSearchResult ams_result;
+    ams_result.setObservedMZ(observed_mz);
+    ams_result.setCalculatedMZ(match.calculated_mz);
+    ams_result.setQueryMass(match.query_mass);
+    ams_result.setFoundMass(entry.mass);
+    ams_result.setCharge(std::abs(adduct.getCharge())); // use theoretical adducts charge (is always valid); native charge might be zero
+    ams_result.setMZErrorPPM(match.mz_error_ppm);
+    ams_result.setMatchingIndex(match.db_entry);
+    ams_result.setFoundAdduct(adduct.getName());
+    ams_result.setEmpiricalFormula(entry.formula);
+    ams_result.setMatchingHMDBids(entry.massIDs);
+    return ams_result;
+  }
+
+  AccurateMassSearchResult AccurateMassSearchEngine::createNotFoundResult_(double observed_mz, Int observed_charge) const
+  {
+    AccurateMassSearchResult ams_result;
+    ams_result.setObservedMZ(observed_mz);
+    ams_result.setCalculatedMZ(std::numeric_limits<double>::quiet_NaN());
+    ams_result.setQueryMass(std::numeric_limits<double>::quiet_NaN());
+    ams_result.setFoundMass(std::numeric_limits<double>::quiet_NaN());
+    ams_result.setCharge(observed_charge);
+    ams_result.setMZErrorPPM(std::numeric_limits<double>::quiet_NaN());
+    ams_result.setMatchingIndex(-1); // this is checked to identify 'not-found'
+    ams_result.setFoundAdduct("null");
+    ams_result.setEmpiricalFormula("");
+    ams_result.setMatchingHMDBids(std::vector<String>(1, "null"));
+    return ams_result;
   }
 
   void AccurateMassSearchEngine::queryByFeature(const Feature& feature, const Size& feature_index, const String& ion_mode, std::vector<AccurateMassSearchResult>& results) const
@@ -676,27 +726,31 @@ namespace OpenMS
     std::vector<AccurateMassSearchResult> results_part;
 
     queryByMZ(feature.getMZ(), feature.getCharge(), ion_mode, results_part);
+    addFeatureInfo_(feature, feature_index, results_part);
+
+    // append
+    results.insert(results.end(), results_part.begin(), results_part.end());
+  }
 
+  void AccurateMassSearchEngine::addFeatureInfo_(const Feature& feature, Size feature_index, std::vector<AccurateMassSearchResult>& results) const
+  {
     Size isotope_export = (Size)param_.getValue("mzTab:exportIsotopeIntensities");
 
-    for (Size hit_idx = 0; hit_idx < results_part.size(); ++hit_idx)
+    std::vector<double> mti;
+    if (isotope_export > 0 && feature.metaValueExists("masstrace_intensity"))
     {
-      results_part[hit_idx].setObservedRT(feature.getRT());
-      results_part[hit_idx].setSourceFeatureIndex(feature_index);
-      results_part[hit_idx].setObservedIntensity(feature.getIntensity());
-      
-      std::vector<double> mti;
+      mti = feature.getMetaValue("masstrace_intensity");
+    }
+
+    for (Size hit_idx = 0; hit_idx < results.size(); ++hit_idx)
+    {
+      results[hit_idx].setObservedRT(feature.getRT());
+      results[hit_idx].setSourceFeatureIndex(feature_index);
+      results[hit_idx].setObservedIntensity(feature.getIntensity());
       if (isotope_export > 0)
       {
-          if (feature.metaValueExists("masstrace_intensity"))
-          {
-            mti = feature.getMetaValue("masstrace_intensity");
-          }
-        results_part[hit_idx].setMasstraceIntensities(mti);
+        results[hit_idx].setMasstraceIntensities(mti);
       }
-      
-      // append
-      results.push_back(results_part[hit_idx]);
     }
   }
 
@@ -709,10 +763,14 @@ namespace OpenMS
     results.clear();
     // get hits
     queryByMZ(cfeat.getMZ(), cfeat.getCharge(), ion_mode, results);
+    addConsensusFeatureInfo_(cfeat, cf_index, number_of_maps, results);
+  }
 
+  void AccurateMassSearchEngine::addConsensusFeatureInfo_(const ConsensusFeature& cfeat, Size cf_index, Size number_of_maps, std::vector<AccurateMassSearchResult>& results) const
+  {
     // collect meta data:
     // intensities for all maps as given in handles; 0 if no handle is present for a map
-    ConsensusFeature::HandleSetType ind_feats(cfeat.getFeatures()); // sorted by MapIndices
+    const ConsensusFeature::HandleSetType& ind_feats(cfeat.getFeatures()); // sorted by MapIndices
     ConsensusFeature::const_iterator f_it = ind_feats.begin();
     std::vector<double> tmp_f_ints;
     for (Size map_idx = 0; map_idx < number_of_maps; ++map_idx)
@@ -764,15 +822,36 @@ namespace OpenMS
       ion_mode_internal = resolveAutoMode_(fmap);
     }
 
+    // search all features at once
+    std::vector<double> observed_mzs(fmap.size());
+    std::vector<Int> observed_charges(fmap.size());
+    for (Size i = 0; i < fmap.size(); ++i)
+    {
+      observed_mzs[i] = fmap[i].getMZ();
+      observed_charges[i] = fmap[i].getCharge();
+    }
+    std::vector<MassMatch> matches;
+    queryByMZ(observed_mzs, observed_charges, ion_mode_internal, matches);
+    const std::vector<AdductInfo>& adducts = getAdducts_(ion_mode_internal);
+
     // map for storing overall results
     QueryResultsTable overall_results;
     Size dummy_count(0);
+    std::vector<MassMatch>::const_iterator match_it = matches.begin();
     for (Size i = 0; i < fmap.size(); ++i)
     {
       std::vector<AccurateMassSearchResult> query_results;
 
       // std::cout << i << ": " << fmap[i].getMetaValue(3) << " mass: " << fmap[i].getMZ() << " num_traces: " << fmap[i].getMetaValue("num_of_masstraces") << " charge: " << fmap[i].getCharge() << std::endl;
-      queryByFeature(fmap[i], i, ion_mode_internal, query_results);
+      for (; match_it != matches.end() && match_it->query == i; ++match_it)
+      {
+        query_results.push_back(createResult_(*match_it, observed_mzs[i], adducts));
+      }
+      if (query_results.empty() && keep_unidentified_masses_)
+      {
+        query_results.push_back(createNotFoundResult_(observed_mzs[i], observed_charges[i]));
+      }
+      addFeatureInfo_(fmap[i], i, query_results);
 
       if (query_results.size() == 0) continue; // cannot happen if a 'not-found' dummy was added
 
@@ -878,14 +957,35 @@ namespace OpenMS
     ConsensusMap::ColumnHeaders fd_map = cmap.getColumnHeaders();
     Size num_of_maps = fd_map.size();
 
+    // search all consensus features at once
+    std::vector<double> observed_mzs(cmap.size());
+    std::vector<Int> observed_charges(cmap.size());
+    for (Size i = 0; i < cmap.size(); ++i)
+    {
+      observed_mzs[i] = cmap[i].getMZ();
+      observed_charges[i] = cmap[i].getCharge();
+    }
+    std::vector<MassMatch> matches;
+    queryByMZ(observed_mzs, observed_charges, ion_mode_internal, matches);
+    const std::vector<AdductInfo>& adducts = getAdducts_(ion_mode_internal);
+
     // map for storing overall results
     QueryResultsTable overall_results;
 
+    std::vector<MassMatch>::const_iterator match_it = matches.begin();
     for (Size i = 0; i < cmap.size(); ++i)
     {
       std::vector<AccurateMassSearchResult> query_results;
       // std::cout << i << ": " << cmap[i].getMetaValue(3) << " mass: " << cmap[i].getMZ() << " num_traces: " << cmap[i].getMetaValue("num_of_masstraces") << " charge: " << cmap[i].getCharge() << std::endl;
-      queryByConsensusFeature(cmap[i], i, num_of_maps, ion_mode_internal, query_results);
+      for (; match_it != matches.end() && match_it->query == i; ++match_it)
+      {
+        query_results.push_back(createResult_(*match_it, observed_mzs[i], adducts));
+      }
+      if (query_results.empty() && keep_unidentified_masses_)
+      {
+        query_results.push_back(createNotFoundResult_(observed_mzs[i], observed_charges[i]));
+      }
+      addConsensusFeatureInfo_(cmap[i], i, num_of_maps, query_results);
       annotate_(query_results, cmap[i]);
       overall_results.push_back(query_results);
     }
@@ -1492,18 +1592,10 @@ namespace OpenMS
 
     Size common_size = std::min(num_traces, MAX_THEORET_ISOS);
 
-    // compute theoretical isotope distribution
-    IsotopeDistribution iso_dist(form.getIsotopeDistribution(CoarseIsotopePatternGenerator((UInt)common_size)));
-    std::vector<double> theoretical_iso_dist;
-    std::transform(
-      iso_dist.begin(),
-      iso_dist.end(),
-      back_inserter(theoretical_iso_dist),
-      [](const IsotopeDistribution::MassAbundance& p)
-      {
-        return p.getIntensity();
-      });
-    
+    // theoretical isotope distribution (from the shared cache, normalized to
+    // a maximum of 1, which does not change the cosine similarity)
+    const std::vector<double>& theoretical_iso_dist = IsotopePatternCache::getInstance()->getFormulaIntensities(form, common_size);
+
     // same for observed isotope distribution
     std::vector<double> observed_iso_dist;
     if (num_traces > 0)
@@ -37,6 +37,10 @@
 #include <OpenMS/CONCEPT/Macros.h> // for "OPENMS_PRECONDITION"
 #include <OpenMS/FILTERING/ID/IDFilter.h>
 
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
 using namespace std;
 
 // #define DEBUG_ID_CONSENSUS
@@ -82,8 +86,51 @@ namespace OpenMS
       return;
     }
 
-    number_of_runs_ = (number_of_runs != 0) ? number_of_runs : ids.size();
+    prepareIDs_(ids);
+    computeConsensus_(ids, number_of_runs);
+  }
 
+
+  void ConsensusIDAlgorithm::apply(vector<vector<PeptideIdentification>*>&
+                                   id_sets,
+                                   const vector<Size>& number_of_runs)
+  {
+    if (!number_of_runs.empty() && (number_of_runs.size() != id_sets.size()))
+    {
+      String msg = "Number of ID runs must be given for each set of peptide "
+        "identifications (or not at all)";
+      throw Exception::IllegalArgument(__FILE__, __LINE__,
+                                       OPENMS_PRETTY_FUNCTION, msg);
+    }
+
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic, 100)
+#endif
+    for (SignedSize i = 0; i < SignedSize(id_sets.size()); ++i)
+    {
+      if (!id_sets[i]->empty()) prepareIDs_(*id_sets[i]);
+    }
+
+    precompute_(id_sets);
+
+    for (Size i = 0; i < id_sets.size(); ++i)
+    {
+      if (id_sets[i]->empty()) continue;
+      computeConsensus_(*id_sets[i],
+                        number_of_runs.empty() ? 0 : number_of_runs[i]);
+    }
+  }
+
+
+  void ConsensusIDAlgorithm::precompute_(
+    const vector<vector<PeptideIdentification>*>& /* id_sets */)
+  {
+  }
+
+
+  void ConsensusIDAlgorithm::prepareIDs_(vector<PeptideIdentification>& ids)
+    const
+  {
     // prepare data here, so that it doesn't have to happen in each algorithm:
     for (vector<PeptideIdentification>::iterator pep_it = ids.begin(); 
          pep_it != ids.end(); ++pep_it)
@@ -97,6 +144,13 @@ namespace OpenMS
     }
     // make sure there are no duplicated hits (by sequence):
     IDFilter::removeDuplicatePeptideHits(ids, true);
+  }
+
+
+  void ConsensusIDAlgorithm::computeConsensus_(
+    vector<PeptideIdentification>& ids, Size number_of_runs)
+  {
+    number_of_runs_ = (number_of_runs != 0) ? number_of_runs : ids.size();
 
     SequenceGrouping results;
     apply_(ids, results); // actual (subclass-specific) processing
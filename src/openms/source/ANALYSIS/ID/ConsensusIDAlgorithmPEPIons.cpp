@@ -73,8 +73,9 @@ namespace OpenMS
     // order of sequences matters for cache look-up:
     if (seq2 < seq1) std::swap(seq1, seq2); // "operator>" not defined
     pair<AASequence, AASequence> seq_pair = make_pair(seq1, seq2);
-    SimilarityCache::iterator pos = similarities_.find(seq_pair);
-    if (pos != similarities_.end()) return pos->second; // score found in cache
+    double score_sim = 0.0;
+    // score found in cache?
+    if (getCachedSimilarity_(seq_pair, score_sim)) return score_sim;
 
     // compare b and y ion series of seq. 1 and seq. 2:
     vector<double> ions1(2 * seq1.size()), ions2(2 * seq2.size());
@@ -134,12 +135,11 @@ namespace OpenMS
       start = lower; // "*it1" is increasing, so lower bounds can't get lower
     }
 
-    double score_sim = 0.0;
     if (matches.size() >= min_shared_)
     {
       score_sim = matches.size() / float(min(ions1.size(), ions2.size()));
     }
-    similarities_[seq_pair] = score_sim; // cache the similarity score
+    cacheSimilarity_(seq_pair, score_sim); // cache the similarity score
 
     return score_sim;
   }
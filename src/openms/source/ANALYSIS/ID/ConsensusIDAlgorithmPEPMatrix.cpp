@@ -48,8 +48,6 @@ namespace OpenMS
     defaults_.setMinInt("penalty", 1);
 
     defaultsToParam_();
-
-    ::seqan::resize(rows(alignment_), 2);
   }
 
 
@@ -95,24 +93,28 @@ namespace OpenMS
     seq1 = AASequence::fromString(unmod_seq1);
     seq2 = AASequence::fromString(unmod_seq2);
     pair<AASequence, AASequence> seq_pair = make_pair(seq1, seq2);
-    SimilarityCache::iterator pos = similarities_.find(seq_pair);
-    if (pos != similarities_.end()) return pos->second; // score found in cache
+    double cached_sim;
+    // score found in cache?
+    if (getCachedSimilarity_(seq_pair, cached_sim)) return cached_sim;
     
-    // use SeqAn similarity scoring:
+    // use SeqAn similarity scoring (with a local alignment data structure, as
+    // this may be called from several threads):
+    ::seqan::Align<SeqAnSequence, ::seqan::ArrayGaps> alignment;
+    ::seqan::resize(rows(alignment), 2);
     SeqAnSequence seqan_seq1 = unmod_seq1.c_str();
     SeqAnSequence seqan_seq2 = unmod_seq2.c_str();
     // seq. 1 against itself:
-    ::seqan::assignSource(row(alignment_, 0), seqan_seq1);
-    ::seqan::assignSource(row(alignment_, 1), seqan_seq1);
-    double score_self1 = globalAlignment(alignment_, scoring_method_,
+    ::seqan::assignSource(row(alignment, 0), seqan_seq1);
+    ::seqan::assignSource(row(alignment, 1), seqan_seq1);
+    double score_self1 = globalAlignment(alignment, scoring_method_,
                                          ::seqan::NeedlemanWunsch());
     // seq. 1 against seq. 2:
-    ::seqan::assignSource(row(alignment_, 1), seqan_seq2);
-    double score_sim = globalAlignment(alignment_, scoring_method_, 
+    ::seqan::assignSource(row(alignment, 1), seqan_seq2);
+    double score_sim = globalAlignment(alignment, scoring_method_, 
                                        ::seqan::NeedlemanWunsch());
     // seq. 2 against itself:
-    ::seqan::assignSource(row(alignment_, 0), seqan_seq2);
-    double score_self2 = globalAlignment(alignment_, scoring_method_,
+    ::seqan::assignSource(row(alignment, 0), seqan_seq2);
+    double score_self2 = globalAlignment(alignment, scoring_method_,
                                          ::seqan::NeedlemanWunsch());
     if (score_sim < 0)
     {
@@ -122,7 +124,7 @@ namespace OpenMS
     {
       score_sim /= min(score_self1, score_self2); // normalize
     }
-    similarities_[seq_pair] = score_sim; // cache the similarity score
+    cacheSimilarity_(seq_pair, score_sim); // cache the similarity score
 
     return score_sim;
   }
@@ -35,6 +35,12 @@
 #include <OpenMS/ANALYSIS/ID/ConsensusIDAlgorithmSimilarity.h>
 #include <OpenMS/CONCEPT/LogStream.h>
 
+#include <set>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
 using namespace std;
 
 namespace OpenMS
@@ -130,4 +136,90 @@ namespace OpenMS
     }
   }
 
+
+  void ConsensusIDAlgorithmSimilarity::precompute_(
+    const vector<vector<PeptideIdentification>*>& id_sets)
+  {
+    // collect the distinct pairs of sequences from different ID runs that
+    // "apply_" will compare (the same sequences recur in many spectra):
+    set<pair<String, String> > seen;
+    vector<pair<const AASequence*, const AASequence*> > seq_pairs;
+    for (vector<vector<PeptideIdentification>*>::const_iterator set_it =
+           id_sets.begin(); set_it != id_sets.end(); ++set_it)
+    {
+      const vector<PeptideIdentification>& ids = **set_it;
+      vector<vector<String> > sequences(ids.size());
+      for (Size i = 0; i < ids.size(); ++i)
+      {
+        for (vector<PeptideHit>::const_iterator hit_it =
+               ids[i].getHits().begin(); hit_it != ids[i].getHits().end();
+             ++hit_it)
+        {
+          sequences[i].push_back(hit_it->getSequence().toString());
+        }
+      }
+      for (Size i = 0; i < ids.size(); ++i)
+      {
+        for (Size j = i + 1; j < ids.size(); ++j)
+        {
+          for (Size k = 0; k < sequences[i].size(); ++k)
+          {
+            for (Size l = 0; l < sequences[j].size(); ++l)
+            {
+              const String& seq1 = sequences[i][k];
+              const String& seq2 = sequences[j][l];
+              if (seq1 == seq2) continue; // trivial, not cached
+              pair<String, String> key = (seq1 < seq2) ?
+                make_pair(seq1, seq2) : make_pair(seq2, seq1);
+              if (seen.insert(key).second)
+              {
+                seq_pairs.push_back(make_pair(
+                  &ids[i].getHits()[k].getSequence(),
+                  &ids[j].getHits()[l].getSequence()));
+              }
+            }
+          }
+        }
+      }
+    }
+
+    // compute the similarities, which are stored in the cache:
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic, 100)
+#endif
+    for (SignedSize i = 0; i < SignedSize(seq_pairs.size()); ++i)
+    {
+      getSimilarity_(*seq_pairs[i].first, *seq_pairs[i].second);
+    }
+  }
+
+
+  bool ConsensusIDAlgorithmSimilarity::getCachedSimilarity_(
+    const pair<AASequence, AASequence>& seq_pair, double& similarity) const
+  {
+    bool found = false;
+#ifdef _OPENMP
+#pragma omp critical (ConsensusIDAlgorithmSimilarity_cache)
+#endif
+    {
+      SimilarityCache::const_iterator pos = similarities_.find(seq_pair);
+      if (pos != similarities_.end())
+      {
+        similarity = pos->second;
+        found = true;
+      }
+    }
+    return found;
+  }
+
+
+  void ConsensusIDAlgorithmSimilarity::cacheSimilarity_(
+    const pair<AASequence, AASequence>& seq_pair, double similarity)
+  {
+#ifdef _OPENMP
+#pragma omp critical (ConsensusIDAlgorithmSimilarity_cache)
+#endif
+    similarities_[seq_pair] = similarity;
+  }
+
 } // namespace OpenMS
@@ -32,9 +32,18 @@
 // $Authors: Andreas Bertsch, Chris Bielow $
 // --------------------------------------------------------------------------
 
+
 #include <OpenMS/ANALYSIS/ID/FalseDiscoveryRate.h>
 #include <OpenMS/CONCEPT/LogStream.h>
 
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
 // #define FALSE_DISCOVERY_RATE_DEBUG
 // #undef  FALSE_DISCOVERY_RATE_DEBUG
 
@@ -42,6 +51,54 @@ using namespace std;
 
 namespace OpenMS
 {
+  namespace
+  {
+    /// sorts the range with one thread per chunk, followed by pairwise merges of the chunks
+    template <typename Iterator, typename Compare>
+    void parallelSort(Iterator first, Iterator last, Compare comp)
+    {
+      const SignedSize n = last - first;
+#ifdef _OPENMP
+      const SignedSize chunks = omp_get_max_threads();
+      if (chunks > 1 && n >= 10000)
+      {
+        vector<Iterator> bounds(chunks + 1);
+        for (SignedSize i = 0; i <= chunks; ++i)
+        {
+          bounds[i] = first + n * i / chunks;
+        }
+#pragma omp parallel for
+        for (SignedSize i = 0; i < chunks; ++i)
+        {
+          std::sort(bounds[i], bounds[i + 1], comp);
+        }
+        for (SignedSize width = 1; width < chunks; width *= 2)
+        {
+#pragma omp parallel for
+          for (SignedSize i = 0; i < chunks - width; i += 2 * width)
+          {
+            std::inplace_merge(bounds[i], bounds[i + width], bounds[std::min(i + 2 * width, chunks)], comp);
+          }
+        }
+        return;
+      }
+#endif
+      (void)n;
+      std::sort(first, last, comp);
+    }
+
+    /// looks up the q-value/FDR of a score (zero for scores not in @p score_to_fdr, which needs to be sorted)
+    double lookupFDR(const vector<pair<double, double> >& score_to_fdr, double score)
+    {
+      vector<pair<double, double> >::const_iterator pos = lower_bound(score_to_fdr.begin(), score_to_fdr.end(), make_pair(score, -numeric_limits<double>::max()));
+      if (pos != score_to_fdr.end() && pos->first == score)
+      {
+        return pos->second;
+      }
+      return 0.0;
+    }
+  }
+
   FalseDiscoveryRate::FalseDiscoveryRate() :
     DefaultParamHandler("FalseDiscoveryRate")
   {
@@ -132,8 +189,11 @@ namespace OpenMS
 #ifdef FALSE_DISCOVERY_RATE_DEBUG
         cerr << "Id-run: " << *iit << endl;
 #endif
-        // get the scores of all peptide hits
-        vector<double> target_scores, decoy_scores;
+        // collect the scores and target/decoy labels of all peptide hits as
+        // columns, the results are written back in the same order below
+        vector<double> scores;
+        vector<bool> is_decoy;
+        Size n_targets(0), n_unlabeled(0);
         for (auto it = ids.begin(); it != ids.end(); ++it)
         {
           // if runs should be treated separately, the identifiers must be the same
@@ -158,31 +218,33 @@ namespace OpenMS
             String target_decoy(it->getHits()[i].getMetaValue("target_decoy"));
             if (target_decoy == "target" || target_decoy == "target+decoy")
             {
-              target_scores.push_back(it->getHits()[i].getScore());
+              scores.push_back(it->getHits()[i].getScore());
+              is_decoy.push_back(false);
+              ++n_targets;
+            }
+            else if (target_decoy == "decoy")
+            {
+              scores.push_back(it->getHits()[i].getScore());
+              is_decoy.push_back(true);
+            }
+            else if (target_decoy != "")
+            {
+              throw Exception::InvalidValue(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "Unknown value of meta value 'target_decoy'", target_decoy);
             }
             else
             {
-              if (target_decoy == "decoy")
-              {
-                decoy_scores.push_back(it->getHits()[i].getScore());
-              }
-              else
-              {
-                if (target_decoy != "")
-                {
-                  throw Exception::InvalidValue(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "Unknown value of meta value 'target_decoy'", target_decoy);
-                }
-              }
+              ++n_unlabeled;
             }
           }
         }
+        Size n_decoys = scores.size() - n_targets;
 
 #ifdef FALSE_DISCOVERY_RATE_DEBUG
-        cerr << "#target-scores=" << target_scores.size() << ", #decoy-scores=" << decoy_scores.size() << endl;
+        cerr << "#target-scores=" << n_targets << ", #decoy-scores=" << n_decoys << endl;
 #endif
 
         // check decoy scores
-        if (decoy_scores.empty())
+        if (n_decoys == 0)
         {
           String error_string = "FalseDiscoveryRate: #decoy sequences is zero! Setting all target sequences to q-value/FDR 0! ";
           if (split_charge_variants || treat_runs_separately)
@@ -202,7 +264,7 @@ namespace OpenMS
         }
 
         // check target scores
-        if (target_scores.empty())
+        if (n_targets == 0)
         {
           String error_string = "FalseDiscoveryRate: #target sequences is zero! Ignoring. ";
           if (split_charge_variants || treat_runs_separately)
@@ -221,59 +283,29 @@ namespace OpenMS
           LOG_ERROR << error_string << std::endl;
         }
 
-        if (target_scores.empty() || decoy_scores.empty())
+        // without targets or decoys, remove the decoys and set the
+        // targets to 0; otherwise calculate the fdr for all scores
+        bool pseudo_scores = (n_targets == 0 || n_decoys == 0);
+        vector<double> fdrs;
+        vector<pair<double, double> > score_to_fdr;
+        if (!pseudo_scores)
         {
-          // no remove the the relevant entries, or put 'pseudo-scores' in
-          for (auto it = ids.begin(); it != ids.end(); ++it)
+          calculateFDRs(scores, is_decoy, higher_score_better, q_value, fdrs);
+
+          // hits without target/decoy label get the value of an identical score (if any)
+          if (n_unlabeled > 0)
           {
-            // if runs should be treated separately, the identifiers must be the same
-            if (treat_runs_separately && it->getIdentifier() != *iit)
+            score_to_fdr.reserve(scores.size());
+            for (Size i = 0; i < scores.size(); ++i)
             {
-              continue;
+              score_to_fdr.push_back(make_pair(scores[i], fdrs[i]));
             }
-
-            vector<PeptideHit> hits(it->getHits()), new_hits;
-            for (Size i = 0; i < hits.size(); ++i)
-            {
-              if (split_charge_variants && hits[i].getCharge() != *zit)
-              {
-                new_hits.push_back(hits[i]);
-                continue;
-              }
-
-              if (!hits[i].metaValueExists("target_decoy"))
-              {
-                LOG_FATAL_ERROR << "Meta value 'target_decoy' does not exists, reindex the idXML file with 'PeptideIndexer' (run-id='" << it->getIdentifier() << ", rank=" << i + 1 << " of " << hits.size() << ")!" << endl;
-                throw Exception::MissingInformation(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "Meta value 'target_decoy' does not exist!");
-              }
-
-              String target_decoy(hits[i].getMetaValue("target_decoy"));
-              if (target_decoy == "target" || target_decoy == "target+decoy")
-              {
-                // if it is a target hit, there are now decoys, fdr/q-value should be zero then
-                new_hits.push_back(hits[i]);
-                String score_type = it->getScoreType() + "_score";
-                new_hits.back().setMetaValue(score_type, new_hits.back().getScore());
-                new_hits.back().setScore(0);
-              }
-              else
-              {
-                if (target_decoy != "decoy")
-                {
-                  throw Exception::InvalidValue(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "Unknown value of meta value 'target_decoy'", target_decoy);
-                }
-              }
-            }
-            it->setHits(new_hits);
+            sort(score_to_fdr.begin(), score_to_fdr.end());
           }
-          continue;
         }
 
-        // calculate fdr for the forward scores
-        Map<double, double> score_to_fdr;
-        calculateFDRs_(score_to_fdr, target_scores, decoy_scores, q_value, higher_score_better);
-
-        // annotate fdr
+        // annotate fdr (in place, removing decoys if necessary)
+        Size index = 0;
         for (auto it = ids.begin(); it != ids.end(); ++it)
         {
           // if runs should be treated separately, the identifiers must be the same
@@ -283,29 +315,49 @@ namespace OpenMS
           }
 
           String score_type = it->getScoreType() + "_score";
-          vector<PeptideHit> hits;
-          for (vector<PeptideHit>::const_iterator pit = it->getHits().begin(); pit != it->getHits().end(); ++pit)
+          vector<PeptideHit>& hits = it->getHits();
+          Size kept = 0;
+          for (Size i = 0; i < hits.size(); ++i)
           {
-            PeptideHit hit = *pit;
-
-            if (split_charge_variants && pit->getCharge() != *zit)
+            if (!split_charge_variants || hits[i].getCharge() == *zit)
             {
-              hits.push_back(*pit);
-              continue;
-            }
-            if (hit.metaValueExists("target_decoy"))
-            {
-              String meta_value = (String)hit.getMetaValue("target_decoy");
-              if (meta_value == "decoy" && !add_decoy_peptides)
+              String target_decoy(hits[i].getMetaValue("target_decoy"));
+              bool decoy = (target_decoy == "decoy");
+              double fdr(0);
+              if (pseudo_scores)
+              {
+                if (target_decoy == "")
+                {
+                  throw Exception::InvalidValue(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "Unknown value of meta value 'target_decoy'", target_decoy);
+                }
+                // if it is a target hit, there are no decoys, fdr/q-value should be zero then
+                if (decoy)
+                {
+                  continue;
+                }
+              }
+              else if (target_decoy == "")
               {
-                continue;
+                fdr = lookupFDR(score_to_fdr, hits[i].getScore());
               }
+              else
+              {
+                fdr = fdrs[index++];
+                if (decoy && !add_decoy_peptides)
+                {
+                  continue;
+                }
+              }
+              hits[i].setMetaValue(score_type, hits[i].getScore());
+              hits[i].setScore(fdr);
             }
-            hit.setMetaValue(score_type, pit->getScore());
-            hit.setScore(score_to_fdr[pit->getScore()]);
-            hits.push_back(hit);
+            if (kept != i)
+            {
+              hits[kept] = std::move(hits[i]);
+            }
+            ++kept;
           }
-          it->getHits().swap(hits);
+          hits.resize(kept);
         }
       }
       if (!split_charge_variants)
@@ -344,13 +396,15 @@ namespace OpenMS
     {
       return;
     }
-    vector<double> target_scores, decoy_scores;
+    vector<double> scores;
+    vector<bool> is_decoy;
     // get the scores of all peptide hits
     for (vector<PeptideIdentification>::const_iterator it = fwd_ids.begin(); it != fwd_ids.end(); ++it)
     {
       for (vector<PeptideHit>::const_iterator pit = it->getHits().begin(); pit != it->getHits().end(); ++pit)
       {
-        target_scores.push_back(pit->getScore());
+        scores.push_back(pit->getScore());
+        is_decoy.push_back(false);
       }
     }
 
@@ -358,7 +412,8 @@ namespace OpenMS
     {
       for (vector<PeptideHit>::const_iterator pit = it->getHits().begin(); pit != it->getHits().end(); ++pit)
       {
-        decoy_scores.push_back(pit->getScore());
+        scores.push_back(pit->getScore());
+        is_decoy.push_back(true);
       }
     }
 
@@ -366,10 +421,11 @@ namespace OpenMS
     bool higher_score_better = fwd_ids.begin()->isHigherScoreBetter();
     bool add_decoy_peptides = param_.getValue("add_decoy_peptides").toBool();
     // calculate fdr for the forward scores
-    Map<double, double> score_to_fdr;
-    calculateFDRs_(score_to_fdr, target_scores, decoy_scores, q_value, higher_score_better);
+    vector<double> fdrs;
+    calculateFDRs(scores, is_decoy, higher_score_better, q_value, fdrs);
 
     // annotate fdr
+    Size index = 0;
     String score_type = fwd_ids.begin()->getScoreType() + "_score";
     for (vector<PeptideIdentification>::iterator it = fwd_ids.begin(); it != fwd_ids.end(); ++it)
     {
@@ -383,16 +439,14 @@ namespace OpenMS
       }
 
       it->setHigherScoreBetter(false);
-      vector<PeptideHit> hits = it->getHits();
-      for (vector<PeptideHit>::iterator pit = hits.begin(); pit != hits.end(); ++pit)
+      for (vector<PeptideHit>::iterator pit = it->getHits().begin(); pit != it->getHits().end(); ++pit)
       {
 #ifdef FALSE_DISCOVERY_RATE_DEBUG
-        cerr << pit->getScore() << " " << score_to_fdr[pit->getScore()] << endl;
+        cerr << pit->getScore() << " " << fdrs[index] << endl;
 #endif
         pit->setMetaValue(score_type, pit->getScore());
-        pit->setScore(score_to_fdr[pit->getScore()]);
+        pit->setScore(fdrs[index++]);
       }
-      it->setHits(hits);
     }
     //write as well decoy peptides
     if (add_decoy_peptides)
@@ -410,16 +464,14 @@ namespace OpenMS
         }
 
         it->setHigherScoreBetter(false);
-        vector<PeptideHit> hits = it->getHits();
-        for (vector<PeptideHit>::iterator pit = hits.begin(); pit != hits.end(); ++pit)
+        for (vector<PeptideHit>::iterator pit = it->getHits().begin(); pit != it->getHits().end(); ++pit)
         {
 #ifdef FALSE_DISCOVERY_RATE_DEBUG
-          cerr << pit->getScore() << " " << score_to_fdr[pit->getScore()] << endl;
+          cerr << pit->getScore() << " " << fdrs[index] << endl;
 #endif
           pit->setMetaValue(score_type, pit->getScore());
-          pit->setScore(score_to_fdr[pit->getScore()]);
+          pit->setScore(fdrs[index++]);
         }
-        it->setHits(hits);
       }
     }
 
@@ -428,17 +480,18 @@ namespace OpenMS
 
   void FalseDiscoveryRate::apply(vector<ProteinIdentification>& ids) const
   {
-    bool q_value = !param_.getValue("no_qvalues").toBool();
-    bool higher_score_better = ids.begin()->isHigherScoreBetter();
-    bool add_decoy_proteins = param_.getValue("add_decoy_proteins").toBool();
-
     if (ids.empty())
     {
       LOG_WARN << "No protein identifications given to FalseDiscoveryRate! No calculation performed.\n";
       return;
     }
 
-    vector<double> target_scores, decoy_scores;
+    bool q_value = !param_.getValue("no_qvalues").toBool();
+    bool higher_score_better = ids.begin()->isHigherScoreBetter();
+    bool add_decoy_proteins = param_.getValue("add_decoy_proteins").toBool();
+
+    vector<double> scores;
+    vector<bool> is_decoy;
     for (auto it = ids.begin(); it != ids.end(); ++it)
     {
       for (auto pit = it->getHits().begin(); pit != it->getHits().end(); ++pit)
@@ -452,25 +505,27 @@ namespace OpenMS
         String target_decoy = pit->getMetaValue("target_decoy");
         if (target_decoy == "decoy")
         {
-          decoy_scores.push_back(pit->getScore());
+          is_decoy.push_back(true);
         }
         else if (target_decoy == "target")
         {
-          target_scores.push_back(pit->getScore());
+          is_decoy.push_back(false);
         }
         else
         {
           throw Exception::InvalidValue(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "Unknown value of meta value 'target_decoy'", target_decoy);
         }
+        scores.push_back(pit->getScore());
       }
     }
 
 
     // calculate fdr for the forward scores
-    Map<double, double> score_to_fdr;
-    calculateFDRs_(score_to_fdr, target_scores, decoy_scores, q_value, higher_score_better);
+    vector<double> fdrs;
+    calculateFDRs(scores, is_decoy, higher_score_better, q_value, fdrs);
 
-    // annotate fdr
+    // annotate fdr (in place, removing decoys if necessary)
+    Size index = 0;
     String score_type = ids.begin()->getScoreType() + "_score";
     for (auto it = ids.begin(); it != ids.end(); ++it)
     {
@@ -483,19 +538,24 @@ namespace OpenMS
         it->setScoreType("FDR");
       }
       it->setHigherScoreBetter(false);
-      const vector<ProteinHit>& old_hits = it->getHits();
-      vector<ProteinHit> new_hits;
-      for (auto hit : old_hits)
+      vector<ProteinHit>& hits = it->getHits();
+      Size kept = 0;
+      for (Size i = 0; i < hits.size(); ++i, ++index)
       {
-        // Add decoy proteins only if add_decoy_proteins is set 
-        if (add_decoy_proteins || hit.getMetaValue("target_decoy") != "decoy")
-        {      
-          hit.setMetaValue(score_type, hit.getScore());
-          hit.setScore(score_to_fdr[hit.getScore()]);
-          new_hits.push_back(hit);
+        // Add decoy proteins only if add_decoy_proteins is set
+        if (!add_decoy_proteins && is_decoy[index])
+        {
+          continue;
         }
+        hits[i].setMetaValue(score_type, hits[i].getScore());
+        hits[i].setScore(fdrs[index]);
+        if (kept != i)
+        {
+          hits[kept] = std::move(hits[i]);
+        }
+        ++kept;
       }
-      it->setHits(new_hits);
+      hits.resize(kept);
     }
 
     return;
@@ -507,30 +567,34 @@ namespace OpenMS
     {
       return;
     }
-    vector<double> target_scores, decoy_scores;
-    // get the scores of all peptide hits
+    vector<double> scores;
+    vector<bool> is_decoy;
+    // get the scores of all protein hits
     for (vector<ProteinIdentification>::const_iterator it = fwd_ids.begin(); it != fwd_ids.end(); ++it)
     {
       for (vector<ProteinHit>::const_iterator pit = it->getHits().begin(); pit != it->getHits().end(); ++pit)
       {
-        target_scores.push_back(pit->getScore());
+        scores.push_back(pit->getScore());
+        is_decoy.push_back(false);
       }
     }
     for (vector<ProteinIdentification>::const_iterator it = rev_ids.begin(); it != rev_ids.end(); ++it)
     {
       for (vector<ProteinHit>::const_iterator pit = it->getHits().begin(); pit != it->getHits().end(); ++pit)
       {
-        decoy_scores.push_back(pit->getScore());
+        scores.push_back(pit->getScore());
+        is_decoy.push_back(true);
       }
     }
 
     bool q_value = !param_.getValue("no_qvalues").toBool();
     bool higher_score_better = fwd_ids.begin()->isHigherScoreBetter();
     // calculate fdr for the forward scores
-    Map<double, double> score_to_fdr;
-    calculateFDRs_(score_to_fdr, target_scores, decoy_scores, q_value, higher_score_better);
+    vector<double> fdrs;
+    calculateFDRs(scores, is_decoy, higher_score_better, q_value, fdrs);
 
     // annotate fdr
+    Size index = 0;
     String score_type = fwd_ids.begin()->getScoreType() + "_score";
     for (vector<ProteinIdentification>::iterator it = fwd_ids.begin(); it != fwd_ids.end(); ++it)
     {
@@ -543,168 +607,121 @@ namespace OpenMS
         it->setScoreType("FDR");
       }
       it->setHigherScoreBetter(false);
-      vector<ProteinHit> hits = it->getHits();
-      for (vector<ProteinHit>::iterator pit = hits.begin(); pit != hits.end(); ++pit)
+      for (vector<ProteinHit>::iterator pit = it->getHits().begin(); pit != it->getHits().end(); ++pit)
       {
         pit->setMetaValue(score_type, pit->getScore());
-        pit->setScore(score_to_fdr[pit->getScore()]);
+        pit->setScore(fdrs[index++]);
       }
-      it->setHits(hits);
     }
 
     return;
   }
 
-  void FalseDiscoveryRate::calculateFDRs_(Map<double, double>& score_to_fdr, vector<double>& target_scores, vector<double>& decoy_scores, bool q_value, bool higher_score_better) const
+  void FalseDiscoveryRate::calculateFDRs(const vector<double>& scores, const vector<bool>& is_decoy, bool higher_score_better, bool q_value, vector<double>& fdrs)
   {
-    Size number_of_target_scores = target_scores.size();
-    // sort the scores
-    if (higher_score_better && !q_value)
+    if (scores.size() != is_decoy.size())
     {
-      sort(target_scores.rbegin(), target_scores.rend());
-      sort(decoy_scores.rbegin(), decoy_scores.rend());
+      throw Exception::IllegalArgument(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "Number of scores and target/decoy labels differ");
     }
-    else if (!higher_score_better && !q_value)
+
+    const Size n = scores.size();
+    fdrs.resize(n);
+    if (n == 0)
     {
-      sort(target_scores.begin(), target_scores.end());
-      sort(decoy_scores.begin(), decoy_scores.end());
+      return;
     }
-    else if (higher_score_better)
+
+    // sort (score, index) pairs once, best score first
+    vector<pair<double, Size> > order(n);
+    for (Size i = 0; i < n; ++i)
     {
-      sort(target_scores.begin(), target_scores.end());
-      sort(decoy_scores.rbegin(), decoy_scores.rend());
+      order[i] = make_pair(scores[i], i);
+    }
+    if (higher_score_better)
+    {
+      parallelSort(order.begin(), order.end(), [](const pair<double, Size>& a, const pair<double, Size>& b) { return a.first > b.first; });
     }
     else
     {
-      sort(target_scores.rbegin(), target_scores.rend());
-      sort(decoy_scores.begin(), decoy_scores.end());
+      parallelSort(order.begin(), order.end(), [](const pair<double, Size>& a, const pair<double, Size>& b) { return a.first < b.first; });
     }
 
-    Size j = 0;
-
-    if (q_value)
+    // FDR of each group of tied scores containing targets:
+    // #decoys / #targets with the same or a better score
+    vector<double> target_scores, target_fdrs;
+    Size n_targets(0), n_decoys(0);
+    for (Size begin = 0, end = 0; begin < n; begin = end)
     {
-      double minimal_fdr = 1.;
-      for (Size i = 0; i != target_scores.size(); ++i)
+      bool has_target = false;
+      for (end = begin; end < n && order[end].first == order[begin].first; ++end)
       {
-        if (decoy_scores.empty())
-        {
-          // set FDR to 0 (done below automatically)
-        }
-        else if (i == 0 && j == 0)
+        if (is_decoy[order[end].second])
         {
-          while (j != decoy_scores.size()
-                && ((target_scores[i] <= decoy_scores[j] && higher_score_better) ||
-                    (target_scores[i] >= decoy_scores[j] && !higher_score_better)))
-          {
-            ++j;
-          }
+          ++n_decoys;
         }
         else
         {
-          if (j == decoy_scores.size())
-          {
-            j--;
-          }
-          while (j != 0
-                && ((target_scores[i] > decoy_scores[j] && higher_score_better) ||
-                    (target_scores[i] < decoy_scores[j] && !higher_score_better)))
-          {
-            --j;
-          }
-          // Since j has to be equal to the number of fps above the threshold we add one
-          if ((target_scores[i] <= decoy_scores[j] && higher_score_better)
-             || (target_scores[i] >= decoy_scores[j] && !higher_score_better))
-          {
-            ++j;
-          }
+          ++n_targets;
+          has_target = true;
         }
-
-#ifdef FALSE_DISCOVERY_RATE_DEBUG
-        cerr << target_scores[i] << " " << decoy_scores[j] << " " << i << " " << j << " ";
-#endif
-
-        double fdr = 0.;
-
-        if (minimal_fdr >= (double)j / (number_of_target_scores - i))
-        {
-          minimal_fdr = (double)j / (number_of_target_scores - i);
-        }
-        fdr = minimal_fdr;
-
-#ifdef FALSE_DISCOVERY_RATE_DEBUG
-        cerr << fdr << endl;
-#endif
-        score_to_fdr[target_scores[i]] = fdr;
-
+      }
+      if (has_target)
+      {
+        target_scores.push_back(order[begin].first);
+        target_fdrs.push_back((double)n_decoys / (double)n_targets);
       }
     }
-    else
+
+    // q-value: minimal FDR of this or any worse score
+    if (q_value)
     {
-      for (Size i = 0; i != target_scores.size(); ++i)
+      double minimal_fdr = 1.;
+      for (Size g = target_fdrs.size(); g > 0; --g)
       {
-        while (j != decoy_scores.size() &&
-               ((target_scores[i] <= decoy_scores[j] && higher_score_better) ||
-                (target_scores[i] >= decoy_scores[j] && !higher_score_better)))
-        {
-          ++j;
-        }
-
-#ifdef FALSE_DISCOVERY_RATE_DEBUG
-        cerr << target_scores[i] << " " << decoy_scores[j] << " " << i << " " << j << " ";
-#endif
-        double fdr(0);
-
-        fdr = (double)j / (double)(i + 1);
-
-#ifdef FALSE_DISCOVERY_RATE_DEBUG
-        cerr << fdr << endl;
-#endif
-        score_to_fdr[target_scores[i]] = fdr;
+        minimal_fdr = std::min(minimal_fdr, target_fdrs[g - 1]);
+        target_fdrs[g - 1] = minimal_fdr;
       }
     }
 
-
-    // assign q-value of decoy_score to closest target_score
-    for (Size i = 0; i != decoy_scores.size(); ++i)
+    // write back by index, decoys get the value of the closest target score
+    Size target_group = 0;
+    for (Size begin = 0, end = 0; begin < n; begin = end)
     {
-      const double& ds = decoy_scores[i];
-
-      // advance target index until score is better than decoy score
-      size_t k{0};
-      while (k != target_scores.size() && 
-             ((target_scores[k] <= ds && higher_score_better) ||
-              (target_scores[k] >= ds && !higher_score_better)))
+      bool has_target = false;
+      for (end = begin; end < n && order[end].first == order[begin].first; ++end)
       {
-        ++k;
+        has_target = has_target || !is_decoy[order[end].second];
       }
 
-      // corner cases
-      if (k == 0)
+      double fdr = 1.;
+      if (has_target)
       {
-        if (target_scores.size() != 0)
+        fdr = target_fdrs[target_group++];
+      }
+      else if (!target_scores.empty())
+      {
+        // closest better (previous) and worse (next) target scores
+        const double score = order[begin].first;
+        if (target_group == target_scores.size())
         {
-          score_to_fdr[ds] = score_to_fdr[target_scores[0]];
-          continue;
+          fdr = target_fdrs.back();
+        }
+        else if (target_group == 0 ||
+                 fabs(target_scores[target_group] - score) <= fabs(target_scores[target_group - 1] - score))
+        {
+          fdr = target_fdrs[target_group];
         }
         else
         {
-          score_to_fdr[ds] = 1.0;
+          fdr = target_fdrs[target_group - 1];
         }
       }
 
-      if (k == target_scores.size()) { score_to_fdr[ds] = score_to_fdr[target_scores.back()]; continue; }
-      
-      if (fabs(target_scores[k] - ds) < fabs(target_scores[k - 1] - ds))
+      for (Size i = begin; i < end; ++i)
       {
-        score_to_fdr[ds] = score_to_fdr[target_scores[k]];
-      }
-      else
-      {
-        score_to_fdr[ds] = score_to_fdr[target_scores[k - 1]];
+        fdrs[order[i].second] = fdr;
       }
     }
-
   }
 
 } // namespace OpenMS
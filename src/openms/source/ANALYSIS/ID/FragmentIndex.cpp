@@ -0,0 +1,263 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2018.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: Hannes Roest $
+// $Authors: Hannes Roest $
+// --------------------------------------------------------------------------
+
+
+#include <OpenMS/ANALYSIS/ID/FragmentIndex.h>
+
+#include <OpenMS/CONCEPT/Exception.h>
+#include <OpenMS/KERNEL/MSSpectrum.h>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <numeric>
+
+using std::vector;
+
+namespace OpenMS
+{
+  FragmentIndex::FragmentIndex(double bin_size) :
+    bin_size_(bin_size),
+    built_(false),
+    fragment_offsets_(1, 0)
+  {
+    if (!(bin_size > 0.0))
+    {
+      throw Exception::IllegalArgument(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "The bin size needs to be positive.");
+    }
+  }
+
+  Size FragmentIndex::addPeptide(double precursor_mass, const PeakSpectrum& theo_spectrum)
+  {
+    if (built_)
+    {
+      throw Exception::IllegalArgument(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "No peptides can be added after the index was built.");
+    }
+
+    const PeakSpectrum::StringDataArray* ion_names = nullptr;
+    if (!theo_spectrum.getStringDataArrays().empty())
+    {
+      ion_names = &theo_spectrum.getStringDataArrays()[0];
+    }
+
+    // store fragments sorted by m/z (the spectrum may not be sorted)
+    vector<Size> order(theo_spectrum.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(), [&theo_spectrum](Size a, Size b)
+      {
+        return theo_spectrum[a].getMZ() < theo_spectrum[b].getMZ();
+      });
+
+    for (Size i : order)
+    {
+      fragment_mz_.push_back(theo_spectrum[i].getMZ());
+      fragment_intensities_.push_back(theo_spectrum[i].getIntensity());
+      char type = ' ';
+      if (ion_names != nullptr && i < ion_names->size() && !(*ion_names)[i].empty())
+      {
+        type = (*ion_names)[i][0];
+      }
+      fragment_types_.push_back(type);
+    }
+    fragment_offsets_.push_back(fragment_mz_.size());
+    precursor_masses_.push_back(precursor_mass);
+    return precursor_masses_.size() - 1;
+  }
+
+  Size FragmentIndex::addPeptide(double precursor_mass, const vector<TheoreticalSpectrumGenerator::FragmentIon>& fragment_ions)
+  {
+    if (built_)
+    {
+      throw Exception::IllegalArgument(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "No peptides can be added after the index was built.");
+    }
+
+    for (const TheoreticalSpectrumGenerator::FragmentIon& ion : fragment_ions)
+    {
+      fragment_mz_.push_back(ion.mz);
+      fragment_intensities_.push_back(ion.intensity);
+      fragment_types_.push_back(ion.ion_type);
+    }
+    fragment_offsets_.push_back(fragment_mz_.size());
+    precursor_masses_.push_back(precursor_mass);
+    return precursor_masses_.size() - 1;
+  }
+
+  void FragmentIndex::build()
+  {
+    if (precursor_masses_.size() > std::numeric_limits<UInt32>::max())
+    {
+      throw Exception::IllegalArgument(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "Too many peptides for the fragment index.");
+    }
+
+    // order peptides by precursor mass
+    peptides_by_mass_.resize(precursor_masses_.size());
+    std::iota(peptides_by_mass_.begin(), peptides_by_mass_.end(), 0);
+    std::stable_sort(peptides_by_mass_.begin(), peptides_by_mass_.end(), [this](UInt32 a, UInt32 b)
+      {
+        return precursor_masses_[a] < precursor_masses_[b];
+      });
+    sorted_masses_.resize(peptides_by_mass_.size());
+    for (Size rank = 0; rank < peptides_by_mass_.size(); ++rank)
+    {
+      sorted_masses_[rank] = precursor_masses_[peptides_by_mass_[rank]];
+    }
+
+    // count the fragments per bin ...
+    double max_mz = 0.0;
+    for (double mz : fragment_mz_) { max_mz = std::max(max_mz, mz); }
+    const Size nr_bins = getBin_(max_mz) + 1;
+    bin_offsets_.assign(nr_bins + 1, 0);
+    for (double mz : fragment_mz_) { ++bin_offsets_[getBin_(mz) + 1]; }
+    std::partial_sum(bin_offsets_.begin(), bin_offsets_.end(), bin_offsets_.begin());
+
+    // ... and fill the bins in order of the peptide mass, which keeps each bin sorted by rank
+    bins_.resize(fragment_mz_.size());
+    vector<Size> fill(bin_offsets_.begin(), bin_offsets_.end() - 1);
+    for (Size rank = 0; rank < peptides_by_mass_.size(); ++rank)
+    {
+      const UInt32 peptide = peptides_by_mass_[rank];
+      for (Size f = fragment_offsets_[peptide]; f < fragment_offsets_[peptide + 1]; ++f)
+      {
+        BinEntry_& entry = bins_[fill[getBin_(fragment_mz_[f])]++];
+        entry.rank = static_cast<UInt32>(rank);
+        entry.mz = static_cast<float>(fragment_mz_[f]);
+      }
+    }
+    built_ = true;
+  }
+
+  bool FragmentIndex::isBuilt() const
+  {
+    return built_;
+  }
+
+  Size FragmentIndex::size() const
+  {
+    return precursor_masses_.size();
+  }
+
+  Size FragmentIndex::getNumberOfFragments() const
+  {
+    return fragment_mz_.size();
+  }
+
+  double FragmentIndex::getBinSize() const
+  {
+    return bin_size_;
+  }
+
+  double FragmentIndex::getPrecursorMass(Size peptide) const
+  {
+    return precursor_masses_[peptide];
+  }
+
+  void FragmentIndex::getTheoreticalSpectrum(Size peptide, PeakSpectrum& theo_spectrum) const
+  {
+    theo_spectrum.clear(true);
+    PeakSpectrum::StringDataArray ion_names;
+    ion_names.setName("IonNames");
+    for (Size f = fragment_offsets_[peptide]; f < fragment_offsets_[peptide + 1]; ++f)
+    {
+      Peak1D p;
+      p.setMZ(fragment_mz_[f]);
+      p.setIntensity(fragment_intensities_[f]);
+      theo_spectrum.push_back(p);
+      ion_names.push_back(String(fragment_types_[f]));
+    }
+    theo_spectrum.getStringDataArrays().push_back(ion_names);
+  }
+
+  void FragmentIndex::query(const PeakSpectrum& spectrum,
+                            double precursor_mass_min,
+                            double precursor_mass_max,
+                            double fragment_mass_tolerance,
+                            bool fragment_mass_tolerance_unit_ppm,
+                            Size min_matched_peaks,
+                            vector<Candidate>& candidates) const
+  {
+    if (!built_)
+    {
+      throw Exception::IllegalArgument(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "The fragment index needs to be built before it can be queried.");
+    }
+
+    const Size rank_begin = std::lower_bound(sorted_masses_.begin(), sorted_masses_.end(), precursor_mass_min) - sorted_masses_.begin();
+    const Size rank_end = std::upper_bound(sorted_masses_.begin(), sorted_masses_.end(), precursor_mass_max) - sorted_masses_.begin();
+    if (rank_begin >= rank_end || bins_.empty()) { return; }
+
+    vector<UInt32> matches(rank_end - rank_begin, 0);
+    for (Size i = 0; i < spectrum.size(); ++i)
+    {
+      const double mz = spectrum[i].getMZ();
+
+      // ppm tolerances are relative to the fragment m/z, search a window that contains all fragments
+      // within tolerance and allow for the single precision of the stored m/z values
+      double half_window = fragment_mass_tolerance_unit_ppm ?
+        mz * fragment_mass_tolerance * 1e-6 / std::max(1.0 - fragment_mass_tolerance * 1e-6, 1e-6) : fragment_mass_tolerance;
+      half_window += mz * std::numeric_limits<float>::epsilon();
+      const double lower = mz - half_window;
+      const double upper = mz + half_window;
+      if (upper < 0.0) { continue; }
+
+      const Size bin_begin = getBin_(std::max(lower, 0.0));
+      const Size bin_end = std::min(getBin_(upper) + 1, bin_offsets_.size() - 1);
+      for (Size bin = bin_begin; bin < bin_end; ++bin)
+      {
+        vector<BinEntry_>::const_iterator it = std::lower_bound(bins_.begin() + bin_offsets_[bin], bins_.begin() + bin_offsets_[bin + 1], rank_begin,
+          [](const BinEntry_& entry, Size rank) { return entry.rank < rank; });
+        const vector<BinEntry_>::const_iterator end = bins_.begin() + bin_offsets_[bin + 1];
+        for (; it != end && it->rank < rank_end; ++it)
+        {
+          if (it->mz > lower && it->mz < upper) { ++matches[it->rank - rank_begin]; }
+        }
+      }
+    }
+
+    for (Size r = 0; r < matches.size(); ++r)
+    {
+      if (matches[r] > 0 && matches[r] >= min_matched_peaks)
+      {
+        Candidate c;
+        c.peptide = peptides_by_mass_[rank_begin + r];
+        c.matched_peaks = matches[r];
+        candidates.push_back(c);
+      }
+    }
+  }
+
+  Size FragmentIndex::getBin_(double mz) const
+  {
+    return static_cast<Size>(mz / bin_size_);
+  }
+
+}
@@ -33,8 +33,13 @@
 // --------------------------------------------------------------------------
 
 #include <OpenMS/ANALYSIS/ID/IDMapper.h>
+#include <OpenMS/DATASTRUCTURES/BoundingBoxGrid.h>
 #include <OpenMS/MATH/MISC/MathFunctions.h>
 
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
 using namespace std;
 
 namespace OpenMS
@@ -115,9 +120,43 @@ namespace OpenMS
     // consensusMap -> {peptide_index}
     std::vector<std::set<size_t> > mapping(map.size());
 
-    DoubleList mz_values;
-    double rt_pep;
-    IntList charges;
+    // index the (RT, m/z) regions that can match each consensus feature
+    // (centroid or subelements), only these candidates are checked below
+    std::vector<DBoundingBox<2> > boxes(map.size());
+    for (Size cm_index = 0; cm_index < map.size(); ++cm_index)
+    {
+      if (!measure_from_subelements)
+      {
+        enlargeMatchBox_(boxes[cm_index], map[cm_index].getRT(), map[cm_index].getMZ());
+      }
+      else
+      {
+        for (ConsensusFeature::HandleSetType::const_iterator it_handle = map[cm_index].getFeatures().begin();
+             it_handle != map[cm_index].getFeatures().end();
+             ++it_handle)
+        {
+          enlargeMatchBox_(boxes[cm_index], it_handle->getRT(), it_handle->getMZ());
+        }
+      }
+    }
+    BoundingBoxGrid grid;
+    grid.build(boxes);
+
+    // find the candidate consensus features of all peptide IDs in parallel
+    std::vector<DoubleList> id_mz_values(ids.size());
+    std::vector<double> id_rts(ids.size());
+    std::vector<IntList> id_charges(ids.size());
+    std::vector<std::vector<Size> > candidates(ids.size());
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic, 100)
+#endif
+    for (SignedSize i = 0; i < (SignedSize)ids.size(); ++i)
+    {
+      if (ids[i].getHits().empty()) continue;
+
+      getIDDetails_(ids[i], id_rts[i], id_mz_values[i], id_charges[i]);
+      getCandidates_(grid, id_rts[i], id_mz_values[i], candidates[i]);
+    }
 
     // for statistics
     Size id_matches_none(0), id_matches_single(0), id_matches_multiple(0);
@@ -127,13 +166,17 @@ namespace OpenMS
     {
       if (ids[i].getHits().empty()) continue;
 
-      getIDDetails_(ids[i], rt_pep, mz_values, charges);
+      const DoubleList& mz_values = id_mz_values[i];
+      const double rt_pep = id_rts[i];
+      const IntList& charges = id_charges[i];
 
       bool id_mapped(false);
 
-      // iterate over the features
-      for (Size cm_index = 0; cm_index < map.size(); ++cm_index)
+      // iterate over the candidate features
+      for (Size c = 0; c < candidates[i].size(); ++c)
       {
+        const Size cm_index = candidates[i][c];
+
         // if set to TRUE, we leave the i_mz-loop as we added the whole ID with all hits
         bool was_added = false; // was current pep-m/z matched?!
 
@@ -293,9 +336,13 @@ namespace OpenMS
         }
         precursor_empty_id.setIdentifier(empty_protein_id.getIdentifier());
 
-        // iterate over the consensus features
-        for (Size cm_index = 0; cm_index < map.size(); ++cm_index)
+        // iterate over the candidate consensus features
+        std::vector<Size> precursor_candidates;
+        getCandidates_(grid, rt_value, DoubleList(1, mz_p), precursor_candidates);
+        for (Size c = 0; c < precursor_candidates.size(); ++c)
         {
+          const Size cm_index = precursor_candidates[c];
+
           // charge states to use for checking:
           IntList current_charges;
           if (!ignore_charge_)
@@ -433,67 +480,43 @@ namespace OpenMS
       max_rt = std::max(max_rt, box.maxPosition().getX());
     }
     
-    // hash bounding boxes of features by RT:
-    // RT range is partitioned into slices (bins) of 1 second; every feature
-    // that overlaps a certain slice is hashed into the corresponding bin
-    std::vector<std::vector<SignedSize> > hash_table;
-    // make sure the RT hash table has indices >= 0 and doesn't waste space
-    // in the beginning:
-    SignedSize offset(0);
-    
+    // spatial index over the feature bounding boxes
+    BoundingBoxGrid grid;
     if (map.size() > 0)
     {
-      // std::cout << "Setting up hash table..." << std::endl;
-      offset = SignedSize(floor(min_rt));
-      // this only works if features were found
-      hash_table.resize(SignedSize(floor(max_rt)) - offset + 1);
-      for (Size index = 0; index < boxes.size(); ++index)
-      {
-        const DBoundingBox<2> & box = boxes[index];
-        for (SignedSize i = SignedSize(floor(box.minPosition().getX()));
-             i <= SignedSize(floor(box.maxPosition().getX())); ++i)
-        {
-          hash_table[i - offset].push_back(index);
-        }
-      }
+      grid.build(boxes);
     }
     else
     {
       LOG_WARN << "IDMapper received an empty FeatureMap! All peptides are mapped as 'unassigned'!" << std::endl;
     }
     
-    // for statistics:
-    Size matches_none = 0, matches_single = 0, matches_multi = 0;
-    
     // std::cout << "Finding matches..." << std::endl;
-    // iterate over peptide IDs:
-    for (std::vector<PeptideIdentification>::const_iterator id_it =
-         ids.begin(); id_it != ids.end(); ++id_it)
+    // find the matching features of all peptide IDs in parallel (the map is
+    // not modified here), annotation happens afterwards in the original order
+    std::vector<std::vector<Size> > matches(ids.size());
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic, 100)
+#endif
+    for (SignedSize i = 0; i < (SignedSize)ids.size(); ++i)
     {
-      // std::cout << "Peptide ID: " << id_it - ids.begin() << std::endl;
-
-      if (id_it->getHits().empty()) continue;
+      const PeptideIdentification& id = ids[i];
+      if (id.getHits().empty()) continue;
 
       DoubleList mz_values;
       double rt_value;
       IntList charges;
-      getIDDetails_(*id_it, rt_value, mz_values, charges, use_avg_mass);
+      getIDDetails_(id, rt_value, mz_values, charges, use_avg_mass);
       
-      if ((rt_value < min_rt) || (rt_value > max_rt))             // RT out of bounds
-      {
-        map.getUnassignedPeptideIdentifications().push_back(*id_it);
-        ++matches_none;
-        continue;
-      }
+      if ((rt_value < min_rt) || (rt_value > max_rt)) continue; // RT out of bounds
       
       // iterate over candidate features:
-      Size index = SignedSize(floor(rt_value)) - offset;
-      Size matching_features = 0;
-      for (std::vector<SignedSize>::iterator hash_it =
-           hash_table[index].begin(); hash_it != hash_table[index].end();
-           ++hash_it)
+      std::vector<Size> candidates;
+      getCandidates_(grid, rt_value, mz_values, candidates);
+      for (std::vector<Size>::const_iterator cand_it = candidates.begin();
+           cand_it != candidates.end(); ++cand_it)
       {
-        Feature & feat = map[*hash_it];
+        const Feature & feat = map[*cand_it];
         
         // need to check the charge state?
         bool check_charge = !ignore_charge_;
@@ -514,19 +537,18 @@ namespace OpenMS
           }
           
           DPosition<2> id_pos(rt_value, *mz_it);
-          if (boxes[*hash_it].encloses(id_pos))                 // potential match
+          if (boxes[*cand_it].encloses(id_pos))                 // potential match
           {
             if (use_centroid_mz)
             {
               // only one m/z value to check, which was already incorporated
               // into the overall bounding box -> success!
-              feat.getPeptideIdentifications().push_back(*id_it);
-              ++matching_features;
+              matches[i].push_back(*cand_it);
               break;                     // "mz_it" loop
             }
             // else: check all the mass traces
             bool found_match = false;
-            for (std::vector<ConvexHull2D>::iterator ch_it =
+            for (std::vector<ConvexHull2D>::const_iterator ch_it =
                  feat.getConvexHulls().begin(); ch_it !=
                  feat.getConvexHulls().end(); ++ch_it)
             {
@@ -539,8 +561,7 @@ namespace OpenMS
               increaseBoundingBox_(box);
               if (box.encloses(id_pos)) // success!
               {
-                feat.getPeptideIdentifications().push_back(*id_it);
-                ++matching_features;
+                matches[i].push_back(*cand_it);
                 found_match = true;
                 break; // "ch_it" loop
               }
@@ -549,12 +570,28 @@ namespace OpenMS
           }
         }
       }
-      if (matching_features == 0)
+    }
+
+    // for statistics:
+    Size matches_none = 0, matches_single = 0, matches_multi = 0;
+    
+    // iterate over peptide IDs:
+    for (Size i = 0; i < ids.size(); ++i)
+    {
+      if (ids[i].getHits().empty()) continue;
+
+      for (std::vector<Size>::const_iterator match_it = matches[i].begin();
+           match_it != matches[i].end(); ++match_it)
       {
-        map.getUnassignedPeptideIdentifications().push_back(*id_it);
+        map[*match_it].getPeptideIdentifications().push_back(ids[i]);
+      }
+
+      if (matches[i].empty())
+      {
+        map.getUnassignedPeptideIdentifications().push_back(ids[i]);
         ++matches_none;
       }
-      else if (matching_features == 1) 
+      else if (matches[i].size() == 1) 
       {
         ++matches_single;
       }
@@ -617,7 +654,8 @@ namespace OpenMS
         }
       
         // iterate over candidate features:
-        Size index = SignedSize(floor(rt_value)) - offset;
+        std::vector<Size> candidates;
+        getCandidates_(grid, rt_value, DoubleList(1, mz_p), candidates);
         Size matching_features = 0;
 
         PeptideIdentification precursor_empty_id;
@@ -631,11 +669,10 @@ namespace OpenMS
         precursor_empty_id.setIdentifier(empty_protein_id.getIdentifier());
         //precursor_empty_id.setCharge(z_p);
 
-        for (std::vector<SignedSize>::iterator hash_it =
-           hash_table[index].begin(); hash_it != hash_table[index].end();
-           ++hash_it)
+        for (std::vector<Size>::const_iterator cand_it = candidates.begin();
+             cand_it != candidates.end(); ++cand_it)
         {
-          Feature & feat = map[*hash_it];
+          Feature & feat = map[*cand_it];
         
           // (optinally) check charge state
           if (!ignore_charge_)
@@ -645,7 +682,7 @@ namespace OpenMS
         
           DPosition<2> id_pos(rt_value, mz_p);
 
-          if (boxes[*hash_it].encloses(id_pos)) // potential match
+          if (boxes[*cand_it].encloses(id_pos)) // potential match
           {
             if (use_centroid_mz)
             {
@@ -780,6 +817,45 @@ namespace OpenMS
     }
   }
 
+  void IDMapper::enlargeMatchBox_(DBoundingBox<2>& box, const double rt, const double mz) const
+  {
+    // slightly larger than necessary, so that rounding cannot exclude any
+    // position that isMatch_() accepts
+    const double rt_tol = rt_tolerance_ * (1.0 + 1e-9) + 1e-9;
+    double mz_min, mz_max;
+    if (measure_ == MEASURE_PPM)
+    {
+      // the ppm error is relative to the theoretical (peptide) m/z
+      const double tol = mz_tolerance_ * 1e-6;
+      mz_min = mz / (1.0 + tol);
+      mz_max = tol < 1.0 ? mz / (1.0 - tol) : std::numeric_limits<double>::max();
+    }
+    else
+    {
+      mz_min = mz - mz_tolerance_;
+      mz_max = mz + mz_tolerance_;
+    }
+    const double mz_slack = 1e-9 * std::max(fabs(mz_min), fabs(mz_max)) + 1e-9;
+    box.enlarge(rt - rt_tol, mz_min - mz_slack);
+    box.enlarge(rt + rt_tol, std::min(mz_max + mz_slack, std::numeric_limits<double>::max()));
+  }
+
+  void IDMapper::getCandidates_(const BoundingBoxGrid& grid, const double rt, const DoubleList& mz_values, std::vector<Size>& candidates) const
+  {
+    candidates.clear();
+    std::vector<Size> result;
+    for (DoubleList::const_iterator mz_it = mz_values.begin(); mz_it != mz_values.end(); ++mz_it)
+    {
+      grid.query(DPosition<2>(rt, *mz_it), result);
+      candidates.insert(candidates.end(), result.begin(), result.end());
+    }
+    if (mz_values.size() > 1)
+    {
+      std::sort(candidates.begin(), candidates.end());
+      candidates.erase(std::unique(candidates.begin(), candidates.end()), candidates.end());
+    }
+  }
+
   void IDMapper::increaseBoundingBox_(DBoundingBox<2>& box)
   {
     DPosition<2> sub_min(rt_tolerance_,
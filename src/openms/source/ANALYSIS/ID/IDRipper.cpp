@@ -34,11 +34,19 @@
 
 #include <OpenMS/ANALYSIS/ID/IDRipper.h>
 
+#include <OpenMS/FORMAT/FileHandler.h>
+#include <OpenMS/FORMAT/IdXMLFile.h>
+#include <OpenMS/INTERFACES/IDConsumer.h>
+
 #include <QDir>
 
+#include <fstream>
+#include <memory>
+
 using std::vector;
 using std::map;
 using std::pair;
+using std::make_pair;
 
 //using namespace std;
 
@@ -165,6 +173,209 @@ namespace OpenMS
     }
   }
 
+  StringList IDRipper::ripFile(const String& in_file, const String& output_directory)
+  {
+    // file name of the file origin of a peptide identification (empty if not annotated)
+    struct OriginName
+    {
+      static String get(const PeptideIdentification& pep)
+      {
+        const String& file_origin = pep.getMetaValue("file_origin").toString();
+        return QFileInfo(file_origin.toQString()).fileName().toStdString();
+      }
+    };
+
+    // what the first pass learns about one output file
+    struct Output
+    {
+      // indices of the referenced protein hits (in order of first reference) for each run
+      map<Size, vector<Size> > run_hits;
+      std::set<pair<Size, Size> > seen_hits;
+    };
+
+    // first pass: collect protein identifications and the protein hits needed by each file origin
+    class Collector :
+      public Interfaces::IDConsumer
+    {
+    public:
+      Collector(IDRipper& ripper) : ripper_(ripper), peptide_count(0) {}
+
+      void consumeProteinID(ProteinIdentification& prot_id) override
+      {
+        const Size run = runs.size();
+        run_index.insert(make_pair(prot_id.getIdentifier(), run));
+        for (Size h = 0; h < prot_id.getHits().size(); ++h)
+        {
+          hit_index.insert(make_pair(prot_id.getHits()[h].getAccession(), hits.size()));
+          hits.push_back(prot_id.getHits()[h]);
+        }
+        runs.push_back(prot_id);
+        runs.back().getHits().clear();
+        runs.back().removeMetaValue("file_origin");
+      }
+
+      void consumePeptideID(PeptideIdentification& pep_id) override
+      {
+        ++peptide_count;
+        const String file_ = OriginName::get(pep_id);
+        map<String, Size>::const_iterator run_it = run_index.find(pep_id.getIdentifier());
+        if (file_.empty() || pep_id.getHits().empty() || run_it == run_index.end())
+        {
+          return;
+        }
+        Output& output = outputs[file_];
+        vector<Size>& run_hits = output.run_hits[run_it->second];
+
+        vector<String> protein_accessions;
+        ripper_.getProteinAccessions_(protein_accessions, pep_id.getHits());
+        for (vector<String>::const_iterator acc_it = protein_accessions.begin(); acc_it != protein_accessions.end(); ++acc_it)
+        {
+          map<String, Size>::const_iterator hit_it = hit_index.find(*acc_it);
+          if (hit_it != hit_index.end() && output.seen_hits.insert(make_pair(run_it->second, hit_it->second)).second)
+          {
+            run_hits.push_back(hit_it->second);
+          }
+        }
+      }
+
+      IDRipper& ripper_;
+      vector<ProteinIdentification> runs; // without hits
+      vector<ProteinHit> hits; // hits of all runs
+      map<String, Size> run_index;
+      map<String, Size> hit_index;
+      map<String, Output> outputs;
+      Size peptide_count;
+    };
+
+    Collector collector(*this);
+    IdXMLFile().load(in_file, collector);
+
+    if (collector.runs.empty() || collector.peptide_count == 0)
+    {
+      throw Exception::Precondition(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "idXML file has to store protein and peptide identifications!");
+    }
+
+    // state of one output file while writing
+    struct Writer
+    {
+      String filename;
+      std::unique_ptr<std::ofstream> os;
+      const Output* output;
+      vector<ProteinIdentification::SearchParameters> params;
+      Size current_run;
+      UInt prot_count;
+      map<String, UInt> accession_to_id;
+    };
+
+    // open all output files and write their headers
+    IdXMLFile writer;
+    map<String, Size> writer_index;
+    vector<Writer> writers(collector.outputs.size());
+    StringList filenames;
+    for (map<String, Output>::const_iterator out_it = collector.outputs.begin(); out_it != collector.outputs.end(); ++out_it)
+    {
+      Writer& w = writers[writer_index.size()];
+      writer_index.insert(make_pair(out_it->first, writer_index.size()));
+      QString output = output_directory.toQString();
+      w.filename = QDir::toNativeSeparators(output.append(QString("/")).append(out_it->first.toQString())).toStdString();
+      if (!FileHandler::hasValidExtension(w.filename, FileTypes::IDXML))
+      {
+        throw Exception::UnableToCreateFile(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, w.filename,
+                                            "invalid file extension, expected '" + FileTypes::typeToName(FileTypes::IDXML) + "'");
+      }
+      w.os.reset(new std::ofstream(w.filename.c_str()));
+      if (!*w.os)
+      {
+        throw Exception::UnableToCreateFile(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, w.filename);
+      }
+      w.os->precision(writtenDigits<double>(0.0));
+      w.output = &out_it->second;
+      w.current_run = collector.runs.size();
+      w.prot_count = 0;
+      for (map<Size, vector<Size> >::const_iterator run_it = w.output->run_hits.begin(); run_it != w.output->run_hits.end(); ++run_it)
+      {
+        const ProteinIdentification::SearchParameters& sp = collector.runs[run_it->first].getSearchParameters();
+        if (find(w.params.begin(), w.params.end(), sp) == w.params.end())
+        {
+          w.params.push_back(sp);
+        }
+      }
+      writer.writeHeader_(*w.os, w.params, "");
+      filenames.push_back(w.filename);
+    }
+
+    // second pass: write every peptide identification to the file of its origin
+    class Distributor :
+      public Interfaces::IDConsumer
+    {
+    public:
+      Distributor(const Collector& collector, IdXMLFile& writer, const map<String, Size>& writer_index, vector<Writer>& writers) :
+        collector_(collector), writer_(writer), writer_index_(writer_index), writers_(writers)
+      {
+      }
+
+      void consumeProteinID(ProteinIdentification& /* prot_id */) override
+      {
+        // already known from the first pass
+      }
+
+      void consumePeptideID(PeptideIdentification& pep_id) override
+      {
+        const String file_ = OriginName::get(pep_id);
+        map<String, Size>::const_iterator run_it = collector_.run_index.find(pep_id.getIdentifier());
+        if (file_.empty() || pep_id.getHits().empty() || run_it == collector_.run_index.end())
+        {
+          return;
+        }
+        Writer& w = writers_[writer_index_.find(file_)->second];
+        const Size run = run_it->second;
+        if (w.current_run != run)
+        {
+          if (w.current_run != collector_.runs.size())
+          {
+            *w.os << "\t</IdentificationRun>\n";
+          }
+          // copy only the protein hits this output refers to
+          ProteinIdentification prot_id = collector_.runs[run];
+          const vector<Size>& run_hits = w.output->run_hits.find(run)->second;
+          prot_id.getHits().reserve(run_hits.size());
+          for (vector<Size>::const_iterator hit_it = run_hits.begin(); hit_it != run_hits.end(); ++hit_it)
+          {
+            prot_id.getHits().push_back(collector_.hits[*hit_it]);
+          }
+          writer_.writeIdentificationRunStart_(*w.os, prot_id, w.params, w.prot_count, w.accession_to_id);
+          w.current_run = run;
+        }
+        pep_id.removeMetaValue("file_origin");
+        writer_.writePeptideIdentification_(*w.os, pep_id, w.accession_to_id);
+      }
+
+    private:
+      const Collector& collector_;
+      IdXMLFile& writer_;
+      const map<String, Size>& writer_index_;
+      vector<Writer>& writers_;
+    };
+
+    Distributor distributor(collector, writer, writer_index, writers);
+    IdXMLFile().load(in_file, distributor);
+
+    for (vector<Writer>::iterator w_it = writers.begin(); w_it != writers.end(); ++w_it)
+    {
+      if (w_it->current_run != collector.runs.size())
+      {
+        *w_it->os << "\t</IdentificationRun>\n";
+      }
+      *w_it->os << "</IdXML>\n";
+      w_it->os->close();
+      if (w_it->os->fail())
+      {
+        throw Exception::UnableToCreateFile(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, w_it->filename);
+      }
+    }
+    return filenames;
+  }
+
   void IDRipper::getProteinHits_(vector<ProteinHit>& result, const vector<ProteinHit>& protein_hits, const vector<String>& protein_accessions)
   {
     for (vector<String>::const_iterator it = protein_accessions.begin(); it < protein_accessions.end(); ++it)
@@ -285,27 +285,29 @@ MetaboliteSpectralMatching::~MetaboliteSpectralMatching()
 
 /// public methods
 
-double MetaboliteSpectralMatching::computeHyperScore(MSSpectrum exp_spectrum, MSSpectrum db_spectrum,
-                             const double& fragment_mass_error, const double& mz_lower_bound)
+double MetaboliteSpectralMatching::computeHyperScore(const MSSpectrum& exp_spectrum, const MSSpectrum& db_spectrum,
+                             const double& fragment_mass_error, const double& mz_lower_bound) const
 {
 
   double dot_product(0.0);
   Size matched_ions_count(0);
 
   // scan for matching peaks between observed and DB stored spectra
-  for (MSSpectrum::iterator frag_it = exp_spectrum.MZBegin(mz_lower_bound); frag_it != exp_spectrum.end(); ++frag_it)
+  const bool ppm = (mz_error_unit_ == "ppm");
+
+  for (MSSpectrum::ConstIterator frag_it = exp_spectrum.MZBegin(mz_lower_bound); frag_it != exp_spectrum.end(); ++frag_it)
   {
     double frag_mz = frag_it->getMZ();
 
     double mz_offset = fragment_mass_error;
 
-    if (mz_error_unit_ == "ppm")
+    if (ppm)
     {
       mz_offset = frag_mz * 1e-6 * fragment_mass_error;
     }
 
-    MSSpectrum::iterator db_mass_it = db_spectrum.MZBegin(frag_mz - mz_offset);
-    MSSpectrum::iterator db_mass_end = db_spectrum.MZEnd(frag_mz + mz_offset);
+    MSSpectrum::ConstIterator db_mass_it = db_spectrum.MZBegin(frag_mz - mz_offset);
+    MSSpectrum::ConstIterator db_mass_end = db_spectrum.MZEnd(frag_mz + mz_offset);
 
     std::pair<double, Peak1D> nearest_peak(mz_offset + 1.0, Peak1D());
 
@@ -360,7 +362,11 @@ double MetaboliteSpectralMatching::computeHyperScore(MSSpectrum exp_spectrum, MS
 
 void MetaboliteSpectralMatching::run(PeakMap & msexp, PeakMap & spec_db, MzTab& mztab_out)
 {
-  std::sort(spec_db.begin(), spec_db.end(), PrecursorMZLess);
+  // the database is sorted in place, repeated runs against the same database skip this step
+  if (!std::is_sorted(spec_db.begin(), spec_db.end(), PrecursorMZLess))
+  {
+    std::sort(spec_db.begin(), spec_db.end(), PrecursorMZLess);
+  }
 
   std::vector<double> mz_keys;
 
@@ -387,12 +393,17 @@ void MetaboliteSpectralMatching::run(PeakMap & msexp, PeakMap & spec_db, MzTab&
   wm.filterPeakMap(msexp);
 
 
-  // container storing results
-  std::vector<SpectralMatch> matching_results;
-
+  // container storing results (per query spectrum, so spectra can be matched in parallel)
+  std::vector<std::vector<SpectralMatch> > spectrum_results(msexp.size());
 
-  for (Size spec_idx = 0; spec_idx < msexp.size(); ++spec_idx)
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic)
+#endif
+  for (SignedSize signed_spec_idx = 0; signed_spec_idx < (SignedSize)msexp.size(); ++signed_spec_idx)
   {
+    const Size spec_idx(signed_spec_idx);
+    std::vector<SpectralMatch>& matching_results = spectrum_results[spec_idx];
+
     // std::cout << "merged spectrum no. " << spec_idx << " with #fragment ions: " << msexp[spec_idx].size() << std::endl;
 
     // iterate over all precursor masses
@@ -502,6 +513,12 @@ void MetaboliteSpectralMatching::run(PeakMap & msexp, PeakMap & spec_db, MzTab&
     } // end precursor loop
   } // end spectra loop
 
+  std::vector<SpectralMatch> matching_results;
+  for (Size spec_idx = 0; spec_idx < spectrum_results.size(); ++spec_idx)
+  {
+    matching_results.insert(matching_results.end(), spectrum_results[spec_idx].begin(), spectrum_results[spec_idx].end());
+  }
+
   // write final results to MzTab
   exportMzTab_(matching_results, mztab_out);
 }
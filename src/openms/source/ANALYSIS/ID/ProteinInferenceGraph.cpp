@@ -0,0 +1,440 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2018.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: Julianus Pfeuffer $
+// $Authors: Hannes Roest $
+// --------------------------------------------------------------------------
+
+
+#include <OpenMS/ANALYSIS/ID/ProteinInferenceGraph.h>
+
+#include <OpenMS/CONCEPT/Exception.h>
+
+#include <algorithm>
+#include <cmath>
+#include <queue>
+#include <set>
+#include <string>
+#include <unordered_map>
+#include <utility>
+
+using std::vector;
+
+namespace OpenMS
+{
+  ProteinInferenceGraph::ProteinInferenceGraph() :
+    protein_offsets_(1, 0),
+    peptide_offsets_(1, 0),
+    probabilities_valid_(true),
+    component_offsets_(1, 0)
+  {
+  }
+
+  void ProteinInferenceGraph::build(const ProteinIdentification& protein, const vector<PeptideIdentification>& peptides)
+  {
+    const vector<ProteinHit>& hits = protein.getHits();
+    std::unordered_map<std::string, UInt32> accession_index;
+    for (Size i = 0; i < hits.size(); ++i)
+    {
+      accession_index.emplace(hits[i].getAccession(), UInt32(i));
+    }
+
+    peptide_sequences_.clear();
+    peptide_probabilities_.clear();
+    probabilities_valid_ = true;
+    std::unordered_map<std::string, UInt32> sequence_index;
+    vector<std::pair<UInt32, UInt32> > edges; // (protein, peptide)
+    for (const PeptideIdentification& pep_id : peptides)
+    {
+      const vector<PeptideHit>& pep_hits = pep_id.getHits();
+      if (pep_hits.empty()) continue;
+
+      // best hit (independent of the order of the hits):
+      bool higher_better = pep_id.isHigherScoreBetter();
+      Size best = 0;
+      for (Size i = 1; i < pep_hits.size(); ++i)
+      {
+        if (higher_better ? pep_hits[i].getScore() > pep_hits[best].getScore() :
+                            pep_hits[i].getScore() < pep_hits[best].getScore())
+        {
+          best = i;
+        }
+      }
+      const PeptideHit& hit = pep_hits[best];
+      double score = hit.getScore();
+      if (!(score >= 0.0 && score <= 1.0)) probabilities_valid_ = false;
+      double probability = higher_better ? score : 1.0 - score;
+
+      std::pair<std::unordered_map<std::string, UInt32>::iterator, bool> pos =
+        sequence_index.emplace(hit.getSequence().toUnmodifiedString(), UInt32(peptide_sequences_.size()));
+      if (pos.second)
+      {
+        peptide_sequences_.push_back(pos.first->first);
+        peptide_probabilities_.push_back(probability);
+      }
+      else
+      {
+        double& current = peptide_probabilities_[pos.first->second];
+        current = std::max(current, probability);
+      }
+
+      std::set<String> accessions = hit.extractProteinAccessionsSet();
+      for (const String& acc : accessions)
+      {
+        std::unordered_map<std::string, UInt32>::const_iterator prot = accession_index.find(acc);
+        if (prot != accession_index.end())
+        {
+          edges.push_back(std::make_pair(prot->second, pos.first->second));
+        }
+      }
+    }
+    std::sort(edges.begin(), edges.end());
+    edges.erase(std::unique(edges.begin(), edges.end()), edges.end());
+
+    // adjacency arrays in both directions (sorted, as the edges are):
+    Size n_proteins = hits.size(), n_peptides = peptide_sequences_.size();
+    protein_offsets_.assign(n_proteins + 1, 0);
+    peptide_offsets_.assign(n_peptides + 1, 0);
+    for (const std::pair<UInt32, UInt32>& edge : edges)
+    {
+      ++protein_offsets_[edge.first + 1];
+      ++peptide_offsets_[edge.second + 1];
+    }
+    for (Size i = 0; i < n_proteins; ++i) protein_offsets_[i + 1] += protein_offsets_[i];
+    for (Size i = 0; i < n_peptides; ++i) peptide_offsets_[i + 1] += peptide_offsets_[i];
+    protein_peptides_.resize(edges.size());
+    peptide_proteins_.resize(edges.size());
+    vector<Size> fill(peptide_offsets_.begin(), peptide_offsets_.end() - 1);
+    for (Size e = 0; e < edges.size(); ++e)
+    {
+      protein_peptides_[e] = edges[e].second;
+      peptide_proteins_[fill[edges[e].second]++] = edges[e].first;
+    }
+
+    // connected components (breadth-first search from every unvisited protein):
+    const UInt32 unvisited = UInt32(-1);
+    protein_components_.assign(n_proteins, unvisited);
+    vector<bool> peptide_visited(n_peptides, false);
+    component_offsets_.assign(1, 0);
+    component_proteins_.clear();
+    component_proteins_.reserve(n_proteins);
+    for (Size root = 0; root < n_proteins; ++root)
+    {
+      if (protein_components_[root] != unvisited) continue;
+      UInt32 component = UInt32(component_offsets_.size() - 1);
+      Size start = component_proteins_.size();
+      protein_components_[root] = component;
+      component_proteins_.push_back(UInt32(root));
+      // the proteins of the component serve as BFS queue:
+      for (Size next = start; next < component_proteins_.size(); ++next)
+      {
+        UInt32 prot = component_proteins_[next];
+        for (Size i = protein_offsets_[prot]; i < protein_offsets_[prot + 1]; ++i)
+        {
+          UInt32 pep = protein_peptides_[i];
+          if (peptide_visited[pep]) continue;
+          peptide_visited[pep] = true;
+          for (Size j = peptide_offsets_[pep]; j < peptide_offsets_[pep + 1]; ++j)
+          {
+            UInt32 other = peptide_proteins_[j];
+            if (protein_components_[other] != unvisited) continue;
+            protein_components_[other] = component;
+            component_proteins_.push_back(other);
+          }
+        }
+      }
+      std::sort(component_proteins_.begin() + start, component_proteins_.end());
+      component_offsets_.push_back(component_proteins_.size());
+    }
+  }
+
+  void ProteinInferenceGraph::infer(ProteinIdentification& protein, InferenceMethod method, Size max_iterations, double tolerance) const
+  {
+    vector<ProteinHit>& hits = protein.getHits();
+    if (hits.size() != getNumberOfProteins())
+    {
+      throw Exception::IllegalArgument(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "The protein identification does not match the graph (different number of protein hits).");
+    }
+    if ((method == BAYESIAN) && !probabilities_valid_)
+    {
+      throw Exception::InvalidValue(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "Bayesian protein inference requires peptide scores that are probabilities or posterior error probabilities.", "peptide score");
+    }
+
+    Size n_components = getNumberOfComponents();
+    vector<vector<ProteinIdentification::ProteinGroup> > indist_groups(n_components), protein_groups(n_components);
+    vector<double> scores(hits.size(), 0.0);
+
+    // components are independent (and write to disjoint protein scores):
+#pragma omp parallel for schedule(dynamic, 100)
+    for (SignedSize c = 0; c < SignedSize(n_components); ++c)
+    {
+      vector<Group_> groups;
+      buildGroups_(c, groups);
+      vector<double> group_scores(groups.size(), 0.0);
+      vector<bool> selected(groups.size(), true);
+      if (method == PARSIMONY)
+      {
+        selectParsimonious_(groups, selected);
+        for (Size g = 0; g < groups.size(); ++g)
+        {
+          group_scores[g] = selected[g] ? 1.0 : 0.0;
+        }
+      }
+      else
+      {
+        estimateProbabilities_(groups, max_iterations, tolerance, group_scores);
+      }
+
+      for (Size g = 0; g < groups.size(); ++g)
+      {
+        ProteinIdentification::ProteinGroup group;
+        group.probability = group_scores[g];
+        for (UInt32 prot : groups[g].proteins)
+        {
+          group.accessions.push_back(hits[prot].getAccession());
+          scores[prot] = group_scores[g];
+        }
+        std::sort(group.accessions.begin(), group.accessions.end());
+        if (selected[g]) protein_groups[c].push_back(group);
+        indist_groups[c].push_back(group);
+      }
+    }
+
+    for (Size i = 0; i < hits.size(); ++i)
+    {
+      hits[i].setScore(scores[i]);
+    }
+    protein.setScoreType(method == PARSIMONY ? "parsimony" : "Posterior Probability");
+    protein.setHigherScoreBetter(true);
+    protein.getIndistinguishableProteins().clear();
+    protein.getProteinGroups().clear();
+    for (Size c = 0; c < n_components; ++c)
+    {
+      for (const ProteinIdentification::ProteinGroup& group : indist_groups[c])
+      {
+        protein.insertIndistinguishableProteins(group);
+      }
+      for (const ProteinIdentification::ProteinGroup& group : protein_groups[c])
+      {
+        protein.insertProteinGroup(group);
+      }
+    }
+  }
+
+  Size ProteinInferenceGraph::mapPeptides_(const vector<Group_>& groups, vector<vector<UInt32> >& local)
+  {
+    vector<UInt32> peptides;
+    for (const Group_& group : groups)
+    {
+      peptides.insert(peptides.end(), group.peptides.begin(), group.peptides.end());
+    }
+    std::sort(peptides.begin(), peptides.end());
+    peptides.erase(std::unique(peptides.begin(), peptides.end()), peptides.end());
+
+    local.resize(groups.size());
+    for (Size g = 0; g < groups.size(); ++g)
+    {
+      local[g].clear();
+      for (UInt32 pep : groups[g].peptides)
+      {
+        local[g].push_back(UInt32(std::lower_bound(peptides.begin(), peptides.end(), pep) - peptides.begin()));
+      }
+    }
+    return peptides.size();
+  }
+
+  void ProteinInferenceGraph::buildGroups_(Size component, vector<Group_>& groups) const
+  {
+    // sort the proteins by their peptides, equal neighbours are indistinguishable:
+    vector<UInt32> proteins(component_proteins_.begin() + component_offsets_[component],
+                            component_proteins_.begin() + component_offsets_[component + 1]);
+    std::stable_sort(proteins.begin(), proteins.end(), [this](UInt32 a, UInt32 b)
+    {
+      return std::lexicographical_compare(
+        protein_peptides_.begin() + protein_offsets_[a], protein_peptides_.begin() + protein_offsets_[a + 1],
+        protein_peptides_.begin() + protein_offsets_[b], protein_peptides_.begin() + protein_offsets_[b + 1]);
+    });
+
+    groups.clear();
+    for (Size i = 0; i < proteins.size(); ++i)
+    {
+      UInt32 prot = proteins[i];
+      vector<UInt32>::const_iterator begin = protein_peptides_.begin() + protein_offsets_[prot];
+      vector<UInt32>::const_iterator end = protein_peptides_.begin() + protein_offsets_[prot + 1];
+      if (groups.empty() || (groups.back().peptides.size() != Size(end - begin)) ||
+          !std::equal(groups.back().peptides.begin(), groups.back().peptides.end(), begin))
+      {
+        groups.push_back(Group_());
+        groups.back().peptides.assign(begin, end);
+      }
+      groups.back().proteins.push_back(prot);
+    }
+
+    // order groups by their first protein (proteins are sorted within groups):
+    std::sort(groups.begin(), groups.end(), [](const Group_& a, const Group_& b)
+    {
+      return a.proteins[0] < b.proteins[0];
+    });
+  }
+
+  void ProteinInferenceGraph::selectParsimonious_(const vector<Group_>& groups, vector<bool>& selected) const
+  {
+    vector<vector<UInt32> > local;
+    Size n_peptides = mapPeptides_(groups, local);
+    vector<bool> covered(n_peptides, false);
+    selected.assign(groups.size(), false);
+
+    // lazy greedy set cover: the gain of a group can only decrease, so a
+    // group whose updated gain is still the best one can be selected
+    typedef std::pair<std::pair<Size, double>, SignedSize> Key; // ((uncovered, summed probability), -group)
+    std::priority_queue<Key> queue;
+    vector<Size> global(n_peptides);
+    for (Size g = 0; g < groups.size(); ++g)
+    {
+      for (Size i = 0; i < local[g].size(); ++i) global[local[g][i]] = groups[g].peptides[i];
+    }
+    auto gain = [&](Size g)
+    {
+      Size count = 0;
+      double sum = 0.0;
+      for (UInt32 pep : local[g])
+      {
+        if (covered[pep]) continue;
+        ++count;
+        sum += peptide_probabilities_[global[pep]];
+      }
+      return Key(std::make_pair(count, sum), -SignedSize(g));
+    };
+    for (Size g = 0; g < groups.size(); ++g)
+    {
+      queue.push(gain(g));
+    }
+    while (!queue.empty())
+    {
+      Key top = queue.top();
+      queue.pop();
+      Size g = Size(-top.second);
+      Key current = gain(g);
+      if (current.first.first == 0) continue;
+      if (!queue.empty() && (current < queue.top()))
+      {
+        queue.push(current);
+        continue;
+      }
+      selected[g] = true;
+      for (UInt32 pep : local[g]) covered[pep] = true;
+    }
+  }
+
+  void ProteinInferenceGraph::estimateProbabilities_(const vector<Group_>& groups, Size max_iterations, double tolerance, vector<double>& probabilities) const
+  {
+    vector<vector<UInt32> > local;
+    Size n_peptides = mapPeptides_(groups, local);
+    vector<double> peptide_probs(n_peptides);
+    for (Size g = 0; g < groups.size(); ++g)
+    {
+      for (Size i = 0; i < local[g].size(); ++i)
+      {
+        peptide_probs[local[g][i]] = peptide_probabilities_[groups[g].peptides[i]];
+      }
+    }
+
+    // start with equal weights for the groups sharing a peptide:
+    probabilities.assign(groups.size(), 1.0);
+    vector<double> totals(n_peptides);
+    for (Size iteration = 0; iteration < max_iterations; ++iteration)
+    {
+      std::fill(totals.begin(), totals.end(), 0.0);
+      for (Size g = 0; g < groups.size(); ++g)
+      {
+        for (UInt32 pep : local[g]) totals[pep] += probabilities[g];
+      }
+
+      double max_change = 0.0;
+      vector<double> updated(groups.size());
+      for (Size g = 0; g < groups.size(); ++g)
+      {
+        double absent = 1.0; // probability that no peptide stems from the group
+        for (UInt32 pep : local[g])
+        {
+          double weight = (totals[pep] > 0.0) ? probabilities[g] / totals[pep] : 0.0;
+          absent *= 1.0 - weight * peptide_probs[pep];
+        }
+        updated[g] = 1.0 - absent;
+        max_change = std::max(max_change, std::fabs(updated[g] - probabilities[g]));
+      }
+      probabilities.swap(updated);
+      if (max_change < tolerance) break;
+    }
+  }
+
+  Size ProteinInferenceGraph::getNumberOfProteins() const
+  {
+    return protein_offsets_.size() - 1;
+  }
+
+  Size ProteinInferenceGraph::getNumberOfPeptides() const
+  {
+    return peptide_offsets_.size() - 1;
+  }
+
+  Size ProteinInferenceGraph::getNumberOfComponents() const
+  {
+    return component_offsets_.size() - 1;
+  }
+
+  Size ProteinInferenceGraph::getComponent(Size protein) const
+  {
+    return protein_components_[protein];
+  }
+
+  void ProteinInferenceGraph::getPeptides(Size protein, vector<Size>& peptides) const
+  {
+    peptides.assign(protein_peptides_.begin() + protein_offsets_[protein],
+                    protein_peptides_.begin() + protein_offsets_[protein + 1]);
+  }
+
+  void ProteinInferenceGraph::getProteins(Size peptide, vector<Size>& proteins) const
+  {
+    proteins.assign(peptide_proteins_.begin() + peptide_offsets_[peptide],
+                    peptide_proteins_.begin() + peptide_offsets_[peptide + 1]);
+  }
+
+  const String& ProteinInferenceGraph::getPeptideSequence(Size peptide) const
+  {
+    return peptide_sequences_[peptide];
+  }
+
+  double ProteinInferenceGraph::getPeptideProbability(Size peptide) const
+  {
+    return peptide_probabilities_[peptide];
+  }
+
+}
@@ -0,0 +1,133 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2018.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: Timo Sachsenberg $
+// $Authors: Timo Sachsenberg $
+// --------------------------------------------------------------------------
+
+#include <OpenMS/ANALYSIS/ID/SearchEngineChunks.h>
+
+#include <OpenMS/CONCEPT/Exception.h>
+
+#include <algorithm>
+#include <map>
+#include <set>
+
+namespace OpenMS
+{
+
+  Size SearchEngineChunks::getNumberOfChunks(Size requested, Size nr_spectra)
+  {
+    return std::max(Size(1), std::min(requested, nr_spectra));
+  }
+
+  Int SearchEngineChunks::getThreadsPerChunk(Size nr_chunks, Int threads)
+  {
+    if (nr_chunks == 0) return std::max(threads, 1);
+    return std::max(Int(threads / Int(nr_chunks)), 1);
+  }
+
+  std::vector<PeakMap> SearchEngineChunks::split(const PeakMap& exp, Size nr_chunks)
+  {
+    if (nr_chunks == 0 || nr_chunks > exp.size())
+    {
+      throw Exception::InvalidValue(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION,
+        "Number of chunks needs to be between 1 and the number of spectra (" + String(exp.size()) + ")", String(nr_chunks));
+    }
+
+    std::vector<PeakMap> chunks(nr_chunks);
+    // the first (size % nr_chunks) chunks get one spectrum more
+    const Size chunk_size = exp.size() / nr_chunks;
+    const Size larger_chunks = exp.size() % nr_chunks;
+    Size begin = 0;
+    for (Size i = 0; i < nr_chunks; ++i)
+    {
+      const Size end = begin + chunk_size + (i < larger_chunks ? 1 : 0);
+      chunks[i].getExperimentalSettings() = exp.getExperimentalSettings();
+      chunks[i].getSpectra().assign(exp.getSpectra().begin() + begin, exp.getSpectra().begin() + end);
+      chunks[i].updateRanges();
+      begin = end;
+    }
+    return chunks;
+  }
+
+  void SearchEngineChunks::merge(std::vector<std::vector<ProteinIdentification> >& chunk_proteins,
+                                 std::vector<std::vector<PeptideIdentification> >& chunk_peptides,
+                                 std::vector<ProteinIdentification>& proteins,
+                                 std::vector<PeptideIdentification>& peptides)
+  {
+    if (chunk_proteins.size() != chunk_peptides.size())
+    {
+      throw Exception::InvalidValue(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION,
+        "Number of chunks differs between protein (" + String(chunk_proteins.size()) + ") and peptide identifications", String(chunk_peptides.size()));
+    }
+
+    proteins.clear();
+    peptides.clear();
+    std::vector<std::set<String> > accessions;
+    for (Size c = 0; c < chunk_proteins.size(); ++c)
+    {
+      // identifiers of the runs of this chunk -> identifiers of the merged runs
+      std::map<String, String> identifiers;
+      for (Size r = 0; r < chunk_proteins[c].size(); ++r)
+      {
+        ProteinIdentification& run = chunk_proteins[c][r];
+        if (r == proteins.size())
+        {
+          // new run: take over the run information, hits are merged below
+          proteins.push_back(run);
+          proteins.back().getHits().clear();
+          accessions.push_back(std::set<String>());
+        }
+        identifiers[run.getIdentifier()] = proteins[r].getIdentifier();
+        for (std::vector<ProteinHit>::iterator hit = run.getHits().begin(); hit != run.getHits().end(); ++hit)
+        {
+          if (accessions[r].insert(hit->getAccession()).second)
+          {
+            proteins[r].insertHit(std::move(*hit));
+          }
+        }
+      }
+
+      for (std::vector<PeptideIdentification>::iterator pep = chunk_peptides[c].begin(); pep != chunk_peptides[c].end(); ++pep)
+      {
+        std::map<String, String>::const_iterator id = identifiers.find(pep->getIdentifier());
+        if (id != identifiers.end())
+        {
+          pep->setIdentifier(id->second);
+        }
+        peptides.push_back(std::move(*pep));
+      }
+    }
+    chunk_proteins.clear();
+    chunk_peptides.clear();
+  }
+
+} // namespace OpenMS
@@ -34,7 +34,9 @@
 
 #include <OpenMS/ANALYSIS/ID/SiriusMSConverter.h>
 #include <cstdint>
+#include <exception>
 #include <fstream>
+#include <sstream>
 #include <QDir>
 #include <OpenMS/CONCEPT/LogStream.h>
 #include <OpenMS/KERNEL/MSSpectrum.h>
@@ -114,7 +116,7 @@ namespace OpenMS
     return isotopes;
   }
 
-  void writeMsFile_(ofstream& os,
+  void writeMsFile_(ostream& os,
                     const PeakMap& spectra,
                     const vector<size_t>& ms2_spectra_index,
                     const String& native_id_type_accession,
@@ -325,6 +327,17 @@ namespace OpenMS
     }
   }
 
+  // a single compound of the .ms file: either all MS2 spectra assigned to a
+  // feature or a single MS2 spectrum without feature information
+  struct SiriusMSCompound_
+  {
+    vector<size_t> ms2_spectra_index;
+    StringList adducts;
+    vector<pair<double, double>> f_isotopes;
+    int feature_charge = 0;
+    uint64_t feature_id = 0;
+  };
+
   void SiriusMSFile::store(const PeakMap& spectra,
                            const OpenMS::String& msfile,
                            const FeatureMapping::FeatureToMs2Indices& feature_mapping,
@@ -332,6 +345,21 @@ namespace OpenMS
                            const int& isotope_pattern_iterations,
                            const bool no_masstrace_info_isotope_pattern)
   {
+    store(spectra, vector<String>(1, msfile), feature_mapping, feature_only, isotope_pattern_iterations, no_masstrace_info_isotope_pattern);
+  }
+
+  void SiriusMSFile::store(const PeakMap& spectra,
+                           const vector<String>& msfiles,
+                           const FeatureMapping::FeatureToMs2Indices& feature_mapping,
+                           const bool& feature_only,
+                           const int& isotope_pattern_iterations,
+                           const bool no_masstrace_info_isotope_pattern)
+  {
+    if (msfiles.empty())
+    {
+      throw Exception::IllegalArgument(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "At least one output file is needed.");
+    }
+
     const map<const BaseFeature*, vector<size_t>>& assigned_ms2 = feature_mapping.assignedMS2;
     const vector<size_t> & unassigned_ms2 = feature_mapping.unassignedMS2;
 
@@ -367,22 +395,8 @@ namespace OpenMS
       throw OpenMS::Exception::IllegalArgument(__FILE__, __LINE__, __FUNCTION__, "Error: Profile data provided but centroided spectra are needed. Please use PeakPicker to convert the spectra.");
     }
 
-    // loop over all spectra in file and write data to ofstream
-    ofstream os;
-
-    // create temporary input file (.ms)
-    os.open(msfile.c_str());
-     if (!os)
-    {
-      throw Exception::UnableToCreateFile(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, msfile);
-    }
-    os.precision(12);
-
-    StringList adducts;
-    uint64_t feature_id;
-    int feature_charge;
-    vector<pair<double, double>> f_isotopes;
-    f_isotopes.clear();
+    // collect all compounds in the order in which they are written
+    vector<SiriusMSCompound_> compounds;
 
     // if feature information is available to this first (write features in one compound)
     if (use_feature_information)
@@ -392,17 +406,14 @@ namespace OpenMS
            ++it)
       {
         const BaseFeature* feature = it->first;
-        const vector<size_t> feature_associated_ms2 = it->second;
 
-        // reset feature information with each iteration
-        f_isotopes.clear();
-        adducts.clear();
-
-        feature_id = feature->getUniqueId();
-        feature_charge = feature->getCharge();
+        SiriusMSCompound_ compound;
+        compound.ms2_spectra_index = it->second;
+        compound.feature_id = feature->getUniqueId();
+        compound.feature_charge = feature->getCharge();
 
         // multiple charged compounds are not allowed in sirius
-        if (feature_charge > 1 || feature_charge < -1)
+        if (compound.feature_charge > 1 || compound.feature_charge < -1)
         {
           count_skipped_features = count_skipped_features + 1;
           continue;
@@ -410,10 +421,10 @@ namespace OpenMS
 
         if (feature->metaValueExists("adducts"))
         {
-          adducts = feature->getMetaValue("adducts");
+          compound.adducts = feature->getMetaValue("adducts");
         }
         if (feature->metaValueExists("masstrace_centroid_mz") && feature->metaValueExists("masstrace_intensity"))
-         {
+        {
           vector<double> masstrace_centroid_mz = feature->getMetaValue("masstrace_centroid_mz");
           vector<double> masstrace_intensity = feature->getMetaValue("masstrace_intensity");
           if (masstrace_centroid_mz.size() == masstrace_intensity.size())
@@ -421,71 +432,26 @@ namespace OpenMS
             for (Size i = 0; i < masstrace_centroid_mz.size(); ++i)
             {
               pair<double, double> masstrace_mz_int(masstrace_centroid_mz[i],masstrace_intensity[i]);
-              f_isotopes.push_back(masstrace_mz_int);
+              compound.f_isotopes.push_back(masstrace_mz_int);
             }
           }
-         }
-
-         bool writecompound = true;
-        // call function to writeMsFile to os
-        writeMsFile_(os,
-                     spectra,
-                     feature_associated_ms2,
-                     native_id_type_accession,
-                     adducts,
-                     f_isotopes,
-                     feature_charge,
-                     feature_id,
-                     writecompound,
-                     no_masstrace_info_isotope_pattern,
-                     isotope_pattern_iterations,
-                     count_skipped_spectra,
-                     count_to_pos,
-                     count_to_neg,
-                     count_no_ms1);
-
         }
+        compounds.push_back(compound);
+      }
     }
 
+    // without feature information (feature_id 0) every MS2 spectrum is a compound of its own
+    vector<size_t> single_ms2;
+
     // if not mappend information avaibalbe (e.g. empty featurexml or only a few features)
     if (use_unassigend_ms2)
     {
-      // no feature information was provided
-      bool writecompound = true;
-      f_isotopes.clear();
-      adducts.clear();
-      feature_charge = 0;
-      feature_id = 0;
-
-      writeMsFile_(os,
-                   spectra,
-                   unassigned_ms2,
-                   native_id_type_accession,
-                   adducts,
-                   f_isotopes,
-                   feature_charge,
-                   feature_id,
-                   writecompound,
-                   no_masstrace_info_isotope_pattern,
-                   isotope_pattern_iterations,
-                   count_skipped_spectra,
-                   count_to_pos,
-                   count_to_neg,
-                   count_no_ms1);
+      single_ms2 = unassigned_ms2;
     }
 
     if (no_feautre_information)
     {
-      // no feature information was provided
-      bool writecompound = true;
-      f_isotopes.clear();
-      adducts.clear();
-      feature_charge = 0;
-      feature_id = 0;
-
       // fill vector with index of all ms2 of the mzml
-      vector<size_t> all_ms2;
-
       for (PeakMap::ConstIterator s_it = spectra.begin(); s_it != spectra.end(); ++s_it)
       {
         // process only MS2 spectra
@@ -496,27 +462,90 @@ namespace OpenMS
 
         int scan_index = s_it - spectra.begin();
 
-        all_ms2.push_back(scan_index);
+        single_ms2.push_back(scan_index);
       }
+    }
 
-      writeMsFile_(os,
-                   spectra,
-                   all_ms2,
-                   native_id_type_accession,
-                   adducts,
-                   f_isotopes,
-                   feature_charge,
-                   feature_id,
-                   writecompound,
-                   no_masstrace_info_isotope_pattern,
-                   isotope_pattern_iterations,
-                   count_skipped_spectra,
-                   count_to_pos,
-                   count_to_neg,
-                   count_no_ms1);
+    for (const size_t& ind : single_ms2)
+    {
+      SiriusMSCompound_ compound;
+      compound.ms2_spectra_index.push_back(ind);
+      compounds.push_back(compound);
     }
 
-    os.close();
+    // The compounds are split into contiguous parts (one per file). Within a
+    // part, blocks of compounds are formatted in parallel and then written in
+    // order, thus the output does not depend on the number of threads and
+    // the concatenated parts are equal to the output for a single file.
+    const Size block_size = 256;
+    for (Size part = 0; part < msfiles.size(); ++part)
+    {
+      // create temporary input file (.ms)
+      ofstream os(msfiles[part].c_str());
+      if (!os)
+      {
+        throw Exception::UnableToCreateFile(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, msfiles[part]);
+      }
+
+      const Size part_begin = part * compounds.size() / msfiles.size();
+      const Size part_end = (part + 1) * compounds.size() / msfiles.size();
+      for (Size block_begin = part_begin; block_begin < part_end; block_begin += block_size)
+      {
+        const Size block_end = std::min(part_end, block_begin + block_size);
+        vector<String> buffers(block_end - block_begin);
+
+        Size err_count = 0;
+        std::exception_ptr err;
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic) reduction(+: count_skipped_spectra, count_to_pos, count_to_neg, count_no_ms1)
+#endif
+        for (SignedSize c = (SignedSize)block_begin; c < (SignedSize)block_end; ++c)
+        {
+          try
+          {
+            const SiriusMSCompound_& compound = compounds[c];
+            stringstream ss;
+            ss.precision(12);
+
+            uint64_t feature_id = compound.feature_id;
+            bool writecompound = true;
+            // call function to writeMsFile to ss
+            writeMsFile_(ss,
+                         spectra,
+                         compound.ms2_spectra_index,
+                         native_id_type_accession,
+                         compound.adducts,
+                         compound.f_isotopes,
+                         compound.feature_charge,
+                         feature_id,
+                         writecompound,
+                         no_masstrace_info_isotope_pattern,
+                         isotope_pattern_iterations,
+                         count_skipped_spectra,
+                         count_to_pos,
+                         count_to_neg,
+                         count_no_ms1);
+            buffers[c - block_begin] = ss.str();
+          }
+          catch (...)
+          {
+#ifdef _OPENMP
+#pragma omp critical (SiriusMSFile_store)
+#endif
+            {
+              if (err_count++ == 0) err = std::current_exception();
+            }
+          }
+        }
+        if (err_count != 0) std::rethrow_exception(err);
+
+        for (const String& buffer : buffers)
+        {
+          os << buffer;
+        }
+      }
+      os.close();
+    }
 
     LOG_WARN << "No MS1 spectrum for this precursor. Occurred " << count_no_ms1 << " times." << endl;
     LOG_WARN << count_skipped_spectra << " spectra were skipped due to precursor charge below -1 and above +1." << endl;
@@ -16,6 +16,7 @@ ConsensusIDAlgorithmRanks.cpp
 ConsensusIDAlgorithmSimilarity.cpp
 ConsensusIDAlgorithmWorst.cpp
 FalseDiscoveryRate.cpp
+FragmentIndex.cpp
 HiddenMarkovModel.cpp
 IDConflictResolverAlgorithm.cpp
 IDMapper.cpp
@@ -24,9 +25,11 @@ IDDecoyProbability.cpp
 MetaboliteSpectralMatching.cpp
 PeptideProteinResolution.cpp
 PrecursorPurity.cpp
+ProteinInferenceGraph.cpp
 ProtonDistributionModel.cpp
 PeptideIndexing.cpp
 PercolatorFeatureSetHelper.cpp
+SearchEngineChunks.cpp
 SiriusMSConverter.cpp
 )
 
@@ -55,44 +55,59 @@ namespace OpenMS
   Size ConsensusMapNormalizerAlgorithmMedian::computeMedians(const ConsensusMap & map, vector<double>& medians, const String& acc_filter, const String& desc_filter)
   {
     Size number_of_maps = map.getColumnHeaders().size();
+    for (UInt i = 0; i < number_of_maps; i++)
+    {
+      if (map.getColumnHeaders().find(i) == map.getColumnHeaders().end()) throw Exception::ElementNotFound(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, String(i));
+    }
+
+    vector<bool> use_feature(map.size());
+    for (ConsensusMap::ConstIterator cf_it = map.begin(); cf_it != map.end(); ++cf_it)
+    {
+      use_feature[cf_it - map.begin()] = passesFilters_(cf_it, map, acc_filter, desc_filter);
+    }
+
+    return computeMedians(ColumnarConsensusMap(map), medians, use_feature);
+  }
+
+  Size ConsensusMapNormalizerAlgorithmMedian::computeMedians(const ColumnarConsensusMap & map, vector<double>& medians, const vector<bool>& use_feature)
+  {
+    Size number_of_maps = map.getNumberOfMaps();
+    const vector<Size>& map_sizes = map.getMapSizes();
     vector<vector<double> > feature_int(number_of_maps);
     medians.resize(number_of_maps);
 
     // get map with most features, reserve space for feature_int (unequal vector lengths, 0-features omitted)
-    ConsensusMap::ColumnHeaders::const_iterator map_with_most_features = map.getColumnHeaders().find(0);
     UInt map_with_most_features_idx = 0;
     for (UInt i = 0; i < number_of_maps; i++)
     {
-      ConsensusMap::ColumnHeaders::const_iterator it = map.getColumnHeaders().find(i);
-      if (it == map.getColumnHeaders().end()) throw Exception::ElementNotFound(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, String(i));
-      feature_int[i].reserve(it->second.size);
+      feature_int[i].reserve(map_sizes[i]);
 
-      if (it->second.size > map_with_most_features->second.size)
+      if (map_sizes[i] > map_sizes[map_with_most_features_idx])
       {
-        map_with_most_features = it;
         map_with_most_features_idx = i;
       }
     }
 
     // fill feature_int with intensities
+    const vector<Size>& row_offsets = map.getRowOffsets();
+    const vector<UInt64>& map_indices = map.getHandleMapIndices();
+    const ColumnarConsensusMap::IntensityContainer& intensities = map.getHandleIntensities();
     Size pass_counter = 0;
-    ConsensusMap::ConstIterator cf_it;
-    for (cf_it = map.begin(); cf_it != map.end(); ++cf_it)
+    for (Size i = 0; i < map.getNumberOfFeatures(); ++i)
     {
-      if (!passesFilters_(cf_it, map, acc_filter, desc_filter))
+      if (!use_feature.empty() && !use_feature[i])
       {
         continue;
       }
       ++pass_counter;
 
-      ConsensusFeature::HandleSetType::const_iterator f_it;
-      for (f_it = cf_it->getFeatures().begin(); f_it != cf_it->getFeatures().end(); ++f_it)
+      for (Size k = row_offsets[i]; k < row_offsets[i + 1]; ++k)
       {
-        feature_int[f_it->getMapIndex()].push_back(f_it->getIntensity());
+        feature_int[map_indices[k]].push_back(intensities[k]);
       }
     }
 
-    LOG_INFO << endl << "Using " << pass_counter << "/" << map.size() <<  " consensus features for computing normalization coefficients" << endl << endl;
+    LOG_INFO << endl << "Using " << pass_counter << "/" << map.getNumberOfFeatures() <<  " consensus features for computing normalization coefficients" << endl << endl;
 
     // do we have enough features passing the filters to compute the median for every map?
     bool enough_features_left = true;
@@ -115,8 +130,11 @@ namespace OpenMS
     }
     else
     {
-      //compute medians
-      for (UInt j = 0; j < number_of_maps; j++)
+      //compute medians (sorting each map is independent)
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic)
+#endif
+      for (SignedSize j = 0; j < (SignedSize)number_of_maps; j++)
       {
         vector<double>& ints_j = feature_int[j];
         medians[j] = Math::median(ints_j.begin(), ints_j.end());
@@ -127,46 +145,61 @@ namespace OpenMS
   }
 
   void ConsensusMapNormalizerAlgorithmMedian::normalizeMaps(ConsensusMap & map, NormalizationMethod method, const String& acc_filter, const String& desc_filter)
+  {
+    vector<bool> use_feature(map.size());
+    for (ConsensusMap::ConstIterator cf_it = map.begin(); cf_it != map.end(); ++cf_it)
+    {
+      use_feature[cf_it - map.begin()] = passesFilters_(cf_it, map, acc_filter, desc_filter);
+    }
+
+    ColumnarConsensusMap columnar(map);
+    normalizeMaps(columnar, method, use_feature);
+    columnar.exportIntensities(map);
+  }
+
+  void ConsensusMapNormalizerAlgorithmMedian::normalizeMaps(ColumnarConsensusMap & map, NormalizationMethod method, const vector<bool>& use_feature)
   {
     if (method == NM_SHIFT)
     {
       LOG_WARN << endl << "WARNING: normalization using median shifting is not recommended for regular log-normal MS data. Use this only if you know exactly what you're doing!" << endl << endl;
     }
 
-    ConsensusMap::Iterator cf_it;
     ProgressLogger progresslogger;
     progresslogger.setLogType(ProgressLogger::CMD);
-    progresslogger.startProgress(0, map.size(), "normalizing maps");
+    progresslogger.startProgress(0, map.getNumberOfFeatures(), "normalizing maps");
 
     vector<double> medians;
-    Size index_of_largest_map = computeMedians(map, medians, acc_filter, desc_filter);
+    Size index_of_largest_map = computeMedians(map, medians, use_feature);
+
+    // shift to median of map with largest median in order to avoid negative intensities
+    double max_median(numeric_limits<double>::min());
+    Size max_median_index(0);
+    for (Size i = 0; i < medians.size(); ++i)
+    {
+      if (medians[i] > max_median)
+      {
+        max_median = medians[i];
+        max_median_index = i;
+      }
+    }
 
-    for (cf_it = map.begin(); cf_it != map.end(); ++cf_it)
+    const vector<Size>& row_offsets = map.getRowOffsets();
+    const vector<UInt64>& map_indices = map.getHandleMapIndices();
+    ColumnarConsensusMap::IntensityContainer& intensities = map.getHandleIntensities();
+    for (Size i = 0; i < map.getNumberOfFeatures(); ++i)
     {
-      progresslogger.setProgress(cf_it - map.begin());
-      ConsensusFeature::HandleSetType::const_iterator f_it;
-      for (f_it = cf_it->getFeatures().begin(); f_it != cf_it->getFeatures().end(); ++f_it)
+      progresslogger.setProgress(i);
+      for (Size k = row_offsets[i]; k < row_offsets[i + 1]; ++k)
       {
-        Size map_index = f_it->getMapIndex();
+        Size map_index = map_indices[k];
         if (method == NM_SCALE)
         {
           // scale to median of map with largest number of features
-          f_it->asMutable().setIntensity(f_it->getIntensity() * medians[index_of_largest_map] / medians[map_index]);
+          intensities[k] = intensities[k] * medians[index_of_largest_map] / medians[map_index];
         }
         else // method == NM_SHIFT
         {
-          // shift to median of map with largest median in order to avoid negative intensities
-          double max_median(numeric_limits<double>::min());
-          Size max_median_index(0);
-          for (Size i = 0; i < medians.size(); ++i)
-          {
-            if (medians[i] > max_median)
-            {
-              max_median = medians[i];
-              max_median_index = i;
-            }
-          }
-          f_it->asMutable().setIntensity(f_it->getIntensity() + medians[max_median_index] - medians[map_index]);
+          intensities[k] = intensities[k] + medians[max_median_index] - medians[map_index];
         }
       }
     }
@@ -36,6 +36,8 @@
 
 #include <OpenMS/CONCEPT/ProgressLogger.h>
 
+#include <algorithm>
+
 using namespace std;
 
 namespace OpenMS
@@ -51,81 +53,98 @@ namespace OpenMS
 
   void ConsensusMapNormalizerAlgorithmQuantile::normalizeMaps(ConsensusMap& map)
   {
-    //extract feature intensities
-    vector<vector<double> > feature_ints;
-    extractIntensityVectors(map, feature_ints);
-    Size number_of_maps = feature_ints.size();
+    Size number_of_maps = map.getColumnHeaders().size();
+    for (UInt i = 0; i < number_of_maps; i++)
+    {
+      if (map.getColumnHeaders().find(i) == map.getColumnHeaders().end()) throw Exception::ElementNotFound(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, String(i));
+    }
+
+    // work on the handle intensities only, the handle sets are not rebuilt
+    ColumnarConsensusMap columnar(map);
+    normalizeMaps(columnar);
+    columnar.exportIntensities(map);
+  }
+
+  void ConsensusMapNormalizerAlgorithmQuantile::normalizeMaps(ColumnarConsensusMap& map)
+  {
+    Size number_of_maps = map.getNumberOfMaps();
+    const vector<UInt64>& map_indices = map.getHandleMapIndices();
+    ColumnarConsensusMap::IntensityContainer& intensities = map.getHandleIntensities();
+
+    //positions of the handles of each map in the handle columns (in consensus feature order)
+    vector<vector<Size> > handle_positions(number_of_maps);
+    for (Size k = 0; k < map_indices.size(); ++k)
+    {
+      handle_positions[map_indices[k]].push_back(k);
+    }
 
     //determine largest number of features in any map
     Size largest_number_of_features = 0;
+    Size non_empty_maps = 0;
     for (Size i = 0; i < number_of_maps; ++i)
     {
-      if (feature_ints[i].size() > largest_number_of_features)
+      largest_number_of_features = std::max(largest_number_of_features, handle_positions[i].size());
+      if (!handle_positions[i].empty()) ++non_empty_maps;
+    }
+    if (non_empty_maps == 0) return;
+
+    //rank the features of each map and resample n data points from each sorted intensity distribution, n = maximum number of features in any map
+    vector<vector<Size> > sort_indices(number_of_maps);
+    vector<vector<double> > resampled_sorted_data(number_of_maps);
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic)
+#endif
+    for (SignedSize i = 0; i < (SignedSize)number_of_maps; ++i)
+    {
+      const vector<Size>& positions = handle_positions[i];
+      if (positions.empty()) continue;
+
+      std::vector<std::pair<double, Size> > sort_pairs;
+      sort_pairs.reserve(positions.size());
+      for (Size j = 0; j < positions.size(); ++j)
       {
-        largest_number_of_features = feature_ints[i].size();
+        sort_pairs.push_back(std::make_pair(intensities[positions[j]], j));
       }
-    }
+      std::sort(sort_pairs.begin(), sort_pairs.end());
 
-    //resample n data points from each sorted intensity distribution (from the different maps), n = maximum number of features in any map
-    vector<vector<double> > resampled_sorted_data;
-    for (Size i = 0; i < number_of_maps; ++i)
-    {
-      vector<double> sorted = feature_ints[i];
-      std::sort(sorted.begin(), sorted.end());
-      vector<double> resampled(largest_number_of_features);
-      resample(sorted, resampled, static_cast<UInt>(largest_number_of_features));
-      resampled_sorted_data.push_back(resampled);
+      vector<double> sorted(sort_pairs.size());
+      sort_indices[i].resize(sort_pairs.size());
+      for (Size j = 0; j < sort_pairs.size(); ++j)
+      {
+        sorted[j] = sort_pairs[j].first;
+        sort_indices[i][j] = sort_pairs[j].second;
+      }
+      resample(sorted, resampled_sorted_data[i], static_cast<UInt>(largest_number_of_features));
     }
 
-    //compute reference distribution from all resampled distributions
+    //compute reference distribution from all resampled distributions (in map order, independent of the number of threads)
     vector<double> reference_distribution(largest_number_of_features);
     for (Size i = 0; i < number_of_maps; ++i)
     {
+      if (handle_positions[i].empty()) continue;
       for (Size j = 0; j < largest_number_of_features; ++j)
       {
-        reference_distribution[j] += (resampled_sorted_data[i][j] / (double)number_of_maps);
+        reference_distribution[j] += (resampled_sorted_data[i][j] / (double)non_empty_maps);
       }
     }
 
     //for each map: resample from the reference distribution down to the respective original size again
-    vector<vector<double> > normalized_sorted_ints(number_of_maps);
-    for (Size i = 0; i < number_of_maps; ++i)
+    //and assign the normalized values according to the original ranks
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic)
+#endif
+    for (SignedSize i = 0; i < (SignedSize)number_of_maps; ++i)
     {
-      vector<double> ints;
-      resample(reference_distribution, ints, static_cast<UInt>(feature_ints[i].size()));
-      normalized_sorted_ints[i] = ints;
-    }
+      const vector<Size>& positions = handle_positions[i];
+      if (positions.empty()) continue;
 
-    //set the intensities of feature_ints to the normalized intensities
-    for (Size i = 0; i < number_of_maps; ++i)
-    {
-      // We do not want to change the order in feature_ints[i] but normalized_sorted_ints
-      // comes sorted, so we transfer the values in feature_ints[i] into pairs that store
-      // the value and the index in feature_ints[i]. Then we sort the vector of pair and as
-      // a result store the indexes of feature_ints[i] in a sorted order in sort_indices.
-      std::vector<std::pair<double, UInt> > sort_pairs;
-      sort_pairs.reserve(feature_ints[i].size());
-      for (Size j = 0; j < feature_ints[i].size(); ++j)
-      {
-        sort_pairs.push_back(std::make_pair(feature_ints[i][j], j));
-      }
-      std::sort(sort_pairs.begin(), sort_pairs.end());
-      vector<Size> sort_indices;
-      sort_indices.reserve(sort_pairs.size());
-      for (Size j = 0; j < sort_pairs.size(); ++j)
-      {
-        sort_indices.push_back(sort_pairs.at(j).second);
-      }
-      Size k = 0;
-      for (Size j = 0; j < sort_indices.size(); ++j)
+      vector<double> normalized_sorted_ints;
+      resample(reference_distribution, normalized_sorted_ints, static_cast<UInt>(positions.size()));
+      for (Size j = 0; j < sort_indices[i].size(); ++j)
       {
-        Size idx = sort_indices[j];
-        feature_ints[i][idx] = normalized_sorted_ints[i][k++];
+        intensities[positions[sort_indices[i][j]]] = normalized_sorted_ints[j];
       }
     }
-
-    //write new feature intensities to the consensus map
-    setNormalizedIntensityValues(feature_ints, map);
   }
 
   void ConsensusMapNormalizerAlgorithmQuantile::resample(const vector<double>& data_in, vector<double>& data_out, UInt n_resampling_points)
@@ -37,6 +37,10 @@
 #include <OpenMS/METADATA/ProteinIdentification.h>
 #include <OpenMS/METADATA/PeptideIdentification.h>
 #include <OpenMS/FORMAT/FeatureXMLFile.h>
+#include <OpenMS/SYSTEM/File.h>
+
+#include <fstream>
+#include <unordered_map>
 
 using namespace std;
 
@@ -107,12 +111,6 @@ namespace OpenMS
   void FeatureGroupingAlgorithmKD::group_(const vector<MapType>& input_maps,
                                           ConsensusMap& out)
   {
-    // set parameters
-    String mz_unit(param_.getValue("mz_unit").toString());
-    mz_ppm_ = mz_unit == "ppm";
-    mz_tol_ = (double)(param_.getValue("link:mz_tol"));
-    rt_tol_secs_ = (double)(param_.getValue("link:rt_tol"));
-
     // check that the number of maps is ok:
     if (input_maps.size() < 2)
     {
@@ -140,16 +138,8 @@ namespace OpenMS
       }
     }
 
-    // set up distance functor
-    Param distance_params;
-    distance_params.insert("", param_.copy("distance_RT:"));
-    distance_params.insert("", param_.copy("distance_MZ:"));
-    distance_params.insert("", param_.copy("distance_intensity:"));
-    distance_params.setValue("distance_RT:max_difference", rt_tol_secs_);
-    distance_params.setValue("distance_MZ:max_difference", mz_tol_);
-    distance_params.setValue("distance_MZ:unit", (mz_ppm_ ? "ppm" : "Da"));
-    feature_distance_ = FeatureDistance(max_intensity, false);
-    feature_distance_.setParameters(distance_params);
+    // set parameters and distance functor
+    setLinkingParameters_(max_intensity);
 
     // partition at boundaries -> this should be safe because there cannot be
     // any cluster reaching across boundaries
@@ -264,7 +254,7 @@ namespace OpenMS
       }
 
       // link features
-      runClustering_(kd_data, out);
+      runClustering_(kd_data, out, feature_distance_);
       setProgress(progress++);
     }
     endProgress();
@@ -310,7 +300,400 @@ namespace OpenMS
     group_(maps, out);
   }
 
-  void FeatureGroupingAlgorithmKD::runClustering_(const KDTreeFeatureMaps& kd_data, ConsensusMap& out)
+  namespace
+  {
+    // fixed-size part of a partition record (features reduced to what is needed for linking)
+    struct PartitionRecord
+    {
+      UInt64 map_index;
+      UInt64 unique_id;
+      double rt;
+      double mz;
+      float intensity;
+      float quality;
+      float width;
+      Int charge;
+      UInt32 adduct_length;
+    };
+
+    void writePartitionRecord(std::ofstream& os, Size map_index, const BaseFeature& feature)
+    {
+      String adduct;
+      if (feature.metaValueExists("dc_charge_adducts"))
+      {
+        adduct = feature.getMetaValue("dc_charge_adducts").toString();
+      }
+      PartitionRecord record;
+      record.map_index = map_index;
+      record.unique_id = feature.getUniqueId();
+      record.rt = feature.getRT();
+      record.mz = feature.getMZ();
+      record.intensity = feature.getIntensity();
+      record.quality = feature.getQuality();
+      record.width = feature.getWidth();
+      record.charge = feature.getCharge();
+      record.adduct_length = adduct.size();
+      os.write(reinterpret_cast<const char*>(&record), sizeof(record));
+      os.write(adduct.c_str(), adduct.size());
+    }
+  }
+
+  void FeatureGroupingAlgorithmKD::loadPartition_(const String& filename, vector<BaseFeature>& features, vector<Size>& map_indices)
+  {
+    features.clear();
+    map_indices.clear();
+    std::ifstream is(filename.c_str(), std::ios::in | std::ios::binary);
+    if (!is)
+    {
+      throw Exception::FileNotReadable(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, filename);
+    }
+    PartitionRecord record;
+    while (is.read(reinterpret_cast<char*>(&record), sizeof(record)))
+    {
+      BaseFeature feature;
+      feature.setUniqueId(record.unique_id);
+      feature.setRT(record.rt);
+      feature.setMZ(record.mz);
+      feature.setIntensity(record.intensity);
+      feature.setQuality(record.quality);
+      feature.setWidth(record.width);
+      feature.setCharge(record.charge);
+      if (record.adduct_length > 0)
+      {
+        std::string adduct(record.adduct_length, ' ');
+        if (!is.read(&adduct[0], record.adduct_length))
+        {
+          throw Exception::FileNotReadable(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, filename);
+        }
+        feature.setMetaValue("dc_charge_adducts", String(adduct));
+      }
+      features.push_back(feature);
+      map_indices.push_back(record.map_index);
+    }
+    if (is.gcount() != 0) // truncated record
+    {
+      throw Exception::FileNotReadable(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, filename);
+    }
+  }
+
+  void FeatureGroupingAlgorithmKD::group(const StringList& feature_files, ConsensusMap& out)
+  {
+    // check that the number of maps is ok:
+    Size num_maps = feature_files.size();
+    if (num_maps < 2)
+    {
+      throw Exception::IllegalArgument(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION,
+                                       "At least two maps must be given!");
+    }
+
+    out.clear(false);
+
+    FeatureXMLFile f;
+    FeatureFileOptions options = f.getOptions();
+    // to save memory don't load convex hulls and subordinates
+    options.setLoadSubordinates(false);
+    options.setLoadConvexHull(false);
+    f.setOptions(options);
+
+    // m/z values are counted in bins slightly larger than the maximal m/z
+    // tolerance: features separated by an empty bin can never be linked (in
+    // ppm mode, the bins have a constant width on a logarithmic scale)
+    bool mz_ppm = param_.getValue("mz_unit").toString() == "ppm";
+    double max_mz_tol = max((double)(param_.getValue("link:mz_tol")), (double)(param_.getValue("warp:mz_tol")));
+    double bin_width = max(1.01 * (mz_ppm ? max_mz_tol * 1e-6 : max_mz_tol), 1e-9);
+    if (mz_ppm)
+    {
+      bin_width = std::log1p(bin_width);
+    }
+
+    // ------------ pass 1: collect m/z statistics and meta data ------------
+    map<Int64, Size> bin_counts;
+    Size num_features = 0;
+    double max_intensity(0.0);
+    vector<bool> has_peptide_ids(num_maps, false);
+    Size progress = 0;
+    startProgress(0, num_maps, "collecting m/z values");
+    for (Size k = 0; k < num_maps; ++k)
+    {
+      FeatureMap fmap;
+      f.load(feature_files[k], fmap);
+
+      StringList ms_runs;
+      fmap.getPrimaryMSRunPath(ms_runs);
+      ConsensusMap::ColumnHeader& header = out.getColumnHeaders()[k];
+      header.filename = (ms_runs.size() == 1) ? ms_runs.front() : feature_files[k];
+      header.size = fmap.size();
+      header.unique_id = fmap.getUniqueId();
+
+      for (FeatureMap::const_iterator feat_it = fmap.begin(); feat_it != fmap.end(); ++feat_it)
+      {
+        double mz = mz_ppm ? std::log(max(feat_it->getMZ(), 1e-6)) : feat_it->getMZ();
+        ++bin_counts[(Int64)std::floor(mz / bin_width)];
+        max_intensity = max(max_intensity, (double)feat_it->getIntensity());
+        if (!feat_it->getPeptideIdentifications().empty())
+        {
+          has_peptide_ids[k] = true;
+        }
+      }
+      num_features += fmap.size();
+
+      // add protein IDs and unassigned peptide IDs (in the order of the input maps)
+      out.getProteinIdentifications().insert(out.getProteinIdentifications().end(),
+                                             fmap.getProteinIdentifications().begin(),
+                                             fmap.getProteinIdentifications().end());
+      out.getUnassignedPeptideIdentifications().insert(out.getUnassignedPeptideIdentifications().end(),
+                                                       fmap.getUnassignedPeptideIdentifications().begin(),
+                                                       fmap.getUnassignedPeptideIdentifications().end());
+      setProgress(++progress);
+    }
+    endProgress();
+
+    setLinkingParameters_(max_intensity);
+
+    // compute partition boundaries (at empty bins)
+    Size pts_per_partition = num_features / (int)(param_.getValue("nr_partitions"));
+    vector<double> partition_boundaries; // inner boundaries
+    Size cumulative_count = 0;
+    for (map<Int64, Size>::const_iterator it = bin_counts.begin(); it != bin_counts.end(); ++it)
+    {
+      cumulative_count += it->second;
+      map<Int64, Size>::const_iterator next = it;
+      ++next;
+      if (next != bin_counts.end() && next->first - it->first >= 2 &&
+          cumulative_count >= (partition_boundaries.size() + 1) * pts_per_partition)
+      {
+        double edge = (it->first + 1) * bin_width;
+        partition_boundaries.push_back(mz_ppm ? std::exp(edge) : edge);
+      }
+    }
+    bin_counts.clear();
+    Size num_partitions = partition_boundaries.size() + 1;
+
+    // ------------ pass 2: distribute features to partition files ------------
+    String prefix = File::getTempDirectory() + "/" + File::getUniqueName() + "_kd_partition_";
+    vector<String> partition_files(num_partitions);
+    {
+      vector<std::ofstream> streams(num_partitions);
+      for (Size j = 0; j < num_partitions; ++j)
+      {
+        partition_files[j] = prefix + String(j) + ".bin";
+        streams[j].open(partition_files[j].c_str(), std::ios::out | std::ios::binary);
+        if (!streams[j])
+        {
+          throw Exception::UnableToCreateFile(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, partition_files[j]);
+        }
+      }
+
+      progress = 0;
+      startProgress(0, num_maps, "partitioning features");
+      for (Size k = 0; k < num_maps; ++k)
+      {
+        FeatureMap fmap;
+        f.load(feature_files[k], fmap);
+        for (FeatureMap::const_iterator feat_it = fmap.begin(); feat_it != fmap.end(); ++feat_it)
+        {
+          Size j = std::upper_bound(partition_boundaries.begin(), partition_boundaries.end(),
+                                    feat_it->getMZ()) - partition_boundaries.begin();
+          writePartitionRecord(streams[j], k, *feat_it);
+        }
+        setProgress(++progress);
+      }
+      endProgress();
+
+      for (Size j = 0; j < num_partitions; ++j)
+      {
+        streams[j].close();
+        if (streams[j].fail())
+        {
+          throw Exception::UnableToCreateFile(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, partition_files[j]);
+        }
+      }
+    }
+
+    // ------------ compute RT transformation models ------------
+    MapAlignmentAlgorithmKD aligner(num_maps, param_);
+    bool align = param_.getValue("warp:enabled").toString() == "true";
+    if (align)
+    {
+      progress = 0;
+      startProgress(0, num_partitions, "computing RT transformations");
+      for (Size j = 0; j < num_partitions; ++j)
+      {
+        vector<BaseFeature> features;
+        vector<Size> map_indices;
+        loadPartition_(partition_files[j], features, map_indices);
+
+        // set up kd-tree
+        KDTreeFeatureMaps kd_data;
+        kd_data.setParameters(param_);
+        for (Size i = 0; i < features.size(); ++i)
+        {
+          kd_data.addFeature(map_indices[i], &features[i]);
+        }
+        kd_data.optimizeTree();
+        aligner.addRTFitData(kd_data);
+        setProgress(++progress);
+      }
+
+      // fit LOWESS on RT fit data collected across all partitions
+      try
+      {
+        aligner.fitLOWESS();
+      }
+      catch (Exception::BaseException& e)
+      {
+        LOG_ERROR << "Error: " << e.what() << endl;
+        for (Size j = 0; j < num_partitions; ++j)
+        {
+          File::remove(partition_files[j]);
+        }
+        return;
+      }
+
+      endProgress();
+    }
+
+    // ------------ run alignment + feature linking on individual partitions ------------
+    // partitions are independent: link them in parallel, collect the results
+    // per partition and append them in order (deterministic result)
+    vector<ConsensusMap> partition_results(num_partitions);
+    String unreadable_file;
+    startProgress(0, num_partitions, "linking features");
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic)
+#endif
+    for (SignedSize j = 0; j < (SignedSize)num_partitions; ++j)
+    {
+      try
+      {
+        vector<BaseFeature> features;
+        vector<Size> map_indices;
+        loadPartition_(partition_files[j], features, map_indices);
+
+        // set up kd-tree
+        KDTreeFeatureMaps kd_data;
+        kd_data.setParameters(param_);
+        for (Size i = 0; i < features.size(); ++i)
+        {
+          kd_data.addFeature(map_indices[i], &features[i]);
+        }
+        kd_data.optimizeTree();
+
+        // alignment
+        if (align)
+        {
+          aligner.transform(kd_data);
+        }
+
+        // link features (the distance functor caches values, use one per partition)
+        FeatureDistance feature_distance(feature_distance_);
+        runClustering_(kd_data, partition_results[j], feature_distance);
+      }
+      catch (Exception::FileNotReadable&)
+      {
+#ifdef _OPENMP
+#pragma omp critical (FeatureGroupingAlgorithmKD_error)
+#endif
+        unreadable_file = partition_files[j];
+      }
+
+      nextProgress();
+    }
+    endProgress();
+
+    for (Size j = 0; j < num_partitions; ++j)
+    {
+      File::remove(partition_files[j]);
+    }
+    if (!unreadable_file.empty())
+    {
+      throw Exception::FileNotReadable(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, unreadable_file);
+    }
+
+    for (Size j = 0; j < num_partitions; ++j)
+    {
+      for (ConsensusMap::const_iterator cf_it = partition_results[j].begin(); cf_it != partition_results[j].end(); ++cf_it)
+      {
+        out.push_back(*cf_it);
+      }
+      partition_results[j] = ConsensusMap();
+    }
+
+    // ------------ pass 3: transfer peptide identifications ------------
+    if (std::find(has_peptide_ids.begin(), has_peptide_ids.end(), true) != has_peptide_ids.end())
+    {
+      // index: (map, feature unique id) -> consensus feature
+      vector<std::unordered_map<UInt64, Size> > cf_index(num_maps);
+      for (Size i = 0; i < out.size(); ++i)
+      {
+        for (ConsensusFeature::const_iterator h_it = out[i].begin(); h_it != out[i].end(); ++h_it)
+        {
+          if (has_peptide_ids[h_it->getMapIndex()])
+          {
+            cf_index[h_it->getMapIndex()][h_it->getUniqueId()] = i;
+          }
+        }
+      }
+
+      progress = 0;
+      startProgress(0, num_maps, "transferring peptide identifications");
+      for (Size k = 0; k < num_maps; ++k)
+      {
+        if (has_peptide_ids[k])
+        {
+          FeatureMap fmap;
+          f.load(feature_files[k], fmap);
+          for (FeatureMap::const_iterator feat_it = fmap.begin(); feat_it != fmap.end(); ++feat_it)
+          {
+            std::unordered_map<UInt64, Size>::const_iterator pos = cf_index[k].find(feat_it->getUniqueId());
+            if (feat_it->getPeptideIdentifications().empty() || pos == cf_index[k].end()) continue;
+
+            // annotate map index to peptide identification (as in ConsensusFeature::insert)
+            vector<PeptideIdentification> ids(feat_it->getPeptideIdentifications());
+            for (vector<PeptideIdentification>::iterator id_it = ids.begin(); id_it != ids.end(); ++id_it)
+            {
+              id_it->setMetaValue("map_index", k);
+            }
+            vector<PeptideIdentification>& cf_ids = out[pos->second].getPeptideIdentifications();
+            cf_ids.insert(cf_ids.end(), ids.begin(), ids.end());
+          }
+          std::unordered_map<UInt64, Size>().swap(cf_index[k]);
+        }
+        setProgress(++progress);
+      }
+      endProgress();
+    }
+
+    // canonical ordering for checking the results:
+    startProgress(0, 3, String("sorting results"));
+    out.sortByQuality();
+    setProgress(1);
+    out.sortByMaps();
+    setProgress(2);
+    out.sortBySize();
+    endProgress();
+  }
+
+  void FeatureGroupingAlgorithmKD::setLinkingParameters_(double max_intensity)
+  {
+    String mz_unit(param_.getValue("mz_unit").toString());
+    mz_ppm_ = mz_unit == "ppm";
+    mz_tol_ = (double)(param_.getValue("link:mz_tol"));
+    rt_tol_secs_ = (double)(param_.getValue("link:rt_tol"));
+
+    // set up distance functor
+    Param distance_params;
+    distance_params.insert("", param_.copy("distance_RT:"));
+    distance_params.insert("", param_.copy("distance_MZ:"));
+    distance_params.insert("", param_.copy("distance_intensity:"));
+    distance_params.setValue("distance_RT:max_difference", rt_tol_secs_);
+    distance_params.setValue("distance_MZ:max_difference", mz_tol_);
+    distance_params.setValue("distance_MZ:unit", (mz_ppm_ ? "ppm" : "Da"));
+    feature_distance_ = FeatureDistance(max_intensity, false);
+    feature_distance_.setParameters(distance_params);
+  }
+
+  void FeatureGroupingAlgorithmKD::runClustering_(const KDTreeFeatureMaps& kd_data, ConsensusMap& out, FeatureDistance& feature_distance) const
   {
     Size n = kd_data.size();
 
@@ -323,7 +706,7 @@ namespace OpenMS
     set<ClusterProxyKD> potential_clusters;
     vector<ClusterProxyKD> cluster_for_idx(n);
     vector<Int> assigned(n, false);
-    updateClusterProxies_(potential_clusters, cluster_for_idx, update_these, assigned, kd_data);
+    updateClusterProxies_(potential_clusters, cluster_for_idx, update_these, assigned, kd_data, feature_distance);
 
     // pass 2: construct consensus features until all points assigned.
     while (!potential_clusters.empty())
@@ -333,7 +716,7 @@ namespace OpenMS
 
       // compile the actual list of sub feature indices for cluster with center i
       vector<Size> cf_indices;
-      computeBestClusterForCenter_(i, cf_indices, assigned, kd_data);
+      computeBestClusterForCenter_(i, cf_indices, assigned, kd_data, feature_distance);
 
       // add consensus feature
       addConsensusFeature_(cf_indices, kd_data, out);
@@ -361,7 +744,7 @@ namespace OpenMS
       }
 
       // now that the points are marked assigned, update the neighborhoods of their neighbors
-      updateClusterProxies_(potential_clusters, cluster_for_idx, update_these, assigned, kd_data);
+      updateClusterProxies_(potential_clusters, cluster_for_idx, update_these, assigned, kd_data, feature_distance);
     }
   }
 
@@ -371,14 +754,15 @@ namespace OpenMS
                                                          vector<ClusterProxyKD>& cluster_for_idx,
                                                          const set<Size>& update_these,
                                                          const vector<Int>& assigned,
-                                                         const KDTreeFeatureMaps& kd_data)
+                                                         const KDTreeFeatureMaps& kd_data,
+                                                         FeatureDistance& feature_distance) const
   {
     for (set<Size>::const_iterator it = update_these.begin(); it != update_these.end(); ++it)
     {
       Size i = *it;
       const ClusterProxyKD& old_proxy = cluster_for_idx[i];
       vector<Size> unused;
-      ClusterProxyKD new_proxy = computeBestClusterForCenter_(i, unused, assigned, kd_data);
+      ClusterProxyKD new_proxy = computeBestClusterForCenter_(i, unused, assigned, kd_data, feature_distance);
 
       // only need to update if size and/or average distance have changed
       if (new_proxy != old_proxy)
@@ -390,7 +774,7 @@ namespace OpenMS
     }
   }
 
-  ClusterProxyKD FeatureGroupingAlgorithmKD::computeBestClusterForCenter_(Size i, vector<Size>& cf_indices, const vector<Int>& assigned, const KDTreeFeatureMaps& kd_data) const
+  ClusterProxyKD FeatureGroupingAlgorithmKD::computeBestClusterForCenter_(Size i, vector<Size>& cf_indices, const vector<Int>& assigned, const KDTreeFeatureMaps& kd_data, FeatureDistance& feature_distance) const
   {
     // compute i's neighborhood, together with a look-up table
     // map index -> corresponding points
@@ -421,8 +805,7 @@ namespace OpenMS
       Size best_index = numeric_limits<Size>::max();
       for (vector<Size>::const_iterator c_it = candidates.begin(); c_it != candidates.end(); ++c_it)
       {
-        double dist = const_cast<FeatureDistance&>(feature_distance_)(*(kd_data.feature(*c_it)),
-                                                                      *(kd_data.feature(i))).second;
+        double dist = feature_distance(*(kd_data.feature(*c_it)), *(kd_data.feature(i))).second;
 
         if (dist < min_dist)
         {
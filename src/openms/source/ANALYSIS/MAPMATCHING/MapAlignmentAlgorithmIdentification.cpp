@@ -36,6 +36,10 @@
 #include <OpenMS/FORMAT/FileHandler.h>
 #include <OpenMS/MATH/STATISTICS/StatisticFunctions.h>
 
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
 using namespace std;
 
 namespace OpenMS
@@ -141,6 +145,9 @@ namespace OpenMS
     // compute RT medians:
     LOG_DEBUG << "Computing RT medians..." << endl;
     vector<SeqToValue> medians_per_run(size);
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic)
+#endif
     for (Int i = 0; i < size; ++i)
     {
       computeMedians_(rt_data[i], medians_per_run[i], sorted);
@@ -225,30 +232,20 @@ namespace OpenMS
     }
     LOG_DEBUG << "Max. allowed RT shift (in seconds): " << max_rt_shift << endl;
 
-    // generate RT transformations:
+    // generate RT transformations (the data points of different runs are
+    // independent, so collect these in parallel):
     LOG_DEBUG << "Generating RT transformations..." << endl;
-    LOG_INFO << "\nAlignment based on:" << endl; // diagnostic output
-    Size offset = 0; // offset in case of internal reference
-    for (Int i = 0; i < size + 1; ++i)
+    vector<TransformationDescription::DataPoints> data_per_run(size);
+    vector<Size> outliers_per_run(size, 0);
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic)
+#endif
+    for (Int i = 0; i < size; ++i)
     {
-      if (i == reference_index_)
-      {
-        // if one of the input maps was used as reference, it has been skipped
-        // so far - now we have to consider it again:
-        TransformationDescription trafo;
-        trafo.fitModel("identity");
-        transforms.push_back(trafo);
-        LOG_INFO << "- " << reference_.size() << " data points for sample "
-                 << i + 1 << " (reference)\n";
-        offset = 1;
-      }
-      if (i >= size) break;
-
       // to be useful for the alignment, a peptide sequence has to occur in the
       // current run ("medians_per_run[i]"), but also in at least one other run
       // ("medians_overall"):
-      TransformationDescription::DataPoints data;
-      Size n_outliers = 0;
+      TransformationDescription::DataPoints& data = data_per_run[i];
       for (SeqToValue::iterator med_it = medians_per_run[i].begin();
            med_it != medians_per_run[i].end(); ++med_it)
       {
@@ -263,14 +260,36 @@ namespace OpenMS
           }
           else
           {
-            n_outliers++;
+            outliers_per_run[i]++;
           }
         }
       }
-      transforms.push_back(TransformationDescription(data));
-      LOG_INFO << "- " << data.size() << " data points for sample "
+    }
+
+    LOG_INFO << "\nAlignment based on:" << endl; // diagnostic output
+    Size offset = 0; // offset in case of internal reference
+    for (Int i = 0; i < size + 1; ++i)
+    {
+      if (i == reference_index_)
+      {
+        // if one of the input maps was used as reference, it has been skipped
+        // so far - now we have to consider it again:
+        TransformationDescription trafo;
+        trafo.fitModel("identity");
+        transforms.push_back(trafo);
+        LOG_INFO << "- " << reference_.size() << " data points for sample "
+                 << i + 1 << " (reference)\n";
+        offset = 1;
+      }
+      if (i >= size) break;
+
+      transforms.push_back(TransformationDescription(data_per_run[i]));
+      LOG_INFO << "- " << data_per_run[i].size() << " data points for sample "
                << i + offset + 1;
-      if (n_outliers) LOG_INFO << " (" << n_outliers << " outliers removed)";
+      if (outliers_per_run[i])
+      {
+        LOG_INFO << " (" << outliers_per_run[i] << " outliers removed)";
+      }
       LOG_INFO << "\n";
     }
     LOG_INFO << endl;
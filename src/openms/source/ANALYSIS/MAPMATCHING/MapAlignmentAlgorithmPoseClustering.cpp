@@ -62,6 +62,17 @@ namespace OpenMS
     pairfinder_.setLogType(getLogType());
 
     max_num_peaks_considered_ = param_.getValue("max_num_peaks_considered");
+
+    // the preparation depends on the superimposer parameters
+    superimposer_.prepareMap(reference_, reference_prepared_);
+  }
+
+  void MapAlignmentAlgorithmPoseClustering::setUpWorkers_(PoseClusteringAffineSuperimposer& superimposer, StablePairFinder& pairfinder, bool log_progress) const
+  {
+    superimposer.setParameters(superimposer_.getParameters());
+    superimposer.setLogType(log_progress ? getLogType() : ProgressLogger::NONE);
+    pairfinder.setParameters(pairfinder_.getParameters());
+    pairfinder.setLogType(log_progress ? getLogType() : ProgressLogger::NONE);
   }
 
   MapAlignmentAlgorithmPoseClustering::~MapAlignmentAlgorithmPoseClustering()
@@ -85,14 +96,90 @@ namespace OpenMS
 
   void MapAlignmentAlgorithmPoseClustering::align(const ConsensusMap& map, TransformationDescription& trafo)
   {
-    // TODO: move this to updateMembers_? (if ConsensusMap prevails)
-    // TODO: why does superimposer work on consensus map???
+    // use own workers, so that concurrent calls do not interfere
+    PoseClusteringAffineSuperimposer superimposer;
+    StablePairFinder pairfinder;
+    setUpWorkers_(superimposer, pairfinder, true);
+    align_(map, superimposer, pairfinder, trafo);
+  }
+
+  void MapAlignmentAlgorithmPoseClustering::align(const std::vector<FeatureMap>& maps, std::vector<TransformationDescription>& trafos)
+  {
+    alignMaps_(maps, trafos);
+  }
+
+  void MapAlignmentAlgorithmPoseClustering::align(const std::vector<ConsensusMap>& maps, std::vector<TransformationDescription>& trafos)
+  {
+    alignMaps_(maps, trafos);
+  }
+
+  template <typename MapType>
+  void MapAlignmentAlgorithmPoseClustering::alignMaps_(const std::vector<MapType>& maps, std::vector<TransformationDescription>& trafos)
+  {
+    trafos.clear();
+    trafos.resize(maps.size());
+
+    startProgress(0, maps.size(), "aligning maps");
+    // exceptions must not leave the parallel region: store the first one
+    bool failed = false;
+    String error_message;
+#ifdef _OPENMP
+#pragma omp parallel
+#endif
+    {
+      // one superimposer and pair finder per thread
+      PoseClusteringAffineSuperimposer superimposer;
+      StablePairFinder pairfinder;
+      setUpWorkers_(superimposer, pairfinder, false);
+
+#ifdef _OPENMP
+#pragma omp for schedule(dynamic, 1)
+#endif
+      for (SignedSize i = 0; i < (SignedSize)maps.size(); ++i)
+      {
+        try
+        {
+          align_(maps[i], superimposer, pairfinder, trafos[i]);
+        }
+        catch (Exception::BaseException& e)
+        {
+#ifdef _OPENMP
+#pragma omp critical (MapAlignmentAlgorithmPoseClustering_error)
+#endif
+          {
+            if (!failed) error_message = String("Alignment of map ") + i + " failed: " + e.what();
+            failed = true;
+          }
+        }
+        nextProgress();
+      }
+    }
+    endProgress();
+
+    if (failed)
+    {
+      throw Exception::InvalidValue(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, error_message, "");
+    }
+  }
+
+  void MapAlignmentAlgorithmPoseClustering::align_(const FeatureMap& map, PoseClusteringAffineSuperimposer& superimposer, StablePairFinder& pairfinder, TransformationDescription& trafo) const
+  {
+    ConsensusMap map_scene;
+    MapConversion::convert(1, map, map_scene, max_num_peaks_considered_);
+    align_(map_scene, superimposer, pairfinder, trafo);
+  }
+
+  void MapAlignmentAlgorithmPoseClustering::align_(const ConsensusMap& map, PoseClusteringAffineSuperimposer& superimposer, StablePairFinder& pairfinder, TransformationDescription& trafo) const
+  {
     const ConsensusMap & map_model = reference_;
     ConsensusMap map_scene = map;
 
     // run superimposer to find the global transformation
+    // (the reference was prepared for the superimposer in setReference())
     TransformationDescription si_trafo;
-    superimposer_.run(map_model, map_scene, si_trafo);
+    PoseClusteringAffineSuperimposer::PreparedMap scene_prepared;
+    superimposer.prepareMap(map_scene, scene_prepared);
+    superimposer.run(reference_prepared_, scene_prepared, si_trafo);
 
     // apply transformation to consensus features and contained feature
     // handles
@@ -113,7 +200,7 @@ namespace OpenMS
     std::vector<ConsensusMap> input(2);
     input[0] = map_model;
     input[1] = map_scene;
-    pairfinder_.run(input, result);
+    pairfinder.run(input, result);
 
     // calculate the local transformation
     si_trafo.invert(); // to undo the transformation applied above
@@ -37,8 +37,13 @@
 
 #include <OpenMS/CONCEPT/Factory.h>
 
+#include <exception>
 #include <fstream>
 
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
 namespace OpenMS
 {
 
@@ -115,9 +120,16 @@ namespace OpenMS
       Size x = 0;
       float maxi = -999.0;
 
+      std::vector<std::pair<Size, Size> > pairs;
+      for (Size k = 0; k < pattern.size(); ++k)
+      {
+        pairs.push_back(std::make_pair(k, y));
+      }
+      std::vector<float> scores;
+      scoreRange_(pattern, tempalign, pairs, scores);
       for (Size k = 0; k < pattern.size(); ++k)
       {
-        float s =    scoring_(*pattern[k], *(tempalign[y]));
+        float s = scores[k];
         if (s > maxi && s > cutoffScore_)
         {
           x = k;
@@ -132,9 +144,15 @@ namespace OpenMS
 
       Size xn = (Size)(pattern.size() * i);
       Size yn = 0;
+      pairs.clear();
+      for (Size k = 0; k < tempalign.size(); ++k)
+      {
+        pairs.push_back(std::make_pair(xn, k));
+      }
+      scoreRange_(pattern, tempalign, pairs, scores);
       for (Size k = 0; k < tempalign.size(); ++k)
       {
-        float s =    scoring_(*pattern[xn], *(tempalign[k]));
+        float s = scores[k];
         if (s > maxi && s > cutoffScore_)
         {
           yn = k;
@@ -222,6 +240,18 @@ namespace OpenMS
     while (!finish)
     {
       traceback.clear();
+      // score the cells of the band in parallel, the recursion below only looks them up
+      std::vector<std::pair<Size, Size> > band;
+      for (Size i = 1; i <= n; ++i)
+      {
+        Int j_min = std::max(1, (Int)i - k_);
+        Int j_max = std::min((Int)m, (Int)i + (Int)n - (Int)m + k_);
+        for (Int j = j_min; j <= j_max; ++j)
+        {
+          band.push_back(std::make_pair(i, (Size)j));
+        }
+      }
+      precomputeScores_(band, xbegin, ybegin, pattern, aligned, buffermatrix, column_row_orientation);
       for (Size i = 0; i <= n; ++i)
       {
         setProgress(i);
@@ -316,7 +346,7 @@ namespace OpenMS
         }
         if (i != 0)
         {
-          firstcolummatchmatrix = secondcolummatchmatrix;
+          firstcolummatchmatrix.swap(secondcolummatchmatrix);
           secondcolummatchmatrix.clear();
         }
       }
@@ -454,6 +484,24 @@ namespace OpenMS
   inline Int MapAlignmentAlgorithmSpectrumAlignment::bestk_(const std::vector<MSSpectrum*>& pattern, std::vector<MSSpectrum*>& aligned, std::map<Size, std::map<Size, float> >& buffer, bool column_row_orientation, Size xbegin, Size xend, Size ybegin, Size yend)
   {
     Int ktemp = 2;
+    std::vector<std::pair<Size, Size> > cells;
+    for (float i = 0.25; i <= 0.75; i += 0.25)
+    {
+      Size temp = (Size)((yend - ybegin) * i);
+      for (Size k = 0; k <= (xend - xbegin); ++k)
+      {
+        if (column_row_orientation)
+        {
+          cells.push_back(std::make_pair(temp + 1, k + 1));
+        }
+        else
+        {
+          cells.push_back(std::make_pair(k + 1, temp + 1));
+        }
+      }
+    }
+    precomputeScores_(cells, xbegin, ybegin, pattern, aligned, buffer, column_row_orientation);
+
     for (float i = 0.25; i <= 0.75; i += 0.25)
     {
       Size temp = (Size)((yend - ybegin) * i);
@@ -501,11 +549,7 @@ namespace OpenMS
         {
           debugscoreDistributionCalculation_(score);
         }
-        if (score < threshold_)
-          score = mismatchscore_;
-        else
-          score = 2 + score;
-        buffer[i][j] = score;
+        buffer[i][j] = transformScore_(score);
       }
       return buffer[i][j];
     }
@@ -520,16 +564,81 @@ namespace OpenMS
         {
           debugscoreDistributionCalculation_(score);
         }
-        if (score < threshold_)
-          score = mismatchscore_;
-        else
-          score = 2 + score;
-        buffer[j][i] = score;
+        buffer[j][i] = transformScore_(score);
       }
       return buffer[j][i];
     }
   }
 
+  inline float MapAlignmentAlgorithmSpectrumAlignment::transformScore_(float score) const
+  {
+    if (score > 1)
+      score = 1;
+    if (score < threshold_)
+      return mismatchscore_;
+    return 2 + score;
+  }
+
+  void MapAlignmentAlgorithmSpectrumAlignment::precomputeScores_(const std::vector<std::pair<Size, Size> >& cells, Size patternbegin, Size alignbegin, const std::vector<MSSpectrum*>& pattern, std::vector<MSSpectrum*>& aligned, std::map<Size, std::map<Size, float> >& buffer, bool column_row_orientation)
+  {
+    // the score distribution of the debug mode is collected in scoreCalculation_
+    if (debug_) return;
+
+    // buffer keys (template index first) and the corresponding spectrum pairs of the cells not scored yet
+    std::vector<std::pair<Size, Size> > keys;
+    std::vector<std::pair<Size, Size> > pairs;
+    for (Size k = 0; k < cells.size(); ++k)
+    {
+      Size x = column_row_orientation ? cells[k].second : cells[k].first;
+      Size y = column_row_orientation ? cells[k].first : cells[k].second;
+      std::map<Size, std::map<Size, float> >::const_iterator row = buffer.find(x);
+      if (row != buffer.end())
+      {
+        std::map<Size, float>::const_iterator cell = row->second.find(y);
+        if (cell != row->second.end() && cell->second != 0) continue;
+      }
+      keys.push_back(std::make_pair(x, y));
+      pairs.push_back(std::make_pair(x + patternbegin - 1, y + alignbegin - 1));
+    }
+
+    std::vector<float> scores;
+    scoreRange_(pattern, aligned, pairs, scores);
+    for (Size k = 0; k < keys.size(); ++k)
+    {
+      buffer[keys[k].first][keys[k].second] = transformScore_(scores[k]);
+    }
+  }
+
+  void MapAlignmentAlgorithmSpectrumAlignment::scoreRange_(const std::vector<MSSpectrum*>& pattern, std::vector<MSSpectrum*>& aligned, const std::vector<std::pair<Size, Size> >& pairs, std::vector<float>& scores)
+  {
+    scores.assign(pairs.size(), 0.0f);
+    Size err_count = 0;
+    std::exception_ptr err;
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic, 16)
+#endif
+    for (SignedSize k = 0; k < (SignedSize)pairs.size(); ++k)
+    {
+      try
+      {
+        scores[k] = scoring_(*pattern[pairs[k].first], *aligned[pairs[k].second]);
+      }
+      catch (...)
+      {
+#ifdef _OPENMP
+#pragma omp critical (MapAlignmentAlgorithmSpectrumAlignment_scoreRange)
+#endif
+        {
+          if (err_count++ == 0) err = std::current_exception();
+        }
+      }
+    }
+    if (err_count > 0)
+    {
+      std::rethrow_exception(err);
+    }
+  }
+
   inline float MapAlignmentAlgorithmSpectrumAlignment::scoring_(const MSSpectrum& a, MSSpectrum& b)
   {
     return c1_->operator()(a, b);
@@ -60,30 +60,46 @@ namespace OpenMS
     msexp.clearRanges();
 
     // Transform spectra
-    for (PeakMap::iterator mse_iter = msexp.begin();
+    vector<double> rts;
+    rts.reserve(msexp.size());
+    for (PeakMap::const_iterator mse_iter = msexp.begin();
          mse_iter != msexp.end(); ++mse_iter)
     {
-      double rt = mse_iter->getRT();
-      if (store_original_rt) storeOriginalRT_(*mse_iter, rt);
-      mse_iter->setRT(trafo.apply(rt));
+      rts.push_back(mse_iter->getRT());
+    }
+    vector<double> new_rts;
+    trafo.apply(rts, new_rts);
+    for (Size i = 0; i < msexp.size(); ++i)
+    {
+      if (store_original_rt) storeOriginalRT_(msexp[i], rts[i]);
+      msexp[i].setRT(new_rts[i]);
     }
 
-    // Also transform chromatograms
+    // Also transform chromatograms (all at once)
+    rts.clear();
     for (Size i = 0; i < msexp.getNrChromatograms(); ++i)
     {
-      MSChromatogram& chromatogram = msexp.getChromatogram(i);
-      vector<double> original_rts;
-      if (store_original_rt) original_rts.reserve(chromatogram.size());
+      const MSChromatogram& chromatogram = msexp.getChromatogram(i);
       for (Size j = 0; j < chromatogram.size(); j++)
       {
-        double rt = chromatogram[j].getRT();
-        if (store_original_rt) original_rts.push_back(rt);
-        chromatogram[j].setRT(trafo.apply(rt));
+        rts.push_back(chromatogram[j].getRT());
       }
+    }
+    trafo.apply(rts, new_rts);
+    Size pos = 0;
+    for (Size i = 0; i < msexp.getNrChromatograms(); ++i)
+    {
+      MSChromatogram& chromatogram = msexp.getChromatogram(i);
       if (store_original_rt && !chromatogram.metaValueExists("original_rt"))
       {
+        vector<double> original_rts(rts.begin() + pos,
+                                    rts.begin() + pos + chromatogram.size());
         chromatogram.setMetaValue("original_rt", original_rts);
       }
+      for (Size j = 0; j < chromatogram.size(); j++, pos++)
+      {
+        chromatogram[j].setRT(new_rts[pos]);
+      }
     }
 
     msexp.updateRanges();
@@ -94,44 +110,108 @@ namespace OpenMS
     FeatureMap& fmap, const TransformationDescription& trafo,
     bool store_original_rt)
   {
+    // collect all RTs in the order in which they are assigned below, so the
+    // transformation can be evaluated for all of them at once
+    vector<double> rts;
+    for (vector<Feature>::const_iterator fmit = fmap.begin();
+         fmit != fmap.end(); ++fmit)
+    {
+      collectRTs_(*fmit, rts);
+    }
+    collectRTs_(fmap.getUnassignedPeptideIdentifications(), rts);
+    trafo.apply(rts, rts);
+
+    vector<double>::const_iterator rt_it = rts.begin();
     for (vector<Feature>::iterator fmit = fmap.begin(); fmit != fmap.end();
          ++fmit)
     {
-      applyToFeature_(*fmit, trafo, store_original_rt);
+      applyToFeature_(*fmit, rt_it, store_original_rt);
     }
 
     // adapt RT values of unassigned peptides:
-    if (!fmap.getUnassignedPeptideIdentifications().empty())
+    applyToPeptideIds_(fmap.getUnassignedPeptideIdentifications(), rt_it,
+                       store_original_rt);
+  }
+
+
+  void MapAlignmentTransformer::collectRTs_(const BaseFeature& feature,
+                                            vector<double>& rts)
+  {
+    rts.push_back(feature.getRT());
+    collectRTs_(feature.getPeptideIdentifications(), rts);
+  }
+
+
+  void MapAlignmentTransformer::collectRTs_(const Feature& feature,
+                                            vector<double>& rts)
+  {
+    collectRTs_(static_cast<const BaseFeature&>(feature), rts);
+
+    const vector<ConvexHull2D>& convex_hulls = feature.getConvexHulls();
+    for (vector<ConvexHull2D>::const_iterator chiter = convex_hulls.begin();
+         chiter != convex_hulls.end(); ++chiter)
+    {
+      const ConvexHull2D::PointArrayType& points = chiter->getHullPoints();
+      for (ConvexHull2D::PointArrayType::const_iterator points_iter =
+             points.begin(); points_iter != points.end(); ++points_iter)
+      {
+        rts.push_back((*points_iter)[Feature::RT]);
+      }
+    }
+
+    for (vector<Feature>::const_iterator subiter =
+           feature.getSubordinates().begin();
+         subiter != feature.getSubordinates().end(); ++subiter)
     {
-      transformRetentionTimes(fmap.getUnassignedPeptideIdentifications(), trafo,
-                              store_original_rt);
+      collectRTs_(*subiter, rts);
+    }
+  }
+
+
+  void MapAlignmentTransformer::collectRTs_(const ConsensusFeature& feature,
+                                            vector<double>& rts)
+  {
+    collectRTs_(static_cast<const BaseFeature&>(feature), rts);
+
+    for (ConsensusFeature::HandleSetType::const_iterator it =
+           feature.getFeatures().begin(); it != feature.getFeatures().end();
+         ++it)
+    {
+      rts.push_back(it->getRT());
+    }
+  }
+
+
+  void MapAlignmentTransformer::collectRTs_(
+    const vector<PeptideIdentification>& pep_ids, vector<double>& rts)
+  {
+    for (vector<PeptideIdentification>::const_iterator pep_it =
+           pep_ids.begin(); pep_it != pep_ids.end(); ++pep_it)
+    {
+      if (pep_it->hasRT()) rts.push_back(pep_it->getRT());
     }
   }
 
 
   void MapAlignmentTransformer::applyToBaseFeature_(
-    BaseFeature& feature, const TransformationDescription& trafo,
+    BaseFeature& feature, vector<double>::const_iterator& rt_it,
     bool store_original_rt)
   {
     // transform feature position:
-    double rt = feature.getRT();
-    if (store_original_rt) storeOriginalRT_(feature, rt);
-    feature.setRT(trafo.apply(rt));
+    if (store_original_rt) storeOriginalRT_(feature, feature.getRT());
+    feature.setRT(*rt_it++);
 
     // adapt RT values of annotated peptides:
-    if (!feature.getPeptideIdentifications().empty())
-    {
-      transformRetentionTimes(feature.getPeptideIdentifications(), trafo,
-                              store_original_rt);
-    }
+    applyToPeptideIds_(feature.getPeptideIdentifications(), rt_it,
+                       store_original_rt);
   }
 
 
   void MapAlignmentTransformer::applyToFeature_(
-    Feature& feature, const TransformationDescription& trafo,
+    Feature& feature, vector<double>::const_iterator& rt_it,
     bool store_original_rt)
   {
-    applyToBaseFeature_(feature, trafo, store_original_rt);
+    applyToBaseFeature_(feature, rt_it, store_original_rt);
 
     // loop over all convex hulls
     vector<ConvexHull2D>& convex_hulls = feature.getConvexHulls();
@@ -144,8 +224,7 @@ namespace OpenMS
       for (ConvexHull2D::PointArrayType::iterator points_iter = points.begin();
            points_iter != points.end(); ++points_iter)
       {
-        double rt = (*points_iter)[Feature::RT];
-        (*points_iter)[Feature::RT] = trafo.apply(rt);
+        (*points_iter)[Feature::RT] = *rt_it++;
       }
       chiter->setHullPoints(points);
     }
@@ -154,7 +233,7 @@ namespace OpenMS
     for (vector<Feature>::iterator subiter = feature.getSubordinates().begin();
          subiter != feature.getSubordinates().end(); ++subiter)
     {
-      applyToFeature_(*subiter, trafo, store_original_rt);
+      applyToFeature_(*subiter, rt_it, store_original_rt);
     }
   }
 
@@ -163,33 +242,41 @@ namespace OpenMS
     ConsensusMap& cmap, const TransformationDescription& trafo,
     bool store_original_rt)
   {
-    for (ConsensusMap::Iterator cmit = cmap.begin(); cmit != cmap.end(); ++cmit)
+    // collect all RTs in the order in which they are assigned below, so the
+    // transformation can be evaluated for all of them at once
+    vector<double> rts;
+    for (ConsensusMap::ConstIterator cmit = cmap.begin(); cmit != cmap.end();
+         ++cmit)
     {
-      applyToConsensusFeature_(*cmit, trafo, store_original_rt);
+      collectRTs_(*cmit, rts);
     }
+    collectRTs_(cmap.getUnassignedPeptideIdentifications(), rts);
+    trafo.apply(rts, rts);
 
-    // adapt RT values of unassigned peptides:
-    if (!cmap.getUnassignedPeptideIdentifications().empty())
+    vector<double>::const_iterator rt_it = rts.begin();
+    for (ConsensusMap::Iterator cmit = cmap.begin(); cmit != cmap.end(); ++cmit)
     {
-      transformRetentionTimes(cmap.getUnassignedPeptideIdentifications(), trafo,
-                              store_original_rt);
+      applyToConsensusFeature_(*cmit, rt_it, store_original_rt);
     }
+
+    // adapt RT values of unassigned peptides:
+    applyToPeptideIds_(cmap.getUnassignedPeptideIdentifications(), rt_it,
+                       store_original_rt);
   }
 
 
   void MapAlignmentTransformer::applyToConsensusFeature_(
-    ConsensusFeature& feature, const TransformationDescription& trafo,
+    ConsensusFeature& feature, vector<double>::const_iterator& rt_it,
     bool store_original_rt)
   {
-    applyToBaseFeature_(feature, trafo, store_original_rt);
+    applyToBaseFeature_(feature, rt_it, store_original_rt);
 
     // apply to grouped features (feature handles):
     for (ConsensusFeature::HandleSetType::const_iterator it = 
            feature.getFeatures().begin(); it != feature.getFeatures().end();
          ++it)
     {
-      double rt = it->getRT();
-      it->asMutable().setRT(trafo.apply(rt));
+      it->asMutable().setRT(*rt_it++);
     }
   }
 
@@ -197,15 +284,28 @@ namespace OpenMS
   void MapAlignmentTransformer::transformRetentionTimes(
     vector<PeptideIdentification>& pep_ids, 
     const TransformationDescription& trafo, bool store_original_rt)
+  {
+    vector<double> rts;
+    rts.reserve(pep_ids.size());
+    collectRTs_(pep_ids, rts);
+    trafo.apply(rts, rts);
+
+    vector<double>::const_iterator rt_it = rts.begin();
+    applyToPeptideIds_(pep_ids, rt_it, store_original_rt);
+  }
+
+
+  void MapAlignmentTransformer::applyToPeptideIds_(
+    vector<PeptideIdentification>& pep_ids,
+    vector<double>::const_iterator& rt_it, bool store_original_rt)
   {
     for (vector<PeptideIdentification>::iterator pep_it = pep_ids.begin(); 
          pep_it != pep_ids.end(); ++pep_it)
     {
       if (pep_it->hasRT())
       {
-        double rt = pep_it->getRT();
-        if (store_original_rt) storeOriginalRT_(*pep_it, rt);
-        pep_it->setRT(trafo.apply(rt));
+        if (store_original_rt) storeOriginalRT_(*pep_it, pep_it->getRT());
+        pep_it->setRT(*rt_it++);
       }
     }
   }
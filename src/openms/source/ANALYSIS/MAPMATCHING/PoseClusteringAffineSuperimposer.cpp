@@ -133,6 +133,15 @@ namespace OpenMS
     rt_high_hash_.setMapping(shift_bucket_size, rt_buckets_num_half, rt_high);
   }
 
+  /// adds the bucket values of @p source to @p target (both with the same mapping)
+  void addHistogram(const Math::LinearInterpolation<double, double>& source, Math::LinearInterpolation<double, double>& target)
+  {
+    for (Size index = 0; index < source.getData().size(); ++index)
+    {
+      target.getData()[index] += source.getData()[index];
+    }
+  }
+
   /**
     @brief Estimates scaling by trying different (weighted) affine transformations.
 
@@ -176,135 +185,190 @@ namespace OpenMS
       dump_pairs_file << "#" << ' ' << "i" << ' ' << "j" << ' ' << "k" << ' ' << "l" << ' ' << std::endl;
     }
 
-    // first point in model map (i)
-    for (Size i = 0, i_low = 0, i_high = 0, k_low = 0, k_high = 0; i < model_map_size - 1; ++i)
+    if (model_map_size < 2)
+    {
+      return;
+    }
+
+    // The points i of the model map are split into a fixed number of
+    // contiguous blocks which are hashed in parallel into separate histograms.
+    // These are added up in the order of the blocks afterwards, so the result
+    // does not depend on the number of threads. (The pairs are dumped in
+    // order, so blocks are processed serially in that case.)
+    typedef Math::LinearInterpolation<double, double> LinearInterpolationType;
+    const Size nr_points = model_map_size - 1;
+    const Size nr_blocks = std::min(nr_points, Size(64));
+    std::vector<LinearInterpolationType> block_scaling_hash_1, block_scaling_hash_2, block_rt_low_hash, block_rt_high_hash;
+    if (hashing_round == 1)
+    {
+      block_scaling_hash_1.resize(nr_blocks, scaling_hash_1);
+      for (Size b = 0; b < nr_blocks; ++b)
+      {
+        std::fill(block_scaling_hash_1[b].getData().begin(), block_scaling_hash_1[b].getData().end(), 0.0);
+      }
+    }
+    else
+    {
+      block_scaling_hash_2.resize(nr_blocks, scaling_hash_2);
+      block_rt_low_hash.resize(nr_blocks, rt_low_hash_);
+      block_rt_high_hash.resize(nr_blocks, rt_high_hash_);
+      for (Size b = 0; b < nr_blocks; ++b)
+      {
+        std::fill(block_scaling_hash_2[b].getData().begin(), block_scaling_hash_2[b].getData().end(), 0.0);
+        std::fill(block_rt_low_hash[b].getData().begin(), block_rt_low_hash[b].getData().end(), 0.0);
+        std::fill(block_rt_high_hash[b].getData().begin(), block_rt_high_hash[b].getData().end(), 0.0);
+      }
+    }
+
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic, 1) if (!do_dump_pairs)
+#endif
+    for (SignedSize block = 0; block < (SignedSize)nr_blocks; ++block)
     {
-      // Adjust window around i in model map (get all features in a m/z range of item i in the model map)
-      while (i_low < model_map_size && model_map[i_low].getMZ() < model_map[i].getMZ() - mz_pair_max_distance)
-        ++i_low;
-      while (i_high < model_map_size && model_map[i_high].getMZ() <= model_map[i].getMZ() + mz_pair_max_distance)
-        ++i_high;
-      // stop if there are too many features are in our window
-      double i_winlength_factor = 1. / (i_high - i_low);
-      i_winlength_factor -= winlength_factor_baseline;
-      if (i_winlength_factor <= 0)
-        continue;
-
-      // Adjust window around k in scene map (get all features in a m/z range of item i in the scene map)
-      while (k_low < scene_map_size && scene_map[k_low].getMZ() < model_map[i].getMZ() - mz_pair_max_distance)
-        ++k_low;
-      while (k_high < scene_map_size && scene_map[k_high].getMZ() <= model_map[i].getMZ() + mz_pair_max_distance)
-        ++k_high;
-
-      // Iterate through all matching features in the scene map that are
-      // within the m/z distance of item i from the model map.
-      // first point in scene map (k)
-      for (Size k = k_low; k < k_high; ++k)
+      const Size block_begin = nr_points * block / nr_blocks;
+      const Size block_end = nr_points * (block + 1) / nr_blocks;
+
+      // first point in model map (i)
+      for (Size i = block_begin; i < block_end; ++i)
       {
+        // Adjust window around i in model map (get all features in a m/z range of item i in the model map)
+        const Size i_low = std::lower_bound(model_map.begin(), model_map.end(), model_map[i].getMZ() - mz_pair_max_distance, Peak2D::MZLess()) - model_map.begin();
+        const Size i_high = std::upper_bound(model_map.begin(), model_map.end(), model_map[i].getMZ() + mz_pair_max_distance, Peak2D::MZLess()) - model_map.begin();
         // stop if there are too many features are in our window
-        double k_winlength_factor = 1. / (k_high - k_low);
-        k_winlength_factor -= winlength_factor_baseline;
-        if (k_winlength_factor <= 0)
+        double i_winlength_factor = 1. / (i_high - i_low);
+        i_winlength_factor -= winlength_factor_baseline;
+        if (i_winlength_factor <= 0)
           continue;
 
-        // compute similarity of intensities i k by taking the ratio of the two intensities
-        double similarity_ik;
-        {
-          const double int_i = model_map[i].getIntensity();
-          const double int_k = scene_map[k].getIntensity() * total_intensity_ratio;
-          similarity_ik = (int_i < int_k) ? int_i / int_k : int_k / int_i;
-          // weight is inverse proportional to number of elements with similar mz
-          similarity_ik *= i_winlength_factor;
-          similarity_ik *= k_winlength_factor;
-        }
+        // Adjust window around k in scene map (get all features in a m/z range of item i in the scene map)
+        const Size k_low = std::lower_bound(scene_map.begin(), scene_map.end(), model_map[i].getMZ() - mz_pair_max_distance, Peak2D::MZLess()) - scene_map.begin();
+        const Size k_high = std::upper_bound(scene_map.begin(), scene_map.end(), model_map[i].getMZ() + mz_pair_max_distance, Peak2D::MZLess()) - scene_map.begin();
 
-        // second point in model map (j)
-        for (Size j = i + 1, j_low = i_low, j_high = i_low, l_low = k_low, l_high = k_high; j < model_map_size; ++j)
+        // Iterate through all matching features in the scene map that are
+        // within the m/z distance of item i from the model map.
+        // first point in scene map (k)
+        for (Size k = k_low; k < k_high; ++k)
         {
-          // diff in model map -> skip features that are too far away in RT
-          double diff_model = model_map[j].getRT() - model_map[i].getRT();
-          if (fabs(diff_model) < rt_pair_min_distance)
+          // stop if there are too many features are in our window
+          double k_winlength_factor = 1. / (k_high - k_low);
+          k_winlength_factor -= winlength_factor_baseline;
+          if (k_winlength_factor <= 0)
             continue;
 
-          // Adjust window around j in model map
-          while (j_low < model_map_size && model_map[j_low].getMZ() < model_map[i].getMZ() - mz_pair_max_distance)
-            ++j_low;
-          while (j_high < model_map_size && model_map[j_high].getMZ() <= model_map[i].getMZ() + mz_pair_max_distance)
-            ++j_high;
-          double j_winlength_factor = 1. / (j_high - j_low);
-          j_winlength_factor -= winlength_factor_baseline;
-          if (j_winlength_factor <= 0)
-            continue;
-
-          // Adjust window around l in scene map
-          while (l_low < scene_map_size && scene_map[l_low].getMZ() < model_map[j].getMZ() - mz_pair_max_distance)
-            ++l_low;
-          while (l_high < scene_map_size && scene_map[l_high].getMZ() <= model_map[j].getMZ() + mz_pair_max_distance)
-            ++l_high;
+          // compute similarity of intensities i k by taking the ratio of the two intensities
+          double similarity_ik;
+          {
+            const double int_i = model_map[i].getIntensity();
+            const double int_k = scene_map[k].getIntensity() * total_intensity_ratio;
+            similarity_ik = (int_i < int_k) ? int_i / int_k : int_k / int_i;
+            // weight is inverse proportional to number of elements with similar mz
+            similarity_ik *= i_winlength_factor;
+            similarity_ik *= k_winlength_factor;
+          }
 
-          // second point in scene map (l)
-          for (Size l = l_low; l < l_high; ++l)
+          // second point in model map (j)
+          for (Size j = i + 1, j_low = i_low, j_high = i_low, l_low = k_low, l_high = k_high; j < model_map_size; ++j)
           {
-            double l_winlength_factor = 1. / (l_high - l_low);
-            l_winlength_factor -= winlength_factor_baseline;
-            if (l_winlength_factor <= 0)
+            // diff in model map -> skip features that are too far away in RT
+            double diff_model = model_map[j].getRT() - model_map[i].getRT();
+            if (fabs(diff_model) < rt_pair_min_distance)
               continue;
 
-            // diff in scene map -> skip features that are too far away in RT
-            double diff_scene = scene_map[l].getRT() - scene_map[k].getRT();
-
-            // avoid cross mappings (i,j) -> (k,l) (e.g. i_rt < j_rt and k_rt > l_rt)
-            // and point pairs with equal retention times (e.g. i_rt == j_rt)
-            if (fabs(diff_scene) < rt_pair_min_distance || ((diff_model > 0) != (diff_scene > 0)))
+            // Adjust window around j in model map
+            while (j_low < model_map_size && model_map[j_low].getMZ() < model_map[i].getMZ() - mz_pair_max_distance)
+              ++j_low;
+            while (j_high < model_map_size && model_map[j_high].getMZ() <= model_map[i].getMZ() + mz_pair_max_distance)
+              ++j_high;
+            double j_winlength_factor = 1. / (j_high - j_low);
+            j_winlength_factor -= winlength_factor_baseline;
+            if (j_winlength_factor <= 0)
               continue;
 
-            // compute the transformation (i,j) -> (k,l)
-            double scaling = diff_model / diff_scene;
-            double shift = model_map[i].getRT() - scene_map[k].getRT() * scaling;
+            // Adjust window around l in scene map
+            while (l_low < scene_map_size && scene_map[l_low].getMZ() < model_map[j].getMZ() - mz_pair_max_distance)
+              ++l_low;
+            while (l_high < scene_map_size && scene_map[l_high].getMZ() <= model_map[j].getMZ() + mz_pair_max_distance)
+              ++l_high;
 
-            // compute similarity of intensities i k j l
-            double similarity_ik_jl;
-            {
-              // compute similarity of intensities j l
-              const double int_j = model_map[j].getIntensity();
-              const double int_l = scene_map[l].getIntensity() * total_intensity_ratio;
-              double similarity_jl = (int_j < int_l) ? int_j / int_l : int_l / int_j;
-              // weight is inverse proportional to number of elements with similar mz
-              similarity_jl *= j_winlength_factor;
-              similarity_jl *= l_winlength_factor;
-              similarity_ik_jl = similarity_ik * similarity_jl;
-            }
-
-            // hash the images of scaling, rt_low and rt_high into their respective hash tables
-            // store the scaling parameter and the (estimated) transformation of start/end of the maps in hashes
-            //   -> in round 2, discard values outside of scale_low_1 and
-            //   scale_high_1 (estimated before in scalingEstimate)
-            if (hashing_round == 1)
+            // second point in scene map (l)
+            for (Size l = l_low; l < l_high; ++l)
             {
-              // hashing round 1 (estimate the scaling only)
-              scaling_hash_1.addValue(log(scaling), similarity_ik_jl);
-            }
-            else if (scaling >= scale_low_1 && scaling <= scale_high_1)
-            {
-              // hashing round 2 (estimate scaling and shift)
-              scaling_hash_2.addValue(log(scaling), similarity_ik_jl);
+              double l_winlength_factor = 1. / (l_high - l_low);
+              l_winlength_factor -= winlength_factor_baseline;
+              if (l_winlength_factor <= 0)
+                continue;
+
+              // diff in scene map -> skip features that are too far away in RT
+              double diff_scene = scene_map[l].getRT() - scene_map[k].getRT();
+
+              // avoid cross mappings (i,j) -> (k,l) (e.g. i_rt < j_rt and k_rt > l_rt)
+              // and point pairs with equal retention times (e.g. i_rt == j_rt)
+              if (fabs(diff_scene) < rt_pair_min_distance || ((diff_model > 0) != (diff_scene > 0)))
+                continue;
 
-              const double rt_low_image = shift + rt_low * scaling;
-              rt_low_hash_.addValue(rt_low_image, similarity_ik_jl);
-              const double rt_high_image = shift + rt_high * scaling;
-              rt_high_hash_.addValue(rt_high_image, similarity_ik_jl);
+              // compute the transformation (i,j) -> (k,l)
+              double scaling = diff_model / diff_scene;
+              double shift = model_map[i].getRT() - scene_map[k].getRT() * scaling;
 
-              if (do_dump_pairs)
+              // compute similarity of intensities i k j l
+              double similarity_ik_jl;
               {
-                dump_pairs_file << i << ' ' << model_map[i].getRT() << ' ' << model_map[i].getMZ() << ' ' << j << ' ' << model_map[j].getRT() << ' '
-                                << model_map[j].getMZ() << ' ' << k << ' ' << scene_map[k].getRT() << ' ' << scene_map[k].getMZ() << ' ' << l << ' '
-                                << scene_map[l].getRT() << ' ' << scene_map[l].getMZ() << ' ' << similarity_ik_jl << ' ' << std::endl;
+                // compute similarity of intensities j l
+                const double int_j = model_map[j].getIntensity();
+                const double int_l = scene_map[l].getIntensity() * total_intensity_ratio;
+                double similarity_jl = (int_j < int_l) ? int_j / int_l : int_l / int_j;
+                // weight is inverse proportional to number of elements with similar mz
+                similarity_jl *= j_winlength_factor;
+                similarity_jl *= l_winlength_factor;
+                similarity_ik_jl = similarity_ik * similarity_jl;
               }
-            }
-          }   // l
-        }   // j
-      }   // k
-    }   // i
+
+              // hash the images of scaling, rt_low and rt_high into their respective hash tables
+              // store the scaling parameter and the (estimated) transformation of start/end of the maps in hashes
+              //   -> in round 2, discard values outside of scale_low_1 and
+              //   scale_high_1 (estimated before in scalingEstimate)
+              if (hashing_round == 1)
+              {
+                // hashing round 1 (estimate the scaling only)
+                block_scaling_hash_1[block].addValue(log(scaling), similarity_ik_jl);
+              }
+              else if (scaling >= scale_low_1 && scaling <= scale_high_1)
+              {
+                // hashing round 2 (estimate scaling and shift)
+                block_scaling_hash_2[block].addValue(log(scaling), similarity_ik_jl);
+
+                const double rt_low_image = shift + rt_low * scaling;
+                block_rt_low_hash[block].addValue(rt_low_image, similarity_ik_jl);
+                const double rt_high_image = shift + rt_high * scaling;
+                block_rt_high_hash[block].addValue(rt_high_image, similarity_ik_jl);
+
+                if (do_dump_pairs)
+                {
+                  dump_pairs_file << i << ' ' << model_map[i].getRT() << ' ' << model_map[i].getMZ() << ' ' << j << ' ' << model_map[j].getRT() << ' '
+                                  << model_map[j].getMZ() << ' ' << k << ' ' << scene_map[k].getRT() << ' ' << scene_map[k].getMZ() << ' ' << l << ' '
+                                  << scene_map[l].getRT() << ' ' << scene_map[l].getMZ() << ' ' << similarity_ik_jl << ' ' << std::endl;
+                }
+              }
+            }   // l
+          }   // j
+        }   // k
+      }   // i
+    }   // block
+
+    // add up the histograms of the blocks
+    for (Size b = 0; b < nr_blocks; ++b)
+    {
+      if (hashing_round == 1)
+      {
+        addHistogram(block_scaling_hash_1[b], scaling_hash_1);
+      }
+      else
+      {
+        addHistogram(block_scaling_hash_2[b], scaling_hash_2);
+        addHistogram(block_rt_low_hash[b], rt_low_hash_);
+        addHistogram(block_rt_high_hash[b], rt_high_hash_);
+      }
+    }
   }
 
   /**
@@ -732,6 +796,55 @@ namespace OpenMS
     return total_int_model_map / total_int_scene_map;
   }
 
+  void PoseClusteringAffineSuperimposer::prepareMap(const std::vector<Peak2D> & map,
+                                                    PreparedMap & prepared) const
+  {
+    prepared.points.clear();
+    prepared.min_rt = prepared.max_rt = 0.0;
+    if (map.empty())
+    {
+      return;
+    }
+
+    // take estimates of the minimal / maximal element from the full map
+    // possible improvement: use the truncated map which should be more
+    // reliable (one outlier of low intensity could derail the estimate)
+    prepared.min_rt = std::min_element(map.begin(), map.end(), Peak2D::RTLess())->getRT();
+    prepared.max_rt = std::max_element(map.begin(), map.end(), Peak2D::RTLess())->getRT();
+
+    // Select the most abundant data points only (use copy to truncate):
+    prepared.points = map;
+    const Size num_used_points = (Int) param_.getValue("num_used_points");
+
+    // sort the last data points by ascending intensity (from the right, using reverse iterators)
+    //  -> linear in complexity, should be faster than sorting and then taking cutoff
+    if (prepared.points.size() > num_used_points)
+    {
+      std::nth_element(prepared.points.rbegin(), prepared.points.rbegin() + (prepared.points.size() - num_used_points),
+          prepared.points.rend(), Peak2D::IntensityLess());
+      prepared.points.resize(num_used_points);
+    }
+
+    // sort by ascending m/z
+    std::sort(prepared.points.begin(), prepared.points.end(), Peak2D::MZLess());
+  }
+
+  void PoseClusteringAffineSuperimposer::prepareMap(const ConsensusMap & map,
+                                                    PreparedMap & prepared) const
+  {
+    std::vector<Peak2D> c_map;
+    c_map.reserve(map.size());
+    for (ConsensusMap::const_iterator it = map.begin(); it != map.end(); ++it)
+    {
+      Peak2D c;
+      c.setIntensity( it->getIntensity() );
+      c.setRT( it->getRT() );
+      c.setMZ( it->getMZ() );
+      c_map.push_back(c);
+    }
+    prepareMap(c_map, prepared);
+  }
+
   void PoseClusteringAffineSuperimposer::run(const std::vector<Peak2D> & map_model,
                                              const std::vector<Peak2D> & map_scene, 
                                              TransformationDescription & transformation)
@@ -743,6 +856,22 @@ namespace OpenMS
                                        "One of the input maps is empty! This is not allowed!");
     }
 
+    PreparedMap model, scene;
+    prepareMap(map_model, model);
+    prepareMap(map_scene, scene);
+    run(model, scene, transformation);
+  }
+
+  void PoseClusteringAffineSuperimposer::run(const PreparedMap & model,
+                                             const PreparedMap & scene,
+                                             TransformationDescription & transformation)
+  {
+    if (model.points.empty() || scene.points.empty())
+    {
+      throw Exception::IllegalArgument(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION,
+                                       "One of the input maps is empty! This is not allowed!");
+    }
+
     //**************************************************************************
     // Parameters
     //**************************************************************************
@@ -801,48 +930,19 @@ namespace OpenMS
     setProgress(++actual_progress);
 
     //**************************************************************************
-    // Step 1: Select the most abundant data points only.
+    // Step 1: Select the most abundant data points only (see prepareMap())
     //**************************************************************************
-    // use copy to truncate
-    std::vector<Peak2D> model_map(map_model);
-    std::vector<Peak2D> scene_map(map_scene);
-    {
-      // truncate the data as necessary
-      const Size num_used_points = (Int) param_.getValue("num_used_points");
-
-      // sort the last data points by ascending intensity (from the right, using reverse iterators)
-      //  -> linear in complexity, should be faster than sorting and then taking cutoff
-      if (model_map.size() > num_used_points)
-      {
-        std::nth_element(model_map.rbegin(), model_map.rbegin() + (model_map.size() - num_used_points),
-            model_map.rend(), Peak2D::IntensityLess());
-        model_map.resize(num_used_points);
-      }
-      setProgress(++actual_progress);
-      if (scene_map.size() > num_used_points)
-      {
-        std::nth_element(scene_map.rbegin(), scene_map.rbegin() + (scene_map.size() - num_used_points),
-            scene_map.rend(), Peak2D::IntensityLess());
-        scene_map.resize(num_used_points);
-      }
-      setProgress(++actual_progress);
-    }
-    // sort by ascending m/z
-    std::sort(model_map.begin(), model_map.end(), Peak2D::MZLess());
-    std::sort(scene_map.begin(), scene_map.end(), Peak2D::MZLess());
+    const std::vector<Peak2D> & model_map = model.points;
+    const std::vector<Peak2D> & scene_map = scene.points;
     setProgress((actual_progress = 10));
 
     //**************************************************************************
     // Preprocessing
     //**************************************************************************
-    // take estimates of the minimal / maximal element from both maps
-    // possible improvement: use the truncated map from above which should be
-    // more reliable (one outlier of low intensity could derail the estimate
-    // below)
-    const double model_minrt = std::min_element(map_model.begin(), map_model.end(), Peak2D::RTLess())->getRT();
-    const double scene_minrt = std::min_element(map_scene.begin(), map_scene.end(), Peak2D::RTLess())->getRT();
-    const double model_maxrt = std::max_element(map_model.begin(), map_model.end(), Peak2D::RTLess())->getRT();
-    const double scene_maxrt = std::max_element(map_scene.begin(), map_scene.end(), Peak2D::RTLess())->getRT();
+    const double model_minrt = model.min_rt;
+    const double scene_minrt = scene.min_rt;
+    const double model_maxrt = model.max_rt;
+    const double scene_maxrt = scene.max_rt;
     const double rt_low =  (model_minrt + scene_minrt) / 2.;
     const double rt_high = (model_maxrt + scene_maxrt) / 2.;
 
@@ -901,8 +1001,12 @@ namespace OpenMS
 
     // The serial number is incremented for each invocation of this, to avoid
     // overwriting of hash table dumps.
-    static Int dump_buckets_serial = 0;
-    ++dump_buckets_serial;
+    static Int dump_buckets_serial_counter = 0;
+    Int dump_buckets_serial;
+#ifdef _OPENMP
+#pragma omp critical (PoseClusteringAffineSuperimposer_dump_serial)
+#endif
+    dump_buckets_serial = ++dump_buckets_serial_counter;
 
     //**************************************************************************
     // Step 4: Hashing
@@ -1052,25 +1156,16 @@ namespace OpenMS
                                              const ConsensusMap& map_scene,
                                              TransformationDescription& transformation)
   {
-    std::vector<Peak2D> c_map_model, c_map_scene;
-    for (ConsensusMap::const_iterator it = map_model.begin(); it != map_model.end(); ++it)
-    {
-      Peak2D c;
-      c.setIntensity( it->getIntensity() );
-      c.setRT( it->getRT() );
-      c.setMZ( it->getMZ() );
-      c_map_model.push_back(c);
-    }
-    for (ConsensusMap::const_iterator it = map_scene.begin(); it != map_scene.end(); ++it)
+    if (map_model.empty() || map_scene.empty())
     {
-      Peak2D c;
-      c.setIntensity( it->getIntensity() );
-      c.setRT( it->getRT() );
-      c.setMZ( it->getMZ() );
-      c_map_scene.push_back(c);
+      throw Exception::IllegalArgument(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION,
+                                       "One of the input maps is empty! This is not allowed!");
     }
 
-    run(c_map_model, c_map_scene, transformation);
+    PreparedMap model, scene;
+    prepareMap(map_model, model);
+    prepareMap(map_scene, scene);
+    run(model, scene, transformation);
   }
 
 } // namespace OpenMS
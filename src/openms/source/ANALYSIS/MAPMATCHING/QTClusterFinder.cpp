@@ -37,6 +37,8 @@
 #include <OpenMS/METADATA/PeptideIdentification.h>
 #include <OpenMS/KERNEL/FeatureHandle.h>
 
+#include <algorithm>
+
 // #define DEBUG_QTCLUSTERFINDER
 
 using std::list;
@@ -185,13 +187,106 @@ namespace OpenMS
     }
   }
 
+  /// Indexed binary max-heap of cluster indices, ordered by quality (ties: lower index first)
+  class QTClusterFinder::ClusterQueue_
+  {
+public:
+    explicit ClusterQueue_(Size size) :
+      quality_(size, 0.0), position_(size, npos_)
+    {
+    }
+
+    bool empty() const
+    {
+      return heap_.empty();
+    }
+
+    /// Index of the best cluster
+    Size top() const
+    {
+      return heap_.front();
+    }
+
+    /// Inserts a cluster or updates its quality
+    void update(Size cluster, double quality)
+    {
+      quality_[cluster] = quality;
+      if (position_[cluster] == npos_)
+      {
+        position_[cluster] = heap_.size();
+        heap_.push_back(cluster);
+        siftUp_(position_[cluster]);
+      }
+      else
+      {
+        siftUp_(position_[cluster]);
+        siftDown_(position_[cluster]);
+      }
+    }
+
+    /// Removes a cluster (if it is in the queue)
+    void remove(Size cluster)
+    {
+      Size pos = position_[cluster];
+      if (pos == npos_) return;
+      position_[cluster] = npos_;
+      Size last = heap_.back();
+      heap_.pop_back();
+      if (pos == heap_.size()) return; // removed the last element
+      heap_[pos] = last;
+      position_[last] = pos;
+      siftUp_(pos);
+      siftDown_(position_[last]);
+    }
+
+private:
+    static const Size npos_ = Size(-1);
+
+    bool higher_(Size a, Size b) const
+    {
+      return (quality_[a] > quality_[b]) || ((quality_[a] == quality_[b]) && (a < b));
+    }
+
+    void swap_(Size i, Size j)
+    {
+      std::swap(heap_[i], heap_[j]);
+      position_[heap_[i]] = i;
+      position_[heap_[j]] = j;
+    }
+
+    void siftUp_(Size pos)
+    {
+      while (pos > 0)
+      {
+        Size parent = (pos - 1) / 2;
+        if (!higher_(heap_[pos], heap_[parent])) break;
+        swap_(pos, parent);
+        pos = parent;
+      }
+    }
+
+    void siftDown_(Size pos)
+    {
+      while (true)
+      {
+        Size best = pos, left = 2 * pos + 1, right = left + 1;
+        if (left < heap_.size() && higher_(heap_[left], heap_[best])) best = left;
+        if (right < heap_.size() && higher_(heap_[right], heap_[best])) best = right;
+        if (best == pos) break;
+        swap_(pos, best);
+        pos = best;
+      }
+    }
+
+    std::vector<Size> heap_;
+    std::vector<double> quality_;
+    std::vector<Size> position_;
+  };
+
   template <typename MapType>
   void QTClusterFinder::run_internal_(const vector<MapType>& input_maps,
                              ConsensusMap& result_map, bool do_progress)
   {
-    // clear temporary data structures
-    already_used_.clear();
-
     num_maps_ = input_maps.size();
     if (num_maps_ < 2)
     {
@@ -203,17 +298,20 @@ namespace OpenMS
     // for the current partition
     double max_intensity = 0.0;
     double max_mz = 0.0;
+    Size num_features = 0;
     for (typename vector<MapType>::const_iterator map_it = input_maps.begin(); 
          map_it != input_maps.end(); ++map_it)
     {
       max_intensity = max(max_intensity, map_it->getMaxInt());
       max_mz = max(max_mz, map_it->getMax().getY());
+      num_features += map_it->size();
     }
     setParameters_(max_intensity, max_mz);
 
-    // create the hash grid and fill it with features:
-    // std::cout << "Hashing..." << std::endl;
-    list<OpenMS::GridFeature> grid_features;
+    // create the hash grid and fill it with features (the storage is
+    // reserved up front, so pointers to the grid features stay valid):
+    vector<OpenMS::GridFeature> grid_features;
+    grid_features.reserve(num_features);
     Grid grid(Grid::ClusterCenter(max_diff_rt_, max_diff_mz_));
     for (Size map_index = 0; map_index < num_maps_; ++map_index)
     {
@@ -238,38 +336,18 @@ namespace OpenMS
     }
 
     // compute QT clustering:
-    // std::cout << "Clustering..." << std::endl;
-    list<QTCluster> clustering;
-    computeClustering_(grid, clustering);
+    vector<QTCluster> clustering;
+    Neighborhoods_ neighborhoods;
+    computeClustering_(grid, grid_features, clustering, neighborhoods);
     // number of clusters == number of data points:
     Size size = clustering.size();
 
-    // create a temp. map storing which grid features are next to which clusters
-    typedef OpenMSBoost::unordered_map<Size, std::vector<GridFeature*> > NeighborList;
-    ElementMapping element_mapping;
-    for (list<QTCluster>::iterator it = clustering.begin();
-         it != clustering.end(); ++it)
-    {
-      NeighborList neigh = it->getAllNeighbors();
-      for (NeighborList::iterator n_it = neigh.begin(); n_it != neigh.end(); ++n_it)
-      {
-        for (std::vector<GridFeature*>::iterator i_it = n_it->second.begin();
-            i_it != n_it->second.end(); ++i_it)
-        {
-          // remember for each feature (gridfeature) all the cluster elements
-          // it belongs to
-          element_mapping[*i_it].push_back(&(*it));
-        }
-      }
-    }
-
-    // ensure that all cluster centers are in the list
-    for (list<QTCluster>::iterator it = clustering.begin();
-         it != clustering.end(); ++it)
+    ClusterQueue_ queue(size);
+    for (Size i = 0; i < size; ++i)
     {
-      OpenMS::GridFeature* center_feature = it->getCenterPoint();
-      element_mapping[center_feature].push_back(&(*it));
+      queue.update(i, clustering[i].getQuality());
     }
+    vector<bool> used(size, false);
 
     ProgressLogger logger;
     Size progress = 0;
@@ -279,61 +357,44 @@ namespace OpenMS
       logger.startProgress(0, size, "linking features");
     }
 
-    while (!clustering.empty())
+    while (true)
     {
-      // std::cout << "Clusters: " << clustering.size() << std::endl;
       ConsensusFeature consensus_feature;
-      makeConsensusFeature_(clustering, consensus_feature, element_mapping, grid);
-      if (!clustering.empty())
+      if (!makeConsensusFeature_(clustering, consensus_feature, queue, neighborhoods, used))
       {
-        result_map.push_back(consensus_feature);
+        break;
       }
+      result_map.push_back(consensus_feature);
       if (do_progress) logger.setProgress(progress++);
     }
 
     if (do_progress) logger.endProgress();
   }
 
-  void QTClusterFinder::makeConsensusFeature_(list<QTCluster>& clustering,
+  bool QTClusterFinder::makeConsensusFeature_(vector<QTCluster>& clustering,
                                               ConsensusFeature& feature,
-                                              ElementMapping& element_mapping,
-                                              Grid& grid)
+                                              ClusterQueue_& queue,
+                                              const Neighborhoods_& neighborhoods,
+                                              vector<bool>& used)
   {
-    // find the best cluster (a valid cluster with the highest score)
-    // -> this is equivalent to std::max_element but we can skip invalid clusters
-    list<QTCluster>::iterator best = clustering.begin();
-    while (best != clustering.end() && best->isInvalid()) // find start element
+    // no more clusters to process
+    if (queue.empty())
     {
-      ++best;
-    }
-    for (list<QTCluster>::iterator it = best;
-         it != clustering.end(); ++it)
-    {
-      if (!it->isInvalid())
-      {
-        if (it->getQuality() > best->getQuality())
-        {
-          best = it;
-        }
-      }
+      return false;
     }
 
-    // no more clusters to process -> clear clustering and return
-    if (best == clustering.end())
-    {
-      clustering.clear();
-      return;
-    }
+    // the best cluster (a valid cluster with the highest score)
+    QTCluster& best = clustering[queue.top()];
 
     OpenMSBoost::unordered_map<Size, OpenMS::GridFeature*> elements;
-    best->getElements(elements);
+    best.getElements(elements);
 #ifdef DEBUG_QTCLUSTERFINDER
     std::cout << "Elements: " << elements.size() << " with best "
-         << best->getQuality() << " invalid " << best->isInvalid() << std::endl;
+         << best.getQuality() << " invalid " << best.isInvalid() << std::endl;
 #endif
 
     // create consensus feature from best cluster:
-    feature.setQuality(best->getQuality());
+    feature.setQuality(best.getQuality());
     for (OpenMSBoost::unordered_map<Size, OpenMS::GridFeature*>::const_iterator
          it = elements.begin(); it != elements.end(); ++it)
     {
@@ -348,7 +409,7 @@ namespace OpenMS
     feature.computeConsensus();
 
 #ifdef DEBUG_QTCLUSTERFINDER
-    std::cout << " create new consensus feature " << feature.getRT() << " " << feature.getMZ() << " from " << best->getCenterPoint()->getFeature().getUniqueId() << std::endl;
+    std::cout << " create new consensus feature " << feature.getRT() << " " << feature.getMZ() << " from " << best.getCenterPoint()->getFeature().getUniqueId() << std::endl;
     for (OpenMSBoost::unordered_map<Size, OpenMS::GridFeature*>::const_iterator
          it = elements.begin(); it != elements.end(); ++it)
     {
@@ -356,166 +417,76 @@ namespace OpenMS
     }
 #endif
 
-    // Store the id of already used features (important: needs to be done
-    // before the large loop below)
+    // update the clustering:
+    // 1. mark the elements as used and invalidate the clusters they are the
+    //    center of (incl. the current "best" cluster)
+    // 2. update all clusters that may contain one of the elements by
+    //    removing used elements and adding the best remaining ones
+    vector<Size> element_indices;
     for (OpenMSBoost::unordered_map<Size, OpenMS::GridFeature*>::const_iterator
          it = elements.begin(); it != elements.end(); ++it)
     {
-      already_used_.insert(it->second);
+      Size index = neighborhoods.clusterIndex(it->second);
+      element_indices.push_back(index);
+      used[index] = true;
+      clustering[index].setInvalid();
+      queue.remove(index);
     }
 
-    // update the clustering:
-    // 1. remove current "best" cluster from list
-    // 2. update all clusters accordingly by removing already used elements
-    // 3. Invalidate elements whose central has been used already
-    best->setInvalid();
-    for (OpenMSBoost::unordered_map<Size, OpenMS::GridFeature*>::const_iterator
-        it = elements.begin(); it != elements.end(); ++it)
+    vector<Size> affected;
+    for (vector<Size>::const_iterator e_it = element_indices.begin(); e_it != element_indices.end(); ++e_it)
     {
-      // Identify all features that could potentially have been touched by this
-      //  Get all clusters that may potentially need updating
-
-      ElementMapping tmp_element_mapping; // modify copy, then update
-
-      for (std::vector<QTCluster*>::iterator
-           cluster  = element_mapping[&(*it->second)].begin();
-           cluster != element_mapping[&(*it->second)].end(); ++cluster)
+      for (Size k = neighborhoods.reverse_offsets[*e_it]; k < neighborhoods.reverse_offsets[*e_it + 1]; ++k)
       {
-        // we do not want to update invalid features (saves time and does not
+        Size cluster = neighborhoods.reverse[k];
+        // we do not want to update invalid clusters (saves time and does not
         // recompute the quality)
-        if (!(*cluster)->isInvalid())
-        {
-          // remove the elements of the new feature from the cluster
-          if ((*cluster)->update(elements))
-          {
-            // If update returns true, it means that at least one element was
-            // removed from the cluster and we need to update that cluster
-
-            // Get the coordinates of the current cluster
-            const Int x = (*cluster)->getXCoord(); 
-            const Int y = (*cluster)->getYCoord();
-
-            ////////////////////////////////////////
-            // Step 1: Iterate through all neighboring grid features and try to
-            // add elements to the current cluster to replace the ones we just
-            // removed
-            const OpenMS::GridFeature* center_feature = (*cluster)->getCenterPoint();
-            addClusterElements_(x, y, grid, (**cluster), center_feature);
-
-            ////////////////////////////////////////
-            // Step 2: update element_mapping as the best feature for each
-            // cluster may have changed
-            typedef OpenMSBoost::unordered_map<Size,
-                    std::vector<GridFeature*> > NeighborList;
-            NeighborList neigh = (*cluster)->getAllNeighbors();
-            for (NeighborList::iterator n_it = neigh.begin(); n_it != neigh.end(); ++n_it)
-            {
-              for (std::vector<GridFeature*>::iterator i_it =
-                  n_it->second.begin(); i_it != n_it->second.end(); ++i_it)
-              {
-                // remember for each feature (gridfeature) all the cluster
-                // elements it belongs to
-                tmp_element_mapping[*i_it].push_back(*cluster);
-              }
-            }
-          }
-        }
-      }
-
-      for (ElementMapping::iterator it = tmp_element_mapping.begin(); 
-          it != tmp_element_mapping.end(); ++it )
-      {
-        for (std::vector<QTCluster*>::iterator it2 = it->second.begin();
-            it2 != it->second.end(); ++it2)
-        {
-          element_mapping[ it->first ].push_back(*it2);
-        }
+        if (!clustering[cluster].isInvalid()) affected.push_back(cluster);
       }
     }
-  }
+    std::sort(affected.begin(), affected.end());
+    affected.erase(std::unique(affected.begin(), affected.end()), affected.end());
 
-  void QTClusterFinder::addClusterElements_(int x, int y, const Grid& grid, QTCluster& cluster,
-    const OpenMS::GridFeature* center_feature)
-  {
-    cluster.initializeCluster();
-
-#ifdef DEBUG_QTCLUSTERFINDER
-    std::cout << " Compute Clustering: "<< x << " " << y << " with id " << center_feature->getFeature().getUniqueId() << std::endl;
-    std::set<AASequence> a = cluster.getAnnotations();
-    std::cout << " with annotations: ";
-    for (std::set<AASequence>::iterator it = a.begin(); it != a.end(); ++it) std::cout << " " << *it;
-    std::cout << std::endl;
+    // the affected clusters are independent of each other:
+    vector<char> changed(affected.size(), false);
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic) if (affected.size() > 32)
 #endif
-
-
-    // iterate over neighboring grid cells (1st dimension):
-    for (int i = x - 1; i <= x + 1; ++i)
+    for (SignedSize i = 0; i < (SignedSize)affected.size(); ++i)
     {
-      // iterate over neighboring grid cells (2nd dimension):
-      for (int j = y - 1; j <= y + 1; ++j)
+      QTCluster& cluster = clustering[affected[i]];
+      // If update returns true, it means that at least one element was
+      // removed from the cluster and we need to update that cluster
+      if (cluster.update(elements))
       {
-        try
-        {
-          const Grid::CellContent& act_pos = grid.grid_at(Grid::CellIndex(i, j));
-
-          for (Grid::const_cell_iterator it_cell = act_pos.begin();
-               it_cell != act_pos.end(); ++it_cell)
-          {
-            OpenMS::GridFeature* neighbor_feature = it_cell->second;
-
-#ifdef DEBUG_QTCLUSTERFINDER
-            std::cout << " considering to add feature " << neighbor_feature->getFeature().getUniqueId() << " to cluster " <<  center_feature->getFeature().getUniqueId()<< std::endl;
-#endif
-
-            // Skip features that we have already used -> we cannot add them to
-            // be neighbors any more
-            if (already_used_.find(neighbor_feature) != already_used_.end() )
-            {
-              continue;
-            }
-
-            // consider only "real" neighbors, not the element itself:
-            if (center_feature != neighbor_feature)
-            {
-              // NOTE: this actually caches the distance -> memory problem
-              double dist = getDistance_(center_feature, neighbor_feature);
-
-              if (dist == FeatureDistance::infinity)
-              {
-                continue; // conditions not satisfied
-              }
-              // if neighbor point is a possible cluster point, add it:
-              cluster.add(neighbor_feature, dist);
-            }
-          }
-        }
-        catch (std::out_of_range&)
-        {
-        }
+        fillCluster_(cluster, affected[i], neighborhoods, used);
+        changed[i] = true;
       }
     }
 
-    cluster.finalizeCluster();
-
-#ifdef DEBUG_QTCLUSTERFINDER
-    OpenMSBoost::unordered_map<Size, OpenMS::GridFeature*> elements;
-    cluster.getElements(elements);
-    std::cout << " Done with cluster -> get quality " << cluster.getQuality() << " and nr elements " << elements.size() << std::endl;
-    for (OpenMSBoost::unordered_map<Size, OpenMS::GridFeature*>::const_iterator
-         it = elements.begin(); it != elements.end(); ++it)
+    for (Size i = 0; i < affected.size(); ++i)
     {
-      std::cout << "   = element id : " << it->second->getFeature().getUniqueId() << std::endl;
+      if (changed[i]) queue.update(affected[i], clustering[affected[i]].getQuality());
     }
+    return true;
+  }
+
+  void QTClusterFinder::fillCluster_(QTCluster& cluster, Size cluster_index,
+                                     const Neighborhoods_& neighborhoods,
+                                     const vector<bool>& used) const
+  {
+    cluster.initializeCluster();
 
+    for (Size k = neighborhoods.offsets[cluster_index]; k < neighborhoods.offsets[cluster_index + 1]; ++k)
     {
-      std::set<AASequence> a = cluster.getAnnotations();
-      std::cout << " FINAL with annotations: ";
-      for (std::set<AASequence>::iterator it = a.begin(); it != a.end(); ++it) std::cout << " " << *it;
-      std::cout << std::endl;
+      // Skip features that we have already used -> we cannot add them to
+      // be neighbors any more
+      Size neighbor = neighborhoods.neighbors[k];
+      if (used[neighbor]) continue;
+      cluster.add(neighborhoods.features[neighbor], neighborhoods.distances[k]);
     }
-#endif
-
 
+    cluster.finalizeCluster();
   }
 
   void QTClusterFinder::run(const vector<ConsensusMap>& input_maps,
@@ -530,36 +501,126 @@ namespace OpenMS
     run_(input_maps, result_map);
   }
 
-  void QTClusterFinder::computeClustering_(Grid& grid,
-                                           list<QTCluster>& clustering)
+  void QTClusterFinder::computeClustering_(const Grid& grid,
+                                           const vector<OpenMS::GridFeature>& grid_features,
+                                           vector<QTCluster>& clustering,
+                                           Neighborhoods_& neighborhoods)
   {
     clustering.clear();
-    already_used_.clear();
 
     // FeatureDistance produces normalized distances (between 0 and 1):
     const double max_distance = 1.0;
 
-    // iterate over all grid cells:
-    for (Grid::iterator it = grid.begin(); it != grid.end(); ++it)
+    // create one cluster per grid feature (in the order of the grid):
+    Size size = grid_features.size();
+    clustering.reserve(size);
+    neighborhoods.features.clear();
+    neighborhoods.features.reserve(size);
+    neighborhoods.first_feature = grid_features.empty() ? nullptr : &grid_features[0];
+    neighborhoods.cluster_index.assign(size, 0);
+    for (Grid::const_iterator it = grid.begin(); it != grid.end(); ++it)
     {
       const Grid::CellIndex& act_coords = it.index();
       const Int x = act_coords[0], y = act_coords[1];
 
       OpenMS::GridFeature* center_feature = it->second;
-      QTCluster cluster(center_feature, num_maps_, max_distance, use_IDs_, x, y);
+      neighborhoods.cluster_index[center_feature - neighborhoods.first_feature] = clustering.size();
+      neighborhoods.features.push_back(center_feature);
+      clustering.push_back(QTCluster(center_feature, num_maps_, max_distance, use_IDs_, x, y));
+    }
+
+    // collect the neighborhood of each cluster center: all features in
+    // neighboring grid cells that satisfy the distance constraints
+    vector<vector<std::pair<Size, double> > > rows(size);
+#ifdef _OPENMP
+#pragma omp parallel
+#endif
+    {
+      // the distance functor is not thread-safe (it caches normalization factors)
+      FeatureDistance feature_distance(feature_distance_);
+#ifdef _OPENMP
+#pragma omp for schedule(dynamic, 100)
+#endif
+      for (SignedSize c = 0; c < (SignedSize)size; ++c)
+      {
+        const QTCluster& cluster = clustering[c];
+        const OpenMS::GridFeature* center_feature = neighborhoods.features[c];
+        const Int x = cluster.getXCoord(), y = cluster.getYCoord();
+        // iterate over neighboring grid cells (1st dimension):
+        for (int i = x - 1; i <= x + 1; ++i)
+        {
+          // iterate over neighboring grid cells (2nd dimension):
+          for (int j = y - 1; j <= y + 1; ++j)
+          {
+            try
+            {
+              const Grid::CellContent& act_pos = grid.grid_at(Grid::CellIndex(i, j));
 
-      addClusterElements_(x, y, grid, cluster, center_feature);
+              for (Grid::const_cell_iterator it_cell = act_pos.begin();
+                   it_cell != act_pos.end(); ++it_cell)
+              {
+                OpenMS::GridFeature* neighbor_feature = it_cell->second;
+                // consider only "real" neighbors, not the element itself:
+                if (center_feature == neighbor_feature) continue;
+
+                double dist = feature_distance(center_feature->getFeature(), neighbor_feature->getFeature()).second;
+                if (dist == FeatureDistance::infinity)
+                {
+                  continue; // conditions not satisfied
+                }
+                rows[c].push_back(make_pair(neighborhoods.clusterIndex(neighbor_feature), dist));
+              }
+            }
+            catch (std::out_of_range&)
+            {
+            }
+          }
+        }
+      }
+    }
 
-      clustering.push_back(cluster);
+    // flatten the neighborhoods and build the reverse mapping
+    neighborhoods.offsets.assign(size + 1, 0);
+    neighborhoods.reverse_offsets.assign(size + 1, 0);
+    for (Size c = 0; c < size; ++c)
+    {
+      neighborhoods.offsets[c + 1] = neighborhoods.offsets[c] + rows[c].size();
+      for (Size k = 0; k < rows[c].size(); ++k)
+      {
+        ++neighborhoods.reverse_offsets[rows[c][k].first + 1];
+      }
+    }
+    for (Size c = 0; c < size; ++c)
+    {
+      neighborhoods.reverse_offsets[c + 1] += neighborhoods.reverse_offsets[c];
+    }
+    Size num_entries = neighborhoods.offsets[size];
+    neighborhoods.neighbors.resize(num_entries);
+    neighborhoods.distances.resize(num_entries);
+    neighborhoods.reverse.resize(num_entries);
+    vector<Size> reverse_pos(neighborhoods.reverse_offsets.begin(), neighborhoods.reverse_offsets.end() - 1);
+    for (Size c = 0; c < size; ++c)
+    {
+      Size pos = neighborhoods.offsets[c];
+      for (Size k = 0; k < rows[c].size(); ++k, ++pos)
+      {
+        neighborhoods.neighbors[pos] = rows[c][k].first;
+        neighborhoods.distances[pos] = rows[c][k].second;
+        neighborhoods.reverse[reverse_pos[rows[c][k].first]++] = c;
+      }
+      vector<std::pair<Size, double> >().swap(rows[c]);
     }
-  }
 
-  double QTClusterFinder::getDistance_(const OpenMS::GridFeature* left,
-                                       const OpenMS::GridFeature* right)
-  {
-    return feature_distance_(left->getFeature(), right->getFeature()).second;
+    // compute the initial clusters (independent of each other):
+    vector<bool> used(size, false);
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic, 100)
+#endif
+    for (SignedSize c = 0; c < (SignedSize)size; ++c)
+    {
+      fillCluster_(clustering[c], c, neighborhoods, used);
+    }
   }
-  
 
   QTClusterFinder::~QTClusterFinder()
   {
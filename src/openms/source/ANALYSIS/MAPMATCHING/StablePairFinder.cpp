@@ -122,54 +122,58 @@ namespace OpenMS
     // TODO: iterate over SENSIBLE RT (and m/z) window -- sort the maps beforehand
     //       to save a lot of processing time...
     //       Once done, remove the warning in the description of the 'use_identifications' parameter
-    for (UInt fi0 = 0; fi0 < input_maps[0].size(); ++fi0)
+    //
+    // The distances are computed in parallel for blocks of features of map 0
+    // and stored in a flat buffer (rows: map 0, columns: map 1). The entries
+    // of map 0 are updated per row, those of map 1 per column in the order of
+    // map 0, so the result is the same as for the serial pairwise iteration.
+    const Size size0 = input_maps[0].size(), size1 = input_maps[1].size();
+    const Size block_rows = std::max(Size(1), std::min(size0, Size(1 << 20) / std::max(size1, Size(1))));
+    vector<pair<bool, double> > distances(block_rows * size1);
+    for (Size block_begin = 0; block_begin < size0; block_begin += block_rows)
     {
-      const ConsensusFeature& feat0 = input_maps[0][fi0];
-
-      for (UInt fi1 = 0; fi1 < input_maps[1].size(); ++fi1)
+      const Size block_end = std::min(size0, block_begin + block_rows);
+#ifdef _OPENMP
+#pragma omp parallel
+#endif
       {
-        const ConsensusFeature& feat1 = input_maps[1][fi1];
-
-        if (use_IDs_ && !compatibleIDs_(feat0, feat1)) // check peptide IDs
-        {
-          continue; // mismatch
-        }
-
-        pair<bool, double> result = feature_distance(feat0, feat1);
-        double distance = result.second;
-        // we only care if distance constraints are satisfied for "best
-        // matches", not for second-best; this means that second-best distances
-        // can become smaller than best distances
-        // (e.g. the RT is larger than allowed (->invalid pair), but m/z is perfect and has the most weight --> better score!)
-        bool valid = result.first;
-
-        // update entries for map 0:
-        if (distance < nn_distance_0[fi0].second)
+        // FeatureDistance changes its state for ppm tolerances -> one copy per thread
+        FeatureDistance local_distance(feature_distance);
+#ifdef _OPENMP
+#pragma omp for schedule(dynamic)
+#endif
+        for (SignedSize fi0 = block_begin; fi0 < (SignedSize)block_end; ++fi0)
         {
-          if (valid && (distance < nn_distance_0[fi0].first))
+          const ConsensusFeature& feat0 = input_maps[0][fi0];
+          pair<bool, double>* row = &distances[(fi0 - block_begin) * size1];
+          for (UInt fi1 = 0; fi1 < size1; ++fi1)
           {
-            nn_distance_0[fi0].second = nn_distance_0[fi0].first;
-            nn_distance_0[fi0].first = distance;
-            nn_index_0[fi0] = fi1;
+            const ConsensusFeature& feat1 = input_maps[1][fi1];
+            if (use_IDs_ && !compatibleIDs_(feat0, feat1)) // check peptide IDs
+            {
+              row[fi1] = make_pair(false, FeatureDistance::infinity); // mismatch, never updates an entry
+              continue;
+            }
+            row[fi1] = local_distance(feat0, feat1);
           }
-          else
+
+          // update entries for map 0:
+          for (UInt fi1 = 0; fi1 < size1; ++fi1)
           {
-            nn_distance_0[fi0].second = distance;
+            updateNeighbors_(row[fi1], fi1, nn_index_0[fi0], nn_distance_0[fi0]);
           }
         }
-        // update entries for map 1:
-        if (distance < nn_distance_1[fi1].second)
+      }
+
+      // update entries for map 1:
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static)
+#endif
+      for (SignedSize fi1 = 0; fi1 < (SignedSize)size1; ++fi1)
+      {
+        for (UInt fi0 = block_begin; fi0 < block_end; ++fi0)
         {
-          if (valid && (distance < nn_distance_1[fi1].first))
-          {
-            nn_distance_1[fi1].second = nn_distance_1[fi1].first;
-            nn_distance_1[fi1].first = distance;
-            nn_index_1[fi1] = fi0;
-          }
-          else
-          {
-            nn_distance_1[fi1].second = distance;
-          }
+          updateNeighbors_(distances[(fi0 - block_begin) * size1 + fi1], fi0, nn_index_1[fi1], nn_distance_1[fi1]);
         }
       }
     }
@@ -254,6 +258,30 @@ namespace OpenMS
     // FeatureGroupingAlgorithm!
   }
 
+  void StablePairFinder::updateNeighbors_(const pair<bool, double>& result, UInt index, UInt& nn_index, pair<double, double>& nn_distance)
+  {
+    double distance = result.second;
+    // we only care if distance constraints are satisfied for "best
+    // matches", not for second-best; this means that second-best distances
+    // can become smaller than best distances
+    // (e.g. the RT is larger than allowed (->invalid pair), but m/z is perfect and has the most weight --> better score!)
+    bool valid = result.first;
+
+    if (distance < nn_distance.second)
+    {
+      if (valid && (distance < nn_distance.first))
+      {
+        nn_distance.second = nn_distance.first;
+        nn_distance.first = distance;
+        nn_index = index;
+      }
+      else
+      {
+        nn_distance.second = distance;
+      }
+    }
+  }
+
   bool StablePairFinder::compatibleIDs_(const ConsensusFeature& feat1, const ConsensusFeature& feat2) const
   {
     // a feature without identifications always matches:
@@ -133,6 +133,11 @@ namespace OpenMS
     return model_->evaluate(value);
   }
 
+  void TransformationDescription::apply(const std::vector<double>& values, std::vector<double>& results) const
+  {
+    model_->evaluateBatch(values, results);
+  }
+
   const String& TransformationDescription::getModelType() const
   {
     return model_type_;
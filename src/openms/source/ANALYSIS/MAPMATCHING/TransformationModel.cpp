@@ -88,6 +88,19 @@ namespace OpenMS
     return value;
   }
 
+  void TransformationModel::evaluateBatch(const std::vector<double>& values, std::vector<double>& results) const
+  {
+    results.resize(values.size());
+    const SignedSize n = static_cast<SignedSize>(values.size());
+#ifdef _OPENMP
+#pragma omp parallel for if (n > 10000)
+#endif
+    for (SignedSize i = 0; i < n; ++i)
+    {
+      results[i] = evaluate(values[i]);
+    }
+  }
+
   const Param& TransformationModel::getParameters() const
   {
     return params_;
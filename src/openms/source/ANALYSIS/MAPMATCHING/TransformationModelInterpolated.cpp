@@ -37,6 +37,7 @@
 // Spline2dInterpolator
 #include <OpenMS/MATH/MISC/CubicSpline2d.h>
 
+#include <algorithm>
 #include <numeric>
 
 // AkimaInterpolator
@@ -71,6 +72,11 @@ public:
       return spline_->eval(x);
     }
 
+    double evalInInterval(const double& x, Size index) const override
+    {
+      return spline_->eval(x, index);
+    }
+
     ~Spline2dInterpolator() override
     {
       delete spline_;
@@ -163,6 +169,21 @@ public:
       }
     }
 
+    double evalInInterval(const double& x, Size index) const override
+    {
+      // same result as eval(), which returns the last point exactly
+      if (x >= x_.back())
+      {
+        return y_.back();
+      }
+      const double x_0 = x_[index];
+      const double x_1 = x_[index + 1];
+      const double y_0 = y_[index];
+      const double y_1 = y_[index + 1];
+
+      return y_0 + (y_1 - y_0) * (x - x_0) / (x_1 - x_0);
+    }
+
     ~LinearInterpolator() override
     {
     }
@@ -296,6 +317,60 @@ private:
     return interp_->eval(value);
   }
 
+  void TransformationModelInterpolated::evaluateBatch(const std::vector<double>& values, std::vector<double>& results) const
+  {
+    results.resize(values.size());
+    const SignedSize n = static_cast<SignedSize>(values.size());
+    const SignedSize block_size = 4096;
+    const SignedSize nr_blocks = (n + block_size - 1) / block_size;
+    const Size last_interval = x_.size() - 2; // we have at least 3 points
+
+#ifdef _OPENMP
+#pragma omp parallel for if (nr_blocks > 2)
+#endif
+    for (SignedSize block = 0; block < nr_blocks; ++block)
+    {
+      const SignedSize block_end = std::min(n, (block + 1) * block_size);
+      Size interval = 0; // x_[interval] <= value < x_[interval + 1] for the previous interpolated value
+      for (SignedSize i = block * block_size; i < block_end; ++i)
+      {
+        const double value = values[i];
+        if (value < x_.front()) // extrapolate front
+        {
+          results[i] = lm_front_->evaluate(value);
+          continue;
+        }
+        if (value > x_.back()) // extrapolate back
+        {
+          results[i] = lm_back_->evaluate(value);
+          continue;
+        }
+
+        if (value < x_[interval])
+        {
+          // going backwards (unsorted input): search from the start
+          interval = std::upper_bound(x_.begin(), x_.begin() + interval, value) - x_.begin() - 1;
+        }
+        else
+        {
+          // sweep forward a few intervals, search if the value is further away
+          Size steps = 0;
+          while ((interval < last_interval) && (x_[interval + 1] <= value) && (steps < 8))
+          {
+            ++interval;
+            ++steps;
+          }
+          if ((interval < last_interval) && (x_[interval + 1] <= value))
+          {
+            interval = std::upper_bound(x_.begin() + interval + 1, x_.end(), value) - x_.begin() - 1;
+            interval = std::min(interval, last_interval);
+          }
+        }
+        results[i] = interp_->evalInInterval(value, interval);
+      }
+    }
+  }
+
   void TransformationModelInterpolated::getDefaultParameters(Param& params)
   {
     params.clear();
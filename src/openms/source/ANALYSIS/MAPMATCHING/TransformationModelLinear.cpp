@@ -110,6 +110,25 @@ namespace OpenMS
     return eval;
   }
 
+  void TransformationModelLinear::evaluateBatch(const std::vector<double>& values, std::vector<double>& results) const
+  {
+    if (weighting_)
+    {
+      TransformationModel::evaluateBatch(values, results);
+      return;
+    }
+
+    results.resize(values.size());
+    const SignedSize n = static_cast<SignedSize>(values.size());
+#ifdef _OPENMP
+#pragma omp parallel for if (n > 10000)
+#endif
+    for (SignedSize i = 0; i < n; ++i)
+    {
+      results[i] = slope_ * values[i] + intercept_;
+    }
+  }
+
   void TransformationModelLinear::invert()
   {
     if (slope_ == 0)
@@ -37,106 +37,194 @@
 #include <OpenMS/DATASTRUCTURES/String.h>
 
 #include <OpenMS/CONCEPT/Exception.h>
+#include <OpenMS/SYSTEM/Profiler.h>
+#include <OpenMS/ANALYSIS/OPENSWATH/IonMobilityFrame.h>
+#include <OpenMS/ANALYSIS/OPENSWATH/CompactChromatogramList.h>
+
+#include <algorithm>
+#include <exception>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
 
 namespace OpenMS
 {
 
-  void ChromatogramExtractorAlgorithm::extract_value_tophat(
-      const std::vector<double>::const_iterator& mz_start,
-            std::vector<double>::const_iterator& mz_it,
-      const std::vector<double>::const_iterator& mz_end,
-            std::vector<double>::const_iterator& int_it,
-      const double mz, double& integrated_intensity, const double mz_extraction_window, const bool ppm)
+  namespace
   {
-    integrated_intensity = 0;
-    if (mz_start == mz_end)
+    // Sum of n contiguous values. Four independent accumulators break the
+    // dependency chain of a single running sum so that the compiler can keep
+    // the loop in vector registers without relaxed floating point semantics.
+    inline double sumRange_(const double* values, std::ptrdiff_t n)
     {
-      return;
+      double s0 = 0, s1 = 0, s2 = 0, s3 = 0;
+      std::ptrdiff_t i = 0;
+      for (; i + 4 <= n; i += 4)
+      {
+        s0 += values[i];
+        s1 += values[i + 1];
+        s2 += values[i + 2];
+        s3 += values[i + 3];
+      }
+      for (; i < n; ++i)
+      {
+        s0 += values[i];
+      }
+      return (s0 + s1) + (s2 + s3);
     }
 
-    // calculate extraction window
-    double left, right;
-    if (ppm)
-    {
-      left  = mz - mz * mz_extraction_window / 2.0 * 1.0e-6;
-      right = mz + mz * mz_extraction_window / 2.0 * 1.0e-6;
-    }
-    else
+    // Same as sumRange_ but only values whose ion mobility is strictly inside
+    // (left_im, right_im) contribute (branch-free masked sum).
+    inline double sumRangeMasked_(const double* values, const double* im, std::ptrdiff_t n,
+                                  const double left_im, const double right_im)
     {
-      left  = mz - mz_extraction_window / 2.0;
-      right = mz + mz_extraction_window / 2.0;
+      double s0 = 0, s1 = 0, s2 = 0, s3 = 0;
+      std::ptrdiff_t i = 0;
+      for (; i + 4 <= n; i += 4)
+      {
+        s0 += (im[i] > left_im && im[i] < right_im) ? values[i] : 0.0;
+        s1 += (im[i + 1] > left_im && im[i + 1] < right_im) ? values[i + 1] : 0.0;
+        s2 += (im[i + 2] > left_im && im[i + 2] < right_im) ? values[i + 2] : 0.0;
+        s3 += (im[i + 3] > left_im && im[i + 3] < right_im) ? values[i + 3] : 0.0;
+      }
+      for (; i < n; ++i)
+      {
+        s0 += (im[i] > left_im && im[i] < right_im) ? values[i] : 0.0;
+      }
+      return (s0 + s1) + (s2 + s3);
     }
 
-    std::vector<double>::const_iterator mz_walker;
-    std::vector<double>::const_iterator int_walker;
-
-    // advance the mz / int iterator until we hit the m/z value of the next transition
-    while (mz_it != mz_end && (*mz_it) < mz)
+    // Computes the range [first, last) of data points around the current
+    // position mz_it that fall into the open window (left, right). Since the
+    // spectrum is sorted, these form a contiguous range whose boundaries are
+    // found by binary search instead of walking the data point by point.
+    //
+    // The range is the same set of points the previous point-by-point walk
+    // visited, so extraction results are unchanged: the walk only left the
+    // current position if the preceding data point was inside the window
+    // (which is not the case if m/z values are not provided in ascending
+    // order) and it did not reach the very first data point of the spectrum
+    // unless it started next to it. Callers also add the last data point once
+    // more if mz_it reached the end of the spectrum.
+    inline void windowRange_(const std::vector<double>::const_iterator& mz_start,
+                             const std::vector<double>::const_iterator& mz_it,
+                             const std::vector<double>::const_iterator& mz_end,
+                             const double left, const double right,
+                             std::vector<double>::const_iterator& first,
+                             std::vector<double>::const_iterator& last)
     {
-      mz_it++;
-      int_it++;
+      first = mz_it;
+      if (mz_it != mz_start && *(mz_it - 1) < right)
+      {
+        first = std::upper_bound(mz_it - 1 == mz_start ? mz_start : mz_start + 1, mz_it, left);
+      }
+      last = std::lower_bound(mz_it, mz_end, right);
     }
 
-    // walk right and left and add to our intensity
-    mz_walker  = mz_it;
-    int_walker = int_it;
-
-    // if we moved past the end of the spectrum, we need to try the last peak
-    // of the spectrum (it could still be within the window)
-    if (mz_it == mz_end)
+    // Whether a spectrum at rt is extracted for coord (the whole chromatogram
+    // is extracted if rt_end - rt_start <= 0)
+    inline bool extractsRT_(const ChromatogramExtractorAlgorithm::ExtractionCoordinates& coord, const double rt)
     {
-      --mz_walker;
-      --int_walker;
+      return !(coord.rt_end - coord.rt_start > 0 && (rt < coord.rt_start || rt > coord.rt_end));
     }
 
-    // add the current peak if it is between right and left
-    if ((*mz_walker) > left && (*mz_walker) < right)
+    // Computes the open extraction window (left, right) around mz
+    inline void extractionWindow_(const double mz, const double mz_extraction_window, const bool ppm,
+                                  double& left, double& right)
     {
-      integrated_intensity += (*int_walker);
+      if (ppm)
+      {
+        left  = mz - mz * mz_extraction_window / 2.0 * 1.0e-6;
+        right = mz + mz * mz_extraction_window / 2.0 * 1.0e-6;
+      }
+      else
+      {
+        left  = mz - mz_extraction_window / 2.0;
+        right = mz + mz_extraction_window / 2.0;
+      }
     }
 
-    // (i) Walk to the left one step and then keep walking left until we go
-    // outside the window. Note for the first step to the left we have to
-    // check for the walker becoming equal to the first data point.
-    mz_walker  = mz_it;
-    int_walker = int_it;
-    if (mz_it != mz_start)
+    // Same result as the m/z-sorted ion mobility extract_value_tophat, but
+    // the (m/z, ion mobility) window is summed through the mobility-indexed
+    // frame. The iterators are advanced as in extract_value_tophat and the
+    // data points treated specially there (the first data point of the
+    // spectrum, see windowRange_, and the last one if the window lies beyond
+    // the spectrum) are corrected for.
+    inline void extract_value_tophat_(const IonMobilityFrame& frame,
+                                      const std::vector<double>::const_iterator& mz_start,
+                                            std::vector<double>::const_iterator& mz_it,
+                                      const std::vector<double>::const_iterator& mz_end,
+                                            std::vector<double>::const_iterator& int_it,
+                                            std::vector<double>::const_iterator& im_it,
+                                      const double mz, const double im, double& integrated_intensity,
+                                      const double mz_extraction_window, const double im_extraction_window,
+                                      const bool ppm)
     {
-      --mz_walker;
-      --int_walker;
+      integrated_intensity = 0;
+      if (mz_start == mz_end)
+      {
+        return;
+      }
+
+      double left, right;
+      extractionWindow_(mz, mz_extraction_window, ppm, left, right);
+      const double left_im  = im - im_extraction_window / 2.0;
+      const double right_im = im + im_extraction_window / 2.0;
+
+      std::vector<double>::const_iterator mz_next = std::lower_bound(mz_it, mz_end, mz);
+      int_it += mz_next - mz_it;
+      im_it += mz_next - mz_it;
+      mz_it = mz_next;
 
-      // Special case: target m/z is larger than first data point but the first
-      // data point is inside the window.
-      // Then, mz_it is the second data point, mz_walker now points to the very
-      // first data point. If mz_it was the first data point, we already added
-      // it above. We still need to add this point if it is inside the window
-      // (while loop below will not catch it)
-      if (mz_walker == mz_start && (*mz_walker) > left && (*mz_walker) < right)
+      integrated_intensity = frame.sumIntensity(left, right, left_im, right_im);
+
+      const std::ptrdiff_t pos = mz_it - mz_start;
+      const double* first_int = &*(int_it - pos);
+      const double* first_im = &*(im_it - pos);
+      if (pos >= 2 && *mz_start > left && *mz_start < right && *first_im > left_im && *first_im < right_im)
+      {
+        integrated_intensity -= *first_int;
+      }
+      if (mz_it == mz_end && *(mz_it - 1) > left && *(mz_it - 1) < right &&
+          *(im_it - 1) > left_im && *(im_it - 1) < right_im)
       {
-        integrated_intensity += (*int_walker);
+        integrated_intensity += *(int_it - 1);
       }
     }
-    while (mz_walker != mz_start && (*mz_walker) > left && (*mz_walker) < right)
+  }
+
+  void ChromatogramExtractorAlgorithm::extract_value_tophat(
+      const std::vector<double>::const_iterator& mz_start,
+            std::vector<double>::const_iterator& mz_it,
+      const std::vector<double>::const_iterator& mz_end,
+            std::vector<double>::const_iterator& int_it,
+      const double mz, double& integrated_intensity, const double mz_extraction_window, const bool ppm)
+  {
+    integrated_intensity = 0;
+    if (mz_start == mz_end)
     {
-      integrated_intensity += (*int_walker);
-      --mz_walker;
-      --int_walker;
+      return;
     }
 
-    // (ii) Walk to the right one step and then keep walking right until we are
-    // outside the window
-    mz_walker  = mz_it;
-    int_walker = int_it;
-    if (mz_it != mz_end)
+    double left, right;
+    extractionWindow_(mz, mz_extraction_window, ppm, left, right);
+
+    // advance the mz / int iterator to the first data point not smaller than
+    // the m/z value of the current transition
+    std::vector<double>::const_iterator mz_next = std::lower_bound(mz_it, mz_end, mz);
+    int_it += mz_next - mz_it;
+    mz_it = mz_next;
+
+    std::vector<double>::const_iterator first, last;
+    windowRange_(mz_start, mz_it, mz_end, left, right, first, last);
+    if (first < last)
     {
-      ++mz_walker;
-      ++int_walker;
+      integrated_intensity = sumRange_(&*(int_it - (mz_it - first)), last - first);
     }
-    while (mz_walker != mz_end && (*mz_walker) > left && (*mz_walker) < right)
+    if (mz_it == mz_end && *(mz_it - 1) > left && *(mz_it - 1) < right)
     {
-      integrated_intensity += (*int_walker);
-      ++mz_walker;
-      ++int_walker;
+      integrated_intensity += *(int_it - 1);
     }
   }
 
@@ -164,101 +252,29 @@ namespace OpenMS
       return;
     }
 
-    // calculate extraction window
     double left, right;
-    if (ppm)
-    {
-      left  = mz - mz * mz_extraction_window / 2.0 * 1.0e-6;
-      right = mz + mz * mz_extraction_window / 2.0 * 1.0e-6;
-    }
-    else
-    {
-      left  = mz - mz_extraction_window / 2.0;
-      right = mz + mz_extraction_window / 2.0;
-    }
+    extractionWindow_(mz, mz_extraction_window, ppm, left, right);
     double left_im  = im - im_extraction_window / 2.0;
     double right_im = im + im_extraction_window / 2.0;
 
-    std::vector<double>::const_iterator mz_walker;
-    std::vector<double>::const_iterator im_walker;
-    std::vector<double>::const_iterator int_walker;
-
-    // advance the mz / int iterator until we hit the m/z value of the next transition
-    while (mz_it != mz_end && (*mz_it) < mz)
-    {
-      mz_it++;
-      im_it++;
-      int_it++;
-    }
-
-    // walk right and left and add to our intensity
-    mz_walker  = mz_it;
-    im_walker  = im_it;
-    int_walker = int_it;
+    // advance the mz / int / im iterator to the first data point not smaller
+    // than the m/z value of the current transition
+    std::vector<double>::const_iterator mz_next = std::lower_bound(mz_it, mz_end, mz);
+    int_it += mz_next - mz_it;
+    im_it += mz_next - mz_it;
+    mz_it = mz_next;
 
-    // if we moved past the end of the spectrum, we need to try the last peak
-    // of the spectrum (it could still be within the window)
-    if (mz_it == mz_end)
+    std::vector<double>::const_iterator first, last;
+    windowRange_(mz_start, mz_it, mz_end, left, right, first, last);
+    if (first < last)
     {
-      --mz_walker;
-      --im_walker;
-      --int_walker;
+      std::ptrdiff_t offset = mz_it - first;
+      integrated_intensity = sumRangeMasked_(&*(int_it - offset), &*(im_it - offset), last - first, left_im, right_im);
     }
-
-    // add the current peak if it is between right and left
-    if ((*mz_walker) > left && (*mz_walker) < right && (*im_walker) > left_im && (*im_walker) < right_im)
+    if (mz_it == mz_end && *(mz_it - 1) > left && *(mz_it - 1) < right &&
+        *(im_it - 1) > left_im && *(im_it - 1) < right_im)
     {
-      integrated_intensity += (*int_walker);
-    }
-
-    // (i) Walk to the left one step and then keep walking left until we go
-    // outside the window. Note for the first step to the left we have to
-    // check for the walker becoming equal to the first data point.
-    mz_walker  = mz_it;
-    int_walker = int_it;
-    im_walker = im_it;
-    if (mz_it != mz_start)
-    {
-      --mz_walker;
-      --im_walker;
-      --int_walker;
-
-      // Special case: target m/z is larger than first data point but the first
-      // data point is inside the window.
-      // Then, mz_it is the second data point, mz_walker now points to the very
-      // first data point. If mz_it was the first data point, we already added
-      // it above. We still need to add this point if it is inside the window
-      // (while loop below will not catch it)
-      if (mz_walker == mz_start && (*mz_walker) > left && (*mz_walker) < right && (*im_walker) > left_im && (*im_walker) < right_im)
-      {
-        integrated_intensity += (*int_walker);
-      }
-    }
-    while (mz_walker != mz_start && (*mz_walker) > left && (*mz_walker) < right)
-    {
-      if (*im_walker > left_im && *im_walker < right_im) integrated_intensity += (*int_walker);
-      --mz_walker;
-      --im_walker;
-      --int_walker;
-    }
-
-    // (ii) Walk to the right one step and then keep walking right until we are
-    // outside the window
-    mz_walker  = mz_it;
-    im_walker  = im_it;
-    int_walker = int_it;
-    if (mz_it != mz_end)
-    {
-      ++im_walker;
-      ++mz_walker;
-      ++int_walker;
-    }
-    while (mz_walker != mz_end && (*mz_walker) > left && (*mz_walker) < right)
-    {
-      if (*im_walker > left_im && *im_walker < right_im) integrated_intensity += (*int_walker);
-      ++mz_walker;
-      ++im_walker;
-      ++int_walker;
+      integrated_intensity += *(int_it - 1);
     }
   }
 
@@ -270,6 +286,7 @@ namespace OpenMS
       double im_extraction_window,
       const String& filter)
   {
+    OPENMS_PROFILE_SCOPE("ChromatogramExtractorAlgorithm::extractChromatograms");
     Size input_size = input->getNrSpectra();
     if (input_size < 1)
     {
@@ -291,87 +308,340 @@ namespace OpenMS
         "Input to extractChromatogram needs to be sorted by m/z");
     }
 
-    //go through all spectra
-    startProgress(0, input_size, "Extracting chromatograms");
-    for (Size scan_idx = 0; scan_idx < input_size; ++scan_idx)
+    std::vector<SweepEntry_> sweep;
+    sweep.reserve(extraction_coordinates.size());
+    for (Size k = 0; k < extraction_coordinates.size(); ++k)
     {
-      setProgress(scan_idx);
+      sweep.push_back(SweepEntry_(&extraction_coordinates[k], output[k].get()));
+    }
 
-      OpenSwath::SpectrumPtr sptr = input->getSpectrumById(scan_idx);
-      OpenSwath::SpectrumMeta s_meta = input->getSpectrumMetaById(scan_idx);
+    extractSweep_(input, sweep, mz_extraction_window, ppm, im_extraction_window, used_filter,
+      [&](Size, double rt, const double* intensities) { appendSpectrum_(rt, sweep, intensities); });
+  }
+
+  void ChromatogramExtractorAlgorithm::extractChromatograms(const OpenSwath::SpectrumAccessPtr input,
+      std::vector< std::vector< OpenSwath::ChromatogramPtr > >& output,
+      const std::vector< std::vector<ExtractionCoordinates> >& extraction_coordinates,
+      double mz_extraction_window,
+      bool ppm,
+      double im_extraction_window,
+      const String& filter)
+  {
+    OPENMS_PROFILE_SCOPE("ChromatogramExtractorAlgorithm::extractChromatograms");
+    if (output.size() != extraction_coordinates.size())
+    {
+      throw Exception::IllegalArgument(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION,
+        "Output and extraction coordinates need to have the same number of sets: "+ String(output.size()) + " != " + String(extraction_coordinates.size()) );
+    }
 
-      OpenSwath::BinaryDataArrayPtr mz_arr = sptr->getMZArray();
-      OpenSwath::BinaryDataArrayPtr int_arr = sptr->getIntensityArray();
-      std::vector<double>::const_iterator mz_start = mz_arr->data.begin();
-      std::vector<double>::const_iterator mz_end = mz_arr->data.end();
-      std::vector<double>::const_iterator mz_it = mz_arr->data.begin();
-      std::vector<double>::const_iterator int_it = int_arr->data.begin();
-      std::vector<double>::const_iterator im_it;
+    int used_filter = getFilterNr_(filter);
 
-      if (sptr->getMZArray()->data.size() == 0)
+    // merge all sets into a single list sorted by m/z which is swept once per spectrum
+    std::vector<SweepEntry_> sweep;
+    for (Size set_idx = 0; set_idx < extraction_coordinates.size(); ++set_idx)
+    {
+      const std::vector<ExtractionCoordinates>& coordinates = extraction_coordinates[set_idx];
+      if (output[set_idx].size() != coordinates.size())
       {
-        continue;
+        throw Exception::IllegalArgument(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION,
+          "Output and extraction coordinates need to have the same size: "+ String(output[set_idx].size()) + " != " + String(coordinates.size()) );
+      }
+      if (std::adjacent_find(coordinates.begin(), coordinates.end(),
+            ExtractionCoordinates::SortExtractionCoordinatesReverseByMZ) != coordinates.end())
+      {
+        throw Exception::IllegalArgument(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION,
+          "Input to extractChromatogram needs to be sorted by m/z");
+      }
+      for (Size k = 0; k < coordinates.size(); ++k)
+      {
+        sweep.push_back(SweepEntry_(&coordinates[k], output[set_idx][k].get()));
+      }
+    }
+    std::stable_sort(sweep.begin(), sweep.end(),
+        [](const SweepEntry_& a, const SweepEntry_& b) { return a.first->mz < b.first->mz; });
+
+    if (input->getNrSpectra() < 1 || sweep.empty())
+    {
+      return;
+    }
+
+    extractSweep_(input, sweep, mz_extraction_window, ppm, im_extraction_window, used_filter,
+      [&](Size, double rt, const double* intensities) { appendSpectrum_(rt, sweep, intensities); });
+  }
+
+  void ChromatogramExtractorAlgorithm::extractChromatograms(const OpenSwath::SpectrumAccessPtr input,
+      std::vector<CompactChromatogramList>& output,
+      const std::vector< std::vector<ExtractionCoordinates> >& extraction_coordinates,
+      double mz_extraction_window,
+      bool ppm,
+      double im_extraction_window,
+      const String& filter)
+  {
+    OPENMS_PROFILE_SCOPE("ChromatogramExtractorAlgorithm::extractChromatograms");
+    int used_filter = getFilterNr_(filter);
+
+    // the retention times of the input are shared by all chromatograms
+    boost::shared_ptr<std::vector<double> > rt_axis(new std::vector<double>(input->getNrSpectra()));
+    for (Size scan_idx = 0; scan_idx < rt_axis->size(); ++scan_idx)
+    {
+      (*rt_axis)[scan_idx] = input->getSpectrumMetaById(scan_idx).RT;
+    }
+
+    // merge all sets into a single list sorted by m/z, remembering which
+    // chromatogram of which list each entry is extracted into
+    struct Target
+    {
+      const ExtractionCoordinates* coord;
+      Size set_idx;
+      Size chrom_idx;
+    };
+    std::vector<Target> targets;
+    output.clear();
+    output.reserve(extraction_coordinates.size());
+    for (Size set_idx = 0; set_idx < extraction_coordinates.size(); ++set_idx)
+    {
+      const std::vector<ExtractionCoordinates>& coordinates = extraction_coordinates[set_idx];
+      if (std::adjacent_find(coordinates.begin(), coordinates.end(),
+            ExtractionCoordinates::SortExtractionCoordinatesReverseByMZ) != coordinates.end())
+      {
+        throw Exception::IllegalArgument(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION,
+          "Input to extractChromatogram needs to be sorted by m/z");
+      }
+      output.push_back(CompactChromatogramList(coordinates.size(), rt_axis));
+      for (Size k = 0; k < coordinates.size(); ++k)
+      {
+        targets.push_back({&coordinates[k], set_idx, k});
       }
+    }
+    std::stable_sort(targets.begin(), targets.end(),
+        [](const Target& a, const Target& b) { return a.coord->mz < b.coord->mz; });
+
+    if (rt_axis->empty() || targets.empty())
+    {
+      return;
+    }
 
-      // Look for ion mobility array
-      bool has_im = (im_extraction_window > 0.0);
-      if (has_im)
+    std::vector<SweepEntry_> sweep;
+    sweep.reserve(targets.size());
+    for (const Target& t : targets)
+    {
+      sweep.push_back(SweepEntry_(t.coord, nullptr));
+    }
+
+    extractSweep_(input, sweep, mz_extraction_window, ppm, im_extraction_window, used_filter,
+      [&](Size scan_idx, double rt, const double* intensities)
       {
-        OpenSwath::BinaryDataArrayPtr im_arr = sptr->getMZArray();
-        bool found = false;
-        for (const auto& arr : sptr->getDataArrays())
+        for (Size k = 0; k < targets.size(); ++k)
         {
-          if (arr->description == "Ion Mobility")
+          if (extractsRT_(*targets[k].coord, rt))
           {
-            im_it = arr->data.begin();
-            found = true;
+            output[targets[k].set_idx].push_back(targets[k].chrom_idx, scan_idx, intensities[k]);
           }
         }
-        if (!found)
-        {
-          throw Exception::IllegalArgument(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION,
-            "Requested ion mobility extraction but no ion mobility array found (looked for 'Ion Mobility').");
-        }
+      });
+  }
+
+  void ChromatogramExtractorAlgorithm::extractSweep_(const OpenSwath::SpectrumAccessPtr input,
+      const std::vector<SweepEntry_>& sweep,
+      double mz_extraction_window,
+      bool ppm,
+      double im_extraction_window,
+      int used_filter,
+      const AppendFunction_& append)
+  {
+    const Size input_size = input->getNrSpectra();
+    startProgress(0, input_size, "Extracting chromatograms");
+
+    int nr_threads = 1;
+#ifdef _OPENMP
+    if (!omp_in_parallel())
+    {
+      nr_threads = omp_get_max_threads();
+    }
+#endif
+
+    if (nr_threads < 2 || input_size < 2 || sweep.empty())
+    {
+      // go through all spectra
+      std::vector<double> intensities(sweep.size());
+      for (Size scan_idx = 0; scan_idx < input_size; ++scan_idx)
+      {
+        setProgress(scan_idx);
+        double current_rt = input->getSpectrumMetaById(scan_idx).RT;
+        extractSpectrum_(input->getSpectrumById(scan_idx), current_rt,
+                         sweep, mz_extraction_window, ppm, im_extraction_window, used_filter, &intensities[0]);
+        append(scan_idx, current_rt, &intensities[0]);
       }
+      endProgress();
+      return;
+    }
 
-      // go through all transitions / chromatograms which are sorted by
-      // ProductMZ. We can use this to step through the spectrum and at the
-      // same time step through the transitions. We increase the peak counter
-      // until we hit the next transition and then extract the signal.
-      for (Size k = 0; k < extraction_coordinates.size(); ++k)
+    // Spectra are independent of each other: extract blocks of spectra in
+    // parallel (each thread reading from its own light clone of the input)
+    // into a buffer with one row of intensities per spectrum, then append
+    // the rows to the chromatograms in spectrum order. The result is
+    // identical to the sequential extraction.
+    std::vector<OpenSwath::SpectrumAccessPtr> thread_input(nr_threads);
+    for (int t = 0; t < nr_threads; ++t)
+    {
+      thread_input[t] = input->lightClone();
+    }
+
+    // limit the buffer to about 32 MB
+    const Size max_buffer_size = Size(1) << 22;
+    const Size block_size = std::min(input_size,
+      std::max(Size(nr_threads), std::min(Size(nr_threads) * 16, max_buffer_size / sweep.size())));
+    std::vector<double> block_intensities(block_size * sweep.size());
+    std::vector<double> block_rt(block_size);
+
+    for (Size block_start = 0; block_start < input_size; block_start += block_size)
+    {
+      setProgress(block_start);
+      const SignedSize block_n = std::min(block_size, input_size - block_start);
+
+      Size err_count = 0;
+      std::exception_ptr err;
+#ifdef _OPENMP
+#pragma omp parallel for num_threads(nr_threads) schedule(dynamic)
+#endif
+      for (SignedSize i = 0; i < block_n; ++i)
       {
-        double integrated_intensity = 0;
-        double current_rt = s_meta.RT;
-        if (extraction_coordinates[k].rt_end - extraction_coordinates[k].rt_start > 0 &&
-             (current_rt < extraction_coordinates[k].rt_start ||
-              current_rt > extraction_coordinates[k].rt_end) )
+        int thread = 0;
+#ifdef _OPENMP
+        thread = omp_get_thread_num();
+#endif
+        try
         {
-          continue;
+          const Size scan_idx = block_start + i;
+          const OpenSwath::SpectrumAccessPtr& tinput = thread_input[thread];
+          block_rt[i] = tinput->getSpectrumMetaById(scan_idx).RT;
+          extractSpectrum_(tinput->getSpectrumById(scan_idx), block_rt[i],
+                           sweep, mz_extraction_window, ppm, im_extraction_window, used_filter,
+                           &block_intensities[i * sweep.size()]);
         }
-
-        const bool use_im = (extraction_coordinates[k].ion_mobility >= 0.0 && has_im);
-        if (!use_im && used_filter == 1)
+        catch (...)
         {
-          extract_value_tophat(mz_start, mz_it, mz_end, int_it,
-                               extraction_coordinates[k].mz, integrated_intensity, mz_extraction_window, ppm);
+#ifdef _OPENMP
+#pragma omp critical (ChromatogramExtractorAlgorithm_error)
+#endif
+          {
+            if (err_count++ == 0) err = std::current_exception();
+          }
         }
-        else if (use_im && used_filter == 1)
+      }
+      if (err_count > 0)
+      {
+        std::rethrow_exception(err);
+      }
+
+      for (SignedSize i = 0; i < block_n; ++i)
+      {
+        append(block_start + i, block_rt[i], &block_intensities[i * sweep.size()]);
+      }
+    }
+    endProgress();
+  }
+
+  void ChromatogramExtractorAlgorithm::extractSpectrum_(const OpenSwath::SpectrumPtr& sptr,
+      double current_rt,
+      const std::vector<SweepEntry_>& sweep,
+      double mz_extraction_window,
+      bool ppm,
+      double im_extraction_window,
+      int used_filter,
+      double* intensities)
+  {
+    OpenSwath::BinaryDataArrayPtr mz_arr = sptr->getMZArray();
+    OpenSwath::BinaryDataArrayPtr int_arr = sptr->getIntensityArray();
+    std::vector<double>::const_iterator mz_start = mz_arr->data.begin();
+    std::vector<double>::const_iterator mz_end = mz_arr->data.end();
+    std::vector<double>::const_iterator mz_it = mz_arr->data.begin();
+    std::vector<double>::const_iterator int_it = int_arr->data.begin();
+    std::vector<double>::const_iterator im_it;
+
+    if (mz_arr->data.size() == 0)
+    {
+      std::fill(intensities, intensities + sweep.size(), 0.0);
+      return;
+    }
+
+    // Look for ion mobility array
+    bool has_im = (im_extraction_window > 0.0);
+    if (has_im)
+    {
+      bool found = false;
+      for (const auto& arr : sptr->getDataArrays())
+      {
+        if (arr->description == "Ion Mobility")
         {
-          extract_value_tophat(mz_start, mz_it, mz_end, int_it, im_it,
-                               extraction_coordinates[k].mz, extraction_coordinates[k].ion_mobility,
-                               integrated_intensity, mz_extraction_window, im_extraction_window, ppm);
+          im_it = arr->data.begin();
+          found = true;
         }
-        else if (used_filter == 2)
+      }
+      if (!found)
+      {
+        throw Exception::IllegalArgument(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION,
+          "Requested ion mobility extraction but no ion mobility array found (looked for 'Ion Mobility').");
+      }
+    }
+    // (m/z, ion mobility) windows are queried through a mobility-indexed
+    // frame, built on the first transition that needs it
+    IonMobilityFrame frame;
+    bool frame_built = false;
+
+    // go through all transitions / chromatograms which are sorted by
+    // ProductMZ. We can use this to step through the spectrum and at the
+    // same time step through the transitions. We increase the peak counter
+    // until we hit the next transition and then extract the signal.
+    for (Size k = 0; k < sweep.size(); ++k)
+    {
+      const ExtractionCoordinates& coord = *sweep[k].first;
+      double integrated_intensity = 0;
+      if (!extractsRT_(coord, current_rt))
+      {
+        continue;
+      }
+
+      const bool use_im = (coord.ion_mobility >= 0.0 && has_im);
+      if (!use_im && used_filter == 1)
+      {
+        extract_value_tophat(mz_start, mz_it, mz_end, int_it,
+                             coord.mz, integrated_intensity, mz_extraction_window, ppm);
+      }
+      else if (use_im && used_filter == 1)
+      {
+        if (!frame_built)
         {
-          throw Exception::NotImplemented(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION);
+          frame = IonMobilityFrame(sptr);
+          frame_built = true;
         }
+        extract_value_tophat_(frame, mz_start, mz_it, mz_end, int_it, im_it,
+                              coord.mz, coord.ion_mobility,
+                              integrated_intensity, mz_extraction_window, im_extraction_window, ppm);
+      }
+      else if (used_filter == 2)
+      {
+        throw Exception::NotImplemented(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION);
+      }
+
+      intensities[k] = integrated_intensity;
+    }
+  }
 
-        // Time is first, intensity is second
-        output[k]->getTimeArray()->data.push_back(current_rt);
-        output[k]->getIntensityArray()->data.push_back(integrated_intensity);
+  void ChromatogramExtractorAlgorithm::appendSpectrum_(double current_rt,
+      const std::vector<SweepEntry_>& sweep,
+      const double* intensities)
+  {
+    for (Size k = 0; k < sweep.size(); ++k)
+    {
+      if (!extractsRT_(*sweep[k].first, current_rt))
+      {
+        continue;
       }
+      // Time is first, intensity is second
+      sweep[k].second->getTimeArray()->data.push_back(current_rt);
+      sweep[k].second->getIntensityArray()->data.push_back(intensities[k]);
     }
-    endProgress();
   }
 
   int ChromatogramExtractorAlgorithm::getFilterNr_(const String& filter)
@@ -0,0 +1,122 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2018.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: Hannes Roest $
+// $Authors: Hannes Roest $
+// --------------------------------------------------------------------------
+
+#include <OpenMS/ANALYSIS/OPENSWATH/CompactChromatogramList.h>
+
+#include <numeric>
+
+namespace OpenMS
+{
+
+  CompactChromatogramList::CompactChromatogramList() :
+    rt_axis_(new std::vector<double>())
+  {
+  }
+
+  CompactChromatogramList::CompactChromatogramList(Size size, const boost::shared_ptr<const std::vector<double> >& rt_axis) :
+    rt_axis_(rt_axis),
+    chromatograms_(size)
+  {
+  }
+
+  Size CompactChromatogramList::size() const
+  {
+    return chromatograms_.size();
+  }
+
+  const std::vector<double>& CompactChromatogramList::getRTAxis() const
+  {
+    return *rt_axis_;
+  }
+
+  void CompactChromatogramList::push_back(Size chrom, Size rt_index, double intensity)
+  {
+    Chromatogram_& c = chromatograms_[chrom];
+    if (c.intensities.empty())
+    {
+      c.first_rt_index = rt_index;
+    }
+    else if (c.rt_indices.empty() && rt_index != c.first_rt_index + c.intensities.size())
+    {
+      // the data points are no longer consecutive: store all positions
+      c.rt_indices.resize(c.intensities.size());
+      std::iota(c.rt_indices.begin(), c.rt_indices.end(), UInt32(c.first_rt_index));
+    }
+    if (!c.rt_indices.empty())
+    {
+      c.rt_indices.push_back(UInt32(rt_index));
+    }
+    c.intensities.push_back(float(intensity));
+  }
+
+  Size CompactChromatogramList::getNrPoints(Size chrom) const
+  {
+    return chromatograms_[chrom].intensities.size();
+  }
+
+  OpenSwath::ChromatogramPtr CompactChromatogramList::getChromatogram(Size chrom) const
+  {
+    const Chromatogram_& c = chromatograms_[chrom];
+    const std::vector<double>& rt_axis = *rt_axis_;
+
+    OpenSwath::ChromatogramPtr chromatogram(new OpenSwath::Chromatogram);
+    std::vector<double>& rt = chromatogram->getTimeArray()->data;
+    std::vector<double>& intensity = chromatogram->getIntensityArray()->data;
+    rt.reserve(c.intensities.size());
+    intensity.reserve(c.intensities.size());
+    for (Size i = 0; i < c.intensities.size(); ++i)
+    {
+      rt.push_back(rt_axis[c.rt_indices.empty() ? c.first_rt_index + i : c.rt_indices[i]]);
+      intensity.push_back(c.intensities[i]);
+    }
+    return chromatogram;
+  }
+
+  std::vector<OpenSwath::ChromatogramPtr> CompactChromatogramList::getChromatograms() const
+  {
+    std::vector<OpenSwath::ChromatogramPtr> chromatograms;
+    chromatograms.reserve(chromatograms_.size());
+    for (Size i = 0; i < chromatograms_.size(); ++i)
+    {
+      chromatograms.push_back(getChromatogram(i));
+    }
+    return chromatograms;
+  }
+
+  void CompactChromatogramList::clear()
+  {
+    std::vector<Chromatogram_>().swap(chromatograms_);
+  }
+
+}
@@ -69,6 +69,18 @@ namespace OpenMS
     int ms_level = -1;
     double rt = -1.0;
 
+    if (mapped_region_)
+    {
+      Size available;
+      const char* data = getMappedData_(spectra_index_[id], available);
+      std::vector<OpenSwath::BinaryDataArrayPtr> arrays = Internal::CachedMzMLHandler::readSpectrumFast(data, available, ms_level, rt);
+
+      OpenSwath::SpectrumPtr sptr(new OpenSwath::Spectrum);
+      sptr->setMZArray(arrays[0]);
+      sptr->setIntensityArray(arrays[1]);
+      return sptr;
+    }
+
     if ( !ifs_.seekg(spectra_index_[id]) )
     {
       std::cerr << "Error while reading spectrum " << id << " - seekg created an error when trying to change position to " << spectra_index_[id] << "." << std::endl;
@@ -85,6 +97,38 @@ namespace OpenMS
     return sptr;
   }
 
+  std::vector<OpenSwath::SpectrumPtr> SpectrumAccessOpenMSCached::getSpectraByIds(const std::vector<std::size_t>& ids)
+  {
+    // read in file order to turn neighbouring spectra into sequential reads
+    std::vector<std::size_t> order(ids.size());
+    for (Size k = 0; k < order.size(); k++) order[k] = k;
+    std::sort(order.begin(), order.end(), [&](std::size_t a, std::size_t b)
+    {
+      return spectra_index_[ids[a]] < spectra_index_[ids[b]];
+    });
+
+    std::vector<OpenSwath::SpectrumPtr> spectra(ids.size());
+    for (Size k = 0; k < order.size(); k++)
+    {
+      spectra[order[k]] = getSpectrumById(static_cast<int>(ids[order[k]]));
+    }
+    return spectra;
+  }
+
+  void SpectrumAccessOpenMSCached::prefetchSpectraByRT(double RT, double deltaRT)
+  {
+    if (!mapped_region_) return;
+
+    std::vector<std::size_t> ids = getSpectraByRT(RT, deltaRT);
+    if (ids.empty()) return;
+
+    // the spectra within an RT range are stored consecutively
+    std::size_t first = *std::min_element(ids.begin(), ids.end());
+    std::size_t last = *std::max_element(ids.begin(), ids.end());
+    std::streampos end = (last + 1 < spectra_index_.size() ? spectra_index_[last + 1] : std::streampos(-1));
+    prefetchMappedData_(spectra_index_[first], end);
+  }
+
   OpenSwath::SpectrumMeta SpectrumAccessOpenMSCached::getSpectrumMetaById(int id) const
   {
     OPENMS_PRECONDITION(id >= 0, "Id needs to be larger than zero");
@@ -104,6 +148,18 @@ namespace OpenMS
     OpenSwath::BinaryDataArrayPtr rt_array(new OpenSwath::BinaryDataArray);
     OpenSwath::BinaryDataArrayPtr intensity_array(new OpenSwath::BinaryDataArray);
 
+    if (mapped_region_)
+    {
+      Size available;
+      const char* data = getMappedData_(chrom_index_[id], available);
+      std::vector<OpenSwath::BinaryDataArrayPtr> arrays = Internal::CachedMzMLHandler::readChromatogramFast(data, available);
+
+      OpenSwath::ChromatogramPtr cptr(new OpenSwath::Chromatogram);
+      cptr->setTimeArray(arrays[0]);
+      cptr->setIntensityArray(arrays[1]);
+      return cptr;
+    }
+
     if ( !ifs_.seekg(chrom_index_[id]) )
     {
       std::cerr << "Error while reading chromatogram " << id << " - seekg created an error when trying to change position to " << chrom_index_[id] << "." << std::endl;
@@ -34,6 +34,8 @@
 
 #include <OpenMS/ANALYSIS/OPENSWATH/DATAACCESS/SpectrumAccessSqMass.h>
 
+#include <limits>
+
 namespace OpenMS
 {
 
@@ -118,6 +120,52 @@ namespace OpenMS
       return sptr;
     }
 
+    std::vector<OpenSwath::SpectrumPtr> SpectrumAccessSqMass::getSpectraByIds(const std::vector<std::size_t>& ids)
+    {
+      std::vector<OpenSwath::SpectrumPtr> spectra;
+      if (ids.empty()) return spectra;
+
+      std::vector<int> indices;
+      indices.reserve(ids.size());
+      for (Size k = 0; k < ids.size(); k++)
+      {
+        if (sidx_.empty())
+        {
+          indices.push_back(static_cast<int>(ids[k]));
+        }
+        else
+        {
+          indices.push_back(sidx_[ids[k]]);
+        }
+      }
+
+      // read MSSpectra and prepare for conversion (opening the database and
+      // reading the meta data only once for all spectra)
+      std::vector<MSSpectrum> tmp_spectra;
+      handler_.readSpectra(tmp_spectra, indices, false);
+
+      spectra.reserve(tmp_spectra.size());
+      for (Size k = 0; k < tmp_spectra.size(); k++)
+      {
+        const MSSpectrumType& spectrum = tmp_spectra[k];
+        OpenSwath::BinaryDataArrayPtr intensity_array(new OpenSwath::BinaryDataArray);
+        OpenSwath::BinaryDataArrayPtr mz_array(new OpenSwath::BinaryDataArray);
+        mz_array->data.reserve(spectrum.size());
+        intensity_array->data.reserve(spectrum.size());
+        for (MSSpectrumType::const_iterator it = spectrum.begin(); it != spectrum.end(); ++it)
+        {
+          mz_array->data.push_back(it->getMZ());
+          intensity_array->data.push_back(it->getIntensity());
+        }
+
+        OpenSwath::SpectrumPtr sptr(new OpenSwath::Spectrum);
+        sptr->setMZArray(mz_array);
+        sptr->setIntensityArray(intensity_array);
+        spectra.push_back(sptr);
+      }
+      return spectra;
+    }
+
     OpenSwath::SpectrumMeta SpectrumAccessSqMass::getSpectrumMetaById(int id) const
     {
       std::vector<int> indices;
@@ -225,9 +273,42 @@ namespace OpenMS
       return res;
     }
 
-    OpenSwath::ChromatogramPtr SpectrumAccessSqMass::getChromatogramById(int /* id */)
+    OpenSwath::ChromatogramPtr SpectrumAccessSqMass::getChromatogramById(int id)
     {
-      throw Exception::NotImplemented(__FILE__,__LINE__,OPENMS_PRETTY_FUNCTION);
+      std::vector<std::size_t> ids(1, id);
+      return getChromatogramsByRTRange(ids, -std::numeric_limits<double>::max(), std::numeric_limits<double>::max())[0];
+    }
+
+    std::vector<OpenSwath::ChromatogramPtr> SpectrumAccessSqMass::getChromatogramsByRTRange(const std::vector<std::size_t>& ids, double rt_min, double rt_max) const
+    {
+      std::vector<OpenSwath::ChromatogramPtr> chromatograms;
+      if (ids.empty()) return chromatograms;
+
+      // TODO: currently chrom indices are not supported, ids refer to the file
+      std::vector<int> indices(ids.begin(), ids.end());
+      std::vector<MSChromatogram> tmp_chroms;
+      handler_.readChromatogramsInRTRange(tmp_chroms, indices, rt_min, rt_max);
+
+      chromatograms.reserve(tmp_chroms.size());
+      for (Size k = 0; k < tmp_chroms.size(); k++)
+      {
+        const MSChromatogramType& chromatogram = tmp_chroms[k];
+        OpenSwath::BinaryDataArrayPtr intensity_array(new OpenSwath::BinaryDataArray);
+        OpenSwath::BinaryDataArrayPtr rt_array(new OpenSwath::BinaryDataArray);
+        rt_array->data.reserve(chromatogram.size());
+        intensity_array->data.reserve(chromatogram.size());
+        for (MSChromatogramType::const_iterator it = chromatogram.begin(); it != chromatogram.end(); ++it)
+        {
+          rt_array->data.push_back(it->getRT());
+          intensity_array->data.push_back(it->getIntensity());
+        }
+
+        OpenSwath::ChromatogramPtr cptr(new OpenSwath::Chromatogram);
+        cptr->setTimeArray(rt_array);
+        cptr->setIntensityArray(intensity_array);
+        chromatograms.push_back(cptr);
+      }
+      return chromatograms;
     }
 
     size_t SpectrumAccessSqMass::getNrChromatograms() const
@@ -64,6 +64,11 @@ namespace OpenMS
     return sptr_->getSpectraByRT(RT, deltaRT);
   }
 
+  void SpectrumAccessTransforming::prefetchSpectraByRT(double RT, double deltaRT)
+  {
+    sptr_->prefetchSpectraByRT(RT, deltaRT);
+  }
+
   size_t SpectrumAccessTransforming::getNrSpectra() const
   {
     return sptr_->getNrSpectra();
@@ -0,0 +1,339 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2018.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: Hannes Roest $
+// $Authors: Hannes Roest $
+// --------------------------------------------------------------------------
+
+#include <OpenMS/ANALYSIS/OPENSWATH/DATAACCESS/SwathMapResidencyManager.h>
+
+#include <OpenMS/ANALYSIS/OPENSWATH/DATAACCESS/SpectrumAccessOpenMSInMemory.h>
+#include <OpenMS/CONCEPT/LogStream.h>
+
+#include <algorithm>
+#include <exception>
+#include <set>
+
+namespace OpenMS
+{
+
+  namespace
+  {
+    UInt64 arrayMemoryUsage_(const std::vector<OpenSwath::BinaryDataArrayPtr>& arrays)
+    {
+      UInt64 bytes = 0;
+      for (Size i = 0; i < arrays.size(); ++i)
+      {
+        if (!arrays[i]) continue;
+        bytes += sizeof(OpenSwath::BinaryDataArray) + arrays[i]->data.capacity() * sizeof(double) + arrays[i]->description.capacity();
+      }
+      return bytes;
+    }
+  }
+
+  SwathMapResidencyManager::SwathMapResidencyManager(UInt64 memory_budget) :
+    memory_budget_(memory_budget),
+    resident_bytes_(0),
+    largest_map_(0),
+    clock_(0),
+    schedule_pos_(0),
+    stop_(false)
+  {
+  }
+
+  SwathMapResidencyManager::~SwathMapResidencyManager()
+  {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      stop_ = true;
+      changed_.notify_all();
+    }
+    if (prefetch_thread_.joinable()) prefetch_thread_.join();
+  }
+
+  void SwathMapResidencyManager::setSchedule(const std::vector<OpenSwath::SpectrumAccessPtr>& schedule)
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    schedule_ = schedule;
+    schedule_pos_ = 0;
+    if (!schedule_.empty() && memory_budget_ > 0 && !prefetch_thread_.joinable())
+    {
+      prefetch_thread_ = std::thread(&SwathMapResidencyManager::prefetch_, this);
+    }
+    changed_.notify_all();
+  }
+
+  OpenSwath::SpectrumAccessPtr SwathMapResidencyManager::acquire(const OpenSwath::SpectrumAccessPtr& map)
+  {
+    if (!map) return map;
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    Entry& entry = entries_[map.get()];
+    if (!entry.source)
+    {
+      entry.source = map;
+      entry.bytes = 0;
+      entry.measured = false;
+      entry.loading = false;
+      entry.prefetched = false;
+      entry.users = 0;
+      entry.last_use = 0;
+    }
+    ++entry.users;
+    entry.last_use = ++clock_;
+    entry.prefetched = false;
+
+    // prefetching continues after the map that is used now
+    for (Size k = schedule_pos_; k < schedule_.size(); ++k)
+    {
+      if (schedule_[k].get() == map.get())
+      {
+        schedule_pos_ = k + 1;
+        changed_.notify_all();
+        break;
+      }
+    }
+
+    while (entry.loading) changed_.wait(lock);
+
+    if (!entry.resident)
+    {
+      UInt64 bytes = estimate_(entry);
+      if (makeRoom_(bytes, false) || makeRoom_(bytes, true))
+      {
+        entry.bytes = bytes;
+        resident_bytes_ += bytes;
+        load_(entry, lock);
+      }
+    }
+    return entry.resident ? entry.resident : map;
+  }
+
+  void SwathMapResidencyManager::release(const OpenSwath::SpectrumAccessPtr& map)
+  {
+    if (!map) return;
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    EntryMap::iterator it = entries_.find(map.get());
+    if (it == entries_.end() || it->second.users == 0) return;
+    --it->second.users;
+    it->second.last_use = ++clock_;
+    changed_.notify_all();
+  }
+
+  void SwathMapResidencyManager::clear()
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (EntryMap::iterator it = entries_.begin(); it != entries_.end(); ++it)
+    {
+      Entry& entry = it->second;
+      if (entry.resident && entry.users == 0 && !entry.loading)
+      {
+        entry.resident.reset();
+        entry.prefetched = false;
+        resident_bytes_ -= entry.bytes;
+      }
+    }
+    changed_.notify_all();
+  }
+
+  UInt64 SwathMapResidencyManager::getMemoryBudget() const
+  {
+    return memory_budget_;
+  }
+
+  UInt64 SwathMapResidencyManager::getResidentBytes() const
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return resident_bytes_;
+  }
+
+  bool SwathMapResidencyManager::isResident(const OpenSwath::SpectrumAccessPtr& map) const
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    EntryMap::const_iterator it = entries_.find(map.get());
+    return it != entries_.end() && it->second.resident;
+  }
+
+  UInt64 SwathMapResidencyManager::getMemoryUsage(OpenSwath::ISpectrumAccess& map)
+  {
+    UInt64 bytes = 0;
+    for (Size i = 0; i < map.getNrSpectra(); ++i)
+    {
+      OpenSwath::SpectrumPtr spectrum = map.getSpectrumById(i);
+      bytes += sizeof(OpenSwath::Spectrum) + sizeof(OpenSwath::SpectrumMeta);
+      if (spectrum) bytes += arrayMemoryUsage_(spectrum->getDataArrays());
+    }
+    for (Size i = 0; i < map.getNrChromatograms(); ++i)
+    {
+      OpenSwath::ChromatogramPtr chromatogram = map.getChromatogramById(i);
+      bytes += sizeof(OpenSwath::Chromatogram) + map.getChromatogramNativeID(i).size();
+      if (chromatogram) bytes += arrayMemoryUsage_(chromatogram->getDataArrays());
+    }
+    return bytes;
+  }
+
+  UInt64 SwathMapResidencyManager::estimate_(const Entry& entry) const
+  {
+    return entry.measured ? entry.bytes : largest_map_;
+  }
+
+  bool SwathMapResidencyManager::makeRoom_(UInt64 bytes, bool evict_prefetched)
+  {
+    if (bytes > memory_budget_) return false;
+    if (resident_bytes_ + bytes <= memory_budget_) return true;
+
+    std::vector<Entry*> candidates;
+    UInt64 evictable = 0;
+    for (EntryMap::iterator it = entries_.begin(); it != entries_.end(); ++it)
+    {
+      Entry& entry = it->second;
+      if (!entry.resident || entry.users > 0 || entry.loading) continue;
+      if (entry.prefetched && !evict_prefetched) continue;
+      candidates.push_back(&entry);
+      evictable += entry.bytes;
+    }
+    if (resident_bytes_ - evictable + bytes > memory_budget_) return false;
+
+    // evict maps that were used before (least recently used first), then prefetched ones
+    std::sort(candidates.begin(), candidates.end(), [](const Entry* a, const Entry* b)
+      {
+        if (a->prefetched != b->prefetched) return b->prefetched;
+        return a->last_use < b->last_use;
+      });
+    for (Size i = 0; i < candidates.size() && resident_bytes_ + bytes > memory_budget_; ++i)
+    {
+      candidates[i]->resident.reset();
+      candidates[i]->prefetched = false;
+      resident_bytes_ -= candidates[i]->bytes;
+    }
+    return true;
+  }
+
+  void SwathMapResidencyManager::load_(Entry& entry, std::unique_lock<std::mutex>& lock)
+  {
+    // the memory for the copy (entry.bytes) has been reserved by the caller
+    entry.loading = true;
+    OpenSwath::SpectrumAccessPtr source = entry.source->lightClone();
+    lock.unlock();
+
+    OpenSwath::SpectrumAccessPtr copy;
+    UInt64 bytes = 0;
+    try
+    {
+      copy.reset(new SpectrumAccessOpenMSInMemory(*source));
+      bytes = getMemoryUsage(*copy);
+    }
+    catch (...)
+    {
+      lock.lock();
+      resident_bytes_ -= entry.bytes;
+      entry.loading = false;
+      entry.prefetched = false;
+      changed_.notify_all();
+      throw;
+    }
+
+    lock.lock();
+    resident_bytes_ -= entry.bytes;
+    entry.bytes = bytes;
+    entry.measured = true;
+    entry.loading = false;
+    largest_map_ = std::max(largest_map_, bytes);
+    // the estimate may have been too low, the copy is only kept if it fits
+    if (makeRoom_(bytes, false) || makeRoom_(bytes, true))
+    {
+      entry.resident = copy;
+      resident_bytes_ += bytes;
+    }
+    else
+    {
+      entry.prefetched = false;
+    }
+    changed_.notify_all();
+  }
+
+  void SwathMapResidencyManager::prefetch_()
+  {
+    // maps that could not be loaded are not tried again
+    std::set<const OpenSwath::ISpectrumAccess*> failed;
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (!stop_)
+    {
+      // find the next scheduled map that is not in memory yet
+      Entry* next = nullptr;
+      for (Size k = schedule_pos_; k < schedule_.size() && next == nullptr; ++k)
+      {
+        EntryMap::iterator it = entries_.find(schedule_[k].get());
+        if (it == entries_.end())
+        {
+          Entry entry;
+          entry.source = schedule_[k];
+          entry.bytes = 0;
+          entry.measured = false;
+          entry.loading = false;
+          entry.prefetched = false;
+          entry.users = 0;
+          entry.last_use = 0;
+          it = entries_.insert(std::make_pair(schedule_[k].get(), entry)).first;
+        }
+        if (!it->second.resident && !it->second.loading && failed.find(it->first) == failed.end()) next = &it->second;
+      }
+
+      // prefetch it if it fits without evicting maps that will be needed
+      // first (its size is only estimated once any map has been loaded)
+      UInt64 bytes = next ? estimate_(*next) : 0;
+      if (next && bytes > 0 && makeRoom_(bytes, false))
+      {
+        next->bytes = bytes;
+        next->prefetched = true;
+        next->last_use = ++clock_;
+        resident_bytes_ += bytes;
+        try
+        {
+          load_(*next, lock);
+        }
+        catch (std::exception& e)
+        {
+          LOG_WARN << "Could not prefetch SWATH map: " << e.what() << std::endl;
+          failed.insert(next->source.get());
+        }
+        catch (...)
+        {
+          LOG_WARN << "Could not prefetch SWATH map" << std::endl;
+          failed.insert(next->source.get());
+        }
+        continue;
+      }
+      changed_.wait(lock);
+    }
+  }
+
+}
@@ -10,6 +10,7 @@ SpectrumAccessOpenMSInMemory.cpp
 SpectrumAccessSqMass.cpp
 SpectrumAccessTransforming.cpp
 SpectrumAccessQuadMZTransforming.cpp
+SwathMapResidencyManager.cpp
 DataAccessHelper.cpp
 SimpleOpenMSSpectraAccessFactory.cpp
 )
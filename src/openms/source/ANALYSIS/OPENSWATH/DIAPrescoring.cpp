@@ -40,6 +40,10 @@
 
 #include <iostream>
 
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
 namespace OpenMS
 {
 
@@ -92,91 +96,142 @@ namespace OpenMS
     }
 
     ivw->colnames(transitionsNames);
-    //iterate over spectra
 
-    for (UInt i = 0; i < swath_ptr->getNrSpectra(); ++i)
+    // the theoretical spectra only depend on the library, compute them once
+    std::vector<TheoreticalSpectrum_> theoretical(transmap.size());
+    size_t xx = 0;
+    for (Mmap::iterator beg = transmap.begin(); beg != transmap.end(); ++beg, ++xx)
     {
+      getTheoreticalSpectrum_(beg->second, theoretical[xx]);
+    }
+
+    //iterate over spectra: score blocks of spectra in parallel and store the
+    //scores in the order of the spectra
+    const SignedSize nr_spectra = swath_ptr->getNrSpectra();
+    const SignedSize block_size = 256;
+    for (SignedSize block_start = 0; block_start < nr_spectra; block_start += block_size)
+    {
+      const SignedSize block_end = std::min(nr_spectra, block_start + block_size);
+      std::vector<std::vector<double> > score1v(block_end - block_start);
+      std::vector<std::vector<double> > score2v(block_end - block_start);
+      std::vector<double> rts(block_end - block_start);
+      Size err_count(0);
+      std::exception_ptr err;
+#ifdef _OPENMP
+#pragma omp parallel
+#endif
+      {
+        OpenSwath::SpectrumAccessPtr local_swath_ptr = swath_ptr;
+#ifdef _OPENMP
+        // multiple threads must not share a single filestream (e.g. for cached data)
+        if (omp_get_num_threads() > 1)
+        {
+          local_swath_ptr = swath_ptr->lightClone();
+        }
+#pragma omp for schedule(dynamic)
+#endif
+        for (SignedSize i = block_start; i < block_end; ++i)
+        {
+          try
+          {
+            OpenSwath::SpectrumPtr spec = local_swath_ptr->getSpectrumById(i);
+            rts[i - block_start] = local_swath_ptr->getSpectrumMetaById(i).RT;
 
-      OpenSwath::SpectrumPtr spec = swath_ptr->getSpectrumById(i);
-      OpenSwath::SpectrumMeta specmeta = swath_ptr->getSpectrumMetaById(i);
-      std::cout << "Processing Spectrum  " << i << "RT " << specmeta.RT << std::endl;
-
-      //iterate over spectra
-      size_t xx = 0;
-      Mmap::iterator beg = transmap.begin();
-      Mmap::iterator end = transmap.end();
-      std::vector<double> score1v;
-      std::vector<double> score2v;
-      for (; beg != end; ++beg, ++xx)
+            //iterate over transition groups
+            std::vector<double>& s1 = score1v[i - block_start];
+            std::vector<double>& s2 = score2v[i - block_start];
+            s1.resize(theoretical.size());
+            s2.resize(theoretical.size());
+            for (Size k = 0; k < theoretical.size(); ++k)
+            {
+              score_(spec, theoretical[k], s1[k], s2[k]);
+            }
+          }
+          catch (...)
+          {
+#ifdef _OPENMP
+#pragma omp critical (DiaPrescore_error)
+#endif
+            {
+              if (err_count++ == 0) err = std::current_exception();
+            }
+          }
+        } //end of forloop over spectra
+      }
+      if (err_count > 0)
       {
-        //std::cout << "analysing transition" << xx << beg->second.size()
-        //    << " " << beg->first << std::endl;
-        double score1;
-        double score2;
-        //OpenSwath::LightPeptide pep;
-        score(spec, beg->second, score1, score2);
-
-        score1v.push_back(score1);
-        score2v.push_back(score2);
-      } //end of forloop over transitions
-
-      //std::string ispectrum = boost::lexical_cast<std::string>(i);
-      std::string specRT = boost::lexical_cast<std::string>(specmeta.RT);
-      ivw->store("score1_" + specRT, score1v);
-      ivw->store("score2_" + specRT, score2v);
-    } //end of forloop over spectra
+        std::rethrow_exception(err);
+      }
+
+      for (SignedSize i = block_start; i < block_end; ++i)
+      {
+        std::cout << "Processing Spectrum  " << i << "RT " << rts[i - block_start] << std::endl;
+        //std::string ispectrum = boost::lexical_cast<std::string>(i);
+        std::string specRT = boost::lexical_cast<std::string>(rts[i - block_start]);
+        ivw->store("score1_" + specRT, score1v[i - block_start]);
+        ivw->store("score2_" + specRT, score2v[i - block_start]);
+      }
+    } //end of forloop over blocks
   }
 
   void DiaPrescore::score(OpenSwath::SpectrumPtr spec,
                           const std::vector<OpenSwath::LightTransition>& lt,
                           double& dotprod,
                           double& manhattan)
+  {
+    TheoreticalSpectrum_ theoretical;
+    getTheoreticalSpectrum_(lt, theoretical);
+    score_(spec, theoretical, dotprod, manhattan);
+  }
+
+  void DiaPrescore::getTheoreticalSpectrum_(const std::vector<OpenSwath::LightTransition>& lt,
+                                            TheoreticalSpectrum_& theoretical) const
   {
     std::vector<std::pair<double, double> > res;
     getMZIntensityFromTransition(lt, res);
-    std::vector<double> firstIstotope, theomasses;
+    std::vector<double> firstIstotope;
     DIAHelpers::extractFirst(res, firstIstotope);
-    std::vector<std::pair<double, double> > spectrum, spectrum2;
+    std::vector<std::pair<double, double> > spectrum;
     DIAHelpers::addIsotopes2Spec(res, spectrum, nr_charges_);
-    spectrum2.resize(spectrum.size());
-    std::copy(spectrum.begin(), spectrum.end(), spectrum2.begin());
     //std::cout << spectrum.size() << std::endl;
     DIAHelpers::addPreisotopeWeights(firstIstotope, spectrum, 2, 0.0);
     //extracts masses from spectrum
-    DIAHelpers::extractFirst(spectrum, theomasses);
-    std::vector<double>  theorint;
+    DIAHelpers::extractFirst(spectrum, theoretical.masses);
+    std::vector<double>& theorint = theoretical.intensities_manhattan;
     DIAHelpers::extractSecond(spectrum, theorint);
+    std::transform(theorint.begin(), theorint.end(), theorint.begin(), OpenSwath::mySqrt());
+    double intTheorTotal = std::accumulate(theorint.begin(), theorint.end(), 0.0);
+    OpenSwath::normalize(theorint, intTheorTotal, theorint);
+
+    // the dot product uses the same theoretical intensities, normalized to unit length
+    std::vector<double>& theorint2 = theoretical.intensities_dotprod;
+    DIAHelpers::extractSecond(spectrum, theorint2);
+    std::transform(theorint2.begin(), theorint2.end(), theorint2.begin(), OpenSwath::mySqrt());
+    intTheorTotal = OpenSwath::norm(theorint2.begin(), theorint2.end());
+    OpenSwath::normalize(theorint2, intTheorTotal, theorint2);
+  }
+
+  void DiaPrescore::score_(OpenSwath::SpectrumPtr spec,
+                           const TheoreticalSpectrum_& theoretical,
+                           double& dotprod,
+                           double& manhattan) const
+  {
     std::vector<double> intExp, mzExp;
-    integrateWindows(spec, theomasses, dia_extract_window_, intExp,
+    integrateWindows(spec, theoretical.masses, dia_extract_window_, intExp,
                      mzExp);
     std::transform(intExp.begin(), intExp.end(), intExp.begin(), OpenSwath::mySqrt());
-    std::transform(theorint.begin(), theorint.end(), theorint.begin(), OpenSwath::mySqrt());
 
     double intExptotal = std::accumulate(intExp.begin(), intExp.end(), 0.0);
-    double intTheorTotal = std::accumulate(theorint.begin(), theorint.end(), 0.0);
-
     OpenSwath::normalize(intExp, intExptotal, intExp);
-    OpenSwath::normalize(theorint, intTheorTotal, theorint);
 
-    manhattan = OpenSwath::manhattanDist(intExp.begin(), intExp.end(), theorint.begin());
-
-    //std::cout << spectrum.size() << std::endl;
-    DIAHelpers::addPreisotopeWeights(firstIstotope, spectrum2, 2, -0.5);
-    std::vector<double>  theorint2;
-    DIAHelpers::extractSecond(spectrum, theorint2);
-    std::transform(theorint2.begin(), theorint2.end(), theorint2.begin(), OpenSwath::mySqrt());
+    manhattan = OpenSwath::manhattanDist(intExp.begin(), intExp.end(), theoretical.intensities_manhattan.begin());
 
     intExptotal = OpenSwath::norm(intExp.begin(), intExp.end());
-    intTheorTotal = OpenSwath::norm(theorint2.begin(), theorint2.end());
-
     OpenSwath::normalize(intExp, intExptotal, intExp);
-    OpenSwath::normalize(theorint2, intTheorTotal, theorint2);
 
     //    std::copy(intExp.begin(), intExp.end(), std::ostream_iterator<double>(std::cout, ", "));
     //    std::cout << std::endl;
-    //    std::copy(theorint2.begin(), theorint2.end(), std::ostream_iterator<double>(std::cout, ", "));
-    //    std::cout << std::endl;
-    dotprod = OpenSwath::dotProd(intExp.begin(), intExp.end(), theorint2.begin());
+    dotprod = OpenSwath::dotProd(intExp.begin(), intExp.end(), theoretical.intensities_dotprod.begin());
   }
 
   void DiaPrescore::updateMembers_()
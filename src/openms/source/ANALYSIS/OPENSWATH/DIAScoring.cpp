@@ -44,6 +44,7 @@
 #include <OpenMS/ANALYSIS/OPENSWATH/DIAHelper.h>
 
 #include <OpenMS/ANALYSIS/OPENSWATH/DIAPrescoring.h>
+#include <OpenMS/ANALYSIS/OPENSWATH/OpenSwathLibraryCache.h>
 
 #include <OpenMS/CHEMISTRY/TheoreticalSpectrumGenerator.h>
 #include <OpenMS/MATH/MISC/MathFunctions.h> // getPPM
@@ -74,7 +75,8 @@ namespace OpenMS
   }
 
   DIAScoring::DIAScoring() :
-    DefaultParamHandler("DIAScoring")
+    DefaultParamHandler("DIAScoring"),
+    library_cache_(nullptr)
   {
 
     defaults_.setValue("dia_extraction_window", 0.05, "DIA extraction window in Th or ppm.");
@@ -247,9 +249,18 @@ namespace OpenMS
     yseries_score = 0;
     OPENMS_PRECONDITION(charge > 0, "Charge is a positive integer"); // for peptides, charge should be positive
 
-    double mz, intensity, left, right;
     std::vector<double> yseries, bseries;
     OpenMS::DIAHelpers::getBYSeries(sequence, bseries, yseries, generator, charge);
+    dia_by_ion_score(spectrum, bseries, yseries, bseries_score, yseries_score);
+  }
+
+  void DIAScoring::dia_by_ion_score(SpectrumPtrType spectrum, const std::vector<double>& bseries,
+                                    const std::vector<double>& yseries, double& bseries_score, double& yseries_score)
+  {
+    bseries_score = 0;
+    yseries_score = 0;
+
+    double mz, intensity, left, right;
     for (Size it = 0; it < bseries.size(); it++)
     {
       left = bseries[it];
@@ -278,6 +289,29 @@ namespace OpenMS
     }
   }
 
+  void DIAScoring::getBYSeries(const AASequence& sequence, int charge,
+                               std::vector<double>& bseries, std::vector<double>& yseries) const
+  {
+    OPENMS_PRECONDITION(charge > 0, "Charge is a positive integer"); // for peptides, charge should be positive
+    bseries.clear();
+    yseries.clear();
+    OpenMS::DIAHelpers::getBYSeries(sequence, bseries, yseries, generator, charge);
+  }
+
+  void DIAScoring::setLibraryCache(const OpenSwathLibraryCache* cache)
+  {
+    library_cache_ = cache;
+  }
+
+  const OpenSwathLibraryCache* DIAScoring::getLibraryCache() const
+  {
+    if (library_cache_ == nullptr || library_cache_->getNrIsotopes() != (Int)dia_nr_isotopes_)
+    {
+      return nullptr;
+    }
+    return library_cache_;
+  }
+
   void DIAScoring::score_with_isotopes(SpectrumPtrType spectrum, const std::vector<TransitionType>& transitions,
                                        double& dotprod, double& manhattan)
   {
@@ -309,6 +343,7 @@ namespace OpenMS
     std::vector<double> isotopes_int;
     double max_ratio;
     int nr_occurences;
+    const OpenSwathLibraryCache* cache = getLibraryCache();
     for (Size k = 0; k < transitions.size(); k++)
     {
       isotopes_int.clear();
@@ -337,7 +372,16 @@ namespace OpenMS
 
       // calculate the scores:
       // isotope correlation (forward) and the isotope overlap (backward) scores
-      double score = scoreIsotopePattern_(transitions[k].getProductMZ(), isotopes_int, putative_fragment_charge);
+      const std::vector<double>* theoretical_isotopes = (cache != nullptr) ? cache->getIsotopePattern(transitions[k].getNativeID()) : nullptr;
+      double score;
+      if (theoretical_isotopes != nullptr)
+      {
+        score = scoreIsotopePattern_(isotopes_int, *theoretical_isotopes);
+      }
+      else
+      {
+        score = scoreIsotopePattern_(transitions[k].getProductMZ(), isotopes_int, putative_fragment_charge);
+      }
       isotope_corr += score * rel_intensity;
       largePeaksBeforeFirstIsotope_(spectrum, transitions[k].getProductMZ(), isotopes_int[0], nr_occurences, max_ratio);
       isotope_overlap += nr_occurences * rel_intensity;
@@ -397,11 +441,28 @@ namespace OpenMS
                                           int putative_fragment_charge,
                                           const std::string& sum_formula)
   {
-    OPENMS_PRECONDITION(putative_fragment_charge != 0, "Charge needs to be set"); // charge can be positive and negative
+    std::vector<double> theoretical_isotopes;
+    getTheoreticalIsotopePattern(product_mz, putative_fragment_charge, theoretical_isotopes, sum_formula);
+    return scoreIsotopePattern_(isotopes_int, theoretical_isotopes);
+  } //end of dia_isotope_corr_sub
 
-    typedef OpenMS::FeatureFinderAlgorithmPickedHelperStructs::TheoreticalIsotopePattern TheoreticalIsotopePattern;
+  double DIAScoring::scoreIsotopePattern_(const std::vector<double>& isotopes_int,
+                                          const std::vector<double>& theoretical_isotopes) const
+  {
+    // score the pattern against a theoretical one
+    double int_score = OpenSwath::cor_pearson(isotopes_int.begin(), isotopes_int.end(), theoretical_isotopes.begin());
+    if (boost::math::isnan(int_score))
+    {
+      int_score = 0;
+    }
+    return int_score;
+  }
+
+  void DIAScoring::getTheoreticalIsotopePattern(double product_mz, int putative_fragment_charge,
+                                                std::vector<double>& isotopes, const std::string& sum_formula) const
+  {
+    OPENMS_PRECONDITION(putative_fragment_charge != 0, "Charge needs to be set"); // charge can be positive and negative
 
-    TheoreticalIsotopePattern isotopes;
     IsotopeDistribution isotope_dist;
     if (!sum_formula.empty())
     {
@@ -416,38 +477,25 @@ namespace OpenMS
       isotope_dist = solver.estimateFromPeptideWeight(std::fabs(product_mz * putative_fragment_charge));
     }
 
-
+    isotopes.clear();
     for (IsotopeDistribution::Iterator it = isotope_dist.begin(); it != isotope_dist.end(); ++it)
     {
-      isotopes.intensity.push_back(it->getIntensity());
+      isotopes.push_back(it->getIntensity());
     }
-    isotopes.optional_begin = 0;
-    isotopes.optional_end = dia_nr_isotopes_;
 
     // scale the distribution to a maximum of 1
     double max = 0.0;
-    for (Size i = 0; i < isotopes.intensity.size(); ++i)
+    for (Size i = 0; i < isotopes.size(); ++i)
     {
-      if (isotopes.intensity[i] > max)
+      if (isotopes[i] > max)
       {
-        max = isotopes.intensity[i];
+        max = isotopes[i];
       }
     }
-    isotopes.max = max;
-    for (Size i = 0; i < isotopes.intensity.size(); ++i)
-    {
-      isotopes.intensity[i] /= max;
-    }
-    isotopes.trimmed_left = 0;
-
-    // score the pattern against a theoretical one
-    double int_score = OpenSwath::cor_pearson(isotopes_int.begin(), isotopes_int.end(), isotopes.intensity.begin());
-    if (boost::math::isnan(int_score))
+    for (Size i = 0; i < isotopes.size(); ++i)
     {
-      int_score = 0;
+      isotopes[i] /= max;
     }
-    return int_score;
-
-  } //end of dia_isotope_corr_sub
+  }
 
 }
@@ -0,0 +1,177 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2018.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: Hannes Roest $
+// $Authors: Hannes Roest $
+// --------------------------------------------------------------------------
+
+#include <OpenMS/ANALYSIS/OPENSWATH/IonMobilityFrame.h>
+
+#include <OpenMS/CONCEPT/Exception.h>
+
+#include <algorithm>
+#include <numeric>
+
+namespace OpenMS
+{
+
+  IonMobilityFrame::IonMobilityFrame() :
+    scan_begin_(1, 0)
+  {
+  }
+
+  IonMobilityFrame::IonMobilityFrame(const OpenSwath::SpectrumPtr& spectrum) :
+    scan_begin_(1, 0)
+  {
+    OpenSwath::BinaryDataArrayPtr mz_arr = spectrum->getMZArray();
+    OpenSwath::BinaryDataArrayPtr int_arr = spectrum->getIntensityArray();
+    OpenSwath::BinaryDataArrayPtr im_arr = spectrum->getDriftTimeArray();
+    if (im_arr == nullptr || im_arr->data.size() != mz_arr->data.size())
+    {
+      throw Exception::IllegalArgument(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION,
+        "Cannot build an ion mobility frame without ion mobility array (looked for 'Ion Mobility').");
+    }
+
+    const std::vector<double>& mz = mz_arr->data;
+    const std::vector<double>& intensity = int_arr->data;
+    const std::vector<double>& im = im_arr->data;
+
+    // order the data points by (ion mobility, m/z)
+    std::vector<Size> order(mz.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::sort(order.begin(), order.end(), [&im, &mz](Size a, Size b)
+    {
+      return im[a] < im[b] || (im[a] == im[b] && mz[a] < mz[b]);
+    });
+
+    im_.reserve(order.size());
+    mz_.reserve(order.size());
+    int_.reserve(order.size());
+    scan_begin_.clear();
+    for (Size i = 0; i < order.size(); ++i)
+    {
+      const Size k = order[i];
+      if (i == 0 || im[k] != im_.back())
+      {
+        scan_im_.push_back(im[k]);
+        scan_begin_.push_back(i);
+      }
+      im_.push_back(im[k]);
+      mz_.push_back(mz[k]);
+      int_.push_back(intensity[k]);
+    }
+    scan_begin_.push_back(order.size());
+  }
+
+  Size IonMobilityFrame::size() const
+  {
+    return mz_.size();
+  }
+
+  Size IonMobilityFrame::getNrScans() const
+  {
+    return scan_im_.size();
+  }
+
+  void IonMobilityFrame::scanRange_(double im_lower, double im_upper, Size& first, Size& last) const
+  {
+    first = std::upper_bound(scan_im_.begin(), scan_im_.end(), im_lower) - scan_im_.begin();
+    last = std::lower_bound(scan_im_.begin() + first, scan_im_.end(), im_upper) - scan_im_.begin();
+  }
+
+  double IonMobilityFrame::sumIntensity(double mz_lower, double mz_upper, double im_lower, double im_upper) const
+  {
+    Size first_scan, last_scan;
+    scanRange_(im_lower, im_upper, first_scan, last_scan);
+
+    double sum = 0.0;
+    for (Size s = first_scan; s < last_scan; ++s)
+    {
+      std::vector<double>::const_iterator scan_start = mz_.begin() + scan_begin_[s];
+      std::vector<double>::const_iterator scan_end = mz_.begin() + scan_begin_[s + 1];
+      std::vector<double>::const_iterator first = std::upper_bound(scan_start, scan_end, mz_lower);
+      std::vector<double>::const_iterator last = std::lower_bound(first, scan_end, mz_upper);
+      for (Size i = first - mz_.begin(); i < Size(last - mz_.begin()); ++i)
+      {
+        sum += int_[i];
+      }
+    }
+    return sum;
+  }
+
+  OpenSwath::SpectrumPtr IonMobilityFrame::extractSpectrum(double im_lower, double im_upper) const
+  {
+    Size first_scan, last_scan;
+    scanRange_(im_lower, im_upper, first_scan, last_scan);
+    const Size first = scan_begin_[first_scan];
+    const Size last = scan_begin_[last_scan];
+
+    // restore m/z order of the data points inside the window
+    std::vector<Size> order(last - first);
+    std::iota(order.begin(), order.end(), first);
+    std::stable_sort(order.begin(), order.end(), [this](Size a, Size b) { return mz_[a] < mz_[b]; });
+
+    OpenSwath::BinaryDataArrayPtr mz_arr(new OpenSwath::BinaryDataArray);
+    OpenSwath::BinaryDataArrayPtr int_arr(new OpenSwath::BinaryDataArray);
+    OpenSwath::BinaryDataArrayPtr im_arr(new OpenSwath::BinaryDataArray);
+    im_arr->description = "Ion Mobility";
+    mz_arr->data.reserve(order.size());
+    int_arr->data.reserve(order.size());
+    im_arr->data.reserve(order.size());
+    for (Size k : order)
+    {
+      mz_arr->data.push_back(mz_[k]);
+      int_arr->data.push_back(int_[k]);
+      im_arr->data.push_back(im_[k]);
+    }
+
+    OpenSwath::SpectrumPtr spectrum(new OpenSwath::Spectrum);
+    spectrum->setMZArray(mz_arr);
+    spectrum->setIntensityArray(int_arr);
+    spectrum->getDataArrays().push_back(im_arr);
+    return spectrum;
+  }
+
+  const std::vector<double>& IonMobilityFrame::getMobilities() const
+  {
+    return im_;
+  }
+
+  const std::vector<double>& IonMobilityFrame::getMZs() const
+  {
+    return mz_;
+  }
+
+  const std::vector<double>& IonMobilityFrame::getIntensities() const
+  {
+    return int_;
+  }
+
+}
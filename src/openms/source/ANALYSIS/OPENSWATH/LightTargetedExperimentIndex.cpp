@@ -0,0 +1,162 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2018.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: Hannes Roest $
+// $Authors: Hannes Roest $
+// --------------------------------------------------------------------------
+
+
+#include <OpenMS/ANALYSIS/OPENSWATH/LightTargetedExperimentIndex.h>
+
+#include <algorithm>
+
+namespace OpenMS
+{
+
+  LightTargetedExperimentIndex::LightTargetedExperimentIndex(const OpenSwath::LightTargetedExperiment& experiment) :
+    experiment_(experiment)
+  {
+    const std::vector<OpenSwath::LightCompound>& compounds = experiment.compounds;
+    const std::vector<OpenSwath::LightTransition>& transitions = experiment.transitions;
+
+    compound_index_.reserve(compounds.size());
+    compounds_by_rt_.reserve(compounds.size());
+    for (Size i = 0; i < compounds.size(); ++i)
+    {
+      compound_index_.insert(std::make_pair(compounds[i].id, i)); // keeps the first one
+      compounds_by_rt_.push_back(std::make_pair(compounds[i].rt, i));
+    }
+    std::sort(compounds_by_rt_.begin(), compounds_by_rt_.end());
+
+    protein_index_.reserve(experiment.proteins.size());
+    for (Size i = 0; i < experiment.proteins.size(); ++i)
+    {
+      protein_index_.insert(std::make_pair(experiment.proteins[i].id, i));
+    }
+
+    compound_transitions_.resize(compounds.size());
+    transition_compound_.resize(transitions.size());
+    transitions_by_mz_.reserve(transitions.size());
+    for (Size i = 0; i < transitions.size(); ++i)
+    {
+      transitions_by_mz_.push_back(std::make_pair(transitions[i].precursor_mz, i));
+      SignedSize c = getCompoundIndex(transitions[i].peptide_ref);
+      transition_compound_[i] = c;
+      if (c >= 0)
+      {
+        compound_transitions_[c].push_back(i);
+      }
+    }
+    std::sort(transitions_by_mz_.begin(), transitions_by_mz_.end());
+  }
+
+  const OpenSwath::LightTargetedExperiment& LightTargetedExperimentIndex::getExperiment() const
+  {
+    return experiment_;
+  }
+
+  SignedSize LightTargetedExperimentIndex::getCompoundIndex(const std::string& id) const
+  {
+    std::unordered_map<std::string, Size>::const_iterator it = compound_index_.find(id);
+    return (it != compound_index_.end()) ? (SignedSize)it->second : -1;
+  }
+
+  SignedSize LightTargetedExperimentIndex::getProteinIndex(const std::string& id) const
+  {
+    std::unordered_map<std::string, Size>::const_iterator it = protein_index_.find(id);
+    return (it != protein_index_.end()) ? (SignedSize)it->second : -1;
+  }
+
+  SignedSize LightTargetedExperimentIndex::getTransitionCompound(Size transition_index) const
+  {
+    return transition_compound_[transition_index];
+  }
+
+  const std::vector<Size>& LightTargetedExperimentIndex::getCompoundTransitions(Size compound_index) const
+  {
+    return compound_transitions_[compound_index];
+  }
+
+  void LightTargetedExperimentIndex::selectTransitions(double lower, double upper, std::vector<Size>& result) const
+  {
+    result.clear();
+    // first entry with m/z > lower, first entry with m/z >= upper
+    std::vector<std::pair<double, Size> >::const_iterator first = std::upper_bound(transitions_by_mz_.begin(), transitions_by_mz_.end(),
+      lower, [](double value, const std::pair<double, Size>& entry) { return value < entry.first; });
+    std::vector<std::pair<double, Size> >::const_iterator last = std::lower_bound(first, transitions_by_mz_.end(),
+      upper, [](const std::pair<double, Size>& entry, double value) { return entry.first < value; });
+    result.reserve(last - first);
+    for (; first != last; ++first)
+    {
+      result.push_back(first->second);
+    }
+    std::sort(result.begin(), result.end());
+  }
+
+  void LightTargetedExperimentIndex::selectTransitions(double lower, double upper, double rt_start, double rt_end,
+                                                       std::vector<Size>& result) const
+  {
+    selectTransitions(lower, upper, result);
+    const std::vector<OpenSwath::LightCompound>& compounds = experiment_.compounds;
+    std::vector<Size>::iterator new_end = std::remove_if(result.begin(), result.end(), [&](Size t)
+      {
+        SignedSize c = transition_compound_[t];
+        return c < 0 || compounds[c].rt < rt_start || compounds[c].rt > rt_end;
+      });
+    result.erase(new_end, result.end());
+  }
+
+  void LightTargetedExperimentIndex::selectCompounds(double rt_start, double rt_end, std::vector<Size>& result) const
+  {
+    result.clear();
+    std::vector<std::pair<double, Size> >::const_iterator first = std::lower_bound(compounds_by_rt_.begin(), compounds_by_rt_.end(),
+      rt_start, [](const std::pair<double, Size>& entry, double value) { return entry.first < value; });
+    std::vector<std::pair<double, Size> >::const_iterator last = std::upper_bound(first, compounds_by_rt_.end(),
+      rt_end, [](double value, const std::pair<double, Size>& entry) { return value < entry.first; });
+    result.reserve(last - first);
+    for (; first != last; ++first)
+    {
+      result.push_back(first->second);
+    }
+    std::sort(result.begin(), result.end());
+  }
+
+  void LightTargetedExperimentIndex::selectCompoundTransitions(const std::vector<Size>& compound_indices, std::vector<Size>& result) const
+  {
+    Size offset = result.size();
+    for (Size i = 0; i < compound_indices.size(); ++i)
+    {
+      const std::vector<Size>& transitions = compound_transitions_[compound_indices[i]];
+      result.insert(result.end(), transitions.begin(), transitions.end());
+    }
+    std::sort(result.begin() + offset, result.end());
+  }
+
+}
@@ -34,6 +34,12 @@
 
 #include <OpenMS/ANALYSIS/OPENSWATH/MRMAssay.h>
 
+#include <boost/numeric/conversion/cast.hpp>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
 namespace OpenMS
 {
   MRMAssay::MRMAssay()
@@ -687,12 +693,8 @@ namespace OpenMS
                              bool enable_unspecific_losses,
                              int round_decPow)
   {
-    PeptideVectorType peptides;
-    ProteinVectorType proteins;
     TransitionVectorType transitions;
 
-    OpenMS::MRMIonSeries mrmis;
-
     // hash of the peptide reference containing all transitions
     MRMAssay::PeptideTransitionMapType peptide_trans_map;
     for (Size i = 0; i < exp.getTransitions().size(); i++)
@@ -700,72 +702,127 @@ namespace OpenMS
       peptide_trans_map[exp.getTransitions()[i].getPeptideRef()].push_back(&exp.getTransitions()[i]);
     }
 
+    // Look up the peptides and their sequences first: the peptide reference
+    // map of the TargetedExperiment and the residue database are not
+    // thread-safe
+    std::vector<MRMAssay::PeptideTransitionMapType::const_iterator> peptide_its;
+    std::vector<const TargetedExperiment::Peptide*> target_peptides;
+    std::vector<OpenMS::AASequence> target_sequences;
+    for (MRMAssay::PeptideTransitionMapType::const_iterator pep_it = peptide_trans_map.begin();
+         pep_it != peptide_trans_map.end(); ++pep_it)
+    {
+      const TargetedExperiment::Peptide& target_peptide = exp.getPeptideByRef(pep_it->first);
+      peptide_its.push_back(pep_it);
+      target_peptides.push_back(&target_peptide);
+      target_sequences.push_back(TargetedExperimentHelper::getAASequence(target_peptide));
+    }
+
+    // Annotate the transitions of each peptide in parallel, the results are
+    // collected per peptide to keep the order of the output independent of
+    // the number of threads
+    std::vector<TransitionVectorType> peptide_transitions(peptide_its.size());
     Size progress = 0;
+    Size err_count(0);
+    std::exception_ptr err;
     startProgress(0, exp.getTransitions().size(), "Annotating transitions");
-    for (MRMAssay::PeptideTransitionMapType::iterator pep_it = peptide_trans_map.begin();
-         pep_it != peptide_trans_map.end(); ++pep_it)
+#ifdef _OPENMP
+#pragma omp parallel
+#endif
     {
-      String peptide_ref = pep_it->first;
+      OpenMS::MRMIonSeries mrmis;
 
-      TargetedExperiment::Peptide target_peptide = exp.getPeptideByRef(peptide_ref);
-      OpenMS::AASequence target_peptide_sequence = TargetedExperimentHelper::getAASequence(target_peptide);
+#ifdef _OPENMP
+#pragma omp for schedule(dynamic)
+#endif
+      for (SignedSize k = 0; k < boost::numeric_cast<SignedSize>(peptide_its.size()); ++k)
+      {
+        try
+        {
+          const TargetedExperiment::Peptide& target_peptide = *target_peptides[k];
+          const OpenMS::AASequence& target_peptide_sequence = target_sequences[k];
+          const std::vector<const ReactionMonitoringTransition*>& peptide_trs = peptide_its[k]->second;
 
-      int precursor_charge = 1;
-      if (target_peptide.hasCharge()) {precursor_charge = target_peptide.getChargeState();}
+          int precursor_charge = 1;
+          if (target_peptide.hasCharge()) {precursor_charge = target_peptide.getChargeState();}
 
-      MRMIonSeries::IonSeries target_ionseries = mrmis.getIonSeries(
-                                                    target_peptide_sequence, precursor_charge, fragment_types,
-                                                    fragment_charges, enable_specific_losses,
-                                                    enable_unspecific_losses, round_decPow);
+          MRMIonSeries::IonSeries target_ionseries = mrmis.getIonSeries(
+                                                        target_peptide_sequence, precursor_charge, fragment_types,
+                                                        fragment_charges, enable_specific_losses,
+                                                        enable_unspecific_losses, round_decPow);
 
-      // Generate theoretical precursor m.z
-      double precursor_mz = target_peptide_sequence.getMonoWeight(Residue::Full, precursor_charge) / precursor_charge;
-      precursor_mz = Math::roundDecimal(precursor_mz, round_decPow);
+          // Generate theoretical precursor m.z
+          double precursor_mz = target_peptide_sequence.getMonoWeight(Residue::Full, precursor_charge) / precursor_charge;
+          precursor_mz = Math::roundDecimal(precursor_mz, round_decPow);
 
-      for (Size i = 0; i < pep_it->second.size(); i++)
-      {
-        setProgress(++progress);
-        ReactionMonitoringTransition tr = *(pep_it->second[i]);
+          for (Size i = 0; i < peptide_trs.size(); i++)
+          {
+            ReactionMonitoringTransition tr = *(peptide_trs[i]);
 
-        // Annotate transition from theoretical ion series
-        std::pair<String, double> targetion = mrmis.annotateIon(target_ionseries, tr.getProductMZ(), product_mz_threshold);
+            // Annotate transition from theoretical ion series
+            std::pair<String, double> targetion = mrmis.annotateIon(target_ionseries, tr.getProductMZ(), product_mz_threshold);
 
-        // Ensure that precursor m/z is within threshold
-        if (std::fabs(tr.getPrecursorMZ() - precursor_mz) > precursor_mz_threshold)
-        {
-          targetion.first = "unannotated";
-        }
+            // Ensure that precursor m/z is within threshold
+            if (std::fabs(tr.getPrecursorMZ() - precursor_mz) > precursor_mz_threshold)
+            {
+              targetion.first = "unannotated";
+            }
 
-        // Set precursor m/z to theoretical value
-        tr.setPrecursorMZ(precursor_mz);
+            // Set precursor m/z to theoretical value
+            tr.setPrecursorMZ(precursor_mz);
 
-        // Set product m/z to theoretical value
-        tr.setProductMZ(targetion.second);
+            // Set product m/z to theoretical value
+            tr.setProductMZ(targetion.second);
 
-        // Skip unannotated transitions from previous step
-        if (targetion.first == "unannotated")
-        {
-          LOG_DEBUG << "[unannotated] Skipping " << target_peptide_sequence.toString() 
-            << " PrecursorMZ: " << tr.getPrecursorMZ() << " ProductMZ: " << tr.getProductMZ() 
-            << " " << tr.getMetaValue("annotation") << std::endl;
-          continue;
+            // Skip unannotated transitions from previous step
+            if (targetion.first == "unannotated")
+            {
+              LOG_DEBUG << "[unannotated] Skipping " << target_peptide_sequence.toString() 
+                << " PrecursorMZ: " << tr.getPrecursorMZ() << " ProductMZ: " << tr.getProductMZ() 
+                << " " << tr.getMetaValue("annotation") << std::endl;
+              continue;
+            }
+            else
+            {
+              LOG_DEBUG << "[selected] " << target_peptide_sequence.toString() << " PrecursorMZ: " << tr.getPrecursorMZ() << " ProductMZ: " << tr.getProductMZ() << " " << tr.getMetaValue("annotation") << std::endl;
+            }
+
+            // Set CV terms
+            mrmis.annotateTransitionCV(tr, targetion.first);
+
+            // Add reference to parent precursor
+            tr.setPeptideRef(target_peptide.id);
+
+            // Append transition
+            peptide_transitions[k].push_back(tr);
+          }
         }
-        else
+        catch (...)
         {
-          LOG_DEBUG << "[selected] " << target_peptide_sequence.toString() << " PrecursorMZ: " << tr.getPrecursorMZ() << " ProductMZ: " << tr.getProductMZ() << " " << tr.getMetaValue("annotation") << std::endl;
+#ifdef _OPENMP
+#pragma omp critical (MRMAssay_error)
+#endif
+          {
+            if (err_count++ == 0) err = std::current_exception();
+          }
         }
 
-        // Set CV terms
-        mrmis.annotateTransitionCV(tr, targetion.first);
-
-        // Add reference to parent precursor
-        tr.setPeptideRef(target_peptide.id);
-
-        // Append transition
-        transitions.push_back(tr);
+#ifdef _OPENMP
+#pragma omp atomic
+#endif
+        progress += peptide_its[k]->second.size();
+        IF_MASTERTHREAD setProgress(progress);
       }
     }
     endProgress();
+    if (err_count > 0)
+    {
+      std::rethrow_exception(err);
+    }
+
+    for (Size k = 0; k < peptide_transitions.size(); ++k)
+    {
+      transitions.insert(transitions.end(), peptide_transitions[k].begin(), peptide_transitions[k].end());
+    }
 
     exp.setTransitions(transitions);
   }
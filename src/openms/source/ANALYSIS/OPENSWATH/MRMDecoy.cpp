@@ -38,6 +38,12 @@
 
 #include <OpenMS/CONCEPT/LogStream.h>
 
+#include <boost/numeric/conversion/cast.hpp>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
 namespace OpenMS
 {
 
@@ -376,7 +382,6 @@ namespace OpenMS
                                 const std::vector<String>& fragment_types, const std::vector<size_t>& fragment_charges,
                                 const bool enable_specific_losses, const bool enable_unspecific_losses, const int round_decPow) const
   {
-    MRMIonSeries mrmis;
     MRMDecoy::PeptideVectorType peptides, decoy_peptides;
     MRMDecoy::ProteinVectorType proteins, decoy_proteins;
     MRMDecoy::TransitionVectorType decoy_transitions;
@@ -411,7 +416,7 @@ namespace OpenMS
       selection_list = item_list;
     }
 
-    std::vector<String> exclusion_peptides;
+    std::set<String> exclusion_peptides;
     // Go through all peptides and apply the decoy method to the sequence
     // (pseudo-reverse, reverse or shuffle). Then set the peptides and proteins of the decoy
     // experiment.
@@ -436,7 +441,7 @@ namespace OpenMS
         if (MRMDecoy::hasCNterminalMods_(peptide, do_switchKR))
         {
           LOG_DEBUG << "[peptide] Skipping " << peptide.id << " due to C/N-terminal modifications" << std::endl;
-          exclusion_peptides.push_back(peptide.id);
+          exclusion_peptides.insert(peptide.id);
         }
         else
         {
@@ -450,7 +455,7 @@ namespace OpenMS
         if (MRMDecoy::hasCNterminalMods_(peptide, false))
         {
           LOG_DEBUG << "[peptide] Skipping " << peptide.id << " due to C/N-terminal modifications" << std::endl;
-          exclusion_peptides.push_back(peptide.id);
+          exclusion_peptides.insert(peptide.id);
         }
         else
         {
@@ -463,7 +468,7 @@ namespace OpenMS
         if (do_switchKR && MRMDecoy::hasCNterminalMods_(peptide, do_switchKR))
         {
           LOG_DEBUG << "[peptide] Skipping " << peptide.id << " due to C/N-terminal modifications" << std::endl;
-          exclusion_peptides.push_back(peptide.id);
+          exclusion_peptides.insert(peptide.id);
         }
         else if (do_switchKR) switchKR(peptide);
       }
@@ -485,105 +490,162 @@ namespace OpenMS
       peptide_trans_map[exp.getTransitions()[i].getPeptideRef()].push_back(&exp.getTransitions()[i]);
     }
 
-    progress = 0;
-    startProgress(0, peptide_trans_map.size(), "Generating decoy transitions");
-    for (MRMDecoy::PeptideTransitionMapType::iterator pep_it = peptide_trans_map.begin();
+    // Look up the target and decoy peptides and their sequences first: the
+    // peptide reference map of the TargetedExperiment and the residue
+    // database are not thread-safe
+    std::vector<MRMDecoy::PeptideTransitionMapType::const_iterator> peptide_its;
+    std::vector<const TargetedExperiment::Peptide*> target_peptide_ptrs, decoy_peptide_ptrs;
+    std::vector<OpenMS::AASequence> target_sequences, decoy_sequences;
+    for (MRMDecoy::PeptideTransitionMapType::const_iterator pep_it = peptide_trans_map.begin();
          pep_it != peptide_trans_map.end(); ++pep_it)
     {
-      setProgress(++progress);
-
-      String peptide_ref = pep_it->first;
       String decoy_peptide_ref = decoy_tag + pep_it->first; // see above, the decoy peptide id is computed deterministically from the target id
       if (!dec.hasPeptide(decoy_peptide_ref)) {continue;}
-      const TargetedExperiment::Peptide target_peptide = exp.getPeptideByRef(peptide_ref);
-
-      const TargetedExperiment::Peptide decoy_peptide = dec.getPeptideByRef(decoy_peptide_ref);
-      OpenMS::AASequence target_peptide_sequence = TargetedExperimentHelper::getAASequence(target_peptide);
-      OpenMS::AASequence decoy_peptide_sequence = TargetedExperimentHelper::getAASequence(decoy_peptide);
-
-      int decoy_charge = 1;
-      int target_charge = 1;
-      if (decoy_peptide.hasCharge()) {decoy_charge = decoy_peptide.getChargeState();}
-      if (target_peptide.hasCharge()) {target_charge = target_peptide.getChargeState();}
-
-      MRMIonSeries::IonSeries decoy_ionseries = mrmis.getIonSeries(decoy_peptide_sequence, decoy_charge,
-            fragment_types, fragment_charges, enable_specific_losses,
-            enable_unspecific_losses, round_decPow);
-      MRMIonSeries::IonSeries target_ionseries = mrmis.getIonSeries(target_peptide_sequence, target_charge,
-            fragment_types, fragment_charges, enable_specific_losses,
-            enable_unspecific_losses, round_decPow);
+      const TargetedExperiment::Peptide& target_peptide = exp.getPeptideByRef(pep_it->first);
+      const TargetedExperiment::Peptide& decoy_peptide = dec.getPeptideByRef(decoy_peptide_ref);
+      peptide_its.push_back(pep_it);
+      target_peptide_ptrs.push_back(&target_peptide);
+      decoy_peptide_ptrs.push_back(&decoy_peptide);
+      target_sequences.push_back(TargetedExperimentHelper::getAASequence(target_peptide));
+      decoy_sequences.push_back(TargetedExperimentHelper::getAASequence(decoy_peptide));
+    }
 
-      // Compute (new) decoy precursor m/z based on the K/R replacement and the AA changes in the shuffle algorithm
-      double decoy_precursor_mz = decoy_peptide_sequence.getMonoWeight(Residue::Full, decoy_charge) / decoy_charge;
-      decoy_precursor_mz += precursor_mz_shift; // fix for TOPPView: Duplicate precursor MZ is not displayed.
+    // Generate the decoy transitions of each peptide in parallel, the results
+    // are collected per peptide to keep the output order independent of the
+    // number of threads
+    std::vector<MRMDecoy::TransitionVectorType> peptide_decoy_transitions(peptide_its.size());
+    std::vector<std::vector<String> > peptide_exclusions(peptide_its.size());
+    Size err_count(0);
+    std::exception_ptr err;
+    progress = 0;
+    startProgress(0, peptide_its.size(), "Generating decoy transitions");
+#ifdef _OPENMP
+#pragma omp parallel
+#endif
+    {
+      MRMIonSeries mrmis;
 
-      for (Size i = 0; i < pep_it->second.size(); i++)
+#ifdef _OPENMP
+#pragma omp for schedule(dynamic)
+#endif
+      for (SignedSize k = 0; k < boost::numeric_cast<SignedSize>(peptide_its.size()); ++k)
       {
-        const ReactionMonitoringTransition tr = *(pep_it->second[i]);
-
-        if (!tr.isDetectingTransition() || tr.getDecoyTransitionType() == ReactionMonitoringTransition::DECOY)
+        try
         {
-          continue;
-        }
+          const TargetedExperiment::Peptide& target_peptide = *target_peptide_ptrs[k];
+          const TargetedExperiment::Peptide& decoy_peptide = *decoy_peptide_ptrs[k];
+          const OpenMS::AASequence& target_peptide_sequence = target_sequences[k];
+          const OpenMS::AASequence& decoy_peptide_sequence = decoy_sequences[k];
+          const std::vector<const ReactionMonitoringTransition*>& peptide_trs = peptide_its[k]->second;
+
+          int decoy_charge = 1;
+          int target_charge = 1;
+          if (decoy_peptide.hasCharge()) {decoy_charge = decoy_peptide.getChargeState();}
+          if (target_peptide.hasCharge()) {target_charge = target_peptide.getChargeState();}
+
+          MRMIonSeries::IonSeries decoy_ionseries = mrmis.getIonSeries(decoy_peptide_sequence, decoy_charge,
+                fragment_types, fragment_charges, enable_specific_losses,
+                enable_unspecific_losses, round_decPow);
+          MRMIonSeries::IonSeries target_ionseries = mrmis.getIonSeries(target_peptide_sequence, target_charge,
+                fragment_types, fragment_charges, enable_specific_losses,
+                enable_unspecific_losses, round_decPow);
+
+          // Compute (new) decoy precursor m/z based on the K/R replacement and the AA changes in the shuffle algorithm
+          double decoy_precursor_mz = decoy_peptide_sequence.getMonoWeight(Residue::Full, decoy_charge) / decoy_charge;
+          decoy_precursor_mz += precursor_mz_shift; // fix for TOPPView: Duplicate precursor MZ is not displayed.
+
+          for (Size i = 0; i < peptide_trs.size(); i++)
+          {
+            const ReactionMonitoringTransition tr = *(peptide_trs[i]);
 
-        ReactionMonitoringTransition decoy_tr = tr; // copy the target transition
+            if (!tr.isDetectingTransition() || tr.getDecoyTransitionType() == ReactionMonitoringTransition::DECOY)
+            {
+              continue;
+            }
 
-        decoy_tr.setNativeID(decoy_tag + tr.getNativeID());
-        decoy_tr.setDecoyTransitionType(ReactionMonitoringTransition::DECOY);
-        decoy_tr.setPrecursorMZ(decoy_precursor_mz);
+            ReactionMonitoringTransition decoy_tr = tr; // copy the target transition
 
-        // determine the current annotation for the target ion and then select
-        // the appropriate decoy ion for this target transition
-        std::pair<String, double> targetion = mrmis.annotateIon(target_ionseries, tr.getProductMZ(), product_mz_threshold);
-        std::pair<String, double> decoyion = mrmis.getIon(decoy_ionseries, targetion.first);
+            decoy_tr.setNativeID(decoy_tag + tr.getNativeID());
+            decoy_tr.setDecoyTransitionType(ReactionMonitoringTransition::DECOY);
+            decoy_tr.setPrecursorMZ(decoy_precursor_mz);
 
-        if (method == "shift")
-        {
-          decoy_tr.setProductMZ(decoyion.second + product_mz_shift);
-        }
-        else
-        {
-          decoy_tr.setProductMZ(decoyion.second);
-        }
-        decoy_tr.setPeptideRef(decoy_tag + tr.getPeptideRef());
+            // determine the current annotation for the target ion and then select
+            // the appropriate decoy ion for this target transition
+            std::pair<String, double> targetion = mrmis.annotateIon(target_ionseries, tr.getProductMZ(), product_mz_threshold);
+            std::pair<String, double> decoyion = mrmis.getIon(decoy_ionseries, targetion.first);
 
-        if (decoyion.second > 0)
-        {
-          decoy_transitions.push_back(decoy_tr);
+            if (method == "shift")
+            {
+              decoy_tr.setProductMZ(decoyion.second + product_mz_shift);
+            }
+            else
+            {
+              decoy_tr.setProductMZ(decoyion.second);
+            }
+            decoy_tr.setPeptideRef(decoy_tag + tr.getPeptideRef());
+
+            if (decoyion.second > 0)
+            {
+              peptide_decoy_transitions[k].push_back(decoy_tr);
+            }
+            else
+            {
+              // transition could not be annotated, remove whole peptide
+              peptide_exclusions[k].push_back(decoy_tr.getPeptideRef());
+              LOG_DEBUG << "[peptide] Skipping " << decoy_tr.getPeptideRef() << " due to missing annotation" << std::endl;
+            }
+          } // end loop over transitions
         }
-        else
+        catch (...)
         {
-          // transition could not be annotated, remove whole peptide
-          exclusion_peptides.push_back(decoy_tr.getPeptideRef());
-          LOG_DEBUG << "[peptide] Skipping " << decoy_tr.getPeptideRef() << " due to missing annotation" << std::endl;
+#ifdef _OPENMP
+#pragma omp critical (MRMDecoy_error)
+#endif
+          {
+            if (err_count++ == 0) err = std::current_exception();
+          }
         }
-      } // end loop over transitions
-
-    } // end loop over peptides
+#ifdef _OPENMP
+#pragma omp atomic
+#endif
+        ++progress;
+        IF_MASTERTHREAD setProgress(progress);
+      } // end loop over peptides
+    }
     endProgress();
+    if (err_count > 0)
+    {
+      std::rethrow_exception(err);
+    }
+
+    for (Size k = 0; k < peptide_its.size(); ++k)
+    {
+      decoy_transitions.insert(decoy_transitions.end(), peptide_decoy_transitions[k].begin(), peptide_decoy_transitions[k].end());
+      exclusion_peptides.insert(peptide_exclusions[k].begin(), peptide_exclusions[k].end());
+    }
 
     MRMDecoy::TransitionVectorType filtered_decoy_transitions;
     for (MRMDecoy::TransitionVectorType::iterator tr_it = decoy_transitions.begin(); tr_it != decoy_transitions.end(); ++tr_it)
     {
-      if (std::find(exclusion_peptides.begin(), exclusion_peptides.end(), tr_it->getPeptideRef()) == exclusion_peptides.end())
+      if (exclusion_peptides.find(tr_it->getPeptideRef()) == exclusion_peptides.end())
       {
         filtered_decoy_transitions.push_back(*tr_it);
       }
     }
     dec.setTransitions(filtered_decoy_transitions);
 
-    std::vector<String> protein_ids;
+    std::set<String> protein_ids;
     for (Size i = 0; i < peptides.size(); ++i)
     {
       TargetedExperiment::Peptide peptide = peptides[i];
 
       // Check if peptide has any transitions left
-      if (std::find(exclusion_peptides.begin(), exclusion_peptides.end(), peptide.id) == exclusion_peptides.end())
+      if (exclusion_peptides.find(peptide.id) == exclusion_peptides.end())
       {
         decoy_peptides.push_back(peptide);
         for (Size j = 0; j < peptide.protein_refs.size(); ++j)
         {
-          protein_ids.push_back(peptide.protein_refs[j]);
+          protein_ids.insert(peptide.protein_refs[j]);
         }
       }
       else
@@ -597,7 +659,7 @@ namespace OpenMS
       OpenMS::TargetedExperiment::Protein protein = proteins[i];
 
       // Check if protein has any peptides left
-      if (find(protein_ids.begin(), protein_ids.end(), protein.id) != protein_ids.end())
+      if (protein_ids.find(protein.id) != protein_ids.end())
       {
         decoy_proteins.push_back(protein);
       }
@@ -46,6 +46,7 @@
 // Helpers
 #include <OpenMS/ANALYSIS/OPENSWATH/OpenSwathHelper.h>
 #include <OpenMS/CHEMISTRY/ProteaseDigestion.h>
+#include <OpenMS/SYSTEM/Profiler.h>
 
 #include <boost/range/adaptor/map.hpp>
 #include <boost/foreach.hpp>
@@ -184,6 +185,7 @@ namespace OpenMS
                                                std::vector<OpenSwath::SwathMap> swath_maps,
                                                TransitionGroupMapType& transition_group_map)
   {
+    OPENMS_PROFILE_SCOPE("MRMFeatureFinderScoring::pickExperiment");
     //
     // Step 1
     //
@@ -230,20 +232,25 @@ namespace OpenMS
     }
     trgroup_picker.setParameters(trgroup_picker_param);
 
-    Size progress = 0;
-    startProgress(0, transition_group_map.size(), "picking peaks");
+    // pick all groups first (in parallel), scoring writes into the shared output and stays serial
+    std::vector<MRMTransitionGroupType*> transition_groups;
+    transition_groups.reserve(transition_group_map.size());
     for (TransitionGroupMapType::iterator trgroup_it = transition_group_map.begin(); trgroup_it != transition_group_map.end(); ++trgroup_it)
     {
-
-      setProgress(++progress);
       MRMTransitionGroupType& transition_group = trgroup_it->second;
       if (transition_group.getChromatograms().empty() || transition_group.getTransitions().empty())
       {
         continue;
       }
+      transition_groups.push_back(&transition_group);
+    }
+    trgroup_picker.pickTransitionGroups(transition_groups);
 
-      trgroup_picker.pickTransitionGroup(transition_group);
-      scorePeakgroups(trgroup_it->second, trafo, swath_maps, output);
+    startProgress(0, transition_groups.size(), "scoring peak groups");
+    for (Size i = 0; i < transition_groups.size(); ++i)
+    {
+      setProgress(i + 1);
+      scorePeakgroups(*transition_groups[i], trafo, swath_maps, output);
     }
     endProgress();
 
@@ -483,6 +490,7 @@ namespace OpenMS
                                                 FeatureMap& output, 
                                                 bool ms1only)
   {
+    OPENMS_PROFILE_SCOPE("MRMFeatureFinderScoring::scorePeakgroups");
     if (PeptideRefMap_.empty())
     {
       throw Exception::IllegalArgument(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION,
@@ -556,6 +564,19 @@ namespace OpenMS
     ProteaseDigestion pd;
     pd.setEnzyme("Trypsin");
 
+    // hint the spectrum backends which spectra will be needed for scoring
+    // (allows them to read ahead while the first peak groups are scored)
+    if (!ms1only)
+    {
+      for (const auto& swath_map : swath_maps)
+      {
+        for (const auto& feature : transition_group_detection.getFeatures())
+        {
+          swath_map.sptr->prefetchSpectraByRT(feature.getRT(), 0.0);
+        }
+      }
+    }
+
     size_t feature_idx = 0;
     // Go through all peak groups (found MRM features) and score them
     for (std::vector<MRMFeature>::iterator mrmfeature = transition_group_detection.getFeaturesMuteable().begin();
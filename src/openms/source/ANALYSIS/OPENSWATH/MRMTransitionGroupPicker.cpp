@@ -75,6 +75,9 @@ namespace OpenMS
 
     defaults_.setValue("resample_boundary", 15.0, "For computing peak quality, how many extra seconds should be sample left and right of the actual peak", ListUtils::create<String>("advanced"));
 
+    defaults_.setValue("resample_to_common_grid", "false", "Resample all chromatograms of a transition group onto the RT grid of its most densely sampled fragment chromatogram before picking (useful for SRM data where transitions are not sampled at the same time points).", ListUtils::create<String>("advanced"));
+    defaults_.setValidStrings("resample_to_common_grid", ListUtils::create<String>("true,false"));
+
     defaults_.setValue("compute_peak_quality", "false", "Tries to compute a quality value for each peakgroup and detect outlier transitions. The resulting score is centered around zero and values above 0 are generally good and below -1 or -2 are usually bad.", ListUtils::create<String>("advanced"));
     defaults_.setValidStrings("compute_peak_quality", ListUtils::create<String>("true,false"));
     
@@ -125,12 +128,29 @@ namespace OpenMS
     min_qual_ = (double)param_.getValue("minimal_quality");
     min_peak_width_ = (double)param_.getValue("min_peak_width");
     resample_boundary_ = (double)param_.getValue("resample_boundary");
+    resample_to_common_grid_ = (bool)param_.getValue("resample_to_common_grid").toBool();
     boundary_selection_method_ = param_.getValue("boundary_selection_method");
 
     picker_.setParameters(param_.copy("PeakPickerMRM:", true));
     pi_.setParameters(param_.copy("PeakIntegrator:", true));
   }
 
+  void MRMTransitionGroupPicker::pickChromatogramBuffered_(const MSChromatogram& chromatogram, Size idx)
+  {
+    if (idx >= picked_chroms_.size())
+    {
+      picked_chroms_.resize(idx + 1);
+      smoothed_chroms_.resize(idx + 1);
+    }
+    MSChromatogram& picked_chrom = picked_chroms_[idx];
+    MSChromatogram& smoothed_chrom = smoothed_chroms_[idx];
+    // the picker does not touch its output for empty input, reset the buffers explicitly
+    picked_chrom.clear(true);
+    smoothed_chrom.clear(true);
+    picker_.pickChromatogram(chromatogram, picked_chrom, smoothed_chrom);
+    picked_chrom.sortByIntensity();
+  }
+
   void MRMTransitionGroupPicker::findLargestPeak(const std::vector<MSChromatogram >& picked_chroms, int& chr_idx, int& peak_idx)
   {
     double largest = 0.0;
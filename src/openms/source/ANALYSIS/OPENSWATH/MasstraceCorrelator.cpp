@@ -39,6 +39,9 @@
 #include <OpenMS/FILTERING/NOISEESTIMATION/SignalToNoiseEstimatorMedian.h>
 #include <OpenMS/MATH/STATISTICS/StatisticFunctions.h>
 
+#include <algorithm>
+#include <exception>
+
 // #define DEBUG_MASSTRACES
 // #include <assert.h>
 
@@ -152,6 +155,8 @@ namespace OpenMS
   {
     std::vector<double> vec1;
     std::vector<double> vec2;
+    vec1.reserve(hull_points1.size() + hull_points2.size());
+    vec2.reserve(hull_points1.size() + hull_points2.size());
     matchMassTraces_(hull_points1, hull_points2, vec1, vec2, mindiff);
 
     pearson_score = Math::pearsonCorrelationCoefficient(vec1.begin(), vec1.end(), vec2.begin(), vec2.end() );
@@ -226,30 +231,44 @@ namespace OpenMS
     int nr_peaks_added = 0;
 #endif
 
-    Size j;
-    double firstpoint, lastpoint, current_rt;
-    double* rt_cache_ptr;
-
-    int lag; double lag_intensity; double pearson_score;
-
     // cache datastructures
     std::vector< MasstracePointsType > feature_points; 
     std::vector< std::pair<double,double> > max_intensities; 
     std::vector< double > rt_cache;
     createConsensusMapCache(map, feature_points, max_intensities, rt_cache);
 
-    std::map<int, int> used_already;
+    // all features sorted by (apex) RT: the candidates of a seed form a
+    // contiguous RT range which is found by binary search
+    std::vector< std::pair<double, Size> > rt_order;
+    rt_order.reserve(rt_cache.size());
+    for (Size i = 0; i < rt_cache.size(); ++i)
+    {
+      rt_order.push_back(std::make_pair(rt_cache[i], i));
+    }
+    std::sort(rt_order.begin(), rt_order.end());
+
+    // scores of a single candidate against the current seed
+    struct CandidateScore
+    {
+      int lag;
+      double lag_intensity;
+      double pearson_score;
+    };
+
+    std::vector<bool> used_already(map.size(), false);
+    std::vector<Size> candidates;
+    std::vector<CandidateScore> scores;
     // go through all consensus features in the map and use 
     startProgress(0, map.size(), "correlating masstraces ");
     for (Size i = 0; i < map.size(); ++i)
     {
       setProgress(i);
 
-      if (used_already.find(i) != used_already.end()) 
+      if (used_already[i]) 
       {
         continue;
       }
-      used_already[i] = 0;
+      used_already[i] = true;
 
       // Prepare a new pseudo spectrum
       MSSpectrum spectrum;
@@ -270,23 +289,63 @@ namespace OpenMS
       spectrum.push_back(peak);
 
       // store the RT of the current feature and the first/last points of this feature
-      firstpoint = feature_points[i].front().first; 
-      lastpoint = feature_points[i].back().first;
-      current_rt = rt_cache[i];
-      rt_cache_ptr = &rt_cache[i];
-
-      // go through all features with lower intensity in the map
-      for (j = i+1; j < map.size(); ++j)
+      const double firstpoint = feature_points[i].front().first; 
+      const double lastpoint = feature_points[i].back().first;
+      const double current_rt = rt_cache[i];
+
+      // Collect all features with lower intensity in the map (j > i) whose
+      // center is inside the masstrace of the parent and whose rt_max is
+      // close enough to the one of the parent. Both conditions are monotonic
+      // in RT, thus the candidates are a contiguous range in rt_order.
+      candidates.clear();
+      if (max_rt_apex_difference >= 0)
       {
+        std::vector< std::pair<double, Size> >::const_iterator it = std::partition_point(rt_order.begin(), rt_order.end(),
+          [&](const std::pair<double, Size>& p) { return p.first < firstpoint || current_rt - p.first > max_rt_apex_difference; });
+        for (; it != rt_order.end() && !(it->first > lastpoint || it->first - current_rt > max_rt_apex_difference); ++it)
+        {
+          if (it->second > i) candidates.push_back(it->second);
+        }
+        // the peaks are added in order of decreasing intensity (map order)
+        std::sort(candidates.begin(), candidates.end());
+      }
 
-        // If the center of this trace is outside the masstrace of the parent, ignore this pair.
-        // If the difference between the rt_max of the two features is too large, ignore this pair.
-        ++rt_cache_ptr;
-        if ( fabs( (*rt_cache_ptr) - current_rt ) >  max_rt_apex_difference) {continue;}
-        if ( (*rt_cache_ptr) < firstpoint || (*rt_cache_ptr) > lastpoint ) {continue;}
+      // We score the candidates against the seed in terms of several properties / scores
+      // (in parallel for large candidate sets, the results are evaluated in
+      // candidate order below and thus do not depend on the number of threads)
+      scores.resize(candidates.size());
+      Size err_count = 0;
+      std::exception_ptr err;
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic, 16) if (candidates.size() >= 64)
+#endif
+      for (SignedSize k = 0; k < (SignedSize)candidates.size(); ++k)
+      {
+        try
+        {
+          CandidateScore& score = scores[k];
+          score.lag = 0;
+          score.lag_intensity = 0;
+          scoreHullpoints(feature_points[i], feature_points[candidates[k]], score.lag, score.lag_intensity, score.pearson_score, min_correlation, max_lag);
+        }
+        catch (...)
+        {
+#ifdef _OPENMP
+#pragma omp critical (MasstraceCorrelator_createPseudoSpectra)
+#endif
+          {
+            if (err_count++ == 0) err = std::current_exception();
+          }
+        }
+      }
+      if (err_count != 0) std::rethrow_exception(err);
 
-        // We score the two vectors against each other in terms of several properties / scores
-        scoreHullpoints(feature_points[i], feature_points[j], lag, lag_intensity, pearson_score, min_correlation, max_lag);
+      for (Size k = 0; k < candidates.size(); ++k)
+      {
+        const Size j = candidates[k];
+        const int lag = scores[k].lag;
+        const double lag_intensity = scores[k].lag_intensity;
+        const double pearson_score = scores[k].pearson_score;
 
 #ifdef DEBUG_MASSTRACES
         cout << j << ". Checking mass trace at RT: "<<  map[j].getRT() << " m/z: " << map[j].getMZ()
@@ -305,7 +364,7 @@ namespace OpenMS
         if (pearson_score > min_correlation && lag >= -max_lag && lag <= max_lag)
         {
           // mark this masstrace as used already, thus we cannot use it as a seed any more
-          used_already[j] = 0;
+          used_already[j] = true;
 
 #ifdef DEBUG_MASSTRACES
           nr_peaks_added++;
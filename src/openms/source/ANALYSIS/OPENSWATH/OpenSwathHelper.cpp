@@ -34,6 +34,8 @@
 
 #include <OpenMS/ANALYSIS/OPENSWATH/OpenSwathHelper.h>
 
+#include <algorithm>
+
 namespace OpenMS
 {
   void OpenSwathHelper::selectSwathTransitions(const OpenMS::TargetedExperiment& targeted_exp,
@@ -53,6 +55,47 @@ namespace OpenMS
     }
   }
 
+  void OpenSwathHelper::selectSwathTransitions(const LightTargetedExperimentIndex& index,
+                                               OpenSwath::LightTargetedExperiment& transition_exp_used, double min_upper_edge_dist,
+                                               double lower, double upper)
+  {
+    const OpenSwath::LightTargetedExperiment& targeted_exp = index.getExperiment();
+    std::vector<Size> selected;
+    index.selectTransitions(lower, upper, selected);
+
+    std::vector<Size> matching_compounds;
+    for (Size i = 0; i < selected.size(); i++)
+    {
+      const OpenSwath::LightTransition& tr = targeted_exp.transitions[selected[i]];
+      if (std::fabs(upper - tr.getPrecursorMZ()) >= min_upper_edge_dist)
+      {
+        transition_exp_used.transitions.push_back(tr);
+        SignedSize c = index.getTransitionCompound(selected[i]);
+        if (c >= 0) matching_compounds.push_back(c);
+      }
+    }
+    std::sort(matching_compounds.begin(), matching_compounds.end());
+    matching_compounds.erase(std::unique(matching_compounds.begin(), matching_compounds.end()), matching_compounds.end());
+
+    std::vector<Size> matching_proteins;
+    for (Size i = 0; i < matching_compounds.size(); i++)
+    {
+      const OpenSwath::LightCompound& compound = targeted_exp.compounds[matching_compounds[i]];
+      transition_exp_used.compounds.push_back(compound);
+      for (Size j = 0; j < compound.protein_refs.size(); j++)
+      {
+        SignedSize p = index.getProteinIndex(compound.protein_refs[j]);
+        if (p >= 0) matching_proteins.push_back(p);
+      }
+    }
+    std::sort(matching_proteins.begin(), matching_proteins.end());
+    matching_proteins.erase(std::unique(matching_proteins.begin(), matching_proteins.end()), matching_proteins.end());
+    for (Size i = 0; i < matching_proteins.size(); i++)
+    {
+      transition_exp_used.proteins.push_back(targeted_exp.proteins[matching_proteins[i]]);
+    }
+  }
+
   void OpenSwathHelper::checkSwathMap(const OpenMS::PeakMap& swath_map,
                                       double& lower, double& upper)
   {
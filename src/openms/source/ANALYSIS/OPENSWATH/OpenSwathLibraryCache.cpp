@@ -0,0 +1,330 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2018.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: Hannes Roest $
+// $Authors: Hannes Roest $
+// --------------------------------------------------------------------------
+
+
+#include <OpenMS/ANALYSIS/OPENSWATH/OpenSwathLibraryCache.h>
+
+#include <OpenMS/ANALYSIS/OPENSWATH/DIAScoring.h>
+#include <OpenMS/ANALYSIS/OPENSWATH/DATAACCESS/DataAccessHelper.h>
+#include <OpenMS/CHEMISTRY/AASequence.h>
+#include <OpenMS/CONCEPT/Exception.h>
+
+#include <fstream>
+
+#define OPENSWATH_LIBRARY_CACHE_IDENTIFIER 8096
+#define OPENSWATH_LIBRARY_CACHE_VERSION 1
+
+namespace OpenMS
+{
+  namespace
+  {
+    // FNV-1a hash over raw bytes
+    void hashBytes_(UInt64& hash, const void* data, Size size)
+    {
+      const unsigned char* bytes = static_cast<const unsigned char*>(data);
+      for (Size i = 0; i < size; ++i)
+      {
+        hash ^= bytes[i];
+        hash *= 1099511628211ULL;
+      }
+    }
+
+    void hashString_(UInt64& hash, const std::string& s)
+    {
+      Size size = s.size();
+      hashBytes_(hash, &size, sizeof(size));
+      hashBytes_(hash, s.data(), s.size());
+    }
+
+    template <typename T>
+    void hashValue_(UInt64& hash, const T& value)
+    {
+      hashBytes_(hash, &value, sizeof(value));
+    }
+
+    void writeString_(std::ofstream& ofs, const std::string& s)
+    {
+      Size size = s.size();
+      ofs.write((char*)&size, sizeof(size));
+      ofs.write(s.data(), size);
+    }
+
+    void writeVector_(std::ofstream& ofs, const std::vector<double>& v)
+    {
+      Size size = v.size();
+      ofs.write((char*)&size, sizeof(size));
+      if (size > 0)
+      {
+        ofs.write((char*)&v[0], size * sizeof(v[0]));
+      }
+    }
+
+    void checkStream_(const std::ifstream& ifs, const String& filename)
+    {
+      if (!ifs)
+      {
+        throw Exception::ParseError(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION,
+          "Unexpected end of library cache file. Aborting!", filename);
+      }
+    }
+
+    void readString_(std::ifstream& ifs, std::string& s, const String& filename)
+    {
+      Size size = 0;
+      ifs.read((char*)&size, sizeof(size));
+      checkStream_(ifs, filename);
+      s.resize(size);
+      if (size > 0)
+      {
+        ifs.read(&s[0], size);
+        checkStream_(ifs, filename);
+      }
+    }
+
+    void readVector_(std::ifstream& ifs, std::vector<double>& v, const String& filename)
+    {
+      Size size = 0;
+      ifs.read((char*)&size, sizeof(size));
+      checkStream_(ifs, filename);
+      v.resize(size);
+      if (size > 0)
+      {
+        ifs.read((char*)&v[0], size * sizeof(v[0]));
+        checkStream_(ifs, filename);
+      }
+    }
+  }
+
+  OpenSwathLibraryCache::OpenSwathLibraryCache() :
+    nr_isotopes_(-1),
+    fingerprint_value_(0)
+  {
+  }
+
+  void OpenSwathLibraryCache::compute(const OpenSwath::LightTargetedExperiment& library, const DIAScoring& diascoring)
+  {
+    nr_isotopes_ = (Int)diascoring.getParameters().getValue("dia_nr_isotopes");
+    fingerprint_value_ = fingerprint_(library, nr_isotopes_);
+
+    // compute in parallel, then insert serially
+    const std::vector<OpenSwath::LightCompound>& compounds = library.compounds;
+    const std::vector<OpenSwath::LightTransition>& transitions = library.transitions;
+    std::vector<CompoundEntry> compound_entries(compounds.size());
+    std::vector<std::vector<double> > patterns(transitions.size());
+
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic, 100)
+#endif
+    for (SignedSize i = 0; i < (SignedSize)compounds.size(); ++i)
+    {
+      if (!compounds[i].isPeptide()) continue;
+      // b/y ion series are checked for charge state 1 (see OpenSwathScoring::calculateDIAScores)
+      AASequence aas;
+      OpenSwathDataAccessHelper::convertPeptideToAASequence(compounds[i], aas);
+      diascoring.getBYSeries(aas, 1, compound_entries[i].bseries, compound_entries[i].yseries);
+    }
+
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic, 100)
+#endif
+    for (SignedSize i = 0; i < (SignedSize)transitions.size(); ++i)
+    {
+      // same charge assumption as DIAScoring::dia_isotope_scores
+      int putative_fragment_charge = transitions[i].fragment_charge > 0 ? transitions[i].fragment_charge : 1;
+      diascoring.getTheoreticalIsotopePattern(transitions[i].product_mz, putative_fragment_charge, patterns[i]);
+    }
+
+    compounds_.clear();
+    isotope_patterns_.clear();
+    for (Size i = 0; i < compounds.size(); ++i)
+    {
+      if (!compounds[i].isPeptide()) continue;
+      compounds_[compounds[i].id].bseries.swap(compound_entries[i].bseries);
+      compounds_[compounds[i].id].yseries.swap(compound_entries[i].yseries);
+    }
+    for (Size i = 0; i < transitions.size(); ++i)
+    {
+      isotope_patterns_[transitions[i].transition_name].swap(patterns[i]);
+    }
+  }
+
+  bool OpenSwathLibraryCache::matches(const OpenSwath::LightTargetedExperiment& library, const DIAScoring& diascoring) const
+  {
+    Int nr_isotopes = (Int)diascoring.getParameters().getValue("dia_nr_isotopes");
+    return nr_isotopes == nr_isotopes_ && fingerprint_(library, nr_isotopes) == fingerprint_value_;
+  }
+
+  void OpenSwathLibraryCache::store(const String& filename) const
+  {
+    std::ofstream ofs(filename.c_str(), std::ios::out | std::ios::binary);
+    if (!ofs)
+    {
+      throw Exception::UnableToCreateFile(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, filename);
+    }
+
+    int file_identifier = OPENSWATH_LIBRARY_CACHE_IDENTIFIER;
+    int format_version = OPENSWATH_LIBRARY_CACHE_VERSION;
+    ofs.write((char*)&file_identifier, sizeof(file_identifier));
+    ofs.write((char*)&format_version, sizeof(format_version));
+    ofs.write((char*)&nr_isotopes_, sizeof(nr_isotopes_));
+    ofs.write((char*)&fingerprint_value_, sizeof(fingerprint_value_));
+
+    Size nr_compounds = compounds_.size();
+    ofs.write((char*)&nr_compounds, sizeof(nr_compounds));
+    for (const auto& c : compounds_)
+    {
+      writeString_(ofs, c.first);
+      writeVector_(ofs, c.second.bseries);
+      writeVector_(ofs, c.second.yseries);
+    }
+
+    Size nr_transitions = isotope_patterns_.size();
+    ofs.write((char*)&nr_transitions, sizeof(nr_transitions));
+    for (const auto& t : isotope_patterns_)
+    {
+      writeString_(ofs, t.first);
+      writeVector_(ofs, t.second);
+    }
+
+    if (!ofs)
+    {
+      throw Exception::UnableToCreateFile(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, filename);
+    }
+  }
+
+  void OpenSwathLibraryCache::load(const String& filename)
+  {
+    std::ifstream ifs(filename.c_str(), std::ios::binary);
+    if (ifs.fail())
+    {
+      throw Exception::FileNotFound(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, filename);
+    }
+
+    int file_identifier = 0;
+    ifs.read((char*)&file_identifier, sizeof(file_identifier));
+    if (file_identifier != OPENSWATH_LIBRARY_CACHE_IDENTIFIER)
+    {
+      throw Exception::ParseError(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION,
+        "File might not be a library cache file (wrong file magic number). Aborting!", filename);
+    }
+    int format_version = 0;
+    ifs.read((char*)&format_version, sizeof(format_version));
+    if (format_version != OPENSWATH_LIBRARY_CACHE_VERSION)
+    {
+      throw Exception::ParseError(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION,
+        "Unsupported library cache format version " + String(format_version) + ". Aborting!", filename);
+    }
+
+    Int nr_isotopes = 0;
+    UInt64 fingerprint_value = 0;
+    Size nr_compounds = 0, nr_transitions = 0;
+    ifs.read((char*)&nr_isotopes, sizeof(nr_isotopes));
+    ifs.read((char*)&fingerprint_value, sizeof(fingerprint_value));
+    ifs.read((char*)&nr_compounds, sizeof(nr_compounds));
+    checkStream_(ifs, filename);
+
+    // read into temporaries so that a broken file leaves the cache unchanged
+    std::unordered_map<std::string, CompoundEntry> compounds;
+    std::string id;
+    for (Size i = 0; i < nr_compounds; ++i)
+    {
+      readString_(ifs, id, filename);
+      CompoundEntry& entry = compounds[id];
+      readVector_(ifs, entry.bseries, filename);
+      readVector_(ifs, entry.yseries, filename);
+    }
+
+    ifs.read((char*)&nr_transitions, sizeof(nr_transitions));
+    checkStream_(ifs, filename);
+    std::unordered_map<std::string, std::vector<double> > isotope_patterns;
+    for (Size i = 0; i < nr_transitions; ++i)
+    {
+      readString_(ifs, id, filename);
+      readVector_(ifs, isotope_patterns[id], filename);
+    }
+
+    nr_isotopes_ = nr_isotopes;
+    fingerprint_value_ = fingerprint_value;
+    compounds_.swap(compounds);
+    isotope_patterns_.swap(isotope_patterns);
+  }
+
+  const OpenSwathLibraryCache::CompoundEntry* OpenSwathLibraryCache::getCompound(const std::string& compound_id) const
+  {
+    std::unordered_map<std::string, CompoundEntry>::const_iterator it = compounds_.find(compound_id);
+    return (it != compounds_.end()) ? &it->second : nullptr;
+  }
+
+  const std::vector<double>* OpenSwathLibraryCache::getIsotopePattern(const std::string& transition_id) const
+  {
+    std::unordered_map<std::string, std::vector<double> >::const_iterator it = isotope_patterns_.find(transition_id);
+    return (it != isotope_patterns_.end()) ? &it->second : nullptr;
+  }
+
+  Int OpenSwathLibraryCache::getNrIsotopes() const
+  {
+    return nr_isotopes_;
+  }
+
+  bool OpenSwathLibraryCache::empty() const
+  {
+    return compounds_.empty() && isotope_patterns_.empty();
+  }
+
+  UInt64 OpenSwathLibraryCache::fingerprint_(const OpenSwath::LightTargetedExperiment& library, Int nr_isotopes)
+  {
+    UInt64 hash = 14695981039346656037ULL;
+    hashValue_(hash, nr_isotopes);
+    for (const auto& c : library.compounds)
+    {
+      hashString_(hash, c.id);
+      hashString_(hash, c.sequence);
+      hashString_(hash, c.compound_name);
+      hashValue_(hash, c.modifications.size());
+      for (const auto& m : c.modifications)
+      {
+        hashValue_(hash, m.location);
+        hashValue_(hash, m.unimod_id);
+      }
+    }
+    for (const auto& t : library.transitions)
+    {
+      hashString_(hash, t.transition_name);
+      hashValue_(hash, t.product_mz);
+      hashValue_(hash, t.fragment_charge);
+    }
+    return hash;
+  }
+
+}
@@ -32,7 +32,281 @@
 // $Authors: George Rosenberger $
 // --------------------------------------------------------------------------
 
+
+#include <OpenMS/ANALYSIS/OPENSWATH/OpenSwathOSWWriter.h>
+
+#include <OpenMS/CONCEPT/LogStream.h>
+
+#include <condition_variable>
+#include <iterator>
+#include <mutex>
+#include <thread>
+
 namespace OpenMS
 {
-}
+  namespace Internal
+  {
+    /**
+      @brief Inserts rows into an OSW file from a background thread
+
+      Keeps a single database connection open with one prepared statement
+      per table. Rows handed to append() are collected and written by the
+      background thread, each batch of collected rows in a single
+      transaction.
+    */
+    class OSWInsertEngine
+    {
+    public:
+      typedef OpenSwathOSWWriter::Row Row;
+
+      explicit OSWInsertEngine(const String& filename) :
+        db_(nullptr),
+        statements_(OpenSwathOSWWriter::SIZE_OF_TABLE, nullptr),
+        busy_(false),
+        stop_(false)
+      {
+        if (sqlite3_open(filename.c_str(), &db_) != SQLITE_OK)
+        {
+          String error_message = sqlite3_errmsg(db_);
+          sqlite3_close(db_);
+          throw Exception::IllegalArgument(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, error_message);
+        }
+        sqlite3_busy_timeout(db_, 60000);
+        exec_("PRAGMA journal_mode = WAL");
+        exec_("PRAGMA synchronous = NORMAL");
+
+        for (Size t = 0; t < statements_.size(); ++t)
+        {
+          const OpenSwathOSWWriter::Table table = (OpenSwathOSWWriter::Table)t;
+          const std::vector<String>& columns = OpenSwathOSWWriter::getColumns(table);
+          String sql = "INSERT INTO " + OpenSwathOSWWriter::getTableName(table) + " (" + ListUtils::concatenate(columns, ", ") + ") VALUES (";
+          for (Size i = 0; i < columns.size(); ++i)
+          {
+            sql += (i == 0 ? "?" : ", ?");
+          }
+          sql += ")";
+          if (sqlite3_prepare_v2(db_, sql.c_str(), -1, &statements_[t], nullptr) != SQLITE_OK)
+          {
+            String error_message = sqlite3_errmsg(db_);
+            close_();
+            throw Exception::IllegalArgument(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, error_message);
+          }
+        }
+
+        thread_ = std::thread(&OSWInsertEngine::run_, this);
+      }
+
+      /// Writes all remaining rows and closes the database
+      ~OSWInsertEngine()
+      {
+        {
+          std::lock_guard<std::mutex> lock(mutex_);
+          stop_ = true;
+        }
+        work_available_.notify_all();
+        thread_.join();
+        if (!error_.empty())
+        {
+          LOG_ERROR << "Error writing OSW file: " << error_ << std::endl;
+        }
+        // leave the file in the default journal mode for readers
+        sqlite3_exec(db_, "PRAGMA journal_mode = DELETE", nullptr, nullptr, nullptr);
+        close_();
+      }
+
+      void append(std::vector<Row>& rows)
+      {
+        {
+          std::lock_guard<std::mutex> lock(mutex_);
+          checkError_();
+          pending_.insert(pending_.end(), std::make_move_iterator(rows.begin()), std::make_move_iterator(rows.end()));
+        }
+        rows.clear();
+        work_available_.notify_one();
+      }
+
+      void flush()
+      {
+        std::unique_lock<std::mutex> lock(mutex_);
+        work_done_.wait(lock, [this] { return (pending_.empty() && !busy_) || !error_.empty(); });
+        checkError_();
+      }
+
+    private:
+      void run_()
+      {
+        std::vector<Row> rows;
+        while (true)
+        {
+          {
+            std::unique_lock<std::mutex> lock(mutex_);
+            work_available_.wait(lock, [this] { return stop_ || !pending_.empty(); });
+            if (pending_.empty()) break; // stop_ is set and there is nothing left
+            rows.swap(pending_);
+            busy_ = true;
+          }
+
+          String error_message;
+          try
+          {
+            insert_(rows);
+          }
+          catch (Exception::BaseException& e)
+          {
+            error_message = e.what();
+          }
+          rows.clear();
 
+          {
+            std::lock_guard<std::mutex> lock(mutex_);
+            busy_ = false;
+            if (!error_message.empty() && error_.empty())
+            {
+              error_ = error_message;
+            }
+          }
+          work_done_.notify_all();
+        }
+      }
+
+      void insert_(const std::vector<Row>& rows)
+      {
+        exec_("BEGIN TRANSACTION");
+        for (Size i = 0; i < rows.size(); ++i)
+        {
+          sqlite3_stmt* stmt = statements_[rows[i].table];
+          const std::vector<String>& values = rows[i].values;
+          for (Size k = 0; k < values.size(); ++k)
+          {
+            if (values[k] == "NULL")
+            {
+              sqlite3_bind_null(stmt, (int)k + 1);
+            }
+            else
+            {
+              // the column affinity converts numeric text to INTEGER / REAL
+              sqlite3_bind_text(stmt, (int)k + 1, values[k].c_str(), (int)values[k].size(), SQLITE_STATIC);
+            }
+          }
+          int rc = sqlite3_step(stmt);
+          sqlite3_reset(stmt);
+          if (rc != SQLITE_DONE)
+          {
+            String error_message = sqlite3_errmsg(db_);
+            sqlite3_exec(db_, "ROLLBACK", nullptr, nullptr, nullptr);
+            throw Exception::IllegalArgument(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, error_message);
+          }
+        }
+        exec_("COMMIT");
+      }
+
+      void exec_(const char* sql)
+      {
+        char* zErrMsg = nullptr;
+        if (sqlite3_exec(db_, sql, nullptr, nullptr, &zErrMsg) != SQLITE_OK)
+        {
+          String error_message = zErrMsg;
+          sqlite3_free(zErrMsg);
+          throw Exception::IllegalArgument(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, error_message);
+        }
+      }
+
+      void checkError_() const
+      {
+        if (!error_.empty())
+        {
+          throw Exception::IllegalArgument(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, error_);
+        }
+      }
+
+      void close_()
+      {
+        for (Size t = 0; t < statements_.size(); ++t)
+        {
+          sqlite3_finalize(statements_[t]);
+        }
+        sqlite3_close(db_);
+      }
+
+      sqlite3* db_;
+      std::vector<sqlite3_stmt*> statements_;
+
+      std::mutex mutex_;
+      std::condition_variable work_available_;
+      std::condition_variable work_done_;
+      std::vector<Row> pending_;
+      bool busy_;
+      bool stop_;
+      String error_;
+      std::thread thread_;
+    };
+  }
+
+  String OpenSwathOSWWriter::getTableName(Table table)
+  {
+    switch (table)
+    {
+      case FEATURE: return "FEATURE";
+      case FEATURE_MS1: return "FEATURE_MS1";
+      case FEATURE_PRECURSOR: return "FEATURE_PRECURSOR";
+      case FEATURE_MS2: return "FEATURE_MS2";
+      case FEATURE_TRANSITION: return "FEATURE_TRANSITION";
+      case FEATURE_TRANSITION_UIS: return "FEATURE_TRANSITION";
+      default:
+        throw Exception::IllegalArgument(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "Unknown table " + String((int)table));
+    }
+  }
+
+  const std::vector<String>& OpenSwathOSWWriter::getColumns(Table table)
+  {
+    static const std::vector<String> columns[SIZE_OF_TABLE] =
+    {
+      ListUtils::create<String>("ID,RUN_ID,PRECURSOR_ID,EXP_RT,NORM_RT,DELTA_RT,LEFT_WIDTH,RIGHT_WIDTH"),
+      ListUtils::create<String>("FEATURE_ID,AREA_INTENSITY,APEX_INTENSITY,VAR_MASSDEV_SCORE,VAR_MI_SCORE,VAR_MI_CONTRAST_SCORE,"
+        "VAR_MI_COMBINED_SCORE,VAR_ISOTOPE_CORRELATION_SCORE,VAR_ISOTOPE_OVERLAP_SCORE,VAR_XCORR_COELUTION,"
+        "VAR_XCORR_COELUTION_CONTRAST,VAR_XCORR_COELUTION_COMBINED,VAR_XCORR_SHAPE,VAR_XCORR_SHAPE_CONTRAST,VAR_XCORR_SHAPE_COMBINED"),
+      ListUtils::create<String>("FEATURE_ID,ISOTOPE,AREA_INTENSITY,APEX_INTENSITY"),
+      ListUtils::create<String>("FEATURE_ID,AREA_INTENSITY,TOTAL_AREA_INTENSITY,APEX_INTENSITY,TOTAL_MI,VAR_BSERIES_SCORE,"
+        "VAR_DOTPROD_SCORE,VAR_INTENSITY_SCORE,VAR_ISOTOPE_CORRELATION_SCORE,VAR_ISOTOPE_OVERLAP_SCORE,VAR_LIBRARY_CORR,"
+        "VAR_LIBRARY_DOTPROD,VAR_LIBRARY_MANHATTAN,VAR_LIBRARY_RMSD,VAR_LIBRARY_ROOTMEANSQUARE,VAR_LIBRARY_SANGLE,"
+        "VAR_LOG_SN_SCORE,VAR_MANHATTAN_SCORE,VAR_MASSDEV_SCORE,VAR_MASSDEV_SCORE_WEIGHTED,VAR_MI_SCORE,"
+        "VAR_MI_WEIGHTED_SCORE,VAR_MI_RATIO_SCORE,VAR_NORM_RT_SCORE,VAR_XCORR_COELUTION,VAR_XCORR_COELUTION_WEIGHTED,"
+        "VAR_XCORR_SHAPE,VAR_XCORR_SHAPE_WEIGHTED,VAR_YSERIES_SCORE,VAR_ELUTION_MODEL_FIT_SCORE,VAR_SONAR_LAG,"
+        "VAR_SONAR_SHAPE,VAR_SONAR_LOG_SN,VAR_SONAR_LOG_DIFF,VAR_SONAR_LOG_TREND,VAR_SONAR_RSQ"),
+      ListUtils::create<String>("FEATURE_ID,TRANSITION_ID,AREA_INTENSITY,TOTAL_AREA_INTENSITY,APEX_INTENSITY,TOTAL_MI"),
+      ListUtils::create<String>("FEATURE_ID,TRANSITION_ID,AREA_INTENSITY,TOTAL_AREA_INTENSITY,APEX_INTENSITY,TOTAL_MI,"
+        "VAR_INTENSITY_SCORE,VAR_INTENSITY_RATIO_SCORE,VAR_LOG_INTENSITY,VAR_XCORR_COELUTION,VAR_XCORR_SHAPE,"
+        "VAR_LOG_SN_SCORE,VAR_MASSDEV_SCORE,VAR_MI_SCORE,VAR_MI_RATIO_SCORE,VAR_ISOTOPE_CORRELATION_SCORE,"
+        "VAR_ISOTOPE_OVERLAP_SCORE")
+    };
+    if (table < 0 || table >= SIZE_OF_TABLE)
+    {
+      throw Exception::IllegalArgument(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "Unknown table " + String((int)table));
+    }
+    return columns[table];
+  }
+
+  void OpenSwathOSWWriter::startEngine_()
+  {
+    engine_.reset(new Internal::OSWInsertEngine(output_filename_));
+  }
+
+  void OpenSwathOSWWriter::writeRows(std::vector<Row>& rows)
+  {
+    if (!engine_)
+    {
+      throw Exception::IllegalArgument(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION,
+          "writeHeader() needs to be called before writeRows()");
+    }
+    engine_->append(rows);
+  }
+
+  void OpenSwathOSWWriter::flush()
+  {
+    if (engine_)
+    {
+      engine_->flush();
+    }
+  }
+
+}
@@ -38,6 +38,7 @@
 #include <OpenMS/OPENSWATHALGO/ALGO/Scoring.h>
 #include <OpenMS/OPENSWATHALGO/ALGO/MRMScoring.h>
 #include <OpenMS/ANALYSIS/OPENSWATH/SONARScoring.h>
+#include <OpenMS/ANALYSIS/OPENSWATH/OpenSwathLibraryCache.h>
 
 // auxiliary
 #include <OpenMS/ANALYSIS/OPENSWATH/DATAACCESS/DataAccessHelper.h>
@@ -128,11 +129,20 @@ namespace OpenMS
     // Peptide-specific scores
     if (compound.isPeptide())
     {
-      // Presence of b/y series score
-      OpenMS::AASequence aas;
-      int by_charge_state = 1; // for which charge states should we check b/y series
-      OpenSwathDataAccessHelper::convertPeptideToAASequence(compound, aas);
-      diascoring.dia_by_ion_score(spectrum, aas, by_charge_state, scores.bseries_score, scores.yseries_score);
+      // Presence of b/y series score (use the precomputed series if available)
+      const OpenSwathLibraryCache* cache = diascoring.getLibraryCache();
+      const OpenSwathLibraryCache::CompoundEntry* entry = (cache != nullptr) ? cache->getCompound(compound.id) : nullptr;
+      if (entry != nullptr)
+      {
+        diascoring.dia_by_ion_score(spectrum, entry->bseries, entry->yseries, scores.bseries_score, scores.yseries_score);
+      }
+      else
+      {
+        OpenMS::AASequence aas;
+        int by_charge_state = 1; // for which charge states should we check b/y series
+        OpenSwathDataAccessHelper::convertPeptideToAASequence(compound, aas);
+        diascoring.dia_by_ion_score(spectrum, aas, by_charge_state, scores.bseries_score, scores.yseries_score);
+      }
     }
 
     if (ms1_map && ms1_map->getNrSpectra() > 0) 
@@ -507,20 +517,22 @@ namespace OpenMS
     }
     else
     {
-      std::vector<OpenSwath::SpectrumPtr> all_spectra;
       // always add the spectrum 0, then add those right and left
-      all_spectra.push_back(swath_map->getSpectrumById(closest_idx));
+      std::vector<std::size_t> spectrum_ids;
+      spectrum_ids.push_back(closest_idx);
       for (int i = 1; i <= nr_spectra_to_add / 2; i++) // cast to int is intended!
       {
         if (closest_idx - i >= 0)
         {
-          all_spectra.push_back(swath_map->getSpectrumById(closest_idx - i));
+          spectrum_ids.push_back(closest_idx - i);
         }
         if (closest_idx + i < (int)swath_map->getNrSpectra())
         {
-          all_spectra.push_back(swath_map->getSpectrumById(closest_idx + i));
+          spectrum_ids.push_back(closest_idx + i);
         }
       }
+      // retrieve all spectra at once (allows the backend to merge the reads)
+      std::vector<OpenSwath::SpectrumPtr> all_spectra = swath_map->getSpectraByIds(spectrum_ids);
       if (drift_upper > 0) 
       {
         std::vector<OpenSwath::SpectrumPtr> tmp;
@@ -34,6 +34,86 @@
 
 #include <OpenMS/ANALYSIS/OPENSWATH/OpenSwathWorkflow.h>
 
+#include <OpenMS/ANALYSIS/OPENSWATH/CompactChromatogramList.h>
+
+#include <OpenMS/CONCEPT/GroupedTaskScheduler.h>
+
+#include <iterator>
+
+// OpenSwathOutputQueue
+namespace OpenMS
+{
+
+  OpenSwathOutputQueue::OpenSwathOutputQueue(OpenSwathTSVWriter& tsv_writer, OpenSwathOSWWriter& osw_writer) :
+    tsv_writer_(tsv_writer),
+    osw_writer_(osw_writer)
+  {
+  }
+
+  void OpenSwathOutputQueue::write(std::vector<String>& tsv_lines, std::vector<OpenSwathOSWWriter::Row>& osw_rows)
+  {
+    // the OSW writer inserts asynchronously by itself
+    if (osw_writer_.isActive() && !osw_rows.empty())
+    {
+      osw_writer_.writeRows(osw_rows);
+    }
+    osw_rows.clear();
+
+    if (tsv_lines.empty())
+    {
+      return;
+    }
+    {
+      std::lock_guard<std::mutex> lock(queue_mutex_);
+      tsv_pending_.insert(tsv_pending_.end(), std::make_move_iterator(tsv_lines.begin()), std::make_move_iterator(tsv_lines.end()));
+    }
+    tsv_lines.clear();
+    drain_(false);
+  }
+
+  void OpenSwathOutputQueue::flush()
+  {
+    drain_(true);
+    if (osw_writer_.isActive())
+    {
+      osw_writer_.flush();
+    }
+  }
+
+  void OpenSwathOutputQueue::drain_(bool wait)
+  {
+    std::unique_lock<std::mutex> writer_lock(writer_mutex_, std::defer_lock);
+    if (wait)
+    {
+      writer_lock.lock();
+    }
+    else if (!writer_lock.try_lock())
+    {
+      // another thread is writing and will pick up our lines
+      return;
+    }
+
+    while (true)
+    {
+      std::vector<String> tsv_lines;
+      {
+        std::lock_guard<std::mutex> lock(queue_mutex_);
+        tsv_lines.swap(tsv_pending_);
+      }
+      if (tsv_lines.empty())
+      {
+        break;
+      }
+
+      if (tsv_writer_.isActive())
+      {
+        tsv_writer_.writeLines(tsv_lines);
+      }
+    }
+  }
+
+}
+
 // OpenSwathCalibrationWorkflow
 namespace OpenMS
 {
@@ -291,6 +371,20 @@ namespace OpenMS
     trafo_inverse.invert();
 
     this->startProgress(0, 1, "Extract iRT chromatograms");
+    if (residency_manager_ != nullptr)
+    {
+      // only maps with iRT transitions are used
+      std::vector< OpenSwath::SpectrumAccessPtr > schedule;
+      for (Size i = 0; i < swath_maps.size(); ++i)
+      {
+        if (swath_maps[i].ms1) continue;
+        OpenSwath::LightTargetedExperiment transition_exp_used;
+        OpenSwathHelper::selectSwathTransitions(irt_transitions, transition_exp_used,
+            cp.min_upper_edge_dist, swath_maps[i].lower, swath_maps[i].upper);
+        if (!transition_exp_used.getTransitions().empty()) schedule.push_back(swath_maps[i].sptr);
+      }
+      residency_manager_->setSchedule(schedule);
+    }
 #ifdef _OPENMP
 #pragma omp parallel for schedule(dynamic,1)
 #endif
@@ -310,16 +404,13 @@ namespace OpenMS
           std::vector< ChromatogramExtractor::ExtractionCoordinates > coordinates;
           ChromatogramExtractor extractor;
 
-          OpenSwath::SpectrumAccessPtr current_swath_map = swath_maps[map_idx].sptr;
-          if (load_into_memory)
-          {
-            // This creates an InMemory object that keeps all data in memory
-            current_swath_map = boost::shared_ptr<SpectrumAccessOpenMSInMemory>( new SpectrumAccessOpenMSInMemory(*current_swath_map) );
-          }
+          OpenSwath::SpectrumAccessPtr current_swath_map = acquireSwathMap_(swath_maps[map_idx].sptr, load_into_memory);
 
           prepareExtractionCoordinates_(tmp_out, coordinates, transition_exp_used, trafo_inverse, cp);
           extractor.extractChromatograms(current_swath_map, tmp_out, coordinates, cp.mz_extraction_window,
                 cp.ppm, cp.im_extraction_window, cp.extraction_function);
+          current_swath_map.reset();
+          releaseSwathMap_(swath_maps[map_idx].sptr);
           extractor.return_chromatogram(tmp_out, coordinates,
               transition_exp_used, SpectrumSettings(), tmp_chromatograms, false, cp.im_extraction_window);
 
@@ -386,6 +477,7 @@ namespace OpenMS
       LOG_DEBUG << " got a total of " << chromatograms.size() << " chromatograms after SONAR addition " << std::endl;
     }
 
+    if (residency_manager_ != nullptr) residency_manager_->setSchedule(std::vector< OpenSwath::SpectrumAccessPtr >());
     this->endProgress();
   }
 
@@ -432,7 +524,6 @@ namespace OpenMS
     trafo_inverse.invert();
 
     std::cout << "Will analyze " << transition_exp.transitions.size() << " transitions in total." << std::endl;
-    int progress = 0;
     this->startProgress(0, swath_maps.size(), "Extracting and scoring transitions");
 
     // (i) Obtain precursor chromatograms (MS1) if precursor extraction is enabled
@@ -468,142 +559,185 @@ namespace OpenMS
     }
 
     // (iii) Perform extraction and scoring of fragment ion chromatograms (MS2)
-    // We set dynamic scheduling such that the maps are worked on in the order
-    // in which they were given to the program / acquired. This gives much
-    // better load balancing than static allocation.
-#ifdef _OPENMP
-    int total_nr_threads = omp_get_max_threads(); // store total number of threads we are allowed to use
-    if (threads_outer_loop_ > -1)
+    // Scored lines are handed over to the output queue such that scoring
+    // threads do not wait for each other to write to disk.
+    OpenSwathOutputQueue output_queue(tsv_writer, osw_writer);
+
+    // Step 1: select which transitions to extract for each SWATH map and
+    // split them into batches of compounds
+    struct SwathWindowData
     {
-      omp_set_nested(1);
-      omp_set_dynamic(0);
-      omp_set_num_threads(std::min(threads_outer_loop_, omp_get_max_threads()) ); // use at most threads_outer_loop_ threads here
-    }
+      OpenSwath::LightTargetedExperiment transition_exp_used_all;
+      boost::shared_ptr< LightTargetedExperimentIndex > transition_index;
+      OpenSwath::SpectrumAccessPtr swath_map;
+      std::vector< OpenSwath::LightTargetedExperiment > batch_transition_exps;
+      std::vector< std::vector< OpenSwath::ChromatogramPtr > > batch_chrom_lists;
+      std::vector< CompactChromatogramList > batch_compact_chroms; // only used with cp.compact_chromatograms
+      std::vector< std::vector< ChromatogramExtractor::ExtractionCoordinates > > batch_coordinates;
+      int batch_size;
+    };
+    std::vector< SwathWindowData > windows(swath_maps.size());
+    std::vector< Size > batches_per_window(swath_maps.size(), 0);
+    LightTargetedExperimentIndex library_index(transition_exp);
+#ifdef _OPENMP
 #pragma omp parallel for schedule(dynamic,1)
 #endif
     for (SignedSize i = 0; i < boost::numeric_cast<SignedSize>(swath_maps.size()); ++i)
     {
-      if (!swath_maps[i].ms1) // skip MS1
+      if (swath_maps[i].ms1) continue; // skip MS1
+
+      SwathWindowData& window = windows[i];
+      OpenSwathHelper::selectSwathTransitions(library_index, window.transition_exp_used_all,
+          cp.min_upper_edge_dist, swath_maps[i].lower, swath_maps[i].upper);
+      Size nr_compounds = window.transition_exp_used_all.getCompounds().size();
+      if (window.transition_exp_used_all.getTransitions().empty() || nr_compounds == 0) continue; // skip if no transitions found
+      window.transition_index.reset(new LightTargetedExperimentIndex(window.transition_exp_used_all));
+
+      if (batchSize <= 0 || batchSize >= (int)nr_compounds)
       {
+        window.batch_size = nr_compounds;
+      }
+      else
+      {
+        window.batch_size = batchSize;
+      }
+      batches_per_window[i] = nr_compounds / window.batch_size + 1;
+    }
 
-        // Step 1: select which transitions to extract (proceed in batches)
-        OpenSwath::LightTargetedExperiment transition_exp_used_all;
-        OpenSwathHelper::selectSwathTransitions(transition_exp, transition_exp_used_all,
-            cp.min_upper_edge_dist, swath_maps[i].lower, swath_maps[i].upper);
-        if (transition_exp_used_all.getTransitions().size() > 0) // skip if no transitions found
-        {
+    // Step 2: process all (SWATH map, batch) pairs on all threads. We use a
+    // single scheduler for all of them instead of nested parallelization
+    // (dividing the threads between SWATH maps and batches), such that
+    // threads that are done with one SWATH map immediately continue with
+    // batches of the next one. Tasks are handed out in the order in which
+    // the maps were given to the program / acquired and at most
+    // threads_outer_loop_ maps are kept in memory at the same time.
+    for (Size i = 0; i < swath_maps.size(); ++i)
+    {
+      if (batches_per_window[i] == 0) this->nextProgress();
+    }
 
-          OpenSwath::SpectrumAccessPtr current_swath_map = swath_maps[i].sptr;
-          if (load_into_memory)
-          {
-            // This creates an InMemory object that keeps all data in memory
-            current_swath_map = boost::shared_ptr<SpectrumAccessOpenMSInMemory>( new SpectrumAccessOpenMSInMemory(*current_swath_map) );
-          }
+    // the maps are set up in this order, which allows to load them ahead of time
+    if (residency_manager_ != nullptr)
+    {
+      std::vector< OpenSwath::SpectrumAccessPtr > schedule;
+      for (Size i = 0; i < swath_maps.size(); ++i)
+      {
+        if (batches_per_window[i] > 0) schedule.push_back(swath_maps[i].sptr);
+      }
+      residency_manager_->setSchedule(schedule);
+    }
 
-          int batch_size;
-          if (batchSize <= 0 || batchSize >= (int)transition_exp_used_all.getCompounds().size())
-          {
-            batch_size = transition_exp_used_all.getCompounds().size();
-          }
-          else
-          {
-            batch_size = batchSize;
-          }
+    GroupedTaskScheduler scheduler(threads_outer_loop_);
+    scheduler.run(batches_per_window,
 
-          SignedSize nr_batches = (transition_exp_used_all.getCompounds().size() / batch_size);
+      // Step 2.1: load the SWATH map and extract the transitions of all
+      // batches in a single pass over it (each spectrum is only read and
+      // decoded once)
+      [&](Size i)
+      {
+        SwathWindowData& window = windows[i];
+        window.swath_map = acquireSwathMap_(swath_maps[i].sptr, load_into_memory);
+
+        Size nr_batches = batches_per_window[i];
+        window.batch_transition_exps.resize(nr_batches);
+        window.batch_chrom_lists.resize(nr_batches);
+        window.batch_coordinates.resize(nr_batches);
+        for (Size pep_idx = 0; pep_idx < nr_batches; pep_idx++)
+        {
+          selectCompoundsForBatch_(*window.transition_index, window.batch_transition_exps[pep_idx], window.batch_size, pep_idx);
+          prepareExtractionCoordinates_(window.batch_chrom_lists[pep_idx], window.batch_coordinates[pep_idx],
+              window.batch_transition_exps[pep_idx], trafo_inverse, cp);
+        }
 
-          // If we have a multiple of threads_outer_loop_ here, then use nested
-          // parallelization here. E.g. if we use 8 threads for the outer loop,
-          // but we have a total of 24 cores available, each of the 8 threads
-          // will then create a team of 3 threads to work on the batches
-          // individually.
-          //
-          // We should avoid oversubscribing the CPUs, therefore we use integer division.
-          // -- see https://docs.oracle.com/cd/E19059-01/stud.10/819-0501/2_nested.html
-#ifdef _OPENMP
-          int outer_thread_nr = omp_get_thread_num();
-          omp_set_num_threads(std::max(1, total_nr_threads / threads_outer_loop_) );
-#endif
-#pragma omp parallel for schedule(dynamic, 1)
-          for (SignedSize pep_idx = 0; pep_idx <= nr_batches; pep_idx++)
-          {
-            OpenSwath::SpectrumAccessPtr current_swath_map_inner = current_swath_map;
+        if (cp.compact_chromatograms)
+        {
+          // the batches are only converted to full chromatograms right before they are scored
+          std::vector< std::vector< OpenSwath::ChromatogramPtr > >(nr_batches).swap(window.batch_chrom_lists);
+          ChromatogramExtractorAlgorithm().extractChromatograms(window.swath_map, window.batch_compact_chroms, window.batch_coordinates,
+              cp.mz_extraction_window, cp.ppm, cp.im_extraction_window, cp.extraction_function);
+        }
+        else
+        {
+          ChromatogramExtractorAlgorithm().extractChromatograms(window.swath_map, window.batch_chrom_lists, window.batch_coordinates,
+              cp.mz_extraction_window, cp.ppm, cp.im_extraction_window, cp.extraction_function);
+        }
+      },
 
-#ifdef _OPENMP
-            // To ensure multi-threading safe access to the individual spectra, we
-            // need to use a light clone of the spectrum access (if multiple threads
-            // share a single filestream and call seek on it, chaos will ensue).
-            if (total_nr_threads / threads_outer_loop_ > 1)
-            {
-              current_swath_map_inner = current_swath_map->lightClone();
-            }
+      // Step 2.2: score a single batch
+      [&](Size i, Size pep_idx)
+      {
+        SwathWindowData& window = windows[i];
+        OpenSwath::SpectrumAccessPtr current_swath_map_inner = window.swath_map;
 
-#pragma omp critical (osw_write_stdout)
+#ifdef _OPENMP
+        // To ensure multi-threading safe access to the individual spectra, we
+        // need to use a light clone of the spectrum access (if multiple threads
+        // share a single filestream and call seek on it, chaos will ensue).
+        if (omp_get_num_threads() > 1)
+        {
+          current_swath_map_inner = window.swath_map->lightClone();
+        }
 #endif
-            {
-              std::cout << "Thread " <<
+
+        // lines of different threads are not mixed by the log stream
+        LOG_INFO << "Thread " <<
 #ifdef _OPENMP
-              outer_thread_nr << "_" << omp_get_thread_num() << " " <<
+        omp_get_thread_num() << " " <<
 #else
-              "0" << 
+        "0" << 
 #endif
-              "will analyze " << transition_exp_used_all.getCompounds().size() <<  " compounds and "
-              << transition_exp_used_all.getTransitions().size() <<  " transitions "
-              "from SWATH " << i << " (batch " << pep_idx << " out of " << nr_batches << ")" << std::endl;
-            }
-
-            // Create the new, batch-size transition experiment
-            OpenSwath::LightTargetedExperiment transition_exp_used;
-            selectCompoundsForBatch_(transition_exp_used_all, transition_exp_used, batch_size, pep_idx);
-
-            // Step 2.1: extract these transitions
-            ChromatogramExtractor extractor;
-            std::vector< OpenSwath::ChromatogramPtr > chrom_list;
-            std::vector< ChromatogramExtractor::ExtractionCoordinates > coordinates;
-
-            // Step 2.2: prepare the extraction coordinates and extract chromatograms
-            // chrom_list contains one entry for each fragment ion (transition) in transition_exp_used
-            prepareExtractionCoordinates_(chrom_list, coordinates, transition_exp_used, trafo_inverse, cp);
-            extractor.extractChromatograms(current_swath_map_inner, chrom_list, coordinates, cp.mz_extraction_window,
-                cp.ppm, cp.im_extraction_window, cp.extraction_function);
-
-            // Step 2.3: convert chromatograms back to OpenMS::MSChromatogram and write to output
-            PeakMap chrom_exp;
-            extractor.return_chromatogram(chrom_list, coordinates, transition_exp_used,  SpectrumSettings(), 
-                                          chrom_exp.getChromatograms(), false, cp.im_extraction_window);
-
-
-            // Step 3: score these extracted transitions
-            FeatureMap featureFile;
-            std::vector< OpenSwath::SwathMap > tmp = {swath_maps[i]};
-            tmp.back().sptr = current_swath_map_inner;
-            scoreAllChromatograms_(chrom_exp.getChromatograms(), ms1_chromatograms, tmp, transition_exp_used,
-                feature_finder_param, trafo, cp.rt_extraction_window, featureFile, tsv_writer, osw_writer, ms1_isotopes);
-
-            // Step 4: write all chromatograms and features out into an output object / file
-            // (this needs to be done in a critical section since we only have one
-            // output file and one output map).
-            #pragma omp critical (osw_write_out)
-            {
-              writeOutFeaturesAndChroms_(chrom_exp.getChromatograms(), featureFile, out_featureFile, store_features, chromConsumer);
-            }
-          }
+        "will analyze " << window.transition_exp_used_all.getCompounds().size() <<  " compounds and "
+        << window.transition_exp_used_all.getTransitions().size() <<  " transitions "
+        "from SWATH " << i << " (batch " << pep_idx << " out of " << batches_per_window[i] - 1 << ")" << std::endl;
+
+        // The batch-size transition experiment and its extracted chromatograms
+        // chrom_list contains one entry for each fragment ion (transition) in transition_exp_used
+        OpenSwath::LightTargetedExperiment& transition_exp_used = window.batch_transition_exps[pep_idx];
+        std::vector< OpenSwath::ChromatogramPtr >& chrom_list = window.batch_chrom_lists[pep_idx];
+        const std::vector< ChromatogramExtractor::ExtractionCoordinates >& coordinates = window.batch_coordinates[pep_idx];
+        if (cp.compact_chromatograms)
+        {
+          chrom_list = window.batch_compact_chroms[pep_idx].getChromatograms();
+          window.batch_compact_chroms[pep_idx].clear();
+        }
 
-        } // continue 2 (no continue due to OpenMP)
-      } // continue 1 (no continue due to OpenMP)
+        // Step 2.3: convert chromatograms back to OpenMS::MSChromatogram and write to output
+        ChromatogramExtractor extractor;
+        PeakMap chrom_exp;
+        extractor.return_chromatogram(chrom_list, coordinates, transition_exp_used,  SpectrumSettings(), 
+                                      chrom_exp.getChromatograms(), false, cp.im_extraction_window);
+        std::vector< OpenSwath::ChromatogramPtr >().swap(chrom_list); // release memory early
+
+        // Step 3: score these extracted transitions
+        FeatureMap featureFile;
+        std::vector< OpenSwath::SwathMap > tmp = {swath_maps[i]};
+        tmp.back().sptr = current_swath_map_inner;
+        scoreAllChromatograms_(chrom_exp.getChromatograms(), ms1_chromatograms, tmp, transition_exp_used,
+            feature_finder_param, trafo, cp.rt_extraction_window, featureFile, tsv_writer, osw_writer, ms1_isotopes,
+            false, &output_queue);
+
+        // Step 4: write all chromatograms and features out into an output object / file
+        // (this needs to be done in a critical section since we only have one
+        // output file and one output map).
+#ifdef _OPENMP
+#pragma omp critical (osw_write_out)
+#endif
+        {
+          writeOutFeaturesAndChroms_(chrom_exp.getChromatograms(), featureFile, out_featureFile, store_features, chromConsumer);
+        }
+      },
 
-      #pragma omp critical (progress)
-      this->setProgress(++progress);
+      // Step 2.4: release all data of the SWATH map
+      [&](Size i)
+      {
+        windows[i] = SwathWindowData();
+        releaseSwathMap_(swath_maps[i].sptr);
+        this->nextProgress();
+      });
 
-    }
+    output_queue.flush();
+    if (residency_manager_ != nullptr) residency_manager_->setSchedule(std::vector< OpenSwath::SpectrumAccessPtr >());
     this->endProgress();
-    
-#ifdef _OPENMP
-    if (threads_outer_loop_ > -1)
-    {
-      omp_set_num_threads(total_nr_threads); // set number of available threads back to initial value
-    }
-#endif    
   }
 
   void OpenSwathWorkflow::writeOutFeaturesAndChroms_(
@@ -655,15 +789,13 @@ namespace OpenMS
       if (swath_maps[i].ms1 && use_ms1_traces_)
       {
         // store reference to MS1 map for later -> note that this is *not* threadsafe!
-        ms1_map_ = swath_maps[i].sptr;
-
-        if (load_into_memory)
-        {
-          // This creates an InMemory object that keeps all data in memory
-          // but provides the same access functionality to the raw data as
-          // any object implementing ISpectrumAccess
-          ms1_map_ = boost::shared_ptr<SpectrumAccessOpenMSInMemory>( new SpectrumAccessOpenMSInMemory(*ms1_map_) );
-        }
+        // (with load_into_memory, this is an InMemory object that keeps all
+        // data in memory but provides the same access functionality to the
+        // raw data as any object implementing ISpectrumAccess)
+        ms1_map_.reset();
+        if (ms1_map_source_) releaseSwathMap_(ms1_map_source_);
+        ms1_map_source_ = swath_maps[i].sptr;
+        ms1_map_ = acquireSwathMap_(ms1_map_source_, load_into_memory);
 
         std::vector< OpenSwath::ChromatogramPtr > chrom_list;
         std::vector< ChromatogramExtractor::ExtractionCoordinates > coordinates;
@@ -716,7 +848,8 @@ namespace OpenMS
     OpenSwathTSVWriter & tsv_writer,
     OpenSwathOSWWriter & osw_writer,
     int nr_ms1_isotopes,
-    bool ms1only) const
+    bool ms1only,
+    OpenSwathOutputQueue* output_queue) const
   {
     TransformationDescription trafo_inv = trafo;
     trafo_inv.invert();
@@ -742,6 +875,7 @@ namespace OpenMS
     trgroup_picker.setParameters(trgroup_picker_param);
 
     featureFinder.setParameters(feature_finder_param);
+    featureFinder.setLibraryCache(library_cache_);
     featureFinder.prepareProteinPeptideMaps_(transition_exp);
 
     // Map ms1 chromatogram id to sequence number
@@ -778,7 +912,8 @@ namespace OpenMS
       assay_map[transition_exp.getTransitions()[i].getPeptideRef()].push_back(&transition_exp.getTransitions()[i]);
     }
 
-    std::vector<String> to_tsv_output, to_osw_output;
+    std::vector<String> to_tsv_output;
+    std::vector<OpenSwathOSWWriter::Row> to_osw_output;
     ///////////////////////////////////
     // Start of main function
     // Iterating over all the assays
@@ -872,10 +1007,18 @@ namespace OpenMS
       {
         const OpenSwath::LightCompound pep = transition_exp.getCompounds()[ assay_peptide_map[id] ];
         const TransitionType* transition = assay_it->second[detection_assay_it];
-        to_osw_output.push_back(osw_writer.prepareLine(pep, transition, output, id));
+        osw_writer.prepareRows(pep, transition, output, id, to_osw_output);
       }
     }
 
+    // Hand the lines over to the writer queue if we have one, otherwise write
+    // them directly (which needs a barrier for the TSV output)
+    if (output_queue != nullptr)
+    {
+      output_queue->write(to_tsv_output, to_osw_output);
+      return;
+    }
+
     // Only write at the very end since this is a step that needs a barrier
     if (tsv_writer.isActive())
     {
@@ -887,15 +1030,10 @@ namespace OpenMS
       }
     }
 
-    // Only write at the very end since this is a step that needs a barrier
+    // The OSW writer is thread-safe and inserts asynchronously
     if (osw_writer.isActive())
     {
-#ifdef _OPENMP
-#pragma omp critical (osw_write_tsv)
-#endif
-      {
-        osw_writer.writeLines(to_osw_output);
-      }
+      osw_writer.writeRows(to_osw_output);
     }
   }
 
@@ -918,6 +1056,44 @@ namespace OpenMS
     copyBatchTransitions_(transition_exp_used.compounds, transition_exp_used_all.transitions, transition_exp_used.transitions);
   }
 
+  void OpenSwathWorkflow::selectCompoundsForBatch_(const LightTargetedExperimentIndex& index,
+    OpenSwath::LightTargetedExperiment& transition_exp_used, int batch_size, size_t j)
+  {
+    const OpenSwath::LightTargetedExperiment& transition_exp_used_all = index.getExperiment();
+
+    // compute batch start/end
+    size_t start = j * batch_size;
+    size_t end = j * batch_size + batch_size;
+    if (end > transition_exp_used_all.compounds.size())
+    {
+      end = transition_exp_used_all.compounds.size();
+    }
+
+    // Create the new, batch-size transition experiment
+    transition_exp_used.proteins = transition_exp_used_all.proteins;
+    transition_exp_used.compounds.insert(transition_exp_used.compounds.end(),
+        transition_exp_used_all.compounds.begin() + start, transition_exp_used_all.compounds.begin() + end);
+
+    // map the compounds to their (first) index, such that duplicated
+    // identifiers select their transitions only once
+    std::vector<Size> compound_indices;
+    for (size_t i = start; i < end; i++)
+    {
+      SignedSize c = index.getCompoundIndex(transition_exp_used_all.compounds[i].id);
+      if (c >= 0) compound_indices.push_back(c);
+    }
+    std::sort(compound_indices.begin(), compound_indices.end());
+    compound_indices.erase(std::unique(compound_indices.begin(), compound_indices.end()), compound_indices.end());
+
+    std::vector<Size> transition_indices;
+    index.selectCompoundTransitions(compound_indices, transition_indices);
+    transition_exp_used.transitions.reserve(transition_exp_used.transitions.size() + transition_indices.size());
+    for (Size i = 0; i < transition_indices.size(); i++)
+    {
+      transition_exp_used.transitions.push_back(transition_exp_used_all.transitions[transition_indices[i]]);
+    }
+  }
+
   void OpenSwathWorkflow::copyBatchTransitions_(const std::vector<OpenSwath::LightCompound>& used_compounds,
     const std::vector<OpenSwath::LightTransition>& all_transitions,
     std::vector<OpenSwath::LightTransition>& output)
@@ -937,6 +1113,28 @@ namespace OpenMS
     }
   }
 
+  OpenSwath::SpectrumAccessPtr OpenSwathWorkflowBase::acquireSwathMap_(const OpenSwath::SpectrumAccessPtr& map, bool load_into_memory)
+  {
+    if (residency_manager_ != nullptr)
+    {
+      return residency_manager_->acquire(map);
+    }
+    if (load_into_memory)
+    {
+      // This creates an InMemory object that keeps all data in memory
+      return boost::shared_ptr<SpectrumAccessOpenMSInMemory>( new SpectrumAccessOpenMSInMemory(*map) );
+    }
+    return map;
+  }
+
+  void OpenSwathWorkflowBase::releaseSwathMap_(const OpenSwath::SpectrumAccessPtr& map)
+  {
+    if (residency_manager_ != nullptr)
+    {
+      residency_manager_->release(map);
+    }
+  }
+
   void OpenSwathWorkflowBase::prepareExtractionCoordinates_(std::vector< OpenSwath::ChromatogramPtr > & chrom_list,
                                                             std::vector< ChromatogramExtractorAlgorithm::ExtractionCoordinates > & coordinates, 
                                                             const OpenSwath::LightTargetedExperiment & transition_exp_used, 
@@ -1005,9 +1203,22 @@ namespace OpenMS
       double sonar_winsize, sonar_start, sonar_end;
       int sonar_total_win;
       computeSonarWindows_(swath_maps, sonar_winsize, sonar_start, sonar_end, sonar_total_win);
+      LightTargetedExperimentIndex library_index(transition_exp);
+
+      if (streaming_)
+      {
+        std::cout << "Will analyze " << transition_exp.transitions.size() << " transitions in total (streaming)." << std::endl;
+        performExtractionSonarStreaming_(swath_maps, library_index, ms1_chromatograms, trafo, trafo_inverse, cp,
+            feature_finder_param, sonar_winsize, sonar_start, sonar_total_win, out_featureFile, store_features,
+            tsv_writer, osw_writer, chromConsumer, batchSize);
+        if (osw_writer.isActive())
+        {
+          osw_writer.flush();
+        }
+        return;
+      }
 
       std::cout << "Will analyze " << transition_exp.transitions.size() << " transitions in total." << std::endl;
-      int progress = 0;
       this->startProgress(0, sonar_total_win, "Extracting and scoring transitions");
 
       ///////////////////////////////////////////////////////////////////////////
@@ -1027,8 +1238,9 @@ namespace OpenMS
 
         // Step 1: select which transitions to extract with the current windows (proceed in batches)
         OpenSwath::LightTargetedExperiment transition_exp_used_all;
-        OpenSwathHelper::selectSwathTransitions(transition_exp, transition_exp_used_all,
+        OpenSwathHelper::selectSwathTransitions(library_index, transition_exp_used_all,
             0, currwin_start, currwin_end);
+        LightTargetedExperimentIndex window_index(transition_exp_used_all);
 
         if (transition_exp_used_all.getTransitions().size() > 0) // skip if no transitions found
         {
@@ -1057,6 +1269,7 @@ namespace OpenMS
           ////////////////////////////////// 
           // Threadsafe loading of identified maps
           ////////////////////////////////// 
+          std::vector< OpenSwath::SpectrumAccessPtr > used_map_sources;
           for (Size i = 0; i < used_maps.size(); i++)
           {
 #ifdef _OPENMP
@@ -1067,7 +1280,13 @@ namespace OpenMS
               // multiple threads could access the same maps) which often
               // happens in SONAR. Thus we either create a threadsafe light
               // clone or load them into memory if requested.
-              if (load_into_memory)
+              if (residency_manager_ != nullptr)
+              {
+                // in-memory maps of the manager are shared as well
+                used_map_sources.push_back(used_maps[i].sptr);
+                used_maps[i].sptr = residency_manager_->acquire(used_maps[i].sptr)->lightClone();
+              }
+              else if (load_into_memory)
               {
                 used_maps[i].sptr = boost::shared_ptr<SpectrumAccessOpenMSInMemory>( new SpectrumAccessOpenMSInMemory(*used_maps[i].sptr) );
               }
@@ -1088,23 +1307,18 @@ namespace OpenMS
             batch_size = batchSize;
           }
 
+          LOG_INFO << "Thread " <<
 #ifdef _OPENMP
-#pragma omp critical (osw_write_stdout)
+          omp_get_thread_num() << " " <<
 #endif
-          {
-            std::cout << "Thread " <<
-#ifdef _OPENMP
-            omp_get_thread_num() << " " <<
-#endif
-            "will analyze " << transition_exp_used_all.getCompounds().size() <<  " compounds and "
-            << transition_exp_used_all.getTransitions().size() <<  " transitions "
-            "from SONAR SWATH " << sonar_idx << " in batches of " << batch_size << std::endl;
-          }
+          "will analyze " << transition_exp_used_all.getCompounds().size() <<  " compounds and "
+          << transition_exp_used_all.getTransitions().size() <<  " transitions "
+          "from SONAR SWATH " << sonar_idx << " in batches of " << batch_size << std::endl;
           for (size_t pep_idx = 0; pep_idx <= (transition_exp_used_all.getCompounds().size() / batch_size); pep_idx++)
           {
             // Create the new, batch-size transition experiment
             OpenSwath::LightTargetedExperiment transition_exp_used;
-            selectCompoundsForBatch_(transition_exp_used_all, transition_exp_used, batch_size, pep_idx);
+            selectCompoundsForBatch_(window_index, transition_exp_used, batch_size, pep_idx);
 
             // Step 2.1: extract these transitions
             std::vector< OpenSwath::ChromatogramPtr > chrom_list;
@@ -1134,16 +1348,242 @@ namespace OpenMS
               writeOutFeaturesAndChroms_(chrom_exp.getChromatograms(), featureFile, out_featureFile, store_features, chromConsumer);
             }
           }
+
+          used_maps.clear();
+          for (Size i = 0; i < used_map_sources.size(); i++)
+          {
+            releaseSwathMap_(used_map_sources[i]);
+          }
+        }
+        this->nextProgress();
+      }
+      this->endProgress();
+
+      if (osw_writer.isActive())
+      {
+        osw_writer.flush();
+      }
+    }
+
+
+    void OpenSwathWorkflowSonar::performExtractionSonarStreaming_(const std::vector< OpenSwath::SwathMap > & swath_maps,
+                                                                  const LightTargetedExperimentIndex & library_index,
+                                                                  const std::vector< MSChromatogram > & ms1_chromatograms,
+                                                                  const TransformationDescription & trafo,
+                                                                  const TransformationDescription & trafo_inverse,
+                                                                  const ChromExtractParams & cp,
+                                                                  const Param & feature_finder_param,
+                                                                  double sonar_winsize,
+                                                                  double sonar_start,
+                                                                  int sonar_total_win,
+                                                                  FeatureMap& out_featureFile,
+                                                                  bool store_features,
+                                                                  OpenSwathTSVWriter & tsv_writer,
+                                                                  OpenSwathOSWWriter & osw_writer,
+                                                                  Interfaces::IMSDataConsumer * chromConsumer,
+                                                                  int batchSize)
+    {
+      // Data of a (virtual) SONAR window while its maps are read
+      struct SonarWindowData
+      {
+        bool open = false;
+        std::vector< OpenSwath::LightTargetedExperiment > batch_transition_exps;
+        std::vector< std::vector< OpenSwath::ChromatogramPtr > > batch_chrom_lists;
+        std::vector< std::vector< ChromatogramExtractor::ExtractionCoordinates > > batch_coordinates;
+        std::vector< OpenSwath::SwathMap > used_maps;
+      };
+      std::vector< SonarWindowData > windows(sonar_total_win);
+
+      // Process the maps in order of their lower m/z bound: a window is
+      // complete once a map starts above its upper end
+      std::vector< Size > map_order;
+      for (Size i = 0; i < swath_maps.size(); ++i)
+      {
+        if (!swath_maps[i].ms1) map_order.push_back(i);
+      }
+      std::stable_sort(map_order.begin(), map_order.end(),
+          [&swath_maps](Size a, Size b) { return swath_maps[a].lower < swath_maps[b].lower; });
+
+      int progress = 0;
+      this->startProgress(0, map_order.size(), "Extracting and scoring transitions");
+      int first_pending = 0; // all windows before this one are done
+      for (Size order_idx = 0; order_idx < map_order.size(); ++order_idx)
+      {
+        const OpenSwath::SwathMap& map = swath_maps[map_order[order_idx]];
+
+        ////////////////////////////////// 
+        // Step 1: set up the windows overlapping the current map and collect
+        // the coordinates to extract from it (one set per window and batch)
+        ////////////////////////////////// 
+        std::vector< std::vector< OpenSwath::ChromatogramPtr > > map_chrom_lists;
+        std::vector< std::vector< ChromatogramExtractor::ExtractionCoordinates > > map_coordinates;
+        std::vector< std::vector< Size > > map_positions; // position of each coordinate in its batch
+        std::vector< std::pair< int, Size > > map_sets; // window and batch of each set
+        for (int sonar_idx = first_pending; sonar_idx < sonar_total_win; sonar_idx++)
+        {
+          double currwin_start = sonar_start + sonar_idx * sonar_winsize;
+          double currwin_end = currwin_start + sonar_winsize;
+          if (currwin_start > map.upper) break;
+          // same criterion as in performExtractionSonar
+          if (!( (currwin_start >= map.lower && currwin_start <= map.upper  ) ||
+                 (currwin_end >= map.lower && currwin_end <= map.upper  ) ))
+          {
+            continue;
+          }
+
+          SonarWindowData& window = windows[sonar_idx];
+          if (!window.open)
+          {
+            window.open = true;
+            OpenSwath::LightTargetedExperiment transition_exp_used_all;
+            OpenSwathHelper::selectSwathTransitions(library_index, transition_exp_used_all,
+                0, currwin_start, currwin_end);
+            Size nr_compounds = transition_exp_used_all.getCompounds().size();
+            if (transition_exp_used_all.getTransitions().empty() || nr_compounds == 0) continue; // skip if no transitions found
+
+            int batch_size;
+            if (batchSize <= 0 || batchSize >= (int)nr_compounds)
+            {
+              batch_size = nr_compounds;
+            }
+            else
+            {
+              batch_size = batchSize;
+            }
+            LOG_DEBUG << "Will analyze " << nr_compounds <<  " compounds and "
+              << transition_exp_used_all.getTransitions().size() <<  " transitions "
+              "from SONAR SWATH " << sonar_idx << " in batches of " << batch_size << std::endl;
+
+            LightTargetedExperimentIndex window_index(transition_exp_used_all);
+            Size nr_batches = nr_compounds / batch_size + 1;
+            window.batch_transition_exps.resize(nr_batches);
+            window.batch_chrom_lists.resize(nr_batches);
+            window.batch_coordinates.resize(nr_batches);
+            for (Size pep_idx = 0; pep_idx < nr_batches; pep_idx++)
+            {
+              selectCompoundsForBatch_(window_index, window.batch_transition_exps[pep_idx], batch_size, pep_idx);
+              prepareExtractionCoordinates_(window.batch_chrom_lists[pep_idx], window.batch_coordinates[pep_idx],
+                  window.batch_transition_exps[pep_idx], trafo_inverse, cp);
+            }
+          }
+          if (window.batch_coordinates.empty()) continue;
+
+          window.used_maps.push_back(map);
+          for (Size pep_idx = 0; pep_idx < window.batch_coordinates.size(); pep_idx++)
+          {
+            const std::vector< ChromatogramExtractor::ExtractionCoordinates >& coordinates = window.batch_coordinates[pep_idx];
+            std::vector< ChromatogramExtractor::ExtractionCoordinates > coordinates_used;
+            std::vector< Size > positions;
+            for (Size c_idx = 0; c_idx < coordinates.size(); c_idx++)
+            {
+              if (coordinates[c_idx].mz_precursor > map.lower &&
+                  coordinates[c_idx].mz_precursor < map.upper)
+              {
+                coordinates_used.push_back(coordinates[c_idx]);
+                positions.push_back(c_idx);
+              }
+            }
+            if (coordinates_used.empty()) continue;
+
+            std::vector< OpenSwath::ChromatogramPtr > chrom_list;
+            for (Size c_idx = 0; c_idx < coordinates_used.size(); c_idx++)
+            {
+              chrom_list.push_back(OpenSwath::ChromatogramPtr(new OpenSwath::Chromatogram));
+            }
+            map_chrom_lists.push_back(chrom_list);
+            map_coordinates.push_back(coordinates_used);
+            map_positions.push_back(positions);
+            map_sets.push_back(std::make_pair(sonar_idx, pep_idx));
+          }
         }
+
+        ////////////////////////////////// 
+        // Step 2: extract all windows from the current map in a single pass
+        // and add the result to the chromatograms of each window
+        ////////////////////////////////// 
+        if (!map_sets.empty())
+        {
+          ChromatogramExtractorAlgorithm().extractChromatograms(map.sptr->lightClone(), map_chrom_lists, map_coordinates,
+              cp.mz_extraction_window, cp.ppm, cp.im_extraction_window, cp.extraction_function);
+        }
+        for (Size set_idx = 0; set_idx < map_sets.size(); set_idx++)
+        {
+          std::vector< OpenSwath::ChromatogramPtr >& chrom_list =
+            windows[map_sets[set_idx].first].batch_chrom_lists[map_sets[set_idx].second];
+          for (Size j = 0; j < map_positions[set_idx].size(); j++)
+          {
+            Size c_idx = map_positions[set_idx][j];
+            chrom_list[c_idx] = addChromatograms(chrom_list[c_idx], map_chrom_lists[set_idx][j]);
+          }
+        }
+        map_chrom_lists.clear();
+
+        ////////////////////////////////// 
+        // Step 3: score all windows that no further map overlaps
+        ////////////////////////////////// 
+        double next_lower = std::numeric_limits<double>::infinity();
+        if (order_idx + 1 < map_order.size())
+        {
+          next_lower = swath_maps[map_order[order_idx + 1]].lower;
+        }
+        int first_open = first_pending;
+        while (first_pending < sonar_total_win && sonar_start + (first_pending + 1) * sonar_winsize < next_lower)
+        {
+          first_pending++;
+        }
+
+        std::vector< std::pair< int, Size > > tasks;
+        for (int sonar_idx = first_open; sonar_idx < first_pending; sonar_idx++)
+        {
+          for (Size pep_idx = 0; pep_idx < windows[sonar_idx].batch_coordinates.size(); pep_idx++)
+          {
+            tasks.push_back(std::make_pair(sonar_idx, pep_idx));
+          }
+        }
+
 #ifdef _OPENMP
-#pragma omp critical (progress)
+#pragma omp parallel for schedule(dynamic, 1)
 #endif
+        for (SignedSize task_idx = 0; task_idx < boost::numeric_cast<SignedSize>(tasks.size()); task_idx++)
+        {
+          SonarWindowData& window = windows[tasks[task_idx].first];
+          Size pep_idx = tasks[task_idx].second;
+
+          // batches of the same window are scored concurrently and need their own map access
+          std::vector< OpenSwath::SwathMap > used_maps = window.used_maps;
+          for (Size i = 0; i < used_maps.size(); i++)
+          {
+            used_maps[i].sptr = used_maps[i].sptr->lightClone();
+          }
+
+          // convert chromatograms back to OpenMS::MSChromatogram and score them
+          PeakMap chrom_exp;
+          ChromatogramExtractor().return_chromatogram(window.batch_chrom_lists[pep_idx], window.batch_coordinates[pep_idx],
+              window.batch_transition_exps[pep_idx], SpectrumSettings(), chrom_exp.getChromatograms(), false, cp.im_extraction_window);
+          std::vector< OpenSwath::ChromatogramPtr >().swap(window.batch_chrom_lists[pep_idx]); // release memory early
+
+          FeatureMap featureFile;
+          scoreAllChromatograms_(chrom_exp.getChromatograms(), ms1_chromatograms, used_maps, window.batch_transition_exps[pep_idx],
+                                 feature_finder_param, trafo, cp.rt_extraction_window, featureFile, tsv_writer, osw_writer);
+
+          // write all chromatograms and features out into an output object / file
+#ifdef _OPENMP
+#pragma omp critical (osw_write_out)
+#endif
+          {
+            writeOutFeaturesAndChroms_(chrom_exp.getChromatograms(), featureFile, out_featureFile, store_features, chromConsumer);
+          }
+        }
+
+        for (int sonar_idx = first_open; sonar_idx < first_pending; sonar_idx++)
+        {
+          windows[sonar_idx] = SonarWindowData();
+        }
         this->setProgress(++progress);
       }
       this->endProgress();
     }
 
-
     void OpenSwathWorkflowSonar::computeSonarWindows_(const std::vector< OpenSwath::SwathMap > & swath_maps,
                                                       double & sonar_winsize,
                                                       double & sonar_start,
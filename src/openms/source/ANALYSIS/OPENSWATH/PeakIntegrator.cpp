@@ -34,8 +34,49 @@
 
 #include <OpenMS/ANALYSIS/OPENSWATH/PeakIntegrator.h>
 
+#include <algorithm>
+
 namespace OpenMS
 {
+  namespace
+  {
+    // kernels for integratePeaks(), they work on the index range [b, e) of contiguous arrays
+
+    double rangeSum(const double* y, const Size b, const Size e)
+    {
+      double sum = 0.0;
+      for (Size i = b; i < e; ++i)
+      {
+        sum += y[i];
+      }
+      return sum;
+    }
+
+    // requires e - b >= 2
+    double trapezoid(const double* x, const double* y, const Size b, const Size e)
+    {
+      double sum = 0.0;
+      for (Size i = b; i + 1 < e; ++i)
+      {
+        sum += (x[i + 1] - x[i]) * (y[i] + y[i + 1]);
+      }
+      return sum / 2.0;
+    }
+
+    // Simpson's rule for unequally spaced points (see PeakIntegrator::simpson_), requires an odd number of points
+    double simpson(const double* x, const double* y, const Size b, const Size e)
+    {
+      double integral = 0.0;
+      for (Size i = b + 1; i + 1 < e; i += 2)
+      {
+        const double h = x[i] - x[i - 1];
+        const double k = x[i + 1] - x[i];
+        integral += (1.0 / 6.0) * (h + k) * ((2.0 - k / h) * y[i - 1] + ((h + k) * (h + k) / (h * k)) * y[i] + (2.0 - h / k) * y[i + 1]);
+      }
+      return integral;
+    }
+  }
+
   PeakIntegrator::PeakIntegrator() :
     DefaultParamHandler("PeakIntegrator")
   {
@@ -105,6 +146,154 @@ namespace OpenMS
     return calculatePeakShapeMetrics_(spectrum, left->getMZ(), right->getMZ(), peak_height, peak_apex_pos);
   }
 
+  void PeakIntegrator::integratePeaks(
+    const std::vector<PeakIntegrationJob>& jobs,
+    std::vector<PeakArea>& areas,
+    std::vector<PeakBackground>& backgrounds,
+    const bool compute_hull_points
+  ) const
+  {
+    const bool use_trapezoid = integration_type_ == INTEGRATION_TYPE_TRAPEZOID;
+    const bool use_simpson = integration_type_ == INTEGRATION_TYPE_SIMPSON;
+    const bool use_sum = integration_type_ == INTEGRATION_TYPE_INTENSITYSUM;
+    if (!use_trapezoid && !use_simpson && !use_sum)
+    {
+      throw Exception::InvalidParameter(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "Please set a valid value for the parameter \"integration_type\".");
+    }
+    const bool base_to_base = baseline_type_ == BASELINE_TYPE_BASETOBASE;
+    const bool vertical_min = baseline_type_ == BASELINE_TYPE_VERTICALDIVISION || baseline_type_ == BASELINE_TYPE_VERTICALDIVISION_MIN;
+    const bool vertical_max = baseline_type_ == BASELINE_TYPE_VERTICALDIVISION_MAX;
+    if (!base_to_base && !vertical_min && !vertical_max)
+    {
+      throw Exception::InvalidParameter(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "Please set a valid value for the parameter \"baseline_type\".");
+    }
+
+    areas.assign(jobs.size(), PeakArea());
+    backgrounds.assign(jobs.size(), PeakBackground());
+
+    if (fit_EMG_)
+    {
+      // the EMG fit needs a peak container
+      for (Size j = 0; j < jobs.size(); ++j)
+      {
+        const PeakIntegrationJob& job = jobs[j];
+        if (std::upper_bound(job.pos, job.pos + job.size, job.right) <= std::lower_bound(job.pos, job.pos + job.size, job.left))
+        {
+          areas[j].apex_pos = (job.left + job.right) / 2;
+          continue;
+        }
+        MSChromatogram chromatogram;
+        for (Size i = 0; i < job.size; ++i)
+        {
+          chromatogram.push_back(ChromatogramPeak(job.pos[i], job.intensity[i]));
+        }
+        areas[j] = integratePeak_(chromatogram, job.left, job.right);
+        backgrounds[j] = estimateBackground_(chromatogram, job.left, job.right, areas[j].apex_pos);
+        if (!compute_hull_points) areas[j].hull_points.clear();
+      }
+      return;
+    }
+
+    Size simpson_fallbacks = 0;
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic, 64) reduction(+: simpson_fallbacks)
+#endif
+    for (SignedSize j = 0; j < (SignedSize)jobs.size(); ++j)
+    {
+      const PeakIntegrationJob& job = jobs[j];
+      const double* x = job.pos;
+      const double* y = job.intensity;
+      const Size b = std::lower_bound(x, x + job.size, job.left) - x;
+      const Size e = std::upper_bound(x, x + job.size, job.right) - x;
+
+      PeakArea& pa = areas[j];
+      pa.apex_pos = (job.left + job.right) / 2; // initial estimate, to avoid apex being outside of [left,right]
+      if (e <= b) continue;
+      const Size n_points = e - b;
+
+      if (compute_hull_points) pa.hull_points.reserve(n_points);
+      for (Size i = b; i < e; ++i)
+      {
+        if (compute_hull_points) pa.hull_points.push_back(DPosition<2>(x[i], y[i]));
+        if (pa.height < y[i])
+        {
+          pa.height = y[i];
+          pa.apex_pos = x[i];
+        }
+      }
+
+      if (use_sum)
+      {
+        pa.area = rangeSum(y, b, e);
+      }
+      else if (n_points == 2 || (use_trapezoid && n_points > 2)) // Simpson's rule needs at least three points
+      {
+        if (use_simpson) ++simpson_fallbacks;
+        pa.area = trapezoid(x, y, b, e);
+      }
+      else if (n_points > 2) // simpson
+      {
+        if (n_points % 2)
+        {
+          pa.area = simpson(x, y, b, e);
+        }
+        else
+        {
+          // average over the odd sub- and super-ranges, as in integratePeak()
+          double area = simpson(x, y, b, e - 1) + simpson(x, y, b + 1, e);
+          UInt valids = 2;
+          if (b > 0)
+          {
+            area += simpson(x, y, b - 1, e);
+            ++valids;
+          }
+          if (e < job.size)
+          {
+            area += simpson(x, y, b, e + 1);
+            ++valids;
+          }
+          pa.area = area / valids;
+        }
+      }
+
+      // background, see estimateBackground_()
+      const double int_l = y[b];
+      const double int_r = y[e - 1];
+      const double delta_int = int_r - int_l;
+      const double delta_pos = x[e - 1] - x[b];
+      const double min_int_pos = int_r <= int_l ? x[e - 1] : x[b];
+      PeakBackground& pb = backgrounds[j];
+      if (base_to_base)
+      {
+        const double delta_int_apex = std::fabs(delta_int) * std::fabs(min_int_pos - pa.apex_pos) / delta_pos;
+        pb.height = std::min(int_r, int_l) + delta_int_apex;
+        if (!use_sum)
+        {
+          pb.area = delta_pos * (std::min(int_r, int_l) + 0.5 * std::fabs(delta_int));
+        }
+        else
+        {
+          const double pos_sum = rangeSum(x, b, e);
+          const double rectangle_area = n_points * int_l;
+          const double slope = delta_int / delta_pos;
+          const double triangle_area = (pos_sum - n_points * x[b]) * slope;
+          pb.area = triangle_area + rectangle_area;
+        }
+      }
+      else
+      {
+        pb.height = vertical_min ? std::min(int_r, int_l) : std::max(int_r, int_l);
+        pb.area = use_sum ? pb.height * n_points : pb.height * delta_pos;
+      }
+    }
+
+    if (simpson_fallbacks > 0)
+    {
+      LOG_WARN << std::endl << "PeakIntegrator::integratePeaks: "
+        "number of points is 2 for " << simpson_fallbacks << " peak(s), falling back to `trapezoid`." << std::endl;
+    }
+  }
+
   void PeakIntegrator::getDefaultParameters(Param& params)
   {
     params.clear();
@@ -41,7 +41,7 @@
 namespace OpenMS
 {
 
-  OpenSwath::SpectrumPtr SpectrumAddition::addUpSpectra(const std::vector<OpenSwath::SpectrumPtr> all_spectra,
+  OpenSwath::SpectrumPtr SpectrumAddition::addUpSpectra(const std::vector<OpenSwath::SpectrumPtr>& all_spectra,
       double sampling_rate, bool filter_zeros)
   {
     if (all_spectra.size() == 1) return all_spectra[0];
@@ -91,18 +91,15 @@ namespace OpenMS
       ++cnt;
     }
 
-    LinearResamplerAlign lresampler;
-    // resample all spectra and add to master spectrum
+    // resample all spectra and add to master spectrum (all use the same uniform raster)
     for (Size curr_sp = 0; curr_sp < all_spectra.size(); curr_sp++)
     {
-      lresampler.raster(all_spectra[curr_sp]->getMZArray()->data.begin(),
-                        all_spectra[curr_sp]->getMZArray()->data.end(),
-                        all_spectra[curr_sp]->getIntensityArray()->data.begin(),
-                        all_spectra[curr_sp]->getIntensityArray()->data.end(),
-                        resampled_peak_container->getMZArray()->data.begin(),
-                        resampled_peak_container->getMZArray()->data.end(),
-                        resampled_peak_container->getIntensityArray()->data.begin(),
-                        resampled_peak_container->getIntensityArray()->data.end()
+      LinearResamplerAlign::rasterUniform(all_spectra[curr_sp]->getMZArray()->data.begin(),
+                                          all_spectra[curr_sp]->getMZArray()->data.end(),
+                                          all_spectra[curr_sp]->getIntensityArray()->data.begin(),
+                                          min, sampling_rate,
+                                          resampled_peak_container->getIntensityArray()->data.begin(),
+                                          resampled_peak_container->getIntensityArray()->data.end()
       );
     }
 
@@ -125,7 +122,7 @@ namespace OpenMS
     }
   }
 
-  OpenMS::MSSpectrum SpectrumAddition::addUpSpectra(const std::vector<OpenMS::MSSpectrum> all_spectra, double sampling_rate, bool filter_zeros)
+  OpenMS::MSSpectrum SpectrumAddition::addUpSpectra(const std::vector<OpenMS::MSSpectrum>& all_spectra, double sampling_rate, bool filter_zeros)
   {
     if (all_spectra.size() == 1) return all_spectra[0];
     if (all_spectra.empty()) return MSSpectrum();
@@ -166,31 +163,29 @@ namespace OpenMS
 
     // generate the resampled peaks at positions origin+i*spacing_
     int number_resampled_points = (max - min) / sampling_rate + 1;
-    MSSpectrum resampled_peak_container;
-    resampled_peak_container.resize(number_resampled_points);
-    MSSpectrum::iterator it = resampled_peak_container.begin();
-    for (int i = 0; i < number_resampled_points; ++i)
-    {
-      it->setMZ(min + i * sampling_rate);
-      it->setIntensity(0);
-      ++it;
-    }
 
-    // resample all spectra and add to master spectrum
-    LinearResamplerAlign lresampler;
-    MSSpectrum master_spectrum = resampled_peak_container;
+    // resample all spectra onto the same uniform raster and add them up
+    std::vector<double> summed_intensities(number_resampled_points, 0.0);
+    std::vector<double> mz, intensity;
     for (Size curr_sp = 0; curr_sp < all_spectra.size(); curr_sp++)
     {
-      MSSpectrum input_spectrum;
-      MSSpectrum output_spectrum = resampled_peak_container;
-
-      lresampler.raster(all_spectra[curr_sp].begin(), all_spectra[curr_sp].end(), output_spectrum.begin(), output_spectrum.end());
-
-      // add to master spectrum
-      for (Size i = 0; i < output_spectrum.size(); ++i)
+      mz.resize(all_spectra[curr_sp].size());
+      intensity.resize(all_spectra[curr_sp].size());
+      for (Size k = 0; k < all_spectra[curr_sp].size(); ++k)
       {
-        master_spectrum[i].setIntensity(master_spectrum[i].getIntensity() + output_spectrum[i].getIntensity());
+        mz[k] = all_spectra[curr_sp][k].getMZ();
+        intensity[k] = all_spectra[curr_sp][k].getIntensity();
       }
+      LinearResamplerAlign::rasterUniform(mz.begin(), mz.end(), intensity.begin(), min, sampling_rate,
+                                          summed_intensities.begin(), summed_intensities.end());
+    }
+
+    MSSpectrum master_spectrum;
+    master_spectrum.resize(number_resampled_points);
+    for (int i = 0; i < number_resampled_points; ++i)
+    {
+      master_spectrum[i].setMZ(min + i * sampling_rate);
+      master_spectrum[i].setIntensity(summed_intensities[i]);
     }
 
     if (!filter_zeros)
@@ -43,6 +43,10 @@
 // Functions
 #include <OpenMS/OPENSWATHALGO/DATAACCESS/SpectrumHelpers.h> // integrateWindow
 
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
 // #define SWATHMAPMASSCORRECTION_DEBUG
 
 namespace OpenMS
@@ -72,93 +76,157 @@ namespace OpenMS
     os.precision(writtenDigits(double()));
 #endif
 
-    TransformationDescription::DataPoints data_all;
-    std::vector<double> weights;
-    std::vector<double> exp_mz;
-    std::vector<double> theo_mz;
-    std::vector<double> delta_ppm;
+    // transition groups in the order of the map
+    std::vector<OpenMS::MRMFeatureFinderScoring::MRMTransitionGroupType *> transition_groups;
+    transition_groups.reserve(transition_group_map.size());
     for (auto trgroup_it = transition_group_map.begin(); trgroup_it != transition_group_map.end(); ++trgroup_it)
     {
+      transition_groups.push_back(trgroup_it->second);
+    }
 
-      // we need at least one feature to find the best one
-      auto transition_group = trgroup_it->second;
-      if (transition_group->getFeatures().size() == 0)
-      {
-        continue;
-      }
-
-      // Find the feature with the highest score
-      double bestRT = -1;
-      double highest_score = -1000;
-      for (auto mrmfeature = transition_group->getFeatures().begin(); mrmfeature != transition_group->getFeatures().end(); ++mrmfeature)
+    // Extract the calibrating data points of all transition groups in
+    // parallel, each group gets its own list of points (measured m/z,
+    // theoretical m/z, intensity, RT)
+    std::vector<std::vector<CalibrationPoint_> > group_points(transition_groups.size());
+    Size err_count(0);
+    std::exception_ptr err;
+#ifdef _OPENMP
+#pragma omp parallel
+#endif
+    {
+      // To ensure multi-threading safe access to the spectra, each thread needs
+      // a light clone of the spectrum access (a shared filestream would be
+      // used by multiple threads otherwise)
+      std::vector< OpenSwath::SwathMap > local_swath_maps = swath_maps;
+#ifdef _OPENMP
+      if (omp_get_num_threads() > 1)
       {
-        if (mrmfeature->getOverallQuality() > highest_score)
+        for (Size i = 0; i < local_swath_maps.size(); ++i)
         {
-          bestRT = mrmfeature->getRT();
-          highest_score = mrmfeature->getOverallQuality();
+          local_swath_maps[i].sptr = local_swath_maps[i].sptr->lightClone();
         }
       }
+#endif
+      OpenSwathScoring scoring;
 
-      // Get the corresponding SWATH map(s), for SONAR there will be more than one map
-      std::vector<OpenSwath::SwathMap> used_maps;
-      for (SignedSize i = 0; i < boost::numeric_cast<SignedSize>(swath_maps.size()); ++i)
+#ifdef _OPENMP
+#pragma omp for schedule(dynamic)
+#endif
+      for (SignedSize k = 0; k < boost::numeric_cast<SignedSize>(transition_groups.size()); ++k)
       {
-        if (swath_maps[i].lower < transition_group->getTransitions()[0].precursor_mz &&
-            swath_maps[i].upper >= transition_group->getTransitions()[0].precursor_mz)
+        try
         {
-          used_maps.push_back(swath_maps[i]);
+          // we need at least one feature to find the best one
+          auto transition_group = transition_groups[k];
+          if (transition_group->getFeatures().size() == 0)
+          {
+            continue;
+          }
+
+          // Find the feature with the highest score
+          double bestRT = -1;
+          double highest_score = -1000;
+          for (auto mrmfeature = transition_group->getFeatures().begin(); mrmfeature != transition_group->getFeatures().end(); ++mrmfeature)
+          {
+            if (mrmfeature->getOverallQuality() > highest_score)
+            {
+              bestRT = mrmfeature->getRT();
+              highest_score = mrmfeature->getOverallQuality();
+            }
+          }
+
+          // Get the corresponding SWATH map(s), for SONAR there will be more than one map
+          std::vector<OpenSwath::SwathMap> used_maps;
+          for (Size i = 0; i < local_swath_maps.size(); ++i)
+          {
+            if (local_swath_maps[i].lower < transition_group->getTransitions()[0].precursor_mz &&
+                local_swath_maps[i].upper >= transition_group->getTransitions()[0].precursor_mz)
+            {
+              used_maps.push_back(local_swath_maps[i]);
+            }
+          }
+
+          if (used_maps.empty())
+          {
+            continue;
+          }
+
+          // Get the spectrum for this RT and extract raw data points for all the
+          // calibrating transitions (fragment m/z values) from the spectrum
+          OpenSwath::SpectrumPtr sp = scoring.fetchSpectrumSwath(used_maps, bestRT, 1, 0, 0);
+          for (std::vector< OpenMS::MRMFeatureFinderScoring::TransitionType >::const_iterator
+              tr = transition_group->getTransitions().begin();
+              tr != transition_group->getTransitions().end(); ++tr)
+          {
+            double mz, intensity;
+            double left = tr->product_mz - mz_extr_window / 2.0;
+            double right = tr->product_mz + mz_extr_window / 2.0;
+            bool centroided = false;
+
+            if (ppm)
+            {
+              left = tr->product_mz - mz_extr_window / 2.0  * tr->product_mz * 1e-6;
+              right = tr->product_mz + mz_extr_window / 2.0 * tr->product_mz * 1e-6;
+            }
+
+            // integrate spectrum at the position of the theoretical mass
+            OpenSwath::integrateWindow(sp, left, right, mz, intensity, centroided);
+
+            // skip empty windows
+            if (mz == -1)
+            {
+              continue;
+            }
+
+            CalibrationPoint_ point = {mz, tr->product_mz, intensity, bestRT};
+            group_points[k].push_back(point);
+          }
         }
-      }
-
-      if (used_maps.empty())
-      {
-        continue;
-      }
-
-      // Get the spectrum for this RT and extract raw data points for all the
-      // calibrating transitions (fragment m/z values) from the spectrum
-      OpenSwath::SpectrumPtr sp = OpenSwathScoring().fetchSpectrumSwath(used_maps, bestRT, 1, 0, 0);
-      for (std::vector< OpenMS::MRMFeatureFinderScoring::TransitionType >::const_iterator
-          tr = transition_group->getTransitions().begin();
-          tr != transition_group->getTransitions().end(); ++tr)
-      {
-        double mz, intensity;
-        double left = tr->product_mz - mz_extr_window / 2.0;
-        double right = tr->product_mz + mz_extr_window / 2.0;
-        bool centroided = false;
-
-        if (ppm)
+        catch (...)
         {
-          left = tr->product_mz - mz_extr_window / 2.0  * tr->product_mz * 1e-6;
-          right = tr->product_mz + mz_extr_window / 2.0 * tr->product_mz * 1e-6;
+#ifdef _OPENMP
+#pragma omp critical (SwathMapMassCorrection_error)
+#endif
+          {
+            if (err_count++ == 0) err = std::current_exception();
+          }
         }
+      }
+    }
+    if (err_count > 0)
+    {
+      std::rethrow_exception(err);
+    }
 
-        // integrate spectrum at the position of the theoretical mass
-        OpenSwath::integrateWindow(sp, left, right, mz, intensity, centroided);
-
-        // skip empty windows
-        if (mz == -1)
-        {
-          continue;
-        }
+    TransformationDescription::DataPoints data_all;
+    std::vector<double> weights;
+    std::vector<double> exp_mz;
+    std::vector<double> theo_mz;
+    std::vector<double> delta_ppm;
+    for (Size k = 0; k < group_points.size(); ++k)
+    {
+      for (Size j = 0; j < group_points[k].size(); ++j)
+      {
+        const double mz = group_points[k][j].mz;
+        const double product_mz = group_points[k][j].theo_mz;
+        const double intensity = group_points[k][j].intensity;
 
         // store result masses
 
-        data_all.push_back(std::make_pair(mz, tr->product_mz));
+        data_all.push_back(std::make_pair(mz, product_mz));
         // regression weight is the log2 intensity
         weights.push_back( log(intensity) / log(2.0) );
         exp_mz.push_back( mz );
         // y = target = theoretical
-        theo_mz.push_back( tr->product_mz );
-        double diff_ppm = (mz - tr->product_mz) * 1000000 / mz;
+        theo_mz.push_back( product_mz );
+        double diff_ppm = (mz - product_mz) * 1000000 / mz;
         // y = target = delta-ppm
         delta_ppm.push_back(diff_ppm);
 
 #ifdef SWATHMAPMASSCORRECTION_DEBUG
-        os << mz << "\t" << tr->product_mz << "\t" << diff_ppm << "\t" << log(intensity) / log(2.0) << "\t" << bestRT << std::endl;
+        os << mz << "\t" << product_mz << "\t" << diff_ppm << "\t" << log(intensity) / log(2.0) << "\t" << group_points[k][j].rt << std::endl;
 #endif
-        LOG_DEBUG << mz << "\t" << tr->product_mz << "\t" << diff_ppm << "\t" << log(intensity) / log(2.0) << "\t" << bestRT << std::endl;
-
+        LOG_DEBUG << mz << "\t" << product_mz << "\t" << diff_ppm << "\t" << log(intensity) / log(2.0) << "\t" << group_points[k][j].rt << std::endl;
       }
     }
 
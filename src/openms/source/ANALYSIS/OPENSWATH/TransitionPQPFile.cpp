@@ -57,23 +57,12 @@ namespace OpenMS
     return(0);
   }
 
-  void TransitionPQPFile::readPQPInput_(const char* filename, std::vector<TSVTransition>& transition_list, bool legacy_traml_id)
+  int TransitionPQPFile::openPQP_(const char* filename, sqlite3*& db)
   {
-    sqlite3 *db;
     sqlite3_stmt * cntstmt;
-    sqlite3_stmt * stmt;
-    int rc;
-    std::string select_sql;
-
-    // Use legacy TraML identifiers for precursors (transition_group_id) and transitions (transition_name)?
-    std::string traml_id = "ID";
-    if (legacy_traml_id)
-    {
-      traml_id = "TRAML_ID";
-    }
 
     // Open database
-    rc = sqlite3_open(filename, &db);
+    int rc = sqlite3_open(filename, &db);
     if ( rc )
     {
       fprintf(stderr, "Can't open database: %s\n", sqlite3_errmsg(db));
@@ -84,6 +73,19 @@ namespace OpenMS
     sqlite3_step( cntstmt );
     int num_transitions = sqlite3_column_int( cntstmt, 0 );
     sqlite3_finalize(cntstmt);
+    return num_transitions;
+  }
+
+  std::string TransitionPQPFile::getPQPSelectStatement_(bool legacy_traml_id)
+  {
+    std::string select_sql;
+
+    // Use legacy TraML identifiers for precursors (transition_group_id) and transitions (transition_name)?
+    std::string traml_id = "ID";
+    if (legacy_traml_id)
+    {
+      traml_id = "TRAML_ID";
+    }
 
     // Get peptides
     select_sql = "SELECT " \
@@ -161,7 +163,134 @@ namespace OpenMS
                   "INNER JOIN PRECURSOR_COMPOUND_MAPPING ON PRECURSOR.ID = PRECURSOR_COMPOUND_MAPPING.PRECURSOR_ID " \
                   "INNER JOIN COMPOUND ON PRECURSOR_COMPOUND_MAPPING.COMPOUND_ID = COMPOUND.ID; ";
 
+    return select_sql;
+  }
+
+  void TransitionPQPFile::readPQPRow_(sqlite3_stmt* stmt, TSVTransition& transition)
+  {
+
+    if (sqlite3_column_type( stmt, 0 ) != SQLITE_NULL)
+    {
+      transition.precursor = sqlite3_column_double( stmt, 0 );
+    }
+    if (sqlite3_column_type( stmt, 1 ) != SQLITE_NULL)
+    {
+      transition.product = sqlite3_column_double( stmt, 1 );
+    }
+    if (sqlite3_column_type( stmt, 2 ) != SQLITE_NULL)
+    {
+      transition.rt_calibrated = sqlite3_column_double( stmt, 2 );
+    }
+    if (sqlite3_column_type( stmt, 3 ) != SQLITE_NULL)
+    {
+      transition.transition_name = std::string(reinterpret_cast<const char*>(sqlite3_column_text( stmt, 3 )));
+    }
+    if (sqlite3_column_type( stmt, 4 ) != SQLITE_NULL)
+    {
+      transition.CE = sqlite3_column_double( stmt, 4 );
+    }
+    if (sqlite3_column_type( stmt, 5 ) != SQLITE_NULL)
+    {
+      transition.library_intensity = sqlite3_column_double( stmt, 5 );
+    }
+    if (sqlite3_column_type( stmt, 6 ) != SQLITE_NULL)
+    {
+      transition.group_id = std::string(reinterpret_cast<const char*>(sqlite3_column_text( stmt, 6 )));
+    }
+    if (sqlite3_column_type( stmt, 7 ) != SQLITE_NULL)
+    {
+      transition.decoy = sqlite3_column_int( stmt, 7 );
+    }
+    if (sqlite3_column_type( stmt, 8 ) != SQLITE_NULL)
+    {
+      transition.PeptideSequence = std::string(reinterpret_cast<const char*>(sqlite3_column_text( stmt, 8 )));
+    }
+    if (sqlite3_column_type( stmt, 9 ) != SQLITE_NULL)
+    {
+      transition.ProteinName = std::string(reinterpret_cast<const char*>(sqlite3_column_text( stmt, 9 )));
+    }
+    if (sqlite3_column_type( stmt, 10 ) != SQLITE_NULL)
+    {
+      transition.Annotation = std::string(reinterpret_cast<const char*>(sqlite3_column_text( stmt, 10 )));
+    }
+    if (sqlite3_column_type( stmt, 11 ) != SQLITE_NULL)
+    {
+      transition.FullPeptideName = std::string(reinterpret_cast<const char*>(sqlite3_column_text( stmt, 11 )));
+    }
+    if (sqlite3_column_type( stmt, 12 ) != SQLITE_NULL)
+    {
+      transition.CompoundName = std::string(reinterpret_cast<const char*>(sqlite3_column_text( stmt, 12 )));
+    }
+    if (sqlite3_column_type( stmt, 13 ) != SQLITE_NULL)
+    {
+      transition.SMILES = std::string(reinterpret_cast<const char*>(sqlite3_column_text( stmt, 13 )));
+    }
+    if (sqlite3_column_type( stmt, 14 ) != SQLITE_NULL)
+    {
+      transition.SumFormula = std::string(reinterpret_cast<const char*>(sqlite3_column_text( stmt, 14 )));
+    }
+    if (sqlite3_column_type( stmt, 15 ) != SQLITE_NULL)
+    {
+      transition.precursor_charge = sqlite3_column_int( stmt, 15 );
+    }
+    if (sqlite3_column_type( stmt, 16 ) != SQLITE_NULL)
+    {
+      transition.peptide_group_label = std::string(reinterpret_cast<const char*>(sqlite3_column_text( stmt, 16 )));
+    }
+    if (sqlite3_column_type( stmt, 17 ) != SQLITE_NULL)
+    {
+      transition.label_type = std::string(reinterpret_cast<const char*>(sqlite3_column_text( stmt, 17 )));
+    }
+    if (sqlite3_column_type( stmt, 18 ) != SQLITE_NULL)
+    {
+      transition.fragment_charge = sqlite3_column_int( stmt, 18 );
+    }
+    if (sqlite3_column_type( stmt, 19 ) != SQLITE_NULL)
+    {
+      transition.fragment_nr = sqlite3_column_int( stmt, 19 );
+    }
+    if (sqlite3_column_type( stmt, 20 ) != SQLITE_NULL)
+    {
+      transition.fragment_mzdelta = sqlite3_column_double( stmt, 20 );
+    }
+    if (sqlite3_column_type( stmt, 21 ) != SQLITE_NULL)
+    {
+      transition.fragment_modification = sqlite3_column_int( stmt, 21 );
+    }
+    if (sqlite3_column_type( stmt, 22 ) != SQLITE_NULL)
+    {
+      transition.fragment_type = std::string(reinterpret_cast<const char*>(sqlite3_column_text( stmt, 22 )));
+    }
+    if (sqlite3_column_type( stmt, 23 ) != SQLITE_NULL)
+    {
+      transition.uniprot_id = std::string(reinterpret_cast<const char*>(sqlite3_column_text( stmt, 23 )));
+    }
+    if (sqlite3_column_type( stmt, 24 ) != SQLITE_NULL)
+    {
+      transition.detecting_transition = sqlite3_column_int( stmt, 24 );
+    }
+    if (sqlite3_column_type( stmt, 25 ) != SQLITE_NULL)
+    {
+      transition.identifying_transition = sqlite3_column_int( stmt, 25 );
+    }
+    if (sqlite3_column_type( stmt, 26 ) != SQLITE_NULL)
+    {
+      transition.quantifying_transition = sqlite3_column_int( stmt, 26 );
+    }
+    if (sqlite3_column_type( stmt, 27 ) != SQLITE_NULL)
+    {
+      String(reinterpret_cast<const char*>(sqlite3_column_text( stmt, 27 ))).split('|', transition.peptidoforms);
+    }
+  }
+
+  void TransitionPQPFile::readPQPInput_(const char* filename, std::vector<TSVTransition>& transition_list, bool legacy_traml_id)
+  {
+    sqlite3 *db;
+    sqlite3_stmt * stmt;
+    int num_transitions = openPQP_(filename, db);
+
     // Execute SQL select statement
+    std::string select_sql = getPQPSelectStatement_(legacy_traml_id);
     sqlite3_prepare_v2(db, select_sql.c_str(), -1, &stmt, nullptr);
     sqlite3_step( stmt );
 
@@ -172,120 +301,7 @@ namespace OpenMS
     {
       setProgress(progress++);
       TSVTransition mytransition;
-
-      if (sqlite3_column_type( stmt, 0 ) != SQLITE_NULL)
-      {
-        mytransition.precursor = sqlite3_column_double( stmt, 0 );
-      }
-      if (sqlite3_column_type( stmt, 1 ) != SQLITE_NULL)
-      {
-        mytransition.product = sqlite3_column_double( stmt, 1 );
-      }
-      if (sqlite3_column_type( stmt, 2 ) != SQLITE_NULL)
-      {
-        mytransition.rt_calibrated = sqlite3_column_double( stmt, 2 );
-      }
-      if (sqlite3_column_type( stmt, 3 ) != SQLITE_NULL)
-      {
-        mytransition.transition_name = std::string(reinterpret_cast<const char*>(sqlite3_column_text( stmt, 3 )));
-      }
-      if (sqlite3_column_type( stmt, 4 ) != SQLITE_NULL)
-      {
-        mytransition.CE = sqlite3_column_double( stmt, 4 );
-      }
-      if (sqlite3_column_type( stmt, 5 ) != SQLITE_NULL)
-      {
-        mytransition.library_intensity = sqlite3_column_double( stmt, 5 );
-      }
-      if (sqlite3_column_type( stmt, 6 ) != SQLITE_NULL)
-      {
-        mytransition.group_id = std::string(reinterpret_cast<const char*>(sqlite3_column_text( stmt, 6 )));
-      }
-      if (sqlite3_column_type( stmt, 7 ) != SQLITE_NULL)
-      {
-        mytransition.decoy = sqlite3_column_int( stmt, 7 );
-      }
-      if (sqlite3_column_type( stmt, 8 ) != SQLITE_NULL)
-      {
-        mytransition.PeptideSequence = std::string(reinterpret_cast<const char*>(sqlite3_column_text( stmt, 8 )));
-      }
-      if (sqlite3_column_type( stmt, 9 ) != SQLITE_NULL)
-      {
-        mytransition.ProteinName = std::string(reinterpret_cast<const char*>(sqlite3_column_text( stmt, 9 )));
-      }
-      if (sqlite3_column_type( stmt, 10 ) != SQLITE_NULL)
-      {
-        mytransition.Annotation = std::string(reinterpret_cast<const char*>(sqlite3_column_text( stmt, 10 )));
-      }
-      if (sqlite3_column_type( stmt, 11 ) != SQLITE_NULL)
-      {
-        mytransition.FullPeptideName = std::string(reinterpret_cast<const char*>(sqlite3_column_text( stmt, 11 )));
-      }
-      if (sqlite3_column_type( stmt, 12 ) != SQLITE_NULL)
-      {
-        mytransition.CompoundName = std::string(reinterpret_cast<const char*>(sqlite3_column_text( stmt, 12 )));
-      }
-      if (sqlite3_column_type( stmt, 13 ) != SQLITE_NULL)
-      {
-        mytransition.SMILES = std::string(reinterpret_cast<const char*>(sqlite3_column_text( stmt, 13 )));
-      }
-      if (sqlite3_column_type( stmt, 14 ) != SQLITE_NULL)
-      {
-        mytransition.SumFormula = std::string(reinterpret_cast<const char*>(sqlite3_column_text( stmt, 14 )));
-      }
-      if (sqlite3_column_type( stmt, 15 ) != SQLITE_NULL)
-      {
-        mytransition.precursor_charge = sqlite3_column_int( stmt, 15 );
-      }
-      if (sqlite3_column_type( stmt, 16 ) != SQLITE_NULL)
-      {
-        mytransition.peptide_group_label = std::string(reinterpret_cast<const char*>(sqlite3_column_text( stmt, 16 )));
-      }
-      if (sqlite3_column_type( stmt, 17 ) != SQLITE_NULL)
-      {
-        mytransition.label_type = std::string(reinterpret_cast<const char*>(sqlite3_column_text( stmt, 17 )));
-      }
-      if (sqlite3_column_type( stmt, 18 ) != SQLITE_NULL)
-      {
-        mytransition.fragment_charge = sqlite3_column_int( stmt, 18 );
-      }
-      if (sqlite3_column_type( stmt, 19 ) != SQLITE_NULL)
-      {
-        mytransition.fragment_nr = sqlite3_column_int( stmt, 19 );
-      }
-      if (sqlite3_column_type( stmt, 20 ) != SQLITE_NULL)
-      {
-        mytransition.fragment_mzdelta = sqlite3_column_double( stmt, 20 );
-      }
-      if (sqlite3_column_type( stmt, 21 ) != SQLITE_NULL)
-      {
-        mytransition.fragment_modification = sqlite3_column_int( stmt, 21 );
-      }
-      if (sqlite3_column_type( stmt, 22 ) != SQLITE_NULL)
-      {
-        mytransition.fragment_type = std::string(reinterpret_cast<const char*>(sqlite3_column_text( stmt, 22 )));
-      }
-      if (sqlite3_column_type( stmt, 23 ) != SQLITE_NULL)
-      {
-        mytransition.uniprot_id = std::string(reinterpret_cast<const char*>(sqlite3_column_text( stmt, 23 )));
-      }
-      if (sqlite3_column_type( stmt, 24 ) != SQLITE_NULL)
-      {
-        mytransition.detecting_transition = sqlite3_column_int( stmt, 24 );
-      }
-      if (sqlite3_column_type( stmt, 25 ) != SQLITE_NULL)
-      {
-        mytransition.identifying_transition = sqlite3_column_int( stmt, 25 );
-      }
-      if (sqlite3_column_type( stmt, 26 ) != SQLITE_NULL)
-      {
-        mytransition.quantifying_transition = sqlite3_column_int( stmt, 26 );
-      }
-      if (sqlite3_column_type( stmt, 27 ) != SQLITE_NULL)
-      {
-        String(reinterpret_cast<const char*>(sqlite3_column_text( stmt, 27 ))).split('|', mytransition.peptidoforms);;
-      }
-
+      readPQPRow_(stmt, mytransition);
       transition_list.push_back(mytransition);
       sqlite3_step( stmt );
     }
@@ -722,9 +738,58 @@ namespace OpenMS
 
   void TransitionPQPFile::convertPQPToTargetedExperiment(const char* filename, OpenSwath::LightTargetedExperiment& targeted_exp, bool legacy_traml_id)
   {
-    std::vector<TSVTransition> transition_list;
-    readPQPInput_(filename, transition_list, legacy_traml_id);
-    TSVToTargetedExperiment_(transition_list, targeted_exp);
+    convertPQPToTargetedExperiment(filename, targeted_exp, legacy_traml_id, std::vector<std::pair<double, double> >());
+  }
+
+  void TransitionPQPFile::convertPQPToTargetedExperiment(const char* filename, OpenSwath::LightTargetedExperiment& targeted_exp, bool legacy_traml_id,
+                                                         const std::vector<std::pair<double, double> >& precursor_ranges)
+  {
+    sqlite3 *db;
+    sqlite3_stmt * stmt;
+    int num_transitions = openPQP_(filename, db);
+
+    std::string select_sql = getPQPSelectStatement_(legacy_traml_id);
+    sqlite3_prepare_v2(db, select_sql.c_str(), -1, &stmt, nullptr);
+    sqlite3_step( stmt );
+
+    std::map<String, int> compound_map;
+    std::map<String, int> protein_map;
+    // first peptide sequence seen for each peptide label group
+    std::map<String, String> label_sequence_map;
+
+    // the rows are converted one at a time, no intermediate list of all TSVTransitions is kept
+    std::vector<TSVTransition> current(1);
+    Size progress = 0;
+    startProgress(0, num_transitions, "reading PQP file");
+    while (sqlite3_column_type( stmt, 0 ) != SQLITE_NULL)
+    {
+      setProgress(progress++);
+      TSVTransition& mytransition = current[0];
+      mytransition = TSVTransition();
+      readPQPRow_(stmt, mytransition);
+      sqlite3_step( stmt );
+
+      if (!precursor_ranges.empty())
+      {
+        bool in_range = false;
+        for (const auto& range : precursor_ranges)
+        {
+          if (mytransition.precursor >= range.first && mytransition.precursor < range.second)
+          {
+            in_range = true;
+            break;
+          }
+        }
+        if (!in_range) continue;
+      }
+
+      resolveMixedSequenceGroup_(mytransition, label_sequence_map);
+      addLightTransition_(current.cbegin(), targeted_exp, compound_map, protein_map);
+    }
+    endProgress();
+
+    sqlite3_finalize(stmt);
+    sqlite3_close(db);
   }
 
 }
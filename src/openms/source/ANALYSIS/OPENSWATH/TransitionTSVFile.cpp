@@ -39,10 +39,37 @@
 #include <OpenMS/CHEMISTRY/ResidueDB.h>
 #include <OpenMS/CONCEPT/LogStream.h>
 #include <OpenMS/FORMAT/TextFile.h>
+#include <OpenMS/FORMAT/TraMLFile.h>
 
 namespace OpenMS
 {
 
+  /**
+    @brief Splits @p line at every @p delimiter into @p fields
+
+    An empty last column is kept (i.e. there is always one field more than
+    there are delimiters). The strings in @p fields are re-used to avoid
+    allocations when splitting many lines.
+  */
+  static void splitLine_(const std::string& line, char delimiter, std::vector<std::string>& fields)
+  {
+    Size n = 0;
+    std::string::size_type start = 0;
+    while (true)
+    {
+      std::string::size_type end = line.find(delimiter, start);
+      if (n == fields.size()) fields.emplace_back();
+      if (end == std::string::npos)
+      {
+        fields[n++].assign(line, start, std::string::npos);
+        break;
+      }
+      fields[n++].assign(line, start, end - start);
+      start = end + 1;
+    }
+    fields.resize(n);
+  }
+
   template<class T>   // primary template
   bool extractName(T& value, const std::string& header_name,
                    const std::vector<std::string>& tmp_line,
@@ -67,9 +94,9 @@ namespace OpenMS
                         const std::map<std::string, int>& header_dict)
   {
     auto tmp = header_dict.find( header_name );
-    if (tmp != header_dict.end() && !String(tmp_line[ tmp->second ]).empty())
+    if (tmp != header_dict.end() && !tmp_line[ tmp->second ].empty())
     {
-      value = String(tmp_line[ tmp->second ]).toInt();
+      value = StringView(tmp_line[ tmp->second ]).toInt();
       return true;
     }
     return false;
@@ -81,9 +108,9 @@ namespace OpenMS
                         const std::map<std::string, int>& header_dict)
   {
     auto tmp = header_dict.find(header_name);
-    if (tmp != header_dict.end() && !String(tmp_line[ tmp->second ]).empty())
+    if (tmp != header_dict.end() && !tmp_line[ tmp->second ].empty())
     {
-      value = String(tmp_line[ tmp->second ]).toDouble();
+      value = StringView(tmp_line[ tmp->second ]).toDouble();
       return true;
     }
     return false;
@@ -95,7 +122,7 @@ namespace OpenMS
                         const std::map<std::string, int>& header_dict)
   {
     auto tmp = header_dict.find( header_name );
-    if (tmp != header_dict.end() && !String(tmp_line[ tmp->second ]).empty())
+    if (tmp != header_dict.end() && !tmp_line[ tmp->second ].empty())
     {
       auto str_value = tmp_line[ tmp->second ];
       if (str_value == "1" || str_value == "TRUE") value = true;
@@ -217,7 +244,6 @@ namespace OpenMS
   {
     std::ifstream data(filename);
     std::string   line;
-    std::string   tmp;
 
     // read header
     std::vector<std::string>   tmp_line;
@@ -254,13 +280,7 @@ namespace OpenMS
     int cnt = 0;
     while (TextFile::getLine(data, line)) // make sure line endings are handled correctly
     {
-      line.push_back(delimiter); // avoid losing last column if it is empty
-      std::stringstream lineStream(line);
-
-      while (std::getline(lineStream, tmp, delimiter)) // default getline is fine here, we only want to split the line
-      {
-        tmp_line.push_back(tmp);
-      }
+      splitLine_(line, delimiter, tmp_line);
       cnt++;
 
 #ifdef TRANSITIONTSVREADER_TESTING
@@ -287,7 +307,7 @@ namespace OpenMS
 
       //// Required columns (they are guaranteed to be present, see getTSVHeader_)
       // PrecursorMz
-      mytransition.precursor = String(tmp_line[header_dict["PrecursorMz"]]).toDouble();
+      mytransition.precursor = StringView(tmp_line[header_dict["PrecursorMz"]]).toDouble();
 
       // ProductMz
       if (!extractName<double>(mytransition.product, "ProductMz", tmp_line, header_dict) &&
@@ -464,7 +484,6 @@ namespace OpenMS
       std::cout << mytransition.uniprot_id << std::endl;
 #endif
 
-      tmp_line.clear();
     }
 
     if (spectrast_legacy && retentionTimeInterpretation_ == "iRT")
@@ -656,107 +675,107 @@ namespace OpenMS
     startProgress(0, transition_list.size(), "conversion to internal data representation");
     for (auto tr_it = transition_list.cbegin(); tr_it != transition_list.cend(); ++tr_it)
     {
-      OpenSwath::LightTransition transition;
-      transition.transition_name  = tr_it->transition_name;
-      transition.peptide_ref  = tr_it->group_id;
-      transition.library_intensity  = tr_it->library_intensity;
-      transition.precursor_mz  = tr_it->precursor;
-      transition.product_mz  = tr_it->product;
-      transition.fragment_charge = 0; // use zero for charge that is not set
-      if (!tr_it->fragment_charge.empty() && tr_it->fragment_charge != "NA")
-      {
-        transition.fragment_charge = tr_it->fragment_charge.toInt();
-      }
+      addLightTransition_(tr_it, exp, compound_map, protein_map);
+      setProgress(progress++);
+    }
+    endProgress();
+  }
+
+  void TransitionTSVFile::addLightTransition_(std::vector<TSVTransition>::const_iterator tr_it,
+                                              OpenSwath::LightTargetedExperiment& exp,
+                                              std::map<String, int>& compound_map,
+                                              std::map<String, int>& protein_map)
+  {
+    OpenSwath::LightTransition transition;
+    transition.transition_name  = tr_it->transition_name;
+    transition.peptide_ref  = tr_it->group_id;
+    transition.library_intensity  = tr_it->library_intensity;
+    transition.precursor_mz  = tr_it->precursor;
+    transition.product_mz  = tr_it->product;
+    transition.fragment_charge = 0; // use zero for charge that is not set
+    if (!tr_it->fragment_charge.empty() && tr_it->fragment_charge != "NA")
+    {
+      transition.fragment_charge = tr_it->fragment_charge.toInt();
+    }
 
-      transition.decoy = tr_it->decoy;
-      transition.detecting_transition = tr_it->detecting_transition;
-      transition.identifying_transition = tr_it->identifying_transition;
-      transition.quantifying_transition = tr_it->quantifying_transition;
+    transition.decoy = tr_it->decoy;
+    transition.detecting_transition = tr_it->detecting_transition;
+    transition.identifying_transition = tr_it->identifying_transition;
+    transition.quantifying_transition = tr_it->quantifying_transition;
 
-      exp.transitions.push_back(transition);
+    exp.transitions.push_back(transition);
 
-      // check whether we need a new compound
-      if (compound_map.find(tr_it->group_id) == compound_map.end())
+    // check whether we need a new compound
+    if (compound_map.find(tr_it->group_id) == compound_map.end())
+    {
+      OpenSwath::LightCompound compound;
+      if (tr_it->isPeptide())
       {
-        OpenSwath::LightCompound compound;
-        if (tr_it->isPeptide())
-        {
-          OpenMS::TargetedExperiment::Peptide tramlpeptide;
-          createPeptide_(tr_it, tramlpeptide);
-          OpenSwathDataAccessHelper::convertTargetedCompound(tramlpeptide, compound);
-        }
-        else
-        {
-          OpenMS::TargetedExperiment::Compound tramlcompound;
-          createCompound_(tr_it, tramlcompound);
-          OpenSwathDataAccessHelper::convertTargetedCompound(tramlcompound, compound);
-        }
-        exp.compounds.push_back(compound);
-        compound_map[compound.id] = 0;
+        OpenMS::TargetedExperiment::Peptide tramlpeptide;
+        createPeptide_(tr_it, tramlpeptide);
+        OpenSwathDataAccessHelper::convertTargetedCompound(tramlpeptide, compound);
       }
-
-      // check whether we need a new protein
-      if (tr_it->isPeptide() && protein_map.find(tr_it->ProteinName) == protein_map.end())
+      else
       {
-        OpenSwath::LightProtein protein;
-        protein.id = tr_it->ProteinName;
-        protein.sequence = "";
-        exp.proteins.push_back(protein);
-        protein_map[tr_it->ProteinName] = 0;
+        OpenMS::TargetedExperiment::Compound tramlcompound;
+        createCompound_(tr_it, tramlcompound);
+        OpenSwathDataAccessHelper::convertTargetedCompound(tramlcompound, compound);
       }
-      setProgress(progress++);
+      exp.compounds.push_back(compound);
+      compound_map[compound.id] = 0;
+    }
+
+    // check whether we need a new protein
+    if (tr_it->isPeptide() && protein_map.find(tr_it->ProteinName) == protein_map.end())
+    {
+      OpenSwath::LightProtein protein;
+      protein.id = tr_it->ProteinName;
+      protein.sequence = "";
+      exp.proteins.push_back(protein);
+      protein_map[tr_it->ProteinName] = 0;
     }
-    endProgress();
   }
 
   void TransitionTSVFile::resolveMixedSequenceGroups_(std::vector<TransitionTSVFile::TSVTransition>& transition_list)
   {
-    // Create temporary map by group label
-    std::map< String, std::vector<TSVTransition*> > label_transition_map;
+    // first peptide sequence seen for each peptide label group
+    std::map<String, String> label_sequence_map;
     for (std::vector<TSVTransition>::iterator tr_it = transition_list.begin(); tr_it != transition_list.end(); ++tr_it)
     {
-      if (!tr_it->peptide_group_label.empty() )
-      {
-        label_transition_map[tr_it->peptide_group_label].push_back(& (*tr_it));
-      }
+      resolveMixedSequenceGroup_(*tr_it, label_sequence_map);
     }
+  }
 
-    // Iterate through all the group labels and perform sanity check whether the peptide sequence is the same for all of them
-    for (std::map< String, std::vector<TSVTransition*> >::iterator pep_it = label_transition_map.begin(); pep_it != label_transition_map.end(); ++pep_it)
+  void TransitionTSVFile::resolveMixedSequenceGroup_(TSVTransition& transition, std::map<String, String>& label_sequence_map)
+  {
+    if (transition.peptide_group_label.empty()) return;
+
+    auto label_it = label_sequence_map.find(transition.peptide_group_label);
+    if (label_it == label_sequence_map.end())
     {
-      String curr_sequence;
-      if (!pep_it->second.empty() )
-      { 
-        curr_sequence = (*pep_it->second.begin())->PeptideSequence;
-      }
+      label_sequence_map[transition.peptide_group_label] = transition.PeptideSequence;
+      return;
+    }
 
-      for (std::vector<TSVTransition*>::iterator tr_it = pep_it->second.begin(); tr_it != pep_it->second.end(); ++tr_it)
+    // Sanity check: different peptide sequence in the same peptide label group means that something is probably wrong ...
+    const String& curr_sequence = label_it->second;
+    if (!curr_sequence.empty() && transition.PeptideSequence != curr_sequence)
+    {
+      if (override_group_label_check_)
       {
-        // Sanity check: different peptide sequence in the same peptide label group means that something is probably wrong ...
-        if (!curr_sequence.empty() && (*tr_it)->PeptideSequence != curr_sequence)
-        {
-
-          if (override_group_label_check_)
-          {
-            // We wont fix it but give out a warning
-            LOG_WARN << "Warning: Found multiple peptide sequences for peptide label group " << pep_it->first << 
-              //" found multiple peptide sequences: " << curr_sequence << " and " << (*tr_it)->PeptideSequence << 
-              ". Since 'override_group_label_check' is on, nothing will be changed." << std::endl;
-          }
-          else
-          {
-            // Lets fix it and inform the user
-            LOG_WARN << "Warning: Found multiple peptide sequences for peptide label group " << pep_it->first << 
-              //" found multiple peptide sequences: " << curr_sequence << " and " << (*tr_it)->PeptideSequence << 
-              ". This is most likely an error and to fix this, a new peptide label group will be inferred - " << 
-              "to override this decision, please use the override_group_label_check parameter." << std::endl;
-            (*tr_it)->peptide_group_label = (*tr_it)->group_id;
-          }
-
-        }
+        // We wont fix it but give out a warning
+        LOG_WARN << "Warning: Found multiple peptide sequences for peptide label group " << label_it->first << 
+          ". Since 'override_group_label_check' is on, nothing will be changed." << std::endl;
+      }
+      else
+      {
+        // Lets fix it and inform the user
+        LOG_WARN << "Warning: Found multiple peptide sequences for peptide label group " << label_it->first << 
+          ". This is most likely an error and to fix this, a new peptide label group will be inferred - " << 
+          "to override this decision, please use the override_group_label_check parameter." << std::endl;
+        transition.peptide_group_label = transition.group_id;
       }
     }
-
   }
 
   void TransitionTSVFile::createTransition_(std::vector<TSVTransition>::iterator& tr_it, OpenMS::ReactionMonitoringTransition& rm_trans)
@@ -1366,23 +1385,8 @@ namespace OpenMS
     return(mytransition);
   }
 
-  void TransitionTSVFile::writeTSVOutput_(const char* filename, OpenMS::TargetedExperiment& targeted_exp)
+  void TransitionTSVFile::writeTSVHeader_(std::ostream& os) const
   {
-    std::vector<TSVTransition> mytransitions;
-
-    Size progress = 0;
-    startProgress(0, targeted_exp.getTransitions().size(), "writing OpenSWATH Transition List TSV file");
-    for (Size i = 0; i < targeted_exp.getTransitions().size(); i++)
-    {
-      TransitionTSVFile::TSVTransition mytransition = convertTransition_(&targeted_exp.getTransitions()[i],targeted_exp);
-      mytransitions.push_back(mytransition);
-      setProgress(progress++);
-    }
-    endProgress();
-
-    // start writing
-    std::ofstream os(filename);
-    os.precision(writtenDigits(double()));
     for (Size i = 0; i < header_names_.size(); i++)
     {
       os << header_names_[i];
@@ -1392,43 +1396,59 @@ namespace OpenMS
       }
     }
     os << std::endl;
+  }
 
-    for (std::vector<TSVTransition>::iterator it = mytransitions.begin(); it != mytransitions.end(); ++it)
-    {
-
-      String line;
-      line +=
-        (String)it->precursor                + "\t"
-        + (String)it->product                  + "\t"
-        + (String)it->precursor_charge         + "\t"
-        + (String)it->fragment_charge          + "\t"
-        + (String)it->library_intensity        + "\t"
-        + (String)it->rt_calibrated            + "\t"
-        + (String)it->PeptideSequence          + "\t"
-        + (String)it->FullPeptideName          + "\t"
-        + (String)it->peptide_group_label      + "\t"
-        + (String)it->label_type               + "\t"
-        + (String)it->CompoundName             + "\t"
-        + (String)it->SumFormula               + "\t"
-        + (String)it->SMILES                   + "\t"
-        + (String)it->ProteinName              + "\t"
-        + (String)it->uniprot_id               + "\t"
-        + (String)it->fragment_type            + "\t"
-        + (String)it->fragment_nr              + "\t"
-        + (String)it->Annotation               + "\t"
-        + (String)it->CE                       + "\t"
-        + (String)it->drift_time               + "\t"
-        + (String)it->group_id                 + "\t"
-        + (String)it->transition_name          + "\t"
-        + (String)it->decoy                    + "\t"
-        + (String)it->detecting_transition     + "\t"
-        + (String)it->identifying_transition   + "\t"
-        + (String)it->quantifying_transition   + "\t"
-        + ListUtils::concatenate(it->peptidoforms, "|");
-
-      os << line << std::endl;
+  void TransitionTSVFile::writeTSVLine_(std::ostream& os, const TSVTransition& transition) const
+  {
+    String line;
+    line +=
+      (String)transition.precursor                + "\t"
+      + (String)transition.product                  + "\t"
+      + (String)transition.precursor_charge         + "\t"
+      + (String)transition.fragment_charge          + "\t"
+      + (String)transition.library_intensity        + "\t"
+      + (String)transition.rt_calibrated            + "\t"
+      + (String)transition.PeptideSequence          + "\t"
+      + (String)transition.FullPeptideName          + "\t"
+      + (String)transition.peptide_group_label      + "\t"
+      + (String)transition.label_type               + "\t"
+      + (String)transition.CompoundName             + "\t"
+      + (String)transition.SumFormula               + "\t"
+      + (String)transition.SMILES                   + "\t"
+      + (String)transition.ProteinName              + "\t"
+      + (String)transition.uniprot_id               + "\t"
+      + (String)transition.fragment_type            + "\t"
+      + (String)transition.fragment_nr              + "\t"
+      + (String)transition.Annotation               + "\t"
+      + (String)transition.CE                       + "\t"
+      + (String)transition.drift_time               + "\t"
+      + (String)transition.group_id                 + "\t"
+      + (String)transition.transition_name          + "\t"
+      + (String)transition.decoy                    + "\t"
+      + (String)transition.detecting_transition     + "\t"
+      + (String)transition.identifying_transition   + "\t"
+      + (String)transition.quantifying_transition   + "\t"
+      + ListUtils::concatenate(transition.peptidoforms, "|");
+
+    os << line << std::endl;
+  }
+
+  void TransitionTSVFile::writeTSVOutput_(const char* filename, OpenMS::TargetedExperiment& targeted_exp)
+  {
+    // each transition is written as soon as it is converted, no list of all
+    // TSVTransitions is kept
+    std::ofstream os(filename);
+    os.precision(writtenDigits(double()));
+    writeTSVHeader_(os);
 
+    Size progress = 0;
+    startProgress(0, targeted_exp.getTransitions().size(), "writing OpenSWATH Transition List TSV file");
+    for (Size i = 0; i < targeted_exp.getTransitions().size(); i++)
+    {
+      writeTSVLine_(os, convertTransition_(&targeted_exp.getTransitions()[i], targeted_exp));
+      setProgress(progress++);
     }
+    endProgress();
     os.close();
   }
 
@@ -1443,6 +1463,30 @@ namespace OpenMS
     writeTSVOutput_(filename, targeted_exp);
   }
 
+  void TransitionTSVFile::convertTraMLToTSV(const String& traml_file, const char* filename)
+  {
+    std::ofstream os(filename);
+    os.precision(writtenDigits(double()));
+    writeTSVHeader_(os);
+
+    // only proteins, peptides and compounds are kept in memory, the
+    // transitions are written while the TraML file is parsed
+    OpenMS::TargetedExperiment targeted_exp;
+    TraMLFile traml;
+    traml.setLogType(getLogType());
+    traml.load(traml_file, targeted_exp, [&](const ReactionMonitoringTransition& transition)
+      {
+        if ((!transition.getPeptideRef().empty() && !targeted_exp.hasPeptide(transition.getPeptideRef())) ||
+            (!transition.getCompoundRef().empty() && !targeted_exp.hasCompound(transition.getCompoundRef())))
+        {
+          throw Exception::IllegalArgument(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION,
+              "Your input file contains invalid references, cannot process file.");
+        }
+        writeTSVLine_(os, convertTransition_(&transition, targeted_exp));
+      });
+    os.close();
+  }
+
   void TransitionTSVFile::convertTSVToTargetedExperiment(const char* filename, FileTypes::Type filetype, OpenMS::TargetedExperiment& targeted_exp)
   {
     std::vector<TSVTransition> transition_list;
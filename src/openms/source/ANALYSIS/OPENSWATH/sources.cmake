@@ -5,10 +5,13 @@ set(directory source/ANALYSIS/OPENSWATH)
 set(sources_list
   ChromatogramExtractor.cpp
   ChromatogramExtractorAlgorithm.cpp
+  CompactChromatogramList.cpp
   ConfidenceScoring.cpp
   DIAHelper.cpp
   DIAPrescoring.cpp
   DIAScoring.cpp
+  IonMobilityFrame.cpp
+  LightTargetedExperimentIndex.cpp
   MasstraceCorrelator.cpp
   MRMAssay.cpp
   MRMDecoy.cpp
@@ -20,6 +23,7 @@ set(sources_list
   MRMRTNormalizer.cpp
   MRMTransitionGroupPicker.cpp
   OpenSwathHelper.cpp
+  OpenSwathLibraryCache.cpp
   OpenSwathScores.cpp
   OpenSwathScoring.cpp
   OpenSwathTSVWriter.cpp
@@ -64,6 +64,7 @@
 #include <numeric>
 #include <boost/math/special_functions/erf.hpp>
 #include <algorithm>
+#include <exception>
 
 namespace OpenMS
 {
@@ -427,7 +428,7 @@ namespace OpenMS
     // sort from min to max concentration
     std::vector<AbsoluteQuantitationStandards::featureConcentration> component_concentrations_sorted = component_concentrations;
     std::sort(component_concentrations_sorted.begin(), component_concentrations_sorted.end(),
-      [](AbsoluteQuantitationStandards::featureConcentration lhs, AbsoluteQuantitationStandards::featureConcentration rhs)
+      [](const AbsoluteQuantitationStandards::featureConcentration& lhs, const AbsoluteQuantitationStandards::featureConcentration& rhs)
       {
         return lhs.actual_concentration < rhs.actual_concentration; //ascending order
       }
@@ -440,36 +441,39 @@ namespace OpenMS
       component_concentrations_sorted_indices.push_back(index);
     }
 
+    // extract the calibration points once, all fits below only work on subsets of them
+    CalibrationPoints_ points;
+    extractCalibrationPoints_(component_concentrations_sorted, feature_name, transformation_model_params, points);
+
     // starting parameters
     optimized_params = transformation_model_params;
 
+    std::vector<double> biases;
     // for (size_t n_iters = 0; n_iters < max_iters_; ++n_iters)
     for (size_t n_iters = 0; n_iters < component_concentrations_sorted.size(); ++n_iters)
     {
 
-      // extract out components
-      const std::vector<AbsoluteQuantitationStandards::featureConcentration> component_concentrations_sub = extractComponents_(
-        component_concentrations_sorted, component_concentrations_sorted_indices);
-
       // check if the min number of calibration points has been broken
       if (component_concentrations_sorted_indices.size() < min_points_)
       {
-        LOG_INFO << "No optimal calibration found for " << component_concentrations_sub[0].feature.getMetaValue("native_id") << " .";
+        if (!component_concentrations_sorted_indices.empty())
+        {
+          LOG_INFO << "No optimal calibration found for " << component_concentrations_sorted[component_concentrations_sorted_indices[0]].feature.getMetaValue("native_id") << " .";
+        }
         return false;  //no optimal calibration found
       }
 
       // fit the model
-      optimized_params = fitCalibration(component_concentrations_sub,
-        feature_name,
+      optimized_params = fitCalibration_(points,
+        component_concentrations_sorted_indices,
         transformation_model,
         optimized_params);
 
       // calculate the R2 and bias
-      std::vector<double> biases; // not needed (method parameters)
-      double correlation_coefficient = 0.0; // not needed (method parameters)
-      calculateBiasAndR(
-        component_concentrations_sub,
-        feature_name,
+      double correlation_coefficient = 0.0;
+      calculateBiasAndR_(
+        points,
+        component_concentrations_sorted_indices,
         transformation_model,
         optimized_params,
         biases,
@@ -486,10 +490,10 @@ namespace OpenMS
       }
       if (bias_check && correlation_coefficient > min_correlation_coefficient_)
       {
-        LOG_INFO << "Valid calibration found for " << component_concentrations_sub[0].feature.getMetaValue("native_id") << " .";
+        LOG_INFO << "Valid calibration found for " << component_concentrations_sorted[component_concentrations_sorted_indices[0]].feature.getMetaValue("native_id") << " .";
 
         // copy over the final optimized points before exiting
-        component_concentrations = component_concentrations_sub;
+        component_concentrations = extractComponents_(component_concentrations_sorted, component_concentrations_sorted_indices);
         return true;  //optimal calibration found
       }
 
@@ -498,20 +502,13 @@ namespace OpenMS
       if (outlier_detection_method_ == "iter_jackknife")
       {
         // get candidate outlier: removal of which datapoint results in best rsq?
-        pos = jackknifeOutlierCandidate_(
-          component_concentrations_sub,
-          feature_name,
-          transformation_model,
-          optimized_params);
+        pos = jackknifeOutlierCandidate_(points, component_concentrations_sorted_indices);
       }
       else if (outlier_detection_method_ == "iter_residual")
       {
         // get candidate outlier: removal of datapoint with largest residual?
-        pos = residualOutlierCandidate_(
-          component_concentrations_sub,
-          feature_name,
-          transformation_model,
-          optimized_params);
+        // (the biases of the current fit are exactly what residualOutlierCandidate_ computes)
+        pos = max_element(biases.begin(), biases.end()) - biases.begin();
       }
       else
       {
@@ -533,6 +530,148 @@ namespace OpenMS
     return false;  //no optimal calibration found
   }
 
+  void AbsoluteQuantitation::extractCalibrationPoints_(
+    const std::vector<AbsoluteQuantitationStandards::featureConcentration> & component_concentrations,
+    const String & feature_name,
+    const Param & transformation_model_params,
+    CalibrationPoints_ & points)
+  {
+    points = CalibrationPoints_();
+    TransformationModel::DataPoints data;
+    TransformationModel::DataPoint point;
+    for (size_t i = 0; i < component_concentrations.size(); ++i)
+    {
+      const AbsoluteQuantitationStandards::featureConcentration& fc = component_concentrations[i];
+      const double ratio = calculateRatio(fc.feature, fc.IS_feature, feature_name);
+      points.actual_ratios.push_back(fc.actual_concentration / fc.IS_actual_concentration);
+      points.feature_ratios.push_back(ratio);
+      points.feature_amount_ratios.push_back(ratio / fc.dilution_factor); // adjust based on the dilution factor
+
+      point.first = points.actual_ratios.back();
+      point.second = points.feature_amount_ratios.back();
+      data.push_back(point);
+    }
+
+    // the weighting only depends on the model parameters, not on the fit
+    TransformationModel tm(data, transformation_model_params);
+    tm.weightData(data);
+    for (size_t i = 0; i < data.size(); ++i)
+    {
+      points.actual_ratios_weighted.push_back(data[i].first);
+      points.feature_amount_ratios_weighted.push_back(data[i].second);
+    }
+  }
+
+  Param AbsoluteQuantitation::fitCalibration_(
+    const CalibrationPoints_ & points,
+    const std::vector<size_t> & indices,
+    const String & transformation_model,
+    const Param & transformation_model_params)
+  {
+    TransformationModel::DataPoints data;
+    TransformationModel::DataPoint point;
+    for (size_t i = 0; i < indices.size(); ++i)
+    {
+      point.first = points.actual_ratios[indices[i]];
+      point.second = points.feature_amount_ratios[indices[i]];
+      data.push_back(point);
+    }
+
+    TransformationDescription tmd(data);
+    tmd.fitModel(transformation_model, transformation_model_params);
+    return tmd.getModelParameters();
+  }
+
+  void AbsoluteQuantitation::calculateBiasAndR_(
+    const CalibrationPoints_ & points,
+    const std::vector<size_t> & indices,
+    const String & transformation_model,
+    const Param & transformation_model_params,
+    std::vector<double> & biases,
+    double & correlation_coefficient)
+  {
+    biases.clear();
+
+    // set up the inverted calibration once (applyCalibration does this for every point)
+    TransformationModel::DataPoints data;
+    TransformationDescription tmd(data);
+    tmd.fitModel(transformation_model, transformation_model_params);
+    tmd.invert();
+
+    std::vector<double> concentration_ratios_weighted, feature_amounts_ratios_weighted;
+    for (size_t i = 0; i < indices.size(); ++i)
+    {
+      double calculated_concentration_ratio = tmd.apply(points.feature_ratios[indices[i]]);
+      if (calculated_concentration_ratio < 0.0)
+      {
+        calculated_concentration_ratio = 0.0;
+      }
+      biases.push_back(calculateBias(points.actual_ratios[indices[i]], calculated_concentration_ratio));
+
+      concentration_ratios_weighted.push_back(points.actual_ratios_weighted[indices[i]]);
+      feature_amounts_ratios_weighted.push_back(points.feature_amount_ratios_weighted[indices[i]]);
+    }
+
+    // calculate the R2 (R2 = Pearson_R^2)
+    correlation_coefficient = Math::pearsonCorrelationCoefficient(
+      concentration_ratios_weighted.begin(), concentration_ratios_weighted.end(),
+      feature_amounts_ratios_weighted.begin(), feature_amounts_ratios_weighted.end()
+    );
+  }
+
+  int AbsoluteQuantitation::jackknifeOutlierCandidate_(
+    const CalibrationPoints_ & points,
+    const std::vector<size_t> & indices)
+  {
+    if (indices.size() < 2) return 0;
+
+    const std::vector<double>& x = points.actual_ratios_weighted;
+    const std::vector<double>& y = points.feature_amount_ratios_weighted;
+    const double n = indices.size();
+
+    // centered sums of all points
+    double mean_x = 0.0, mean_y = 0.0;
+    for (size_t i = 0; i < indices.size(); ++i)
+    {
+      mean_x += x[indices[i]];
+      mean_y += y[indices[i]];
+    }
+    mean_x /= n;
+    mean_y /= n;
+    double c_xx = 0.0, c_yy = 0.0, c_xy = 0.0;
+    for (size_t i = 0; i < indices.size(); ++i)
+    {
+      const double dx = x[indices[i]] - mean_x;
+      const double dy = y[indices[i]] - mean_y;
+      c_xx += dx * dx;
+      c_yy += dy * dy;
+      c_xy += dx * dy;
+    }
+
+    // Pearson's R with one point removed: downdate the means and the centered sums
+    std::vector<double> rsq_tmp;
+    for (size_t i = 0; i < indices.size(); ++i)
+    {
+      const double xi = x[indices[i]];
+      const double yi = y[indices[i]];
+      const double mean_x_i = (n * mean_x - xi) / (n - 1);
+      const double mean_y_i = (n * mean_y - yi) / (n - 1);
+      const double c_xx_i = c_xx - (xi - mean_x) * (xi - mean_x_i);
+      const double c_yy_i = c_yy - (yi - mean_y) * (yi - mean_y_i);
+      const double c_xy_i = c_xy - (xi - mean_x) * (yi - mean_y_i);
+      rsq_tmp.push_back(c_xy_i / std::sqrt(c_xx_i * c_yy_i));
+    }
+
+    // the first point within numerical precision of the best one, as the
+    // downdated sums are not bit-identical to a refit
+    const double rsq_max = *max_element(rsq_tmp.begin(), rsq_tmp.end());
+    for (size_t i = 0; i < rsq_tmp.size(); ++i)
+    {
+      if (rsq_tmp[i] >= rsq_max - 1e-12) return (int)i;
+    }
+    return max_element(rsq_tmp.begin(), rsq_tmp.end()) - rsq_tmp.begin();
+  }
+
   std::vector<AbsoluteQuantitationStandards::featureConcentration> AbsoluteQuantitation::extractComponents_(
     const std::vector<AbsoluteQuantitationStandards::featureConcentration> & component_concentrations,
     const std::vector<size_t>& component_concentrations_indices)
@@ -549,41 +688,18 @@ namespace OpenMS
   int AbsoluteQuantitation::jackknifeOutlierCandidate_(
     const std::vector<AbsoluteQuantitationStandards::featureConcentration>& component_concentrations,
     const String & feature_name,
-    const String & transformation_model,
+    const String & /* transformation_model */,
     const Param & transformation_model_params)
   {
     // Returns candidate outlier: A linear regression and rsq is calculated for
     // the data points with one removed pair. The combination resulting in
     // highest rsq is considered corresponding to the outlier candidate. The
     // corresponding iterator position is then returned.
-    std::vector<double> rsq_tmp;
-    Param optimized_params = transformation_model_params;
-
-    for (Size i = 0; i < component_concentrations.size(); i++)
-    {
-      std::vector<AbsoluteQuantitationStandards::featureConcentration> component_concentrations_tmp = component_concentrations;
-      component_concentrations_tmp.erase(component_concentrations_tmp.begin() + i);
-
-      // fit the model
-      optimized_params = fitCalibration(component_concentrations_tmp,
-        feature_name,
-        transformation_model,
-        optimized_params);
-
-      // calculate the R2 and bias
-      std::vector<double> biases;
-      double correlation_coefficient = 0.0;
-      calculateBiasAndR(
-        component_concentrations_tmp,
-        feature_name,
-        transformation_model,
-        optimized_params,
-        biases,
-        correlation_coefficient);
-
-      rsq_tmp.push_back(correlation_coefficient);
-    }
-    return max_element(rsq_tmp.begin(), rsq_tmp.end()) - rsq_tmp.begin();
+    CalibrationPoints_ points;
+    extractCalibrationPoints_(component_concentrations, feature_name, transformation_model_params, points);
+    std::vector<size_t> indices(component_concentrations.size());
+    std::iota(indices.begin(), indices.end(), 0);
+    return jackknifeOutlierCandidate_(points, indices);
   }
 
   int AbsoluteQuantitation::residualOutlierCandidate_(
@@ -595,19 +711,23 @@ namespace OpenMS
     // Returns candidate outlier: A linear regression and residuals are calculated for
     // the data points. The one with highest residual error is selected as the outlier candidate. The
     // corresponding iterator position is then returned.
+    CalibrationPoints_ points;
+    extractCalibrationPoints_(component_concentrations, feature_name, transformation_model_params, points);
+    std::vector<size_t> indices(component_concentrations.size());
+    std::iota(indices.begin(), indices.end(), 0);
 
     // fit the model
-    Param optimized_params = fitCalibration(component_concentrations,
-      feature_name,
+    Param optimized_params = fitCalibration_(points,
+      indices,
       transformation_model,
       transformation_model_params);
 
     // calculate the R2 and bias
     std::vector<double> biases;
     double correlation_coefficient = 0.0;
-    calculateBiasAndR(
-      component_concentrations,
-      feature_name,
+    calculateBiasAndR_(
+      points,
+      indices,
       transformation_model,
       optimized_params,
       biases,
@@ -620,16 +740,43 @@ namespace OpenMS
     std::map<String, std::vector<AbsoluteQuantitationStandards::featureConcentration>> & components_concentrations)
   {
     std::map<String, std::vector<AbsoluteQuantitationStandards::featureConcentration>>& cc = components_concentrations;
+    if (!quant_methods_.empty() && optimization_method_ != "iterative")
+    {
+      throw Exception::IllegalArgument(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION,
+        "Unsupported calibration curve optimization method '" + optimization_method_ + "'.");
+    }
+
+    // collect the components with standards (the components are independent of each other)
+    std::vector<std::pair<AbsoluteQuantitationMethod*, std::vector<AbsoluteQuantitationStandards::featureConcentration>*> > components;
     for (std::pair<const String, AbsoluteQuantitationMethod>& quant_method : quant_methods_)
     {
       const String& component_name = quant_method.first;
-      AbsoluteQuantitationMethod& component_aqm = quant_method.second;
-      if (cc.count(component_name) && optimization_method_ == "iterative")
+      std::map<String, std::vector<AbsoluteQuantitationStandards::featureConcentration>>::iterator cc_it = cc.find(component_name);
+      if (cc_it != cc.end())
+      {
+        components.push_back(std::make_pair(&quant_method.second, &cc_it->second));
+      }
+      else
+      {
+        LOG_DEBUG << "Warning: Standards not found for component " << component_name << ".";
+      }
+    }
+
+    Size err_count = 0;
+    std::exception_ptr first_error;
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic, 1)
+#endif
+    for (SignedSize c = 0; c < (SignedSize)components.size(); ++c)
+    {
+      AbsoluteQuantitationMethod& component_aqm = *components[c].first;
+      std::vector<AbsoluteQuantitationStandards::featureConcentration>& component_concentrations = *components[c].second;
+      try
       {
         // optimize the calibration curve for the component
         Param optimized_params;
         bool optimal_calibration_found = optimizeCalibrationCurveIterative(
-          cc[component_name],
+          component_concentrations,
           component_aqm.getFeatureName(),
           component_aqm.getTransformationModel(),
           component_aqm.getTransformationModelParams(),
@@ -637,7 +784,7 @@ namespace OpenMS
 
         // order component concentrations and update the lloq and uloq
         std::vector<AbsoluteQuantitationStandards::featureConcentration>::const_iterator it;
-        it = std::min_element(cc[component_name].begin(), cc[component_name].end(), [](
+        it = std::min_element(component_concentrations.begin(), component_concentrations.end(), [](
             const AbsoluteQuantitationStandards::featureConcentration& lhs,
             const AbsoluteQuantitationStandards::featureConcentration& rhs
           )
@@ -646,7 +793,7 @@ namespace OpenMS
           }
         );
         component_aqm.setLLOQ(it->actual_concentration);
-        it = std::max_element(cc[component_name].begin(), cc[component_name].end(), [](
+        it = std::max_element(component_concentrations.begin(), component_concentrations.end(), [](
             const AbsoluteQuantitationStandards::featureConcentration& lhs,
             const AbsoluteQuantitationStandards::featureConcentration& rhs
           )
@@ -662,7 +809,7 @@ namespace OpenMS
           std::vector<double> biases;
           double correlation_coefficient = 0.0;
           calculateBiasAndR(
-            cc[component_name],
+            component_concentrations,
             component_aqm.getFeatureName(),
             component_aqm.getTransformationModel(),
             optimized_params,
@@ -672,9 +819,9 @@ namespace OpenMS
           // record the updated information
           component_aqm.setCorrelationCoefficient(correlation_coefficient);
           component_aqm.setTransformationModelParams(optimized_params);
-          component_aqm.setNPoints(cc[component_name].size());
+          component_aqm.setNPoints(component_concentrations.size());
         }
-        else 
+        else
         {
           component_aqm.setCorrelationCoefficient(0.0);
           component_aqm.setNPoints(0);
@@ -682,16 +829,17 @@ namespace OpenMS
           component_aqm.setULOQ(0.0);
         }
       }
-      else if (optimization_method_ != "iterative")
+      catch (...)
       {
-        throw Exception::IllegalArgument(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION,
-          "Unsupported calibration curve optimization method '" + optimization_method_ + "'.");
-      }
-      else
-      {
-        LOG_DEBUG << "Warning: Standards not found for component " << component_name << ".";
+#ifdef _OPENMP
+#pragma omp critical (AbsoluteQuantitation_error)
+#endif
+        {
+          if (err_count++ == 0) first_error = std::current_exception();
+        }
       }
     }
+    if (first_error) std::rethrow_exception(first_error);
   }
 
   void AbsoluteQuantitation::optimizeSingleCalibrationCurve(
@@ -43,6 +43,14 @@
 #include <OpenMS/KERNEL/ConsensusMap.h>
 #include <OpenMS/MATH/STATISTICS/StatisticFunctions.h>
 
+#include <cmath>
+#include <exception>
+#include <limits>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
 // #define ISOBARIC_CHANNEL_EXTRACTOR_DEBUG
 // #undef ISOBARIC_CHANNEL_EXTRACTOR_DEBUG
 
@@ -54,59 +62,82 @@ namespace OpenMS
   // Also used for TMT_11PLEX
   double TMT_10AND11PLEX_CHANNEL_TOLERANCE = 0.003;
 
-  /// small quality control class, holding temporary data for reporting
-  struct ChannelQC
+  namespace
   {
-    // C'tor
-    ChannelQC() :
-      mz_deltas(),
-      signal_not_unique(0)
-    {}
-
-    std::vector<double> mz_deltas; ///< m/z distance between expected and observed reporter ion closest to expected position
-    int signal_not_unique;  ///< counts if more than one peak was found within the search window of each reporter position
-  };
+    /// distance to the expected reporter position up to which signals are used for the calibration statistics
+    const double qc_dist_mz = 0.5; // fixed! Do not change!
 
+    /**
+      @brief Finds the non-zero signal closest to @p center within @p qc_dist_mz in [@p first, @p last).
+
+      Instead of scanning the whole QC window, the search starts at the
+      expected position and walks outwards until the closest signal on
+      either side is found. If two signals have the same distance, the one
+      with the lower m/z is used.
+
+      @param peak_count Set to the number of non-zero signals closer than @p max_shift to @p center
+      @return The closest signal or @p last if there is none
+    */
+    PeakMap::SpectrumType::ConstIterator findReporterSignal(const PeakMap::SpectrumType& spec,
+                                                            const PeakMap::SpectrumType::ConstIterator& first,
+                                                            const PeakMap::SpectrumType::ConstIterator& last,
+                                                            const double center, const double max_shift, int& peak_count)
+    {
+      typedef PeakMap::SpectrumType::ConstIterator ConstIterator;
 
-  IsobaricChannelExtractor::PuritySate_::PuritySate_(const PeakMap& targetExp) :
-    baseExperiment(targetExp)
-  {
-    // initialize precursorScan with end(), it will be updated later on
-    // from the calling method
-    precursorScan = baseExperiment.end();
+      const ConstIterator pos = spec.MZBegin(first, center, last);
 
-    // find the first ms1 scan in the experiment
-    followUpScan = baseExperiment.begin();
-    while (followUpScan != baseExperiment.end() && followUpScan->getMSLevel() != 1)
-    {
-      ++followUpScan;
-    }
+      // count signals within the user window -- should be only one, otherwise window is too large
+      peak_count = 0;
+      for (ConstIterator it = pos; it != last && it->getMZ() - center < max_shift; ++it)
+      {
+        if (it->getIntensity() != 0) ++peak_count;
+      }
+      for (ConstIterator it = pos; it != first; )
+      {
+        --it;
+        if (center - it->getMZ() >= max_shift) break;
+        if (it->getIntensity() != 0) ++peak_count;
+      }
 
-    // check if we found one
-    hasFollowUpScan = followUpScan != baseExperiment.end();
-  }
+      // closest non-zero signal on the right (ignore 0-intensity shoulder peaks -- could be detrimental when de-calibrated)
+      ConstIterator right = pos;
+      while (right != last && right->getMZ() <= center + qc_dist_mz && right->getIntensity() == 0) ++right;
+      const bool has_right = right != last && right->getMZ() <= center + qc_dist_mz;
 
+      // closest non-zero signal on the left
+      ConstIterator left = pos;
+      bool has_left = false;
+      while (left != first)
+      {
+        --left;
+        if (left->getMZ() < center - qc_dist_mz) break;
+        if (left->getIntensity() != 0)
+        {
+          has_left = true;
+          break;
+        }
+      }
+      if (has_left)
+      {
+        // among signals with identical m/z, the first one is used
+        ConstIterator candidate = left;
+        while (left != first && (left - 1)->getMZ() == candidate->getMZ())
+        {
+          --left;
+          if (left->getIntensity() != 0) candidate = left;
+        }
+        left = candidate;
+      }
 
-  void IsobaricChannelExtractor::PuritySate_::advanceFollowUp(const double rt)
-  {
-    // advance follow up scan until we found a ms1 scan with a bigger RT
-    if (followUpScan != baseExperiment.end()) ++followUpScan;
-    while (followUpScan != baseExperiment.end())
-    {
-      if (followUpScan->getMSLevel() == 1 && followUpScan->getRT() > rt)
+      if (has_left && has_right)
       {
-        break;
+        return (right->getMZ() - center < center - left->getMZ()) ? right : left;
       }
-      ++followUpScan;
+      if (has_left) return left;
+      if (has_right) return right;
+      return last;
     }
-
-    // check if we found one
-    hasFollowUpScan = followUpScan != baseExperiment.end();
-  }
-
-  bool IsobaricChannelExtractor::PuritySate_::followUpValid(const double rt)
-  {
-    return hasFollowUpScan ? rt < followUpScan->getRT() : true;
   }
 
   IsobaricChannelExtractor::IsobaricChannelExtractor(const IsobaricQuantitationMethod* const quant_method) :
@@ -241,28 +272,30 @@ namespace OpenMS
     return false;
   }
 
-  double IsobaricChannelExtractor::computeSingleScanPrecursorPurity_(const PeakMap::ConstIterator& ms2_spec, const PeakMap::SpectrumType& precursor_spec) const
+  double IsobaricChannelExtractor::computeSingleScanPrecursorPurity_(const PeakMap::SpectrumType& ms2_spec, const PeakMap::SpectrumType& precursor_spec) const
   {
 
     typedef PeakMap::SpectrumType::ConstIterator const_spec_iterator;
 
+    const Precursor& precursor = ms2_spec.getPrecursors()[0];
+
     // compute distance between isotopic peaks based on the precursor charge.
-    const double charge_dist = Constants::NEUTRON_MASS_U / static_cast<double>(ms2_spec->getPrecursors()[0].getCharge());
+    const double charge_dist = Constants::NEUTRON_MASS_U / static_cast<double>(precursor.getCharge());
 
     // the actual boundary values
-    const double strict_lower_mz = ms2_spec->getPrecursors()[0].getMZ() - ms2_spec->getPrecursors()[0].getIsolationWindowLowerOffset();
-    const double strict_upper_mz = ms2_spec->getPrecursors()[0].getMZ() + ms2_spec->getPrecursors()[0].getIsolationWindowUpperOffset();
+    const double strict_lower_mz = precursor.getMZ() - precursor.getIsolationWindowLowerOffset();
+    const double strict_upper_mz = precursor.getMZ() + precursor.getIsolationWindowUpperOffset();
 
     const double fuzzy_lower_mz = strict_lower_mz - (strict_lower_mz * max_precursor_isotope_deviation_ / 1000000);
     const double fuzzy_upper_mz = strict_upper_mz + (strict_upper_mz * max_precursor_isotope_deviation_ / 1000000);
 
     // first find the actual precursor peak
-    Size precursor_peak_idx = precursor_spec.findNearest(ms2_spec->getPrecursors()[0].getMZ());
+    Size precursor_peak_idx = precursor_spec.findNearest(precursor.getMZ());
     const Peak1D& precursor_peak = precursor_spec[precursor_peak_idx];
 
     // now we get ourselves some border iterators
     const_spec_iterator lower_bound = precursor_spec.MZBegin(fuzzy_lower_mz);
-    const_spec_iterator upper_bound = precursor_spec.MZEnd(ms2_spec->getPrecursors()[0].getMZ());
+    const_spec_iterator upper_bound = precursor_spec.MZEnd(precursor.getMZ());
 
     Peak1D::IntensityType precursor_intensity = precursor_peak.getIntensity();
     Peak1D::IntensityType total_intensity = precursor_peak.getIntensity();
@@ -278,10 +311,12 @@ namespace OpenMS
       const_spec_iterator np_it = precursor_spec.MZBegin(lower_bound, expected_next_mz, upper_bound);
 
       // handle border cases
+      if (np_it == precursor_spec.end()) break; // no more peaks
 
       // check if next peak has smaller dist
       const_spec_iterator np_it2 = np_it;
       ++np_it;
+      if (np_it == precursor_spec.end()) np_it = np_it2;
 
       if (std::fabs(np_it2->getMZ() - expected_next_mz) < std::fabs(np_it->getMZ() - expected_next_mz))
       {
@@ -325,7 +360,7 @@ namespace OpenMS
     // try to find a match for our isotopic peak on the right
 
     // redefine bounds
-    lower_bound = precursor_spec.MZBegin(ms2_spec->getPrecursors()[0].getMZ());
+    lower_bound = precursor_spec.MZBegin(precursor.getMZ());
     upper_bound = precursor_spec.MZEnd(fuzzy_upper_mz);
 
     expected_next_mz = precursor_peak.getMZ() + charge_dist;
@@ -336,10 +371,12 @@ namespace OpenMS
       const_spec_iterator np_it = precursor_spec.MZBegin(lower_bound, expected_next_mz, upper_bound);
 
       // handle border cases
+      if (np_it == precursor_spec.end()) break; // no more peaks
 
       // check if next peak has smaller dist
       const_spec_iterator np_it2 = np_it;
       ++np_it;
+      if (np_it == precursor_spec.end()) np_it = np_it2;
 
       if (std::fabs(np_it2->getMZ() - expected_next_mz) < std::fabs(np_it->getMZ() - expected_next_mz))
       {
@@ -416,32 +453,34 @@ namespace OpenMS
     return precursor_intensity / total_intensity;
   }
 
-  double IsobaricChannelExtractor::computePrecursorPurity_(const PeakMap::ConstIterator& ms2_spec, const PuritySate_& pState) const
+  double IsobaricChannelExtractor::computePrecursorPurity_(const Job_& job) const
   {
+    const PeakMap::SpectrumType& ms2_spec = *job.spectrum;
+
     // we cannot analyze precursors without a charge
-    if (ms2_spec->getPrecursors()[0].getCharge() == 0)
+    if (ms2_spec.getPrecursors()[0].getCharge() == 0)
     {
       return 1.0;
     }
     else
     {
 #ifdef ISOBARIC_CHANNEL_EXTRACTOR_DEBUG
-      std::cerr << "------------------ analyzing " << ms2_spec->getNativeID() << std::endl;
+      std::cerr << "------------------ analyzing " << ms2_spec.getNativeID() << std::endl;
 #endif
 
       // compute purity of preceding ms1 scan
-      double early_scan_purity = computeSingleScanPrecursorPurity_(ms2_spec, *(pState.precursorScan));
+      double early_scan_purity = computeSingleScanPrecursorPurity_(ms2_spec, *job.precursor_scan);
 
-      if (pState.hasFollowUpScan && interpolate_precursor_purity_)
+      if (job.follow_up_scan && interpolate_precursor_purity_)
       {
-        double late_scan_purity = computeSingleScanPrecursorPurity_(ms2_spec, *(pState.followUpScan));
+        double late_scan_purity = computeSingleScanPrecursorPurity_(ms2_spec, *job.follow_up_scan);
 
         // calculating the extrapolated, S2I value as a time weighted linear combination of the two scans
         // see: Savitski MM, Sweetman G, Askenazi M, Marto JA, Lang M, Zinn N, et al. (2011).
         // Analytical chemistry 83: 8959–67. http://www.ncbi.nlm.nih.gov/pubmed/22017476
         // std::fabs is applied to compensate for potentially negative RTs
-        return std::fabs(ms2_spec->getRT() - pState.precursorScan->getRT()) *
-               ((late_scan_purity - early_scan_purity) / std::fabs(pState.followUpScan->getRT() - pState.precursorScan->getRT()))
+        return std::fabs(ms2_spec.getRT() - job.precursor_scan->getRT()) *
+               ((late_scan_purity - early_scan_purity) / std::fabs(job.follow_up_scan->getRT() - job.precursor_scan->getRT()))
                + early_scan_purity;
       }
       else
@@ -451,205 +490,144 @@ namespace OpenMS
     }
   }
 
-  void IsobaricChannelExtractor::extractChannels(const PeakMap& ms_exp_data, ConsensusMap& consensus_map)
+  void IsobaricChannelExtractor::extractSpectrum_(const Job_& job, JobResult_& result) const
   {
-    if (ms_exp_data.empty())
-    {
-      LOG_WARN << "The given file does not contain any conventional peak data, but might"
-                  " contain chromatograms. This tool currently cannot handle them, sorry.\n";
-      throw Exception::MissingInformation(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "Experiment has no scans!");
-    }
+    const PeakMap::SpectrumType& spec = *job.spectrum;
 
-    // check if RT is sorted (we rely on it)
-    if (!ms_exp_data.isSorted(false))
+    // check precursor purity if we have a valid precursor ..
+    result.precursor_purity = -1.0;
+    if (job.precursor_scan)
     {
-      throw Exception::InvalidParameter(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "Spectra are not sorted in RT! Please sort them first!");
+      result.precursor_purity = computePrecursorPurity_(job);
+      // the spectrum is skipped if the purity is not high enough (see extractBatch_)
+      if (result.precursor_purity < min_precursor_purity_) return;
     }
 
-    // clear the output map
-    consensus_map.clear(false);
-    consensus_map.setExperimentType("labeled_MS2");
-
-    // create predicate for spectrum checking
-    LOG_INFO << "Selecting scans with activation mode: " << (selected_activation_ == "" ? "any" : selected_activation_) << std::endl;
-    HasActivationMethod<PeakMap::SpectrumType> isValidActivation(ListUtils::create<String>(selected_activation_));
+    const IsobaricQuantitationMethod::IsobaricChannelList& channels = quant_method_->getChannelInformation();
+    result.channels.resize(channels.size());
+    result.mz_deltas.assign(channels.size(), std::numeric_limits<double>::quiet_NaN());
+    result.signal_not_unique.assign(channels.size(), 0);
 
-    // walk through spectra and count the number of scans with valid activation method per MS-level
-    // only the highest level will be used for quantification (e.g. MS3, if present)
-    std::map<UInt, UInt> ms_level;
-    std::map<String, int> activation_modes;
-    for (PeakMap::ConstIterator it = ms_exp_data.begin(); it != ms_exp_data.end(); ++it)
+    // restrict all searches to the reporter region of the spectrum
+    double min_center = std::numeric_limits<double>::max(), max_center = -std::numeric_limits<double>::max();
+    for (IsobaricQuantitationMethod::IsobaricChannelList::const_iterator cl_it = channels.begin(); cl_it != channels.end(); ++cl_it)
     {
-      if (it->getMSLevel() == 1) continue; // never report MS1
-      ++activation_modes[getActivationMethod_(*it)]; // count HCD, CID, ...
-      if (selected_activation_ == "" || isValidActivation(*it))
-      {
-        ++ms_level[it->getMSLevel()];
-      }
+      min_center = std::min(min_center, cl_it->center);
+      max_center = std::max(max_center, cl_it->center);
     }
-    if (ms_level.empty())
-    {
-      LOG_WARN << "Filtering by MS/MS(/MS) and activation mode: no spectra pass activation mode filter!\n"
-               << "Activation modes found:\n";
-      for (std::map<String, int>::const_iterator it = activation_modes.begin(); it != activation_modes.end(); ++it)
-      {
-        LOG_WARN << "  mode " << (it->first.empty() ? "<none>" : it->first) << ": " << it->second << " scans\n";
-      }
-      LOG_WARN << "Result will be empty!" << std::endl;
-      return;
-    }
-    LOG_INFO << "Filtering by MS/MS(/MS) and activation mode:\n";
-    for (std::map<UInt, UInt>::const_iterator it = ms_level.begin(); it != ms_level.end(); ++it)
-    {
-      LOG_INFO << "  level " << it->first << ": " << it->second << " scans\n";
-    }
-    UInt quant_ms_level = ms_level.rbegin()->first;
-    LOG_INFO << "Using MS-level " << quant_ms_level << " for quantification." << std::endl;
-
-    // now we have picked data
-    // --> assign peaks to channels
-    UInt64 element_index(0);
-
-    // remember the current precursor spectrum
-    PuritySate_ pState(ms_exp_data);
-
-    typedef std::map<String, ChannelQC > ChannelQCSet;
-    ChannelQCSet channel_mz_delta;
-    const double qc_dist_mz = 0.5; // fixed! Do not change!
-
-    Size number_of_channels = quant_method_->getNumberOfChannels();
-
-    PeakMap::ConstIterator it_last_MS2 = ms_exp_data.end(); // remember last MS2 spec, to get precursor in MS1 (also if quant is in MS3)
+    const PeakMap::SpectrumType::ConstIterator first = spec.MZBegin(min_center - qc_dist_mz);
+    const PeakMap::SpectrumType::ConstIterator last = spec.MZEnd(max_center + qc_dist_mz);
 
-    for (PeakMap::ConstIterator it = ms_exp_data.begin(); it != ms_exp_data.end(); ++it)
+    for (Size i = 0; i < channels.size(); ++i)
     {
-      // remember the last MS1 spectra as we assume it to be the precursor spectrum
-      if (it->getMSLevel() ==  1)
+      Peak2D& channel_value = result.channels[i];
+      // set position of channel
+      channel_value.setRT(spec.getRT());
+      channel_value.setMZ(channels[i].center);
+      channel_value.setIntensity(0);
+
+      // search for the non-zero signal closest to theoretical position
+      // & check for closest signal within reasonable distance (0.5 Da) -- might find neighbouring TMT channel, but that should not confuse anyone
+      int peak_count(0);
+      PeakMap::SpectrumType::ConstIterator idx_nearest = findReporterSignal(spec, first, last, channels[i].center, reporter_mass_shift_, peak_count);
+      if (idx_nearest != last)
       {
-        // remember potential precursor and continue
-        pState.precursorScan = it;
-        // reset last MS2 -- we expect to see a new one soon and the old one should not be used for the following MS3 (if any)
-        it_last_MS2 = ms_exp_data.end();
-        continue;
-      }
-      else if (it->getMSLevel() == 2)
-      { // remember last MS2 spec, to get precursor in MS1 (also if quant is in MS3)
-        it_last_MS2 = it;
-        if (it_last_MS2->getPrecursors().empty())
+        double mz_delta = channels[i].center - idx_nearest->getMZ();
+        // stats: we don't care what shift the user specified
+        result.mz_deltas[i] = mz_delta;
+        result.signal_not_unique[i] = peak_count > 1;
+        // pass user threshold
+        if (std::fabs(mz_delta) < reporter_mass_shift_)
         {
-          throw Exception::MissingInformation(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, String("No precursor information given for scan native ID ") + it->getNativeID() + " with RT " + String(it->getRT()));
+          channel_value.setIntensity(idx_nearest->getIntensity());
         }
       }
-      if (it->getMSLevel() != quant_ms_level) continue;
-      if ((*it).empty()) continue; // skip empty spectra
-      if (!(selected_activation_ == "" || isValidActivation(*it))) continue;
 
-      // find following ms1 scan (needed for purity computation)
-      if (!pState.followUpValid(it->getRT()))
+      // discard contribution of this channel as it is below the required intensity threshold
+      if (channel_value.getIntensity() < min_reporter_intensity_)
       {
-        // advance iterator
-        pState.advanceFollowUp(it->getRT());
+        channel_value.setIntensity(0);
       }
+    }
+  }
 
-      // check if precursor is available
-      if (it->getPrecursors().empty())
+  void IsobaricChannelExtractor::extractBatch_(const std::vector<Job_>& jobs, ConsensusMap& consensus_map, UInt64& element_index, std::vector<ChannelQC_>& channel_qc) const
+  {
+    std::vector<JobResult_> results(jobs.size());
+
+    // parallel exception catching and re-throwing business
+    Size err_count = 0;
+    std::exception_ptr error;
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic)
+#endif
+    for (SignedSize i = 0; i < (SignedSize)jobs.size(); ++i)
+    {
+      if (err_count) continue; // no need to continue if already an error was encountered
+      try
       {
-        throw Exception::MissingInformation(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, String("No precursor information given for scan native ID ") + it->getNativeID() + " with RT " + String(it->getRT()));
+        extractSpectrum_(jobs[i], results[i]);
       }
-
-      // check precursor constraints
-      if (!isValidPrecursor_(it->getPrecursors()[0]))
+      catch (...)
       {
-        LOG_DEBUG << "Skip spectrum " << it->getNativeID() << ": Precursor doesn't fulfill all constraints." << std::endl;
-        continue;
+#ifdef _OPENMP
+#pragma omp critical (IsobaricChannelExtractor_error)
+#endif
+        {
+          if (!err_count) error = std::current_exception();
+          ++err_count;
+        }
       }
+    }
+    if (err_count != 0)
+    {
+      std::rethrow_exception(error);
+    }
+
+    // assemble the features in the order of the spectra
+    for (Size i = 0; i < jobs.size(); ++i)
+    {
+      const PeakMap::SpectrumType& spec = *jobs[i].spectrum;
+      const JobResult_& result = results[i];
 
-      // check precursor purity if we have a valid precursor ..
-      double precursor_purity = -1.0;
-      if (pState.precursorScan != ms_exp_data.end())
+      if (jobs[i].precursor_scan)
       {
-        precursor_purity = computePrecursorPurity_(it, pState);
         // check if purity is high enough
-        if (precursor_purity < min_precursor_purity_)
+        if (result.precursor_purity < min_precursor_purity_)
         {
-          LOG_DEBUG << "Skip spectrum " << it->getNativeID() << ": Precursor purity is below the threshold. [purity = " << precursor_purity << "]" << std::endl;
+          LOG_DEBUG << "Skip spectrum " << spec.getNativeID() << ": Precursor purity is below the threshold. [purity = " << result.precursor_purity << "]" << std::endl;
           continue;
         }
       }
       else
       {
-        LOG_INFO << "No precursor available for spectrum: " << it->getNativeID() << std::endl;
+        LOG_INFO << "No precursor available for spectrum: " << spec.getNativeID() << std::endl;
       }
 
       // store RT&MZ of MS1 parent ion as centroid of ConsensusFeature
-      if (it_last_MS2 == ms_exp_data.end())
+      if (!jobs[i].has_parent)
       { // this only happens if an MS3 spec does not have a preceding MS2
-        throw Exception::MissingInformation(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, String("No MS2 precursor information given for MS3 scan native ID ") + it->getNativeID() + " with RT " + String(it->getRT()));
+        throw Exception::MissingInformation(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, String("No MS2 precursor information given for MS3 scan native ID ") + spec.getNativeID() + " with RT " + String(spec.getRT()));
       }
       ConsensusFeature cf;
       cf.setUniqueId();
-      cf.setRT(it_last_MS2->getRT());
-      cf.setMZ(it_last_MS2->getPrecursors()[0].getMZ());
+      cf.setRT(jobs[i].parent_rt);
+      cf.setMZ(jobs[i].parent_mz);
 
-      Peak2D channel_value;
-      channel_value.setRT(it->getRT());
       // for each each channel
-      UInt64 map_index = 0;
       Peak2D::IntensityType overall_intensity = 0;
-
-      for (IsobaricQuantitationMethod::IsobaricChannelList::const_iterator cl_it = quant_method_->getChannelInformation().begin();
-            cl_it != quant_method_->getChannelInformation().end();
-            ++cl_it)
+      for (Size map_index = 0; map_index < result.channels.size(); ++map_index)
       {
-        // set mz-position of channel
-        channel_value.setMZ(cl_it->center);
-        // reset intensity
-        channel_value.setIntensity(0);
-
-        // as every evaluation requires time, we cache the MZEnd iterator
-        const PeakMap::SpectrumType::ConstIterator mz_end = it->MZEnd(cl_it->center + qc_dist_mz);
-
-        // search for the non-zero signal closest to theoretical position
-        // & check for closest signal within reasonable distance (0.5 Da) -- might find neighbouring TMT channel, but that should not confuse anyone
-        int peak_count(0); // count peaks in user window -- should be only one, otherwise Window is too large
-        PeakMap::SpectrumType::ConstIterator idx_nearest(mz_end);
-        for (PeakMap::SpectrumType::ConstIterator mz_it = it->MZBegin(cl_it->center - qc_dist_mz);
-              mz_it != mz_end;
-              ++mz_it)
-        {
-          if (mz_it->getIntensity() == 0) continue; // ignore 0-intensity shoulder peaks -- could be detrimental when de-calibrated
-          double dist_mz = fabs(mz_it->getMZ() - cl_it->center);
-          if (dist_mz < reporter_mass_shift_) ++peak_count;
-          if (idx_nearest == mz_end // first peak
-              || ((dist_mz < fabs(idx_nearest->getMZ() - cl_it->center)))) // closer to best candidate
-          {
-            idx_nearest = mz_it;
-          }
-        }
-        if (idx_nearest != mz_end)
-        {
-          double mz_delta = cl_it->center - idx_nearest->getMZ();
-          // stats: we don't care what shift the user specified
-          channel_mz_delta[cl_it->name].mz_deltas.push_back(mz_delta);
-          if (peak_count > 1) ++channel_mz_delta[cl_it->name].signal_not_unique;
-          // pass user threshold
-          if (std::fabs(mz_delta) < reporter_mass_shift_)
-          {
-            channel_value.setIntensity(idx_nearest->getIntensity());
-          }
-        }
-
-        // discard contribution of this channel as it is below the required intensity threshold
-        if (channel_value.getIntensity() < min_reporter_intensity_)
+        if (!std::isnan(result.mz_deltas[map_index]))
         {
-          channel_value.setIntensity(0);
+          channel_qc[map_index].mz_deltas.push_back(result.mz_deltas[map_index]);
+          if (result.signal_not_unique[map_index]) ++channel_qc[map_index].signal_not_unique;
         }
 
-        overall_intensity += channel_value.getIntensity();
+        overall_intensity += result.channels[map_index].getIntensity();
         // add channel to ConsensusFeature
-        cf.insert(map_index, channel_value, element_index);
-        ++map_index;
-      } // ! channel_iterator
+        cf.insert(map_index, result.channels[map_index], element_index);
+      }
 
       // check if we keep this feature or if it contains low-intensity quantifications
       if (remove_low_intensity_quantifications_ && hasLowIntensityReporter_(cf))
@@ -663,48 +641,52 @@ namespace OpenMS
         cf.setMetaValue("all_empty", String("true"));
       }
       // add purity information if we could compute it
-      if (precursor_purity > 0.0)
+      if (result.precursor_purity > 0.0)
       {
-        cf.setMetaValue("precursor_purity", precursor_purity);
+        cf.setMetaValue("precursor_purity", result.precursor_purity);
       }
 
       // embed the id of the scan from which the quantitative information was extracted
-      cf.setMetaValue("scan_id", it->getNativeID());
+      cf.setMetaValue("scan_id", spec.getNativeID());
       // ...as well as additional meta information
-      cf.setMetaValue("precursor_intensity", it->getPrecursors()[0].getIntensity());
+      cf.setMetaValue("precursor_intensity", spec.getPrecursors()[0].getIntensity());
 
-      cf.setCharge(it->getPrecursors()[0].getCharge());
+      cf.setCharge(spec.getPrecursors()[0].getCharge());
       cf.setIntensity(overall_intensity);
       consensus_map.push_back(cf);
 
       // the tandem-scan in the order they appear in the experiment
       ++element_index;
-    } // ! Experiment iterator
+    }
+  }
+
+  void IsobaricChannelExtractor::reportChannelQC_(std::vector<ChannelQC_>& channel_qc) const
+  {
+    Size number_of_channels = quant_method_->getNumberOfChannels();
 
     // print stats about m/z calibration / presence of signal
     LOG_INFO << "Calibration stats: Median distance of observed reporter ions m/z to expected position (up to " << qc_dist_mz << " Th):\n";
     bool impurities_found(false);
-    for (IsobaricQuantitationMethod::IsobaricChannelList::const_iterator cl_it = quant_method_->getChannelInformation().begin();
-      cl_it != quant_method_->getChannelInformation().end();
-      ++cl_it)
+    const IsobaricQuantitationMethod::IsobaricChannelList& channels = quant_method_->getChannelInformation();
+    for (Size i = 0; i < channels.size(); ++i)
     {
-      LOG_INFO << "  ch " << String(cl_it->name).fillRight(' ', 4) << " (~" << String(cl_it->center).substr(0, 7).fillRight(' ', 7) << "): ";
-      if (channel_mz_delta.find(cl_it->name) != channel_mz_delta.end())
+      LOG_INFO << "  ch " << String(channels[i].name).fillRight(' ', 4) << " (~" << String(channels[i].center).substr(0, 7).fillRight(' ', 7) << "): ";
+      if (!channel_qc[i].mz_deltas.empty())
       {
         // sort
-        double median = Math::median(channel_mz_delta[cl_it->name].mz_deltas.begin(), channel_mz_delta[cl_it->name].mz_deltas.end(), false);
+        double median = Math::median(channel_qc[i].mz_deltas.begin(), channel_qc[i].mz_deltas.end(), false);
         if (((number_of_channels == 10) || (number_of_channels == 11)) &&
             (fabs(median) > TMT_10AND11PLEX_CHANNEL_TOLERANCE) &&
-            (int(cl_it->center) != 126 && int(cl_it->center) != 131)) // these two channels have ~1 Th spacing.. so they do not suffer from the tolerance problem
+            (int(channels[i].center) != 126 && int(channels[i].center) != 131)) // these two channels have ~1 Th spacing.. so they do not suffer from the tolerance problem
         { // the channel was most likely empty, and we picked up the neighbouring channel's data (~0.006 Th apart). So reporting median here is misleading.
           LOG_INFO << "<invalid data (>" << TMT_10AND11PLEX_CHANNEL_TOLERANCE << " Th channel tolerance)>\n";
         }
         else
         {
           LOG_INFO << median << " Th";
-          if (channel_mz_delta[cl_it->name].signal_not_unique > 0) 
+          if (channel_qc[i].signal_not_unique > 0)
           {
-            LOG_INFO << " [MSn impurity (within " << reporter_mass_shift_ << " Th): " << channel_mz_delta[cl_it->name].signal_not_unique << " windows|spectra]";
+            LOG_INFO << " [MSn impurity (within " << reporter_mass_shift_ << " Th): " << channel_qc[i].signal_not_unique << " windows|spectra]";
             impurities_found = true;
           }
           LOG_INFO << "\n";
@@ -715,16 +697,36 @@ namespace OpenMS
         LOG_INFO << "<no data>\n";
       }
     }
-    if (impurities_found) LOG_INFO << "\nImpurities within the allowed reporter mass shift " << reporter_mass_shift_ << " Th have been found." 
+    if (impurities_found) LOG_INFO << "\nImpurities within the allowed reporter mass shift " << reporter_mass_shift_ << " Th have been found."
                                    << "They can be ignored if the spectra are m/z calibrated (see above), since only the peak closest to the theoretical position is used for quantification!";
     LOG_INFO << std::endl;
+  }
 
+  void IsobaricChannelExtractor::extractChannels(const PeakMap& ms_exp_data, ConsensusMap& consensus_map)
+  {
+    if (ms_exp_data.empty())
+    {
+      LOG_WARN << "The given file does not contain any conventional peak data, but might"
+                  " contain chromatograms. This tool currently cannot handle them, sorry.\n";
+      throw Exception::MissingInformation(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "Experiment has no scans!");
+    }
 
-    /// add meta information to the map
-    registerChannelsInOutputMap_(consensus_map);
+    // check if RT is sorted (we rely on it)
+    if (!ms_exp_data.isSorted(false))
+    {
+      throw Exception::InvalidParameter(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "Spectra are not sorted in RT! Please sort them first!");
+    }
+
+    // the experiment outlives the consumer, so the spectra need not be copied
+    ExtractionConsumer consumer(*this, consensus_map);
+    for (PeakMap::ConstIterator it = ms_exp_data.begin(); it != ms_exp_data.end(); ++it)
+    {
+      consumer.consumeSpectrum_(*it, true);
+    }
+    consumer.finish();
   }
 
-  void IsobaricChannelExtractor::registerChannelsInOutputMap_(ConsensusMap& consensus_map)
+  void IsobaricChannelExtractor::registerChannelsInOutputMap_(ConsensusMap& consensus_map) const
   {
     // register the individual channels in the output consensus map
     Int index = 0;
@@ -749,4 +751,197 @@ namespace OpenMS
     }
   }
 
+  IsobaricChannelExtractor::ExtractionConsumer::ExtractionConsumer(const IsobaricChannelExtractor& extractor, ConsensusMap& consensus_map) :
+    extractor_(extractor),
+    consensus_map_(consensus_map),
+#ifdef _OPENMP
+    batch_size_(16 * omp_get_max_threads()),
+#else
+    batch_size_(16),
+#endif
+    spectra_count_(0),
+    last_rt_(-std::numeric_limits<double>::max()),
+    ms_level_(),
+    activation_modes_(),
+    quant_ms_level_(0),
+    has_last_ms2_(false),
+    last_ms2_rt_(0.0),
+    last_ms2_mz_(0.0),
+    precursor_scan_(),
+    waiting_(),
+    ready_(),
+    element_index_(0),
+    channel_qc_(extractor.quant_method_->getNumberOfChannels())
+  {
+    // clear the output map
+    consensus_map_.clear(false);
+    consensus_map_.setExperimentType("labeled_MS2");
+
+    LOG_INFO << "Selecting scans with activation mode: " << (extractor_.selected_activation_ == "" ? "any" : extractor_.selected_activation_) << std::endl;
+  }
+
+  IsobaricChannelExtractor::ExtractionConsumer::~ExtractionConsumer()
+  {
+  }
+
+  void IsobaricChannelExtractor::ExtractionConsumer::consumeSpectrum(SpectrumType& s)
+  {
+    consumeSpectrum_(s, false);
+  }
+
+  void IsobaricChannelExtractor::ExtractionConsumer::consumeSpectrum_(const SpectrumType& s, bool borrowed)
+  {
+    // check if RT is sorted (we rely on it)
+    if (s.getRT() < last_rt_)
+    {
+      throw Exception::InvalidParameter(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "Spectra are not sorted in RT! Please sort them first!");
+    }
+    last_rt_ = s.getRT();
+    ++spectra_count_;
+
+    // only MS1 scans and the spectra used for quantitation are kept
+    auto share = [&s, borrowed]()
+    {
+      return borrowed ? std::shared_ptr<const SpectrumType>(&s, [](const SpectrumType*) {}) : std::make_shared<const SpectrumType>(s);
+    };
+
+    if (s.getMSLevel() == 1)
+    {
+      std::shared_ptr<const SpectrumType> ms1 = share();
+
+      // this is the follow up scan of all waiting spectra with a smaller RT
+      Size n_ready = 0;
+      while (n_ready < waiting_.size() && waiting_[n_ready].spectrum->getRT() < s.getRT())
+      {
+        waiting_[n_ready].follow_up_scan = ms1;
+        ready_.push_back(waiting_[n_ready]);
+        ++n_ready;
+      }
+      waiting_.erase(waiting_.begin(), waiting_.begin() + n_ready);
+
+      // remember potential precursor
+      precursor_scan_ = ms1;
+      // reset last MS2 -- we expect to see a new one soon and the old one should not be used for the following MS3 (if any)
+      has_last_ms2_ = false;
+
+      if (ready_.size() >= batch_size_) extractReady_(false);
+      return;
+    }
+
+    // count the number of scans with valid activation method per MS-level
+    // only the highest level will be used for quantification (e.g. MS3, if present)
+    ++activation_modes_[extractor_.getActivationMethod_(s)]; // count HCD, CID, ...
+    HasActivationMethod<SpectrumType> isValidActivation(ListUtils::create<String>(extractor_.selected_activation_));
+    const bool valid_activation = extractor_.selected_activation_ == "" || isValidActivation(s);
+    if (valid_activation)
+    {
+      ++ms_level_[s.getMSLevel()];
+      if (s.getMSLevel() > quant_ms_level_)
+      {
+        // a higher MS level is present, everything extracted so far is not used
+        quant_ms_level_ = s.getMSLevel();
+        consensus_map_.clear(false);
+        element_index_ = 0;
+        channel_qc_.assign(channel_qc_.size(), ChannelQC_());
+        waiting_.clear();
+        ready_.clear();
+      }
+    }
+
+    if (s.getMSLevel() == 2)
+    { // remember last MS2 spec, to get precursor in MS1 (also if quant is in MS3)
+      if (s.getPrecursors().empty())
+      {
+        throw Exception::MissingInformation(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, String("No precursor information given for scan native ID ") + s.getNativeID() + " with RT " + String(s.getRT()));
+      }
+      has_last_ms2_ = true;
+      last_ms2_rt_ = s.getRT();
+      last_ms2_mz_ = s.getPrecursors()[0].getMZ();
+    }
+    if (s.getMSLevel() != quant_ms_level_) return;
+    if (s.empty()) return; // skip empty spectra
+    if (!valid_activation) return;
+
+    // check if precursor is available
+    if (s.getPrecursors().empty())
+    {
+      throw Exception::MissingInformation(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, String("No precursor information given for scan native ID ") + s.getNativeID() + " with RT " + String(s.getRT()));
+    }
+
+    // check precursor constraints
+    if (!extractor_.isValidPrecursor_(s.getPrecursors()[0]))
+    {
+      LOG_DEBUG << "Skip spectrum " << s.getNativeID() << ": Precursor doesn't fulfill all constraints." << std::endl;
+      return;
+    }
+
+    Job_ job;
+    job.spectrum = share();
+    job.precursor_scan = precursor_scan_;
+    job.has_parent = has_last_ms2_;
+    job.parent_rt = last_ms2_rt_;
+    job.parent_mz = last_ms2_mz_;
+
+    // the following MS1 scan is only needed for the interpolation of the purity
+    if (job.precursor_scan && extractor_.interpolate_precursor_purity_)
+    {
+      waiting_.push_back(job);
+    }
+    else
+    {
+      ready_.push_back(job);
+      if (ready_.size() >= batch_size_) extractReady_(false);
+    }
+  }
+
+  void IsobaricChannelExtractor::ExtractionConsumer::extractReady_(bool all)
+  {
+    // take the batch out first, so it is discarded if the extraction fails
+    std::vector<Job_> batch;
+    batch.swap(ready_);
+    if (all)
+    {
+      // no follow up scan available for these
+      batch.insert(batch.end(), waiting_.begin(), waiting_.end());
+      waiting_.clear();
+    }
+    extractor_.extractBatch_(batch, consensus_map_, element_index_, channel_qc_);
+  }
+
+  void IsobaricChannelExtractor::ExtractionConsumer::finish()
+  {
+    if (spectra_count_ == 0)
+    {
+      LOG_WARN << "The given file does not contain any conventional peak data, but might"
+                  " contain chromatograms. This tool currently cannot handle them, sorry.\n";
+      throw Exception::MissingInformation(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "Experiment has no scans!");
+    }
+
+    extractReady_(true);
+    precursor_scan_.reset();
+
+    if (ms_level_.empty())
+    {
+      LOG_WARN << "Filtering by MS/MS(/MS) and activation mode: no spectra pass activation mode filter!\n"
+               << "Activation modes found:\n";
+      for (std::map<String, int>::const_iterator it = activation_modes_.begin(); it != activation_modes_.end(); ++it)
+      {
+        LOG_WARN << "  mode " << (it->first.empty() ? "<none>" : it->first) << ": " << it->second << " scans\n";
+      }
+      LOG_WARN << "Result will be empty!" << std::endl;
+      return;
+    }
+    LOG_INFO << "Filtering by MS/MS(/MS) and activation mode:\n";
+    for (std::map<UInt, UInt>::const_iterator it = ms_level_.begin(); it != ms_level_.end(); ++it)
+    {
+      LOG_INFO << "  level " << it->first << ": " << it->second << " scans\n";
+    }
+    LOG_INFO << "Using MS-level " << quant_ms_level_ << " for quantification." << std::endl;
+
+    extractor_.reportChannelQC_(channel_qc_);
+
+    /// add meta information to the map
+    extractor_.registerChannelsInOutputMap_(consensus_map_);
+  }
+
 } // namespace
@@ -73,11 +73,8 @@ namespace OpenMS
 
     // convert to Eigen matrix
     EigenMatrixXdPtr m(convertOpenMSMatrix2EigenMatrixXd(correction_matrix));
+    // the correction matrix is the same for all features: factorize it only once
     Eigen::FullPivLU<Eigen::MatrixXd> ludecomp(*m);
-    Eigen::VectorXd b;
-    b.resize(quant_method->getNumberOfChannels());
-    b.setZero();
-    std::vector<double> x(quant_method->getNumberOfChannels(), 0);
 
     if (!ludecomp.isInvertible())
     {
@@ -85,9 +82,25 @@ namespace OpenMS
       throw Exception::InvalidParameter(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "IsobaricIsotopeCorrector: The given isotope correction matrix is not invertible!");
     }
 
+    // collect the reporter intensities of all consensus elements (one column per element)
+    const Size channel_count = quant_method->getNumberOfChannels();
+    Eigen::MatrixXd b(channel_count, consensus_map_in.size());
+    b.setZero();
+    for (ConsensusMap::size_type i = 0; i < consensus_map_in.size(); ++i)
+    {
+      fillInputVector_(b, i, consensus_map_in[i], consensus_map_in);
+    }
+
+    // solve the unconstrained problem for all elements at once
+    Eigen::MatrixXd e_mx = ludecomp.solve(b);
+    if (!((*m) * e_mx).isApprox(b))
+    {
+      throw Exception::InvalidParameter(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "IsobaricIsotopeCorrector: Cannot multiply!");
+    }
+
     // data structures for NNLS
-    Matrix<double> m_b(quant_method->getNumberOfChannels(), 1);
-    Matrix<double> m_x(quant_method->getNumberOfChannels(), 1);
+    Matrix<double> m_b(channel_count, 1);
+    Matrix<double> m_x(channel_count, 1);
 
     // correct all consensus elements
     for (ConsensusMap::size_type i = 0; i < consensus_map_out.size(); ++i)
@@ -98,30 +111,37 @@ namespace OpenMS
       // delete only the consensus handles from the output map
       consensus_map_out[i].clear();
 
-      // fill b vector
-      fillInputVector_(b, m_b, consensus_map_in[i], consensus_map_in);
-
-      //solve
-      Eigen::MatrixXd e_mx = ludecomp.solve(b);
-      if (!((*m) * e_mx).isApprox(b))
+      Eigen::VectorXd x = e_mx.col(i);
+      if (x.size() == 0 || x.minCoeff() >= 0.0)
+      {
+        // non-negativity constraints are inactive: the exact solution is also the NNLS solution
+        for (Size index = 0; index < channel_count; ++index)
+        {
+          m_x(index, 0) = x(index);
+        }
+      }
+      else
       {
-        throw Exception::InvalidParameter(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "IsobaricIsotopeCorrector: Cannot multiply!");
+        for (Size index = 0; index < channel_count; ++index)
+        {
+          m_b(index, 0) = b(index, i);
+        }
+        solveNNLS_(correction_matrix, m_b, m_x);
       }
-      solveNNLS_(correction_matrix, m_b, m_x);
 
       // update the output consensus map with the corrected intensities
       float cf_intensity = updateOutpuMap_(consensus_map_in, consensus_map_out, i, m_x);
 
       // check consistency
-      computeStats_(m_x, e_mx, cf_intensity, quant_method, stats);    
+      computeStats_(m_x, x, cf_intensity, quant_method, stats);
     }
 
     return stats;
   }
 
   void
-  IsobaricIsotopeCorrector::fillInputVector_(Eigen::VectorXd& b,
-                                             Matrix<double>& m_b, const ConsensusFeature& cf, const ConsensusMap& cm)
+  IsobaricIsotopeCorrector::fillInputVector_(Eigen::MatrixXd& b,
+                                             Size column, const ConsensusFeature& cf, const ConsensusMap& cm)
   {
     for (ConsensusFeature::HandleSetType::const_iterator it_elements = cf.getFeatures().begin();
          it_elements != cf.getFeatures().end();
@@ -133,8 +153,7 @@ namespace OpenMS
       std::cout << "  map_index " << it_elements->getMapIndex() << "-> id " << index << " with intensity " << it_elements->getIntensity() << "\n" << std::endl;
 #endif
       // this is deprecated, but serves as quality measurement
-      b(index) = it_elements->getIntensity();
-      m_b(index, 0) = it_elements->getIntensity();
+      b(index, column) = it_elements->getIntensity();
     }
   }
 
@@ -151,7 +170,7 @@ namespace OpenMS
 
   void
   IsobaricIsotopeCorrector::computeStats_(const Matrix<double>& m_x,
-                                          const Eigen::MatrixXd& x, const float cf_intensity,
+                                          const Eigen::VectorXd& x, const float cf_intensity,
                                           const IsobaricQuantitationMethod* quant_method, IsobaricQuantifierStatistics& stats)
   {
     Size s_negative(0);
@@ -170,44 +170,59 @@ namespace OpenMS
       pep_quant_ = filtered;
     }
 
-    // now perform the actual peptide quantification:
+    // now perform the actual peptide quantification (peptides are independent
+    // of each other, so this can be done in parallel):
+    bool filter_charge = param_.getValue("filter_charge") == "true";
+    vector<PeptideQuant::iterator> pep_its;
+    pep_its.reserve(pep_quant_.size());
     for (PeptideQuant::iterator q_it = pep_quant_.begin();
          q_it != pep_quant_.end(); ++q_it)
     {
-      if (param_.getValue("filter_charge") == "true")
+      pep_its.push_back(q_it);
+    }
+
+    Size quant_peptides = 0;
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic, 64) reduction(+: quant_peptides)
+#endif
+    for (SignedSize i = 0; i < SignedSize(pep_its.size()); ++i)
+    {
+      PeptideData& data = pep_its[i]->second;
+      if (filter_charge)
       {
         // find charge state with abundances for highest number of samples
         // (break ties by total abundance):
         IntList charges; // sorted charge states (best first)
-        orderBest_(q_it->second.abundances, charges);
+        orderBest_(data.abundances, charges);
         if (charges.empty()) continue; // only identified, not quantified
         Int best_charge = charges[0];
 
         // quantify according to the best charge state only:
         for (SampleAbundances::iterator samp_it =
-               q_it->second.abundances[best_charge].begin(); samp_it !=
-             q_it->second.abundances[best_charge].end(); ++samp_it)
+               data.abundances[best_charge].begin(); samp_it !=
+             data.abundances[best_charge].end(); ++samp_it)
         {
-          q_it->second.total_abundances[samp_it->first] = samp_it->second;
+          data.total_abundances[samp_it->first] = samp_it->second;
         }
       }
       else
       {
         // sum up abundances over all charge states:
         for (map<Int, SampleAbundances>::iterator ab_it =
-               q_it->second.abundances.begin(); ab_it !=
-             q_it->second.abundances.end(); ++ab_it)
+               data.abundances.begin(); ab_it != data.abundances.end();
+             ++ab_it)
         {
           for (SampleAbundances::iterator samp_it = ab_it->second.begin();
                samp_it != ab_it->second.end(); ++samp_it)
           {
-            q_it->second.total_abundances[samp_it->first] += samp_it->second;
+            data.total_abundances[samp_it->first] += samp_it->second;
           }
         }
       }
-      if (!q_it->second.total_abundances.empty())
-        stats_.quant_peptides++;
+      if (!data.total_abundances.empty())
+        quant_peptides++;
     }
+    stats_.quant_peptides += quant_peptides;
 
     if ((stats_.n_samples > 1) &&
         (param_.getValue("consensus:normalize") == "true"))
@@ -359,12 +374,25 @@ namespace OpenMS
     bool include_all = param_.getValue("include_all") == "true";
     bool fix_peptides = param_.getValue("consensus:fix_peptides") == "true";
 
+    // proteins are aggregated independently of each other (in parallel):
+    vector<ProteinQuant::iterator> prot_its;
+    prot_its.reserve(prot_quant_.size());
     for (ProteinQuant::iterator prot_it = prot_quant_.begin();
          prot_it != prot_quant_.end(); ++prot_it)
     {
+      prot_its.push_back(prot_it);
+    }
+
+    Size too_few_peptides = 0, quant_proteins = 0;
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic, 16) reduction(+: too_few_peptides, quant_proteins)
+#endif
+    for (SignedSize i = 0; i < SignedSize(prot_its.size()); ++i)
+    {
+      ProteinQuant::iterator prot_it = prot_its[i];
       if ((top > 0) && (prot_it->second.abundances.size() < top))
       {
-        stats_.too_few_peptides++;
+        too_few_peptides++;
         if (!include_all)
           continue; // not enough proteotypic peptides
       }
@@ -457,9 +485,11 @@ namespace OpenMS
       }
 
       // update statistics:
-      if (prot_it->second.total_abundances.empty()) stats_.too_few_peptides++;
-      else stats_.quant_proteins++;
+      if (prot_it->second.total_abundances.empty()) too_few_peptides++;
+      else quant_proteins++;
     }
+    stats_.too_few_peptides += too_few_peptides;
+    stats_.quant_proteins += quant_proteins;
   }
 
 
@@ -581,4 +611,50 @@ namespace OpenMS
     return prot_quant_;
   }
 
+
+  PeptideAndProteinQuant::PeptideMatrix
+  PeptideAndProteinQuant::getPeptideMatrix() const
+  {
+    PeptideMatrix matrix;
+
+    // columns: all samples with at least one peptide abundance
+    set<UInt64> samples;
+    for (PeptideQuant::const_iterator q_it = pep_quant_.begin();
+         q_it != pep_quant_.end(); ++q_it)
+    {
+      if (q_it->second.total_abundances.empty()) continue; // not quantified
+      matrix.peptides.push_back(q_it->first);
+      for (SampleAbundances::const_iterator samp_it =
+             q_it->second.total_abundances.begin(); samp_it !=
+           q_it->second.total_abundances.end(); ++samp_it)
+      {
+        samples.insert(samp_it->first);
+      }
+    }
+    matrix.samples.assign(samples.begin(), samples.end());
+    map<UInt64, Size> sample_index;
+    for (Size col = 0; col < matrix.samples.size(); ++col)
+    {
+      sample_index[matrix.samples[col]] = col;
+    }
+
+    const Size n_cols = matrix.samples.size();
+    matrix.abundances.assign(matrix.peptides.size() * n_cols, 0.0);
+    Size row = 0;
+    for (PeptideQuant::const_iterator q_it = pep_quant_.begin();
+         q_it != pep_quant_.end(); ++q_it)
+    {
+      if (q_it->second.total_abundances.empty()) continue; // not quantified
+      double* values = &matrix.abundances[row * n_cols];
+      for (SampleAbundances::const_iterator samp_it =
+             q_it->second.total_abundances.begin(); samp_it !=
+           q_it->second.total_abundances.end(); ++samp_it)
+      {
+        values[sample_index[samp_it->first]] = samp_it->second;
+      }
+      ++row;
+    }
+    return matrix;
+  }
+
 }
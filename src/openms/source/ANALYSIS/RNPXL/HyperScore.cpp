@@ -33,6 +33,7 @@
 // --------------------------------------------------------------------------
 
 #include <OpenMS/ANALYSIS/RNPXL/HyperScore.h>
+#include <OpenMS/ANALYSIS/RNPXL/TheoreticalSpectrumBatch.h>
 
 #include <OpenMS/KERNEL/MSSpectrum.h>
 #include <OpenMS/KERNEL/MSExperiment.h>
@@ -114,5 +115,85 @@ namespace OpenMS
       return hyperScore;
     }
 
+  void HyperScore::compute(double fragment_mass_tolerance, bool fragment_mass_tolerance_unit_ppm, const PeakSpectrum& exp_spectrum, const TheoreticalSpectrumBatch& theo_spectra, std::vector<double>& scores)
+  {
+    scores.assign(theo_spectra.size(), 0.0);
+    if (theo_spectra.empty()) { return; }
+
+    if (exp_spectrum.size() < 1)
+    {
+      std::cout << "Warning: HyperScore: One of the given spectra is empty." << std::endl;
+      return;
+    }
+
+    const Size n_e = exp_spectrum.size();
+    vector<double> exp_mz(n_e), exp_intensity(n_e);
+    for (Size e = 0; e < n_e; ++e)
+    {
+      exp_mz[e] = exp_spectrum[e].getMZ();
+      exp_intensity[e] = exp_spectrum[e].getIntensity();
+    }
+
+    const Size n_t = theo_spectra.getNumberOfPeaks();
+    const double* theo_mz = theo_spectra.getMZArray().data();
+    const float* theo_intensity = theo_spectra.getIntensityArray().data();
+    const double* e_mz = exp_mz.data();
+    const double* e_intensity = exp_intensity.data();
+
+    // match the theoretical peaks of all spectra: nearest experimental peak (as in MSSpectrum::findNearest) and
+    // its contribution to the dot product. No data-dependent branches, so this loop can be vectorized.
+    vector<double> contribution(n_t);
+    vector<char> matched(n_t);
+    for (Size i = 0; i < n_t; ++i)
+    {
+      const double mz = theo_mz[i];
+      const double max_dist_dalton = fragment_mass_tolerance_unit_ppm ? mz * fragment_mass_tolerance * 1e-6 : fragment_mass_tolerance;
+
+      const Size lower = TheoreticalSpectrumBatch::partitionPoint(e_mz, n_e, [mz](double x) { return x < mz; });
+      const Size right = lower < n_e ? lower : n_e - 1;
+      const Size left = lower > 0 ? lower - 1 : 0;
+      const Size index = std::fabs(e_mz[right] - mz) < std::fabs(e_mz[left] - mz) ? right : left;
+
+      const bool match = std::fabs(mz - e_mz[index]) < max_dist_dalton;
+      contribution[i] = match ? e_intensity[index] * static_cast<double>(theo_intensity[i]) : 0.0;
+      matched[i] = match;
+    }
+
+    // sum up per spectrum
+    const vector<Size>& offsets = theo_spectra.getOffsets();
+    const vector<char>& ion_types = theo_spectra.getIonTypeArray();
+    for (Size s = 0; s < theo_spectra.size(); ++s)
+    {
+      if (offsets[s] == offsets[s + 1])
+      {
+        std::cout << "Warning: HyperScore: One of the given spectra is empty." << std::endl;
+        continue;
+      }
+      if (!theo_spectra.isAnnotated(s))
+      {
+        std::cout << "Error: HyperScore: Theoretical spectrum without StringDataArray (\"IonNames\" annotation) provided." << std::endl;
+        continue;
+      }
+
+      double dot_product = 0.0;
+      UInt y_ion_count = 0;
+      UInt b_ion_count = 0;
+      for (Size i = offsets[s]; i < offsets[s + 1]; ++i)
+      {
+        if (!matched[i]) { continue; }
+        dot_product += contribution[i];
+        if (ion_types[i] == 'y')
+        {
+          ++y_ion_count;
+        }
+        else if (ion_types[i] == 'b')
+        {
+          ++b_ion_count;
+        }
+      }
+      scores[s] = log1p(dot_product) + logfactorial_(y_ion_count) + logfactorial_(b_ion_count);
+    }
+  }
+
 }
 
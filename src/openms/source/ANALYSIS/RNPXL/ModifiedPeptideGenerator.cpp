@@ -33,12 +33,56 @@
 // --------------------------------------------------------------------------
 
 #include <OpenMS/ANALYSIS/RNPXL/ModifiedPeptideGenerator.h>
+#include <OpenMS/CONCEPT/Exception.h>
+
+#include <algorithm>
 
 using std::vector;
 using std::map;
 
 namespace OpenMS
 {
+  const int ModifiedPeptideGenerator::N_TERM_MODIFICATION_INDEX = -1;
+  const int ModifiedPeptideGenerator::C_TERM_MODIFICATION_INDEX = -2;
+
+  namespace
+  {
+    // state of the branch-and-bound enumeration in enumerateVariableModifications()
+    struct MassEnumeration
+    {
+      vector<vector<double> > deltas; // weight differences of the compatible modifications per site
+      vector<double> lower; // smallest weight change achievable by the sites [i, end)
+      vector<double> upper; // largest weight change achievable by the sites [i, end)
+      double min_mass;
+      double max_mass;
+    };
+
+    void enumerateMassesRecursively(const MassEnumeration& e, Size site, Size mods_left, double mass, UInt64 mask, UInt64 choice, UInt64 radix, vector<ModifiedPeptideGenerator::ModifiedPeptideMass>& candidates)
+    {
+      // no combination of the remaining sites can reach the mass window
+      if (mass + e.lower[site] > e.max_mass || mass + e.upper[site] < e.min_mass) return;
+
+      if (site == e.deltas.size() || mods_left == 0)
+      {
+        if (mask != 0 && mass >= e.min_mass && mass <= e.max_mass)
+        {
+          ModifiedPeptideGenerator::ModifiedPeptideMass candidate = {mass, mask, choice};
+          candidates.push_back(candidate);
+        }
+        return;
+      }
+
+      // leave the site unmodified
+      enumerateMassesRecursively(e, site + 1, mods_left, mass, mask, choice, radix, candidates);
+
+      // place each compatible modification at the site
+      const vector<double>& deltas = e.deltas[site];
+      for (Size m = 0; m < deltas.size(); ++m)
+      {
+        enumerateMassesRecursively(e, site + 1, mods_left - 1, mass + deltas[m], mask | (UInt64(1) << site), choice + m * radix, radix * deltas.size(), candidates);
+      }
+    }
+  }
 
   // static
   void ModifiedPeptideGenerator::applyFixedModifications(const vector<ResidueModification>::const_iterator& fixed_mods_begin, const vector<ResidueModification>::const_iterator& fixed_mods_end, AASequence& peptide)
@@ -119,9 +163,6 @@ namespace OpenMS
       return;
     }
 
-    const int N_TERM_MODIFICATION_INDEX = -1; // magic constant to distinguish N_TERM only modifications from ANYWHERE modifications placed at N-term residue
-    const int C_TERM_MODIFICATION_INDEX = -2; // magic constant to distinguish C_TERM only modifications from ANYWHERE modifications placed at C-term residue
-
     //keep a list of all possible modifications of this peptide
     vector<AASequence> modified_peptides;
 
@@ -134,7 +175,67 @@ namespace OpenMS
     //iterate over each residue and build compatibility mapping describing
     //which amino acid (peptide index) is compatible with which modification
     map<int, vector<ResidueModification> > map_compatibility;
+    getCompatibilityMap_(var_mods_begin, var_mods_end, peptide, map_compatibility);
 
+    // Check if no compatible site that can be modified by variable
+    // modification. If so just return peptides without variable modifications.
+    const Size compatible_mod_sites = map_compatibility.size();
+    if (compatible_mod_sites == 0)
+    {
+      if (keep_unmodified)
+      {
+        all_modified_peptides.push_back(peptide);
+      }
+      return;
+    }
+
+    // generate powerset of max_variable_mods_per_peptide sized subset of all compatible modification sites
+    Size max_placements = std::min(max_variable_mods_per_peptide, compatible_mod_sites);
+    for (Size n_var_mods = 1; n_var_mods <= max_placements; ++n_var_mods)
+    {
+      // enumerate all modified peptides with n_var_mods variable modified residues
+      Size zeros = std::max((Size)0, compatible_mod_sites - n_var_mods);
+      vector<bool> subset_mask;
+
+      for (Size i = 0; i != compatible_mod_sites; ++i)
+      {
+        // create mask 000011 to select last (e.g. n_var_mods = 2) two compatible sites as subset from the set of all compatible sites
+        if (i < zeros)
+        {
+          subset_mask.push_back(false);
+        }
+        else
+        {
+          subset_mask.push_back(true);
+        }
+      }
+
+      // generate all subsets of compatible sites {000011, ... , 101000, 110000} with current number of allowed variable modifications per peptide
+      do
+      {
+        // create subset indices e.g.{4,12} from subset mask e.g. 1010000 corresponding to the positions in the peptide sequence
+        vector<int> subset_indices;
+        map<int, vector<ResidueModification> >::const_iterator mit = map_compatibility.begin();
+        for (Size i = 0; i != compatible_mod_sites; ++i, ++mit)
+        {
+          if (subset_mask[i])
+          {
+            subset_indices.push_back(mit->first);
+          }
+        }
+
+        // now enumerate all modifications
+        recurseAndGenerateVariableModifiedPeptides_(subset_indices, map_compatibility, 0, peptide, modified_peptides);
+      } while (next_permutation(subset_mask.begin(), subset_mask.end()));
+    }
+    // add modified version of the current peptide to the list of all peptides
+    all_modified_peptides.insert(all_modified_peptides.end(), modified_peptides.begin(), modified_peptides.end());
+  }
+
+
+  // static
+  void ModifiedPeptideGenerator::getCompatibilityMap_(const vector<ResidueModification>::const_iterator& var_mods_begin, const vector<ResidueModification>::const_iterator& var_mods_end, const AASequence& peptide, map<int, vector<ResidueModification> >& map_compatibility)
+  {
     // set terminal modifications for modifications without amino acid preference
     for (vector<ResidueModification>::const_iterator variable_it = var_mods_begin; variable_it != var_mods_end; ++variable_it)
     {
@@ -191,69 +292,104 @@ namespace OpenMS
         }
       }
     }
+  }
 
-    // Check if no compatible site that can be modified by variable
-    // modification. If so just return peptides without variable modifications.
-    const Size compatible_mod_sites = map_compatibility.size();
-    if (compatible_mod_sites == 0)
+  // static
+  void ModifiedPeptideGenerator::getVariableModificationSites(const vector<ResidueModification>::const_iterator& var_mods_begin, const vector<ResidueModification>::const_iterator& var_mods_end, const AASequence& peptide, VariableModificationSites& sites)
+  {
+    map<int, vector<ResidueModification> > map_compatibility;
+    getCompatibilityMap_(var_mods_begin, var_mods_end, peptide, map_compatibility);
+
+    sites.positions.clear();
+    sites.modifications.clear();
+    for (map<int, vector<ResidueModification> >::const_iterator mit = map_compatibility.begin(); mit != map_compatibility.end(); ++mit)
     {
-      if (keep_unmodified)
+      sites.positions.push_back(mit->first);
+      sites.modifications.push_back(mit->second);
+    }
+  }
+
+  // static
+  void ModifiedPeptideGenerator::enumerateVariableModifications(const AASequence& peptide, const VariableModificationSites& sites, Size max_variable_mods_per_peptide, vector<ModifiedPeptideMass>& candidates, bool keep_unmodified, double min_mass, double max_mass)
+  {
+    candidates.clear();
+    const double unmodified_weight = peptide.getMonoWeight();
+    if (keep_unmodified && unmodified_weight >= min_mass && unmodified_weight <= max_mass)
+    {
+      ModifiedPeptideMass candidate = {unmodified_weight, 0, 0};
+      candidates.push_back(candidate);
+    }
+
+    const Size n_sites = sites.positions.size();
+    if (n_sites == 0 || max_variable_mods_per_peptide == 0)
+    {
+      return;
+    }
+    if (n_sites > 64)
+    {
+      throw Exception::IllegalArgument(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "At most 64 sites compatible with variable modifications are supported, peptide '" + peptide.toString() + "' has " + String(n_sites) + ".");
+    }
+
+    MassEnumeration e;
+    e.min_mass = min_mass;
+    e.max_mass = max_mass;
+    e.deltas.resize(n_sites);
+    e.lower.assign(n_sites + 1, 0.0);
+    e.upper.assign(n_sites + 1, 0.0);
+    for (Size i = 0; i < n_sites; ++i)
+    {
+      for (vector<ResidueModification>::const_iterator mod_it = sites.modifications[i].begin(); mod_it != sites.modifications[i].end(); ++mod_it)
       {
-        all_modified_peptides.push_back(peptide);
+        e.deltas[i].push_back(mod_it->getDiffMonoMass());
       }
-      return;
+    }
+    // bounds ignore the limit on the number of modifications, they are only used for pruning
+    for (Size i = n_sites; i > 0; --i)
+    {
+      const vector<double>& deltas = e.deltas[i - 1];
+      e.lower[i - 1] = e.lower[i] + std::min(0.0, *std::min_element(deltas.begin(), deltas.end()));
+      e.upper[i - 1] = e.upper[i] + std::max(0.0, *std::max_element(deltas.begin(), deltas.end()));
     }
 
-    // generate powerset of max_variable_mods_per_peptide sized subset of all compatible modification sites
-    Size max_placements = std::min(max_variable_mods_per_peptide, compatible_mod_sites);
-    for (Size n_var_mods = 1; n_var_mods <= max_placements; ++n_var_mods)
+    enumerateMassesRecursively(e, 0, max_variable_mods_per_peptide, unmodified_weight, 0, 0, 1, candidates);
+
+    std::stable_sort(candidates.begin(), candidates.end(),
+      [](const ModifiedPeptideMass& a, const ModifiedPeptideMass& b) { return a.mono_weight < b.mono_weight; });
+  }
+
+  // static
+  AASequence ModifiedPeptideGenerator::createModifiedPeptide(const AASequence& peptide, const VariableModificationSites& sites, const ModifiedPeptideMass& candidate)
+  {
+    AASequence modified_peptide = peptide;
+    UInt64 choice = candidate.modification_choice;
+    for (Size i = 0; i < sites.positions.size() && i < 64; ++i)
     {
-      // enumerate all modified peptides with n_var_mods variable modified residues
-      Size zeros = std::max((Size)0, compatible_mod_sites - n_var_mods);
-      vector<bool> subset_mask;
+      if ((candidate.site_mask & (UInt64(1) << i)) == 0) continue;
 
-      for (Size i = 0; i != compatible_mod_sites; ++i)
+      const vector<ResidueModification>& mods = sites.modifications[i];
+      const ResidueModification& mod = mods[choice % mods.size()];
+      choice /= mods.size();
+
+      const int current_index = sites.positions[i];
+      if (current_index == C_TERM_MODIFICATION_INDEX)
       {
-        // create mask 000011 to select last (e.g. n_var_mods = 2) two compatible sites as subset from the set of all compatible sites
-        if (i < zeros)
-        {
-          subset_mask.push_back(false);
-        }
-        else
-        {
-          subset_mask.push_back(true);
-        }
+        modified_peptide.setCTerminalModification(mod.getFullName());
       }
-
-      // generate all subsets of compatible sites {000011, ... , 101000, 110000} with current number of allowed variable modifications per peptide
-      do
+      else if (current_index == N_TERM_MODIFICATION_INDEX)
       {
-        // create subset indices e.g.{4,12} from subset mask e.g. 1010000 corresponding to the positions in the peptide sequence
-        vector<int> subset_indices;
-        map<int, vector<ResidueModification> >::const_iterator mit = map_compatibility.begin();
-        for (Size i = 0; i != compatible_mod_sites; ++i, ++mit)
-        {
-          if (subset_mask[i])
-          {
-            subset_indices.push_back(mit->first);
-          }
-        }
-
-        // now enumerate all modifications
-        recurseAndGenerateVariableModifiedPeptides_(subset_indices, map_compatibility, 0, peptide, modified_peptides);
-      } while (next_permutation(subset_mask.begin(), subset_mask.end()));
+        modified_peptide.setNTerminalModification(mod.getFullName());
+      }
+      else
+      {
+        modified_peptide.setModification(current_index, mod.getFullName());
+      }
     }
-    // add modified version of the current peptide to the list of all peptides
-    all_modified_peptides.insert(all_modified_peptides.end(), modified_peptides.begin(), modified_peptides.end());
+    return modified_peptide;
   }
 
-
   // static
   void ModifiedPeptideGenerator::recurseAndGenerateVariableModifiedPeptides_(const vector<int>& subset_indices, const map<int, vector<ResidueModification> >& map_compatibility, int depth, const AASequence& current_peptide, vector<AASequence>& modified_peptides)
   {
-    const int N_TERM_MODIFICATION_INDEX = -1; // magic constant to distinguish N_TERM only modifications from ANYWHERE modifications placed at N-term residue
-    const int C_TERM_MODIFICATION_INDEX = -2; // magic constant to distinguish C_TERM only modifications from ANYWHERE modifications placed at C-term residue
-
     // cout << depth << " " << subset_indices.size() << " " << current_peptide.toString() << endl;
 
     // end of recursion. Add the modified peptide and return
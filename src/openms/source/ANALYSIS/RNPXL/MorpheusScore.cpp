@@ -33,7 +33,9 @@
 // --------------------------------------------------------------------------
 
 #include <OpenMS/ANALYSIS/RNPXL/MorpheusScore.h>
+#include <OpenMS/ANALYSIS/RNPXL/TheoreticalSpectrumBatch.h>
 #include <OpenMS/KERNEL/MSSpectrum.h>
+#include <algorithm>
 #include <cmath>
 
 namespace OpenMS
@@ -116,5 +118,70 @@ namespace OpenMS
     psm.err = matches > 0 ? sum_error / static_cast<double>(matches) : 1e10;
     return psm;
   }
-}
 
+  void MorpheusScore::compute(double fragment_mass_tolerance,
+                              bool fragment_mass_tolerance_unit_ppm,
+                              const PeakSpectrum& exp_spectrum,
+                              const TheoreticalSpectrumBatch& theo_spectra,
+                              std::vector<MorpheusScore::Result>& results)
+  {
+    results.assign(theo_spectra.size(), MorpheusScore::Result());
+
+    const Size n_e(exp_spectrum.size());
+    if (theo_spectra.empty() || n_e == 0) { return; }
+
+    std::vector<double> exp_mz(n_e), exp_intensity(n_e);
+    double total_intensity(0);
+    for (Size e = 0; e < n_e; ++e)
+    {
+      exp_mz[e] = exp_spectrum[e].getMZ();
+      exp_intensity[e] = exp_spectrum[e].getIntensity();
+      total_intensity += exp_intensity[e];
+    }
+
+    // range of experimental peaks in the tolerance window of each theoretical peak of all spectra
+    // (no data-dependent branches, so this loop can be vectorized)
+    const Size n_t = theo_spectra.getNumberOfPeaks();
+    const double* theo_mz = theo_spectra.getMZArray().data();
+    const double* e_mz = exp_mz.data();
+    std::vector<Size> window_begin(n_t), window_end(n_t);
+    for (Size i = 0; i < n_t; ++i)
+    {
+      const double mz = theo_mz[i];
+      const double max_dist_dalton = fragment_mass_tolerance_unit_ppm ? mz * fragment_mass_tolerance * 1e-6 : fragment_mass_tolerance;
+      window_begin[i] = TheoreticalSpectrumBatch::partitionPoint(e_mz, n_e, [mz, max_dist_dalton](double x) { return mz - x > max_dist_dalton; });
+      window_end[i] = TheoreticalSpectrumBatch::partitionPoint(e_mz, n_e, [mz, max_dist_dalton](double x) { return x - mz <= max_dist_dalton; });
+    }
+
+    const std::vector<Size>& offsets = theo_spectra.getOffsets();
+    for (Size s = 0; s < theo_spectra.size(); ++s)
+    {
+      if (offsets[s] == offsets[s + 1]) { continue; }
+
+      // every theoretical peak with experimental peaks in its window is counted once, every
+      // experimental peak contributes once (with the mass error to the first theoretical peak it matches)
+      Size matches(0), next_exp(0);
+      double match_intensity(0.0);
+      double sum_error(0.0);
+      for (Size i = offsets[s]; i < offsets[s + 1]; ++i)
+      {
+        if (window_begin[i] >= window_end[i]) { continue; }
+        ++matches;
+        for (Size e = std::max(window_begin[i], next_exp); e < window_end[i]; ++e)
+        {
+          match_intensity += exp_intensity[e];
+          sum_error += fabs(e_mz[e] - theo_mz[i]);
+        }
+        next_exp = std::max(next_exp, window_end[i]);
+      }
+
+      MorpheusScore::Result& psm = results[s];
+      psm.score = static_cast<double>(matches) + match_intensity / total_intensity;
+      psm.n_peaks = offsets[s + 1] - offsets[s];
+      psm.matches = matches;
+      psm.MIC = match_intensity;
+      psm.TIC = total_intensity;
+      psm.err = matches > 0 ? sum_error / static_cast<double>(matches) : 1e10;
+    }
+  }
+}
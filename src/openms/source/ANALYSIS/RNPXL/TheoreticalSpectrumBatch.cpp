@@ -0,0 +1,148 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2018.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: Timo Sachsenberg $
+// $Authors: Timo Sachsenberg $
+// --------------------------------------------------------------------------
+
+#include <OpenMS/ANALYSIS/RNPXL/TheoreticalSpectrumBatch.h>
+
+#include <OpenMS/KERNEL/MSSpectrum.h>
+
+namespace OpenMS
+{
+  TheoreticalSpectrumBatch::TheoreticalSpectrumBatch() :
+    offsets_(1, 0)
+  {
+  }
+
+  Size TheoreticalSpectrumBatch::add(const PeakSpectrum& theo_spectrum)
+  {
+    // TODO this assumes only one StringDataArray is present and it is the right one (same as HyperScore)
+    const PeakSpectrum::StringDataArray* ion_names = theo_spectrum.getStringDataArrays().empty() ? nullptr : &theo_spectrum.getStringDataArrays()[0];
+
+    for (Size i = 0; i < theo_spectrum.size(); ++i)
+    {
+      mz_.push_back(theo_spectrum[i].getMZ());
+      intensity_.push_back(theo_spectrum[i].getIntensity());
+
+      char ion_type = 0;
+      if (ion_names != nullptr && i < ion_names->size() && !(*ion_names)[i].empty())
+      {
+        // fragment annotations in XL-MS data are more complex and do not start with the ion type, but the ion type always follows after a $
+        const String& name = (*ion_names)[i];
+        if (name[0] == 'y' || name.hasSubstring("$y"))
+        {
+          ion_type = 'y';
+        }
+        else if (name[0] == 'b' || name.hasSubstring("$b"))
+        {
+          ion_type = 'b';
+        }
+      }
+      ion_type_.push_back(ion_type);
+    }
+    offsets_.push_back(mz_.size());
+    annotated_.push_back(ion_names != nullptr);
+    return annotated_.size() - 1;
+  }
+
+  Size TheoreticalSpectrumBatch::add(const std::vector<TheoreticalSpectrumGenerator::FragmentIon>& fragment_ions)
+  {
+    for (const TheoreticalSpectrumGenerator::FragmentIon& ion : fragment_ions)
+    {
+      mz_.push_back(ion.mz);
+      intensity_.push_back(ion.intensity);
+      ion_type_.push_back((ion.ion_type == 'y' || ion.ion_type == 'b') ? ion.ion_type : 0);
+    }
+    offsets_.push_back(mz_.size());
+    annotated_.push_back(true);
+    return annotated_.size() - 1;
+  }
+
+  void TheoreticalSpectrumBatch::clear()
+  {
+    mz_.clear();
+    intensity_.clear();
+    ion_type_.clear();
+    offsets_.resize(1);
+    annotated_.clear();
+  }
+
+  void TheoreticalSpectrumBatch::reserve(Size spectra, Size peaks)
+  {
+    mz_.reserve(peaks);
+    intensity_.reserve(peaks);
+    ion_type_.reserve(peaks);
+    offsets_.reserve(spectra + 1);
+    annotated_.reserve(spectra);
+  }
+
+  Size TheoreticalSpectrumBatch::size() const
+  {
+    return annotated_.size();
+  }
+
+  bool TheoreticalSpectrumBatch::empty() const
+  {
+    return annotated_.empty();
+  }
+
+  Size TheoreticalSpectrumBatch::getNumberOfPeaks() const
+  {
+    return mz_.size();
+  }
+
+  const std::vector<double>& TheoreticalSpectrumBatch::getMZArray() const
+  {
+    return mz_;
+  }
+
+  const std::vector<float>& TheoreticalSpectrumBatch::getIntensityArray() const
+  {
+    return intensity_;
+  }
+
+  const std::vector<char>& TheoreticalSpectrumBatch::getIonTypeArray() const
+  {
+    return ion_type_;
+  }
+
+  const std::vector<Size>& TheoreticalSpectrumBatch::getOffsets() const
+  {
+    return offsets_;
+  }
+
+  bool TheoreticalSpectrumBatch::isAnnotated(Size index) const
+  {
+    return annotated_[index];
+  }
+}
+
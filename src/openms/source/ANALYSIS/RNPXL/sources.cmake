@@ -11,6 +11,7 @@ RNPxlFragmentAnnotationHelper.cpp
 RNPxlMarkerIonExtractor.cpp
 RNPxlModificationsGenerator.cpp
 RNPxlReport.cpp
+TheoreticalSpectrumBatch.cpp
 )
 
 ### add path to the filenames
@@ -50,6 +50,140 @@ using boost::math::cdf;
 namespace OpenMS
 {
 
+  namespace
+  {
+    /*
+      Positions (in the training data) of the support vectors of a model that
+      was trained on a precomputed kernel. libsvm stores the 1-based serial
+      number of the training sample in the first node of each support vector.
+      Returns false if a serial number does not refer to one of the
+      'nr_training' training samples.
+    */
+    bool getPrecomputedSVIndices_(const svm_model* model, Size nr_training, vector<Size>& sv_indices)
+    {
+      sv_indices.resize(model->l);
+      for (Int k = 0; k < model->l; ++k)
+      {
+        const double serial = model->SV[k][0].value;
+        if (serial < 1 || serial > nr_training)
+        {
+          return false;
+        }
+        sv_indices[k] = (Size) serial - 1;
+      }
+      return true;
+    }
+
+    /*
+      Evaluates a precomputed kernel model sample by sample. For precomputed
+      kernels libsvm only reads the kernel values of the support vectors from a
+      row, so only those are computed and the full kernel matrix between the
+      samples and the training data is never built. The rows are filled in
+      parallel, each thread reuses a single row buffer.
+
+      'kernel(i, t)' returns the kernel value of sample i and training sample t,
+      'predict(i, row)' evaluates the model on the row of sample i.
+    */
+    template <typename KernelFunction, typename PredictFunction>
+    void predictOnSupportVectors_(Size nr_samples, Size nr_training, const vector<Size>& sv_indices,
+                                  const KernelFunction& kernel, const PredictFunction& predict)
+    {
+#ifdef _OPENMP
+#pragma omp parallel
+#endif
+      {
+        vector<svm_node> row(nr_training + 2);
+        for (Size j = 0; j <= nr_training; ++j)
+        {
+          row[j].index = (Int) j;
+          row[j].value = 0;
+        }
+        row[nr_training + 1].index = -1;
+
+#ifdef _OPENMP
+#pragma omp for schedule(dynamic, 16)
+#endif
+        for (SignedSize i = 0; i < (SignedSize) nr_samples; ++i)
+        {
+          row[0].value = (double) i + 1;
+          for (Size k = 0; k < sv_indices.size(); ++k)
+          {
+            row[sv_indices[k] + 1].value = kernel((Size) i, sv_indices[k]);
+          }
+          predict((Size) i, &row[0]);
+        }
+      }
+    }
+
+    /*
+      Predicts 'count' sparse vectors. Models with a linear kernel (regression,
+      one-class and two-class classification) are collapsed into a single dense
+      weight vector w = sum_i coef_i * SV_i, so each prediction is one sparse
+      dot product instead of one per support vector (identical to svm_predict
+      up to rounding). All other models are evaluated with svm_predict in
+      parallel.
+    */
+    void predictVectors_(const svm_model* model, svm_node* const* vectors, Size count, vector<double>& results)
+    {
+      results.resize(count);
+
+      const Int svm_type = model->param.svm_type;
+      const bool regression = (svm_type == EPSILON_SVR || svm_type == NU_SVR);
+      if (model->param.kernel_type == LINEAR && (regression || svm_type == ONE_CLASS || model->nr_class == 2))
+      {
+        vector<double> weights;
+        for (Int k = 0; k < model->l; ++k)
+        {
+          for (const svm_node* node = model->SV[k]; node->index != -1; ++node)
+          {
+            if ((Size) node->index >= weights.size())
+            {
+              weights.resize(node->index + 1, 0.0);
+            }
+            weights[node->index] += model->sv_coef[0][k] * node->value;
+          }
+        }
+        const double rho = model->rho[0];
+
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
+        for (SignedSize i = 0; i < (SignedSize) count; ++i)
+        {
+          double decision_value = -rho;
+          for (const svm_node* node = vectors[i]; node->index != -1; ++node)
+          {
+            if ((Size) node->index < weights.size())
+            {
+              decision_value += weights[node->index] * node->value;
+            }
+          }
+          if (regression)
+          {
+            results[i] = decision_value;
+          }
+          else if (svm_type == ONE_CLASS)
+          {
+            results[i] = (decision_value > 0) ? 1 : -1;
+          }
+          else
+          {
+            results[i] = (decision_value > 0) ? model->label[0] : model->label[1];
+          }
+        }
+        return;
+      }
+
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
+      for (SignedSize i = 0; i < (SignedSize) count; ++i)
+      {
+        results[i] = svm_predict(model, vectors[i]);
+      }
+    }
+  }
+
   SVMData::SVMData() :
     sequences(std::vector<std::vector<std::pair<Int, double> > >()),
     labels(std::vector<double>())
@@ -524,6 +658,20 @@ namespace OpenMS
 
     if (model_ != nullptr && problem != nullptr)
     {
+      vector<Size> sv_indices;
+      if (kernel_type_ == OLIGO && training_set_ != nullptr
+         && getPrecomputedSVIndices_(model_, training_set_->l, sv_indices))
+      {
+        const svm_problem* training_set = training_set_;
+        const vector<double>& gauss_table = gauss_table_;
+        const svm_model* model = model_;
+        results.resize(problem->l);
+        predictOnSupportVectors_(problem->l, training_set->l, sv_indices,
+          [&](Size i, Size t) { return SVMWrapper::kernelOligo(problem->x[i], training_set->x[t], gauss_table); },
+          [&](Size i, const svm_node* row) { results[i] = svm_predict(model, row); });
+        return;
+      }
+
       if (kernel_type_ == OLIGO)
       {
         if (training_set_ != nullptr)
@@ -531,12 +679,7 @@ namespace OpenMS
           problem = computeKernelMatrix(problem, training_set_);
         }
       }
-      results.reserve(problem->l);
-      for (Int i = 0; i < problem->l; i++)
-      {
-        double label = svm_predict(model_, problem->x[i]);
-        results.push_back(label);
-      }
+      predictVectors_(model_, problem->x, problem->l, results);
 
       if (kernel_type_ == OLIGO)
       {
@@ -565,6 +708,19 @@ namespace OpenMS
       }
       else if (model_ != nullptr)
       {
+        vector<Size> sv_indices;
+        if (getPrecomputedSVIndices_(model_, training_data_.sequences.size(), sv_indices))
+        {
+          const SVMData& training_data = training_data_;
+          const vector<double>& gauss_table = gauss_table_;
+          const svm_model* model = model_;
+          results.resize(problem.sequences.size());
+          predictOnSupportVectors_(problem.sequences.size(), training_data.sequences.size(), sv_indices,
+            [&](Size i, Size t) { return SVMWrapper::kernelOligo(problem.sequences[i], training_data.sequences[t], gauss_table); },
+            [&](Size i, const svm_node* row) { results[i] = svm_predict(model, row); });
+          return;
+        }
+
         struct svm_problem* prediction_problem = computeKernelMatrix(problem, training_data_);
         for (Size i = 0; i < problem.sequences.size(); i++)
         {
@@ -1296,13 +1452,9 @@ namespace OpenMS
   {
     results.clear();
 
-    if (model_ != nullptr)
+    if (model_ != nullptr && !vectors.empty())
     {
-      for (Size i = 0; i < vectors.size(); i++)
-      {
-        double label = svm_predict(model_, vectors[i]);
-        results.push_back(label);
-      }
+      predictVectors_(model_, &vectors[0], vectors.size(), results);
     }
   }
 
@@ -1335,6 +1487,27 @@ namespace OpenMS
 
     if (model_ != nullptr)
     {
+      vector<Size> sv_indices;
+      if (kernel_type_ == OLIGO && training_set_ != nullptr
+         && getPrecomputedSVIndices_(model_, training_set_->l, sv_indices))
+      {
+        const svm_problem* training_set = training_set_;
+        const vector<double>& gauss_table = gauss_table_;
+        const svm_model* model = model_;
+        const bool first_label_positive = (labels[0] >= 0);
+        probabilities.resize(problem->l);
+        prediction_labels.resize(problem->l);
+        predictOnSupportVectors_(problem->l, training_set->l, sv_indices,
+          [&](Size i, Size t) { return SVMWrapper::kernelOligo(problem->x[i], training_set->x[t], gauss_table); },
+          [&](Size i, const svm_node* row)
+          {
+            double prob_estimates[2] = {-1, -1};
+            prediction_labels[i] = svm_predict_probability(model, row, prob_estimates);
+            probabilities[i] = first_label_positive ? prob_estimates[0] : 1 - prob_estimates[0];
+          });
+        return;
+      }
+
       if (kernel_type_ == OLIGO)
       {
         if (training_set_ != nullptr)
@@ -409,6 +409,9 @@ namespace OpenMS
 //  std::cout << model.solver()->getNumCols()<<" columns has solution"<<std::endl;
 // #endif
     LPWrapper::SolverParam param;
+    // the model is updated and re-solved iteratively, so start from the
+    // previous solution if possible:
+    param.enable_warm_start = true;
     model_->solve(param);
 
     for (Int column = 0; column < model_->getNumberOfColumns(); ++column)
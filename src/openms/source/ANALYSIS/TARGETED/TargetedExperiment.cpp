@@ -317,6 +317,7 @@ namespace OpenMS
 
   void TargetedExperiment::setCompounds(const std::vector<Compound> & compounds)
   {
+    compound_reference_map_dirty_ = true;
     compounds_ = compounds;
   }
 
@@ -327,6 +328,7 @@ namespace OpenMS
 
   void TargetedExperiment::addCompound(const Compound & rhs)
   {
+    compound_reference_map_dirty_ = true;
     compounds_.push_back(rhs);
   }
 
@@ -0,0 +1,86 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2018.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: Eugen Netz $
+// $Authors: Eugen Netz $
+// --------------------------------------------------------------------------
+
+#include <OpenMS/ANALYSIS/XLMS/OPXLFragmentLadderCache.h>
+
+namespace OpenMS
+{
+  OPXLFragmentLadderCache::OPXLFragmentLadderCache(const TheoreticalSpectrumGeneratorXLMS& generator, Size max_size) :
+    generator_(&generator),
+    max_size_(max_size)
+  {
+  }
+
+  bool OPXLFragmentLadderCache::LadderKey_::operator<(const LadderKey_& other) const
+  {
+    // cheap comparisons first, the peptide comparison walks over the residues
+    if (link_pos != other.link_pos) return link_pos < other.link_pos;
+    if (link_pos_2 != other.link_pos_2) return link_pos_2 < other.link_pos_2;
+    if (frag_alpha != other.frag_alpha) return frag_alpha < other.frag_alpha;
+    if (charge != other.charge) return charge < other.charge;
+    return peptide < other.peptide;
+  }
+
+  OPXLFragmentLadderCache::LadderPtr OPXLFragmentLadderCache::getLinearIonSpectrum(const AASequence& peptide, Size link_pos, bool frag_alpha, int charge, Size link_pos_2)
+  {
+    LadderKey_ key{peptide, link_pos, link_pos_2, frag_alpha, charge};
+
+    std::map<LadderKey_, LadderPtr>::const_iterator it = ladders_.find(key);
+    if (it != ladders_.end())
+    {
+      return it->second;
+    }
+
+    std::shared_ptr<PeakSpectrum> ladder(new PeakSpectrum());
+    generator_->getLinearIonSpectrum(*ladder, key.peptide, link_pos, frag_alpha, charge, link_pos_2);
+
+    // ladders handed out before stay valid, they are shared with the caller
+    if (ladders_.size() >= max_size_)
+    {
+      ladders_.clear();
+    }
+    ladders_.emplace(std::move(key), ladder);
+    return ladder;
+  }
+
+  Size OPXLFragmentLadderCache::size() const
+  {
+    return ladders_.size();
+  }
+
+  void OPXLFragmentLadderCache::clear()
+  {
+    ladders_.clear();
+  }
+}
@@ -52,16 +52,23 @@ namespace OpenMS
     double min_precursor = spectrum_precursors[0];
     double max_precursor = spectrum_precursors[spectrum_precursors.size()-1];
 
-// Multithreading options: schedule: static, dynamic, guided
-// use OpenMP to run this for-loop on multiple CPU cores
-#ifdef _OPENMP
-#pragma omp parallel for schedule(static)
-#endif
-    for (SignedSize p1 = 0; p1 < static_cast<SignedSize>(peptides.size()); ++p1)
+    // tolerances at the borders of the precursor range
+    double allowed_error_min = precursor_mass_tolerance;
+    double allowed_error_max = precursor_mass_tolerance;
+    if (precursor_mass_tolerance_unit_ppm) // ppm
     {
-      // get the amino acid sequence of this peptide as a character string
-      String seq_first = peptides[p1].peptide_seq.toUnmodifiedString();
+      allowed_error_min = min_precursor * precursor_mass_tolerance * 1e-6;
+      allowed_error_max = max_precursor * precursor_mass_tolerance * 1e-6;
+    }
+
+    // window of second peptides for the current first peptide: [p2_low, p2_high)
+    // the peptides are sorted by mass, so both borders only move towards lighter peptides while walking
+    // through heavier first peptides and only the pairs within the precursor window are ever visited
+    Size p2_low = peptides.size();
+    Size p2_high = peptides.size();
 
+    for (Size p1 = 0; p1 < peptides.size(); ++p1)
+    {
       // generate mono-links: one cross-linker with one peptide attached to one side
       for (Size i = 0; i < cross_link_mass_mono_link.size(); i++)
       {
@@ -84,76 +91,68 @@ namespace OpenMS
         }
       }
 
-       // test if this peptide could have loop-links: one cross-link with both sides attached to the same peptide
-       // TODO check for distance between the two linked residues
-      bool first_res = false; // is there a residue the first side of the linker can attach to?
-      bool second_res = false; // is there a residue the second side of the linker can attach to?
-      for (Size k = 0; k < seq_first.size()-1; ++k)
+      // test if this peptide could have loop-links: one cross-link with both sides attached to the same peptide
+      // (only if the mass fits to the precursors at all, scanning the sequence is comparably expensive)
+      // TODO check for distance between the two linked residues
+      double loop_link_mass = peptides[p1].peptide_mass + cross_link_mass;
+      double loop_link_error = precursor_mass_tolerance_unit_ppm ? loop_link_mass * precursor_mass_tolerance * 1e-6 : precursor_mass_tolerance;
+      if (loop_link_mass + loop_link_error >= min_precursor && loop_link_mass - loop_link_error <= max_precursor)
       {
-        for (Size i = 0; i < cross_link_residue1.size(); ++i)
+        // get the amino acid sequence of this peptide as a character string
+        String seq_first = peptides[p1].peptide_seq.toUnmodifiedString();
+
+        bool first_res = false; // is there a residue the first side of the linker can attach to?
+        bool second_res = false; // is there a residue the second side of the linker can attach to?
+        for (Size k = 0; k < seq_first.size()-1; ++k)
         {
-          if (cross_link_residue1[i].size() == 1 && seq_first.substr(k, 1) == cross_link_residue1[i])
+          for (Size i = 0; i < cross_link_residue1.size(); ++i)
           {
-            first_res = true;
+            if (cross_link_residue1[i].size() == 1 && seq_first[k] == cross_link_residue1[i][0])
+            {
+              first_res = true;
+            }
           }
-        }
-        for (Size i = 0; i < cross_link_residue2.size(); ++i)
-        {
-          if (cross_link_residue2[i].size() == 1 && seq_first.substr(k, 1) == cross_link_residue2[i])
+          for (Size i = 0; i < cross_link_residue2.size(); ++i)
           {
-            second_res = true;
+            if (cross_link_residue2[i].size() == 1 && seq_first[k] == cross_link_residue2[i][0])
+            {
+              second_res = true;
+            }
           }
         }
-      }
-
-      // If both sides of a cross-linker can link to this peptide, generate the loop-link
-      if (first_res && second_res)
-      {
-        // Monoisotopic weight of the peptide + cross-linker
-        double cross_linked_pair_mass = peptides[p1].peptide_mass + cross_link_mass;
 
-        // also only one peptide
-        OPXLDataStructs::XLPrecursor precursor;
-        precursor.precursor_mass = cross_linked_pair_mass;
-        precursor.alpha_index = p1;
-        precursor.beta_index = peptides.size() + 1; // an out-of-range index to represent an empty index
-
-        // call function to compare with spectrum precursor masses
-        filter_and_add_candidate(mass_to_candidates, spectrum_precursors, precursor_correction_positions, precursor_mass_tolerance_unit_ppm, precursor_mass_tolerance, precursor);
+        // If both sides of a cross-linker can link to this peptide, generate the loop-link
+        if (first_res && second_res)
+        {
+          // also only one peptide
+          OPXLDataStructs::XLPrecursor precursor;
+          precursor.precursor_mass = loop_link_mass;
+          precursor.alpha_index = p1;
+          precursor.beta_index = peptides.size() + 1; // an out-of-range index to represent an empty index
+
+          // call function to compare with spectrum precursor masses
+          filter_and_add_candidate(mass_to_candidates, spectrum_precursors, precursor_correction_positions, precursor_mass_tolerance_unit_ppm, precursor_mass_tolerance, precursor);
+        }
       }
 
-      // check for minimal mass of second peptide, jump farther than current peptide if possible
-      double allowed_error = 0;
-      if (precursor_mass_tolerance_unit_ppm) // ppm
-      {
-        allowed_error = min_precursor * precursor_mass_tolerance * 1e-6;
-      }
-      else // Dalton
+      // allowed masses of the second peptide
+      double min_second_peptide_mass = min_precursor - cross_link_mass - peptides[p1].peptide_mass - allowed_error_min;
+      double max_second_peptide_mass = max_precursor - cross_link_mass - peptides[p1].peptide_mass + allowed_error_max;
+
+      // move the window: p2_low is the first peptide not too light, p2_high the first one too heavy
+      while (p2_high > 0 && peptides[p2_high - 1].peptide_mass > max_second_peptide_mass)
       {
-        allowed_error = precursor_mass_tolerance;
+        --p2_high;
       }
-      double min_second_peptide_mass = min_precursor - cross_link_mass - peptides[p1].peptide_mass - allowed_error;
-
-      if (precursor_mass_tolerance_unit_ppm) // ppm
+      while (p2_low > 0 && !(peptides[p2_low - 1].peptide_mass < min_second_peptide_mass))
       {
-        allowed_error = max_precursor * precursor_mass_tolerance * 1e-6;
+        --p2_low;
       }
-      double max_second_peptide_mass = max_precursor - cross_link_mass - peptides[p1].peptide_mass + allowed_error;
 
       // Generate cross-links: one cross-linker linking two separate peptides, the most important case
-      // Loop over all p2 peptide candidates, that come after p1 in the list
-      for (Size p2 = p1; p2 < peptides.size(); ++p2)
+      // Loop over all p2 peptide candidates within the window, that come after p1 in the list
+      for (Size p2 = std::max(p1, p2_low); p2 < p2_high; ++p2)
       {
-        // skip peptides, that are too small in any case
-        if (peptides[p2].peptide_mass < min_second_peptide_mass)
-        {
-          continue;
-        }
-        else if (peptides[p2].peptide_mass > max_second_peptide_mass)
-        {
-          break;
-        }
-
         // Monoisotopic weight of the first peptide + the second peptide + cross-linker
         double cross_linked_pair_mass = peptides[p1].peptide_mass + peptides[p2].peptide_mass + cross_link_mass;
 
@@ -167,7 +166,6 @@ namespace OpenMS
         filter_and_add_candidate(mass_to_candidates, spectrum_precursors, precursor_correction_positions, precursor_mass_tolerance_unit_ppm, precursor_mass_tolerance, precursor);
       }
     }
-    // cout << "Enumerated pairs with sequence " << countA << " of " << peptides.size() << ";\t Current pair count: " << mass_to_candidates.size() << " | current size in mb: " << mass_to_candidates.size() * sizeof(OPXLDataStructs::XLPrecursor) / 1024 / 1024 << endl;
     return mass_to_candidates;
   }
 
@@ -195,17 +193,9 @@ namespace OpenMS
 
     if (low_it != up_it) // if they are not equal, there are matching precursors in the data
     {
-      // found_matching_precursors = true;
-
-// don't access this vector from two processing threads at the same time
-#ifdef _OPENMP
-#pragma omp critical
-#endif
-      {
-        mass_to_candidates.push_back(precursor);
-        // take the position of the highest matching precursor mass in the vector (prioritize smallest correction)
-        precursor_correction_positions.push_back(std::distance(spectrum_precursors.begin(), std::prev(up_it, 1)));
-      }
+      mass_to_candidates.push_back(precursor);
+      // take the position of the highest matching precursor mass in the vector (prioritize smallest correction)
+      precursor_correction_positions.push_back(std::distance(spectrum_precursors.begin(), std::prev(up_it, 1)));
       return true;
     }
     else
@@ -1013,7 +1003,7 @@ namespace OpenMS
     }
   }
 
-  std::vector <OPXLDataStructs::ProteinProteinCrossLink> OPXLHelper::collectPrecursorCandidates(IntList precursor_correction_steps, double precursor_mass, double precursor_mass_tolerance, bool precursor_mass_tolerance_unit_ppm, vector<OPXLDataStructs::AASeqWithMass> filtered_peptide_masses, double cross_link_mass, DoubleList cross_link_mass_mono_link, StringList cross_link_residue1, StringList cross_link_residue2, String cross_link_name)
+  std::vector <OPXLDataStructs::ProteinProteinCrossLink> OPXLHelper::collectPrecursorCandidates(const IntList& precursor_correction_steps, double precursor_mass, double precursor_mass_tolerance, bool precursor_mass_tolerance_unit_ppm, const vector<OPXLDataStructs::AASeqWithMass>& filtered_peptide_masses, double cross_link_mass, const DoubleList& cross_link_mass_mono_link, const StringList& cross_link_residue1, const StringList& cross_link_residue2, const String& cross_link_name)
   {
     // determine candidates
     std::vector< OPXLDataStructs::XLPrecursor > candidates;
@@ -46,7 +46,7 @@ using namespace std;
 namespace OpenMS
 {
 
-  PeakSpectrum OPXLSpectrumProcessingAlgorithms::mergeAnnotatedSpectra(PeakSpectrum & first_spectrum, PeakSpectrum & second_spectrum)
+  PeakSpectrum OPXLSpectrumProcessingAlgorithms::mergeAnnotatedSpectra(const PeakSpectrum & first_spectrum, const PeakSpectrum & second_spectrum)
   {
     // merge peaks: create new spectrum, insert peaks from first and then from second spectrum
     PeakSpectrum resulting_spectrum;
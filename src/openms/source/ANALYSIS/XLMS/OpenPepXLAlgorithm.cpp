@@ -37,6 +37,7 @@
 #include <OpenMS/CHEMISTRY/ProteaseDB.h>
 #include <OpenMS/ANALYSIS/XLMS/OPXLSpectrumProcessingAlgorithms.h>
 #include <OpenMS/ANALYSIS/XLMS/OPXLHelper.h>
+#include <OpenMS/ANALYSIS/XLMS/OPXLFragmentLadderCache.h>
 #include <OpenMS/ANALYSIS/XLMS/XQuestScores.h>
 #include <OpenMS/KERNEL/SpectrumHelper.h>
 #include <OpenMS/FILTERING/TRANSFORMERS/NLargest.h>
@@ -398,6 +399,17 @@ using namespace OpenMS;
     progresslogger.startProgress(0, 1, "Matching to theoretical spectra and scoring...");
     Size spectrum_counter = 0;
 
+    // the top hits of each pair are only written by the thread processing the pair and collected after the loop
+    vector< vector< OPXLDataStructs::CrossLinkSpectrumMatch > > top_csms_per_pair(spectrum_pairs.size());
+
+    // one cache of linear fragment ladders per thread, the same peptides occur in the candidates of many spectra
+    Size num_threads = 1;
+#ifdef _OPENMP
+    num_threads = omp_get_max_threads();
+#endif
+    vector<OPXLFragmentLadderCache> ladder_caches(num_threads, OPXLFragmentLadderCache(specGen));
+    const OPXLFragmentLadderCache::LadderPtr empty_ladder(new PeakSpectrum());
+
 #ifdef _OPENMP
 #pragma omp parallel for schedule(guided)
 #endif
@@ -423,7 +435,13 @@ using namespace OpenMS;
       const PeakSpectrum& xlink_peaks = preprocessed_pair_spectra.spectra_xlink_peaks[pair_index];
       const PeakSpectrum& all_peaks = preprocessed_pair_spectra.spectra_all_peaks[pair_index];
 
-      vector< OPXLDataStructs::CrossLinkSpectrumMatch > top_csms_spectrum;
+      vector< OPXLDataStructs::CrossLinkSpectrumMatch >& top_csms_spectrum = top_csms_per_pair[pair_index];
+
+      Size thread = 0;
+#ifdef _OPENMP
+      thread = omp_get_thread_num();
+#endif
+      OPXLFragmentLadderCache& ladder_cache = ladder_caches[thread];
 
       // ignore this spectrum pair, if they have less paired peaks than the minimal peptide size
       if (all_peaks.size() < peptide_min_size_)
@@ -455,8 +473,6 @@ using namespace OpenMS;
         OPXLDataStructs::CrossLinkSpectrumMatch csm;
         csm.cross_link = cross_link_candidate;
 
-        PeakSpectrum theoretical_spec_linear_alpha;
-        PeakSpectrum theoretical_spec_linear_beta;
         PeakSpectrum theoretical_spec_xlinks_alpha;
         PeakSpectrum theoretical_spec_xlinks_beta;
 
@@ -468,10 +484,11 @@ using namespace OpenMS;
           link_pos_B = cross_link_candidate.cross_link_position.second;
         }
 
-        specGen.getLinearIonSpectrum(theoretical_spec_linear_alpha, cross_link_candidate.alpha, cross_link_candidate.cross_link_position.first, true, 2, link_pos_B);
+        OPXLFragmentLadderCache::LadderPtr ladder_alpha = ladder_cache.getLinearIonSpectrum(cross_link_candidate.alpha, cross_link_candidate.cross_link_position.first, true, 2, link_pos_B);
+        OPXLFragmentLadderCache::LadderPtr ladder_beta = empty_ladder;
         if (type_is_cross_link)
         {
-          specGen.getLinearIonSpectrum(theoretical_spec_linear_beta, cross_link_candidate.beta, cross_link_candidate.cross_link_position.second, false, 2);
+          ladder_beta = ladder_cache.getLinearIonSpectrum(cross_link_candidate.beta, cross_link_candidate.cross_link_position.second, false, 2);
           specGen.getXLinkIonSpectrum(theoretical_spec_xlinks_alpha, cross_link_candidate, true, 1, precursor_charge);
           specGen.getXLinkIonSpectrum(theoretical_spec_xlinks_beta, cross_link_candidate, false, 1, precursor_charge);
         }
@@ -480,6 +497,8 @@ using namespace OpenMS;
           // Function for mono-links or loop-links
           specGen.getXLinkIonSpectrum(theoretical_spec_xlinks_alpha, cross_link_candidate.alpha, cross_link_candidate.cross_link_position.first, precursor_mass, true, 2, precursor_charge, link_pos_B);
         }
+        const PeakSpectrum& theoretical_spec_linear_alpha = *ladder_alpha;
+        const PeakSpectrum& theoretical_spec_linear_beta = *ladder_beta;
 
         vector< pair< Size, Size > > matched_spec_linear_alpha;
         vector< pair< Size, Size > > matched_spec_linear_beta;
@@ -910,26 +929,23 @@ using namespace OpenMS;
         top_csms_spectrum.push_back(all_csms_spectrum[top]);
       }
 
-      Size all_top_csms_current_index = 0;
-#ifdef _OPENMP
-#pragma omp critical (all_top_csms_access)
-#endif
-      {
-        if (!top_csms_spectrum.empty())
-        {
-          all_top_csms.push_back(top_csms_spectrum);
-          all_top_csms_current_index = all_top_csms.size()-1;
-        }
-      }
+      LOG_DEBUG << "Next Spectrum #############################################" << endl;
+    }
 
-      // Write PeptideIdentifications and PeptideHits for n top hits of this spectrum
-      if (!top_csms_spectrum.empty())
+    // collect the results in the order of the pairs, independent of the number of threads
+    for (Size pair_index = 0; pair_index < spectrum_pairs.size(); ++pair_index)
+    {
+      const vector< OPXLDataStructs::CrossLinkSpectrumMatch >& top_csms_spectrum = top_csms_per_pair[pair_index];
+      if (top_csms_spectrum.empty())
       {
-        OPXLHelper::buildPeptideIDs(peptide_ids, top_csms_spectrum, all_top_csms, all_top_csms_current_index, spectra, scan_index, scan_index_heavy);
+        continue;
       }
+      all_top_csms.push_back(top_csms_spectrum);
 
-      LOG_DEBUG << "Next Spectrum #############################################" << endl;
+      // Write PeptideIdentifications and PeptideHits for n top hits of this spectrum
+      OPXLHelper::buildPeptideIDs(peptide_ids, top_csms_spectrum, all_top_csms, all_top_csms.size()-1, spectra, spectrum_pairs[pair_index].first, spectrum_pairs[pair_index].second);
     }
+    top_csms_per_pair.clear();
     // end of matching / scoring
     progresslogger.endProgress();
 
@@ -1125,14 +1141,10 @@ using namespace OpenMS;
 
       LOG_DEBUG << "paired up, linear peaks: " << linear_peaks.size() << " | xlink peaks: " << xlink_peaks.size() << " | all peaks: " << all_peaks.size() << endl;
 
-  #ifdef _OPENMP
-  #pragma omp critical (preprocessed_pair_spectra_access)
-  #endif
-      {
-        swap(preprocessed_pair_spectra.spectra_linear_peaks[pair_index], linear_peaks);
-        swap(preprocessed_pair_spectra.spectra_xlink_peaks[pair_index], xlink_peaks);
-        swap(preprocessed_pair_spectra.spectra_all_peaks[pair_index], all_peaks);
-      }
+      // every pair has its own preallocated slots, no synchronisation needed
+      swap(preprocessed_pair_spectra.spectra_linear_peaks[pair_index], linear_peaks);
+      swap(preprocessed_pair_spectra.spectra_xlink_peaks[pair_index], xlink_peaks);
+      swap(preprocessed_pair_spectra.spectra_all_peaks[pair_index], all_peaks);
 
   #ifdef DEBUG_OPENPEPXL
         LOG_DEBUG << "spctrum_linear_peaks: " << preprocessed_pair_spectra.spectra_linear_peaks[pair_index].size() << endl;
@@ -37,6 +37,7 @@
 #include <OpenMS/CHEMISTRY/ProteaseDB.h>
 #include <OpenMS/ANALYSIS/XLMS/OPXLSpectrumProcessingAlgorithms.h>
 #include <OpenMS/ANALYSIS/XLMS/OPXLHelper.h>
+#include <OpenMS/ANALYSIS/XLMS/OPXLFragmentLadderCache.h>
 #include <OpenMS/ANALYSIS/XLMS/XQuestScores.h>
 #include <OpenMS/KERNEL/SpectrumHelper.h>
 #include <OpenMS/FILTERING/TRANSFORMERS/NLargest.h>
@@ -54,6 +55,10 @@
 #include <cmath>
 #include <numeric>
 
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
 using namespace std;
 using namespace OpenMS;
 
@@ -378,6 +383,18 @@ using namespace OpenMS;
 
     LOG_DEBUG << "Spectra left after preprocessing and filtering: " << spectra.size() << " of " << unprocessed_spectra.size() << endl;
 
+    // the top hits of each spectrum are only written by the thread processing the spectrum and collected after the loop
+    vector< vector< OPXLDataStructs::CrossLinkSpectrumMatch > > top_csms_per_spectrum(spectra.size());
+
+    // caches of linear fragment ladders for pre-scoring and scoring, one per thread
+    Size num_threads = 1;
+    #ifdef _OPENMP
+    num_threads = omp_get_max_threads();
+    #endif
+    vector<OPXLFragmentLadderCache> ladder_caches_fast(num_threads, OPXLFragmentLadderCache(specGen_fast));
+    vector<OPXLFragmentLadderCache> ladder_caches_full(num_threads, OPXLFragmentLadderCache(specGen_full));
+    const OPXLFragmentLadderCache::LadderPtr empty_ladder(new PeakSpectrum());
+
     #ifdef _OPENMP
     #pragma omp parallel for schedule(guided)
     #endif
@@ -397,7 +414,15 @@ using namespace OpenMS;
       const double precursor_mz = spectrum.getPrecursors()[0].getMZ();
       const double precursor_mass = (precursor_mz * static_cast<double>(precursor_charge)) - (static_cast<double>(precursor_charge) * Constants::PROTON_MASS_U);
 
-      vector< OPXLDataStructs::CrossLinkSpectrumMatch > top_csms_spectrum;
+      vector< OPXLDataStructs::CrossLinkSpectrumMatch >& top_csms_spectrum = top_csms_per_spectrum[scan_index];
+
+      Size thread = 0;
+    #ifdef _OPENMP
+      thread = omp_get_thread_num();
+    #endif
+      OPXLFragmentLadderCache& ladder_cache_fast = ladder_caches_fast[thread];
+      OPXLFragmentLadderCache& ladder_cache_full = ladder_caches_full[thread];
+
       vector <OPXLDataStructs::ProteinProteinCrossLink> cross_link_candidates = OPXLHelper::collectPrecursorCandidates(precursor_correction_steps_, precursor_mass, precursor_mass_tolerance_, precursor_mass_tolerance_unit_ppm_, filtered_peptide_masses, cross_link_mass_, cross_link_mass_mono_link_, cross_link_residue1_, cross_link_residue2_, cross_link_name_);
 
       LOG_DEBUG << "Size of enumerated candidates: " << double(cross_link_candidates.size()) * sizeof(OPXLDataStructs::ProteinProteinCrossLink) / 1024.0 / 1024.0 << " mb" << endl;
@@ -419,9 +444,6 @@ using namespace OpenMS;
         {
           OPXLDataStructs::ProteinProteinCrossLink cross_link_candidate = cross_link_candidates[i];
 
-          PeakSpectrum theoretical_spec_linear_alpha;
-          PeakSpectrum theoretical_spec_linear_beta;
-
           bool type_is_cross_link = cross_link_candidate.getType() == OPXLDataStructs::CROSS;
           bool type_is_loop = cross_link_candidate.getType() == OPXLDataStructs::LOOP;
           Size link_pos_B = 0;
@@ -429,11 +451,14 @@ using namespace OpenMS;
           {
             link_pos_B = cross_link_candidate.cross_link_position.second;
           }
-          specGen_fast.getLinearIonSpectrum(theoretical_spec_linear_alpha, cross_link_candidate.alpha, cross_link_candidate.cross_link_position.first, true, 1, link_pos_B);
+          OPXLFragmentLadderCache::LadderPtr ladder_alpha = ladder_cache_fast.getLinearIonSpectrum(cross_link_candidate.alpha, cross_link_candidate.cross_link_position.first, true, 1, link_pos_B);
+          OPXLFragmentLadderCache::LadderPtr ladder_beta = empty_ladder;
           if (type_is_cross_link)
           {
-            specGen_fast.getLinearIonSpectrum(theoretical_spec_linear_beta, cross_link_candidate.beta, cross_link_candidate.cross_link_position.second, false, 1);
+            ladder_beta = ladder_cache_fast.getLinearIonSpectrum(cross_link_candidate.beta, cross_link_candidate.cross_link_position.second, false, 1);
           }
+          const PeakSpectrum& theoretical_spec_linear_alpha = *ladder_alpha;
+          const PeakSpectrum& theoretical_spec_linear_beta = *ladder_beta;
 
           // Something like this can happen, e.g. with a loop link connecting residues close to the ends of the peptide
           if ( (theoretical_spec_linear_alpha.size() < 3) )
@@ -495,8 +520,6 @@ using namespace OpenMS;
         OPXLDataStructs::CrossLinkSpectrumMatch csm;
         csm.cross_link = cross_link_candidate;
 
-        PeakSpectrum theoretical_spec_linear_alpha;
-        PeakSpectrum theoretical_spec_linear_beta;
         PeakSpectrum theoretical_spec_xlinks_alpha;
         PeakSpectrum theoretical_spec_xlinks_beta;
 
@@ -507,10 +530,11 @@ using namespace OpenMS;
         {
           link_pos_B = cross_link_candidate.cross_link_position.second;
         }
-        specGen_full.getLinearIonSpectrum(theoretical_spec_linear_alpha, cross_link_candidate.alpha, cross_link_candidate.cross_link_position.first, true, 2, link_pos_B);
+        OPXLFragmentLadderCache::LadderPtr ladder_alpha = ladder_cache_full.getLinearIonSpectrum(cross_link_candidate.alpha, cross_link_candidate.cross_link_position.first, true, 2, link_pos_B);
+        OPXLFragmentLadderCache::LadderPtr ladder_beta = empty_ladder;
         if (type_is_cross_link)
         {
-          specGen_full.getLinearIonSpectrum(theoretical_spec_linear_beta, cross_link_candidate.beta, cross_link_candidate.cross_link_position.second, false, 2);
+          ladder_beta = ladder_cache_full.getLinearIonSpectrum(cross_link_candidate.beta, cross_link_candidate.cross_link_position.second, false, 2);
           specGen_full.getXLinkIonSpectrum(theoretical_spec_xlinks_alpha, cross_link_candidate, true, 1, precursor_charge);
           specGen_full.getXLinkIonSpectrum(theoretical_spec_xlinks_beta, cross_link_candidate, false, 1, precursor_charge);
         }
@@ -519,6 +543,8 @@ using namespace OpenMS;
           // Function for mono-links or loop-links
           specGen_full.getXLinkIonSpectrum(theoretical_spec_xlinks_alpha, cross_link_candidate.alpha, cross_link_candidate.cross_link_position.first, precursor_mass, true, 2, precursor_charge, link_pos_B);
         }
+        const PeakSpectrum& theoretical_spec_linear_alpha = *ladder_alpha;
+        const PeakSpectrum& theoretical_spec_linear_beta = *ladder_beta;
 
         // Something like this can happen, e.g. with a loop link connecting the first and last residue of a peptide
         if ( (theoretical_spec_linear_alpha.size() < 1) || (theoretical_spec_xlinks_alpha.size() < 1) )
@@ -536,7 +562,7 @@ using namespace OpenMS;
         DataArrays::FloatDataArray ppm_error_array_linear_beta;
         DataArrays::FloatDataArray ppm_error_array_xlinks_beta;
 
-        PeakSpectrum::IntegerDataArray& theo_charges_la = theoretical_spec_linear_alpha.getIntegerDataArrays()[0];
+        const PeakSpectrum::IntegerDataArray& theo_charges_la = theoretical_spec_linear_alpha.getIntegerDataArrays()[0];
         PeakSpectrum::IntegerDataArray theo_charges_xa;
         if (theoretical_spec_xlinks_alpha.getIntegerDataArrays().size() > 0)
         {
@@ -878,26 +904,23 @@ using namespace OpenMS;
         top_csms_spectrum.push_back(all_csms_spectrum[top]);
       }
 
-      Size all_top_csms_current_index = 0;
-    #ifdef _OPENMP
-    #pragma omp critical (all_top_csms_access)
-    #endif
-      {
-        if (!top_csms_spectrum.empty())
-        {
-          all_top_csms.push_back(top_csms_spectrum);
-          all_top_csms_current_index = all_top_csms.size()-1;
-        }
-      }
+      LOG_DEBUG << "Next Spectrum ##################################" << endl;
+    }
 
-      // Write PeptideIdentifications and PeptideHits for n top hits
-      if (!top_csms_spectrum.empty())
+    // collect the results in the order of the spectra, independent of the number of threads
+    for (Size scan_index = 0; scan_index < spectra.size(); ++scan_index)
+    {
+      const vector< OPXLDataStructs::CrossLinkSpectrumMatch >& top_csms_spectrum = top_csms_per_spectrum[scan_index];
+      if (top_csms_spectrum.empty())
       {
-        OPXLHelper::buildPeptideIDs(peptide_ids, top_csms_spectrum, all_top_csms, all_top_csms_current_index, spectra, scan_index, scan_index);
+        continue;
       }
+      all_top_csms.push_back(top_csms_spectrum);
 
-      LOG_DEBUG << "Next Spectrum ##################################" << endl;
+      // Write PeptideIdentifications and PeptideHits for n top hits
+      OPXLHelper::buildPeptideIDs(peptide_ids, top_csms_spectrum, all_top_csms, all_top_csms.size()-1, spectra, scan_index, scan_index);
     }
+    top_csms_per_spectrum.clear();
 
     // end of matching / scoring
     progresslogger.endProgress();
@@ -6,6 +6,7 @@ set(sources_list
 OpenPepXLAlgorithm.cpp
 OpenPepXLLFAlgorithm.cpp
 OPXLDataStructs.cpp
+OPXLFragmentLadderCache.cpp
 OPXLHelper.cpp
 OPXLSpectrumProcessingAlgorithms.cpp
 XQuestScores.cpp
@@ -34,7 +34,9 @@
 
 #include <OpenMS/APPLICATIONS/TOPPBase.h>
 
+#include <OpenMS/SYSTEM/ExecutionResources.h>
 #include <OpenMS/SYSTEM/File.h>
+#include <OpenMS/SYSTEM/Profiler.h>
 #include <OpenMS/SYSTEM/StopWatch.h>
 #include <OpenMS/SYSTEM/SysInfo.h>
 #include <OpenMS/SYSTEM/UpdateCheck.h>
@@ -47,15 +49,19 @@
 
 #include <OpenMS/FORMAT/FileHandler.h>
 #include <OpenMS/FORMAT/FileTypes.h>
+#include <OpenMS/FORMAT/InMemoryFileStore.h>
 #include <OpenMS/FORMAT/ParamXMLFile.h>
 #include <OpenMS/FORMAT/VALIDATORS/XMLValidator.h>
 
 #include <OpenMS/APPLICATIONS/ConsoleUtils.h>
 
 #include <iostream>
+#include <list>
+#include <memory>
 
 #include <QDir>
 #include <QFile>
+#include <QFileInfo>
 #include <QProcess>
 
 #include <boost/math/special_functions/fpclassify.hpp>
@@ -83,22 +89,45 @@ namespace OpenMS
 
   using namespace Exception;
 
+  namespace
+  {
+    // distributes the lines of the informational log streams from a
+    // background thread for the lifetime of the object
+    class AsynchronousLogging
+    {
+    public:
+      explicit AsynchronousLogging(bool enable) :
+        enabled_(enable)
+      {
+        if (enabled_) setAsynchronous_(true);
+      }
+
+      ~AsynchronousLogging()
+      {
+        if (enabled_) setAsynchronous_(false);
+      }
+
+    private:
+      void setAsynchronous_(bool async)
+      {
+        Log_info.setAsynchronous(async);
+        Log_warn.setAsynchronous(async);
+        Log_debug.setAsynchronous(async);
+      }
+
+      bool enabled_;
+    };
+  }
+
   String TOPPBase::topp_ini_file_ = String(QDir::homePath()) + "/.TOPP.ini";
   const Citation TOPPBase::cite_openms_ = { "Rost HL, Sachsenberg T, Aiche S, Bielow C et al.",
       "OpenMS: a flexible open-source software platform for mass spectrometry data analysis",
       "Nat Meth. 2016; 13, 9: 741-748",
       "10.1038/nmeth.3959" };
 
-  void TOPPBase::setMaxNumberOfThreads(int
-#ifdef _OPENMP
-                                       num_threads // to avoid the unused warning we enable this
-                                                   // argument only if openmp is available
-#endif
-                                       )
+  void TOPPBase::setMaxNumberOfThreads(int num_threads)
   {
-#ifdef _OPENMP
-    omp_set_num_threads(num_threads);
-#endif
+    ExecutionResources::setThreads(num_threads);
   }
 
   TOPPBase::TOPPBase(const String& tool_name, const String& tool_description, bool official, const std::vector<Citation>& citations) :
@@ -153,6 +182,19 @@ namespace OpenMS
 
   TOPPBase::ExitCodes TOPPBase::main(int argc, const char** argv)
   {
+    // forget the state of a previous run (see runBatch_())
+    parameters_.clear();
+    subsections_.clear();
+    subsections_TOPP_.clear();
+    param_ = Param();
+    param_inifile_ = Param();
+    param_cmdline_ = Param();
+    param_instance_ = Param();
+    param_common_tool_ = Param();
+    param_common_ = Param();
+    log_type_ = ProgressLogger::NONE;
+    test_mode_ = false;
+
     //----------------------------------------------------------
     //parse command line
     //----------------------------------------------------------
@@ -167,6 +209,9 @@ namespace OpenMS
       addText_("Common UTIL options:");
     registerStringOption_("ini", "<file>", "", "Use the given TOPP INI file", false);
     registerStringOption_("log", "<file>", "", "Name of log file (created only when specified)", false, true);
+    registerStringOption_("batch", "<file>", "", "Runs the tool once for each line of this file ('-' for standard input, e.g. connected to a named pipe), which holds the command line of the job without the program name. Avoids the startup costs of a separate process per job. Empty lines and lines starting with '#' are ignored, 'quit' ends the batch. All other options given together with -batch are ignored", false, true);
+    registerStringOption_("perf_report", "<file>", "", "Writes a machine-readable (JSON) performance report of the tool run to this file: wall and CPU time in total and per recorded processing step, thread utilization, peak memory usage and I/O volume (created only when specified)", false, true);
+    registerStringOption_("profile", "<file>", "", "Records the time spent in the main processing steps, writes it as a Chrome trace (JSON, view with chrome://tracing or Perfetto) to this file and prints a summary (created only when specified)", false, true);
     registerIntOption_("instance", "<n>", 1, "Instance number for the TOPP INI file", false, true);
     registerIntOption_("debug", "<n>", 0, "Sets the debug level", false, true);
     registerIntOption_("threads", "<n>", 1, "Sets the number of threads allowed to be used by the TOPP tool", false);
@@ -246,6 +291,12 @@ namespace OpenMS
       return ILLEGAL_PARAMETERS;
     }
 
+    // '-batch' given: run the jobs, this command line holds nothing else of interest
+    if (param_cmdline_.exists("batch"))
+    {
+      return runBatch_(param_cmdline_.getValue("batch"));
+    }
+
     ExitCodes result;
 #ifndef DEBUG_TOPP
     try
@@ -435,17 +486,74 @@ namespace OpenMS
     //----------------------------------------------------------
     //threads
     //----------------------------------------------------------
-    Int threads = getParamAsInt_("threads", 1);
-    TOPPBase::setMaxNumberOfThreads(threads);
+    TOPPBase::setMaxNumberOfThreads(getParamAsInt_("threads", 1));
+    Int threads = ExecutionResources::getThreads();
+    {
+      const char* affinity_env = getenv("OPENMS_THREAD_AFFINITY");
+      String affinity_name = (affinity_env == nullptr ? "" : affinity_env);
+      if (!affinity_name.empty())
+      {
+        const std::string* names_end = ExecutionResources::NamesOfAffinity + ExecutionResources::SIZE_OF_AFFINITY;
+        const std::string* name = std::find(ExecutionResources::NamesOfAffinity, names_end, affinity_name.toLower());
+        if (name == names_end)
+        {
+          writeLog_("Warning: Unknown thread affinity '" + affinity_name + "' given in OPENMS_THREAD_AFFINITY (valid are 'none', 'compact' and 'spread'). Ignoring it.");
+        }
+        else if (!ExecutionResources::setAffinity(ExecutionResources::Affinity(name - ExecutionResources::NamesOfAffinity)))
+        {
+          writeLog_("Warning: Binding threads to cores is not supported on this platform. Ignoring OPENMS_THREAD_AFFINITY.");
+        }
+      }
+    }
 
     //----------------------------------------------------------
     //main
     //----------------------------------------------------------
+    String profile_file, perf_report_file;
+    DataValue const& value_profile = getParam_("profile");
+    if (!value_profile.isEmpty()) profile_file = (String)value_profile;
+    DataValue const& value_perf_report = getParam_("perf_report");
+    if (!value_perf_report.isEmpty()) perf_report_file = (String)value_perf_report;
+    if (!profile_file.empty() || !perf_report_file.empty())
+    {
+      Profiler::clear();
+      Profiler::setEnabled(true);
+    }
+
+    size_t io_read_before(0), io_written_before(0);
+    bool has_io_counters = SysInfo::getProcessIOCounters(io_read_before, io_written_before);
+
     StopWatch sw;
     sw.start();
-    result = main_(argc, argv);
+    {
+      // threads logging in parallel sections should not wait for the output streams
+      AsynchronousLogging async_logging(threads > 1);
+      OPENMS_PROFILE_SCOPE("TOPPBase::main_");
+      result = main_(argc, argv);
+    }
     sw.stop();
     LOG_INFO << this->tool_name_ << " took " << sw.toString() << "." << std::endl;
+    Profiler::setEnabled(false);
+
+    if (!perf_report_file.empty())
+    {
+      size_t io_read_after(0), io_written_after(0);
+      has_io_counters = has_io_counters && SysInfo::getProcessIOCounters(io_read_after, io_written_after);
+      storePerformanceReport_(perf_report_file, sw, threads,
+                              has_io_counters ? SignedSize(io_read_after - io_read_before) : -1,
+                              has_io_counters ? SignedSize(io_written_after - io_written_before) : -1,
+                              result);
+    }
+
+    if (!profile_file.empty())
+    {
+      Profiler::storeChromeTrace(profile_file);
+      std::stringstream summary;
+      Profiler::printSummary(summary);
+      LOG_INFO << "Profile (written to '" << profile_file << "'):\n" << summary.str();
+      size_t mem_virtual(0);
+      LOG_INFO << "Peak Memory Usage: " << (SysInfo::getProcessPeakMemoryConsumption(mem_virtual) ? String(mem_virtual / 1024) + " MB" : "<unknown>") << std::endl;
+    }
 
     // useful for benchmarking
     if (debug_level_ >= 1)
@@ -927,6 +1035,173 @@ namespace OpenMS
     throw UnregisteredParameter(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, name);
   }
 
+  TOPPBase::ExitCodes TOPPBase::runBatch_(const String& batch_file)
+  {
+    std::ifstream batch_stream;
+    std::istream* in = &std::cin;
+    if (batch_file != "-")
+    {
+      batch_stream.open(batch_file.c_str());
+      if (!batch_stream)
+      {
+        writeLog_("Error: Cannot read batch file '" + batch_file + "'. Aborting!");
+        return INPUT_FILE_NOT_READABLE;
+      }
+      in = &batch_stream;
+    }
+
+    ExitCodes batch_result = EXECUTION_OK;
+    Size job = 0;
+    std::string line;
+    while (std::getline(*in, line))
+    {
+      String job_line(line);
+      job_line.trim();
+      if (job_line.empty() || job_line.hasPrefix("#")) continue;
+      if (job_line == "quit") break;
+      ++job;
+
+      ExitCodes result = ILLEGAL_PARAMETERS;
+      StringList args;
+      args.push_back(tool_name_);
+      std::vector<String> tokens;
+      try
+      {
+        job_line.split_quoted(" ", tokens);
+      }
+      catch (Exception::BaseException& e)
+      {
+        writeLog_(String("Error: Invalid batch job '") + job_line + "' (" + e.what() + ")");
+        tokens.clear();
+        args.clear();
+      }
+      for (String& token : tokens)
+      {
+        if (token.empty()) continue;
+        if (token.hasPrefix("\"")) token.unquote();
+        args.push_back(token);
+      }
+
+      if (ListUtils::contains(args, "-batch"))
+      {
+        writeLog_("Error: Batch jobs must not use -batch themselves.");
+      }
+      else if (!args.empty())
+      {
+        std::vector<const char*> argv;
+        for (const String& arg : args)
+        {
+          argv.push_back(arg.c_str());
+        }
+        argv.push_back(nullptr);
+        result = main(int(args.size()), argv.data());
+      }
+
+      writeLog_(String("batch job ") + job + " finished: " + int(result));
+      if (result != EXECUTION_OK && batch_result == EXECUTION_OK)
+      {
+        batch_result = result;
+      }
+    }
+    return batch_result;
+  }
+
+  void TOPPBase::storePerformanceReport_(const String& filename, const StopWatch& sw, Int threads, SignedSize bytes_read, SignedSize bytes_written, ExitCodes result) const
+  {
+    std::ofstream os(filename.c_str());
+    if (!os)
+    {
+      throw UnableToCreateFile(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, filename);
+    }
+
+    // number of threads OpenMP actually uses
+    Int threads_used = 1;
+#ifdef _OPENMP
+    threads_used = omp_get_max_threads();
+#endif
+    double wall = sw.getClockTime();
+    double cpu = sw.getCPUTime();
+    size_t mem_peak(0), mem_current(0);
+    bool has_peak = SysInfo::getProcessPeakMemoryConsumption(mem_peak);
+    SysInfo::getProcessMemoryConsumption(mem_current);
+
+    os.precision(writtenDigits(double()));
+    os << "{\n"
+       << "  \"tool\": " << String(tool_name_).quote() << ",\n"
+       << "  \"version\": " << String(version_).quote() << ",\n"
+       << "  \"exit_code\": " << Int(result) << ",\n"
+       << "  \"threads_requested\": " << threads << ",\n"
+       << "  \"threads_used\": " << threads_used << ",\n"
+       << "  \"wall_time\": " << wall << ",\n"
+       << "  \"cpu_time\": " << cpu << ",\n"
+       << "  \"user_time\": " << sw.getUserTime() << ",\n"
+       << "  \"system_time\": " << sw.getSystemTime() << ",\n"
+       // fraction of the available thread time that was spent computing
+       << "  \"thread_utilization\": " << (wall > 0 ? cpu / (wall * threads_used) : 0.0) << ",\n"
+       << "  \"memory_peak_kb\": " << (has_peak ? SignedSize(mem_peak) : SignedSize(-1)) << ",\n"
+       << "  \"memory_end_kb\": " << mem_current << ",\n"
+       << "  \"bytes_read\": " << bytes_read << ",\n"
+       << "  \"bytes_written\": " << bytes_written << ",\n";
+
+    // the regions recorded by the Profiler (summed over all threads)
+    os << "  \"phases\": [";
+    std::vector<Profiler::RegionSummary> regions = Profiler::getSummary();
+    for (Size i = 0; i < regions.size(); ++i)
+    {
+      os << (i == 0 ? "\n" : ",\n")
+         << "    {\"name\": " << String(regions[i].name).quote()
+         << ", \"calls\": " << regions[i].calls
+         << ", \"time\": " << regions[i].total
+         << ", \"self_time\": " << regions[i].self
+         << ", \"max_time\": " << regions[i].max << "}";
+    }
+    os << (regions.empty() ? "],\n" : "\n  ],\n");
+
+    // sizes of all input and output files given to the tool
+    os << "  \"files\": [";
+    bool first = true;
+    for (std::vector<ParameterInformation>::const_iterator it = parameters_.begin(); it != parameters_.end(); ++it)
+    {
+      StringList files;
+      if (it->type == ParameterInformation::INPUT_FILE || it->type == ParameterInformation::OUTPUT_FILE)
+      {
+        String file = getParamAsString_(it->name);
+        if (!file.empty()) files.push_back(file);
+      }
+      else if (it->type == ParameterInformation::INPUT_FILE_LIST || it->type == ParameterInformation::OUTPUT_FILE_LIST)
+      {
+        files = getParamAsStringList_(it->name, StringList());
+      }
+      bool input = (it->type == ParameterInformation::INPUT_FILE || it->type == ParameterInformation::INPUT_FILE_LIST);
+      for (StringList::const_iterator f = files.begin(); f != files.end(); ++f)
+      {
+        QFileInfo fi(f->toQString());
+        os << (first ? "\n" : ",\n")
+           << "    {\"parameter\": " << String(it->name).quote()
+           << ", \"direction\": \"" << (input ? "input" : "output") << "\""
+           << ", \"path\": " << String(*f).quote()
+           << ", \"bytes\": " << (fi.exists() ? SignedSize(fi.size()) : SignedSize(-1)) << "}";
+        first = false;
+      }
+    }
+    os << (first ? "],\n" : "\n  ],\n");
+
+    // user-defined counters of the Profiler
+    os << "  \"counters\": {";
+    std::vector<std::pair<String, double> > counts = Profiler::getCounts();
+    for (Size i = 0; i < counts.size(); ++i)
+    {
+      os << (i == 0 ? "" : ", ") << String(counts[i].first).quote() << ": " << counts[i].second;
+    }
+    os << "}\n}\n";
+
+    os.close();
+    if (!os)
+    {
+      throw UnableToCreateFile(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, filename);
+    }
+  }
+
   void TOPPBase::setValidStrings_(const String& name, const std::string vstrings[], int count)
   {
     std::vector<String> vec;
@@ -1663,6 +1938,88 @@ namespace OpenMS
     return EXECUTION_OK;
   }
 
+  TOPPBase::ExitCodes TOPPBase::runExternalProcesses_(const QString& executable, const std::vector<QStringList>& arguments, Size max_parallel, const QString& workdir) const
+  {
+    if (arguments.size() == 1 || max_parallel < 2)
+    {
+      for (Size i = 0; i < arguments.size(); ++i)
+      {
+        ExitCodes exit_code = runExternalProcess_(executable, arguments[i], workdir);
+        if (exit_code != EXECUTION_OK) return exit_code;
+      }
+      return EXECUTION_OK;
+    }
+
+    std::vector<std::unique_ptr<QProcess> > processes(arguments.size());
+    std::list<Size> running;
+    Size next = 0;
+    bool failed = false;
+    while (!running.empty() || (!failed && next < arguments.size()))
+    {
+      // start processes until the limit is reached
+      while (!failed && next < arguments.size() && running.size() < max_parallel)
+      {
+        processes[next].reset(new QProcess());
+        QProcess& qp = *processes[next];
+        if (!workdir.isEmpty())
+        {
+          qp.setWorkingDirectory(workdir);
+        }
+        qp.start(executable, arguments[next]);
+        std::stringstream ss;
+        ss << "COMMAND: " << String(executable);
+        for (QStringList::const_iterator it = arguments[next].begin(); it != arguments[next].end(); ++it)
+        {
+          ss << " " << it->toStdString();
+        }
+        LOG_DEBUG << ss.str() << endl;
+        writeLog_("Executing: " + String(executable) + " (instance " + String(next + 1) + " of " + String(arguments.size()) + ")");
+        if (!qp.waitForStarted(-1))
+        {
+          writeLog_("FATAL: External invocation of " + String(executable) + " failed (could not be started).");
+          failed = true;
+        }
+        else
+        {
+          running.push_back(next);
+        }
+        ++next;
+      }
+
+      // poll the running processes in turn (waiting on a process also reads
+      // its output, so none of them blocks on a full pipe for long)
+      for (std::list<Size>::iterator it = running.begin(); it != running.end(); )
+      {
+        QProcess& qp = *processes[*it];
+        if (qp.state() != QProcess::NotRunning && !qp.waitForFinished(100))
+        {
+          ++it;
+          continue;
+        }
+        if (qp.exitStatus() != 0 || qp.exitCode() != 0)
+        {
+          writeLog_("FATAL: External invocation of " + String(executable) + " (instance " + String(*it + 1) + ") failed. Standard output and error were:");
+          const QString external_sout(qp.readAllStandardOutput());
+          const QString external_serr(qp.readAllStandardError());
+          writeLog_(external_sout);
+          writeLog_(external_serr);
+          writeLog_(String(qp.exitCode()));
+          failed = true;
+        }
+        qp.close();
+        processes[*it].reset();
+        it = running.erase(it);
+      }
+    }
+
+    if (failed)
+    {
+      return EXTERNAL_PROGRAM_ERROR;
+    }
+    writeLog_("Executed " + String(arguments.size()) + " instances of " + String(executable) + " successfully!");
+    return EXECUTION_OK;
+  }
+
   String TOPPBase::getParamAsString_(const String& key, const String& default_value) const
   {
     const DataValue& tmp = getParam_(key);
@@ -1931,6 +2288,17 @@ namespace OpenMS
     else
       message = "Cannot read input file given from parameter '-" + param_name + "'!\n";
 
+    // data passed in memory from a previous tool (see TOPPPipeline)
+    if (InMemoryFileStore::isMemoryPath(filename))
+    {
+      if (!InMemoryFileStore::exists(filename))
+      {
+        LOG_ERROR << message;
+        throw FileNotFound(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, filename);
+      }
+      return;
+    }
+
     // check file
     if (!File::exists(filename))
     {
@@ -1960,7 +2328,7 @@ namespace OpenMS
     else
       message = "Cannot write output file given from parameter '-" + param_name + "'!\n";
 
-    if (!File::writable(filename))
+    if (!InMemoryFileStore::isMemoryPath(filename) && !File::writable(filename))
     {
       LOG_ERROR << message;
       throw UnableToCreateFile(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, filename);
@@ -0,0 +1,136 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2018.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: Timo Sachsenberg $
+// $Authors: Timo Sachsenberg $
+// --------------------------------------------------------------------------
+
+#include <OpenMS/APPLICATIONS/TOPPPipeline.h>
+
+#include <OpenMS/CONCEPT/LogStream.h>
+#include <OpenMS/FORMAT/InMemoryFileStore.h>
+
+using namespace std;
+
+namespace OpenMS
+{
+
+  TOPPPipeline::TOPPPipeline() :
+    failed_stage_(0)
+  {
+  }
+
+  TOPPPipeline::~TOPPPipeline()
+  {
+  }
+
+  void TOPPPipeline::addStage(TOPPBase* tool, const StringList& arguments)
+  {
+    if (tool == nullptr)
+    {
+      throw Exception::MissingInformation(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "TOPPPipeline stage without tool given.");
+    }
+    tools_.emplace_back(tool);
+    arguments_.push_back(arguments);
+  }
+
+  Size TOPPPipeline::size() const
+  {
+    return tools_.size();
+  }
+
+  void TOPPPipeline::keep(const String& name)
+  {
+    kept_.insert(name);
+  }
+
+  Size TOPPPipeline::getFailedStage() const
+  {
+    return failed_stage_;
+  }
+
+  map<String, Size> TOPPPipeline::lastUse_() const
+  {
+    map<String, Size> last_use;
+    for (Size i = 0; i < arguments_.size(); ++i)
+    {
+      for (const String& arg : arguments_[i])
+      {
+        if (InMemoryFileStore::isMemoryPath(arg) && kept_.count(arg) == 0)
+        {
+          last_use[arg] = i;
+        }
+      }
+    }
+    return last_use;
+  }
+
+  TOPPBase::ExitCodes TOPPPipeline::run()
+  {
+    const map<String, Size> last_use = lastUse_();
+    failed_stage_ = tools_.size();
+
+    for (Size i = 0; i < tools_.size(); ++i)
+    {
+      // TOPPBase::main() expects the program name in argv[0]
+      vector<const char*> argv;
+      argv.reserve(arguments_[i].size() + 2);
+      argv.push_back("TOPPPipeline");
+      for (const String& arg : arguments_[i])
+      {
+        argv.push_back(arg.c_str());
+      }
+      argv.push_back(nullptr);
+
+      TOPPBase::ExitCodes result = tools_[i]->main(int(argv.size() - 1), argv.data());
+      if (result != TOPPBase::EXECUTION_OK)
+      {
+        LOG_ERROR << "TOPPPipeline: stage " << (i + 1) << " of " << tools_.size() << " failed (exit code " << int(result) << ")." << endl;
+        failed_stage_ = i;
+        for (const auto& entry : last_use)
+        {
+          InMemoryFileStore::remove(entry.first);
+        }
+        return result;
+      }
+
+      // release data sets no later stage needs
+      for (const auto& entry : last_use)
+      {
+        if (entry.second == i)
+        {
+          InMemoryFileStore::remove(entry.first);
+        }
+      }
+    }
+    return TOPPBase::EXECUTION_OK;
+  }
+
+} // namespace OpenMS
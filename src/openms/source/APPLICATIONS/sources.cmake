@@ -6,6 +6,7 @@ set(sources_list
 INIUpdater.cpp
 ToolHandler.cpp
 TOPPBase.cpp
+TOPPPipeline.cpp
 ParameterInformation.cpp
 ConsoleUtils.cpp
 )
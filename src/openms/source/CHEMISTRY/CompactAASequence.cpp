@@ -0,0 +1,282 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2018.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// --------------------------------------------------------------------------
+// $Maintainer: Timo Sachsenberg $
+// $Authors: Timo Sachsenberg $
+// --------------------------------------------------------------------------
+
+#include <OpenMS/CHEMISTRY/CompactAASequence.h>
+#include <OpenMS/CHEMISTRY/Residue.h>
+#include <OpenMS/CHEMISTRY/ResidueDB.h>
+#include <OpenMS/CHEMISTRY/ResidueModification.h>
+
+#include <algorithm>
+#include <functional>
+#include <unordered_set>
+
+using namespace std;
+
+namespace OpenMS
+{
+  namespace
+  {
+    inline void hashCombine(std::size_t& seed, std::size_t value)
+    {
+      seed ^= value + std::size_t(0x9e3779b9) + (seed << 6) + (seed >> 2);
+    }
+  }
+
+  CompactAASequence::CompactAASequence() :
+    residues_(),
+    modified_(),
+    n_term_mod_(nullptr),
+    c_term_mod_(nullptr),
+    hash_(0)
+  {
+    updateHash_();
+  }
+
+  CompactAASequence::CompactAASequence(const AASequence& sequence) :
+    residues_(),
+    modified_(),
+    n_term_mod_(sequence.getNTerminalModification()),
+    c_term_mod_(sequence.getCTerminalModification()),
+    hash_(0)
+  {
+    const ResidueDB* rdb = ResidueDB::getInstance();
+    residues_.reserve(sequence.size());
+    for (Size i = 0; i < sequence.size(); ++i)
+    {
+      const Residue* r = &sequence.getResidue(i);
+      const char code = r->getOneLetterCode().empty() ? 'X' : r->getOneLetterCode()[0];
+      residues_ += code;
+      // everything that is not the plain residue of the one-letter code goes to the table
+      if (rdb->getResidue((unsigned char)code) != r)
+      {
+        modified_.push_back(make_pair(i, r));
+      }
+    }
+    updateHash_();
+  }
+
+  CompactAASequence CompactAASequence::fromString(const String& sequence)
+  {
+    // fast path: unmodified one-letter codes only
+    const ResidueDB* rdb = ResidueDB::getInstance();
+    bool plain = !sequence.empty();
+    for (String::const_iterator it = sequence.begin(); it != sequence.end(); ++it)
+    {
+      if (*it < 'A' || *it > 'Z' || rdb->getResidue((unsigned char)*it) == nullptr)
+      {
+        plain = false;
+        break;
+      }
+    }
+    if (!plain)
+    {
+      return CompactAASequence(AASequence::fromString(sequence));
+    }
+
+    CompactAASequence result;
+    result.residues_ = sequence;
+    result.updateHash_();
+    return result;
+  }
+
+  AASequence CompactAASequence::toAASequence() const
+  {
+    AASequence sequence;
+    for (Size i = 0; i < residues_.size(); ++i)
+    {
+      sequence += getResidue(i);
+    }
+    sequence.setNTerminalModification(n_term_mod_);
+    sequence.setCTerminalModification(c_term_mod_);
+    return sequence;
+  }
+
+  String CompactAASequence::toString() const
+  {
+    if (!isModified())
+    {
+      return residues_;
+    }
+    return toAASequence().toString();
+  }
+
+  const Residue* CompactAASequence::getModifiedResidue_(Size index) const
+  {
+    ModifiedResidues::const_iterator it = std::lower_bound(modified_.begin(), modified_.end(), make_pair(index, (const Residue*)nullptr));
+    if (it != modified_.end() && it->first == index)
+    {
+      return it->second;
+    }
+    return nullptr;
+  }
+
+  const Residue* CompactAASequence::getResidue(Size index) const
+  {
+    const Residue* r = getModifiedResidue_(index);
+    if (r != nullptr)
+    {
+      return r;
+    }
+    return ResidueDB::getInstance()->getResidue((unsigned char)residues_[index]);
+  }
+
+  void CompactAASequence::updateHash_()
+  {
+    std::size_t seed = std::hash<std::string>()(residues_);
+    for (ModifiedResidues::const_iterator it = modified_.begin(); it != modified_.end(); ++it)
+    {
+      hashCombine(seed, it->first);
+      hashCombine(seed, std::hash<const Residue*>()(it->second));
+    }
+    hashCombine(seed, std::hash<const ResidueModification*>()(n_term_mod_));
+    hashCombine(seed, std::hash<const ResidueModification*>()(c_term_mod_));
+    hash_ = seed;
+  }
+
+  bool CompactAASequence::operator==(const CompactAASequence& rhs) const
+  {
+    return hash_ == rhs.hash_ &&
+           n_term_mod_ == rhs.n_term_mod_ &&
+           c_term_mod_ == rhs.c_term_mod_ &&
+           residues_ == rhs.residues_ &&
+           modified_ == rhs.modified_;
+  }
+
+  bool CompactAASequence::operator!=(const CompactAASequence& rhs) const
+  {
+    return !(*this == rhs);
+  }
+
+  bool CompactAASequence::operator<(const CompactAASequence& rhs) const
+  {
+    // check size
+    if (residues_.size() != rhs.residues_.size())
+    {
+      return residues_.size() < rhs.residues_.size();
+    }
+
+    // when checking terminal mods, "no mod" is less than "any mod"
+    if (n_term_mod_ && !rhs.n_term_mod_)
+    {
+      return false;
+    }
+    else if (!n_term_mod_ && rhs.n_term_mod_)
+    {
+      return true;
+    }
+    else if (n_term_mod_ && rhs.n_term_mod_ && (n_term_mod_ != rhs.n_term_mod_))
+    {
+      return n_term_mod_->getId() < rhs.n_term_mod_->getId();
+    }
+
+    // check one letter codes and modifications
+    ModifiedResidues::const_iterator a = modified_.begin();
+    ModifiedResidues::const_iterator b = rhs.modified_.begin();
+    for (Size i = 0; i < residues_.size(); ++i)
+    {
+      const Residue* mod_a = (a != modified_.end() && a->first == i) ? (a++)->second : nullptr;
+      const Residue* mod_b = (b != rhs.modified_.end() && b->first == i) ? (b++)->second : nullptr;
+      if (residues_[i] != rhs.residues_[i])
+      {
+        return residues_[i] < rhs.residues_[i];
+      }
+      if (mod_a != mod_b)
+      {
+        const ResidueModification* m_a = (mod_a != nullptr) ? mod_a->getModification() : nullptr;
+        const ResidueModification* m_b = (mod_b != nullptr) ? mod_b->getModification() : nullptr;
+        if (m_a != m_b)
+        {
+          return m_a < m_b;
+        }
+      }
+    }
+
+    // c-term
+    if (c_term_mod_ && !rhs.c_term_mod_)
+    {
+      return false;
+    }
+    else if (!c_term_mod_ && rhs.c_term_mod_)
+    {
+      return true;
+    }
+    else if (c_term_mod_ && rhs.c_term_mod_ && (c_term_mod_ != rhs.c_term_mod_))
+    {
+      return c_term_mod_->getId() < rhs.c_term_mod_->getId();
+    }
+
+    return false;
+  }
+
+  namespace
+  {
+    std::unordered_set<CompactAASequence, CompactAASequence::Hash>& internPool()
+    {
+      static std::unordered_set<CompactAASequence, CompactAASequence::Hash> pool;
+      return pool;
+    }
+  }
+
+  const CompactAASequence& CompactAASequence::intern(const CompactAASequence& sequence)
+  {
+    const CompactAASequence* interned = nullptr;
+#ifdef _OPENMP
+#pragma omp critical (CompactAASequence_intern)
+#endif
+    {
+      // elements of an unordered_set are not moved on rehashing
+      interned = &*internPool().insert(sequence).first;
+    }
+    return *interned;
+  }
+
+  Size CompactAASequence::getInternedCount()
+  {
+    Size count(0);
+#ifdef _OPENMP
+#pragma omp critical (CompactAASequence_intern)
+#endif
+    count = internPool().size();
+    return count;
+  }
+
+  std::ostream& operator<<(std::ostream& os, const CompactAASequence& sequence)
+  {
+    os << sequence.toString();
+    return os;
+  }
+
+} // namespace OpenMS
+
@@ -0,0 +1,340 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2018.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: Chris Bielow $
+// $Authors: Chris Bielow $
+// --------------------------------------------------------------------------
+
+#include <OpenMS/CHEMISTRY/CompactEmpiricalFormula.h>
+
+#include <OpenMS/CHEMISTRY/Element.h>
+#include <OpenMS/CHEMISTRY/ElementDB.h>
+#include <OpenMS/CONCEPT/Constants.h>
+#include <OpenMS/DATASTRUCTURES/String.h>
+
+#include <algorithm>
+#include <functional>
+#include <iostream>
+
+using namespace std;
+
+namespace OpenMS
+{
+  namespace
+  {
+    // elements and masses of the common elements, taken from ElementDB once
+    struct CommonElementTable
+    {
+      const Element* elements[CompactEmpiricalFormula::SIZE_OF_COMMONELEMENT];
+      double mono_weights[CompactEmpiricalFormula::SIZE_OF_COMMONELEMENT];
+      double average_weights[CompactEmpiricalFormula::SIZE_OF_COMMONELEMENT];
+
+      CommonElementTable()
+      {
+        const char* symbols[CompactEmpiricalFormula::SIZE_OF_COMMONELEMENT] = {"C", "H", "N", "O", "P", "S"};
+        const ElementDB* db = ElementDB::getInstance();
+        for (Size i = 0; i < CompactEmpiricalFormula::SIZE_OF_COMMONELEMENT; ++i)
+        {
+          elements[i] = db->getElement(symbols[i]);
+          mono_weights[i] = elements[i]->getMonoWeight();
+          average_weights[i] = elements[i]->getAverageWeight();
+        }
+      }
+    };
+
+    const CommonElementTable& commonElementTable()
+    {
+      // initialization of function-local statics is thread-safe
+      static const CommonElementTable table;
+      return table;
+    }
+
+    bool lessElement(const pair<const Element*, SignedSize>& entry, const Element* element)
+    {
+      return std::less<const Element*>()(entry.first, element);
+    }
+  }
+
+  CompactEmpiricalFormula::CompactEmpiricalFormula() :
+    charge_(0)
+  {
+    std::fill(counts_, counts_ + SIZE_OF_COMMONELEMENT, 0);
+  }
+
+  CompactEmpiricalFormula::CompactEmpiricalFormula(const EmpiricalFormula& formula) :
+    CompactEmpiricalFormula()
+  {
+    for (const auto& it : formula)
+    {
+      Size index = commonIndex_(it.first);
+      if (index < SIZE_OF_COMMONELEMENT)
+      {
+        counts_[index] = it.second;
+      }
+      else
+      {
+        addOther_(it.first, it.second);
+      }
+    }
+    charge_ = formula.getCharge();
+  }
+
+  CompactEmpiricalFormula::CompactEmpiricalFormula(const String& formula) :
+    CompactEmpiricalFormula(EmpiricalFormula(formula))
+  {
+  }
+
+  CompactEmpiricalFormula::CompactEmpiricalFormula(SignedSize number, const Element* element, SignedSize charge) :
+    CompactEmpiricalFormula()
+  {
+    Size index = commonIndex_(element);
+    if (index < SIZE_OF_COMMONELEMENT)
+    {
+      counts_[index] = number;
+    }
+    else
+    {
+      addOther_(element, number);
+    }
+    charge_ = charge;
+  }
+
+  EmpiricalFormula CompactEmpiricalFormula::toEmpiricalFormula() const
+  {
+    const CommonElementTable& table = commonElementTable();
+    EmpiricalFormula formula;
+    for (Size i = 0; i < SIZE_OF_COMMONELEMENT; ++i)
+    {
+      if (counts_[i] != 0)
+      {
+        formula += EmpiricalFormula(counts_[i], table.elements[i]);
+      }
+    }
+    for (const auto& it : other_)
+    {
+      formula += EmpiricalFormula(it.second, it.first);
+    }
+    formula.setCharge(charge_);
+    return formula;
+  }
+
+  double CompactEmpiricalFormula::getMonoWeight() const
+  {
+    const CommonElementTable& table = commonElementTable();
+    double weight = Constants::PROTON_MASS_U * charge_;
+    for (Size i = 0; i < SIZE_OF_COMMONELEMENT; ++i)
+    {
+      weight += table.mono_weights[i] * (double)counts_[i];
+    }
+    for (const auto& it : other_)
+    {
+      weight += it.first->getMonoWeight() * (double)it.second;
+    }
+    return weight;
+  }
+
+  double CompactEmpiricalFormula::getAverageWeight() const
+  {
+    const CommonElementTable& table = commonElementTable();
+    double weight(0);
+    if (charge_ > 0)
+    {
+      weight += Constants::PROTON_MASS_U * charge_;
+    }
+    for (Size i = 0; i < SIZE_OF_COMMONELEMENT; ++i)
+    {
+      weight += table.average_weights[i] * (double)counts_[i];
+    }
+    for (const auto& it : other_)
+    {
+      weight += it.first->getAverageWeight() * (double)it.second;
+    }
+    return weight;
+  }
+
+  SignedSize CompactEmpiricalFormula::getNumberOf(const Element* element) const
+  {
+    Size index = commonIndex_(element);
+    if (index < SIZE_OF_COMMONELEMENT)
+    {
+      return counts_[index];
+    }
+    OtherElements::const_iterator it = std::lower_bound(other_.begin(), other_.end(), element, lessElement);
+    if (it != other_.end() && it->first == element)
+    {
+      return it->second;
+    }
+    return 0;
+  }
+
+  SignedSize CompactEmpiricalFormula::getNumberOfAtoms() const
+  {
+    SignedSize num_atoms(0);
+    for (Size i = 0; i < SIZE_OF_COMMONELEMENT; ++i) num_atoms += counts_[i];
+    for (const auto& it : other_) num_atoms += it.second;
+    return num_atoms;
+  }
+
+  String CompactEmpiricalFormula::toString() const
+  {
+    return toEmpiricalFormula().toString();
+  }
+
+  const Element* CompactEmpiricalFormula::getElement(CommonElement element)
+  {
+    return commonElementTable().elements[element];
+  }
+
+  CompactEmpiricalFormula& CompactEmpiricalFormula::operator+=(const CompactEmpiricalFormula& rhs)
+  {
+    for (Size i = 0; i < SIZE_OF_COMMONELEMENT; ++i) counts_[i] += rhs.counts_[i];
+    for (const auto& it : rhs.other_) addOther_(it.first, it.second);
+    charge_ += rhs.charge_;
+    return *this;
+  }
+
+  CompactEmpiricalFormula& CompactEmpiricalFormula::operator-=(const CompactEmpiricalFormula& rhs)
+  {
+    for (Size i = 0; i < SIZE_OF_COMMONELEMENT; ++i) counts_[i] -= rhs.counts_[i];
+    for (const auto& it : rhs.other_) addOther_(it.first, -it.second);
+    charge_ -= rhs.charge_;
+    return *this;
+  }
+
+  CompactEmpiricalFormula& CompactEmpiricalFormula::operator*=(SignedSize times)
+  {
+    for (Size i = 0; i < SIZE_OF_COMMONELEMENT; ++i) counts_[i] *= times;
+    if (times == 0)
+    {
+      other_.clear();
+    }
+    for (auto& it : other_) it.second *= times;
+    charge_ *= times;
+    return *this;
+  }
+
+  CompactEmpiricalFormula CompactEmpiricalFormula::operator+(const CompactEmpiricalFormula& rhs) const
+  {
+    CompactEmpiricalFormula ef(*this);
+    ef += rhs;
+    return ef;
+  }
+
+  CompactEmpiricalFormula CompactEmpiricalFormula::operator-(const CompactEmpiricalFormula& rhs) const
+  {
+    CompactEmpiricalFormula ef(*this);
+    ef -= rhs;
+    return ef;
+  }
+
+  CompactEmpiricalFormula CompactEmpiricalFormula::operator*(SignedSize times) const
+  {
+    CompactEmpiricalFormula ef(*this);
+    ef *= times;
+    return ef;
+  }
+
+  bool CompactEmpiricalFormula::isEmpty() const
+  {
+    for (Size i = 0; i < SIZE_OF_COMMONELEMENT; ++i)
+    {
+      if (counts_[i] != 0) return false;
+    }
+    return other_.empty();
+  }
+
+  bool CompactEmpiricalFormula::operator==(const CompactEmpiricalFormula& rhs) const
+  {
+    return std::equal(counts_, counts_ + SIZE_OF_COMMONELEMENT, rhs.counts_) &&
+           charge_ == rhs.charge_ && other_ == rhs.other_;
+  }
+
+  bool CompactEmpiricalFormula::operator!=(const CompactEmpiricalFormula& rhs) const
+  {
+    return !(*this == rhs);
+  }
+
+  bool CompactEmpiricalFormula::operator<(const CompactEmpiricalFormula& rhs) const
+  {
+    for (Size i = 0; i < SIZE_OF_COMMONELEMENT; ++i)
+    {
+      if (counts_[i] != rhs.counts_[i]) return counts_[i] < rhs.counts_[i];
+    }
+    if (charge_ != rhs.charge_) return charge_ < rhs.charge_;
+    if (other_.size() != rhs.other_.size()) return other_.size() < rhs.other_.size();
+    for (Size i = 0; i < other_.size(); ++i)
+    {
+      if (other_[i].first != rhs.other_[i].first)
+      {
+        return std::less<const Element*>()(other_[i].first, rhs.other_[i].first);
+      }
+      if (other_[i].second != rhs.other_[i].second) return other_[i].second < rhs.other_[i].second;
+    }
+    return false;
+  }
+
+  void CompactEmpiricalFormula::addOther_(const Element* element, SignedSize number)
+  {
+    if (number == 0)
+    {
+      return;
+    }
+    OtherElements::iterator it = std::lower_bound(other_.begin(), other_.end(), element, lessElement);
+    if (it != other_.end() && it->first == element)
+    {
+      it->second += number;
+      if (it->second == 0)
+      {
+        other_.erase(it);
+      }
+    }
+    else
+    {
+      other_.insert(it, make_pair(element, number));
+    }
+  }
+
+  Size CompactEmpiricalFormula::commonIndex_(const Element* element)
+  {
+    const CommonElementTable& table = commonElementTable();
+    Size index = 0;
+    while (index < SIZE_OF_COMMONELEMENT && table.elements[index] != element)
+    {
+      ++index;
+    }
+    return index;
+  }
+
+  ostream& operator<<(ostream& os, const CompactEmpiricalFormula& formula)
+  {
+    return os << formula.toEmpiricalFormula();
+  }
+
+} // namespace OpenMS
@@ -43,10 +43,9 @@ using namespace std;
 
 namespace OpenMS
 {
-  CrossLinksDB::CrossLinksDB()
+  CrossLinksDB::CrossLinksDB() :
+    ModificationsDB("", "", "") // the base class content is not used, don't parse its files
   {
-    mods_.clear();
-    modification_names_.clear();
     readFromOBOFile("CHEMISTRY/XLMOD.obo");
   }
 
@@ -99,6 +99,13 @@ namespace OpenMS
   std::vector<int> EnzymaticDigestion::tokenize_(const String& sequence, int start, int end) const
   {
     std::vector<int> positions;
+    tokenize_(sequence, positions, start, end);
+    return positions;
+  }
+
+  void EnzymaticDigestion::tokenize_(const String& sequence, std::vector<int>& positions, int start, int end) const
+  {
+    positions.clear();
     // set proper boundaries
     start = std::max(0, start);
     if (end < 0 || end > (int)sequence.size()) end = (int)sequence.size();
@@ -118,7 +125,6 @@ namespace OpenMS
     {
       positions.push_back(start);
     }
-    return positions;
   }
 
   bool EnzymaticDigestion::isValidProduct(const String& sequence,
@@ -38,6 +38,14 @@
 #include <OpenMS/DATASTRUCTURES/String.h>
 #include <OpenMS/CHEMISTRY/Element.h>
 
+#include <algorithm>
+#include <exception>
+#include <map>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
 namespace OpenMS
 {
 
@@ -92,4 +100,176 @@ namespace OpenMS
     return result;
   }
 
+  void FineIsotopePatternGenerator::collectElements_(const std::vector<EmpiricalFormula>& formulas, ElementTable_& table)
+  {
+    std::map<const Element*, int> known;
+    for (const EmpiricalFormula& formula : formulas)
+    {
+      for (const auto& elem : formula)
+      {
+        if (known.find(elem.first) != known.end()) continue;
+        known[elem.first] = table.elements.size();
+        table.elements.push_back(elem.first);
+
+        std::vector<double> masses;
+        std::vector<double> probs;
+        for (auto iso : elem.first->getIsotopeDistribution())
+        {
+          if (iso.getIntensity() <= 0.0) continue; // Note: there will be a segfault if one of the intensities is zero!
+          masses.push_back(iso.getMZ());
+          probs.push_back(iso.getIntensity());
+        }
+        table.masses.push_back(masses);
+        table.probabilities.push_back(probs);
+      }
+    }
+  }
+
+  void FineIsotopePatternGenerator::runCached_(const EmpiricalFormula& formula, const ElementTable_& table, IsoSpec& algorithm,
+                                               std::vector<int>& element_ids, std::vector<int>& atom_counts, std::vector<Peak1D>& peaks)
+  {
+    // same order of elements as in run()
+    element_ids.clear();
+    atom_counts.clear();
+    for (const auto& elem : formula)
+    {
+      element_ids.push_back(std::find(table.elements.begin(), table.elements.end(), elem.first) - table.elements.begin());
+      atom_counts.push_back(elem.second);
+    }
+
+    algorithm.runCached(element_ids, atom_counts, table.masses, table.probabilities);
+
+    const std::vector<double>& masses = algorithm.getMasses();
+    const std::vector<double>& probabilities = algorithm.getProbabilities();
+    peaks.clear();
+    peaks.reserve(masses.size());
+    for (Size i = 0; i < masses.size(); ++i)
+    {
+      peaks.emplace_back(Peak1D(masses[i], probabilities[i]));
+    }
+    std::sort(peaks.begin(), peaks.end(), [](const Peak1D& p1, const Peak1D& p2) { return p1.getMZ() < p2.getMZ(); });
+  }
+
+  std::vector<IsotopeDistribution> FineIsotopePatternGenerator::run(const std::vector<EmpiricalFormula>& formulas) const
+  {
+    ElementTable_ table;
+    collectElements_(formulas, table);
+
+    std::vector<IsotopeDistribution> result(formulas.size());
+    Size err_count = 0;
+    std::exception_ptr err;
+#ifdef _OPENMP
+#pragma omp parallel
+#endif
+    {
+      // one IsoSpec object (with its cache of marginal distributions) per thread
+      IsoSpec algorithm(threshold_, absolute_);
+      std::vector<int> element_ids, atom_counts;
+      std::vector<Peak1D> peaks;
+#ifdef _OPENMP
+#pragma omp for schedule(dynamic, 64)
+#endif
+      for (SignedSize i = 0; i < (SignedSize)formulas.size(); ++i)
+      {
+        try
+        {
+          runCached_(formulas[i], table, algorithm, element_ids, atom_counts, peaks);
+          result[i].set(peaks);
+        }
+        catch (...)
+        {
+#ifdef _OPENMP
+#pragma omp critical (FineIsotopePatternGenerator_error)
+#endif
+          {
+            if (err_count++ == 0) err = std::current_exception();
+          }
+        }
+      }
+    }
+    if (err_count > 0)
+    {
+      std::rethrow_exception(err);
+    }
+    return result;
+  }
+
+  void FineIsotopePatternGenerator::run(const std::vector<EmpiricalFormula>& formulas,
+                                        std::vector<double>& masses,
+                                        std::vector<double>& probabilities,
+                                        std::vector<Size>& offsets) const
+  {
+    ElementTable_ table;
+    collectElements_(formulas, table);
+
+    // Each thread processes a contiguous range of formulas into its own
+    // buffers, which are concatenated in the order of the ranges.
+    int nr_threads = 1;
+#ifdef _OPENMP
+    nr_threads = omp_get_max_threads();
+#endif
+    std::vector<std::vector<double> > thread_masses(nr_threads), thread_probabilities(nr_threads);
+    std::vector<Size> sizes(formulas.size());
+    Size err_count = 0;
+    std::exception_ptr err;
+#ifdef _OPENMP
+#pragma omp parallel num_threads(nr_threads)
+#endif
+    {
+      int thread = 0, used_threads = 1;
+#ifdef _OPENMP
+      thread = omp_get_thread_num();
+      used_threads = omp_get_num_threads();
+#endif
+      const Size begin = formulas.size() * thread / used_threads;
+      const Size end = formulas.size() * (thread + 1) / used_threads;
+
+      IsoSpec algorithm(threshold_, absolute_);
+      std::vector<int> element_ids, atom_counts;
+      std::vector<Peak1D> peaks;
+      try
+      {
+        for (Size i = begin; i < end; ++i)
+        {
+          runCached_(formulas[i], table, algorithm, element_ids, atom_counts, peaks);
+          sizes[i] = peaks.size();
+          for (const Peak1D& p : peaks)
+          {
+            thread_masses[thread].push_back(p.getMZ());
+            thread_probabilities[thread].push_back(p.getIntensity());
+          }
+        }
+      }
+      catch (...)
+      {
+#ifdef _OPENMP
+#pragma omp critical (FineIsotopePatternGenerator_error)
+#endif
+        {
+          if (err_count++ == 0) err = std::current_exception();
+        }
+      }
+    }
+    if (err_count > 0)
+    {
+      std::rethrow_exception(err);
+    }
+
+    offsets.resize(formulas.size() + 1);
+    offsets[0] = 0;
+    for (Size i = 0; i < formulas.size(); ++i)
+    {
+      offsets[i + 1] = offsets[i] + sizes[i];
+    }
+    masses.clear();
+    probabilities.clear();
+    masses.reserve(offsets.back());
+    probabilities.reserve(offsets.back());
+    for (int t = 0; t < nr_threads; ++t)
+    {
+      masses.insert(masses.end(), thread_masses[t].begin(), thread_masses[t].end());
+      probabilities.insert(probabilities.end(), thread_probabilities[t].begin(), thread_probabilities[t].end());
+    }
+  }
+
 }
@@ -34,8 +34,11 @@
 
 #include <OpenMS/CHEMISTRY/ISOTOPEDISTRIBUTION/IsoSpec.h>
 
+#include <OpenMS/CONCEPT/Exception.h>
 #include <OpenMS/CONCEPT/Macros.h>
+#include <cmath>
 #include <iterator>
+#include <limits>
 #include <string>
 
 #include "IsoSpec/allocator.cpp"
@@ -131,6 +134,157 @@ namespace OpenMS
     delete[] IP;
   }
 
+  void IsoSpec::runCached(const std::vector<int>& elementIds,
+                          const std::vector<int>& atomCounts,
+                          const std::vector<std::vector<double> >& elementMasses,
+                          const std::vector<std::vector<double> >& elementProbabilities)
+  {
+    OPENMS_PRECONDITION(elementIds.size() == atomCounts.size(), "Vectors need to be of the same size")
+    OPENMS_PRECONDITION(elementMasses.size() == elementProbabilities.size(), "Vectors need to be of the same size")
+
+    const Size dim_number = elementIds.size();
+    if (absolute_)
+    {
+      // the marginal distributions depend on the mode of the whole formula
+      std::vector<int> isotope_nr(dim_number);
+      std::vector<std::vector<double> > isotope_masses(dim_number), isotope_probabilities(dim_number);
+      for (Size i = 0; i < dim_number; ++i)
+      {
+        isotope_masses[i] = elementMasses[elementIds[i]];
+        isotope_probabilities[i] = elementProbabilities[elementIds[i]];
+        isotope_nr[i] = isotope_masses[i].size();
+      }
+      run(isotope_nr, atomCounts, isotope_masses, isotope_probabilities);
+      return;
+    }
+
+    // look up (or compute) the marginal distribution of each element
+    marginals_.resize(dim_number);
+    double mode_lprob = 0.0;
+    for (Size i = 0; i < dim_number; ++i)
+    {
+      std::pair<int, int> key(elementIds[i], atomCounts[i]);
+      auto it = marginal_cache_.find(key);
+      if (it == marginal_cache_.end())
+      {
+        const std::vector<double>& masses = elementMasses[elementIds[i]];
+        const std::vector<double>& probabilities = elementProbabilities[elementIds[i]];
+        OPENMS_PRECONDITION(masses.size() == probabilities.size(), "Vectors need to be of the same size")
+        if (!std::all_of(probabilities.begin(), probabilities.end(), [](double p) { return p > 0.0; }))
+        {
+          throw Exception::IllegalArgument(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION,
+                                           std::string("All probabilities need to be larger than zero").c_str());
+        }
+
+        Marginal marginal(masses.data(), probabilities.data(), masses.size(), atomCounts[i]);
+        // for a relative threshold, the cutoff of each marginal only depends on its own mode
+        double lcutoff = threshold_ <= 0.0 ? std::numeric_limits<double>::lowest() : log(threshold_) + marginal.getModeLProb();
+        std::shared_ptr<PrecalculatedMarginal> precalculated(new PrecalculatedMarginal(std::move(marginal), lcutoff, true, 1000, 1000));
+        it = marginal_cache_.insert(std::make_pair(key, precalculated)).first;
+      }
+      marginals_[i] = it->second.get();
+      mode_lprob += marginals_[i]->getModeLProb();
+    }
+
+    enumerateCached_(mode_lprob);
+  }
+
+  void IsoSpec::enumerateCached_(double mode_lprob)
+  {
+    // Same enumeration as IsoThresholdGenerator (and the same order of
+    // configurations) on the marginal distributions in marginals_
+    masses_.clear();
+    probabilities_.clear();
+
+    const int dim_number = marginals_.size();
+    if (dim_number == 0)
+    {
+      masses_.push_back(0.0);
+      probabilities_.push_back(1.0);
+      return;
+    }
+    for (int i = 0; i < dim_number; ++i)
+    {
+      if (!marginals_[i]->inRange(0))
+      {
+        return;
+      }
+    }
+
+    const double lcutoff = threshold_ <= 0.0 ? std::numeric_limits<double>::lowest() : log(threshold_) + mode_lprob;
+
+    counter_.assign(dim_number, 0);
+    partial_lprobs_.resize(dim_number + 1);
+    partial_masses_.resize(dim_number + 1);
+    partial_eprobs_.resize(dim_number + 1);
+    partial_lprobs_[dim_number] = 0.0;
+    partial_masses_[dim_number] = 0.0;
+    partial_eprobs_[dim_number] = 1.0;
+
+    max_confs_lp_sum_.resize(dim_number);
+    max_confs_lp_sum_[0] = marginals_[0]->getModeLProb();
+    for (int i = 1; i < dim_number - 1; ++i)
+    {
+      max_confs_lp_sum_[i] = max_confs_lp_sum_[i - 1] + marginals_[i]->getModeLProb();
+    }
+
+    auto recalc = [this](int idx)
+    {
+      for (; idx >= 0; --idx)
+      {
+        partial_lprobs_[idx] = partial_lprobs_[idx + 1] + marginals_[idx]->get_lProb(counter_[idx]);
+        partial_masses_[idx] = partial_masses_[idx + 1] + marginals_[idx]->get_mass(counter_[idx]);
+        partial_eprobs_[idx] = partial_eprobs_[idx + 1] * marginals_[idx]->get_eProb(counter_[idx]);
+      }
+    };
+
+    recalc(dim_number - 1);
+    counter_[0]--;
+
+    while (true)
+    {
+      counter_[0]++;
+      partial_lprobs_[0] = partial_lprobs_[1] + marginals_[0]->get_lProb(counter_[0]);
+      if (partial_lprobs_[0] >= lcutoff)
+      {
+        partial_masses_[0] = partial_masses_[1] + marginals_[0]->get_mass(counter_[0]);
+        partial_eprobs_[0] = partial_eprobs_[1] * marginals_[0]->get_eProb(counter_[0]);
+        masses_.push_back(partial_masses_[0]);
+        probabilities_.push_back(partial_eprobs_[0]);
+        continue;
+      }
+
+      // a carry is needed
+      int idx = 0;
+      bool found = false;
+      while (idx < dim_number - 1)
+      {
+        counter_[idx] = 0;
+        idx++;
+        counter_[idx]++;
+        partial_lprobs_[idx] = partial_lprobs_[idx + 1] + marginals_[idx]->get_lProb(counter_[idx]);
+        if (partial_lprobs_[idx] + max_confs_lp_sum_[idx - 1] >= lcutoff)
+        {
+          partial_masses_[idx] = partial_masses_[idx + 1] + marginals_[idx]->get_mass(counter_[idx]);
+          partial_eprobs_[idx] = partial_eprobs_[idx + 1] * marginals_[idx]->get_eProb(counter_[idx]);
+          recalc(idx - 1);
+          masses_.push_back(partial_masses_[0]);
+          probabilities_.push_back(partial_eprobs_[0]);
+          found = true;
+          break;
+        }
+      }
+      if (!found)
+      {
+        break;
+      }
+    }
+  }
+
+  void IsoSpec::clearCache()
+  {
+    marginal_cache_.clear();
+  }
 
   void runLayered(const std::string& formula)
   {
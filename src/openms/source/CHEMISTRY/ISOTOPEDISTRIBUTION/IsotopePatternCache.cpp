@@ -0,0 +1,157 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2018.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: Chris Bielow $
+// $Authors: Hannes Roest $
+// --------------------------------------------------------------------------
+
+
+#include <OpenMS/CHEMISTRY/ISOTOPEDISTRIBUTION/IsotopePatternCache.h>
+
+#include <OpenMS/CHEMISTRY/EmpiricalFormula.h>
+#include <OpenMS/CHEMISTRY/ISOTOPEDISTRIBUTION/CoarseIsotopePatternGenerator.h>
+
+#include <algorithm>
+#include <cmath>
+#include <functional>
+
+namespace OpenMS
+{
+  namespace
+  {
+    const double MASS_RESOLUTION = 0.001;
+
+    std::vector<double> getIntensities(const IsotopeDistribution& dist)
+    {
+      std::vector<double> intensities;
+      intensities.reserve(dist.size());
+      for (IsotopeDistribution::ConstIterator it = dist.begin(); it != dist.end(); ++it)
+      {
+        intensities.push_back(it->getIntensity());
+      }
+      return intensities;
+    }
+  }
+
+  IsotopePatternCache::IsotopePatternCache()
+  {
+  }
+
+  IsotopePatternCache* IsotopePatternCache::getInstance()
+  {
+    // initialization of local statics is thread-safe
+    static IsotopePatternCache cache;
+    return &cache;
+  }
+
+  std::size_t IsotopePatternCache::MassKeyHash_::operator()(const MassKey_& key) const
+  {
+    return std::hash<Int64>()(key.first) * 31 + key.second;
+  }
+
+  std::size_t IsotopePatternCache::FormulaKeyHash_::operator()(const FormulaKey_& key) const
+  {
+    return std::hash<std::string>()(key.first) * 31 + key.second;
+  }
+
+  const std::vector<double>& IsotopePatternCache::getAveragineIntensities(double mass, Size max_isotope)
+  {
+    MassKey_ key(Int64(std::floor(mass / MASS_RESOLUTION)), max_isotope);
+    const std::vector<double>* cached = nullptr;
+#pragma omp critical (IsotopePatternCache_averagine)
+    {
+      std::unordered_map<MassKey_, std::vector<double>, MassKeyHash_>::const_iterator pos = averagine_cache_.find(key);
+      if (pos != averagine_cache_.end()) cached = &pos->second;
+    }
+    if (cached) return *cached;
+
+    // compute outside of the critical section, if another thread was faster
+    // its pattern (which is the same) is kept:
+    CoarseIsotopePatternGenerator solver(max_isotope);
+    std::vector<double> intensities = getIntensities(solver.estimateFromPeptideWeight((key.first + 0.5) * MASS_RESOLUTION));
+    normalize_(intensities);
+#pragma omp critical (IsotopePatternCache_averagine)
+    cached = &averagine_cache_.emplace(key, std::move(intensities)).first->second;
+    return *cached;
+  }
+
+  const std::vector<double>& IsotopePatternCache::getFormulaIntensities(const EmpiricalFormula& formula, Size max_isotope)
+  {
+    FormulaKey_ key(formula.toString(), max_isotope);
+    const std::vector<double>* cached = nullptr;
+#pragma omp critical (IsotopePatternCache_formula)
+    {
+      std::unordered_map<FormulaKey_, std::vector<double>, FormulaKeyHash_>::const_iterator pos = formula_cache_.find(key);
+      if (pos != formula_cache_.end()) cached = &pos->second;
+    }
+    if (cached) return *cached;
+
+    std::vector<double> intensities = getIntensities(formula.getIsotopeDistribution(CoarseIsotopePatternGenerator(max_isotope)));
+    normalize_(intensities);
+#pragma omp critical (IsotopePatternCache_formula)
+    cached = &formula_cache_.emplace(key, std::move(intensities)).first->second;
+    return *cached;
+  }
+
+  double IsotopePatternCache::getMassResolution()
+  {
+    return MASS_RESOLUTION;
+  }
+
+  Size IsotopePatternCache::size() const
+  {
+    Size count(0);
+#pragma omp critical (IsotopePatternCache_averagine)
+    count += averagine_cache_.size();
+#pragma omp critical (IsotopePatternCache_formula)
+    count += formula_cache_.size();
+    return count;
+  }
+
+  void IsotopePatternCache::clear()
+  {
+#pragma omp critical (IsotopePatternCache_averagine)
+    averagine_cache_.clear();
+#pragma omp critical (IsotopePatternCache_formula)
+    formula_cache_.clear();
+  }
+
+  void IsotopePatternCache::normalize_(std::vector<double>& intensities)
+  {
+    if (intensities.empty()) return;
+    double max = *std::max_element(intensities.begin(), intensities.end());
+    if (max <= 0.0) return;
+    for (Size i = 0; i < intensities.size(); ++i)
+    {
+      intensities[i] /= max;
+    }
+  }
+
+}
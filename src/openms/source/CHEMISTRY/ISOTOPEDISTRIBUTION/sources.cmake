@@ -7,6 +7,7 @@ set(sources_list
   CoarseIsotopePatternGenerator.cpp
   FineIsotopePatternGenerator.cpp
   IsotopeDistribution.cpp
+  IsotopePatternCache.cpp
   IsoSpec.cpp
   IsotopePatternGenerator.cpp
 )
@@ -34,12 +34,60 @@
 //
 
 #include <iostream>
+#include <limits>
+#include <cmath>
 #include <OpenMS/CHEMISTRY/MASSDECOMPOSITION/IMS/RealMassDecomposer.h>
+#include <OpenMS/CONCEPT/Types.h>
 
 namespace OpenMS
 {
   namespace ims
   {
+    namespace
+    {
+      /**
+        Checks the decompositions of the integer decomposer against the real
+        mass and the constraints. Accepted decompositions are counted and, if
+        a store is given, collected. Stops the enumeration once
+        @p max_decompositions decompositions were accepted.
+      */
+      struct RealMassFilter
+      {
+        const Weights & weights;
+        double mass;
+        double error;
+        const RealMassDecomposer::constraints_type * constraints;
+        RealMassDecomposer::decompositions_type * store;
+        RealMassDecomposer::number_of_decompositions_type max_decompositions;
+        RealMassDecomposer::number_of_decompositions_type count;
+
+        bool operator()(const RealMassDecomposer::integer_decomposer_type::decomposition_type & decomposition)
+        {
+          double parent_mass = weights.getParentMass(decomposition);
+          if (fabs(parent_mass - mass) > error)
+          {
+            return true;
+          }
+          if (constraints != nullptr)
+          {
+            for (RealMassDecomposer::constraints_type::const_iterator it =
+                   constraints->begin(); it != constraints->end(); ++it)
+            {
+              if (decomposition[it->first] < it->second.first ||
+                  decomposition[it->first] > it->second.second)
+              {
+                return true;
+              }
+            }
+          }
+          if (store != nullptr)
+          {
+            store->push_back(decomposition);
+          }
+          return ++count < max_decompositions;
+        }
+      };
+    }
 
     RealMassDecomposer::RealMassDecomposer(const Weights & weights) :
       weights_(weights)
@@ -51,7 +99,29 @@ namespace OpenMS
         new integer_decomposer_type(weights));
     }
 
-    RealMassDecomposer::decompositions_type RealMassDecomposer::getDecompositions(double mass, double error)
+    template <typename Visitor>
+    void RealMassDecomposer::visitRange_(integer_value_type start_integer_mass, integer_value_type end_integer_mass, Visitor & visitor) const
+    {
+      // loops and finds decompositions for every integer mass,
+      // the visitor checks if real mass of decomposition lays in the allowed
+      // error interval [mass-error; mass+error]
+      for (integer_value_type integer_mass = start_integer_mass;
+           integer_mass < end_integer_mass; ++integer_mass)
+      {
+        if (!decomposer_->visitDecompositions(integer_mass, visitor))
+        {
+          return;
+        }
+      }
+    }
+
+    RealMassDecomposer::decompositions_type RealMassDecomposer::getDecompositions(double mass, double error) const
+    {
+      return getDecompositions(mass, error, std::numeric_limits<number_of_decompositions_type>::max());
+    }
+
+    RealMassDecomposer::decompositions_type RealMassDecomposer::getDecompositions(double mass, double error,
+                                                                                  number_of_decompositions_type max_decompositions) const
     {
       // defines the range of integers to be decomposed
       integer_value_type start_integer_mass = static_cast<integer_value_type>(
@@ -60,36 +130,18 @@ namespace OpenMS
         floor((1 + rounding_errors_.second) * (mass + error) / precision_));
 
       decompositions_type all_decompositions_from_range;
-
-      // loops and finds decompositions for every integer mass,
-      // then checks if real mass of decomposition lays in the allowed
-      // error interval [mass-error; mass+error]
-      for (integer_value_type integer_mass = start_integer_mass;
-           integer_mass < end_integer_mass; ++integer_mass)
+      if (max_decompositions == 0)
       {
-        decompositions_type decompositions =
-          decomposer_->getAllDecompositions(integer_mass);
-        for (decompositions_type::iterator pos = decompositions.begin();
-             pos != decompositions.end(); )
-        {
-          double parent_mass = weights_.getParentMass(*pos);
-          if (fabs(parent_mass - mass) > error)
-          {
-            pos = decompositions.erase(pos);
-          }
-          else
-          {
-            ++pos;
-          }
-        }
-        all_decompositions_from_range.insert(all_decompositions_from_range.end(),
-                                             decompositions.begin(), decompositions.end());
+        return all_decompositions_from_range;
       }
+
+      RealMassFilter filter = {weights_, mass, error, nullptr, &all_decompositions_from_range, max_decompositions, 0};
+      visitRange_(start_integer_mass, end_integer_mass, filter);
       return all_decompositions_from_range;
     }
 
     RealMassDecomposer::decompositions_type RealMassDecomposer::getDecompositions(double mass, double error,
-                                                                                  const constraints_type & constraints)
+                                                                                  const constraints_type & constraints) const
     {
 
       // defines the range of integers to be decomposed
@@ -100,55 +152,36 @@ namespace OpenMS
 
       decompositions_type all_decompositions_from_range;
 
-      // loops and finds decompositions for every integer mass,
-      // then checks if real mass of decomposition lays in the allowed
-      // error interval [mass-error; mass+error]
-      for (integer_value_type integer_mass = start_integer_mass;
-           integer_mass < end_integer_mass; ++integer_mass)
+      RealMassFilter filter = {weights_, mass, error, constraints.empty() ? nullptr : &constraints, &all_decompositions_from_range,
+                               std::numeric_limits<number_of_decompositions_type>::max(), 0};
+      visitRange_(start_integer_mass, end_integer_mass, filter);
+      return all_decompositions_from_range;
+    }
+
+    std::vector<RealMassDecomposer::decompositions_type> RealMassDecomposer::getDecompositions(const std::vector<double> & masses, double error) const
+    {
+      std::vector<decompositions_type> result(masses.size());
+      const SignedSize n = static_cast<SignedSize>(masses.size());
+
+      // the decomposer is only read, every thread writes to its own result entry;
+      // dynamic scheduling since the number of decompositions grows quickly with the mass
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic)
+#endif
+      for (SignedSize i = 0; i < n; ++i)
       {
-        decompositions_type decompositions =
-          decomposer_->getAllDecompositions(integer_mass);
-        for (decompositions_type::iterator pos = decompositions.begin();
-             pos != decompositions.end(); )
-        {
-          double parent_mass = weights_.getParentMass(*pos);
-          if (fabs(parent_mass - mass) > error)
-          {
-            pos = decompositions.erase(pos);
-          }
-          else
-          {
-            bool to_erase = false;
-            if (!constraints.empty())
-            {
-              for (constraints_type::const_iterator it =
-                     constraints.begin(); it != constraints.end(); ++it)
-              {
-                if ((*pos)[it->first] < it->second.first ||
-                    (*pos)[it->first] > it->second.second)
-                {
-                  to_erase = true;
-                  break;
-                }
-              }
-            }
-            if (to_erase)
-            {
-              pos = decompositions.erase(pos);
-            }
-            else
-            {
-              ++pos;
-            }
-          }
-        }
-        all_decompositions_from_range.insert(all_decompositions_from_range.end(),
-                                             decompositions.begin(), decompositions.end());
+        result[i] = getDecompositions(masses[i], error);
       }
-      return all_decompositions_from_range;
+      return result;
+    }
+
+    RealMassDecomposer::number_of_decompositions_type RealMassDecomposer::getNumberOfDecompositions(double mass, double error) const
+    {
+      return getNumberOfDecompositions(mass, error, std::numeric_limits<number_of_decompositions_type>::max());
     }
 
-    RealMassDecomposer::number_of_decompositions_type RealMassDecomposer::getNumberOfDecompositions(double mass, double error)
+    RealMassDecomposer::number_of_decompositions_type RealMassDecomposer::getNumberOfDecompositions(double mass, double error,
+                                                                                                    number_of_decompositions_type max_decompositions) const
     {
       // defines the range of integers to be decomposed
       integer_value_type start_integer_mass = static_cast<integer_value_type>(1);
@@ -160,27 +193,15 @@ namespace OpenMS
       integer_value_type end_integer_mass = static_cast<integer_value_type>(
         floor((1 + rounding_errors_.second) * (mass + error) / precision_));
 
-      number_of_decompositions_type number_of_decompositions = static_cast<number_of_decompositions_type>(0);
-
-      // loops and finds decompositions for every integer mass,
-      // then checks if real mass of decomposition lays in the allowed
-      // error interval [mass-error; mass+error]
-      for (integer_value_type integer_mass = start_integer_mass;
-           integer_mass < end_integer_mass; ++integer_mass)
+      if (max_decompositions == 0)
       {
-        decompositions_type decompositions =
-          decomposer_->getAllDecompositions(integer_mass);
-        for (decompositions_type::iterator pos = decompositions.begin();
-             pos != decompositions.end(); ++pos)
-        {
-          double parent_mass = weights_.getParentMass(*pos);
-          if (fabs(parent_mass - mass) <= error)
-          {
-            ++number_of_decompositions;
-          }
-        }
+        return 0;
       }
-      return number_of_decompositions;
+
+      // count only, no decompositions are stored
+      RealMassFilter filter = {weights_, mass, error, nullptr, nullptr, max_decompositions, 0};
+      visitRange_(start_integer_mass, end_integer_mass, filter);
+      return filter.count;
     }
 
   } // namespace ims
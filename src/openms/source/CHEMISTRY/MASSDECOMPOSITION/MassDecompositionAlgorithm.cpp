@@ -39,14 +39,57 @@
 #include <OpenMS/CHEMISTRY/ModificationDefinitionsSet.h>
 
 #include <iostream>
+#include <map>
 using namespace std;
 
 namespace OpenMS
 {
+  namespace
+  {
+    /// returns the decomposer of the given alphabet, the extended residue table is only computed on first use
+    std::shared_ptr<const ims::RealMassDecomposer> getCachedDecomposer(const ims::IMSAlphabet::masses_type & masses, double precision)
+    {
+      typedef std::pair<ims::IMSAlphabet::masses_type, double> Key;
+      static std::map<Key, std::shared_ptr<const ims::RealMassDecomposer> > cache;
+
+      std::shared_ptr<const ims::RealMassDecomposer> decomposer;
+#ifdef _OPENMP
+#pragma omp critical (MassDecompositionAlgorithm_cache)
+#endif
+      {
+        Key key(masses, precision);
+        std::map<Key, std::shared_ptr<const ims::RealMassDecomposer> >::const_iterator it = cache.find(key);
+        if (it != cache.end())
+        {
+          decomposer = it->second;
+        }
+        else
+        {
+          // initializes weights
+          ims::Weights weights(masses, precision);
+
+          // optimize alphabet by dividing by gcd
+          weights.divideByGCD();
+
+          // decomposes real values
+          decomposer = std::shared_ptr<const ims::RealMassDecomposer>(new ims::RealMassDecomposer(weights));
+
+          // only a few alphabets are used in practice, keep the cache from growing on parameter sweeps
+          if (cache.size() >= 16)
+          {
+            cache.clear();
+          }
+          cache[key] = decomposer;
+        }
+      }
+      return decomposer;
+    }
+  }
+
   MassDecompositionAlgorithm::MassDecompositionAlgorithm() :
     DefaultParamHandler("MassDecompositionAlgorithm"),
     alphabet_(nullptr),
-    decomposer_(nullptr)
+    decomposer_()
   {
     defaults_.setValue("decomp_weights_precision", 0.01, "precision used to calculate the decompositions, this only affects cache usage!", ListUtils::create<String>("advanced"));
     defaults_.setValue("tolerance", 0.3, "tolerance which is allowed for the decompositions");
@@ -71,14 +114,37 @@ namespace OpenMS
   MassDecompositionAlgorithm::~MassDecompositionAlgorithm()
   {
     delete alphabet_;
-    delete decomposer_;
   }
 
-  void MassDecompositionAlgorithm::getDecompositions(vector<MassDecomposition> & decomps, double mass)
+  void MassDecompositionAlgorithm::getDecompositions(vector<MassDecomposition> & decomps, double mass) const
   {
     double tolerance((double) param_.getValue("tolerance"));
-    ims::RealMassDecomposer::decompositions_type decompositions = decomposer_->getDecompositions(mass, tolerance);
+    getDecompositions(decomps, mass, tolerance);
+  }
 
+  void MassDecompositionAlgorithm::getDecompositions(vector<MassDecomposition> & decomps, double mass, double tolerance) const
+  {
+    convertDecompositions_(decomposer_->getDecompositions(mass, tolerance), decomps);
+  }
+
+  void MassDecompositionAlgorithm::getDecompositions(vector<vector<MassDecomposition> > & decomps, const vector<double> & weights) const
+  {
+    double tolerance((double) param_.getValue("tolerance"));
+    decomps.clear();
+    decomps.resize(weights.size());
+
+    const SignedSize n = static_cast<SignedSize>(weights.size());
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic)
+#endif
+    for (SignedSize i = 0; i < n; ++i)
+    {
+      convertDecompositions_(decomposer_->getDecompositions(weights[i], tolerance), decomps[i]);
+    }
+  }
+
+  void MassDecompositionAlgorithm::convertDecompositions_(const ims::RealMassDecomposer::decompositions_type & decompositions, vector<MassDecomposition> & decomps) const
+  {
     for (ims::RealMassDecomposer::decompositions_type::const_iterator pos = decompositions.begin(); pos != decompositions.end(); ++pos)
     {
       String d;
@@ -188,11 +254,6 @@ namespace OpenMS
     {
       delete alphabet_;
     }
-    if (decomposer_ != nullptr)
-    {
-      delete decomposer_;
-    }
-
     // init mass decomposer
     alphabet_ = new ims::IMSAlphabet();
     for (Map<char, double>::ConstIterator it = aa_to_weight.begin(); it != aa_to_weight.end(); ++it)
@@ -200,14 +261,8 @@ namespace OpenMS
       alphabet_->push_back(String(it->first), it->second);
     }
 
-    // initializes weights
-    ims::Weights weights(alphabet_->getMasses(), (double) param_.getValue("decomp_weights_precision"));
-
-    // optimize alphabet by dividing by gcd
-    weights.divideByGCD();
-
-    // decomposes real values
-    decomposer_ = new ims::RealMassDecomposer(weights);
+    // the extended residue table is shared by all instances with the same alphabet
+    decomposer_ = getCachedDecomposer(alphabet_->getMasses(), (double) param_.getValue("decomp_weights_precision"));
 
     return;
   }
@@ -37,11 +37,13 @@
 
 #include <OpenMS/FORMAT/UnimodXMLFile.h>
 #include <OpenMS/SYSTEM/File.h>
+#include <OpenMS/CHEMISTRY/ElementDB.h>
 #include <OpenMS/CHEMISTRY/ResidueDB.h>
 #include <OpenMS/CHEMISTRY/Residue.h>
 #include <OpenMS/CONCEPT/LogStream.h>
 #include <OpenMS/CONCEPT/Macros.h>
 
+#include <exception>
 #include <fstream>
 
 using namespace std;
@@ -53,20 +55,85 @@ namespace OpenMS
 
   ModificationsDB::ModificationsDB(OpenMS::String unimod_file, OpenMS::String psimod_file, OpenMS::String xlmod_file)
   {
-    if (!unimod_file.empty())
+    // The three files are independent, so they are parsed concurrently into
+    // temporary containers. Merging into the database has to happen in the
+    // original order (Unimod, PSI-MOD, XLMOD), as OBO terms are mapped onto
+    // already known Unimod entries.
+    vector<ResidueModification*> unimod_mods;
+    multimap<String, ResidueModification> psimod_mods, xlmod_mods;
+
+    // file lookup and formula parsing initialize function-local statics on
+    // first use, make sure this happens before the threads start
+    File::getOpenMSDataPath();
+    ElementDB::getInstance();
+
+    std::exception_ptr error;
+#ifdef _OPENMP
+#pragma omp parallel sections
+#endif
     {
-      readFromUnimodXMLFile(unimod_file);
+#ifdef _OPENMP
+#pragma omp section
+#endif
+      {
+        try
+        {
+          if (!unimod_file.empty()) UnimodXMLFile().load(unimod_file, unimod_mods);
+        }
+        catch (...)
+        {
+#ifdef _OPENMP
+#pragma omp critical (ModificationsDB_error)
+#endif
+          if (!error) error = std::current_exception();
+        }
+      }
+#ifdef _OPENMP
+#pragma omp section
+#endif
+      {
+        try
+        {
+          if (!psimod_file.empty()) parseOBOFile_(psimod_file, psimod_mods);
+        }
+        catch (...)
+        {
+#ifdef _OPENMP
+#pragma omp critical (ModificationsDB_error)
+#endif
+          if (!error) error = std::current_exception();
+        }
+      }
+#ifdef _OPENMP
+#pragma omp section
+#endif
+      {
+        try
+        {
+          if (!xlmod_file.empty()) parseOBOFile_(xlmod_file, xlmod_mods);
+        }
+        catch (...)
+        {
+#ifdef _OPENMP
+#pragma omp critical (ModificationsDB_error)
+#endif
+          if (!error) error = std::current_exception();
+        }
+      }
     }
 
-    if (!psimod_file.empty())
+    if (error)
     {
-      readFromOBOFile(psimod_file);
+      for (vector<ResidueModification*>::iterator it = unimod_mods.begin(); it != unimod_mods.end(); ++it)
+      {
+        delete *it;
+      }
+      std::rethrow_exception(error);
     }
 
-    if (!xlmod_file.empty())
-    {
-      readFromOBOFile(xlmod_file);
-    }
+    addUnimodModifications_(unimod_mods);
+    addOBOModifications_(psimod_mods);
+    addOBOModifications_(xlmod_mods);
 
     is_instantiated_ = true;
   }
@@ -272,8 +339,12 @@ namespace OpenMS
   {
     vector<ResidueModification*> new_mods;
     UnimodXMLFile().load(filename, new_mods);
+    addUnimodModifications_(new_mods);
+  }
 
-    for (vector<ResidueModification*>::iterator it = new_mods.begin(); it != new_mods.end(); ++it)
+  void ModificationsDB::addUnimodModifications_(const vector<ResidueModification*>& new_mods)
+  {
+    for (vector<ResidueModification*>::const_iterator it = new_mods.begin(); it != new_mods.end(); ++it)
     {
       // create full ID based on other information:
       (*it)->setFullId();
@@ -305,11 +376,16 @@ namespace OpenMS
   }
 
   void ModificationsDB::readFromOBOFile(const String& filename)
+  {
+    multimap<String, ResidueModification> all_mods;
+    parseOBOFile_(filename, all_mods);
+    addOBOModifications_(all_mods);
+  }
+
+  void ModificationsDB::parseOBOFile_(const String& filename, multimap<String, ResidueModification>& all_mods)
   {
     ResidueModification mod;
     // add multiple mods for multiple specificities
-    //Map<String, ResidueModification> all_mods;
-    multimap<String, ResidueModification> all_mods;
 
     ifstream is(File::find(filename).c_str());
     String line, line_wo_spaces, id;
@@ -557,7 +633,10 @@ namespace OpenMS
       origin = "";
       mod = ResidueModification();
     }
+  }
 
+  void ModificationsDB::addOBOModifications_(const multimap<String, ResidueModification>& all_mods)
+  {
     // now use the term and all synonyms to build the database
     for (multimap<String, ResidueModification>::const_iterator it = all_mods.begin(); it != all_mods.end(); ++it)
     {
@@ -34,6 +34,8 @@
 
 #include <OpenMS/CHEMISTRY/ProteaseDigestion.h>
 #include <OpenMS/CHEMISTRY/ProteaseDB.h>
+#include <OpenMS/CHEMISTRY/ResidueDB.h>
+#include <OpenMS/CHEMISTRY/Residue.h>
 #include <OpenMS/SYSTEM/File.h>
 #include <OpenMS/CONCEPT/LogStream.h>
 #include <boost/regex.hpp>
@@ -45,6 +47,26 @@ using namespace std;
 
 namespace OpenMS
 {
+  namespace
+  {
+    /// monoisotopic internal weights by one-letter code; negative for characters that are not residues
+    const std::vector<double>& residueWeightTable()
+    {
+      static const std::vector<double> table = []()
+      {
+        std::vector<double> weights(256, -1.0);
+        const ResidueDB* db = ResidueDB::getInstance();
+        for (Size c = 0; c < weights.size(); ++c)
+        {
+          const Residue* r = db->getResidue((unsigned char)c);
+          if (r != nullptr) weights[c] = r->getMonoWeight(Residue::Internal);
+        }
+        return weights;
+      }();
+      return table;
+    }
+  }
+
   void ProteaseDigestion::setEnzyme(const String& enzyme_name)
   {
     enzyme_ = ProteaseDB::getInstance()->getEnzyme(enzyme_name);
@@ -138,5 +160,78 @@ namespace OpenMS
     return wrong_size;
   }
 
+  Size ProteaseDigestion::digestProtein_(const String& protein, Size protein_index, std::vector<int>& positions, std::vector<double>& prefix_weights, std::vector<Size>& prefix_unknown,
+                                         std::vector<DigestionProduct>& output, Size min_length, Size max_length, double min_mass, double max_mass) const
+  {
+    // disable max length/mass filter by setting to maximum
+    if (max_length == 0 || max_length > protein.size())
+    {
+      max_length = protein.size();
+    }
+    if (max_mass == 0)
+    {
+      max_mass = std::numeric_limits<double>::max();
+    }
+
+    // prefix sums of residue weights, unknown residues are counted separately
+    const std::vector<double>& weight_table = residueWeightTable();
+    prefix_weights.resize(protein.size() + 1);
+    prefix_unknown.resize(protein.size() + 1);
+    prefix_weights[0] = 0.0;
+    prefix_unknown[0] = 0;
+    for (Size i = 0; i < protein.size(); ++i)
+    {
+      const double w = weight_table[(unsigned char)protein[i]];
+      prefix_weights[i + 1] = prefix_weights[i] + std::max(w, 0.0);
+      prefix_unknown[i + 1] = prefix_unknown[i] + (w < 0.0);
+    }
+    const double water = Residue::getInternalToFull().getMonoWeight();
+
+    Size wrong_size(0);
+    auto report = [&](Size begin, Size l)
+    {
+      if (l < min_length || l > max_length || prefix_unknown[begin + l] != prefix_unknown[begin])
+      {
+        ++wrong_size;
+        return;
+      }
+      const double weight = prefix_weights[begin + l] - prefix_weights[begin] + water;
+      if (weight < min_mass || weight > max_mass)
+      {
+        ++wrong_size;
+        return;
+      }
+      DigestionProduct p = {protein_index, begin, l, weight};
+      output.push_back(p);
+    };
+
+    // same enumeration as digest()
+    Size mc = (enzyme_->getName() == UnspecificCleavage) ? std::numeric_limits<Size>::max() : missed_cleavages_;
+    tokenize_(protein, positions);
+    positions.push_back(protein.size()); // positions now contains 0, x1, ... xn, end
+    Size count = positions.size();
+    Size begin = positions[0];
+    for (Size i = 1; i < count; ++i)
+    {
+      report(begin, positions[i] - begin);
+      begin = positions[i];
+    }
+
+    // missed cleavages
+    if (positions.size() > 1 && mc != 0) // there is at least one cleavage site (in addition to last position)!
+    {
+      for (Size mcs = 1; ((mcs <= mc) && (mcs < count - 1)); ++mcs)
+      {
+        begin = positions[0];
+        for (Size j = 1; j < count - mcs; ++j)
+        {
+          report(begin, positions[j + mcs] - begin);
+          begin = positions[j];
+        }
+      }
+    }
+    return wrong_size;
+  }
+
 } //namespace OpenMS
 
@@ -0,0 +1,350 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2018.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: Timo Sachsenberg $
+// $Authors: Timo Sachsenberg $
+// --------------------------------------------------------------------------
+
+#include <OpenMS/CHEMISTRY/ResidueMassTable.h>
+
+#include <OpenMS/CHEMISTRY/AASequence.h>
+#include <OpenMS/CHEMISTRY/ModificationsDB.h>
+#include <OpenMS/CHEMISTRY/Residue.h>
+#include <OpenMS/CHEMISTRY/ResidueDB.h>
+#include <OpenMS/CONCEPT/Constants.h>
+#include <OpenMS/CONCEPT/Exception.h>
+
+#include <algorithm>
+#include <functional>
+#include <limits>
+
+using std::vector;
+
+namespace OpenMS
+{
+  const ResidueMassTable::ResidueCode ResidueMassTable::INVALID_CODE_ = std::numeric_limits<ResidueMassTable::ResidueCode>::max();
+
+  ResidueMassTable::ResidueMassTable(const StringList& modifications) :
+    unmodified_codes_(256, INVALID_CODE_),
+    internal_to_full_(Residue::getInternalToFull().getMonoWeight())
+  {
+    ResidueDB* residue_db = ResidueDB::getInstance();
+
+    // unmodified residues ('X' has no defined mass)
+    for (int c = 'A'; c <= 'Z'; ++c)
+    {
+      const Residue* residue = residue_db->getResidue(static_cast<unsigned char>(c));
+      if (c == 'X' || residue == nullptr || residue->getMonoWeight() <= 0.0) { continue; }
+
+      ResidueEntry_ entry = {residue->getMonoWeight(Residue::Internal), static_cast<char>(c), -1};
+      unmodified_codes_[c] = residues_.size();
+      residues_.push_back(entry);
+    }
+
+    // modifications and modified residues
+    modified_codes_.resize(modifications.size() * 256, INVALID_CODE_);
+    for (Size m = 0; m < modifications.size(); ++m)
+    {
+      const ResidueModification& mod = ModificationsDB::getInstance()->getModification(modifications[m]);
+      ModificationEntry_ mod_entry = {mod.getFullId(), mod.getDiffMonoMass(), mod.getOrigin(), mod.getTermSpecificity()};
+      modifications_.push_back(mod_entry);
+      modification_index_[modifications[m]] = m;
+      modification_index_[mod.getFullId()] = m;
+
+      if (mod.getTermSpecificity() != ResidueModification::ANYWHERE) { continue; }
+
+      const unsigned char origin = static_cast<unsigned char>(mod.getOrigin());
+      if (unmodified_codes_[origin] == INVALID_CODE_) { continue; }
+
+      const Residue* modified = residue_db->getModifiedResidue(residue_db->getResidue(origin), mod.getFullId());
+      ResidueEntry_ entry = {modified->getMonoWeight(Residue::Internal), static_cast<char>(origin), static_cast<Int>(m)};
+      modified_codes_[m * 256 + origin] = residues_.size();
+      residues_.push_back(entry);
+    }
+  }
+
+  Size ResidueMassTable::getNumberOfResidues() const
+  {
+    return residues_.size();
+  }
+
+  Size ResidueMassTable::getNumberOfModifications() const
+  {
+    return modifications_.size();
+  }
+
+  Int ResidueMassTable::getModificationIndex(const String& modification) const
+  {
+    std::map<String, Size>::const_iterator it = modification_index_.find(modification);
+    return it == modification_index_.end() ? -1 : static_cast<Int>(it->second);
+  }
+
+  double ResidueMassTable::getResidueMass(ResidueCode code) const
+  {
+    return residues_[code].mass;
+  }
+
+  char ResidueMassTable::getOneLetterCode(ResidueCode code) const
+  {
+    return residues_[code].one_letter_code;
+  }
+
+  Int ResidueMassTable::getResidueModification(ResidueCode code) const
+  {
+    return residues_[code].modification;
+  }
+
+  double ResidueMassTable::getModificationMass(Size modification) const
+  {
+    return modifications_[modification].diff_mono_mass;
+  }
+
+  bool ResidueMassTable::getModifiedResidue(ResidueCode code, Size modification, ResidueCode& modified) const
+  {
+    if (residues_[code].modification != -1) { return false; }
+    const ResidueCode result = modified_codes_[modification * 256 + static_cast<unsigned char>(residues_[code].one_letter_code)];
+    if (result == INVALID_CODE_) { return false; }
+    modified = result;
+    return true;
+  }
+
+  bool ResidueMassTable::encode(const String& sequence, EncodedSequence& encoded) const
+  {
+    encoded.residues.resize(sequence.size());
+    encoded.n_term_modification = -1;
+    encoded.c_term_modification = -1;
+    for (Size i = 0; i < sequence.size(); ++i)
+    {
+      const ResidueCode code = unmodified_codes_[static_cast<unsigned char>(sequence[i])];
+      if (code == INVALID_CODE_) { return false; }
+      encoded.residues[i] = code;
+    }
+    return true;
+  }
+
+  void ResidueMassTable::encode(const AASequence& peptide, EncodedSequence& encoded) const
+  {
+    encoded.residues.resize(peptide.size());
+    encoded.n_term_modification = -1;
+    encoded.c_term_modification = -1;
+    for (Size i = 0; i < peptide.size(); ++i)
+    {
+      const Residue& residue = peptide[i];
+      ResidueCode code = unmodified_codes_[static_cast<unsigned char>(residue.getOneLetterCode()[0])];
+      if (code == INVALID_CODE_)
+      {
+        throw Exception::ElementNotFound(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, residue.getName());
+      }
+      if (residue.isModified())
+      {
+        const Int mod = getModificationIndex(residue.getModification()->getFullId());
+        if (mod == -1 || !getModifiedResidue(code, mod, code))
+        {
+          throw Exception::ElementNotFound(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, residue.getModification()->getFullId());
+        }
+      }
+      encoded.residues[i] = code;
+    }
+    if (peptide.hasNTerminalModification())
+    {
+      encoded.n_term_modification = getModificationIndex(peptide.getNTerminalModification()->getFullId());
+      if (encoded.n_term_modification == -1)
+      {
+        throw Exception::ElementNotFound(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, peptide.getNTerminalModification()->getFullId());
+      }
+    }
+    if (peptide.hasCTerminalModification())
+    {
+      encoded.c_term_modification = getModificationIndex(peptide.getCTerminalModification()->getFullId());
+      if (encoded.c_term_modification == -1)
+      {
+        throw Exception::ElementNotFound(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, peptide.getCTerminalModification()->getFullId());
+      }
+    }
+  }
+
+  void ResidueMassTable::applyFixedModifications(const vector<Size>& modifications, EncodedSequence& encoded) const
+  {
+    // terminal modifications without amino acid preference
+    for (Size m : modifications)
+    {
+      const ModificationEntry_& mod = modifications_[m];
+      if (mod.term_specificity == ResidueModification::N_TERM && encoded.n_term_modification == -1)
+      {
+        encoded.n_term_modification = m;
+      }
+      else if (mod.term_specificity == ResidueModification::C_TERM && encoded.c_term_modification == -1)
+      {
+        encoded.c_term_modification = m;
+      }
+    }
+
+    for (Size i = 0; i < encoded.residues.size(); ++i)
+    {
+      // skip already modified residues
+      if (residues_[encoded.residues[i]].modification != -1) { continue; }
+
+      const ResidueCode unmodified = encoded.residues[i];
+      for (Size m : modifications)
+      {
+        const ModificationEntry_& mod = modifications_[m];
+        if (residues_[unmodified].one_letter_code != mod.origin) { continue; }
+
+        if (mod.term_specificity == ResidueModification::ANYWHERE)
+        {
+          getModifiedResidue(unmodified, m, encoded.residues[i]);
+        }
+        else if (mod.term_specificity == ResidueModification::C_TERM && i == encoded.residues.size() - 1)
+        {
+          encoded.c_term_modification = m;
+        }
+        else if (mod.term_specificity == ResidueModification::N_TERM && i == 0)
+        {
+          encoded.n_term_modification = m;
+        }
+      }
+    }
+  }
+
+  void ResidueMassTable::getMassRange(const EncodedSequence& encoded, const vector<Size>& modifications, Size max_variable_mods, double& min_mass, double& max_mass) const
+  {
+    min_mass = max_mass = getMonoWeight(encoded);
+    if (encoded.residues.empty() || max_variable_mods == 0 || modifications.empty()) { return; }
+
+    // smallest (<= 0) and largest (>= 0) mass difference of a modification at each site
+    vector<double> site_min, site_max;
+    auto addSite = [&site_min, &site_max](double lowest, double highest)
+    {
+      if (lowest < 0.0) { site_min.push_back(lowest); }
+      if (highest > 0.0) { site_max.push_back(highest); }
+    };
+
+    const double n_term_current = encoded.n_term_modification == -1 ? 0.0 : modifications_[encoded.n_term_modification].diff_mono_mass;
+    const double c_term_current = encoded.c_term_modification == -1 ? 0.0 : modifications_[encoded.c_term_modification].diff_mono_mass;
+    const Size last = encoded.residues.size() - 1;
+
+    // terminal modifications (all N-/C-terminal modifications if the terminus is not modified)
+    double n_lowest(0.0), n_highest(0.0), c_lowest(0.0), c_highest(0.0);
+    for (Size m : modifications)
+    {
+      const ModificationEntry_& mod = modifications_[m];
+      if (mod.term_specificity == ResidueModification::N_TERM && encoded.n_term_modification == -1)
+      {
+        n_lowest = std::min(n_lowest, mod.diff_mono_mass);
+        n_highest = std::max(n_highest, mod.diff_mono_mass);
+      }
+      else if (mod.term_specificity == ResidueModification::C_TERM && encoded.c_term_modification == -1)
+      {
+        c_lowest = std::min(c_lowest, mod.diff_mono_mass);
+        c_highest = std::max(c_highest, mod.diff_mono_mass);
+      }
+    }
+
+    for (Size i = 0; i <= last; ++i)
+    {
+      const ResidueEntry_& residue = residues_[encoded.residues[i]];
+      if (residue.modification != -1) { continue; }
+
+      double lowest(0.0), highest(0.0);
+      for (Size m : modifications)
+      {
+        const ModificationEntry_& mod = modifications_[m];
+        if (residue.one_letter_code != mod.origin) { continue; }
+
+        double delta(0.0);
+        if (mod.term_specificity == ResidueModification::ANYWHERE)
+        {
+          ResidueCode modified;
+          if (!getModifiedResidue(encoded.residues[i], m, modified)) { continue; }
+          delta = residues_[modified].mass - residue.mass;
+        }
+        else if (mod.term_specificity == ResidueModification::N_TERM && i == 0)
+        {
+          // placed at the terminus (replacing a terminal modification) or at the residue, depending on the number of variable modifications
+          n_lowest = std::min(n_lowest, mod.diff_mono_mass - n_term_current);
+          n_highest = std::max(n_highest, mod.diff_mono_mass - n_term_current);
+          delta = mod.diff_mono_mass;
+        }
+        else if (mod.term_specificity == ResidueModification::C_TERM && i == last)
+        {
+          c_lowest = std::min(c_lowest, mod.diff_mono_mass - c_term_current);
+          c_highest = std::max(c_highest, mod.diff_mono_mass - c_term_current);
+          delta = mod.diff_mono_mass;
+        }
+        else
+        {
+          continue;
+        }
+        lowest = std::min(lowest, delta);
+        highest = std::max(highest, delta);
+      }
+      addSite(lowest, highest);
+    }
+    addSite(n_lowest, n_highest);
+    addSite(c_lowest, c_highest);
+
+    // the max_variable_mods sites with the largest / smallest differences
+    if (site_max.size() > max_variable_mods)
+    {
+      std::nth_element(site_max.begin(), site_max.begin() + max_variable_mods, site_max.end(), std::greater<double>());
+      site_max.resize(max_variable_mods);
+    }
+    if (site_min.size() > max_variable_mods)
+    {
+      std::nth_element(site_min.begin(), site_min.begin() + max_variable_mods, site_min.end());
+      site_min.resize(max_variable_mods);
+    }
+    for (double delta : site_max) { max_mass += delta; }
+    for (double delta : site_min) { min_mass += delta; }
+  }
+
+  double ResidueMassTable::getMonoWeight(const EncodedSequence& encoded, Int charge) const
+  {
+    if (encoded.residues.empty()) { return 0.0; }
+
+    // same order of summation as AASequence::getMonoWeight()
+    double mono_weight(Constants::PROTON_MASS_U * charge);
+    if (encoded.n_term_modification != -1)
+    {
+      mono_weight += modifications_[encoded.n_term_modification].diff_mono_mass;
+    }
+    if (encoded.c_term_modification != -1)
+    {
+      mono_weight += modifications_[encoded.c_term_modification].diff_mono_mass;
+    }
+    for (ResidueCode code : encoded.residues)
+    {
+      mono_weight += residues_[code].mass;
+    }
+    return mono_weight + internal_to_full_;
+  }
+
+}
+
@@ -46,6 +46,17 @@
 namespace OpenMS
 {
 
+  namespace
+  {
+    // read-only lookup (unlike operator[] it is safe to use from several threads), 0 for unknown residues
+    template <typename ValueType>
+    inline ValueType lookupValue_(const std::map<String, ValueType>& values, const String& key)
+    {
+      typename std::map<String, ValueType>::const_iterator it = values.find(key);
+      return it == values.end() ? ValueType(0) : it->second;
+    }
+  }
+
   std::map<String, Size> SvmTheoreticalSpectrumGenerator::aa_to_index_;
   std::map<String, double> SvmTheoreticalSpectrumGenerator::hydrophobicity_;
   std::map<String, double> SvmTheoreticalSpectrumGenerator::helicity_;
@@ -246,7 +257,7 @@ namespace OpenMS
   {
   }
 
-  Size SvmTheoreticalSpectrumGenerator::generateDescriptorSet_(AASequence peptide, Size position, IonType type, Size /* precursor_charge */, DescriptorSet& desc_set)
+  Size SvmTheoreticalSpectrumGenerator::generateDescriptorSet_(const AASequence& peptide, Size position, IonType type, Size /* precursor_charge */, DescriptorSet& desc_set)
   {
 
     std::vector<svm_node> descriptors_tmp;
@@ -280,13 +291,13 @@ namespace OpenMS
     svm_node node;
 
     //RB_C
-    node.index = index + (Int)aa_to_index_[peptide.getResidue(position + 1).getOneLetterCode()];
+    node.index = index + (Int)lookupValue_(aa_to_index_, peptide.getResidue(position + 1).getOneLetterCode());
     node.value = 1;
     descriptors_tmp.push_back(node);
     index += (Int)num_aa;
 
     //RB_N
-    node.index = index + (Int)aa_to_index_[peptide.getResidue(position).getOneLetterCode()];
+    node.index = index + (Int)lookupValue_(aa_to_index_, peptide.getResidue(position).getOneLetterCode());
     node.value = 1;
     descriptors_tmp.push_back(node);
     index += (Int)num_aa;
@@ -313,39 +324,39 @@ namespace OpenMS
 
     //BaRB_N
     node.index = index++;
-    node.value = basicity_[res_n_string];
+    node.value = lookupValue_(basicity_, res_n_string);
     descriptors_tmp.push_back(node);
 
     //BaRB_C
     node.index = index++;
-    node.value = basicity_[res_c_string];
+    node.value = lookupValue_(basicity_, res_c_string);
     descriptors_tmp.push_back(node);
 
     //BaRB_A
     node.index = index++;
-    node.value = (basicity_[res_n_string] + basicity_[res_c_string]) / 2.0;
+    node.value = (lookupValue_(basicity_, res_n_string) + lookupValue_(basicity_, res_c_string)) / 2.0;
     descriptors_tmp.push_back(node);
 
     //BaRB_D
     node.index = index++;
-    node.value = basicity_[res_n_string] - basicity_[res_c_string];
+    node.value = lookupValue_(basicity_, res_n_string) - lookupValue_(basicity_, res_c_string);
     descriptors_tmp.push_back(node);
 
     double ba_p = 0, hy_p = 0, ba_yi = 0, hy_yi = 0, ba_bi = 0, hy_bi = 0;
     for (Size i = 0; i < peptide.size(); ++i)
     {
-      ba_p += basicity_[peptide.getResidue(i).getOneLetterCode()];
-      hy_p += hydrophobicity_[peptide.getResidue(i).getOneLetterCode()];
+      ba_p += lookupValue_(basicity_, peptide.getResidue(i).getOneLetterCode());
+      hy_p += lookupValue_(hydrophobicity_, peptide.getResidue(i).getOneLetterCode());
     }
     for (Size i = 0; i < position + 1; ++i)
     {
-      ba_bi += basicity_[peptide.getResidue(i).getOneLetterCode()];
-      hy_bi += hydrophobicity_[peptide.getResidue(i).getOneLetterCode()];
+      ba_bi += lookupValue_(basicity_, peptide.getResidue(i).getOneLetterCode());
+      hy_bi += lookupValue_(hydrophobicity_, peptide.getResidue(i).getOneLetterCode());
     }
     for (Size i = position + 1; i < peptide.size(); ++i)
     {
-      ba_yi += basicity_[peptide.getResidue(i).getOneLetterCode()];
-      hy_yi += hydrophobicity_[peptide.getResidue(i).getOneLetterCode()];
+      ba_yi += lookupValue_(basicity_, peptide.getResidue(i).getOneLetterCode());
+      hy_yi += lookupValue_(hydrophobicity_, peptide.getResidue(i).getOneLetterCode());
     }
 
     //BaYI
@@ -365,42 +376,42 @@ namespace OpenMS
 
     //HeRB_N
     node.index = index++;
-    node.value = helicity_[res_n_string];
+    node.value = lookupValue_(helicity_, res_n_string);
     descriptors_tmp.push_back(node);
 
     //HeRB_C
     node.index = index++;
-    node.value = helicity_[res_c_string];
+    node.value = lookupValue_(helicity_, res_c_string);
     descriptors_tmp.push_back(node);
 
     //HeRB_A
     node.index = index++;
-    node.value = (helicity_[res_n_string] + helicity_[res_c_string]) / 2;
+    node.value = (lookupValue_(helicity_, res_n_string) + lookupValue_(helicity_, res_c_string)) / 2;
     descriptors_tmp.push_back(node);
 
     //HeRB_D
     node.index = index++;
-    node.value = helicity_[res_n_string] - helicity_[res_c_string];
+    node.value = lookupValue_(helicity_, res_n_string) - lookupValue_(helicity_, res_c_string);
     descriptors_tmp.push_back(node);
 
     //HyRB_N
     node.index = index++;
-    node.value = hydrophobicity_[res_n_string];
+    node.value = lookupValue_(hydrophobicity_, res_n_string);
     descriptors_tmp.push_back(node);
 
     //HyRB_C
     node.index = index++;
-    node.value = hydrophobicity_[res_c_string];
+    node.value = lookupValue_(hydrophobicity_, res_c_string);
     descriptors_tmp.push_back(node);
 
     //HyRB_A
     node.index = index++;
-    node.value = (hydrophobicity_[res_n_string] + hydrophobicity_[res_c_string]) / 2;
+    node.value = (lookupValue_(hydrophobicity_, res_n_string) + lookupValue_(hydrophobicity_, res_c_string)) / 2;
     descriptors_tmp.push_back(node);
 
     //HyRB_D
     node.index = index++;
-    node.value = hydrophobicity_[res_n_string] - hydrophobicity_[res_c_string];
+    node.value = lookupValue_(hydrophobicity_, res_n_string) - lookupValue_(hydrophobicity_, res_c_string);
     descriptors_tmp.push_back(node);
 
     //Hy_YI
@@ -791,8 +802,10 @@ namespace OpenMS
       std::vector<double> predicted_intensity(peptide.size(), 0.);
       std::vector<bool> predicted_class(peptide.size(), false);
 
-#pragma omp parallel for
-      for (SignedSize i = 1; i < (SignedSize)peptide.size(); ++i)
+      // collect the fragmentation positions for which this type is predicted
+      std::vector<Size> positions;
+      positions.reserve(peptide.size());
+      for (Size i = 1; i < peptide.size(); ++i)
       {
         //determine whether type is N- or C-terminal
         if (residue == Residue::AIon || residue == Residue::BIon || residue == Residue::CIon)
@@ -820,33 +833,46 @@ namespace OpenMS
         {
           LOG_ERROR << "Requested unsupported ion type" << std::endl;
         }
+        positions.push_back(i);
+      }
 
-        DescriptorSet descriptor;
-        generateDescriptorSet_(peptide, i - 1, mp_.ion_types[type_nr], precursor_charge, descriptor);
+      // build (and scale) the descriptors of all positions
+      std::vector<DescriptorSet> descriptors(positions.size());
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic, 4)
+#endif
+      for (SignedSize k = 0; k < (SignedSize)positions.size(); ++k)
+      {
+        generateDescriptorSet_(peptide, positions[k] - 1, mp_.ion_types[type_nr], precursor_charge, descriptors[k]);
         if (mp_.scaling_lower != mp_.scaling_upper)
         {
-          scaleDescriptorSet_(descriptor, mp_.scaling_lower, mp_.scaling_upper);
+          scaleDescriptorSet_(descriptors[k], mp_.scaling_lower, mp_.scaling_upper);
         }
+      }
 
-        if (simulation_type == 0)
+      // evaluate the SVM once for all positions (SVMWrapper::predict is parallelized itself)
+      std::vector<svm_node*> svm_input(positions.size());
+      for (Size k = 0; k < positions.size(); ++k)
+      {
+        svm_input[k] = &descriptors[k].descriptors[0];
+      }
+      std::vector<double> svm_output;
+      if (simulation_type == 0)
+      {
+        mp_.class_models[type_nr].get()->predict(svm_input, svm_output);
+        for (Size k = 0; k < svm_output.size(); ++k)
         {
-          std::vector<double> tmp_out;
-          std::vector<svm_node*> tmp_in(1, &descriptor.descriptors[0]);
-
-          mp_.class_models[type_nr].get()->predict(tmp_in, tmp_out);
-          predicted_class[i] = tmp_out[0];
+          predicted_class[positions[k]] = svm_output[k];
         }
-
-        if (simulation_type == 1)
+      }
+      else if (simulation_type == 1)
+      {
+        mp_.reg_models[type_nr].get()->predict(svm_input, svm_output);
+        for (Size k = 0; k < svm_output.size(); ++k)
         {
-          std::vector<double> tmp_out;
-          std::vector<svm_node*> tmp_in(1, &descriptor.descriptors[0]);
-
-          mp_.reg_models[type_nr].get()->predict(tmp_in, tmp_out);
-          predicted_intensity[i] = std::min(std::max(0., tmp_out[0]), 1.0);
+          predicted_intensity[positions[k]] = std::min(std::max(0., svm_output[k]), 1.0);
         }
       }
-      //end of parallel execution
 
 
 
@@ -41,6 +41,9 @@
 
 #include <OpenMS/KERNEL/MSSpectrum.h>
 
+#include <algorithm>
+#include <limits>
+
 using namespace std;
 
 namespace OpenMS
@@ -212,6 +215,135 @@ namespace OpenMS
     return;
   }
 
+  void TheoreticalSpectrumGenerator::getFragmentIons(FragmentIonBuffer & buffer, const AASequence & peptide, Int min_charge, Int max_charge) const
+  {
+    buffer.ions.clear();
+    buffer.series_.clear();
+
+    const Size n = peptide.size();
+    if (n == 0 || min_charge > max_charge)
+    {
+      return;
+    }
+    if ((add_c_ions_ || add_x_ions_) && n < 2)
+    {
+      throw Exception::InvalidSize(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, 1);
+    }
+
+    // prefix_masses[k] / suffix_masses[k]: mass of the first / last k residues
+    // (the residue masses are first stored in reverse order in suffix_masses and then summed up in place)
+    vector<double>& prefix_masses = buffer.prefix_masses_;
+    vector<double>& suffix_masses = buffer.suffix_masses_;
+    prefix_masses.resize(n + 1);
+    suffix_masses.resize(n + 1);
+    prefix_masses[0] = 0.0;
+    suffix_masses[0] = 0.0;
+    bool increasing = true; // all ion series are sorted if all residue masses are positive
+    for (Size i = 0; i < n; ++i)
+    {
+      const double weight = peptide[i].getMonoWeight(Residue::Internal); // standard internal residue including named modifications
+      increasing = increasing && weight > 0.0;
+      prefix_masses[i + 1] = prefix_masses[i] + weight;
+      suffix_masses[n - i] = weight;
+    }
+    for (Size k = 1; k <= n; ++k)
+    {
+      suffix_masses[k] += suffix_masses[k - 1];
+    }
+
+    const double n_term_mod = peptide.hasNTerminalModification() ? peptide.getNTerminalModification()->getDiffMonoMass() : 0.0;
+    const double c_term_mod = peptide.hasCTerminalModification() ? peptide.getCTerminalModification()->getDiffMonoMass() : 0.0;
+
+    // set up all ion series in the order used by getSpectrum() (so ions with equal m/z keep that order)
+    struct SeriesType
+    {
+      bool add;
+      Residue::ResidueType res_type;
+      bool prefix;
+      double intensity;
+    };
+    const SeriesType series_types[] =
+    {
+      {add_b_ions_, Residue::BIon, true, b_intensity_},
+      {add_y_ions_, Residue::YIon, false, y_intensity_},
+      {add_a_ions_, Residue::AIon, true, a_intensity_},
+      {add_c_ions_, Residue::CIon, true, c_intensity_},
+      {add_x_ions_, Residue::XIon, false, x_intensity_},
+      {add_z_ions_, Residue::ZIon, false, z_intensity_}
+    };
+    Size total(0);
+    for (Int z = min_charge; z <= max_charge; ++z)
+    {
+      for (const SeriesType& type : series_types)
+      {
+        if (!type.add) { continue; }
+
+        double ion_offset(0.0);
+        switch (type.res_type)
+        {
+          case Residue::AIon: ion_offset = Residue::getInternalToAIon().getMonoWeight(); break;
+          case Residue::BIon: ion_offset = Residue::getInternalToBIon().getMonoWeight(); break;
+          case Residue::CIon: ion_offset = Residue::getInternalToCIon().getMonoWeight(); break;
+          case Residue::XIon: ion_offset = Residue::getInternalToXIon().getMonoWeight(); break;
+          case Residue::YIon: ion_offset = Residue::getInternalToYIon().getMonoWeight(); break;
+          case Residue::ZIon: ion_offset = Residue::getInternalToZIon().getMonoWeight(); break;
+          default: break;
+        }
+
+        FragmentIonBuffer::Series_ series;
+        series.masses = type.prefix ? prefix_masses.data() : suffix_masses.data();
+        series.offset = Constants::PROTON_MASS_U * z + (type.prefix ? n_term_mod : c_term_mod) + ion_offset;
+        series.charge = z;
+        series.next = (type.prefix && !add_first_prefix_ion_) ? 2 : 1;
+        series.last = n - 1; // ions of the full peptide are not generated (as in getSpectrum())
+        series.intensity = type.intensity;
+        series.ion_type = residueTypeToIonLetter_(type.res_type);
+        if (series.next <= series.last)
+        {
+          series.next_mz = (series.masses[series.next] + series.offset) / series.charge;
+          total += series.last - series.next + 1;
+        }
+        else
+        {
+          series.next_mz = std::numeric_limits<double>::max();
+        }
+        buffer.series_.push_back(series);
+      }
+    }
+    if (buffer.series_.empty())
+    {
+      return;
+    }
+
+    // merge the (sorted) ion series
+    buffer.ions.resize(total);
+    for (Size out = 0; out < total; ++out)
+    {
+      Size best = 0;
+      for (Size s = 1; s < buffer.series_.size(); ++s)
+      {
+        if (buffer.series_[s].next_mz < buffer.series_[best].next_mz) { best = s; }
+      }
+      FragmentIonBuffer::Series_& series = buffer.series_[best];
+
+      FragmentIon& ion = buffer.ions[out];
+      ion.mz = series.next_mz;
+      ion.intensity = series.intensity;
+      ion.ion_number = static_cast<UInt32>(series.next);
+      ion.charge = static_cast<Int>(series.charge);
+      ion.ion_type = series.ion_type;
+
+      ++series.next;
+      series.next_mz = series.next <= series.last ? (series.masses[series.next] + series.offset) / series.charge : std::numeric_limits<double>::max();
+    }
+
+    // residues with zero or negative mass (e.g. unusual modifications) can break the order of a series
+    if (!increasing)
+    {
+      std::stable_sort(buffer.ions.begin(), buffer.ions.end(), [](const FragmentIon& a, const FragmentIon& b) { return a.mz < b.mz; });
+    }
+  }
+
   void TheoreticalSpectrumGenerator::addAbundantImmoniumIons_(PeakSpectrum & spectrum, const AASequence& peptide, DataArrays::StringDataArray& ion_names, DataArrays::IntegerDataArray& charges) const
   {
     Peak1D p;
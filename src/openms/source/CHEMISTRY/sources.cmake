@@ -7,6 +7,8 @@ AASequence.cpp
 CrossLinksDB.cpp
 Element.cpp
 ElementDB.cpp
+CompactAASequence.cpp
+CompactEmpiricalFormula.cpp
 EmpiricalFormula.cpp
 EnzymaticDigestionLogModel.cpp
 EnzymaticDigestion.cpp
@@ -21,6 +23,7 @@ ProteaseDB.cpp
 ProteaseDigestion.cpp
 Residue.cpp
 ResidueDB.cpp
+ResidueMassTable.cpp
 ResidueModification.cpp
 RNaseDB.cpp
 RNaseDigestion.cpp
@@ -35,6 +35,9 @@
 
 #include <OpenMS/COMPARISON/SPECTRA/BinnedSpectralContrastAngle.h>
 
+#include <algorithm>
+#include <exception>
+
 using namespace std;
 
 namespace OpenMS
@@ -85,5 +88,155 @@ namespace OpenMS
 
     return score;
   }
-}
 
+  void BinnedSpectralContrastAngle::computeTopMatches(const std::vector<BinnedSpectrum>& queries, const std::vector<BinnedSpectrum>& library, std::vector<std::vector<Match> >& matches, Size top_k, double min_score) const
+  {
+    matches.clear();
+    matches.resize(queries.size());
+    if (queries.empty() || library.empty()) return;
+
+    const BinnedSpectrum& reference = library[0];
+    for (const BinnedSpectrum& bs : library)
+    {
+      if (!BinnedSpectrum::isCompatible(reference, bs))
+      {
+        throw Exception::IllegalArgument(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "Library spectra have different bin size, unit or offset.");
+      }
+    }
+    for (const BinnedSpectrum& bs : queries)
+    {
+      if (!BinnedSpectrum::isCompatible(reference, bs))
+      {
+        throw Exception::IllegalArgument(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "Query spectra are binned differently than the library spectra.");
+      }
+    }
+
+    typedef BinnedSpectrum::SparseVectorIndexType BinIndex;
+
+    // compact list of all bins occupied in the library
+    std::vector<BinIndex> bins;
+    for (const BinnedSpectrum& bs : library)
+    {
+      for (BinnedSpectrum::SparseVectorIteratorType it(bs.getBins()); it; ++it)
+      {
+        bins.push_back(it.index());
+      }
+    }
+    std::sort(bins.begin(), bins.end());
+    bins.erase(std::unique(bins.begin(), bins.end()), bins.end());
+
+    // transpose the library into CSC layout: for each occupied bin the
+    // library spectra (ordered by index) and their intensities
+    std::vector<Size> offsets(bins.size() + 1, 0);
+    std::vector<double> library_norms(library.size(), 0.0);
+    for (Size j = 0; j < library.size(); ++j)
+    {
+      std::vector<BinIndex>::const_iterator pos = bins.begin();
+      for (BinnedSpectrum::SparseVectorIteratorType it(library[j].getBins()); it; ++it)
+      {
+        pos = std::lower_bound(pos, bins.cend(), it.index());
+        ++offsets[pos - bins.begin() + 1];
+        library_norms[j] += double(it.value()) * it.value();
+      }
+      library_norms[j] = sqrt(library_norms[j]);
+    }
+    for (Size b = 0; b < bins.size(); ++b)
+    {
+      offsets[b + 1] += offsets[b];
+    }
+    std::vector<Size> spectrum_indices(offsets.back());
+    std::vector<float> intensities(offsets.back());
+    std::vector<Size> fill(offsets.begin(), offsets.end() - 1);
+    for (Size j = 0; j < library.size(); ++j)
+    {
+      std::vector<BinIndex>::const_iterator pos = bins.begin();
+      for (BinnedSpectrum::SparseVectorIteratorType it(library[j].getBins()); it; ++it)
+      {
+        pos = std::lower_bound(pos, bins.cend(), it.index());
+        Size& k = fill[pos - bins.begin()];
+        spectrum_indices[k] = j;
+        intensities[k] = it.value();
+        ++k;
+      }
+    }
+
+    Size err_count = 0;
+    std::exception_ptr err;
+#ifdef _OPENMP
+#pragma omp parallel
+#endif
+    {
+      // dense accumulator over the library plus the list of touched entries (per thread)
+      std::vector<double> dot(library.size(), 0.0);
+      std::vector<Size> touched;
+#ifdef _OPENMP
+#pragma omp for schedule(dynamic, 16)
+#endif
+      for (SignedSize i = 0; i < (SignedSize)queries.size(); ++i)
+      {
+        try
+        {
+          double query_norm = 0.0;
+          for (BinnedSpectrum::SparseVectorIteratorType it(queries[i].getBins()); it; ++it)
+          {
+            query_norm += double(it.value()) * it.value();
+          }
+          query_norm = sqrt(query_norm);
+
+          // sparse dot products with all library spectra sharing a bin
+          std::vector<BinIndex>::const_iterator pos = bins.begin();
+          for (BinnedSpectrum::SparseVectorIteratorType it(queries[i].getBins()); it; ++it)
+          {
+            pos = std::lower_bound(pos, bins.cend(), it.index());
+            if (pos == bins.end()) break;
+            if (*pos != it.index()) continue;
+            const Size b = pos - bins.begin();
+            const double value = it.value();
+            for (Size k = offsets[b]; k < offsets[b + 1]; ++k)
+            {
+              const Size j = spectrum_indices[k];
+              if (dot[j] == 0.0) touched.push_back(j);
+              dot[j] += value * intensities[k];
+            }
+          }
+
+          std::vector<Match>& result = matches[i];
+          for (Size j : touched)
+          {
+            const double score = dot[j] / (query_norm * library_norms[j]);
+            dot[j] = 0.0;
+            if (score > 0.0 && score >= min_score) result.push_back(Match(j, score));
+          }
+          touched.clear();
+
+          auto better = [](const Match& a, const Match& b)
+          {
+            return (a.second > b.second) || ((a.second == b.second) && (a.first < b.first));
+          };
+          if ((top_k > 0) && (result.size() > top_k))
+          {
+            std::partial_sort(result.begin(), result.begin() + top_k, result.end(), better);
+            result.resize(top_k);
+          }
+          else
+          {
+            std::sort(result.begin(), result.end(), better);
+          }
+        }
+        catch (...)
+        {
+#ifdef _OPENMP
+#pragma omp critical (BinnedSpectralContrastAngle_error)
+#endif
+          {
+            if (err_count++ == 0) err = std::current_exception();
+          }
+        }
+      }
+    }
+    if (err_count > 0)
+    {
+      std::rethrow_exception(err);
+    }
+  }
+}
@@ -45,11 +45,19 @@ namespace OpenMS
     defaults_.setValue("tolerance", 0.3, "Defines the absolute (in Da) or relative (in ppm) tolerance");
     defaults_.setValue("is_relative_tolerance", "false", "If true, the 'tolerance' is interpreted as ppm-value");
     defaults_.setValidStrings("is_relative_tolerance", ListUtils::create<String>("true,false"));
+    defaults_.setValue("matching_method", "banded_alignment", "Matching of peaks for absolute tolerances: 'banded_alignment' aligns the peaks by dynamic programming, 'nearest_peak' assigns each peak of the first spectrum to the closest peak of the second spectrum within the tolerance (linear time). Relative tolerances always use 'nearest_peak'.");
+    defaults_.setValidStrings("matching_method", ListUtils::create<String>("banded_alignment,nearest_peak"));
+    defaults_.setValue("one_to_one", "false", "Nearest peak matching only: match each peak of the second spectrum to at most one peak of the first spectrum (the closest one).");
+    defaults_.setValidStrings("one_to_one", ListUtils::create<String>("true,false"));
     defaultsToParam_();
   }
 
   SpectrumAlignment::SpectrumAlignment(const SpectrumAlignment & source) :
-    DefaultParamHandler(source)
+    DefaultParamHandler(source),
+    tolerance_(source.tolerance_),
+    is_relative_tolerance_(source.is_relative_tolerance_),
+    nearest_peak_(source.nearest_peak_),
+    one_to_one_(source.one_to_one_)
   {
   }
 
@@ -62,8 +70,20 @@ namespace OpenMS
     if (this != &source)
     {
       DefaultParamHandler::operator=(source);
+      tolerance_ = source.tolerance_;
+      is_relative_tolerance_ = source.is_relative_tolerance_;
+      nearest_peak_ = source.nearest_peak_;
+      one_to_one_ = source.one_to_one_;
     }
     return *this;
   }
 
+  void SpectrumAlignment::updateMembers_()
+  {
+    tolerance_ = (double)param_.getValue("tolerance");
+    is_relative_tolerance_ = param_.getValue("is_relative_tolerance").toBool();
+    nearest_peak_ = (String)param_.getValue("matching_method") == "nearest_peak";
+    one_to_one_ = param_.getValue("one_to_one").toBool();
+  }
+
 }
@@ -49,10 +49,10 @@
 #include <OpenMS/CONCEPT/LogStream.h>
 #include <OpenMS/CONCEPT/StreamHandler.h>
 
-#ifdef _OPENMP
-#endif
-
-#define BUFFER_LENGTH 32768
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
 
 using namespace std;
 
@@ -60,44 +60,134 @@ namespace OpenMS
 {
   namespace Logger
   {
+    namespace
+    {
+      // text of one LogStreamBuf written by one thread, not synced yet
+      struct PendingText
+      {
+        Size owner;
+        std::string text;
+      };
+
+      std::atomic<Size> next_buffer_id(0);
+
+      // Text of threads that exited before syncing. In particular, the
+      // thread-local storage of the main thread is destroyed before the global
+      // log streams, which pick up their remaining text from here. Both are
+      // defined before the global log streams (see bottom), so they outlive them.
+      std::mutex orphan_mutex;
+      std::vector<PendingText> orphan_text;
+
+      struct ThreadText
+      {
+        std::vector<PendingText> entries;
+        ~ThreadText();
+      };
+
+      thread_local ThreadText thread_text;
+      thread_local bool thread_text_destroyed = false;
+
+      // distributes all queued lines and pauses the background thread of an
+      // asynchronous buffer while its streams are modified
+      class AsyncPause
+      {
+      public:
+        explicit AsyncPause(LogStreamBuf* buf) :
+          buf_(buf),
+          async_(buf->isAsynchronous())
+        {
+          if (async_) buf_->setAsynchronous(false);
+        }
+
+        ~AsyncPause()
+        {
+          if (async_) buf_->setAsynchronous(true);
+        }
+
+      private:
+        LogStreamBuf* buf_;
+        bool async_;
+      };
+
+      ThreadText::~ThreadText()
+      {
+        thread_text_destroyed = true;
+        std::lock_guard<std::mutex> lock(orphan_mutex);
+        for (PendingText& p : entries)
+        {
+          if (!p.text.empty()) orphan_text.push_back(std::move(p));
+        }
+      }
+    }
+
+    struct LogStreamBuf::AsyncState
+    {
+      std::mutex mutex;
+      std::condition_variable lines_available;
+      std::vector<std::string> lines;
+      bool stop = false;
+      std::thread thread;
+    };
 
     const time_t LogStreamBuf::MAX_TIME = numeric_limits<time_t>::max();
     const std::string LogStreamBuf::UNKNOWN_LOG_LEVEL = "UNKNOWN_LOG_LEVEL";
 
     LogStreamBuf::LogStreamBuf(std::string log_level) :
       std::streambuf(),
-      pbuf_(nullptr),
+      id_(next_buffer_id++),
       level_(log_level),
       stream_list_(),
-      incomplete_line_(),
+      async_(),
       log_cache_counter_(0),
       log_cache_(),
       log_time_cache_()
     {
-      pbuf_ = new char[BUFFER_LENGTH];
-      std::streambuf::setp(pbuf_, pbuf_ + BUFFER_LENGTH - 1);
+      // no put area: all text is passed to overflow() / xsputn(), which
+      // collect it per thread
+      std::streambuf::setp(nullptr, nullptr);
     }
 
     LogStreamBuf::~LogStreamBuf()
     {
+      setAsynchronous(false);
+
       // Prevent issue on OSX with OpenMP: destructors of global objects seem to be called after tearing down the OpenMP context, we therefore cannot use any locks here.
-      syncLF_();
+      std::string incomplete_line;
       {
-        clearCache();
-        if (incomplete_line_.size() > 0)
-          distribute_(incomplete_line_);
-        delete[] pbuf_;
-        pbuf_ = nullptr;
+        std::lock_guard<std::mutex> lock(orphan_mutex);
+        for (std::vector<PendingText>::iterator it = orphan_text.begin(); it != orphan_text.end(); )
+        {
+          if (it->owner == id_)
+          {
+            incomplete_line += it->text;
+            it = orphan_text.erase(it);
+          }
+          else
+          {
+            ++it;
+          }
+        }
       }
+      std::string* text = threadText_(false);
+      if (text != nullptr)
+      {
+        incomplete_line += *text;
+        text->clear();
+      }
+      std::vector<std::string> lines;
+      extractLines_(incomplete_line, lines);
+      processLines_(lines);
+
+      clearCache();
+      if (incomplete_line.size() > 0 && !stream_list_.empty())
+        distribute_(incomplete_line);
     }
 
     int LogStreamBuf::overflow(int c)
     {
       if (c != traits_type::eof())
       {
-        *pptr() = c;
-        pbump(1);
-        sync();
+        threadText_(true)->push_back((char)c);
         return c;
       }
       else
@@ -106,6 +196,90 @@ namespace OpenMS
       }
     }
 
+    std::streamsize LogStreamBuf::xsputn(const char* s, std::streamsize n)
+    {
+      threadText_(true)->append(s, (size_t)n);
+      return n;
+    }
+
+    std::string* LogStreamBuf::threadText_(bool create)
+    {
+      std::vector<PendingText>* entries_ptr = &thread_text.entries;
+      if (thread_text_destroyed)
+      {
+        // only while the thread (or the program) shuts down: use storage
+        // without destructor (intentionally leaked)
+        static thread_local std::vector<PendingText>* shutdown_entries = nullptr;
+        if (shutdown_entries == nullptr) shutdown_entries = new std::vector<PendingText>();
+        entries_ptr = shutdown_entries;
+      }
+      std::vector<PendingText>& entries = *entries_ptr;
+      for (PendingText& p : entries)
+      {
+        if (p.owner == id_) return &p.text;
+      }
+      if (!create) return nullptr;
+      entries.push_back(PendingText{id_, std::string()});
+      return &entries.back().text;
+    }
+
+    void LogStreamBuf::extractLines_(std::string& text, std::vector<std::string>& lines)
+    {
+      std::string::size_type line_start = 0, line_end;
+      while ((line_end = text.find('\n', line_start)) != std::string::npos)
+      {
+        lines.push_back(text.substr(line_start, line_end - line_start));
+        line_start = line_end + 1;
+      }
+      text.erase(0, line_start);
+    }
+
+    void LogStreamBuf::setAsynchronous(bool async)
+    {
+      if (async == (async_ != nullptr)) return;
+      if (async)
+      {
+        async_.reset(new AsyncState());
+        async_->thread = std::thread(&LogStreamBuf::runAsync_, this);
+      }
+      else
+      {
+        {
+          std::lock_guard<std::mutex> lock(async_->mutex);
+          async_->stop = true;
+        }
+        async_->lines_available.notify_all();
+        async_->thread.join();
+        async_.reset();
+      }
+    }
+
+    bool LogStreamBuf::isAsynchronous() const
+    {
+      return async_ != nullptr;
+    }
+
+    void LogStreamBuf::runAsync_()
+    {
+      std::vector<std::string> lines;
+      while (true)
+      {
+        {
+          std::unique_lock<std::mutex> lock(async_->mutex);
+          async_->lines_available.wait(lock, [this]() { return async_->stop || !async_->lines.empty(); });
+          if (async_->lines.empty()) break; // stop requested and everything written
+          lines.swap(async_->lines);
+        }
+        #ifdef _OPENMP
+          #pragma omp critical (LOGSTREAM)
+        #endif
+        {
+          processLines_(lines);
+        }
+        lines.clear();
+      }
+    }
+
     LogStreamBuf * LogStream::rdbuf()
     {
       return (LogStreamBuf *)std::ios::rdbuf();
@@ -234,94 +408,78 @@ namespace OpenMS
       }
     }
 
-    int LogStreamBuf::syncLF_()
+    void LogStreamBuf::processLines_(const std::vector<std::string>& lines)
     {
-      // sync our streambuffer...
-      if (pptr() != pbase())
+      // check if we have attached streams, so we don't waste time to
+      // prepare the output
+      if (stream_list_.empty()) return;
+
+      for (const std::string& outstring : lines)
       {
-        // check if we have attached streams, so we don't waste time to
-        // prepare the output
-        if (!stream_list_.empty())
+        // avoid adding empty lines to the cache
+        if (outstring.empty())
+        {
+          distribute_(outstring);
+        }
+          // check if we have already seen this log message
+        else if (!isInCache_(outstring))
         {
-          char *line_start = pbase();
-          char *line_end = pbase();
+          // add line to the log cache
+          std::string extra_message = addToCache_(outstring);
 
-          static char buf[BUFFER_LENGTH];
+          // send outline (and extra_message) to attached streams
+          if (!extra_message.empty())
+            distribute_(extra_message);
 
-          while (line_end < pptr())
-          {
-            // search for the first end of line
-            for (; line_end < pptr() && *line_end != '\n'; line_end++)
-            {
-            }
-
-            if (line_end >= pptr())
-            {
-              // Copy the incomplete line to the incomplete_line_ buffer
-              size_t length = line_end - line_start;
-              length = std::min(length, (size_t) (BUFFER_LENGTH - 1));
-              strncpy(&(buf[0]), line_start, length);
-
-              // if length was too large, we copied one byte less than BUFFER_LENGTH to have
-              // room for the final \0
-              buf[length] = '\0';
-
-              incomplete_line_ += &(buf[0]);
-
-              // mark everything as read
-              line_end = pptr() + 1;
-            }
-            else
-            {
-              // note: pptr() - pbase() should be bounded by BUFFER_LENGTH, so this should always work
-              memcpy(&(buf[0]), line_start, line_end - line_start + 1);
-              buf[line_end - line_start] = '\0';
-
-              // assemble the string to be written
-              // (consider leftovers of the last buffer from incomplete_line_)
-              std::string outstring;
-              std::swap(outstring, incomplete_line_); // init outstring, while resetting incomplete_line_
-              outstring += &(buf[0]);
-
-              // avoid adding empty lines to the cache
-              if (outstring.empty())
-              {
-                distribute_(outstring);
-              }
-                // check if we have already seen this log message
-              else if (!isInCache_(outstring))
-              {
-                // add line to the log cache
-                std::string extra_message = addToCache_(outstring);
-
-                // send outline (and extra_message) to attached streams
-                if (!extra_message.empty())
-                  distribute_(extra_message);
-
-                distribute_(outstring);
-              }
-
-              // update the line pointers (increment both)
-              line_start = ++line_end;
-            }
-          }
+          distribute_(outstring);
         }
-        // remove all processed lines from the buffer
-        pbump((int) (pbase() - pptr()));
+      }
+    }
+
+    int LogStreamBuf::syncLF_()
+    {
+      std::string* text = threadText_(false);
+      if (text != nullptr && !text->empty())
+      {
+        std::vector<std::string> lines;
+        extractLines_(*text, lines);
+        processLines_(lines);
       }
       return 0;
     }
 
     int LogStreamBuf::sync()
     {
-      int ret = 0;
+      // splitting the text of this thread into lines needs no lock
+      std::string* text = threadText_(false);
+      if (text == nullptr || text->empty())
+      {
+        return 0;
+      }
+      std::vector<std::string> lines;
+      extractLines_(*text, lines);
+      if (lines.empty())
+      {
+        return 0;
+      }
+
+      if (async_ != nullptr)
+      {
+        {
+          std::lock_guard<std::mutex> lock(async_->mutex);
+          async_->lines.insert(async_->lines.end(), std::make_move_iterator(lines.begin()), std::make_move_iterator(lines.end()));
+        }
+        async_->lines_available.notify_one();
+        return 0;
+      }
+
       #ifdef _OPENMP
         #pragma omp critical (LOGSTREAM)
       #endif
       {
-        ret = syncLF_();
+        processLines_(lines);
       }
-      return ret;
+      return 0;
     }
 
     string LogStreamBuf::expandPrefix_
@@ -462,6 +620,7 @@ namespace OpenMS
         return;
       }
       // we didn't find it - create a new entry in the list
+      AsyncPause pause(rdbuf());
       LogStreamBuf::StreamStruct s_struct;
       s_struct.stream = &stream;
       rdbuf()->stream_list_.push_back(s_struct);
@@ -476,6 +635,7 @@ namespace OpenMS
       if (it != rdbuf()->stream_list_.end())
       {
         rdbuf()->sync();
+        AsyncPause pause(rdbuf());
         // HINT: we do NOT clear the cache (because we cannot access it from here)
         //       and we do not flush incomplete_line_!!!
         rdbuf()->stream_list_.erase(it);
@@ -490,6 +650,7 @@ namespace OpenMS
       insert(s);
 
       StreamIterator it = findStream_(s);
+      AsyncPause pause(rdbuf());
       (*it).target = &target;
     }
 
@@ -523,6 +684,7 @@ namespace OpenMS
       StreamIterator it = findStream_(s);
       if (it != rdbuf()->stream_list_.end())
       {
+        AsyncPause pause(rdbuf());
         (*it).prefix = prefix;
       }
     }
@@ -532,6 +694,7 @@ namespace OpenMS
       if (!bound_())
         return;
 
+      AsyncPause pause(rdbuf());
       for (StreamIterator it = rdbuf()->stream_list_.begin(); it != rdbuf()->stream_list_.end(); ++it)
       {
         (*it).prefix = prefix;
@@ -550,6 +713,15 @@ namespace OpenMS
       std::ostream::flush();
     }
 
+    void LogStream::setAsynchronous(bool async)
+    {
+      if (!bound_())
+        return;
+
+      rdbuf()->sync();
+      rdbuf()->setAsynchronous(async);
+    }
+
   }   // namespace Logger
 
 
@@ -117,7 +117,8 @@ private:
     mutable StopWatch stop_watch_;
     mutable SignedSize begin_;
     mutable SignedSize end_;
-    mutable SignedSize current_;
+    // incremented concurrently by nextProgress()
+    mutable std::atomic<SignedSize> current_;
   };
 
   class NoProgressLoggerImpl :
@@ -188,14 +189,14 @@ public:
 
   ProgressLogger::ProgressLogger() :
     type_(NONE),
-    last_invoke_()
+    last_invoke_(0)
   {
     current_logger_ = Factory<ProgressLogger::ProgressLoggerImpl>::create(logTypeToFactoryName_(type_));
   }
 
   ProgressLogger::ProgressLogger(const ProgressLogger& other) :
     type_(other.type_),
-    last_invoke_(other.last_invoke_)
+    last_invoke_(other.last_invoke_.load())
   {
     // recreate our logger
     current_logger_ = Factory<ProgressLogger::ProgressLoggerImpl>::create(logTypeToFactoryName_(type_));
@@ -205,7 +206,7 @@ public:
   {
     if (&other == this) return *this;
 
-    this->last_invoke_ = other.last_invoke_;
+    this->last_invoke_ = other.last_invoke_.load();
     this->type_ = other.type_;
 
     // we clean our old logger
@@ -244,21 +245,27 @@ public:
     ++recursion_depth_;
   }
 
+  bool ProgressLogger::claimUpdate_() const
+  {
+    // update only if at least 1 second has passed; if several threads get
+    // here at the same time, only the one that swaps the timestamp updates
+    time_t now = time(nullptr);
+    time_t last = last_invoke_.load(std::memory_order_relaxed);
+    return last != now && last_invoke_.compare_exchange_strong(last, now, std::memory_order_relaxed);
+  }
+
   void ProgressLogger::setProgress(SignedSize value) const
   {
-    // update only if at least 1 second has passed
-    if (last_invoke_ == time(nullptr)) return;
+    if (!claimUpdate_()) return;
 
-    last_invoke_ = time(nullptr);
     current_logger_->setProgress(value, recursion_depth_);
   }
+
   void ProgressLogger::nextProgress() const
   {
     auto p = current_logger_->nextProgress();
-    // update only if at least 1 second has passed
-    if (last_invoke_ == time(nullptr)) return;
+    if (!claimUpdate_()) return;
 
-    last_invoke_ = time(nullptr);
     current_logger_->setProgress(p, recursion_depth_);
   }
 
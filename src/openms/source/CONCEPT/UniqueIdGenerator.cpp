@@ -36,6 +36,12 @@
 
 #include <boost/date_time/posix_time/posix_time_types.hpp> //no i/o just types
 
+#include <atomic>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
 namespace OpenMS
 {
   UInt64 UniqueIdGenerator::seed_ = 0;
@@ -43,10 +49,49 @@ namespace OpenMS
   boost::mt19937_64* UniqueIdGenerator::rng_ = nullptr;
   boost::uniform_int<UInt64>* UniqueIdGenerator::dist_ = nullptr;
 
+#ifdef _OPENMP
+  namespace
+  {
+    // incremented whenever the seed changes, so the per-thread generators know when to re-seed
+    std::atomic<UInt64> seed_generation(1);
+
+    // generator used by a thread inside of parallel regions
+    struct ThreadGenerator
+    {
+      UInt64 generation = 0;
+      boost::mt19937_64 rng;
+    };
+
+    thread_local ThreadGenerator thread_generator;
+
+    // SplitMix64 finalizer: decorrelates the seeds of the per-thread streams
+    UInt64 mixSeed(UInt64 x)
+    {
+      x += 0x9E3779B97F4A7C15ULL;
+      x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+      x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+      return x ^ (x >> 31);
+    }
+  }
+#endif
+
   UInt64 UniqueIdGenerator::getUniqueId()
   {
     UniqueIdGenerator& instance = getInstance_();
 #ifdef _OPENMP
+    if (omp_in_parallel())
+    {
+      // lock-free: every thread has its own stream
+      ThreadGenerator& gen = thread_generator;
+      UInt64 generation = seed_generation.load(std::memory_order_acquire);
+      if (gen.generation != generation)
+      {
+        gen.rng.seed(mixSeed(instance.seed_ ^ mixSeed(UInt64(omp_get_thread_num()) + 1)));
+        gen.generation = generation;
+      }
+      return gen.rng();
+    }
+
     UInt64 val;
 #pragma omp critical (OPENMS_UniqueIdGenerator_getUniqueId)
     {
@@ -75,6 +120,9 @@ namespace OpenMS
       instance.seed_ = seed;
       instance.rng_->seed( instance.seed_ );
       instance.dist_->reset();
+#ifdef _OPENMP
+      seed_generation.fetch_add(1, std::memory_order_release);
+#endif
     }
   }
 
@@ -84,18 +132,15 @@ namespace OpenMS
 
   UniqueIdGenerator & UniqueIdGenerator::getInstance_()
   {
-  // modifies static members
-#ifdef _OPENMP
-#pragma omp critical (OPENMS_UniqueIdGenerator_getInstance_)
-#endif
+    // initialization of function-local statics is thread-safe (C++11), so
+    // no critical section is needed on every call
+    static UniqueIdGenerator* const instance = []()
     {
-      if (!instance_)
-      {
-        instance_ = new UniqueIdGenerator();
-        instance_->init_();
-      }
-    }
-    return *instance_;
+      instance_ = new UniqueIdGenerator();
+      instance_->init_();
+      return instance_;
+    }();
+    return *instance;
   }
 
   void UniqueIdGenerator::init_()
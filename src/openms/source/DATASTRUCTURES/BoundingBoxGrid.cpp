@@ -0,0 +1,184 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2018.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: Hannes Roest $
+// $Authors: Hannes Roest $
+// --------------------------------------------------------------------------
+
+#include <OpenMS/DATASTRUCTURES/BoundingBoxGrid.h>
+
+#include <algorithm>
+#include <cmath>
+
+namespace OpenMS
+{
+
+  BoundingBoxGrid::BoundingBoxGrid() :
+    boxes_(),
+    extent_(),
+    cell_size_x_(1.0),
+    cell_size_y_(1.0),
+    cells_x_(0),
+    cells_y_(0),
+    cell_begin_(),
+    entries_()
+  {
+  }
+
+  void BoundingBoxGrid::build(const std::vector<DBoundingBox<2> >& boxes, double cell_size_x, double cell_size_y)
+  {
+    boxes_ = boxes;
+    extent_ = DBoundingBox<2>();
+    cells_x_ = 0;
+    cells_y_ = 0;
+    cell_begin_.clear();
+    entries_.clear();
+
+    // boxes with min > max cannot enclose anything and are not indexed
+    std::vector<double> widths, heights;
+    for (Size i = 0; i < boxes_.size(); ++i)
+    {
+      const DBoundingBox<2>& box = boxes_[i];
+      if (box.minX() > box.maxX() || box.minY() > box.maxY()) continue;
+      extent_.enlarge(box.minPosition());
+      extent_.enlarge(box.maxPosition());
+      widths.push_back(box.width());
+      heights.push_back(box.height());
+    }
+    if (widths.empty()) return;
+
+    // default cell size: median extent of the boxes (or a fraction of the
+    // whole area if the boxes are points)
+    const double n = double(widths.size());
+    if (cell_size_x <= 0)
+    {
+      std::nth_element(widths.begin(), widths.begin() + widths.size() / 2, widths.end());
+      cell_size_x = widths[widths.size() / 2];
+      if (cell_size_x <= 0) cell_size_x = extent_.width() / std::sqrt(n);
+    }
+    if (cell_size_y <= 0)
+    {
+      std::nth_element(heights.begin(), heights.begin() + heights.size() / 2, heights.end());
+      cell_size_y = heights[heights.size() / 2];
+      if (cell_size_y <= 0) cell_size_y = extent_.height() / std::sqrt(n);
+    }
+    if (cell_size_x <= 0) cell_size_x = 1.0;
+    if (cell_size_y <= 0) cell_size_y = 1.0;
+
+    // limit the number of cells (memory) by making the cells larger
+    const double max_cells = 4.0 * n + 16.0;
+    double cells = (std::floor(extent_.width() / cell_size_x) + 1.0) * (std::floor(extent_.height() / cell_size_y) + 1.0);
+    if (cells > max_cells)
+    {
+      double factor = std::sqrt(cells / max_cells);
+      cell_size_x *= factor;
+      cell_size_y *= factor;
+    }
+    cell_size_x_ = cell_size_x;
+    cell_size_y_ = cell_size_y;
+    cells_x_ = Size(std::floor(extent_.width() / cell_size_x_)) + 1;
+    cells_y_ = Size(std::floor(extent_.height() / cell_size_y_)) + 1;
+
+    // count the entries of each cell, then fill them in order of the boxes
+    cell_begin_.assign(cells_x_ * cells_y_ + 1, 0);
+    std::vector<Size> fill;
+    for (int pass = 0; pass < 2; ++pass)
+    {
+      if (pass == 1)
+      {
+        for (Size c = 1; c < cell_begin_.size(); ++c)
+        {
+          cell_begin_[c] += cell_begin_[c - 1];
+        }
+        entries_.resize(cell_begin_.back());
+        fill.assign(cell_begin_.begin(), cell_begin_.end() - 1);
+      }
+      for (Size i = 0; i < boxes_.size(); ++i)
+      {
+        const DBoundingBox<2>& box = boxes_[i];
+        if (box.minX() > box.maxX() || box.minY() > box.maxY()) continue;
+        Size x_begin = cell_(box.minX(), extent_.minX(), cell_size_x_, cells_x_);
+        Size x_end = cell_(box.maxX(), extent_.minX(), cell_size_x_, cells_x_);
+        Size y_begin = cell_(box.minY(), extent_.minY(), cell_size_y_, cells_y_);
+        Size y_end = cell_(box.maxY(), extent_.minY(), cell_size_y_, cells_y_);
+        for (Size x = x_begin; x <= x_end; ++x)
+        {
+          for (Size y = y_begin; y <= y_end; ++y)
+          {
+            if (pass == 0)
+            {
+              ++cell_begin_[x * cells_y_ + y + 1];
+            }
+            else
+            {
+              entries_[fill[x * cells_y_ + y]++] = i;
+            }
+          }
+        }
+      }
+    }
+  }
+
+  void BoundingBoxGrid::query(const DPosition<2>& position, std::vector<Size>& result) const
+  {
+    result.clear();
+    if (cells_x_ == 0 || !extent_.encloses(position)) return;
+
+    Size x = cell_(position.getX(), extent_.minX(), cell_size_x_, cells_x_);
+    Size y = cell_(position.getY(), extent_.minY(), cell_size_y_, cells_y_);
+    Size cell = x * cells_y_ + y;
+    for (Size e = cell_begin_[cell]; e < cell_begin_[cell + 1]; ++e)
+    {
+      if (boxes_[entries_[e]].encloses(position))
+      {
+        result.push_back(entries_[e]);
+      }
+    }
+  }
+
+  Size BoundingBoxGrid::size() const
+  {
+    return boxes_.size();
+  }
+
+  const DBoundingBox<2>& BoundingBoxGrid::getBox(Size index) const
+  {
+    return boxes_[index];
+  }
+
+  Size BoundingBoxGrid::cell_(double value, double min, double cell_size, Size cells) const
+  {
+    double pos = std::floor((value - min) / cell_size);
+    if (pos <= 0) return 0;
+    if (pos >= double(cells - 1)) return cells - 1;
+    return Size(pos);
+  }
+
+} // namespace OpenMS
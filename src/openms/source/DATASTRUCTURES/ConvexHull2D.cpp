@@ -239,6 +239,23 @@ namespace OpenMS
     return saved_points;
   }
 
+  void ConvexHull2D::compact(bool bounding_box_only)
+  {
+    if (bounding_box_only && !(map_points_.empty() && outer_points_.empty()))
+    {
+      expandToBoundingBox();
+    }
+    compress();
+    PointArrayType points(getHullPoints()); // exact capacity
+    outer_points_.swap(points);
+    map_points_.clear();
+  }
+
+  bool ConvexHull2D::isCompact() const
+  {
+    return map_points_.empty();
+  }
+
   bool ConvexHull2D::encloses(const PointType& point) const
   {
     if ((map_points_.empty()) && outer_points_.size() > 0) // we cannot answer the query as we lack the internal data structure
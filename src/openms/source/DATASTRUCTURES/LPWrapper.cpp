@@ -194,6 +194,68 @@ namespace OpenMS
     return index; // in addRow index is decreased already
   }
 
+  Int LPWrapper::addRows(const std::vector<Int>& row_starts, const std::vector<Int>& column_indices, const std::vector<double>& values,
+                         const std::vector<String>& names, const std::vector<double>& lower_bounds, const std::vector<double>& upper_bounds,
+                         const std::vector<Type>& types)
+  {
+    if (row_starts.empty() || (row_starts.front() != 0) || (Size(row_starts.back()) != column_indices.size()))
+      throw Exception::IllegalArgument(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "Row start positions do not match the number of matrix entries");
+    if (column_indices.size() != values.size())
+      throw Exception::IllegalArgument(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "Indices and values vectors differ in size");
+    Size n_rows = row_starts.size() - 1;
+    if ((names.size() != n_rows) || (lower_bounds.size() != n_rows) || (upper_bounds.size() != n_rows) || (types.size() != n_rows))
+      throw Exception::IllegalArgument(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "Number of row names/bounds/types differs from number of rows");
+    for (Size i = 0; i < n_rows; ++i)
+    {
+      if (row_starts[i + 1] < row_starts[i])
+        throw Exception::IllegalArgument(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "Row start positions must not decrease");
+    }
+
+    Int first_index = getNumberOfRows();
+    if (n_rows == 0) return first_index;
+
+    if (solver_ == SOLVER_GLPK)
+    {
+      glp_add_rows(lp_problem_, (int)n_rows);
+      // glpk accesses arrays beginning at index 1 (and uses 1-based indices)
+      std::vector<Int> glp_indices(1, -1);
+      std::vector<double> glp_values(1, -1);
+      for (Size i = 0; i < n_rows; ++i)
+      {
+        glp_indices.resize(1);
+        glp_values.resize(1);
+        for (Int k = row_starts[i]; k < row_starts[i + 1]; ++k)
+        {
+          glp_indices.push_back(column_indices[k] + 1);
+          glp_values.push_back(values[k]);
+        }
+        Int index = first_index + (Int)i + 1;
+        glp_set_mat_row(lp_problem_, index, (int)glp_indices.size() - 1, &(glp_indices[0]), &(glp_values[0]));
+        glp_set_row_name(lp_problem_, index, names[i].c_str());
+        glp_set_row_bnds(lp_problem_, index, types[i], lower_bounds[i], upper_bounds[i]);
+      }
+      return first_index;
+    }
+#if COINOR_SOLVER == 1
+    else if (solver_ == SOLVER_COINOR)
+    {
+      for (Size i = 0; i < n_rows; ++i)
+      {
+        Int start = row_starts[i];
+        Int length = row_starts[i + 1] - start;
+        // CoinModel only reads the arrays, the const_casts are safe:
+        model_->addRow(length, length ? const_cast<Int*>(&column_indices[start]) : nullptr,
+                       length ? const_cast<double*>(&values[start]) : nullptr,
+                       -COIN_DBL_MAX, COIN_DBL_MAX, names[i].c_str());
+        setRowBounds(first_index + (Int)i, lower_bounds[i], upper_bounds[i], types[i]);
+      }
+      return first_index;
+    }
+#endif
+    else
+      throw Exception::InvalidValue(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "Invalid Solver chosen", String(solver_));
+  }
+
   Int LPWrapper::addColumn(std::vector<Int>& column_indices, std::vector<double>& column_values, const String& name,
                            double lower_bound, double upper_bound, Type type) //return index
   {
@@ -663,6 +725,32 @@ namespace OpenMS
       if (solver_param.enable_binarization)
         solver_param_glp.binarize = GLP_ON; // only with presolve
 
+      if (solver_param.enable_warm_start)
+      {
+        // solve the LP relaxation first, starting from the current basis
+        // (rows/columns added since the last solve keep it valid); the MIP
+        // solver then starts from this relaxation without presolving:
+        glp_smcp simplex_param;
+        glp_init_smcp(&simplex_param);
+        simplex_param.msg_lev = solver_param.message_level;
+        int ret = glp_simplex(lp_problem_, &simplex_param);
+        if ((ret == GLP_EBADB) || (ret == GLP_ESING) || (ret == GLP_ECOND))
+        {
+          // basis not usable - start from an advanced initial basis instead:
+          glp_adv_basis(lp_problem_, 0);
+          ret = glp_simplex(lp_problem_, &simplex_param);
+        }
+        if ((ret == 0) && (glp_get_status(lp_problem_) == GLP_OPT))
+        {
+          solver_param_glp.presolve = GLP_OFF;
+          solver_param_glp.binarize = GLP_OFF;
+        }
+        else // no optimal relaxation (e.g. infeasible) - let the MIP presolver handle it
+        {
+          solver_param_glp.presolve = GLP_ON;
+        }
+      }
+
       return glp_intopt(lp_problem_, &solver_param_glp);
     }
 #if COINOR_SOLVER == 1
@@ -729,6 +817,8 @@ namespace OpenMS
       //                                        << model.getObjValue()
       //                                        << (!model.status() ? " Finished" : " Not finished")
       //                                        << std::endl;
+      // the problem may be solved repeatedly (after modifications):
+      solution_.clear();
       for (Int i = 0; i < model_->numberColumns(); ++i)
       {
         solution_.push_back(model.solver()->getColSolution()[i]);
@@ -268,38 +268,52 @@ namespace OpenMS
     return nodes.end();
   }
 
+  namespace
+  {
+    /// Does @p name equal the part [@p start, @p start + @p length) of @p path? (avoids creating substrings during lookups)
+    inline bool equalsRange(const String& name, const String& path, String::size_type start, String::size_type length)
+    {
+      return name.size() == length && path.compare(start, length, name) == 0;
+    }
+  }
+
   Param::ParamNode* Param::ParamNode::findParentOf(const String& local_name)
   {
-    //cout << "findParentOf nodename: " << this->name << " - nodes: " << this->nodes.size() << " - find: "<< name << std::endl;
-    if (!local_name.has(':')) // we are in the right child
+    // walk down the sections of the path, i.e. all parts followed by a ':'
+    ParamNode* node = this;
+    String::size_type start = 0;
+    for (String::size_type colon = local_name.find(':'); colon != String::npos; colon = local_name.find(':', start))
     {
-      //check if a node or entry prefix match
-      for (Size i = 0; i < nodes.size(); ++i)
+      ParamNode* child = nullptr;
+      for (ParamNode& n : node->nodes)
       {
-        if (nodes[i].name.hasPrefix(local_name))
-          return this;
+        if (equalsRange(n.name, local_name, start, colon - start))
+        {
+          child = &n;
+          break;
+        }
       }
-      for (Size i = 0; i < entries.size(); ++i)
+      if (child == nullptr) //subnode not found
       {
-        if (entries[i].name.hasPrefix(local_name))
-          return this;
+        return nullptr;
       }
-      return nullptr;
+      node = child;
+      start = colon + 1;
     }
-    else //several subnodes to browse through
+
+    // we are in the right child: check if a node or entry prefix match
+    const String::size_type length = local_name.size() - start;
+    for (Size i = 0; i < node->nodes.size(); ++i)
     {
-      String prefix = local_name.prefix(':');
-      //cout << " - Prefix: '" << prefix << "'" << std::endl;
-      NodeIterator it = findNode(prefix);
-      if (it == nodes.end()) //subnode not found
-      {
-        return nullptr;
-      }
-      //recursively call findNode for the rest of the path
-      String new_name = local_name.substr(it->name.size() + 1);
-      //cout << " - Next name: '" << new_name << "'" << std::endl;
-      return it->findParentOf(new_name);
+      if (node->nodes[i].name.compare(0, length, local_name, start, length) == 0)
+        return node;
+    }
+    for (Size i = 0; i < node->entries.size(); ++i)
+    {
+      if (node->entries[i].name.compare(0, length, local_name, start, length) == 0)
+        return node;
     }
+    return nullptr;
   }
 
   Param::ParamEntry* Param::ParamNode::findEntryRecursive(const String& local_name)
@@ -308,40 +322,55 @@ namespace OpenMS
     if (parent == nullptr)
       return nullptr;
 
-    EntryIterator it = parent->findEntry(suffix(local_name));
-    if (it == parent->entries.end())
-      return nullptr;
-
-    return &(*it);
+    String::size_type colon = local_name.rfind(':');
+    String::size_type start = (colon == String::npos ? 0 : colon + 1);
+    for (ParamEntry& entry : parent->entries)
+    {
+      if (equalsRange(entry.name, local_name, start, local_name.size() - start))
+        return &entry;
+    }
+    return nullptr;
   }
 
-  void Param::ParamNode::insert(const ParamNode& node, const String& prefix)
+  namespace
   {
-    //std::cerr << "INSERT NODE  " << node.name << " (" << prefix << ")" << std::endl;
-    String prefix2 = prefix + node.name;
-
-    ParamNode* insert_node = this;
-    while (prefix2.has(':'))
+    /// Returns the node for all sections of @p path (the parts followed by a ':'), which are created if missing. @p start is set to the beginning of the last part.
+    Param::ParamNode* findOrCreateSections(Param::ParamNode* node, const String& path, String::size_type& start)
     {
-      String local_name = prefix2.prefix(':');
-      //check if the node already exists
-      NodeIterator it = insert_node->findNode(local_name);
-      if (it != insert_node->nodes.end()) //exists
+      start = 0;
+      for (String::size_type colon = path.find(':'); colon != String::npos; colon = path.find(':', start))
       {
-        insert_node = &(*it);
-      }
-      else //create it
-      {
-        insert_node->nodes.push_back(ParamNode(local_name, ""));
-        insert_node = &(insert_node->nodes.back());
-        //std::cerr << " - Created new node: " << insert_node->name << std::endl;
+        Param::ParamNode* child = nullptr;
+        for (Param::ParamNode& n : node->nodes)
+        {
+          if (equalsRange(n.name, path, start, colon - start))
+          {
+            child = &n;
+            break;
+          }
+        }
+        if (child == nullptr) //create it
+        {
+          node->nodes.push_back(Param::ParamNode(path.substr(start, colon - start), ""));
+          child = &(node->nodes.back());
+        }
+        node = child;
+        start = colon + 1;
       }
-      //remove prefix
-      prefix2 = prefix2.substr(local_name.size() + 1);
+      return node;
     }
+  }
+
+  void Param::ParamNode::insert(const ParamNode& node, const String& prefix)
+  {
+    //std::cerr << "INSERT NODE  " << node.name << " (" << prefix << ")" << std::endl;
+    const String path = prefix + node.name;
+    String::size_type start;
+    ParamNode* insert_node = findOrCreateSections(this, path, start);
 
     //check if the node already exists
-    NodeIterator it = insert_node->findNode(prefix2);
+    NodeIterator it = insert_node->nodes.begin();
+    while (it != insert_node->nodes.end() && !equalsRange(it->name, path, start, path.size() - start)) ++it;
     if (it != insert_node->nodes.end()) //append nodes and entries
     {
       for (ConstNodeIterator it2 = node.nodes.begin(); it2 != node.nodes.end(); ++it2)
@@ -359,43 +388,21 @@ namespace OpenMS
     }
     else //insert it
     {
-      Param::ParamNode tmp(node);
-      tmp.name = prefix2;
-      insert_node->nodes.push_back(tmp);
+      insert_node->nodes.push_back(node);
+      insert_node->nodes.back().name = path.substr(start);
     }
   }
 
   void Param::ParamNode::insert(const ParamEntry& entry, const String& prefix)
   {
     //std::cerr << "INSERT ENTRY " << entry.name << " (" << prefix << ")" << std::endl;
-    String prefix2 = prefix + entry.name;
-    //std::cerr << " - inserting: " << prefix2 << std::endl;
-
-    ParamNode* insert_node = this;
-    while (prefix2.has(':'))
-    {
-      String local_name = prefix2.prefix(':');
-      //std::cerr << " - looking for node: " << name << std::endl;
-      //look up if the node already exists
-      NodeIterator it = insert_node->findNode(local_name);
-      if (it != insert_node->nodes.end()) //exists
-      {
-        insert_node = &(*it);
-      }
-      else //create it
-      {
-        insert_node->nodes.push_back(ParamNode(local_name, ""));
-        insert_node = &(insert_node->nodes.back());
-        //std::cerr << " - Created new node: " << insert_node->name << std::endl;
-      }
-      //remove prefix
-      prefix2 = prefix2.substr(local_name.size() + 1);
-      //std::cerr << " - new prefix: " << prefix2 << std::endl;
-    }
+    const String path = prefix + entry.name;
+    String::size_type start;
+    ParamNode* insert_node = findOrCreateSections(this, path, start);
 
     //check if the entry already exists
-    //std::cerr << " - final entry name: " << prefix2 << std::endl;
-    EntryIterator it = insert_node->findEntry(prefix2);
+    EntryIterator it = insert_node->entries.begin();
+    while (it != insert_node->entries.end() && !equalsRange(it->name, path, start, path.size() - start)) ++it;
     if (it != insert_node->entries.end()) //overwrite entry
     {
       it->value = entry.value;
@@ -407,9 +414,8 @@ namespace OpenMS
     }
     else //insert it
     {
-      Param::ParamEntry tmp(entry);
-      tmp.name = prefix2;
-      insert_node->entries.push_back(tmp);
+      insert_node->entries.push_back(entry);
+      insert_node->entries.back().name = path.substr(start);
     }
   }
 
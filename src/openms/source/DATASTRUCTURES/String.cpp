@@ -527,4 +527,58 @@ namespace OpenMS
     return *this;
   }
 
+  StringView StringView::trim() const
+  {
+    const char* b = begin_;
+    const char* e = begin_ + size_;
+    while (b != e && (*b == ' ' || *b == '\t' || *b == '\n' || *b == '\r'))
+    {
+      ++b;
+    }
+    while (e != b && (*(e - 1) == ' ' || *(e - 1) == '\t' || *(e - 1) == '\n' || *(e - 1) == '\r'))
+    {
+      --e;
+    }
+    return StringView(b, e - b);
+  }
+
+  bool StringView::split(const char splitter, std::vector<StringView>& substrings) const
+  {
+    substrings.clear();
+    if (size_ == 0) return false;
+
+    const char* b = begin_;
+    const char* e = begin_ + size_;
+    const char* pos = std::find(b, e, splitter);
+    if (pos == e)
+    {
+      substrings.push_back(*this);
+      return false;
+    }
+
+    while (pos != e)
+    {
+      substrings.push_back(StringView(b, pos - b));
+      b = pos + 1;
+      pos = std::find(b, e, splitter);
+    }
+    substrings.push_back(StringView(b, e - b));
+    return true;
+  }
+
+  Int StringView::toInt() const
+  {
+    return StringUtils::toInt(begin_, begin_ + size_);
+  }
+
+  float StringView::toFloat() const
+  {
+    return StringUtils::toFloat(begin_, begin_ + size_);
+  }
+
+  double StringView::toDouble() const
+  {
+    return StringUtils::toDouble(begin_, begin_ + size_);
+  }
+
 } // namespace OpenMS
@@ -5,6 +5,7 @@ set(directory source/DATASTRUCTURES)
 set(sources_list
 Adduct.cpp
 BinaryTreeNode.cpp
+BoundingBoxGrid.cpp
 CalibrationData.cpp
 ChargePair.cpp
 Compomer.cpp
@@ -295,35 +295,64 @@ namespace OpenMS
     }
     else
     { // one model per spectrum (not all might be needed, if certain MS levels are excluded from calibration)
-      tms.reserve(exp.size());
-      // go through spectra and calibrate
-      Size i(0), i_mslvl(0);
-      for (PeakMap::Iterator it = exp.begin(); it != exp.end(); ++it, ++i)
+      // spectra which need a model (scan m/z or precursor m/z needs correction)
+      std::vector<Size> spec_index;
+      spec_index.reserve(exp.size());
+      for (Size i = 0; i < exp.size(); ++i)
       {
-        setProgress(i);
-
-        // skip this MS level?
-        if (!(ListUtils::contains(target_mslvl, it->getMSLevel()) ||     // scan m/z needs correction
-              ListUtils::contains(target_mslvl, it->getMSLevel() - 1)))  // precursor m/z needs correction
+        if (ListUtils::contains(target_mslvl, exp[i].getMSLevel()) ||
+            ListUtils::contains(target_mslvl, exp[i].getMSLevel() - 1))
         {
-          continue;
+          spec_index.push_back(i);
         }
+      }
 
-        //
-        // build model
-        //
-        tms.push_back(MZTrafoModel());
-        tms.back().train(cal_data_, model_type, use_RANSAC, it->getRT() - rt_chunk, it->getRT() + rt_chunk);
-        if (!MZTrafoModel::isValidModel(tms.back())) // model not trained or coefficients are too extreme
+      // build the models and calibrate the spectra
+      // Each model only reads the (const) calibration data and writes to its own spectrum.
+      // RANSAC uses its own seeded random number streams, i.e. the result does
+      // not depend on thread scheduling.
+      tms.resize(spec_index.size());
+      std::vector<char> valid(spec_index.size(), 0);
+      Size progress(0), err_count(0);
+      std::exception_ptr err;
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic, 16)
+#endif
+      for (SignedSize k = 0; k < (SignedSize)spec_index.size(); ++k)
+      {
+        try
         {
-          invalid_models[i_mslvl] = i;
+          MSSpectrum& spec = exp[spec_index[k]];
+          tms[k].train(cal_data_, model_type, use_RANSAC, spec.getRT() - rt_chunk, spec.getRT() + rt_chunk);
+          if (MZTrafoModel::isValidModel(tms[k])) // model not trained or coefficients are too extreme otherwise
+          {
+            applyTransformation(spec, target_mslvl, tms[k]);
+            valid[k] = 1;
+          }
         }
-        else
+        catch (...)
         {
-          applyTransformation(*it, target_mslvl, tms.back());
+#ifdef _OPENMP
+#pragma omp critical (InternalCalibration_error)
+#endif
+          {
+            if (err_count++ == 0) err = std::current_exception();
+          }
         }
-        ++i_mslvl;
-      } // MSExp::iter
+#ifdef _OPENMP
+#pragma omp atomic
+#endif
+        ++progress;
+        IF_MASTERTHREAD setProgress(progress);
+      }
+      if (err_count > 0)
+      {
+        std::rethrow_exception(err);
+      }
+      for (Size k = 0; k < spec_index.size(); ++k)
+      {
+        if (!valid[k]) invalid_models[k] = spec_index[k];
+      }
 
       //////////////////////////////////////////////////////////////////////////
       // CHECK Models -- use neighbors if needed
@@ -339,8 +368,14 @@ namespace OpenMS
           << "Using the closest successful model on these." << std::endl;
 
         std::vector<MZTrafoModel> tms_new = tms; // will contain corrected models (this wastes a bit of memory)
-        for (std::map<Size, Size>::const_iterator it = invalid_models.begin(); it != invalid_models.end(); ++it)
+        // each invalid model belongs to a different spectrum, so they can be fixed independently
+        std::vector<std::pair<Size, Size> > invalid_list(invalid_models.begin(), invalid_models.end());
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic, 16)
+#endif
+        for (SignedSize k = 0; k < (SignedSize)invalid_list.size(); ++k)
         {
+          const std::pair<Size, Size>* it = &invalid_list[k];
           Size p = it->first;
           // find model closest valid model to p'th model
           std::vector<MZTrafoModel>::iterator it_center_r = tms.begin() + p; // points to 'p'
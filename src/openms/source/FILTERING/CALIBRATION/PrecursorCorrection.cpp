@@ -98,46 +98,29 @@ using namespace std;
       vector<Size> precursor_scan_index;
       getPrecursors(exp, precursors, precursors_rt, precursor_scan_index);
 
+      // search the closest MS1 peak for all precursors in parallel (the experiment is only read) ...
+      vector<Size> spectrum_idx(precursors_rt.size(), 0); // index of MS2 spectrum
+      vector<SearchResult_> status(precursors_rt.size(), NO_MS1_);
+      vector<double> peak_mz(precursors_rt.size(), 0.0);
+      searchMS1_(exp, precursors, precursors_rt, mz_tolerance, ppm, false, spectrum_idx, status, peak_mz);
+
+      // ... and apply the corrections in precursor order
       for (Size i = 0; i != precursors_rt.size(); ++i)
       {
-        // get precursor rt
-        double rt = precursors_rt[i];
-
-        // get precursor MZ
-        double mz = precursors[i].getMZ();
-
-        //cout << rt << " " << mz << endl;
-
-        // get precursor spectrum
-        MSExperiment::ConstIterator rt_it = exp.RTBegin(rt - 1e-8);
-
-        // store index of MS2 spectrum
-        UInt precursor_spectrum_idx = rt_it - exp.begin();
-
-        // get parent (MS1) of precursor spectrum
-        rt_it = exp.getPrecursorSpectrum(rt_it);
-
-        if (rt_it == exp.end() 
-        || rt_it->getMSLevel() != 1)
+        if (status[i] == NO_MS1_)
         {
           LOG_WARN << "Warning: no MS1 spectrum for this precursor" << endl;
-          continue;          
+          continue;
         }
 
-        //cout << rt_it->getRT() << " " << rt_it->size() << endl;
-
-        // find peak (index) closest to expected position
-        Size nearest_peak_idx = rt_it->findNearest(mz);
-
-        // get actual position of closest peak
-        double nearest_peak_mz = (*rt_it)[nearest_peak_idx].getMZ();
-
-        // calculate error between expected and actual position
-        double nearestPeakError = ppm ? abs(nearest_peak_mz - mz)/mz * 1e6 : abs(nearest_peak_mz - mz);
-
         // check if error is small enough
-        if (nearestPeakError < mz_tolerance)
+        if (status[i] == FOUND_)
         {
+          double rt = precursors_rt[i];
+          double mz = precursors[i].getMZ();
+          double nearest_peak_mz = peak_mz[i];
+          Size precursor_spectrum_idx = spectrum_idx[i];
+
           // sanity check: do we really have the same precursor in the original and the picked spectrum
           if (fabs(exp[precursor_spectrum_idx].getPrecursors()[0].getMZ() - mz) > 0.0001)
           {
@@ -175,46 +158,34 @@ using namespace std;
       getPrecursors(exp, precursors, precursors_rt, precursor_scan_index);
       int count_error_highest_intenstiy = 0;
 
+      // search the most intense MS1 peak for all precursors in parallel (the experiment is only read) ...
+      vector<Size> spectrum_idx(precursors_rt.size(), 0); // index of MS2 spectrum
+      vector<SearchResult_> status(precursors_rt.size(), NO_MS1_);
+      vector<double> peak_mz(precursors_rt.size(), 0.0);
+      searchMS1_(exp, precursors, precursors_rt, mz_tolerance, ppm, true, spectrum_idx, status, peak_mz);
+
+      // ... and apply the corrections in precursor order
       for (Size i = 0; i != precursors_rt.size(); ++i)
       {
         double rt = precursors_rt[i]; // get precursor rt        
         double mz = precursors[i].getMZ(); // get precursor MZ
 
-        // retrieves iterator of the MS2 fragment sprectrum
-        MSExperiment::ConstIterator rt_it = exp.RTBegin(rt - 1e-8);
-
-        // store index of MS2 spectrum
-        UInt precursor_spectrum_idx = rt_it - exp.begin();
-
-        // get parent (MS1) of precursor spectrum
-        rt_it = exp.getPrecursorSpectrum(rt_it);
-
-        if (rt_it == exp.end() 
-        || rt_it->getMSLevel() != 1)
+        if (status[i] == NO_MS1_)
         {
           LOG_WARN << "Warning: no MS1 spectrum for this precursor" << endl;
           continue;
         }
 
-        // get tolerance window and left/right iterator
-        std::pair<double,double> tolerance_window = Math::getTolWindow(mz, mz_tolerance, ppm);
-        MSSpectrum::ConstIterator left = rt_it->MZBegin(tolerance_window.first);
-        MSSpectrum::ConstIterator right = rt_it->MZEnd(tolerance_window.second);
-
         // no MS1 precursor peak in +- tolerance window found
-        if  (left == right || left > right)
+        if (status[i] == NOT_FOUND_)
         {
           count_error_highest_intenstiy += 1;
           continue;
         }
 
-        MSSpectrum::ConstIterator max_intensity_it = std::max_element(left, right, Peak1D::IntensityLess());
-
-        // find peak (index) with highest intensity to expected position
-        Size highest_peak_idx = max_intensity_it - rt_it->begin();
-
-        // get actual position of highest intensity peak
-        double highest_peak_mz = (*rt_it)[highest_peak_idx].getMZ();
+        // actual position of highest intensity peak
+        double highest_peak_mz = peak_mz[i];
+        Size precursor_spectrum_idx = spectrum_idx[i];
 
         // cout << mz << " -> " << nearest_peak_mz << endl;
         double delta_mz = highest_peak_mz - mz;
@@ -253,7 +224,26 @@ using namespace std;
       // if believe_charge is set, only add features that match the precursor charge
       map<Size, set<Size> > scan_idx_to_feature_idx;
 
-      for (Size scan = 0; scan != exp.size(); ++scan)
+      // bounding boxes (extended by the RT tolerance) of all features, ordered by their minimal RT;
+      // a precursor can only overlap with features starting at most 'max_rt_width' before it
+      vector<DBoundingBox<2> > boxes(features.size());
+      vector<pair<double, Size> > rt_starts;
+      rt_starts.reserve(features.size());
+      double max_rt_width(0);
+      for (Size f = 0; f != features.size(); ++f)
+      {
+        if (!extendedBoundingBox_(features[f], rt_tolerance_s, boxes[f])) continue;
+        rt_starts.push_back(make_pair(boxes[f].minX(), f));
+        max_rt_width = std::max(max_rt_width, boxes[f].maxX() - boxes[f].minX());
+      }
+      std::sort(rt_starts.begin(), rt_starts.end());
+
+      // find the overlapping features of each MS2 spectrum in parallel
+      vector<vector<Size> > overlapping(exp.size());
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic, 64)
+#endif
+      for (SignedSize scan = 0; scan < (SignedSize)exp.size(); ++scan)
       {
         // skip non-tandem mass spectra
         if (exp[scan].getMSLevel() != 2 || exp[scan].getPrecursors().empty()) continue;
@@ -262,19 +252,29 @@ using namespace std;
         const double pc_mz = exp[scan].getPrecursors()[0].getMZ();
         const double rt = exp[scan].getRT();
         const int pc_charge = exp[scan].getPrecursors()[0].getCharge();
+        const DPosition<2> pc_pos(rt, pc_mz);
 
-        for (Size f = 0; f != features.size(); ++f)
+        vector<pair<double, Size> >::const_iterator it = lower_bound(rt_starts.begin(), rt_starts.end(), make_pair(rt - max_rt_width, Size(0)));
+        for (; it != rt_starts.end() && it->first <= rt; ++it)
         {
+          const Size f = it->second;
           // feature  is incompatible if believe_charge is set and charges don't match
           if (believe_charge && features[f].getCharge() != pc_charge) continue;
 
           // check if precursor/MS2 position overlap with feature
-          if (overlaps_(features[f], rt, pc_mz, rt_tolerance_s))
+          if (boxes[f].encloses(pc_pos))
           {
-            scan_idx_to_feature_idx[scan].insert(f);
+            overlapping[scan].push_back(f);
           }
         }
       }
+      for (Size scan = 0; scan != exp.size(); ++scan)
+      {
+        if (!overlapping[scan].empty())
+        {
+          scan_idx_to_feature_idx[scan].insert(overlapping[scan].begin(), overlapping[scan].end());
+        }
+      }
 
       // filter sets to retain compatible features:
       // if precursor_mz = feature_mz + n * feature_charge (+/- mz_tolerance) a feature is compatible, others are removed from the set
@@ -387,10 +387,9 @@ using namespace std;
       return corrected_precursors;
     }
 
-    bool PrecursorCorrection::overlaps_(const Feature& feature,
-                                        const double rt,
-                                        const double pc_mz,
-                                        const double rt_tolerance)
+    bool PrecursorCorrection::extendedBoundingBox_(const Feature& feature,
+                                                   const double rt_tolerance,
+                                                   DBoundingBox<2>& box)
     {
       if (feature.getConvexHulls().empty())
       {
@@ -398,19 +397,107 @@ using namespace std;
       }
 
       // get bounding box and extend by retention time tolerance
-      DBoundingBox<2> box = feature.getConvexHull().getBoundingBox();
+      box = feature.getConvexHull().getBoundingBox();
       DPosition<2> extend_rt(rt_tolerance, 0.01);
       box.setMin(box.minPosition() - extend_rt);
       box.setMax(box.maxPosition() + extend_rt);
 
+      // the box of an empty hull does not enclose any position
+      return box.minPosition()[0] <= box.maxPosition()[0] && box.minPosition()[1] <= box.maxPosition()[1];
+    }
+
+    bool PrecursorCorrection::overlaps_(const Feature& feature,
+                                        const double rt,
+                                        const double pc_mz,
+                                        const double rt_tolerance)
+    {
+      DBoundingBox<2> box;
+      extendedBoundingBox_(feature, rt_tolerance, box);
+
       DPosition<2> pc_pos(rt, pc_mz);
-      if (box.encloses(pc_pos))
+      return box.encloses(pc_pos);
+    }
+
+    void PrecursorCorrection::searchMS1_(const MSExperiment& exp,
+                                         const vector<Precursor>& precursors,
+                                         const vector<double>& precursors_rt,
+                                         double mz_tolerance,
+                                         bool ppm,
+                                         bool highest_intensity,
+                                         vector<Size>& spectrum_idx,
+                                         vector<SearchResult_>& status,
+                                         vector<double>& peak_mz)
+    {
+      Size err_count(0);
+      std::exception_ptr err;
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic, 64)
+#endif
+      for (SignedSize i = 0; i < (SignedSize)precursors_rt.size(); ++i)
       {
-        return true;
+        try
+        {
+          // get precursor rt and MZ
+          double rt = precursors_rt[i];
+          double mz = precursors[i].getMZ();
+
+          // retrieves iterator of the MS2 fragment sprectrum
+          MSExperiment::ConstIterator rt_it = exp.RTBegin(rt - 1e-8);
+
+          // store index of MS2 spectrum
+          spectrum_idx[i] = rt_it - exp.begin();
+
+          // get parent (MS1) of precursor spectrum
+          rt_it = exp.getPrecursorSpectrum(rt_it);
+
+          if (rt_it == exp.end()
+          || rt_it->getMSLevel() != 1)
+          {
+            status[i] = NO_MS1_;
+            continue;
+          }
+          status[i] = NOT_FOUND_;
+
+          if (highest_intensity)
+          {
+            // get tolerance window and left/right iterator
+            std::pair<double,double> tolerance_window = Math::getTolWindow(mz, mz_tolerance, ppm);
+            MSSpectrum::ConstIterator left = rt_it->MZBegin(tolerance_window.first);
+            MSSpectrum::ConstIterator right = rt_it->MZEnd(tolerance_window.second);
+
+            // no MS1 precursor peak in +- tolerance window found
+            if (left == right || left > right) continue;
+
+            peak_mz[i] = std::max_element(left, right, Peak1D::IntensityLess())->getMZ();
+            status[i] = FOUND_;
+          }
+          else
+          {
+            // find peak (index) closest to expected position
+            double nearest_peak_mz = (*rt_it)[rt_it->findNearest(mz)].getMZ();
+
+            // calculate error between expected and actual position
+            double nearestPeakError = ppm ? abs(nearest_peak_mz - mz)/mz * 1e6 : abs(nearest_peak_mz - mz);
+            if (nearestPeakError < mz_tolerance)
+            {
+              peak_mz[i] = nearest_peak_mz;
+              status[i] = FOUND_;
+            }
+          }
+        }
+        catch (...)
+        {
+#ifdef _OPENMP
+#pragma omp critical (PrecursorCorrection_error)
+#endif
+          {
+            if (err_count++ == 0) err = std::current_exception();
+          }
+        }
       }
-      else
+      if (err_count > 0)
       {
-        return false;
+        std::rethrow_exception(err);
       }
     }
 
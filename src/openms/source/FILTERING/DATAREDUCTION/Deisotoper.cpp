@@ -37,8 +37,11 @@
 #include <OpenMS/CONCEPT/Constants.h>
 #include <OpenMS/FILTERING/DATAREDUCTION/Deisotoper.h>
 #include <OpenMS/KERNEL/MSSpectrum.h>
+#include <OpenMS/KERNEL/MSExperiment.h>
 #include <OpenMS/MATH/MISC/MathFunctions.h>
 
+#include <algorithm>
+
 namespace OpenMS
 {
 
@@ -74,21 +77,40 @@ void Deisotoper::deisotopeAndSingleCharge(MSSpectrum& spec,
     spec.getIntegerDataArrays().back().setName("charge");
   }
 
-  // during discovery phase, work on a constant reference (just to make sure we do not modify spec)
-  const MSSpectrum& old_spectrum = spec;
+  // during discovery phase, work on contiguous copies of the m/z and intensity values (just to make sure we do not modify spec)
+  const Size n_peaks = spec.size();
+  std::vector<double> mzs(n_peaks);
+  std::vector<double> intensities(n_peaks);
+  for (Size i = 0; i != n_peaks; ++i)
+  {
+    mzs[i] = spec[i].getMZ();
+    intensities[i] = spec[i].getIntensity();
+  }
+
+  // expected distances of the isotopic peaks for each charge
+  std::vector<std::vector<double> > isotope_spacings(std::max(max_charge, 0) + 1);
+  for (int q = std::max(min_charge, 0); q <= max_charge; ++q)
+  {
+    isotope_spacings[q].resize(max_isopeaks);
+    for (unsigned int i = 1; i < max_isopeaks; ++i)
+    {
+      isotope_spacings[q][i] = static_cast<double>(i) * Constants::C13C12_MASSDIFF_U / static_cast<double>(q);
+    }
+  }
 
   // determine charge seeds and extend them
-  std::vector<size_t> mono_isotopic_peak(old_spectrum.size(), 0);
-  std::vector<int> features(old_spectrum.size(), -1);
+  std::vector<size_t> mono_isotopic_peak(n_peaks, 0);
+  std::vector<int> features(n_peaks, -1);
   int feature_number = 0;
 
   std::vector<size_t> extensions;
 
-  for (size_t current_peak = 0; current_peak != old_spectrum.size(); ++current_peak)
+  for (size_t current_peak = 0; current_peak != n_peaks; ++current_peak)
   {
-    const double current_mz = old_spectrum[current_peak].getMZ();
+    const double current_mz = mzs[current_peak];
+    const double tolerance_dalton = fragment_unit_ppm ? Math::ppmToMass(fragment_tolerance, current_mz) : fragment_tolerance;
 
-    for (int q = max_charge; q >= min_charge; --q) // important: test charge hypothesis from high to low
+    for (int q = max_charge; q >= std::max(min_charge, 0); --q) // important: test charge hypothesis from high to low
     {
       // try to extend isotopes from mono-isotopic peak
       // if extension larger then min_isopeaks possible:
@@ -97,14 +119,24 @@ void Deisotoper::deisotopeAndSingleCharge(MSSpectrum& spec,
       if (features[current_peak] == -1) // only process peaks which have no assigned feature number
       {
         bool has_min_isopeaks = true;
-        const double tolerance_dalton = fragment_unit_ppm ? Math::ppmToMass(fragment_tolerance, current_mz) : fragment_tolerance;
         extensions.clear();
         extensions.push_back(current_peak);
+
+        // the expected positions increase, so each search can start where the previous one ended
+        std::vector<double>::const_iterator search_begin = mzs.begin() + current_peak;
         for (unsigned int i = 1; i < max_isopeaks; ++i)
         {
-          const double expected_mz = current_mz + static_cast<double>(i) * Constants::C13C12_MASSDIFF_U / static_cast<double>(q);
-          const int p = old_spectrum.findNearest(expected_mz, tolerance_dalton);
-          if (p == -1) // test for missing peak
+          const double expected_mz = current_mz + isotope_spacings[q][i];
+
+          // nearest peak (same as MSSpectrum::findNearest)
+          search_begin = std::lower_bound(search_begin, mzs.cend(), expected_mz);
+          Size p = search_begin - mzs.begin();
+          if (p == n_peaks || (p != 0 && std::fabs(mzs[p] - expected_mz) >= std::fabs(mzs[p - 1] - expected_mz)))
+          {
+            --p;
+          }
+
+          if (!(mzs[p] >= expected_mz - tolerance_dalton && mzs[p] <= expected_mz + tolerance_dalton)) // test for missing peak
           {
             has_min_isopeaks = (i >= min_isopeaks);
             break;
@@ -113,7 +145,7 @@ void Deisotoper::deisotopeAndSingleCharge(MSSpectrum& spec,
           {
             // Possible improvement: include proper averagine model filtering. for now start at the second peak to test hypothesis
             // Note: this is a common approach used in several other search engines
-            if (old_spectrum[p].getIntensity() > old_spectrum[extensions.back()].getIntensity())
+            if (intensities[p] > intensities[extensions.back()])
             {
               has_min_isopeaks = (i >= min_isopeaks);
               break;
@@ -171,5 +203,38 @@ void Deisotoper::deisotopeAndSingleCharge(MSSpectrum& spec,
   spec.select(select_idx);
   spec.sortByPosition();
 }
-} // namespace
 
+// static
+void Deisotoper::deisotopeAndSingleCharge(PeakMap& exp,
+                      double fragment_tolerance,
+                      bool fragment_unit_ppm,
+                      int min_charge,
+                      int max_charge,
+                      bool keep_only_deisotoped,
+                      unsigned int min_isopeaks,
+                      unsigned int max_isopeaks,
+                      bool make_single_charged,
+                      bool annotate_charge)
+{
+  if (min_isopeaks < 2 || max_isopeaks < 2 || min_isopeaks > max_isopeaks)
+  {
+    throw Exception::IllegalArgument(__FILE__, 
+		    __LINE__, 
+		    OPENMS_PRETTY_FUNCTION, 
+		    "Minimum/maximum number of isotopic peaks must be at least 2 (and min_isopeaks <= max_isopeaks).");
+  }
+
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic)
+#endif
+  for (SignedSize i = 0; i < (SignedSize)exp.size(); ++i)
+  {
+    if (!exp[i].isSorted())
+    {
+      exp[i].sortByPosition();
+    }
+    deisotopeAndSingleCharge(exp[i], fragment_tolerance, fragment_unit_ppm, min_charge, max_charge,
+      keep_only_deisotoped, min_isopeaks, max_isopeaks, make_single_charged, annotate_charge);
+  }
+}
+} // namespace
@@ -332,6 +332,9 @@ namespace OpenMS
 
     this->startProgress(0, mt_vec.size(), "elution peak detection");
     Size progress(0);
+    // the peaks of each trace are collected separately (no synchronization
+    // needed) and merged in input order afterwards
+    std::vector<std::vector<MassTrace> > local_mtraces(mt_vec.size());
 #ifdef _OPENMP
 #pragma omp parallel for
 #endif
@@ -344,8 +347,19 @@ namespace OpenMS
 #endif
       ++progress;
 
-      // push_back to 'single_mtraces' is protected, so threading is ok
-      detectElutionPeaks_(mt_vec[i], single_mtraces);
+      detectElutionPeaks_(mt_vec[i], local_mtraces[i]);
+    }
+
+    Size mtraces_count(0);
+    for (Size i = 0; i < local_mtraces.size(); ++i)
+    {
+      mtraces_count += local_mtraces[i].size();
+    }
+    single_mtraces.reserve(mtraces_count);
+    for (Size i = 0; i < local_mtraces.size(); ++i)
+    {
+      single_mtraces.insert(single_mtraces.end(), local_mtraces[i].begin(), local_mtraces[i].end());
+      std::vector<MassTrace>().swap(local_mtraces[i]);
     }
 
     this->endProgress();
@@ -464,12 +478,7 @@ namespace OpenMS
           mt.estimateFWHM(true);
         }
 
-#ifdef _OPENMP
-#pragma omp critical (OPENMS_ElutionPeakDetection_mtraces)
-#endif
-        {
-          single_mtraces.push_back(mt);
-        }
+        single_mtraces.push_back(mt);
 
       }
     }
@@ -545,12 +554,7 @@ namespace OpenMS
             new_mt.estimateFWHM(true);
           }
 
-#ifdef _OPENMP
-#pragma omp critical (OPENMS_ElutionPeakDetection_mtraces)
-#endif
-          {
-            single_mtraces.push_back(new_mt);
-          }
+          single_mtraces.push_back(new_mt);
         }
       }
 
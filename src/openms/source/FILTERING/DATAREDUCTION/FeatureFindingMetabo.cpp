@@ -33,11 +33,12 @@
 // --------------------------------------------------------------------------
 
 #include <OpenMS/FILTERING/DATAREDUCTION/FeatureFindingMetabo.h>
-#include <OpenMS/CHEMISTRY/ISOTOPEDISTRIBUTION/CoarseIsotopePatternGenerator.h>
+#include <OpenMS/CHEMISTRY/ISOTOPEDISTRIBUTION/IsotopePatternCache.h>
 #include <OpenMS/SYSTEM/File.h>
 #include <OpenMS/ANALYSIS/OPENSWATH/OpenSwathHelper.h>
 
 #include <fstream>
+#include <iterator>
 
 #include <boost/dynamic_bitset.hpp>
 
@@ -49,6 +50,7 @@
 namespace OpenMS
 {
   FeatureHypothesis::FeatureHypothesis() :
+    mass_traces_(nullptr),
     iso_pattern_(),
     feat_score_(),
     charge_()
@@ -56,34 +58,33 @@ namespace OpenMS
 
   }
 
-  FeatureHypothesis::~FeatureHypothesis()
+  FeatureHypothesis::FeatureHypothesis(const std::vector<MassTrace>& mass_traces) :
+    mass_traces_(&mass_traces),
+    iso_pattern_(),
+    feat_score_(),
+    charge_()
   {
 
   }
 
-  FeatureHypothesis::FeatureHypothesis(const FeatureHypothesis& fh) :
-    iso_pattern_(fh.iso_pattern_),
-    feat_score_(fh.feat_score_),
-    charge_(fh.charge_)
+  FeatureHypothesis::~FeatureHypothesis()
   {
 
   }
 
-  FeatureHypothesis& FeatureHypothesis::operator=(const FeatureHypothesis& rhs)
+  void FeatureHypothesis::addMassTrace(Size index)
   {
-    if (this == &rhs)
-      return *this;
-
-    iso_pattern_ = rhs.iso_pattern_;
-    feat_score_ = rhs.feat_score_;
-    charge_ = rhs.charge_;
+    iso_pattern_.push_back(index);
+  }
 
-    return *this;
+  const std::vector<Size>& FeatureHypothesis::getMassTraceIndices() const
+  {
+    return iso_pattern_;
   }
 
-  void FeatureHypothesis::addMassTrace(const MassTrace& mt_ptr)
+  const MassTrace& FeatureHypothesis::getTrace_(Size i) const
   {
-    iso_pattern_.push_back(&mt_ptr);
+    return (*mass_traces_)[iso_pattern_[i]];
   }
 
   double FeatureHypothesis::getMonoisotopicFeatureIntensity(bool smoothed = false) const
@@ -93,7 +94,7 @@ namespace OpenMS
       throw Exception::InvalidValue(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION,
           "FeatureHypothesis is empty, no traces contained!", String(iso_pattern_.size()));
     }
-    return iso_pattern_[0]->getIntensity(smoothed);
+    return getTrace_(0).getIntensity(smoothed);
   }
 
   double FeatureHypothesis::getSummedFeatureIntensity(bool smoothed = false) const
@@ -101,7 +102,7 @@ namespace OpenMS
     double int_sum(0.0);
     for (Size i = 0; i < iso_pattern_.size(); ++i)
     {
-      int_sum += iso_pattern_[i]->getIntensity(smoothed);
+      int_sum += getTrace_(i).getIntensity(smoothed);
     }
     return int_sum;
   }
@@ -112,7 +113,7 @@ namespace OpenMS
 
     for (Size mt_idx = 0; mt_idx < iso_pattern_.size(); ++mt_idx)
     {
-      num_points += iso_pattern_[mt_idx]->getSize();
+      num_points += getTrace_(mt_idx).getSize();
     }
 
     return num_points;
@@ -123,10 +124,10 @@ namespace OpenMS
     std::vector<ConvexHull2D> tmp_hulls;
     for (Size mt_idx = 0; mt_idx < iso_pattern_.size(); ++mt_idx)
     {
-      ConvexHull2D::PointArrayType hull_points(iso_pattern_[mt_idx]->getSize());
+      ConvexHull2D::PointArrayType hull_points(getTrace_(mt_idx).getSize());
 
       Size i = 0;
-      for (MassTrace::const_iterator l_it = iso_pattern_[mt_idx]->begin(); l_it != iso_pattern_[mt_idx]->end(); ++l_it)
+      for (MassTrace::const_iterator l_it = getTrace_(mt_idx).begin(); l_it != getTrace_(mt_idx).end(); ++l_it)
       {
         hull_points[i][0] = (*l_it).getRT();
         hull_points[i][1] = (*l_it).getMZ();
@@ -142,7 +143,7 @@ namespace OpenMS
 
   std::vector< OpenMS::MSChromatogram > FeatureHypothesis::getChromatograms(UInt64 feature_id) const
   {
-    double mz = iso_pattern_[0]->getCentroidMZ();
+    double mz = getTrace_(0).getCentroidMZ();
     Precursor prec;
     prec.setMZ(mz);
     prec.setCharge(charge_);
@@ -153,7 +154,7 @@ namespace OpenMS
     {
       OpenMS::MSChromatogram chromatogram;
 
-      for (MassTrace::const_iterator l_it = iso_pattern_[mt_idx]->begin(); l_it != iso_pattern_[mt_idx]->end(); ++l_it)
+      for (MassTrace::const_iterator l_it = getTrace_(mt_idx).begin(); l_it != getTrace_(mt_idx).end(); ++l_it)
       {
         ChromatogramPeak peak;
         peak.setRT((*l_it).getRT());
@@ -187,7 +188,7 @@ namespace OpenMS
 
     for (Size i = 0; i < iso_pattern_.size(); ++i)
     {
-      tmp_labels.push_back(iso_pattern_[i]->getLabel());
+      tmp_labels.push_back(getTrace_(i).getLabel());
     }
 
     return tmp_labels;
@@ -213,7 +214,7 @@ namespace OpenMS
     std::vector<double> tmp;
     for (Size i = 0; i < iso_pattern_.size(); ++i)
     {
-      tmp.push_back(iso_pattern_[i]->getIntensity(smoothed));
+      tmp.push_back(getTrace_(i).getIntensity(smoothed));
     }
     return tmp;
   }
@@ -224,7 +225,7 @@ namespace OpenMS
     std::vector<double> tmp;
     for (Size i = 0; i < iso_pattern_.size(); ++i)
     {
-      tmp.push_back(iso_pattern_[i]->getCentroidMZ());
+      tmp.push_back(getTrace_(i).getCentroidMZ());
     }
     return tmp;
   }
@@ -234,7 +235,7 @@ namespace OpenMS
     std::vector<double> tmp;
     for (Size i = 0; i < iso_pattern_.size(); ++i)
     {
-      tmp.push_back(iso_pattern_[i]->getCentroidRT());
+      tmp.push_back(getTrace_(i).getCentroidRT());
     }
     return tmp;
   }
@@ -245,7 +246,7 @@ namespace OpenMS
 
     for (Size i = 1; i < iso_pattern_.size(); ++i)
     {
-      tmp.push_back(iso_pattern_[i]->getCentroidMZ() - iso_pattern_[i-1]->getCentroidMZ());
+      tmp.push_back(getTrace_(i).getCentroidMZ() - getTrace_(i-1).getCentroidMZ());
     }
 
     return tmp;
@@ -258,7 +259,7 @@ namespace OpenMS
       throw Exception::InvalidValue(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION,
                                     "FeatureHypothesis is empty, no centroid MZ!", String(iso_pattern_.size()));
     }
-    return iso_pattern_[0]->getCentroidMZ();
+    return getTrace_(0).getCentroidMZ();
   }
 
   double FeatureHypothesis::getCentroidRT() const
@@ -268,7 +269,7 @@ namespace OpenMS
       throw Exception::InvalidValue(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION,
         "FeatureHypothesis is empty, no centroid RT!", String(iso_pattern_.size()));
     }
-    return iso_pattern_[0]->getCentroidRT();
+    return getTrace_(0).getCentroidRT();
   }
 
   double FeatureHypothesis::getFWHM() const
@@ -277,7 +278,7 @@ namespace OpenMS
     {
       return 0.0;
     }
-    return iso_pattern_[0]->getFWHM();
+    return getTrace_(0).getFWHM();
   }
 
   double FeatureHypothesis::getScore() const
@@ -350,30 +351,22 @@ namespace OpenMS
 
   double FeatureFindingMetabo::computeAveragineSimScore_(const std::vector<double>& hypo_ints, const double& mol_weight) const
   {
-    CoarseIsotopePatternGenerator solver(hypo_ints.size());
-    auto isodist = solver.estimateFromPeptideWeight(mol_weight);
-    // isodist.renormalize();
-
-    IsotopeDistribution::ContainerType averagine_dist = isodist.getContainer();
-    double max_int(0.0), theo_max_int(0.0);
+    // theoretical intensities (normalized to a maximum of 1) from the shared cache
+    const std::vector<double>& averagine_ints = IsotopePatternCache::getInstance()->getAveragineIntensities(mol_weight, hypo_ints.size());
+    double max_int(0.0);
     for (Size i = 0; i < hypo_ints.size(); ++i)
     {
       if (hypo_ints[i] > max_int)
       {
         max_int = hypo_ints[i];
       }
-
-      if (averagine_dist[i].getIntensity() > theo_max_int)
-      {
-        theo_max_int = averagine_dist[i].getIntensity();
-      }
     }
 
     // compute normalized intensities
     std::vector<double> averagine_ratios, hypo_isos;
     for (Size i = 0; i < hypo_ints.size(); ++i)
     {
-      averagine_ratios.push_back(averagine_dist[i].getIntensity() / theo_max_int);
+      averagine_ratios.push_back(i < averagine_ints.size() ? averagine_ints[i] : 0.0);
       hypo_isos.push_back(hypo_ints[i] / max_int);
     }
 
@@ -651,26 +644,24 @@ namespace OpenMS
   }
 
 
-  void FeatureFindingMetabo::findLocalFeatures_(const std::vector<const MassTrace*>& candidates, const double total_intensity, std::vector<FeatureHypothesis>& output_hypotheses) const
+  void FeatureFindingMetabo::findLocalFeatures_(const std::vector<MassTrace>& mass_traces, const std::vector<Size>& candidates, const double total_intensity, std::vector<FeatureHypothesis>& output_hypotheses) const
   {
-    // single Mass trace hypothesis
-    FeatureHypothesis tmp_hypo;
-    tmp_hypo.addMassTrace(*candidates[0]);
-    tmp_hypo.setScore((candidates[0]->getIntensity(use_smoothed_intensities_)) / total_intensity);
+    const MassTrace& mono_trace = mass_traces[candidates[0]];
+    double mono_score = mono_trace.getIntensity(use_smoothed_intensities_) / total_intensity;
 
-#ifdef _OPENMP
-#pragma omp critical (OPENMS_FFMetabo_output_hypos)
-#endif
-    {
-      // pushing back to shared vector needs to be synchronized
-      output_hypotheses.push_back(tmp_hypo);
-    }
+    // single Mass trace hypothesis
+    FeatureHypothesis tmp_hypo(mass_traces);
+    tmp_hypo.addMassTrace(candidates[0]);
+    tmp_hypo.setScore(mono_score);
+    output_hypotheses.push_back(std::move(tmp_hypo));
 
     for (Size charge = charge_lower_bound_; charge <= charge_upper_bound_; ++charge)
     {
-      FeatureHypothesis fh_tmp;
-      fh_tmp.addMassTrace(*candidates[0]);
-      fh_tmp.setScore((candidates[0]->getIntensity(use_smoothed_intensities_)) / total_intensity);
+      // the hypothesis is extended trace by trace, with each extension
+      // stored as a new hypothesis
+      std::vector<Size> pattern(1, candidates[0]);
+      std::vector<double> pattern_ints(1, mono_trace.getIntensity(false));
+      double pattern_score = mono_score;
 
       // double mono_iso_rt(candidates[0]->getCentroidRT());
       // double mono_iso_mz(candidates[0]->getCentroidMZ());
@@ -692,13 +683,14 @@ namespace OpenMS
           // double tmp_iso_int(candidates[mt_idx]->computePeakArea());
 
 #ifdef FFM_DEBUG
-          std::cout << "scoring " << candidates[0]->getLabel() << " " << candidates[0]->getCentroidMZ() << 
-            " with " << candidates[mt_idx]->getLabel() << " " << candidates[mt_idx]->getCentroidMZ() << std::endl;
+          std::cout << "scoring " << mono_trace.getLabel() << " " << mono_trace.getCentroidMZ() << 
+            " with " << mass_traces[candidates[mt_idx]].getLabel() << " " << mass_traces[candidates[mt_idx]].getCentroidMZ() << std::endl;
 #endif
 
           // Score current mass trace candidates against hypothesis
-          double rt_score(scoreRT_(*candidates[0], *candidates[mt_idx]));
-          double mz_score(scoreMZ_(*candidates[0], *candidates[mt_idx], iso_pos, charge));
+          const MassTrace& candidate = mass_traces[candidates[mt_idx]];
+          double rt_score(scoreRT_(mono_trace, candidate));
+          double mz_score(scoreMZ_(mono_trace, candidate, iso_pos, charge));
 
           // disable intensity scoring for now...
           double int_score(1.0);
@@ -706,13 +698,13 @@ namespace OpenMS
 
           if (isotope_filtering_model_ == "peptides")
           {
-            std::vector<double> tmp_ints(fh_tmp.getAllIntensities());
-            tmp_ints.push_back(candidates[mt_idx]->getIntensity(use_smoothed_intensities_));
-            int_score = computeAveragineSimScore_(tmp_ints, candidates[mt_idx]->getCentroidMZ() * charge);
+            std::vector<double> tmp_ints(pattern_ints);
+            tmp_ints.push_back(candidate.getIntensity(use_smoothed_intensities_));
+            int_score = computeAveragineSimScore_(tmp_ints, candidate.getCentroidMZ() * charge);
           }
 
 #ifdef FFM_DEBUG
-          std::cout << fh_tmp.getLabel() << "_" << candidates[mt_idx]->getLabel() << 
+          std::cout << mono_trace.getLabel() << "_" << candidate.getLabel() << 
             "\t" << "ch: " << charge << " isopos: " << iso_pos << " rt: " << 
             rt_score << "mz: " << mz_score << "int: " << int_score << std::endl;
 #endif
@@ -733,20 +725,21 @@ namespace OpenMS
         // and isotopic position
         if (best_so_far > 0.0)
         {
-          fh_tmp.addMassTrace(*candidates[best_idx]);
-          double weighted_score(((candidates[best_idx]->getIntensity(use_smoothed_intensities_)) * best_so_far) / total_intensity);
-
-          fh_tmp.setScore(fh_tmp.getScore() + weighted_score);
-          fh_tmp.setCharge(charge);
+          const MassTrace& best_trace = mass_traces[candidates[best_idx]];
+          pattern.push_back(candidates[best_idx]);
+          pattern_ints.push_back(best_trace.getIntensity(false));
+          double weighted_score(((best_trace.getIntensity(use_smoothed_intensities_)) * best_so_far) / total_intensity);
+          pattern_score += weighted_score;
           last_iso_idx = best_idx;
 
-#ifdef _OPENMP
-#pragma omp critical (OPENMS_FFMetabo_output_hypos)
-#endif
+          FeatureHypothesis fh_tmp(mass_traces);
+          for (Size i = 0; i < pattern.size(); ++i)
           {
-            // pushing back to shared vector needs to be synchronized
-            output_hypotheses.push_back(fh_tmp);
+            fh_tmp.addMassTrace(pattern[i]);
           }
+          fh_tmp.setScore(pattern_score);
+          fh_tmp.setCharge(charge);
+          output_hypotheses.push_back(std::move(fh_tmp));
         }
         else
         {
@@ -755,7 +748,7 @@ namespace OpenMS
       } // end for iso_pos
 
 #ifdef FFM_DEBUG
-      std::cout << "best found for ch " << charge << ":" << fh_tmp.getLabel() << " score: " << fh_tmp.getScore() << std::endl;
+      std::cout << "best found for ch " << charge << ": " << pattern.size() << " traces, score: " << pattern_score << std::endl;
 #endif
     } // end for charge
   } // end of findLocalFeatures_(...)
@@ -800,7 +793,9 @@ namespace OpenMS
     // and generate isotopic / charge hypotheses
     // *********************************************************** //
 
-    std::vector<FeatureHypothesis> feat_hypos;
+    // hypotheses are collected per mass trace (no synchronization needed)
+    // and merged afterwards
+    std::vector<std::vector<FeatureHypothesis> > local_hypos(input_mtraces.size());
     Size progress(0);
 #ifdef _OPENMP
 #pragma omp parallel for
@@ -813,11 +808,11 @@ namespace OpenMS
 #endif
       ++progress;
 
-      std::vector<const MassTrace*> local_traces;
+      std::vector<Size> local_traces;
       double ref_trace_mz(input_mtraces[i].getCentroidMZ());
       double ref_trace_rt(input_mtraces[i].getCentroidRT());
 
-      local_traces.push_back(&input_mtraces[i]);
+      local_traces.push_back(i);
 
       for (Size ext_idx = i + 1; ext_idx < input_mtraces.size(); ++ext_idx)
       {
@@ -829,13 +824,26 @@ namespace OpenMS
         if (diff_rt <= local_rt_range_)
         {
           // std::cout << " accepted!" << std::endl;
-          local_traces.push_back(&input_mtraces[ext_idx]);
+          local_traces.push_back(ext_idx);
         }
       }
-      findLocalFeatures_(local_traces, total_intensity, feat_hypos);
+      findLocalFeatures_(input_mtraces, local_traces, total_intensity, local_hypos[i]);
     }
     this->endProgress();
 
+    Size hypos_count(0);
+    for (Size i = 0; i < local_hypos.size(); ++i)
+    {
+      hypos_count += local_hypos[i].size();
+    }
+    std::vector<FeatureHypothesis> feat_hypos;
+    feat_hypos.reserve(hypos_count);
+    for (Size i = 0; i < local_hypos.size(); ++i)
+    {
+      std::move(local_hypos[i].begin(), local_hypos[i].end(), std::back_inserter(feat_hypos));
+      std::vector<FeatureHypothesis>().swap(local_hypos[i]);
+    }
+
     // sort feature candidates by their score
     std::sort(feat_hypos.begin(), feat_hypos.end(), CmpHypothesesByScore());
 
@@ -855,15 +863,15 @@ namespace OpenMS
     // scoring one. Accept them if they do not contain traces that have 
     // already been used by a higher scoring hypothesis.
     // *********************************************************** //
-    std::map<String, bool> trace_excl_map;
+    std::vector<bool> trace_excluded(input_mtraces.size(), false);
     for (Size hypo_idx = 0; hypo_idx < feat_hypos.size(); ++hypo_idx)
     {
       // std::cout << "score now: " <<  feat_hypos[hypo_idx].getScore() << std::endl;
-      std::vector<String> labels(feat_hypos[hypo_idx].getLabels());
+      const std::vector<Size>& trace_indices = feat_hypos[hypo_idx].getMassTraceIndices();
       bool trace_coll = false;   // trace collision?
-      for (Size lab_idx = 0; lab_idx < labels.size(); ++lab_idx)
+      for (Size i = 0; i < trace_indices.size(); ++i)
       {
-        if (trace_excl_map.find(labels[lab_idx]) != trace_excl_map.end())
+        if (trace_excluded[trace_indices[i]])
         {
           trace_coll = true;
           break;
@@ -945,10 +953,10 @@ namespace OpenMS
       {
         output_chromatograms.push_back(feat_hypos[hypo_idx].getChromatograms(f.getUniqueId()));
       }
-      // add used traces to exclusion map
-      for (Size lab_idx = 0; lab_idx < labels.size(); ++lab_idx)
+      // exclude used traces
+      for (Size i = 0; i < trace_indices.size(); ++i)
       {
-        trace_excl_map[labels[lab_idx]] = true;
+        trace_excluded[trace_indices[i]] = true;
       }
     }
     output_featmap.setUniqueId(UniqueIdGenerator::getUniqueId());
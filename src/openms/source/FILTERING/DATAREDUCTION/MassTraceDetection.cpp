@@ -62,6 +62,11 @@ namespace OpenMS
     defaults_.setValue("min_trace_length", 5.0, "Minimum expected length of a mass trace (in seconds).", ListUtils::create<String>("advanced"));
     defaults_.setValue("max_trace_length", -1.0, "Maximum expected length of a mass trace (in seconds). Set to a negative value to disable maximal length check during mass trace detection.", ListUtils::create<String>("advanced"));
 
+    defaults_.setValue("num_mz_slabs", 1, "Number of m/z slabs for partitioned (parallel) mass trace detection. With a value of 1, traces are detected serially in the whole map.", ListUtils::create<String>("advanced"));
+    defaults_.setMinInt("num_mz_slabs", 1);
+    defaults_.setValue("mz_slab_overlap", 0.2, "Overlap of neighbouring m/z slabs (in Th, see num_mz_slabs). Needs to be larger than the m/z extent of a mass trace.", ListUtils::create<String>("advanced"));
+    defaults_.setMinFloat("mz_slab_overlap", 0.0);
+
     defaultsToParam_();
 
     this->setLogType(CMD);
@@ -249,7 +254,14 @@ namespace OpenMS
     // Step 2: start extending mass traces beginning with the apex peak (go
     // through all peaks in order of decreasing intensity)
     // *********************************************************************
-    run_(chrom_apices, total_peak_count, work_exp, spec_offsets, found_masstraces);
+    if (num_mz_slabs_ > 1)
+    {
+      runPartitioned_(chrom_apices, total_peak_count, work_exp, spec_offsets, found_masstraces);
+    }
+    else
+    {
+      run_(chrom_apices, total_peak_count, work_exp, spec_offsets, found_masstraces);
+    }
 
     return;
   } // end of MassTraceDetection::run
@@ -258,7 +270,9 @@ namespace OpenMS
                                 const Size total_peak_count, 
                                 const PeakMap& work_exp, 
                                 const std::vector<Size>& spec_offsets,
-                                std::vector<MassTrace>& found_masstraces)
+                                std::vector<MassTrace>& found_masstraces,
+                                std::vector<std::vector<std::pair<Size, Size> > >* found_peaks,
+                                bool report_progress)
   {
     boost::dynamic_bitset<> peak_visited(total_peak_count);
     Size trace_number(1);
@@ -286,7 +300,7 @@ namespace OpenMS
     }
      
 
-    this->startProgress(0, total_peak_count, "mass trace detection");
+    if (report_progress) this->startProgress(0, total_peak_count, "mass trace detection");
     Size peaks_detected(0);
 
     for (MapIdxSortedByInt::const_reverse_iterator m_it = chrom_apices.rbegin(); m_it != chrom_apices.rend(); ++m_it)
@@ -537,14 +551,142 @@ namespace OpenMS
         ++trace_number;
 
         found_masstraces.push_back(new_trace);
+        if (found_peaks) found_peaks->push_back(gathered_idx);
 
         peaks_detected += new_trace.getSize();
-        this->setProgress(peaks_detected);
+        if (report_progress) this->setProgress(peaks_detected);
       }
     }
 
+    if (report_progress) this->endProgress();
+
+  }
+
+  void MassTraceDetection::runPartitioned_(const MapIdxSortedByInt& chrom_apices,
+                                           const Size total_peak_count,
+                                           const PeakMap& work_exp,
+                                           const std::vector<Size>& spec_offsets,
+                                           std::vector<MassTrace>& found_masstraces)
+  {
+    if (chrom_apices.empty()) return;
+
+    // slab borders: quantiles of the apex m/z values (for similar work per slab)
+    std::vector<double> apex_mzs;
+    apex_mzs.reserve(chrom_apices.size());
+    for (MapIdxSortedByInt::const_iterator m_it = chrom_apices.begin(); m_it != chrom_apices.end(); ++m_it)
+    {
+      apex_mzs.push_back(work_exp[m_it->second.first][m_it->second.second].getMZ());
+    }
+    std::sort(apex_mzs.begin(), apex_mzs.end());
+    Size num_slabs = std::min(num_mz_slabs_, apex_mzs.size());
+    std::vector<double> borders(num_slabs + 1);
+    borders[0] = -std::numeric_limits<double>::max();
+    borders[num_slabs] = std::numeric_limits<double>::max();
+    for (Size k = 1; k < num_slabs; ++k)
+    {
+      borders[k] = apex_mzs[k * apex_mzs.size() / num_slabs];
+    }
+
+    // detect traces in each slab (with its own copy of the peaks in range):
+    std::vector<std::vector<MassTrace> > slab_traces(num_slabs);
+    std::vector<std::vector<std::vector<std::pair<Size, Size> > > > slab_peaks(num_slabs);
+    std::vector<std::vector<Size> > slab_first_peaks(num_slabs);
+    this->startProgress(0, num_slabs, "mass trace detection");
+#pragma omp parallel for schedule(dynamic, 1)
+    for (SignedSize k = 0; k < (SignedSize)num_slabs; ++k)
+    {
+      double lower = borders[k] - mz_slab_overlap_, upper = borders[k + 1] + mz_slab_overlap_;
+      PeakMap slab_exp;
+      std::vector<Size>& first_peaks = slab_first_peaks[k];
+      std::vector<Size> slab_offsets(1, 0);
+      for (Size i = 0; i < work_exp.size(); ++i)
+      {
+        const MSSpectrum& spec = work_exp[i];
+        Size first = spec.MZBegin(lower) - spec.begin(), last = spec.MZBegin(upper) - spec.begin();
+        MSSpectrum slab_spec;
+        slab_spec.setRT(spec.getRT());
+        slab_spec.insert(slab_spec.end(), spec.begin() + first, spec.begin() + last);
+        for (Size j = 0; j < spec.getFloatDataArrays().size(); ++j)
+        {
+          const MSSpectrum::FloatDataArray& array = spec.getFloatDataArrays()[j];
+          MSSpectrum::FloatDataArray slab_array;
+          slab_array.setName(array.getName());
+          slab_array.insert(slab_array.end(), array.begin() + std::min(first, array.size()), array.begin() + std::min(last, array.size()));
+          slab_spec.getFloatDataArrays().push_back(slab_array);
+        }
+        first_peaks.push_back(first);
+        slab_offsets.push_back(slab_offsets.back() + slab_spec.size());
+        slab_exp.addSpectrum(slab_spec);
+      }
+      Size slab_peak_count = slab_offsets.back();
+      slab_offsets.pop_back();
+
+      // apices in range (in the original order, also for equal intensities):
+      MapIdxSortedByInt slab_apices;
+      for (MapIdxSortedByInt::const_iterator m_it = chrom_apices.begin(); m_it != chrom_apices.end(); ++m_it)
+      {
+        Size scan_idx = m_it->second.first, peak_idx = m_it->second.second;
+        double mz = work_exp[scan_idx][peak_idx].getMZ();
+        if (mz >= lower && mz < upper)
+        {
+          slab_apices.insert(slab_apices.end(), std::make_pair(m_it->first, std::make_pair(scan_idx, peak_idx - first_peaks[scan_idx])));
+        }
+      }
+
+      run_(slab_apices, slab_peak_count, slab_exp, slab_offsets, slab_traces[k], &slab_peaks[k], false);
+
+      this->nextProgress();
+    }
     this->endProgress();
 
+    // collect the traces whose apex lies in the slab itself, in the order
+    // of the serial detection (decreasing apex intensity):
+    std::vector<Size> apex_ranks(total_peak_count, 0);
+    Size rank(0);
+    for (MapIdxSortedByInt::const_reverse_iterator m_it = chrom_apices.rbegin(); m_it != chrom_apices.rend(); ++m_it)
+    {
+      apex_ranks[spec_offsets[m_it->second.first] + m_it->second.second] = rank++;
+    }
+    std::vector<std::pair<Size, std::pair<Size, Size> > > candidates; // (apex rank, (slab, trace))
+    for (Size k = 0; k < num_slabs; ++k)
+    {
+      for (Size t = 0; t < slab_traces[k].size(); ++t)
+      {
+        std::vector<std::pair<Size, Size> >& peaks = slab_peaks[k][t];
+        for (Size i = 0; i < peaks.size(); ++i)
+        {
+          peaks[i].second += slab_first_peaks[k][peaks[i].first]; // index in work_exp
+        }
+        double apex_mz = work_exp[peaks[0].first][peaks[0].second].getMZ();
+        if (apex_mz >= borders[k] && apex_mz < borders[k + 1])
+        {
+          candidates.push_back(std::make_pair(apex_ranks[spec_offsets[peaks[0].first] + peaks[0].second], std::make_pair(k, t)));
+        }
+      }
+    }
+    std::sort(candidates.begin(), candidates.end());
+
+    // remove traces conflicting with a previous trace from another slab:
+    boost::dynamic_bitset<> peak_used(total_peak_count);
+    Size trace_number(1);
+    for (Size c = 0; c < candidates.size(); ++c)
+    {
+      Size k = candidates[c].second.first, t = candidates[c].second.second;
+      const std::vector<std::pair<Size, Size> >& peaks = slab_peaks[k][t];
+      bool conflict = false;
+      for (Size i = 0; i < peaks.size() && !conflict; ++i)
+      {
+        conflict = peak_used[spec_offsets[peaks[i].first] + peaks[i].second];
+      }
+      if (conflict) continue;
+      for (Size i = 0; i < peaks.size(); ++i)
+      {
+        peak_used[spec_offsets[peaks[i].first] + peaks[i].second] = true;
+      }
+      slab_traces[k][t].setLabel("T" + String(trace_number));
+      ++trace_number;
+      found_masstraces.push_back(slab_traces[k][t]);
+    }
   }
   
   void MassTraceDetection::updateMembers_()
@@ -560,6 +702,8 @@ namespace OpenMS
     min_trace_length_ = (double)param_.getValue("min_trace_length");
     max_trace_length_ = (double)param_.getValue("max_trace_length");
     reestimate_mt_sd_ = param_.getValue("reestimate_mt_sd").toBool();
+    num_mz_slabs_ = (Size)param_.getValue("num_mz_slabs");
+    mz_slab_overlap_ = (double)param_.getValue("mz_slab_overlap");
   }
 
 }
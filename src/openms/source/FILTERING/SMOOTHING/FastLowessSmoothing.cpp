@@ -46,12 +46,17 @@
 */
 
 #include <OpenMS/FILTERING/SMOOTHING/FastLowessSmoothing.h>
+#include <OpenMS/CONCEPT/Types.h>
 
 #include <cmath>
 #include <algorithm>    // std::min, std::max
 #include <cstdlib>
 #include <vector>
 
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
 namespace c_lowess
 {
 
@@ -499,8 +504,51 @@ namespace c_lowess
       }
     }
 
+    /// Find the points at which the regression is computed and their
+    /// neighborhoods (these only depend on x, not on y or the iteration).
+    void find_fit_points(const ContainerType& x,
+                         const size_t n,
+                         const size_t ns,
+                         const ValueType delta,
+                         std::vector<size_t>& fit_index,
+                         std::vector<size_t>& fit_nleft,
+                         std::vector<size_t>& fit_nright)
+    {
+      fit_index.clear();
+      fit_nleft.clear();
+      fit_nright.clear();
+
+      size_t i(0), last(-1), nleft(0), nright(ns - 1);
+      do
+      {
+        update_neighborhood(x, n, i, nleft, nright);
+        fit_index.push_back(i);
+        fit_nleft.push_back(nleft);
+        fit_nright.push_back(nright);
+
+        // same as update_indices, without copying the fitted values of ties
+        last = i;
+        ValueType cut = x[last] + delta;
+        for (i = last + 1; i < n; i++)
+        {
+          if (x[i] > cut) break;
+          if (x[i] == x[last]) last = i;
+        }
+        i = std::max(last + 1, i - 1);
+      } while (last < n - 1);
+    }
+
 public:
 
+    /**
+      @brief Lowess fit
+
+      The local regressions of each robustness iteration are independent of
+      each other and are computed in parallel (each thread uses its own
+      vector of @p thread_weights). Interpolation of skipped points and
+      copying of tied points is done afterwards in the original order, so the
+      result does not depend on the number of threads.
+    */
     int lowess(const ContainerType& x,
                const ContainerType& y,
                double frac,    // parameter f
@@ -508,11 +556,14 @@ public:
                ValueType delta,
                ContainerType& ys,
                ContainerType& resid_weights,   // vector rw
-               ContainerType& weights   // vector res
+               ContainerType& weights,   // vector res
+               std::vector<ContainerType>& thread_weights,
+               std::vector<size_t>& fit_index,
+               std::vector<size_t>& fit_nleft,
+               std::vector<size_t>& fit_nright,
+               ContainerType& fit_values
                )
     {
-      bool fit_ok;
-
       size_t ns, n(x.size());
       if (n < 2)
       {
@@ -525,28 +576,51 @@ public:
       size_t tmp = (size_t)(frac * (double)n);
       ns = std::max(std::min(tmp, n), (size_t)2);
 
+      find_fit_points(x, n, ns, delta, fit_index, fit_nleft, fit_nright);
+      const OpenMS::SignedSize nr_fits = fit_index.size();
+      fit_values.resize(nr_fits);
+
+      int nr_threads = 1;
+#ifdef _OPENMP
+      nr_threads = omp_get_max_threads();
+#endif
+      thread_weights.resize(nr_threads);
+      for (OpenMS::Size t = 0; t < thread_weights.size(); ++t)
+      {
+        thread_weights[t].resize(n);
+      }
+
       // robustness iterations
       for (int iter = 1; iter <= nsteps + 1; iter++)
       {
-        // start of array in C++ at 0 / in FORTRAN at 1
-        // last: index of prev estimated point
-        // i: index of current point
-        size_t i(0), last(-1), nleft(0), nright(ns -1);
-
-        // Fit all data points y[i] until the end of the array
-        do
+        // Calculate weights and apply fit (original lowest function) at
+        // all fit points
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static)
+#endif
+        for (OpenMS::SignedSize k = 0; k < nr_fits; ++k)
         {
-          // Identify the neighborhood around the current x[i]
-          // -> get the nearest ns points
-          update_neighborhood(x, n, i, nleft, nright);
-
-          // Calculate weights and apply fit (original lowest function)
-          fit_ok = lowest(x, y, n, x[i], ys[i], nleft, nright,
-                          weights, (iter > 1), resid_weights);
+          int thread = 0;
+#ifdef _OPENMP
+          thread = omp_get_thread_num();
+#endif
+          const size_t i = fit_index[k];
+          bool fit_ok = lowest(x, y, n, x[i], fit_values[k], fit_nleft[k], fit_nright[k],
+                               thread_weights[thread], (iter > 1), resid_weights);
 
           // if something went wrong during the fit, use y[i] as the
           // fitted value at x[i]
-          if (!fit_ok) ys[i] = y[i];
+          if (!fit_ok) fit_values[k] = y[i];
+        }
+
+        // start of array in C++ at 0 / in FORTRAN at 1
+        // last: index of prev estimated point
+        // i: index of current point
+        size_t i(0), last(-1);
+        for (OpenMS::SignedSize k = 0; k < nr_fits; ++k)
+        {
+          i = fit_index[k];
+          ys[i] = fit_values[k];
 
           // If we skipped some points (because of how delta was set), go back
           // and fit them by linear interpolation.
@@ -558,8 +632,7 @@ public:
           // Update the last fit counter to indicate we've now fit this point.
           // Find the next i for which we'll run a regression.
           update_indices(x, n, delta, i, last, ys);
-
-        } while (last < n - 1);
+        }
 
         // compute current residuals
         for (i = 0; i < n; i++)
@@ -587,6 +660,15 @@ namespace OpenMS
     int lowess(const std::vector<double>& x, const std::vector<double>& y,
                double f, int nsteps,
                double delta, std::vector<double>& result)
+    {
+      LowessWorkspace workspace;
+      return lowess(x, y, f, nsteps, delta, result, workspace);
+    }
+
+    int lowess(const std::vector<double>& x, const std::vector<double>& y,
+               double f, int nsteps,
+               double delta, std::vector<double>& result,
+               LowessWorkspace& workspace)
     {
       OPENMS_PRECONDITION(delta >= 0.0, "lowess: parameter delta must be zero or larger")
       OPENMS_PRECONDITION(f > 0.0, "lowess: parameter f must be larger than 0")
@@ -600,17 +682,19 @@ namespace OpenMS
       size_t n = x.size();
 
       // result as well as working vectors need to have the correct size
+      // (the working vectors keep their capacity between calls)
       result.clear();
       result.resize(n);
-      std::vector<double> resid_weights(n);
-      std::vector<double> weights(n);
+      workspace.resid_weights.resize(n);
+      workspace.residuals.resize(n);
 
       c_lowess::TemplatedLowess<std::vector<double>, double> clowess;
 
-      int retval = clowess.lowess(x, y, f, nsteps, delta, result,
-                                  resid_weights, weights);
-
-      return retval;
+      return clowess.lowess(x, y, f, nsteps, delta, result,
+                            workspace.resid_weights, workspace.residuals,
+                            workspace.thread_weights,
+                            workspace.fit_index, workspace.fit_nleft, workspace.fit_nright,
+                            workspace.fit_values);
     }
 
   }
@@ -34,6 +34,8 @@
 
 #include <OpenMS/FILTERING/SMOOTHING/GaussFilter.h>
 
+#include <exception>
+
 namespace OpenMS
 {
 
@@ -54,6 +56,61 @@ namespace OpenMS
   {
   }
 
+  void GaussFilter::filterExperiment(PeakMap & map)
+  {
+    startProgress(0, map.size() + map.getChromatograms().size(), "smoothing data");
+
+    const SignedSize nr_spectra = map.size();
+    const SignedSize nr_items = nr_spectra + map.getChromatograms().size();
+
+    // parallel exception catching and re-throwing business
+    Size err_count = 0;
+    std::exception_ptr error;
+#ifdef _OPENMP
+#pragma omp parallel
+#endif
+    {
+      // the filter algorithm is re-initialized for each data point with 'use_ppm_tolerance', use a copy per thread
+      GaussFilter thread_filter(*this);
+
+#ifdef _OPENMP
+#pragma omp for schedule(dynamic)
+#endif
+      for (SignedSize i = 0; i < nr_items; ++i)
+      {
+        if (err_count) continue; // no need to continue if already an error was encountered
+        try
+        {
+          if (i < nr_spectra)
+          {
+            thread_filter.filter(map[i]);
+          }
+          else
+          {
+            thread_filter.filter(map.getChromatogram(i - nr_spectra));
+          }
+        }
+        catch (...)
+        {
+#ifdef _OPENMP
+#pragma omp critical (GaussFilter_error)
+#endif
+          {
+            if (!err_count) error = std::current_exception();
+            ++err_count;
+          }
+        }
+        nextProgress();
+      }
+    }
+    endProgress();
+
+    if (err_count != 0)
+    {
+      std::rethrow_exception(error);
+    }
+  }
+
   void GaussFilter::updateMembers_()
   {
     gauss_algo_.initialize((double)param_.getValue("gaussian_width"), spacing_,
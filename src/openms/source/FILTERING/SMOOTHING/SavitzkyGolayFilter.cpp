@@ -38,6 +38,12 @@
 #include <Eigen/Core>
 #include <Eigen/SVD>
 
+#include <map>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
 namespace OpenMS
 {
   SavitzkyGolayFilter::SavitzkyGolayFilter() :
@@ -104,5 +110,185 @@ namespace OpenMS
         }
       }
     }
+
+    // arrange the coefficients in the order of the data points they are applied to
+    UInt mid = frame_size_ / 2;
+    kernel_.resize(frame_size_ * (frame_size_ + 1));
+    for (UInt j = 0; j < frame_size_; ++j)
+    {
+      // transient on
+      for (UInt i = 0; i <= mid; ++i)
+      {
+        kernel_[i * frame_size_ + j] = coeffs_[(i + 1) * frame_size_ - 1 - j];
+      }
+      // steady state
+      kernel_[(mid + 1) * frame_size_ + j] = coeffs_[mid * frame_size_ + j];
+      // transient off
+      for (UInt t = 0; t < mid; ++t)
+      {
+        kernel_[(mid + 2 + t) * frame_size_ + j] = coeffs_[(mid - 1 - t) * frame_size_ + j];
+      }
+    }
+  }
+
+  void SavitzkyGolayFilter::smooth_(const double * input, double * output, Size nr_points, Size nr_traces) const
+  {
+    const Size mid = frame_size_ / 2;
+    for (Size k = 0; k < nr_points; ++k)
+    {
+      // select the coefficients and the first data point of the frame
+      Size row, start;
+      if (k <= mid)
+      {
+        row = k;
+        start = 0;
+      }
+      else if (k < nr_points - mid)
+      {
+        row = mid + 1;
+        start = k - mid;
+      }
+      else
+      {
+        row = mid + 2 + (k - (nr_points - mid));
+        start = nr_points - frame_size_;
+      }
+
+      const double * coeffs = &kernel_[row * frame_size_];
+      const double * in = input + start * nr_traces;
+      double * out = output + k * nr_traces;
+      for (Size t = 0; t < nr_traces; ++t)
+      {
+        out[t] = 0.0;
+      }
+      // the inner loop runs over the traces with the same coefficient (vectorizable)
+      for (Size j = 0; j < frame_size_; ++j)
+      {
+        const double c = coeffs[j];
+        const double * in_j = in + j * nr_traces;
+        for (Size t = 0; t < nr_traces; ++t)
+        {
+          out[t] += in_j[t] * c;
+        }
+      }
+      for (Size t = 0; t < nr_traces; ++t)
+      {
+        out[t] = std::max(0.0, out[t]);
+      }
+    }
+  }
+
+  void SavitzkyGolayFilter::filter(MSSpectrum & spectrum) const
+  {
+    const Size n = spectrum.size();
+    if (frame_size_ > n) { return; }
+
+    std::vector<double> input(n), output(n);
+    for (Size p = 0; p < n; ++p)
+    {
+      input[p] = spectrum[p].getIntensity();
+    }
+    smooth_(&input[0], &output[0], n, 1);
+    for (Size p = 0; p < n; ++p)
+    {
+      spectrum[p].setIntensity(output[p]);
+    }
+  }
+
+  void SavitzkyGolayFilter::filter(MSChromatogram & chromatogram) const
+  {
+    const Size n = chromatogram.size();
+    if (frame_size_ > n) { return; }
+
+    std::vector<double> input(n), output(n);
+    for (Size p = 0; p < n; ++p)
+    {
+      input[p] = chromatogram[p].getIntensity();
+    }
+    smooth_(&input[0], &output[0], n, 1);
+    for (Size p = 0; p < n; ++p)
+    {
+      chromatogram[p].setIntensity(output[p]);
+    }
+  }
+
+  void SavitzkyGolayFilter::filterBatch(std::vector<double> & intensities, Size nr_traces) const
+  {
+    if (nr_traces == 0 || intensities.size() % nr_traces != 0)
+    {
+      throw Exception::IllegalArgument(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION,
+        "The number of intensities (" + String(intensities.size()) + ") is not a multiple of the number of traces (" + String(nr_traces) + ").");
+    }
+    const Size nr_points = intensities.size() / nr_traces;
+    if (frame_size_ > nr_points) { return; }
+
+    std::vector<double> output(intensities.size());
+    smooth_(&intensities[0], &output[0], nr_points, nr_traces);
+    intensities.swap(output);
+  }
+
+  void SavitzkyGolayFilter::filterExperiment(PeakMap & map) const
+  {
+    startProgress(0, map.size() + map.getChromatograms().size(), "smoothing data");
+
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic)
+#endif
+    for (SignedSize i = 0; i < (SignedSize)map.size(); ++i)
+    {
+      filter(map[i]);
+      nextProgress();
+    }
+
+    // group the chromatograms by their number of data points and smooth them in blocks
+    const Size max_block_size = 64;
+    std::map<Size, std::vector<Size> > chroms_by_size;
+    for (Size i = 0; i < map.getChromatograms().size(); ++i)
+    {
+      chroms_by_size[map.getChromatogram(i).size()].push_back(i);
+    }
+    std::vector<std::vector<Size> > blocks;
+    for (std::map<Size, std::vector<Size> >::const_iterator it = chroms_by_size.begin(); it != chroms_by_size.end(); ++it)
+    {
+      for (Size start = 0; start < it->second.size(); start += max_block_size)
+      {
+        Size end = std::min(start + max_block_size, it->second.size());
+        blocks.push_back(std::vector<Size>(it->second.begin() + start, it->second.begin() + end));
+      }
+    }
+
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic)
+#endif
+    for (SignedSize b = 0; b < (SignedSize)blocks.size(); ++b)
+    {
+      const std::vector<Size>& block = blocks[b];
+      const Size nr_traces = block.size();
+      const Size nr_points = map.getChromatogram(block[0]).size();
+
+      std::vector<double> intensities(nr_points * nr_traces);
+      for (Size t = 0; t < nr_traces; ++t)
+      {
+        const MSChromatogram& chrom = map.getChromatogram(block[t]);
+        for (Size k = 0; k < nr_points; ++k)
+        {
+          intensities[k * nr_traces + t] = chrom[k].getIntensity();
+        }
+      }
+      filterBatch(intensities, nr_traces);
+      for (Size t = 0; t < nr_traces; ++t)
+      {
+        MSChromatogram& chrom = map.getChromatogram(block[t]);
+        for (Size k = 0; k < nr_points; ++k)
+        {
+          chrom[k].setIntensity(intensities[k * nr_traces + t]);
+        }
+      }
+      for (Size t = 0; t < nr_traces; ++t)
+      {
+        nextProgress();
+      }
+    }
+    endProgress();
   }
 }
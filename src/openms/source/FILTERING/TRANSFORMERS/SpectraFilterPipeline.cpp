@@ -0,0 +1,184 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2018.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: Timo Sachsenberg $
+// $Authors: Timo Sachsenberg $
+// --------------------------------------------------------------------------
+//
+#include <OpenMS/FILTERING/TRANSFORMERS/SpectraFilterPipeline.h>
+
+#include <OpenMS/CONCEPT/Exception.h>
+#include <OpenMS/DATASTRUCTURES/ListUtils.h>
+#include <OpenMS/FILTERING/TRANSFORMERS/BernNorm.h>
+#include <OpenMS/FILTERING/TRANSFORMERS/NLargest.h>
+#include <OpenMS/FILTERING/TRANSFORMERS/Normalizer.h>
+#include <OpenMS/FILTERING/TRANSFORMERS/ParentPeakMower.h>
+#include <OpenMS/FILTERING/TRANSFORMERS/Scaler.h>
+#include <OpenMS/FILTERING/TRANSFORMERS/SqrtMower.h>
+#include <OpenMS/FILTERING/TRANSFORMERS/ThresholdMower.h>
+#include <OpenMS/FILTERING/TRANSFORMERS/WindowMower.h>
+
+#include <memory>
+
+using namespace std;
+
+namespace OpenMS
+{
+  namespace
+  {
+    // wraps a configured filter object; the object is owned by the returned function
+    template <typename FilterType>
+    std::function<void (PeakSpectrum&)> makeStep(const Param& param)
+    {
+      std::shared_ptr<FilterType> filter(new FilterType());
+      // missing values are set to the defaults (filters without parameters would warn otherwise)
+      if (!param.empty() || !filter->getDefaults().empty())
+      {
+        filter->setParameters(param);
+      }
+      return [filter](PeakSpectrum& spectrum) { filter->filterPeakSpectrum(spectrum); };
+    }
+  }
+
+  SpectraFilterPipeline::SpectraFilterPipeline()
+  {
+  }
+
+  SpectraFilterPipeline::~SpectraFilterPipeline()
+  {
+  }
+
+  void SpectraFilterPipeline::addFilter(const String& name, const Param& param)
+  {
+    // creating the filter validates the name and the parameters
+    createStep_(name, param);
+    filters_.push_back(make_pair(name, param));
+  }
+
+  void SpectraFilterPipeline::clear()
+  {
+    filters_.clear();
+  }
+
+  Size SpectraFilterPipeline::size() const
+  {
+    return filters_.size();
+  }
+
+  StringList SpectraFilterPipeline::getFilters() const
+  {
+    StringList names;
+    for (Size i = 0; i < filters_.size(); ++i)
+    {
+      names.push_back(filters_[i].first);
+    }
+    return names;
+  }
+
+  StringList SpectraFilterPipeline::getFilterNames()
+  {
+    return ListUtils::create<String>("BernNorm,NLargest,Normalizer,ParentPeakMower,Scaler,SqrtMower,ThresholdMower,WindowMower");
+  }
+
+  Param SpectraFilterPipeline::getFilterDefaults(const String& name)
+  {
+    if (name == "BernNorm") return BernNorm().getDefaults();
+    if (name == "NLargest") return NLargest().getDefaults();
+    if (name == "Normalizer") return Normalizer().getDefaults();
+    if (name == "ParentPeakMower") return ParentPeakMower().getDefaults();
+    if (name == "Scaler") return Scaler().getDefaults();
+    if (name == "SqrtMower") return SqrtMower().getDefaults();
+    if (name == "ThresholdMower") return ThresholdMower().getDefaults();
+    if (name == "WindowMower") return WindowMower().getDefaults();
+    throw Exception::InvalidValue(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "Unknown spectrum filter. Valid filters are: " + ListUtils::concatenate(getFilterNames(), ", "), name);
+  }
+
+  SpectraFilterPipeline::Step_ SpectraFilterPipeline::createStep_(const String& name, const Param& param)
+  {
+    if (name == "BernNorm") return makeStep<BernNorm>(param);
+    if (name == "NLargest") return makeStep<NLargest>(param);
+    if (name == "Normalizer") return makeStep<Normalizer>(param);
+    if (name == "ParentPeakMower") return makeStep<ParentPeakMower>(param);
+    if (name == "Scaler") return makeStep<Scaler>(param);
+    if (name == "SqrtMower") return makeStep<SqrtMower>(param);
+    if (name == "ThresholdMower") return makeStep<ThresholdMower>(param);
+    if (name == "WindowMower") return makeStep<WindowMower>(param);
+    throw Exception::InvalidValue(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "Unknown spectrum filter. Valid filters are: " + ListUtils::concatenate(getFilterNames(), ", "), name);
+  }
+
+  std::vector<SpectraFilterPipeline::Step_> SpectraFilterPipeline::createSteps_() const
+  {
+    std::vector<Step_> steps;
+    steps.reserve(filters_.size());
+    for (Size i = 0; i < filters_.size(); ++i)
+    {
+      steps.push_back(createStep_(filters_[i].first, filters_[i].second));
+    }
+    return steps;
+  }
+
+  void SpectraFilterPipeline::filterPeakSpectrum(PeakSpectrum& spectrum) const
+  {
+    std::vector<Step_> steps = createSteps_();
+    for (Size j = 0; j < steps.size(); ++j)
+    {
+      steps[j](spectrum);
+    }
+  }
+
+  void SpectraFilterPipeline::filterPeakMap(PeakMap& exp) const
+  {
+    if (filters_.empty()) return;
+
+#ifdef _OPENMP
+#pragma omp parallel
+#endif
+    {
+      // some filters cache their parameters in members while filtering, thus each thread needs its own objects
+      std::vector<Step_> steps;
+#ifdef _OPENMP
+#pragma omp critical (SpectraFilterPipeline_createSteps)
+#endif
+      steps = createSteps_();
+
+#ifdef _OPENMP
+#pragma omp for schedule(dynamic, 64)
+#endif
+      for (SignedSize i = 0; i < (SignedSize)exp.size(); ++i)
+      {
+        for (Size j = 0; j < steps.size(); ++j)
+        {
+          steps[j](exp[i]);
+        }
+      }
+    }
+  }
+
+}
@@ -35,6 +35,10 @@
 
 #include <OpenMS/FILTERING/TRANSFORMERS/SpectraMerger.h>
 
+#include <OpenMS/KERNEL/MSExperiment.h>
+
+#include <queue>
+
 using namespace std;
 namespace OpenMS
 {
@@ -112,4 +116,187 @@ namespace OpenMS
     return *this;
   }
 
+  void SpectraMerger::mergeSpectraBlockWiseBinned(PeakMap& exp)
+  {
+    IntList ms_levels = param_.getValue("block_method:ms_levels");
+    Int rt_block_size(param_.getValue("block_method:rt_block_size"));
+    double rt_max_length = (param_.getValue("block_method:rt_max_length"));
+    double mz_binning_width(param_.getValue("mz_binning_width"));
+    bool ppm = param_.getValue("mz_binning_width_unit") == "ppm";
+
+    if (rt_max_length == 0) // no rt restriction set?
+    {
+      rt_max_length = (std::numeric_limits<double>::max)(); // set max rt span to very large value
+    }
+
+    // determine the blocks (same as in mergeSpectraBlockWise), each block
+    // stores the indices of its spectra, starting with the master spectrum
+    std::vector<std::pair<UInt, std::vector<Size> > > blocks;
+    std::vector<bool> is_merged(exp.size(), false);
+    for (IntList::const_iterator it_mslevel = ms_levels.begin(); it_mslevel != ms_levels.end(); ++it_mslevel)
+    {
+      Size idx_block(0);
+      for (Size i = 0; i < exp.size(); ++i)
+      {
+        if (Int(exp[i].getMSLevel()) != *it_mslevel)
+        {
+          continue;
+        }
+        if (!is_merged[i] && !exp[i].isSorted())
+        {
+          exp[i].sortByPosition();
+        }
+        is_merged[i] = true;
+
+        if (blocks.empty() || blocks.back().first != UInt(*it_mslevel) ||
+            Int(blocks.back().second.size()) >= rt_block_size ||
+            exp[i].getRT() - exp[idx_block].getRT() > rt_max_length)
+        {
+          idx_block = i;
+          blocks.push_back(std::make_pair(UInt(*it_mslevel), std::vector<Size>()));
+        }
+        blocks.back().second.push_back(i);
+      }
+    }
+
+    std::vector<MSSpectrum> merged_spectra(blocks.size());
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic)
+#endif
+    for (SignedSize b = 0; b < (SignedSize)blocks.size(); ++b)
+    {
+      std::vector<const MSSpectrum*> block;
+      block.reserve(blocks[b].second.size());
+      for (Size i = 0; i < blocks[b].second.size(); ++i)
+      {
+        block.push_back(&exp[blocks[b].second[i]]);
+      }
+      mergeBlockBinned(block, blocks[b].first, mz_binning_width, ppm, merged_spectra[b]);
+    }
+
+    LOG_INFO << "Merged " << std::count(is_merged.begin(), is_merged.end(), true) << " spectra into " << blocks.size() << " blocks.\n";
+
+    // keep all spectra which were not merged and add the merged ones
+    std::vector<MSSpectrum> result;
+    result.reserve(exp.size() - std::count(is_merged.begin(), is_merged.end(), true) + merged_spectra.size());
+    for (Size i = 0; i < exp.size(); ++i)
+    {
+      if (!is_merged[i])
+      {
+        result.push_back(std::move(exp[i]));
+      }
+    }
+    for (Size b = 0; b < merged_spectra.size(); ++b)
+    {
+      if (!merged_spectra[b].empty())
+      {
+        result.push_back(std::move(merged_spectra[b]));
+      }
+    }
+    exp.setSpectra(std::move(result));
+    exp.sortSpectra();
+  }
+
+  void SpectraMerger::mergeBlockBinned(const std::vector<const MSSpectrum*>& block, UInt ms_level,
+                                       double mz_binning_width, bool ppm, MSSpectrum& merged)
+  {
+    if (block.empty())
+    {
+      throw Exception::IllegalArgument(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "Cannot merge an empty block of spectra.");
+    }
+
+    // meta data: first spectrum, with the meta data of all others appended
+    const MSSpectrum& master = *block[0];
+    merged.clear(true);
+    merged.SpectrumSettings::operator=(master);
+    merged.setName(master.getName());
+    merged.setDriftTime(master.getDriftTime());
+    merged.setMSLevel(ms_level);
+
+    double rt_average(0.0);
+    double precursor_mz_average(0.0);
+    Size precursor_count(0);
+    Size peak_count(0);
+    for (Size i = 0; i < block.size(); ++i)
+    {
+      if (i > 0)
+      {
+        merged.unify(*block[i]);
+      }
+      rt_average += block[i]->getRT();
+      if (ms_level >= 2 && !block[i]->getPrecursors().empty())
+      {
+        precursor_mz_average += block[i]->getPrecursors()[0].getMZ();
+        ++precursor_count;
+      }
+      peak_count += block[i]->size();
+    }
+    merged.setRT(rt_average / block.size());
+    if (ms_level >= 2)
+    {
+      if (precursor_count)
+      {
+        precursor_mz_average /= precursor_count;
+      }
+      std::vector<Precursor> pcs = merged.getPrecursors();
+      pcs.resize(1);
+      pcs[0].setMZ(precursor_mz_average);
+      merged.setPrecursors(pcs);
+    }
+
+    // k-way merge of the peak lists: (m/z, spectrum index, peak index), smallest m/z on top
+    typedef std::pair<double, std::pair<Size, Size> > HeapEntry;
+    std::priority_queue<HeapEntry, std::vector<HeapEntry>, std::greater<HeapEntry> > heap;
+    for (Size i = 0; i < block.size(); ++i)
+    {
+      if (!block[i]->empty())
+      {
+        heap.push(std::make_pair((*block[i])[0].getMZ(), std::make_pair(i, Size(0))));
+      }
+    }
+
+    merged.reserve(peak_count);
+    double bin_start(0.0), bin_tolerance(0.0);
+    double sum_intensity(0.0), sum_weighted_mz(0.0), sum_mz(0.0);
+    Size bin_size(0);
+    while (!heap.empty())
+    {
+      const double mz = heap.top().first;
+      const Size spec_idx = heap.top().second.first;
+      const Size peak_idx = heap.top().second.second;
+      heap.pop();
+      if (peak_idx + 1 < block[spec_idx]->size())
+      {
+        heap.push(std::make_pair((*block[spec_idx])[peak_idx + 1].getMZ(), std::make_pair(spec_idx, peak_idx + 1)));
+      }
+
+      if (bin_size > 0 && mz - bin_start > bin_tolerance)
+      {
+        Peak1D p;
+        p.setMZ(sum_intensity > 0 ? sum_weighted_mz / sum_intensity : sum_mz / bin_size);
+        p.setIntensity(sum_intensity);
+        merged.push_back(p);
+        bin_size = 0;
+      }
+      if (bin_size == 0)
+      {
+        bin_start = mz;
+        bin_tolerance = ppm ? mz * mz_binning_width * 1e-6 : mz_binning_width;
+        sum_intensity = sum_weighted_mz = sum_mz = 0.0;
+      }
+      const double intensity = (*block[spec_idx])[peak_idx].getIntensity();
+      sum_intensity += intensity;
+      sum_weighted_mz += mz * intensity;
+      sum_mz += mz;
+      ++bin_size;
+    }
+    if (bin_size > 0)
+    {
+      Peak1D p;
+      p.setMZ(sum_intensity > 0 ? sum_weighted_mz / sum_intensity : sum_mz / bin_size);
+      p.setIntensity(sum_intensity);
+      merged.push_back(p);
+    }
+  }
+
 }
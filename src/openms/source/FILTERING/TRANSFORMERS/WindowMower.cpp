@@ -81,6 +81,15 @@ namespace OpenMS
     }
   }
 
+  void WindowMower::selectMostIntense_(std::vector<std::pair<double, Size> >& window, Size n)
+  {
+    if (window.size() > n)
+    {
+      std::nth_element(window.begin(), window.begin() + n, window.end());
+      window.resize(n);
+    }
+  }
+
   void WindowMower::filterPeakMap(PeakMap & exp)
   {
     bool sliding = (String)param_.getValue("movetype") == "slide" ? true : false;
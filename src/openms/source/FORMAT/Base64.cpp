@@ -124,6 +124,125 @@ print s
   const char Base64::encoder_[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
   const char Base64::decoder_[] = "|$$$}rstuvwxyz{$$$$$$$>?@ABCDEFGHIJKLMNOPQRSTUVW$$$$$$XYZ[\\]^_`abcdefghijklmnopq";
 
+  namespace
+  {
+    /// Marks characters outside of the Base64 alphabet in the decoding table
+    const Byte INVALID_BASE64 = 0x80;
+
+    /**
+      Full 256 entry decoding table (char -> 6 bit value) which needs no range
+      checks. Characters that are not part of the alphabet are set to
+      INVALID_BASE64 which allows to check a whole block of characters at once.
+    */
+    struct Base64DecodingTable
+    {
+      Byte table[256];
+
+      explicit Base64DecodingTable(const char* encoder)
+      {
+        std::fill(table, table + 256, INVALID_BASE64);
+        for (Byte i = 0; i < 64; ++i)
+        {
+          table[(unsigned char)encoder[i]] = i;
+        }
+      }
+    };
+  }
+
+  Size Base64::decodeBytes_(const char* src, Size src_size, Byte* dest)
+  {
+    static const Base64DecodingTable decoding(encoder_);
+    const Byte* table = decoding.table;
+
+    // last one or two '=' are skipped if contained
+    if (src_size > 0 && src[src_size - 1] == '=') --src_size;
+    if (src_size > 0 && src[src_size - 1] == '=') --src_size;
+
+    const unsigned char* in = reinterpret_cast<const unsigned char*>(src);
+    Byte* to = dest;
+    Byte invalid = 0;
+
+    // decode 4 Base64-Chars to 3 Byte at a time (no branches in the loop,
+    // invalid characters are only detected once all blocks are decoded)
+    Size i = 0;
+    for (; i + 4 <= src_size; i += 4)
+    {
+      const Byte a = table[in[i]];
+      const Byte b = table[in[i + 1]];
+      const Byte c = table[in[i + 2]];
+      const Byte d = table[in[i + 3]];
+      invalid |= a | b | c | d;
+
+      const UInt32 int_24bit = ((UInt32)a << 18) | ((UInt32)b << 12) | ((UInt32)c << 6) | (UInt32)d;
+      to[0] = (Byte)(int_24bit >> 16);
+      to[1] = (Byte)(int_24bit >> 8);
+      to[2] = (Byte)int_24bit;
+      to += 3;
+    }
+
+    // the last block may contain two or three characters (padding was removed)
+    const Size rest = src_size - i;
+    if (rest >= 2)
+    {
+      const Byte a = table[in[i]];
+      const Byte b = table[in[i + 1]];
+      const Byte c = rest == 3 ? table[in[i + 2]] : 0;
+      invalid |= a | b | c;
+
+      *to++ = (Byte)((a << 2) | (b >> 4));
+      if (rest == 3)
+      {
+        *to++ = (Byte)(((b & 15) << 4) | (c >> 2));
+      }
+    }
+
+    if (invalid & INVALID_BASE64)
+    {
+      // slow path: skip all characters which are not part of the alphabet and decode again
+      std::string filtered;
+      filtered.reserve(src_size);
+      for (Size k = 0; k < src_size; ++k)
+      {
+        if (!(table[in[k]] & INVALID_BASE64)) filtered.push_back(src[k]);
+      }
+      return decodeBytes_(filtered.c_str(), filtered.size(), dest);
+    }
+
+    return to - dest;
+  }
+
+  void Base64::encodeBytes_(const Byte* src, Size src_size, String& out)
+  {
+    out.resize((src_size + 2) / 3 * 4); // enough space for all characters
+    if (src_size == 0) return;
+
+    Byte* to = reinterpret_cast<Byte*>(&out[0]);
+    const Byte* it = src;
+    const Byte* end = src + src_size;
+
+    // encode 3 Byte to 4 Base64-Chars at a time
+    for (; end - it >= 3; it += 3)
+    {
+      const UInt32 int_24bit = ((UInt32)it[0] << 16) | ((UInt32)it[1] << 8) | (UInt32)it[2];
+      to[0] = encoder_[(int_24bit >> 18) & 0x3F];
+      to[1] = encoder_[(int_24bit >> 12) & 0x3F];
+      to[2] = encoder_[(int_24bit >> 6) & 0x3F];
+      to[3] = encoder_[int_24bit & 0x3F];
+      to += 4;
+    }
+
+    // one or two remaining bytes need padding
+    if (it != end)
+    {
+      const bool two_bytes = (end - it) == 2;
+      const UInt32 int_24bit = ((UInt32)it[0] << 16) | (two_bytes ? ((UInt32)it[1] << 8) : 0);
+      to[0] = encoder_[(int_24bit >> 18) & 0x3F];
+      to[1] = encoder_[(int_24bit >> 12) & 0x3F];
+      to[2] = two_bytes ? encoder_[(int_24bit >> 6) & 0x3F] : '=';
+      to[3] = '=';
+    }
+  }
+
   void Base64::encodeStrings(const std::vector<String>& in, String& out, bool zlib_compression, bool append_null_byte)
   {
     out.clear();
@@ -132,8 +251,6 @@ print s
 
     std::string str;
     std::string compressed;
-    Byte* it;
-    Byte* end;
     for (Size i = 0; i < in.size(); ++i)
     {
       str = str.append(in[i]);
@@ -167,57 +284,12 @@ print s
         throw Exception::ConversionError(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "Compression error?");
       }
 
-      it = reinterpret_cast<Byte*>(&compressed[0]);
-      end = it + compressed_length;
-      // TODO check integer overflow
-      out.resize((Size)ceil(compressed_length / 3.) * 4); //resize output array in order to have enough space for all characters
+      encodeBytes_(reinterpret_cast<Byte*>(&compressed[0]), compressed_length, out);
     }
     else
     {
-      // TODO check integer overflow
-      out.resize((Size)ceil(str.size() / 3.) * 4); //resize output array in order to have enough space for all characters
-      it = reinterpret_cast<Byte*>(&str[0]);
-      end = it + str.size();
+      encodeBytes_(reinterpret_cast<Byte*>(&str[0]), str.size(), out);
     }
-    Byte* to = reinterpret_cast<Byte*>(&out[0]);
-    Size written = 0;
-
-    while (it != end)
-    {
-      Int int_24bit = 0;
-      Int padding_count = 0;
-
-      // construct 24-bit integer from 3 bytes
-      for (Size i = 0; i < 3; i++)
-      {
-        if (it != end)
-        {
-          int_24bit |= *it++ << ((2 - i) * 8);
-        }
-        else
-        {
-          padding_count++;
-        }
-      }
-
-      // write out 4 characters
-      for (Int i = 3; i >= 0; i--)
-      {
-        to[i] = encoder_[int_24bit & 0x3F];
-        int_24bit >>= 6;
-      }
-
-      // fixup for padding
-      if (padding_count > 0)
-        to[3] = '=';
-      if (padding_count > 1)
-        to[2] = '=';
-
-      to += 4;
-      written += 4;
-    }
-
-    out.resize(written); //no more space is needed
   }
 
   void Base64::decodeStrings(const String& in, std::vector<String>& out, bool zlib_compression)
@@ -44,6 +44,13 @@
 
 #include <OpenMS/FORMAT/HANDLERS/CachedMzMLHandler.h>
 
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+
+#ifndef OPENMS_WINDOWSPLATFORM
+#include <sys/mman.h>
+#endif
+
 namespace OpenMS
 {
 
@@ -63,11 +70,18 @@ namespace OpenMS
 
   CachedmzML::CachedmzML(const CachedmzML & rhs) :
     meta_ms_experiment_(rhs.meta_ms_experiment_),
-    ifs_(rhs.filename_cached_.c_str(), std::ios::binary),
+    ifs_(),
+    mapped_region_(rhs.mapped_region_),
     filename_(rhs.filename_),
+    filename_cached_(rhs.filename_cached_),
     spectra_index_(rhs.spectra_index_),
     chrom_index_(rhs.chrom_index_)
   {
+    // the memory mapping is shared, only open a new file stream if there is none
+    if (!mapped_region_)
+    {
+      ifs_.open(rhs.filename_cached_.c_str(), std::ios::binary);
+    }
   }
 
   void CachedmzML::load_(const String& filename)
@@ -81,8 +95,25 @@ namespace OpenMS
     spectra_index_ = cache.getSpectraIndex();
     chrom_index_ = cache.getChromatogramIndex();;
 
-    // open the filestream
-    ifs_.open(filename_cached_.c_str(), std::ios::binary);
+    // map the file into memory, fall back to a file stream if this fails
+    mapped_region_.reset();
+    if (ifs_.is_open()) ifs_.close();
+    try
+    {
+      boost::interprocess::file_mapping mapping(filename_cached_.c_str(), boost::interprocess::read_only);
+      mapped_region_.reset(new boost::interprocess::mapped_region(mapping, boost::interprocess::read_only));
+      // the file is read in random order, no read-ahead needed
+      mapped_region_->advise(boost::interprocess::mapped_region::advice_random);
+    }
+    catch (boost::interprocess::interprocess_exception& /* e */)
+    {
+      mapped_region_.reset();
+    }
+
+    if (!mapped_region_)
+    {
+      ifs_.open(filename_cached_.c_str(), std::ios::binary);
+    }
 
     // load the meta data from disk
     MzMLFile().load(filename, meta_ms_experiment_);
@@ -93,6 +124,15 @@ namespace OpenMS
     OPENMS_PRECONDITION(id >= 0, "Id needs to be larger than zero");
     // OPENMS_PRECONDITION(id < (int)getNrSpectra(), "Id cannot be larger than number of spectra");
 
+    if (mapped_region_)
+    {
+      Size available;
+      const char* data = getMappedData_(spectra_index_[id], available);
+      MSSpectrum s = meta_ms_experiment_.getSpectrum(id);
+      Internal::CachedMzMLHandler::readSpectrum(s, data, available);
+      return s;
+    }
+
     if ( !ifs_.seekg(spectra_index_[id]) )
     {
       std::cerr << "Error while reading spectrum " << id << " - seekg created an error when trying to change position to " << spectra_index_[id] << "." << std::endl;
@@ -111,6 +151,15 @@ namespace OpenMS
     OPENMS_PRECONDITION(id >= 0, "Id needs to be larger than zero");
     OPENMS_PRECONDITION(id < (int)getNrChromatograms(), "Id cannot be larger than number of chromatograms");
 
+    if (mapped_region_)
+    {
+      Size available;
+      const char* data = getMappedData_(chrom_index_[id], available);
+      MSChromatogram c = meta_ms_experiment_.getChromatogram(id);
+      Internal::CachedMzMLHandler::readChromatogram(c, data, available);
+      return c;
+    }
+
     if ( !ifs_.seekg(chrom_index_[id]) )
     {
       std::cerr << "Error while reading chromatogram " << id << " - seekg created an error when trying to change position to " << chrom_index_[id] << "." << std::endl;
@@ -134,6 +183,46 @@ namespace OpenMS
     return meta_ms_experiment_.getChromatograms().size();
   }
 
+  bool CachedmzML::isMemoryMapped() const
+  {
+    return mapped_region_ != nullptr;
+  }
+
+  const char* CachedmzML::getMappedData_(std::streampos pos, Size& available) const
+  {
+    OPENMS_PRECONDITION(mapped_region_, "Cached file needs to be memory-mapped");
+
+    const std::streamoff offset = pos;
+    const Size size = mapped_region_->get_size();
+    if (offset < 0 || static_cast<Size>(offset) >= size)
+    {
+      throw Exception::ParseError(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION,
+        "Position " + String(static_cast<Size>(offset)) + " lies outside of the mapped file (size " + String(size) + ").", filename_cached_);
+    }
+    available = size - static_cast<Size>(offset);
+    return static_cast<const char*>(mapped_region_->get_address()) + offset;
+  }
+
+  void CachedmzML::prefetchMappedData_(std::streampos begin, std::streampos end) const
+  {
+    if (!mapped_region_) return;
+#ifdef POSIX_MADV_WILLNEED
+    const Size size = mapped_region_->get_size();
+    Size first = std::min<Size>(static_cast<std::streamoff>(begin), size);
+    Size last = (end == std::streampos(-1) ? size : std::min<Size>(static_cast<std::streamoff>(end), size));
+    if (first >= last) return;
+
+    // madvise requires a page-aligned start address
+    const Size page_size = boost::interprocess::mapped_region::get_page_size();
+    first -= first % page_size;
+    char* address = static_cast<char*>(mapped_region_->get_address()) + first;
+    posix_madvise(address, last - first, POSIX_MADV_WILLNEED);
+#else
+    (void) begin;
+    (void) end;
+#endif
+  }
+
   void CachedmzML::store(const String& filename, const PeakMap& map)
   {
     Internal::CachedMzMLHandler().writeMemdump(map, filename + ".cached");
@@ -35,10 +35,12 @@
 #include <OpenMS/FORMAT/ConsensusXMLFile.h>
 #include <OpenMS/FORMAT/FileHandler.h>
 #include <OpenMS/FORMAT/IdXMLFile.h>
+#include <OpenMS/FORMAT/InMemoryFileStore.h>
 #include <OpenMS/SYSTEM/File.h>
 #include <OpenMS/METADATA/DataProcessing.h>
 #include <OpenMS/CHEMISTRY/ProteaseDB.h>
 #include <fstream>
+#include <sstream>
 
 using namespace std;
 
@@ -638,6 +640,12 @@ namespace OpenMS
       throw Exception::UnableToCreateFile(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, filename, "invalid file extension, expected '" + FileTypes::typeToName(FileTypes::CONSENSUSXML) + "'");
     }
 
+    if (InMemoryFileStore::isMemoryPath(filename))
+    {
+      InMemoryFileStore::store(filename, consensus_map);
+      return;
+    }
+
     if (!consensus_map.isMapConsistent(&LOG_WARN))
     {
       // Currently it is possible that FeatureLinkerUnlabeledQT triggers this exception
@@ -846,46 +854,52 @@ namespace OpenMS
 
     // write all consensus elements
     os << "\t<consensusElementList>\n";
-    for (Size i = 0; i < consensus_map.size(); ++i)
+    // format batches of elements (in parallel) and write them in order
+    const Size batch_size = 10000;
+    std::vector<String> formatted;
+    for (Size batch_start = 0; batch_start < consensus_map.size(); batch_start += batch_size)
     {
-      setProgress(++progress_);
-      // write a consensusElement
-      const ConsensusFeature& elem = consensus_map[i];
-      os << "\t\t<consensusElement id=\"e_" << elem.getUniqueId() << "\" quality=\"" << precisionWrapper(elem.getQuality()) << "\"";
-      if (elem.getCharge() != 0)
+      const Size batch_end = std::min(consensus_map.size(), batch_start + batch_size);
+      formatted.assign(batch_end - batch_start, String());
+
+      Size err_count(0);
+      std::exception_ptr err;
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic, 100)
+#endif
+      for (SignedSize k = 0; k < (SignedSize)formatted.size(); ++k)
       {
-        os << " charge=\"" << elem.getCharge() << "\"";
-      }
-      os << ">\n";
-      // write centroid
-      os << "\t\t\t<centroid rt=\"" << precisionWrapper(elem.getRT()) << "\" mz=\"" << precisionWrapper(elem.getMZ()) << "\" it=\"" << precisionWrapper(
-        elem.getIntensity()) << "\"/>\n";
-      // write groupedElementList
-      os << "\t\t\t<groupedElementList>\n";
-      for (ConsensusFeature::HandleSetType::const_iterator it = elem.begin(); it != elem.end(); ++it)
-      {
-        os << "\t\t\t\t<element"
-              " map=\"" << it->getMapIndex() << "\""
-                                                " id=\"" << it->getUniqueId() << "\""
-                                                                                 " rt=\"" << precisionWrapper(it->getRT()) << "\""
-                                                                                                                              " mz=\"" << precisionWrapper(it->getMZ()) << "\""
-                                                                                                                                                                           " it=\"" << precisionWrapper(it->getIntensity()) << "\"";
-        if (it->getCharge() != 0)
+        try
+        {
+          std::stringstream elem_os;
+          elem_os.precision(os.precision());
+          writeConsensusFeature_(filename, elem_os, consensus_map[batch_start + k]);
+          formatted[k] = elem_os.str();
+        }
+        catch (...)
         {
-          os << " charge=\"" << it->getCharge() << "\"";
+#ifdef _OPENMP
+#pragma omp critical (ConsensusXMLFile_store)
+#endif
+          {
+            if (err_count++ == 0)
+            {
+              err = std::current_exception();
+            }
+          }
         }
-        os << "/>\n";
       }
-      os << "\t\t\t</groupedElementList>\n";
-
-      // write PeptideIdentification
-      for (UInt j = 0; j < elem.getPeptideIdentifications().size(); ++j)
+      if (err_count != 0)
       {
-        writePeptideIdentification_(filename, os, elem.getPeptideIdentifications()[j], "PeptideIdentification", 3);
+        std::rethrow_exception(err);
       }
 
-      writeUserParam_("UserParam", os, elem, 3);
-      os << "\t\t</consensusElement>\n";
+      for (Size k = 0; k < formatted.size(); ++k)
+      {
+        os << formatted[k];
+      }
+      progress_ += (UInt)(batch_end - batch_start);
+      setProgress(progress_);
     }
     os << "\t</consensusElementList>\n";
 
@@ -900,6 +914,12 @@ namespace OpenMS
   void
   ConsensusXMLFile::load(const String& filename, ConsensusMap& map)
   {
+    if (InMemoryFileStore::isMemoryPath(filename))
+    {
+      InMemoryFileStore::load(filename, map);
+      return;
+    }
+
     //Filename for error messages in XMLHandler
     file_ = filename;
 
@@ -938,6 +958,46 @@ namespace OpenMS
     map.updateRanges();
   }
 
+  void
+  ConsensusXMLFile::writeConsensusFeature_(const String& filename, std::ostream& os, const ConsensusFeature& elem)
+  {
+    os << "\t\t<consensusElement id=\"e_" << elem.getUniqueId() << "\" quality=\"" << precisionWrapper(elem.getQuality()) << "\"";
+    if (elem.getCharge() != 0)
+    {
+      os << " charge=\"" << elem.getCharge() << "\"";
+    }
+    os << ">\n";
+    // write centroid
+    os << "\t\t\t<centroid rt=\"" << precisionWrapper(elem.getRT()) << "\" mz=\"" << precisionWrapper(elem.getMZ()) << "\" it=\"" << precisionWrapper(
+      elem.getIntensity()) << "\"/>\n";
+    // write groupedElementList
+    os << "\t\t\t<groupedElementList>\n";
+    for (ConsensusFeature::HandleSetType::const_iterator it = elem.begin(); it != elem.end(); ++it)
+    {
+      os << "\t\t\t\t<element"
+            " map=\"" << it->getMapIndex() << "\""
+                                              " id=\"" << it->getUniqueId() << "\""
+                                                                               " rt=\"" << precisionWrapper(it->getRT()) << "\""
+                                                                                                                            " mz=\"" << precisionWrapper(it->getMZ()) << "\""
+                                                                                                                                                                         " it=\"" << precisionWrapper(it->getIntensity()) << "\"";
+      if (it->getCharge() != 0)
+      {
+        os << " charge=\"" << it->getCharge() << "\"";
+      }
+      os << "/>\n";
+    }
+    os << "\t\t\t</groupedElementList>\n";
+
+    // write PeptideIdentification
+    for (UInt j = 0; j < elem.getPeptideIdentifications().size(); ++j)
+    {
+      writePeptideIdentification_(filename, os, elem.getPeptideIdentifications()[j], "PeptideIdentification", 3);
+    }
+
+    writeUserParam_("UserParam", os, elem, 3);
+    os << "\t\t</consensusElement>\n";
+  }
+
   void
   ConsensusXMLFile::writePeptideIdentification_(const String& filename, std::ostream& os, const PeptideIdentification& id, const String& tag_name,
                                                 UInt indentation_level)
@@ -946,12 +1006,17 @@ namespace OpenMS
 
     if (!identifier_id_.has(id.getIdentifier()))
     {
-      warning(STORE, String("Omitting peptide identification because of missing ProteinIdentification with identifier '") + id.getIdentifier()
-              + "' while writing '" + filename + "'!");
+#ifdef _OPENMP
+#pragma omp critical (ConsensusXMLFile_warning)
+#endif
+      {
+        warning(STORE, String("Omitting peptide identification because of missing ProteinIdentification with identifier '") + id.getIdentifier()
+                + "' while writing '" + filename + "'!");
+      }
       return;
     }
     os << indent << "<" << tag_name << " ";
-    os << "identification_run_ref=\"" << identifier_id_[id.getIdentifier()] << "\" ";
+    os << "identification_run_ref=\"" << identifier_id_.find(id.getIdentifier())->second << "\" ";
     os << "score_type=\"" << writeXMLEscape(id.getScoreType()) << "\" ";
     os << "higher_score_better=\"" << (id.isHigherScoreBetter() ? "true" : "false") << "\" ";
     os << "significance_threshold=\"" << id.getSignificanceThreshold() << "\" ";
@@ -999,7 +1064,8 @@ namespace OpenMS
         if (!protein_accession.empty())
         {
           accs += "PH_";
-          accs += String(accession_to_id_[id.getIdentifier() + "_" + protein_accession]);
+          Map<String, Size>::const_iterator acc_it = accession_to_id_.find(id.getIdentifier() + "_" + protein_accession);
+          accs += String(acc_it != accession_to_id_.end() ? acc_it->second : 0);
         }
       }
 
@@ -88,20 +88,33 @@ namespace OpenMS
   }
 
   bool CsvFile::getRow(Size row, StringList& list)
+  {
+    std::vector<StringView> items;
+    bool splitted = getRow(row, items);
+    // assign into the existing strings of 'list' to re-use their memory
+    list.resize(items.size());
+    for (Size i = 0; i < items.size(); i++)
+    {
+      list[i].assign(items[i].begin(), items[i].end());
+    }
+    return splitted;
+  }
+
+  bool CsvFile::getRow(Size row, std::vector<StringView>& list) const
   {
     // it is assumed that the value to be casted won't be so large to overflow an int
     if (static_cast<int>(row) > static_cast<int>(TextFile::buffer_.size()) - 1)
     {
       throw Exception::InvalidIterator(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION);
     }
-    bool splitted = buffer_[row].split(itemseperator_, list);
+    bool splitted = StringView(buffer_[row]).split(itemseperator_, list);
     if (!splitted)
     {
       return splitted;
     }
-    for (Size i = 0; i < list.size(); i++)
+    if (itemenclosed_)
     {
-      if (itemenclosed_)
+      for (Size i = 0; i < list.size(); i++)
       {
         list[i] = list[i].substr(1, list[i].size() - 2);
       }
@@ -0,0 +1,197 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2018.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: Hannes Roest $
+// $Authors: Hannes Roest $
+// --------------------------------------------------------------------------
+
+#include <OpenMS/FORMAT/DATAACCESS/MSDataAsyncConsumer.h>
+
+#include <OpenMS/CONCEPT/LogStream.h>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+namespace OpenMS
+{
+
+  MSDataAsyncConsumer::MSDataAsyncConsumer(Interfaces::IMSDataConsumer* consumer, Size max_queue_size, int threads) :
+    consumer_(consumer),
+    max_queue_size_(max_queue_size == 0 ? 64 : max_queue_size),
+    threads_(threads < 1 ? 1 : threads),
+    busy_(false),
+    stop_(false),
+    error_(),
+    error_reported_(false)
+  {
+    thread_ = std::thread(&MSDataAsyncConsumer::run_, this);
+  }
+
+  MSDataAsyncConsumer::~MSDataAsyncConsumer()
+  {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      stop_ = true;
+    }
+    work_available_.notify_all();
+    thread_.join();
+    if (error_ && !error_reported_)
+    {
+      try
+      {
+        std::rethrow_exception(error_);
+      }
+      catch (std::exception& e)
+      {
+        LOG_ERROR << "Error while writing the remaining data: " << e.what() << std::endl;
+      }
+      catch (...)
+      {
+        LOG_ERROR << "Error while writing the remaining data." << std::endl;
+      }
+    }
+  }
+
+  void MSDataAsyncConsumer::setExpectedSize(Size expectedSpectra, Size expectedChromatograms)
+  {
+    // the writer thread is idle after flush()
+    flush();
+    consumer_->setExpectedSize(expectedSpectra, expectedChromatograms);
+  }
+
+  void MSDataAsyncConsumer::setExperimentalSettings(const ExperimentalSettings& exp)
+  {
+    flush();
+    consumer_->setExperimentalSettings(exp);
+  }
+
+  void MSDataAsyncConsumer::consumeSpectrum(SpectrumType& s)
+  {
+    Item_ item;
+    item.is_spectrum = true;
+    item.spectrum = s;
+    push_(item);
+  }
+
+  void MSDataAsyncConsumer::consumeChromatogram(ChromatogramType& c)
+  {
+    Item_ item;
+    item.is_spectrum = false;
+    item.chromatogram = c;
+    push_(item);
+  }
+
+  void MSDataAsyncConsumer::flush()
+  {
+    std::unique_lock<std::mutex> lock(mutex_);
+    work_done_.wait(lock, [this] { return queue_.empty() && !busy_; });
+    checkError_();
+  }
+
+  Size MSDataAsyncConsumer::getMaxQueueSize() const
+  {
+    return max_queue_size_;
+  }
+
+  void MSDataAsyncConsumer::push_(Item_& item)
+  {
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      checkError_();
+      space_available_.wait(lock, [this] { return queue_.size() < max_queue_size_ || error_; });
+      checkError_();
+      queue_.push_back(std::move(item));
+    }
+    work_available_.notify_one();
+  }
+
+  void MSDataAsyncConsumer::checkError_()
+  {
+    if (error_)
+    {
+      error_reported_ = true;
+      std::rethrow_exception(error_);
+    }
+  }
+
+  void MSDataAsyncConsumer::run_()
+  {
+#ifdef _OPENMP
+    // the thread budget of the wrapped consumer (OpenMP settings are per thread)
+    omp_set_num_threads(threads_);
+#endif
+    while (true)
+    {
+      Item_ item;
+      bool failed;
+      {
+        std::unique_lock<std::mutex> lock(mutex_);
+        work_available_.wait(lock, [this] { return stop_ || !queue_.empty(); });
+        if (queue_.empty()) break; // stop_ is set and there is nothing left
+        item = std::move(queue_.front());
+        queue_.pop_front();
+        busy_ = true;
+        failed = (bool)error_;
+      }
+      space_available_.notify_one();
+
+      // after an error, the remaining data is discarded
+      if (!failed)
+      {
+        try
+        {
+          if (item.is_spectrum)
+          {
+            consumer_->consumeSpectrum(item.spectrum);
+          }
+          else
+          {
+            consumer_->consumeChromatogram(item.chromatogram);
+          }
+        }
+        catch (...)
+        {
+          std::lock_guard<std::mutex> lock(mutex_);
+          error_ = std::current_exception();
+        }
+      }
+
+      {
+        std::lock_guard<std::mutex> lock(mutex_);
+        busy_ = false;
+      }
+      // wake up producers waiting for space (after an error) and flush()
+      space_available_.notify_all();
+      work_done_.notify_all();
+    }
+  }
+
+} // namespace OpenMS
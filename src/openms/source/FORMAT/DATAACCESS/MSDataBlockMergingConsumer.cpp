@@ -0,0 +1,172 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2018.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: Hannes Roest $
+// $Authors: Hannes Roest $
+// --------------------------------------------------------------------------
+
+#include <OpenMS/FORMAT/DATAACCESS/MSDataBlockMergingConsumer.h>
+
+#include <OpenMS/FILTERING/TRANSFORMERS/SpectraMerger.h>
+
+namespace OpenMS
+{
+
+  MSDataBlockMergingConsumer::MSDataBlockMergingConsumer(Interfaces::IMSDataConsumer* next_consumer, const SpectraMerger& merger) :
+    next_consumer_(next_consumer),
+    pending_offset_(0)
+  {
+    const Param& p = merger.getParameters();
+    ms_levels_ = p.getValue("block_method:ms_levels");
+    rt_block_size_ = (Int)p.getValue("block_method:rt_block_size");
+    rt_max_length_ = p.getValue("block_method:rt_max_length");
+    if (rt_max_length_ == 0) // no rt restriction set?
+    {
+      rt_max_length_ = (std::numeric_limits<double>::max)();
+    }
+    mz_binning_width_ = p.getValue("mz_binning_width");
+    ppm_ = p.getValue("mz_binning_width_unit") == "ppm";
+  }
+
+  MSDataBlockMergingConsumer::~MSDataBlockMergingConsumer()
+  {
+    flush();
+  }
+
+  void MSDataBlockMergingConsumer::setExperimentalSettings(const ExperimentalSettings& exp)
+  {
+    next_consumer_->setExperimentalSettings(exp);
+  }
+
+  void MSDataBlockMergingConsumer::consumeSpectrum(SpectrumType& s)
+  {
+    const UInt ms_level = s.getMSLevel();
+    if (std::find(ms_levels_.begin(), ms_levels_.end(), Int(ms_level)) == ms_levels_.end())
+    {
+      // not merged: pass on directly if nothing is waiting before it
+      if (pending_.empty())
+      {
+        next_consumer_->consumeSpectrum(s);
+      }
+      else
+      {
+        PendingSpectrum_ entry;
+        entry.spectrum = s;
+        entry.ready = true;
+        entry.discard = false;
+        pending_.push_back(entry);
+      }
+      return;
+    }
+
+    // block full if it contains a maximum number of scans or if maximum rt length spanned
+    std::map<UInt, OpenBlock_>::iterator it = open_blocks_.find(ms_level);
+    if (it != open_blocks_.end() &&
+        (it->second.spectra.size() >= rt_block_size_ ||
+         s.getRT() - it->second.spectra[0].getRT() > rt_max_length_))
+    {
+      closeBlock_(ms_level);
+      it = open_blocks_.end();
+    }
+
+    if (it == open_blocks_.end())
+    {
+      // reserve the place of the merged spectrum in the output
+      OpenBlock_ block;
+      block.position = pending_offset_ + pending_.size();
+      it = open_blocks_.insert(std::make_pair(ms_level, block)).first;
+
+      PendingSpectrum_ entry;
+      entry.ready = false;
+      entry.discard = false;
+      pending_.push_back(entry);
+    }
+
+    it->second.spectra.push_back(s);
+    if (!it->second.spectra.back().isSorted())
+    {
+      it->second.spectra.back().sortByPosition();
+    }
+
+    flushReady_();
+  }
+
+  void MSDataBlockMergingConsumer::consumeChromatogram(ChromatogramType& c)
+  {
+    next_consumer_->consumeChromatogram(c);
+  }
+
+  void MSDataBlockMergingConsumer::flush()
+  {
+    while (!open_blocks_.empty())
+    {
+      closeBlock_(open_blocks_.begin()->first);
+    }
+    flushReady_();
+  }
+
+  void MSDataBlockMergingConsumer::closeBlock_(UInt ms_level)
+  {
+    std::map<UInt, OpenBlock_>::iterator it = open_blocks_.find(ms_level);
+    if (it == open_blocks_.end())
+    {
+      return;
+    }
+
+    std::vector<const MSSpectrum*> block;
+    block.reserve(it->second.spectra.size());
+    for (Size i = 0; i < it->second.spectra.size(); ++i)
+    {
+      block.push_back(&it->second.spectra[i]);
+    }
+
+    PendingSpectrum_& entry = pending_[it->second.position - pending_offset_];
+    SpectraMerger::mergeBlockBinned(block, ms_level, mz_binning_width_, ppm_, entry.spectrum);
+    entry.ready = true;
+    entry.discard = entry.spectrum.empty();
+
+    open_blocks_.erase(it);
+  }
+
+  void MSDataBlockMergingConsumer::flushReady_()
+  {
+    while (!pending_.empty() && pending_.front().ready)
+    {
+      if (!pending_.front().discard)
+      {
+        next_consumer_->consumeSpectrum(pending_.front().spectrum);
+      }
+      pending_.pop_front();
+      ++pending_offset_;
+    }
+  }
+
+} // namespace OpenMS
+
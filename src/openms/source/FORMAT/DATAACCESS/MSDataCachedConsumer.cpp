@@ -47,15 +47,23 @@ namespace OpenMS
     spectra_written_(0),
     chromatograms_written_(0)
   {
-    int file_identifier = CACHED_MZML_FILE_IDENTIFIER;
-    ofs_.write((char*)&file_identifier, sizeof(file_identifier));
+    writeHeader_(ofs_);
+  }
+
+  MSDataCachedConsumer::MSDataCachedConsumer(const String& filename, const StorageOptions& options, bool clearData) :
+    ofs_(filename.c_str(), std::ios::binary),
+    clearData_(clearData),
+    spectra_written_(0),
+    chromatograms_written_(0)
+  {
+    setStorageOptions(options);
+    writeHeader_(ofs_);
   }
 
   MSDataCachedConsumer::~MSDataCachedConsumer()
   {
-    // Write size of file (to the end of the file)
-    ofs_.write((char*)&spectra_written_, sizeof(spectra_written_));
-    ofs_.write((char*)&chromatograms_written_, sizeof(chromatograms_written_));
+    // Write the offset table and size of file (to the end of the file)
+    writeFooter_(ofs_, spectra_index_, chrom_index_);
 
     // Close file stream: close() _should_ call flush() but it might not in
     // all cases. To be sure call flush() first.
@@ -70,6 +78,7 @@ namespace OpenMS
       throw Exception::IllegalArgument(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION,
         "Cannot write spectra after writing chromatograms.");
     }
+    spectra_index_.push_back(ofs_.tellp());
     writeSpectrum_(s, ofs_);
     spectra_written_++;
 
@@ -87,6 +96,7 @@ namespace OpenMS
 
   void MSDataCachedConsumer::consumeChromatogram(ChromatogramType & c)
   {
+    chrom_index_.push_back(ofs_.tellp());
     writeChromatogram_(c, ofs_);
     chromatograms_written_++;
 
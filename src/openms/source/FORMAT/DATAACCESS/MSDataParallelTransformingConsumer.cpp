@@ -0,0 +1,191 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2018.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: Hannes Roest $
+// $Authors: Hannes Roest $
+// --------------------------------------------------------------------------
+
+
+#include <OpenMS/FORMAT/DATAACCESS/MSDataParallelTransformingConsumer.h>
+
+#include <OpenMS/CONCEPT/LogStream.h>
+
+#include <exception>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+namespace OpenMS
+{
+  namespace
+  {
+    /// apply @p f to all elements of @p batch in parallel (re-throws the first exception)
+    template <typename DataType>
+    void transformBatch(std::vector<DataType>& batch, const std::function<void (DataType&)>& f)
+    {
+      if (!f) return;
+
+      // parallel exception catching and re-throwing business
+      Size err_count = 0;
+      std::exception_ptr error;
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic)
+#endif
+      for (SignedSize i = 0; i < (SignedSize)batch.size(); ++i)
+      {
+        if (err_count) continue; // no need to continue if already an error was encountered
+        try
+        {
+          f(batch[i]);
+        }
+        catch (...)
+        {
+#ifdef _OPENMP
+#pragma omp critical (MSDataParallelTransformingConsumer_error)
+#endif
+          {
+            if (!err_count) error = std::current_exception();
+            ++err_count;
+          }
+        }
+      }
+
+      if (err_count != 0)
+      {
+        std::rethrow_exception(error);
+      }
+    }
+  }
+
+  MSDataParallelTransformingConsumer::MSDataParallelTransformingConsumer(Interfaces::IMSDataConsumer* next_consumer, Size batch_size) :
+    next_consumer_(next_consumer),
+    batch_size_(batch_size),
+    lambda_spec_(nullptr),
+    lambda_chrom_(nullptr)
+  {
+    if (batch_size_ == 0)
+    {
+#ifdef _OPENMP
+      batch_size_ = 16 * omp_get_max_threads();
+#else
+      batch_size_ = 16;
+#endif
+    }
+  }
+
+  MSDataParallelTransformingConsumer::~MSDataParallelTransformingConsumer()
+  {
+    // flush remaining data (exceptions must not leave the destructor)
+    try
+    {
+      flush();
+    }
+    catch (std::exception& e)
+    {
+      LOG_ERROR << "Error while processing the remaining data: " << e.what() << std::endl;
+    }
+  }
+
+  void MSDataParallelTransformingConsumer::setExpectedSize(Size expectedSpectra, Size expectedChromatograms)
+  {
+    next_consumer_->setExpectedSize(expectedSpectra, expectedChromatograms);
+  }
+
+  void MSDataParallelTransformingConsumer::setExperimentalSettings(const ExperimentalSettings& exp)
+  {
+    next_consumer_->setExperimentalSettings(exp);
+  }
+
+  void MSDataParallelTransformingConsumer::consumeSpectrum(SpectrumType& s)
+  {
+    // keep the order of spectra and chromatograms
+    if (!chromatograms_.empty()) flushChromatograms_();
+
+    spectra_.push_back(s);
+    if (spectra_.size() >= batch_size_) flushSpectra_();
+  }
+
+  void MSDataParallelTransformingConsumer::consumeChromatogram(ChromatogramType& c)
+  {
+    // keep the order of spectra and chromatograms
+    if (!spectra_.empty()) flushSpectra_();
+
+    chromatograms_.push_back(c);
+    if (chromatograms_.size() >= batch_size_) flushChromatograms_();
+  }
+
+  void MSDataParallelTransformingConsumer::setSpectraProcessingFunc(std::function<void (SpectrumType&)> f_spec)
+  {
+    lambda_spec_ = f_spec;
+  }
+
+  void MSDataParallelTransformingConsumer::setChromatogramProcessingFunc(std::function<void (ChromatogramType&)> f_chrom)
+  {
+    lambda_chrom_ = f_chrom;
+  }
+
+  void MSDataParallelTransformingConsumer::flush()
+  {
+    flushSpectra_();
+    flushChromatograms_();
+  }
+
+  Size MSDataParallelTransformingConsumer::getBatchSize() const
+  {
+    return batch_size_;
+  }
+
+  void MSDataParallelTransformingConsumer::flushSpectra_()
+  {
+    // take the batch out first, so it is discarded if the processing fails
+    std::vector<SpectrumType> batch;
+    batch.swap(spectra_);
+    transformBatch(batch, lambda_spec_);
+    for (Size i = 0; i < batch.size(); ++i)
+    {
+      next_consumer_->consumeSpectrum(batch[i]);
+    }
+    spectra_.reserve(batch_size_);
+  }
+
+  void MSDataParallelTransformingConsumer::flushChromatograms_()
+  {
+    // take the batch out first, so it is discarded if the processing fails
+    std::vector<ChromatogramType> batch;
+    batch.swap(chromatograms_);
+    transformBatch(batch, lambda_chrom_);
+    for (Size i = 0; i < batch.size(); ++i)
+    {
+      next_consumer_->consumeChromatogram(batch[i]);
+    }
+  }
+
+} // namespace OpenMS
@@ -0,0 +1,210 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2018.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: Hannes Roest $
+// $Authors: Hannes Roest $
+// --------------------------------------------------------------------------
+
+#include <OpenMS/FORMAT/DATAACCESS/MSDataPipelineConsumer.h>
+
+#include <OpenMS/CONCEPT/LogStream.h>
+
+#include <exception>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+namespace OpenMS
+{
+  namespace
+  {
+    /// pass @p batch through @p stages, runs of parallel-safe stages are applied concurrently (re-throws the first exception)
+    template <typename DataType>
+    void runStages(std::vector<DataType>& batch, const std::vector<Interfaces::IMSDataConsumer*>& stages,
+                   const std::vector<bool>& parallel_safe, void (Interfaces::IMSDataConsumer::*consume)(DataType&))
+    {
+      Size first = 0;
+      while (first < stages.size())
+      {
+        if (!parallel_safe[first])
+        {
+          // sequential stage: data arrives in the original order
+          for (Size i = 0; i < batch.size(); ++i)
+          {
+            (stages[first]->*consume)(batch[i]);
+          }
+          ++first;
+          continue;
+        }
+
+        // apply all consecutive parallel stages to one item before moving on to the next
+        Size last = first;
+        while (last < stages.size() && parallel_safe[last]) ++last;
+
+        // parallel exception catching and re-throwing business
+        Size err_count = 0;
+        std::exception_ptr error;
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic)
+#endif
+        for (SignedSize i = 0; i < (SignedSize)batch.size(); ++i)
+        {
+          if (err_count) continue; // no need to continue if already an error was encountered
+          try
+          {
+            for (Size k = first; k < last; ++k)
+            {
+              (stages[k]->*consume)(batch[i]);
+            }
+          }
+          catch (...)
+          {
+#ifdef _OPENMP
+#pragma omp critical (MSDataPipelineConsumer_error)
+#endif
+            {
+              if (!err_count) error = std::current_exception();
+              ++err_count;
+            }
+          }
+        }
+
+        if (err_count != 0)
+        {
+          std::rethrow_exception(error);
+        }
+        first = last;
+      }
+    }
+  }
+
+  MSDataPipelineConsumer::MSDataPipelineConsumer(Size batch_size) :
+    batch_size_(batch_size)
+  {
+    if (batch_size_ == 0)
+    {
+#ifdef _OPENMP
+      batch_size_ = 16 * omp_get_max_threads();
+#else
+      batch_size_ = 16;
+#endif
+    }
+  }
+
+  MSDataPipelineConsumer::~MSDataPipelineConsumer()
+  {
+    // flush remaining data (exceptions must not leave the destructor)
+    try
+    {
+      flush();
+    }
+    catch (std::exception& e)
+    {
+      LOG_ERROR << "Error while processing the remaining data: " << e.what() << std::endl;
+    }
+  }
+
+  void MSDataPipelineConsumer::appendStage(Interfaces::IMSDataConsumer* consumer, bool parallel_safe)
+  {
+    // data collected so far belongs to the previous pipeline
+    flush();
+    stages_.push_back(consumer);
+    parallel_safe_.push_back(parallel_safe);
+  }
+
+  Size MSDataPipelineConsumer::getNumberOfStages() const
+  {
+    return stages_.size();
+  }
+
+  void MSDataPipelineConsumer::setExpectedSize(Size expectedSpectra, Size expectedChromatograms)
+  {
+    for (Size i = 0; i < stages_.size(); ++i)
+    {
+      stages_[i]->setExpectedSize(expectedSpectra, expectedChromatograms);
+    }
+  }
+
+  void MSDataPipelineConsumer::setExperimentalSettings(const ExperimentalSettings& exp)
+  {
+    for (Size i = 0; i < stages_.size(); ++i)
+    {
+      stages_[i]->setExperimentalSettings(exp);
+    }
+  }
+
+  void MSDataPipelineConsumer::consumeSpectrum(SpectrumType& s)
+  {
+    // keep the order of spectra and chromatograms
+    if (!chromatograms_.empty()) flushChromatograms_();
+
+    spectra_.push_back(s);
+    if (spectra_.size() >= batch_size_) flushSpectra_();
+  }
+
+  void MSDataPipelineConsumer::consumeChromatogram(ChromatogramType& c)
+  {
+    // keep the order of spectra and chromatograms
+    if (!spectra_.empty()) flushSpectra_();
+
+    chromatograms_.push_back(c);
+    if (chromatograms_.size() >= batch_size_) flushChromatograms_();
+  }
+
+  void MSDataPipelineConsumer::flush()
+  {
+    flushSpectra_();
+    flushChromatograms_();
+  }
+
+  Size MSDataPipelineConsumer::getBatchSize() const
+  {
+    return batch_size_;
+  }
+
+  void MSDataPipelineConsumer::flushSpectra_()
+  {
+    // take the batch out first, so it is discarded if the processing fails
+    std::vector<SpectrumType> batch;
+    batch.swap(spectra_);
+    runStages(batch, stages_, parallel_safe_, &Interfaces::IMSDataConsumer::consumeSpectrum);
+    spectra_.reserve(batch_size_);
+  }
+
+  void MSDataPipelineConsumer::flushChromatograms_()
+  {
+    // take the batch out first, so it is discarded if the processing fails
+    std::vector<ChromatogramType> batch;
+    batch.swap(chromatograms_);
+    runStages(batch, stages_, parallel_safe_, &Interfaces::IMSDataConsumer::consumeChromatogram);
+  }
+
+} // namespace OpenMS
@@ -7,8 +7,12 @@ set(sources_list
   MSDataWritingConsumer.cpp
   MSDataTransformingConsumer.cpp
   MSDataAggregatingConsumer.cpp
+  MSDataAsyncConsumer.cpp
+  MSDataBlockMergingConsumer.cpp
   MSDataCachedConsumer.cpp
   MSDataChainingConsumer.cpp
+  MSDataParallelTransformingConsumer.cpp
+  MSDataPipelineConsumer.cpp
   MSDataStoringConsumer.cpp
   MSDataSqlConsumer.cpp
   MSDataTransformingConsumer.cpp
@@ -39,6 +39,8 @@
 
 #include <OpenMS/CONCEPT/LogStream.h>
 
+#include <sstream>
+
 #include <seqan/basic.h>
 #include <seqan/stream.h>
 #include <seqan/seq_io/guess_stream_format.h>
@@ -164,24 +166,55 @@ namespace OpenMS
     }
   }
 
-  void FASTAFile::writeNext(const FASTAEntry& protein)
+  void FASTAFile::writeEntry_(std::ostream& os, const FASTAEntry& protein)
   {
-    outfile_ << ">" << protein.identifier << " " << protein.description << "\n";
+    os << ">" << protein.identifier << " " << protein.description << "\n";
     const String& tmp(protein.sequence);
 
     int chunks( tmp.size()/80 ); // number of complete chunks
     Size chunk_pos(0);
     while (--chunks >= 0)
     {
-      outfile_.write(&tmp[chunk_pos], 80);
-      outfile_ << "\n";
+      os.write(&tmp[chunk_pos], 80);
+      os << "\n";
       chunk_pos += 80;
     }
 
     if (tmp.size() > chunk_pos)
     {
-      outfile_.write(&tmp[chunk_pos], tmp.size() - chunk_pos);
-      outfile_ << "\n";
+      os.write(&tmp[chunk_pos], tmp.size() - chunk_pos);
+      os << "\n";
+    }
+  }
+
+  void FASTAFile::writeNext(const FASTAEntry& protein)
+  {
+    writeEntry_(outfile_, protein);
+  }
+
+  void FASTAFile::writeNext(const vector<FASTAEntry>& proteins)
+  {
+    // blocks of entries are formatted in parallel, then written in order
+    const SignedSize block_size = 512;
+    const SignedSize block_count = ((SignedSize)proteins.size() + block_size - 1) / block_size;
+    vector<String> buffers(block_count);
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic)
+#endif
+    for (SignedSize b = 0; b < block_count; ++b)
+    {
+      stringstream ss;
+      const SignedSize end = std::min((SignedSize)proteins.size(), (b + 1) * block_size);
+      for (SignedSize i = b * block_size; i < end; ++i)
+      {
+        writeEntry_(ss, proteins[i]);
+      }
+      buffers[b] = ss.str();
+    }
+
+    for (const String& buffer : buffers)
+    {
+      outfile_ << buffer;
     }
   }
 
@@ -0,0 +1,376 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2018.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: Timo Sachsenberg $
+// $Authors: Timo Sachsenberg $
+// --------------------------------------------------------------------------
+
+#include <OpenMS/FORMAT/FASTAIndex.h>
+
+#include <OpenMS/CONCEPT/LogStream.h>
+#include <OpenMS/FORMAT/TextFile.h>
+#include <OpenMS/SYSTEM/File.h>
+
+#include <QtCore/QDateTime>
+#include <QtCore/QFileInfo>
+
+#include <exception>
+#include <fstream>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+using namespace std;
+
+namespace OpenMS
+{
+  namespace
+  {
+    /// Parses a non-negative number (offsets of large files do not fit into Int)
+    bool parseSize_(const String& str, Size& value)
+    {
+      if (str.empty()) return false;
+      value = 0;
+      for (String::const_iterator it = str.begin(); it != str.end(); ++it)
+      {
+        if (*it < '0' || *it > '9') return false;
+        value = value * 10 + (*it - '0');
+      }
+      return true;
+    }
+  }
+
+  FASTAIndex::FASTAIndex()
+  {
+  }
+
+  void FASTAIndex::open(const String& fasta_file, bool store_index)
+  {
+    if (!File::exists(fasta_file))
+    {
+      throw Exception::FileNotFound(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, fasta_file);
+    }
+
+    String index_file = fasta_file + ".fai";
+    if (File::exists(index_file) &&
+        QFileInfo(index_file.toQString()).lastModified() >= QFileInfo(fasta_file.toQString()).lastModified())
+    {
+      load(index_file, fasta_file);
+      return;
+    }
+
+    build(fasta_file);
+    if (store_index)
+    {
+      try
+      {
+        store(index_file);
+      }
+      catch (Exception::UnableToCreateFile&)
+      {
+        LOG_INFO << "Could not write FASTA index '" << index_file << "', the index is only kept in memory." << std::endl;
+      }
+    }
+  }
+
+  void FASTAIndex::build(const String& fasta_file)
+  {
+    ifstream is(fasta_file.c_str(), ios_base::in | ios_base::binary);
+    if (!is)
+    {
+      throw Exception::FileNotFound(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, fasta_file);
+    }
+
+    fasta_file_ = fasta_file;
+    entries_.clear();
+
+    std::string line;
+    Size pos(0); // byte offset of the current line
+    bool short_line(false); // did the current entry already have a line shorter than line_bases?
+    while (std::getline(is, line))
+    {
+      Size line_bytes = line.size() + (is.eof() ? 0 : 1);
+      if (!line.empty() && line[line.size() - 1] == '\r') line.resize(line.size() - 1);
+
+      if (!line.empty() && line[0] == '>')
+      {
+        String id(line.substr(1));
+        id.trim();
+        Entry record;
+        record.name = id.substr(0, id.find_first_of(" \v\t"));
+        record.length = 0;
+        record.offset = pos + line_bytes;
+        record.line_bases = 0;
+        record.line_width = 0;
+        entries_.push_back(record);
+        short_line = false;
+      }
+      else if (!entries_.empty())
+      {
+        Entry& record = entries_.back();
+        Size bases = line.size();
+        if (record.line_bases == 0 && record.length == 0)
+        {
+          record.line_bases = bases;
+          record.line_width = line_bytes;
+        }
+        else if (bases > 0 && (short_line || bases > record.line_bases))
+        {
+          throw Exception::ParseError(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, fasta_file,
+              "Different line lengths in the sequence of '" + record.name + "', cannot index the FASTA file.");
+        }
+        if (bases < record.line_bases) short_line = true;
+        record.length += bases;
+      }
+      pos += line_bytes;
+    }
+    updateLookup_();
+  }
+
+  void FASTAIndex::load(const String& index_file, const String& fasta_file)
+  {
+    TextFile tf(index_file);
+
+    fasta_file_ = fasta_file;
+    entries_.clear();
+    entries_.reserve(tf.end() - tf.begin());
+    std::vector<String> fields;
+    for (TextFile::ConstIterator it = tf.begin(); it != tf.end(); ++it)
+    {
+      if (it->empty()) continue;
+      it->split('\t', fields);
+      if (fields.size() != 5)
+      {
+        throw Exception::ParseError(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, *it,
+            "Expected 5 tab-separated fields in FASTA index file '" + index_file + "'.");
+      }
+      Entry record;
+      record.name = fields[0];
+      if (!parseSize_(fields[1], record.length) || !parseSize_(fields[2], record.offset) ||
+          !parseSize_(fields[3], record.line_bases) || !parseSize_(fields[4], record.line_width) ||
+          (record.length > 0 && record.line_bases == 0))
+      {
+        throw Exception::ParseError(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, *it,
+            "Invalid number in FASTA index file '" + index_file + "'.");
+      }
+      entries_.push_back(record);
+    }
+    updateLookup_();
+  }
+
+  void FASTAIndex::store(const String& index_file) const
+  {
+    ofstream os(index_file.c_str(), ios_base::out | ios_base::binary);
+    if (!os)
+    {
+      throw Exception::UnableToCreateFile(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, index_file);
+    }
+    for (const Entry& record : entries_)
+    {
+      os << record.name << '\t' << record.length << '\t' << record.offset << '\t'
+         << record.line_bases << '\t' << record.line_width << '\n';
+    }
+    os.close();
+    if (!os)
+    {
+      throw Exception::UnableToCreateFile(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, index_file);
+    }
+  }
+
+  Size FASTAIndex::size() const
+  {
+    return entries_.size();
+  }
+
+  const std::vector<FASTAIndex::Entry>& FASTAIndex::getIndexEntries() const
+  {
+    return entries_;
+  }
+
+  SignedSize FASTAIndex::find(const String& name) const
+  {
+    std::unordered_map<std::string, Size>::const_iterator it = lookup_.find(name);
+    if (it == lookup_.end()) return -1;
+    return it->second;
+  }
+
+  bool FASTAIndex::getEntry(const String& name, FASTAFile::FASTAEntry& entry) const
+  {
+    SignedSize index = find(name);
+    if (index < 0) return false;
+    getEntry(index, entry);
+    return true;
+  }
+
+  void FASTAIndex::getEntry(Size index, FASTAFile::FASTAEntry& entry) const
+  {
+    if (index >= entries_.size())
+    {
+      throw Exception::IndexOverflow(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, index, entries_.size());
+    }
+    ifstream is(fasta_file_.c_str(), ios_base::in | ios_base::binary);
+    if (!is)
+    {
+      throw Exception::FileNotFound(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, fasta_file_);
+    }
+    readEntry_(is, entries_[index], entry);
+  }
+
+  void FASTAIndex::getEntries(Size first, Size last, std::vector<FASTAFile::FASTAEntry>& entries) const
+  {
+    if (last > entries_.size())
+    {
+      throw Exception::IndexOverflow(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, last, entries_.size());
+    }
+    entries.clear();
+    if (first >= last) return;
+    entries.resize(last - first);
+
+    Size err_count(0);
+    std::exception_ptr err;
+#ifdef _OPENMP
+#pragma omp parallel
+#endif
+    {
+      // every thread reads a contiguous chunk of entries with its own stream
+      ifstream is(fasta_file_.c_str(), ios_base::in | ios_base::binary);
+#ifdef _OPENMP
+#pragma omp for schedule(static)
+#endif
+      for (SignedSize k = 0; k < (SignedSize)entries.size(); ++k)
+      {
+        try
+        {
+          if (!is)
+          {
+            throw Exception::FileNotFound(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, fasta_file_);
+          }
+          readEntry_(is, entries_[first + k], entries[k]);
+        }
+        catch (...)
+        {
+#ifdef _OPENMP
+#pragma omp critical (FASTAIndex_getEntries)
+#endif
+          {
+            if (err_count++ == 0) err = std::current_exception();
+          }
+        }
+      }
+    }
+    if (err_count > 0) std::rethrow_exception(err);
+  }
+
+  void FASTAIndex::readEntry_(std::ifstream& is, const Entry& record, FASTAFile::FASTAEntry& entry) const
+  {
+    // the header is the line ending right before the first residue: search
+    // backwards for the preceding line break, doubling the window if needed
+    std::string header, buffer;
+    Size window(4096);
+    while (true)
+    {
+      Size start = record.offset > window ? record.offset - window : 0;
+      buffer.resize(record.offset - start);
+      is.clear();
+      is.seekg(start);
+      is.read(&buffer[0], buffer.size());
+      if ((Size)is.gcount() != buffer.size())
+      {
+        throw Exception::ParseError(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, fasta_file_,
+            "FASTA index does not match the file (offset of '" + record.name + "' is beyond the end of the file).");
+      }
+      Size stop = buffer.size();
+      while (stop > 0 && (buffer[stop - 1] == '\n' || buffer[stop - 1] == '\r')) --stop;
+      Size line_start = buffer.rfind('\n', stop == 0 ? 0 : stop - 1);
+      if (line_start != std::string::npos && line_start < stop)
+      {
+        header = buffer.substr(line_start + 1, stop - line_start - 1);
+        break;
+      }
+      if (start == 0)
+      {
+        header = buffer.substr(0, stop);
+        break;
+      }
+      window *= 2;
+    }
+    if (header.empty() || header[0] != '>')
+    {
+      throw Exception::ParseError(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, fasta_file_,
+          "FASTA index does not match the file (no header found for '" + record.name + "').");
+    }
+
+    // handle id (as in FASTAFile::readNext)
+    String id(header.substr(1));
+    id.trim();
+    String::size_type position = id.find_first_of(" \v\t");
+    if (position == String::npos)
+    {
+      entry.identifier = id;
+      entry.description = "";
+    }
+    else
+    {
+      entry.identifier = id.substr(0, position);
+      entry.description = id.suffix(id.size() - position - 1);
+    }
+
+    // sequence: all lines but the last one have line_bases residues
+    String seq;
+    if (record.length > 0)
+    {
+      Size bytes = (record.length / record.line_bases) * record.line_width + record.length % record.line_bases;
+      seq.resize(bytes);
+      is.clear();
+      is.seekg(record.offset);
+      is.read(&seq[0], bytes);
+      seq.resize(is.gcount());
+      seq.removeWhitespaces();
+    }
+    if (seq.size() != record.length)
+    {
+      throw Exception::ParseError(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, fasta_file_,
+          "FASTA index does not match the file (wrong sequence length for '" + record.name + "').");
+    }
+    entry.sequence = seq;
+  }
+
+  void FASTAIndex::updateLookup_()
+  {
+    lookup_.clear();
+    lookup_.reserve(entries_.size());
+    for (Size i = 0; i < entries_.size(); ++i)
+    {
+      lookup_.insert(std::make_pair(entries_[i].name, i)); // keeps the first entry for duplicate names
+    }
+  }
+
+} // namespace OpenMS
@@ -39,8 +39,10 @@
 #include <OpenMS/METADATA/DataProcessing.h>
 #include <OpenMS/CHEMISTRY/ProteaseDB.h>
 #include <OpenMS/FORMAT/FileHandler.h>
+#include <OpenMS/FORMAT/InMemoryFileStore.h>
 
 #include <fstream>
+#include <sstream>
 
 using namespace std;
 
@@ -102,6 +104,12 @@ namespace OpenMS
 
   void FeatureXMLFile::load(const String& filename, FeatureMap& feature_map)
   {
+    if (InMemoryFileStore::isMemoryPath(filename))
+    {
+      InMemoryFileStore::load(filename, feature_map);
+      return;
+    }
+
     //Filename for error messages in XMLHandler
     file_ = filename;
 
@@ -140,6 +148,12 @@ namespace OpenMS
       throw Exception::UnableToCreateFile(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, filename, "invalid file extension, expected '" + FileTypes::typeToName(FileTypes::FEATUREXML) + "'");
     }
 
+    if (InMemoryFileStore::isMemoryPath(filename))
+    {
+      InMemoryFileStore::store(filename, feature_map);
+      return;
+    }
+
     //open stream
     ofstream os(filename.c_str());
     if (!os)
@@ -304,11 +318,51 @@ namespace OpenMS
     // write features with their corresponding attributes
     os << "\t<featureList count=\"" << feature_map.size() << "\">\n";
     startProgress(0, feature_map.size(), "Storing featureXML file");
-    for (Size s = 0; s < feature_map.size(); s++)
-    {
-      writeFeature_(filename, os, feature_map[s], "f_", feature_map[s].getUniqueId(), 0);
-      setProgress(s);
-      // writeFeature_(filename, os, feature_map[s], "f_", s, 0);
+    // format batches of elements (in parallel) and write them in order
+    const Size batch_size = 10000;
+    std::vector<String> formatted;
+    for (Size batch_start = 0; batch_start < feature_map.size(); batch_start += batch_size)
+    {
+      const Size batch_end = std::min(feature_map.size(), batch_start + batch_size);
+      formatted.assign(batch_end - batch_start, String());
+
+      Size err_count(0);
+      std::exception_ptr err;
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic, 100)
+#endif
+      for (SignedSize k = 0; k < (SignedSize)formatted.size(); ++k)
+      {
+        try
+        {
+          std::stringstream elem_os;
+          elem_os.precision(os.precision());
+          writeFeature_(filename, elem_os, feature_map[batch_start + k], "f_", feature_map[batch_start + k].getUniqueId(), 0);
+          formatted[k] = elem_os.str();
+        }
+        catch (...)
+        {
+#ifdef _OPENMP
+#pragma omp critical (FeatureXMLFile_store)
+#endif
+          {
+            if (err_count++ == 0)
+            {
+              err = std::current_exception();
+            }
+          }
+        }
+      }
+      if (err_count != 0)
+      {
+        std::rethrow_exception(err);
+      }
+
+      for (Size k = 0; k < formatted.size(); ++k)
+      {
+        os << formatted[k];
+      }
+      setProgress(batch_end - 1);
     }
     endProgress();
 
@@ -978,7 +1032,7 @@ namespace OpenMS
     os << indent << "\t\t\t<charge>" << feat.getCharge() << "</charge>\n";
 
     // write convex hull
-    vector<ConvexHull2D> hulls = feat.getConvexHulls();
+    const vector<ConvexHull2D>& hulls = feat.getConvexHulls();
 
     Size hulls_count = hulls.size();
 
@@ -986,13 +1040,19 @@ namespace OpenMS
     {
       os << indent << "\t\t\t<convexhull nr=\"" << i << "\">\n";
 
-      ConvexHull2D current_hull = hulls[i];
-      current_hull.compress();
-      Size hull_size = current_hull.getHullPoints().size();
+      // compact hulls are already compressed, only copy the others for compression
+      ConvexHull2D compressed_hull;
+      if (!hulls[i].isCompact())
+      {
+        compressed_hull = hulls[i];
+        compressed_hull.compress();
+      }
+      const ConvexHull2D::PointArrayType& hull_points = hulls[i].isCompact() ? hulls[i].getHullPoints() : compressed_hull.getHullPoints();
+      Size hull_size = hull_points.size();
 
       for (Size j = 0; j < hull_size; j++)
       {
-        DPosition<2> pos = current_hull.getHullPoints()[j];
+        const DPosition<2>& pos = hull_points[j];
         /*Size pos_size = pos.size();
             os << indent << "\t\t\t\t<hullpoint>\n";
     for (Size k=0; k<pos_size; k++)
@@ -1036,11 +1096,16 @@ namespace OpenMS
 
     if (!identifier_id_.has(id.getIdentifier()))
     {
-      warning(STORE, String("Omitting peptide identification because of missing ProteinIdentification with identifier '") + id.getIdentifier() + "' while writing '" + filename + "'!");
+#ifdef _OPENMP
+#pragma omp critical (FeatureXMLFile_warning)
+#endif
+      {
+        warning(STORE, String("Omitting peptide identification because of missing ProteinIdentification with identifier '") + id.getIdentifier() + "' while writing '" + filename + "'!");
+      }
       return;
     }
     os << indent << "<" << tag_name << " ";
-    os << "identification_run_ref=\"" << identifier_id_[id.getIdentifier()] << "\" ";
+    os << "identification_run_ref=\"" << identifier_id_.find(id.getIdentifier())->second << "\" ";
     os << "score_type=\"" << writeXMLEscape(id.getScoreType()) << "\" ";
     os << "higher_score_better=\"" << (id.isHigherScoreBetter() ? "true" : "false") << "\" ";
     os << "significance_threshold=\"" << id.getSignificanceThreshold() << "\" ";
@@ -1089,7 +1154,8 @@ namespace OpenMS
         if (!protein_accession.empty())
         {
           accs += "PH_";
-          accs += String(accession_to_id_[id.getIdentifier() + "_" + protein_accession]);
+          Map<String, Size>::const_iterator acc_it = accession_to_id_.find(id.getIdentifier() + "_" + protein_accession);
+          accs += String(acc_it != accession_to_id_.end() ? acc_it->second : 0);
         }
       }
 
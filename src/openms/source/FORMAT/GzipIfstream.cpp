@@ -35,20 +35,163 @@
 #include <iostream>
 #include <OpenMS/FORMAT/GzipIfstream.h>
 #include <OpenMS/CONCEPT/Exception.h>
+#include <OpenMS/CONCEPT/Types.h>
 #include <cstdlib>
+#include <cstring>
+#include <exception>
+#include <vector>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
 
 using namespace std;
 
 namespace OpenMS
 {
+  namespace
+  {
+    /// size of the fixed part of a gzip member header (including XLEN)
+    const size_t BGZF_HEADER_SIZE = 12;
+    /// number of BGZF blocks decompressed together (each block holds at most 64 kB of data)
+    const size_t BGZF_BATCH_SIZE = 256;
+
+    /// Little-endian integer from @p p
+    inline UInt32 readLE_(const unsigned char * p, size_t bytes)
+    {
+      UInt32 result = 0;
+      for (size_t i = bytes; i > 0; --i)
+      {
+        result = (result << 8) | p[i - 1];
+      }
+      return result;
+    }
+
+    /**
+      @brief Returns the total size of the BGZF block given the fixed header and its extra field
+
+      Returns 0 if the gzip member does not carry the BGZF block size subfield.
+    */
+    size_t bgzfBlockSize_(const unsigned char * header, const unsigned char * extra, size_t xlen)
+    {
+      // ID1, ID2, CM = deflate, FLG = FEXTRA
+      if (header[0] != 31 || header[1] != 139 || header[2] != 8 || (header[3] & 4) == 0) return 0;
+      size_t pos = 0;
+      while (pos + 4 <= xlen)
+      {
+        size_t slen = readLE_(extra + pos + 2, 2);
+        if (extra[pos] == 'B' && extra[pos + 1] == 'C' && slen == 2 && pos + 6 <= xlen)
+        {
+          return readLE_(extra + pos + 4, 2) + 1;
+        }
+        pos += 4 + slen;
+      }
+      return 0;
+    }
+
+    /**
+      @brief Reads the next BGZF block from @p file into @p block
+
+      @return false if the end of the file was reached before a new block started
+      @exception Exception::ConversionError is thrown if the block is truncated or not a BGZF block
+    */
+    bool readBGZFBlock_(std::FILE * file, std::string & block)
+    {
+      unsigned char header[BGZF_HEADER_SIZE];
+      size_t n = fread(header, 1, BGZF_HEADER_SIZE, file);
+      if (n == 0) return false;
+      if (n != BGZF_HEADER_SIZE)
+      {
+        throw Exception::ConversionError(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "gzip file seems to be corrupted");
+      }
+      size_t xlen = readLE_(header + 10, 2);
+      std::vector<unsigned char> extra(xlen);
+      size_t block_size = 0;
+      if (fread(extra.data(), 1, xlen, file) == xlen)
+      {
+        block_size = bgzfBlockSize_(header, extra.data(), xlen);
+      }
+      // header, extra field, at least an empty deflate stream, CRC32 and ISIZE
+      if (block_size < BGZF_HEADER_SIZE + xlen + 8)
+      {
+        throw Exception::ConversionError(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "gzip file seems to be corrupted");
+      }
+      block.resize(block_size);
+      std::memcpy(&block[0], header, BGZF_HEADER_SIZE);
+      if (xlen > 0) std::memcpy(&block[BGZF_HEADER_SIZE], extra.data(), xlen);
+      size_t rest = block_size - BGZF_HEADER_SIZE - xlen;
+      if (fread(&block[BGZF_HEADER_SIZE + xlen], 1, rest, file) != rest)
+      {
+        throw Exception::ConversionError(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "gzip file seems to be corrupted");
+      }
+      return true;
+    }
+
+    /// Decompresses a single BGZF block (as read by readBGZFBlock_) into @p out and verifies its checksum
+    void inflateBGZFBlock_(const std::string & block, std::string & out)
+    {
+      const unsigned char * data = reinterpret_cast<const unsigned char *>(block.data());
+      size_t xlen = readLE_(data + 10, 2);
+      size_t cdata_offset = BGZF_HEADER_SIZE + xlen;
+      size_t cdata_size = block.size() - cdata_offset - 8;
+      UInt32 crc = readLE_(data + block.size() - 8, 4);
+      UInt32 isize = readLE_(data + block.size() - 4, 4);
+
+      out.resize(isize);
+      z_stream zs;
+      std::memset(&zs, 0, sizeof(zs));
+      if (inflateInit2(&zs, -15) != Z_OK) // raw deflate stream
+      {
+        throw Exception::ConversionError(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "zlib initialization failed");
+      }
+      zs.next_in = const_cast<Bytef *>(data + cdata_offset);
+      zs.avail_in = (uInt) cdata_size;
+      // zlib does not accept a null output buffer, even for empty blocks
+      Bytef dummy;
+      zs.next_out = isize > 0 ? reinterpret_cast<Bytef *>(&out[0]) : &dummy;
+      zs.avail_out = (uInt) isize;
+      int ret = inflate(&zs, Z_FINISH);
+      size_t total_out = zs.total_out;
+      inflateEnd(&zs);
+
+      if (ret != Z_STREAM_END || total_out != isize ||
+          crc32(crc32(0L, Z_NULL, 0), reinterpret_cast<const Bytef *>(out.data()), (uInt) isize) != crc)
+      {
+        throw Exception::ConversionError(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "gzip file seems to be corrupted");
+      }
+    }
+
+    /// Returns true if the file starts with a BGZF block
+    bool isBGZF_(const char * filename)
+    {
+      std::FILE * file = fopen(filename, "rb");
+      if (file == nullptr) return false;
+      unsigned char header[BGZF_HEADER_SIZE];
+      bool result = false;
+      if (fread(header, 1, BGZF_HEADER_SIZE, file) == BGZF_HEADER_SIZE)
+      {
+        size_t xlen = readLE_(header + 10, 2);
+        std::vector<unsigned char> extra(xlen);
+        if (fread(extra.data(), 1, xlen, file) == xlen)
+        {
+          result = bgzfBlockSize_(header, extra.data(), xlen) > 0;
+        }
+      }
+      fclose(file);
+      return result;
+    }
+  }
+
   GzipIfstream::GzipIfstream(const char * filename) :
-    gzfile_(nullptr), n_buffer_(0), stream_at_end_(false)
+    gzfile_(nullptr), n_buffer_(0), gzerror_(0), stream_at_end_(false),
+    bgzf_file_(nullptr), bgzf_pos_(0), bgzf_file_end_(true)
   {
     open(filename);
   }
 
   GzipIfstream::GzipIfstream() :
-    gzfile_(nullptr), n_buffer_(0), gzerror_(0), stream_at_end_(true)
+    gzfile_(nullptr), n_buffer_(0), gzerror_(0), stream_at_end_(true),
+    bgzf_file_(nullptr), bgzf_pos_(0), bgzf_file_end_(true)
   {
   }
 
@@ -59,7 +202,33 @@ namespace OpenMS
 
   size_t GzipIfstream::read(char * s, size_t n)
   {
-    if (gzfile_ != nullptr)
+    if (bgzf_file_ != nullptr)
+    {
+      size_t n_read = 0;
+      try
+      {
+        while (n_read < n)
+        {
+          if (bgzf_pos_ == bgzf_buffer_.size() && !fillBlockBuffer_()) break;
+          size_t count = std::min(n - n_read, bgzf_buffer_.size() - bgzf_pos_);
+          std::memcpy(s + n_read, bgzf_buffer_.data() + bgzf_pos_, count);
+          bgzf_pos_ += count;
+          n_read += count;
+        }
+        // like gzeof, only report the end once all data has been returned
+        if (bgzf_pos_ == bgzf_buffer_.size() && bgzf_file_end_)
+        {
+          close();
+        }
+      }
+      catch (...)
+      {
+        close();
+        throw;
+      }
+      return n_read;
+    }
+    else if (gzfile_ != nullptr)
     {
       n_buffer_ = gzread(gzfile_, s, (unsigned int) n /* size of buf */);
       if (gzeof(gzfile_) == 1)
@@ -80,12 +249,76 @@ namespace OpenMS
     }
   }
 
+  bool GzipIfstream::fillBlockBuffer_()
+  {
+    std::vector<std::string> blocks;
+    blocks.reserve(BGZF_BATCH_SIZE);
+    std::string block;
+    while (blocks.size() < BGZF_BATCH_SIZE)
+    {
+      if (!readBGZFBlock_(bgzf_file_, block))
+      {
+        bgzf_file_end_ = true;
+        break;
+      }
+      blocks.push_back(block);
+    }
+    if (blocks.empty()) return false;
+
+    // every block is an independent deflate stream
+    std::vector<std::string> decompressed(blocks.size());
+    Size err_count(0);
+    std::exception_ptr err;
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic, 4)
+#endif
+    for (SignedSize k = 0; k < (SignedSize)blocks.size(); ++k)
+    {
+      try
+      {
+        inflateBGZFBlock_(blocks[k], decompressed[k]);
+      }
+      catch (...)
+      {
+#ifdef _OPENMP
+#pragma omp critical (GzipIfstream_inflate)
+#endif
+        {
+          if (err_count++ == 0) err = std::current_exception();
+        }
+      }
+    }
+    if (err_count > 0) std::rethrow_exception(err);
+
+    bgzf_buffer_.clear();
+    for (Size k = 0; k < decompressed.size(); ++k)
+    {
+      bgzf_buffer_ += decompressed[k];
+    }
+    bgzf_pos_ = 0;
+    return true;
+  }
+
   void GzipIfstream::open(const char * filename)
   {
-    if (gzfile_ != nullptr)
+    if (gzfile_ != nullptr || bgzf_file_ != nullptr)
     {
       close();
     }
+
+    if (isBGZF_(filename))
+    {
+      bgzf_file_ = fopen(filename, "rb");
+      if (bgzf_file_ != nullptr)
+      {
+        bgzf_buffer_.clear();
+        bgzf_pos_ = 0;
+        bgzf_file_end_ = false;
+        stream_at_end_ = false;
+        return;
+      }
+    }
+
     gzfile_ = gzopen(filename, "rb"); // read binary: always open in binary mode because windows and mac open in text mode
 
     //aborting, ahhh!
@@ -144,6 +377,14 @@ namespace OpenMS
       gzclose(gzfile_);
     }
     gzfile_ = nullptr;
+    if (bgzf_file_ != nullptr)
+    {
+      fclose(bgzf_file_);
+    }
+    bgzf_file_ = nullptr;
+    bgzf_buffer_.clear();
+    bgzf_pos_ = 0;
+    bgzf_file_end_ = true;
     stream_at_end_ = true;
   }
 
@@ -37,11 +37,65 @@
 #include <OpenMS/KERNEL/MSExperiment.h>
 #include <OpenMS/FORMAT/MzMLFile.h>
 
+#include <OpenMS/FORMAT/ZlibCompression.h>
+
+#include <cstring>
+
 namespace OpenMS
 {
 namespace Internal
 {
 
+  namespace
+  {
+    /**
+      @brief Minimal input stream on a memory buffer
+
+      Offers the subset of the std::ifstream interface used by the readers
+      below, but reading past the end of the buffer raises an exception
+      instead of setting the fail bit.
+    */
+    class MemoryInputStream
+    {
+    public:
+      MemoryInputStream(const char* buffer, Size buffer_size) :
+        pos_(buffer),
+        end_(buffer + buffer_size)
+      {
+      }
+
+      MemoryInputStream& read(char* s, std::streamsize n)
+      {
+        checkAvailable_(n);
+        std::memcpy(s, pos_, n);
+        pos_ += n;
+        return *this;
+      }
+
+      MemoryInputStream& ignore(std::streamsize n)
+      {
+        checkAvailable_(n);
+        pos_ += n;
+        return *this;
+      }
+
+    private:
+      void checkAvailable_(std::streamsize n) const
+      {
+        if (n < 0 || n > end_ - pos_)
+        {
+          throw Exception::ParseError(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION,
+            "Tried to read past the end of the cached data, something is wrong here. Aborting.", "memory");
+        }
+      }
+
+      const char* pos_;
+      const char* end_;
+    };
+  }
+
+  const Size CachedMzMLHandler::CACHED_MZML_V2_BLOCK_MARKER;
+
   CachedMzMLHandler::CachedMzMLHandler()
   {
   }
@@ -57,37 +111,95 @@ namespace Internal
 
     spectra_index_ = rhs.spectra_index_;
     chrom_index_ = rhs.chrom_index_;
+    storage_options_ = rhs.storage_options_;
 
     return *this;
   }
 
+  void CachedMzMLHandler::setStorageOptions(const StorageOptions& options)
+  {
+    if (options.format_version != 1 && options.format_version != 2)
+    {
+      throw Exception::InvalidParameter(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION,
+        "Cached mzML format version " + String(options.format_version) + " is not supported (use 1 or 2).");
+    }
+    storage_options_ = options;
+  }
+
+  const CachedMzMLHandler::StorageOptions& CachedMzMLHandler::getStorageOptions() const
+  {
+    return storage_options_;
+  }
+
   void CachedMzMLHandler::writeMemdump(const MapType& exp, const String& out) const
   {
     std::ofstream ofs(out.c_str(), std::ios::binary);
-    Size exp_size = exp.size();
-    Size chrom_size = exp.getChromatograms().size();
-    int file_identifier = CACHED_MZML_FILE_IDENTIFIER;
-    ofs.write((char*)&file_identifier, sizeof(file_identifier));
+    writeHeader_(ofs);
+
+    std::vector<std::streampos> spectra_index, chrom_index;
+    spectra_index.reserve(exp.size());
+    chrom_index.reserve(exp.getChromatograms().size());
 
     startProgress(0, exp.size() + exp.getChromatograms().size(), "storing binary data");
     for (Size i = 0; i < exp.size(); i++)
     {
       setProgress(i);
+      spectra_index.push_back(ofs.tellp());
       writeSpectrum_(exp[i], ofs);
     }
 
     for (Size i = 0; i < exp.getChromatograms().size(); i++)
     {
       setProgress(i);
+      chrom_index.push_back(ofs.tellp());
       writeChromatogram_(exp.getChromatograms()[i], ofs);
     }
 
-    ofs.write((char*)&exp_size, sizeof(exp_size));
-    ofs.write((char*)&chrom_size, sizeof(chrom_size));
+    writeFooter_(ofs, spectra_index, chrom_index);
     ofs.close();
     endProgress();
   }
 
+  void CachedMzMLHandler::writeHeader_(std::ofstream& ofs) const
+  {
+    if (storage_options_.format_version == 1)
+    {
+      int file_identifier = CACHED_MZML_FILE_IDENTIFIER;
+      ofs.write((char*)&file_identifier, sizeof(file_identifier));
+      return;
+    }
+
+    int file_identifier = CACHED_MZML_VERSIONED_FILE_IDENTIFIER;
+    int format_version = storage_options_.format_version;
+    ofs.write((char*)&file_identifier, sizeof(file_identifier));
+    ofs.write((char*)&format_version, sizeof(format_version));
+  }
+
+  void CachedMzMLHandler::writeFooter_(std::ofstream& ofs, const std::vector<std::streampos>& spectra_index,
+    const std::vector<std::streampos>& chrom_index) const
+  {
+    Size exp_size = spectra_index.size();
+    Size chrom_size = chrom_index.size();
+
+    if (storage_options_.format_version != 1)
+    {
+      // offset table of all blocks, followed by the position of the table
+      Size index_offset = ofs.tellp();
+      std::vector<Size> offsets;
+      offsets.reserve(exp_size + chrom_size);
+      for (const auto& pos : spectra_index) offsets.push_back(static_cast<Size>(static_cast<std::streamoff>(pos)));
+      for (const auto& pos : chrom_index) offsets.push_back(static_cast<Size>(static_cast<std::streamoff>(pos)));
+      if (!offsets.empty())
+      {
+        ofs.write((char*)&offsets[0], offsets.size() * sizeof(offsets[0]));
+      }
+      ofs.write((char*)&index_offset, sizeof(index_offset));
+    }
+
+    ofs.write((char*)&exp_size, sizeof(exp_size));
+    ofs.write((char*)&chrom_size, sizeof(chrom_size));
+  }
+
   void CachedMzMLHandler::readMemdump(MapType& exp_reading, String filename) const
   {
     std::ifstream ifs(filename.c_str(), std::ios::binary);
@@ -99,20 +211,14 @@ namespace Internal
     Size exp_size, chrom_size;
     Peak1D current_peak;
 
-    int file_identifier;
-    ifs.read((char*)&file_identifier, sizeof(file_identifier));
-    if (file_identifier != CACHED_MZML_FILE_IDENTIFIER)
-    {
-      throw Exception::ParseError(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, 
-        "File might not be a cached mzML file (wrong file magic number). Aborting!", filename);
-    }
+    const std::streamoff header_size = readHeader_(ifs, filename);
 
     ifs.seekg(0, ifs.end); // set file pointer to end
     ifs.seekg(ifs.tellg(), ifs.beg); // set file pointer to end, in forward direction
     ifs.seekg(- static_cast<int>(sizeof(exp_size) + sizeof(chrom_size)), ifs.cur); // move two fields to the left, start reading
     ifs.read((char*)&exp_size, sizeof(exp_size));
     ifs.read((char*)&chrom_size, sizeof(chrom_size));
-    ifs.seekg(sizeof(file_identifier), ifs.beg); // set file pointer to beginning (after identifier), start reading
+    ifs.seekg(header_size, ifs.beg); // set file pointer to beginning (after header), start reading
 
     exp_reading.reserve(exp_size);
     startProgress(0, exp_size + chrom_size, "reading binary data");
@@ -147,6 +253,67 @@ namespace Internal
     return chrom_index_;
   }
 
+  std::streamoff CachedMzMLHandler::readHeader_(std::ifstream& ifs, const String& filename)
+  {
+    int file_identifier = 0;
+    ifs.read((char*)&file_identifier, sizeof(file_identifier));
+    if (file_identifier == CACHED_MZML_FILE_IDENTIFIER)
+    {
+      return sizeof(file_identifier);
+    }
+    if (file_identifier != CACHED_MZML_VERSIONED_FILE_IDENTIFIER)
+    {
+      throw Exception::ParseError(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, 
+        "File might not be a cached mzML file (wrong file magic number). Aborting!", filename);
+    }
+
+    int format_version = 0;
+    ifs.read((char*)&format_version, sizeof(format_version));
+    if (format_version != 2)
+    {
+      throw Exception::ParseError(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, 
+        "Unsupported cached mzML format version " + String(format_version) + ". Aborting!", filename);
+    }
+    return sizeof(file_identifier) + sizeof(format_version);
+  }
+
+  void CachedMzMLHandler::readIndexV2_(std::ifstream& ifs, const String& filename)
+  {
+    Size index_offset, exp_size, chrom_size;
+
+    ifs.seekg(0, ifs.end);
+    const std::streamoff file_size = ifs.tellg();
+    const std::streamoff footer_size = sizeof(index_offset) + sizeof(exp_size) + sizeof(chrom_size);
+    if (file_size < footer_size)
+    {
+      throw Exception::ParseError(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, 
+        "File is too small to be a cached mzML file. Aborting!", filename);
+    }
+
+    ifs.seekg(file_size - footer_size, ifs.beg);
+    ifs.read((char*)&index_offset, sizeof(index_offset));
+    ifs.read((char*)&exp_size, sizeof(exp_size));
+    ifs.read((char*)&chrom_size, sizeof(chrom_size));
+
+    // the offset table has to lie exactly between the data blocks and the footer
+    if (!ifs || static_cast<std::streamoff>(index_offset) > file_size - footer_size ||
+      (file_size - footer_size - static_cast<std::streamoff>(index_offset)) / sizeof(Size) != exp_size + chrom_size)
+    {
+      throw Exception::ParseError(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, 
+        "Invalid offset table in cached mzML file. Aborting!", filename);
+    }
+
+    std::vector<Size> offsets(exp_size + chrom_size);
+    ifs.seekg(index_offset, ifs.beg);
+    if (!offsets.empty())
+    {
+      ifs.read((char*)&offsets[0], offsets.size() * sizeof(offsets[0]));
+    }
+
+    spectra_index_.assign(offsets.begin(), offsets.begin() + exp_size);
+    chrom_index_.assign(offsets.begin() + exp_size, offsets.end());
+  }
+
   void CachedMzMLHandler::createMemdumpIndex(String filename)
   {
     std::ifstream ifs(filename.c_str(), std::ios::binary);
@@ -165,11 +332,13 @@ namespace Internal
     int extra_offset = sizeof(DoubleType) + sizeof(IntType);
     int chrom_offset = 0;
 
-    ifs.read((char*)&file_identifier, sizeof(file_identifier));
-    if (file_identifier != CACHED_MZML_FILE_IDENTIFIER)
+    const std::streamoff header_size = readHeader_(ifs, filename);
+    if (header_size != sizeof(file_identifier))
     {
-      throw Exception::ParseError(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, 
-          "File might not be a cached mzML file (wrong file magic number). Aborting!", filename);
+      // version 2: the offsets of all blocks are stored in the footer
+      readIndexV2_(ifs, filename);
+      ifs.close();
+      return;
     }
 
     // For spectra and chromatograms go through file, read the size of the
@@ -314,15 +483,27 @@ namespace Internal
     MzMLFile().store(out_meta, out_exp);
   }
 
-  std::vector<OpenSwath::BinaryDataArrayPtr> CachedMzMLHandler::readSpectrumFast(std::ifstream& ifs, int& ms_level, double& rt)
+  template <typename InputStreamType>
+  std::vector<OpenSwath::BinaryDataArrayPtr> CachedMzMLHandler::readSpectrumFast_(InputStreamType& ifs, int& ms_level, double& rt)
   {
     std::vector<OpenSwath::BinaryDataArrayPtr> data;
     data.push_back(OpenSwath::BinaryDataArrayPtr(new OpenSwath::BinaryDataArray));
     data.push_back(OpenSwath::BinaryDataArrayPtr(new OpenSwath::BinaryDataArray));
 
+    // version 1: the spectrum starts with its size, version 2: with the block marker
     Size spec_size = -1;
     Size nr_float_arrays = -1;
     ifs.read((char*) &spec_size, sizeof(spec_size));
+    if (spec_size == CACHED_MZML_V2_BLOCK_MARKER)
+    {
+      Size nr_arrays = 0;
+      ifs.read((char*) &nr_arrays, sizeof(nr_arrays));
+      ifs.read((char*) &ms_level, sizeof(ms_level));
+      ifs.read((char*) &rt, sizeof(rt));
+      readDataV2_(ifs, data, nr_arrays);
+      return data;
+    }
+
     ifs.read((char*) &nr_float_arrays, sizeof(nr_float_arrays));
     ifs.read((char*) &ms_level, sizeof(ms_level));
     ifs.read((char*) &rt, sizeof(rt));
@@ -337,7 +518,61 @@ namespace Internal
     return data;
   }
 
-  void CachedMzMLHandler::readDataFast_(std::ifstream& ifs,
+  template <typename InputStreamType>
+  std::vector<OpenSwath::BinaryDataArrayPtr> CachedMzMLHandler::readChromatogramFast_(InputStreamType& ifs)
+  {
+    std::vector<OpenSwath::BinaryDataArrayPtr> data;
+    data.push_back(OpenSwath::BinaryDataArrayPtr(new OpenSwath::BinaryDataArray));
+    data.push_back(OpenSwath::BinaryDataArrayPtr(new OpenSwath::BinaryDataArray));
+
+    // version 1: the chromatogram starts with its size, version 2: with the block marker
+    Size chrom_size = -1;
+    Size nr_float_arrays = -1;
+    ifs.read((char*) &chrom_size, sizeof(chrom_size));
+    if (chrom_size == CACHED_MZML_V2_BLOCK_MARKER)
+    {
+      Size nr_arrays = 0;
+      ifs.read((char*) &nr_arrays, sizeof(nr_arrays));
+      readDataV2_(ifs, data, nr_arrays);
+      return data;
+    }
+
+    ifs.read((char*) &nr_float_arrays, sizeof(nr_float_arrays));
+
+    if (static_cast<int>(chrom_size) < 0)
+    {
+      throw Exception::ParseError(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, 
+        "Read an invalid chromatogram length, something is wrong here. Aborting.", "filestream");
+    }
+
+    readDataFast_(ifs, data, chrom_size, nr_float_arrays);
+    return data;
+  }
+
+  std::vector<OpenSwath::BinaryDataArrayPtr> CachedMzMLHandler::readSpectrumFast(std::ifstream& ifs, int& ms_level, double& rt)
+  {
+    return readSpectrumFast_(ifs, ms_level, rt);
+  }
+
+  std::vector<OpenSwath::BinaryDataArrayPtr> CachedMzMLHandler::readSpectrumFast(const char* buffer, Size buffer_size, int& ms_level, double& rt)
+  {
+    MemoryInputStream ifs(buffer, buffer_size);
+    return readSpectrumFast_(ifs, ms_level, rt);
+  }
+
+  std::vector<OpenSwath::BinaryDataArrayPtr> CachedMzMLHandler::readChromatogramFast(std::ifstream& ifs)
+  {
+    return readChromatogramFast_(ifs);
+  }
+
+  std::vector<OpenSwath::BinaryDataArrayPtr> CachedMzMLHandler::readChromatogramFast(const char* buffer, Size buffer_size)
+  {
+    MemoryInputStream ifs(buffer, buffer_size);
+    return readChromatogramFast_(ifs);
+  }
+
+  template <typename InputStreamType>
+  void CachedMzMLHandler::readDataFast_(InputStreamType& ifs,
                                         std::vector<OpenSwath::BinaryDataArrayPtr>& data,
                                         const Size& data_size,
                                         const Size& nr_float_arrays)
@@ -352,7 +587,7 @@ namespace Internal
     }
     if (nr_float_arrays == 0) return;
 
-    char* buffer = new(std::nothrow) char[1024];
+    char buffer[1024] = "";
     for (Size k = 0; k < nr_float_arrays; k++)
     {
       data.push_back(OpenSwath::BinaryDataArrayPtr(new OpenSwath::BinaryDataArray));
@@ -361,7 +596,7 @@ namespace Internal
       ifs.read((char*)&len_name, sizeof(len_name));
 
       // We will not read data longer than 1024 length as this is user-generated input data
-      if (len_name > 1023) ifs.seekg(len_name * sizeof(char), ifs.cur);
+      if (len_name > 1023) ifs.ignore(len_name * sizeof(char));
       else
       {
         ifs.read(buffer, len_name);
@@ -369,31 +604,106 @@ namespace Internal
       }
       data.back()->data.resize(len);
       data.back()->description = buffer;
-      ifs.read((char*)&(data.back()->data)[0], len * sizeof(DatumSingleton));
+      if (len > 0)
+      {
+        ifs.read((char*)&(data.back()->data)[0], len * sizeof(DatumSingleton));
+      }
     }
-    delete[] buffer;
     return;
   }
 
-  std::vector<OpenSwath::BinaryDataArrayPtr> CachedMzMLHandler::readChromatogramFast(std::ifstream& ifs)
+  template <typename InputStreamType>
+  void CachedMzMLHandler::readDataV2_(InputStreamType& ifs,
+                                      std::vector<OpenSwath::BinaryDataArrayPtr>& data,
+                                      const Size& nr_arrays)
   {
-    std::vector<OpenSwath::BinaryDataArrayPtr> data;
-    data.push_back(OpenSwath::BinaryDataArrayPtr(new OpenSwath::BinaryDataArray));
-    data.push_back(OpenSwath::BinaryDataArrayPtr(new OpenSwath::BinaryDataArray));
-
-    Size chrom_size = -1;
-    Size nr_float_arrays = -1;
-    ifs.read((char*) &chrom_size, sizeof(chrom_size));
-    ifs.read((char*) &nr_float_arrays, sizeof(nr_float_arrays));
-
-    if (static_cast<int>(chrom_size) < 0)
+    if (nr_arrays < 2 || nr_arrays > 1024)
     {
       throw Exception::ParseError(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, 
-        "Read an invalid chromatogram length, something is wrong here. Aborting.", "filestream");
+        "Read an invalid number of data arrays (" + String(nr_arrays) + "), something is wrong here. Aborting.", "filestream");
     }
 
-    readDataFast_(ifs, data, chrom_size, nr_float_arrays);
-    return data;
+    std::string bytes;
+    for (Size k = 0; k < nr_arrays; k++)
+    {
+      if (k >= 2) data.push_back(OpenSwath::BinaryDataArrayPtr(new OpenSwath::BinaryDataArray));
+      OpenSwath::BinaryDataArrayPtr& array = data[k];
+
+      unsigned char encoding = SIZE_OF_ARRAYENCODING;
+      unsigned char zlib_compressed = 0;
+      Size len_name = 0, nr_values = 0, nr_bytes = 0;
+      ifs.read((char*)&encoding, sizeof(encoding));
+      ifs.read((char*)&zlib_compressed, sizeof(zlib_compressed));
+      ifs.read((char*)&len_name, sizeof(len_name));
+      if (encoding >= SIZE_OF_ARRAYENCODING || len_name > 1023)
+      {
+        throw Exception::ParseError(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, 
+          "Read an invalid data array header, something is wrong here. Aborting.", "filestream");
+      }
+      array->description.resize(len_name);
+      if (len_name > 0) ifs.read(&array->description[0], len_name);
+      ifs.read((char*)&nr_values, sizeof(nr_values));
+      ifs.read((char*)&nr_bytes, sizeof(nr_bytes));
+
+      // fast path: uncompressed doubles are read directly into the output
+      if (encoding == ENCODING_DOUBLE && !zlib_compressed)
+      {
+        if (nr_bytes != nr_values * sizeof(DatumSingleton))
+        {
+          throw Exception::ParseError(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, 
+            "Read an invalid data array length, something is wrong here. Aborting.", "filestream");
+        }
+        array->data.resize(nr_values);
+        if (nr_values > 0) ifs.read((char*)&(array->data)[0], nr_bytes);
+        continue;
+      }
+
+      bytes.resize(nr_bytes);
+      if (nr_bytes > 0) ifs.read(&bytes[0], nr_bytes);
+      if (zlib_compressed)
+      {
+        std::string uncompressed;
+        ZlibCompression::uncompressString(bytes.data(), bytes.size(), uncompressed);
+        bytes.swap(uncompressed);
+      }
+
+      if (encoding == ENCODING_DOUBLE || encoding == ENCODING_FLOAT)
+      {
+        const Size value_size = (encoding == ENCODING_DOUBLE ? sizeof(double) : sizeof(float));
+        if (bytes.size() != nr_values * value_size)
+        {
+          throw Exception::ParseError(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, 
+            "Read an invalid data array length, something is wrong here. Aborting.", "filestream");
+        }
+        array->data.resize(nr_values);
+        if (nr_values == 0) continue;
+        if (encoding == ENCODING_DOUBLE)
+        {
+          std::memcpy(&(array->data)[0], bytes.data(), bytes.size());
+        }
+        else
+        {
+          std::vector<float> tmp(nr_values);
+          std::memcpy(&tmp[0], bytes.data(), bytes.size());
+          std::copy(tmp.begin(), tmp.end(), array->data.begin());
+        }
+      }
+      else
+      {
+        MSNumpressCoder::NumpressConfig config;
+        if (encoding == ENCODING_NUMPRESS_LINEAR) config.np_compression = MSNumpressCoder::LINEAR;
+        else if (encoding == ENCODING_NUMPRESS_PIC) config.np_compression = MSNumpressCoder::PIC;
+        else config.np_compression = MSNumpressCoder::SLOF;
+
+        array->data.clear();
+        if (!bytes.empty()) MSNumpressCoder().decodeNPRaw(bytes, array->data, config);
+        if (array->data.size() != nr_values)
+        {
+          throw Exception::ParseError(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, 
+            "Decoded " + String(array->data.size()) + " instead of " + String(nr_values) + " values, something is wrong here. Aborting.", "filestream");
+        }
+      }
+    }
   }
 
   void CachedMzMLHandler::readSpectrum(SpectrumType& spectrum, std::ifstream& ifs)
@@ -401,6 +711,31 @@ namespace Internal
     int ms_level;
     double rt;
     std::vector<OpenSwath::BinaryDataArrayPtr> data = readSpectrumFast(ifs, ms_level, rt);
+    fillSpectrum_(spectrum, data, ms_level, rt);
+  }
+
+  void CachedMzMLHandler::readSpectrum(SpectrumType& spectrum, const char* buffer, Size buffer_size)
+  {
+    int ms_level;
+    double rt;
+    std::vector<OpenSwath::BinaryDataArrayPtr> data = readSpectrumFast(buffer, buffer_size, ms_level, rt);
+    fillSpectrum_(spectrum, data, ms_level, rt);
+  }
+
+  void CachedMzMLHandler::readChromatogram(ChromatogramType& chromatogram, std::ifstream& ifs)
+  {
+    std::vector<OpenSwath::BinaryDataArrayPtr> data = readChromatogramFast(ifs);
+    fillChromatogram_(chromatogram, data);
+  }
+
+  void CachedMzMLHandler::readChromatogram(ChromatogramType& chromatogram, const char* buffer, Size buffer_size)
+  {
+    std::vector<OpenSwath::BinaryDataArrayPtr> data = readChromatogramFast(buffer, buffer_size);
+    fillChromatogram_(chromatogram, data);
+  }
+
+  void CachedMzMLHandler::fillSpectrum_(SpectrumType& spectrum, const std::vector<OpenSwath::BinaryDataArrayPtr>& data, int ms_level, double rt)
+  {
     spectrum.reserve(data[0]->data.size());
     spectrum.setMSLevel(ms_level);
     spectrum.setRT(rt);
@@ -422,9 +757,8 @@ namespace Internal
     }
   }
 
-  void CachedMzMLHandler::readChromatogram(ChromatogramType& chromatogram, std::ifstream& ifs)
+  void CachedMzMLHandler::fillChromatogram_(ChromatogramType& chromatogram, const std::vector<OpenSwath::BinaryDataArrayPtr>& data)
   {
-    std::vector<OpenSwath::BinaryDataArrayPtr> data = readChromatogramFast(ifs);
     chromatogram.reserve(data[0]->data.size());
 
     for (Size j = 0; j < data[0]->data.size(); j++)
@@ -440,7 +774,7 @@ namespace Internal
     {
       MSChromatogram::FloatDataArray fda;
       fda.reserve(data[j]->data.size());
-      for (const auto& k : fda) fda.push_back(k);
+      for (const auto& k : data[j]->data) fda.push_back(k);
       fda.setName(data[j]->description);
       fdas.push_back(fda);
     }
@@ -449,6 +783,12 @@ namespace Internal
 
   void CachedMzMLHandler::writeSpectrum_(const SpectrumType& spectrum, std::ofstream& ofs) const
   {
+    if (storage_options_.format_version != 1)
+    {
+      writeSpectrumV2_(spectrum, ofs);
+      return;
+    }
+
     Size exp_size = spectrum.size();
     ofs.write((char*)&exp_size, sizeof(exp_size));
     Size arr_s = spectrum.getFloatDataArrays().size() + spectrum.getIntegerDataArrays().size();
@@ -509,6 +849,12 @@ namespace Internal
 
   void CachedMzMLHandler::writeChromatogram_(const ChromatogramType& chromatogram, std::ofstream& ofs) const
   {
+    if (storage_options_.format_version != 1)
+    {
+      writeChromatogramV2_(chromatogram, ofs);
+      return;
+    }
+
     Size exp_size = chromatogram.size();
     ofs.write((char*)&exp_size, sizeof(exp_size));
     Size arr_s = chromatogram.getFloatDataArrays().size() + chromatogram.getIntegerDataArrays().size();
@@ -562,6 +908,144 @@ namespace Internal
     }
   }
 
+  namespace
+  {
+    /// array encoding for a numpress configuration (or @p fallback if numpress is not used)
+    CachedMzMLHandler::ArrayEncoding getEncoding_(const MSNumpressCoder::NumpressConfig& np_config,
+      CachedMzMLHandler::ArrayEncoding fallback)
+    {
+      switch (np_config.np_compression)
+      {
+        case MSNumpressCoder::LINEAR: return CachedMzMLHandler::ENCODING_NUMPRESS_LINEAR;
+        case MSNumpressCoder::PIC: return CachedMzMLHandler::ENCODING_NUMPRESS_PIC;
+        case MSNumpressCoder::SLOF: return CachedMzMLHandler::ENCODING_NUMPRESS_SLOF;
+        default: return fallback;
+      }
+    }
+  }
+
+  void CachedMzMLHandler::writeSpectrumV2_(const SpectrumType& spectrum, std::ofstream& ofs) const
+  {
+    Size marker = CACHED_MZML_V2_BLOCK_MARKER;
+    ofs.write((char*)&marker, sizeof(marker));
+    Size nr_arrays = 2 + spectrum.getFloatDataArrays().size() + spectrum.getIntegerDataArrays().size();
+    ofs.write((char*)&nr_arrays, sizeof(nr_arrays));
+    IntType int_field_ = spectrum.getMSLevel();
+    ofs.write((char*)&int_field_, sizeof(int_field_));
+    DoubleType dbl_field_ = spectrum.getRT();
+    ofs.write((char*)&dbl_field_, sizeof(dbl_field_));
+
+    Datavector mz_data;
+    Datavector int_data;
+    mz_data.reserve(spectrum.size());
+    int_data.reserve(spectrum.size());
+    for (Size j = 0; j < spectrum.size(); j++)
+    {
+      mz_data.push_back(spectrum[j].getMZ());
+      int_data.push_back(static_cast<double>(spectrum[j].getIntensity()));
+    }
+
+    // peak intensities are single precision, storing them as float is lossless
+    writeArrayV2_(ofs, "", mz_data, getEncoding_(storage_options_.np_config_mass_time, ENCODING_DOUBLE), storage_options_.np_config_mass_time);
+    writeArrayV2_(ofs, "", int_data, getEncoding_(storage_options_.np_config_intensity, ENCODING_FLOAT), storage_options_.np_config_intensity);
+
+    Datavector tmp;
+    for (const auto& fda : spectrum.getFloatDataArrays() )
+    {
+      tmp.assign(fda.begin(), fda.end());
+      writeArrayV2_(ofs, fda.getName(), tmp, ENCODING_FLOAT, MSNumpressCoder::NumpressConfig());
+    }
+    for (const auto& ida : spectrum.getIntegerDataArrays() )
+    {
+      tmp.assign(ida.begin(), ida.end());
+      writeArrayV2_(ofs, ida.getName(), tmp, ENCODING_DOUBLE, MSNumpressCoder::NumpressConfig());
+    }
+  }
+
+  void CachedMzMLHandler::writeChromatogramV2_(const ChromatogramType& chromatogram, std::ofstream& ofs) const
+  {
+    Size marker = CACHED_MZML_V2_BLOCK_MARKER;
+    ofs.write((char*)&marker, sizeof(marker));
+    Size nr_arrays = 2 + chromatogram.getFloatDataArrays().size() + chromatogram.getIntegerDataArrays().size();
+    ofs.write((char*)&nr_arrays, sizeof(nr_arrays));
+
+    Datavector rt_data;
+    Datavector int_data;
+    rt_data.reserve(chromatogram.size());
+    int_data.reserve(chromatogram.size());
+    for (Size j = 0; j < chromatogram.size(); j++)
+    {
+      rt_data.push_back(chromatogram[j].getRT());
+      int_data.push_back(chromatogram[j].getIntensity());
+    }
+
+    // chromatogram intensities are double precision, keep them unless numpress is requested
+    writeArrayV2_(ofs, "", rt_data, getEncoding_(storage_options_.np_config_mass_time, ENCODING_DOUBLE), storage_options_.np_config_mass_time);
+    writeArrayV2_(ofs, "", int_data, getEncoding_(storage_options_.np_config_intensity, ENCODING_DOUBLE), storage_options_.np_config_intensity);
+
+    Datavector tmp;
+    for (const auto& fda : chromatogram.getFloatDataArrays() )
+    {
+      tmp.assign(fda.begin(), fda.end());
+      writeArrayV2_(ofs, fda.getName(), tmp, ENCODING_FLOAT, MSNumpressCoder::NumpressConfig());
+    }
+    for (const auto& ida : chromatogram.getIntegerDataArrays() )
+    {
+      tmp.assign(ida.begin(), ida.end());
+      writeArrayV2_(ofs, ida.getName(), tmp, ENCODING_DOUBLE, MSNumpressCoder::NumpressConfig());
+    }
+  }
+
+  void CachedMzMLHandler::writeArrayV2_(std::ofstream& ofs, const String& name, const std::vector<double>& data,
+    ArrayEncoding encoding, const MSNumpressCoder::NumpressConfig& np_config) const
+  {
+    std::string bytes;
+    if (encoding == ENCODING_NUMPRESS_LINEAR || encoding == ENCODING_NUMPRESS_PIC || encoding == ENCODING_NUMPRESS_SLOF)
+    {
+      String result;
+      if (!data.empty()) MSNumpressCoder().encodeNPRaw(data, result, np_config);
+      // numpress leaves the result empty if the error tolerance cannot be met
+      if (result.empty()) encoding = ENCODING_DOUBLE;
+      else bytes = result;
+    }
+
+    if (encoding == ENCODING_FLOAT)
+    {
+      std::vector<float> tmp(data.begin(), data.end());
+      bytes.assign(reinterpret_cast<const char*>(tmp.data()), tmp.size() * sizeof(float));
+    }
+    else if (encoding == ENCODING_DOUBLE)
+    {
+      bytes.assign(reinterpret_cast<const char*>(data.data()), data.size() * sizeof(double));
+    }
+
+    // only keep the compressed data if it is actually smaller
+    unsigned char zlib_compressed = 0;
+    if (storage_options_.zlib_compression && !bytes.empty())
+    {
+      std::string compressed;
+      ZlibCompression::compressString(bytes, compressed);
+      if (compressed.size() < bytes.size())
+      {
+        bytes.swap(compressed);
+        zlib_compressed = 1;
+      }
+    }
+
+    // names longer than 1023 characters are not read back (user-generated input data)
+    unsigned char enc = static_cast<unsigned char>(encoding);
+    Size len_name = std::min(name.size(), Size(1023));
+    Size nr_values = data.size();
+    Size nr_bytes = bytes.size();
+    ofs.write((char*)&enc, sizeof(enc));
+    ofs.write((char*)&zlib_compressed, sizeof(zlib_compressed));
+    ofs.write((char*)&len_name, sizeof(len_name));
+    ofs.write(name.c_str(), len_name);
+    ofs.write((char*)&nr_values, sizeof(nr_values));
+    ofs.write((char*)&nr_bytes, sizeof(nr_bytes));
+    ofs.write(bytes.data(), nr_bytes);
+  }
+
 }
 }
 
@@ -99,7 +99,11 @@ namespace OpenMS
     {
       throw Exception::FileNotFound(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, filename);
     }
+    return parseOffsets(f, indexoffset, spectra_offsets, chromatograms_offsets);
+  }
 
+  int IndexedMzMLDecoder::parseOffsets(std::istream& f, std::streampos indexoffset, OffsetVector& spectra_offsets, OffsetVector& chromatograms_offsets)
+  {
     // get length of file:
     f.seekg(0, f.end);
     std::streampos length = f.tellg();
@@ -149,9 +153,6 @@ namespace OpenMS
 
   std::streampos IndexedMzMLDecoder::findIndexListOffset(String filename, int buffersize)
   {
-    // return value
-    std::streampos indexoffset = -1;
-
     //-------------------------------------------------------------
     // Open file, jump to end and read last n bytes into buffer.
     //-------------------------------------------------------------
@@ -162,6 +163,18 @@ namespace OpenMS
       throw Exception::FileNotFound(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, filename);
     }
 
+#ifdef DEBUG_READER
+    std::cout << " reading file " << filename  << " with size " << buffersize << std::endl;
+#endif
+
+    return findIndexListOffset(f, buffersize);
+  }
+
+  std::streampos IndexedMzMLDecoder::findIndexListOffset(std::istream& f, int buffersize)
+  {
+    // return value
+    std::streampos indexoffset = -1;
+
     // Read the last few bytes and hope our offset is there to be found
     char* buffer = new char[buffersize + 1];
     f.seekg(-buffersize, f.end);
@@ -169,7 +182,6 @@ namespace OpenMS
     buffer[buffersize] = '\0';
 
 #ifdef DEBUG_READER
-    std::cout << " reading file " << filename  << " with size " << buffersize << std::endl;
     std::cout << buffer << std::endl;
 #endif
 
@@ -192,7 +204,6 @@ namespace OpenMS
         std::cerr << "Corrupted / unreadable value in <indexListOffset> : " << thismatch << std::endl;
         // free resources and re-throw
         delete[] buffer;
-        f.close();
         throw;  // re-throw conversion error
       }
     }
@@ -203,7 +214,6 @@ namespace OpenMS
       std::cerr << buffer << std::endl;
     }
 
-    f.close();
     delete[] buffer;
 
     return indexoffset;
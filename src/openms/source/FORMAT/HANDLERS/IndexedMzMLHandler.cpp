@@ -36,6 +36,12 @@
 
 #include <OpenMS/FORMAT/HANDLERS/IndexedMzMLDecoder.h>
 #include <OpenMS/FORMAT/HANDLERS/MzMLSpectrumDecoder.h>
+#include <OpenMS/FORMAT/MzMLFile.h>
+#include <OpenMS/KERNEL/MSExperiment.h>
+#include <OpenMS/SYSTEM/RemoteFile.h>
+
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
 
 // #define DEBUG_READER
 
@@ -44,19 +50,42 @@ namespace OpenMS
 namespace Internal
 {
 
+  namespace
+  {
+    // XMLFile initializes xerces for every parse, which is not thread-safe
+    std::mutex xml_parse_mutex;
+  }
+
   void IndexedMzMLHandler::parseFooter_(String filename)
   {
     //-------------------------------------------------------------
     // Find offset
     //-------------------------------------------------------------
 
-    index_offset_ = IndexedMzMLDecoder().findIndexListOffset(filename);
-    if (index_offset_ == (std::streampos)-1)
+    int res = -1;
+    if (remote_file_)
     {
-      parsing_success_ = false;
-      return;
+      // only the footer is read (using the block cache of the remote file)
+      RemoteFileStream in(remote_file_);
+      index_offset_ = IndexedMzMLDecoder().findIndexListOffset(in);
+      if (index_offset_ == (std::streampos)-1)
+      {
+        parsing_success_ = false;
+        return;
+      }
+      in.clear();
+      res = IndexedMzMLDecoder().parseOffsets(in, index_offset_, spectra_offsets_, chromatograms_offsets_);
+    }
+    else
+    {
+      index_offset_ = IndexedMzMLDecoder().findIndexListOffset(filename);
+      if (index_offset_ == (std::streampos)-1)
+      {
+        parsing_success_ = false;
+        return;
+      }
+      res = IndexedMzMLDecoder().parseOffsets(filename, index_offset_, spectra_offsets_, chromatograms_offsets_);
     }
-    int res = IndexedMzMLDecoder().parseOffsets(filename, index_offset_, spectra_offsets_, chromatograms_offsets_);
 
     spectra_before_chroms_ = true;
     if (!spectra_offsets_.empty() && !chromatograms_offsets_.empty())
@@ -69,6 +98,77 @@ namespace Internal
     else parsing_success_ = false;
   }
 
+  std::string IndexedMzMLHandler::listStartTag_(const std::string& name, std::streampos offset, std::streampos& tag_offset)
+  {
+    // the start tag directly precedes the first element of the list
+    const std::streampos begin = offset - std::streampos(std::min<std::streamoff>(offset, 4096));
+    const std::string text = readRange_(begin, offset);
+    const Size pos = text.rfind("<" + name);
+    const Size end = pos == std::string::npos ? pos : text.find('>', pos);
+    if (end == std::string::npos) return std::string();
+    tag_offset = begin + std::streamoff(pos);
+
+    // a single element is parsed at a time
+    std::string tag = text.substr(pos, end + 1 - pos);
+    const Size count_pos = tag.find("count=\"");
+    const Size count_end = count_pos == std::string::npos ? count_pos : tag.find('"', count_pos + 7);
+    if (count_end != std::string::npos) tag.replace(count_pos + 7, count_end - count_pos - 7, "1");
+    return tag;
+  }
+
+  void IndexedMzMLHandler::parseHeader_()
+  {
+    xml_prefix_.clear();
+    spectrum_list_tag_.clear();
+    chromatogram_list_tag_.clear();
+    if (!parsing_success_) return;
+
+    std::streamoff prefix_end = index_offset_;
+    std::streampos tag_offset;
+    if (!spectra_offsets_.empty())
+    {
+      spectrum_list_tag_ = listStartTag_("spectrumList", spectra_offsets_[0].second, tag_offset);
+      if (spectrum_list_tag_.empty()) return;
+      prefix_end = std::min<std::streamoff>(prefix_end, tag_offset);
+    }
+    if (!chromatograms_offsets_.empty())
+    {
+      chromatogram_list_tag_ = listStartTag_("chromatogramList", chromatograms_offsets_[0].second, tag_offset);
+      if (chromatogram_list_tag_.empty())
+      {
+        spectrum_list_tag_.clear();
+        return;
+      }
+      prefix_end = std::min<std::streamoff>(prefix_end, tag_offset);
+    }
+
+    // document up to the first list, ends inside of the <run> element
+    xml_prefix_ = readRange_(0, prefix_end);
+    xml_closing_ = "</run>\n</mzML>\n";
+    if (xml_prefix_.find("<indexedmzML") != std::string::npos) xml_closing_ += "</indexedmzML>\n";
+  }
+
+  void IndexedMzMLHandler::parseMetaData_(const std::string& document, MSExperiment& exp) const
+  {
+    MzMLFile f;
+    PeakFileOptions options = f.getOptions();
+    options.setFillData(false);
+    f.setOptions(options);
+    std::lock_guard<std::mutex> lock(xml_parse_mutex);
+    f.loadBuffer(document, exp);
+  }
+
+  void IndexedMzMLHandler::getExperimentalSettings(ExperimentalSettings& settings) const
+  {
+    if (xml_prefix_.empty())
+    {
+      throw Exception::ParseError(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, filename_, "Could not extract the header of the file.");
+    }
+    PeakMap exp;
+    parseMetaData_(xml_prefix_ + xml_closing_, exp);
+    settings = exp.getExperimentalSettings();
+  }
+
   IndexedMzMLHandler::IndexedMzMLHandler(const String& filename) :
     parsing_success_(false),
     skip_xml_checks_(false) 
@@ -87,12 +187,23 @@ namespace Internal
     chromatograms_offsets_(source.chromatograms_offsets_),
     index_offset_(source.index_offset_),
     spectra_before_chroms_(source.spectra_before_chroms_),
-    // do not copy the filestream itself but open a new filestream using the same file
-    // this is critical for parallel access to the same file!
-    filestream_(source.filename_.c_str()),
+    filestream_(),
+    filestream_mutex_(),
+    mapped_region_(source.mapped_region_),
+    remote_file_(source.remote_file_),
+    xml_prefix_(source.xml_prefix_),
+    spectrum_list_tag_(source.spectrum_list_tag_),
+    chromatogram_list_tag_(source.chromatogram_list_tag_),
+    xml_closing_(source.xml_closing_),
     parsing_success_(source.parsing_success_),
     skip_xml_checks_(source.skip_xml_checks_)
   {
+    // do not copy the filestream itself but open a new filestream using the same file
+    // (not needed if the memory mapping or the remote file can be shared)
+    if (!mapped_region_ && !remote_file_)
+    {
+      filestream_.open(source.filename_.c_str());
+    }
   }
 
   IndexedMzMLHandler::~IndexedMzMLHandler()
@@ -106,8 +217,72 @@ namespace Internal
       filestream_.close();
     }
     filename_ = filename;
-    filestream_.open(filename.c_str());
+    spectra_offsets_.clear();
+    chromatograms_offsets_.clear();
+
+    mapped_region_.reset();
+    remote_file_.reset();
+    if (RemoteFile::isRemote(filename))
+    {
+      remote_file_.reset(new RemoteFile(filename));
+      parseFooter_(filename);
+      parseHeader_();
+      return;
+    }
+
+    // map the file into memory, fall back to a file stream if this fails
+    try
+    {
+      boost::interprocess::file_mapping mapping(filename.c_str(), boost::interprocess::read_only);
+      mapped_region_.reset(new boost::interprocess::mapped_region(mapping, boost::interprocess::read_only));
+      // the file is read in random order, no read-ahead needed
+      mapped_region_->advise(boost::interprocess::mapped_region::advice_random);
+    }
+    catch (boost::interprocess::interprocess_exception& /* e */)
+    {
+      mapped_region_.reset();
+    }
+
+    if (!mapped_region_)
+    {
+      filestream_.open(filename.c_str());
+    }
     parseFooter_(filename);
+    parseHeader_();
+  }
+
+  std::string IndexedMzMLHandler::readRange_(std::streampos startidx, std::streampos endidx)
+  {
+    if (mapped_region_)
+    {
+      const std::streamoff file_size = mapped_region_->get_size();
+      const std::streamoff start = std::min<std::streamoff>(startidx, file_size);
+      const std::streamoff end = std::min<std::streamoff>(std::max<std::streamoff>(endidx, start), file_size);
+      const char* data = static_cast<const char*>(mapped_region_->get_address());
+      // stop at the first null byte (same as reading from the file stream)
+      const char* end_ptr = std::find(data + start, data + end, '\0');
+      return std::string(data + start, end_ptr);
+    }
+
+    if (remote_file_)
+    {
+      const Size start = std::max<std::streamoff>(startidx, 0);
+      const Size end = std::max<std::streamoff>(endidx, start);
+      std::string text = remote_file_->read(start, end - start);
+      // stop at the first null byte (same as reading from the file stream)
+      text.erase(std::find(text.begin(), text.end(), '\0'), text.end());
+      return text;
+    }
+
+    std::lock_guard<std::mutex> lock(filestream_mutex_);
+    std::streampos readl = endidx - startidx;
+    char* buffer = new char[readl + std::streampos(1)];
+    filestream_.seekg(startidx, filestream_.beg);
+    filestream_.read(buffer, readl);
+    buffer[readl] = '\0';
+    std::string text(buffer);
+    delete[] buffer;
+    return text;
   }
 
   bool IndexedMzMLHandler::getParsingSuccess() const
@@ -125,34 +300,39 @@ namespace Internal
     return chromatograms_offsets_.size();
   }
 
-  std::string IndexedMzMLHandler::getChromatogramById_helper_(int id)
+  std::pair<std::streampos, std::streampos> IndexedMzMLHandler::getChromatogramRange_(int id) const
   {
-    int chromToGet = id;
+    std::streampos startidx = chromatograms_offsets_[id].second;
+    std::streampos endidx = -1;
 
-    if (!parsing_success_)
-    {
-      throw Exception::ParseError(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, 
-          "Parsing was unsuccessful, cannot read file", "");
-    }
-    if (chromToGet < 0)
+    if (id == int(getNrChromatograms() - 1))
     {
-      throw Exception::IllegalArgument(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, 
-          String( "id needs to be positive, was " + String(id) ));
+      if (spectra_offsets_.empty() || spectra_before_chroms_)
+      {
+        // just take everything until the index starts
+        endidx = index_offset_;
+      }
+      else
+      {
+        // just take everything until the chromatograms start
+        endidx = spectra_offsets_[0].second;
+      }
     }
-    if (chromToGet >= (int)getNrChromatograms())
+    else
     {
-      throw Exception::IllegalArgument(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, String( 
-            "id needs to be smaller than the number of spectra, was " + String(id) 
-            + " maximal allowed is " + String(getNrSpectra()) ));
+      endidx = chromatograms_offsets_[id + 1].second;
     }
+    return std::make_pair(startidx, endidx);
+  }
 
-    std::streampos startidx = -1;
+  std::pair<std::streampos, std::streampos> IndexedMzMLHandler::getSpectrumRange_(int id) const
+  {
+    std::streampos startidx = spectra_offsets_[id].second;
     std::streampos endidx = -1;
 
-    if (chromToGet == int(getNrChromatograms() - 1))
+    if (id == int(getNrSpectra() - 1))
     {
-      startidx = chromatograms_offsets_[chromToGet].second;
-      if (spectra_offsets_.empty() || spectra_before_chroms_)
+      if (chromatograms_offsets_.empty() || !spectra_before_chroms_)
       {
         // just take everything until the index starts
         endidx = index_offset_;
@@ -160,22 +340,65 @@ namespace Internal
       else
       {
         // just take everything until the chromatograms start
-        endidx = spectra_offsets_[0].second;
+        endidx = chromatograms_offsets_[0].second;
       }
     }
     else
     {
-      startidx = chromatograms_offsets_[chromToGet].second;
-      endidx = chromatograms_offsets_[chromToGet + 1].second;
+      endidx = spectra_offsets_[id + 1].second;
     }
+    return std::make_pair(startidx, endidx);
+  }
 
-    std::streampos readl = endidx - startidx;
-    char* buffer = new char[readl + std::streampos(1)];
-    filestream_.seekg(startidx, filestream_.beg);
-    filestream_.read(buffer, readl);
-    buffer[readl] = '\0';
-    std::string text(buffer);
-    delete[] buffer;
+  void IndexedMzMLHandler::prefetch(const std::vector<int>& spectra, const std::vector<int>& chromatograms)
+  {
+    // local files are memory-mapped, nothing to do
+    if (!remote_file_ || !parsing_success_) return;
+
+    std::vector<std::pair<Size, Size> > ranges;
+    for (int id : spectra)
+    {
+      if (id < 0 || id >= (int)getNrSpectra()) continue;
+      const std::pair<std::streampos, std::streampos> range = getSpectrumRange_(id);
+      ranges.push_back(std::make_pair((Size)range.first, (Size)range.second));
+    }
+    for (int id : chromatograms)
+    {
+      if (id < 0 || id >= (int)getNrChromatograms()) continue;
+      const std::pair<std::streampos, std::streampos> range = getChromatogramRange_(id);
+      ranges.push_back(std::make_pair((Size)range.first, (Size)range.second));
+    }
+    remote_file_->prefetch(ranges);
+  }
+
+  bool IndexedMzMLHandler::isRemote() const
+  {
+    return remote_file_.get() != nullptr;
+  }
+
+  std::string IndexedMzMLHandler::getChromatogramById_helper_(int id)
+  {
+    int chromToGet = id;
+
+    if (!parsing_success_)
+    {
+      throw Exception::ParseError(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, 
+          "Parsing was unsuccessful, cannot read file", "");
+    }
+    if (chromToGet < 0)
+    {
+      throw Exception::IllegalArgument(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, 
+          String( "id needs to be positive, was " + String(id) ));
+    }
+    if (chromToGet >= (int)getNrChromatograms())
+    {
+      throw Exception::IllegalArgument(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, String( 
+            "id needs to be smaller than the number of spectra, was " + String(id) 
+            + " maximal allowed is " + String(getNrSpectra()) ));
+    }
+
+    const std::pair<std::streampos, std::streampos> range = getChromatogramRange_(chromToGet);
+    std::string text = readRange_(range.first, range.second);
 
 #ifdef DEBUG_READER
     // print the full text we just read
@@ -206,36 +429,8 @@ namespace Internal
             + " maximal allowed is " + String(getNrSpectra()) ));
     }
 
-    std::streampos startidx = -1;
-    std::streampos endidx = -1;
-
-    if (spectrumToGet == int(getNrSpectra() - 1))
-    {
-      startidx = spectra_offsets_[spectrumToGet].second;
-      if (chromatograms_offsets_.empty() || !spectra_before_chroms_)
-      {
-        // just take everything until the index starts
-        endidx = index_offset_;
-      }
-      else
-      {
-        // just take everything until the chromatograms start
-        endidx = chromatograms_offsets_[0].second;
-      }
-    }
-    else
-    {
-      startidx = spectra_offsets_[spectrumToGet].second;
-      endidx = spectra_offsets_[spectrumToGet + 1].second;
-    }
-
-    std::streampos readl = endidx - startidx;
-    char* buffer = new char[readl + std::streampos(1)];
-    filestream_.seekg(startidx, filestream_.beg);
-    filestream_.read(buffer, readl);
-    buffer[readl] = '\0';
-    std::string text(buffer);
-    delete[] buffer;
+    const std::pair<std::streampos, std::streampos> range = getSpectrumRange_(spectrumToGet);
+    std::string text = readRange_(range.first, range.second);
 
 #ifdef DEBUG_READER
     // print the full text we just read
@@ -266,6 +461,26 @@ namespace Internal
     MzMLSpectrumDecoder(skip_xml_checks_).domParseSpectrum(text, s);
   }
 
+  void IndexedMzMLHandler::getMSSpectrumWithMetaDataById(int id, MSSpectrum& s)
+  {
+    std::string text = IndexedMzMLHandler::getSpectrumById_helper_(id);
+    const Size end = text.rfind("</spectrum>");
+    if (spectrum_list_tag_.empty() || end == std::string::npos)
+    {
+      throw Exception::ParseError(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, filename_, "Could not extract spectrum " + String(id) + ".");
+    }
+    text.resize(end + 11);
+
+    PeakMap exp;
+    parseMetaData_(xml_prefix_ + spectrum_list_tag_ + "\n" + text + "\n</spectrumList>\n" + xml_closing_, exp);
+    if (exp.size() != 1)
+    {
+      throw Exception::ParseError(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, filename_, "Could not parse spectrum " + String(id) + ".");
+    }
+    s = std::move(exp[0]);
+    MzMLSpectrumDecoder(skip_xml_checks_).domParseSpectrum(text, s);
+  }
+
   OpenMS::Interfaces::ChromatogramPtr IndexedMzMLHandler::getChromatogramById(int id)
   {
     OpenMS::Interfaces::ChromatogramPtr cptr(new OpenMS::Interfaces::Chromatogram);
@@ -287,5 +502,25 @@ namespace Internal
     MzMLSpectrumDecoder(skip_xml_checks_).domParseChromatogram(text, c);
   }
 
+  void IndexedMzMLHandler::getMSChromatogramWithMetaDataById(int id, MSChromatogram& c)
+  {
+    std::string text = IndexedMzMLHandler::getChromatogramById_helper_(id);
+    const Size end = text.rfind("</chromatogram>");
+    if (chromatogram_list_tag_.empty() || end == std::string::npos)
+    {
+      throw Exception::ParseError(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, filename_, "Could not extract chromatogram " + String(id) + ".");
+    }
+    text.resize(end + 15);
+
+    PeakMap exp;
+    parseMetaData_(xml_prefix_ + chromatogram_list_tag_ + "\n" + text + "\n</chromatogramList>\n" + xml_closing_, exp);
+    if (exp.getNrChromatograms() != 1)
+    {
+      throw Exception::ParseError(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, filename_, "Could not parse chromatogram " + String(id) + ".");
+    }
+    c = std::move(exp.getChromatograms()[0]);
+    MzMLSpectrumDecoder(skip_xml_checks_).domParseChromatogram(text, c);
+  }
+
 }
 }
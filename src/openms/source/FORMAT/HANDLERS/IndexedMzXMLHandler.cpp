@@ -0,0 +1,385 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2018.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: Timo Sachsenberg $
+// $Authors: Timo Sachsenberg $
+// --------------------------------------------------------------------------
+
+#include <OpenMS/FORMAT/HANDLERS/IndexedMzXMLHandler.h>
+
+#include <OpenMS/FORMAT/HANDLERS/MzXMLHandler.h>
+#include <OpenMS/SYSTEM/File.h>
+#include <OpenMS/FORMAT/XMLFile.h>
+#include <OpenMS/KERNEL/MSExperiment.h>
+
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+
+#include <algorithm>
+#include <cstdlib>
+
+// #define DEBUG_READER
+
+namespace OpenMS
+{
+namespace Internal
+{
+
+  namespace
+  {
+    /// Gives access to XMLFile::parseBuffer_ for parsing the assembled scans
+    class MzXMLBufferParser :
+      public XMLFile
+    {
+  public:
+      MzXMLBufferParser() :
+        XMLFile("/SCHEMAS/mzXML_idx_3.1.xsd", "3.1")
+      {
+      }
+
+      void parse(const std::string& buffer, XMLHandler* handler)
+      {
+        parseBuffer_(buffer, handler);
+      }
+    };
+
+    /// Number of bytes at the end of the file that are searched for <indexOffset>
+    const std::streamoff INDEX_OFFSET_SEARCH_LENGTH = 1024;
+  }
+
+  void IndexedMzXMLHandler::parseIndex_()
+  {
+    parsing_success_ = false;
+    spectra_offsets_.clear();
+    spectra_ends_.clear();
+    header_.clear();
+
+    std::streamoff file_size = 0;
+    if (mapped_region_)
+    {
+      file_size = mapped_region_->get_size();
+    }
+    else
+    {
+      if (!filestream_.is_open()) return;
+      filestream_.seekg(0, filestream_.end);
+      file_size = filestream_.tellg();
+    }
+    if (file_size <= 0) return;
+
+    //-------------------------------------------------------------
+    // Find offset of the index
+    //-------------------------------------------------------------
+    const std::streamoff tail_start = std::max<std::streamoff>(0, file_size - INDEX_OFFSET_SEARCH_LENGTH);
+    const std::string tail = readRange_(tail_start, file_size);
+    const std::string::size_type offset_tag = tail.rfind("<indexOffset>");
+    if (offset_tag == std::string::npos) return;
+
+    const char* number = tail.c_str() + offset_tag + std::string("<indexOffset>").size();
+    char* number_end = nullptr;
+    const long long index_offset = std::strtoll(number, &number_end, 10);
+    if (number_end == number || index_offset <= 0 || index_offset >= file_size) return;
+    index_offset_ = std::streampos(index_offset);
+
+    //-------------------------------------------------------------
+    // Parse the <offset> entries of the scan index
+    //-------------------------------------------------------------
+    const std::string index = readRange_(index_offset_, file_size);
+    if (index.compare(0, 6, "<index") != 0) return;
+    const std::string::size_type index_end = index.find("</index>");
+    if (index_end == std::string::npos) return;
+
+    std::string::size_type pos = 0;
+    while ((pos = index.find("<offset", pos)) < index_end)
+    {
+      // attribute 'id', spaces around '=' are allowed
+      std::string::size_type tag_end = index.find('>', pos);
+      std::string::size_type id_pos = index.find("id", pos);
+      if (tag_end == std::string::npos || id_pos > tag_end) return;
+      std::string::size_type quote = index.find_first_of("\"'", id_pos);
+      if (quote > tag_end) return;
+      std::string::size_type quote_end = index.find(index[quote], quote + 1);
+      if (quote_end > tag_end) return;
+      std::string id = index.substr(quote + 1, quote_end - quote - 1);
+
+      // text content holds the offset (position of the '<scan' tag)
+      number = index.c_str() + tag_end + 1;
+      const long long offset = std::strtoll(number, &number_end, 10);
+      if (number_end == number || offset < 0 || offset >= index_offset) return;
+
+      spectra_offsets_.push_back(std::make_pair(id, std::streampos(offset)));
+      pos = tag_end + 1;
+    }
+    if (spectra_offsets_.empty()) return;
+
+    //-------------------------------------------------------------
+    // Determine the end of each scan: the next scan in the file (which is
+    // either a nested scan or the next scan on the same level) or the index
+    //-------------------------------------------------------------
+    std::vector<std::streampos> sorted_offsets;
+    sorted_offsets.reserve(spectra_offsets_.size() + 1);
+    for (Size i = 0; i < spectra_offsets_.size(); ++i)
+    {
+      sorted_offsets.push_back(spectra_offsets_[i].second);
+    }
+    sorted_offsets.push_back(index_offset_);
+    std::sort(sorted_offsets.begin(), sorted_offsets.end());
+
+    spectra_ends_.reserve(spectra_offsets_.size());
+    for (Size i = 0; i < spectra_offsets_.size(); ++i)
+    {
+      spectra_ends_.push_back(*std::upper_bound(sorted_offsets.begin(), sorted_offsets.end(), spectra_offsets_[i].second));
+    }
+
+    //-------------------------------------------------------------
+    // Cache the header (everything up to the first scan)
+    //-------------------------------------------------------------
+    header_ = readRange_(0, sorted_offsets.front());
+    const std::string::size_type run_pos = header_.find("<msRun");
+    if (run_pos == std::string::npos) return;
+
+    // the scan count would let the handler reserve space for the whole run
+    const std::string::size_type run_end = header_.find('>', run_pos);
+    const std::string::size_type count_pos = header_.find("scanCount", run_pos);
+    if (count_pos < run_end)
+    {
+      const std::string::size_type quote = header_.find_first_of("\"'", count_pos);
+      const std::string::size_type quote_end = quote < run_end ? header_.find(header_[quote], quote + 1) : std::string::npos;
+      if (quote_end < run_end)
+      {
+        header_.erase(count_pos, quote_end - count_pos + 1);
+      }
+    }
+
+    parsing_success_ = true;
+  }
+
+  IndexedMzXMLHandler::IndexedMzXMLHandler(const String& filename) :
+    index_offset_(-1),
+    parsing_success_(false)
+  {
+    openFile(filename);
+  }
+
+  IndexedMzXMLHandler::IndexedMzXMLHandler() :
+    index_offset_(-1),
+    parsing_success_(false)
+  {}
+
+  IndexedMzXMLHandler::IndexedMzXMLHandler(const IndexedMzXMLHandler& source) :
+    filename_(source.filename_),
+    spectra_offsets_(source.spectra_offsets_),
+    spectra_ends_(source.spectra_ends_),
+    index_offset_(source.index_offset_),
+    header_(source.header_),
+    filestream_(),
+    filestream_mutex_(),
+    mapped_region_(source.mapped_region_),
+    parsing_success_(source.parsing_success_)
+  {
+    // do not copy the filestream itself but open a new filestream using the same file
+    // (not needed if the memory mapping can be shared)
+    if (!mapped_region_ && !filename_.empty())
+    {
+      filestream_.open(source.filename_.c_str(), std::ios::binary);
+    }
+  }
+
+  IndexedMzXMLHandler::~IndexedMzXMLHandler()
+  {
+  }
+
+  void IndexedMzXMLHandler::openFile(const String& filename)
+  {
+    if (!File::exists(filename))
+    {
+      throw Exception::FileNotFound(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, filename);
+    }
+
+    if (filestream_.is_open())
+    {
+      filestream_.close();
+    }
+    filename_ = filename;
+
+    // map the file into memory, fall back to a file stream if this fails
+    mapped_region_.reset();
+    try
+    {
+      boost::interprocess::file_mapping mapping(filename.c_str(), boost::interprocess::read_only);
+      mapped_region_.reset(new boost::interprocess::mapped_region(mapping, boost::interprocess::read_only));
+      // the file is read in random order, no read-ahead needed
+      mapped_region_->advise(boost::interprocess::mapped_region::advice_random);
+    }
+    catch (boost::interprocess::interprocess_exception& /* e */)
+    {
+      mapped_region_.reset();
+    }
+
+    if (!mapped_region_)
+    {
+      filestream_.open(filename.c_str(), std::ios::binary);
+    }
+    parseIndex_();
+  }
+
+  std::string IndexedMzXMLHandler::readRange_(std::streampos startidx, std::streampos endidx)
+  {
+    if (mapped_region_)
+    {
+      const std::streamoff file_size = mapped_region_->get_size();
+      const std::streamoff start = std::min<std::streamoff>(startidx, file_size);
+      const std::streamoff end = std::min<std::streamoff>(std::max<std::streamoff>(endidx, start), file_size);
+      const char* data = static_cast<const char*>(mapped_region_->get_address());
+      return std::string(data + start, data + end);
+    }
+
+    std::lock_guard<std::mutex> lock(filestream_mutex_);
+    std::string text(std::max<std::streamoff>(endidx - startidx, 0), '\0');
+    filestream_.clear();
+    filestream_.seekg(startidx, filestream_.beg);
+    filestream_.read(&text[0], text.size());
+    text.resize(filestream_.gcount());
+    return text;
+  }
+
+  std::string IndexedMzXMLHandler::getScanText_(int id)
+  {
+    if (!parsing_success_)
+    {
+      throw Exception::ParseError(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION,
+          "Parsing was unsuccessful, cannot read file", "");
+    }
+    if (id < 0)
+    {
+      throw Exception::IllegalArgument(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION,
+          String( "id needs to be positive, was " + String(id) ));
+    }
+    if (id >= (int)getNrSpectra())
+    {
+      throw Exception::IllegalArgument(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, String(
+            "id needs to be smaller than the number of spectra, was " + String(id)
+            + " maximal allowed is " + String(getNrSpectra()) ));
+    }
+
+    std::string text = readRange_(spectra_offsets_[id].second, spectra_ends_[id]);
+    if (text.compare(0, 5, "<scan") != 0)
+    {
+      throw Exception::ParseError(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, 
+          "Index entry does not point to a <scan> element", String(id));
+    }
+
+    // the text either ends with the closing tag(s) of this scan (and possibly
+    // of its parents) or with the start of a nested scan
+    const std::string::size_type scan_end = text.find("</scan>");
+    if (scan_end != std::string::npos)
+    {
+      text.resize(scan_end + 7);
+    }
+    else
+    {
+      text += "</scan>";
+    }
+    text += "\n";
+
+#ifdef DEBUG_READER
+    // print the full text we just read
+    std::cout << text << std::endl;
+#endif
+
+    return text;
+  }
+
+  bool IndexedMzXMLHandler::getParsingSuccess() const
+  {
+    return parsing_success_;
+  }
+
+  size_t IndexedMzXMLHandler::getNrSpectra() const
+  {
+    return spectra_offsets_.size();
+  }
+
+  const std::string& IndexedMzXMLHandler::getScanNumber(int id) const
+  {
+    if (id < 0 || id >= (int)getNrSpectra())
+    {
+      throw Exception::IndexOverflow(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, id, getNrSpectra());
+    }
+    return spectra_offsets_[id].first;
+  }
+
+  const MSSpectrum IndexedMzXMLHandler::getMSSpectrumById(int id)
+  {
+    MSSpectrum s;
+    getMSSpectrumById(id, s);
+    return s;
+  }
+
+  void IndexedMzXMLHandler::getMSSpectrumById(int id, MSSpectrum& s)
+  {
+    std::vector<MSSpectrum> spectra;
+    getMSSpectraByIds(std::vector<int>(1, id), spectra);
+    s = std::move(spectra[0]);
+  }
+
+  void IndexedMzXMLHandler::getMSSpectraByIds(const std::vector<int>& ids, std::vector<MSSpectrum>& spectra)
+  {
+    spectra.clear();
+    if (ids.empty()) return;
+
+    // assemble a document holding all requested scans (on the top level)
+    std::string document = header_;
+    for (Size i = 0; i < ids.size(); ++i)
+    {
+      document += getScanText_(ids[i]);
+    }
+    document += "</msRun>\n</mzXML>\n";
+
+    // decode the binary data of all scans in one (parallel) batch
+    PeakFileOptions options;
+    options.setMaxDataPoolSize(ids.size());
+
+    PeakMap exp;
+    ProgressLogger logger;
+    MzXMLHandler handler(exp, filename_, "3.1", logger);
+    handler.setOptions(options);
+    MzXMLBufferParser().parse(document, &handler);
+
+    if (exp.size() != ids.size())
+    {
+      throw Exception::ParseError(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION,
+          String("Expected ") + ids.size() + " scans, but found " + exp.size(), filename_);
+    }
+    spectra.swap(exp.getSpectra());
+  }
+
+}
+}
@@ -156,24 +156,7 @@ namespace OpenMS
      */
     void MzIdentMLDOMHandler::readMzIdentMLFile(const std::string& mzid_file)
     {
-      // Test to see if the file is ok.
-      struct stat fileStatus;
-
-      errno = 0;
-      if (stat(mzid_file.c_str(), &fileStatus) == -1) // ==0 ok; ==-1 error
-      {
-        if (errno == ENOENT) // errno declared by include file errno.h
-          throw (runtime_error("Path file_name does not exist, or path is an empty string."));
-        else if (errno == ENOTDIR)
-          throw (runtime_error("A component of the path is not a directory."));
-        // On MSVC 2008, the ELOOP constant is not declared and thus introduces a compile error
-        //else if (errno == ELOOP)
-        //  throw (runtime_error("Too many symbolic links encountered while traversing the path."));
-        else if (errno == EACCES)
-          throw (runtime_error("Permission denied."));
-        else if (errno == ENAMETOOLONG)
-          throw (runtime_error("File can not be read."));
-      }
+      checkFile_(mzid_file);
 
       // Configure DOM parser.
       mzid_parser_.setValidationScheme(XercesDOMParser::Val_Never);
@@ -188,99 +171,255 @@ namespace OpenMS
         // no need to free this pointer - owned by the parent parser object
         xercesc::DOMDocument* xmlDoc = mzid_parser_.getDocument();
 
-        // Catch special case: Cross-Linking MS
-        DOMNodeList* additionalSearchParams = xmlDoc->getElementsByTagName(XMLString::transcode("AdditionalSearchParams"));
-        const  XMLSize_t as_node_count = additionalSearchParams->getLength();
+        parseSearchSetup_(xmlDoc);
+
+        // 5. AnalysisSampleCollection ??? contact stuff
 
-        for (XMLSize_t i = 0; i < as_node_count; ++i)
+        // 6. AnalysisCollection {1,1} - build final structures PeptideIdentification (and hits)
+
+        // 6.1 SpectrumIdentificationList {0,1}
+        DOMNodeList* spectrumIdentificationListElements = xmlDoc->getElementsByTagName(XMLString::transcode("SpectrumIdentificationList"));
+        if (spectrumIdentificationListElements->getLength() == 0) throw(runtime_error("No SpectrumIdentificationList nodes"));
+        parseSpectrumIdentificationListElements_(spectrumIdentificationListElements);
+
+        parseProteinDetection_(xmlDoc);
+      }
+      catch (xercesc::XMLException& e)
+      {
+        char* message = xercesc::XMLString::transcode(e.getMessage());
+//          ostringstream errBuf;
+//          errBuf << "Error parsing file: " << message << flush;
+        LOG_ERROR << "XERCES error parsing file: " << message << flush << endl;
+        XMLString::release(&message);
+      }
+    }
+
+    /*
+     * DOM parser filter for streaming: converts each SpectrumIdentificationResult
+     * as soon as it is complete and drops it from the DOM tree
+     */
+    class MzIdentMLDOMHandler::SpectrumIdentificationResultFilter_ :
+      public DOMLSParserFilter
+    {
+public:
+      SpectrumIdentificationResultFilter_(MzIdentMLDOMHandler& handler, const std::function<void(PeptideIdentification&)>& consumer) :
+        handler_(handler),
+        consumer_(consumer),
+        setup_done_(false),
+        sil_tag_(XMLString::transcode("SpectrumIdentificationList")),
+        sir_tag_(XMLString::transcode("SpectrumIdentificationResult")),
+        id_attr_(XMLString::transcode("id"))
+      {
+      }
+
+      ~SpectrumIdentificationResultFilter_() override
+      {
+        XMLString::release(&sil_tag_);
+        XMLString::release(&sir_tag_);
+        XMLString::release(&id_attr_);
+      }
+
+      FilterAction startElement(DOMElement* element) override
+      {
+        // everything in front of the first SpectrumIdentificationList (software, inputs,
+        // protocols, SequenceCollection) is complete at this point
+        if (!setup_done_ && XMLString::equals(element->getTagName(), sil_tag_))
         {
-          DOMNode* current_sp = additionalSearchParams->item(i);
+          handler_.parseSearchSetup_(element->getOwnerDocument());
+          setup_done_ = true;
+        }
+        return FILTER_ACCEPT;
+      }
 
-          DOMElement* element_SearchParams = dynamic_cast<xercesc::DOMElement*>(current_sp);
-          String cross_linking_search = XMLString::transcode(element_SearchParams->getAttribute(XMLString::transcode("id")));
-          DOMElement* child = element_SearchParams->getFirstElementChild();
+      FilterAction acceptNode(DOMNode* node) override
+      {
+        DOMElement* element = dynamic_cast<DOMElement*>(node);
+        if (element == nullptr || !XMLString::equals(element->getTagName(), sir_tag_))
+        {
+          return FILTER_ACCEPT;
+        }
 
-          while (child && !xl_ms_search_)
+        DOMElement* parent = dynamic_cast<DOMElement*>(element->getParentNode());
+        String sil = XMLString::transcode(parent->getAttribute(id_attr_));
+        Size first = handler_.pep_id_->size();
+        handler_.parseSpectrumIdentificationResultElement_(element, sil);
+        if (consumer_)
+        {
+          for (Size i = first; i < handler_.pep_id_->size(); ++i)
           {
-            String accession = XMLString::transcode(child->getAttribute(XMLString::transcode("accession")));
-            if (accession == "MS:1002494") // accession for "cross-linking search"
-            {
-              xl_ms_search_ = true;
-            }
-            child = child->getNextElementSibling();
+            consumer_((*handler_.pep_id_)[i]);
           }
+          handler_.pep_id_->erase(handler_.pep_id_->begin() + first, handler_.pep_id_->end());
         }
+        return FILTER_REJECT; // converted, no need to keep it in the DOM
+      }
 
-        if (xl_ms_search_)
-        {
-          LOG_DEBUG << "Reading a Cross-Linking MS file." << endl;
-        }
+      DOMNodeFilter::ShowType getWhatToShow() const override
+      {
+        return DOMNodeFilter::SHOW_ELEMENT;
+      }
 
-        // 0. AnalysisSoftwareList {0,1}
-        DOMNodeList* analysisSoftwareElements = xmlDoc->getElementsByTagName(XMLString::transcode("AnalysisSoftware"));
-        parseAnalysisSoftwareList_(analysisSoftwareElements);
+      bool setupDone() const
+      {
+        return setup_done_;
+      }
 
-        // 1. DataCollection {1,1}
-        DOMNodeList* spectraDataElements = xmlDoc->getElementsByTagName(XMLString::transcode("SpectraData"));
-        if (spectraDataElements->getLength() == 0) throw(runtime_error("No SpectraData nodes"));
-        parseInputElements_(spectraDataElements);
+private:
+      MzIdentMLDOMHandler& handler_;
+      const std::function<void(PeptideIdentification&)>& consumer_;
+      bool setup_done_;
+      XMLCh* sil_tag_;
+      XMLCh* sir_tag_;
+      XMLCh* id_attr_;
+    };
 
-        // 1.2. SearchDatabase {0,unbounded}
-        DOMNodeList* searchDatabaseElements = xmlDoc->getElementsByTagName(XMLString::transcode("SearchDatabase"));
-        parseInputElements_(searchDatabaseElements);
+    /*
+     * reads a mzid file, converting results while parsing
+     */
+    void MzIdentMLDOMHandler::readMzIdentMLFile(const std::string& mzid_file, const std::function<void(PeptideIdentification&)>& consumer)
+    {
+      checkFile_(mzid_file);
 
-        // 1.1 SourceFile {0,unbounded}
-        DOMNodeList* sourceFileElements = xmlDoc->getElementsByTagName(XMLString::transcode("SourceFile"));
-        parseInputElements_(sourceFileElements);
+      // Configure DOM parser (the filter requires the DOM Level 3 Load interface).
+      DOMImplementation* impl = DOMImplementationRegistry::getDOMImplementation(XMLString::transcode("LS"));
+      DOMLSParser* parser = impl->createLSParser(DOMImplementationLS::MODE_SYNCHRONOUS, nullptr);
+      DOMConfiguration* config = parser->getDomConfig();
+      config->setParameter(XMLUni::fgDOMValidate, false);
+      config->setParameter(XMLUni::fgDOMNamespaces, false);
+      config->setParameter(XMLUni::fgXercesSchema, false);
+      config->setParameter(XMLUni::fgXercesLoadExternalDTD, false);
 
-        // 2. SpectrumIdentification  {1,unbounded} ! creates identification runs (or ProteinIdentifications)
-        DOMNodeList* spectrumIdentificationElements = xmlDoc->getElementsByTagName(XMLString::transcode("SpectrumIdentification"));
-        if (spectrumIdentificationElements->getLength() == 0) throw(runtime_error("No SpectrumIdentification nodes"));
-        parseSpectrumIdentificationElements_(spectrumIdentificationElements);
+      SpectrumIdentificationResultFilter_ filter(*this, consumer);
+      parser->setFilter(&filter);
 
-        // 3. AnalysisProtocolCollection {1,1} SpectrumIdentificationProtocol  {1,unbounded} ! identification run parameters
-        DOMNodeList* spectrumIdentificationProtocolElements = xmlDoc->getElementsByTagName(XMLString::transcode("SpectrumIdentificationProtocol"));
-        if (spectrumIdentificationProtocolElements->getLength() == 0) throw(runtime_error("No SpectrumIdentificationProtocol nodes"));
-        parseSpectrumIdentificationProtocolElements_(spectrumIdentificationProtocolElements);
+      try
+      {
+        // no need to free this pointer - owned by the parser object
+        xercesc::DOMDocument* xmlDoc = parser->parseURI(mzid_file.c_str());
+        if (xmlDoc == nullptr) throw(runtime_error("Could not parse file."));
 
-        // 4. SequenceCollection nodes {0,1} DBSequenceElement {1,unbounded} Peptide {0,unbounded} PeptideEvidence {0,unbounded}
-        DOMNodeList* dbSequenceElements = xmlDoc->getElementsByTagName(XMLString::transcode("DBSequence"));
-        parseDBSequenceElements_(dbSequenceElements);
+        if (!filter.setupDone())
+        {
+          parseSearchSetup_(xmlDoc);
+          throw(runtime_error("No SpectrumIdentificationList nodes"));
+        }
 
-        DOMNodeList* peptideElements = xmlDoc->getElementsByTagName(XMLString::transcode("Peptide"));
-        parsePeptideElements_(peptideElements);
+        parseProteinDetection_(xmlDoc);
+      }
+      catch (xercesc::XMLException& e)
+      {
+        char* message = xercesc::XMLString::transcode(e.getMessage());
+        LOG_ERROR << "XERCES error parsing file: " << message << flush << endl;
+        XMLString::release(&message);
+      }
+      catch (...)
+      {
+        parser->release();
+        throw;
+      }
+      parser->release();
+    }
 
-        DOMNodeList* peptideEvidenceElements = xmlDoc->getElementsByTagName(XMLString::transcode("PeptideEvidence"));
-        parsePeptideEvidenceElements_(peptideEvidenceElements);
-//          mzid_parser_.resetDocumentPool(); //segfault prone: do not use!
+    void MzIdentMLDOMHandler::checkFile_(const std::string& mzid_file)
+    {
+      // Test to see if the file is ok.
+      struct stat fileStatus;
 
-        // 5. AnalysisSampleCollection ??? contact stuff
+      errno = 0;
+      if (stat(mzid_file.c_str(), &fileStatus) == -1) // ==0 ok; ==-1 error
+      {
+        if (errno == ENOENT) // errno declared by include file errno.h
+          throw (runtime_error("Path file_name does not exist, or path is an empty string."));
+        else if (errno == ENOTDIR)
+          throw (runtime_error("A component of the path is not a directory."));
+        // On MSVC 2008, the ELOOP constant is not declared and thus introduces a compile error
+        //else if (errno == ELOOP)
+        //  throw (runtime_error("Too many symbolic links encountered while traversing the path."));
+        else if (errno == EACCES)
+          throw (runtime_error("Permission denied."));
+        else if (errno == ENAMETOOLONG)
+          throw (runtime_error("File can not be read."));
+      }
+    }
 
-        // 6. AnalysisCollection {1,1} - build final structures PeptideIdentification (and hits)
+    void MzIdentMLDOMHandler::parseSearchSetup_(xercesc::DOMDocument* xmlDoc)
+    {
+      // Catch special case: Cross-Linking MS
+      DOMNodeList* additionalSearchParams = xmlDoc->getElementsByTagName(XMLString::transcode("AdditionalSearchParams"));
+      const  XMLSize_t as_node_count = additionalSearchParams->getLength();
 
-        // 6.1 SpectrumIdentificationList {0,1}
-        DOMNodeList* spectrumIdentificationListElements = xmlDoc->getElementsByTagName(XMLString::transcode("SpectrumIdentificationList"));
-        if (spectrumIdentificationListElements->getLength() == 0) throw(runtime_error("No SpectrumIdentificationList nodes"));
-        parseSpectrumIdentificationListElements_(spectrumIdentificationListElements);
+      for (XMLSize_t i = 0; i < as_node_count; ++i)
+      {
+        DOMNode* current_sp = additionalSearchParams->item(i);
 
-        // 6.2 ProteinDetection {0,1}
-        DOMNodeList* parseProteinDetectionListElements = xmlDoc->getElementsByTagName(XMLString::transcode("ProteinDetectionList"));
-        parseProteinDetectionListElements_(parseProteinDetectionListElements);
+        DOMElement* element_SearchParams = dynamic_cast<xercesc::DOMElement*>(current_sp);
+        String cross_linking_search = XMLString::transcode(element_SearchParams->getAttribute(XMLString::transcode("id")));
+        DOMElement* child = element_SearchParams->getFirstElementChild();
 
-        for (vector<ProteinIdentification>::iterator it = pro_id_->begin(); it != pro_id_->end(); ++it)
+        while (child && !xl_ms_search_)
         {
-          it->sort();
+          String accession = XMLString::transcode(child->getAttribute(XMLString::transcode("accession")));
+          if (accession == "MS:1002494") // accession for "cross-linking search"
+          {
+            xl_ms_search_ = true;
+          }
+          child = child->getNextElementSibling();
         }
-        //note: PeptideIdentification sorting here not necessary any more, due to sorting according to cv in SpectrumIdentificationResult
+      }
 
+      if (xl_ms_search_)
+      {
+        LOG_DEBUG << "Reading a Cross-Linking MS file." << endl;
       }
-      catch (xercesc::XMLException& e)
+
+      // 0. AnalysisSoftwareList {0,1}
+      DOMNodeList* analysisSoftwareElements = xmlDoc->getElementsByTagName(XMLString::transcode("AnalysisSoftware"));
+      parseAnalysisSoftwareList_(analysisSoftwareElements);
+
+      // 1. DataCollection {1,1}
+      DOMNodeList* spectraDataElements = xmlDoc->getElementsByTagName(XMLString::transcode("SpectraData"));
+      if (spectraDataElements->getLength() == 0) throw(runtime_error("No SpectraData nodes"));
+      parseInputElements_(spectraDataElements);
+
+      // 1.2. SearchDatabase {0,unbounded}
+      DOMNodeList* searchDatabaseElements = xmlDoc->getElementsByTagName(XMLString::transcode("SearchDatabase"));
+      parseInputElements_(searchDatabaseElements);
+
+      // 1.1 SourceFile {0,unbounded}
+      DOMNodeList* sourceFileElements = xmlDoc->getElementsByTagName(XMLString::transcode("SourceFile"));
+      parseInputElements_(sourceFileElements);
+
+      // 2. SpectrumIdentification  {1,unbounded} ! creates identification runs (or ProteinIdentifications)
+      DOMNodeList* spectrumIdentificationElements = xmlDoc->getElementsByTagName(XMLString::transcode("SpectrumIdentification"));
+      if (spectrumIdentificationElements->getLength() == 0) throw(runtime_error("No SpectrumIdentification nodes"));
+      parseSpectrumIdentificationElements_(spectrumIdentificationElements);
+
+      // 3. AnalysisProtocolCollection {1,1} SpectrumIdentificationProtocol  {1,unbounded} ! identification run parameters
+      DOMNodeList* spectrumIdentificationProtocolElements = xmlDoc->getElementsByTagName(XMLString::transcode("SpectrumIdentificationProtocol"));
+      if (spectrumIdentificationProtocolElements->getLength() == 0) throw(runtime_error("No SpectrumIdentificationProtocol nodes"));
+      parseSpectrumIdentificationProtocolElements_(spectrumIdentificationProtocolElements);
+
+      // 4. SequenceCollection nodes {0,1} DBSequenceElement {1,unbounded} Peptide {0,unbounded} PeptideEvidence {0,unbounded}
+      DOMNodeList* dbSequenceElements = xmlDoc->getElementsByTagName(XMLString::transcode("DBSequence"));
+      parseDBSequenceElements_(dbSequenceElements);
+
+      DOMNodeList* peptideElements = xmlDoc->getElementsByTagName(XMLString::transcode("Peptide"));
+      parsePeptideElements_(peptideElements);
+
+      DOMNodeList* peptideEvidenceElements = xmlDoc->getElementsByTagName(XMLString::transcode("PeptideEvidence"));
+      parsePeptideEvidenceElements_(peptideEvidenceElements);
+//          mzid_parser_.resetDocumentPool(); //segfault prone: do not use!
+    }
+
+    void MzIdentMLDOMHandler::parseProteinDetection_(xercesc::DOMDocument* xmlDoc)
+    {
+      // 6.2 ProteinDetection {0,1}
+      DOMNodeList* parseProteinDetectionListElements = xmlDoc->getElementsByTagName(XMLString::transcode("ProteinDetectionList"));
+      parseProteinDetectionListElements_(parseProteinDetectionListElements);
+
+      for (vector<ProteinIdentification>::iterator it = pro_id_->begin(); it != pro_id_->end(); ++it)
       {
-        char* message = xercesc::XMLString::transcode(e.getMessage());
-//          ostringstream errBuf;
-//          errBuf << "Error parsing file: " << message << flush;
-        LOG_ERROR << "XERCES error parsing file: " << message << flush << endl;
-        XMLString::release(&message);
+        it->sort();
       }
     }
 
@@ -1250,121 +1389,126 @@ namespace OpenMS
           {
             if ((std::string)XMLString::transcode(element_res->getTagName()) == "SpectrumIdentificationResult")
             {
-              String spectra_data_ref = XMLString::transcode(element_res->getAttribute(XMLString::transcode("spectraData_ref"))); //ref to the sourcefile, could be useful but now nowhere to store
-              String spectrumID = XMLString::transcode(element_res->getAttribute(XMLString::transcode("spectrumID")));
-              pair<CVTermList, map<String, DataValue> > params = parseParamGroup_(element_res->getChildNodes());
+              parseSpectrumIdentificationResultElement_(element_res, id);
+            }
+            element_res = element_res->getNextElementSibling();
+          }
+        }
+      }
+    }
 
-              if (xl_ms_search_) // XL-MS data has a different structure (up to 4 spectrum identification items for the same PSM)
-              {
-                std::multimap<String, int> xl_val_map;
-                std::set<String> xl_val_set;
-                int index_counter = 0;
-                DOMElement* sii = element_res->getFirstElementChild();
+    void MzIdentMLDOMHandler::parseSpectrumIdentificationResultElement_(DOMElement* element_res, const String& id)
+    {
+      String spectra_data_ref = XMLString::transcode(element_res->getAttribute(XMLString::transcode("spectraData_ref"))); //ref to the sourcefile, could be useful but now nowhere to store
+      String spectrumID = XMLString::transcode(element_res->getAttribute(XMLString::transcode("spectrumID")));
+      pair<CVTermList, map<String, DataValue> > params = parseParamGroup_(element_res->getChildNodes());
 
-                // loop over all SIIs of a spectrum and group together the SIIs belonging to the same cross-link spectrum match
-                while (sii)
-                {
-                  if ((std::string)XMLString::transcode(sii->getTagName()) == "SpectrumIdentificationItem")
-                  {
-                    DOMNodeList* sii_cvp = sii->getElementsByTagName(XMLString::transcode("cvParam"));
-                    const  XMLSize_t cv_count = sii_cvp->getLength();
-                    for (XMLSize_t i = 0; i < cv_count; ++i)
-                    {
-                      DOMElement* element_sii_cvp = dynamic_cast<xercesc::DOMElement*>(sii_cvp->item(i));
-                      if (String(XMLString::transcode(element_sii_cvp->getAttribute(XMLString::transcode("accession")))) == String("MS:1002511")) // cross-link spectrum identification item
-                      {
-                        String xl_val = XMLString::transcode(element_sii_cvp->getAttribute(XMLString::transcode("value")));
-                        xl_val_map.insert(make_pair(xl_val, index_counter));
-                        xl_val_set.insert(xl_val);
-                      }
-                    }
-                  }
-                  sii = sii->getNextElementSibling();
-                  ++index_counter;
-                }
+      if (xl_ms_search_) // XL-MS data has a different structure (up to 4 spectrum identification items for the same PSM)
+      {
+        std::multimap<String, int> xl_val_map;
+        std::set<String> xl_val_set;
+        int index_counter = 0;
+        DOMElement* sii = element_res->getFirstElementChild();
 
-                // fix for label-free mono-links
-                // those only have one SII and no "cross-link spectrum identification item" value
-                if (xl_val_set.empty())
-                {
-                  xl_val_set.insert("0");
-                  xl_val_map.insert(make_pair("0", 0));
-                }
-                for (set<String>::const_iterator set_it = xl_val_set.begin(); set_it != xl_val_set.end(); ++set_it)
-                {
-                  parseSpectrumIdentificationItemSetXLMS(set_it, xl_val_map, element_res, spectrumID);
-                }
-                pep_id_->back().setIdentifier(pro_id_->at(si_pro_map_[id]).getIdentifier());
-              }
-              else // general case
+        // loop over all SIIs of a spectrum and group together the SIIs belonging to the same cross-link spectrum match
+        while (sii)
+        {
+          if ((std::string)XMLString::transcode(sii->getTagName()) == "SpectrumIdentificationItem")
+          {
+            DOMNodeList* sii_cvp = sii->getElementsByTagName(XMLString::transcode("cvParam"));
+            const  XMLSize_t cv_count = sii_cvp->getLength();
+            for (XMLSize_t i = 0; i < cv_count; ++i)
+            {
+              DOMElement* element_sii_cvp = dynamic_cast<xercesc::DOMElement*>(sii_cvp->item(i));
+              if (String(XMLString::transcode(element_sii_cvp->getAttribute(XMLString::transcode("accession")))) == String("MS:1002511")) // cross-link spectrum identification item
               {
-                pep_id_->push_back(PeptideIdentification());
-                pep_id_->back().setHigherScoreBetter(false); //either a q-value or an e-value, only if neither available there will be another
-                pep_id_->back().setMetaValue("spectrum_reference", spectrumID);  // SpectrumIdentificationResult attribute spectrumID is taken from the mz_file and should correspond to MSSpectrum.nativeID, thus spectrum_reference will serve as reference. As the format of the 'reference' widely varies from vendor to vendor, spectrum_reference as string will serve best, indices are not recommended.
+                String xl_val = XMLString::transcode(element_sii_cvp->getAttribute(XMLString::transcode("value")));
+                xl_val_map.insert(make_pair(xl_val, index_counter));
+                xl_val_set.insert(xl_val);
+              }
+            }
+          }
+          sii = sii->getNextElementSibling();
+          ++index_counter;
+        }
 
-                //fill pep_id_->back() with content
-                DOMElement* parent = dynamic_cast<xercesc::DOMElement*>(element_res->getParentNode());
-                String sil = XMLString::transcode(parent->getAttribute(XMLString::transcode("id")));
+        // fix for label-free mono-links
+        // those only have one SII and no "cross-link spectrum identification item" value
+        if (xl_val_set.empty())
+        {
+          xl_val_set.insert("0");
+          xl_val_map.insert(make_pair("0", 0));
+        }
+        for (set<String>::const_iterator set_it = xl_val_set.begin(); set_it != xl_val_set.end(); ++set_it)
+        {
+          parseSpectrumIdentificationItemSetXLMS(set_it, xl_val_map, element_res, spectrumID);
+        }
+        pep_id_->back().setIdentifier(pro_id_->at(si_pro_map_[id]).getIdentifier());
+      }
+      else // general case
+      {
+        pep_id_->push_back(PeptideIdentification());
+        pep_id_->back().setHigherScoreBetter(false); //either a q-value or an e-value, only if neither available there will be another
+        pep_id_->back().setMetaValue("spectrum_reference", spectrumID);  // SpectrumIdentificationResult attribute spectrumID is taken from the mz_file and should correspond to MSSpectrum.nativeID, thus spectrum_reference will serve as reference. As the format of the 'reference' widely varies from vendor to vendor, spectrum_reference as string will serve best, indices are not recommended.
 
-                DOMElement* child = element_res->getFirstElementChild();
-                while (child)
-                {
-                  if ((std::string)XMLString::transcode(child->getTagName()) == "SpectrumIdentificationItem")
-                  {
-                    parseSpectrumIdentificationItemElement_(child, pep_id_->back(), sil);
-                  }
-                  child = child->getNextElementSibling();
-                }
+        //fill pep_id_->back() with content
+        DOMElement* parent = dynamic_cast<xercesc::DOMElement*>(element_res->getParentNode());
+        String sil = XMLString::transcode(parent->getAttribute(XMLString::transcode("id")));
 
-              } // end of "not-XLMS-results"
+        DOMElement* child = element_res->getFirstElementChild();
+        while (child)
+        {
+          if ((std::string)XMLString::transcode(child->getTagName()) == "SpectrumIdentificationItem")
+          {
+            parseSpectrumIdentificationItemElement_(child, pep_id_->back(), sil);
+          }
+          child = child->getNextElementSibling();
+        }
 
-              // TODO @mths: setSignificanceThreshold, but from where?
+      } // end of "not-XLMS-results"
 
-              pep_id_->back().setIdentifier(pro_id_->at(si_pro_map_[id]).getIdentifier());
+      // TODO @mths: setSignificanceThreshold, but from where?
 
-              pep_id_->back().sortByRank();
+      pep_id_->back().setIdentifier(pro_id_->at(si_pro_map_[id]).getIdentifier());
 
-              //adopt cv s
-              for (map<String, vector<CVTerm> >::const_iterator cvit =  params.first.getCVTerms().begin(); cvit != params.first.getCVTerms().end(); ++cvit)
-              {
-                // check for retention time or scan time entry
-                /* N.B.: MzIdentML does not impose the requirement to store
-                   'redundant' data (e.g. RT) as the identified spectrum is
-                   unambiguously referencable by the spectrumID (OpenMS
-                   internally spectrum_reference) and hence such data can be
-                   looked up in the mz file. For convenience, and as OpenMS
-                   relies on the smallest common denominator to reference a
-                   spectrum (RT/precursor MZ), we provide functionality to amend
-                   RT data to identifications and support reading such from mzid
-                */
-                if (cvit->first == "MS:1000894" || cvit->first == "MS:1000016") //TODO use subordinate terms which define units
-                {
-                  double rt = cvit->second.front().getValue().toString().toDouble();
-                  if (cvit->second.front().getUnit().accession == "UO:0000031")  // minutes
-                  {
-                    rt *= 60.0;
-                  }
-                  pep_id_->back().setRT(rt);
-                }
-                else
-                {
-                  pep_id_->back().setMetaValue(cvit->first, cvit->second.front().getValue()); // TODO? all DataValues - are there more then one, my guess is this is overdesigned
-                }
-              }
-              //adopt up s
-              for (map<String, DataValue>::const_iterator upit = params.second.begin(); upit != params.second.end(); ++upit)
-              {
-                pep_id_->back().setMetaValue(upit->first, upit->second);
-              }
-              if (pep_id_->back().getRT() != pep_id_->back().getRT())
-              {
-                LOG_WARN << "No retention time found for 'SpectrumIdentificationResult'" << endl;
-              }
-            }
-            element_res = element_res->getNextElementSibling();
+      pep_id_->back().sortByRank();
+
+      //adopt cv s
+      for (map<String, vector<CVTerm> >::const_iterator cvit =  params.first.getCVTerms().begin(); cvit != params.first.getCVTerms().end(); ++cvit)
+      {
+        // check for retention time or scan time entry
+        /* N.B.: MzIdentML does not impose the requirement to store
+           'redundant' data (e.g. RT) as the identified spectrum is
+           unambiguously referencable by the spectrumID (OpenMS
+           internally spectrum_reference) and hence such data can be
+           looked up in the mz file. For convenience, and as OpenMS
+           relies on the smallest common denominator to reference a
+           spectrum (RT/precursor MZ), we provide functionality to amend
+           RT data to identifications and support reading such from mzid
+        */
+        if (cvit->first == "MS:1000894" || cvit->first == "MS:1000016") //TODO use subordinate terms which define units
+        {
+          double rt = cvit->second.front().getValue().toString().toDouble();
+          if (cvit->second.front().getUnit().accession == "UO:0000031")  // minutes
+          {
+            rt *= 60.0;
           }
+          pep_id_->back().setRT(rt);
+        }
+        else
+        {
+          pep_id_->back().setMetaValue(cvit->first, cvit->second.front().getValue()); // TODO? all DataValues - are there more then one, my guess is this is overdesigned
         }
       }
+      //adopt up s
+      for (map<String, DataValue>::const_iterator upit = params.second.begin(); upit != params.second.end(); ++upit)
+      {
+        pep_id_->back().setMetaValue(upit->first, upit->second);
+      }
+      if (pep_id_->back().getRT() != pep_id_->back().getRT())
+      {
+        LOG_WARN << "No retention time found for 'SpectrumIdentificationResult'" << endl;
+      }
     }
 
     void MzIdentMLDOMHandler::parseSpectrumIdentificationItemSetXLMS(set<String>::const_iterator set_it, std::multimap<String, int> xl_val_map, DOMElement* element_res, String spectrumID)
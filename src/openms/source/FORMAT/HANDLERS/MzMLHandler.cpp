@@ -44,10 +44,44 @@
 #include <OpenMS/INTERFACES/IMSDataConsumer.h>
 #include <OpenMS/SYSTEM/File.h>
 
+#include <exception>
+#include <sstream>
+
 namespace OpenMS
 {
   namespace Internal
   {
+    namespace
+    {
+      /// the controlled vocabularies used by all handlers (parsing the OBO files is expensive)
+      const ControlledVocabulary& getMzMLCV()
+      {
+        static const ControlledVocabulary cv = []()
+        {
+          ControlledVocabulary tmp;
+          tmp.loadFromOBO("MS", File::find("/CV/psi-ms.obo"));
+          tmp.loadFromOBO("PATO", File::find("/CV/quality.obo"));
+          tmp.loadFromOBO("UO", File::find("/CV/unit.obo"));
+          tmp.loadFromOBO("BTO", File::find("/CV/brenda.obo"));
+          tmp.loadFromOBO("GO", File::find("/CV/goslim_goa.obo"));
+          return tmp;
+        }();
+        return cv;
+      }
+
+      /// the CV mapping rules used by all handlers
+      const CVMappings& getMzMLMapping()
+      {
+        static const CVMappings mapping = []()
+        {
+          CVMappings tmp;
+          CVMappingFile().load(File::find("/MAPPING/ms-mapping.xml"), tmp);
+          return tmp;
+        }();
+        return mapping;
+      }
+    }
+
 
     /// Constructor for a read-only handler
     MzMLHandler::MzMLHandler(MapType& exp, const String& filename, const String& version, const ProgressLogger& logger)
@@ -66,16 +100,10 @@ namespace OpenMS
     /// delegated c'tor for the common things
     MzMLHandler::MzMLHandler(const String& filename, const String& version, const ProgressLogger& logger)
       : XMLHandler(filename, version),
-        logger_(logger)
+        logger_(logger),
+        cv_(getMzMLCV()),
+        mapping_(getMzMLMapping())
     {
-      cv_.loadFromOBO("MS", File::find("/CV/psi-ms.obo"));
-      cv_.loadFromOBO("PATO", File::find("/CV/quality.obo"));
-      cv_.loadFromOBO("UO", File::find("/CV/unit.obo"));
-      cv_.loadFromOBO("BTO", File::find("/CV/brenda.obo"));
-      cv_.loadFromOBO("GO", File::find("/CV/goslim_goa.obo"));
-
-      CVMappingFile().load(File::find("/MAPPING/ms-mapping.xml"), mapping_);
-
       // check the version number of the mzML handler
       if (VersionInfo::VersionDetails::create(version_) == VersionInfo::VersionDetails::EMPTY)
       {
@@ -87,6 +115,9 @@ namespace OpenMS
     /// Destructor
     MzMLHandler::~MzMLHandler()
     {
+      // do not destroy the batches while they are still being decoded
+      if (spectra_decoded_.valid()) spectra_decoded_.wait();
+      if (chromatograms_decoded_.valid()) chromatograms_decoded_.wait();
     }
     /// Set the peak file options
     void MzMLHandler::setOptions(const PeakFileOptions& opt)
@@ -140,28 +171,47 @@ namespace OpenMS
 
     void MzMLHandler::populateSpectraWithData_()
     {
+      // append the batch which is still being decoded first (this keeps the
+      // order of the file and bounds the number of batches in memory to two)
+      finishSpectraDecoding_();
+
+      if (spectrum_data_.empty())
+      {
+        return;
+      }
+      spectrum_data_decoding_.swap(spectrum_data_);
 
       // Whether spectrum should be populated with data
-      if (options_.getFillData())
+      if (!options_.getFillData())
+      {
+        finishSpectraDecoding_();
+        return;
+      }
+
+      // Decode the batch in the background while the parser continues with
+      // the next batch. Only the batch itself and the (constant) options are
+      // accessed from the background thread; the experiment and the consumer
+      // are exclusively accessed from the parsing thread.
+      spectra_decoded_ = std::async(std::launch::async, [this]()
       {
         size_t errCount = 0;
 #ifdef _OPENMP
 #pragma omp parallel for
 #endif
-        for (SignedSize i = 0; i < (SignedSize)spectrum_data_.size(); i++)
+        for (SignedSize i = 0; i < (SignedSize)spectrum_data_decoding_.size(); i++)
         {
           // parallel exception catching and re-throwing business
           if (!errCount) // no need to parse further if already an error was encountered
           {
             try
             {
-              populateSpectraWithData_(spectrum_data_[i].data,
-                                       spectrum_data_[i].default_array_length,
+              populateSpectraWithData_(spectrum_data_decoding_[i].data,
+                                       spectrum_data_decoding_[i].default_array_length,
                                        options_,
-                                       spectrum_data_[i].spectrum);
-              if (options_.getSortSpectraByMZ() && !spectrum_data_[i].spectrum.isSorted())
+                                       spectrum_data_decoding_[i].spectrum);
+              if (options_.getSortSpectraByMZ() && !spectrum_data_decoding_[i].spectrum.isSorted())
               {
-                spectrum_data_[i].spectrum.sortByPosition();
+                spectrum_data_decoding_[i].spectrum.sortByPosition();
               }
             }
             catch (...)
@@ -175,81 +225,130 @@ namespace OpenMS
         {
           throw Exception::ParseError(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, file_, "Error during parsing of binary data.");
         }
+      });
+    }
+
+    void MzMLHandler::finishSpectraDecoding_()
+    {
+      if (spectra_decoded_.valid())
+      {
+        try
+        {
+          spectra_decoded_.get(); // re-throws exceptions from the decoding thread
+        }
+        catch (...)
+        {
+          spectrum_data_decoding_.clear();
+          throw;
+        }
       }
 
       // Append all spectra to experiment / consumer
-      for (Size i = 0; i < spectrum_data_.size(); i++)
+      for (Size i = 0; i < spectrum_data_decoding_.size(); i++)
       {
         if (consumer_ != nullptr)
         {
-          consumer_->consumeSpectrum(spectrum_data_[i].spectrum);
+          consumer_->consumeSpectrum(spectrum_data_decoding_[i].spectrum);
           if (options_.getAlwaysAppendData())
           {
-            exp_->addSpectrum(std::move(spectrum_data_[i].spectrum));
+            exp_->addSpectrum(std::move(spectrum_data_decoding_[i].spectrum));
           }
         }
         else
         {
-          exp_->addSpectrum(std::move(spectrum_data_[i].spectrum));
+          exp_->addSpectrum(std::move(spectrum_data_decoding_[i].spectrum));
         }
       }
 
       // Delete batch
-      spectrum_data_.clear();
+      spectrum_data_decoding_.clear();
     }
 
     void MzMLHandler::populateChromatogramsWithData_()
     {
+      // append the batch which is still being decoded first (see populateSpectraWithData_())
+      finishChromatogramsDecoding_();
+
+      if (chromatogram_data_.empty())
+      {
+        return;
+      }
+      chromatogram_data_decoding_.swap(chromatogram_data_);
+
       // Whether chromatogram should be populated with data
-      if (options_.getFillData())
+      if (!options_.getFillData())
+      {
+        finishChromatogramsDecoding_();
+        return;
+      }
+
+      chromatograms_decoded_ = std::async(std::launch::async, [this]()
       {
         size_t errCount = 0;
 #ifdef _OPENMP
 #pragma omp parallel for
 #endif
-        for (SignedSize i = 0; i < (SignedSize)chromatogram_data_.size(); i++)
+        for (SignedSize i = 0; i < (SignedSize)chromatogram_data_decoding_.size(); i++)
         {
           // parallel exception catching and re-throwing business
           try
           {
-            populateChromatogramsWithData_(chromatogram_data_[i].data,
-                                           chromatogram_data_[i].default_array_length,
+            populateChromatogramsWithData_(chromatogram_data_decoding_[i].data,
+                                           chromatogram_data_decoding_[i].default_array_length,
                                            options_,
-                                           chromatogram_data_[i].chromatogram);
-            if (options_.getSortChromatogramsByRT() && !chromatogram_data_[i].chromatogram.isSorted())
+                                           chromatogram_data_decoding_[i].chromatogram);
+            if (options_.getSortChromatogramsByRT() && !chromatogram_data_decoding_[i].chromatogram.isSorted())
             {
-              chromatogram_data_[i].chromatogram.sortByPosition();
+              chromatogram_data_decoding_[i].chromatogram.sortByPosition();
             }
           }
           catch (...)
-          {++errCount; }
+          {
+#pragma omp critical(HandleException)
+            ++errCount;
+          }
         }
         if (errCount != 0)
         {
           throw Exception::ParseError(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, file_, "Error during parsing of binary data.");
         }
+      });
+    }
 
+    void MzMLHandler::finishChromatogramsDecoding_()
+    {
+      if (chromatograms_decoded_.valid())
+      {
+        try
+        {
+          chromatograms_decoded_.get(); // re-throws exceptions from the decoding thread
+        }
+        catch (...)
+        {
+          chromatogram_data_decoding_.clear();
+          throw;
+        }
       }
 
       // Append all chromatograms to experiment / consumer
-      for (Size i = 0; i < chromatogram_data_.size(); i++)
+      for (Size i = 0; i < chromatogram_data_decoding_.size(); i++)
       {
         if (consumer_ != nullptr)
         {
-          consumer_->consumeChromatogram(chromatogram_data_[i].chromatogram);
+          consumer_->consumeChromatogram(chromatogram_data_decoding_[i].chromatogram);
           if (options_.getAlwaysAppendData())
           {
-            exp_->addChromatogram(std::move(chromatogram_data_[i].chromatogram));
+            exp_->addChromatogram(std::move(chromatogram_data_decoding_[i].chromatogram));
           }
         }
         else
         {
-          exp_->addChromatogram(std::move(chromatogram_data_[i].chromatogram));
+          exp_->addChromatogram(std::move(chromatogram_data_decoding_[i].chromatogram));
         }
       }
 
       // Delete batch
-      chromatogram_data_.clear();
+      chromatogram_data_decoding_.clear();
     }
 
     void MzMLHandler::addSpectrumMetaData_(const std::vector<MzMLHandlerHelper::BinaryData>& input_data, 
@@ -1287,9 +1386,11 @@ namespace OpenMS
         instruments_.clear();
         processing_.clear();
 
-        // Flush the remaining data
+        // Flush the remaining data and wait for the background decoding
         populateSpectraWithData_();
+        finishSpectraDecoding_();
         populateChromatogramsWithData_();
+        finishChromatogramsDecoding_();
       }
     }
 
@@ -3861,12 +3962,14 @@ namespace OpenMS
           warning(STORE, String("Invalid native IDs detected. Using spectrum identifier nativeID format (spectrum=xsd:nonNegativeInteger) for all spectra."));
         }
 
-        // write actual data
-        for (Size s_idx = 0; s_idx < exp.size(); ++s_idx)
+        // write actual data (batches are encoded in parallel)
+        const Size batch_size = std::max(options_.getMaxDataPoolSize(), (Size)1);
+        for (Size s_idx = 0; s_idx < exp.size(); s_idx += batch_size)
         {
-          logger_.setProgress(progress++);
-          const SpectrumType& spec = exp[s_idx];
-          writeSpectrum_(os, spec, s_idx, validator, renew_native_ids, dps);
+          logger_.setProgress(progress);
+          const Size batch_end = std::min(s_idx + batch_size, exp.size());
+          writeSpectra_(os, exp.getSpectra().begin() + s_idx, exp.getSpectra().begin() + batch_end, s_idx, validator, renew_native_ids, dps);
+          progress += batch_end - s_idx;
         }
         os << "\t\t</spectrumList>\n";
       }
@@ -3881,11 +3984,14 @@ namespace OpenMS
         // meta information needs to be stored here but the actual data is
         // stored somewhere else).
         os << "\t\t<chromatogramList count=\"" << exp.getChromatograms().size() << "\" defaultDataProcessingRef=\"dp_sp_0\">\n";
-        for (Size c_idx = 0; c_idx != exp.getChromatograms().size(); ++c_idx)
+        const std::vector<ChromatogramType>& chromatograms = exp.getChromatograms();
+        const Size batch_size = std::max(options_.getMaxDataPoolSize(), (Size)1);
+        for (Size c_idx = 0; c_idx < chromatograms.size(); c_idx += batch_size)
         {
-          logger_.setProgress(progress++);
-          const ChromatogramType& chromatogram = exp.getChromatograms()[c_idx];
-          writeChromatogram_(os, chromatogram, c_idx, validator);
+          logger_.setProgress(progress);
+          const Size batch_end = std::min(c_idx + batch_size, chromatograms.size());
+          writeChromatograms_(os, chromatograms.begin() + c_idx, chromatograms.begin() + batch_end, c_idx, validator);
+          progress += batch_end - c_idx;
         }
         os << "\t\t</chromatogramList>" << "\n";
       }
@@ -4833,6 +4939,75 @@ namespace OpenMS
                                      const Internal::MzMLValidator& validator,
                                      bool renew_native_ids,
                                      std::vector<std::vector< ConstDataProcessingPtr > >& dps)
+    {
+      long offset = os.tellp();
+      String native_id = writeSpectrumElement_(os, spec, s, validator, renew_native_ids, dps);
+      spectra_offsets_.push_back(make_pair(native_id, offset + 3));
+    }
+
+    void MzMLHandler::writeSpectra_(std::ostream& os,
+                                    std::vector<SpectrumType>::const_iterator first,
+                                    std::vector<SpectrumType>::const_iterator last,
+                                    Size first_idx,
+                                    const Internal::MzMLValidator& validator,
+                                    bool renew_native_ids,
+                                    std::vector<std::vector< ConstDataProcessingPtr > >& dps)
+    {
+      const Size count = last - first;
+      std::vector<std::string> texts(count);
+      std::vector<String> native_ids(count);
+
+      // format (and encode) the spectra in parallel, errors are reported
+      // after all spectra up to the first failing one have been written
+      std::exception_ptr error;
+      Size error_idx = count;
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic)
+#endif
+      for (SignedSize i = 0; i < (SignedSize)count; ++i)
+      {
+        try
+        {
+          std::ostringstream buffer;
+          buffer.flags(os.flags());
+          buffer.precision(os.precision());
+          buffer.imbue(os.getloc());
+          native_ids[i] = writeSpectrumElement_(buffer, *(first + i), first_idx + i, validator, renew_native_ids, dps);
+          texts[i] = buffer.str();
+        }
+        catch (...)
+        {
+#ifdef _OPENMP
+#pragma omp critical (MzMLHandlerWriteSpectra)
+#endif
+          if ((Size)i < error_idx)
+          {
+            error_idx = i;
+            error = std::current_exception();
+          }
+        }
+      }
+
+      // emit in order, the offsets are relative to the start of the file
+      for (Size i = 0; i < error_idx; ++i)
+      {
+        long offset = os.tellp();
+        os.write(texts[i].data(), texts[i].size());
+        spectra_offsets_.push_back(make_pair(native_ids[i], offset + 3));
+        std::string().swap(texts[i]);
+      }
+      if (error)
+      {
+        std::rethrow_exception(error);
+      }
+    }
+
+    String MzMLHandler::writeSpectrumElement_(std::ostream& os,
+                                              const SpectrumType& spec,
+                                              Size s,
+                                              const Internal::MzMLValidator& validator,
+                                              bool renew_native_ids,
+                                              std::vector<std::vector< ConstDataProcessingPtr > >& dps)
     {
       //native id
       String native_id = spec.getNativeID();
@@ -4841,10 +5016,7 @@ namespace OpenMS
         native_id = String("spectrum=") + s;
       }
 
-      long offset = os.tellp();
-      spectra_offsets_.push_back(make_pair(native_id, offset + 3));
-
-      // IMPORTANT make sure the offset (above) corresponds to the start of the <spectrum tag
+      // IMPORTANT make sure the offset recorded by the caller corresponds to the start of the <spectrum tag
       os << "\t\t\t<spectrum id=\"" << writeXMLEscape(native_id) << "\" index=\"" << s << "\" defaultArrayLength=\"" << spec.size() << "\"";
       if (spec.getSourceFile() != SourceFile())
       {
@@ -5147,6 +5319,7 @@ namespace OpenMS
       }
 
       os << "\t\t\t</spectrum>\n";
+      return native_id;
     }
 
     template <typename ContainerT>
@@ -5384,10 +5557,72 @@ namespace OpenMS
                                          const Internal::MzMLValidator& validator)
     {
       long offset = os.tellp();
+      writeChromatogramElement_(os, chromatogram, c, validator);
       chromatograms_offsets_.push_back(make_pair(chromatogram.getNativeID(), offset + 3));
+    }
 
+    void MzMLHandler::writeChromatograms_(std::ostream& os,
+                                          std::vector<ChromatogramType>::const_iterator first,
+                                          std::vector<ChromatogramType>::const_iterator last,
+                                          Size first_idx,
+                                          const Internal::MzMLValidator& validator)
+    {
+      const Size count = last - first;
+      std::vector<std::string> texts(count);
+
+      // format (and encode) the chromatograms in parallel, errors are
+      // reported after all chromatograms up to the first failing one have
+      // been written
+      std::exception_ptr error;
+      Size error_idx = count;
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic)
+#endif
+      for (SignedSize i = 0; i < (SignedSize)count; ++i)
+      {
+        try
+        {
+          std::ostringstream buffer;
+          buffer.flags(os.flags());
+          buffer.precision(os.precision());
+          buffer.imbue(os.getloc());
+          writeChromatogramElement_(buffer, *(first + i), first_idx + i, validator);
+          texts[i] = buffer.str();
+        }
+        catch (...)
+        {
+#ifdef _OPENMP
+#pragma omp critical (MzMLHandlerWriteChromatograms)
+#endif
+          if ((Size)i < error_idx)
+          {
+            error_idx = i;
+            error = std::current_exception();
+          }
+        }
+      }
+
+      // emit in order, the offsets are relative to the start of the file
+      for (Size i = 0; i < error_idx; ++i)
+      {
+        long offset = os.tellp();
+        os.write(texts[i].data(), texts[i].size());
+        chromatograms_offsets_.push_back(make_pair((first + i)->getNativeID(), offset + 3));
+        std::string().swap(texts[i]);
+      }
+      if (error)
+      {
+        std::rethrow_exception(error);
+      }
+    }
+
+    void MzMLHandler::writeChromatogramElement_(std::ostream& os,
+                                                const ChromatogramType& chromatogram,
+                                                Size c,
+                                                const Internal::MzMLValidator& validator)
+    {
       // TODO native id with chromatogram=?? prefix?
-      // IMPORTANT make sure the offset (above) corresponds to the start of the <chromatogram tag
+      // IMPORTANT make sure the offset recorded by the caller corresponds to the start of the <chromatogram tag
       os << "\t\t\t<chromatogram id=\"" << writeXMLEscape(chromatogram.getNativeID()) << "\" index=\"" << c << "\" defaultArrayLength=\"" << chromatogram.size() << "\">" << "\n";
 
       // write cvParams (chromatogram type)
@@ -44,6 +44,8 @@
 
 #include <QtCore/QFileInfo>
 
+#include <exception>
+
 // #include <type_traits> // for template arg detection
 #include <boost/type_traits.hpp>
 
@@ -56,6 +58,51 @@ namespace OpenMS
   namespace Internal
   {
 
+    /*
+     * Decodes a single binary data array as stored in an sqMass file into
+     * @p data. The @p uncompressed buffer is only used as scratch space.
+     *
+     * compression is one of 0 = no, 1 = zlib, 2 = np-linear, 3 = np-slof, 4 =
+     * np-pic, 5 = np-linear + zlib, 6 = np-slof + zlib, 7 = np-pic + zlib
+     */
+    static void decodeDataArray_(const std::string& raw, int compression, std::vector<double>& data, std::string& uncompressed)
+    {
+      if (compression == 1)
+      {
+        OpenMS::ZlibCompression::uncompressString(raw.data(), raw.size(), uncompressed);
+
+        void* byte_buffer = reinterpret_cast<void *>(&uncompressed[0]);
+        Size buffer_size = uncompressed.size();
+        const double * float_buffer = reinterpret_cast<const double *>(byte_buffer);
+        if (buffer_size % sizeof(double) != 0)
+        {
+          throw Exception::ConversionError(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "Bad BufferCount?");
+        }
+        Size float_count = buffer_size / sizeof(double);
+        // copy values
+        data.assign(float_buffer, float_buffer + float_count);
+      }
+      else if (compression == 5)
+      {
+        OpenMS::ZlibCompression::uncompressString(raw.data(), raw.size(), uncompressed);
+        MSNumpressCoder::NumpressConfig config;
+        config.setCompression("linear");
+        MSNumpressCoder().decodeNPRaw(uncompressed, data, config);
+      }
+      else if (compression == 6)
+      {
+        OpenMS::ZlibCompression::uncompressString(raw.data(), raw.size(), uncompressed);
+        MSNumpressCoder::NumpressConfig config;
+        config.setCompression("slof");
+        MSNumpressCoder().decodeNPRaw(uncompressed, data, config);
+      }
+      else
+      {
+        throw Exception::IllegalArgument(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, 
+            "Compression not supported");
+      }
+    }
+
     /*
      *
      * This function populates a set of empty data containers (MSSpectrum or
@@ -71,6 +118,11 @@ namespace OpenMS
      *
      * It is designed to work with containers of type MSSpectrum and
      * MSChromatogram to provide a single function for both use-cases.
+     *
+     * Rows are read from the statement in batches; the (expensive)
+     * decompression and decoding of the binary data of a batch happens in
+     * parallel if OpenMP is enabled while reading from the database is
+     * sequential.
      * 
      */
     template<class ContainerT>
@@ -81,130 +133,157 @@ namespace OpenMS
 
       std::vector<int> cont_data; cont_data.resize(containers.size());
       std::map<Size,Size> sql_container_map;
-      while (sqlite3_column_type( stmt, 0 ) != SQLITE_NULL)
-      {
-        Size id_orig = sqlite3_column_int( stmt, 0 );
 
-        // map the sql table id to the index in the "containers" vector
-        if (sql_container_map.find(id_orig) == sql_container_map.end()) 
+      // raw rows of the current batch (copied out of sqlite since the blob
+      // pointers are only valid until the next call to sqlite3_step)
+      const Size batch_size = 1000;
+      std::vector<Size> row_container;
+      std::vector<int> row_compression;
+      std::vector<int> row_data_type;
+      std::vector<std::string> row_blob;
+      std::vector<std::vector<double> > row_data;
+      row_container.reserve(batch_size);
+      row_compression.reserve(batch_size);
+      row_data_type.reserve(batch_size);
+      row_blob.reserve(batch_size);
+
+      bool finished = false;
+      while (!finished)
+      {
+        row_container.clear();
+        row_compression.clear();
+        row_data_type.clear();
+        row_blob.clear();
+        while (row_blob.size() < batch_size && sqlite3_column_type( stmt, 0 ) != SQLITE_NULL)
         {
-          Size tmp = sql_container_map.size();
-          sql_container_map[id_orig] = tmp;
-        }
-        Size curr_id = sql_container_map[id_orig];
+          Size id_orig = sqlite3_column_int( stmt, 0 );
 
-        const unsigned char * native_id_ = sqlite3_column_text(stmt, 1);
-        std::string native_id(reinterpret_cast<const char*>(native_id_), sqlite3_column_bytes(stmt, 1));
+          // map the sql table id to the index in the "containers" vector
+          if (sql_container_map.find(id_orig) == sql_container_map.end()) 
+          {
+            Size tmp = sql_container_map.size();
+            sql_container_map[id_orig] = tmp;
+          }
+          Size curr_id = sql_container_map[id_orig];
 
-        if (curr_id >= containers.size())
-        {
-          throw Exception::IllegalArgument(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, 
-              "Data for non-existent spectrum / chromatogram found");
-        }
-        if (native_id != containers[curr_id].getNativeID())
-        {
-          throw Exception::IllegalArgument(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, 
-              "Native id for spectrum / chromatogram doesnt match");
-        }
+          const unsigned char * native_id_ = sqlite3_column_text(stmt, 1);
+          std::string native_id(reinterpret_cast<const char*>(native_id_), sqlite3_column_bytes(stmt, 1));
 
-        int compression = sqlite3_column_int( stmt, 2 );
-        int data_type = sqlite3_column_int( stmt, 3 );
+          if (curr_id >= containers.size())
+          {
+            throw Exception::IllegalArgument(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, 
+                "Data for non-existent spectrum / chromatogram found");
+          }
+          if (native_id != containers[curr_id].getNativeID())
+          {
+            throw Exception::IllegalArgument(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, 
+                "Native id for spectrum / chromatogram doesnt match");
+          }
 
-        const void * raw_text = sqlite3_column_blob(stmt, 4);
-        size_t blob_bytes = sqlite3_column_bytes(stmt, 4);
+          const char * raw_text = reinterpret_cast<const char *>(sqlite3_column_blob(stmt, 4));
+          size_t blob_bytes = sqlite3_column_bytes(stmt, 4);
 
-        // data_type is one of 0 = mz, 1 = int, 2 = rt
-        // compression is one of 0 = no, 1 = zlib, 2 = np-linear, 3 = np-slof, 4 = np-pic, 5 = np-linear + zlib, 6 = np-slof + zlib, 7 = np-pic + zlib
-        std::vector<double> data;
-        if (compression == 1)
-        {
-          std::string uncompressed;
-          OpenMS::ZlibCompression::uncompressString(raw_text, blob_bytes, uncompressed);
+          row_container.push_back(curr_id);
+          row_compression.push_back(sqlite3_column_int( stmt, 2 ));
+          row_data_type.push_back(sqlite3_column_int( stmt, 3 ));
+          row_blob.push_back(std::string(raw_text, blob_bytes));
 
-          void* byte_buffer = reinterpret_cast<void *>(&uncompressed[0]);
-          Size buffer_size = uncompressed.size();
-          const double * float_buffer = reinterpret_cast<const double *>(byte_buffer);
-          if (buffer_size % sizeof(double) != 0)
-          {
-            throw Exception::ConversionError(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "Bad BufferCount?");
-          }
-          Size float_count = buffer_size / sizeof(double);
-          // copy values
-          data.assign(float_buffer, float_buffer + float_count);
-        }
-        else if (compression == 5)
-        {
-          std::string uncompressed;
-          OpenMS::ZlibCompression::uncompressString(raw_text, blob_bytes, uncompressed);
-          MSNumpressCoder::NumpressConfig config;
-          config.setCompression("linear");
-          MSNumpressCoder().decodeNPRaw(uncompressed, data, config);
-        }
-        else if (compression == 6)
-        {
-          std::string uncompressed;
-          OpenMS::ZlibCompression::uncompressString(raw_text, blob_bytes, uncompressed);
-          MSNumpressCoder::NumpressConfig config;
-          config.setCompression("slof");
-          MSNumpressCoder().decodeNPRaw(uncompressed, data, config);
-        }
-        else
-        {
-          throw Exception::IllegalArgument(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, 
-              "Compression not supported");
+          sqlite3_step( stmt );
         }
+        finished = (row_blob.size() < batch_size);
+        if (row_blob.empty()) break;
 
-        if (data_type == 1)
+        // decode all data arrays of the batch
+        row_data.resize(row_blob.size());
+        Size err_count(0);
+        std::exception_ptr err;
+#ifdef _OPENMP
+#pragma omp parallel
+#endif
         {
-          // intensity
-          if (containers[curr_id].empty()) containers[curr_id].resize(data.size());
-          std::vector< double >::iterator data_it = data.begin();
-          for (typename ContainerT::iterator it = containers[curr_id].begin(); it != containers[curr_id].end(); ++it, ++data_it)
+          // decoding buffers are re-used across rows to avoid allocating them
+          // for every single data array
+          std::string uncompressed;
+#ifdef _OPENMP
+#pragma omp for schedule(dynamic, 10)
+#endif
+          for (SignedSize k = 0; k < (SignedSize)row_blob.size(); ++k)
           {
-            it->setIntensity(*data_it);
+            try
+            {
+              decodeDataArray_(row_blob[k], row_compression[k], row_data[k], uncompressed);
+            }
+            catch (...)
+            {
+#ifdef _OPENMP
+#pragma omp critical (MzMLSqliteHandler_decode)
+#endif
+              {
+                if (err_count++ == 0) err = std::current_exception();
+              }
+            }
           }
-          cont_data[curr_id] += 1;
         }
-        else if (data_type == 0)
+        if (err_count > 0) std::rethrow_exception(err);
+
+        // copy the decoded data into the containers
+        for (Size k = 0; k < row_blob.size(); ++k)
         {
-          // mz (should only occur in spectra)
-          if (boost::is_same<ContainerT, MSChromatogram>::value) 
+          Size curr_id = row_container[k];
+          int data_type = row_data_type[k];
+          const std::vector<double>& data = row_data[k];
+
+          // data_type is one of 0 = mz, 1 = int, 2 = rt
+          if (data_type == 1)
           {
-            throw Exception::IllegalArgument(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, 
-                "Found m/z data type for spectra (instead of retention time)");
+            // intensity
+            if (containers[curr_id].empty()) containers[curr_id].resize(data.size());
+            std::vector< double >::const_iterator data_it = data.begin();
+            for (typename ContainerT::iterator it = containers[curr_id].begin(); it != containers[curr_id].end(); ++it, ++data_it)
+            {
+              it->setIntensity(*data_it);
+            }
+            cont_data[curr_id] += 1;
           }
-
-          if (containers[curr_id].empty()) containers[curr_id].resize(data.size());
-          std::vector< double >::iterator data_it = data.begin();
-          for (typename ContainerT::iterator it = containers[curr_id].begin(); it != containers[curr_id].end(); ++it, ++data_it)
+          else if (data_type == 0)
           {
-            it->setMZ(*data_it);
+            // mz (should only occur in spectra)
+            if (boost::is_same<ContainerT, MSChromatogram>::value) 
+            {
+              throw Exception::IllegalArgument(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, 
+                  "Found m/z data type for spectra (instead of retention time)");
+            }
+
+            if (containers[curr_id].empty()) containers[curr_id].resize(data.size());
+            std::vector< double >::const_iterator data_it = data.begin();
+            for (typename ContainerT::iterator it = containers[curr_id].begin(); it != containers[curr_id].end(); ++it, ++data_it)
+            {
+              it->setMZ(*data_it);
+            }
+            cont_data[curr_id] += 1;
           }
-          cont_data[curr_id] += 1;
-        }
-        else if (data_type == 2)
-        {
-          // rt (should only occur in chromatograms)
-          if (boost::is_same<ContainerT, MSSpectrum >::value) 
+          else if (data_type == 2)
           {
-            throw Exception::IllegalArgument(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, 
-                "Found retention time data type for spectra (instead of m/z)");
+            // rt (should only occur in chromatograms)
+            if (boost::is_same<ContainerT, MSSpectrum >::value) 
+            {
+              throw Exception::IllegalArgument(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, 
+                  "Found retention time data type for spectra (instead of m/z)");
+            }
+            if (containers[curr_id].empty()) containers[curr_id].resize(data.size());
+            std::vector< double >::const_iterator data_it = data.begin();
+            for (typename ContainerT::iterator it = containers[curr_id].begin(); it != containers[curr_id].end(); ++it, ++data_it)
+            {
+              it->setMZ(*data_it);
+            }
+            cont_data[curr_id] += 1;
           }
-          if (containers[curr_id].empty()) containers[curr_id].resize(data.size());
-          std::vector< double >::iterator data_it = data.begin();
-          for (typename ContainerT::iterator it = containers[curr_id].begin(); it != containers[curr_id].end(); ++it, ++data_it)
+          else
           {
-            it->setMZ(*data_it);
+            throw Exception::IllegalArgument(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, 
+                "Found data type other than RT/Intensity for spectra");
           }
-          cont_data[curr_id] += 1;
         }
-        else
-        {
-          throw Exception::IllegalArgument(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, 
-              "Found data type other than RT/Intensity for spectra");
-        }
-
-        sqlite3_step( stmt );
       }
 
       // ensure that all spectra/chromatograms have their data: we expect two data arrays per container (int and mz/rt)
@@ -217,6 +296,19 @@ namespace OpenMS
       }
     }
 
+    /// Returns the number of rows in @p table (used to reserve space before reading)
+    static Size countRows_(sqlite3 *db, const std::string& table)
+    {
+      sqlite3_stmt * stmt;
+      Size ret(0);
+      std::string select_sql = "SELECT COUNT(*) FROM " + table + ";";
+      if (sqlite3_prepare(db, select_sql.c_str(), -1, &stmt, nullptr) != SQLITE_OK) return ret;
+      sqlite3_step(stmt);
+      if (sqlite3_column_type(stmt, 0) != SQLITE_NULL) ret = sqlite3_column_int(stmt, 0);
+      sqlite3_finalize(stmt);
+      return ret;
+    }
+
     static int callback(void * /* NotUsed */, int argc, char **argv, char **azColName)
     {
       int i;
@@ -321,10 +413,13 @@ namespace OpenMS
         std::vector<MSSpectrum> spectra;
         prepareChroms_(db, chromatograms);
         prepareSpectra_(db, spectra);
-        exp.setChromatograms(chromatograms);
-        exp.setSpectra(spectra);
+        exp.setChromatograms(std::move(chromatograms));
+        exp.setSpectra(std::move(spectra));
       }
 
+      // most spectra share identical meta data, only keep it once
+      exp.shareSpectrumMetaData();
+
       if (meta_only) 
       {
         // free up connection
@@ -348,6 +443,7 @@ namespace OpenMS
       // creates the spectra but does not fill them with data (provides option to return meta-data only)
       std::vector<MSSpectrum> spectra;
       prepareSpectra_(db, spectra);
+      exp.reserve(exp.size() + indices.size());
       for (Size k = 0; k < indices.size(); k++)
       {
         exp.push_back(spectra[indices[k]]); // TODO make more efficient
@@ -370,16 +466,76 @@ namespace OpenMS
       std::vector<MSChromatogram> chroms;
       prepareChroms_(db, chroms);
 
+      Size offset = exp.size();
+      exp.reserve(exp.size() + indices.size());
       for (Size k = 0; k < indices.size(); k++)
       {
         exp.push_back(chroms[indices[k]]); // TODO make more efficient
       }
+
+      // free up connection (each worker below uses its own connection)
+      sqlite3_close(db);
       if (meta_only) {return;}
 
-      populateChromatogramsWithData_(db, exp, indices);
+      // Read the data in batches of chromatograms: every batch is read with a
+      // single "WHERE ID IN" query on its own connection, since sqlite3
+      // supports parallel reads as long as different connections are used.
+      const Size batch_size = 1000;
+      Size nr_batches = (indices.size() + batch_size - 1) / batch_size;
+      Size err_count(0);
+      std::exception_ptr err;
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic, 1)
+#endif
+      for (SignedSize b = 0; b < (SignedSize)nr_batches; ++b)
+      {
+        Size start = b * batch_size;
+        Size end = std::min(start + batch_size, indices.size());
+        std::vector<int> batch_indices(indices.begin() + start, indices.begin() + end);
+        std::vector<MSChromatogram> batch(std::make_move_iterator(exp.begin() + offset + start),
+                                          std::make_move_iterator(exp.begin() + offset + end));
+        sqlite3 *batch_db = nullptr;
+        try
+        {
+          batch_db = openDB();
+          populateChromatogramsWithData_(batch_db, batch, batch_indices);
+        }
+        catch (...)
+        {
+#ifdef _OPENMP
+#pragma omp critical (MzMLSqliteHandler_readChromatograms)
+#endif
+          {
+            if (err_count++ == 0) err = std::current_exception();
+          }
+        }
+        if (batch_db != nullptr) sqlite3_close(batch_db);
+        std::move(batch.begin(), batch.end(), exp.begin() + offset + start);
+      }
+      if (err_count > 0) std::rethrow_exception(err);
+    }
 
-      // free up connection
-      sqlite3_close(db);
+    void MzMLSqliteHandler::readChromatogramsInRTRange(std::vector<MSChromatogram> & exp, const std::vector<int> & indices, double rt_min, double rt_max) const
+    {
+      if (rt_min > rt_max)
+      {
+        throw Exception::IllegalArgument(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION,
+            String("Invalid retention time range [") + rt_min + ", " + rt_max + "]");
+      }
+
+      Size offset = exp.size();
+      readChromatograms(exp, indices, false);
+
+      // data arrays are stored as compressed blobs and can only be restricted
+      // after decoding them
+      for (Size k = offset; k < exp.size(); ++k)
+      {
+        MSChromatogram& chrom = exp[k];
+        MSChromatogram::Iterator first = chrom.RTBegin(rt_min);
+        MSChromatogram::Iterator last = chrom.RTEnd(first, rt_max, chrom.end());
+        chrom.erase(last, chrom.end());
+        chrom.erase(chrom.begin(), first);
+      }
     }
 
     Size MzMLSqliteHandler::getNrSpectra() const
@@ -654,6 +810,8 @@ namespace OpenMS
       // from sqlite3_column_blob(), sqlite3_column_text(), etc. into
       // sqlite3_free().
 
+      chromatograms.reserve(chromatograms.size() + countRows_(db, "CHROMATOGRAM"));
+
       sqlite3_prepare(db, select_sql.c_str(), -1, &stmt, nullptr);
       sqlite3_step( stmt );
 
@@ -692,7 +850,7 @@ namespace OpenMS
 
         chrom.setPrecursor(precursor);
         chrom.setProduct(product);
-        chromatograms.push_back(chrom);
+        chromatograms.push_back(std::move(chrom));
 
         sqlite3_step( stmt );
       }
@@ -736,6 +894,8 @@ namespace OpenMS
       // from sqlite3_column_blob(), sqlite3_column_text(), etc. into
       // sqlite3_free().
 
+      spectra.reserve(spectra.size() + countRows_(db, "SPECTRUM"));
+
       sqlite3_prepare(db, select_sql.c_str(), -1, &stmt, nullptr);
       sqlite3_step( stmt );
 
@@ -782,7 +942,7 @@ namespace OpenMS
 
         if (sqlite3_column_type(stmt, 6) != SQLITE_NULL) spec.getPrecursors().push_back(precursor);
         if (sqlite3_column_type(stmt, 11) != SQLITE_NULL) spec.getProducts().push_back(product);
-        spectra.push_back(spec);
+        spectra.push_back(std::move(spec));
 
         sqlite3_step( stmt );
       }
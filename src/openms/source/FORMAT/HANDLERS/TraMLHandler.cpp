@@ -61,6 +61,26 @@ namespace OpenMS
       cv_.loadFromOBO("PI", File::find("/CV/psi-ms.obo"));
     }
 
+    TraMLHandler::TraMLHandler(TargetedExperiment& exp, const TransitionConsumer& consumer, const String& filename, const String& version, const ProgressLogger& logger) :
+      XMLHandler(filename, version),
+      logger_(logger),
+      exp_(&exp),
+      cexp_(nullptr),
+      consumer_(consumer)
+    {
+      cv_.loadFromOBO("PI", File::find("/CV/psi-ms.obo"));
+    }
+
+    TraMLHandler::TraMLHandler(const TargetedExperiment& exp, const TransitionSupplier& supplier, const String& filename, const String& version, const ProgressLogger& logger) :
+      XMLHandler(filename, version),
+      logger_(logger),
+      exp_(nullptr),
+      cexp_(&exp),
+      supplier_(supplier)
+    {
+      cv_.loadFromOBO("PI", File::find("/CV/psi-ms.obo"));
+    }
+
     TraMLHandler::~TraMLHandler()
     {
     }
@@ -419,7 +439,14 @@ namespace OpenMS
       }
       else if (tag_ == "Transition")
       {
-        exp_->addTransition(actual_transition_);
+        if (consumer_)
+        {
+          consumer_(actual_transition_);
+        }
+        else
+        {
+          exp_->addTransition(actual_transition_);
+        }
         actual_transition_ = ReactionMonitoringTransition();
       }
       else if (tag_ == "Product")
@@ -758,7 +785,25 @@ namespace OpenMS
       //--------------------------------------------------------------------------------------------
       // transition list
       //--------------------------------------------------------------------------------------------
-      if (exp.getTransitions().size() > 0)
+      if (supplier_)
+      {
+        // the number of transitions is not known in advance, open the list
+        // only once the first transition is available
+        ReactionMonitoringTransition transition;
+        bool has_transitions = supplier_(transition);
+        if (has_transitions)
+        {
+          os << "  <TransitionList>" << "\n";
+          do
+          {
+            writeTransition_(os, transition);
+            transition = ReactionMonitoringTransition();
+          }
+          while (supplier_(transition));
+          os << "  </TransitionList>" << "\n";
+        }
+      }
+      else if (exp.getTransitions().size() > 0)
       {
         int progress = 0;
 
@@ -766,103 +811,7 @@ namespace OpenMS
         for (std::vector<ReactionMonitoringTransition>::const_iterator it = exp.getTransitions().begin(); it != exp.getTransitions().end(); ++it)
         {
           logger_.setProgress(progress++);
-          os << "    <Transition";
-          os << " id=\"" << writeXMLEscape(it->getName()) << "\"";
-
-          if (it->getPeptideRef() != "")
-          {
-            os << " peptideRef=\"" << writeXMLEscape(it->getPeptideRef()) << "\"";
-          }
-
-          if (it->getCompoundRef() != "")
-          {
-            os << " compoundRef=\"" << writeXMLEscape(it->getCompoundRef()) << "\"";
-          }
-          os << ">" << "\n";
-
-          // Precursor occurs exactly once (is required according to schema).
-          // CV term MS:1000827 MUST be supplied for the TransitionList path
-          os << "      <Precursor>" << "\n";
-          os << "        <cvParam cvRef=\"MS\" accession=\"MS:1000827\" name=\"isolation window target m/z\" value=\"" <<
-            precisionWrapper(it->getPrecursorMZ()) << "\" unitCvRef=\"MS\" unitAccession=\"MS:1000040\" unitName=\"m/z\"/>\n";
-          if (it->hasPrecursorCVTerms())
-          {
-            writeCVParams_(os, it->getPrecursorCVTermList(), 4);
-            writeUserParam_(os, (MetaInfoInterface)it->getPrecursorCVTermList(), 4);
-          }
-          os << "      </Precursor>" << "\n";
-
-          for (ProductListType::const_iterator prod_it = it->getIntermediateProducts().begin();
-               prod_it != it->getIntermediateProducts().end(); ++prod_it)
-          {
-            os << "      <IntermediateProduct>" << "\n";
-            writeProduct_(os, prod_it);
-            os << "      </IntermediateProduct>" << "\n";
-          }
-
-          // Product is required
-          os << "      <Product>" << "\n";
-          ProductListType dummy_vect;
-          dummy_vect.push_back(it->getProduct());
-          writeProduct_(os, dummy_vect.begin());
-          os << "      </Product>" << "\n";
-
-          const TargetedExperimentHelper::RetentionTime rit = it->getRetentionTime();
-          if (!rit.getCVTerms().empty())
-          {
-            writeRetentionTime_(os, rit);
-          }
-
-          if (it->hasPrediction())
-          {
-            os << "      <Prediction softwareRef=\"" << writeXMLEscape(it->getPrediction().software_ref) << "\"";
-            if (!it->getPrediction().contact_ref.empty())
-            {
-              os << " contactRef=\"" << writeXMLEscape(it->getPrediction().contact_ref) << "\"";
-            }
-            os << ">" << "\n";
-            writeCVParams_(os, it->getPrediction(), 4);
-            writeUserParam_(os, (MetaInfoInterface)it->getPrediction(), 4);
-            os << "      </Prediction>" << "\n";
-          }
-
-          writeCVParams_(os, *it, 3);
-          // Special CV Params
-          if (it->getLibraryIntensity() > -100)
-          {
-            os << "      <cvParam cvRef=\"MS\" accession=\"MS:1001226\" name=\"product ion intensity\" value=\"" <<  it->getLibraryIntensity() << "\"/>\n";
-          }
-          if (it->getDecoyTransitionType() != ReactionMonitoringTransition::UNKNOWN)
-          {
-            if (it->getDecoyTransitionType() == ReactionMonitoringTransition::TARGET)
-            {
-              os << "      <cvParam cvRef=\"MS\" accession=\"MS:1002007\" name=\"target SRM transition\"/>\n";
-            }
-            else if (it->getDecoyTransitionType() == ReactionMonitoringTransition::DECOY)
-            {
-              os << "      <cvParam cvRef=\"MS\" accession=\"MS:1002008\" name=\"decoy SRM transition\"/>\n";
-            }
-          }
-
-          // Output transition type (only write if non-default, otherwise assume default)
-          // Default is: true, false, true
-          // NOTE: do not change that, the same default is implicitly assumed in ReactionMonitoringTransition
-          if (!it->isDetectingTransition())
-          {
-              os << "      <userParam name=\"detecting_transition\" type=\"xsd:boolean\" value=\"false\"/>\n";
-          }
-          if (it->isIdentifyingTransition())
-          {
-              os << "      <userParam name=\"identifying_transition\" type=\"xsd:boolean\" value=\"true\"/>\n";
-          }
-          if (!it->isQuantifyingTransition())
-          {
-              os << "      <userParam name=\"quantifying_transition\" type=\"xsd:boolean\" value=\"false\"/>\n";
-          }
-
-          writeUserParam_(os, (MetaInfoInterface) * it, 3);
-
-          os << "    </Transition>" << "\n";
+          writeTransition_(os, *it);
         }
         os << "  </TransitionList>" << "\n";
 
@@ -902,6 +851,107 @@ namespace OpenMS
       return;
     }
 
+    void TraMLHandler::writeTransition_(std::ostream& os, const ReactionMonitoringTransition& transition) const
+    {
+      os << "    <Transition";
+      os << " id=\"" << writeXMLEscape(transition.getName()) << "\"";
+
+      if (transition.getPeptideRef() != "")
+      {
+        os << " peptideRef=\"" << writeXMLEscape(transition.getPeptideRef()) << "\"";
+      }
+
+      if (transition.getCompoundRef() != "")
+      {
+        os << " compoundRef=\"" << writeXMLEscape(transition.getCompoundRef()) << "\"";
+      }
+      os << ">" << "\n";
+
+      // Precursor occurs exactly once (is required according to schema).
+      // CV term MS:1000827 MUST be supplied for the TransitionList path
+      os << "      <Precursor>" << "\n";
+      os << "        <cvParam cvRef=\"MS\" accession=\"MS:1000827\" name=\"isolation window target m/z\" value=\"" <<
+        precisionWrapper(transition.getPrecursorMZ()) << "\" unitCvRef=\"MS\" unitAccession=\"MS:1000040\" unitName=\"m/z\"/>\n";
+      if (transition.hasPrecursorCVTerms())
+      {
+        writeCVParams_(os, transition.getPrecursorCVTermList(), 4);
+        writeUserParam_(os, (MetaInfoInterface)transition.getPrecursorCVTermList(), 4);
+      }
+      os << "      </Precursor>" << "\n";
+
+      for (ProductListType::const_iterator prod_it = transition.getIntermediateProducts().begin();
+           prod_it != transition.getIntermediateProducts().end(); ++prod_it)
+      {
+        os << "      <IntermediateProduct>" << "\n";
+        writeProduct_(os, prod_it);
+        os << "      </IntermediateProduct>" << "\n";
+      }
+
+      // Product is required
+      os << "      <Product>" << "\n";
+      ProductListType dummy_vect;
+      dummy_vect.push_back(transition.getProduct());
+      writeProduct_(os, dummy_vect.begin());
+      os << "      </Product>" << "\n";
+
+      const TargetedExperimentHelper::RetentionTime rit = transition.getRetentionTime();
+      if (!rit.getCVTerms().empty())
+      {
+        writeRetentionTime_(os, rit);
+      }
+
+      if (transition.hasPrediction())
+      {
+        os << "      <Prediction softwareRef=\"" << writeXMLEscape(transition.getPrediction().software_ref) << "\"";
+        if (!transition.getPrediction().contact_ref.empty())
+        {
+          os << " contactRef=\"" << writeXMLEscape(transition.getPrediction().contact_ref) << "\"";
+        }
+        os << ">" << "\n";
+        writeCVParams_(os, transition.getPrediction(), 4);
+        writeUserParam_(os, (MetaInfoInterface)transition.getPrediction(), 4);
+        os << "      </Prediction>" << "\n";
+      }
+
+      writeCVParams_(os, transition, 3);
+      // Special CV Params
+      if (transition.getLibraryIntensity() > -100)
+      {
+        os << "      <cvParam cvRef=\"MS\" accession=\"MS:1001226\" name=\"product ion intensity\" value=\"" <<  transition.getLibraryIntensity() << "\"/>\n";
+      }
+      if (transition.getDecoyTransitionType() != ReactionMonitoringTransition::UNKNOWN)
+      {
+        if (transition.getDecoyTransitionType() == ReactionMonitoringTransition::TARGET)
+        {
+          os << "      <cvParam cvRef=\"MS\" accession=\"MS:1002007\" name=\"target SRM transition\"/>\n";
+        }
+        else if (transition.getDecoyTransitionType() == ReactionMonitoringTransition::DECOY)
+        {
+          os << "      <cvParam cvRef=\"MS\" accession=\"MS:1002008\" name=\"decoy SRM transition\"/>\n";
+        }
+      }
+
+      // Output transition type (only write if non-default, otherwise assume default)
+      // Default is: true, false, true
+      // NOTE: do not change that, the same default is implicitly assumed in ReactionMonitoringTransition
+      if (!transition.isDetectingTransition())
+      {
+          os << "      <userParam name=\"detecting_transition\" type=\"xsd:boolean\" value=\"false\"/>\n";
+      }
+      if (transition.isIdentifyingTransition())
+      {
+          os << "      <userParam name=\"identifying_transition\" type=\"xsd:boolean\" value=\"true\"/>\n";
+      }
+      if (!transition.isQuantifyingTransition())
+      {
+          os << "      <userParam name=\"quantifying_transition\" type=\"xsd:boolean\" value=\"false\"/>\n";
+      }
+
+      writeUserParam_(os, (MetaInfoInterface) transition, 3);
+
+      os << "    </Transition>" << "\n";
+    }
+
     void TraMLHandler::writeRetentionTime_(std::ostream& os, const TargetedExperimentHelper::RetentionTime& rt) const
     {
       const TargetedExperimentHelper::RetentionTime* rit = &rt;
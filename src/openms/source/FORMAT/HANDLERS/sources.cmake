@@ -8,6 +8,7 @@ set(sources_list
   FidHandler.cpp
   IndexedMzMLDecoder.cpp
   IndexedMzMLHandler.cpp
+  IndexedMzXMLHandler.cpp
   MascotXMLHandler.cpp
   MzDataHandler.cpp
   MzIdentMLHandler.cpp
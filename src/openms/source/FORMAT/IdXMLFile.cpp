@@ -40,6 +40,7 @@
 #include <OpenMS/CONCEPT/PrecisionWrapper.h>
 #include <OpenMS/CHEMISTRY/ProteaseDB.h>
 #include <fstream>
+#include <sstream>
 #include <OpenMS/CONCEPT/Constants.h>
 
 using namespace std;
@@ -50,6 +51,7 @@ namespace OpenMS
   IdXMLFile::IdXMLFile() :
     XMLHandler("", "1.5"),
     XMLFile("/SCHEMAS/IdXML_1_5.xsd", "1.5"),
+    consumer_(nullptr),
     last_meta_(nullptr),
     document_id_(),
     prot_id_in_run_(false)
@@ -94,6 +96,27 @@ namespace OpenMS
     endProgress();
   }
 
+  void IdXMLFile::load(const String& filename, Interfaces::IDConsumer& consumer)
+  {
+    // protein identifications are few and needed during parsing, peptide
+    // identifications are passed on to the consumer and never stored
+    std::vector<ProteinIdentification> protein_ids;
+    std::vector<PeptideIdentification> peptide_ids;
+    String document_id;
+
+    consumer_ = &consumer;
+    try
+    {
+      load(filename, protein_ids, peptide_ids, document_id);
+    }
+    catch (...)
+    {
+      consumer_ = nullptr;
+      throw;
+    }
+    consumer_ = nullptr;
+  }
+
   void IdXMLFile::store(String filename, const std::vector<ProteinIdentification>& protein_ids, const std::vector<PeptideIdentification>& peptide_ids, const String& document_id)
   {
     if (!FileHandler::hasValidExtension(filename, FileTypes::IDXML))
@@ -117,16 +140,6 @@ namespace OpenMS
 
     os.precision(writtenDigits<double>(0.0));
 
-    // write header
-    os << "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n";
-    os << "<?xml-stylesheet type=\"text/xsl\" href=\"https://www.openms.de/xml-stylesheet/IdXML.xsl\" ?>\n";
-    os << "<IdXML version=\"" << getVersion() << "\"";
-    if (document_id != "")
-    {
-      os << " id=\"" << document_id << "\"";
-    }
-    os << " xsi:noNamespaceSchemaLocation=\"https://www.openms.de/xml-schema/IdXML_1_5.xsd\" xmlns:xsi=\"http://www.w3.org/2001/XMLSchema-instance\">\n";
-
     // look up different search parameters
     std::vector<ProteinIdentification::SearchParameters> params;
     for (std::vector<ProteinIdentification>::const_iterator it = protein_ids.begin(); it != protein_ids.end(); ++it)
@@ -137,57 +150,7 @@ namespace OpenMS
       }
     }
 
-    // write search parameters
-    for (Size i = 0; i != params.size(); ++i)
-    {
-      os << "\t<SearchParameters "
-         << "id=\"SP_" << i << "\" "
-         << "db=\"" << writeXMLEscape(params[i].db) << "\" "
-         << "db_version=\"" << writeXMLEscape(params[i].db_version) << "\" "
-         << "taxonomy=\"" << writeXMLEscape(params[i].taxonomy) << "\" ";
-      if (params[i].mass_type == ProteinIdentification::MONOISOTOPIC)
-      {
-        os << "mass_type=\"monoisotopic\" ";
-      }
-      else if (params[i].mass_type == ProteinIdentification::AVERAGE)
-      {
-        os << "mass_type=\"average\" ";
-      }
-      os << "charges=\"" << params[i].charges << "\" ";
-      String enzyme_name = params[i].digestion_enzyme.getName();
-      os << "enzyme=\"" << enzyme_name.toLower() << "\" ";
-      String precursor_unit = params[i].precursor_mass_tolerance_ppm ? "true" : "false";
-      String peak_unit = params[i].fragment_mass_tolerance_ppm ? "true" : "false";
-
-      os << "missed_cleavages=\"" << params[i].missed_cleavages << "\" "
-         << "precursor_peak_tolerance=\"" << params[i].precursor_mass_tolerance << "\" ";
-      os << "precursor_peak_tolerance_ppm=\"" << precursor_unit << "\" ";
-      os << "peak_mass_tolerance=\"" << params[i].fragment_mass_tolerance << "\" ";
-      os << "peak_mass_tolerance_ppm=\"" << peak_unit << "\" ";
-      os << ">\n";
-
-      //modifications
-      for (Size j = 0; j != params[i].fixed_modifications.size(); ++j)
-      {
-        os << "\t\t<FixedModification name=\"" << writeXMLEscape(params[i].fixed_modifications[j]) << "\" />\n";
-        //Add MetaInfo, when modifications has it (Andreas)
-      }
-      for (Size j = 0; j != params[i].variable_modifications.size(); ++j)
-      {
-        os << "\t\t<VariableModification name=\"" << writeXMLEscape(params[i].variable_modifications[j]) << "\" />\n";
-        //Add MetaInfo, when modifications has it (Andreas)
-      }
-
-      writeUserParam_("UserParam", os, params[i], 4);
-
-      os << "\t</SearchParameters>\n";
-    }
-
-    //empty search parameters
-    if (params.empty())
-    {
-      os << "<SearchParameters charges=\"+0, +0\" id=\"ID_1\" db_version=\"0\" mass_type=\"monoisotopic\" peak_mass_tolerance=\"0.0\" precursor_peak_tolerance=\"0.0\" db=\"Unknown\"/>\n";
-    }
+    writeHeader_(os, params, document_id);
 
     UInt prot_count = 0;
     std::map<String, UInt> accession_to_id;
@@ -200,72 +163,16 @@ namespace OpenMS
     {
       done_identifiers.push_back(protein_ids[i].getIdentifier());
 
-      os << "\t<IdentificationRun ";
-      os << "date=\"" << protein_ids[i].getDateTime().getDate() << "T" << protein_ids[i].getDateTime().getTime() << "\" ";
-      os << "search_engine=\"" << writeXMLEscape(protein_ids[i].getSearchEngine()) << "\" ";
-      os << "search_engine_version=\"" << writeXMLEscape(protein_ids[i].getSearchEngineVersion()) << "\" ";
-      // identifier
-      for (Size j = 0; j != params.size(); ++j)
-      {
-        if (params[j] == protein_ids[i].getSearchParameters())
-        {
-          os << "search_parameters_ref=\"SP_" << j << "\" ";
-          break;
-        }
-      }
-      os << ">\n";
-      os << "\t\t<ProteinIdentification ";
-      os << "score_type=\"" << writeXMLEscape(protein_ids[i].getScoreType()) << "\" ";
-      if (protein_ids[i].isHigherScoreBetter())
-      {
-        os << "higher_score_better=\"true\" ";
-      }
-      else
-      {
-        os << "higher_score_better=\"false\" ";
-      }
-      os << "significance_threshold=\"" << protein_ids[i].getSignificanceThreshold() << "\" >\n";
-
-      // write protein hits
-      for (Size j = 0; j < protein_ids[i].getHits().size(); ++j)
-      {
-        os << "\t\t\t<ProteinHit "
-           << "id=\"PH_" << prot_count << "\" "
-           << "accession=\"" << writeXMLEscape(protein_ids[i].getHits()[j].getAccession()) << "\" "
-           << "score=\"" << protein_ids[i].getHits()[j].getScore() << "\" ";
-        accession_to_id[protein_ids[i].getHits()[j].getAccession()] = prot_count;
-        ++prot_count;
-
-        double coverage = protein_ids[i].getHits()[j].getCoverage();
-        if (coverage != ProteinHit::COVERAGE_UNKNOWN)
-        {
-          os << "coverage=\"" << coverage << "\" ";
-        }
-
-        os << "sequence=\"" << writeXMLEscape(protein_ids[i].getHits()[j].getSequence()) << "\" >\n";
-        writeUserParam_("UserParam", os, protein_ids[i].getHits()[j], 4);
-        os << "\t\t\t</ProteinHit>\n";
-      }
-
-      // add ProteinGroup info to metavalues (hack)
-      MetaInfoInterface meta = protein_ids[i];
-      addProteinGroups_(meta, protein_ids[i].getProteinGroups(),
-                        "protein_group", accession_to_id);
-      addProteinGroups_(meta, protein_ids[i].getIndistinguishableProteins(),
-                        "indistinguishable_proteins", accession_to_id);
-      writeUserParam_("UserParam", os, meta, 3);
-
-      os << "\t\t</ProteinIdentification>\n";
+      writeIdentificationRunStart_(os, protein_ids[i], params, prot_count, accession_to_id);
 
       //write PeptideIdentifications
 
       Size count_wrong_id(0);
       Size count_empty(0);
 
+      std::vector<Size> indices;
       for (Size l = 0; l < peptide_ids.size(); ++l)
       {
-        setProgress(l);
-
         if (peptide_ids[l].getIdentifier() != protein_ids[i].getIdentifier())
         {
           ++count_wrong_id;
@@ -276,111 +183,54 @@ namespace OpenMS
           ++count_empty;
           continue;
         }
+        indices.push_back(l);
+      }
 
-        os << "\t\t<PeptideIdentification "
-           << "score_type=\"" << writeXMLEscape(peptide_ids[l].getScoreType()) << "\" ";
-        if (peptide_ids[l].isHigherScoreBetter())
-        {
-          os << "higher_score_better=\"true\" ";
-        }
-        else
-        {
-          os << "higher_score_better=\"false\" ";
-        }
-        os << "significance_threshold=\"" << peptide_ids[l].getSignificanceThreshold() << "\" ";
-        // mz
-        if (peptide_ids[l].hasMZ())
-        {
-          os << "MZ=\"" << peptide_ids[l].getMZ() << "\" ";
-        }
-        // rt
-        if (peptide_ids[l].hasRT())
-        {
-          os << "RT=\"" << peptide_ids[l].getRT() << "\" ";
-        }
-        // spectrum_reference
-        const DataValue& dv = peptide_ids[l].getMetaValue("spectrum_reference");
-        if (dv != DataValue::EMPTY)
-        {
-          os << "spectrum_reference=\"" << writeXMLEscape(dv.toString()) << "\" ";
-        }
-        os << ">\n";
-
-        // write peptide hits
-        std::vector<String> protein_accessions;
-
-        // copy current hit
-        PeptideIdentification pep_id = peptide_ids[l];
-
-        // sort by score
-        pep_id.sort();
-        const vector<PeptideHit> pep_hits = pep_id.getHits();
-
-        for (Size j = 0; j < pep_hits.size(); ++j)
+      // format batches of peptide identifications (in parallel) and write them in order
+      const Size batch_size = 10000;
+      std::vector<String> formatted;
+      for (Size batch_start = 0; batch_start < indices.size(); batch_start += batch_size)
+      {
+        const Size batch_end = std::min(indices.size(), batch_start + batch_size);
+        formatted.assign(batch_end - batch_start, String());
+
+        Size err_count(0);
+        std::exception_ptr err;
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic, 100)
+#endif
+        for (SignedSize k = 0; k < (SignedSize)formatted.size(); ++k)
         {
-          const PeptideHit& p_hit = pep_hits[j];
-          os << "\t\t\t<PeptideHit"
-             << " score=\"" << precisionWrapper(p_hit.getScore()) << "\""
-             << " sequence=\"" << writeXMLEscape(p_hit.getSequence().toString()) << "\""
-             << " charge=\"" << p_hit.getCharge() << "\"";
-
-          const std::vector<PeptideEvidence>& pes = p_hit.getPeptideEvidences();
-
-          os << createFlankingAAXMLString_(pes);
-          os << createPositionXMLString_(pes);
-
-          // Extract all protein accessions.
-          // Note: protein accessions correspond to neighboring AAs and start/end
-          // positions, so we have to keep the same order and allow duplicates
-          // (for peptides matching multiple times in the same protein)
-
-          protein_accessions.clear();
-          for (vector<PeptideEvidence>::const_iterator pe = pes.begin(); pe != pes.end(); ++pe)
-          {
-            const String& protein_accession = pe->getProteinAccession();
-
-            // empty accessions are not written out (legacy code)
-            if (!protein_accession.empty())
-            {
-              protein_accessions.push_back("PH_" + String(accession_to_id[protein_accession]));
-            }
-          }
-
-          if (!protein_accessions.empty())
+          try
           {
-            os << " protein_refs=\"" << ListUtils::concatenate(protein_accessions, " ") << "\"";
+            std::stringstream pep_os;
+            pep_os.precision(os.precision());
+            writePeptideIdentification_(pep_os, peptide_ids[indices[batch_start + k]], accession_to_id);
+            formatted[k] = pep_os.str();
           }
-
-          os << " >\n";
-          writeFragmentAnnotations_("UserParam", os, p_hit.getPeakAnnotations(), 4);
-          writeUserParam_("UserParam", os, p_hit, 4);
-
-          // write out the (optional) peptide prophet / interprophet results as UserParams
+          catch (...)
           {
-            int k = 0;
-            for (std::vector<PeptideHit::PepXMLAnalysisResult>::const_iterator ar_it = p_hit.getAnalysisResults().begin();
-                ar_it != p_hit.getAnalysisResults().end(); ++ar_it, ++k)
+#ifdef _OPENMP
+#pragma omp critical (IdXMLFile_store)
+#endif
             {
-              os << "\t\t\t\t<UserParam type=\"string\" name=\"_ar_" << k << "_score_type\" value=\"" << ar_it->score_type << "\"/>" << "\n";
-              os << "\t\t\t\t<UserParam type=\"float\" name=\"_ar_" << k << "_score\" value=\"" << ar_it->main_score << "\"/>" << "\n";
-              if (!ar_it->sub_scores.empty())
+              if (err_count++ == 0)
               {
-                for (std::map<String, double>::const_iterator subscore_it = ar_it->sub_scores.begin();
-                    subscore_it != ar_it->sub_scores.end(); ++subscore_it)
-                {
-                  os << "\t\t\t\t<UserParam type=\"float\" name=\"_ar_" << k << "_subscore_" << subscore_it->first <<"\" value=\"" << subscore_it->second << "\"/>" << "\n";
-                }
+                err = std::current_exception();
               }
             }
-
           }
-          os << "\t\t\t</PeptideHit>\n";
+        }
+        if (err_count != 0)
+        {
+          std::rethrow_exception(err);
         }
 
-        // do not write "spectrum_reference" since it is written as attribute already
-        pep_id.removeMetaValue("spectrum_reference");
-        writeUserParam_("UserParam", os, pep_id, 3);
-        os << "\t\t</PeptideIdentification>\n";
+        for (Size k = 0; k < formatted.size(); ++k)
+        {
+          os << formatted[k];
+        }
+        setProgress(indices[batch_end - 1]);
       }
 
       os << "\t</IdentificationRun>\n";
@@ -425,6 +275,240 @@ namespace OpenMS
     proteinid_to_accession_.clear();
   }
 
+  void IdXMLFile::writeHeader_(std::ostream& os, const std::vector<ProteinIdentification::SearchParameters>& params, const String& document_id)
+  {
+    // write header
+    os << "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n";
+    os << "<?xml-stylesheet type=\"text/xsl\" href=\"https://www.openms.de/xml-stylesheet/IdXML.xsl\" ?>\n";
+    os << "<IdXML version=\"" << getVersion() << "\"";
+    if (document_id != "")
+    {
+      os << " id=\"" << document_id << "\"";
+    }
+    os << " xsi:noNamespaceSchemaLocation=\"https://www.openms.de/xml-schema/IdXML_1_5.xsd\" xmlns:xsi=\"http://www.w3.org/2001/XMLSchema-instance\">\n";
+
+    // write search parameters
+    for (Size i = 0; i != params.size(); ++i)
+    {
+      os << "\t<SearchParameters "
+         << "id=\"SP_" << i << "\" "
+         << "db=\"" << writeXMLEscape(params[i].db) << "\" "
+         << "db_version=\"" << writeXMLEscape(params[i].db_version) << "\" "
+         << "taxonomy=\"" << writeXMLEscape(params[i].taxonomy) << "\" ";
+      if (params[i].mass_type == ProteinIdentification::MONOISOTOPIC)
+      {
+        os << "mass_type=\"monoisotopic\" ";
+      }
+      else if (params[i].mass_type == ProteinIdentification::AVERAGE)
+      {
+        os << "mass_type=\"average\" ";
+      }
+      os << "charges=\"" << params[i].charges << "\" ";
+      String enzyme_name = params[i].digestion_enzyme.getName();
+      os << "enzyme=\"" << enzyme_name.toLower() << "\" ";
+      String precursor_unit = params[i].precursor_mass_tolerance_ppm ? "true" : "false";
+      String peak_unit = params[i].fragment_mass_tolerance_ppm ? "true" : "false";
+
+      os << "missed_cleavages=\"" << params[i].missed_cleavages << "\" "
+         << "precursor_peak_tolerance=\"" << params[i].precursor_mass_tolerance << "\" ";
+      os << "precursor_peak_tolerance_ppm=\"" << precursor_unit << "\" ";
+      os << "peak_mass_tolerance=\"" << params[i].fragment_mass_tolerance << "\" ";
+      os << "peak_mass_tolerance_ppm=\"" << peak_unit << "\" ";
+      os << ">\n";
+
+      //modifications
+      for (Size j = 0; j != params[i].fixed_modifications.size(); ++j)
+      {
+        os << "\t\t<FixedModification name=\"" << writeXMLEscape(params[i].fixed_modifications[j]) << "\" />\n";
+        //Add MetaInfo, when modifications has it (Andreas)
+      }
+      for (Size j = 0; j != params[i].variable_modifications.size(); ++j)
+      {
+        os << "\t\t<VariableModification name=\"" << writeXMLEscape(params[i].variable_modifications[j]) << "\" />\n";
+        //Add MetaInfo, when modifications has it (Andreas)
+      }
+
+      writeUserParam_("UserParam", os, params[i], 4);
+
+      os << "\t</SearchParameters>\n";
+    }
+
+    //empty search parameters
+    if (params.empty())
+    {
+      os << "<SearchParameters charges=\"+0, +0\" id=\"ID_1\" db_version=\"0\" mass_type=\"monoisotopic\" peak_mass_tolerance=\"0.0\" precursor_peak_tolerance=\"0.0\" db=\"Unknown\"/>\n";
+    }
+  }
+
+  void IdXMLFile::writeIdentificationRunStart_(std::ostream& os, const ProteinIdentification& prot_id, const std::vector<ProteinIdentification::SearchParameters>& params, UInt& prot_count, std::map<String, UInt>& accession_to_id)
+  {
+    os << "\t<IdentificationRun ";
+    os << "date=\"" << prot_id.getDateTime().getDate() << "T" << prot_id.getDateTime().getTime() << "\" ";
+    os << "search_engine=\"" << writeXMLEscape(prot_id.getSearchEngine()) << "\" ";
+    os << "search_engine_version=\"" << writeXMLEscape(prot_id.getSearchEngineVersion()) << "\" ";
+    // identifier
+    for (Size j = 0; j != params.size(); ++j)
+    {
+      if (params[j] == prot_id.getSearchParameters())
+      {
+        os << "search_parameters_ref=\"SP_" << j << "\" ";
+        break;
+      }
+    }
+    os << ">\n";
+    os << "\t\t<ProteinIdentification ";
+    os << "score_type=\"" << writeXMLEscape(prot_id.getScoreType()) << "\" ";
+    if (prot_id.isHigherScoreBetter())
+    {
+      os << "higher_score_better=\"true\" ";
+    }
+    else
+    {
+      os << "higher_score_better=\"false\" ";
+    }
+    os << "significance_threshold=\"" << prot_id.getSignificanceThreshold() << "\" >\n";
+
+    // write protein hits
+    for (Size j = 0; j < prot_id.getHits().size(); ++j)
+    {
+      os << "\t\t\t<ProteinHit "
+         << "id=\"PH_" << prot_count << "\" "
+         << "accession=\"" << writeXMLEscape(prot_id.getHits()[j].getAccession()) << "\" "
+         << "score=\"" << prot_id.getHits()[j].getScore() << "\" ";
+      accession_to_id[prot_id.getHits()[j].getAccession()] = prot_count;
+      ++prot_count;
+
+      double coverage = prot_id.getHits()[j].getCoverage();
+      if (coverage != ProteinHit::COVERAGE_UNKNOWN)
+      {
+        os << "coverage=\"" << coverage << "\" ";
+      }
+
+      os << "sequence=\"" << writeXMLEscape(prot_id.getHits()[j].getSequence()) << "\" >\n";
+      writeUserParam_("UserParam", os, prot_id.getHits()[j], 4);
+      os << "\t\t\t</ProteinHit>\n";
+    }
+
+    // add ProteinGroup info to metavalues (hack)
+    MetaInfoInterface meta = prot_id;
+    addProteinGroups_(meta, prot_id.getProteinGroups(),
+                      "protein_group", accession_to_id);
+    addProteinGroups_(meta, prot_id.getIndistinguishableProteins(),
+                      "indistinguishable_proteins", accession_to_id);
+    writeUserParam_("UserParam", os, meta, 3);
+
+    os << "\t\t</ProteinIdentification>\n";
+  }
+
+  void IdXMLFile::writePeptideIdentification_(std::ostream& os, const PeptideIdentification& pep_id_in, const std::map<String, UInt>& accession_to_id) const
+  {
+    os << "\t\t<PeptideIdentification "
+       << "score_type=\"" << writeXMLEscape(pep_id_in.getScoreType()) << "\" ";
+    if (pep_id_in.isHigherScoreBetter())
+    {
+      os << "higher_score_better=\"true\" ";
+    }
+    else
+    {
+      os << "higher_score_better=\"false\" ";
+    }
+    os << "significance_threshold=\"" << pep_id_in.getSignificanceThreshold() << "\" ";
+    // mz
+    if (pep_id_in.hasMZ())
+    {
+      os << "MZ=\"" << pep_id_in.getMZ() << "\" ";
+    }
+    // rt
+    if (pep_id_in.hasRT())
+    {
+      os << "RT=\"" << pep_id_in.getRT() << "\" ";
+    }
+    // spectrum_reference
+    const DataValue& dv = pep_id_in.getMetaValue("spectrum_reference");
+    if (dv != DataValue::EMPTY)
+    {
+      os << "spectrum_reference=\"" << writeXMLEscape(dv.toString()) << "\" ";
+    }
+    os << ">\n";
+
+    // write peptide hits
+    std::vector<String> protein_accessions;
+
+    // copy current hit
+    PeptideIdentification pep_id = pep_id_in;
+
+    // sort by score
+    pep_id.sort();
+    const vector<PeptideHit> pep_hits = pep_id.getHits();
+
+    for (Size j = 0; j < pep_hits.size(); ++j)
+    {
+      const PeptideHit& p_hit = pep_hits[j];
+      os << "\t\t\t<PeptideHit"
+         << " score=\"" << precisionWrapper(p_hit.getScore()) << "\""
+         << " sequence=\"" << writeXMLEscape(p_hit.getSequence().toString()) << "\""
+         << " charge=\"" << p_hit.getCharge() << "\"";
+
+      const std::vector<PeptideEvidence>& pes = p_hit.getPeptideEvidences();
+
+      os << createFlankingAAXMLString_(pes);
+      os << createPositionXMLString_(pes);
+
+      // Extract all protein accessions.
+      // Note: protein accessions correspond to neighboring AAs and start/end
+      // positions, so we have to keep the same order and allow duplicates
+      // (for peptides matching multiple times in the same protein)
+
+      protein_accessions.clear();
+      for (vector<PeptideEvidence>::const_iterator pe = pes.begin(); pe != pes.end(); ++pe)
+      {
+        const String& protein_accession = pe->getProteinAccession();
+
+        // empty accessions are not written out (legacy code)
+        if (!protein_accession.empty())
+        {
+          std::map<String, UInt>::const_iterator acc_it = accession_to_id.find(protein_accession);
+          protein_accessions.push_back("PH_" + String(acc_it != accession_to_id.end() ? acc_it->second : 0));
+        }
+      }
+
+      if (!protein_accessions.empty())
+      {
+        os << " protein_refs=\"" << ListUtils::concatenate(protein_accessions, " ") << "\"";
+      }
+
+      os << " >\n";
+      writeFragmentAnnotations_("UserParam", os, p_hit.getPeakAnnotations(), 4);
+      writeUserParam_("UserParam", os, p_hit, 4);
+
+      // write out the (optional) peptide prophet / interprophet results as UserParams
+      {
+        int k = 0;
+        for (std::vector<PeptideHit::PepXMLAnalysisResult>::const_iterator ar_it = p_hit.getAnalysisResults().begin();
+            ar_it != p_hit.getAnalysisResults().end(); ++ar_it, ++k)
+        {
+          os << "\t\t\t\t<UserParam type=\"string\" name=\"_ar_" << k << "_score_type\" value=\"" << ar_it->score_type << "\"/>" << "\n";
+          os << "\t\t\t\t<UserParam type=\"float\" name=\"_ar_" << k << "_score\" value=\"" << ar_it->main_score << "\"/>" << "\n";
+          if (!ar_it->sub_scores.empty())
+          {
+            for (std::map<String, double>::const_iterator subscore_it = ar_it->sub_scores.begin();
+                subscore_it != ar_it->sub_scores.end(); ++subscore_it)
+            {
+              os << "\t\t\t\t<UserParam type=\"float\" name=\"_ar_" << k << "_subscore_" << subscore_it->first <<"\" value=\"" << subscore_it->second << "\"/>" << "\n";
+            }
+          }
+        }
+
+      }
+      os << "\t\t\t</PeptideHit>\n";
+    }
+
+    // do not write "spectrum_reference" since it is written as attribute already
+    pep_id.removeMetaValue("spectrum_reference");
+    writeUserParam_("UserParam", os, pep_id, 3);
+    os << "\t\t</PeptideIdentification>\n";
+  }
+
   void IdXMLFile::startElement(const XMLCh* const /*uri*/, const XMLCh* const /*local_name*/, const XMLCh* const qname, const xercesc::Attributes& attributes)
   {
     String tag = sm_.convert(qname);
@@ -846,6 +930,10 @@ namespace OpenMS
                         "indistinguishable_proteins");
 
       prot_ids_->push_back(prot_id_);
+      if (consumer_ != nullptr)
+      {
+        consumer_->consumeProteinID(prot_ids_->back());
+      }
       prot_id_ = ProteinIdentification();
       last_meta_  = nullptr;
       prot_id_in_run_ = true;
@@ -856,6 +944,10 @@ namespace OpenMS
       {
         // add empty <ProteinIdentification> if there was none so far (that's where the IdentificationRun parameters are stored)
         prot_ids_->push_back(prot_id_);
+        if (consumer_ != nullptr)
+        {
+          consumer_->consumeProteinID(prot_ids_->back());
+        }
       }
       prot_id_ = ProteinIdentification();
       last_meta_ = nullptr;
@@ -869,7 +961,14 @@ namespace OpenMS
     //PEPTIDES
     else if (tag == "PeptideIdentification")
     {
-      pep_ids_->push_back(pep_id_);
+      if (consumer_ != nullptr)
+      {
+        consumer_->consumePeptideID(pep_id_);
+      }
+      else
+      {
+        pep_ids_->push_back(pep_id_);
+      }
       pep_id_ = PeptideIdentification();
       last_meta_  = nullptr;
     }
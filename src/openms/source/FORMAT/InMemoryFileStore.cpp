@@ -0,0 +1,160 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2018.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: Timo Sachsenberg $
+// $Authors: Timo Sachsenberg $
+// --------------------------------------------------------------------------
+
+#include <OpenMS/FORMAT/InMemoryFileStore.h>
+
+#include <OpenMS/CONCEPT/Exception.h>
+
+#include <algorithm>
+#include <map>
+#include <memory>
+#include <mutex>
+
+namespace OpenMS
+{
+  namespace
+  {
+    std::mutex store_mutex;
+    std::map<String, std::shared_ptr<const PeakMap> > peak_maps;
+    std::map<String, std::shared_ptr<const FeatureMap> > feature_maps;
+    std::map<String, std::shared_ptr<const ConsensusMap> > consensus_maps;
+
+    template <typename MapType>
+    void storeEntry(std::map<String, std::shared_ptr<const MapType> >& entries, const String& filename, const MapType& data)
+    {
+      if (!InMemoryFileStore::isMemoryPath(filename))
+      {
+        throw Exception::UnableToCreateFile(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, filename, "in-memory file names have to start with '" + InMemoryFileStore::PREFIX + "'");
+      }
+      // copy outside of the lock
+      std::shared_ptr<const MapType> copy = std::make_shared<const MapType>(data);
+      std::lock_guard<std::mutex> lock(store_mutex);
+      // an entry has exactly one type
+      peak_maps.erase(filename);
+      feature_maps.erase(filename);
+      consensus_maps.erase(filename);
+      entries[filename] = copy;
+    }
+
+    template <typename MapType>
+    void loadEntry(const std::map<String, std::shared_ptr<const MapType> >& entries, const String& filename, MapType& data)
+    {
+      std::shared_ptr<const MapType> entry;
+      {
+        std::lock_guard<std::mutex> lock(store_mutex);
+        typename std::map<String, std::shared_ptr<const MapType> >::const_iterator it = entries.find(filename);
+        if (it != entries.end()) entry = it->second;
+      }
+      if (!entry)
+      {
+        throw Exception::FileNotFound(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, filename);
+      }
+      // copy outside of the lock (the entry stays alive even if it is removed meanwhile)
+      data = *entry;
+    }
+  }
+
+  const String InMemoryFileStore::PREFIX = "mem:";
+
+  bool InMemoryFileStore::isMemoryPath(const String& filename)
+  {
+    return filename.hasPrefix(PREFIX);
+  }
+
+  bool InMemoryFileStore::exists(const String& filename)
+  {
+    std::lock_guard<std::mutex> lock(store_mutex);
+    return peak_maps.count(filename) > 0 || feature_maps.count(filename) > 0 || consensus_maps.count(filename) > 0;
+  }
+
+  void InMemoryFileStore::store(const String& filename, const PeakMap& data)
+  {
+    storeEntry(peak_maps, filename, data);
+  }
+
+  void InMemoryFileStore::store(const String& filename, const FeatureMap& data)
+  {
+    storeEntry(feature_maps, filename, data);
+  }
+
+  void InMemoryFileStore::store(const String& filename, const ConsensusMap& data)
+  {
+    storeEntry(consensus_maps, filename, data);
+  }
+
+  void InMemoryFileStore::load(const String& filename, PeakMap& data)
+  {
+    loadEntry(peak_maps, filename, data);
+  }
+
+  void InMemoryFileStore::load(const String& filename, FeatureMap& data)
+  {
+    loadEntry(feature_maps, filename, data);
+  }
+
+  void InMemoryFileStore::load(const String& filename, ConsensusMap& data)
+  {
+    loadEntry(consensus_maps, filename, data);
+  }
+
+  void InMemoryFileStore::remove(const String& filename)
+  {
+    std::lock_guard<std::mutex> lock(store_mutex);
+    peak_maps.erase(filename);
+    feature_maps.erase(filename);
+    consensus_maps.erase(filename);
+  }
+
+  void InMemoryFileStore::clear()
+  {
+    std::lock_guard<std::mutex> lock(store_mutex);
+    peak_maps.clear();
+    feature_maps.clear();
+    consensus_maps.clear();
+  }
+
+  std::vector<String> InMemoryFileStore::getNames()
+  {
+    std::vector<String> names;
+    {
+      std::lock_guard<std::mutex> lock(store_mutex);
+      for (const auto& e : peak_maps) names.push_back(e.first);
+      for (const auto& e : feature_maps) names.push_back(e.first);
+      for (const auto& e : consensus_maps) names.push_back(e.first);
+    }
+    std::sort(names.begin(), names.end());
+    return names;
+  }
+
+} // namespace OpenMS
@@ -76,15 +76,8 @@ namespace OpenMS
     QByteArray base64_uncompressed;
     Base64::decodeSingleString(in, base64_uncompressed, zlib_compression);
 
-    // Create a temporary string (*not* null-terminated) to hold the data
-    std::string tmpstring(base64_uncompressed.constData(), base64_uncompressed.size());
-    decodeNPRaw(tmpstring, out, config);
-
-    // NOTE: it is possible (and likely faster) to call directly the const
-    // unsigned char * function but this would make it necessary to deal with
-    // reinterpret_cast ugliness here ... 
-    //
-    // decodeNP_internal_(reinterpret_cast<const unsigned char*>(base64_uncompressed.constData()), base64_uncompressed.size(), out, config);
+    // decode directly from the buffer (avoids copying the data into a temporary string)
+    decodeNPInternal_(reinterpret_cast<const unsigned char*>(base64_uncompressed.constData()), base64_uncompressed.size(), out, config);
   }
 
   void MSNumpressCoder::encodeNPRaw(const std::vector<double>& in, String& result, const NumpressConfig & config)
@@ -136,16 +129,16 @@ namespace OpenMS
       {
         if (config.estimate_fixed_point)
         {
-          // estimate fixed point either by mass accuracy or by using maximal permissible value
+          // estimate fixed point either by mass accuracy or by using maximal
+          // permissible value (the data is only scanned once, the result is
+          // the same as optimalLinearFixedPointMass with fallback to
+          // optimalLinearFixedPoint if the accuracy cannot be achieved)
+          fixedPoint = numpress::MSNumpress::optimalLinearFixedPoint(&in[0], dataSize);
           if (config.linear_fp_mass_acc > 0)
           {
-            fixedPoint = numpress::MSNumpress::optimalLinearFixedPointMass(&in[0], dataSize, config.linear_fp_mass_acc);
-            // catch failure
-            if (fixedPoint < 0.0) fixedPoint = numpress::MSNumpress::optimalLinearFixedPoint(&in[0], dataSize);
-          }
-          else
-          {
-            fixedPoint = numpress::MSNumpress::optimalLinearFixedPoint(&in[0], dataSize);
+            const double mass_fixed_point = 0.5 / config.linear_fp_mass_acc;
+            if (dataSize < 3) fixedPoint = 0.0; // the first two points are encoded as they are
+            else if (!(mass_fixed_point > fixedPoint)) fixedPoint = mass_fixed_point;
           }
         }
         byteCount = numpress::MSNumpress::encodeLinear(&in[0], dataSize, &numpressed[0], fixedPoint);
@@ -267,10 +267,10 @@ namespace OpenMS
         }
         else
         {
+          vector<StringView> split; // views into 'line', re-used for all peaks
           while (getline(is, line) && ++line_number && line.size() > 0 && isdigit(line[0]))
           {
-            vector<String> split;
-            line.split('\t', split);
+            StringView(line).split('\t', split);
             Peak1D peak;
             if (spectrast_format && split.size() != 4)
             {
@@ -286,7 +286,7 @@ namespace OpenMS
             peak.setIntensity(split[1].toFloat());
             if (parse_peakinfo)
             {
-              spec.getStringDataArrays()[0].push_back(split[2]);
+              spec.getStringDataArrays()[0].push_back(split[2].getString());
             }
             spec.push_back(peak);
           }
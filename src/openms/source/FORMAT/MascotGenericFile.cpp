@@ -46,6 +46,12 @@
 #include <QFileInfo>
 #include <QtCore/QRegExp>
 
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+
+#include <cstring>
+#include <sstream>
+
 #define HIGH_PRECISION 5
 #define LOW_PRECISION 3
 
@@ -134,6 +140,136 @@ namespace OpenMS
     }
   }
 
+  namespace
+  {
+    /// end of the line starting at @p pos (position of its '\n' or @p end)
+    inline const char* lineEnd(const char* pos, const char* end)
+    {
+      const void* newline = memchr(pos, '\n', end - pos);
+      return newline ? static_cast<const char*>(newline) : end;
+    }
+
+    /// start of the next line (or @p end)
+    inline const char* nextLine(const char* pos, const char* end)
+    {
+      const char* line_end = lineEnd(pos, end);
+      return line_end == end ? end : line_end + 1;
+    }
+
+    /**
+      @brief finds the first line at or after @p pos that consists of @p keyword (apart from surrounding whitespace)
+
+      Only the first character of @p keyword is searched for (using memchr),
+      so lines of other content are skipped quickly. @p pos has to be the start
+      of a line.
+
+      @return start of the matching line or @p end if there is none
+    */
+    const char* findKeywordLine(const char* pos, const char* end, const StringView& keyword)
+    {
+      const char* search = pos;
+      while (search != end)
+      {
+        const void* hit = memchr(search, keyword[0], end - search);
+        if (!hit) break;
+        const char* candidate = static_cast<const char*>(hit);
+        if (Size(end - candidate) >= keyword.size() && memcmp(candidate, keyword.data(), keyword.size()) == 0)
+        {
+          const char* line_start = candidate;
+          while (line_start != pos && *(line_start - 1) != '\n') --line_start;
+          if (StringView(line_start, lineEnd(candidate, end) - line_start).trim() == keyword)
+          {
+            return line_start;
+          }
+        }
+        search = candidate + 1;
+      }
+      return end;
+    }
+  }
+
+  std::shared_ptr<const void> MascotGenericFile::findSpectrumBlocks_(const String& filename, std::vector<SpectrumBlock_>& blocks)
+  {
+    if (!File::exists(filename))
+    {
+      throw Exception::FileNotFound(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, filename);
+    }
+
+    blocks.clear();
+    if (QFileInfo(filename.toQString()).size() == 0)
+    {
+      return std::shared_ptr<const void>(); // an empty file cannot be mapped
+    }
+
+    std::shared_ptr<boost::interprocess::mapped_region> region;
+    try
+    {
+      boost::interprocess::file_mapping mapping(filename.c_str(), boost::interprocess::read_only);
+      region = std::make_shared<boost::interprocess::mapped_region>(mapping, boost::interprocess::read_only);
+    }
+    catch (boost::interprocess::interprocess_exception& e)
+    {
+      throw Exception::FileNotReadable(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, filename + " (" + e.what() + ")");
+    }
+
+    const char* begin = static_cast<const char*>(region->get_address());
+    const char* end = begin + region->get_size();
+    const StringView begin_ions("BEGIN IONS", 10);
+    const StringView end_ions("END IONS", 8);
+
+    // line numbers are only needed in error messages, so newlines are counted once per block
+    Size newlines = 0;
+    const char* counted = begin;
+
+    const char* pos = begin;
+    while (true)
+    {
+      const char* block_start = findKeywordLine(pos, end, begin_ions);
+      if (block_start == end) break;
+
+      SpectrumBlock_ block;
+      newlines += std::count(counted, block_start, '\n');
+      counted = block_start;
+      block.line_number = newlines + 1;
+      block.begin = nextLine(block_start, end);
+
+      // parameters (and everything else) up to the first data line belong to the spectrum
+      pos = block.begin;
+      while (pos != end)
+      {
+        StringView line = StringView(pos, lineEnd(pos, end) - pos).trim();
+        if (!line.empty() && isdigit(line[0])) break;
+        pos = nextLine(pos, end);
+      }
+      block.has_data = pos != end;
+      block.end = block.has_data ? findKeywordLine(pos, end, end_ions) : end;
+      block.complete = block.end != end;
+      blocks.push_back(block);
+      if (!block.complete) break;
+
+      pos = nextLine(block.end, end);
+    }
+
+    return region;
+  }
+
+  void MascotGenericFile::transform(const String& filename, Interfaces::IMSDataConsumer* consumer)
+  {
+    std::vector<SpectrumBlock_> blocks;
+    std::shared_ptr<const void> mapping = findSpectrumBlocks_(filename, blocks);
+
+    // the last block is dropped if the file ended before its data
+    Size spectrum_count = blocks.size();
+    if (!blocks.empty() && !blocks.back().has_data) --spectrum_count;
+    consumer->setExpectedSize(spectrum_count, 0);
+    consumer->setExperimentalSettings(ExperimentalSettings());
+
+    parseSpectra_<MSSpectrum>(blocks, [consumer](MSSpectrum& spectrum)
+    {
+      consumer->consumeSpectrum(spectrum);
+    });
+  }
+
   void MascotGenericFile::store(const String& filename, const PeakMap& experiment, bool compact)
   {
     if (!FileHandler::hasValidExtension(filename, FileTypes::MGF))
@@ -419,6 +555,7 @@ namespace OpenMS
     QFileInfo fileinfo(filename.c_str());
     QString filtered_filename = fileinfo.completeBaseName();
     filtered_filename.remove(QRegExp("[^a-zA-Z0-9]"));
+    const String title_filename(filtered_filename);
 
 
     String native_id_type_accession;
@@ -432,16 +569,64 @@ namespace OpenMS
       native_id_type_accession = experiment.getExperimentalSettings().getSourceFiles()[0].getNativeIDTypeAccession();
     }
     this->startProgress(0, experiment.size(), "storing mascot generic file");
-    for (Size i = 0; i < experiment.size(); i++)
+
+    // spectra are formatted in parallel (in batches, to limit the memory
+    // needed) and then written in their original order
+    const Size batch_size = 1000;
+    vector<String> formatted;
+    for (Size batch_start = 0; batch_start < experiment.size(); batch_start += batch_size)
     {
-      this->setProgress(i);
-      if (experiment[i].getMSLevel() == 2)
+      const Size n = min(batch_size, experiment.size() - batch_start);
+      formatted.assign(n, String());
+
+      std::exception_ptr error;
+      Size error_index = n;
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic, 16)
+#endif
+      for (SignedSize i = 0; i < (SignedSize)n; ++i)
+      {
+        if (experiment[batch_start + i].getMSLevel() != 2) continue;
+        try
+        {
+          // same formatting state as the output stream
+          ostringstream spectrum_os;
+          spectrum_os.flags(os.flags());
+          spectrum_os.precision(os.precision());
+          spectrum_os.imbue(os.getloc());
+          writeSpectrum_(spectrum_os, experiment[batch_start + i], title_filename, native_id_type_accession);
+          formatted[i] = spectrum_os.str();
+        }
+        catch (...)
+        {
+#ifdef _OPENMP
+#pragma omp critical (MascotGenericFile_writeMSExperiment)
+#endif
+          {
+            if ((Size)i < error_index)
+            {
+              error_index = i;
+              error = std::current_exception();
+            }
+          }
+        }
+      }
+
+      for (Size i = 0; i < min(n, error_index); ++i)
       {
-        writeSpectrum_(os, experiment[i], filtered_filename, native_id_type_accession);
+        this->setProgress(batch_start + i);
+        if (experiment[batch_start + i].getMSLevel() == 2)
+        {
+          os << formatted[i];
+        }
+        else if (experiment[batch_start + i].getMSLevel() == 0)
+        {
+          LOG_WARN << "MascotGenericFile: MSLevel is set to 0, ignoring this spectrum!" << "\n";
+        }
       }
-      else if (experiment[i].getMSLevel() == 0)
+      if (error)
       {
-        LOG_WARN << "MascotGenericFile: MSLevel is set to 0, ignoring this spectrum!" << "\n";
+        std::rethrow_exception(error);
       }
     }
     // close file
@@ -59,6 +59,13 @@ namespace OpenMS
     handler.readMzIdentMLFile(filename);
   }
 
+  void MzIdentMLFile::load(const String& filename, std::vector<ProteinIdentification>& poid, const std::function<void(PeptideIdentification&)>& consumer)
+  {
+    std::vector<PeptideIdentification> peid; // stays empty, all results go to the consumer
+    Internal::MzIdentMLDOMHandler handler(poid, peid, schema_version_, *this);
+    handler.readMzIdentMLFile(filename, consumer);
+  }
+
   void MzIdentMLFile::store(const String& filename, const Identification& id) const
   {
     Internal::MzIdentMLHandler handler(id, filename, schema_version_, *this);
@@ -35,14 +35,35 @@
 #include <OpenMS/FORMAT/MzMLFile.h>
 
 #include <OpenMS/FORMAT/HANDLERS/MzMLHandler.h>
+#include <OpenMS/FORMAT/HANDLERS/IndexedMzMLDecoder.h>
 #include <OpenMS/FORMAT/CVMappingFile.h>
 #include <OpenMS/FORMAT/VALIDATORS/XMLValidator.h>
 #include <OpenMS/FORMAT/VALIDATORS/MzMLValidator.h>
+#include <OpenMS/FORMAT/InMemoryFileStore.h>
+#include <OpenMS/FORMAT/MzMLSpectrumMetaIndex.h>
 #include <OpenMS/FORMAT/TextFile.h>
 #include <OpenMS/SYSTEM/File.h>
+#include <OpenMS/SYSTEM/Profiler.h>
+
+#include <fstream>
 
 namespace OpenMS
 {
+  namespace
+  {
+    /// reads the bytes [start, end) of @p is
+    std::string readRange_(std::ifstream& is, std::streampos start, std::streampos end)
+    {
+      std::string text;
+      if (end <= start) return text;
+      text.resize(end - start);
+      is.clear();
+      is.seekg(start);
+      is.read(&text[0], end - start);
+      text.resize(is.gcount());
+      return text;
+    }
+  }
 
   MzMLFile::MzMLFile() :
     XMLFile("/SCHEMAS/mzML_1_10.xsd", "1.1.0"),
@@ -167,8 +188,24 @@ namespace OpenMS
 
   void MzMLFile::load(const String& filename, PeakMap& map)
   {
+    OPENMS_PROFILE_SCOPE("MzMLFile::load");
+    if (InMemoryFileStore::isMemoryPath(filename))
+    {
+      InMemoryFileStore::load(filename, map);
+      return;
+    }
+
     map.reset();
 
+    // read only the selected spectra of indexed files
+    if (options_.getUseIndexedSelection() && options_.hasFilters() && loadIndexedSelection_(filename, map))
+    {
+      map.setLoadedFileType(filename);
+      map.setLoadedFilePath(filename);
+      map.shareSpectrumMetaData();
+      return;
+    }
+
     //set DocumentIdentifier
     map.setLoadedFileType(filename);
     map.setLoadedFilePath(filename);
@@ -176,10 +213,122 @@ namespace OpenMS
     Internal::MzMLHandler handler(map, filename, getVersion(), *this);
     handler.setOptions(options_);
     safeParse_(filename, &handler);
+
+    // most spectra share identical meta data, only keep it once
+    map.shareSpectrumMetaData();
+  }
+
+  bool MzMLFile::loadIndexedSelection_(const String& filename, PeakMap& map)
+  {
+    // offsets of all spectra and chromatograms from the indexList at the end of the file
+    IndexedMzMLDecoder decoder;
+    std::streampos index_offset = decoder.findIndexListOffset(filename);
+    if (index_offset == (std::streampos)-1) return false;
+    IndexedMzMLDecoder::OffsetVector spectra_offsets, chromatograms_offsets;
+    if (decoder.parseOffsets(filename, index_offset, spectra_offsets, chromatograms_offsets) != 0 || spectra_offsets.empty()) return false;
+    // chromatograms written before the spectra are not supported here
+    if (!chromatograms_offsets.empty() && chromatograms_offsets[0].second < spectra_offsets[0].second) return false;
+
+    MzMLSpectrumMetaIndex meta_index;
+    try
+    {
+      meta_index.open(filename);
+    }
+    catch (Exception::BaseException&)
+    {
+      return false;
+    }
+    if (meta_index.size() != spectra_offsets.size()) return false;
+    const std::vector<Size> selected = meta_index.select(options_);
+
+    std::ifstream is(filename.c_str(), std::ios_base::binary);
+    if (!is) return false;
+
+    // document up to the <spectrumList> start tag (header, run attributes)
+    const std::string head = readRange_(is, 0, spectra_offsets[0].second);
+    const Size list_pos = head.rfind("<spectrumList");
+    const Size list_end = list_pos == std::string::npos ? list_pos : head.find('>', list_pos);
+    if (list_end == std::string::npos) return false;
+    const std::string prefix = head.substr(0, list_pos);
+    std::string list_tag = head.substr(list_pos, list_end + 1 - list_pos);
+    const Size count_pos = list_tag.find("count=\"");
+    const Size count_end = count_pos == std::string::npos ? count_pos : list_tag.find('"', count_pos + 7);
+
+    // end of the last spectrum: first chromatogram or the index
+    const std::streampos spectra_end = chromatograms_offsets.empty() ? index_offset : chromatograms_offsets[0].second;
+    std::string suffix = "</spectrumList>\n";
+    if (!chromatograms_offsets.empty())
+    {
+      // the chromatogramList start tag follows the last spectrum
+      const std::string last = readRange_(is, spectra_offsets.back().second, spectra_end);
+      const Size chrom_list_pos = last.rfind("<chromatogramList");
+      const std::string chroms = readRange_(is, chromatograms_offsets[0].second, index_offset);
+      const Size chroms_end = chroms.rfind("</chromatogramList>");
+      if (chrom_list_pos == std::string::npos || chroms_end == std::string::npos) return false;
+      suffix += last.substr(chrom_list_pos) + chroms.substr(0, chroms_end) + "</chromatogramList>\n";
+    }
+    std::string closing = "</run>\n</mzML>\n";
+    if (prefix.find("<indexedmzML") != std::string::npos) closing += "</indexedmzML>\n";
+
+    // parse the selected spectra in chunks (bounds the size of the text held in memory)
+    const Size chunk_size = 1000;
+    Size first = 0;
+    do
+    {
+      const Size last = std::min(selected.size(), first + chunk_size);
+      const bool final_chunk = (last == selected.size());
+      if (count_pos != std::string::npos && count_end != std::string::npos)
+      {
+        list_tag.replace(count_pos + 7, count_end - count_pos - 7, String(last - first));
+      }
+      std::string doc = prefix + list_tag + "\n";
+      for (Size k = first; k < last; ++k)
+      {
+        const Size i = selected[k];
+        const std::streampos end = (i + 1 < spectra_offsets.size()) ? spectra_offsets[i + 1].second : spectra_end;
+        const std::string spectrum = readRange_(is, spectra_offsets[i].second, end);
+        const Size spectrum_end = spectrum.rfind("</spectrum>");
+        if (spectrum_end == std::string::npos) return false;
+        doc.append(spectrum, 0, spectrum_end + 11);
+        doc += "\n";
+      }
+      // chromatograms are part of the last chunk only
+      doc += (final_chunk ? suffix : std::string("</spectrumList>\n")) + closing;
+
+      PeakMap chunk;
+      Internal::MzMLHandler handler(chunk, filename, getVersion(), *this);
+      handler.setOptions(options_);
+      parseBuffer_(doc, &handler);
+
+      if (first == 0)
+      {
+        map = chunk;
+      }
+      else
+      {
+        for (Size k = 0; k < chunk.size(); ++k)
+        {
+          map.addSpectrum(std::move(chunk[k]));
+        }
+        map.setChromatograms(std::move(chunk.getChromatograms()));
+      }
+      first = last;
+    }
+    while (first < selected.size());
+
+    map.updateRanges();
+    return true;
   }
 
   void MzMLFile::store(const String& filename, const PeakMap& map) const
   {
+    OPENMS_PROFILE_SCOPE("MzMLFile::store");
+    if (InMemoryFileStore::isMemoryPath(filename))
+    {
+      InMemoryFileStore::store(filename, map);
+      return;
+    }
+
     Internal::MzMLHandler handler(map, filename, getVersion(), *this);
     handler.setOptions(options_);
     save_(filename, &handler);
@@ -0,0 +1,202 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2018.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: Timo Sachsenberg $
+// $Authors: Timo Sachsenberg $
+// --------------------------------------------------------------------------
+
+#include <OpenMS/FORMAT/MzMLSpectrumMetaIndex.h>
+
+#include <OpenMS/CONCEPT/LogStream.h>
+#include <OpenMS/FORMAT/MzMLFile.h>
+#include <OpenMS/FORMAT/TextFile.h>
+#include <OpenMS/KERNEL/MSExperiment.h>
+#include <OpenMS/SYSTEM/File.h>
+
+#include <QtCore/QDateTime>
+#include <QtCore/QFileInfo>
+
+#include <fstream>
+
+using namespace std;
+
+namespace OpenMS
+{
+  MzMLSpectrumMetaIndex::MzMLSpectrumMetaIndex() :
+    entries_()
+  {
+  }
+
+  void MzMLSpectrumMetaIndex::open(const String& mzml_file, bool store_index)
+  {
+    if (!File::exists(mzml_file))
+    {
+      throw Exception::FileNotFound(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, mzml_file);
+    }
+
+    String index_file = mzml_file + ".smi";
+    if (File::exists(index_file) &&
+        QFileInfo(index_file.toQString()).lastModified() >= QFileInfo(mzml_file.toQString()).lastModified())
+    {
+      try
+      {
+        load(index_file);
+        return;
+      }
+      catch (Exception::ParseError&)
+      {
+        LOG_INFO << "Spectrum index '" << index_file << "' is invalid and will be rebuilt." << std::endl;
+      }
+    }
+
+    build(mzml_file);
+    if (store_index)
+    {
+      try
+      {
+        store(index_file);
+      }
+      catch (Exception::UnableToCreateFile&)
+      {
+        LOG_INFO << "Could not write spectrum index '" << index_file << "', the index is only kept in memory." << std::endl;
+      }
+    }
+  }
+
+  void MzMLSpectrumMetaIndex::build(const String& mzml_file)
+  {
+    // only the spectrum metadata is needed
+    MzMLFile f;
+    f.getOptions().setFillData(false);
+    PeakMap exp;
+    f.load(mzml_file, exp);
+
+    entries_.clear();
+    entries_.reserve(exp.size());
+    for (Size i = 0; i < exp.size(); ++i)
+    {
+      Entry record;
+      record.rt = exp[i].getRT();
+      record.ms_level = (Int)exp[i].getMSLevel();
+      record.precursor_mz = exp[i].getPrecursors().empty() ? 0.0 : exp[i].getPrecursors()[0].getMZ();
+      entries_.push_back(record);
+    }
+  }
+
+  void MzMLSpectrumMetaIndex::load(const String& index_file)
+  {
+    TextFile tf(index_file);
+
+    entries_.clear();
+    TextFile::ConstIterator it = tf.begin();
+    if (it == tf.end() || !it->hasPrefix("#spectra\t"))
+    {
+      throw Exception::ParseError(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, index_file,
+          "Missing header in spectrum index file.");
+    }
+    Size expected(0);
+    try
+    {
+      expected = it->suffix('\t').toInt();
+      entries_.reserve(expected);
+      std::vector<String> fields;
+      for (++it; it != tf.end(); ++it)
+      {
+        if (it->empty()) continue;
+        it->split('\t', fields);
+        if (fields.size() != 3)
+        {
+          throw Exception::ParseError(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, *it,
+              "Expected 3 tab-separated fields in spectrum index file '" + index_file + "'.");
+        }
+        Entry record;
+        record.rt = fields[0].toDouble();
+        record.ms_level = fields[1].toInt();
+        record.precursor_mz = fields[2].toDouble();
+        entries_.push_back(record);
+      }
+    }
+    catch (Exception::ConversionError&)
+    {
+      throw Exception::ParseError(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, *it,
+          "Invalid number in spectrum index file '" + index_file + "'.");
+    }
+    if (entries_.size() != expected)
+    {
+      throw Exception::ParseError(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, index_file,
+          "Spectrum index file is incomplete.");
+    }
+  }
+
+  void MzMLSpectrumMetaIndex::store(const String& index_file) const
+  {
+    ofstream os(index_file.c_str(), ios_base::out | ios_base::binary);
+    if (!os)
+    {
+      throw Exception::UnableToCreateFile(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, index_file);
+    }
+    os.precision(writtenDigits<double>(0.0));
+    os << "#spectra\t" << entries_.size() << '\n';
+    for (const Entry& record : entries_)
+    {
+      os << record.rt << '\t' << record.ms_level << '\t' << record.precursor_mz << '\n';
+    }
+    os.close();
+    if (!os)
+    {
+      throw Exception::UnableToCreateFile(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, index_file);
+    }
+  }
+
+  Size MzMLSpectrumMetaIndex::size() const
+  {
+    return entries_.size();
+  }
+
+  const std::vector<MzMLSpectrumMetaIndex::Entry>& MzMLSpectrumMetaIndex::getIndexEntries() const
+  {
+    return entries_;
+  }
+
+  std::vector<Size> MzMLSpectrumMetaIndex::select(const PeakFileOptions& options) const
+  {
+    std::vector<Size> selected;
+    selected.reserve(entries_.size());
+    for (Size i = 0; i < entries_.size(); ++i)
+    {
+      // same conditions as in MzMLHandler
+      if (options.hasMSLevels() && !options.containsMSLevel(entries_[i].ms_level)) continue;
+      if (options.hasRTRange() && !options.getRTRange().encloses(DPosition<1>(entries_[i].rt))) continue;
+      selected.push_back(i);
+    }
+    return selected;
+  }
+
+} // namespace OpenMS
@@ -0,0 +1,282 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2018.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: Timo Sachsenberg $
+// $Authors: Timo Sachsenberg $
+// --------------------------------------------------------------------------
+
+#include <OpenMS/FORMAT/MzMLTailReader.h>
+
+#include <OpenMS/FORMAT/HANDLERS/MzMLHandler.h>
+
+#include <fstream>
+
+namespace OpenMS
+{
+  namespace
+  {
+    /// Counts the parsed elements and forwards them to the consumer of the reader (if any)
+    class CountingConsumer_ :
+      public Interfaces::IMSDataConsumer
+    {
+public:
+      explicit CountingConsumer_(Interfaces::IMSDataConsumer* consumer) :
+        consumer_(consumer),
+        spectra(0),
+        chromatograms(0)
+      {
+      }
+
+      void consumeSpectrum(SpectrumType& s) override
+      {
+        ++spectra;
+        if (consumer_ != nullptr) consumer_->consumeSpectrum(s);
+      }
+
+      void consumeChromatogram(ChromatogramType& c) override
+      {
+        ++chromatograms;
+        if (consumer_ != nullptr) consumer_->consumeChromatogram(c);
+      }
+
+      void setExpectedSize(Size, Size) override {}
+      void setExperimentalSettings(const ExperimentalSettings&) override {}
+
+      Interfaces::IMSDataConsumer* consumer_;
+      Size spectra;
+      Size chromatograms;
+    };
+  }
+
+  MzMLTailReader::MzMLTailReader(const String& filename, Interfaces::IMSDataConsumer* consumer) :
+    XMLFile("/SCHEMAS/mzML_1_10.xsd", "1.1.0"),
+    filename_(filename),
+    consumer_(consumer),
+    state_(HEADER),
+    offset_(0),
+    indexed_(false),
+    spectra_count_(0),
+    chromatogram_count_(0)
+  {
+  }
+
+  MzMLTailReader::~MzMLTailReader()
+  {
+  }
+
+  PeakFileOptions& MzMLTailReader::getOptions()
+  {
+    return options_;
+  }
+
+  const PeakFileOptions& MzMLTailReader::getOptions() const
+  {
+    return options_;
+  }
+
+  bool MzMLTailReader::isFinished() const
+  {
+    return state_ == FINISHED;
+  }
+
+  Size MzMLTailReader::getNrSpectra() const
+  {
+    return spectra_count_;
+  }
+
+  Size MzMLTailReader::getNrChromatograms() const
+  {
+    return chromatogram_count_;
+  }
+
+  Size MzMLTailReader::poll()
+  {
+    if (state_ == FINISHED)
+    {
+      return 0;
+    }
+
+    // read everything appended since the last call
+    {
+      std::ifstream ifs(filename_.c_str(), std::ios::in | std::ios::binary);
+      if (!ifs)
+      {
+        return 0; // not created yet
+      }
+      ifs.seekg(0, std::ios::end);
+      const Size size = (Size) ifs.tellg();
+      if (size < offset_)
+      {
+        throw Exception::ParseError(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, filename_, "File was truncated while being read.");
+      }
+      if (size > offset_)
+      {
+        std::string appended(size - offset_, '\0');
+        ifs.seekg(offset_);
+        ifs.read(&appended[0], appended.size());
+        appended.resize((Size) ifs.gcount());
+        offset_ += appended.size();
+        buffer_ += appended;
+      }
+    }
+
+    Size count(0);
+    while (true)
+    {
+      if (state_ == HEADER || state_ == BETWEEN_LISTS)
+      {
+        const Size spec_pos = buffer_.find("<spectrumList");
+        const Size chrom_pos = buffer_.find("<chromatogramList");
+        const Size list_pos = std::min(spec_pos, chrom_pos);
+        const Size run_end = buffer_.find("</run>");
+        if (run_end != std::string::npos && run_end < list_pos)
+        {
+          state_ = FINISHED;
+          buffer_.clear();
+          break;
+        }
+        if (list_pos == std::string::npos || !startList_(list_pos))
+        {
+          break; // wait for more data
+        }
+      }
+      else if (state_ == SPECTRA || state_ == CHROMATOGRAMS)
+      {
+        const std::string element = (state_ == SPECTRA ? "spectrum" : "chromatogram");
+        const std::string element_end = "</" + element + ">";
+        const std::string list_end = "</" + element + "List>";
+
+        // parse everything up to the end of the list or the last complete element
+        const Size list_end_pos = buffer_.find(list_end);
+        Size parse_end(list_end_pos);
+        if (list_end_pos == std::string::npos)
+        {
+          parse_end = buffer_.rfind(element_end);
+          if (parse_end == std::string::npos)
+          {
+            break; // wait for more data
+          }
+          parse_end += element_end.size();
+        }
+        if (buffer_.find("<" + element) < parse_end)
+        {
+          count += parseElements_(buffer_.substr(0, parse_end));
+        }
+
+        if (list_end_pos == std::string::npos)
+        {
+          buffer_.erase(0, parse_end);
+          break; // wait for more data
+        }
+        buffer_.erase(0, list_end_pos + list_end.size());
+        state_ = BETWEEN_LISTS;
+      }
+      else
+      {
+        break;
+      }
+    }
+    return count;
+  }
+
+  bool MzMLTailReader::startList_(Size pos)
+  {
+    const Size tag_end = buffer_.find('>', pos);
+    if (tag_end == std::string::npos)
+    {
+      return false;
+    }
+
+    list_start_ = buffer_.substr(pos, tag_end + 1 - pos);
+    // the count is the one of the complete list, we parse it piece by piece
+    // (avoids reserving space for all elements on each parse)
+    const Size count_pos = list_start_.find(" count=\"");
+    if (count_pos != std::string::npos)
+    {
+      const Size value_pos = count_pos + 8;
+      const Size value_end = list_start_.find('"', value_pos);
+      if (value_end != std::string::npos)
+      {
+        list_start_.replace(value_pos, value_end - value_pos, "0");
+      }
+    }
+    state_ = (list_start_.compare(0, 13, "<spectrumList") == 0 ? SPECTRA : CHROMATOGRAMS);
+
+    if (header_.empty())
+    {
+      header_ = buffer_.substr(0, pos);
+      indexed_ = (header_.find("<indexedmzML") != std::string::npos);
+      buffer_.erase(0, tag_end + 1);
+
+      // hand over the experimental settings before the first element
+      PeakMap settings;
+      PeakFileOptions options(options_);
+      options.setMetadataOnly(true);
+      Internal::MzMLHandler handler(settings, filename_, getVersion(), *this);
+      handler.setOptions(options);
+      parseBuffer_(header_ + list_start_ + closingTags_(), &handler);
+      if (consumer_ != nullptr)
+      {
+        consumer_->setExperimentalSettings(settings);
+      }
+    }
+    else
+    {
+      buffer_.erase(0, tag_end + 1);
+    }
+    return true;
+  }
+
+  Size MzMLTailReader::parseElements_(const std::string& content)
+  {
+    PeakMap dummy;
+    CountingConsumer_ counter(consumer_);
+    Internal::MzMLHandler handler(dummy, filename_, getVersion(), *this);
+    handler.setOptions(options_);
+    handler.setMSDataConsumer(&counter);
+    parseBuffer_(header_ + list_start_ + content + closingTags_(), &handler);
+
+    spectra_count_ += counter.spectra;
+    chromatogram_count_ += counter.chromatograms;
+    return counter.spectra + counter.chromatograms;
+  }
+
+  std::string MzMLTailReader::closingTags_() const
+  {
+    std::string closing = (state_ == SPECTRA ? "</spectrumList>" : "</chromatogramList>");
+    closing += "</run></mzML>";
+    if (indexed_)
+    {
+      closing += "</indexedmzML>";
+    }
+    return closing;
+  }
+
+} // namespace OpenMS
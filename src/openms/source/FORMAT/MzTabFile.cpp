@@ -39,6 +39,8 @@
 
 #include <boost/regex.hpp>
 
+#include <fstream>
+
 using namespace std;
 
 // TODO fix all the shadowed "String s"
@@ -2597,24 +2599,14 @@ String MzTabFile::generateMzTabSmallMoleculeSectionRow_(const MzTabSmallMolecule
   return ListUtils::concatenate(s, "\t");
 }
 
-void MzTabFile::store(const String& filename, const MzTab& mz_tab) const
+void MzTabFile::generateMzTabSectionsBeforePSM_(const MzTab& mz_tab, StringList& out) const
 {
-
-  if (!FileHandler::hasValidExtension(filename, FileTypes::MZTAB))
-  {
-    throw Exception::UnableToCreateFile(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, filename, "invalid file extension, expected '" + FileTypes::typeToName(FileTypes::MZTAB) + "'");
-  }
-
-  StringList out;
-
   generateMzTabMetaDataSection_(mz_tab.getMetaData(), out);
   bool complete = (mz_tab.getMetaData().mz_tab_mode.toCellString() == "Complete");
   Size ms_runs = mz_tab.getMetaData().ms_run.size();
 
   const MzTabProteinSectionRows& protein_section = mz_tab.getProteinSectionRows();
   const MzTabPeptideSectionRows& peptide_section = mz_tab.getPeptideSectionRows();
-  const MzTabPSMSectionRows& psm_section = mz_tab.getPSMSectionRows();
-  const MzTabSmallMoleculeSectionRows& smallmolecule_section = mz_tab.getSmallMoleculeSectionRows();
 
   if (!protein_section.empty())
   {   
@@ -2659,7 +2651,37 @@ void MzTabFile::store(const String& filename, const MzTab& mz_tab) const
     out.push_back(generateMzTabPeptideHeader_(search_ms_runs, n_best_search_engine_score, n_search_engine_score, assays, study_variables, mz_tab.getPeptideOptionalColumnNames()));
     generateMzTabPeptideSection_(mz_tab.getPeptideSectionRows(), out, mz_tab.getPeptideOptionalColumnNames());
   }
+}
+
+void MzTabFile::generateMzTabSectionsAfterPSM_(const MzTab& mz_tab, StringList& out) const
+{
+  const MzTabSmallMoleculeSectionRows& smallmolecule_section = mz_tab.getSmallMoleculeSectionRows();
+  Size ms_runs = mz_tab.getMetaData().ms_run.size();
+
+  if (!smallmolecule_section.empty())
+  {
+    Size assays = smallmolecule_section[0].smallmolecule_abundance_assay.size();
+    Size study_variables = smallmolecule_section[0].smallmolecule_abundance_study_variable.size();
+    Size n_search_engine_score = smallmolecule_section[0].search_engine_score_ms_run.size();
+    Size n_best_search_engine_score = mz_tab.getMetaData().smallmolecule_search_engine_score.size();
+    out.push_back(generateMzTabSmallMoleculeHeader_(ms_runs, n_best_search_engine_score, n_search_engine_score, assays, study_variables, mz_tab.getSmallMoleculeOptionalColumnNames()));
+    generateMzTabSmallMoleculeSection_(smallmolecule_section, out, mz_tab.getSmallMoleculeOptionalColumnNames());
+  }
+}
 
+void MzTabFile::store(const String& filename, const MzTab& mz_tab) const
+{
+
+  if (!FileHandler::hasValidExtension(filename, FileTypes::MZTAB))
+  {
+    throw Exception::UnableToCreateFile(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, filename, "invalid file extension, expected '" + FileTypes::typeToName(FileTypes::MZTAB) + "'");
+  }
+
+  StringList out;
+
+  generateMzTabSectionsBeforePSM_(mz_tab, out);
+
+  const MzTabPSMSectionRows& psm_section = mz_tab.getPSMSectionRows();
   if (!psm_section.empty())
   {
     Size n_search_engine_scores = mz_tab.getMetaData().psm_search_engine_score.size();
@@ -2672,15 +2694,7 @@ void MzTabFile::store(const String& filename, const MzTab& mz_tab) const
     generateMzTabPSMSection_(mz_tab.getPSMSectionRows(), out, mz_tab.getPSMOptionalColumnNames());
   }
 
-  if (!smallmolecule_section.empty())
-  {
-    Size assays = smallmolecule_section[0].smallmolecule_abundance_assay.size();
-    Size study_variables = smallmolecule_section[0].smallmolecule_abundance_study_variable.size();
-    Size n_search_engine_score = smallmolecule_section[0].search_engine_score_ms_run.size();
-    Size n_best_search_engine_score = mz_tab.getMetaData().smallmolecule_search_engine_score.size();
-    out.push_back(generateMzTabSmallMoleculeHeader_(ms_runs, n_best_search_engine_score, n_search_engine_score, assays, study_variables, mz_tab.getSmallMoleculeOptionalColumnNames()));
-    generateMzTabSmallMoleculeSection_(smallmolecule_section, out, mz_tab.getSmallMoleculeOptionalColumnNames());
-  }
+  generateMzTabSectionsAfterPSM_(mz_tab, out);
 
   // insert comment (might provide critical cues for human reader) and empty lines
   Size line = 0;
@@ -2722,6 +2736,171 @@ void MzTabFile::store(const String& filename, const MzTab& mz_tab) const
   }
 }
 
+void MzTabFile::writeLines_(std::ostream& os, const StringList& lines)
+{
+  // same line handling as TextFile::store()
+  for (StringList::const_iterator it = lines.begin(); it != lines.end(); ++it)
+  {
+    if (it->hasSuffix("\r\n"))
+    {
+      os << it->prefix(it->size() - 2) << "\n";
+    }
+    else if (it->hasSuffix("\n"))
+    {
+      os << *it;
+    }
+    else
+    {
+      os << *it << "\n";
+    }
+  }
+}
+
+void MzTabFile::store(const String& filename, const MzTab& mz_tab, Size n_psm_items, const PSMRowGenerator& psm_row_generator) const
+{
+  if (!FileHandler::hasValidExtension(filename, FileTypes::MZTAB))
+  {
+    throw Exception::UnableToCreateFile(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, filename, "invalid file extension, expected '" + FileTypes::typeToName(FileTypes::MZTAB) + "'");
+  }
+
+  // stream not opened in binary mode, thus "\n" will be evaluated platform dependent (as in TextFile::store())
+  std::ofstream os(filename.c_str(), std::ofstream::out);
+  if (!os)
+  {
+    throw Exception::UnableToCreateFile(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, filename);
+  }
+
+  StringList out;
+  generateMzTabSectionsBeforePSM_(mz_tab, out);
+  writeLines_(os, out);
+  out.clear();
+
+  // PSM rows are generated in batches (in parallel), rows of a batch are kept only until they are written
+  const Size batch_size = 10000;
+
+  // first pass: collect optional column names (in order of first occurrence, as MzTab::getPSMOptionalColumnNames())
+  vector<String> optional_columns;
+  Size n_rows(0);
+  for (Size batch_start = 0; batch_start < n_psm_items; batch_start += batch_size)
+  {
+    const Size batch_end = std::min(n_psm_items, batch_start + batch_size);
+    vector<vector<String> > batch_columns(batch_end - batch_start);
+    vector<Size> batch_rows(batch_end - batch_start, 0);
+
+    Size err_count(0);
+    std::exception_ptr err;
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic, 100)
+#endif
+    for (SignedSize k = 0; k < (SignedSize)batch_columns.size(); ++k)
+    {
+      try
+      {
+        MzTabPSMSectionRows rows;
+        psm_row_generator(batch_start + k, rows);
+        batch_rows[k] = rows.size();
+        for (MzTabPSMSectionRows::const_iterator it = rows.begin(); it != rows.end(); ++it)
+        {
+          for (std::vector<MzTabOptionalColumnEntry>::const_iterator it_opt = it->opt_.begin(); it_opt != it->opt_.end(); ++it_opt)
+          {
+            if (std::find(batch_columns[k].begin(), batch_columns[k].end(), it_opt->first) == batch_columns[k].end())
+            {
+              batch_columns[k].push_back(it_opt->first);
+            }
+          }
+        }
+      }
+      catch (...)
+      {
+#ifdef _OPENMP
+#pragma omp critical (MzTabFile_store)
+#endif
+        {
+          if (err_count++ == 0)
+          {
+            err = std::current_exception();
+          }
+        }
+      }
+    }
+    if (err_count != 0)
+    {
+      std::rethrow_exception(err);
+    }
+
+    for (Size k = 0; k < batch_columns.size(); ++k)
+    {
+      n_rows += batch_rows[k];
+      for (vector<String>::const_iterator it = batch_columns[k].begin(); it != batch_columns[k].end(); ++it)
+      {
+        if (std::find(optional_columns.begin(), optional_columns.end(), *it) == optional_columns.end())
+        {
+          optional_columns.push_back(*it);
+        }
+      }
+    }
+  }
+
+  // second pass: format and write the rows in order
+  if (n_rows != 0)
+  {
+    Size n_search_engine_scores = mz_tab.getMetaData().psm_search_engine_score.size();
+    out.push_back(generateMzTabPSMHeader_(n_search_engine_scores, optional_columns));
+    writeLines_(os, out);
+    out.clear();
+
+    for (Size batch_start = 0; batch_start < n_psm_items; batch_start += batch_size)
+    {
+      const Size batch_end = std::min(n_psm_items, batch_start + batch_size);
+      vector<StringList> formatted(batch_end - batch_start);
+
+      Size err_count(0);
+      std::exception_ptr err;
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic, 100)
+#endif
+      for (SignedSize k = 0; k < (SignedSize)formatted.size(); ++k)
+      {
+        try
+        {
+          MzTabPSMSectionRows rows;
+          psm_row_generator(batch_start + k, rows);
+          for (MzTabPSMSectionRows::const_iterator it = rows.begin(); it != rows.end(); ++it)
+          {
+            formatted[k].push_back(generateMzTabPSMSectionRow_(*it, optional_columns));
+          }
+        }
+        catch (...)
+        {
+#ifdef _OPENMP
+#pragma omp critical (MzTabFile_store)
+#endif
+          {
+            if (err_count++ == 0)
+            {
+              err = std::current_exception();
+            }
+          }
+        }
+      }
+      if (err_count != 0)
+      {
+        std::rethrow_exception(err);
+      }
+
+      for (Size k = 0; k < formatted.size(); ++k)
+      {
+        writeLines_(os, formatted[k]);
+      }
+    }
+    out.push_back(String("\n"));
+  }
+
+  generateMzTabSectionsAfterPSM_(mz_tab, out);
+  writeLines_(os, out);
+  os.close();
+}
+
 }
 
 #pragma clang diagnostic pop
@@ -62,7 +62,8 @@ namespace OpenMS
     np_config_mz_(),
     np_config_int_(),
     np_config_fda_(),
-    maximal_data_pool_size_(100)
+    maximal_data_pool_size_(100),
+    use_indexed_selection_(false)
   {
   }
 
@@ -90,7 +91,8 @@ namespace OpenMS
     np_config_mz_(options.np_config_mz_),
     np_config_int_(options.np_config_int_),
     np_config_fda_(options.np_config_fda_),
-    maximal_data_pool_size_(options.maximal_data_pool_size_)
+    maximal_data_pool_size_(options.maximal_data_pool_size_),
+    use_indexed_selection_(options.use_indexed_selection_)
   {
   }
 
@@ -355,4 +357,14 @@ namespace OpenMS
     return (has_rt_range_ || hasMSLevels());
   }
 
+  void PeakFileOptions::setUseIndexedSelection(bool use)
+  {
+    use_indexed_selection_ = use;
+  }
+
+  bool PeakFileOptions::getUseIndexedSelection() const
+  {
+    return use_indexed_selection_;
+  }
+
 } // namespace OpenMS
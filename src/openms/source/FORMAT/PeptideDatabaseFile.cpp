@@ -0,0 +1,540 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2018.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: Hannes Roest $
+// $Authors: Hannes Roest $
+// --------------------------------------------------------------------------
+
+
+#include <OpenMS/FORMAT/PeptideDatabaseFile.h>
+
+#include <OpenMS/ANALYSIS/RNPXL/ModifiedPeptideGenerator.h>
+#include <OpenMS/CHEMISTRY/AASequence.h>
+#include <OpenMS/CHEMISTRY/ModificationsDB.h>
+#include <OpenMS/CHEMISTRY/ProteaseDigestion.h>
+#include <OpenMS/CONCEPT/Exception.h>
+#include <OpenMS/CONCEPT/Macros.h>
+#include <OpenMS/SYSTEM/File.h>
+
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <map>
+#include <sstream>
+
+using std::vector;
+
+namespace OpenMS
+{
+  namespace
+  {
+    const char PEPDB_MAGIC[8] = {'O', 'M', 'S', 'P', 'E', 'P', 'D', 'B'};
+    const UInt32 PEPDB_VERSION = 1;
+    const UInt32 PEPDB_BYTE_ORDER = 0x01020304;
+
+    UInt64 align8(UInt64 offset)
+    {
+      return (offset + 7) / 8 * 8;
+    }
+
+    String joinList(const StringList& list)
+    {
+      String s;
+      for (Size i = 0; i < list.size(); ++i)
+      {
+        if (i > 0) s += ",";
+        s += list[i];
+      }
+      return s;
+    }
+
+    StringList splitList(const String& s)
+    {
+      StringList list;
+      if (!s.empty()) s.split(',', list);
+      return list;
+    }
+  }
+
+  // all offsets are absolute positions in the file
+  struct PeptideDatabaseFile::Header_
+  {
+    char magic[8];
+    UInt32 version;
+    UInt32 byte_order;
+    UInt64 nr_proteins;
+    UInt64 nr_peptides;
+    UInt64 nr_references;
+    UInt64 nr_variants;
+    UInt64 settings;
+    UInt64 settings_size;
+    UInt64 protein_table;
+    UInt64 peptide_table;
+    UInt64 reference_table;
+    UInt64 variant_table;
+    UInt64 string_pool;
+    UInt64 string_pool_size;
+  };
+
+  struct PeptideDatabaseFile::ProteinRecord_
+  {
+    UInt64 accession;
+    UInt64 accession_length;
+  };
+
+  struct PeptideDatabaseFile::PeptideRecord_
+  {
+    UInt64 sequence;
+    UInt32 sequence_length;
+    UInt32 nr_references;
+    UInt64 first_reference;
+  };
+
+  struct PeptideDatabaseFile::ReferenceRecord_
+  {
+    UInt32 protein;
+    UInt32 start;
+    char aa_before;
+    char aa_after;
+    char padding[6];
+  };
+
+  struct PeptideDatabaseFile::VariantRecord_
+  {
+    double mass;
+    UInt64 sequence;
+    UInt32 sequence_length;
+    UInt32 peptide;
+  };
+
+  bool PeptideDatabaseFile::Settings::operator==(const Settings& rhs) const
+  {
+    return enzyme == rhs.enzyme &&
+           missed_cleavages == rhs.missed_cleavages &&
+           min_length == rhs.min_length &&
+           max_length == rhs.max_length &&
+           fixed_modifications == rhs.fixed_modifications &&
+           variable_modifications == rhs.variable_modifications &&
+           max_variable_mods_per_peptide == rhs.max_variable_mods_per_peptide;
+  }
+
+  bool PeptideDatabaseFile::Settings::operator!=(const Settings& rhs) const
+  {
+    return !(*this == rhs);
+  }
+
+  PeptideDatabaseFile::PeptideDatabaseFile() :
+    begin_(nullptr),
+    size_(0),
+    nr_proteins_(0),
+    nr_peptides_(0),
+    nr_variants_(0),
+    protein_table_(0),
+    peptide_table_(0),
+    reference_table_(0),
+    variant_table_(0)
+  {
+  }
+
+  void PeptideDatabaseFile::store(const String& filename, const vector<FASTAFile::FASTAEntry>& proteins, const Settings& settings)
+  {
+    ProteaseDigestion digestor;
+    digestor.setEnzyme(settings.enzyme);
+    digestor.setMissedCleavages(settings.missed_cleavages);
+
+    vector<ResidueModification> fixed_modifications, variable_modifications;
+    for (const String& name : settings.fixed_modifications)
+    {
+      fixed_modifications.push_back(ModificationsDB::getInstance()->getModification(name));
+    }
+    for (const String& name : settings.variable_modifications)
+    {
+      variable_modifications.push_back(ModificationsDB::getInstance()->getModification(name));
+    }
+
+    // unique peptides (in order of their first occurrence) and their occurrences
+    std::map<String, Size> peptide_index;
+    vector<String> peptides;
+    vector<vector<ReferenceRecord_> > references;
+    Size nr_references = 0;
+    for (Size p = 0; p < proteins.size(); ++p)
+    {
+      const String& protein = proteins[p].sequence;
+      vector<StringView> digest;
+      digestor.digestUnmodified(protein, digest, settings.min_length, settings.max_length);
+
+      // position to continue searching from, for peptides occurring more than once in the protein
+      std::map<String, Size> search_from;
+      for (const StringView& c : digest)
+      {
+        const String peptide = c.getString();
+        if (peptide.find_first_of("BJXZ") != std::string::npos) { continue; }
+
+        Size& from = search_from[peptide];
+        const Size start = protein.find(peptide, from);
+        if (start == std::string::npos) { continue; }
+        from = start + 1;
+
+        std::map<String, Size>::iterator it = peptide_index.find(peptide);
+        if (it == peptide_index.end())
+        {
+          it = peptide_index.insert(std::make_pair(peptide, peptides.size())).first;
+          peptides.push_back(peptide);
+          references.push_back(vector<ReferenceRecord_>());
+        }
+
+        ReferenceRecord_ ref;
+        std::memset(&ref, 0, sizeof(ref));
+        ref.protein = static_cast<UInt32>(p);
+        ref.start = static_cast<UInt32>(start);
+        ref.aa_before = start == 0 ? '[' : protein[start - 1];
+        ref.aa_after = start + peptide.size() >= protein.size() ? ']' : protein[start + peptide.size()];
+        references[it->second].push_back(ref);
+        ++nr_references;
+      }
+    }
+
+    // all modified variants ...
+    struct Variant
+    {
+      double mass;
+      String sequence;
+      UInt32 peptide;
+    };
+    vector<Variant> variants;
+    for (Size i = 0; i < peptides.size(); ++i)
+    {
+      AASequence aas = AASequence::fromString(peptides[i]);
+      vector<AASequence> all_modified_peptides;
+      ModifiedPeptideGenerator::applyFixedModifications(fixed_modifications.begin(), fixed_modifications.end(), aas);
+      ModifiedPeptideGenerator::applyVariableModifications(variable_modifications.begin(), variable_modifications.end(), aas, settings.max_variable_mods_per_peptide, all_modified_peptides);
+      for (const AASequence& modified : all_modified_peptides)
+      {
+        Variant v;
+        v.mass = modified.getMonoWeight();
+        v.sequence = modified.toString();
+        v.peptide = static_cast<UInt32>(i);
+        variants.push_back(v);
+      }
+    }
+
+    // ... sorted by mass
+    std::stable_sort(variants.begin(), variants.end(), [](const Variant& a, const Variant& b) { return a.mass < b.mass; });
+
+    std::stringstream settings_stream;
+    settings_stream << "enzyme\t" << settings.enzyme << "\n"
+                    << "missed_cleavages\t" << settings.missed_cleavages << "\n"
+                    << "min_length\t" << settings.min_length << "\n"
+                    << "max_length\t" << settings.max_length << "\n"
+                    << "fixed_modifications\t" << joinList(settings.fixed_modifications) << "\n"
+                    << "variable_modifications\t" << joinList(settings.variable_modifications) << "\n"
+                    << "max_variable_mods_per_peptide\t" << settings.max_variable_mods_per_peptide << "\n";
+    const String settings_block = settings_stream.str();
+
+    // layout of the file
+    Header_ header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, PEPDB_MAGIC, sizeof(PEPDB_MAGIC));
+    header.version = PEPDB_VERSION;
+    header.byte_order = PEPDB_BYTE_ORDER;
+    header.nr_proteins = proteins.size();
+    header.nr_peptides = peptides.size();
+    header.nr_references = nr_references;
+    header.nr_variants = variants.size();
+    header.settings = sizeof(Header_);
+    header.settings_size = settings_block.size();
+    header.protein_table = align8(header.settings + header.settings_size);
+    header.peptide_table = header.protein_table + header.nr_proteins * sizeof(ProteinRecord_);
+    header.reference_table = header.peptide_table + header.nr_peptides * sizeof(PeptideRecord_);
+    header.variant_table = header.reference_table + header.nr_references * sizeof(ReferenceRecord_);
+    header.string_pool = header.variant_table + header.nr_variants * sizeof(VariantRecord_);
+
+    std::ofstream ofs(filename.c_str(), std::ios::binary);
+    if (!ofs)
+    {
+      throw Exception::UnableToCreateFile(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, filename);
+    }
+
+    std::string strings;
+    ofs.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    ofs.write(settings_block.c_str(), settings_block.size());
+    const char zeros[8] = {0, 0, 0, 0, 0, 0, 0, 0};
+    ofs.write(zeros, header.protein_table - header.settings - header.settings_size);
+
+    for (const FASTAFile::FASTAEntry& protein : proteins)
+    {
+      ProteinRecord_ record;
+      record.accession = header.string_pool + strings.size();
+      record.accession_length = protein.identifier.size();
+      strings += protein.identifier;
+      ofs.write(reinterpret_cast<const char*>(&record), sizeof(record));
+    }
+
+    UInt64 first_reference = 0;
+    for (Size i = 0; i < peptides.size(); ++i)
+    {
+      PeptideRecord_ record;
+      record.sequence = header.string_pool + strings.size();
+      record.sequence_length = static_cast<UInt32>(peptides[i].size());
+      record.nr_references = static_cast<UInt32>(references[i].size());
+      record.first_reference = first_reference;
+      strings += peptides[i];
+      first_reference += references[i].size();
+      ofs.write(reinterpret_cast<const char*>(&record), sizeof(record));
+    }
+
+    for (const vector<ReferenceRecord_>& refs : references)
+    {
+      if (!refs.empty())
+      {
+        ofs.write(reinterpret_cast<const char*>(&refs[0]), refs.size() * sizeof(ReferenceRecord_));
+      }
+    }
+
+    for (const Variant& v : variants)
+    {
+      VariantRecord_ record;
+      record.mass = v.mass;
+      record.sequence = header.string_pool + strings.size();
+      record.sequence_length = static_cast<UInt32>(v.sequence.size());
+      record.peptide = v.peptide;
+      strings += v.sequence;
+      ofs.write(reinterpret_cast<const char*>(&record), sizeof(record));
+    }
+
+    ofs.write(strings.c_str(), strings.size());
+
+    // now that the size of the string pool is known, update the header
+    header.string_pool_size = strings.size();
+    ofs.seekp(0);
+    ofs.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    if (!ofs)
+    {
+      throw Exception::UnableToCreateFile(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, filename);
+    }
+  }
+
+  void PeptideDatabaseFile::load(const String& filename)
+  {
+    if (!File::exists(filename))
+    {
+      throw Exception::FileNotFound(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, filename);
+    }
+
+    *this = PeptideDatabaseFile();
+    filename_ = filename;
+
+    // map the file into memory, fall back to reading it if this fails
+    try
+    {
+      boost::interprocess::file_mapping mapping(filename.c_str(), boost::interprocess::read_only);
+      mapped_region_.reset(new boost::interprocess::mapped_region(mapping, boost::interprocess::read_only));
+      // masses are searched with binary searches, no read-ahead needed
+      mapped_region_->advise(boost::interprocess::mapped_region::advice_random);
+      begin_ = static_cast<const char*>(mapped_region_->get_address());
+      size_ = mapped_region_->get_size();
+    }
+    catch (boost::interprocess::interprocess_exception& /* e */)
+    {
+      mapped_region_.reset();
+    }
+
+    if (!mapped_region_)
+    {
+      std::ifstream ifs(filename.c_str(), std::ios::binary);
+      buffer_.reset(new vector<char>((std::istreambuf_iterator<char>(ifs)), std::istreambuf_iterator<char>()));
+      begin_ = buffer_->empty() ? nullptr : &(*buffer_)[0];
+      size_ = buffer_->size();
+    }
+
+    if (size_ < sizeof(Header_))
+    {
+      throw Exception::ParseError(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "File is too small to be a peptide database.", filename);
+    }
+    Header_ header;
+    std::memcpy(&header, begin_, sizeof(header));
+    if (std::memcmp(header.magic, PEPDB_MAGIC, sizeof(PEPDB_MAGIC)) != 0)
+    {
+      throw Exception::ParseError(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "File is not a peptide database.", filename);
+    }
+    if (header.byte_order != PEPDB_BYTE_ORDER)
+    {
+      throw Exception::ParseError(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "Peptide database was created on a machine with a different byte order.", filename);
+    }
+    if (header.version != PEPDB_VERSION)
+    {
+      throw Exception::ParseError(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "Unsupported peptide database version " + String(header.version) + ".", filename);
+    }
+    if (header.settings + header.settings_size > size_ ||
+        header.protein_table + header.nr_proteins * sizeof(ProteinRecord_) > size_ ||
+        header.peptide_table + header.nr_peptides * sizeof(PeptideRecord_) > size_ ||
+        header.reference_table + header.nr_references * sizeof(ReferenceRecord_) > size_ ||
+        header.variant_table + header.nr_variants * sizeof(VariantRecord_) > size_ ||
+        header.string_pool + header.string_pool_size > size_ ||
+        header.protein_table % 8 != 0)
+    {
+      throw Exception::ParseError(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "Peptide database is truncated or corrupt.", filename);
+    }
+
+    nr_proteins_ = header.nr_proteins;
+    nr_peptides_ = header.nr_peptides;
+    nr_variants_ = header.nr_variants;
+    protein_table_ = header.protein_table;
+    peptide_table_ = header.peptide_table;
+    reference_table_ = header.reference_table;
+    variant_table_ = header.variant_table;
+
+    // parse settings
+    String block(begin_ + header.settings, begin_ + header.settings + header.settings_size);
+    vector<String> lines;
+    block.split('\n', lines);
+    for (const String& line : lines)
+    {
+      vector<String> fields;
+      line.split('\t', fields);
+      if (fields.empty()) continue;
+      const String value = fields.size() > 1 ? fields[1] : String();
+      if (fields[0] == "enzyme") settings_.enzyme = value;
+      else if (fields[0] == "missed_cleavages") settings_.missed_cleavages = value.toInt();
+      else if (fields[0] == "min_length") settings_.min_length = value.toInt();
+      else if (fields[0] == "max_length") settings_.max_length = value.toInt();
+      else if (fields[0] == "fixed_modifications") settings_.fixed_modifications = splitList(value);
+      else if (fields[0] == "variable_modifications") settings_.variable_modifications = splitList(value);
+      else if (fields[0] == "max_variable_mods_per_peptide") settings_.max_variable_mods_per_peptide = value.toInt();
+    }
+  }
+
+  bool PeptideDatabaseFile::isMemoryMapped() const
+  {
+    return mapped_region_ != nullptr;
+  }
+
+  const PeptideDatabaseFile::Settings& PeptideDatabaseFile::getSettings() const
+  {
+    return settings_;
+  }
+
+  Size PeptideDatabaseFile::getNrProteins() const
+  {
+    return nr_proteins_;
+  }
+
+  Size PeptideDatabaseFile::getNrPeptides() const
+  {
+    return nr_peptides_;
+  }
+
+  Size PeptideDatabaseFile::getNrVariants() const
+  {
+    return nr_variants_;
+  }
+
+  String PeptideDatabaseFile::getProteinAccession(Size protein) const
+  {
+    const ProteinRecord_& record = protein_(protein);
+    return String(data_(record.accession), data_(record.accession) + record.accession_length);
+  }
+
+  StringView PeptideDatabaseFile::getPeptideSequence(Size peptide) const
+  {
+    const PeptideRecord_& record = peptide_(peptide);
+    return StringView(data_(record.sequence), record.sequence_length);
+  }
+
+  void PeptideDatabaseFile::getPeptideReferences(Size peptide, vector<PeptideReference>& references) const
+  {
+    const PeptideRecord_& record = peptide_(peptide);
+    const ReferenceRecord_* refs = reinterpret_cast<const ReferenceRecord_*>(data_(reference_table_ + record.first_reference * sizeof(ReferenceRecord_)));
+    references.clear();
+    for (Size i = 0; i < record.nr_references; ++i)
+    {
+      PeptideReference ref;
+      ref.protein = refs[i].protein;
+      ref.start = refs[i].start;
+      ref.aa_before = refs[i].aa_before;
+      ref.aa_after = refs[i].aa_after;
+      references.push_back(ref);
+    }
+  }
+
+  double PeptideDatabaseFile::getVariantMass(Size variant) const
+  {
+    return variant_(variant).mass;
+  }
+
+  StringView PeptideDatabaseFile::getVariantSequence(Size variant) const
+  {
+    const VariantRecord_& record = variant_(variant);
+    return StringView(data_(record.sequence), record.sequence_length);
+  }
+
+  Size PeptideDatabaseFile::getVariantPeptide(Size variant) const
+  {
+    return variant_(variant).peptide;
+  }
+
+  std::pair<Size, Size> PeptideDatabaseFile::getVariantRange(double mass_min, double mass_max) const
+  {
+    const VariantRecord_* begin = &variant_(0);
+    const VariantRecord_* end = begin + nr_variants_;
+    const VariantRecord_* first = std::lower_bound(begin, end, mass_min,
+      [](const VariantRecord_& v, double mass) { return v.mass < mass; });
+    const VariantRecord_* last = std::upper_bound(first, end, mass_max,
+      [](double mass, const VariantRecord_& v) { return mass < v.mass; });
+    return std::make_pair(Size(first - begin), Size(last - begin));
+  }
+
+  const char* PeptideDatabaseFile::data_(UInt64 offset) const
+  {
+    return begin_ + offset;
+  }
+
+  const PeptideDatabaseFile::ProteinRecord_& PeptideDatabaseFile::protein_(Size protein) const
+  {
+    OPENMS_PRECONDITION(protein < nr_proteins_, "Protein index out of range");
+    return reinterpret_cast<const ProteinRecord_*>(data_(protein_table_))[protein];
+  }
+
+  const PeptideDatabaseFile::PeptideRecord_& PeptideDatabaseFile::peptide_(Size peptide) const
+  {
+    OPENMS_PRECONDITION(peptide < nr_peptides_, "Peptide index out of range");
+    return reinterpret_cast<const PeptideRecord_*>(data_(peptide_table_))[peptide];
+  }
+
+  const PeptideDatabaseFile::VariantRecord_& PeptideDatabaseFile::variant_(Size variant) const
+  {
+    OPENMS_PRECONDITION(variant <= nr_variants_, "Variant index out of range");
+    return reinterpret_cast<const VariantRecord_*>(data_(variant_table_))[variant];
+  }
+
+}
@@ -34,12 +34,46 @@
 
 #include <OpenMS/FORMAT/TextFile.h>
 
+#include <OpenMS/FORMAT/Bzip2Ifstream.h>
+#include <OpenMS/FORMAT/GzipIfstream.h>
+
+#include <cstring>
 #include <fstream>
+#include <vector>
 
 using namespace std;
 
 namespace OpenMS
 {
+  namespace
+  {
+    /// Minimal read-only stream buffer on top of GzipIfstream / Bzip2Ifstream
+    template <class DecompressorT>
+    class DecompressingStreambuf :
+      public std::streambuf
+    {
+  public:
+      explicit DecompressingStreambuf(const String& filename) :
+        in_(filename.c_str()),
+        buffer_(1 << 16)
+      {
+      }
+
+  protected:
+      int_type underflow() override
+      {
+        if (gptr() < egptr()) return traits_type::to_int_type(*gptr());
+        if (!in_.isOpen()) return traits_type::eof();
+        size_t n = in_.read(buffer_.data(), buffer_.size());
+        if (n == 0) return traits_type::eof();
+        setg(buffer_.data(), buffer_.data(), buffer_.data() + n);
+        return traits_type::to_int_type(*gptr());
+      }
+
+      DecompressorT in_;
+      std::vector<char> buffer_;
+    };
+  }
 
   TextFile::TextFile()
   {
@@ -65,6 +99,75 @@ namespace OpenMS
       throw Exception::FileNotFound(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, filename);
     }
 
+    // gzip and bzip2 compressed files are decompressed transparently
+    unsigned char magic[4] = {0, 0, 0, 0};
+    is.read(reinterpret_cast<char*>(magic), 4);
+    is.close();
+    if (magic[0] == 0x1f && magic[1] == 0x8b)
+    {
+      DecompressingStreambuf<GzipIfstream> sb(filename);
+      istream dis(&sb);
+      load_(dis, trim_lines, first_n, skip_empty_lines);
+    }
+    else if (magic[0] == 'B' && magic[1] == 'Z' && magic[2] == 'h' && magic[3] >= '1' && magic[3] <= '9')
+    {
+      DecompressingStreambuf<Bzip2Ifstream> sb(filename);
+      istream dis(&sb);
+      load_(dis, trim_lines, first_n, skip_empty_lines);
+    }
+    else if (first_n > -1)
+    {
+      is.open(filename.c_str(), ios_base::in | ios_base::binary);
+      load_(is, trim_lines, first_n, skip_empty_lines);
+    }
+    else
+    {
+      // read the whole file with a single call and split it into lines in
+      // memory, which is much faster than reading it character by character
+      is.open(filename.c_str(), ios_base::in | ios_base::binary);
+      is.seekg(0, ios_base::end);
+      std::streamoff file_size = is.tellg();
+      is.seekg(0, ios_base::beg);
+      if (file_size < 0)
+      { // not seekable (e.g. a pipe)
+        load_(is, trim_lines, first_n, skip_empty_lines);
+        return;
+      }
+      std::string content(static_cast<Size>(file_size), '\0');
+      if (file_size > 0) is.read(&content[0], file_size);
+      content.resize(static_cast<Size>(is.gcount()));
+      loadBuffer_(content, trim_lines, skip_empty_lines);
+    }
+  }
+
+  void TextFile::loadBuffer_(const std::string& content, bool trim_lines, bool skip_empty_lines)
+  {
+    buffer_.clear();
+
+    // line breaks are handled as in getLine(): '\n', '\r\n' or a single '\r'
+    const char* pos = content.data();
+    const char* const end = pos + content.size();
+    while (pos < end)
+    {
+      const char* eol = static_cast<const char*>(memchr(pos, '\n', end - pos));
+      if (eol == nullptr) eol = end;
+      const char* cr = static_cast<const char*>(memchr(pos, '\r', eol - pos));
+      if (cr != nullptr) eol = cr;
+
+      String str(pos, eol);
+      pos = eol + 1;
+      if (cr != nullptr && pos < end && *pos == '\n') ++pos; // consume "\r\n"
+
+      if (trim_lines) str.trim();
+      // skip? (only after trimming!)
+      if (skip_empty_lines && str.empty()) continue;
+
+      buffer_.push_back(std::move(str));
+    }
+  }
+
+  void TextFile::load_(std::istream& is, bool trim_lines, Int first_n, bool skip_empty_lines)
+  {
     buffer_.clear();
 
     String str;
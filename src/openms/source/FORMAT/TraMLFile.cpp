@@ -64,6 +64,18 @@ namespace OpenMS
     save_(filename, &handler);
   }
 
+  void TraMLFile::load(const String & filename, TargetedExperiment & exp, const TransitionConsumer & consumer)
+  {
+    Internal::TraMLHandler handler(exp, consumer, filename, schema_version_, *this);
+    parse_(filename, &handler);
+  }
+
+  void TraMLFile::store(const String & filename, const TargetedExperiment & exp, const TransitionSupplier & supplier) const
+  {
+    Internal::TraMLHandler handler(exp, supplier, filename, schema_version_, *this);
+    save_(filename, &handler);
+  }
+
   bool TraMLFile::isSemanticallyValid(const String & filename, StringList & errors, StringList & warnings)
   {
     //load mapping
@@ -0,0 +1,254 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2018.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: Timo Sachsenberg$
+// $Authors: Timo Sachsenberg $
+// --------------------------------------------------------------------------
+
+#include <OpenMS/KERNEL/ColumnarConsensusMap.h>
+
+#include <OpenMS/KERNEL/ConsensusMap.h>
+#include <OpenMS/CONCEPT/Exception.h>
+
+#include <algorithm>
+
+namespace OpenMS
+{
+  ColumnarConsensusMap::ColumnarConsensusMap() :
+    row_offsets_(1, 0)
+  {
+  }
+
+  ColumnarConsensusMap::ColumnarConsensusMap(const ConsensusMap& map) :
+    row_offsets_(1, 0)
+  {
+    assign(map);
+  }
+
+  bool ColumnarConsensusMap::operator==(const ColumnarConsensusMap& rhs) const
+  {
+    return rt_ == rhs.rt_ &&
+           mz_ == rhs.mz_ &&
+           intensity_ == rhs.intensity_ &&
+           charge_ == rhs.charge_ &&
+           quality_ == rhs.quality_ &&
+           width_ == rhs.width_ &&
+           unique_id_ == rhs.unique_id_ &&
+           row_offsets_ == rhs.row_offsets_ &&
+           handle_map_index_ == rhs.handle_map_index_ &&
+           handle_unique_id_ == rhs.handle_unique_id_ &&
+           handle_rt_ == rhs.handle_rt_ &&
+           handle_mz_ == rhs.handle_mz_ &&
+           handle_intensity_ == rhs.handle_intensity_ &&
+           handle_charge_ == rhs.handle_charge_ &&
+           handle_width_ == rhs.handle_width_ &&
+           map_sizes_ == rhs.map_sizes_;
+  }
+
+  void ColumnarConsensusMap::clear()
+  {
+    rt_.clear();
+    mz_.clear();
+    intensity_.clear();
+    charge_.clear();
+    quality_.clear();
+    width_.clear();
+    unique_id_.clear();
+    row_offsets_.assign(1, 0);
+    handle_map_index_.clear();
+    handle_unique_id_.clear();
+    handle_rt_.clear();
+    handle_mz_.clear();
+    handle_intensity_.clear();
+    handle_charge_.clear();
+    handle_width_.clear();
+    map_sizes_.clear();
+  }
+
+  void ColumnarConsensusMap::assign(const ConsensusMap& map)
+  {
+    clear();
+
+    const Size n = map.size();
+    Size n_handles = 0;
+    Size n_maps = 0;
+    for (ConsensusMap::ColumnHeaders::const_iterator it = map.getColumnHeaders().begin(); it != map.getColumnHeaders().end(); ++it)
+    {
+      n_maps = std::max(n_maps, Size(it->first + 1));
+    }
+    for (Size i = 0; i < n; ++i)
+    {
+      n_handles += map[i].size();
+      if (!map[i].empty())
+      {
+        // handles are ordered by map index, the last one has the largest
+        n_maps = std::max(n_maps, Size(map[i].rbegin()->getMapIndex() + 1));
+      }
+    }
+
+    rt_.reserve(n);
+    mz_.reserve(n);
+    intensity_.reserve(n);
+    charge_.reserve(n);
+    quality_.reserve(n);
+    width_.reserve(n);
+    unique_id_.reserve(n);
+    row_offsets_.reserve(n + 1);
+    handle_map_index_.reserve(n_handles);
+    handle_unique_id_.reserve(n_handles);
+    handle_rt_.reserve(n_handles);
+    handle_mz_.reserve(n_handles);
+    handle_intensity_.reserve(n_handles);
+    handle_charge_.reserve(n_handles);
+    handle_width_.reserve(n_handles);
+
+    for (Size i = 0; i < n; ++i)
+    {
+      const ConsensusFeature& cf = map[i];
+      rt_.push_back(cf.getRT());
+      mz_.push_back(cf.getMZ());
+      intensity_.push_back(cf.getIntensity());
+      charge_.push_back(cf.getCharge());
+      quality_.push_back(cf.getQuality());
+      width_.push_back(cf.getWidth());
+      unique_id_.push_back(cf.getUniqueId());
+
+      for (ConsensusFeature::HandleSetType::const_iterator h = cf.begin(); h != cf.end(); ++h)
+      {
+        handle_map_index_.push_back(h->getMapIndex());
+        handle_unique_id_.push_back(h->getUniqueId());
+        handle_rt_.push_back(h->getRT());
+        handle_mz_.push_back(h->getMZ());
+        handle_intensity_.push_back(h->getIntensity());
+        handle_charge_.push_back(h->getCharge());
+        handle_width_.push_back(h->getWidth());
+      }
+      row_offsets_.push_back(handle_map_index_.size());
+    }
+
+    map_sizes_.assign(n_maps, 0);
+    for (ConsensusMap::ColumnHeaders::const_iterator it = map.getColumnHeaders().begin(); it != map.getColumnHeaders().end(); ++it)
+    {
+      map_sizes_[it->first] = it->second.size;
+    }
+  }
+
+  void ColumnarConsensusMap::exportFeatures(ConsensusMap& map) const
+  {
+    const Size n = rt_.size();
+    map.resize(n);
+    for (Size i = 0; i < n; ++i)
+    {
+      ConsensusFeature& cf = map[i];
+      cf.setRT(rt_[i]);
+      cf.setMZ(mz_[i]);
+      cf.setIntensity(intensity_[i]);
+      cf.setCharge(charge_[i]);
+      cf.setQuality(quality_[i]);
+      cf.setWidth(width_[i]);
+      cf.setUniqueId(unique_id_[i]);
+
+      cf.clear();
+      for (Size k = row_offsets_[i]; k < row_offsets_[i + 1]; ++k)
+      {
+        FeatureHandle handle;
+        handle.setMapIndex(handle_map_index_[k]);
+        handle.setUniqueId(handle_unique_id_[k]);
+        handle.setRT(handle_rt_[k]);
+        handle.setMZ(handle_mz_[k]);
+        handle.setIntensity(handle_intensity_[k]);
+        handle.setCharge(handle_charge_[k]);
+        handle.setWidth(handle_width_[k]);
+        cf.insert(handle);
+      }
+    }
+  }
+
+  void ColumnarConsensusMap::exportIntensities(ConsensusMap& map) const
+  {
+    const Size n = rt_.size();
+    if (map.size() != n)
+    {
+      throw Exception::IllegalArgument(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "Number of consensus features differs (" + String(map.size()) + " vs. " + String(n) + ").");
+    }
+    for (Size i = 0; i < n; ++i)
+    {
+      ConsensusFeature& cf = map[i];
+      if (cf.size() != row_offsets_[i + 1] - row_offsets_[i])
+      {
+        throw Exception::IllegalArgument(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "Number of feature handles of consensus feature " + String(i) + " differs.");
+      }
+      Size k = row_offsets_[i];
+      for (ConsensusFeature::HandleSetType::const_iterator h = cf.begin(); h != cf.end(); ++h, ++k)
+      {
+        h->asMutable().setIntensity(handle_intensity_[k]);
+      }
+    }
+  }
+
+  SignedSize ColumnarConsensusMap::findHandle(Size feature, UInt64 map_index) const
+  {
+    std::vector<UInt64>::const_iterator first = handle_map_index_.begin() + row_offsets_[feature];
+    std::vector<UInt64>::const_iterator last = handle_map_index_.begin() + row_offsets_[feature + 1];
+    std::vector<UInt64>::const_iterator it = std::lower_bound(first, last, map_index);
+    if (it == last || *it != map_index)
+    {
+      return -1;
+    }
+    return it - handle_map_index_.begin();
+  }
+
+  void ColumnarConsensusMap::getIntensityMatrix(std::vector<double>& matrix, double missing) const
+  {
+    const Size n_maps = map_sizes_.size();
+    matrix.assign(rt_.size() * n_maps, missing);
+    for (Size i = 0; i < rt_.size(); ++i)
+    {
+      double* row = &matrix[0] + i * n_maps;
+      for (Size k = row_offsets_[i]; k < row_offsets_[i + 1]; ++k)
+      {
+        row[handle_map_index_[k]] = handle_intensity_[k];
+      }
+    }
+  }
+
+  void ColumnarConsensusMap::getMapIntensities(UInt64 map_index, std::vector<double>& intensities) const
+  {
+    intensities.clear();
+    for (Size i = 0; i < handle_map_index_.size(); ++i)
+    {
+      if (handle_map_index_[i] == map_index)
+      {
+        intensities.push_back(handle_intensity_[i]);
+      }
+    }
+  }
+
+} // namespace OpenMS
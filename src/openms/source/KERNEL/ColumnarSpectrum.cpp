@@ -0,0 +1,164 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2018.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: Timo Sachsenberg$
+// $Authors: Hannes Roest $
+// --------------------------------------------------------------------------
+
+#include <OpenMS/KERNEL/ColumnarSpectrum.h>
+
+#include <OpenMS/KERNEL/MSSpectrum.h>
+#include <OpenMS/CONCEPT/Exception.h>
+
+#include <algorithm>
+#include <numeric>
+
+namespace OpenMS
+{
+  ColumnarSpectrum::ColumnarSpectrum() :
+    mz_(),
+    intensity_(),
+    rt_(-1.0),
+    ms_level_(1)
+  {
+  }
+
+  ColumnarSpectrum::ColumnarSpectrum(const MSSpectrum& spectrum) :
+    mz_(),
+    intensity_(),
+    rt_(-1.0),
+    ms_level_(1)
+  {
+    assign(spectrum);
+  }
+
+  bool ColumnarSpectrum::operator==(const ColumnarSpectrum& rhs) const
+  {
+    return rt_ == rhs.rt_ &&
+           ms_level_ == rhs.ms_level_ &&
+           mz_ == rhs.mz_ &&
+           intensity_ == rhs.intensity_;
+  }
+
+  void ColumnarSpectrum::assign(const MSSpectrum& spectrum)
+  {
+    const Size n = spectrum.size();
+    mz_.resize(n);
+    intensity_.resize(n);
+    for (Size i = 0; i < n; ++i)
+    {
+      mz_[i] = spectrum[i].getMZ();
+      intensity_[i] = spectrum[i].getIntensity();
+    }
+    rt_ = spectrum.getRT();
+    ms_level_ = spectrum.getMSLevel();
+  }
+
+  void ColumnarSpectrum::exportPeaks(MSSpectrum& spectrum) const
+  {
+    const Size n = mz_.size();
+    spectrum.resize(n);
+    for (Size i = 0; i < n; ++i)
+    {
+      spectrum[i].setMZ(mz_[i]);
+      spectrum[i].setIntensity(intensity_[i]);
+    }
+    spectrum.setRT(rt_);
+    spectrum.setMSLevel(ms_level_);
+  }
+
+  void ColumnarSpectrum::sortByPosition()
+  {
+    if (isSorted()) return;
+
+    // sort a permutation, then apply it to both columns
+    std::vector<Size> order(mz_.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(),
+                     [this](Size a, Size b) { return mz_[a] < mz_[b]; });
+
+    MZContainer mz_sorted(mz_.size());
+    IntensityContainer intensity_sorted(intensity_.size());
+    for (Size i = 0; i < order.size(); ++i)
+    {
+      mz_sorted[i] = mz_[order[i]];
+      intensity_sorted[i] = intensity_[order[i]];
+    }
+    mz_.swap(mz_sorted);
+    intensity_.swap(intensity_sorted);
+  }
+
+  bool ColumnarSpectrum::isSorted() const
+  {
+    return std::is_sorted(mz_.begin(), mz_.end());
+  }
+
+  Size ColumnarSpectrum::findNearest(CoordinateType mz) const
+  {
+    // no peak => no search
+    if (mz_.empty()) throw Exception::Precondition(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "There must be at least one peak to determine the nearest peak!");
+
+    // search for position for inserting
+    Size i = std::lower_bound(mz_.begin(), mz_.end(), mz) - mz_.begin();
+    // border cases
+    if (i == 0) return 0;
+    if (i == mz_.size()) return mz_.size() - 1;
+
+    // the peak before or the current peak are closest
+    if (mz_[i] - mz < mz - mz_[i - 1]) return i;
+    return i - 1;
+  }
+
+  ColumnarSpectrum::Iterator ColumnarSpectrum::MZBegin(CoordinateType mz)
+  {
+    return begin() + (std::lower_bound(mz_.begin(), mz_.end(), mz) - mz_.begin());
+  }
+
+  ColumnarSpectrum::ConstIterator ColumnarSpectrum::MZBegin(CoordinateType mz) const
+  {
+    return begin() + (std::lower_bound(mz_.begin(), mz_.end(), mz) - mz_.begin());
+  }
+
+  ColumnarSpectrum::Iterator ColumnarSpectrum::MZEnd(CoordinateType mz)
+  {
+    return begin() + (std::upper_bound(mz_.begin(), mz_.end(), mz) - mz_.begin());
+  }
+
+  ColumnarSpectrum::ConstIterator ColumnarSpectrum::MZEnd(CoordinateType mz) const
+  {
+    return begin() + (std::upper_bound(mz_.begin(), mz_.end(), mz) - mz_.begin());
+  }
+
+  double ColumnarSpectrum::calculateTIC() const
+  {
+    return std::accumulate(intensity_.begin(), intensity_.end(), 0.0);
+  }
+
+} // namespace OpenMS
@@ -91,6 +91,10 @@ namespace OpenMS
   {
   }
 
+  ConsensusMap::ConsensusMap(ConsensusMap&&) = default;
+
+  ConsensusMap& ConsensusMap::operator=(ConsensusMap&&) & = default;
+
   ConsensusMap::~ConsensusMap()
   {
   }
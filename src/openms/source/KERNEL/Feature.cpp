@@ -129,8 +129,9 @@ namespace OpenMS
           DBoundingBox<2> box;
           for (Size hull = 0; hull < convex_hulls_.size(); ++hull)
           {
-            box.enlarge(convex_hulls_[hull].getBoundingBox().minPosition()[0], convex_hulls_[hull].getBoundingBox().minPosition()[1]);
-            box.enlarge(convex_hulls_[hull].getBoundingBox().maxPosition()[0], convex_hulls_[hull].getBoundingBox().maxPosition()[1]);
+            const DBoundingBox<2> hull_box = convex_hulls_[hull].getBoundingBox();
+            box.enlarge(hull_box.minPosition()[0], hull_box.minPosition()[1]);
+            box.enlarge(hull_box.maxPosition()[0], hull_box.maxPosition()[1]);
           }
           convex_hull_.addPoint(ConvexHull2D::PointType(box.minX(), box.minY()));
           convex_hull_.addPoint(ConvexHull2D::PointType(box.maxX(), box.minY()));
@@ -157,6 +158,22 @@ namespace OpenMS
     return false;
   }
 
+  void Feature::compactConvexHulls(bool bounding_boxes_only)
+  {
+    for (vector<ConvexHull2D>::iterator it = convex_hulls_.begin(); it != convex_hulls_.end(); ++it)
+    {
+      it->compact(bounding_boxes_only);
+    }
+    convex_hulls_.shrink_to_fit();
+    // the overall hull is recomputed from the compact hulls on demand
+    convex_hull_ = ConvexHull2D();
+    convex_hulls_modified_ = true;
+    for (vector<Feature>::iterator it = subordinates_.begin(); it != subordinates_.end(); ++it)
+    {
+      it->compactConvexHulls(bounding_boxes_only);
+    }
+  }
+
   Feature& Feature::operator=(const Feature& rhs)
   {
     if (this == &rhs)
@@ -124,6 +124,10 @@ namespace OpenMS
   {
   }
 
+  FeatureMap::FeatureMap(FeatureMap&&) = default;
+
+  FeatureMap& FeatureMap::operator=(FeatureMap&&) & = default;
+
   FeatureMap::~FeatureMap()
   {
   }
@@ -276,6 +280,15 @@ namespace OpenMS
     }
   }
 
+  void FeatureMap::compactConvexHulls(bool bounding_boxes_only)
+  {
+#pragma omp parallel for schedule(dynamic, 1000)
+    for (SignedSize i = 0; i < (SignedSize)this->size(); ++i)
+    {
+      this->operator[](i).compactConvexHulls(bounding_boxes_only);
+    }
+  }
+
   void FeatureMap::swapFeaturesOnly(FeatureMap& from)
   {
     // TODO used by FeatureFinderAlgorithmPicked -- could it also use regular swap?
@@ -41,6 +41,7 @@
 #include <OpenMS/SYSTEM/File.h>
 
 #include <algorithm>
+#include <map>
 #include <limits>
 
 namespace OpenMS
@@ -222,6 +223,58 @@ namespace OpenMS
   @param ms_level MS level to consider for m/z range , RT range and intensity range (All MS levels if negative)
   */
   void MSExperiment::updateRanges(Int ms_level)
+  {
+    // update the ranges of the spectra and chromatograms (this touches every data point)
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic, 16)
+#endif
+    for (SignedSize i = 0; i < (SignedSize) spectra_.size(); ++i)
+    {
+      if ((ms_level < Int(0) || Int(spectra_[i].getMSLevel()) == ms_level) && !spectra_[i].empty())
+      {
+        spectra_[i].updateRanges();
+      }
+    }
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic, 16)
+#endif
+    for (SignedSize i = 0; i < (SignedSize) chromatograms_.size(); ++i)
+    {
+      if (chromatograms_[i].getChromatogramType() != ChromatogramSettings::TOTAL_ION_CURRENT_CHROMATOGRAM &&
+          chromatograms_[i].getChromatogramType() != ChromatogramSettings::EMISSION_CHROMATOGRAM &&
+          !chromatograms_[i].empty())
+      {
+        chromatograms_[i].updateRanges();
+      }
+    }
+
+    combineRanges_(ms_level);
+  }
+
+  void MSExperiment::updateRanges(const std::vector<Size>& modified_spectra, Int ms_level)
+  {
+    for (std::vector<Size>::const_iterator it = modified_spectra.begin(); it != modified_spectra.end(); ++it)
+    {
+      if (*it >= spectra_.size())
+      {
+        throw Exception::IndexOverflow(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, *it, spectra_.size());
+      }
+    }
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic, 16)
+#endif
+    for (SignedSize i = 0; i < (SignedSize) modified_spectra.size(); ++i)
+    {
+      SpectrumType& spectrum = spectra_[modified_spectra[i]];
+      if ((ms_level < Int(0) || Int(spectrum.getMSLevel()) == ms_level) && !spectrum.empty())
+      {
+        spectrum.updateRanges();
+      }
+    }
+    combineRanges_(ms_level);
+  }
+
+  void MSExperiment::combineRanges_(Int ms_level)
   {
     //clear MS levels
     ms_levels_.clear();
@@ -258,8 +311,6 @@ namespace OpenMS
         //do not update mz and int when the spectrum is empty
         if (it->size() == 0) continue;
 
-        it->updateRanges();
-
         //mz
         if (it->getMin()[0] < RangeManagerType::pos_range_.minY()) RangeManagerType::pos_range_.setMinY(it->getMin()[0]);
         if (it->getMax()[0] > RangeManagerType::pos_range_.maxY()) RangeManagerType::pos_range_.setMaxY(it->getMax()[0]);
@@ -316,8 +367,6 @@ namespace OpenMS
 
       total_size_ += it->size();
 
-      it->updateRanges();
-
       // RT
       if (it->getMin()[0] < RangeManagerType::pos_range_.minX()) RangeManagerType::pos_range_.setMinX(it->getMin()[0]);
       if (it->getMax()[0] > RangeManagerType::pos_range_.maxX()) RangeManagerType::pos_range_.setMaxX(it->getMax()[0]);
@@ -374,6 +423,71 @@ namespace OpenMS
     return ms_levels_;
   }
 
+  void MSExperiment::getPeakArrays(std::vector<double>& mz, std::vector<float>& intensity, std::vector<Size>& offsets) const
+  {
+    offsets.resize(spectra_.size() + 1);
+    offsets[0] = 0;
+    for (Size i = 0; i < spectra_.size(); ++i)
+    {
+      offsets[i + 1] = offsets[i] + spectra_[i].size();
+    }
+    mz.resize(offsets.back());
+    intensity.resize(offsets.back());
+
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic, 64)
+#endif
+    for (SignedSize i = 0; i < (SignedSize)spectra_.size(); ++i)
+    {
+      Size k = offsets[i];
+      for (SpectrumType::const_iterator it = spectra_[i].begin(); it != spectra_[i].end(); ++it, ++k)
+      {
+        mz[k] = it->getMZ();
+        intensity[k] = it->getIntensity();
+      }
+    }
+  }
+
+  void MSExperiment::setPeakArrays(const std::vector<double>& mz, const std::vector<float>& intensity, const std::vector<Size>& offsets)
+  {
+    if (offsets.size() != spectra_.size() + 1 || offsets[0] != 0)
+    {
+      throw Exception::InvalidParameter(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "The offsets must start at 0 and contain one entry more than the number of spectra.");
+    }
+    if (mz.size() != intensity.size() || offsets.back() != mz.size())
+    {
+      throw Exception::InvalidParameter(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "The m/z and intensity arrays must have the size given by the last offset.");
+    }
+    for (Size i = 0; i < spectra_.size(); ++i)
+    {
+      if (offsets[i] > offsets[i + 1])
+      {
+        throw Exception::InvalidParameter(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "The offsets must not decrease.");
+      }
+    }
+
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic, 64)
+#endif
+    for (SignedSize i = 0; i < (SignedSize)spectra_.size(); ++i)
+    {
+      SpectrumType& spectrum = spectra_[i];
+      Size n = offsets[i + 1] - offsets[i];
+      if (n != spectrum.size())
+      {
+        spectrum.getFloatDataArrays().clear();
+        spectrum.getIntegerDataArrays().clear();
+        spectrum.getStringDataArrays().clear();
+      }
+      spectrum.resize(n);
+      for (Size k = 0; k < n; ++k)
+      {
+        spectrum[k].setMZ(mz[offsets[i] + k]);
+        spectrum[k].setIntensity(intensity[offsets[i] + k]);
+      }
+    }
+  }
+
   ///@}
 
   ///@name Sorting spectra and peaks
@@ -442,6 +556,38 @@ namespace OpenMS
 
   //@}
 
+  Size MSExperiment::shareSpectrumMetaData()
+  {
+    Size nr_shared = 0;
+    std::map<UInt, Size> last_of_level;
+    for (Size i = 0; i < spectra_.size(); ++i)
+    {
+      Size shared = 0;
+      if (i > 0)
+      {
+        shared = spectra_[i].shareMetaData(spectra_[i - 1]);
+      }
+
+      std::map<UInt, Size>::iterator it = last_of_level.find(spectra_[i].getMSLevel());
+      if (it != last_of_level.end())
+      {
+        // only needed if not everything is shared with the direct predecessor already
+        if (shared < 3 && it->second + 1 != i)
+        {
+          shared = std::max(shared, spectra_[i].shareMetaData(spectra_[it->second]));
+        }
+        it->second = i;
+      }
+      else
+      {
+        last_of_level[spectra_[i].getMSLevel()] = i;
+      }
+
+      if (shared > 0) ++nr_shared;
+    }
+    return nr_shared;
+  }
+
   /// Resets all internal values
   void MSExperiment::reset()
   {
@@ -563,6 +709,11 @@ namespace OpenMS
     spectra_ = spectra;
   }
 
+  void MSExperiment::setSpectra(std::vector<MSSpectrum> && spectra)
+  {
+    spectra_ = std::move(spectra);
+  }
+
   /// adds a spectrum to the list
   void MSExperiment::addSpectrum(const MSSpectrum & spectrum)
   {
@@ -587,6 +738,11 @@ namespace OpenMS
     chromatograms_ = chromatograms;
   }
 
+  void MSExperiment::setChromatograms(std::vector<MSChromatogram > && chromatograms)
+  {
+    chromatograms_ = std::move(chromatograms);
+  }
+
   /// adds a chromatogram to the list
   void MSExperiment::addChromatogram(const MSChromatogram & chromatogram)
   {
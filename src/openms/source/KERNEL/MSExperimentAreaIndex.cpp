@@ -0,0 +1,275 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2018.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: Timo Sachsenberg$
+// $Authors: Timo Sachsenberg $
+// --------------------------------------------------------------------------
+
+#include <OpenMS/KERNEL/MSExperimentAreaIndex.h>
+
+#include <OpenMS/KERNEL/MSExperiment.h>
+#include <OpenMS/KERNEL/Peak2D.h>
+#include <OpenMS/CONCEPT/Exception.h>
+
+#include <algorithm>
+#include <limits>
+#include <numeric>
+
+namespace OpenMS
+{
+  namespace
+  {
+    bool spectrumPeakLess_(const PeakIndex& a, const PeakIndex& b)
+    {
+      return a.spectrum < b.spectrum || (a.spectrum == b.spectrum && a.peak < b.peak);
+    }
+  }
+
+  MSExperimentAreaIndex::MSExperimentAreaIndex() :
+    bin_width_(1.0),
+    spectra_per_block_(32),
+    min_mz_(0.0),
+    number_of_bins_(1),
+    tile_offsets_(1, 0)
+  {
+  }
+
+  MSExperimentAreaIndex::MSExperimentAreaIndex(const MSExperiment& exp, double mz_bin_width, Size spectra_per_block, UInt ms_level) :
+    bin_width_(mz_bin_width),
+    spectra_per_block_(spectra_per_block),
+    min_mz_(0.0),
+    number_of_bins_(1)
+  {
+    if (!(mz_bin_width > 0.0))
+    {
+      throw Exception::IllegalArgument(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "The m/z bin width has to be positive.");
+    }
+    if (spectra_per_block == 0)
+    {
+      throw Exception::IllegalArgument(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "The number of spectra per block has to be positive.");
+    }
+
+    double max_mz = -std::numeric_limits<double>::max();
+    min_mz_ = std::numeric_limits<double>::max();
+    for (Size s = 0; s < exp.size(); ++s)
+    {
+      if (ms_level != 0 && exp[s].getMSLevel() != ms_level)
+      {
+        continue;
+      }
+      if (!rt_.empty() && exp[s].getRT() < rt_.back())
+      {
+        throw Exception::IllegalArgument(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "The spectra have to be sorted by RT.");
+      }
+      rt_.push_back(exp[s].getRT());
+      spectrum_index_.push_back(s);
+      for (MSSpectrum::ConstIterator it = exp[s].begin(); it != exp[s].end(); ++it)
+      {
+        min_mz_ = std::min(min_mz_, it->getMZ());
+        max_mz = std::max(max_mz, it->getMZ());
+      }
+    }
+    if (max_mz < min_mz_) // no peaks
+    {
+      min_mz_ = 0.0;
+      max_mz = 0.0;
+    }
+    number_of_bins_ = (Size)((max_mz - min_mz_) / bin_width_) + 1;
+
+    const Size number_of_spectra = rt_.size();
+    const Size number_of_blocks = (number_of_spectra + spectra_per_block_ - 1) / spectra_per_block_;
+    tile_offsets_.assign(number_of_blocks * number_of_bins_ + 1, 0);
+
+    // count the peaks per tile (the tiles of different blocks are disjoint)
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic)
+#endif
+    for (SignedSize b = 0; b < (SignedSize) number_of_blocks; ++b)
+    {
+      Size* counts = &tile_offsets_[b * number_of_bins_ + 1];
+      const Size spectrum_end = std::min((b + 1) * spectra_per_block_, number_of_spectra);
+      for (Size s = b * spectra_per_block_; s < spectrum_end; ++s)
+      {
+        const MSSpectrum& spectrum = exp[spectrum_index_[s]];
+        for (MSSpectrum::ConstIterator it = spectrum.begin(); it != spectrum.end(); ++it)
+        {
+          ++counts[getBin_(it->getMZ())];
+        }
+      }
+    }
+    std::partial_sum(tile_offsets_.begin(), tile_offsets_.end(), tile_offsets_.begin());
+
+    const Size number_of_peaks = tile_offsets_.back();
+    peak_mz_.resize(number_of_peaks);
+    peak_intensity_.resize(number_of_peaks);
+    peak_spectrum_.resize(number_of_peaks);
+    peak_index_.resize(number_of_peaks);
+
+    // distribute the peaks, spectrum by spectrum, so each tile is ordered by spectrum
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic)
+#endif
+    for (SignedSize b = 0; b < (SignedSize) number_of_blocks; ++b)
+    {
+      std::vector<Size> cursor(tile_offsets_.begin() + b * number_of_bins_, tile_offsets_.begin() + (b + 1) * number_of_bins_);
+      const Size spectrum_end = std::min((b + 1) * spectra_per_block_, number_of_spectra);
+      for (Size s = b * spectra_per_block_; s < spectrum_end; ++s)
+      {
+        const MSSpectrum& spectrum = exp[spectrum_index_[s]];
+        for (Size p = 0; p < spectrum.size(); ++p)
+        {
+          const Size pos = cursor[getBin_(spectrum[p].getMZ())]++;
+          peak_mz_[pos] = spectrum[p].getMZ();
+          peak_intensity_[pos] = spectrum[p].getIntensity();
+          peak_spectrum_[pos] = (UInt32) s;
+          peak_index_[pos] = (UInt32) p;
+        }
+      }
+    }
+  }
+
+  Size MSExperimentAreaIndex::getBin_(double mz) const
+  {
+    if (!(mz > min_mz_))
+    {
+      return 0;
+    }
+    return std::min((Size)((mz - min_mz_) / bin_width_), number_of_bins_ - 1);
+  }
+
+  bool MSExperimentAreaIndex::getRange_(double min_rt, double max_rt, double min_mz, double max_mz,
+                                        Size& spectrum_begin, Size& spectrum_end, Size& bin_begin, Size& bin_end) const
+  {
+    if (peak_mz_.empty() || min_rt > max_rt || min_mz > max_mz)
+    {
+      return false;
+    }
+    spectrum_begin = std::lower_bound(rt_.begin(), rt_.end(), min_rt) - rt_.begin();
+    spectrum_end = std::upper_bound(rt_.begin(), rt_.end(), max_rt) - rt_.begin();
+    if (spectrum_begin >= spectrum_end)
+    {
+      return false;
+    }
+    bin_begin = getBin_(min_mz);
+    bin_end = getBin_(max_mz);
+    return true;
+  }
+
+  void MSExperimentAreaIndex::getPeaks(double min_rt, double max_rt, double min_mz, double max_mz, std::vector<PeakIndex>& peaks) const
+  {
+    peaks.clear();
+    Size spectrum_begin, spectrum_end, bin_begin, bin_end;
+    if (!getRange_(min_rt, max_rt, min_mz, max_mz, spectrum_begin, spectrum_end, bin_begin, bin_end))
+    {
+      return;
+    }
+
+    const Size block_end = (spectrum_end - 1) / spectra_per_block_;
+    for (Size b = spectrum_begin / spectra_per_block_; b <= block_end; ++b)
+    {
+      const Size first = peaks.size();
+      // only tiles at the border of the area need to be checked peak by peak
+      const bool check_rt = b * spectra_per_block_ < spectrum_begin || (b + 1) * spectra_per_block_ > spectrum_end;
+      for (Size k = bin_begin; k <= bin_end; ++k)
+      {
+        const bool check_mz = (k == bin_begin || k == bin_end);
+        const Size tile = b * number_of_bins_ + k;
+        for (Size i = tile_offsets_[tile]; i < tile_offsets_[tile + 1]; ++i)
+        {
+          if (check_mz && (peak_mz_[i] < min_mz || peak_mz_[i] > max_mz)) continue;
+          if (check_rt && (peak_spectrum_[i] < spectrum_begin || peak_spectrum_[i] >= spectrum_end)) continue;
+          peaks.push_back(PeakIndex(spectrum_index_[peak_spectrum_[i]], peak_index_[i]));
+        }
+      }
+      // each tile is ordered by spectrum, merge the tiles of the block
+      if (bin_end > bin_begin)
+      {
+        std::sort(peaks.begin() + first, peaks.end(), spectrumPeakLess_);
+      }
+    }
+  }
+
+  double MSExperimentAreaIndex::getIntensitySum(double min_rt, double max_rt, double min_mz, double max_mz) const
+  {
+    double sum = 0.0;
+    Size spectrum_begin, spectrum_end, bin_begin, bin_end;
+    if (!getRange_(min_rt, max_rt, min_mz, max_mz, spectrum_begin, spectrum_end, bin_begin, bin_end))
+    {
+      return sum;
+    }
+
+    const Size block_end = (spectrum_end - 1) / spectra_per_block_;
+    for (Size b = spectrum_begin / spectra_per_block_; b <= block_end; ++b)
+    {
+      const bool check_rt = b * spectra_per_block_ < spectrum_begin || (b + 1) * spectra_per_block_ > spectrum_end;
+      for (Size k = bin_begin; k <= bin_end; ++k)
+      {
+        const bool check_mz = (k == bin_begin || k == bin_end);
+        const Size tile = b * number_of_bins_ + k;
+        for (Size i = tile_offsets_[tile]; i < tile_offsets_[tile + 1]; ++i)
+        {
+          if (check_mz && (peak_mz_[i] < min_mz || peak_mz_[i] > max_mz)) continue;
+          if (check_rt && (peak_spectrum_[i] < spectrum_begin || peak_spectrum_[i] >= spectrum_end)) continue;
+          sum += peak_intensity_[i];
+        }
+      }
+    }
+    return sum;
+  }
+
+  void MSExperimentAreaIndex::getPeaks(const std::vector<AreaType>& areas, std::vector<std::vector<PeakIndex> >& peaks) const
+  {
+    peaks.resize(areas.size());
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic, 16)
+#endif
+    for (SignedSize i = 0; i < (SignedSize) areas.size(); ++i)
+    {
+      const AreaType& area = areas[i];
+      getPeaks(area.minPosition()[Peak2D::RT], area.maxPosition()[Peak2D::RT],
+               area.minPosition()[Peak2D::MZ], area.maxPosition()[Peak2D::MZ], peaks[i]);
+    }
+  }
+
+  void MSExperimentAreaIndex::getIntensitySums(const std::vector<AreaType>& areas, std::vector<double>& sums) const
+  {
+    sums.resize(areas.size());
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic, 16)
+#endif
+    for (SignedSize i = 0; i < (SignedSize) areas.size(); ++i)
+    {
+      const AreaType& area = areas[i];
+      sums[i] = getIntensitySum(area.minPosition()[Peak2D::RT], area.maxPosition()[Peak2D::RT],
+                                area.minPosition()[Peak2D::MZ], area.maxPosition()[Peak2D::MZ]);
+    }
+  }
+
+} // namespace OpenMS
@@ -35,6 +35,8 @@
 #include <OpenMS/KERNEL/OnDiscMSExperiment.h>
 
 #include <OpenMS/FORMAT/MzMLFile.h>
+#include <OpenMS/CONCEPT/Exception.h>
+
 namespace OpenMS
 {
 
@@ -48,5 +50,35 @@ namespace OpenMS
     f.setOptions(options);
     f.load(filename, *meta_ms_experiment_.get());
   }
+
+  boost::shared_ptr<const MSSpectrum> OnDiscMSExperiment::getCachedSpectrum(Size id)
+  {
+    if (!spectrum_cache_ || id >= spectrum_cache_->spectra.size())
+    {
+      throw Exception::IndexOverflow(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, id, getNrSpectra());
+    }
+    // if decoding throws, the flag stays unset and the next access tries again
+    std::call_once(spectrum_cache_->decoded[id], [this, id]()
+    {
+      spectrum_cache_->spectra[id] = boost::shared_ptr<const MSSpectrum>(new MSSpectrum(getSpectrum(id)));
+    });
+    return spectrum_cache_->spectra[id];
+  }
+
+  void OnDiscMSExperiment::clearSpectrumCache()
+  {
+    spectrum_cache_.reset(new SpectrumCache_(getNrSpectra()));
+  }
+
+  Size OnDiscMSExperiment::getNrCachedSpectra() const
+  {
+    if (!spectrum_cache_) return 0;
+    Size count(0);
+    for (Size i = 0; i < spectrum_cache_->spectra.size(); ++i)
+    {
+      if (spectrum_cache_->spectra[i]) ++count;
+    }
+    return count;
+  }
 } //namespace OpenMS
 
@@ -5,6 +5,8 @@ set(directory source/KERNEL)
 set(sources_list
 AreaIterator.cpp
 BaseFeature.cpp
+ColumnarConsensusMap.cpp
+ColumnarSpectrum.cpp
 ConsensusFeature.cpp
 ConsensusMap.cpp
 ConversionHelper.cpp
@@ -16,6 +18,7 @@ MassTrace.cpp
 MRMFeature.cpp
 MRMTransitionGroup.cpp
 MSExperiment.cpp
+MSExperimentAreaIndex.cpp
 MSSpectrum.cpp
 OnDiscMSExperiment.cpp
 Peak1D.cpp
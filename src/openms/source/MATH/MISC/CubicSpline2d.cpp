@@ -35,6 +35,7 @@
 #include <OpenMS/MATH/MISC/CubicSpline2d.h>
 
 #include <OpenMS/CONCEPT/Exception.h>
+#include <OpenMS/CONCEPT/Macros.h>
 
 #include <algorithm>
 #include <functional>
@@ -105,6 +106,14 @@ namespace OpenMS
     return ((d_[i] * xx + c_[i]) * xx + b_[i]) * xx + a_[i];
   }
 
+  double CubicSpline2d::eval(double x, Size i) const
+  {
+    OPENMS_PRECONDITION(i + 1 < x_.size(), "Interval index out of range of spline interpolation.")
+
+    const double xx = x - x_[i];
+    return ((d_[i] * xx + c_[i]) * xx + b_[i]) * xx + a_[i];
+  }
+
   double CubicSpline2d::derivatives(double x, unsigned order) const
   {
     if (x < x_.front() || x > x_.back())
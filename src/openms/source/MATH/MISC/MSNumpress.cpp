@@ -152,58 +152,83 @@ static void encodeInt(
 
 /**
  * Decodes an int from the half bytes in bp. Lossless reverse of encodeInt 
+ *
+ * The position in data is given as index of the half byte (hi), i.e. the
+ * high half byte of data[hi/2] for even and the low half byte for odd hi.
+ *
+ * Away from the end of the data, the next 16 half bytes are read at once and
+ * the int is assembled with a few bit operations instead of a loop over its
+ * half bytes.
  */
-static void decodeInt(
+static inline unsigned char halfByteAt(
 		const unsigned char *data,
-		size_t *di,
+		size_t hi
+) {
+	return (data[hi >> 1] >> (((hi & 1) ^ 1) << 2)) & 0xf;
+}
+
+static inline unsigned long long loadBigEndian64(
+		const unsigned char *p
+) {
+	return (static_cast<unsigned long long>(p[0]) << 56) | (static_cast<unsigned long long>(p[1]) << 48)
+		| (static_cast<unsigned long long>(p[2]) << 40) | (static_cast<unsigned long long>(p[3]) << 32)
+		| (static_cast<unsigned long long>(p[4]) << 24) | (static_cast<unsigned long long>(p[5]) << 16)
+		| (static_cast<unsigned long long>(p[6]) << 8) | static_cast<unsigned long long>(p[7]);
+}
+
+static inline void decodeInt(
+		const unsigned char *data,
+		size_t *hi,
 		size_t max_di,
-		size_t *half,
 		unsigned int *res
 ) {
-    size_t n, i;
-    unsigned int mask, m;
-    unsigned char head;
-    unsigned char hb;
-
-	if (*half == 0) {
-		head = data[*di] >> 4;
-	} else {
-		head = data[*di] & 0xf;
-		(*di)++;
+	size_t n, i;
+	unsigned char head;
+	size_t pos = *hi;
+
+	if ((pos >> 1) + 8 <= max_di) {
+		// window with the head as the highest half byte
+		unsigned long long w = loadBigEndian64(&data[pos >> 1]) << ((pos & 1) << 2);
+		head = static_cast<unsigned char>(w >> 60);
+		// n leading zeros (head <= 8) or n leading ones (head > 8), computed
+		// without branches as the sign of the values is unpredictable
+		n = (head & 7) + (static_cast<size_t>(head == 8) << 3);
+		const unsigned int value_mask = static_cast<unsigned int>(0xffffffffull >> (4*n));
+		const unsigned int leading_ones = 0u - static_cast<unsigned int>(head > 8);
+		// the following half bytes hold the int starting with its lowest
+		// half byte: reverse their order
+		unsigned int x = static_cast<unsigned int>((w << 4) >> 32);
+		x = (x >> 16) | (x << 16);
+		x = ((x & 0x00ff00ffu) << 8) | ((x >> 8) & 0x00ff00ffu);
+		x = ((x & 0x0f0f0f0fu) << 4) | ((x >> 4) & 0x0f0f0f0fu);
+		*res = (leading_ones & ~value_mask) | (x & value_mask);
+		*hi = pos + 1 + (8 - n);
+		return;
 	}
 
-	*half = 1-(*half);
-	*res = 0;
+	head = halfByteAt(data, pos++);
 	
 	if (head <= 8) {
 		n = head;
+		*res = 0;
 	} else { // leading ones, fill n half bytes in res
 		n = head - 8;
-		mask = 0xf0000000;
-		for (i=0; i<n; i++) {
-			m = mask >> (4*i);
-			*res = *res | m;
-		}
+		*res = ~(0xffffffffu >> (4*n));
 	}
 	
 	if (n == 8) {
+		*hi = pos;
 		return;
 	}
 	
-	if (*di + ((8 - n) - (1 - *half)) / 2 >= max_di) {
+	if ((pos + (7 - n)) / 2 >= max_di) {
 		throw "[MSNumpress::decodeInt] Corrupt input data! ";
 	}
 	
 	for (i=n; i<8; i++) {
-		if (*half == 0) {
-			hb = data[*di] >> 4;
-		} else {
-			hb = data[*di] & 0xf;
-			(*di)++;
-		}
-		*res = *res | ( static_cast<unsigned int>(hb) << ((i-n)*4));
-		*half = 1 - (*half);
+		*res = *res | ( static_cast<unsigned int>(halfByteAt(data, pos++)) << ((i-n)*4));
 	}
+	*hi = pos;
 }
 
 
@@ -254,13 +279,19 @@ double optimalLinearFixedPoint(
 	if (dataSize == 0) return 0;
 	if (dataSize == 1) return floor(0x7FFFFFFFl / data[0]);
 	double maxDouble = max(data[0], data[1]);
+	double maxDiff = -1;
 	double extrapol;
 	double diff;
 
+	// ceil is monotonic, so it is sufficient to apply it to the largest
+	// difference (this keeps the loop free of function calls)
 	for (size_t i=2; i<dataSize; i++) {
 		extrapol = data[i-1] + (data[i-1] - data[i-2]);
-		diff = data[i] - extrapol;
-		maxDouble = max(maxDouble, ceil(abs(diff)+1));
+		diff = abs(data[i] - extrapol);
+		maxDiff = diff > maxDiff ? diff : maxDiff;
+	}
+	if (dataSize > 2) {
+		maxDouble = max(maxDouble, ceil(maxDiff+1));
 	}
 
 	return floor(0x7FFFFFFFl / maxDouble);
@@ -370,8 +401,7 @@ size_t decodeLinear(
 	int diff;
 	long long ints[3];
 	//double d;
-	size_t di;
-	size_t half;
+	size_t hi;
 	long long extrapol;
 	long long y;
 	double fixedPoint;
@@ -405,32 +435,38 @@ size_t decodeLinear(
 	}
 	result[1] = ints[2] / fixedPoint;
 		
-	half = 0;
 	ri = 2;
-	di = 16;
+	hi = 2 * 16;
 	
-	//printf("   di     ri      half    int[0]    int[1]    extrapol   diff\n");
+	//printf("   hi     ri    int[0]    int[1]    extrapol   diff\n");
 	
-	while (di < dataSize) {
-		if (di == (dataSize - 1) && half == 1) {
-			if ((data[di] & 0xf) == 0x0) {
+	while (hi < 2 * dataSize) {
+		if (hi == (2 * dataSize - 1)) {
+			if ((data[dataSize - 1] & 0xf) == 0x0) {
 				break;
 			}
 		}
-		//printf("%7d %7d %7d %lu %lu %ld", di, ri, half, ints[0], ints[1], extrapol);
+		//printf("%7d %7d %lu %lu %ld", hi, ri, ints[0], ints[1], extrapol);
 		
 		ints[0] = ints[1];
 		ints[1] = ints[2];
-		decodeInt(data, &di, dataSize, &half, &buff);
+		decodeInt(data, &hi, dataSize, &buff);
 		diff = static_cast<int>(buff);
 
 		extrapol = ints[1] + (ints[1] - ints[0]);
 		y = extrapol + diff;
 		//printf(" %d \n", diff);
-		result[ri++] 	= y / fixedPoint;
+		// store the integer, scaling happens in a separate pass below
+		result[ri++] 	= static_cast<double>(y);
 		ints[2] 		= y;
 	}
 
+	// scale all values at once: the loop has no dependencies and can be
+	// vectorized (division is exact, results are identical to y / fixedPoint)
+	for (i=2; i<ri; i++) {
+		result[i] = result[i] / fixedPoint;
+	}
+
 	return ri;
 }
 
@@ -622,25 +658,23 @@ size_t decodePic(
 ) {
 	size_t ri;
 	unsigned int x;
-	size_t di;
-	size_t half;
+	size_t hi;
 
-	//printf("ri      di      half    dSize   count\n");
+	//printf("ri      hi      dSize   count\n");
 	
-	half = 0;
 	ri = 0;
-	di = 0;
+	hi = 0;
 	
-	while (di < dataSize) {
-		if (di == (dataSize - 1) && half == 1) {
-			if ((data[di] & 0xf) == 0x0) {
+	while (hi < 2 * dataSize) {
+		if (hi == (2 * dataSize - 1)) {
+			if ((data[dataSize - 1] & 0xf) == 0x0) {
 				break;
 			}
 		}
 		
-		decodeInt(&data[0], &di, dataSize, &half, &x);
+		decodeInt(&data[0], &hi, dataSize, &x);
 		
-		//printf("%7d %7d %7d %7d %7d\n", ri, di, half, dataSize, count);
+		//printf("%7d %7d %7d %7d\n", ri, hi, dataSize, count);
 		
 		//printf("count: %d \n", count);
 		result[ri++] = static_cast<double>(x);
@@ -684,13 +718,14 @@ double optimalSlofFixedPoint(
 	if (dataSize == 0) return 0;
 	
 	double maxDouble = 1;
-	double x;
+	double maxData = -1;
 	double fp;
 
+	// log is monotonic, so it is sufficient to take the log of the largest value
 	for (size_t i=0; i<dataSize; i++) {
-		x = log(data[i]+1);
-		maxDouble = max(maxDouble, x);
+		maxData = data[i] > maxData ? data[i] : maxData;
 	}
+	maxDouble = max(maxDouble, log(maxData+1));
 
 	// here we use 0xFFFE as maximal value as we add 0.5 during encoding (see encodeSlof)
 	fp = floor(0xFFFE / maxDouble);
@@ -747,9 +782,14 @@ size_t decodeSlof(
 	ri = 0;
 	fixedPoint = decodeFixedPoint(data);
 
+	// first extract and scale the integers, then apply exp in a separate
+	// pass (both loops are free of dependencies between elements)
 	for (i=8; i<dataSize; i+=2) {
 		x = static_cast<unsigned short>(data[i] | (data[i+1] << 8));
-		result[ri++] = exp(x / fixedPoint) - 1;
+		result[ri++] = x / fixedPoint;
+	}
+	for (i=0; i<ri; i++) {
+		result[i] = exp(result[i]) - 1;
 	}
 	return ri;
 }
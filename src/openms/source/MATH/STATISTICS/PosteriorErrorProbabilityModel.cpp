@@ -47,6 +47,7 @@
 #include <QDir>
 
 #include <boost/math/special_functions/fpclassify.hpp>
+#include <boost/numeric/conversion/cast.hpp>
 
 #include <algorithm>
 
@@ -68,6 +69,8 @@ namespace OpenMS
       defaults_.setValue("number_of_bins", 100, "Number of bins used for visualization. Only needed if each iteration step of the EM-Algorithm will be visualized", ListUtils::create<String>("advanced"));
       defaults_.setValue("incorrectly_assigned", "Gumbel", "for 'Gumbel', the Gumbel distribution is used to plot incorrectly assigned sequences. For 'Gauss', the Gauss distribution is used.", ListUtils::create<String>("advanced"));
       defaults_.setValue("max_nr_iterations", 1000, "Bounds the number of iterations for the EM algorithm when convergence is slow.", ListUtils::create<String>("advanced"));
+      defaults_.setValue("fit_bins", 0, "If larger than zero, the EM algorithm is run on a histogram of the scores with this number of bins instead of on every single score (each bin is represented by the mean of its scores). This speeds up fitting of very large numbers of scores considerably.", ListUtils::create<String>("advanced"));
+      defaults_.setMinInt("fit_bins", 0);
       defaults_.setValidStrings("incorrectly_assigned", ListUtils::create<String>("Gumbel,Gauss"));
       defaultsToParam_();
       getNegativeGnuplotFormula_ = &PosteriorErrorProbabilityModel::getGumbelGnuplotFormula;
@@ -116,10 +119,22 @@ namespace OpenMS
       correctly_assigned_fit_param_.sigma = incorrectly_assigned_fit_param_.sigma;
       correctly_assigned_fit_param_.A = 1.0   / sqrt(2 * Constants::PI * pow(correctly_assigned_fit_param_.sigma, 2));
 
+      // The EM algorithm is run either on all scores or on a histogram of the
+      // scores, where each bin counts as often as it has scores (em_weights is
+      // empty if all scores are used, i.e. all weights are one)
+      vector<double> bin_scores, em_weights;
+      Size fit_bins = (Int)param_.getValue("fit_bins");
+      if (fit_bins > 0 && fit_bins < x_scores.size())
+      {
+        binScores_(x_scores, fit_bins, bin_scores, em_weights);
+      }
+      vector<double>& em_scores = em_weights.empty() ? x_scores : bin_scores;
+      const SignedSize em_size = boost::numeric_cast<SignedSize>(em_scores.size());
+
       vector<double> incorrect_density, correct_density;
-      fillDensities(x_scores, incorrect_density, correct_density);
+      fillDensities(em_scores, incorrect_density, correct_density);
 
-      double maxlike = computeMaxLikelihood(incorrect_density, correct_density);
+      double maxlike = computeLogLikelihood_(incorrect_density, correct_density, em_weights);
  
       //-------------------------------------------------------------
       // create files for output
@@ -156,19 +171,38 @@ namespace OpenMS
       {
         //-------------------------------------------------------------
         // E-STEP
-        double one_minus_sum_posterior = one_minus_sum_post(incorrect_density, correct_density);
-        double sum_posterior = sum_post(incorrect_density, correct_density);
-
-        // new mean
-        double sum_positive_x0 = sum_pos_x0(x_scores, incorrect_density, correct_density);
-        double sum_negative_x0 = sum_neg_x0(x_scores, incorrect_density, correct_density);
+        // posterior probabilities and the sums for the new means in one pass
+        double one_minus_sum_posterior(0), sum_posterior(0), sum_positive_x0(0), sum_negative_x0(0);
+#ifdef _OPENMP
+#pragma omp parallel for reduction(+: one_minus_sum_posterior, sum_posterior, sum_positive_x0, sum_negative_x0)
+#endif
+        for (SignedSize i = 0; i < em_size; ++i)
+        {
+          double weight = em_weights.empty() ? 1.0 : em_weights[i];
+          double negative = negative_prior_ * incorrect_density[i];
+          double posterior = negative / (negative + (1 - negative_prior_) * correct_density[i]);
+          sum_posterior += weight * posterior;
+          one_minus_sum_posterior += weight * (1 - posterior);
+          sum_negative_x0 += weight * posterior * em_scores[i];
+          sum_positive_x0 += weight * (1 - posterior) * em_scores[i];
+        }
 
         double positive_mean = sum_positive_x0 / one_minus_sum_posterior;
         double negative_mean = sum_negative_x0 / sum_posterior;
 
         //i new standard deviation
-        double sum_positive_sigma = sum_pos_sigma(x_scores, incorrect_density, correct_density, positive_mean);
-        double sum_negative_sigma = sum_neg_sigma(x_scores, incorrect_density, correct_density, negative_mean);
+        double sum_positive_sigma(0), sum_negative_sigma(0);
+#ifdef _OPENMP
+#pragma omp parallel for reduction(+: sum_positive_sigma, sum_negative_sigma)
+#endif
+        for (SignedSize i = 0; i < em_size; ++i)
+        {
+          double weight = em_weights.empty() ? 1.0 : em_weights[i];
+          double negative = negative_prior_ * incorrect_density[i];
+          double posterior = negative / (negative + (1 - negative_prior_) * correct_density[i]);
+          sum_positive_sigma += weight * (1 - posterior) * pow(em_scores[i] - positive_mean, 2);
+          sum_negative_sigma += weight * posterior * pow(em_scores[i] - negative_mean, 2);
+        }
 
         // update parameters
         correctly_assigned_fit_param_.x0 = positive_mean;
@@ -186,11 +220,11 @@ namespace OpenMS
         }
 
         // compute new prior probabilities negative peptides
-        fillDensities(x_scores, incorrect_density, correct_density);
-        sum_posterior = sum_post(incorrect_density, correct_density);
+        fillDensities(em_scores, incorrect_density, correct_density);
+        sum_posterior = sumPosterior_(incorrect_density, correct_density, em_weights);
         negative_prior_ = sum_posterior / x_scores.size();
 
-        double new_maxlike(computeMaxLikelihood(incorrect_density, correct_density));
+        double new_maxlike(computeLogLikelihood_(incorrect_density, correct_density, em_weights));
         if (boost::math::isnan(new_maxlike - maxlike) 
           || new_maxlike < maxlike)
         {
@@ -206,7 +240,7 @@ namespace OpenMS
             LOG_WARN << "Algorithm returns probabilites for suboptimal fit. You might want to try raising the max. number of iterations and have a look at the distribution." << endl;
           }
           stop_em_init = true;
-          sum_posterior = sum_post(incorrect_density, correct_density);
+          sum_posterior = sumPosterior_(incorrect_density, correct_density, em_weights);
           negative_prior_ = sum_posterior / x_scores.size();
 
         }
@@ -270,16 +304,81 @@ namespace OpenMS
         incorrect_density.resize(x_scores.size());
         correct_density.resize(x_scores.size());
       }
-      vector<double>::iterator incorrect(incorrect_density.begin());
-      vector<double>::iterator correct(correct_density.begin());
-      for (double const & score : x_scores)
+      // TODO: incorrect is currently filled with gauss as fitting gumble is not supported
+      // Gaussians in closed form, this is the same as GaussFitResult::eval()
+      // without setting up a distribution for every score
+      const GaussFitter::GaussFitResult& incorrect = incorrectly_assigned_fit_param_;
+      const GaussFitter::GaussFitResult& correct = correctly_assigned_fit_param_;
+      const double incorrect_factor = -0.5 / (incorrect.sigma * incorrect.sigma);
+      const double correct_factor = -0.5 / (correct.sigma * correct.sigma);
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
+      for (SignedSize i = 0; i < boost::numeric_cast<SignedSize>(x_scores.size()); ++i)
+      {
+        const double score = x_scores[i];
+        incorrect_density[i] = incorrect.A * exp((score - incorrect.x0) * (score - incorrect.x0) * incorrect_factor);
+        correct_density[i] = correct.A * exp((score - correct.x0) * (score - correct.x0) * correct_factor);
+      }
+    }
+
+    void PosteriorErrorProbabilityModel::binScores_(const vector<double>& sorted_scores, Size number_of_bins, vector<double>& bin_scores, vector<double>& bin_weights)
+    {
+      bin_scores.clear();
+      bin_weights.clear();
+      if (sorted_scores.empty() || number_of_bins == 0) return;
+
+      const double min_score = sorted_scores.front();
+      const double bin_width = (sorted_scores.back() - min_score) / number_of_bins;
+
+      Size current_bin = 0;
+      double sum = 0;
+      Size count = 0;
+      for (double score : sorted_scores)
+      {
+        Size bin = bin_width > 0 ? std::min(number_of_bins - 1, (Size)((score - min_score) / bin_width)) : 0;
+        if (bin != current_bin && count > 0)
+        {
+          bin_scores.push_back(sum / count);
+          bin_weights.push_back(count);
+          sum = 0;
+          count = 0;
+        }
+        current_bin = bin;
+        sum += score;
+        ++count;
+      }
+      bin_scores.push_back(sum / count);
+      bin_weights.push_back(count);
+    }
+
+    double PosteriorErrorProbabilityModel::computeLogLikelihood_(const vector<double>& incorrect_density, const vector<double>& correct_density, const vector<double>& weights) const
+    {
+      double maxlike(0);
+#ifdef _OPENMP
+#pragma omp parallel for reduction(+: maxlike)
+#endif
+      for (SignedSize i = 0; i < boost::numeric_cast<SignedSize>(incorrect_density.size()); ++i)
       {
-        // TODO: incorrect is currently filled with gauss as fitting gumble is not supported
-        *incorrect = incorrectly_assigned_fit_param_.eval(score);
-        *correct = correctly_assigned_fit_param_.eval(score);
-        ++incorrect;
-        ++correct;
+        double weight = weights.empty() ? 1.0 : weights[i];
+        maxlike += weight * log10(negative_prior_ * incorrect_density[i] + (1 - negative_prior_) * correct_density[i]);
       }
+      return maxlike;
+    }
+
+    double PosteriorErrorProbabilityModel::sumPosterior_(const vector<double>& incorrect_density, const vector<double>& correct_density, const vector<double>& weights) const
+    {
+      double post(0);
+#ifdef _OPENMP
+#pragma omp parallel for reduction(+: post)
+#endif
+      for (SignedSize i = 0; i < boost::numeric_cast<SignedSize>(incorrect_density.size()); ++i)
+      {
+        double weight = weights.empty() ? 1.0 : weights[i];
+        double negative = negative_prior_ * incorrect_density[i];
+        post += weight * negative / (negative + (1 - negative_prior_) * correct_density[i]);
+      }
+      return post;
     }
 
     double PosteriorErrorProbabilityModel::computeMaxLikelihood(vector<double>& incorrect_density, vector<double>& correct_density)
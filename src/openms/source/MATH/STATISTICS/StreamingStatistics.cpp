@@ -0,0 +1,351 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2018.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: Timo Sachsenberg $
+// $Authors: Timo Sachsenberg $
+// --------------------------------------------------------------------------
+
+#include <OpenMS/MATH/STATISTICS/StreamingStatistics.h>
+
+#include <OpenMS/CONCEPT/Constants.h>
+#include <OpenMS/CONCEPT/Exception.h>
+#include <OpenMS/DATASTRUCTURES/String.h>
+
+#include <algorithm>
+#include <cmath>
+
+namespace OpenMS
+{
+  namespace Math
+  {
+    RunningStatistics::RunningStatistics() :
+      count_(0),
+      mean_(0.0),
+      m2_(0.0),
+      min_(0.0),
+      max_(0.0)
+    {
+    }
+
+    void RunningStatistics::add(double value)
+    {
+      if (count_ == 0)
+      {
+        min_ = max_ = value;
+      }
+      else
+      {
+        min_ = std::min(min_, value);
+        max_ = std::max(max_, value);
+      }
+      ++count_;
+      double delta = value - mean_;
+      mean_ += delta / count_;
+      m2_ += delta * (value - mean_);
+    }
+
+    void RunningStatistics::merge(const RunningStatistics& other)
+    {
+      if (other.count_ == 0) return;
+      if (count_ == 0)
+      {
+        *this = other;
+        return;
+      }
+      // pairwise update (Chan et al.)
+      double n_a = double(count_), n_b = double(other.count_), n = n_a + n_b;
+      double delta = other.mean_ - mean_;
+      mean_ += delta * n_b / n;
+      m2_ += other.m2_ + delta * delta * n_a * n_b / n;
+      count_ += other.count_;
+      min_ = std::min(min_, other.min_);
+      max_ = std::max(max_, other.max_);
+    }
+
+    void RunningStatistics::clear()
+    {
+      *this = RunningStatistics();
+    }
+
+    Size RunningStatistics::count() const
+    {
+      return count_;
+    }
+
+    double RunningStatistics::sum() const
+    {
+      return mean_ * count_;
+    }
+
+    double RunningStatistics::mean() const
+    {
+      return mean_;
+    }
+
+    double RunningStatistics::variance() const
+    {
+      return count_ < 2 ? 0.0 : m2_ / (count_ - 1);
+    }
+
+    double RunningStatistics::sd() const
+    {
+      return std::sqrt(variance());
+    }
+
+    double RunningStatistics::min() const
+    {
+      return min_;
+    }
+
+    double RunningStatistics::max() const
+    {
+      return max_;
+    }
+
+    namespace
+    {
+      // arcsine scale function k_1 of the t-digest and its inverse
+      double scale(double q, double compression)
+      {
+        return compression / (2.0 * Constants::PI) * std::asin(2.0 * q - 1.0);
+      }
+
+      double inverseScale(double k, double compression)
+      {
+        double angle = std::min(k * 2.0 * Constants::PI / compression, Constants::PI / 2.0);
+        return (std::sin(angle) + 1.0) / 2.0;
+      }
+    }
+
+    QuantileSketch::QuantileSketch(double compression) :
+      compression_(compression),
+      centroids_(),
+      buffer_(),
+      total_weight_(0.0),
+      min_(0.0),
+      max_(0.0)
+    {
+      if (!(compression >= 10.0))
+      {
+        throw Exception::InvalidValue(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "The compression of a quantile sketch must be at least 10.", String(compression));
+      }
+    }
+
+    void QuantileSketch::add(double value, double weight)
+    {
+      if (!(weight > 0.0)) return;
+      if (empty())
+      {
+        min_ = max_ = value;
+      }
+      else
+      {
+        min_ = std::min(min_, value);
+        max_ = std::max(max_, value);
+      }
+      Centroid c = {value, weight};
+      buffer_.push_back(c);
+      total_weight_ += weight;
+      // keep the memory bounded
+      if (buffer_.size() >= Size(5 * compression_))
+      {
+        compress();
+      }
+    }
+
+    void QuantileSketch::merge(const QuantileSketch& other)
+    {
+      if (other.empty()) return;
+      if (&other == this)
+      {
+        QuantileSketch copy(other);
+        merge(copy);
+        return;
+      }
+      if (empty())
+      {
+        min_ = other.min_;
+        max_ = other.max_;
+      }
+      else
+      {
+        min_ = std::min(min_, other.min_);
+        max_ = std::max(max_, other.max_);
+      }
+      buffer_.insert(buffer_.end(), other.centroids_.begin(), other.centroids_.end());
+      buffer_.insert(buffer_.end(), other.buffer_.begin(), other.buffer_.end());
+      total_weight_ += other.total_weight_;
+      compress();
+    }
+
+    void QuantileSketch::clear()
+    {
+      centroids_.clear();
+      buffer_.clear();
+      total_weight_ = 0.0;
+      min_ = max_ = 0.0;
+    }
+
+    void QuantileSketch::compress()
+    {
+      if (buffer_.empty()) return;
+      buffer_.insert(buffer_.end(), centroids_.begin(), centroids_.end());
+      compress_(buffer_, compression_, centroids_);
+      buffer_.clear();
+    }
+
+    double QuantileSketch::quantile(double q) const
+    {
+      if (empty())
+      {
+        throw Exception::InvalidRange(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION);
+      }
+      if (!(q >= 0.0 && q <= 1.0))
+      {
+        throw Exception::InvalidValue(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "The quantile must be in [0, 1].", String(q));
+      }
+      if (buffer_.empty())
+      {
+        return quantile_(centroids_, q);
+      }
+      // do not modify the sketch in a const method - compress a copy
+      std::vector<Centroid> all(buffer_);
+      all.insert(all.end(), centroids_.begin(), centroids_.end());
+      std::vector<Centroid> compressed;
+      compress_(all, compression_, compressed);
+      return quantile_(compressed, q);
+    }
+
+    double QuantileSketch::median() const
+    {
+      return quantile(0.5);
+    }
+
+    double QuantileSketch::count() const
+    {
+      return total_weight_;
+    }
+
+    bool QuantileSketch::empty() const
+    {
+      return total_weight_ == 0.0;
+    }
+
+    double QuantileSketch::min() const
+    {
+      return min_;
+    }
+
+    double QuantileSketch::max() const
+    {
+      return max_;
+    }
+
+    double QuantileSketch::getCompression() const
+    {
+      return compression_;
+    }
+
+    Size QuantileSketch::centroidCount() const
+    {
+      if (buffer_.empty()) return centroids_.size();
+      QuantileSketch copy(*this);
+      copy.compress();
+      return copy.centroids_.size();
+    }
+
+    void QuantileSketch::compress_(std::vector<Centroid>& buffer, double compression, std::vector<Centroid>& result)
+    {
+      result.clear();
+      if (buffer.empty()) return;
+
+      // stable sort: equal means are merged in insertion order (deterministic)
+      std::stable_sort(buffer.begin(), buffer.end(),
+                       [](const Centroid& a, const Centroid& b) { return a.mean < b.mean; });
+      double total = 0.0;
+      for (std::vector<Centroid>::const_iterator it = buffer.begin(); it != buffer.end(); ++it)
+      {
+        total += it->weight;
+      }
+
+      Centroid current = buffer[0];
+      double weight_so_far = 0.0;
+      double weight_limit = total * inverseScale(scale(0.0, compression) + 1.0, compression);
+      for (Size i = 1; i < buffer.size(); ++i)
+      {
+        const Centroid& next = buffer[i];
+        if (weight_so_far + current.weight + next.weight <= weight_limit)
+        {
+          // merge into the current cluster
+          current.weight += next.weight;
+          current.mean += (next.mean - current.mean) * next.weight / current.weight;
+        }
+        else
+        {
+          weight_so_far += current.weight;
+          weight_limit = total * inverseScale(scale(weight_so_far / total, compression) + 1.0, compression);
+          result.push_back(current);
+          current = next;
+        }
+      }
+      result.push_back(current);
+    }
+
+    double QuantileSketch::quantile_(const std::vector<Centroid>& centroids, double q) const
+    {
+      if (q == 0.0) return min_;
+      if (q == 1.0) return max_;
+
+      // each centroid is centered at the middle of its weight, interpolate
+      // linearly between the centers (and towards min/max in the tails)
+      double target = q * total_weight_;
+      const Centroid& first = centroids.front();
+      if (target < first.weight / 2.0)
+      {
+        return min_ + (first.mean - min_) * target / (first.weight / 2.0);
+      }
+      double cumulative = first.weight / 2.0;
+      for (Size i = 0; i + 1 < centroids.size(); ++i)
+      {
+        double gap = (centroids[i].weight + centroids[i + 1].weight) / 2.0;
+        if (target <= cumulative + gap)
+        {
+          double fraction = (target - cumulative) / gap;
+          return centroids[i].mean + fraction * (centroids[i + 1].mean - centroids[i].mean);
+        }
+        cumulative += gap;
+      }
+      const Centroid& last = centroids.back();
+      double fraction = std::min((target - cumulative) / (last.weight / 2.0), 1.0);
+      return last.mean + fraction * (max_ - last.mean);
+    }
+
+  } // namespace Math
+} // namespace OpenMS
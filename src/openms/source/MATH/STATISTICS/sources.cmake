@@ -16,6 +16,7 @@ LinearRegressionWithoutIntercept.cpp
 PosteriorErrorProbabilityModel.cpp
 QuadraticRegression.cpp
 ROCCurve.cpp
+StreamingStatistics.cpp
 )
 
 ### add path to the filenames
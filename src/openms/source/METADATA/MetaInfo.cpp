@@ -34,6 +34,8 @@
 
 #include <OpenMS/METADATA/MetaInfo.h>
 
+#include <algorithm>
+
 using namespace std;
 
 namespace OpenMS
@@ -41,13 +43,44 @@ namespace OpenMS
 
   MetaInfoRegistry MetaInfo::registry_ = MetaInfoRegistry();
 
+  const Size MetaInfo::INLINE_CAPACITY;
+
+  MetaInfo::MetaInfo(MetaInfo && rhs) noexcept :
+    inline_size_(rhs.inline_size_),
+    heap_values_(std::move(rhs.heap_values_))
+  {
+    for (Size i = 0; i < inline_size_; ++i)
+    {
+      inline_values_[i] = std::move(rhs.inline_values_[i]);
+    }
+    rhs.inline_size_ = 0;
+    rhs.heap_values_.clear();
+  }
+
   MetaInfo::~MetaInfo()
   {
   }
 
+  MetaInfo & MetaInfo::operator=(MetaInfo && rhs) & noexcept
+  {
+    if (&rhs == this) return *this;
+
+    clear();
+    inline_size_ = rhs.inline_size_;
+    for (Size i = 0; i < inline_size_; ++i)
+    {
+      inline_values_[i] = std::move(rhs.inline_values_[i]);
+    }
+    heap_values_.swap(rhs.heap_values_);
+    rhs.inline_size_ = 0;
+    rhs.heap_values_.clear();
+    return *this;
+  }
+
   bool MetaInfo::operator==(const MetaInfo & rhs) const
   {
-    return index_to_value_ == rhs.index_to_value_;
+    return (end_() - begin_()) == (rhs.end_() - rhs.begin_()) &&
+           std::equal(begin_(), end_(), rhs.begin_());
   }
 
   bool MetaInfo::operator!=(const MetaInfo & rhs) const
@@ -55,20 +88,105 @@ namespace OpenMS
     return !(operator==(rhs));
   }
 
-  const DataValue & MetaInfo::getValue(const String & name) const
+  MetaInfo::EntryType * MetaInfo::begin_()
+  {
+    return heap_values_.empty() ? inline_values_ : heap_values_.data();
+  }
+
+  const MetaInfo::EntryType * MetaInfo::begin_() const
   {
-    MapType::const_iterator it = index_to_value_.find(registry_.getIndex(name));
-    if (it != index_to_value_.end())
+    return heap_values_.empty() ? inline_values_ : heap_values_.data();
+  }
+
+  MetaInfo::EntryType * MetaInfo::end_()
+  {
+    return heap_values_.empty() ? inline_values_ + inline_size_ : heap_values_.data() + heap_values_.size();
+  }
+
+  const MetaInfo::EntryType * MetaInfo::end_() const
+  {
+    return heap_values_.empty() ? inline_values_ + inline_size_ : heap_values_.data() + heap_values_.size();
+  }
+
+  namespace
+  {
+    struct EntryIndexLess
     {
-      return it->second;
+      bool operator()(const std::pair<UInt, DataValue> & entry, UInt index) const
+      {
+        return entry.first < index;
+      }
+    };
+  }
+
+  MetaInfo::EntryType * MetaInfo::find_(UInt index)
+  {
+    EntryType * end = end_();
+    EntryType * it = std::lower_bound(begin_(), end, index, EntryIndexLess());
+    return (it != end && it->first == index) ? it : end;
+  }
+
+  const MetaInfo::EntryType * MetaInfo::find_(UInt index) const
+  {
+    const EntryType * end = end_();
+    const EntryType * it = std::lower_bound(begin_(), end, index, EntryIndexLess());
+    return (it != end && it->first == index) ? it : end;
+  }
+
+  MetaInfo::EntryType * MetaInfo::insert_(EntryType * pos, UInt index)
+  {
+    if (heap_values_.empty())
+    {
+      if (inline_size_ < INLINE_CAPACITY)
+      {
+        // shift the following entries by one to make room
+        EntryType * last = inline_values_ + inline_size_;
+        std::move_backward(pos, last, last + 1);
+        pos->first = index;
+        pos->second = DataValue();
+        ++inline_size_;
+        return pos;
+      }
+
+      // inline storage exhausted: move everything to the heap
+      Size offset = pos - inline_values_;
+      heap_values_.reserve(2 * INLINE_CAPACITY);
+      for (Size i = 0; i < inline_size_; ++i)
+      {
+        heap_values_.push_back(std::move(inline_values_[i]));
+      }
+      inline_size_ = 0;
+      return &*heap_values_.insert(heap_values_.begin() + offset, EntryType(index, DataValue()));
     }
-    return DataValue::EMPTY;
+
+    Size offset = pos - heap_values_.data();
+    return &*heap_values_.insert(heap_values_.begin() + offset, EntryType(index, DataValue()));
+  }
+
+  void MetaInfo::erase_(EntryType * pos)
+  {
+    if (heap_values_.empty())
+    {
+      EntryType * last = inline_values_ + inline_size_;
+      std::move(pos + 1, last, pos);
+      --inline_size_;
+      inline_values_[inline_size_].second = DataValue(); // release memory of the moved-out slot
+    }
+    else
+    {
+      heap_values_.erase(heap_values_.begin() + (pos - heap_values_.data()));
+    }
+  }
+
+  const DataValue & MetaInfo::getValue(const String & name) const
+  {
+    return getValue(registry_.getIndex(name));
   }
 
   const DataValue & MetaInfo::getValue(UInt index) const
   {
-    MapType::const_iterator it = index_to_value_.find(index);
-    if (it != index_to_value_.end())
+    const EntryType * it = find_(index);
+    if (it != end_())
     {
       return it->second;
     }
@@ -82,20 +200,39 @@ namespace OpenMS
   }
 
   void MetaInfo::setValue(UInt index, const DataValue & value)
+  {
+    EntryType * it = find_(index);
+    if (it != end_())
+    {
+      it->second = value;
+      return;
+    }
+    // Note: we need to create a copy of the data value here and can't use the
+    // const & as inserting may shift entries (and thus invalidate references,
+    // e.g. in constructs like: m.setValue(1, m.getValue(2)))
+    DataValue tmp = value;
+    setValue(index, std::move(tmp));
+  }
+
+  void MetaInfo::setValue(const String & name, DataValue && value)
+  {
+    UInt index = registry_.registerName(name); // no-op if name is already registered
+    setValue(index, std::move(value));
+  }
+
+  void MetaInfo::setValue(UInt index, DataValue && value)
   {
     // @TODO: check if that index is registered in MetaInfoRegistry?
-    auto it = index_to_value_.find(index);
-    if ( it != index_to_value_.end()) 
+    EntryType * end = end_();
+    EntryType * it = std::lower_bound(begin_(), end, index, EntryIndexLess());
+    if (it != end && it->first == index)
     {
-      it->second = value; 
+      it->second = std::move(value);
     }
     else
     {
-      // Note; we need to create a copy of data value here and can't use the const &
-      // The underlying flat_map invalidates references to it if inserting
-      // an element leads to relocation (e.g, in constructs like: m.insert(1, m[2]));)
-      DataValue tmp = value;
-      index_to_value_.insert(std::make_pair(index, tmp));
+      DataValue tmp(std::move(value)); // see above, @p value may be located in our storage
+      insert_(it, index)->second = std::move(tmp);
     }
   }
 
@@ -109,39 +246,35 @@ namespace OpenMS
     UInt index = registry_.getIndex(name);
     if (index != UInt(-1))
     {
-      return (index_to_value_.find(index) != index_to_value_.end());
+      return exists(index);
     }
     return false;
   }
 
   bool MetaInfo::exists(UInt index) const
   {
-    return (index_to_value_.find(index) != index_to_value_.end());
+    return find_(index) != end_();
   }
 
   void MetaInfo::removeValue(const String & name)
   {
-    MapType::iterator it = index_to_value_.find(registry_.getIndex(name));
-    if (it != index_to_value_.end())
-    {
-      index_to_value_.erase(it);
-    }
+    removeValue(registry_.getIndex(name));
   }
 
   void MetaInfo::removeValue(UInt index)
   {
-    MapType::iterator it = index_to_value_.find(index);
-    if (it != index_to_value_.end())
+    EntryType * it = find_(index);
+    if (it != end_())
     {
-      index_to_value_.erase(it);
+      erase_(it);
     }
   }
 
   void MetaInfo::getKeys(vector<String> & keys) const
   {
-    keys.resize(index_to_value_.size());
+    keys.resize(end_() - begin_());
     UInt i = 0;
-    for (MapType::const_iterator it = index_to_value_.begin(); it != index_to_value_.end(); ++it)
+    for (const EntryType * it = begin_(); it != end_(); ++it)
     {
       keys[i++] = registry_.getName(it->first);
     }
@@ -149,9 +282,9 @@ namespace OpenMS
 
   void MetaInfo::getKeys(vector<UInt> & keys) const
   {
-    keys.resize(index_to_value_.size());
+    keys.resize(end_() - begin_());
     UInt i = 0;
-    for (MapType::const_iterator it = index_to_value_.begin(); it != index_to_value_.end(); ++it)
+    for (const EntryType * it = begin_(); it != end_(); ++it)
     {
       keys[i++] = it->first;
     }
@@ -159,13 +292,17 @@ namespace OpenMS
 
   bool MetaInfo::empty() const
   {
-    return index_to_value_.empty();
+    return inline_size_ == 0 && heap_values_.empty();
   }
 
   void MetaInfo::clear()
   {
-    index_to_value_.clear();
+    for (Size i = 0; i < inline_size_; ++i)
+    {
+      inline_values_[i].second = DataValue();
+    }
+    inline_size_ = 0;
+    std::vector<EntryType>().swap(heap_values_);
   }
 
 } //namespace
-
@@ -182,6 +182,18 @@ namespace OpenMS
     meta_->setValue(index, value);
   }
 
+  void MetaInfoInterface::setMetaValue(const String & name, DataValue && value)
+  {
+    createIfNotExists_();
+    meta_->setValue(name, std::move(value));
+  }
+
+  void MetaInfoInterface::setMetaValue(UInt index, DataValue && value)
+  {
+    createIfNotExists_();
+    meta_->setValue(index, std::move(value));
+  }
+
   MetaInfoRegistry & MetaInfoInterface::metaRegistry()
   {
     return MetaInfo::registry();
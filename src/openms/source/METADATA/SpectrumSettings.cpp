@@ -36,12 +36,70 @@
 
 #include <OpenMS/CONCEPT/Helpers.h>
 #include <boost/iterator/indirect_iterator.hpp> // for equality
+#include <boost/make_shared.hpp>
 
 using namespace std;
 
 namespace OpenMS
 {
 
+  namespace
+  {
+    /// The default-constructed instance that an empty pointer stands for
+    template <typename T>
+    const T & defaultInstance_()
+    {
+      static const T instance;
+      return instance;
+    }
+
+    /// Read access to a copy-on-write member
+    template <typename T>
+    const T & readShared_(const boost::shared_ptr<T> & ptr)
+    {
+      return ptr ? *ptr : defaultInstance_<T>();
+    }
+
+    /// Write access to a copy-on-write member: makes sure the instance is not shared with anybody else
+    template <typename T>
+    T & writeShared_(boost::shared_ptr<T> & ptr)
+    {
+      if (!ptr)
+      {
+        ptr = boost::make_shared<T>();
+      }
+      else if (!ptr.unique())
+      {
+        ptr = boost::make_shared<T>(*ptr);
+      }
+      return *ptr;
+    }
+
+    /// Assignment to a copy-on-write member
+    template <typename T>
+    void assignShared_(boost::shared_ptr<T> & ptr, const T & value)
+    {
+      if (ptr && ptr.unique())
+      {
+        *ptr = value;
+      }
+      else
+      {
+        ptr = boost::make_shared<T>(value);
+      }
+    }
+
+    /// Let @p ptr share the instance of @p other if both are equal
+    template <typename T>
+    bool share_(boost::shared_ptr<T> & ptr, const boost::shared_ptr<T> & other)
+    {
+      if (ptr == other) return true; // already shared (or both default)
+      if (!(readShared_(ptr) == readShared_(other))) return false;
+      ptr = other;
+      return true;
+    }
+  }
+
   const std::string SpectrumSettings::NamesOfSpectrumType[] = {"Unknown", "Centroid", "Profile"};
 
   SpectrumSettings::SpectrumSettings() :
@@ -69,9 +127,9 @@ namespace OpenMS
            type_ == rhs.type_ &&
            native_id_ == rhs.native_id_ &&
            comment_ == rhs.comment_ &&
-           instrument_settings_ == rhs.instrument_settings_ &&
-           acquisition_info_ == rhs.acquisition_info_ &&
-           source_file_ == rhs.source_file_ &&
+           getInstrumentSettings() == rhs.getInstrumentSettings() &&
+           getAcquisitionInfo() == rhs.getAcquisitionInfo() &&
+           getSourceFile() == rhs.getSourceFile() &&
            precursors_ == rhs.precursors_ &&
            products_ == rhs.products_ &&
            identification_ == rhs.identification_ &&
@@ -131,47 +189,56 @@ namespace OpenMS
 
   const InstrumentSettings & SpectrumSettings::getInstrumentSettings() const
   {
-    return instrument_settings_;
+    return readShared_(instrument_settings_);
   }
 
   InstrumentSettings & SpectrumSettings::getInstrumentSettings()
   {
-    return instrument_settings_;
+    return writeShared_(instrument_settings_);
   }
 
   void SpectrumSettings::setInstrumentSettings(const InstrumentSettings & instrument_settings)
   {
-    instrument_settings_ = instrument_settings;
+    assignShared_(instrument_settings_, instrument_settings);
   }
 
   const AcquisitionInfo & SpectrumSettings::getAcquisitionInfo() const
   {
-    return acquisition_info_;
+    return readShared_(acquisition_info_);
   }
 
   AcquisitionInfo & SpectrumSettings::getAcquisitionInfo()
   {
-    return acquisition_info_;
+    return writeShared_(acquisition_info_);
   }
 
   void SpectrumSettings::setAcquisitionInfo(const AcquisitionInfo & acquisition_info)
   {
-    acquisition_info_ = acquisition_info;
+    assignShared_(acquisition_info_, acquisition_info);
   }
 
   const SourceFile & SpectrumSettings::getSourceFile() const
   {
-    return source_file_;
+    return readShared_(source_file_);
   }
 
   SourceFile & SpectrumSettings::getSourceFile()
   {
-    return source_file_;
+    return writeShared_(source_file_);
   }
 
   void SpectrumSettings::setSourceFile(const SourceFile & source_file)
   {
-    source_file_ = source_file;
+    assignShared_(source_file_, source_file);
+  }
+
+  Size SpectrumSettings::shareMetaData(const SpectrumSettings & other)
+  {
+    Size shared = 0;
+    if (share_(instrument_settings_, other.instrument_settings_)) ++shared;
+    if (share_(acquisition_info_, other.acquisition_info_)) ++shared;
+    if (share_(source_file_, other.source_file_)) ++shared;
+    return shared;
   }
 
   const vector<Precursor> & SpectrumSettings::getPrecursors() const
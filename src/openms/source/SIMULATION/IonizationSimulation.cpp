@@ -287,6 +287,61 @@ public:
       this->startProgress(0, features.size(), "Ionization");
       Size progress(0);
 
+      // precompute random numbers: they are drawn serially in feature order (i.e.
+      // in the same order as a single-threaded run), so the result does not
+      // depend on the number of threads; only the charge states are assembled in parallel
+      const Size rnduni_block_size = 50; // uniform numbers are drawn in blocks
+      std::vector<UInt> basic_residues(features.size());
+      std::vector<Int> power_factors(features.size(), 0);
+      std::vector<std::vector<UInt> > rnd_charges(features.size());
+      std::vector<std::vector<Size> > rnd_adducts(features.size());
+      for (Size index = 0; index < features.size(); ++index)
+      {
+        Int abundance = (Int) ceil(features[index].getIntensity());
+        basic_residues[index] = countIonizedResidues_(features[index].getPeptideIdentifications()[0].getHits()[0].getSequence());
+
+        /// shortcut: if abundance is >1000, we 1) downsize by power of 2 until 1000 < abundance_ < 2000
+        ///                                     2) dice distribution
+        ///                                     3) blow abundance up to original level  (to save A LOT of computation time)
+        while (abundance > 1000)
+        {
+          ++power_factors[index];
+          abundance /= 2;
+        }
+
+        if (basic_residues[index] == 0)
+        {
+          continue;
+        }
+
+        std::vector<UInt>& prec_rndbin = rnd_charges[index];
+        prec_rndbin.resize(abundance);
+        Size charge_sites(0);
+        boost::random::binomial_distribution<Int, double> bdist(basic_residues[index], esi_probability_);
+        for (Int j = 0; j < abundance; ++j)
+        {
+          Int rnd_no = bdist(rnd_gen_->getTechnicalRng());
+          prec_rndbin[j] = (UInt) rnd_no; //cast is save because random dist should give result in the intervall [0, basic_residues_c]
+          charge_sites += prec_rndbin[j];
+        }
+
+        // one adduct per charge site (only needed for more elaborate adducts)
+        if (esi_adducts_.size() > 1)
+        {
+          std::vector<Size>& prec_rnduni = rnd_adducts[index];
+          prec_rnduni.resize((charge_sites + rnduni_block_size - 1) / rnduni_block_size * rnduni_block_size);
+          for (Size i_rnd = 0; i_rnd < prec_rnduni.size(); ++i_rnd)
+          {
+            prec_rnduni[i_rnd] = ddist(rnd_gen_->getTechnicalRng());
+          }
+        }
+      }
+
+      // results of each feature (collected in feature order after the parallel loop)
+      std::vector<std::vector<Feature> > charged_features(features.size());
+      std::vector<ConsensusFeature> charge_consensus_features(features.size());
+      std::vector<char> has_consensus(features.size(), 0);
+
       // iterate over all features
 #pragma omp parallel for reduction(+: uncharged_feature_count, undetected_features_count)
       for (SignedSize index = 0; index < (SignedSize)features.size(); ++index)
@@ -303,41 +358,19 @@ public:
         this->setProgress(progress);
 #endif
 
-        ConsensusFeature cf;
-
-        // iterate on abundance
-        Int abundance = (Int) ceil(features[index].getIntensity());
-        UInt basic_residues_c = countIonizedResidues_(features[index].getPeptideIdentifications()[0].getHits()[0].getSequence());
-
-
-        /// shortcut: if abundance is >1000, we 1) downsize by power of 2 until 1000 < abundance_ < 2000
-        ///                                     2) dice distribution
-        ///                                     3) blow abundance up to original level  (to save A LOT of computation time)
-        Int power_factor_2(0);
-        while (abundance > 1000)
-        {
-          ++power_factor_2;
-          abundance /= 2;
-        }
+        ConsensusFeature& cf = charge_consensus_features[index];
 
-        if (basic_residues_c == 0)
+        if (basic_residues[index] == 0)
         {
           ++uncharged_feature_count; // OMP
           continue;
         }
 
-        // precompute random numbers:
-        std::vector<UInt> prec_rndbin(abundance);
-        {
-          boost::random::binomial_distribution<Int, double> bdist(basic_residues_c, esi_probability_);
-          for (Int j = 0; j < abundance; ++j)
-          {
-            Int rnd_no = bdist(rnd_gen_->getTechnicalRng());
-            prec_rndbin[j] = (UInt) rnd_no; //cast is save because random dist should give result in the intervall [0, basic_residues_c]
-          }
-        }
-
-        std::vector<Size> prec_rnduni(50); // uniform numbers container
+        const std::vector<UInt>& prec_rndbin = rnd_charges[index];
+        const std::vector<Size>& prec_rnduni = rnd_adducts[index]; // uniform numbers container
+        const Int abundance = (Int) prec_rndbin.size();
+        const Int power_factor_2 = power_factors[index];
+        Size prec_rnduni_block_end(0);
         Size prec_rnduni_remaining(0);
 
         // assumption: each basic residue can hold one charged adduct
@@ -375,16 +408,11 @@ public:
             {
               if (prec_rnduni_remaining == 0)
               {
-                // refill discrete rnd numbers if container is depleted
-                {
-                  for (Size i_rnd = 0; i_rnd < prec_rnduni.size(); ++i_rnd)
-                  {
-                    prec_rnduni[i_rnd] = ddist(rnd_gen_->getTechnicalRng());
-                  }
-                  prec_rnduni_remaining = prec_rnduni.size();
-                }
+                // continue with the next block of discrete rnd numbers if the current one is depleted
+                prec_rnduni_block_end += rnduni_block_size;
+                prec_rnduni_remaining = rnduni_block_size;
               }
-              adduct_index = prec_rnduni[--prec_rnduni_remaining];
+              adduct_index = prec_rnduni[prec_rnduni_block_end - rnduni_block_size + (--prec_rnduni_remaining)];
               cmp.add(esi_adducts_[adduct_index], Compomer::RIGHT);
             }
           }
@@ -441,10 +469,7 @@ public:
               continue;
             }
 
-#pragma omp critical (OPENMS_copy_map)
-            {
-              copy_map.push_back(charged_feature);
-            }
+            charged_features[index].push_back(charged_feature);
             // add to consensus
             cf.insert(0, charged_feature);
 
@@ -454,13 +479,22 @@ public:
         }
 
         // add consensus element containing all charge variants just created
-#pragma omp critical (OPENMS_charge_consensus)
-        {
-          charge_consensus.push_back(cf);
-        }
+        has_consensus[index] = 1;
 
       } // ! for feature  (parallel)
 
+      for (Size index = 0; index < features.size(); ++index)
+      {
+        for (Size i = 0; i < charged_features[index].size(); ++i)
+        {
+          copy_map.push_back(charged_features[index][i]);
+        }
+        if (has_consensus[index])
+        {
+          charge_consensus.push_back(charge_consensus_features[index]);
+        }
+      }
+
       this->endProgress();
 
       for (Size i = 0; i < charge_consensus.size(); ++i) // this cannot be done inside the parallel-for as the copy_map might be populated meanwhile, which changes the internal uniqueid-map (used in below function)
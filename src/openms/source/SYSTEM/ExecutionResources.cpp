@@ -0,0 +1,246 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2018.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: Timo Sachsenberg $
+// $Authors: Timo Sachsenberg $
+// --------------------------------------------------------------------------
+
+#include <OpenMS/SYSTEM/ExecutionResources.h>
+
+#include <algorithm>
+#include <atomic>
+#include <fstream>
+#include <limits>
+#include <sstream>
+#include <thread>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#if defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#define OMS_USELINUXAFFINITY
+#endif
+
+namespace OpenMS
+{
+  const std::string ExecutionResources::NamesOfAffinity[] = {"none", "compact", "spread"};
+
+  namespace
+  {
+    /// thread budget (-1 if never set: use the OpenMP default)
+    std::atomic<Int> threads_budget(-1);
+    std::atomic<bool> nested_allowed(false);
+    std::atomic<int> current_affinity(ExecutionResources::AFFINITY_NONE);
+
+    /// the cores the process may run on, determined before any thread was bound
+    const std::vector<Int>& allowedCores()
+    {
+      static const std::vector<Int> cores = []()
+      {
+        std::vector<Int> result;
+#ifdef OMS_USELINUXAFFINITY
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        if (sched_getaffinity(0, sizeof(set), &set) == 0)
+        {
+          for (Int cpu = 0; cpu < CPU_SETSIZE; ++cpu)
+          {
+            if (CPU_ISSET(cpu, &set)) result.push_back(cpu);
+          }
+        }
+#endif
+        if (result.empty())
+        {
+          Int n = std::max(1u, std::thread::hardware_concurrency());
+          for (Int cpu = 0; cpu < n; ++cpu) result.push_back(cpu);
+        }
+        return result;
+      }();
+      return cores;
+    }
+
+    /// parses a Linux cpu list like "0-3,8,10-11"
+    std::vector<Int> parseCPUList(const std::string& list)
+    {
+      std::vector<Int> cpus;
+      std::stringstream ss(list);
+      std::string range;
+      while (std::getline(ss, range, ','))
+      {
+        std::string::size_type dash = range.find('-');
+        try
+        {
+          Int first = std::stoi(range.substr(0, dash));
+          Int last = (dash == std::string::npos ? first : std::stoi(range.substr(dash + 1)));
+          for (Int cpu = first; cpu <= last; ++cpu) cpus.push_back(cpu);
+        }
+        catch (std::exception&)
+        {
+          // ignore malformed entries
+        }
+      }
+      return cpus;
+    }
+
+    /// the available cores grouped by NUMA node
+    std::vector<std::vector<Int> > coresPerNode()
+    {
+      const std::vector<Int>& cores = allowedCores();
+      std::vector<std::vector<Int> > nodes;
+#ifdef OMS_USELINUXAFFINITY
+      for (Int node = 0; node < 1024; ++node)
+      {
+        std::ifstream is("/sys/devices/system/node/node" + std::to_string(node) + "/cpulist");
+        if (!is) continue;
+        std::string list;
+        std::getline(is, list);
+        std::vector<Int> node_cores;
+        for (Int cpu : parseCPUList(list))
+        {
+          if (std::find(cores.begin(), cores.end(), cpu) != cores.end()) node_cores.push_back(cpu);
+        }
+        if (!node_cores.empty()) nodes.push_back(node_cores);
+      }
+#endif
+      if (nodes.empty()) nodes.push_back(cores);
+      return nodes;
+    }
+  }
+
+  Int ExecutionResources::getAvailableCores()
+  {
+    return Int(allowedCores().size());
+  }
+
+  void ExecutionResources::setThreads(Int threads)
+  {
+    if (threads <= 0) threads = getAvailableCores();
+    threads_budget = threads;
+#ifdef _OPENMP
+    omp_set_num_threads(threads);
+    omp_set_max_active_levels(nested_allowed ? std::numeric_limits<int>::max() : 1);
+#endif
+  }
+
+  Int ExecutionResources::getThreads()
+  {
+    Int threads = threads_budget;
+    if (threads > 0) return threads;
+#ifdef _OPENMP
+    return omp_get_max_threads();
+#else
+    return 1;
+#endif
+  }
+
+  Int ExecutionResources::getThreadsForParallelRegion()
+  {
+#ifdef _OPENMP
+    if (omp_in_parallel())
+    {
+      if (!nested_allowed) return 1;
+      return std::max(1, getThreads() / omp_get_num_threads());
+    }
+#endif
+    return getThreads();
+  }
+
+  void ExecutionResources::setNestedParallelism(bool allow)
+  {
+    nested_allowed = allow;
+#ifdef _OPENMP
+    omp_set_max_active_levels(allow ? std::numeric_limits<int>::max() : 1);
+#endif
+  }
+
+  bool ExecutionResources::getNestedParallelism()
+  {
+    return nested_allowed;
+  }
+
+  std::vector<Int> ExecutionResources::getCoreOrder(Affinity affinity)
+  {
+    std::vector<std::vector<Int> > nodes = coresPerNode();
+    std::vector<Int> order;
+    if (affinity != AFFINITY_SPREAD)
+    {
+      for (const std::vector<Int>& node : nodes) order.insert(order.end(), node.begin(), node.end());
+      return order;
+    }
+    // round-robin over the nodes
+    Size max_node_size = 0;
+    for (const std::vector<Int>& node : nodes) max_node_size = std::max(max_node_size, node.size());
+    for (Size i = 0; i < max_node_size; ++i)
+    {
+      for (const std::vector<Int>& node : nodes)
+      {
+        if (i < node.size()) order.push_back(node[i]);
+      }
+    }
+    return order;
+  }
+
+  bool ExecutionResources::setAffinity(Affinity affinity)
+  {
+#if defined(_OPENMP) && defined(OMS_USELINUXAFFINITY)
+    const std::vector<Int> order = getCoreOrder(affinity);
+    const std::vector<Int>& cores = allowedCores();
+    std::atomic<bool> success(true);
+#pragma omp parallel num_threads(getThreads())
+    {
+      cpu_set_t set;
+      CPU_ZERO(&set);
+      if (affinity == AFFINITY_NONE)
+      {
+        for (Int cpu : cores) CPU_SET(cpu, &set);
+      }
+      else
+      {
+        CPU_SET(order[omp_get_thread_num() % order.size()], &set);
+      }
+      if (pthread_setaffinity_np(pthread_self(), sizeof(set), &set) != 0) success = false;
+    }
+    if (success) current_affinity = affinity;
+    return success;
+#else
+    (void)affinity;
+    return false;
+#endif
+  }
+
+  ExecutionResources::Affinity ExecutionResources::getAffinity()
+  {
+    return Affinity(int(current_affinity));
+  }
+
+} // namespace OpenMS
@@ -0,0 +1,297 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2018.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: Timo Sachsenberg $
+// $Authors: Timo Sachsenberg $
+// --------------------------------------------------------------------------
+
+#include <OpenMS/SYSTEM/Profiler.h>
+
+#include <OpenMS/CONCEPT/Exception.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <unordered_map>
+
+using namespace std;
+
+namespace OpenMS
+{
+  namespace
+  {
+    /// Events, counters and the stack of open regions of a single thread
+    struct ThreadBuffer
+    {
+      explicit ThreadBuffer(Size index) :
+        thread(index)
+      {
+      }
+
+      Size thread;
+      std::vector<Profiler::Event> events;
+      std::unordered_map<const char*, double> counts;
+      std::vector<Int64> child_time; ///< time spent in nested regions, one entry per open region
+    };
+
+    std::atomic<bool> profiler_enabled(false);
+
+    /// All thread buffers ever created (never freed, threads keep pointers to them)
+    std::vector<std::unique_ptr<ThreadBuffer> >& registry()
+    {
+      static std::vector<std::unique_ptr<ThreadBuffer> > buffers;
+      return buffers;
+    }
+
+    std::mutex& registryMutex()
+    {
+      static std::mutex mutex;
+      return mutex;
+    }
+
+    ThreadBuffer& localBuffer()
+    {
+      static thread_local ThreadBuffer* buffer = nullptr;
+      if (buffer == nullptr)
+      {
+        std::lock_guard<std::mutex> lock(registryMutex());
+        registry().emplace_back(new ThreadBuffer(registry().size()));
+        buffer = registry().back().get();
+      }
+      return *buffer;
+    }
+
+    /// Escapes @p s for use in a JSON string
+    String jsonEscape(const String& s)
+    {
+      String result;
+      for (String::const_iterator it = s.begin(); it != s.end(); ++it)
+      {
+        if (*it == '"' || *it == '\\') result += '\\';
+        result += *it;
+      }
+      return result;
+    }
+  }
+
+  void Profiler::setEnabled(bool enabled)
+  {
+    profiler_enabled = enabled;
+  }
+
+  bool Profiler::isEnabled()
+  {
+    return profiler_enabled.load(std::memory_order_relaxed);
+  }
+
+  void Profiler::clear()
+  {
+    std::lock_guard<std::mutex> lock(registryMutex());
+    for (std::unique_ptr<ThreadBuffer>& buffer : registry())
+    {
+      buffer->events.clear();
+      buffer->counts.clear();
+    }
+  }
+
+  void Profiler::addCount(const char* name, double value)
+  {
+    if (!isEnabled()) return;
+    localBuffer().counts[name] += value;
+  }
+
+  Int64 Profiler::now()
+  {
+    static const std::chrono::steady_clock::time_point origin = std::chrono::steady_clock::now();
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - origin).count();
+  }
+
+  void Profiler::beginRegion()
+  {
+    localBuffer().child_time.push_back(0);
+  }
+
+  void Profiler::endRegion(const char* name, Int64 start)
+  {
+    Int64 duration = now() - start;
+    ThreadBuffer& buffer = localBuffer();
+    Int64 children = 0;
+    if (!buffer.child_time.empty())
+    {
+      children = buffer.child_time.back();
+      buffer.child_time.pop_back();
+    }
+    if (!buffer.child_time.empty()) buffer.child_time.back() += duration;
+
+    Event e;
+    e.name = name;
+    e.thread = buffer.thread;
+    e.depth = buffer.child_time.size();
+    e.start = start;
+    e.duration = duration;
+    e.self = duration - children;
+    buffer.events.push_back(e);
+  }
+
+  std::vector<Profiler::Event> Profiler::getEvents()
+  {
+    std::lock_guard<std::mutex> lock(registryMutex());
+    std::vector<Event> events;
+    for (const std::unique_ptr<ThreadBuffer>& buffer : registry())
+    {
+      events.insert(events.end(), buffer->events.begin(), buffer->events.end());
+    }
+    return events;
+  }
+
+  std::vector<Profiler::RegionSummary> Profiler::getSummary()
+  {
+    std::map<String, RegionSummary> regions;
+    for (const Event& e : getEvents())
+    {
+      std::map<String, RegionSummary>::iterator it = regions.find(e.name);
+      if (it == regions.end())
+      {
+        RegionSummary r;
+        r.name = e.name;
+        r.calls = 0;
+        r.total = 0.0;
+        r.self = 0.0;
+        r.max = 0.0;
+        it = regions.insert(std::make_pair(r.name, r)).first;
+      }
+      RegionSummary& r = it->second;
+      ++r.calls;
+      r.total += e.duration * 1e-9;
+      r.self += e.self * 1e-9;
+      r.max = std::max(r.max, e.duration * 1e-9);
+    }
+
+    std::vector<RegionSummary> result;
+    for (std::map<String, RegionSummary>::const_iterator it = regions.begin(); it != regions.end(); ++it)
+    {
+      result.push_back(it->second);
+    }
+    std::stable_sort(result.begin(), result.end(),
+      [](const RegionSummary& a, const RegionSummary& b) { return a.total > b.total; });
+    return result;
+  }
+
+  std::vector<std::pair<String, double> > Profiler::getCounts()
+  {
+    // the same name may be stored at different addresses, so merge by content
+    std::map<String, double> counts;
+    {
+      std::lock_guard<std::mutex> lock(registryMutex());
+      for (const std::unique_ptr<ThreadBuffer>& buffer : registry())
+      {
+        for (const std::pair<const char* const, double>& c : buffer->counts)
+        {
+          counts[c.first] += c.second;
+        }
+      }
+    }
+    return std::vector<std::pair<String, double> >(counts.begin(), counts.end());
+  }
+
+  void Profiler::printSummary(std::ostream& os)
+  {
+    std::vector<RegionSummary> regions = getSummary();
+    Size width = 6;
+    for (const RegionSummary& r : regions) width = std::max(width, r.name.size());
+
+    os << std::left << std::setw(width) << "region" << std::right
+       << std::setw(10) << "calls" << std::setw(12) << "total [s]" << std::setw(12) << "self [s]"
+       << std::setw(12) << "mean [ms]" << std::setw(12) << "max [ms]" << "\n";
+    os << std::fixed;
+    for (const RegionSummary& r : regions)
+    {
+      os << std::left << std::setw(width) << r.name << std::right
+         << std::setw(10) << r.calls
+         << std::setprecision(3) << std::setw(12) << r.total << std::setw(12) << r.self
+         << std::setw(12) << r.total * 1e3 / r.calls << std::setw(12) << r.max * 1e3 << "\n";
+    }
+
+    std::vector<std::pair<String, double> > counts = getCounts();
+    if (!counts.empty())
+    {
+      os << "\n" << std::left << std::setw(width) << "counter" << std::right << std::setw(22) << "value" << "\n";
+      for (const std::pair<String, double>& c : counts)
+      {
+        os << std::left << std::setw(width) << c.first << std::right << std::setprecision(0) << std::setw(22) << c.second << "\n";
+      }
+    }
+    os.unsetf(std::ios_base::floatfield);
+    os << std::setprecision(6);
+  }
+
+  void Profiler::storeChromeTrace(const String& filename)
+  {
+    std::ofstream os(filename.c_str());
+    if (!os)
+    {
+      throw Exception::UnableToCreateFile(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, filename);
+    }
+
+    // timestamps are in microseconds
+    os << "{\"traceEvents\":[\n";
+    bool first = true;
+    os << std::fixed << std::setprecision(3);
+    for (const Event& e : getEvents())
+    {
+      if (!first) os << ",\n";
+      first = false;
+      os << "{\"name\":\"" << jsonEscape(e.name) << "\",\"cat\":\"OpenMS\",\"ph\":\"X\",\"pid\":0,\"tid\":" << e.thread
+         << ",\"ts\":" << e.start * 1e-3 << ",\"dur\":" << e.duration * 1e-3 << "}";
+    }
+    os << "\n],\n\"displayTimeUnit\":\"ms\",\n\"otherData\":{";
+    first = true;
+    os << std::setprecision(0);
+    for (const std::pair<String, double>& c : getCounts())
+    {
+      if (!first) os << ",";
+      first = false;
+      os << "\"" << jsonEscape(c.first) << "\":" << c.second;
+    }
+    os << "}}\n";
+    os.close();
+    if (!os)
+    {
+      throw Exception::UnableToCreateFile(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, filename);
+    }
+  }
+
+} // namespace OpenMS
@@ -0,0 +1,430 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2018.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: Timo Sachsenberg $
+// $Authors: Timo Sachsenberg $
+// --------------------------------------------------------------------------
+
+#include <OpenMS/SYSTEM/RemoteFile.h>
+
+#include <OpenMS/CONCEPT/Exception.h>
+#include <OpenMS/CONCEPT/LogStream.h>
+
+#include <QtCore/QCoreApplication>
+#include <QtCore/QEventLoop>
+#include <QtCore/QTimer>
+#include <QtCore/QUrl>
+#include <QtNetwork/QNetworkAccessManager>
+#include <QtNetwork/QNetworkReply>
+#include <QtNetwork/QNetworkRequest>
+
+#include <algorithm>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <stdexcept>
+#include <string>
+
+namespace OpenMS
+{
+
+  namespace
+  {
+    // Qt needs an application object to process network events
+    void ensureApplication()
+    {
+      static std::mutex mutex;
+      static std::unique_ptr<QCoreApplication> application;
+      static int argc = 1;
+      static char name[] = "OpenMS";
+      static char* argv[] = { name, nullptr };
+
+      std::lock_guard<std::mutex> lock(mutex);
+      if (QCoreApplication::instance() == nullptr)
+      {
+        application.reset(new QCoreApplication(argc, argv));
+      }
+    }
+
+    QNetworkRequest rangeRequest(const String& url, Size begin, Size end)
+    {
+      QNetworkRequest request(QUrl(url.toQString()));
+      request.setRawHeader("Range", QByteArray("bytes=") + QByteArray::number((qulonglong)begin) + "-" + QByteArray::number((qulonglong)end));
+      request.setAttribute(QNetworkRequest::FollowRedirectsAttribute, true);
+      return request;
+    }
+
+    // aborts the reply if it takes longer than the timeout (seconds)
+    void setTimeout(QNetworkReply* reply, Int timeout)
+    {
+      QTimer* timer = new QTimer(reply);
+      timer->setSingleShot(true);
+      QObject::connect(timer, &QTimer::timeout, reply, &QNetworkReply::abort);
+      timer->start(timeout * 1000);
+    }
+  }
+
+  RemoteFile::Options::Options() :
+    block_size(1 << 20),
+    cache_blocks(256),
+    read_ahead(4),
+    max_concurrent(8),
+    timeout(60),
+    retries(3)
+  {
+  }
+
+  RemoteFile::Statistics::Statistics() :
+    requests(0),
+    bytes_fetched(0),
+    cache_hits(0),
+    cache_misses(0)
+  {
+  }
+
+  RemoteFile::RemoteFile(const String& url, const Options& options) :
+    url_(url),
+    options_(options),
+    size_(0),
+    last_block_(std::numeric_limits<Size>::max())
+  {
+    if (options_.block_size == 0 || options_.cache_blocks == 0 || options_.max_concurrent == 0)
+    {
+      throw Exception::IllegalArgument(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "Block size, cache size and number of concurrent requests need to be positive.");
+    }
+    ensureApplication();
+
+    // request the first byte, the total size is part of the response (Content-Range: bytes 0-0/<size>)
+    QEventLoop loop;
+    QNetworkAccessManager manager;
+    QNetworkReply* reply = manager.get(rangeRequest(url_, 0, 0));
+    setTimeout(reply, options_.timeout);
+    QObject::connect(reply, &QNetworkReply::finished, &loop, &QEventLoop::quit);
+    if (!reply->isFinished()) loop.exec();
+
+    const int status = reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt();
+    const String content_range(reply->rawHeader("Content-Range").constData());
+    const QNetworkReply::NetworkError error = reply->error();
+    const String error_string(reply->errorString());
+    reply->deleteLater();
+
+    // an empty file cannot satisfy the range (416, Content-Range: bytes */0)
+    if (status == 206 || status == 416)
+    {
+      size_ = parseContentRange(content_range);
+      return;
+    }
+    if (status == 200)
+    {
+      throw Exception::IllegalArgument(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "The server of '" + url_ + "' does not support range requests.");
+    }
+    LOG_ERROR << "RemoteFile: Could not open '" << url_ << "' (HTTP status " << status << ", error " << (int)error << ": " << error_string << ")." << std::endl;
+    throw Exception::FileNotFound(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, url_);
+  }
+
+  bool RemoteFile::isRemote(const String& filename)
+  {
+    String lower(filename.prefix(std::min<Size>(filename.size(), 8)));
+    lower.toLower();
+    return lower.hasPrefix("http://") || lower.hasPrefix("https://");
+  }
+
+  Size RemoteFile::parseContentRange(const String& content_range)
+  {
+    // the total size follows the slash, it may be '*' if unknown
+    const Size slash = content_range.rfind('/');
+    String total = slash == std::string::npos ? String() : String(content_range.substr(slash + 1));
+    total.trim();
+    if (total.empty() || total.find_first_not_of("0123456789") != std::string::npos)
+    {
+      throw Exception::ParseError(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, content_range, "Content-Range does not contain the size of the file.");
+    }
+    try
+    {
+      const unsigned long long size = std::stoull(total);
+      if (size > std::numeric_limits<Size>::max()) throw std::out_of_range(total);
+      return Size(size);
+    }
+    catch (std::out_of_range&)
+    {
+      throw Exception::ParseError(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, content_range, "File size is out of range.");
+    }
+  }
+
+  const String& RemoteFile::getURL() const
+  {
+    return url_;
+  }
+
+  Size RemoteFile::size() const
+  {
+    return size_;
+  }
+
+  Size RemoteFile::blockCount_() const
+  {
+    return (size_ + options_.block_size - 1) / options_.block_size;
+  }
+
+  RemoteFile::BlockPtr_ RemoteFile::findBlock_(Size block)
+  {
+    std::unordered_map<Size, std::pair<BlockPtr_, std::list<Size>::iterator> >::iterator it = cache_.find(block);
+    if (it == cache_.end()) return BlockPtr_();
+    lru_.splice(lru_.begin(), lru_, it->second.second);
+    return it->second.first;
+  }
+
+  void RemoteFile::insertBlock_(Size block, const BlockPtr_& data)
+  {
+    if (cache_.find(block) != cache_.end()) return;
+    lru_.push_front(block);
+    cache_[block] = std::make_pair(data, lru_.begin());
+    while (cache_.size() > options_.cache_blocks)
+    {
+      cache_.erase(lru_.back());
+      lru_.pop_back();
+    }
+  }
+
+  std::vector<RemoteFile::BlockPtr_> RemoteFile::fetchBlocks_(const std::vector<Size>& blocks)
+  {
+    std::vector<BlockPtr_> results(blocks.size());
+    if (blocks.empty()) return results;
+
+    // all requests of this call are processed by a local event loop (in the calling thread)
+    QEventLoop loop;
+    QNetworkAccessManager manager;
+    std::vector<Size> attempts(blocks.size(), 0);
+    Size next = 0;
+    Size running = 0;
+    String error;
+
+    std::function<void(Size)> start = [&](Size i)
+    {
+      const Size begin = blocks[i] * options_.block_size;
+      const Size end = std::min(size_, begin + options_.block_size);
+      QNetworkReply* reply = manager.get(rangeRequest(url_, begin, end - 1));
+      setTimeout(reply, options_.timeout);
+      ++running;
+      QObject::connect(reply, &QNetworkReply::finished, [&, i, reply, begin, end]()
+      {
+        --running;
+        const int status = reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt();
+        const QByteArray data = reply->readAll();
+        if (reply->error() == QNetworkReply::NoError && status == 206 && (Size)data.size() == end - begin)
+        {
+          results[i].reset(new std::string(data.constData(), data.size()));
+        }
+        else if (++attempts[i] < options_.retries)
+        {
+          start(i);
+        }
+        else if (error.empty())
+        {
+          error = "bytes " + String(begin) + "-" + String(end - 1) + " (HTTP status " + String(status) + ": " + String(reply->errorString()) + ")";
+        }
+        reply->deleteLater();
+
+        // keep max_concurrent requests running (stop after an error)
+        while (error.empty() && running < options_.max_concurrent && next < blocks.size())
+        {
+          start(next++);
+        }
+        if (running == 0) loop.quit();
+      });
+    };
+
+    while (running < options_.max_concurrent && next < blocks.size())
+    {
+      start(next++);
+    }
+    if (running > 0) loop.exec();
+
+    if (!error.empty())
+    {
+      LOG_ERROR << "RemoteFile: Could not read " << error << " of '" << url_ << "'." << std::endl;
+      throw Exception::IOException(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, url_);
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (Size i = 0; i < blocks.size(); ++i)
+    {
+      insertBlock_(blocks[i], results[i]);
+      statistics_.requests += 1;
+      statistics_.bytes_fetched += results[i]->size();
+    }
+    return results;
+  }
+
+  Size RemoteFile::read(Size offset, Size length, char* buffer)
+  {
+    if (offset >= size_ || length == 0) return 0;
+    length = std::min(length, size_ - offset);
+    const Size first = offset / options_.block_size;
+    const Size last = (offset + length - 1) / options_.block_size;
+
+    std::vector<BlockPtr_> data(last - first + 1);
+    std::vector<Size> missing;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      for (Size b = first; b <= last; ++b)
+      {
+        data[b - first] = findBlock_(b);
+        if (!data[b - first]) missing.push_back(b);
+      }
+      statistics_.cache_misses += missing.size();
+      statistics_.cache_hits += data.size() - missing.size();
+
+      // sequential access: fetch the following blocks along with the missing ones
+      const bool sequential = (last_block_ == first || last_block_ + 1 == first);
+      if (sequential && !missing.empty())
+      {
+        for (Size b = last + 1; b <= last + options_.read_ahead && b < blockCount_(); ++b)
+        {
+          if (cache_.find(b) == cache_.end()) missing.push_back(b);
+        }
+      }
+      last_block_ = last;
+    }
+
+    const std::vector<BlockPtr_> fetched = fetchBlocks_(missing);
+    for (Size i = 0; i < missing.size(); ++i)
+    {
+      if (missing[i] <= last) data[missing[i] - first] = fetched[i];
+    }
+
+    // copy the requested bytes
+    Size copied = 0;
+    for (Size b = first; b <= last; ++b)
+    {
+      const std::string& block = *data[b - first];
+      const Size block_begin = b * options_.block_size;
+      const Size from = std::max(offset, block_begin) - block_begin;
+      const Size to = std::min(offset + length, block_begin + block.size()) - block_begin;
+      std::copy(block.begin() + from, block.begin() + to, buffer + copied);
+      copied += to - from;
+    }
+    return copied;
+  }
+
+  std::string RemoteFile::read(Size offset, Size length)
+  {
+    if (offset >= size_) return std::string();
+    std::string result(std::min(length, size_ - offset), '\0');
+    if (!result.empty()) result.resize(read(offset, result.size(), &result[0]));
+    return result;
+  }
+
+  void RemoteFile::prefetch(const std::vector<std::pair<Size, Size> >& ranges)
+  {
+    std::vector<Size> blocks;
+    for (const std::pair<Size, Size>& range : ranges)
+    {
+      if (range.first >= range.second || range.first >= size_) continue;
+      const Size last = (std::min(range.second, size_) - 1) / options_.block_size;
+      for (Size b = range.first / options_.block_size; b <= last; ++b)
+      {
+        blocks.push_back(b);
+      }
+    }
+    std::sort(blocks.begin(), blocks.end());
+    blocks.erase(std::unique(blocks.begin(), blocks.end()), blocks.end());
+
+    std::vector<Size> missing;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      for (Size b : blocks)
+      {
+        if (cache_.find(b) == cache_.end()) missing.push_back(b);
+      }
+    }
+    // blocks beyond the cache capacity would only evict the first ones again
+    if (missing.size() > options_.cache_blocks) missing.resize(options_.cache_blocks);
+    fetchBlocks_(missing);
+  }
+
+  RemoteFile::Statistics RemoteFile::getStatistics() const
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return statistics_;
+  }
+
+  RemoteFileStream::RemoteFileStream(const boost::shared_ptr<RemoteFile>& file, Size buffer_size) :
+    std::istream(nullptr),
+    buffer_(file, buffer_size)
+  {
+    rdbuf(&buffer_);
+  }
+
+  RemoteFileStream::~RemoteFileStream()
+  {
+  }
+
+  RemoteFileStream::StreamBuffer_::StreamBuffer_(const boost::shared_ptr<RemoteFile>& file, Size buffer_size) :
+    file_(file),
+    buffer_(std::max<Size>(buffer_size, 1)),
+    position_(0)
+  {
+    setg(buffer_.data(), buffer_.data(), buffer_.data());
+  }
+
+  RemoteFileStream::StreamBuffer_::int_type RemoteFileStream::StreamBuffer_::underflow()
+  {
+    if (gptr() < egptr()) return traits_type::to_int_type(*gptr());
+    const Size n = file_->read(position_, buffer_.size(), buffer_.data());
+    if (n == 0) return traits_type::eof();
+    setg(buffer_.data(), buffer_.data(), buffer_.data() + n);
+    position_ += n;
+    return traits_type::to_int_type(*gptr());
+  }
+
+  RemoteFileStream::StreamBuffer_::pos_type RemoteFileStream::StreamBuffer_::seekoff(off_type off, std::ios_base::seekdir dir, std::ios_base::openmode which)
+  {
+    if (!(which & std::ios_base::in)) return pos_type(off_type(-1));
+
+    const off_type current = (off_type)position_ - (egptr() - gptr());
+    if (dir == std::ios_base::cur && off == 0) return pos_type(current); // tellg
+
+    off_type target = off;
+    if (dir == std::ios_base::cur) target = current + off;
+    else if (dir == std::ios_base::end) target = (off_type)file_->size() + off;
+    if (target < 0 || target > (off_type)file_->size()) return pos_type(off_type(-1));
+
+    position_ = target;
+    setg(buffer_.data(), buffer_.data(), buffer_.data());
+    return pos_type(target);
+  }
+
+  RemoteFileStream::StreamBuffer_::pos_type RemoteFileStream::StreamBuffer_::seekpos(pos_type pos, std::ios_base::openmode which)
+  {
+    return seekoff(off_type(pos), std::ios_base::beg, which);
+  }
+
+}
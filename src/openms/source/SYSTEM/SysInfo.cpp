@@ -40,8 +40,10 @@
 #elif __APPLE__
 #include <mach/mach.h>
 #include <mach/mach_init.h>
+#include <sys/resource.h>
 #else
 #include <cstdio>
+#include <cstring>
 #include <unistd.h>
 
 #define OMS_USELINUXMEMORYPLATFORM
@@ -96,6 +98,31 @@ namespace OpenMS
     fclose(f);
     return true;
   }
+
+  // reads the value of all @p keys (e.g. "VmHWM:") from a "key value" file like /proc/self/status
+  bool read_proc_values_linux(const char* path, const char* const* keys, unsigned long long* values, size_t n)
+  {
+    FILE *f = fopen(path, "r");
+    if (!f)
+    {
+      return false;
+    }
+    size_t found(0);
+    char line[256];
+    while (found < n && fgets(line, sizeof(line), f))
+    {
+      for (size_t i = 0; i < n; ++i)
+      {
+        size_t len = strlen(keys[i]);
+        if (strncmp(line, keys[i], len) == 0 && 1 == sscanf(line + len, "%llu", &values[i]))
+        {
+          ++found;
+        }
+      }
+    }
+    fclose(f);
+    return found == n;
+  }
 #endif
 
   bool SysInfo::getProcessMemoryConsumption(size_t& mem_virtual)
@@ -142,11 +169,50 @@ namespace OpenMS
     mem_virtual = pmc.PeakWorkingSetSize / 1024; // byte to KB
     return true;
 #elif __APPLE__
-    //todo: find a good API to do this
-    return false;
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) != 0)
+    {
+      return false;
+    }
+    mem_virtual = (size_t)usage.ru_maxrss / 1024; // byte to KB
+    return true;
 #else // Linux
+    const char* const keys[] = {"VmHWM:"};
+    unsigned long long peak(0);
+    if (!read_proc_values_linux("/proc/self/status", keys, &peak, 1))
+    {
+      return false;
+    }
+    mem_virtual = (size_t)peak; // already in KB
+    return true;
+#endif
+  }
+
+  bool SysInfo::getProcessIOCounters(size_t& bytes_read, size_t& bytes_written)
+  {
+    bytes_read = bytes_written = 0;
+#ifdef OPENMS_WINDOWSPLATFORM
+    IO_COUNTERS io;
+    if (!GetProcessIoCounters(GetCurrentProcess(), &io))
+    {
+      return false;
+    }
+    bytes_read = (size_t)io.ReadTransferCount;
+    bytes_written = (size_t)io.WriteTransferCount;
+    return true;
+#elif __APPLE__
     //todo: find a good API to do this
     return false;
+#else // Linux
+    const char* const keys[] = {"rchar:", "wchar:"};
+    unsigned long long values[2] = {0, 0};
+    if (!read_proc_values_linux("/proc/self/io", keys, values, 2))
+    {
+      return false;
+    }
+    bytes_read = (size_t)values[0];
+    bytes_written = (size_t)values[1];
+    return true;
 #endif
   }
 
@@ -3,10 +3,13 @@ set(directory source/SYSTEM)
 
 ### list all filenames of the directory here
 set(sources_list
+ExecutionResources.cpp
 File.cpp
 FileWatcher.cpp
 JavaInfo.cpp
 NetworkGetRequest.cpp
+Profiler.cpp
+RemoteFile.cpp
 RWrapper.cpp
 StopWatch.cpp
 SysInfo.cpp
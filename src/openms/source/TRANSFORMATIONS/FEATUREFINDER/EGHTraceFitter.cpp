@@ -64,31 +64,25 @@ namespace OpenMS
     double sigma = x(2);
     double tau = x(3);
 
-    double t_diff, t_diff2, denominator = 0.0;
-
-    double fegh = 0.0;
+    const double two_sigma_sq = 2 * sigma * sigma;
+    const double baseline = m_data->traces_ptr->baseline;
 
     UInt count = 0;
     for (Size t = 0; t < m_data->traces_ptr->size(); ++t)
     {
-      const FeatureFinderAlgorithmPickedHelperStructs::MassTrace& trace = m_data->traces_ptr->at(t);
-      double weight = m_data->weighted ? trace.theoretical_int : 1.0;
+      const FeatureFinderAlgorithmPickedHelperStructs::MassTrace& trace = (*m_data->traces_ptr)[t];
+      const double weight = m_data->weighted ? trace.theoretical_int : 1.0;
+      const double trace_height = trace.theoretical_int * H;
       for (Size i = 0; i < trace.peaks.size(); ++i)
       {
-        double rt = trace.peaks[i].first;
-
-        t_diff = rt - tR;
-        t_diff2 = t_diff * t_diff; // -> (t - t_R)^2
-
-        denominator = 2 * sigma * sigma + tau * t_diff; // -> 2\sigma_{g}^{2} + \tau \left(t - t_R\right)
+        const double t_diff = trace.peaks[i].first - tR;
+        // -> 2\sigma_{g}^{2} + \tau \left(t - t_R\right)
+        const double denominator = two_sigma_sq + tau * t_diff;
 
+        double fegh = 0.0;
         if (denominator > 0.0)
         {
-          fegh =  m_data->traces_ptr->baseline + trace.theoretical_int * H * exp(-t_diff2 / denominator);
-        }
-        else
-        {
-          fegh = 0.0;
+          fegh = baseline + trace_height * exp(-t_diff * t_diff / denominator);
         }
 
         fvec(count) = (fegh - trace.peaks[i].second->getIntensity()) * weight;
@@ -105,56 +99,48 @@ namespace OpenMS
     double sigma = fabs(x(2)); // must be non-negative!
     double tau = x(3);
 
-    double derivative_H, derivative_tR, derivative_sigma, derivative_tau = 0.0;
-    double t_diff, t_diff2, exp1, denominator = 0.0;
+    const double two_sigma_sq = 2 * sigma * sigma;
+    const double four_sigma_sq = 2 * two_sigma_sq;
 
     UInt count = 0;
     for (Size t = 0; t < m_data->traces_ptr->size(); ++t)
     {
-      const FeatureFinderAlgorithmPickedHelperStructs::MassTrace& trace = m_data->traces_ptr->at(t);
-      double weight = m_data->weighted ? trace.theoretical_int : 1.0;
+      const FeatureFinderAlgorithmPickedHelperStructs::MassTrace& trace = (*m_data->traces_ptr)[t];
+      const double weight = m_data->weighted ? trace.theoretical_int : 1.0;
       for (Size i = 0; i < trace.peaks.size(); ++i)
       {
-        double rt = trace.peaks[i].first;
+        const double t_diff = trace.peaks[i].first - tR;
+        const double t_diff2 = t_diff * t_diff; // -> (t - t_R)^2
 
-        t_diff = rt - tR;
-        t_diff2 = t_diff * t_diff; // -> (t - t_R)^2
-
-        denominator = 2 * sigma * sigma + tau * t_diff; // -> 2\sigma_{g}^{2} + \tau \left(t - t_R\right)
+        // -> 2\sigma_{g}^{2} + \tau \left(t - t_R\right)
+        const double denominator = two_sigma_sq + tau * t_diff;
 
         if (denominator > 0)
         {
-          exp1 = exp(-t_diff2 / denominator);
+          const double exp1 = exp(-t_diff2 / denominator);
 
           // \partial H f_{egh}(t) = \exp\left( \frac{-\left(t-t_R \right)}{2\sigma_{g}^{2} + \tau \left(t - t_R\right)} \right)
-          derivative_H = trace.theoretical_int * exp1;
-
-          // \partial t_R f_{egh}(t) &=& H \exp \left( \frac{-\left(t-t_R \right)}{2\sigma_{g}^{2} + \tau \left(t - t_R\right)} \right) \left( \frac{\left( 4 \sigma_{g}^{2} + \tau \left(t-t_R \right) \right) \left(t-t_R \right)}{\left( 2\sigma_{g}^{2} + \tau \left(t - t_R\right) \right)^2} \right)
-          derivative_tR = trace.theoretical_int * H * exp1 * ((4 * sigma * sigma + tau * t_diff) * t_diff) / (denominator * denominator);
+          const double derivative_H = trace.theoretical_int * exp1;
 
-          // \partial \sigma_{g}^{2} f_{egh}(t) &=& H \exp \left( \frac{-\left(t-t_R \right)^2}{2\sigma_{g}^{2} + \tau \left(t - t_R\right)} \right) \left( \frac{ 2 \left(t - t_R\right)^2}{\left( 2\sigma_{g}^{2} + \tau \left(t - t_R\right) \right)^2} \right)
-          // // \partial \sigma_{g}^{2} f_{egh}(t) &=& H \exp \left( \frac{-\left(t-t_R \right)^2}{2\sigma_{g}^{2} + \tau \left(t - t_R\right)} \right) \left( \frac{ 2 \left(t - t_R\right)^2}{\left( 2\sigma_{g}^{2} + \tau \left(t - t_R\right) \right)^2} \right)
-          // derivative_sigma_square = trace.theoretical_int * H * exp1 * 2 * t_diff2 / (denominator * denominator));
+          // the remaining partial derivatives share the factor
+          // H \exp \left( \frac{-\left(t-t_R \right)^2}{2\sigma_{g}^{2} + \tau \left(t - t_R\right)} \right) \frac{1}{\left( 2\sigma_{g}^{2} + \tau \left(t - t_R\right) \right)^2}
+          const double common = derivative_H * H / (denominator * denominator) * weight;
 
+          // \partial t_R f_{egh}(t) &=& H \exp \left( \frac{-\left(t-t_R \right)}{2\sigma_{g}^{2} + \tau \left(t - t_R\right)} \right) \left( \frac{\left( 4 \sigma_{g}^{2} + \tau \left(t-t_R \right) \right) \left(t-t_R \right)}{\left( 2\sigma_{g}^{2} + \tau \left(t - t_R\right) \right)^2} \right)
           // \partial \sigma_{g} f_{egh}(t) &=& H \exp \left( \frac{-\left(t-t_R \right)^2}{2\sigma_{g}^{2} + \tau \left(t - t_R\right)} \right) \left( \frac{ 4 \sigma_{g} \left(t - t_R\right)^2}{\left( 2\sigma_{g}^{2} + \tau \left(t - t_R\right) \right)^2} \right)
-          derivative_sigma = trace.theoretical_int * H * exp1 * 4 * sigma * t_diff2 / (denominator * denominator);
-
           // \partial \tau f_{egh}(t) &=& H \exp \left( \frac{-\left(t-t_R \right)^2}{2\sigma_{g}^{2} + \tau \left(t - t_R\right)} \right) \left( \frac{ \left(t - t_R\right)^3}{\left( 2\sigma_{g}^{2} + \tau \left(t - t_R\right) \right)^2} \right)
-          derivative_tau = trace.theoretical_int * H * exp1 * t_diff * t_diff2 / (denominator * denominator);
+          J(count, 0) = derivative_H * weight;
+          J(count, 1) = common * (four_sigma_sq + tau * t_diff) * t_diff;
+          J(count, 2) = common * 4 * sigma * t_diff2;
+          J(count, 3) = common * t_diff * t_diff2;
         }
         else
         {
-          derivative_H = 0.0;
-          derivative_tR = 0.0;
-          derivative_sigma = 0.0;
-          derivative_tau = 0.0;
+          J(count, 0) = 0.0;
+          J(count, 1) = 0.0;
+          J(count, 2) = 0.0;
+          J(count, 3) = 0.0;
         }
-
-        // set the jacobian matrix
-        J(count, 0) = derivative_H * weight;
-        J(count, 1) = derivative_tR * weight;
-        J(count, 2) = derivative_sigma * weight;
-        J(count, 3) = derivative_tau * weight;
         ++count;
       }
     }
@@ -39,6 +39,12 @@
 #include <OpenMS/TRANSFORMATIONS/FEATUREFINDER/EGHTraceFitter.h>
 #include <OpenMS/TRANSFORMATIONS/FEATUREFINDER/GaussTraceFitter.h>
 
+#include <boost/numeric/conversion/cast.hpp>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
 using namespace OpenMS;
 using namespace std;
 
@@ -113,18 +119,9 @@ double ElutionModelFitter::calculateFitQuality_(const TraceFitter* fitter,
 }
 
 
-void ElutionModelFitter::fitElutionModels(FeatureMap& features)
+TraceFitter* ElutionModelFitter::createFitter_(bool asymmetric,
+                                              bool weighted) const
 {
-  bool asymmetric = param_.getValue("asymmetric").toBool();
-  double add_zeros = param_.getValue("add_zeros");
-  bool weighted = !param_.getValue("unweighted_fit").toBool();
-  bool impute = !param_.getValue("no_imputation").toBool();
-  double check_boundaries = param_.getValue("check:boundaries");
-  double area_limit = param_.getValue("check:min_area");
-  double width_limit = param_.getValue("check:width");
-  double asym_limit = (asymmetric ? 
-                       double(param_.getValue("check:asymmetry")) : 0.0);
-
   TraceFitter* fitter;
   if (asymmetric)
   {
@@ -137,195 +134,239 @@ void ElutionModelFitter::fitElutionModels(FeatureMap& features)
     params.setValue("weighted", "true");
     fitter->setParameters(params);
   }
+  return fitter;
+}
+
+
+void ElutionModelFitter::fitElutionModels(FeatureMap& features)
+{
+  bool asymmetric = param_.getValue("asymmetric").toBool();
+  double add_zeros = param_.getValue("add_zeros");
+  bool weighted = !param_.getValue("unweighted_fit").toBool();
+  bool impute = !param_.getValue("no_imputation").toBool();
+  double check_boundaries = param_.getValue("check:boundaries");
+  double area_limit = param_.getValue("check:min_area");
+  double width_limit = param_.getValue("check:width");
+  double asym_limit = (asymmetric ? 
+                       double(param_.getValue("check:asymmetry")) : 0.0);
 
-  // store model parameters to find outliers later; store values redundantly -
-  // once aligned with the features in the map, once only for successful models:
+  // store model parameters to find outliers later:
   vector<double> widths_all, widths_good, asym_all, asym_good;
   if (width_limit > 0)
   {
     widths_all.resize(features.size(), numeric_limits<double>::quiet_NaN());
-    widths_good.reserve(features.size());
   }
   if (asym_limit > 0)
   {
     asym_all.resize(features.size(), numeric_limits<double>::quiet_NaN());
-    asym_good.reserve(features.size());
   }
 
-  // collect peaks that constitute mass traces:
+  // features are fitted independently of each other, so we can do this in
+  // parallel (every thread uses its own fitter):
   LOG_DEBUG << "Fitting elution models to features:" << endl;
-  Size index = 0;
-  for (FeatureMap::Iterator feat_it = features.begin(); 
-       feat_it != features.end(); ++feat_it, ++index)
+  Size err_count(0);
+  std::exception_ptr err;
+#ifdef _OPENMP
+#pragma omp parallel
+#endif
   {
-    // LOG_DEBUG << String(feat_it->getMetaValue("PeptideRef")) << endl;
-    double region_start = double(feat_it->getMetaValue("leftWidth"));
-    double region_end = double(feat_it->getMetaValue("rightWidth"));
+    TraceFitter* fitter = createFitter_(asymmetric, weighted);
 
-    if (feat_it->getSubordinates().empty())
+#ifdef _OPENMP
+#pragma omp for schedule(dynamic)
+#endif
+    for (SignedSize i = 0; i < boost::numeric_cast<SignedSize>(features.size()); ++i)
     {
-      throw Exception::MissingInformation(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "No subordinate features for mass traces available.");
-    }
-    const Feature& sub = feat_it->getSubordinates()[0];
-    if (sub.getConvexHulls().empty())
-    {
-      throw Exception::MissingInformation(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "No hull points for mass trace in subordinate feature available.");
-    }
-
-    vector<Peak1D> peaks;
-    // reserve space once, to avoid copying and invalidating pointers:
-    Size points_per_hull = sub.getConvexHulls()[0].getHullPoints().size();
-    peaks.reserve(feat_it->getSubordinates().size() * points_per_hull +
-                  (add_zeros > 0.0)); // don't forget additional zero point
-    MassTraces traces;
-    traces.max_trace = 0;
-    // need a mass trace for every transition, plus maybe one for add. zeros:
-    traces.reserve(feat_it->getSubordinates().size() + (add_zeros > 0.0));
-    for (vector<Feature>::iterator sub_it = feat_it->getSubordinates().begin();
-         sub_it != feat_it->getSubordinates().end(); ++sub_it)
-    {
-      MassTrace trace;
-      trace.peaks.reserve(points_per_hull);
-      trace.theoretical_int = sub_it->getMetaValue("isotope_probability");
-      const ConvexHull2D& hull = sub_it->getConvexHulls()[0];
-      for (ConvexHull2D::PointArrayTypeConstIterator point_it = 
-             hull.getHullPoints().begin(); point_it !=
-             hull.getHullPoints().end(); ++point_it)
+      try
       {
-        double intensity = point_it->getY();
-        if (intensity > 0.0) // only use non-zero intensities for fitting
+        Size index = Size(i);
+        FeatureMap::Iterator feat_it = features.begin() + i;
+        // collect peaks that constitute mass traces:
+        // LOG_DEBUG << String(feat_it->getMetaValue("PeptideRef")) << endl;
+        double region_start = double(feat_it->getMetaValue("leftWidth"));
+        double region_end = double(feat_it->getMetaValue("rightWidth"));
+
+        if (feat_it->getSubordinates().empty())
         {
-          Peak1D peak;
-          peak.setMZ(sub_it->getMZ());
-          peak.setIntensity(intensity);
-          peaks.push_back(peak);
-          trace.peaks.push_back(make_pair(point_it->getX(), &peaks.back()));
+          throw Exception::MissingInformation(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "No subordinate features for mass traces available.");
+        }
+        const Feature& sub = feat_it->getSubordinates()[0];
+        if (sub.getConvexHulls().empty())
+        {
+          throw Exception::MissingInformation(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "No hull points for mass trace in subordinate feature available.");
         }
-      }
-      trace.updateMaximum();
-      if (!trace.peaks.empty()) traces.push_back(trace);
-    }
 
-    // find the trace with maximal intensity:
-    Size max_trace = 0;
-    double max_intensity = 0;
-    for (Size i = 0; i < traces.size(); ++i)
-    {
-      if (traces[i].max_peak->getIntensity() > max_intensity)
-      {
-        max_trace = i;
-        max_intensity = traces[i].max_peak->getIntensity();
-      }
-    }
-    traces.max_trace = max_trace;
-    traces.baseline = 0.0;
+        vector<Peak1D> peaks;
+        // reserve space once, to avoid copying and invalidating pointers:
+        Size points_per_hull = sub.getConvexHulls()[0].getHullPoints().size();
+        peaks.reserve(feat_it->getSubordinates().size() * points_per_hull +
+                      (add_zeros > 0.0)); // don't forget additional zero point
+        MassTraces traces;
+        traces.max_trace = 0;
+        // need a mass trace for every transition, plus maybe one for add. zeros:
+        traces.reserve(feat_it->getSubordinates().size() + (add_zeros > 0.0));
+        for (vector<Feature>::iterator sub_it = feat_it->getSubordinates().begin();
+             sub_it != feat_it->getSubordinates().end(); ++sub_it)
+        {
+          MassTrace trace;
+          trace.peaks.reserve(points_per_hull);
+          trace.theoretical_int = sub_it->getMetaValue("isotope_probability");
+          const ConvexHull2D& hull = sub_it->getConvexHulls()[0];
+          for (ConvexHull2D::PointArrayTypeConstIterator point_it = 
+                 hull.getHullPoints().begin(); point_it !=
+                 hull.getHullPoints().end(); ++point_it)
+          {
+            double intensity = point_it->getY();
+            if (intensity > 0.0) // only use non-zero intensities for fitting
+            {
+              Peak1D peak;
+              peak.setMZ(sub_it->getMZ());
+              peak.setIntensity(intensity);
+              peaks.push_back(peak);
+              trace.peaks.push_back(make_pair(point_it->getX(), &peaks.back()));
+            }
+          }
+          trace.updateMaximum();
+          if (!trace.peaks.empty()) traces.push_back(trace);
+        }
 
-    if (add_zeros > 0.0)
-    {
-      MassTrace trace;
-      trace.peaks.reserve(2);
-      trace.theoretical_int = add_zeros;
-      Peak1D peak;
-      peak.setMZ(feat_it->getSubordinates()[0].getMZ());
-      peak.setIntensity(0.0);
-      peaks.push_back(peak);
-      double offset = 0.2 * (region_start - region_end);
-      trace.peaks.push_back(make_pair(region_start - offset, &peaks.back()));
-      trace.peaks.push_back(make_pair(region_end + offset, &peaks.back()));
-      traces.push_back(trace);
-    }
+        // find the trace with maximal intensity:
+        Size max_trace = 0;
+        double max_intensity = 0;
+        for (Size i = 0; i < traces.size(); ++i)
+        {
+          if (traces[i].max_peak->getIntensity() > max_intensity)
+          {
+            max_trace = i;
+            max_intensity = traces[i].max_peak->getIntensity();
+          }
+        }
+        traces.max_trace = max_trace;
+        traces.baseline = 0.0;
 
-    // fit the model:
-    bool fit_success = true;
-    try
-    {
-      fitter->fit(traces);
-    }
-    catch (Exception::UnableToFit& except)
-    {
-      LOG_ERROR << "Error fitting model to feature '" << feat_it->getUniqueId()
-                << "': " << except.getName() << " - " << except.getMessage()
-                << endl;
-      fit_success = false;
-    }
+        if (add_zeros > 0.0)
+        {
+          MassTrace trace;
+          trace.peaks.reserve(2);
+          trace.theoretical_int = add_zeros;
+          Peak1D peak;
+          peak.setMZ(feat_it->getSubordinates()[0].getMZ());
+          peak.setIntensity(0.0);
+          peaks.push_back(peak);
+          double offset = 0.2 * (region_start - region_end);
+          trace.peaks.push_back(make_pair(region_start - offset, &peaks.back()));
+          trace.peaks.push_back(make_pair(region_end + offset, &peaks.back()));
+          traces.push_back(trace);
+        }
 
-    // record model parameters:
-    double center = fitter->getCenter(), height = fitter->getHeight();
-    feat_it->setMetaValue("model_height", height);
-    feat_it->setMetaValue("model_FWHM", fitter->getFWHM());
-    feat_it->setMetaValue("model_center", center);
-    feat_it->setMetaValue("model_lower", fitter->getLowerRTBound());
-    feat_it->setMetaValue("model_upper", fitter->getUpperRTBound());
-    if (asymmetric)
-    {
-      EGHTraceFitter* egh = static_cast<EGHTraceFitter*>(fitter);
-      feat_it->setMetaValue("model_EGH_tau", egh->getTau());
-      feat_it->setMetaValue("model_EGH_sigma", egh->getSigma());
-    }
-    else
-    {
-      GaussTraceFitter* gauss = static_cast<GaussTraceFitter*>(fitter);
-      feat_it->setMetaValue("model_Gauss_sigma", gauss->getSigma());
-    }
+        // fit the model:
+        bool fit_success = true;
+        try
+        {
+          fitter->fit(traces);
+        }
+        catch (Exception::UnableToFit& except)
+        {
+          LOG_ERROR << "Error fitting model to feature '" << feat_it->getUniqueId()
+                    << "': " << except.getName() << " - " << except.getMessage()
+                    << endl;
+          fit_success = false;
+        }
 
-    // goodness of fit:
-    double mre = -1.0; // mean relative error
-    if (fit_success)
-    {
-      mre = calculateFitQuality_(fitter, traces);
-    }
-    feat_it->setMetaValue("model_error", mre);
+        // record model parameters:
+        double center = fitter->getCenter(), height = fitter->getHeight();
+        feat_it->setMetaValue("model_height", height);
+        feat_it->setMetaValue("model_FWHM", fitter->getFWHM());
+        feat_it->setMetaValue("model_center", center);
+        feat_it->setMetaValue("model_lower", fitter->getLowerRTBound());
+        feat_it->setMetaValue("model_upper", fitter->getUpperRTBound());
+        if (asymmetric)
+        {
+          EGHTraceFitter* egh = static_cast<EGHTraceFitter*>(fitter);
+          feat_it->setMetaValue("model_EGH_tau", egh->getTau());
+          feat_it->setMetaValue("model_EGH_sigma", egh->getSigma());
+        }
+        else
+        {
+          GaussTraceFitter* gauss = static_cast<GaussTraceFitter*>(fitter);
+          feat_it->setMetaValue("model_Gauss_sigma", gauss->getSigma());
+        }
 
-    // check model validity:
-    double area = fitter->getArea();
-    feat_it->setMetaValue("model_area", area);
-    if ((area != area) || (area <= area_limit)) // x != x: test for NaN
-    {
-      feat_it->setMetaValue("model_status", "1 (invalid area)");
-    }
-    else if ((center <= region_start) || (center >= region_end))
-    {
-      feat_it->setMetaValue("model_status", "2 (center out of bounds)");
-    }
-    else if (fitter->getValue(region_start) > check_boundaries * height)
-    {
-      feat_it->setMetaValue("model_status", "3 (left side out of bounds)");
-    }
-    else if (fitter->getValue(region_end) > check_boundaries * height)
-    {
-      feat_it->setMetaValue("model_status", "4 (right side out of bounds)");
-    }
-    else
-    {
-      feat_it->setMetaValue("model_status", "0 (valid)");
-      // store model parameters to find outliers later:
-      if (asymmetric)
-      {
-        double sigma = feat_it->getMetaValue("model_EGH_sigma");
-        double abs_tau = fabs(double(feat_it->getMetaValue("model_EGH_tau")));
-        if (width_limit > 0)
+        // goodness of fit:
+        double mre = -1.0; // mean relative error
+        if (fit_success)
+        {
+          mre = calculateFitQuality_(fitter, traces);
+        }
+        feat_it->setMetaValue("model_error", mre);
+
+        // check model validity:
+        double area = fitter->getArea();
+        feat_it->setMetaValue("model_area", area);
+        if ((area != area) || (area <= area_limit)) // x != x: test for NaN
+        {
+          feat_it->setMetaValue("model_status", "1 (invalid area)");
+        }
+        else if ((center <= region_start) || (center >= region_end))
+        {
+          feat_it->setMetaValue("model_status", "2 (center out of bounds)");
+        }
+        else if (fitter->getValue(region_start) > check_boundaries * height)
         {
-          // see implementation of "EGHTraceFitter::getArea":
-          double width = sigma * 0.6266571 + abs_tau;
-          widths_all[index] = width;
-          widths_good.push_back(width);
+          feat_it->setMetaValue("model_status", "3 (left side out of bounds)");
         }
-        if (asym_limit > 0)
+        else if (fitter->getValue(region_end) > check_boundaries * height)
         {
-          double asymmetry = abs_tau / sigma;
-          asym_all[index] = asymmetry;
-          asym_good.push_back(asymmetry);
+          feat_it->setMetaValue("model_status", "4 (right side out of bounds)");
+        }
+        else
+        {
+          feat_it->setMetaValue("model_status", "0 (valid)");
+          // store model parameters to find outliers later:
+          if (asymmetric)
+          {
+            double sigma = feat_it->getMetaValue("model_EGH_sigma");
+            double abs_tau = fabs(double(feat_it->getMetaValue("model_EGH_tau")));
+            if (width_limit > 0)
+            {
+              // see implementation of "EGHTraceFitter::getArea":
+              widths_all[index] = sigma * 0.6266571 + abs_tau;
+            }
+            if (asym_limit > 0)
+            {
+              asym_all[index] = abs_tau / sigma;
+            }
+          }
+          else if (width_limit > 0)
+          {
+            widths_all[index] = feat_it->getMetaValue("model_Gauss_sigma");
+          }
         }
       }
-      else if (width_limit > 0)
+      catch (...)
       {
-        double width = feat_it->getMetaValue("model_Gauss_sigma");
-        widths_all[index] = width;
-        widths_good.push_back(width);
+#ifdef _OPENMP
+#pragma omp critical (ElutionModelFitter_error)
+#endif
+        {
+          ++err_count;
+          err = std::current_exception();
+        }
       }
     }
+    delete fitter;
+  }
+  if (err_count != 0) std::rethrow_exception(err);
+
+  // parameters of successful models (in the order of the features):
+  for (Size i = 0; i < widths_all.size(); ++i)
+  {
+    if (widths_all[i] == widths_all[i]) widths_good.push_back(widths_all[i]);
+  }
+  for (Size i = 0; i < asym_all.size(); ++i)
+  {
+    if (asym_all[i] == asym_all[i]) asym_good.push_back(asym_all[i]);
   }
-  delete fitter;
 
   // find outliers in model parameters:
   if (width_limit > 0)
@@ -398,7 +439,7 @@ void ElutionModelFitter::fitElutionModels(FeatureMap& features)
   Size model_successes = 0, model_failures = 0;
 
   for (FeatureMap::Iterator feat_it = features.begin(); 
-       feat_it != features.end(); ++feat_it, ++index)
+       feat_it != features.end(); ++feat_it)
   {
     feat_it->setMetaValue("raw_intensity", feat_it->getIntensity());
     if (String(feat_it->getMetaValue("model_status"))[0] != '0')
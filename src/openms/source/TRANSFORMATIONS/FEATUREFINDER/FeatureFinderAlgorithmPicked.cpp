@@ -600,20 +600,22 @@ namespace OpenMS
       //------------------------------------------------------------------
 
       // We do not want to store features whose seeds lie within other
-      // features with higher intensity. We thus store this information in
-      // the map seeds_in_features which contains for each seed i a vector
-      // of other seeds that are contained in the corresponding feature i.
+      // features with higher intensity. We thus store for each seed i the
+      // other seeds that are contained in the corresponding feature i
+      // (seeds_in_features) and decide after the extension of all seeds
+      // which features to keep.
       //
-      // The features are stored in an temporary feature map until it is
-      // decided whether they are contained within a seed of higher
-      // intensity.
-      std::map<Size, std::vector<Size> > seeds_in_features;
-      typedef std::map<Size, Feature> FeatureMapType;
-      FeatureMapType tmp_feature_map;
+      // All results are written to per-seed slots, so the seeds can be
+      // extended in parallel without synchronization: the feature (if any)
+      // to seed_features[i], the reason for aborting the extension (if any)
+      // to seed_abort_reasons[i].
+      std::vector<std::vector<Size> > seeds_in_features(seeds.size());
+      std::vector<std::vector<Feature> > seed_features(seeds.size());
+      std::vector<String> seed_abort_reasons(seeds.size());
       int gl_progress = 0;
       ff_->startProgress(0, seeds.size(), String("Extending seeds for charge ") + String(c));
 #ifdef _OPENMP
-#pragma omp parallel for
+#pragma omp parallel for schedule(dynamic, 16)
 #endif
       for (SignedSize i = 0; i < (SignedSize)seeds.size(); ++i)
       {
@@ -646,7 +648,7 @@ namespace OpenMS
 
         if (isotope_fit_quality < min_isotope_fit_)
         {
-          abort_(seeds[i], "Could not find good enough isotope pattern containing the seed");
+          seed_abort_reasons[i] = "Could not find good enough isotope pattern containing the seed";
           //continue;
         }
         else
@@ -662,7 +664,7 @@ namespace OpenMS
 
           if (!traces.isValid(seed_mz, trace_tolerance_))
           {
-            abort_(seeds[i], "Could not extend seed");
+            seed_abort_reasons[i] = "Could not extend seed";
             //continue;
           }
           else
@@ -674,11 +676,16 @@ namespace OpenMS
             //------------------------------------------------------------------
             Int plot_nr = -1;
 
+            // the plot number is only needed for debug output (the feature
+            // label is re-set below, when the feature is accepted)
+            if (debug_)
+            {
 #ifdef _OPENMP
 #pragma omp critical (FeatureFinderAlgorithmPicked_PLOTNR)
 #endif
-            {
-              plot_nr = ++plot_nr_global;
+              {
+                plot_nr = ++plot_nr_global;
+              }
             }
 
             //------------------------------------------------------------------
@@ -734,12 +741,12 @@ namespace OpenMS
             double final_score = 0.0;
 
             bool feature_ok = checkFeatureQuality_(fitter, new_traces, seed_mz, min_feature_score, error_msg, fit_score, correlation, final_score);
+            //write debug output of feature
+            if (debug_)
+            {
 #ifdef _OPENMP
 #pragma omp critical (FeatureFinderAlgorithmPicked_DEBUG)
 #endif
-            {
-              //write debug output of feature
-              if (debug_)
               {
                 writeFeatureDebugInfo_(fitter, traces, new_traces, feature_ok, error_msg, final_score, plot_nr, peak);
               }
@@ -750,7 +757,7 @@ namespace OpenMS
             //validity output
             if (!feature_ok)
             {
-              abort_(seeds[i], error_msg);
+              seed_abort_reasons[i] = error_msg;
               //continue;
             }
             else
@@ -820,63 +827,76 @@ namespace OpenMS
                 f.getConvexHulls().push_back(traces[j].getConvexhull());
               }
 
-#ifdef _OPENMP
-#pragma omp critical (FeatureFinderAlgorithmPicked_TMPFEATUREMAP)
-#endif
-              {
-                tmp_feature_map[i] = f;
-              }
-
-              //----------------------------------------------------------------
-              //Remember all seeds that lie inside the convex hull of the new feature
-              DBoundingBox<2> bb = f.getConvexHull().getBoundingBox();
-              for (Size j = i + 1; j < seeds.size(); ++j)
-              {
-                double rt = map_[seeds[j].spectrum].getRT();
-                double mz = map_[seeds[j].spectrum][seeds[j].peak].getMZ();
-                if (bb.encloses(rt, mz) && f.encloses(rt, mz))
-                {
-#ifdef _OPENMP
-#pragma omp critical (FeatureFinderAlgorithmPicked_SEEDSINFEATURES)
-#endif
-                  {
-                    seeds_in_features[i].push_back(j);
-                  }
-                }
-              }
+              seed_features[i].push_back(f);
             }
           }
         } // three if/else statements instead of continue (disallowed in OpenMP)
       } // end of OPENMP over seeds
 
+      // bookkeeping of aborted seeds (in seed order)
+      for (Size i = 0; i < seeds.size(); ++i)
+      {
+        if (!seed_abort_reasons[i].empty())
+        {
+          abort_(seeds[i], seed_abort_reasons[i]);
+        }
+      }
+
+      // Remember all seeds that lie inside the convex hull of each new
+      // feature. Only seeds of lower intensity (higher index) are relevant;
+      // they are looked up in a list of seeds sorted by m/z instead of
+      // testing all of them.
+      std::vector<std::pair<double, Size> > seeds_by_mz;
+      seeds_by_mz.reserve(seeds.size());
+      for (Size i = 0; i < seeds.size(); ++i)
+      {
+        seeds_by_mz.push_back(std::make_pair(map_[seeds[i].spectrum][seeds[i].peak].getMZ(), i));
+      }
+      std::sort(seeds_by_mz.begin(), seeds_by_mz.end());
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic, 16)
+#endif
+      for (SignedSize i = 0; i < (SignedSize)seeds.size(); ++i)
+      {
+        if (seed_features[i].empty()) continue;
+        const Feature& f = seed_features[i][0];
+        DBoundingBox<2> bb = f.getConvexHull().getBoundingBox();
+        std::vector<std::pair<double, Size> >::const_iterator it =
+          std::lower_bound(seeds_by_mz.begin(), seeds_by_mz.end(), std::make_pair(bb.minY(), Size(0)));
+        for (; it != seeds_by_mz.end() && it->first <= bb.maxY(); ++it)
+        {
+          Size j = it->second;
+          if (j <= (Size)i) continue;
+          double rt = map_[seeds[j].spectrum].getRT();
+          double mz = it->first;
+          if (bb.encloses(rt, mz) && f.encloses(rt, mz))
+          {
+            seeds_in_features[i].push_back(j);
+          }
+        }
+      }
+
       // Here we have to evaluate which seeds are already contained in
       // features of seeds with higher intensities. Only if the seed is not
       // used in any feature with higher intensity, we can add it to the
       // features_ list.
-      std::vector<Size> seeds_contained;
-      for (std::map<Size, Feature>::iterator iter = tmp_feature_map.begin(); iter != tmp_feature_map.end(); ++iter)
+      std::vector<bool> seeds_contained(seeds.size(), false);
+      for (Size seed_nr = 0; seed_nr < seeds.size(); ++seed_nr)
       {
-        Size seed_nr = iter->first;
-        bool is_used = false;
-        for (Size i = 0; i < seeds_contained.size(); ++i)
-        {
-          if (seed_nr == seeds_contained[i]) { is_used = true; break; }
-        }
-        if (!is_used)
-        {
-          ++feature_candidates;
+        if (seed_features[seed_nr].empty() || seeds_contained[seed_nr]) continue;
 
-          //re-set label
-          iter->second.setMetaValue(3, feature_nr_global);
-          ++feature_nr_global;
-          features_->push_back(iter->second);
+        ++feature_candidates;
 
-          std::vector<Size> curr_seed = seeds_in_features[seed_nr];
-          for (Size k = 0; k < curr_seed.size(); ++k)
-          {
-            seeds_contained.push_back(curr_seed[k]);
+        //re-set label
+        Feature& f = seed_features[seed_nr][0];
+        f.setMetaValue(3, feature_nr_global);
+        ++feature_nr_global;
+        features_->push_back(f);
 
-          }
+        const std::vector<Size>& curr_seed = seeds_in_features[seed_nr];
+        for (Size k = 0; k < curr_seed.size(); ++k)
+        {
+          seeds_contained[curr_seed[k]] = true;
         }
       }
 
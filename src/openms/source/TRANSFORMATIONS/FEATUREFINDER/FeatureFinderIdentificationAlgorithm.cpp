@@ -47,6 +47,8 @@
 #include <OpenMS/CHEMISTRY/ISOTOPEDISTRIBUTION/IsotopeDistribution.h>
 #include <OpenMS/FORMAT/FeatureXMLFile.h>
 
+#include <boost/numeric/conversion/cast.hpp>
+
 #include <vector>
 #include <numeric>
 #include <fstream>
@@ -61,7 +63,8 @@ using namespace std;
 namespace OpenMS
 {
   FeatureFinderIdentificationAlgorithm::FeatureFinderIdentificationAlgorithm() :
-    DefaultParamHandler("FeatureFinderIdentificationAlgorithm")
+    DefaultParamHandler("FeatureFinderIdentificationAlgorithm"),
+    keep_log_streams_(false)
   {
     StringList output_file_tags;
     output_file_tags.push_back("output file");
@@ -179,6 +182,17 @@ namespace OpenMS
                                         OPENMS_PRETTY_FUNCTION, msg);
     }
 
+    // reset results of previous runs (this object may be used repeatedly):
+    library_ = TargetedExperiment();
+    chrom_data_.clear(true);
+    isotope_probs_.clear();
+    svm_probs_internal_.clear();
+    svm_probs_external_.clear();
+    n_internal_features_ = n_external_features_ = 0;
+    trafo_external_ = TransformationDescription();
+    rt_window_ = param_.getValue("extract:rt_window");
+    min_peak_width_ = param_.getValue("detect:min_peak_width");
+
     // initialize algorithm classes needed later:
     Param params = feat_finder_.getParameters();
     params.setValue("stop_report_after_feature", -1); // return all features
@@ -289,10 +303,11 @@ namespace OpenMS
 
     LOG_INFO << "Detecting chromatographic peaks..." << endl;
     // suppress status output from OpenSWATH, unless in debug mode:
-    if (debug_level_ < 1) Log_info.remove(cout);
+    bool change_log = (debug_level_ < 1) && !keep_log_streams_;
+    if (change_log) Log_info.remove(cout);
     feat_finder_.pickExperiment(chrom_data_, features, library_,
                                 TransformationDescription(), ms_data_);
-    if (debug_level_ < 1) Log_info.insert(cout); // revert logging change
+    if (change_log) Log_info.insert(cout); // revert logging change
     LOG_INFO << "Found " << features.size() << " feature candidates in total."
              << endl;
     ms_data_.reset(); // not needed anymore, free up the memory
@@ -321,6 +336,101 @@ namespace OpenMS
     features.ensureUniqueId();
   }
 
+  void FeatureFinderIdentificationAlgorithm::runCohort(
+    vector<PeakMap>& ms_data,
+    const vector<vector<PeptideIdentification> >& peptides,
+    const vector<vector<ProteinIdentification> >& proteins,
+    const vector<PeptideIdentification>& peptides_ext,
+    const vector<ProteinIdentification>& proteins_ext,
+    vector<FeatureMap>& features)
+  {
+    if ((peptides.size() != ms_data.size()) ||
+        (proteins.size() != ms_data.size()))
+    {
+      String msg = "Numbers of LC-MS runs (" + String(ms_data.size()) +
+        ") and of peptide/protein ID sets (" + String(peptides.size()) + "/" +
+        String(proteins.size()) + ") do not match.";
+      throw Exception::IllegalArgument(__FILE__, __LINE__,
+                                       OPENMS_PRETTY_FUNCTION, msg);
+    }
+
+    // the isotope distributions (unlike the RT regions) do not depend on the
+    // run, so compute them once for the best hits of all IDs:
+    set<AASequence> sequences;
+    vector<const vector<PeptideIdentification>*> all_peptides(1, &peptides_ext);
+    for (Size i = 0; i < peptides.size(); ++i)
+    {
+      all_peptides.push_back(&peptides[i]);
+    }
+    for (Size i = 0; i < all_peptides.size(); ++i)
+    {
+      for (vector<PeptideIdentification>::const_iterator pep_it =
+             all_peptides[i]->begin(); pep_it != all_peptides[i]->end(); ++pep_it)
+      {
+        const vector<PeptideHit>& hits = pep_it->getHits();
+        if (hits.empty()) continue;
+        bool higher_better = pep_it->isHigherScoreBetter();
+        vector<PeptideHit>::const_iterator best = hits.begin();
+        for (vector<PeptideHit>::const_iterator hit_it = hits.begin() + 1;
+             hit_it != hits.end(); ++hit_it)
+        {
+          if (higher_better ? (hit_it->getScore() > best->getScore()) :
+              (hit_it->getScore() < best->getScore()))
+          {
+            best = hit_it;
+          }
+        }
+        sequences.insert(best->getSequence());
+      }
+    }
+    LOG_INFO << "Computing isotope distributions for " << sequences.size()
+             << " peptide(s)..." << endl;
+    cacheIsotopeDistributions_(vector<AASequence>(sequences.begin(),
+                                                  sequences.end()));
+
+    features.clear();
+    features.resize(ms_data.size());
+    // suppress status output from OpenSWATH once for all runs (the workers
+    // must not change the global log streams concurrently):
+    if (debug_level_ < 1) Log_info.remove(cout);
+    Size err_count(0);
+    std::exception_ptr err;
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic)
+#endif
+    for (SignedSize i = 0; i < boost::numeric_cast<SignedSize>(ms_data.size()); ++i)
+    {
+      try
+      {
+        // runs are independent, every worker gets its own instance of the
+        // algorithm (with a copy of the isotope distributions):
+        FeatureFinderIdentificationAlgorithm worker;
+        worker.setParameters(param_);
+        worker.feat_finder_.setParameters(feat_finder_.getParameters());
+        worker.getProgressLogger().setLogType(prog_log_.getLogType());
+        worker.iso_dist_cache_ = iso_dist_cache_;
+        worker.keep_log_streams_ = true;
+        worker.candidates_out_.clear();
+        worker.svm_xval_out_.clear();
+        worker.ms_data_.swap(ms_data[i]);
+        worker.run(peptides[i], proteins[i], peptides_ext, proteins_ext,
+                   features[i]);
+      }
+      catch (...)
+      {
+#ifdef _OPENMP
+#pragma omp critical (FeatureFinderIdentificationAlgorithm_error)
+#endif
+        {
+          ++err_count;
+          err = std::current_exception();
+        }
+      }
+    }
+    if (debug_level_ < 1) Log_info.insert(cout); // revert logging change
+    if (err_count != 0) std::rethrow_exception(err);
+  }
+
   void FeatureFinderIdentificationAlgorithm::postProcess_(
    FeatureMap & features,
    bool with_external_ids)
@@ -464,6 +574,15 @@ namespace OpenMS
   {
     std::set<String> protein_accessions;
 
+    vector<AASequence> sequences;
+    sequences.reserve(peptide_map.size());
+    for (PeptideMap::const_iterator pm_it = peptide_map.begin();
+         pm_it != peptide_map.end(); ++pm_it)
+    {
+      sequences.push_back(pm_it->first);
+    }
+    cacheIsotopeDistributions_(sequences);
+
     for (PeptideMap::iterator pm_it = peptide_map.begin();
          pm_it != peptide_map.end(); ++pm_it)
     {
@@ -500,15 +619,7 @@ namespace OpenMS
                                             current_accessions.end());
 
       // get isotope distribution for peptide:
-      Size n_isotopes = (isotope_pmin_ > 0.0) ? 10 : n_isotopes_;
-      IsotopeDistribution iso_dist = 
-        seq.getFormula(Residue::Full, 0).getIsotopeDistribution(CoarseIsotopePatternGenerator(n_isotopes));
-      if (isotope_pmin_ > 0.0)
-      {
-        iso_dist.trimLeft(isotope_pmin_);
-        iso_dist.trimRight(isotope_pmin_);
-        iso_dist.renormalize();
-      }
+      const IsotopeDistribution& iso_dist = iso_dist_cache_[seq];
 
       // get regions in which peptide elutes (ideally only one):
       std::vector<RTRegion> rt_regions;
@@ -570,6 +681,39 @@ namespace OpenMS
     }
   }
 
+  void FeatureFinderIdentificationAlgorithm::cacheIsotopeDistributions_(
+    const vector<AASequence>& sequences)
+  {
+    vector<AASequence> missing;
+    for (vector<AASequence>::const_iterator seq_it = sequences.begin();
+         seq_it != sequences.end(); ++seq_it)
+    {
+      if (!iso_dist_cache_.count(*seq_it)) missing.push_back(*seq_it);
+    }
+
+    vector<IsotopeDistribution> iso_dists(missing.size());
+    Size n_isotopes = (isotope_pmin_ > 0.0) ? 10 : n_isotopes_;
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic, 100)
+#endif
+    for (SignedSize i = 0; i < boost::numeric_cast<SignedSize>(missing.size()); ++i)
+    {
+      IsotopeDistribution& iso_dist = iso_dists[i];
+      iso_dist = missing[i].getFormula(Residue::Full, 0).getIsotopeDistribution(CoarseIsotopePatternGenerator(n_isotopes));
+      if (isotope_pmin_ > 0.0)
+      {
+        iso_dist.trimLeft(isotope_pmin_);
+        iso_dist.trimRight(isotope_pmin_);
+        iso_dist.renormalize();
+      }
+    }
+
+    for (Size i = 0; i < missing.size(); ++i)
+    {
+      iso_dist_cache_.insert(make_pair(missing[i], iso_dists[i]));
+    }
+  }
+
   void FeatureFinderIdentificationAlgorithm::getRTRegions_(
     ChargeMap& peptide_data, 
     std::vector<RTRegion>& rt_regions) const
@@ -975,6 +1119,7 @@ namespace OpenMS
 
     isotope_pmin_ = param_.getValue("extract:isotope_pmin");
     n_isotopes_ = param_.getValue("extract:n_isotopes");
+    iso_dist_cache_.clear(); // depends on the isotope settings
 
     mapping_tolerance_ = param_.getValue("detect:mapping_tolerance");
 
@@ -116,6 +116,39 @@ namespace OpenMS
 
   }
   
+  namespace
+  {
+    /// peak passing the position filter (and the result of sampling the profile data around it)
+    struct ProfileCandidate
+    {
+      /// index of the peak in the white spectrum
+      size_t white_mz_idx;
+      /// peak with satellites (and spline-interpolated satellites, if evaluated)
+      MultiplexFilteredPeak peak;
+      /// was the profile data sampled successfully?
+      bool evaluated;
+    };
+
+    /// check if two peaks have the same set of (centroided) satellites
+    bool sameSatellites(const MultiplexFilteredPeak& peak_1, const MultiplexFilteredPeak& peak_2)
+    {
+      const std::multimap<size_t, MultiplexSatelliteCentroided >& satellites_1 = peak_1.getSatellites();
+      const std::multimap<size_t, MultiplexSatelliteCentroided >& satellites_2 = peak_2.getSatellites();
+      if (satellites_1.size() != satellites_2.size())
+      {
+        return false;
+      }
+      for (std::multimap<size_t, MultiplexSatelliteCentroided >::const_iterator it_1 = satellites_1.begin(), it_2 = satellites_2.begin(); it_1 != satellites_1.end(); ++it_1, ++it_2)
+      {
+        if ((it_1->first != it_2->first) || (it_1->second.getRTidx() != it_2->second.getRTidx()) || (it_1->second.getMZidx() != it_2->second.getMZidx()))
+        {
+          return false;
+        }
+      }
+      return true;
+    }
+  }
+
   vector<MultiplexFilteredMSExperiment> MultiplexFilteringProfile::filter()
   {
     // progress logger
@@ -139,108 +172,120 @@ namespace OpenMS
     }
     
     // loop over all patterns
+    // (The patterns need to be processed in order, since peaks found for one pattern are blacklisted for all following patterns.)
     for (unsigned pattern_idx = 0; pattern_idx < patterns_.size(); ++pattern_idx)
     {
       // current pattern
-      MultiplexIsotopicPeakPattern pattern = patterns_[pattern_idx];
+      const MultiplexIsotopicPeakPattern& pattern = patterns_[pattern_idx];
       
       // data structure storing peaks which pass all filters
       MultiplexFilteredMSExperiment result;
 
       // update white experiment
       updateWhiteMSExperiment_();
-      
-      // loop over spectra
-      // loop simultaneously over RT in the spline interpolated profile and (white) centroided experiment (including peak boundaries)
-      for (const auto &it_rt : exp_centroided_white_)
+
+      // Step 1:
+      // Filter all peaks against the blacklist at the start of this pattern and sample the profile data around the peaks
+      // which pass the position filter. This is the expensive part, and the spectra are independent, so we process them
+      // in parallel. (The navigators store the last position, so each thread needs its own.)
+      std::vector<std::vector<ProfileCandidate> > candidates(exp_centroided_white_.size());
+#ifdef _OPENMP
+#pragma omp parallel
+#endif
       {
-        // retention time
-        double rt = it_rt.getRT();
-        // spectral index in exp_centroided_white_, boundaries_ and exp_spline_profile_
-        size_t idx_rt = &it_rt - &exp_centroided_white_[0];
-        
+        std::vector<SplineSpectrum::Navigator> thread_navigators(navigators);
+#ifdef _OPENMP
+#pragma omp for schedule(dynamic)
+#endif
+        for (SignedSize idx_rt = 0; idx_rt < (SignedSize)exp_centroided_white_.size(); ++idx_rt)
+        {
+          const MSSpectrum& spectrum = exp_centroided_white_[idx_rt];
+          
+          // skip empty spectra
+          if (spectrum.size() == 0 || boundaries_[idx_rt].size() == 0 || exp_spline_profile_[idx_rt].size() == 0)
+          {
+            continue;
+          }
+
+          double rt = spectrum.getRT();
+          MSExperiment::ConstIterator it_rt_picked_band_begin = exp_centroided_white_.RTBegin(rt - rt_band_/2);
+          MSExperiment::ConstIterator it_rt_picked_band_end = exp_centroided_white_.RTEnd(rt + rt_band_/2);
+
+          for (MSSpectrum::ConstIterator it_mz = spectrum.begin(); it_mz != spectrum.end(); ++it_mz)
+          {
+            size_t white_mz_idx = it_mz - spectrum.begin();
+            MultiplexFilteredPeak peak(it_mz->getMZ(), rt, exp_centroided_mapping_[idx_rt][white_mz_idx], idx_rt);
+            if (!(filterPeakPositions_(it_mz, exp_centroided_white_.begin(), it_rt_picked_band_begin, it_rt_picked_band_end, pattern, peak)))
+            {
+              continue;
+            }
+
+            ProfileCandidate candidate = {white_mz_idx, peak, true};
+            try
+            {
+              filterProfile_(pattern, candidate.peak, thread_navigators);
+            }
+            catch (...)
+            {
+              // repeated (and the exception thrown) in step 2, if this peak is still relevant then
+              candidate.evaluated = false;
+            }
+            candidates[idx_rt].push_back(candidate);
+          }
+        }
+      }
+
+      // Step 2:
+      // Go through the peaks in order and accept or blacklist them exactly as if they were processed one by one. As long as
+      // no peak has been blacklisted, the results of step 1 are final. Afterwards, the position filter is repeated with the
+      // current blacklist. Only if it yields different satellites, the profile data have to be sampled again.
+      bool blacklist_changed = false;
+      for (size_t idx_rt = 0; idx_rt < exp_centroided_white_.size(); ++idx_rt)
+      {
+        const MSSpectrum& spectrum = exp_centroided_white_[idx_rt];
+
         // skip empty spectra
-        if (it_rt.size() == 0 || boundaries_[idx_rt].size() == 0 || exp_spline_profile_[idx_rt].size() == 0)
+        if (spectrum.size() == 0 || boundaries_[idx_rt].size() == 0 || exp_spline_profile_[idx_rt].size() == 0)
         {
           continue;
         }
         
         setProgress(++progress);
         
+        double rt = spectrum.getRT();
         MSExperiment::ConstIterator it_rt_picked_band_begin = exp_centroided_white_.RTBegin(rt - rt_band_/2);
         MSExperiment::ConstIterator it_rt_picked_band_end = exp_centroided_white_.RTEnd(rt + rt_band_/2);
         
         // loop over mz
-        for (MSSpectrum::ConstIterator it_mz = it_rt.begin(); it_mz != it_rt.end(); ++it_mz)
+        std::vector<ProfileCandidate>::const_iterator it_candidate = candidates[idx_rt].begin();
+        for (MSSpectrum::ConstIterator it_mz = spectrum.begin(); it_mz != spectrum.end(); ++it_mz)
         {
-          double mz = it_mz->getMZ();
-          MultiplexFilteredPeak peak(mz, rt, exp_centroided_mapping_[idx_rt][it_mz - it_rt.begin()], idx_rt);
-          
-          if (!(filterPeakPositions_(it_mz, exp_centroided_white_.begin(), it_rt_picked_band_begin, it_rt_picked_band_end, pattern, peak)))
+          size_t white_mz_idx = it_mz - spectrum.begin();
+          const ProfileCandidate* candidate = nullptr;
+          if (it_candidate != candidates[idx_rt].end() && it_candidate->white_mz_idx == white_mz_idx)
           {
-            continue;
+            candidate = &(*it_candidate);
+            ++it_candidate;
           }
-          
-          size_t mz_idx = exp_centroided_mapping_[idx_rt][it_mz - it_rt.begin()];
-          double peak_min = boundaries_[idx_rt][mz_idx].mz_min;
-          double peak_max = boundaries_[idx_rt][mz_idx].mz_max;
-          
-          //double rt_peak = peak.getRT();
-          double mz_peak = peak.getMZ();
 
-          std::multimap<size_t, MultiplexSatelliteCentroided > satellites = peak.getSatellites();
-          
-          // Arrangement of peaks looks promising. Now scan through the spline fitted profile data around the peak i.e. from peak boundary to peak boundary.
-          for (double mz_profile = peak_min; mz_profile < peak_max; mz_profile = navigators[idx_rt].getNextMz(mz_profile))
+          MultiplexFilteredPeak peak(it_mz->getMZ(), rt, exp_centroided_mapping_[idx_rt][white_mz_idx], idx_rt);
+          bool positions_ok = (candidate != nullptr);
+          if (blacklist_changed || (candidate != nullptr && !candidate->evaluated))
           {
-            // determine m/z shift relative to the centroided peak at which the profile data will be sampled
-            double mz_shift = mz_profile - mz_peak;
-
-            std::multimap<size_t, MultiplexSatelliteProfile > satellites_profile;
+            positions_ok = filterPeakPositions_(it_mz, exp_centroided_white_.begin(), it_rt_picked_band_begin, it_rt_picked_band_end, pattern, peak);
+          }
+          if (!positions_ok)
+          {
+            continue;
+          }
 
-            // construct the set of spline-interpolated satellites for this specific mz_profile
-            for (const auto &satellite_it : satellites)
-            {
-              // find indices of the peak
-              size_t rt_idx = (satellite_it.second).getRTidx();
-              size_t mz_idx = (satellite_it.second).getMZidx();
-              
-              // find peak itself
-              MSExperiment::ConstIterator it_rt = exp_centroided_.begin();
-              std::advance(it_rt, rt_idx);
-              MSSpectrum::ConstIterator it_mz = it_rt->begin();
-              std::advance(it_mz, mz_idx);
-              
-              double rt_satellite = it_rt->getRT();
-              double mz_satellite = it_mz->getMZ();
-              
-              // determine m/z and corresponding intensity
-              double mz = mz_satellite + mz_shift;
-              double intensity = navigators[rt_idx].eval(mz);
-              
-              satellites_profile.insert(std::make_pair(satellite_it.first, MultiplexSatelliteProfile(rt_satellite, mz, intensity)));
-            }
-            
-            if (!(filterAveragineModel_(pattern, peak, satellites_profile)))
-            {
-              continue;
-            }
-            
-            if (!(filterPeptideCorrelation_(pattern, satellites_profile)))
-            {
-              continue;
-            }
-            
-            /**
-             * All filters passed.
-             */
-            
-            // add the satellite data points to the peak
-            for (const auto &it : satellites_profile)
-            {
-              peak.addSatelliteProfile(it.second, it.first);
-            }
-            
+          if (candidate != nullptr && candidate->evaluated && (!blacklist_changed || sameSatellites(candidate->peak, peak)))
+          {
+            peak = candidate->peak;
+          }
+          else
+          {
+            filterProfile_(pattern, peak, navigators);
           }
           
           // If some satellite data points passed all filters, we can add the peak to the filter result.
@@ -248,6 +293,7 @@ namespace OpenMS
           {
             result.addPeak(peak);
             blacklistPeak_(peak, pattern_idx);
+            blacklist_changed = true;
           }
           
         }
@@ -274,36 +320,102 @@ namespace OpenMS
 
     return filter_results;
   }
+
+  void MultiplexFilteringProfile::filterProfile_(const MultiplexIsotopicPeakPattern& pattern, MultiplexFilteredPeak& peak, std::vector<SplineSpectrum::Navigator>& navigators) const
+  {
+    size_t idx_rt = peak.getRTidx();
+    size_t mz_idx = peak.getMZidx();
+    double peak_min = boundaries_[idx_rt][mz_idx].mz_min;
+    double peak_max = boundaries_[idx_rt][mz_idx].mz_max;
+    double mz_peak = peak.getMZ();
+
+    // The averagine distribution only depends on the peak (not on the position in the profile), so we calculate it only once.
+    IsotopeDistribution distribution = getAveragineDistribution_(mz_peak * pattern.getCharge());
+
+    // positions of the satellites (i.e. of the centroided peaks), each satellite is sampled at the same m/z shifts
+    struct SatellitePosition
+    {
+      size_t idx_masstrace;
+      size_t rt_idx;
+      double rt;
+      double mz;
+    };
+    std::vector<SatellitePosition> satellites;
+    satellites.reserve(peak.getSatellites().size());
+    for (const auto &satellite_it : peak.getSatellites())
+    {
+      size_t rt_idx = (satellite_it.second).getRTidx();
+      const MSSpectrum& spectrum = exp_centroided_[rt_idx];
+      SatellitePosition position = {satellite_it.first, rt_idx, spectrum.getRT(), spectrum[(satellite_it.second).getMZidx()].getMZ()};
+      satellites.push_back(position);
+    }
+    
+    // Arrangement of peaks looks promising. Now scan through the spline fitted profile data around the peak i.e. from peak boundary to peak boundary.
+    for (double mz_profile = peak_min; mz_profile < peak_max; mz_profile = navigators[idx_rt].getNextMz(mz_profile))
+    {
+      // determine m/z shift relative to the centroided peak at which the profile data will be sampled
+      double mz_shift = mz_profile - mz_peak;
+
+      std::multimap<size_t, MultiplexSatelliteProfile > satellites_profile;
+
+      // construct the set of spline-interpolated satellites for this specific mz_profile
+      for (const auto &satellite : satellites)
+      {
+        // determine m/z and corresponding intensity
+        double mz = satellite.mz + mz_shift;
+        double intensity = navigators[satellite.rt_idx].eval(mz);
+        
+        satellites_profile.insert(std::make_pair(satellite.idx_masstrace, MultiplexSatelliteProfile(satellite.rt, mz, intensity)));
+      }
+      
+      if (!(filterAveragineModel_(pattern, distribution, satellites_profile)))
+      {
+        continue;
+      }
+      
+      if (!(filterPeptideCorrelation_(pattern, satellites_profile)))
+      {
+        continue;
+      }
+      
+      /**
+       * All filters passed.
+       */
+      
+      // add the satellite data points to the peak
+      for (const auto &it : satellites_profile)
+      {
+        peak.addSatelliteProfile(it.second, it.first);
+      }
+      
+    }
+  }
   
   std::vector<std::vector<PeakPickerHiRes::PeakBoundary> >& MultiplexFilteringProfile::getPeakBoundaries()
   {
     return boundaries_;
   }
 
-  bool MultiplexFilteringProfile::filterAveragineModel_(const MultiplexIsotopicPeakPattern& pattern, const MultiplexFilteredPeak& peak, const std::multimap<size_t, MultiplexSatelliteProfile >& satellites_profile) const
+  IsotopeDistribution MultiplexFilteringProfile::getAveragineDistribution_(double mass) const
   {
-    // construct averagine distribution
-    // Note that the peptide(s) are very close in mass. We therefore calculate the averagine distribution only once (for the lightest peptide).
-    double mass = peak.getMZ() * pattern.getCharge();
     CoarseIsotopePatternGenerator solver(isotopes_per_peptide_max_);
-    IsotopeDistribution distribution;
     if (averagine_type_ == "peptide")
     {
-      distribution = solver.estimateFromPeptideWeight(mass);
+      return solver.estimateFromPeptideWeight(mass);
     }
     else if (averagine_type_ == "RNA")
     {
-      distribution = solver.estimateFromRNAWeight(mass);
+      return solver.estimateFromRNAWeight(mass);
     }
     else if (averagine_type_ == "DNA")
     {
-      distribution = solver.estimateFromDNAWeight(mass);
+      return solver.estimateFromDNAWeight(mass);
     }
-    else
-    {
-      throw Exception::InvalidParameter(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "Invalid averagine type.");
-    }   
-    
+    throw Exception::InvalidParameter(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "Invalid averagine type.");
+  }
+
+  bool MultiplexFilteringProfile::filterAveragineModel_(const MultiplexIsotopicPeakPattern& pattern, const IsotopeDistribution& distribution, const std::multimap<size_t, MultiplexSatelliteProfile >& satellites_profile) const
+  {
     // loop over peptides
     for (size_t peptide = 0; peptide < pattern.getMassShiftCount(); ++peptide)
     {
@@ -330,7 +442,7 @@ namespace OpenMS
         
         if (count > 0)
         {
-          intensities_model.push_back(distribution[isotope].getIntensity());
+          intensities_model.push_back(distribution.getContainer()[isotope].getIntensity());
           intensities_data.push_back(sum_intensities/count);
         }
         
@@ -354,7 +466,7 @@ namespace OpenMS
     return true;
   }
   
-  bool MultiplexFilteringProfile::filterPeptideCorrelation_(const MultiplexIsotopicPeakPattern& pattern, const std::multimap<size_t, MultiplexSatelliteProfile > satellites_profile) const
+  bool MultiplexFilteringProfile::filterPeptideCorrelation_(const MultiplexIsotopicPeakPattern& pattern, const std::multimap<size_t, MultiplexSatelliteProfile >& satellites_profile) const
   {
     if (pattern.getMassShiftCount() < 2)
     {
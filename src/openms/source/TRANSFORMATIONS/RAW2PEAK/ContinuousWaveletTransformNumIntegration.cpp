@@ -81,6 +81,7 @@ namespace OpenMS
     // will set members for scale_ and spacing_
     ContinuousWaveletTransform::init(scale, spacing);
     int number_of_points = (int)(ceil(5 * scale_ / spacing_)) + 1;
+    wavelet_.clear();
     wavelet_.reserve(number_of_points);
     wavelet_.push_back(1.);
 
@@ -36,9 +36,12 @@
 #include <OpenMS/TRANSFORMATIONS/RAW2PEAK/PeakPickerCWT.h>
 
 #include <OpenMS/FILTERING/NOISEESTIMATION/SignalToNoiseEstimatorMeanIterative.h>
+#include <OpenMS/FILTERING/NOISEESTIMATION/SignalToNoiseEstimatorMedianRolling.h>
 #include <OpenMS/TRANSFORMATIONS/RAW2PEAK/TwoDOptimization.h>
 #include <OpenMS/FILTERING/TRANSFORMERS/TICFilter.h>
 
+#include <memory>
+
 #ifdef _OPENMP
 #ifdef OPENMS_WINDOWSPLATFORM
 #include <omp.h>
@@ -62,6 +65,8 @@ namespace OpenMS
   {
     defaults_.setValue("signal_to_noise", 1.0, "Minimal signal to noise ratio for a peak to be picked.");
     defaults_.setMinFloat("signal_to_noise", 0.0);
+    defaults_.setValue("signal_to_noise_estimator", "mean_iterative", "Method used for the signal-to-noise estimation: 'mean_iterative' (SignalToNoiseEstimatorMeanIterative) or 'median_rolling', the exact median of each sliding window (SignalToNoiseEstimatorMedianRolling, faster on dense spectra; only 'win_len', 'min_required_elements' and 'noise_for_empty_window' of 'SignalToNoiseEstimationParameter' apply).", ListUtils::create<String>("advanced"));
+    defaults_.setValidStrings("signal_to_noise_estimator", ListUtils::create<String>("mean_iterative,median_rolling"));
     defaults_.setValue("thresholds:peak_bound", 10.0, "Minimal peak intensity.", ListUtils::create<String>("advanced"));
     defaults_.setMinFloat("thresholds:peak_bound", 0.0);
     defaults_.setValue("thresholds:peak_bound_ms2_level", 10.0, "Minimal peak intensity for MS/MS peaks.", ListUtils::create<String>("advanced"));
@@ -208,6 +213,12 @@ namespace OpenMS
     signal_to_noise_ = (float)param_.getValue("signal_to_noise");
 
     deconvolution_ = param_.getValue("deconvolution:deconvolution").toBool();
+
+    // tabulate the wavelets and compute the peak bounds in the CWT once, they are the same for all spectra
+    ContinuousWaveletTransformNumIntegration wt_ms2;
+    initializeWT_(wt_, peak_bound_, peak_bound_cwt_);
+    initializeWT_(wt_ms2, peak_bound_ms2_level_, peak_bound_ms2_level_cwt_);
+    wt_deconvolution_.init((float)param_.getValue("deconvolution:scaling") / 2, (double)param_.getValue("wavelet_transform:spacing"));
   }
 
   bool PeakPickerCWT::getMaxPosition_(
@@ -702,13 +713,10 @@ namespace OpenMS
 
   bool PeakPickerCWT::deconvolutePeak_(PeakShape & shape, std::vector<PeakShape> & peak_shapes, double peak_bound_cwt) const
   {
-    // scaling for charge one
-    float scaling_DC = (float) param_.getValue("deconvolution:scaling");
     double resolution = 10;
     // init and calculate the transform of the signal in the convoluted region
-    // first take the scaling for charge 2
-    ContinuousWaveletTransformNumIntegration wtDC;
-    wtDC.init(scaling_DC / 2, (double)param_.getValue("wavelet_transform:spacing"));
+    // first take the scaling for charge 2 (the wavelet is tabulated in updateMembers_())
+    ContinuousWaveletTransformNumIntegration wtDC(wt_deconvolution_);
     wtDC.transform(shape.getLeftEndpoint(), shape.getRightEndpoint(), resolution);
     
 #ifdef DEBUG_DECONV
@@ -1057,21 +1065,15 @@ namespace OpenMS
     output.resize(input.size());
     // pick peaks on each scan
     startProgress(0, input.size(), "picking peaks");
-    Size progress = 0;
 #ifdef _OPENMP
-#pragma omp parallel for
+#pragma omp parallel for schedule(dynamic)
 #endif
     for (SignedSize i = 0; i < (SignedSize)input.size(); ++i)
     {
       // pick the peaks in scan i
       // this is needed to eliminate empty spectra in the end
       pick(input[i], output[i]);
-#ifdef _OPENMP
-#pragma omp critical (PeakPickerCWT_PickExperiment)
-#endif
-      {
-        setProgress(++progress);             //do not use 'i' here, as each thread will be assigned different blocks
-      }
+      nextProgress();             //do not use 'i' here, as each thread will be assigned different blocks
     }
     //optimize peak positions
     if (two_d_optimization_ || optimization_)
@@ -1111,13 +1113,11 @@ namespace OpenMS
     output.getFloatDataArrays()[5].setName("peakShape");
     output.getFloatDataArrays()[6].setName("SignalToNoise");
 
-    /// The continuous wavelet "transformer"
-    ContinuousWaveletTransformNumIntegration wt;
+    /// The continuous wavelet "transformer" (with the wavelet tabulated in updateMembers_())
+    ContinuousWaveletTransformNumIntegration wt(wt_);
     /// The minimal height which defines a peak in the CWT
-    double peak_bound_ms_cwt = 0.0;
+    double peak_bound_ms_cwt = (input.getMSLevel() <= 1 ? peak_bound_cwt_ : peak_bound_ms2_level_cwt_);
     double bound = (input.getMSLevel() <= 1 ? peak_bound_ : peak_bound_ms2_level_);
-    // now initialize every time as every spectrum is picked with its own cwt
-    initializeWT_(wt, bound, peak_bound_ms_cwt);
 
     //create the peak shapes vector
     std::vector<PeakShape> peak_shapes;
@@ -1133,8 +1133,23 @@ namespace OpenMS
     // copy the profile data into a std::vector<Peak1D>
     MSSpectrum raw_peak_array;
     // signal to noise estimator
-    SignalToNoiseEstimatorMeanIterative<MSSpectrum> sne;
+    std::unique_ptr<SignalToNoiseEstimator<MSSpectrum> > sne_ptr;
     Param sne_param(param_.copy("SignalToNoiseEstimationParameter:", true));
+    if (param_.getValue("signal_to_noise_estimator") == "median_rolling")
+    {
+      sne_ptr.reset(new SignalToNoiseEstimatorMedianRolling<MSSpectrum>());
+      // only pass on the parameters known to the rolling estimator
+      Param rolling_param = sne_ptr->getDefaults();
+      rolling_param.setValue("win_len", sne_param.getValue("win_len"));
+      rolling_param.setValue("min_required_elements", sne_param.getValue("min_required_elements"));
+      rolling_param.setValue("noise_for_empty_window", sne_param.getValue("noise_for_empty_window"));
+      sne_param = rolling_param;
+    }
+    else
+    {
+      sne_ptr.reset(new SignalToNoiseEstimatorMeanIterative<MSSpectrum>());
+    }
+    SignalToNoiseEstimator<MSSpectrum>& sne = *sne_ptr;
     sne.setParameters(sne_param);
 
     raw_peak_array.insert(raw_peak_array.end(), input.begin(), input.end());
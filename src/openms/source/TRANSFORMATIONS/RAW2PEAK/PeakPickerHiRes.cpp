@@ -36,11 +36,15 @@
 #include <OpenMS/TRANSFORMATIONS/RAW2PEAK/PeakPickerHiRes.h>
 
 #include <OpenMS/FILTERING/NOISEESTIMATION/SignalToNoiseEstimatorMedian.h>
+#include <OpenMS/FILTERING/NOISEESTIMATION/SignalToNoiseEstimatorMedianRolling.h>
 #include <OpenMS/KERNEL/OnDiscMSExperiment.h>
 #include <OpenMS/KERNEL/MSChromatogram.h>
 #include <OpenMS/MATH/MISC/SplineBisection.h>
 #include <OpenMS/MATH/MISC/CubicSpline2d.h>
 
+#include <exception>
+#include <memory>
+
 
 using namespace std;
 
@@ -71,6 +75,9 @@ namespace OpenMS
     defaults_.setValue("report_FWHM_unit", "relative", "Unit of FWHM. Either absolute in the unit of input, e.g. 'm/z' for spectra, or relative as ppm (only sensible for spectra, not chromatograms).");
     defaults_.setValidStrings("report_FWHM_unit", ListUtils::create<String>("relative,absolute"));
 
+    defaults_.setValue("signal_to_noise_estimator", "median", "Method used for the signal-to-noise estimation: 'median' uses a histogram of each sliding window (SignalToNoiseEstimatorMedian), 'median_rolling' the exact median of each sliding window (SignalToNoiseEstimatorMedianRolling, faster on dense spectra; only 'win_len', 'min_required_elements', 'noise_for_empty_window' and 'write_log_messages' of the 'SignalToNoise' section apply).", ListUtils::create<String>("advanced"));
+    defaults_.setValidStrings("signal_to_noise_estimator", ListUtils::create<String>("median,median_rolling"));
+
     // parameters for STN estimator
     defaults_.insert("SignalToNoise:", SignalToNoiseEstimatorMedian< MSSpectrum >().getDefaults());
 
@@ -121,12 +128,19 @@ namespace OpenMS
     }
 
     // signal-to-noise estimation
-    SignalToNoiseEstimatorMedian<MSSpectrum > snt;
-    snt.setParameters(param_.copy("SignalToNoise:", true));
-
+    std::unique_ptr<SignalToNoiseEstimator<MSSpectrum> > snt;
     if (signal_to_noise_ > 0.0)
     {
-      snt.init(input);
+      if (rolling_snt_)
+      {
+        snt.reset(new SignalToNoiseEstimatorMedianRolling<MSSpectrum>());
+      }
+      else
+      {
+        snt.reset(new SignalToNoiseEstimatorMedian<MSSpectrum>());
+      }
+      snt->setParameters(snt_param_);
+      snt->init(input);
     }
 
     // find local maxima in profile data
@@ -152,9 +166,9 @@ namespace OpenMS
       double act_snt = 0.0, act_snt_l1 = 0.0, act_snt_r1 = 0.0;
       if (signal_to_noise_ > 0.0)
       {
-        act_snt = snt.getSignalToNoise(input[i]);
-        act_snt_l1 = snt.getSignalToNoise(input[i - 1]);
-        act_snt_r1 = snt.getSignalToNoise(input[i + 1]);
+        act_snt = snt->getSignalToNoise(input[i]);
+        act_snt_l1 = snt->getSignalToNoise(input[i - 1]);
+        act_snt_r1 = snt->getSignalToNoise(input[i + 1]);
       }
 
       // look for peak cores meeting MZ and intensity/SNT criteria
@@ -175,8 +189,8 @@ namespace OpenMS
 
         if (signal_to_noise_ > 0.0)
         {
-          act_snt_l2 = snt.getSignalToNoise(input[i - 2]);
-          act_snt_r2 = snt.getSignalToNoise(input[i + 2]);
+          act_snt_l2 = snt->getSignalToNoise(input[i - 2]);
+          act_snt_r2 = snt->getSignalToNoise(input[i + 2]);
         }
 
         // checking signal-to-noise?
@@ -220,7 +234,7 @@ namespace OpenMS
 
           if (signal_to_noise_ > 0.0)
           {
-            act_snt_lk = snt.getSignalToNoise(input[i - k]);
+            act_snt_lk = snt->getSignalToNoise(input[i - k]);
           }
 
           if ((act_snt_lk >= signal_to_noise_) && 
@@ -261,7 +275,7 @@ namespace OpenMS
 
           if (signal_to_noise_ > 0.0)
           {
-            act_snt_rk = snt.getSignalToNoise(input[i + k]);
+            act_snt_rk = snt->getSignalToNoise(input[i + k]);
           }
 
           if ((act_snt_rk >= signal_to_noise_) && 
@@ -455,12 +469,24 @@ namespace OpenMS
     // resize output with respect to input
     output.resize(input.size());
 
-    Size progress = 0;
     startProgress(0, input.size() + input.getChromatograms().size(), "picking peaks");
 
-    if (input.getNrSpectra() > 0)
+    // Spectra and chromatograms are picked independently (and in parallel);
+    // boundaries are collected per index and appended in input order
+    std::vector<std::vector<PeakBoundary> > boundaries_s(input.size()); // peak boundaries of each spectrum
+    std::vector<char> picked_s(input.size(), false);
+    size_t errCount = 0;
+    std::exception_ptr error;
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic)
+#endif
+    for (SignedSize idx = 0; idx < (SignedSize)input.size(); ++idx)
     {
-      for (Size scan_idx = 0; scan_idx != input.size(); ++scan_idx)
+      // parallel exception catching and re-throwing business
+      if (errCount) continue; // no need to pick further if already an error was encountered
+
+      Size scan_idx = idx;
+      try
       {
         if (ms_levels_.empty()) // auto mode
         {
@@ -471,10 +497,8 @@ namespace OpenMS
           }
           else
           {
-            std::vector<PeakBoundary> boundaries_s; // peak boundaries of a single spectrum
-
-            pick(input[scan_idx], output[scan_idx], boundaries_s);
-            boundaries_spec.push_back(boundaries_s);
+            pick(input[scan_idx], output[scan_idx], boundaries_s[scan_idx]);
+            picked_s[scan_idx] = true;
           }
         }
         else if (!ListUtils::contains(ms_levels_, input[scan_idx].getMSLevel())) // manual mode
@@ -483,9 +507,7 @@ namespace OpenMS
         }
         else
         {
-          std::vector<PeakBoundary> boundaries_s; // peak boundaries of a single spectrum
-
-                                                  // determine type of spectral data (profile or centroided)
+          // determine type of spectral data (profile or centroided)
           SpectrumSettings::SpectrumType spectrum_type = input[scan_idx].getType();
 
           if (spectrum_type == SpectrumSettings::CENTROID && check_spectrum_type)
@@ -493,22 +515,76 @@ namespace OpenMS
             throw OpenMS::Exception::IllegalArgument(__FILE__, __LINE__, __FUNCTION__, "Error: Centroided data provided but profile spectra expected.");
           }
 
-          pick(input[scan_idx], output[scan_idx], boundaries_s);
-          boundaries_spec.push_back(boundaries_s);
+          pick(input[scan_idx], output[scan_idx], boundaries_s[scan_idx]);
+          picked_s[scan_idx] = true;
+        }
+      }
+      catch (...)
+      {
+#ifdef _OPENMP
+#pragma omp critical(HandleException)
+#endif
+        {
+          if (!errCount) error = std::current_exception();
+          ++errCount;
         }
-        setProgress(++progress);
       }
+
+      nextProgress();
     }
 
+    if (errCount != 0)
+    {
+      std::rethrow_exception(error);
+    }
 
-    for (Size i = 0; i < input.getChromatograms().size(); ++i)
+    for (Size scan_idx = 0; scan_idx < input.size(); ++scan_idx)
     {
-      MSChromatogram chromatogram;
-      std::vector<PeakBoundary> boundaries_c; // peak boundaries of a single chromatogram
-      pick(input.getChromatograms()[i], chromatogram, boundaries_c);
-      output.addChromatogram(chromatogram);
-      boundaries_chrom.push_back(boundaries_c);
-      setProgress(++progress);
+      if (picked_s[scan_idx])
+      {
+        boundaries_spec.push_back(std::vector<PeakBoundary>());
+        boundaries_spec.back().swap(boundaries_s[scan_idx]);
+      }
+    }
+
+    const std::vector<MSChromatogram>& input_chroms = input.getChromatograms();
+    std::vector<MSChromatogram> chromatograms(input_chroms.size());
+    std::vector<std::vector<PeakBoundary> > boundaries_c(input_chroms.size()); // peak boundaries of each chromatogram
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic)
+#endif
+    for (SignedSize i = 0; i < (SignedSize)input_chroms.size(); ++i)
+    {
+      if (errCount) continue;
+
+      try
+      {
+        pick(input_chroms[i], chromatograms[i], boundaries_c[i]);
+      }
+      catch (...)
+      {
+#ifdef _OPENMP
+#pragma omp critical(HandleException)
+#endif
+        {
+          if (!errCount) error = std::current_exception();
+          ++errCount;
+        }
+      }
+
+      nextProgress();
+    }
+
+    if (errCount != 0)
+    {
+      std::rethrow_exception(error);
+    }
+
+    for (Size i = 0; i < chromatograms.size(); ++i)
+    {
+      output.addChromatogram(std::move(chromatograms[i]));
+      boundaries_chrom.push_back(std::vector<PeakBoundary>());
+      boundaries_chrom.back().swap(boundaries_c[i]);
     }
     endProgress();
 
@@ -530,7 +606,6 @@ namespace OpenMS
     // copy experimental settings
     static_cast<ExperimentalSettings &>(output) = *input.getExperimentalSettings();
 
-    Size progress = 0;
     startProgress(0, input.size() + input.getNrChromatograms(), "picking peaks");
 
     // resize output with respect to input
@@ -538,44 +613,77 @@ namespace OpenMS
 
     if (input.getNrSpectra() > 0)
     {
-      for (Size scan_idx = 0; scan_idx != input.size(); ++scan_idx)
+      // spectra can be read concurrently from the on-disc experiment
+      size_t errCount = 0;
+      std::exception_ptr error;
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic)
+#endif
+      for (SignedSize idx = 0; idx < (SignedSize)input.size(); ++idx)
       {
-        if (ms_levels_.empty()) //auto mode
-        {
-          MSSpectrum s = input[scan_idx];
-          s.sortByPosition();
+        // parallel exception catching and re-throwing business
+        if (errCount) continue; // no need to pick further if already an error was encountered
 
-          // determine type of spectral data (profile or centroided)
-          SpectrumSettings::SpectrumType spectrumType = s.getType();
-          if (spectrumType == SpectrumSettings::CENTROID)
+        Size scan_idx = idx;
+        try
+        {
+          if (ms_levels_.empty()) //auto mode
           {
-            output[scan_idx] = input[scan_idx];
+            MSSpectrum s = input[scan_idx];
+            s.sortByPosition();
+
+            // determine type of spectral data (profile or centroided)
+            SpectrumSettings::SpectrumType spectrumType = s.getType();
+            if (spectrumType == SpectrumSettings::CENTROID)
+            {
+              output[scan_idx] = std::move(s);
+            }
+            else
+            {
+              pick(s, output[scan_idx]);
+            }
           }
           else
           {
-            pick(s, output[scan_idx]);
+            // manual mode (checks the spectrum itself, the meta data of all spectra is not available for remote files)
+            MSSpectrum s = input[scan_idx];
+            if (!ListUtils::contains(ms_levels_, s.getMSLevel()))
+            {
+              output[scan_idx] = std::move(s);
+            }
+            else
+            {
+              s.sortByPosition();
+
+              // determine type of spectral data (profile or centroided)
+              SpectrumSettings::SpectrumType spectrum_type = s.getType();
+
+              if (spectrum_type == SpectrumSettings::CENTROID && check_spectrum_type)
+              {
+                throw OpenMS::Exception::IllegalArgument(__FILE__, __LINE__, __FUNCTION__, "Error: Centroided data provided but profile spectra expected.");
+              }
+
+              pick(s, output[scan_idx]);
+            }
           }
         }
-        else if (!ListUtils::contains(ms_levels_, input[scan_idx].getMSLevel())) // manual mode
-        {
-          output[scan_idx] = input[scan_idx];
-        }
-        else
+        catch (...)
         {
-          MSSpectrum s = input[scan_idx];
-          s.sortByPosition();
-
-          // determine type of spectral data (profile or centroided)
-          SpectrumSettings::SpectrumType spectrum_type = s.getType();
-
-          if (spectrum_type == SpectrumSettings::CENTROID && check_spectrum_type)
+#ifdef _OPENMP
+#pragma omp critical(HandleException)
+#endif
           {
-            throw OpenMS::Exception::IllegalArgument(__FILE__, __LINE__, __FUNCTION__, "Error: Centroided data provided but profile spectra expected.");
+            if (!errCount) error = std::current_exception();
+            ++errCount;
           }
-
-          pick(s, output[scan_idx]);
         }
-        setProgress(++progress);
+
+        nextProgress();
+      }
+
+      if (errCount != 0)
+      {
+        std::rethrow_exception(error);
       }
     }
 
@@ -583,8 +691,8 @@ namespace OpenMS
     {
       MSChromatogram chromatogram;
       pick(input.getChromatogram(i), chromatogram);
-      output.addChromatogram(chromatogram);
-      setProgress(++progress);
+      output.addChromatogram(std::move(chromatogram));
+      nextProgress();
     }
     endProgress();
 
@@ -603,6 +711,20 @@ namespace OpenMS
     ms_levels_ = getParameters().getValue("ms_levels");
     report_FWHM_ = getParameters().getValue("report_FWHM").toBool();
     report_FWHM_as_ppm_ = getParameters().getValue("report_FWHM_unit")!="absolute";
+
+    rolling_snt_ = param_.getValue("signal_to_noise_estimator") == "median_rolling";
+    snt_param_ = param_.copy("SignalToNoise:", true);
+    if (rolling_snt_)
+    {
+      // only pass on the parameters known to the rolling estimator
+      const Param rolling_defaults = SignalToNoiseEstimatorMedianRolling<MSSpectrum>().getDefaults();
+      Param rolling_param;
+      for (Param::ParamIterator it = rolling_defaults.begin(); it != rolling_defaults.end(); ++it)
+      {
+        rolling_param.setValue(it.getName(), snt_param_.getValue(it.getName()));
+      }
+      snt_param_ = rolling_param;
+    }
   }
 
 }
@@ -38,12 +38,18 @@
 
 #include <OpenMS/CONCEPT/ProgressLogger.h>
 
+#include <atomic>
+
 class QProgressDialog;
 
 namespace OpenMS
 {
   /**
     @brief Implements a GUI version of the ProgressLoggerImpl.
+
+    setProgress and nextProgress may be called from worker threads (see
+    ProgressLogger): the counter is atomic and updates of the dialog from
+    other threads than the one owning it are queued to the GUI thread.
   */
   class OPENMS_GUI_DLLAPI GUIProgressLoggerImpl :
     public ProgressLogger::ProgressLoggerImpl
@@ -85,7 +91,7 @@ private:
     mutable QProgressDialog* dlg_;
     mutable SignedSize begin_;
     mutable SignedSize end_;
-    mutable SignedSize current_;
+    mutable std::atomic<SignedSize> current_;
   };
 }
 
@@ -51,6 +51,7 @@
 
 #include <vector>
 #include <bitset>
+#include <map>
 
 namespace OpenMS
 {
@@ -179,7 +180,10 @@ public:
       on_disc_peaks(new OnDiscMSExperiment()),
       chromatograms(new ExperimentType()),
       current_spectrum_(0),
-      cached_spectrum_()
+      cached_spectrum_(),
+      on_disc_cache_(),
+      on_disc_cache_access_(0),
+      on_disc_cache_size_(64)
     {
       annotations_1d.resize(1);
     }
@@ -243,6 +247,20 @@ public:
     void setOnDiscPeakData(ODExperimentSharedPtrType p)
     {
       on_disc_peaks = p;
+      on_disc_cache_.clear();
+    }
+
+    /// Returns the maximal number of on-disc spectra kept in memory by getSpectrum()
+    Size getOnDiscCacheSize() const
+    {
+      return on_disc_cache_size_;
+    }
+
+    /// Sets the maximal number of on-disc spectra kept in memory by getSpectrum() (at least one is kept)
+    void setOnDiscCacheSize(Size size)
+    {
+      on_disc_cache_size_ = size;
+      on_disc_cache_.clear();
     }
 
     /// Returns a mutable reference to the on-disc data
@@ -310,7 +328,7 @@ public:
       }
       else if (!on_disc_peaks->empty())
       {
-        return on_disc_peaks->getSpectrum(spectrum_idx);
+        return getOnDiscSpectrum_(spectrum_idx);
       }
       return (*peaks)[spectrum_idx];
     }
@@ -451,6 +469,9 @@ private:
     /// Update current cached spectrum for easy retrieval
     void updateCache_();
 
+    /// Returns a spectrum from the on-disc data (the least recently used spectra are kept in memory)
+    const ExperimentType::SpectrumType& getOnDiscSpectrum_(Size spectrum_idx) const;
+
     /// updates the PeakAnnotations in the current PeptideHit with manually changed annotations
     void updatePeptideHitAnnotations_(PeptideHit& hit);
 
@@ -475,6 +496,15 @@ private:
     /// Current cached spectrum
     ExperimentType::SpectrumType cached_spectrum_;
 
+    /// Recently used on-disc spectra (spectrum index -> (last access, spectrum))
+    mutable std::map<Size, std::pair<UInt64, ExperimentType::SpectrumType> > on_disc_cache_;
+
+    /// Access counter of the on-disc spectrum cache
+    mutable UInt64 on_disc_cache_access_;
+
+    /// Maximal number of spectra in the on-disc spectrum cache
+    Size on_disc_cache_size_;
+
   };
 
   /// Print the contents to a stream.
@@ -0,0 +1,155 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2018.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: Timo Sachsenberg $
+// $Authors: Timo Sachsenberg $
+// --------------------------------------------------------------------------
+
+#pragma once
+
+// OpenMS_GUI config
+#include <OpenMS/VISUAL/OpenMS_GUIConfig.h>
+
+#include <OpenMS/KERNEL/MSExperiment.h>
+
+#include <vector>
+
+namespace OpenMS
+{
+  /**
+    @brief Multi-resolution level-of-detail cache of a peak map
+
+    Stores the maximum intensity of the MS1 peaks in a regular grid of RT x
+    m/z tiles over the data range. Level 0 has the finest tiles, each
+    further level halves the number of tiles in both dimensions until a
+    single tile is left.
+
+    Used by Spectrum2DCanvas to draw zoomed-out views of large maps without
+    iterating over all peaks: the canvas uses the coarsest level whose tiles
+    are not larger than a pixel and falls back to the raw peaks if no level
+    is fine enough.
+
+    The finest level can be stored to and loaded from a binary file (the
+    other levels are derived from it).
+
+    @note The spectra are assumed to be sorted by m/z (as required by
+    Spectrum2DCanvas).
+
+    @ingroup Visual
+  */
+  class OPENMS_GUI_DLLAPI PeakMapIntensityPyramid
+  {
+public:
+    /// Default constructor (empty pyramid)
+    PeakMapIntensityPyramid();
+
+    /**
+      @brief Builds the pyramid from the MS1 spectra of @p map
+
+      @param map The peak map
+      @param rt_bins Maximal number of tiles in RT dimension on the finest level (limited by the number of MS1 spectra)
+      @param mz_bins Number of tiles in m/z dimension on the finest level
+    */
+    void build(const PeakMap& map, Size rt_bins = 2048, Size mz_bins = 8192);
+
+    /// Returns whether the pyramid contains no data
+    bool empty() const;
+
+    /// Removes all data
+    void clear();
+
+    /// Returns the number of levels
+    Size getLevelCount() const;
+
+    /// Returns the number of tiles of @p level in RT dimension
+    Size getRTBins(Size level) const;
+
+    /// Returns the number of tiles of @p level in m/z dimension
+    Size getMZBins(Size level) const;
+
+    /**
+      @brief Determines the coarsest level whose tiles are not larger than @p rt_size x @p mz_size
+
+      @return false if even the finest level has larger tiles (or the pyramid is empty)
+    */
+    bool findLevel(double rt_size, double mz_size, Size& level) const;
+
+    /**
+      @brief Returns the maximum intensity of all tiles of @p level intersecting the given area
+
+      @return The maximum intensity, or -1 if the area contains no peaks
+    */
+    float getMaxIntensity(Size level, double rt_start, double rt_end, double mz_start, double mz_end) const;
+
+    /**
+      @brief Stores the finest level to a binary file
+
+      @exception Exception::UnableToCreateFile is thrown if the file cannot be written
+    */
+    void store(const String& filename) const;
+
+    /**
+      @brief Loads the pyramid from a file written by store()
+
+      @exception Exception::FileNotFound is thrown if the file does not exist
+      @exception Exception::ParseError is thrown if the file is not a valid pyramid file
+    */
+    void load(const String& filename);
+
+protected:
+    /// The tiles of one level (row-major, one row per RT tile)
+    struct Level_
+    {
+      Size rt_bins;
+      Size mz_bins;
+      std::vector<float> max_intensity;
+    };
+
+    /// Computes the coarser levels from level 0
+    void buildLevels_();
+
+    /// Returns the range of tiles [first, last] of @p bins tiles covering [start, end) (false if outside)
+    bool tileRange_(double start, double end, double min, double width, Size bins, Size& first, Size& last) const;
+
+    /// The levels, finest first
+    std::vector<Level_> levels_;
+
+    /// Start of the data range in RT
+    double rt_min_;
+    /// Width of the data range in RT
+    double rt_width_;
+    /// Start of the data range in m/z
+    double mz_min_;
+    /// Width of the data range in m/z
+    double mz_width_;
+  };
+
+} // namespace OpenMS
+
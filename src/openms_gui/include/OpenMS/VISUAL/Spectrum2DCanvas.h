@@ -41,8 +41,13 @@
 #include <OpenMS/VISUAL/SpectrumCanvas.h>
 #include <OpenMS/VISUAL/Spectrum1DCanvas.h>
 #include <OpenMS/KERNEL/PeakIndex.h>
+#include <OpenMS/VISUAL/PeakMapIntensityPyramid.h>
+
+// STL
+#include <map>
 
 // QT
+#include <QtCore/QFutureSynchronizer>
 class QPainter;
 class QMouseEvent;
 class QAction;
@@ -97,6 +102,13 @@ public:
     /// recalculates the dot gradient of the active layer
     void recalculateCurrentLayerDotGradient();
 
+    /**
+      @brief Blocks until all intensity pyramids that are built in the background are finished
+
+      Call this before modifying the peak data of a layer in place (e.g. when reloading the file).
+    */
+    void waitForIntensityPyramids();
+
 signals:
     /// Sets the data for the horizontal projection
     void showProjectionHorizontal(ExperimentSharedPtrType);
@@ -192,6 +204,12 @@ protected:
     */
     void paintMaximumIntensities_(Size layer_index, Size rt_pixel_count, Size mz_pixel_count, QPainter& p);
 
+    /// Starts building the intensity pyramid of @p data in a background thread (if the data is large enough)
+    void buildIntensityPyramid_(const ExperimentSharedPtrType& data);
+
+    /// Returns the intensity pyramid of a peak layer (or nullptr if there is none yet)
+    const PeakMapIntensityPyramid* getIntensityPyramid_(Size layer_index) const;
+
     /**
       @brief Paints the precursor peaks.
 
@@ -392,6 +410,13 @@ protected:
     double pen_size_max_; ///< maximum number of pixels for one data point
     double canvas_coverage_min_; ///< minimum coverage of the canvas required; if lower, points are upscaled in size
 
+    /// intensity pyramids of large peak layers (used for drawing zoomed-out views)
+    std::map<const ExperimentType*, boost::shared_ptr<PeakMapIntensityPyramid> > intensity_pyramids_;
+    /// intensity pyramids that are currently built in the background
+    std::map<const ExperimentType*, boost::shared_ptr<PeakMapIntensityPyramid> > pending_pyramids_;
+    /// futures of the background builds
+    QFutureSynchronizer<void> pyramid_builds_;
+
   private:
     /// Default C'tor hidden
     Spectrum2DCanvas();
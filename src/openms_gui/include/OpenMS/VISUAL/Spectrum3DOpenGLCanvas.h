@@ -43,6 +43,8 @@
 // OpenMS
 #include <OpenMS/DATASTRUCTURES/DRange.h>
 
+#include <vector>
+
 namespace OpenMS
 {
   class Spectrum3DCanvas;
@@ -114,14 +116,40 @@ protected:
     void qglColor_(QColor color);
     ///helper function to replicate old behaviour of QGLWidget
     void qglClearColor_(QColor clearColor);
-    /// Builds up a display list for the 3D view
-    GLuint makeDataAsStick_();
+    /// Vertex of the peak data (position and color) as stored in the vertex buffer
+    struct DataVertex_
+    {
+      GLfloat position[3];
+      GLubyte color[4];
+    };
+
+    /// Range of the vertex buffer belonging to one layer
+    struct DataBatch_
+    {
+      GLint first;
+      GLsizei count;
+      GLfloat line_width;
+      bool smooth;
+    };
+
+    /// Collects the vertices for the 3D view (two per peak, drawn as lines)
+    void makeDataAsStick_(std::vector<DataVertex_>& vertices);
+    /// Collects the vertices for the birds-eye view (one per peak, drawn as points)
+    void makeDataAsTopView_(std::vector<DataVertex_>& vertices);
+    /// Uploads the peak data vertices to the vertex buffer, which is drawn with primitive @p mode
+    void uploadData_(const std::vector<DataVertex_>& vertices, GLenum mode);
+    /// Draws the peak data from the vertex buffer
+    void drawData_();
+    /// Returns the color of a peak with intensity @p intensity of layer @p layer_index (depending on the intensity mode)
+    QColor peakColor_(Size layer_index, float intensity);
+    /// Returns a vertex at the given position with the given color
+    static DataVertex_ dataVertex_(GLfloat x, GLfloat y, GLfloat z, const QColor& color);
+    /// Deletes display list @p list (if any) and replaces it by @p new_list
+    void replaceList_(GLuint& list, GLuint new_list);
     /// Builds up a display list for the axes
     GLuint makeAxes_();
     /// Builds up a display list for axis ticks
     GLuint makeAxesTicks_();
-    /// Builds up a display list for the birds-eye view
-    GLuint makeDataAsTopView_();
     /// Builds up a display list for the background
     GLuint makeGround_();
     /// Builds up a display list for grid lines
@@ -165,13 +193,19 @@ protected:
 
     /** @name Different OpenGL display lists */
     //@{
-    GLuint stickdata_;
     GLuint axes_;
     GLuint axes_ticks_;
     GLuint gridlines_;
     GLuint ground_;
     //@}
 
+    /** @name Peak data on the GPU (uploaded whenever the data or the view mode changes) */
+    //@{
+    GLuint data_vbo_;
+    GLenum data_mode_;
+    std::vector<DataBatch_> data_batches_;
+    //@}
+
     /// reference to Spectrum3DCanvas
     Spectrum3DCanvas & canvas_3d_;
 
@@ -43,6 +43,7 @@
 
 #include <QtWidgets/QGraphicsScene>
 #include <QtCore/QProcess>
+#include <QtCore/QHash>
 
 namespace OpenMS
 {
@@ -93,11 +94,13 @@ public:
     struct TOPPProcess
     {
       /// Constructor
-      TOPPProcess(QProcess * p, const QString & cmd, const QStringList & arg, TOPPASToolVertex * const tool) :
+      TOPPProcess(QProcess * p, const QString & cmd, const QStringList & arg, TOPPASToolVertex * const tool, int thr = 1) :
         proc(p),
         command(cmd),
         args(arg),
-        tv(tool)
+        tv(tool),
+        threads(thr),
+        priority(0)
       {
       }
 
@@ -109,6 +112,10 @@ public:
       QStringList args;
       /// The tool which is started (used to call its slots)
       TOPPASToolVertex * tv;
+      /// The number of threads the tool uses
+      int threads;
+      /// Scheduling priority (length of the longest chain of tools depending on this one, set by enqueueProcess())
+      int priority;
     };
 
     /// The current action mode (creation of a new edge, or panning of the widget)
@@ -204,9 +211,14 @@ public:
     bool isPipelineRunning();
     /// Shows a dialog that allows to specify the output directory. If @p always_ask == false, the dialog won't be shown if a directory has been set, already.
     bool askForOutputDir(bool always_ask = true);
-    /// Enqueues the process, it will be run when the currently pending processes have finished
+    /// Enqueues the process, it will be run when enough of the allowed threads are free
     void enqueueProcess(const TOPPProcess & process);
-    /// Runs the next process in the queue, if any
+    /**
+      @brief Runs queued processes as long as their threads fit into the allowed number of threads
+
+      Processes on the critical path (with the longest chain of dependent tools) are started first, smaller
+      processes are started in between if the next one in line needs more threads than currently free.
+    */
     void runNextProcess();
     /// Resets the processes queue
     void resetProcessesQueue();
@@ -275,8 +287,8 @@ public slots:
     void changedParameter(const bool invalidates_running_pipeline);
     /// Invoked by OutfilelistVertex of user changed the folder name
     void changedOutputFolder();
-    /// Called by a finished QProcess to indicate that we are free to start a new one
-    void processFinished();
+    /// Called by a finished QProcess to indicate that its threads are free to start new ones
+    void processFinished(QProcess * proc = nullptr);
     /// dirty solution: when using ExecutePipeline this slot is called when the pipeline crashes. This will quit the app
     void quitWithError();
 
@@ -355,8 +367,12 @@ protected:
     TOPPASScene * clipboard_;
     /// dry run mode (no tools are actually called)
     bool dry_run_;
-    /// currently running processes...
+    /// number of threads used by the currently running processes
     int threads_active_;
+    /// number of threads of each running process
+    QHash<QProcess*, int> process_threads_;
+    /// cached length of the longest chain of tools starting at a vertex (see criticalPathLength_())
+    QHash<TOPPASVertex*, int> critical_path_lengths_;
     /// description text
     QString description_text_;
     /// maximum number of allowed threads
@@ -366,6 +382,8 @@ protected:
 
     /// Returns the vertex in the foreground at position @p pos , if existent, otherwise 0.
     TOPPASVertex * getVertexAt_(const QPointF & pos);
+    /// Returns the number of tool vertices on the longest path starting at @p tv
+    int criticalPathLength_(TOPPASVertex * tv);
     /// Returns whether an edge between node u and v would be allowed
     bool isEdgeAllowed_(TOPPASVertex * u, TOPPASVertex * v);
     /// DFS helper method. Returns true, if a back edge has been discovered
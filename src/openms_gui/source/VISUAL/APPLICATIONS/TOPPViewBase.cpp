@@ -121,6 +121,7 @@
 #include <boost/math/special_functions/fpclassify.hpp>
 
 #include <algorithm>
+#include <exception>
 #include <utility>
 
 using namespace std;
@@ -1262,16 +1263,51 @@ namespace OpenMS
             // peak_map_sptr = boost::static_pointer_cast<ExperimentSharedPtrType>(on_disc_peaks->getMetaData());
             peak_map_sptr = on_disc_peaks->getMetaData();
 
-            for (Size k = 0; k < indexed_mzml_file_.getNrSpectra() && !cache_ms1_on_disc; k++)
+            // The on-disc experiment can be read from several threads, so the
+            // data is decoded in parallel (errors are rethrown afterwards).
+            std::exception_ptr decoding_error;
+            SignedSize nr_spectra = cache_ms1_on_disc ? 0 : (SignedSize)indexed_mzml_file_.getNrSpectra();
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic)
+#endif
+            for (SignedSize k = 0; k < nr_spectra; k++)
             {
-              if ( peak_map_sptr->getSpectrum(k).getMSLevel() == 1)
+              try
               {
-                peak_map_sptr->getSpectrum(k) = on_disc_peaks->getSpectrum(k);
+                if ( peak_map_sptr->getSpectrum(k).getMSLevel() == 1)
+                {
+                  peak_map_sptr->getSpectrum(k) = on_disc_peaks->getSpectrum(k);
+                }
+              }
+              catch (...)
+              {
+#ifdef _OPENMP
+#pragma omp critical (TOPPViewBase_decodingError)
+#endif
+                if (!decoding_error) decoding_error = std::current_exception();
               }
             }
-            for (Size k = 0; k < indexed_mzml_file_.getNrChromatograms() && !cache_ms2_on_disc; k++)
+            SignedSize nr_chromatograms = cache_ms2_on_disc ? 0 : (SignedSize)indexed_mzml_file_.getNrChromatograms();
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic)
+#endif
+            for (SignedSize k = 0; k < nr_chromatograms; k++)
             {
-              peak_map_sptr->getChromatogram(k) = on_disc_peaks->getChromatogram(k);
+              try
+              {
+                peak_map_sptr->getChromatogram(k) = on_disc_peaks->getChromatogram(k);
+              }
+              catch (...)
+              {
+#ifdef _OPENMP
+#pragma omp critical (TOPPViewBase_decodingError)
+#endif
+                if (!decoding_error) decoding_error = std::current_exception();
+              }
+            }
+            if (decoding_error)
+            {
+              std::rethrow_exception(decoding_error);
             }
 
             // Load at least one spectrum into memory (TOPPView assumes that at least one spectrum is in memory)
@@ -4219,6 +4255,16 @@ namespace OpenMS
       }
       else //if (user_wants_update == true)
       {
+        // background tasks of 2D views must not read the data while it is reloaded
+        for (Size i = 0; i != needs_update.size(); ++i)
+        {
+          Spectrum2DCanvas* canvas_2d = qobject_cast<Spectrum2DCanvas*>(needs_update[i].first->canvas());
+          if (canvas_2d != nullptr)
+          {
+            canvas_2d->waitForIntensityPyramids();
+          }
+        }
+
         LayerData& layer = const_cast<LayerData&>(sw->canvas()->getLayer(layer_index));
         // reload data
         if (layer.type == LayerData::DT_PEAK) //peak data
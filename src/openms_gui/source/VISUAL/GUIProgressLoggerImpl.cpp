@@ -36,6 +36,9 @@
 
 #include <OpenMS/DATASTRUCTURES/String.h>
 
+#include <QtCore/QCoreApplication>
+#include <QtCore/QMetaObject>
+#include <QtCore/QThread>
 #include <QProgressDialog>
 #include <iostream>
 
@@ -85,7 +88,15 @@ namespace OpenMS
     {
       if (dlg_)
       {
-        dlg_->setValue((int)value);
+        if (QThread::currentThread() == dlg_->thread())
+        {
+          dlg_->setValue((int)value);
+        }
+        else
+        {
+          // widgets must only be accessed from the GUI thread
+          QMetaObject::invokeMethod(dlg_, "setValue", Qt::QueuedConnection, Q_ARG(int, (int)value));
+        }
       }
       else
       {
@@ -102,6 +113,8 @@ namespace OpenMS
   {
     if (dlg_)
     {
+      // discard updates still queued by worker threads, they would set an outdated value
+      QCoreApplication::removePostedEvents(dlg_, QEvent::MetaCall);
       dlg_->setValue((int)end_);
     }
     else
@@ -36,6 +36,7 @@
 
 #include <OpenMS/VISUAL/ANNOTATION/Annotation1DPeakItem.h>
 
+#include <algorithm>
 #include <iostream>
 
 using namespace std;
@@ -77,10 +78,36 @@ namespace OpenMS
     }
     else if (on_disc_peaks->getNrSpectra() > current_spectrum_)
     {
-      cached_spectrum_ = on_disc_peaks->getSpectrum(current_spectrum_);
+      cached_spectrum_ = getOnDiscSpectrum_(current_spectrum_);
     }
   }
 
+  const LayerData::ExperimentType::SpectrumType& LayerData::getOnDiscSpectrum_(Size spectrum_idx) const
+  {
+    ++on_disc_cache_access_;
+    std::map<Size, std::pair<UInt64, ExperimentType::SpectrumType> >::iterator it = on_disc_cache_.find(spectrum_idx);
+    if (it != on_disc_cache_.end())
+    {
+      it->second.first = on_disc_cache_access_;
+      return it->second.second;
+    }
+
+    // evict the least recently used spectrum (the cache is small, a linear search is fine)
+    if (on_disc_cache_.size() >= std::max(on_disc_cache_size_, Size(1)))
+    {
+      std::map<Size, std::pair<UInt64, ExperimentType::SpectrumType> >::iterator lru = on_disc_cache_.begin();
+      for (it = on_disc_cache_.begin(); it != on_disc_cache_.end(); ++it)
+      {
+        if (it->second.first < lru->second.first) lru = it;
+      }
+      on_disc_cache_.erase(lru);
+    }
+    std::pair<UInt64, ExperimentType::SpectrumType>& entry = on_disc_cache_[spectrum_idx];
+    entry.first = on_disc_cache_access_;
+    entry.second = on_disc_peaks->getSpectrum(spectrum_idx);
+    return entry.second;
+  }
+
   const LayerData::ExperimentType::SpectrumType & LayerData::getCurrentSpectrum() const
   {
     return cached_spectrum_;
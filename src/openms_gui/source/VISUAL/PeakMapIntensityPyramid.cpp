@@ -0,0 +1,309 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2018.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: Timo Sachsenberg $
+// $Authors: Timo Sachsenberg $
+// --------------------------------------------------------------------------
+
+#include <OpenMS/VISUAL/PeakMapIntensityPyramid.h>
+
+#include <OpenMS/CONCEPT/Exception.h>
+#include <OpenMS/SYSTEM/File.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <limits>
+
+using namespace std;
+
+namespace OpenMS
+{
+  namespace
+  {
+    /// magic number at the start of pyramid files (includes the format version)
+    const char PYRAMID_MAGIC[8] = {'O', 'M', 'S', 'L', 'O', 'D', '0', '1'};
+
+    /// index of the tile of @p bins tiles containing @p value (values outside are clamped)
+    inline Size binIndex(double value, double min, double width, Size bins)
+    {
+      double pos = (value - min) / width * bins;
+      if (pos <= 0.0) return 0;
+      return std::min((Size)pos, bins - 1);
+    }
+  }
+
+  PeakMapIntensityPyramid::PeakMapIntensityPyramid() :
+    levels_(),
+    rt_min_(0.0),
+    rt_width_(1.0),
+    mz_min_(0.0),
+    mz_width_(1.0)
+  {
+  }
+
+  void PeakMapIntensityPyramid::build(const PeakMap& map, Size rt_bins, Size mz_bins)
+  {
+    clear();
+
+    // collect MS1 spectra with data and determine the data range
+    vector<Size> ms1;
+    double rt_min = numeric_limits<double>::max(), rt_max = -numeric_limits<double>::max();
+    double mz_min = numeric_limits<double>::max(), mz_max = -numeric_limits<double>::max();
+    for (Size i = 0; i < map.size(); ++i)
+    {
+      const MSSpectrum& spec = map[i];
+      if (spec.getMSLevel() != 1 || spec.empty()) continue;
+      ms1.push_back(i);
+      rt_min = std::min(rt_min, spec.getRT());
+      rt_max = std::max(rt_max, spec.getRT());
+      mz_min = std::min(mz_min, spec.front().getMZ());
+      mz_max = std::max(mz_max, spec.back().getMZ());
+    }
+    if (ms1.empty() || rt_bins == 0 || mz_bins == 0) return;
+
+    rt_min_ = rt_min;
+    mz_min_ = mz_min;
+    // make sure the maximum is inside the last tile (and avoid empty ranges)
+    rt_width_ = rt_max > rt_min ? (rt_max - rt_min) * (1.0 + 1e-9) : 1.0;
+    mz_width_ = mz_max > mz_min ? (mz_max - mz_min) * (1.0 + 1e-9) : 1.0;
+
+    Level_ base;
+    base.rt_bins = std::min(rt_bins, ms1.size());
+    base.mz_bins = mz_bins;
+    base.max_intensity.assign(base.rt_bins * base.mz_bins, -1.0f);
+
+    // group the spectra by RT tile, so that each tile row is written by one thread only
+    vector<pair<Size, Size> > row_spectra; // (RT tile, spectrum index)
+    row_spectra.reserve(ms1.size());
+    for (Size i = 0; i < ms1.size(); ++i)
+    {
+      row_spectra.push_back(make_pair(binIndex(map[ms1[i]].getRT(), rt_min_, rt_width_, base.rt_bins), ms1[i]));
+    }
+    std::stable_sort(row_spectra.begin(), row_spectra.end());
+    vector<Size> row_begin(base.rt_bins + 1, row_spectra.size());
+    for (Size i = row_spectra.size(); i > 0; --i)
+    {
+      row_begin[row_spectra[i - 1].first] = i - 1;
+    }
+    for (Size r = base.rt_bins; r > 0; --r)
+    {
+      row_begin[r - 1] = std::min(row_begin[r - 1], row_begin[r]);
+    }
+
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic)
+#endif
+    for (SignedSize r = 0; r < (SignedSize)base.rt_bins; ++r)
+    {
+      float* row = &base.max_intensity[r * base.mz_bins];
+      for (Size i = row_begin[r]; i < row_begin[r + 1]; ++i)
+      {
+        const MSSpectrum& spec = map[row_spectra[i].second];
+        for (MSSpectrum::ConstIterator it = spec.begin(); it != spec.end(); ++it)
+        {
+          float& tile = row[binIndex(it->getMZ(), mz_min_, mz_width_, base.mz_bins)];
+          tile = std::max(tile, it->getIntensity());
+        }
+      }
+    }
+
+    levels_.push_back(base);
+    buildLevels_();
+  }
+
+  void PeakMapIntensityPyramid::buildLevels_()
+  {
+    while (levels_.back().rt_bins > 1 || levels_.back().mz_bins > 1)
+    {
+      const Level_& fine = levels_.back();
+      Level_ coarse;
+      coarse.rt_bins = (fine.rt_bins + 1) / 2;
+      coarse.mz_bins = (fine.mz_bins + 1) / 2;
+      coarse.max_intensity.assign(coarse.rt_bins * coarse.mz_bins, -1.0f);
+      for (Size r = 0; r < fine.rt_bins; ++r)
+      {
+        const float* fine_row = &fine.max_intensity[r * fine.mz_bins];
+        float* coarse_row = &coarse.max_intensity[(r / 2) * coarse.mz_bins];
+        for (Size m = 0; m < fine.mz_bins; ++m)
+        {
+          coarse_row[m / 2] = std::max(coarse_row[m / 2], fine_row[m]);
+        }
+      }
+      levels_.push_back(coarse);
+    }
+  }
+
+  bool PeakMapIntensityPyramid::empty() const
+  {
+    return levels_.empty();
+  }
+
+  void PeakMapIntensityPyramid::clear()
+  {
+    levels_.clear();
+    rt_min_ = 0.0;
+    rt_width_ = 1.0;
+    mz_min_ = 0.0;
+    mz_width_ = 1.0;
+  }
+
+  Size PeakMapIntensityPyramid::getLevelCount() const
+  {
+    return levels_.size();
+  }
+
+  Size PeakMapIntensityPyramid::getRTBins(Size level) const
+  {
+    return levels_[level].rt_bins;
+  }
+
+  Size PeakMapIntensityPyramid::getMZBins(Size level) const
+  {
+    return levels_[level].mz_bins;
+  }
+
+  bool PeakMapIntensityPyramid::findLevel(double rt_size, double mz_size, Size& level) const
+  {
+    for (Size l = levels_.size(); l > 0; --l)
+    {
+      if (rt_width_ / levels_[l - 1].rt_bins <= rt_size && mz_width_ / levels_[l - 1].mz_bins <= mz_size)
+      {
+        level = l - 1;
+        return true;
+      }
+    }
+    return false;
+  }
+
+  bool PeakMapIntensityPyramid::tileRange_(double start, double end, double min, double width, Size bins, Size& first, Size& last) const
+  {
+    if (end < min || start > min + width || end < start) return false;
+    first = binIndex(start, min, width, bins);
+    last = binIndex(end, min, width, bins);
+    // the end is exclusive
+    if (last > first && (end - min) / width * bins == std::floor((end - min) / width * bins)) --last;
+    return true;
+  }
+
+  float PeakMapIntensityPyramid::getMaxIntensity(Size level, double rt_start, double rt_end, double mz_start, double mz_end) const
+  {
+    if (level >= levels_.size()) return -1.0f;
+    const Level_& l = levels_[level];
+
+    Size rt_first, rt_last, mz_first, mz_last;
+    if (!tileRange_(rt_start, rt_end, rt_min_, rt_width_, l.rt_bins, rt_first, rt_last) ||
+        !tileRange_(mz_start, mz_end, mz_min_, mz_width_, l.mz_bins, mz_first, mz_last))
+    {
+      return -1.0f;
+    }
+
+    float max = -1.0f;
+    for (Size r = rt_first; r <= rt_last; ++r)
+    {
+      const float* row = &l.max_intensity[r * l.mz_bins];
+      for (Size m = mz_first; m <= mz_last; ++m)
+      {
+        max = std::max(max, row[m]);
+      }
+    }
+    return max;
+  }
+
+  void PeakMapIntensityPyramid::store(const String& filename) const
+  {
+    ofstream os(filename.c_str(), std::ios::out | std::ios::binary);
+    if (!os)
+    {
+      throw Exception::UnableToCreateFile(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, filename);
+    }
+
+    UInt64 bins[2] = {0, 0};
+    if (!levels_.empty())
+    {
+      bins[0] = levels_[0].rt_bins;
+      bins[1] = levels_[0].mz_bins;
+    }
+    double range[4] = {rt_min_, rt_width_, mz_min_, mz_width_};
+    os.write(PYRAMID_MAGIC, sizeof(PYRAMID_MAGIC));
+    os.write(reinterpret_cast<const char*>(bins), sizeof(bins));
+    os.write(reinterpret_cast<const char*>(range), sizeof(range));
+    if (!levels_.empty())
+    {
+      os.write(reinterpret_cast<const char*>(&levels_[0].max_intensity[0]), levels_[0].max_intensity.size() * sizeof(float));
+    }
+    if (!os)
+    {
+      throw Exception::UnableToCreateFile(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, filename);
+    }
+  }
+
+  void PeakMapIntensityPyramid::load(const String& filename)
+  {
+    if (!File::exists(filename))
+    {
+      throw Exception::FileNotFound(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, filename);
+    }
+    ifstream is(filename.c_str(), std::ios::in | std::ios::binary);
+
+    char magic[sizeof(PYRAMID_MAGIC)];
+    UInt64 bins[2];
+    double range[4];
+    is.read(magic, sizeof(magic));
+    is.read(reinterpret_cast<char*>(bins), sizeof(bins));
+    is.read(reinterpret_cast<char*>(range), sizeof(range));
+    if (!is || std::memcmp(magic, PYRAMID_MAGIC, sizeof(magic)) != 0 || range[1] <= 0.0 || range[3] <= 0.0)
+    {
+      throw Exception::ParseError(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, filename, "not a valid intensity pyramid file");
+    }
+
+    clear();
+    if (bins[0] == 0 || bins[1] == 0) return;
+
+    Level_ base;
+    base.rt_bins = bins[0];
+    base.mz_bins = bins[1];
+    base.max_intensity.resize(base.rt_bins * base.mz_bins);
+    is.read(reinterpret_cast<char*>(&base.max_intensity[0]), base.max_intensity.size() * sizeof(float));
+    if (!is)
+    {
+      throw Exception::ParseError(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, filename, "intensity pyramid file is truncated");
+    }
+
+    rt_min_ = range[0];
+    rt_width_ = range[1];
+    mz_min_ = range[2];
+    mz_width_ = range[3];
+    levels_.push_back(base);
+    buildLevels_();
+  }
+
+} // namespace OpenMS
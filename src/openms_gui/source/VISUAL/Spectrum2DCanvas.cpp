@@ -60,6 +60,8 @@
 #include <QtWidgets/QComboBox>
 #include <QtWidgets/QFileDialog>
 #include <QtWidgets/QMessageBox>
+#include <QtConcurrent/QtConcurrent>
+#include <QtCore/QFutureWatcher>
 
 //boost
 #include <boost/math/special_functions/fpclassify.hpp>
@@ -655,6 +657,33 @@ namespace OpenMS
     double rt_step_size = (rt_max - rt_min) / rt_pixel_count;
     double mz_step_size = (mz_max - mz_min) / mz_pixel_count;
 
+    // zoomed out on a large map: use the intensity pyramid instead of iterating over all peaks
+    // (the pyramid does not know about data filters, so it is only used if no filter is active)
+    const PeakMapIntensityPyramid* pyramid = getIntensityPyramid_(layer_index);
+    Size level;
+    if (pyramid != nullptr && !layer.filters.isActive() && pyramid->findLevel(rt_step_size, mz_step_size, level))
+    {
+      for (Size rt = 0; rt < rt_pixel_count; ++rt)
+      {
+        double rt_start = rt_min + rt_step_size * rt;
+        for (Size mz = 0; mz < mz_pixel_count; ++mz)
+        {
+          double mz_start = mz_min + mz_step_size * mz;
+          float max = pyramid->getMaxIntensity(level, rt_start, rt_start + rt_step_size, mz_start, mz_start + mz_step_size);
+          if (max >= 0.0)
+          {
+            QPoint pos;
+            dataToWidget_(mz_start + 0.5 * mz_step_size, rt_start + 0.5 * rt_step_size, pos);
+            if (pos.y() < image_height && pos.x() < image_width)
+            {
+              buffer_.setPixel(pos.x(), pos.y(), heightColor_(max, layer.gradient, snap_factor).rgb());
+            }
+          }
+        }
+      }
+      return;
+    }
+
     // start at first visible RT scan
     Size scan_index = std::distance(map.begin(), map.RTBegin(rt_min));
     //iterate over all pixels (RT dimension)
@@ -726,6 +755,54 @@ namespace OpenMS
     }
   }
 
+  void Spectrum2DCanvas::buildIntensityPyramid_(const ExperimentSharedPtrType& data)
+  {
+    // below this number of peaks, drawing from the raw data is fast enough
+    const Size min_peaks = 5000000;
+    if (data->getSize() < min_peaks)
+    {
+      return;
+    }
+
+    // the background thread shares ownership of data and pyramid, the canvas is only touched in the main thread
+    boost::shared_ptr<PeakMapIntensityPyramid> pyramid(new PeakMapIntensityPyramid());
+    ConstExperimentSharedPtrType peaks = data;
+    QFutureWatcher<void>* watcher = new QFutureWatcher<void>(this);
+    connect(watcher, &QFutureWatcher<void>::finished, this, [this, watcher, peaks, pyramid]()
+    {
+      // only use the pyramid if the data is still shown and has not changed in the meantime
+      std::map<const ExperimentType*, boost::shared_ptr<PeakMapIntensityPyramid> >::iterator it = pending_pyramids_.find(peaks.get());
+      if (it != pending_pyramids_.end() && it->second == pyramid)
+      {
+        pending_pyramids_.erase(it);
+        intensity_pyramids_[peaks.get()] = pyramid;
+        update_buffer_ = true;
+        update_(OPENMS_PRETTY_FUNCTION);
+      }
+      watcher->deleteLater();
+    });
+    pending_pyramids_[peaks.get()] = pyramid;
+    QFuture<void> future = QtConcurrent::run([peaks, pyramid]() { pyramid->build(*peaks); });
+    watcher->setFuture(future);
+    pyramid_builds_.addFuture(future);
+  }
+
+  const PeakMapIntensityPyramid* Spectrum2DCanvas::getIntensityPyramid_(Size layer_index) const
+  {
+    std::map<const ExperimentType*, boost::shared_ptr<PeakMapIntensityPyramid> >::const_iterator it = intensity_pyramids_.find(getLayer(layer_index).getPeakData().get());
+    if (it == intensity_pyramids_.end() || it->second->empty())
+    {
+      return nullptr;
+    }
+    return it->second.get();
+  }
+
+  void Spectrum2DCanvas::waitForIntensityPyramids()
+  {
+    pyramid_builds_.waitForFinished();
+    pyramid_builds_.clearFutures();
+  }
+
   void Spectrum2DCanvas::paintFeatureData_(Size layer_index, QPainter& painter)
   {
     const LayerData& layer = getLayer(layer_index);
@@ -1253,6 +1330,7 @@ namespace OpenMS
       {
         setLayerFlag(LayerData::P_PRECURSORS, true); // show precursors if no MS1 data is contained
       }
+      buildIntensityPyramid_(getCurrentLayer_().getPeakDataMuteable());
     }
     else if (layers_.back().type == LayerData::DT_FEATURE)  // feature data
     {
@@ -1345,8 +1423,19 @@ namespace OpenMS
       return;
     }
 
-    // remove the data
+    // remove the data (and its intensity pyramid, unless another layer shows the same data)
+    const ExperimentType* peaks = getLayer(layer_index).getPeakData().get();
     layers_.erase(layers_.begin() + layer_index);
+    bool peaks_shown = false;
+    for (Size i = 0; i < getLayerCount(); ++i)
+    {
+      peaks_shown |= (getLayer(i).getPeakData().get() == peaks);
+    }
+    if (!peaks_shown)
+    {
+      intensity_pyramids_.erase(peaks);
+      pending_pyramids_.erase(peaks);
+    }
 
     // update visible area and boundaries
     DRange<3> old_data_range = overall_data_range_;
@@ -2836,6 +2925,14 @@ namespace OpenMS
 
   void Spectrum2DCanvas::updateLayer(Size i)
   {
+    // the data has changed: rebuild the intensity pyramid
+    if (getLayer(i).type == LayerData::DT_PEAK)
+    {
+      intensity_pyramids_.erase(getLayer(i).getPeakData().get());
+      pending_pyramids_.erase(getLayer(i).getPeakData().get());
+      buildIntensityPyramid_(layers_[i].getPeakDataMuteable());
+    }
+
     //update nearest peak
     selected_peak_.clear();
     recalculateRanges_(0, 1, 2);
@@ -40,6 +40,8 @@
 #include <QMouseEvent>
 #include <QKeyEvent>
 
+#include <cstddef>
+
 using std::cout;
 using std::endl;
 using std::max;
@@ -49,6 +51,13 @@ namespace OpenMS
 
   Spectrum3DOpenGLCanvas::Spectrum3DOpenGLCanvas(QWidget * parent, Spectrum3DCanvas & canvas_3d) :
     QOpenGLWidget(parent),
+    axes_(0),
+    axes_ticks_(0),
+    gridlines_(0),
+    ground_(0),
+    data_vbo_(0),
+    data_mode_(GL_LINES),
+    data_batches_(),
     canvas_3d_(canvas_3d)
   {
     canvas_3d.rubber_band_.setParent(this);
@@ -73,6 +82,13 @@ namespace OpenMS
 
   Spectrum3DOpenGLCanvas::~Spectrum3DOpenGLCanvas()
   {
+    // the vertex buffer only exists if OpenGL was initialized
+    if (data_vbo_ != 0 && context() != nullptr)
+    {
+      makeCurrent();
+      glDeleteBuffers(1, &data_vbo_);
+      doneCurrent();
+    }
   }
 
   void Spectrum3DOpenGLCanvas::calculateGridLines_()
@@ -203,55 +219,50 @@ namespace OpenMS
     {
       if (!canvas_3d_.rubber_band_.isVisible())
       {
-        axes_ = makeAxes_();
+        replaceList_(axes_, makeAxes_());
         if (canvas_3d_.show_grid_)
         {
-          gridlines_ = makeGridLines_();
+          replaceList_(gridlines_, makeGridLines_());
         }
         xrot_ = 90 * 16;
         yrot_ = 0;
         zrot_ = 0;
         zoom_ = 1.25;
 
-        if (stickdata_ != 0)
-        {
-          glDeleteLists(stickdata_, 1);
-#ifdef DEBUG_TOPPVIEW
-          cout << "BEGIN " << OPENMS_PRETTY_FUNCTION << endl;
-          std::cout << "Deleting sticklist near makeDataAsTopView" << std::endl;
-#endif
-        }
-
-        stickdata_ = makeDataAsTopView_();
-        axes_ticks_ = makeAxesTicks_();
+        std::vector<DataVertex_> vertices;
+        makeDataAsTopView_(vertices);
+        uploadData_(vertices, GL_POINTS);
+        replaceList_(axes_ticks_, makeAxesTicks_());
         //drawAxesLegend_();
       }
     }
     else if (canvas_3d_.action_mode_ == SpectrumCanvas::AM_TRANSLATE)
     {
-      if (canvas_3d_.show_grid_) { gridlines_ = makeGridLines_(); }
-      axes_ = makeAxes_();
-      ground_ = makeGround_();
+      if (canvas_3d_.show_grid_) { replaceList_(gridlines_, makeGridLines_()); }
+      replaceList_(axes_, makeAxes_());
+      replaceList_(ground_, makeGround_());
       x_1_ = 0.0;
       y_1_ = 0.0;
       x_2_ = 0.0;
       y_2_ = 0.0;
 
-      if (stickdata_ != 0)
-      {
-        glDeleteLists(stickdata_, 1);
-#ifdef DEBUG_TOPPVIEW
-        cout << "BEGIN " << OPENMS_PRETTY_FUNCTION << endl;
-        std::cout << "Deleting sticklist near makeDataAsTopView" << std::endl;
-#endif
-      }
-
-      stickdata_ =  makeDataAsStick_();
-      axes_ticks_ = makeAxesTicks_();
+      std::vector<DataVertex_> vertices;
+      makeDataAsStick_(vertices);
+      uploadData_(vertices, GL_LINES);
+      replaceList_(axes_ticks_, makeAxesTicks_());
       //drawAxesLegend_();
     }
   }
 
+  void Spectrum3DOpenGLCanvas::replaceList_(GLuint& list, GLuint new_list)
+  {
+    if (list != 0)
+    {
+      glDeleteLists(list, 1);
+    }
+    list = new_list;
+  }
+
   void Spectrum3DOpenGLCanvas::resetTranslation()
   {
     trans_x_ = 0.0;
@@ -301,7 +312,7 @@ namespace OpenMS
       if (canvas_3d_.action_mode_ == SpectrumCanvas::AM_ZOOM 
        || canvas_3d_.action_mode_ == SpectrumCanvas::AM_TRANSLATE)
       {
-        glCallList(stickdata_);
+        drawData_();
       }
 
       // draw axes legend
@@ -531,25 +542,50 @@ namespace OpenMS
     return list;
   }
 
-  GLuint Spectrum3DOpenGLCanvas::makeDataAsTopView_()
+  QColor Spectrum3DOpenGLCanvas::peakColor_(Size layer_index, float intensity)
   {
-    GLuint list = glGenLists(1);
-    glNewList(list, GL_COMPILE);
-    glPointSize(3.0);
+    const MultiGradient& gradient = canvas_3d_.getLayer(layer_index).gradient;
+    switch (canvas_3d_.intensity_mode_)
+    {
+    case SpectrumCanvas::IM_PERCENTAGE:
+      return gradient.precalculatedColorAt(intensity * 100.0 / canvas_3d_.getMaxIntensity(layer_index));
+
+    case SpectrumCanvas::IM_LOG:
+      return gradient.precalculatedColorAt(log10(1 + max(0.0, (double)intensity)));
+
+    case SpectrumCanvas::IM_NONE:
+    case SpectrumCanvas::IM_SNAP:
+    default:
+      return gradient.precalculatedColorAt(intensity);
+    }
+  }
+
+  Spectrum3DOpenGLCanvas::DataVertex_ Spectrum3DOpenGLCanvas::dataVertex_(GLfloat x, GLfloat y, GLfloat z, const QColor& color)
+  {
+    DataVertex_ vertex;
+    vertex.position[0] = x;
+    vertex.position[1] = y;
+    vertex.position[2] = z;
+    vertex.color[0] = (GLubyte)color.red();
+    vertex.color[1] = (GLubyte)color.green();
+    vertex.color[2] = (GLubyte)color.blue();
+    vertex.color[3] = (GLubyte)color.alpha();
+    return vertex;
+  }
+
+  void Spectrum3DOpenGLCanvas::makeDataAsTopView_(std::vector<DataVertex_>& vertices)
+  {
+    data_batches_.clear();
 
     for (Size i = 0; i < canvas_3d_.getLayerCount(); ++i)
     {
       const LayerData & layer = canvas_3d_.getLayer(i);
       if (layer.visible)
       {
-        if ((Int)layer.param.getValue("dot:shade_mode"))
-        {
-          glShadeModel(GL_SMOOTH);
-        }
-        else
-        {
-          glShadeModel(GL_FLAT);
-        }
+        DataBatch_ batch;
+        batch.first = (GLint)vertices.size();
+        batch.line_width = 1.0;
+        batch.smooth = (Int)layer.param.getValue("dot:shade_mode");
 
         auto begin_it = layer.getPeakData()->areaBeginConst(canvas_3d_.visible_area_.min_[1], canvas_3d_.visible_area_.max_[1], canvas_3d_.visible_area_.min_[0], canvas_3d_.visible_area_.max_[0]);
         auto end_it = layer.getPeakData()->areaEndConst();
@@ -563,63 +599,38 @@ namespace OpenMS
         {
           step = 1 + count / max_displayed_peaks;
         }
+        vertices.reserve(vertices.size() + count / step + 1);
 
         for (auto it = begin_it; it != end_it; ++it)
         {
-          if (step > 1)
+          for (int s = 1; s < step && it != end_it; ++s)
           {
-            for (int i = 0; i < step - 1; ++i)
-            {
-              ++it;
-            }
+            ++it;
           }
           if (it == end_it)
           {
-            glEndList();
-            return list;
+            break;
           }
 
           PeakIndex pi = it.getPeakIndex();
           if (layer.filters.passes((*layer.getPeakData())[pi.spectrum], pi.peak))
           {
-            glBegin(GL_POINTS);
-            double intensity = 0;
-            switch (canvas_3d_.intensity_mode_)
-            {
-            case SpectrumCanvas::IM_NONE:
-              qglColor_(layer.gradient.precalculatedColorAt(it->getIntensity()));
-              break;
-
-            case SpectrumCanvas::IM_PERCENTAGE:
-              intensity = it->getIntensity() * 100.0 / canvas_3d_.getMaxIntensity(i);
-              qglColor_(layer.gradient.precalculatedColorAt(intensity));
-              break;
-
-            case SpectrumCanvas::IM_SNAP:
-              qglColor_(layer.gradient.precalculatedColorAt(it->getIntensity()));
-              break;
-
-            case SpectrumCanvas::IM_LOG:
-              qglColor_(layer.gradient.precalculatedColorAt(log10(1 + max(0.0, (double)(it->getIntensity())))));
-              break;
-
-            }
-            glVertex3f(-corner_ + (GLfloat)scaledMZ_(it->getMZ()),
-                       -corner_,
-                       -near_ - 2 * corner_ - (GLfloat)scaledRT_(it.getRT()));
-            glEnd();
+            vertices.push_back(dataVertex_(-corner_ + (GLfloat)scaledMZ_(it->getMZ()),
+                                           -corner_,
+                                           -near_ - 2 * corner_ - (GLfloat)scaledRT_(it.getRT()),
+                                           peakColor_(i, it->getIntensity())));
           }
         }
+
+        batch.count = (GLsizei)(vertices.size() - batch.first);
+        data_batches_.push_back(batch);
       }
     }
-    glEndList();
-    return list;
   }
 
-  GLuint Spectrum3DOpenGLCanvas::makeDataAsStick_()
+  void Spectrum3DOpenGLCanvas::makeDataAsStick_(std::vector<DataVertex_>& vertices)
   {
-    GLuint list = glGenLists(1);
-    glNewList(list, GL_COMPILE);
+    data_batches_.clear();
 
     for (Size i = 0; i < canvas_3d_.getLayerCount(); i++)
     {
@@ -628,16 +639,10 @@ namespace OpenMS
       {
         recalculateDotGradient_(i);
 
-        if ((Int)layer.param.getValue("dot:shade_mode"))
-        {
-          glShadeModel(GL_SMOOTH);
-        }
-        else
-        {
-          glShadeModel(GL_FLAT);
-        }
-
-        glLineWidth(layer.param.getValue("dot:line_width"));
+        DataBatch_ batch;
+        batch.first = (GLint)vertices.size();
+        batch.line_width = (double)layer.param.getValue("dot:line_width");
+        batch.smooth = (Int)layer.param.getValue("dot:shade_mode");
 
         auto begin_it = layer.getPeakData()->areaBeginConst(canvas_3d_.visible_area_.min_[1], canvas_3d_.visible_area_.max_[1], canvas_3d_.visible_area_.min_[0], canvas_3d_.visible_area_.max_[0]);
         auto end_it = layer.getPeakData()->areaEndConst();
@@ -650,88 +655,78 @@ namespace OpenMS
         {
           step = 1 + count / max_displayed_peaks;
         }
+        vertices.reserve(vertices.size() + 2 * (count / step + 1));
 
+        const QColor base_color = layer.gradient.precalculatedColorAt(0.0);
         for (auto it = begin_it; it != end_it; ++it)
         {
-          if (step > 1)
+          for (int s = 1; s < step && it != end_it; ++s)
           {
-            for (int i = 0; i < step - 1; ++i)
-            {
-              ++it;
-            }
+            ++it;
           }
           if (it == end_it)
           {
-            glEndList();
-            return list;
+            break;
           }
 
           PeakIndex pi = it.getPeakIndex();
           if (layer.filters.passes((*layer.getPeakData())[pi.spectrum], pi.peak))
           {
-            glBegin(GL_LINES);
-            double intensity = 0;
-            switch (canvas_3d_.intensity_mode_)
-            {
-
-            case SpectrumCanvas::IM_PERCENTAGE:
-
-              intensity = it->getIntensity() * 100.0 / canvas_3d_.getMaxIntensity(i);
-              qglColor_(layer.gradient.precalculatedColorAt(0.0));
-              glVertex3d(-corner_ + (GLfloat)scaledMZ_(it->getMZ()),
-                         -corner_,
-                         -near_ - 2 * corner_ - (GLfloat)scaledRT_(it.getRT()));
-              qglColor_(layer.gradient.precalculatedColorAt(intensity));
-              glVertex3d(-corner_ + (GLfloat)scaledMZ_(it->getMZ()),
-                         -corner_ + (GLfloat)scaledIntensity_(it->getIntensity(), i),
-                         -near_ - 2 * corner_ - (GLfloat)scaledRT_(it.getRT()));
-              break;
-
-            case SpectrumCanvas::IM_NONE:
-
-              qglColor_(layer.gradient.precalculatedColorAt(0.0));
-              glVertex3d(-corner_ + (GLfloat)scaledMZ_(it->getMZ()),
-                         -corner_,
-                         -near_ - 2 * corner_ - (GLfloat)scaledRT_(it.getRT()));
-              qglColor_(layer.gradient.precalculatedColorAt(it->getIntensity()));
-              glVertex3d(-corner_ + (GLfloat)scaledMZ_(it->getMZ()),
-                         -corner_ + (GLfloat)scaledIntensity_(it->getIntensity(), i),
-                         -near_ - 2 * corner_ - (GLfloat)scaledRT_(it.getRT()));
-              break;
-
-            case SpectrumCanvas::IM_SNAP:
-
-              qglColor_(layer.gradient.precalculatedColorAt(0.0));
-              glVertex3d(-corner_ + (GLfloat)scaledMZ_(it->getMZ()),
-                         -corner_,
-                         -near_ - 2 * corner_ - (GLfloat)scaledRT_(it.getRT()));
-              qglColor_(layer.gradient.precalculatedColorAt(it->getIntensity()));
-              glVertex3d(-corner_ + (GLfloat)scaledMZ_(it->getMZ()),
-                         -corner_ + (GLfloat)scaledIntensity_(it->getIntensity(), i),
-                         -near_ - 2 * corner_ - (GLfloat)scaledRT_(it.getRT()));
-
-              break;
-
-            case SpectrumCanvas::IM_LOG:
-
-              qglColor_(layer.gradient.precalculatedColorAt(0.0));
-              glVertex3d(-corner_ + (GLfloat)scaledMZ_(it->getMZ()),
-                         -corner_,
-                         -near_ - 2 * corner_ - (GLfloat)scaledRT_(it.getRT()));
-              qglColor_(layer.gradient.precalculatedColorAt(log10(1 + max(0.0, (double)(it->getIntensity())))));
-              glVertex3d(-corner_ + (GLfloat)scaledMZ_(it->getMZ()),
-                         -corner_ + (GLfloat)scaledIntensity_(it->getIntensity(), i),
-                         -near_ - 2 * corner_ - (GLfloat)scaledRT_(it.getRT()));
-
-              break;
-            }
-            glEnd();
+            GLfloat x = -corner_ + (GLfloat)scaledMZ_(it->getMZ());
+            GLfloat z = -near_ - 2 * corner_ - (GLfloat)scaledRT_(it.getRT());
+            vertices.push_back(dataVertex_(x, -corner_, z, base_color));
+            vertices.push_back(dataVertex_(x, -corner_ + (GLfloat)scaledIntensity_(it->getIntensity(), i), z, peakColor_(i, it->getIntensity())));
           }
         }
+
+        batch.count = (GLsizei)(vertices.size() - batch.first);
+        data_batches_.push_back(batch);
       }
     }
-    glEndList();
-    return list;
+  }
+
+  void Spectrum3DOpenGLCanvas::uploadData_(const std::vector<DataVertex_>& vertices, GLenum mode)
+  {
+    if (data_vbo_ == 0)
+    {
+      glGenBuffers(1, &data_vbo_);
+    }
+    glBindBuffer(GL_ARRAY_BUFFER, data_vbo_);
+    glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(DataVertex_), vertices.empty() ? nullptr : &vertices[0], GL_STATIC_DRAW);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    data_mode_ = mode;
+  }
+
+  void Spectrum3DOpenGLCanvas::drawData_()
+  {
+    if (data_vbo_ == 0 || data_batches_.empty())
+    {
+      return;
+    }
+
+    glBindBuffer(GL_ARRAY_BUFFER, data_vbo_);
+    glEnableClientState(GL_VERTEX_ARRAY);
+    glEnableClientState(GL_COLOR_ARRAY);
+    glVertexPointer(3, GL_FLOAT, sizeof(DataVertex_), reinterpret_cast<const GLvoid*>(offsetof(DataVertex_, position)));
+    glColorPointer(4, GL_UNSIGNED_BYTE, sizeof(DataVertex_), reinterpret_cast<const GLvoid*>(offsetof(DataVertex_, color)));
+
+    if (data_mode_ == GL_POINTS)
+    {
+      glPointSize(3.0);
+    }
+    for (std::vector<DataBatch_>::const_iterator it = data_batches_.begin(); it != data_batches_.end(); ++it)
+    {
+      glShadeModel(it->smooth ? GL_SMOOTH : GL_FLAT);
+      if (data_mode_ == GL_LINES)
+      {
+        glLineWidth(it->line_width);
+      }
+      glDrawArrays(data_mode_, it->first, it->count);
+    }
+
+    glDisableClientState(GL_COLOR_ARRAY);
+    glDisableClientState(GL_VERTEX_ARRAY);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
   }
 
   GLuint Spectrum3DOpenGLCanvas::makeGridLines_()
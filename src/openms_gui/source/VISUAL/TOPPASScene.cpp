@@ -59,6 +59,8 @@
 #include <QtCore/QTextStream>
 #include <QtWidgets/QMessageBox>
 
+#include <algorithm>
+
 namespace OpenMS
 {
 
@@ -673,6 +675,7 @@ namespace OpenMS
 
       // reset processes
       topp_processes_queue_.clear();
+      critical_path_lengths_.clear();
 
       // start at input nodes
       for (VertexIterator it = verticesBegin(); it != verticesEnd(); ++it)
@@ -1664,9 +1667,9 @@ namespace OpenMS
     }
   }
 
-  void TOPPASScene::processFinished()
+  void TOPPASScene::processFinished(QProcess* proc)
   {
-    --threads_active_;
+    threads_active_ -= process_threads_.contains(proc) ? process_threads_.take(proc) : 1;
     // try to run next in line
     runNextProcess();
   }
@@ -1993,7 +1996,30 @@ namespace OpenMS
 
   void TOPPASScene::enqueueProcess(const TOPPProcess& process)
   {
-    topp_processes_queue_ << process;
+    TOPPProcess tp = process;
+    tp.priority = criticalPathLength_(tp.tv);
+    topp_processes_queue_ << tp;
+  }
+
+  int TOPPASScene::criticalPathLength_(TOPPASVertex* tv)
+  {
+    QHash<TOPPASVertex*, int>::const_iterator it = critical_path_lengths_.find(tv);
+    if (it != critical_path_lengths_.end())
+    {
+      return it.value();
+    }
+
+    int length = 0;
+    for (TOPPASVertex::ConstEdgeIterator e = tv->outEdgesBegin(); e != tv->outEdgesEnd(); ++e)
+    {
+      length = std::max(length, criticalPathLength_((*e)->getTargetVertex()));
+    }
+    if (qobject_cast<TOPPASToolVertex*>(tv) != nullptr)
+    {
+      ++length;
+    }
+    critical_path_lengths_[tv] = length;
+    return length;
   }
 
   void TOPPASScene::runNextProcess()
@@ -2004,11 +2030,27 @@ namespace OpenMS
 
     used = true;
 
-    while (!topp_processes_queue_.empty() && threads_active_ < allowed_threads_)
+    while (!topp_processes_queue_.empty())
     {
-      ++threads_active_; // will be decreased, once the tool finishes
-      TOPPProcess tp = topp_processes_queue_.first();
-      topp_processes_queue_.pop_front();
+      // take the process with the highest priority that fits into the free threads
+      // (a process never needs more than all allowed threads, so the largest ones can run alone)
+      int free_threads = allowed_threads_ - threads_active_;
+      int next = -1;
+      for (int i = 0; i < topp_processes_queue_.size(); ++i)
+      {
+        const TOPPProcess& candidate = topp_processes_queue_[i];
+        if (std::max(1, std::min(candidate.threads, allowed_threads_)) > free_threads) continue;
+        if (next == -1 || candidate.priority > topp_processes_queue_[next].priority) next = i;
+      }
+      if (next == -1)
+      {
+        break;
+      }
+
+      TOPPProcess tp = topp_processes_queue_.takeAt(next);
+      int threads = std::max(1, std::min(tp.threads, allowed_threads_));
+      threads_active_ += threads; // will be decreased, once the tool finishes
+      process_threads_[tp.proc] = threads;
       FakeProcess* p = qobject_cast<FakeProcess*>(tp.proc);
       if (p)
       {
@@ -731,7 +731,8 @@ namespace OpenMS
         }
       }
       toolScheduledSlot();
-      ts->enqueueProcess(TOPPASScene::TOPPProcess(p, File::findExecutable(name_).toQString(), args, this));
+      int threads = param_tmp.exists("threads") ? (int)param_tmp.getValue("threads") : 1;
+      ts->enqueueProcess(TOPPASScene::TOPPProcess(p, File::findExecutable(name_).toQString(), args, this, threads));
     }
 
     // run pending processes
@@ -803,7 +804,8 @@ namespace OpenMS
       delete p;
     }
 
-    ts->processFinished();
+    // p is only used to look up the number of threads to release
+    ts->processFinished(p);
 
     __DEBUG_END_METHOD__
   }
@@ -20,6 +20,7 @@ MultiGradientSelector.cpp
 
 ParamEditor.cpp
 ParamEditor.ui
+PeakMapIntensityPyramid.cpp
 
 SpectraIdentificationViewWidget.cpp
 SpectraViewWidget.cpp
@@ -72,6 +72,21 @@ public:
     iterator end() {return data.end();}
     const_iterator end() const {return data.end();}
     };
+
+    /// Scratch space for computeRank and rankedMutualInformation, reusing it avoids all allocations after the first call
+    struct RankedMIScratch
+    {
+      /// (value, index) pairs sorted by computeRank
+      std::vector<std::pair<float, unsigned int> > sort_buffer;
+      /// ranks of the first data vector
+      std::vector<unsigned int> ranks1;
+      /// ranks of the second data vector
+      std::vector<unsigned int> ranks2;
+      /// joint states of both rank vectors
+      std::vector<unsigned int> joint_states;
+      /// state counts of the first and second rank vector
+      std::vector<unsigned int> counts1, counts2;
+    };
     //@}
 
     /** @name Helper functions */
@@ -123,6 +138,28 @@ public:
     OPENSWATHALGO_DLLAPI XCorrArrayType calculateCrossCorrelation(const std::vector<double>& data1,
                                                                   const std::vector<double>& data2, const int& maxdelay, const int& lag);
 
+    /** @brief Calculate the normalized crosscorrelation between all pairs of two sets of vectors
+     *
+     * Computes the same values as normalizedCrossCorrelation() (with lag 1)
+     * for every pair (data1[i], data2[j]), but standardizes each vector only
+     * once and writes all results into a single contiguous buffer: the
+     * correlation of pair (i, j) at delay d is stored at
+     * result[(i * data2.size() + j) * (2 * maxdelay + 1) + d + maxdelay].
+     *
+     * @param data1 First set of vectors (standardized in place)
+     * @param data2 Second set of vectors (standardized in place, may be the same object as data1)
+     * @param maxdelay Largest delay to compute (a negative value means the full range, i.e. the vector length)
+     * @param upper_triangle Only compute pairs with j >= i (other entries are set to zero)
+     * @param result Output buffer (resized as needed)
+     *
+     * @return The maximal delay that was used
+     *
+     * @note All vectors need to have the same (non-zero) length.
+    */
+    OPENSWATHALGO_DLLAPI int normalizedCrossCorrelationMatrix(std::vector<std::vector<double> >& data1,
+                                                               std::vector<std::vector<double> >& data2,
+                                                               int maxdelay, bool upper_triangle, std::vector<double>& result);
+
     /// Find best peak in an cross-correlation (highest apex)
     OPENSWATHALGO_DLLAPI XCorrArrayType::const_iterator xcorrArrayGetMaxPeak(const XCorrArrayType & array);
 
@@ -135,9 +172,25 @@ public:
     // Compute rank of vector elements
     OPENSWATHALGO_DLLAPI std::vector<unsigned int> computeRank(const std::vector<double>& w);
 
+    /// Compute rank of vector elements into @p ranks, using @p sort_buffer as scratch space (same result as computeRank(w))
+    OPENSWATHALGO_DLLAPI void computeRank(const std::vector<double>& w, std::vector<unsigned int>& ranks,
+                                          std::vector<std::pair<float, unsigned int> >& sort_buffer);
+
     // Estimate rank-transformed mutual information between two vectors of data points
     OPENSWATHALGO_DLLAPI double rankedMutualInformation(std::vector<double>& data1, std::vector<double>& data2);
 
+    /// Estimate rank-transformed mutual information between two vectors of data points, using caller-provided scratch space
+    OPENSWATHALGO_DLLAPI double rankedMutualInformation(const std::vector<double>& data1, const std::vector<double>& data2, RankedMIScratch& scratch);
+
+    /**
+      @brief Estimate the mutual information between two vectors of ranks (see computeRank)
+
+      Use this when the same data vector takes part in several comparisons, so
+      it only needs to be ranked once. The result is the same as the one of
+      rankedMutualInformation() on the unranked data.
+    */
+    OPENSWATHALGO_DLLAPI double rankedMutualInformation(const std::vector<unsigned int>& ranks1, const std::vector<unsigned int>& ranks2, RankedMIScratch& scratch);
+
     //@}
 
   }
@@ -69,6 +69,25 @@ public:
 
     /// Return a pointer to a spectrum at the given id
     virtual SpectrumPtr getSpectrumById(int id) = 0;
+
+    /**
+      @brief Return pointers to the spectra at the given ids (in the same order as @p ids)
+
+      Backends which can retrieve several spectra more efficiently than one by
+      one (e.g. by merging neighbouring reads or using a single query) should
+      override this function. The default implementation calls
+      getSpectrumById for each id.
+    */
+    virtual std::vector<SpectrumPtr> getSpectraByIds(const std::vector<std::size_t>& ids);
+
+    /**
+      @brief Hint that the spectra within RT +/- deltaRT will be accessed soon
+
+      Backends may use this hint to start reading the corresponding data
+      asynchronously. It never changes the result of any subsequent access,
+      the default implementation does nothing.
+    */
+    virtual void prefetchSpectraByRT(double RT, double deltaRT);
     /// Return a vector of ids of spectra that are within RT +/- deltaRT
     virtual std::vector<std::size_t> getSpectraByRT(double RT, double deltaRT) const = 0;
     /// Returns the number of spectra available
@@ -64,132 +64,146 @@ namespace OpenSwath
     return xcorr_precursor_combined_matrix_;
   }
 
-  void MRMScoring::initializeXCorrMatrix(OpenSwath::IMRMFeature* mrmfeature, const std::vector<String>& native_ids)
+  namespace
   {
-    std::vector<double> intensityi, intensityj;
-    xcorr_matrix_.resize(native_ids.size());
-    for (std::size_t i = 0; i < native_ids.size(); i++)
+    // collect the intensities of a set of features
+    void getIntensities_(const std::vector<MRMScoring::FeatureType>& features, std::vector<std::vector<double> >& intensities)
     {
-      String native_id = native_ids[i];
-      FeatureType fi = mrmfeature->getFeature(native_id);
-      xcorr_matrix_[i].resize(native_ids.size());
-      intensityi.clear();
-      fi->getIntensity(intensityi);
-      for (std::size_t j = i; j < native_ids.size(); j++)
+      intensities.resize(features.size());
+      for (std::size_t i = 0; i < features.size(); i++)
       {
-        String native_id2 = native_ids[j];
-        FeatureType fj = mrmfeature->getFeature(native_id2);
-        intensityj.clear();
-        fj->getIntensity(intensityj);
-        // compute normalized cross correlation
-        xcorr_matrix_[i][j] = Scoring::normalizedCrossCorrelation(intensityi, intensityj, boost::numeric_cast<int>(intensityi.size()), 1);
+        intensities[i].clear();
+        features[i]->getIntensity(intensities[i]);
       }
     }
-  }
 
-  void MRMScoring::initializeXCorrContrastMatrix(OpenSwath::IMRMFeature* mrmfeature, const std::vector<String>& native_ids_set1, const std::vector<String>& native_ids_set2)
-  {
-    std::vector<double> intensityi, intensityj;
-    xcorr_contrast_matrix_.resize(native_ids_set1.size());
-    for (std::size_t i = 0; i < native_ids_set1.size(); i++)
-    { 
-      String native_id = native_ids_set1[i];
-      FeatureType fi = mrmfeature->getFeature(native_id);
-      xcorr_contrast_matrix_[i].resize(native_ids_set2.size());
-      intensityi.clear();
-      fi->getIntensity(intensityi);
-      for (std::size_t j = 0; j < native_ids_set2.size(); j++)
+    void getFeatures_(OpenSwath::IMRMFeature* mrmfeature, const std::vector<MRMScoring::String>& ids,
+                      bool precursor, std::vector<MRMScoring::FeatureType>& features)
+    {
+      for (std::size_t i = 0; i < ids.size(); i++)
       {
-        String native_id2 = native_ids_set2[j];
-        FeatureType fj = mrmfeature->getFeature(native_id2);
-        intensityj.clear();
-        fj->getIntensity(intensityj);
-        // compute normalized cross correlation
-        xcorr_contrast_matrix_[i][j] = Scoring::normalizedCrossCorrelation(intensityi, intensityj, boost::numeric_cast<int>(intensityi.size()), 1);
+        features.push_back(precursor ? mrmfeature->getPrecursorFeature(ids[i]) : mrmfeature->getFeature(ids[i]));
       }
     }
-  }
 
-  void MRMScoring::initializeXCorrPrecursorMatrix(OpenSwath::IMRMFeature* mrmfeature, const std::vector<String>& precursor_ids)
-  {
-    std::vector<double> intensityi, intensityj;
-    xcorr_precursor_matrix_.resize(precursor_ids.size());
-    for (std::size_t i = 0; i < precursor_ids.size(); i++)
+    // compute all cross-correlations between two sets of features in one go
+    // and distribute them into the (i, j) arrays of the matrix (features2 may
+    // be the same object as features1, in which case the data is only
+    // retrieved once)
+    void computeXCorrMatrix_(const std::vector<MRMScoring::FeatureType>& features1,
+                             const std::vector<MRMScoring::FeatureType>& features2,
+                             bool upper_triangle, MRMScoring::XCorrMatrixType& xcorr_matrix)
     {
-      String precursor_id = precursor_ids[i];
-      FeatureType fi = mrmfeature->getPrecursorFeature(precursor_id);
-      xcorr_precursor_matrix_[i].resize(precursor_ids.size());
-      intensityi.clear();
-      fi->getIntensity(intensityi);
-      for (std::size_t j = i; j < precursor_ids.size(); j++)
+      const bool same_set = (&features1 == &features2);
+      std::vector<std::vector<double> > intensities1, intensities2;
+      getIntensities_(features1, intensities1);
+      if (!same_set)
+      {
+        getIntensities_(features2, intensities2);
+      }
+      std::vector<std::vector<double> >& data2 = same_set ? intensities1 : intensities2;
+
+      std::vector<double> buffer;
+      const int maxdelay = Scoring::normalizedCrossCorrelationMatrix(intensities1, data2, -1, upper_triangle, buffer);
+      const std::size_t nr_delays = 2 * maxdelay + 1;
+
+      xcorr_matrix.resize(intensities1.size());
+      for (std::size_t i = 0; i < intensities1.size(); i++)
       {
-        String precursor_id2 = precursor_ids[j];
-        FeatureType fj = mrmfeature->getPrecursorFeature(precursor_id2);
-        intensityj.clear();
-        fj->getIntensity(intensityj);
-        // compute normalized cross correlation
-        xcorr_precursor_matrix_[i][j] = Scoring::normalizedCrossCorrelation(intensityi, intensityj, boost::numeric_cast<int>(intensityi.size()), 1);
+        xcorr_matrix[i].resize(data2.size());
+        for (std::size_t j = (upper_triangle ? i : 0); j < data2.size(); j++)
+        {
+          const double* values = &buffer[(i * data2.size() + j) * nr_delays];
+          std::vector<Scoring::XCorrEntry>& array = xcorr_matrix[i][j].data;
+          array.resize(nr_delays);
+          for (std::size_t k = 0; k < nr_delays; k++)
+          {
+            array[k] = std::make_pair((int)k - maxdelay, values[k]);
+          }
+        }
       }
     }
-  }
 
-  void MRMScoring::initializeXCorrPrecursorContrastMatrix(OpenSwath::IMRMFeature* mrmfeature, const std::vector<String>& precursor_ids, const std::vector<String>& native_ids)
-  {
-    std::vector<double> intensityi, intensityj;
-    xcorr_precursor_contrast_matrix_.resize(precursor_ids.size());
-    for (std::size_t i = 0; i < precursor_ids.size(); i++)
-    { 
-      String precursor_id = precursor_ids[i];
-      FeatureType fi = mrmfeature->getPrecursorFeature(precursor_id);
-      xcorr_precursor_contrast_matrix_[i].resize(native_ids.size());
-      intensityi.clear();
-      fi->getIntensity(intensityi);
-      for (std::size_t j = 0; j < native_ids.size(); j++)
+    // rank the intensities of each feature once and compute the ranked mutual
+    // information of all pairs from the precomputed ranks (features2 may be
+    // the same object as features1)
+    void computeMIMatrix_(const std::vector<MRMScoring::FeatureType>& features1,
+                          const std::vector<MRMScoring::FeatureType>& features2,
+                          bool upper_triangle, std::vector<std::vector<double> >& mi_matrix)
+    {
+      const bool same_set = (&features1 == &features2);
+      Scoring::RankedMIScratch scratch;
+      std::vector<double> intensity;
+      std::vector<std::vector<unsigned int> > ranks1, ranks2;
+
+      ranks1.resize(features1.size());
+      for (std::size_t i = 0; i < features1.size(); i++)
+      {
+        intensity.clear();
+        features1[i]->getIntensity(intensity);
+        Scoring::computeRank(intensity, ranks1[i], scratch.sort_buffer);
+      }
+      if (!same_set)
       {
-        String native_id = native_ids[j];
-        FeatureType fj = mrmfeature->getFeature(native_id);
-        intensityj.clear();
-        fj->getIntensity(intensityj);
-        // compute normalized cross correlation
-        xcorr_precursor_contrast_matrix_[i][j] = Scoring::normalizedCrossCorrelation(intensityi, intensityj, boost::numeric_cast<int>(intensityi.size()), 1);
+        ranks2.resize(features2.size());
+        for (std::size_t j = 0; j < features2.size(); j++)
+        {
+          intensity.clear();
+          features2[j]->getIntensity(intensity);
+          Scoring::computeRank(intensity, ranks2[j], scratch.sort_buffer);
+        }
+      }
+      const std::vector<std::vector<unsigned int> >& data2 = same_set ? ranks1 : ranks2;
+
+      mi_matrix.resize(ranks1.size());
+      for (std::size_t i = 0; i < ranks1.size(); i++)
+      {
+        mi_matrix[i].resize(data2.size());
+        for (std::size_t j = (upper_triangle ? i : 0); j < data2.size(); j++)
+        {
+          mi_matrix[i][j] = Scoring::rankedMutualInformation(ranks1[i], data2[j], scratch);
+        }
       }
     }
   }
 
-  void MRMScoring::initializeXCorrPrecursorCombinedMatrix(OpenSwath::IMRMFeature* mrmfeature, const std::vector<String>& precursor_ids, const std::vector<String>& native_ids)
+  void MRMScoring::initializeXCorrMatrix(OpenSwath::IMRMFeature* mrmfeature, const std::vector<String>& native_ids)
   {
-    std::vector<double> intensityi, intensityj;
     std::vector<FeatureType> features;
+    getFeatures_(mrmfeature, native_ids, false, features);
+    computeXCorrMatrix_(features, features, true, xcorr_matrix_);
+  }
 
-    for (std::size_t i = 0; i < precursor_ids.size(); i++)
-    { 
-      String precursor_id = precursor_ids[i];
-      FeatureType fi = mrmfeature->getPrecursorFeature(precursor_id);
-      features.push_back(fi);
-    }
-    for (std::size_t j = 0; j < native_ids.size(); j++)
-    {
-      String native_id = native_ids[j];
-      FeatureType fj = mrmfeature->getFeature(native_id);
-      features.push_back(fj);
-    }
+  void MRMScoring::initializeXCorrContrastMatrix(OpenSwath::IMRMFeature* mrmfeature, const std::vector<String>& native_ids_set1, const std::vector<String>& native_ids_set2)
+  {
+    std::vector<FeatureType> features1, features2;
+    getFeatures_(mrmfeature, native_ids_set1, false, features1);
+    getFeatures_(mrmfeature, native_ids_set2, false, features2);
+    computeXCorrMatrix_(features1, features2, false, xcorr_contrast_matrix_);
+  }
 
-    xcorr_precursor_combined_matrix_.resize(features.size());
-    for (std::size_t i = 0; i < features.size(); i++)
-    { 
-      FeatureType fi = features[i];
-      xcorr_precursor_combined_matrix_[i].resize(features.size());
-      intensityi.clear();
-      fi->getIntensity(intensityi);
-      for (std::size_t j = 0; j < features.size(); j++)
-      {
-        FeatureType fj = features[j];
-        intensityj.clear();
-        fj->getIntensity(intensityj);
-        // compute normalized cross correlation
-        xcorr_precursor_combined_matrix_[i][j] = Scoring::normalizedCrossCorrelation(intensityi, intensityj, boost::numeric_cast<int>(intensityi.size()), 1);
-      }
-    }
+  void MRMScoring::initializeXCorrPrecursorMatrix(OpenSwath::IMRMFeature* mrmfeature, const std::vector<String>& precursor_ids)
+  {
+    std::vector<FeatureType> features;
+    getFeatures_(mrmfeature, precursor_ids, true, features);
+    computeXCorrMatrix_(features, features, true, xcorr_precursor_matrix_);
+  }
+
+  void MRMScoring::initializeXCorrPrecursorContrastMatrix(OpenSwath::IMRMFeature* mrmfeature, const std::vector<String>& precursor_ids, const std::vector<String>& native_ids)
+  {
+    std::vector<FeatureType> features1, features2;
+    getFeatures_(mrmfeature, precursor_ids, true, features1);
+    getFeatures_(mrmfeature, native_ids, false, features2);
+    computeXCorrMatrix_(features1, features2, false, xcorr_precursor_contrast_matrix_);
+  }
+
+  void MRMScoring::initializeXCorrPrecursorCombinedMatrix(OpenSwath::IMRMFeature* mrmfeature, const std::vector<String>& precursor_ids, const std::vector<String>& native_ids)
+  {
+    std::vector<FeatureType> features;
+    getFeatures_(mrmfeature, precursor_ids, true, features);
+    getFeatures_(mrmfeature, native_ids, false, features);
+    // the combined matrix is used in full (not only the upper triangle)
+    computeXCorrMatrix_(features, features, false, xcorr_precursor_combined_matrix_);
   }
 
   // see /IMSB/users/reiterl/bin/code/biognosys/trunk/libs/mrm_libs/MRM_pgroup.pm
@@ -694,130 +708,41 @@ namespace OpenSwath
 
   void MRMScoring::initializeMIMatrix(OpenSwath::IMRMFeature* mrmfeature, std::vector<String> native_ids)
   {
-    std::vector<double> intensityi, intensityj;
-    mi_matrix_.resize(native_ids.size());
-    for (std::size_t i = 0; i < native_ids.size(); i++)
-    {
-      String native_id = native_ids[i];
-      FeatureType fi = mrmfeature->getFeature(native_id);
-      mi_matrix_[i].resize(native_ids.size());
-      intensityi.clear();
-      fi->getIntensity(intensityi);
-      for (std::size_t j = i; j < native_ids.size(); j++)
-      {
-        String native_id2 = native_ids[j];
-        FeatureType fj = mrmfeature->getFeature(native_id2);
-        intensityj.clear();
-        fj->getIntensity(intensityj);
-        // compute ranked mutual information
-        mi_matrix_[i][j] = Scoring::rankedMutualInformation(intensityi, intensityj);
-      }
-    }
+    std::vector<FeatureType> features;
+    getFeatures_(mrmfeature, native_ids, false, features);
+    computeMIMatrix_(features, features, true, mi_matrix_);
   }
 
   void MRMScoring::initializeMIContrastMatrix(OpenSwath::IMRMFeature* mrmfeature, std::vector<String> native_ids_set1, std::vector<String> native_ids_set2)
-  { 
-    std::vector<double> intensityi, intensityj;
-    mi_contrast_matrix_.resize(native_ids_set1.size());
-    for (std::size_t i = 0; i < native_ids_set1.size(); i++)
-    { 
-      String native_id = native_ids_set1[i];
-      FeatureType fi = mrmfeature->getFeature(native_id);
-      mi_contrast_matrix_[i].resize(native_ids_set2.size());
-      intensityi.clear();
-      fi->getIntensity(intensityi);
-      for (std::size_t j = 0; j < native_ids_set2.size(); j++)
-      {
-        String native_id2 = native_ids_set2[j];
-        FeatureType fj = mrmfeature->getFeature(native_id2);
-        intensityj.clear();
-        fj->getIntensity(intensityj);
-        // compute ranked mutual information
-        mi_contrast_matrix_[i][j] = Scoring::rankedMutualInformation(intensityi, intensityj);
-      }
-    }
+  {
+    std::vector<FeatureType> features1, features2;
+    getFeatures_(mrmfeature, native_ids_set1, false, features1);
+    getFeatures_(mrmfeature, native_ids_set2, false, features2);
+    computeMIMatrix_(features1, features2, false, mi_contrast_matrix_);
   }
 
   void MRMScoring::initializeMIPrecursorMatrix(OpenSwath::IMRMFeature* mrmfeature, std::vector<String> precursor_ids)
   {
-    std::vector<double> intensityi, intensityj;
-    mi_precursor_matrix_.resize(precursor_ids.size());
-    for (std::size_t i = 0; i < precursor_ids.size(); i++)
-    {
-      String precursor_id = precursor_ids[i];
-      FeatureType fi = mrmfeature->getPrecursorFeature(precursor_id);
-      mi_precursor_matrix_[i].resize(precursor_ids.size());
-      intensityi.clear();
-      fi->getIntensity(intensityi);
-      for (std::size_t j = i; j < precursor_ids.size(); j++)
-      {
-        String precursor_id2 = precursor_ids[j];
-        FeatureType fj = mrmfeature->getPrecursorFeature(precursor_id2);
-        intensityj.clear();
-        fj->getIntensity(intensityj);
-        // compute ranked mutual information
-        mi_precursor_matrix_[i][j] = Scoring::rankedMutualInformation(intensityi, intensityj);
-      }
-    }
+    std::vector<FeatureType> features;
+    getFeatures_(mrmfeature, precursor_ids, true, features);
+    computeMIMatrix_(features, features, true, mi_precursor_matrix_);
   }
 
   void MRMScoring::initializeMIPrecursorContrastMatrix(OpenSwath::IMRMFeature* mrmfeature, const std::vector<String>& precursor_ids, const std::vector<String>& native_ids)
   {
-    std::vector<double> intensityi, intensityj;
-    mi_precursor_contrast_matrix_.resize(precursor_ids.size());
-    for (std::size_t i = 0; i < precursor_ids.size(); i++)
-    { 
-      String precursor_id = precursor_ids[i];
-      FeatureType fi = mrmfeature->getPrecursorFeature(precursor_id);
-      mi_precursor_contrast_matrix_[i].resize(native_ids.size());
-      intensityi.clear();
-      fi->getIntensity(intensityi);
-      for (std::size_t j = 0; j < native_ids.size(); j++)
-      {
-        String native_id = native_ids[j];
-        FeatureType fj = mrmfeature->getFeature(native_id);
-        intensityj.clear();
-        fj->getIntensity(intensityj);
-        // compute ranked mutual information
-        mi_precursor_contrast_matrix_[i][j] = Scoring::rankedMutualInformation(intensityi, intensityj);
-      }
-    }
+    std::vector<FeatureType> features1, features2;
+    getFeatures_(mrmfeature, precursor_ids, true, features1);
+    getFeatures_(mrmfeature, native_ids, false, features2);
+    computeMIMatrix_(features1, features2, false, mi_precursor_contrast_matrix_);
   }
 
   void MRMScoring::initializeMIPrecursorCombinedMatrix(OpenSwath::IMRMFeature* mrmfeature, const std::vector<String>& precursor_ids, const std::vector<String>& native_ids)
   {
-    std::vector<double> intensityi, intensityj;
     std::vector<FeatureType> features;
-
-    for (std::size_t i = 0; i < precursor_ids.size(); i++)
-    { 
-      String precursor_id = precursor_ids[i];
-      FeatureType fi = mrmfeature->getPrecursorFeature(precursor_id);
-      features.push_back(fi);
-    }
-    for (std::size_t j = 0; j < native_ids.size(); j++)
-    {
-      String native_id = native_ids[j];
-      FeatureType fj = mrmfeature->getFeature(native_id);
-      features.push_back(fj);
-    }
-
-    mi_precursor_combined_matrix_.resize(features.size());
-    for (std::size_t i = 0; i < features.size(); i++)
-    { 
-      FeatureType fi = features[i];
-      mi_precursor_combined_matrix_[i].resize(features.size());
-      intensityi.clear();
-      fi->getIntensity(intensityi);
-      for (std::size_t j = 0; j < features.size(); j++)
-      {
-        FeatureType fj = features[j];
-        intensityj.clear();
-        fj->getIntensity(intensityj);
-        // compute ranked mutual information
-        mi_precursor_combined_matrix_[i][j] = Scoring::rankedMutualInformation(intensityi, intensityj);
-      }
-    }
+    getFeatures_(mrmfeature, precursor_ids, true, features);
+    getFeatures_(mrmfeature, native_ids, false, features);
+    // the combined matrix is used in full (not only the upper triangle)
+    computeMIMatrix_(features, features, false, mi_precursor_combined_matrix_);
   }
 
   double MRMScoring::calcMIScore()
@@ -34,6 +34,7 @@
 
 #include <OpenMS/OPENSWATHALGO/ALGO/Scoring.h>
 #include <OpenMS/OPENSWATHALGO/Macros.h>
+#include <algorithm>
 #include <cmath>
 
 #include <boost/numeric/conversion/cast.hpp>
@@ -49,9 +50,47 @@ namespace OpenSwath
   namespace Scoring
   {
 
+    namespace
+    {
+      // The reductions below keep four independent partial sums. This breaks
+      // the dependency chain of a single accumulator, so the compiler can
+      // vectorize the loops without relaxed floating point semantics.
+      inline double sum_(const double* x, std::size_t n)
+      {
+        double s[4] = {0.0, 0.0, 0.0, 0.0};
+        std::size_t i = 0;
+        for (; i + 4 <= n; i += 4)
+        {
+          s[0] += x[i];
+          s[1] += x[i + 1];
+          s[2] += x[i + 2];
+          s[3] += x[i + 3];
+        }
+        for (; i < n; ++i) s[0] += x[i];
+        return (s[0] + s[1]) + (s[2] + s[3]);
+      }
+
+      // sum of (x_i - mean)^2
+      inline double squaredDeviationSum_(const double* x, std::size_t n, double mean)
+      {
+        double s[4] = {0.0, 0.0, 0.0, 0.0};
+        std::size_t i = 0;
+        for (; i + 4 <= n; i += 4)
+        {
+          const double d0 = x[i] - mean, d1 = x[i + 1] - mean, d2 = x[i + 2] - mean, d3 = x[i + 3] - mean;
+          s[0] += d0 * d0;
+          s[1] += d1 * d1;
+          s[2] += d2 * d2;
+          s[3] += d3 * d3;
+        }
+        for (; i < n; ++i) s[0] += (x[i] - mean) * (x[i] - mean);
+        return (s[0] + s[1]) + (s[2] + s[3]);
+      }
+    }
+
     void normalize_sum(double x[], unsigned int n)
     {
-      double sumx = std::accumulate(&x[0], &x[0] + n, 0.0);
+      double sumx = sum_(x, n);
       if (sumx == 0.0)
       {
         return;
@@ -66,13 +105,22 @@ namespace OpenSwath
     {
       OPENSWATH_PRECONDITION(n > 0, "Need at least one element");
 
-      double delta_ratio_sum = 0;
       normalize_sum(x, n);
       normalize_sum(y, n);
-      for (int i = 0; i < n; i++)
+      double s[4] = {0.0, 0.0, 0.0, 0.0};
+      int i = 0;
+      for (; i + 4 <= n; i += 4)
+      {
+        s[0] += std::fabs(x[i] - y[i]);
+        s[1] += std::fabs(x[i + 1] - y[i + 1]);
+        s[2] += std::fabs(x[i + 2] - y[i + 2]);
+        s[3] += std::fabs(x[i + 3] - y[i + 3]);
+      }
+      for (; i < n; i++)
       {
-        delta_ratio_sum += std::fabs(x[i] - y[i]);
+        s[0] += std::fabs(x[i] - y[i]);
       }
+      double delta_ratio_sum = (s[0] + s[1]) + (s[2] + s[3]);
       return delta_ratio_sum / n;
     }
 
@@ -80,12 +128,21 @@ namespace OpenSwath
     {
       OPENSWATH_PRECONDITION(n > 0, "Need at least one element");
 
-      double result = 0;
-      for (int i = 0; i < n; i++)
+      double s[4] = {0.0, 0.0, 0.0, 0.0};
+      int i = 0;
+      for (; i + 4 <= n; i += 4)
       {
-
-        result += (x[i] - y[i]) * (x[i] - y[i]);
+        const double d0 = x[i] - y[i], d1 = x[i + 1] - y[i + 1], d2 = x[i + 2] - y[i + 2], d3 = x[i + 3] - y[i + 3];
+        s[0] += d0 * d0;
+        s[1] += d1 * d1;
+        s[2] += d2 * d2;
+        s[3] += d3 * d3;
+      }
+      for (; i < n; i++)
+      {
+        s[0] += (x[i] - y[i]) * (x[i] - y[i]);
       }
+      double result = (s[0] + s[1]) + (s[2] + s[3]);
       return std::sqrt(result / n);
     }
 
@@ -93,19 +150,29 @@ namespace OpenSwath
     {
       OPENSWATH_PRECONDITION(n > 0, "Need at least one element");
 
-      double dotprod = 0;
-      double x_len = 0;
-      double y_len = 0;
-      for (int i = 0; i < n; i++)
+      double dotprod[4] = {0.0, 0.0, 0.0, 0.0};
+      double x_sq[4] = {0.0, 0.0, 0.0, 0.0};
+      double y_sq[4] = {0.0, 0.0, 0.0, 0.0};
+      int i = 0;
+      for (; i + 4 <= n; i += 4)
       {
-        dotprod += x[i] * y[i];
-        x_len += x[i] * x[i];
-        y_len += y[i] * y[i];
+        for (int k = 0; k < 4; ++k)
+        {
+          dotprod[k] += x[i + k] * y[i + k];
+          x_sq[k] += x[i + k] * x[i + k];
+          y_sq[k] += y[i + k] * y[i + k];
+        }
+      }
+      for (; i < n; i++)
+      {
+        dotprod[0] += x[i] * y[i];
+        x_sq[0] += x[i] * x[i];
+        y_sq[0] += y[i] * y[i];
       }
-      x_len = std::sqrt(x_len);
-      y_len = std::sqrt(y_len);
+      double x_len = std::sqrt((x_sq[0] + x_sq[1]) + (x_sq[2] + x_sq[3]));
+      double y_len = std::sqrt((y_sq[0] + y_sq[1]) + (y_sq[2] + y_sq[3]));
 
-      return std::acos(dotprod / (x_len * y_len));
+      return std::acos(((dotprod[0] + dotprod[1]) + (dotprod[2] + dotprod[3])) / (x_len * y_len));
     }
 
     XCorrArrayType::const_iterator xcorrArrayGetMaxPeak(const XCorrArrayType& array)
@@ -130,12 +197,8 @@ namespace OpenSwath
       OPENSWATH_PRECONDITION(data.size() > 0, "Need non-empty array.");
 
       // subtract the mean and divide by the standard deviation
-      double mean = std::accumulate(data.begin(), data.end(), 0.0) / (double) data.size();
-      double sqsum = 0;
-      for (std::vector<double>::iterator it = data.begin(); it != data.end(); ++it)
-      {
-        sqsum += (*it - mean) * (*it - mean);
-      }
+      double mean = sum_(data.data(), data.size()) / (double) data.size();
+      double sqsum = squaredDeviationSum_(data.data(), data.size(), mean);
       double stdev = sqrt(sqsum / data.size()); // standard deviation
 
       if (mean == 0 && stdev == 0) return; // all data is zero
@@ -171,25 +234,82 @@ namespace OpenSwath
       XCorrArrayType result;
       result.data.reserve( (size_t)std::ceil((2*maxdelay + 1) / lag));
       int datasize = boost::numeric_cast<int>(data1.size());
-      int i, j, delay;
+      int i, delay;
 
       for (delay = -maxdelay; delay <= maxdelay; delay = delay + lag)
       {
+        // only the overlapping range contributes (i + delay has to be a valid index);
+        // restricting the loop keeps the summation order and allows vectorization
+        const int i_begin = std::max(0, -delay);
+        const int i_end = std::min(datasize, datasize - delay);
         double sxy = 0;
-        for (i = 0; i < datasize; ++i)
+        for (i = i_begin; i < i_end; ++i)
         {
-          j = i + delay;
-          if (j < 0 || j >= datasize)
-          {
-            continue;
-          }
-          sxy += (data1[i]) * (data2[j]);
+          sxy += data1[i] * data2[i + delay];
         }
         result.data.push_back(std::make_pair(delay, sxy));
       }
       return result;
     }
 
+    int normalizedCrossCorrelationMatrix(std::vector<std::vector<double> >& data1,
+                                         std::vector<std::vector<double> >& data2,
+                                         int maxdelay, bool upper_triangle, std::vector<double>& result)
+    {
+      OPENSWATH_PRECONDITION(data1.empty() || !data1[0].empty(), "Need non-empty arrays.");
+      result.clear();
+      if (data1.empty() || data2.empty())
+      {
+        return 0;
+      }
+
+      const int datasize = boost::numeric_cast<int>(data1[0].size());
+      if (maxdelay < 0 || maxdelay > datasize)
+      {
+        maxdelay = datasize;
+      }
+      const std::size_t nr_delays = 2 * maxdelay + 1;
+
+      // normalize the data (only once per vector)
+      for (std::size_t i = 0; i < data1.size(); ++i)
+      {
+        OPENSWATH_PRECONDITION((int)data1[i].size() == datasize, "All data vectors need to have the same length");
+        standardize_data(data1[i]);
+      }
+      if (&data1 != &data2)
+      {
+        for (std::size_t j = 0; j < data2.size(); ++j)
+        {
+          OPENSWATH_PRECONDITION((int)data2[j].size() == datasize, "All data vectors need to have the same length");
+          standardize_data(data2[j]);
+        }
+      }
+
+      result.resize(data1.size() * data2.size() * nr_delays, 0.0);
+      for (std::size_t i = 0; i < data1.size(); ++i)
+      {
+        const double* x = data1[i].data();
+        for (std::size_t j = (upper_triangle ? i : 0); j < data2.size(); ++j)
+        {
+          const double* y = data2[j].data();
+          double* out = &result[(i * data2.size() + j) * nr_delays];
+          for (int delay = -maxdelay; delay <= maxdelay; ++delay)
+          {
+            // only sum over the overlapping part (x[k] * y[k + delay])
+            const int start = std::max(0, -delay);
+            const int end = std::min(datasize, datasize - delay);
+            double sxy = 0;
+            for (int k = start; k < end; ++k)
+            {
+              sxy += x[k] * y[k + delay];
+            }
+            out[delay + maxdelay] = sxy / datasize;
+          }
+        }
+      }
+      return maxdelay;
+    }
+
     XCorrArrayType calcxcorr_legacy_mquest_(std::vector<double>& data1,
                                             std::vector<double>& data2, bool normalize)
     {
@@ -259,7 +379,16 @@ namespace OpenSwath
 
     std::vector<unsigned int> computeRank(const std::vector<double>& v_temp)
     {
-      std::vector<std::pair<float, unsigned int> > v_sort(v_temp.size());
+      std::vector<std::pair<float, unsigned int> > v_sort;
+      std::vector<unsigned int> result;
+      computeRank(v_temp, result, v_sort);
+      return result;
+    }
+
+    void computeRank(const std::vector<double>& v_temp, std::vector<unsigned int>& result,
+                     std::vector<std::pair<float, unsigned int> >& v_sort)
+    {
+      v_sort.resize(v_temp.size());
 
       for (unsigned int i = 0; i < v_sort.size(); ++i) {
         v_sort[i] = std::make_pair(v_temp[i], i);
@@ -268,7 +397,7 @@ namespace OpenSwath
       std::sort(v_sort.begin(), v_sort.end());
 
       std::pair<double, unsigned int> rank;
-      std::vector<unsigned int> result(v_temp.size());
+      result.resize(v_temp.size());
 
       for (unsigned int i = 0; i < v_sort.size(); ++i) {
         if (v_sort[i].first != rank.first) {
@@ -276,7 +405,6 @@ namespace OpenSwath
         }
         result[v_sort[i].second] = rank.second;
       }
-      return result;
     }
 
     double rankedMutualInformation(std::vector<double>& data1, std::vector<double>& data2)
@@ -295,5 +423,54 @@ namespace OpenSwath
       return result;
     }
 
+    double rankedMutualInformation(const std::vector<double>& data1, const std::vector<double>& data2, RankedMIScratch& scratch)
+    {
+      OPENSWATH_PRECONDITION(data1.size() != 0 && data1.size() == data2.size(), "Both data vectors need to have the same length");
+
+      computeRank(data1, scratch.ranks1, scratch.sort_buffer);
+      computeRank(data2, scratch.ranks2, scratch.sort_buffer);
+      // the overload below uses ranks1 / ranks2 of the scratch only as input, so passing them is fine
+      return rankedMutualInformation(scratch.ranks1, scratch.ranks2, scratch);
+    }
+
+    double rankedMutualInformation(const std::vector<unsigned int>& ranks1, const std::vector<unsigned int>& ranks2, RankedMIScratch& scratch)
+    {
+      OPENSWATH_PRECONDITION(ranks1.size() != 0 && ranks1.size() == ranks2.size(), "Both rank vectors need to have the same length");
+
+      // Same estimate as calcMutualInformation (MIToolbox), but instead of a
+      // dense joint histogram of all state combinations the occupied joint
+      // states are sorted, which visits them in the same order.
+      const std::size_t n = ranks1.size();
+      const unsigned int nr_states1 = *std::max_element(ranks1.begin(), ranks1.end()) + 1;
+      const unsigned int nr_states2 = *std::max_element(ranks2.begin(), ranks2.end()) + 1;
+
+      scratch.counts1.assign(nr_states1, 0);
+      scratch.counts2.assign(nr_states2, 0);
+      scratch.joint_states.resize(n);
+      for (std::size_t i = 0; i < n; ++i)
+      {
+        ++scratch.counts1[ranks1[i]];
+        ++scratch.counts2[ranks2[i]];
+        scratch.joint_states[i] = ranks2[i] * nr_states1 + ranks1[i];
+      }
+      std::sort(scratch.joint_states.begin(), scratch.joint_states.end());
+
+      const double length = n;
+      double mutual_information = 0.0;
+      for (std::size_t i = 0; i < n; )
+      {
+        const unsigned int state = scratch.joint_states[i];
+        std::size_t j = i;
+        while (j < n && scratch.joint_states[j] == state) ++j;
+
+        const double p_joint = (j - i) / length;
+        const double p1 = scratch.counts1[state % nr_states1] / length;
+        const double p2 = scratch.counts2[state / nr_states1] / length;
+        mutual_information += p_joint * std::log(p_joint / p1 / p2);
+        i = j;
+      }
+      return mutual_information / std::log(2.0);
+    }
+
   } //end namespace Scoring
 }
@@ -41,4 +41,19 @@ namespace OpenSwath
   {
   }
 
+  std::vector<SpectrumPtr> ISpectrumAccess::getSpectraByIds(const std::vector<std::size_t>& ids)
+  {
+    std::vector<SpectrumPtr> spectra;
+    spectra.reserve(ids.size());
+    for (std::size_t k = 0; k < ids.size(); ++k)
+    {
+      spectra.push_back(getSpectrumById(static_cast<int>(ids[k])));
+    }
+    return spectra;
+  }
+
+  void ISpectrumAccess::prefetchSpectraByRT(double /* RT */, double /* deltaRT */)
+  {
+  }
+
 }
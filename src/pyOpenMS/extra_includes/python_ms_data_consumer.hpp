@@ -5,6 +5,21 @@
 #include <OpenMS/INTERFACES/IMSDataConsumer.h>
 #include <OpenMS/METADATA/ExperimentalSettings.h>
 
+#include <mutex>
+#include <vector>
+
+// Acquires the Python GIL for the lifetime of the object, so the consumers
+// below can be called from C++ code that runs without the GIL (i.e. inside a
+// 'with nogil' block of the wrapper).
+struct PythonGILGuard
+{
+    PythonGILGuard() : state_(PyGILState_Ensure()) {}
+    ~PythonGILGuard() { PyGILState_Release(state_); }
+
+    private:
+        PyGILState_STATE state_;
+};
+
 // see ../pxds/PythonMSDataConsumer.pxd for Cython def
 class PythonMSDataConsumer :
   virtual public OpenMS::Interfaces::IMSDataConsumer
@@ -45,6 +60,7 @@ class PythonMSDataConsumer :
         /// Destructor
         ~PythonMSDataConsumer()
         {
+           PythonGILGuard gil;
            Py_DECREF(py_consumer_);
         };
 
@@ -52,6 +68,7 @@ class PythonMSDataConsumer :
         /// Consume spectrum (call Python method "consumeSpectrum" of the py_consumer_ object from C++)
         virtual void consumeSpectrum(SpectrumType & spec)
         {
+            PythonGILGuard gil;
             PyObject * py_spec = wrap_spectrum_(spec);
             PyObject * method_name = PyUnicode_FromString("consumeSpectrum");
             PyObject * r = PyObject_CallMethodObjArgs(py_consumer_, method_name, py_spec, NULL);
@@ -66,6 +83,7 @@ class PythonMSDataConsumer :
         /// Consume chromatogram (call Python method "consumeChromatogram" of the py_consumer_ object from C++)
         virtual void consumeChromatogram(ChromatogramType & chrom)
         {
+            PythonGILGuard gil;
             PyObject * py_chrom = wrap_chromatogram_(chrom);
             PyObject * method_name = PyUnicode_FromString("consumeChromatogram");
             PyObject * r = PyObject_CallMethodObjArgs(py_consumer_, method_name, py_chrom, NULL);
@@ -80,6 +98,165 @@ class PythonMSDataConsumer :
         virtual void setExpectedSize(OpenMS::Size expectedSpectra,
                                      OpenMS::Size expectedChromatograms)
         {
+            PythonGILGuard gil;
+            PyObject * expected_spectra = PyInt_FromSize_t(expectedSpectra);
+            PyObject * expected_chromatograms = PyInt_FromSize_t(expectedChromatograms);
+            PyObject * method_name = PyUnicode_FromString("setExpectedSize");
+            PyObject * r = PyObject_CallMethodObjArgs(py_consumer_, method_name, expected_spectra,
+                                                      expected_chromatograms, NULL);
+            Py_DECREF(expected_spectra);
+            Py_DECREF(expected_chromatograms);
+            Py_DECREF(method_name);
+            // NULL indicates python exception:
+            if (r == NULL)
+                throw "exception"; // not sense needed, as cython evaluates python strack trace
+            Py_DECREF(r);
+        };
+
+        virtual void setExperimentalSettings(const OpenMS::ExperimentalSettings & exp_settings)
+        {
+            PythonGILGuard gil;
+            PyObject * py_exp_settings = wrap_experimental_settings_(exp_settings);
+            PyObject * method_name = PyUnicode_FromString("setExperimentalSettings");
+            PyObject * r = PyObject_CallMethodObjArgs(py_consumer_,
+                                                      method_name, py_exp_settings, NULL);
+
+            Py_DECREF(py_exp_settings);
+            Py_DECREF(method_name);
+            // NULL indicates python exception:
+            if (r == NULL)
+                throw "exception"; // not sense needed, as cython evaluates python strack trace
+            Py_DECREF(r);
+        };
+};
+
+// Consumer which collects spectra and chromatograms in C++ and passes them to
+// the Python object in batches ("consumeSpectra" / "consumeChromatograms" are
+// called with a list), so that the Python call overhead is paid once per batch.
+// The remaining items are passed on by flush() (called by the destructor).
+// The batches are guarded by a mutex and the GIL is only held while calling
+// Python, so the consumer can be used from C++ code running without the GIL.
+class PythonBatchingMSDataConsumer :
+  virtual public OpenMS::Interfaces::IMSDataConsumer
+{
+
+    typedef OpenMS::PeakMap::SpectrumType SpectrumType;
+    typedef OpenMS::PeakMap::ChromatogramType ChromatogramType;
+
+    typedef PyObject* (*SpectrumToPythonWrapper) (const SpectrumType &);
+    typedef PyObject* (*ChromatogramToPythonWrapper) (const ChromatogramType &);
+    typedef PyObject* (*ExperimentalSettingsToPythonWrapper) (const OpenMS::ExperimentalSettings &);
+
+    private:
+
+        PyObject *py_consumer_;
+
+        SpectrumToPythonWrapper wrap_spectrum_;
+        ChromatogramToPythonWrapper wrap_chromatogram_;
+        ExperimentalSettingsToPythonWrapper wrap_experimental_settings_;
+
+        OpenMS::Size batch_size_;
+        std::vector<SpectrumType> spectra_;
+        std::vector<ChromatogramType> chromatograms_;
+        std::mutex mutex_;
+
+        // wraps the items and calls 'method' of the Python consumer with a list of them (GIL must be held)
+        template <typename T, typename Wrapper>
+        void callPython_(const char * method, const std::vector<T> & items, Wrapper wrap)
+        {
+            PyObject * list = PyList_New(items.size());
+            for (size_t i = 0; i < items.size(); ++i)
+            {
+                PyList_SET_ITEM(list, i, wrap(items[i])); // steals the reference
+            }
+            PyObject * method_name = PyUnicode_FromString(method);
+            PyObject * r = PyObject_CallMethodObjArgs(py_consumer_, method_name, list, NULL);
+            Py_DECREF(list);
+            Py_DECREF(method_name);
+            // NULL indicates python exception:
+            if (r == NULL)
+                throw "exception"; // not sense needed, as cython evaluates python strack trace
+            Py_DECREF(r);
+        }
+
+        // passes the collected spectra on (the mutex must be held)
+        void flushSpectra_()
+        {
+            if (spectra_.empty()) return;
+            std::vector<SpectrumType> batch;
+            batch.swap(spectra_);
+            PythonGILGuard gil;
+            callPython_("consumeSpectra", batch, wrap_spectrum_);
+        }
+
+        // passes the collected chromatograms on (the mutex must be held)
+        void flushChromatograms_()
+        {
+            if (chromatograms_.empty()) return;
+            std::vector<ChromatogramType> batch;
+            batch.swap(chromatograms_);
+            PythonGILGuard gil;
+            callPython_("consumeChromatograms", batch, wrap_chromatogram_);
+        }
+
+    public:
+
+        /// Constructor (@p batch_size items are collected before Python is called)
+        PythonBatchingMSDataConsumer(PyObject *py_consumer,
+                                     SpectrumToPythonWrapper wrap_spectrum,
+                                     ChromatogramToPythonWrapper wrap_chromatogram,
+                                     ExperimentalSettingsToPythonWrapper wrap_experimental_settings,
+                                     OpenMS::Size batch_size) :
+          py_consumer_(py_consumer),
+          wrap_spectrum_(wrap_spectrum),
+          wrap_chromatogram_(wrap_chromatogram),
+          wrap_experimental_settings_(wrap_experimental_settings),
+          batch_size_(batch_size > 0 ? batch_size : 1)
+        {
+           Py_INCREF(py_consumer_);
+        };
+
+        /// Destructor (passes the remaining items on)
+        ~PythonBatchingMSDataConsumer()
+        {
+           try
+           {
+             flush();
+           }
+           catch (...)
+           {
+             // a destructor must not throw, the Python error stays set
+           }
+           PythonGILGuard gil;
+           Py_DECREF(py_consumer_);
+        };
+
+        /// Passes all collected spectra and chromatograms to the Python consumer
+        void flush()
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            flushSpectra_();
+            flushChromatograms_();
+        }
+
+        virtual void consumeSpectrum(SpectrumType & spec)
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            spectra_.push_back(spec);
+            if (spectra_.size() >= batch_size_) flushSpectra_();
+        };
+
+        virtual void consumeChromatogram(ChromatogramType & chrom)
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            chromatograms_.push_back(chrom);
+            if (chromatograms_.size() >= batch_size_) flushChromatograms_();
+        };
+
+        virtual void setExpectedSize(OpenMS::Size expectedSpectra,
+                                     OpenMS::Size expectedChromatograms)
+        {
+            PythonGILGuard gil;
             PyObject * expected_spectra = PyInt_FromSize_t(expectedSpectra);
             PyObject * expected_chromatograms = PyInt_FromSize_t(expectedChromatograms);
             PyObject * method_name = PyUnicode_FromString("setExpectedSize");
@@ -96,6 +273,7 @@ class PythonMSDataConsumer :
 
         virtual void setExperimentalSettings(const OpenMS::ExperimentalSettings & exp_settings)
         {
+            PythonGILGuard gil;
             PyObject * py_exp_settings = wrap_experimental_settings_(exp_settings);
             PyObject * method_name = PyUnicode_FromString("setExperimentalSettings");
             PyObject * r = PyObject_CallMethodObjArgs(py_consumer_,
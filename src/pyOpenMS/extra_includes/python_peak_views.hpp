@@ -0,0 +1,85 @@
+#ifndef __PYTHON_PEAK_VIEWS_HPP__
+#define __PYTHON_PEAK_VIEWS_HPP__
+
+#include <OpenMS/KERNEL/MSSpectrum.h>
+#include <OpenMS/KERNEL/MSChromatogram.h>
+
+#include <Python.h>
+#include <numpy/arrayobject.h>
+
+// Zero-copy NumPy views on the peak data of MSSpectrum / MSChromatogram.
+//
+// The peaks are stored as an array of structs (position, intensity), so the
+// views are strided 1D arrays pointing directly into the peak container. The
+// returned array keeps 'owner' (the Python wrapper of the spectrum or
+// chromatogram) alive. Changing the number of peaks (resize, push_back,
+// clear, ...) reallocates the container and invalidates existing views.
+//
+// Must be used in the extension module that called numpy's import_array().
+namespace PythonPeakViews
+{
+  // the views rely on the memory layout of the peak types
+  // (position followed by intensity, no padding in front of the intensity)
+  static_assert(sizeof(OpenMS::Peak1D::PositionType) == sizeof(double) &&
+                sizeof(OpenMS::Peak1D::IntensityType) == sizeof(float) &&
+                sizeof(OpenMS::Peak1D) == 2 * sizeof(double),
+                "unexpected memory layout of Peak1D");
+  static_assert(sizeof(OpenMS::ChromatogramPeak::PositionType) == sizeof(double) &&
+                sizeof(OpenMS::ChromatogramPeak::IntensityType) == sizeof(double) &&
+                sizeof(OpenMS::ChromatogramPeak) == 2 * sizeof(double),
+                "unexpected memory layout of ChromatogramPeak");
+
+  // creates a writeable 1D array view of 'size' elements of type 'typenum' starting at 'data'
+  inline PyObject* makeView_(void* data, npy_intp size, npy_intp stride, int typenum, PyObject* owner)
+  {
+    npy_intp dims[1] = {size};
+    npy_intp strides[1] = {stride};
+    // nothing to share for empty containers
+    if (size == 0) return PyArray_SimpleNew(1, dims, typenum);
+    PyObject* array = PyArray_New(&PyArray_Type, 1, dims, typenum, strides, data, 0, NPY_ARRAY_WRITEABLE, NULL);
+    if (array == NULL) return NULL;
+    Py_INCREF(owner);
+    if (PyArray_SetBaseObject(reinterpret_cast<PyArrayObject*>(array), owner) < 0)
+    {
+      Py_DECREF(array);
+      return NULL;
+    }
+    return array;
+  }
+
+  template <typename PeakContainerT>
+  inline char* peakData_(PeakContainerT& container)
+  {
+    return container.empty() ? NULL : reinterpret_cast<char*>(&container[0]);
+  }
+
+  /// m/z values of the spectrum (float64 view)
+  inline PyObject* mzView(OpenMS::MSSpectrum& spectrum, PyObject* owner)
+  {
+    return makeView_(peakData_(spectrum), spectrum.size(), sizeof(OpenMS::Peak1D), NPY_FLOAT64, owner);
+  }
+
+  /// intensities of the spectrum (float32 view)
+  inline PyObject* intensityView(OpenMS::MSSpectrum& spectrum, PyObject* owner)
+  {
+    char* data = peakData_(spectrum);
+    if (data != NULL) data += sizeof(OpenMS::Peak1D::PositionType);
+    return makeView_(data, spectrum.size(), sizeof(OpenMS::Peak1D), NPY_FLOAT32, owner);
+  }
+
+  /// retention times of the chromatogram (float64 view)
+  inline PyObject* rtView(OpenMS::MSChromatogram& chromatogram, PyObject* owner)
+  {
+    return makeView_(peakData_(chromatogram), chromatogram.size(), sizeof(OpenMS::ChromatogramPeak), NPY_FLOAT64, owner);
+  }
+
+  /// intensities of the chromatogram (float64 view)
+  inline PyObject* intensityView(OpenMS::MSChromatogram& chromatogram, PyObject* owner)
+  {
+    char* data = peakData_(chromatogram);
+    if (data != NULL) data += sizeof(OpenMS::ChromatogramPeak::PositionType);
+    return makeView_(data, chromatogram.size(), sizeof(OpenMS::ChromatogramPeak), NPY_FLOAT64, owner);
+  }
+}
+
+#endif
@@ -147,6 +147,8 @@ public:
     ///////////////////////////////////////////////////////////////////////////////
     // inputs raw /centroided  data into the object:
     void add_scan_raw_data(int, double, CentroidData *);
+    // inputs centroided peaks (before deisotoping) and their deisotoped peaks into the object:
+    void add_scan_raw_data(int, double, std::list<CentroidPeak> &, std::list<DeconvPeak> &);
     // inputs raw data into the object:
     void add_scan_raw_data(std::vector<MSPeak>);
 
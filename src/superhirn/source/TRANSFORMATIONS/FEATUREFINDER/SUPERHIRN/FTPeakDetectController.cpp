@@ -50,11 +50,14 @@
 #include <iostream>
 #include <iomanip>
 #include <cstdio>
+#include <algorithm>
 
 #include <OpenMS/TRANSFORMATIONS/FEATUREFINDER/SUPERHIRN/RawData.h>
 #include <OpenMS/TRANSFORMATIONS/FEATUREFINDER/SUPERHIRN/MSPeak.h>
 #include <OpenMS/TRANSFORMATIONS/FEATUREFINDER/SUPERHIRN/CentroidPeak.h>
 #include <OpenMS/TRANSFORMATIONS/FEATUREFINDER/SUPERHIRN/CentroidData.h>
+#include <OpenMS/TRANSFORMATIONS/FEATUREFINDER/SUPERHIRN/Deisotoper.h>
+#include <OpenMS/TRANSFORMATIONS/FEATUREFINDER/SUPERHIRN/IsotopicDist.h>
 #include <OpenMS/TRANSFORMATIONS/FEATUREFINDER/SUPERHIRN/SuperHirnParameters.h>
 #include <OpenMS/TRANSFORMATIONS/FEATUREFINDER/SUPERHIRN/LCElutionPeak.h>
 #include <OpenMS/TRANSFORMATIONS/FEATUREFINDER/SUPERHIRN/BackgroundIntensityBin.h>
@@ -117,25 +120,56 @@ namespace OpenMS
     lcms_->set_spectrum_ID((int) this->lcmsRuns_.size());
 
     ProcessData * dataProcessor = new ProcessData();
-    unsigned int i;
 
-    for (i = 0; i < datavec.size(); i++)
-    {
-      Map it = datavec.at(i);
+    // the isotope tables are initialized lazily, do it before the threads use them
+    IsotopicDist::init();
 
-      dataProcessor->setMaxScanDistance(0);
-      if ((it.first >= SuperHirnParameters::instance()->getMinTR()) &&
-          (it.first <= SuperHirnParameters::instance()->getMaxTR()))
+    // centroiding and deisotoping of a scan does not depend on the other scans
+    // and is done in parallel (in blocks of scans to limit memory usage), the results
+    // are then added to the LC elution profiles in scan order
+    const SignedSize block_size = 512;
+    for (SignedSize block_start = 0; block_start < (SignedSize) datavec.size(); block_start += block_size)
+    {
+      const SignedSize block_end = std::min(block_start + block_size, (SignedSize) datavec.size());
+      std::vector<char> in_range(block_end - block_start, 0);
+      std::vector<list<CentroidPeak> > centroid_peaks(block_end - block_start);
+      std::vector<list<DeconvPeak> > deconv_peaks(block_end - block_start);
+
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic)
+#endif
+      for (SignedSize i = block_start; i < block_end; ++i)
       {
-        SuperHirnParameters::instance()->getScanTRIndex()->insert(std::pair<int, float>(i, (float) it.first));
-
-        // centroid it:
-        CentroidData cd(SuperHirnParameters::instance()->getCentroidWindowWidth(), it.second, it.first,
-                        SuperHirnParameters::instance()->centroidDataModus());
+        const Map & it = datavec[i];
+        if ((it.first >= SuperHirnParameters::instance()->getMinTR()) &&
+            (it.first <= SuperHirnParameters::instance()->getMaxTR()))
+        {
+          in_range[i - block_start] = 1;
+
+          // centroid it:
+          CentroidData cd(SuperHirnParameters::instance()->getCentroidWindowWidth(), it.second, it.first,
+                          SuperHirnParameters::instance()->centroidDataModus());
+          // the centroid peaks are modified by the deisotoper, get them before
+          cd.get(centroid_peaks[i - block_start]);
+
+          // deisotope it:
+          Deisotoper dei;
+          dei.go(cd);
+          dei.cleanDeconvPeaks();
+          deconv_peaks[i - block_start].swap(dei.getDeconvPeaks());
+        }
+      }
 
-        //  store it:
-        dataProcessor->add_scan_raw_data(i, it.first, &cd);
+      for (SignedSize i = block_start; i < block_end; ++i)
+      {
+        dataProcessor->setMaxScanDistance(0);
+        if (in_range[i - block_start])
+        {
+          SuperHirnParameters::instance()->getScanTRIndex()->insert(std::pair<int, float>((int) i, (float) datavec[i].first));
 
+          //  store it:
+          dataProcessor->add_scan_raw_data((int) i, datavec[i].first, centroid_peaks[i - block_start], deconv_peaks[i - block_start]);
+        }
       }
     }
 
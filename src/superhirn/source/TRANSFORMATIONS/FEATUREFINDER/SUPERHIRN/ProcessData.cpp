@@ -310,18 +310,30 @@ namespace OpenMS
 
     Deisotoper dei;
 
-    //////////////////////////////////
-    // add the peaks to the background controller:
+    // the centroid peaks are modified by the deisotoper, get them before
     list<CentroidPeak> pCentroidPeaks;
     centroidedData->get(pCentroidPeaks);
-    backgroundController->addPeakMSScan(TR, &pCentroidPeaks);
 
     dei.go(*centroidedData);
     dei.cleanDeconvPeaks();
 
+    this->add_scan_raw_data(SCAN, TR, pCentroidPeaks, dei.getDeconvPeaks());
+
+  }
+
+///////////////////////////////////////////////////////////////////////////////
+// inputs centroided peaks and their deisotoped peaks into the object
+// (deisotoping does not depend on the object and can be done in parallel beforehand):
+  void ProcessData::add_scan_raw_data(int SCAN, double TR, list<CentroidPeak> & centroidPeaks, list<DeconvPeak> & deconvPeaks)
+  {
+
+    //////////////////////////////////
+    // add the peaks to the background controller:
+    backgroundController->addPeakMSScan(TR, &centroidPeaks);
+
     // convert to objects used for mass clustering over retention time
     vector<MSPeak> PEAK_LIST;
-    convert_ms_peaks(SCAN, TR, dei.getDeconvPeaks(), PEAK_LIST);
+    convert_ms_peaks(SCAN, TR, deconvPeaks, PEAK_LIST);
 
     //  store it:
     this->add_scan_raw_data(PEAK_LIST);
@@ -0,0 +1,362 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2018.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: Timo Sachsenberg $
+// $Authors: Timo Sachsenberg $
+// --------------------------------------------------------------------------
+
+#include "Benchmark.h"
+
+#include <OpenMS/CONCEPT/Exception.h>
+#include <OpenMS/CONCEPT/VersionInfo.h>
+#include <OpenMS/DATASTRUCTURES/String.h>
+#include <OpenMS/SYSTEM/ExecutionResources.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <sstream>
+
+using namespace OpenMS;
+using namespace OpenMS::Benchmark;
+
+namespace OpenMS
+{
+namespace Benchmark
+{
+  /// upper bound for the number of iterations of very fast benchmarks
+  static const Size MAX_ITERATIONS = 1000000;
+
+  State::State(double min_time, Size min_iterations) :
+    min_time_(min_time),
+    min_iterations_(min_iterations),
+    running_(false),
+    paused_(false),
+    paused_ns_(0.0),
+    items_(0),
+    bytes_(0)
+  {
+  }
+
+  bool State::keepRunning()
+  {
+    if (paused_) resumeTiming();
+    Clock::time_point now = Clock::now();
+    if (running_)
+    {
+      times_.push_back(std::chrono::duration<double, std::nano>(now - iteration_start_).count() - paused_ns_);
+    }
+    else
+    {
+      running_ = true;
+      start_ = now;
+    }
+
+    double elapsed = std::chrono::duration<double>(now - start_).count();
+    if ((times_.size() >= min_iterations_ && elapsed >= min_time_) || times_.size() >= MAX_ITERATIONS)
+    {
+      running_ = false;
+      return false;
+    }
+    paused_ns_ = 0.0;
+    iteration_start_ = Clock::now();
+    return true;
+  }
+
+  void State::pauseTiming()
+  {
+    if (paused_) return;
+    paused_ = true;
+    pause_start_ = Clock::now();
+  }
+
+  void State::resumeTiming()
+  {
+    if (!paused_) return;
+    paused_ = false;
+    paused_ns_ += std::chrono::duration<double, std::nano>(Clock::now() - pause_start_).count();
+  }
+
+  void State::setItemsProcessed(Size items)
+  {
+    items_ = items;
+  }
+
+  void State::setBytesProcessed(Size bytes)
+  {
+    bytes_ = bytes;
+  }
+
+  const std::vector<double>& State::getIterationTimes() const
+  {
+    return times_;
+  }
+
+  Size State::getItemsProcessed() const
+  {
+    return items_;
+  }
+
+  Size State::getBytesProcessed() const
+  {
+    return bytes_;
+  }
+
+  Registration::Registration(const std::string& name, Function function)
+  {
+    getBenchmarks().push_back(std::make_pair(name, function));
+  }
+
+  std::vector<std::pair<std::string, Function> >& getBenchmarks()
+  {
+    static std::vector<std::pair<std::string, Function> > benchmarks;
+    return benchmarks;
+  }
+
+} // namespace Benchmark
+} // namespace OpenMS
+
+namespace
+{
+  struct Result
+  {
+    std::string name;
+    Size iterations = 0;
+    double median_ns = 0.0;
+    double mean_ns = 0.0;
+    double min_ns = 0.0;
+    double stddev_ns = 0.0;
+    double items_per_second = 0.0;
+    double bytes_per_second = 0.0;
+    std::string error;
+  };
+
+  Result evaluate(const std::string& name, const State& state)
+  {
+    Result r;
+    r.name = name;
+    std::vector<double> times = state.getIterationTimes();
+    r.iterations = times.size();
+    if (times.empty()) return r;
+
+    std::sort(times.begin(), times.end());
+    r.min_ns = times.front();
+    r.median_ns = (times.size() % 2 == 1 ? times[times.size() / 2] : (times[times.size() / 2 - 1] + times[times.size() / 2]) / 2);
+    double sum = 0.0;
+    for (double t : times) sum += t;
+    r.mean_ns = sum / times.size();
+    double sq = 0.0;
+    for (double t : times) sq += (t - r.mean_ns) * (t - r.mean_ns);
+    r.stddev_ns = (times.size() > 1 ? std::sqrt(sq / (times.size() - 1)) : 0.0);
+    if (r.median_ns > 0.0)
+    {
+      r.items_per_second = state.getItemsProcessed() * 1e9 / r.median_ns;
+      r.bytes_per_second = state.getBytesProcessed() * 1e9 / r.median_ns;
+    }
+    return r;
+  }
+
+  std::string escapeJSON(const std::string& s)
+  {
+    std::string out;
+    for (char c : s)
+    {
+      if (c == '"' || c == '\\') out += '\\';
+      out += c;
+    }
+    return out;
+  }
+
+  void storeJSON(const std::string& filename, const std::vector<Result>& results, Int threads, double min_time)
+  {
+    std::ofstream os(filename.c_str());
+    if (!os)
+    {
+      throw Exception::UnableToCreateFile(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, filename);
+    }
+    os.precision(12);
+    os << "{\n"
+       << "  \"openms_version\": \"" << escapeJSON(VersionInfo::getVersion()) << "\",\n"
+       << "  \"revision\": \"" << escapeJSON(VersionInfo::getRevision()) << "\",\n"
+       << "  \"threads\": " << threads << ",\n"
+       << "  \"min_time\": " << min_time << ",\n"
+       << "  \"benchmarks\": [";
+    for (Size i = 0; i < results.size(); ++i)
+    {
+      const Result& r = results[i];
+      os << (i == 0 ? "\n" : ",\n")
+         << "    {\"name\": \"" << escapeJSON(r.name) << "\", \"iterations\": " << r.iterations
+         << ", \"median_ns\": " << r.median_ns << ", \"mean_ns\": " << r.mean_ns
+         << ", \"min_ns\": " << r.min_ns << ", \"stddev_ns\": " << r.stddev_ns
+         << ", \"items_per_second\": " << r.items_per_second << ", \"bytes_per_second\": " << r.bytes_per_second
+         << ", \"error\": \"" << escapeJSON(r.error) << "\"}";
+    }
+    os << "\n  ]\n}\n";
+  }
+
+  /// reads the median times of a file written by storeJSON()
+  std::map<std::string, double> loadBaseline(const std::string& filename)
+  {
+    std::ifstream is(filename.c_str());
+    if (!is)
+    {
+      throw Exception::FileNotFound(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, filename);
+    }
+    std::stringstream buffer;
+    buffer << is.rdbuf();
+    const std::string json = buffer.str();
+
+    std::map<std::string, double> medians;
+    const std::string name_key = "\"name\": \"", median_key = "\"median_ns\": ";
+    for (std::string::size_type pos = json.find(name_key); pos != std::string::npos; pos = json.find(name_key, pos))
+    {
+      pos += name_key.size();
+      std::string::size_type name_end = json.find('"', pos);
+      std::string::size_type median = json.find(median_key, name_end);
+      if (name_end == std::string::npos || median == std::string::npos) break;
+      medians[json.substr(pos, name_end - pos)] = String(json.substr(median + median_key.size(), json.find(',', median) - median - median_key.size())).toDouble();
+    }
+    return medians;
+  }
+
+  void printUsage()
+  {
+    std::cerr << "openms_benchmarks -- performance benchmarks of OpenMS core algorithms\n\n"
+              << "Options:\n"
+              << "  --list                 list all benchmarks and exit\n"
+              << "  --filter <text>        run only benchmarks whose name contains <text>\n"
+              << "  --min_time <seconds>   minimal time to repeat each benchmark (default: 0.5)\n"
+              << "  --min_iterations <n>   minimal number of repetitions (default: 3)\n"
+              << "  --threads <n>          number of threads (default: 1)\n"
+              << "  --out <file>           write the results as JSON\n"
+              << "  --baseline <file>      compare with the results of an earlier run (JSON written by --out)\n"
+              << "  --threshold <fraction> slowdown (median time) reported as regression (default: 0.1)\n\n"
+              << "The exit code is 1 if a benchmark failed or a regression was found.\n";
+  }
+}
+
+int main(int argc, const char** argv)
+{
+  String filter, out_file, baseline_file;
+  double min_time = 0.5, threshold = 0.1;
+  Size min_iterations = 3;
+  Int threads = 1;
+  bool list = false;
+  for (int i = 1; i < argc; ++i)
+  {
+    String arg(argv[i]);
+    bool has_value = (i + 1 < argc);
+    if (arg == "--list") list = true;
+    else if (arg == "--filter" && has_value) filter = argv[++i];
+    else if (arg == "--min_time" && has_value) min_time = String(argv[++i]).toDouble();
+    else if (arg == "--min_iterations" && has_value) min_iterations = String(argv[++i]).toInt();
+    else if (arg == "--threads" && has_value) threads = String(argv[++i]).toInt();
+    else if (arg == "--out" && has_value) out_file = argv[++i];
+    else if (arg == "--baseline" && has_value) baseline_file = argv[++i];
+    else if (arg == "--threshold" && has_value) threshold = String(argv[++i]).toDouble();
+    else
+    {
+      printUsage();
+      return arg == "--help" ? 0 : 1;
+    }
+  }
+
+  if (list)
+  {
+    for (const auto& benchmark : getBenchmarks()) std::cout << benchmark.first << "\n";
+    return 0;
+  }
+
+  ExecutionResources::setThreads(threads);
+
+  int exit_code = 0;
+  std::vector<Result> results;
+  std::printf("%-50s %10s %14s %14s %16s\n", "benchmark", "iterations", "median [ms]", "min [ms]", "items/s");
+  for (const auto& benchmark : getBenchmarks())
+  {
+    if (!filter.empty() && !String(benchmark.first).hasSubstring(filter)) continue;
+
+    State state(min_time, min_iterations);
+    Result r;
+    try
+    {
+      benchmark.second(state);
+      r = evaluate(benchmark.first, state);
+    }
+    catch (std::exception& e)
+    {
+      r.name = benchmark.first;
+      r.error = e.what();
+      exit_code = 1;
+    }
+    if (r.error.empty())
+    {
+      std::printf("%-50s %10lu %14.4f %14.4f %16.1f\n", r.name.c_str(), (unsigned long)r.iterations, r.median_ns / 1e6, r.min_ns / 1e6, r.items_per_second);
+    }
+    else
+    {
+      std::printf("%-50s failed: %s\n", r.name.c_str(), r.error.c_str());
+    }
+    std::fflush(stdout);
+    results.push_back(r);
+  }
+
+  try
+  {
+    if (!out_file.empty())
+    {
+      storeJSON(out_file, results, threads, min_time);
+    }
+
+    if (!baseline_file.empty())
+    {
+      std::map<std::string, double> baseline = loadBaseline(baseline_file);
+      std::printf("\n%-50s %14s %14s %10s\n", "benchmark", "baseline [ms]", "current [ms]", "ratio");
+      for (const Result& r : results)
+      {
+        std::map<std::string, double>::const_iterator it = baseline.find(r.name);
+        if (it == baseline.end() || it->second <= 0.0 || !r.error.empty()) continue;
+        double ratio = r.median_ns / it->second;
+        bool regression = ratio > 1.0 + threshold;
+        std::printf("%-50s %14.4f %14.4f %10.3f%s\n", r.name.c_str(), it->second / 1e6, r.median_ns / 1e6, ratio, regression ? "  REGRESSION" : "");
+        if (regression) exit_code = 1;
+      }
+    }
+  }
+  catch (Exception::BaseException& e)
+  {
+    std::cerr << "Error: " << e.what() << std::endl;
+    return 1;
+  }
+  return exit_code;
+}
@@ -0,0 +1,144 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2018.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: Timo Sachsenberg $
+// $Authors: Timo Sachsenberg $
+// --------------------------------------------------------------------------
+
+#pragma once
+
+#include <OpenMS/CONCEPT/Types.h>
+
+#include <chrono>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace OpenMS
+{
+namespace Benchmark
+{
+  /**
+    @brief Controls the repetitions of a benchmark and records their timings
+
+    A benchmark function prepares its input and then repeats the code to be
+    measured as long as keepRunning() returns true:
+
+    @code
+    OPENMS_BENCHMARK(Base64_decode)
+    {
+      String encoded = ...; // not measured
+      std::vector<double> decoded;
+      while (state.keepRunning())
+      {
+        Base64::decode(encoded, Base64::BYTEORDER_LITTLEENDIAN, decoded);
+      }
+      state.setItemsProcessed(decoded.size());
+    }
+    @endcode
+
+    Iterations are repeated until at least the minimal time has passed and
+    the minimal number of iterations was run. Work that should not be
+    measured within the loop can be excluded with pauseTiming() and
+    resumeTiming().
+  */
+  class State
+  {
+public:
+    /// Constructor
+    State(double min_time, Size min_iterations);
+
+    /// Finishes the timing of the previous iteration and returns whether another one should be run
+    bool keepRunning();
+
+    /// Stops the clock (within an iteration)
+    void pauseTiming();
+
+    /// Restarts the clock after pauseTiming()
+    void resumeTiming();
+
+    /// Sets the number of items (e.g. spectra or peptides) processed per iteration (for throughput reporting)
+    void setItemsProcessed(Size items);
+
+    /// Sets the number of bytes processed per iteration (for throughput reporting)
+    void setBytesProcessed(Size bytes);
+
+    /// Times of all iterations in nanoseconds
+    const std::vector<double>& getIterationTimes() const;
+
+    Size getItemsProcessed() const;
+
+    Size getBytesProcessed() const;
+
+private:
+    typedef std::chrono::steady_clock Clock;
+
+    double min_time_;
+    Size min_iterations_;
+    bool running_;
+    bool paused_;
+    Clock::time_point start_;
+    Clock::time_point iteration_start_;
+    Clock::time_point pause_start_;
+    double paused_ns_;
+    std::vector<double> times_;
+    Size items_;
+    Size bytes_;
+  };
+
+  /// A benchmark function
+  typedef std::function<void (State&)> Function;
+
+  /// Registers benchmark @p function under @p name (see OPENMS_BENCHMARK)
+  struct Registration
+  {
+    Registration(const std::string& name, Function function);
+  };
+
+  /// All registered benchmarks (in order of registration within each source file)
+  std::vector<std::pair<std::string, Function> >& getBenchmarks();
+
+  /// Keeps the compiler from optimizing away the computation of @p value
+  template <typename T>
+  inline void doNotOptimize(const T& value)
+  {
+    // the address escapes into an opaque volatile store
+    static const void* volatile sink;
+    sink = &value;
+  }
+
+} // namespace Benchmark
+} // namespace OpenMS
+
+/// Defines and registers a benchmark; the body gets an OpenMS::Benchmark::State& named @p state
+#define OPENMS_BENCHMARK(name) \
+  static void openms_benchmark_ ## name(OpenMS::Benchmark::State& state); \
+  static OpenMS::Benchmark::Registration openms_benchmark_registration_ ## name(#name, openms_benchmark_ ## name); \
+  static void openms_benchmark_ ## name(OpenMS::Benchmark::State& state)
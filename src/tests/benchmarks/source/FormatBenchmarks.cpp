@@ -0,0 +1,118 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2018.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: Timo Sachsenberg $
+// $Authors: Timo Sachsenberg $
+// --------------------------------------------------------------------------
+
+#include "Benchmark.h"
+#include "SyntheticData.h"
+
+#include <OpenMS/FORMAT/Base64.h>
+#include <OpenMS/FORMAT/MzMLFile.h>
+#include <OpenMS/SYSTEM/File.h>
+
+#include <QtCore/QFileInfo>
+
+#include <algorithm>
+#include <random>
+
+using namespace OpenMS;
+using namespace OpenMS::Benchmark;
+
+namespace
+{
+  std::vector<double> randomValues(Size count)
+  {
+    std::mt19937 rng(42);
+    std::uniform_real_distribution<double> value(200.0, 2000.0);
+    std::vector<double> values(count);
+    for (double& v : values) v = value(rng);
+    std::sort(values.begin(), values.end()); // m/z arrays are sorted, which matters for compression
+    return values;
+  }
+}
+
+OPENMS_BENCHMARK(Base64_decode_64bit)
+{
+  std::vector<double> values = randomValues(1000000);
+  String encoded;
+  Base64::encode(values, Base64::BYTEORDER_LITTLEENDIAN, encoded, false);
+  std::vector<double> decoded;
+  while (state.keepRunning())
+  {
+    Base64::decode(encoded, Base64::BYTEORDER_LITTLEENDIAN, decoded, false);
+    doNotOptimize(decoded);
+  }
+  state.setItemsProcessed(decoded.size());
+  state.setBytesProcessed(encoded.size());
+}
+
+OPENMS_BENCHMARK(Base64_decode_64bit_zlib)
+{
+  std::vector<double> values = randomValues(1000000);
+  String encoded;
+  Base64::encode(values, Base64::BYTEORDER_LITTLEENDIAN, encoded, true);
+  std::vector<double> decoded;
+  while (state.keepRunning())
+  {
+    Base64::decode(encoded, Base64::BYTEORDER_LITTLEENDIAN, decoded, true);
+    doNotOptimize(decoded);
+  }
+  state.setItemsProcessed(decoded.size());
+  state.setBytesProcessed(encoded.size());
+}
+
+OPENMS_BENCHMARK(MzMLFile_load)
+{
+  const PeakMap& exp = SyntheticData::getSimulatedProfileMap();
+  const String& filename = File::getTemporaryFile();
+  MzMLFile().store(filename, exp);
+
+  PeakMap loaded;
+  while (state.keepRunning())
+  {
+    MzMLFile().load(filename, loaded);
+  }
+  state.setItemsProcessed(loaded.size());
+  state.setBytesProcessed(Size(QFileInfo(filename.toQString()).size()));
+}
+
+OPENMS_BENCHMARK(MzMLFile_store)
+{
+  const PeakMap& exp = SyntheticData::getSimulatedProfileMap();
+  const String& filename = File::getTemporaryFile();
+  while (state.keepRunning())
+  {
+    MzMLFile().store(filename, exp);
+  }
+  state.setItemsProcessed(exp.size());
+  state.setBytesProcessed(Size(QFileInfo(filename.toQString()).size()));
+}
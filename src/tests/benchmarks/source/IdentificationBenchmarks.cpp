@@ -0,0 +1,95 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2018.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: Timo Sachsenberg $
+// $Authors: Timo Sachsenberg $
+// --------------------------------------------------------------------------
+
+#include "Benchmark.h"
+#include "SyntheticData.h"
+
+#include <OpenMS/ANALYSIS/ID/PeptideIndexing.h>
+#include <OpenMS/CHEMISTRY/TheoreticalSpectrumGenerator.h>
+#include <OpenMS/METADATA/PeptideIdentification.h>
+#include <OpenMS/METADATA/ProteinIdentification.h>
+
+using namespace OpenMS;
+using namespace OpenMS::Benchmark;
+
+OPENMS_BENCHMARK(TheoreticalSpectrumGenerator_getSpectrum)
+{
+  std::vector<AASequence> peptides = SyntheticData::createPeptides(SyntheticData::createProteins(50, 400), 1000);
+  TheoreticalSpectrumGenerator tsg;
+  PeakSpectrum spectrum;
+  while (state.keepRunning())
+  {
+    for (const AASequence& peptide : peptides)
+    {
+      spectrum.clear(true);
+      tsg.getSpectrum(spectrum, peptide, 1, 2);
+    }
+    doNotOptimize(spectrum);
+  }
+  state.setItemsProcessed(peptides.size());
+}
+
+OPENMS_BENCHMARK(PeptideIndexing_run)
+{
+  // 5000 peptides of 2000 proteins, 10% of them not contained in the database
+  const std::vector<FASTAFile::FASTAEntry> proteins = SyntheticData::createProteins(2000, 400);
+  std::vector<AASequence> peptides = SyntheticData::createPeptides(proteins, 4500);
+  std::vector<AASequence> unmatched = SyntheticData::createPeptides(SyntheticData::createProteins(100, 400, 7), 500);
+  peptides.insert(peptides.end(), unmatched.begin(), unmatched.end());
+
+  std::vector<PeptideIdentification> pep_ids_template;
+  for (const AASequence& peptide : peptides)
+  {
+    PeptideIdentification id;
+    id.insertHit(PeptideHit(1.0, 1, 2, peptide));
+    pep_ids_template.push_back(id);
+  }
+
+  PeptideIndexing indexer;
+  Param p = indexer.getParameters();
+  p.setValue("missing_decoy_action", "silent");
+  indexer.setParameters(p);
+  indexer.setLogType(ProgressLogger::NONE);
+  while (state.keepRunning())
+  {
+    state.pauseTiming();
+    std::vector<FASTAFile::FASTAEntry> db = proteins;
+    std::vector<ProteinIdentification> prot_ids(1);
+    std::vector<PeptideIdentification> pep_ids = pep_ids_template;
+    state.resumeTiming();
+
+    indexer.run(db, prot_ids, pep_ids);
+  }
+  state.setItemsProcessed(peptides.size());
+}
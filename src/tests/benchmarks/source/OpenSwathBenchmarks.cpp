@@ -0,0 +1,117 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2018.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: Timo Sachsenberg $
+// $Authors: Timo Sachsenberg $
+// --------------------------------------------------------------------------
+
+#include "Benchmark.h"
+#include "SyntheticData.h"
+
+#include <OpenMS/ANALYSIS/OPENSWATH/ChromatogramExtractorAlgorithm.h>
+#include <OpenMS/ANALYSIS/OPENSWATH/DATAACCESS/SimpleOpenMSSpectraAccessFactory.h>
+#include <OpenMS/OPENSWATHALGO/ALGO/MRMScoring.h>
+#include <OpenMS/OPENSWATHALGO/DATAACCESS/MockObjects.h>
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+
+using namespace OpenMS;
+using namespace OpenMS::Benchmark;
+
+OPENMS_BENCHMARK(ChromatogramExtractorAlgorithm_extractChromatograms)
+{
+  // extract an XIC (+- 30 s) for each simulated feature from the simulated map
+  boost::shared_ptr<PeakMap> exp(new PeakMap(SyntheticData::getSimulatedProfileMap()));
+  OpenSwath::SpectrumAccessPtr input = SimpleOpenMSSpectraFactory::getSpectrumAccessOpenMSPtr(exp);
+
+  std::vector<ChromatogramExtractorAlgorithm::ExtractionCoordinates> coordinates;
+  for (const Feature& f : SyntheticData::getSimulatedFeatures())
+  {
+    ChromatogramExtractorAlgorithm::ExtractionCoordinates c;
+    c.mz = f.getMZ();
+    c.rt_start = f.getRT() - 30.0;
+    c.rt_end = f.getRT() + 30.0;
+    c.id = String(coordinates.size());
+    coordinates.push_back(c);
+  }
+  std::sort(coordinates.begin(), coordinates.end(), ChromatogramExtractorAlgorithm::ExtractionCoordinates::SortExtractionCoordinatesByMZ);
+
+  ChromatogramExtractorAlgorithm extractor;
+  std::vector<OpenSwath::ChromatogramPtr> output;
+  while (state.keepRunning())
+  {
+    state.pauseTiming();
+    output.clear();
+    for (Size i = 0; i < coordinates.size(); ++i)
+    {
+      output.push_back(OpenSwath::ChromatogramPtr(new OpenSwath::Chromatogram));
+    }
+    state.resumeTiming();
+
+    extractor.extractChromatograms(input, output, coordinates, 20.0, true, -1.0, "tophat");
+  }
+  state.setItemsProcessed(exp->size());
+}
+
+OPENMS_BENCHMARK(MRMScoring_xcorr)
+{
+  // a peak group of 12 transitions with Gaussian elution profiles of 300 points
+  const Size transitions = 12, points = 300;
+  std::mt19937 rng(42);
+  std::normal_distribution<double> noise(0.0, 0.05);
+  std::uniform_real_distribution<double> shift(-3.0, 3.0);
+  OpenSwath::MockMRMFeature feature;
+  std::vector<std::string> native_ids;
+  for (Size t = 0; t < transitions; ++t)
+  {
+    boost::shared_ptr<OpenSwath::MockFeature> xic(new OpenSwath::MockFeature);
+    const double apex = points / 2.0 + shift(rng), height = 1000.0 * (t + 1);
+    for (Size i = 0; i < points; ++i)
+    {
+      const double d = (i - apex) / 20.0;
+      xic->m_rt_vec.push_back(1000.0 + i);
+      xic->m_intensity_vec.push_back(std::max(0.0, height * (std::exp(-0.5 * d * d) + noise(rng))));
+    }
+    native_ids.push_back("transition_" + String(t));
+    feature.m_features[native_ids.back()] = xic;
+  }
+
+  double score = 0.0;
+  while (state.keepRunning())
+  {
+    OpenSwath::MRMScoring scoring;
+    scoring.initializeXCorrMatrix(&feature, native_ids);
+    score += scoring.calcXcorrCoelutionScore() + scoring.calcXcorrShapeScore();
+    doNotOptimize(score);
+  }
+  state.setItemsProcessed(transitions * (transitions + 1) / 2);
+}
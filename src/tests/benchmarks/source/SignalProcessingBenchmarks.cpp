@@ -0,0 +1,146 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2018.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: Timo Sachsenberg $
+// $Authors: Timo Sachsenberg $
+// --------------------------------------------------------------------------
+
+#include "Benchmark.h"
+#include "SyntheticData.h"
+
+#include <OpenMS/ANALYSIS/MAPMATCHING/QTClusterFinder.h>
+#include <OpenMS/FILTERING/DATAREDUCTION/ElutionPeakDetection.h>
+#include <OpenMS/FILTERING/DATAREDUCTION/FeatureFindingMetabo.h>
+#include <OpenMS/FILTERING/DATAREDUCTION/MassTraceDetection.h>
+#include <OpenMS/KERNEL/ConsensusMap.h>
+#include <OpenMS/KERNEL/MassTrace.h>
+#include <OpenMS/TRANSFORMATIONS/RAW2PEAK/PeakPickerHiRes.h>
+
+#include <random>
+
+using namespace OpenMS;
+using namespace OpenMS::Benchmark;
+
+OPENMS_BENCHMARK(PeakPickerHiRes_pick)
+{
+  MSSpectrum input = SyntheticData::createProfileSpectrum(5000), output;
+  PeakPickerHiRes pp;
+  while (state.keepRunning())
+  {
+    pp.pick(input, output);
+    doNotOptimize(output);
+  }
+  state.setItemsProcessed(input.size());
+}
+
+OPENMS_BENCHMARK(PeakPickerHiRes_pickExperiment)
+{
+  const PeakMap& input = SyntheticData::getSimulatedProfileMap();
+  PeakMap output;
+  PeakPickerHiRes pp;
+  while (state.keepRunning())
+  {
+    pp.pickExperiment(input, output, false);
+  }
+  state.setItemsProcessed(input.size());
+}
+
+OPENMS_BENCHMARK(MassTraceDetection_run)
+{
+  const PeakMap& input = SyntheticData::getSimulatedCentroidedMap();
+  MassTraceDetection mtd;
+  std::vector<MassTrace> traces;
+  while (state.keepRunning())
+  {
+    traces.clear();
+    mtd.run(input, traces);
+  }
+  state.setItemsProcessed(input.size());
+}
+
+OPENMS_BENCHMARK(FeatureFindingMetabo_run)
+{
+  // mass traces as computed by the FeatureFinderMetabo tool (not measured)
+  std::vector<MassTrace> traces, split_traces, final_traces;
+  MassTraceDetection().run(SyntheticData::getSimulatedCentroidedMap(), traces);
+  ElutionPeakDetection epd;
+  epd.detectPeaks(traces, split_traces);
+  epd.filterByPeakWidth(split_traces, final_traces);
+
+  FeatureFindingMetabo ffm;
+  FeatureMap features;
+  std::vector<std::vector<MSChromatogram> > chromatograms;
+  while (state.keepRunning())
+  {
+    state.pauseTiming();
+    std::vector<MassTrace> input = final_traces;
+    features.clear(true);
+    chromatograms.clear();
+    state.resumeTiming();
+
+    ffm.run(input, features, chromatograms);
+  }
+  state.setItemsProcessed(final_traces.size());
+}
+
+OPENMS_BENCHMARK(QTClusterFinder_run)
+{
+  // three replicates of the simulated features with some RT and m/z deviation
+  const FeatureMap& simulated = SyntheticData::getSimulatedFeatures();
+  std::mt19937 rng(42);
+  std::normal_distribution<double> rt_shift(0.0, 5.0), mz_shift(0.0, 0.002);
+  std::vector<FeatureMap> maps(3, simulated);
+  for (Size i = 0; i < maps.size(); ++i)
+  {
+    for (Feature& f : maps[i])
+    {
+      f.setRT(f.getRT() + rt_shift(rng));
+      f.setMZ(f.getMZ() + mz_shift(rng));
+    }
+    maps[i].updateRanges();
+  }
+
+  QTClusterFinder qt;
+  Param p = qt.getParameters();
+  p.setValue("distance_RT:max_difference", 30.0);
+  p.setValue("distance_MZ:max_difference", 10.0);
+  p.setValue("distance_MZ:unit", "ppm");
+  qt.setParameters(p);
+  ConsensusMap result;
+  while (state.keepRunning())
+  {
+    state.pauseTiming();
+    result.clear(true);
+    state.resumeTiming();
+
+    qt.run(maps, result);
+  }
+  state.setItemsProcessed(3 * simulated.size());
+}
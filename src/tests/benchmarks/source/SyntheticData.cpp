@@ -0,0 +1,184 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2018.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: Timo Sachsenberg $
+// $Authors: Timo Sachsenberg $
+// --------------------------------------------------------------------------
+
+#include "SyntheticData.h"
+
+#include <OpenMS/CHEMISTRY/ProteaseDigestion.h>
+#include <OpenMS/DATASTRUCTURES/Param.h>
+#include <OpenMS/SIMULATION/MSSim.h>
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+
+namespace OpenMS
+{
+namespace Benchmark
+{
+  namespace
+  {
+    /// one MSSim run shared by all benchmarks
+    struct Simulation
+    {
+      std::vector<FASTAFile::FASTAEntry> proteins;
+      PeakMap profile;
+      PeakMap centroided;
+      FeatureMap features;
+
+      Simulation()
+      {
+        proteins = SyntheticData::createProteins(25, 400, 4711);
+
+        SimTypes::SampleProteins sample;
+        std::mt19937 rng(4711);
+        std::uniform_real_distribution<double> abundance(100.0, 10000.0);
+        for (FASTAFile::FASTAEntry& protein : proteins)
+        {
+          MetaInfoInterface meta;
+          meta.setMetaValue("intensity", abundance(rng));
+          sample.push_back(SimTypes::SimProtein(protein, meta));
+        }
+        SimTypes::SampleChannels channels(1, sample);
+
+        SimTypes::MutableSimRandomNumberGeneratorPtr rnd_gen(new SimTypes::SimRandomNumberGenerator);
+        rnd_gen->initialize(false, false);
+
+        MSSim sim;
+        Param p = sim.getParameters();
+        p.setValue("RT:scan_window:min", 600.0);
+        p.setValue("RT:scan_window:max", 1200.0);
+        sim.setParameters(p);
+        sim.simulate(rnd_gen, channels);
+
+        profile = sim.getExperiment();
+        centroided = sim.getPeakMap();
+        features = sim.getSimulatedFeatures();
+        profile.updateRanges();
+        centroided.updateRanges();
+        features.updateRanges();
+      }
+    };
+
+    const Simulation& getSimulation()
+    {
+      static const Simulation simulation;
+      return simulation;
+    }
+  }
+
+  std::vector<FASTAFile::FASTAEntry> SyntheticData::createProteins(Size count, Size length, UInt seed)
+  {
+    // approximate amino acid frequencies in UniProt (percent)
+    static const char amino_acids[] = "ARNDCQEGHILKMFPSTWYV";
+    static const double frequencies[] = {8.3, 5.5, 4.1, 5.5, 1.4, 3.9, 6.7, 7.1, 2.3, 5.9, 9.7, 5.8, 2.4, 3.9, 4.7, 6.6, 5.3, 1.1, 2.9, 6.9};
+    std::mt19937 rng(seed);
+    std::discrete_distribution<int> pick(std::begin(frequencies), std::end(frequencies));
+
+    std::vector<FASTAFile::FASTAEntry> proteins;
+    for (Size i = 0; i < count; ++i)
+    {
+      String sequence = "M";
+      while (sequence.size() < length) sequence += amino_acids[pick(rng)];
+      proteins.push_back(FASTAFile::FASTAEntry("BENCH_" + String(i), "synthetic protein " + String(i), sequence));
+    }
+    return proteins;
+  }
+
+  std::vector<AASequence> SyntheticData::createPeptides(const std::vector<FASTAFile::FASTAEntry>& proteins, Size count)
+  {
+    ProteaseDigestion digestion;
+    digestion.setEnzyme("Trypsin");
+    std::vector<AASequence> peptides;
+    for (const FASTAFile::FASTAEntry& protein : proteins)
+    {
+      std::vector<AASequence> digest;
+      digestion.digest(AASequence::fromString(protein.sequence), digest, 7, 30);
+      for (const AASequence& peptide : digest)
+      {
+        if (peptides.size() == count) return peptides;
+        peptides.push_back(peptide);
+      }
+    }
+    return peptides;
+  }
+
+  MSSpectrum SyntheticData::createProfileSpectrum(Size peaks, UInt seed)
+  {
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<double> position(200.0, 2000.0);
+    std::uniform_real_distribution<double> height(100.0, 1e6);
+    std::vector<double> centers(peaks);
+    for (double& c : centers) c = position(rng);
+    std::sort(centers.begin(), centers.end());
+
+    MSSpectrum spectrum;
+    spectrum.setMSLevel(1);
+    spectrum.setType(SpectrumSettings::PROFILE);
+    const double spacing = 0.002, sigma = 0.004;
+    for (double center : centers)
+    {
+      const double h = height(rng);
+      for (int k = -5; k < 5; ++k)
+      {
+        const double mz = center + k * spacing;
+        if (!spectrum.empty() && mz <= spectrum.back().getMZ()) continue; // overlapping peaks
+        const double d = (mz - center) / sigma;
+        spectrum.push_back(Peak1D(mz, float(h * std::exp(-0.5 * d * d))));
+      }
+    }
+    return spectrum;
+  }
+
+  const PeakMap& SyntheticData::getSimulatedProfileMap()
+  {
+    return getSimulation().profile;
+  }
+
+  const PeakMap& SyntheticData::getSimulatedCentroidedMap()
+  {
+    return getSimulation().centroided;
+  }
+
+  const FeatureMap& SyntheticData::getSimulatedFeatures()
+  {
+    return getSimulation().features;
+  }
+
+  const std::vector<FASTAFile::FASTAEntry>& SyntheticData::getSimulatedProteins()
+  {
+    return getSimulation().proteins;
+  }
+
+} // namespace Benchmark
+} // namespace OpenMS
@@ -0,0 +1,81 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2018.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: Timo Sachsenberg $
+// $Authors: Timo Sachsenberg $
+// --------------------------------------------------------------------------
+
+#pragma once
+
+#include <OpenMS/CHEMISTRY/AASequence.h>
+#include <OpenMS/FORMAT/FASTAFile.h>
+#include <OpenMS/KERNEL/FeatureMap.h>
+#include <OpenMS/KERNEL/MSExperiment.h>
+
+#include <vector>
+
+namespace OpenMS
+{
+namespace Benchmark
+{
+  /**
+    @brief Reproducible input data for the benchmarks
+
+    LC-MS data is simulated once per process with MSSim from a fixed set of
+    random proteins (fixed seeds, no random noise between runs), so all
+    benchmarks of a run and of different versions work on the same input.
+  */
+  class SyntheticData
+  {
+public:
+    /// Random protein sequences with natural amino acid frequencies (reproducible for the same @p seed)
+    static std::vector<FASTAFile::FASTAEntry> createProteins(Size count, Size length, UInt seed = 42);
+
+    /// The first @p count tryptic peptides (7 to 30 amino acids) of @p proteins
+    static std::vector<AASequence> createPeptides(const std::vector<FASTAFile::FASTAEntry>& proteins, Size count);
+
+    /// A profile spectrum with @p peaks Gaussian peaks (10 points each, m/z 200 - 2000)
+    static MSSpectrum createProfileSpectrum(Size peaks, UInt seed = 42);
+
+    /// Profile MS1 map simulated by MSSim
+    static const PeakMap& getSimulatedProfileMap();
+
+    /// Centroided MS1 map simulated by MSSim (same run as getSimulatedProfileMap())
+    static const PeakMap& getSimulatedCentroidedMap();
+
+    /// Features simulated by MSSim (same run as getSimulatedProfileMap())
+    static const FeatureMap& getSimulatedFeatures();
+
+    /// The proteins the simulation is based on
+    static const std::vector<FASTAFile::FASTAEntry>& getSimulatedProteins();
+  };
+
+} // namespace Benchmark
+} // namespace OpenMS
@@ -35,6 +35,7 @@
 #include <OpenMS/CONCEPT/ClassTest.h>
 #include <OpenMS/test_config.h>
 #include <OpenMS/FORMAT/DTAFile.h>
+#include <OpenMS/CHEMISTRY/TheoreticalSpectrumGenerator.h>
 
 
 ///////////////////////////
@@ -751,6 +752,21 @@ START_SECTION(std::vector<PeakSpectrum> createTheoreticalSpectraTest_(const std:
   TEST_REAL_SIMILAR(th_spectra[4][0].getMZ(), 147.11340);
   TEST_REAL_SIMILAR(th_spectra[4][2].getMZ(), 244.166);
   TEST_REAL_SIMILAR(th_spectra[4][21].getMZ(), 1352.57723);
+
+  // the shifted fragment ladders are identical to the directly generated spectra
+  std::vector<std::vector<Size>> two_sites(1, std::vector<Size>());
+  two_sites[0].push_back(2);
+  two_sites[0].push_back(7);
+  th_spectra = ptr_test->createTheoreticalSpectraTest_(two_sites, seq_without_phospho);
+  TEST_EQUAL(th_spectra.size(), 1);
+  TEST_EQUAL(th_spectra[0].getName(), "QSS(Phospho)VTQVT(Phospho)EQSPK");
+  PeakSpectrum direct;
+  TheoreticalSpectrumGenerator().getSpectrum(direct, AASequence::fromString("QSS(Phospho)VTQVT(Phospho)EQSPK"), 1, 1);
+  ABORT_IF(th_spectra[0].size() != direct.size());
+  for (Size i = 0; i < direct.size(); ++i)
+  {
+    TEST_REAL_SIMILAR(th_spectra[0][i].getMZ(), direct[i].getMZ());
+  }
   
   th_spectra.clear();
 }
@@ -975,6 +975,42 @@ START_SECTION((int jackknifeOutlierCandidate_(
     transformation_model_params);
   TEST_EQUAL(c2,0);
 
+  // weighted data: the candidate has to match an explicit leave-one-out refit
+  component_concentrations.clear();
+  for (size_t i = 0; i < x1.size(); ++i)
+  {
+    component.setMetaValue("native_id","component");
+    component.setMetaValue("peak_apex_int",y1[i] * (i == 2 ? 1.8 : 1.0));
+    IS_component.setMetaValue("native_id","IS");
+    IS_component.setMetaValue("peak_apex_int",1.0);
+    component_concentration.feature = component;
+    component_concentration.IS_feature = IS_component;
+    component_concentration.actual_concentration = x1[i];
+    component_concentration.IS_actual_concentration = 1.0;
+    component_concentration.dilution_factor = 1.0;
+    component_concentrations.push_back(component_concentration);
+  }
+  transformation_model_params.setValue("x_weight", "ln(x)");
+  transformation_model_params.setValue("y_weight", "ln(y)");
+  std::vector<double> rsq;
+  for (size_t i = 0; i < component_concentrations.size(); ++i)
+  {
+    std::vector<AbsoluteQuantitationStandards::featureConcentration> component_concentrations_tmp = component_concentrations;
+    component_concentrations_tmp.erase(component_concentrations_tmp.begin() + i);
+    Param params = absquant.fitCalibration(component_concentrations_tmp, feature_name, transformation_model, transformation_model_params);
+    std::vector<double> biases;
+    double r = 0.0;
+    absquant.calculateBiasAndR(component_concentrations_tmp, feature_name, transformation_model, params, biases, r);
+    rsq.push_back(r);
+  }
+  int c3 = absquant.jackknifeOutlierCandidate_(
+    component_concentrations,
+    feature_name,
+    transformation_model,
+    transformation_model_params);
+  TEST_EQUAL(c3, max_element(rsq.begin(), rsq.end()) - rsq.begin());
+  TEST_EQUAL(c3, 2);
+
 END_SECTION
 
 START_SECTION((int residualOutlierCandidate_(
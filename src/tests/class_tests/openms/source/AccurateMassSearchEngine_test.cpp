@@ -180,6 +180,47 @@ START_SECTION((void queryByMZ(const double& observed_mz, const Int& observed_cha
 }
 END_SECTION
 
+START_SECTION((void queryByMZ(const std::vector<double>& observed_mzs, const std::vector<Int>& observed_charges, const String& ion_mode, std::vector<MassMatch>& matches) const))
+{
+  std::vector<double> mzs;
+  std::vector<Int> charges;
+  mzs.push_back(EmpiricalFormula("C17H20N2S").getMonoWeight() / 3 - Constants::PROTON_MASS_U);
+  charges.push_back(3);
+  mzs.push_back(1234.0);
+  charges.push_back(1);
+  mzs.push_back(EmpiricalFormula("C17H20N2S").getMonoWeight() - Constants::PROTON_MASS_U);
+  charges.push_back(0);
+
+  std::vector<AccurateMassSearchEngine::MassMatch> matches;
+  TEST_EXCEPTION(Exception::IllegalArgument, ams.queryByMZ(mzs, std::vector<Int>(1, 1), "negative", matches));
+  TEST_EXCEPTION(Exception::InvalidParameter, ams.queryByMZ(mzs, charges, "this_is_an_invalid_ionmode", matches));
+
+  // the batch gives the same hits (in the same order) as the single queries
+  ams.queryByMZ(mzs, charges, "negative", matches);
+  TEST_EQUAL(matches.empty(), false)
+  Size match_idx = 0;
+  for (Size q = 0; q < mzs.size(); ++q)
+  {
+    std::vector<AccurateMassSearchResult> single;
+    ams.queryByMZ(mzs[q], charges[q], "negative", single);
+    for (Size i = 0; i < single.size(); ++i)
+    {
+      if (single[i].getMatchingIndex() == -1) continue; // not-found indicator
+      ABORT_IF(match_idx >= matches.size())
+      TEST_EQUAL(matches[match_idx].query, q)
+      TEST_EQUAL(matches[match_idx].db_entry, (Size)single[i].getMatchingIndex())
+      TEST_REAL_SIMILAR(matches[match_idx].query_mass, single[i].getQueryMass())
+      TEST_REAL_SIMILAR(matches[match_idx].calculated_mz, single[i].getCalculatedMZ())
+      ++match_idx;
+    }
+  }
+  TEST_EQUAL(match_idx, matches.size())
+
+  ams.queryByMZ(std::vector<double>(), std::vector<Int>(), "negative", matches);
+  TEST_EQUAL(matches.size(), 0)
+}
+END_SECTION
+
 AccurateMassSearchEngine ams_feat_test;
 ams_feat_test.setParameters(ams_param);
 ams_feat_test.init();
@@ -260,7 +260,37 @@ START_SECTION([EXTRA] zlib functionality)
 
   TEST_REAL_SIMILAR(data[0], 300.15f)
   TEST_REAL_SIMILAR(data[1], 303.998f)
-  TEST_REAL_SIMILAR(data[2], 304.6f)  
+  TEST_REAL_SIMILAR(data[2], 304.6f)
+
+  // large arrays need to be inflated in several steps
+  data_double.clear();
+  for (Size i = 0; i < 100000; ++i)
+  {
+    data_double.push_back(i * 0.37);
+  }
+  std::vector<double> copy = data_double;
+  b64.encode(copy, Base64::BYTEORDER_BIGENDIAN, str, true);
+  b64.decode(str, Base64::BYTEORDER_BIGENDIAN, res_double, true);
+  TEST_EQUAL(res_double.size(), data_double.size())
+  TEST_EQUAL(res_double == data_double, true)
+}
+END_SECTION
+
+START_SECTION([EXTRA] characters outside of the Base64 alphabet are skipped)
+{
+  TOLERANCE_ABSOLUTE(0.001)
+  Base64 b64;
+  std::vector<float> res;
+
+  b64.decode("QvA AAELIAA=", Base64::BYTEORDER_BIGENDIAN, res);
+  TEST_EQUAL(res.size(), 2)
+  TEST_REAL_SIMILAR(res[0], 120)
+  TEST_REAL_SIMILAR(res[1], 100)
+
+  b64.decode("Q+vIuEec\n9YB", Base64::BYTEORDER_BIGENDIAN, res);
+  TEST_EQUAL(res.size(), 2)
+  TEST_REAL_SIMILAR(res[0], 471.568)
+  TEST_REAL_SIMILAR(res[1], 80363)
 }
 END_SECTION
 
@@ -106,6 +106,44 @@ START_SECTION((double operator()(const BinnedSpectrum &spec) const ))
 }
 END_SECTION
 
+START_SECTION((void computeTopMatches(const std::vector<BinnedSpectrum>& queries, const std::vector<BinnedSpectrum>& library, std::vector<std::vector<Match> >& matches, Size top_k = 0, double min_score = 0.0) const))
+{
+  PeakSpectrum s1, s2, s3;
+  DTAFile().load(OPENMS_GET_TEST_DATA_PATH("PILISSequenceDB_DFPIANGER_1.dta"), s1);
+  s2 = s1;
+  s2.pop_back();
+  s3.push_back(Peak1D(5000.0, 10.0f)); // no bin shared with s1
+  std::vector<BinnedSpectrum> library;
+  library.push_back(BinnedSpectrum(s3, 1.5, false, 2, BinnedSpectrum::DEFAULT_BIN_OFFSET_LOWRES));
+  library.push_back(BinnedSpectrum(s2, 1.5, false, 2, BinnedSpectrum::DEFAULT_BIN_OFFSET_LOWRES));
+  library.push_back(BinnedSpectrum(s1, 1.5, false, 2, BinnedSpectrum::DEFAULT_BIN_OFFSET_LOWRES));
+
+  std::vector<std::vector<BinnedSpectralContrastAngle::Match> > matches;
+  ptr->computeTopMatches(library, library, matches);
+  TEST_EQUAL(matches.size(), 3)
+  ABORT_IF(matches.size() != 3)
+  TEST_EQUAL(matches[0].size(), 1)
+  TEST_EQUAL(matches[0][0].first, 0)
+  TEST_REAL_SIMILAR(matches[0][0].second, 1.0)
+  TEST_EQUAL(matches[2].size(), 2)
+  ABORT_IF(matches[2].size() != 2)
+  TEST_EQUAL(matches[2][0].first, 2)
+  TEST_REAL_SIMILAR(matches[2][0].second, 1.0)
+  TEST_EQUAL(matches[2][1].first, 1)
+  TEST_REAL_SIMILAR(matches[2][1].second, (*ptr)(library[2], library[1]))
+
+  // top-k and score threshold
+  ptr->computeTopMatches(library, library, matches, 1);
+  TEST_EQUAL(matches[2].size(), 1)
+  TEST_EQUAL(matches[2][0].first, 2)
+  ptr->computeTopMatches(library, library, matches, 0, 0.99999);
+  TEST_EQUAL(matches[1].size(), 1)
+
+  std::vector<BinnedSpectrum> incompatible(1, BinnedSpectrum(s1, 1.0, false, 2, BinnedSpectrum::DEFAULT_BIN_OFFSET_LOWRES));
+  TEST_EXCEPTION(Exception::IllegalArgument, ptr->computeTopMatches(incompatible, library, matches))
+}
+END_SECTION
+
 START_SECTION((static BinnedSpectrumCompareFunctor* create()))
 {
   BinnedSpectrumCompareFunctor* bsf = BinnedSpectralContrastAngle::create();
@@ -0,0 +1,150 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2018.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: Hannes Roest $
+// $Authors: Hannes Roest $
+// --------------------------------------------------------------------------
+
+#include <OpenMS/CONCEPT/ClassTest.h>
+#include <OpenMS/test_config.h>
+
+///////////////////////////
+#include <OpenMS/DATASTRUCTURES/BoundingBoxGrid.h>
+///////////////////////////
+
+using namespace OpenMS;
+using namespace std;
+
+START_TEST(BoundingBoxGrid, "$Id$")
+
+/////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////
+
+BoundingBoxGrid* ptr = nullptr;
+BoundingBoxGrid* nullPointer = nullptr;
+
+START_SECTION(BoundingBoxGrid())
+{
+  ptr = new BoundingBoxGrid();
+  TEST_NOT_EQUAL(ptr, nullPointer)
+  TEST_EQUAL(ptr->size(), 0)
+  vector<Size> result(1, 5);
+  ptr->query(DPosition<2>(1.0, 1.0), result);
+  TEST_EQUAL(result.size(), 0)
+  delete ptr;
+}
+END_SECTION
+
+vector<DBoundingBox<2> > boxes;
+boxes.push_back(DBoundingBox<2>(DPosition<2>(0.0, 100.0), DPosition<2>(10.0, 101.0)));
+boxes.push_back(DBoundingBox<2>(DPosition<2>(5.0, 100.5), DPosition<2>(20.0, 100.5))); // zero height
+boxes.push_back(DBoundingBox<2>()); // empty, never matches
+boxes.push_back(DBoundingBox<2>(DPosition<2>(100.0, 500.0), DPosition<2>(110.0, 502.0)));
+boxes.push_back(DBoundingBox<2>(DPosition<2>(-50.0, 0.0), DPosition<2>(200.0, 1000.0))); // covers everything
+
+START_SECTION((void build(const std::vector< DBoundingBox< 2 > > &boxes, double cell_size_x=0.0, double cell_size_y=0.0)))
+{
+  BoundingBoxGrid grid;
+  grid.build(boxes);
+  TEST_EQUAL(grid.size(), 5)
+  TEST_REAL_SIMILAR(grid.getBox(3).minX(), 100.0)
+
+  // rebuilding replaces the content
+  grid.build(vector<DBoundingBox<2> >(1, boxes[0]));
+  TEST_EQUAL(grid.size(), 1)
+  grid.build(vector<DBoundingBox<2> >());
+  TEST_EQUAL(grid.size(), 0)
+}
+END_SECTION
+
+START_SECTION((void query(const DPosition< 2 > &position, std::vector< Size > &result) const))
+{
+  // results must not depend on the cell sizes
+  double cell_sizes[] = {0.0, 0.1, 5.0, 1000.0};
+  for (Size c = 0; c < 4; ++c)
+  {
+    BoundingBoxGrid grid;
+    grid.build(boxes, cell_sizes[c], cell_sizes[c]);
+    vector<Size> result;
+
+    grid.query(DPosition<2>(7.0, 100.5), result);
+    TEST_EQUAL(result.size(), 3)
+    ABORT_IF(result.size() != 3)
+    TEST_EQUAL(result[0], 0)
+    TEST_EQUAL(result[1], 1)
+    TEST_EQUAL(result[2], 4)
+
+    // borders are included
+    grid.query(DPosition<2>(110.0, 502.0), result);
+    TEST_EQUAL(result.size(), 2)
+    ABORT_IF(result.size() != 2)
+    TEST_EQUAL(result[0], 3)
+    TEST_EQUAL(result[1], 4)
+
+    grid.query(DPosition<2>(150.0, 700.0), result);
+    TEST_EQUAL(result.size(), 1)
+
+    // outside of all boxes
+    grid.query(DPosition<2>(300.0, 100.0), result);
+    TEST_EQUAL(result.size(), 0)
+  }
+
+  // compare to a linear search
+  vector<DBoundingBox<2> > many;
+  for (Size i = 0; i < 200; ++i)
+  {
+    double x = (i * 37) % 101, y = 400.0 + (i * 53) % 211;
+    many.push_back(DBoundingBox<2>(DPosition<2>(x, y), DPosition<2>(x + (i % 7) * 3.0, y + (i % 5) * 0.2)));
+  }
+  BoundingBoxGrid grid;
+  grid.build(many);
+  vector<Size> result;
+  Size errors = 0;
+  for (double x = -1.0; x < 125.0; x += 0.5)
+  {
+    for (double y = 399.0; y < 612.0; y += 0.1)
+    {
+      DPosition<2> pos(x, y);
+      grid.query(pos, result);
+      vector<Size> expected;
+      for (Size i = 0; i < many.size(); ++i)
+      {
+        if (many[i].encloses(pos)) expected.push_back(i);
+      }
+      if (result != expected) ++errors;
+    }
+  }
+  TEST_EQUAL(errors, 0)
+}
+END_SECTION
+
+/////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////
+END_TEST
@@ -235,6 +235,101 @@ START_SECTION(( void writeMetadata(MapType exp, String out_meta, bool addCacheMe
 }
 END_SECTION
 
+START_SECTION(( void setStorageOptions(const StorageOptions& options) ))
+{
+  CachedMzMLHandler cache;
+  TEST_EQUAL(cache.getStorageOptions().format_version, 2)
+  TEST_EQUAL(cache.getStorageOptions().zlib_compression, false)
+
+  CachedMzMLHandler::StorageOptions options;
+  options.format_version = 1;
+  cache.setStorageOptions(options);
+  TEST_EQUAL(cache.getStorageOptions().format_version, 1)
+
+  options.format_version = 3;
+  TEST_EXCEPTION(Exception::InvalidParameter, cache.setStorageOptions(options))
+}
+END_SECTION
+
+START_SECTION(( [EXTRA] file format versions and compression ))
+{
+  PeakMap exp;
+  MzMLFile().load(OPENMS_GET_TEST_DATA_PATH("MzMLFile_1.mzML"), exp);
+
+  CachedMzMLHandler::StorageOptions legacy;
+  legacy.format_version = 1;
+  CachedMzMLHandler::StorageOptions compressed;
+  compressed.zlib_compression = true;
+  CachedMzMLHandler::StorageOptions numpress;
+  numpress.np_config_mass_time.np_compression = MSNumpressCoder::LINEAR;
+  numpress.np_config_intensity.np_compression = MSNumpressCoder::SLOF;
+
+  std::vector<CachedMzMLHandler::StorageOptions> all_options = {legacy, CachedMzMLHandler::StorageOptions(), compressed, numpress};
+  std::vector<Size> file_sizes;
+  for (const auto& options : all_options)
+  {
+    std::string tmp_filename;
+    NEW_TMP_FILE(tmp_filename);
+    CachedMzMLHandler cache;
+    cache.setStorageOptions(options);
+    cache.writeMemdump(exp, tmp_filename);
+
+    std::ifstream ifs_(tmp_filename.c_str(), std::ios::binary | std::ios::ate);
+    file_sizes.push_back(ifs_.tellg());
+
+    // index is read from the footer (version 2) or by scanning the file (version 1)
+    CachedMzMLHandler reader;
+    reader.createMemdumpIndex(tmp_filename);
+    TEST_EQUAL(reader.getSpectraIndex().size(), 4)
+    TEST_EQUAL(reader.getChromatogramIndex().size(), 2)
+
+    // numpress is lossy (within the error tolerance)
+    TOLERANCE_RELATIVE(options.np_config_mass_time.np_compression == MSNumpressCoder::NONE ? 1.0 + 1e-6 : 1.0 + 1e-4)
+    for (Size i = 0; i < 4; i++)
+    {
+      ifs_.seekg(reader.getSpectraIndex()[i]);
+      int ms_level = -1;
+      double rt = -1.0;
+      std::vector<OpenSwath::BinaryDataArrayPtr> data = CachedMzMLHandler::readSpectrumFast(ifs_, ms_level, rt);
+      TEST_EQUAL(data.size(), 2 + exp[i].getFloatDataArrays().size())
+      TEST_EQUAL(data[0]->data.size(), exp[i].size())
+      TEST_EQUAL(ms_level, exp[i].getMSLevel())
+      TEST_REAL_SIMILAR(rt, exp[i].getRT())
+      for (Size k = 0; k < data[0]->data.size(); k++)
+      {
+        TEST_REAL_SIMILAR(data[0]->data[k], exp[i][k].getMZ())
+        TEST_REAL_SIMILAR(data[1]->data[k], exp[i][k].getIntensity())
+      }
+      for (Size k = 2; k < data.size(); k++)
+      {
+        TEST_EQUAL(data[k]->description, exp[i].getFloatDataArrays()[k - 2].getName())
+      }
+    }
+    for (Size i = 0; i < 2; i++)
+    {
+      ifs_.seekg(reader.getChromatogramIndex()[i]);
+      std::vector<OpenSwath::BinaryDataArrayPtr> data = CachedMzMLHandler::readChromatogramFast(ifs_);
+      TEST_EQUAL(data[0]->data.size(), exp.getChromatogram(i).size())
+      for (Size k = 0; k < data[0]->data.size(); k++)
+      {
+        TEST_REAL_SIMILAR(data[0]->data[k], exp.getChromatogram(i)[k].getRT())
+        TEST_REAL_SIMILAR(data[1]->data[k], exp.getChromatogram(i)[k].getIntensity())
+      }
+    }
+
+    PeakMap exp_new;
+    reader.readMemdump(exp_new, tmp_filename);
+    TEST_EQUAL(exp_new.size(), exp.size())
+    TEST_EQUAL(exp_new.getChromatograms().size(), exp.getChromatograms().size())
+  }
+  TOLERANCE_RELATIVE(1.0 + 1e-5)
+
+  // float intensities make version 2 files smaller than version 1 files
+  TEST_EQUAL(file_sizes[1] < file_sizes[0], true)
+  TEST_EQUAL(file_sizes[3] < file_sizes[1], true)
+}
+END_SECTION
+
 // Create a single CachedMzML file and use it for the following computations
 // (may be somewhat faster)
 std::string tmp_filename;
@@ -412,6 +507,68 @@ START_SECTION( static inline void readChromatogramFast(OpenSwath::BinaryDataArra
 }
 END_SECTION
 
+START_SECTION(static std::vector<OpenSwath::BinaryDataArrayPtr> readSpectrumFast(const char* buffer, Size buffer_size, int& ms_level, double& rt))
+{
+  // read the whole file into memory
+  std::ifstream ifs_(tmp_filename.c_str(), std::ios::binary);
+  std::string buffer((std::istreambuf_iterator<char>(ifs_)), std::istreambuf_iterator<char>());
+  std::vector<std::streampos> spectra_index = cache_.getSpectraIndex();
+  TEST_EQUAL(spectra_index.size(), 4)
+
+  for (Size k = 0; k < spectra_index.size(); k++)
+  {
+    Size offset = spectra_index[k];
+    int ms_level = -1;
+    double rt = -1.0;
+    std::vector<OpenSwath::BinaryDataArrayPtr> data =
+      CachedMzMLHandler::readSpectrumFast(buffer.data() + offset, buffer.size() - offset, ms_level, rt);
+
+    TEST_EQUAL(data.size(), 2 + exp.getSpectrum(k).getFloatDataArrays().size())
+    TEST_EQUAL(data[0]->data.size(), exp.getSpectrum(k).size())
+    TEST_EQUAL(data[1]->data.size(), exp.getSpectrum(k).size())
+    TEST_EQUAL(ms_level, exp.getSpectrum(k).getMSLevel())
+    TEST_REAL_SIMILAR(rt, exp.getSpectrum(k).getRT())
+    for (Size i = 0; i < data[0]->data.size(); i++)
+    {
+      TEST_REAL_SIMILAR(data[0]->data[i], exp.getSpectrum(k)[i].getMZ())
+      TEST_REAL_SIMILAR(data[1]->data[i], exp.getSpectrum(k)[i].getIntensity())
+    }
+  }
+
+  // should not read after the buffer ends
+  Size offset = spectra_index.back();
+  int ms_level = -1;
+  double rt = -1.0;
+  TEST_EXCEPTION(Exception::ParseError, CachedMzMLHandler::readSpectrumFast(buffer.data() + offset, 20, ms_level, rt))
+}
+END_SECTION
+
+START_SECTION(static std::vector<OpenSwath::BinaryDataArrayPtr> readChromatogramFast(const char* buffer, Size buffer_size))
+{
+  // read the whole file into memory
+  std::ifstream ifs_(tmp_filename.c_str(), std::ios::binary);
+  std::string buffer((std::istreambuf_iterator<char>(ifs_)), std::istreambuf_iterator<char>());
+  std::vector<std::streampos> chrom_index = cache_.getChromatogramIndex();
+  TEST_EQUAL(chrom_index.size(), 2)
+
+  Size offset = chrom_index[0];
+  std::vector<OpenSwath::BinaryDataArrayPtr> data =
+    CachedMzMLHandler::readChromatogramFast(buffer.data() + offset, buffer.size() - offset);
+
+  TEST_EQUAL(data[0]->data.size() > 0, true)
+  TEST_EQUAL(data[0]->data.size(), exp.getChromatogram(0).size())
+  TEST_EQUAL(data[1]->data.size(), exp.getChromatogram(0).size())
+  for (Size i = 0; i < data[0]->data.size(); i++)
+  {
+    TEST_REAL_SIMILAR(data[0]->data[i], exp.getChromatogram(0)[i].getRT())
+    TEST_REAL_SIMILAR(data[1]->data[i], exp.getChromatogram(0)[i].getIntensity())
+  }
+
+  // should not read after the buffer ends
+  TEST_EXCEPTION(Exception::ParseError, CachedMzMLHandler::readChromatogramFast(buffer.data() + offset, 10))
+}
+END_SECTION
+
 /////////////////////////////////////////////////////////////
 /////////////////////////////////////////////////////////////
 END_TEST
@@ -220,6 +220,24 @@ START_SECTION(( const MSExperiment& getMetaData() const ))
 }
 END_SECTION
 
+START_SECTION(( bool isMemoryMapped() const ))
+{
+  TEST_EQUAL(cache_example.isMemoryMapped(), true)
+
+  // copies share the mapping and return the same data
+  CachedmzML cache_copy(cache_example);
+  TEST_EQUAL(cache_copy.isMemoryMapped(), true)
+  for (Size i = 0; i < 4; i++)
+  {
+    TEST_EQUAL(cache_copy.getSpectrum(i) == cache_example.getSpectrum(i), true)
+  }
+  for (Size i = 0; i < 2; i++)
+  {
+    TEST_EQUAL(cache_copy.getChromatogram(i) == cache_example.getChromatogram(i), true)
+  }
+}
+END_SECTION
+
 /////////////////////////////////////////////////////////////
 /////////////////////////////////////////////////////////////
 END_TEST
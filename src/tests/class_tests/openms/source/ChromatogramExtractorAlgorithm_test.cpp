@@ -33,6 +33,7 @@
 // --------------------------------------------------------------------------
 
 #include <OpenMS/ANALYSIS/OPENSWATH/ChromatogramExtractorAlgorithm.h>
+#include <OpenMS/ANALYSIS/OPENSWATH/CompactChromatogramList.h>
 
 #include <OpenMS/CONCEPT/ClassTest.h>
 #include <OpenMS/test_config.h>
@@ -136,6 +137,135 @@ START_SECTION(void extractChromatograms(const OpenSwath::SpectrumAccessPtr input
 }
 END_SECTION
 
+START_SECTION(void extractChromatograms(const OpenSwath::SpectrumAccessPtr input, std::vector< std::vector< OpenSwath::ChromatogramPtr > > &output, const std::vector< std::vector< ExtractionCoordinates > >& extraction_coordinates, double mz_extraction_window, bool ppm, double im_extraction_window, const String& filter))
+{
+  double extract_window = 0.05;
+  boost::shared_ptr<PeakMap > exp(new PeakMap);
+  MzMLFile().load(OPENMS_GET_TEST_DATA_PATH("ChromatogramExtractor_input.mzML"), *exp);
+  OpenSwath::SpectrumAccessPtr expptr = SimpleOpenMSSpectraFactory::getSpectrumAccessOpenMSPtr(exp);
+
+  ChromatogramExtractorAlgorithm extractor;
+
+  // two sets of coordinates (overlapping in m/z) against the same data
+  std::vector< std::vector< ChromatogramExtractorAlgorithm::ExtractionCoordinates > > coordinates(2);
+  std::vector< std::vector< OpenSwath::ChromatogramPtr > > out_exp(2);
+  {
+    ChromatogramExtractorAlgorithm::ExtractionCoordinates coord;
+    coord.rt_start = 0; coord.rt_end = -1;
+    coord.mz = 618.31; coord.id = "tr1";
+    coordinates[0].push_back(coord);
+    coord.mz = 654.38; coord.id = "tr3";
+    coordinates[0].push_back(coord);
+    coord.mz = 618.31; coord.id = "tr1_b";
+    coordinates[1].push_back(coord);
+    coord.mz = 628.45; coord.id = "tr2";
+    coordinates[1].push_back(coord);
+  }
+  for (Size k = 0; k < coordinates.size(); k++)
+  {
+    for (Size i = 0; i < coordinates[k].size(); i++)
+    {
+      out_exp[k].push_back(OpenSwath::ChromatogramPtr(new OpenSwath::Chromatogram));
+    }
+  }
+  extractor.extractChromatograms(expptr, out_exp, coordinates, extract_window, false, -1, "tophat");
+
+  // each set has to give the same result as a separate extraction
+  for (Size k = 0; k < coordinates.size(); k++)
+  {
+    std::vector< OpenSwath::ChromatogramPtr > single;
+    for (Size i = 0; i < coordinates[k].size(); i++)
+    {
+      single.push_back(OpenSwath::ChromatogramPtr(new OpenSwath::Chromatogram));
+    }
+    extractor.extractChromatograms(expptr, single, coordinates[k], extract_window, false, -1, "tophat");
+
+    for (Size i = 0; i < single.size(); i++)
+    {
+      TEST_EQUAL(out_exp[k][i]->getTimeArray()->data.size(), 59)
+      TEST_EQUAL(out_exp[k][i]->getTimeArray()->data.size(), single[i]->getTimeArray()->data.size())
+      for (Size j = 0; j < single[i]->getIntensityArray()->data.size(); j++)
+      {
+        TEST_REAL_SIMILAR(out_exp[k][i]->getTimeArray()->data[j], single[i]->getTimeArray()->data[j])
+        TEST_REAL_SIMILAR(out_exp[k][i]->getIntensityArray()->data[j], single[i]->getIntensityArray()->data[j])
+      }
+    }
+  }
+
+  double max_value = -1; double foundat = -1;
+  find_max_helper(out_exp[1][1], max_value, foundat);
+  TEST_REAL_SIMILAR(max_value, 169.792);
+  TEST_REAL_SIMILAR(foundat, 3120.26);
+
+  // size mismatch between output and coordinates
+  out_exp.pop_back();
+  TEST_EXCEPTION(Exception::IllegalArgument, extractor.extractChromatograms(expptr, out_exp, coordinates, extract_window, false, -1, "tophat"))
+}
+END_SECTION
+
+START_SECTION(void extractChromatograms(const OpenSwath::SpectrumAccessPtr input, std::vector<CompactChromatogramList>& output, const std::vector< std::vector<ExtractionCoordinates> >& extraction_coordinates, double mz_extraction_window, bool ppm, double im_extraction_window, const String& filter))
+{
+  double extract_window = 0.05;
+  boost::shared_ptr<PeakMap > exp(new PeakMap);
+  MzMLFile().load(OPENMS_GET_TEST_DATA_PATH("ChromatogramExtractor_input.mzML"), *exp);
+  OpenSwath::SpectrumAccessPtr expptr = SimpleOpenMSSpectraFactory::getSpectrumAccessOpenMSPtr(exp);
+
+  ChromatogramExtractorAlgorithm extractor;
+
+  std::vector< std::vector< ChromatogramExtractorAlgorithm::ExtractionCoordinates > > coordinates(2);
+  {
+    ChromatogramExtractorAlgorithm::ExtractionCoordinates coord;
+    coord.rt_start = 0; coord.rt_end = -1;
+    coord.mz = 618.31; coord.id = "tr1";
+    coordinates[0].push_back(coord);
+    coord.mz = 654.38; coord.id = "tr3";
+    coordinates[0].push_back(coord);
+    coord.mz = 628.45; coord.id = "tr2";
+    coord.rt_start = 3100; coord.rt_end = 3200; // only part of the RT range
+    coordinates[1].push_back(coord);
+  }
+  std::vector< std::vector< OpenSwath::ChromatogramPtr > > out_exp(2);
+  for (Size k = 0; k < coordinates.size(); k++)
+  {
+    for (Size i = 0; i < coordinates[k].size(); i++)
+    {
+      out_exp[k].push_back(OpenSwath::ChromatogramPtr(new OpenSwath::Chromatogram));
+    }
+  }
+  extractor.extractChromatograms(expptr, out_exp, coordinates, extract_window, false, -1, "tophat");
+
+  std::vector<CompactChromatogramList> out_compact;
+  extractor.extractChromatograms(expptr, out_compact, coordinates, extract_window, false, -1, "tophat");
+  TEST_EQUAL(out_compact.size(), 2)
+  TEST_EQUAL(out_compact[0].size(), 2)
+  TEST_EQUAL(out_compact[1].size(), 1)
+  TEST_EQUAL(out_compact[0].getRTAxis().size(), expptr->getNrSpectra())
+  TEST_EQUAL(&out_compact[0].getRTAxis(), &out_compact[1].getRTAxis()) // shared axis
+
+  // identical to the double precision extraction (up to single precision rounding)
+  for (Size k = 0; k < coordinates.size(); k++)
+  {
+    for (Size i = 0; i < coordinates[k].size(); i++)
+    {
+      OpenSwath::ChromatogramPtr chrom = out_compact[k].getChromatogram(i);
+      TEST_EQUAL(chrom->getTimeArray()->data.size(), out_exp[k][i]->getTimeArray()->data.size())
+      TEST_EQUAL(out_compact[k].getNrPoints(i), out_exp[k][i]->getTimeArray()->data.size())
+      for (Size j = 0; j < chrom->getTimeArray()->data.size(); j++)
+      {
+        TEST_EQUAL(chrom->getTimeArray()->data[j], out_exp[k][i]->getTimeArray()->data[j])
+        TEST_REAL_SIMILAR(chrom->getIntensityArray()->data[j], out_exp[k][i]->getIntensityArray()->data[j])
+      }
+    }
+  }
+  TEST_EQUAL(out_compact[0].getNrPoints(0), 59)
+  TEST_EQUAL(out_compact[1].getNrPoints(0) < 59, true)
+
+  // unsorted coordinates
+  std::swap(coordinates[0][0], coordinates[0][1]);
+  TEST_EXCEPTION(Exception::IllegalArgument, extractor.extractChromatograms(expptr, out_compact, coordinates, extract_window, false, -1, "tophat"))
+}
+END_SECTION
+
 START_SECTION([EXTRA] void extractChromatograms(const OpenSwath::SpectrumAccessPtr input, std::vector< OpenSwath::ChromatogramPtr > &output, std::vector< ExtractionCoordinates >& extraction_coordinates, double mz_extraction_window, bool ppm, String filter))
 {
   typedef OpenMS::DataArrays::FloatDataArray FloatDataArray;
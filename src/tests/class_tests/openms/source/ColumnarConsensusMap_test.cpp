@@ -0,0 +1,232 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2018.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: Timo Sachsenberg$
+// $Authors: Timo Sachsenberg $
+// --------------------------------------------------------------------------
+
+#include <OpenMS/CONCEPT/ClassTest.h>
+
+///////////////////////////
+#include <OpenMS/KERNEL/ColumnarConsensusMap.h>
+///////////////////////////
+
+#include <OpenMS/KERNEL/ConsensusMap.h>
+
+using namespace OpenMS;
+using namespace std;
+
+START_TEST(ColumnarConsensusMap, "$Id$")
+
+/////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////
+
+ColumnarConsensusMap* ptr = nullptr;
+ColumnarConsensusMap* nullPointer = nullptr;
+START_SECTION(ColumnarConsensusMap())
+{
+  ptr = new ColumnarConsensusMap();
+  TEST_NOT_EQUAL(ptr, nullPointer)
+  TEST_EQUAL(ptr->getNumberOfFeatures(), 0)
+  TEST_EQUAL(ptr->getNumberOfHandles(), 0)
+  TEST_EQUAL(ptr->getRowOffsets().size(), 1)
+  TEST_EQUAL(ptr->empty(), true)
+}
+END_SECTION
+
+START_SECTION(~ColumnarConsensusMap())
+{
+  delete ptr;
+}
+END_SECTION
+
+// three maps, two consensus features; map 1 is missing in the second one
+ConsensusMap cmap;
+cmap.getColumnHeaders()[0].size = 10;
+cmap.getColumnHeaders()[1].size = 20;
+cmap.getColumnHeaders()[2].size = 15;
+{
+  ConsensusFeature cf;
+  cf.setRT(100.0);
+  cf.setMZ(500.0);
+  cf.setIntensity(60.0f);
+  cf.setCharge(2);
+  cf.setQuality(0.5);
+  cf.setUniqueId(1);
+  FeatureHandle fh;
+  fh.setMapIndex(0); fh.setUniqueId(10); fh.setRT(99.0); fh.setMZ(500.1); fh.setIntensity(10.0f); fh.setCharge(2);
+  cf.insert(fh);
+  fh.setMapIndex(2); fh.setUniqueId(12); fh.setRT(101.0); fh.setMZ(499.9); fh.setIntensity(30.0f);
+  cf.insert(fh);
+  fh.setMapIndex(1); fh.setUniqueId(11); fh.setRT(100.0); fh.setMZ(500.0); fh.setIntensity(20.0f);
+  cf.insert(fh);
+  cf.setMetaValue("label", "first");
+  cmap.push_back(cf);
+
+  ConsensusFeature cf2;
+  cf2.setRT(200.0);
+  cf2.setMZ(600.0);
+  cf2.setIntensity(5.0f);
+  cf2.setUniqueId(2);
+  fh.setMapIndex(2); fh.setUniqueId(22); fh.setRT(200.0); fh.setMZ(600.0); fh.setIntensity(4.0f); fh.setCharge(1);
+  cf2.insert(fh);
+  fh.setMapIndex(0); fh.setUniqueId(20); fh.setRT(200.5); fh.setMZ(600.1); fh.setIntensity(1.0f);
+  cf2.insert(fh);
+  cmap.push_back(cf2);
+}
+
+START_SECTION(explicit ColumnarConsensusMap(const ConsensusMap& map))
+{
+  ColumnarConsensusMap c(cmap);
+  TEST_EQUAL(c.getNumberOfFeatures(), 2)
+  TEST_EQUAL(c.getNumberOfMaps(), 3)
+  TEST_EQUAL(c.getNumberOfHandles(), 5)
+  TEST_EQUAL(c.getMapSizes()[1], 20)
+  TEST_REAL_SIMILAR(c.getRTs()[1], 200.0)
+  TEST_REAL_SIMILAR(c.getMZs()[0], 500.0)
+  TEST_REAL_SIMILAR(c.getIntensities()[0], 60.0)
+  TEST_EQUAL(c.getCharges()[0], 2)
+  TEST_EQUAL(c.getUniqueIds()[1], 2)
+
+  TEST_EQUAL(c.getRowOffsets().size(), 3)
+  TEST_EQUAL(c.getRowOffsets()[1], 3)
+  TEST_EQUAL(c.getRowOffsets()[2], 5)
+  // handles are ordered by map index within each consensus feature
+  TEST_EQUAL(c.getHandleMapIndices()[0], 0)
+  TEST_EQUAL(c.getHandleMapIndices()[1], 1)
+  TEST_EQUAL(c.getHandleMapIndices()[2], 2)
+  TEST_EQUAL(c.getHandleMapIndices()[3], 0)
+  TEST_EQUAL(c.getHandleMapIndices()[4], 2)
+  TEST_EQUAL(c.getHandleUniqueIds()[4], 22)
+  TEST_REAL_SIMILAR(c.getHandleIntensities()[1], 20.0)
+  TEST_REAL_SIMILAR(c.getHandleRTs()[3], 200.5)
+  TEST_REAL_SIMILAR(c.getHandleMZs()[2], 499.9)
+  TEST_EQUAL(c.getHandleCharges()[4], 1)
+}
+END_SECTION
+
+START_SECTION(bool operator==(const ColumnarConsensusMap& rhs) const)
+{
+  ColumnarConsensusMap c1(cmap), c2(cmap);
+  TEST_EQUAL(c1 == c2, true)
+  c2.getHandleIntensities()[0] = 11.0f;
+  TEST_EQUAL(c1 == c2, false)
+  TEST_EQUAL(c1 != c2, true)
+}
+END_SECTION
+
+START_SECTION(void clear())
+{
+  ColumnarConsensusMap c(cmap);
+  c.clear();
+  TEST_EQUAL(c == ColumnarConsensusMap(), true)
+}
+END_SECTION
+
+START_SECTION(void exportFeatures(ConsensusMap& map) const)
+{
+  ColumnarConsensusMap c(cmap);
+
+  ConsensusMap out;
+  c.exportFeatures(out);
+  TEST_EQUAL(out.size(), 2)
+  TEST_EQUAL(out[0].size(), 3)
+  TEST_EQUAL(out[1].size(), 2)
+  TEST_EQUAL(out[0].getUniqueId(), 1)
+  TEST_REAL_SIMILAR(out[1].getRT(), 200.0)
+  TEST_EQUAL(out[0].getFeatures() == cmap[0].getFeatures(), true)
+  TEST_EQUAL(out[1].getFeatures() == cmap[1].getFeatures(), true)
+
+  // meta data of existing consensus features is kept
+  ConsensusMap out2 = cmap;
+  c.exportFeatures(out2);
+  TEST_EQUAL(out2[0].getMetaValue("label"), "first")
+  TEST_EQUAL(ColumnarConsensusMap(out2) == c, true)
+}
+END_SECTION
+
+START_SECTION(void exportIntensities(ConsensusMap& map) const)
+{
+  ColumnarConsensusMap c(cmap);
+  c.getHandleIntensities()[1] = 42.0f;
+
+  ConsensusMap out = cmap;
+  c.exportIntensities(out);
+  ConsensusFeature::HandleSetType::const_iterator it = out[0].begin();
+  ++it;
+  TEST_EQUAL(it->getMapIndex(), 1)
+  TEST_REAL_SIMILAR(it->getIntensity(), 42.0)
+
+  ConsensusMap wrong = cmap;
+  wrong.resize(1);
+  TEST_EXCEPTION(Exception::IllegalArgument, c.exportIntensities(wrong))
+}
+END_SECTION
+
+START_SECTION(SignedSize findHandle(Size feature, UInt64 map_index) const)
+{
+  ColumnarConsensusMap c(cmap);
+  TEST_EQUAL(c.findHandle(0, 1), 1)
+  TEST_EQUAL(c.findHandle(1, 2), 4)
+  TEST_EQUAL(c.findHandle(1, 1), -1)
+}
+END_SECTION
+
+START_SECTION(void getIntensityMatrix(std::vector<double>& matrix, double missing = 0.0) const)
+{
+  ColumnarConsensusMap c(cmap);
+  vector<double> m;
+  c.getIntensityMatrix(m, -1.0);
+  TEST_EQUAL(m.size(), 6)
+  TEST_REAL_SIMILAR(m[0], 10.0)
+  TEST_REAL_SIMILAR(m[1], 20.0)
+  TEST_REAL_SIMILAR(m[2], 30.0)
+  TEST_REAL_SIMILAR(m[3], 1.0)
+  TEST_REAL_SIMILAR(m[4], -1.0)
+  TEST_REAL_SIMILAR(m[5], 4.0)
+}
+END_SECTION
+
+START_SECTION(void getMapIntensities(UInt64 map_index, std::vector<double>& intensities) const)
+{
+  ColumnarConsensusMap c(cmap);
+  vector<double> ints;
+  c.getMapIntensities(2, ints);
+  TEST_EQUAL(ints.size(), 2)
+  TEST_REAL_SIMILAR(ints[0], 30.0)
+  TEST_REAL_SIMILAR(ints[1], 4.0)
+  c.getMapIntensities(1, ints);
+  TEST_EQUAL(ints.size(), 1)
+}
+END_SECTION
+
+/////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////
+END_TEST
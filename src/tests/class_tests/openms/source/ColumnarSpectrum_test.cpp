@@ -0,0 +1,224 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2018.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: Timo Sachsenberg$
+// $Authors: Hannes Roest $
+// --------------------------------------------------------------------------
+
+#include <OpenMS/CONCEPT/ClassTest.h>
+
+///////////////////////////
+#include <OpenMS/KERNEL/ColumnarSpectrum.h>
+///////////////////////////
+
+#include <OpenMS/KERNEL/MSSpectrum.h>
+
+#include <algorithm>
+
+using namespace OpenMS;
+using namespace std;
+
+START_TEST(ColumnarSpectrum, "$Id$")
+
+/////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////
+
+ColumnarSpectrum* ptr = nullptr;
+ColumnarSpectrum* nullPointer = nullptr;
+START_SECTION(ColumnarSpectrum())
+{
+  ptr = new ColumnarSpectrum();
+  TEST_NOT_EQUAL(ptr, nullPointer)
+  TEST_EQUAL(ptr->size(), 0)
+  TEST_EQUAL(ptr->empty(), true)
+}
+END_SECTION
+
+START_SECTION(~ColumnarSpectrum())
+{
+  delete ptr;
+}
+END_SECTION
+
+MSSpectrum spec;
+spec.setRT(12.5);
+spec.setMSLevel(2);
+spec.setName("test spectrum");
+spec.push_back(Peak1D(500.0, 10.0f));
+spec.push_back(Peak1D(501.0, 20.0f));
+spec.push_back(Peak1D(502.5, 5.0f));
+spec.push_back(Peak1D(505.0, 15.0f));
+
+START_SECTION(explicit ColumnarSpectrum(const MSSpectrum& spectrum))
+{
+  ColumnarSpectrum c(spec);
+  TEST_EQUAL(c.size(), 4)
+  TEST_REAL_SIMILAR(c.getRT(), 12.5)
+  TEST_EQUAL(c.getMSLevel(), 2)
+  for (Size i = 0; i < spec.size(); ++i)
+  {
+    TEST_EQUAL(c.getMZ(i), spec[i].getMZ())
+    TEST_EQUAL(c.getIntensity(i), spec[i].getIntensity())
+  }
+}
+END_SECTION
+
+START_SECTION(void exportPeaks(MSSpectrum& spectrum) const)
+{
+  ColumnarSpectrum c(spec);
+  MSSpectrum out = spec;
+  out.clear(false);
+  c.exportPeaks(out);
+  TEST_EQUAL(out == spec, true)
+  TEST_EQUAL(out.getName(), "test spectrum")
+
+  // modify in columnar representation and write back
+  c.setIntensity(1, 100.0f);
+  c.push_back(510.0, 1.0f);
+  c.exportPeaks(out);
+  TEST_EQUAL(out.size(), 5)
+  TEST_REAL_SIMILAR(out[1].getIntensity(), 100.0)
+  TEST_REAL_SIMILAR(out[4].getMZ(), 510.0)
+}
+END_SECTION
+
+START_SECTION(bool operator==(const ColumnarSpectrum& rhs) const)
+{
+  ColumnarSpectrum c1(spec), c2(spec);
+  TEST_EQUAL(c1 == c2, true)
+  c2.setRT(1.0);
+  TEST_EQUAL(c1 == c2, false)
+  TEST_EQUAL(c1 != c2, true)
+}
+END_SECTION
+
+START_SECTION(Iterator begin())
+{
+  ColumnarSpectrum c(spec);
+  Size i = 0;
+  for (ColumnarSpectrum::ConstIterator it = c.begin(); it != c.end(); ++it, ++i)
+  {
+    TEST_EQUAL(it->getMZ(), spec[i].getMZ())
+    TEST_EQUAL((*it).getIntensity(), spec[i].getIntensity())
+  }
+  TEST_EQUAL(i, 4)
+  TEST_EQUAL(c.end() - c.begin(), 4)
+
+  for (ColumnarSpectrum::Iterator it = c.begin(); it != c.end(); ++it)
+  {
+    it->setIntensity(it->getIntensity() * 2);
+  }
+  TEST_REAL_SIMILAR(c.getIntensity(0), 20.0)
+  TEST_REAL_SIMILAR(c.begin()[3].getIntensity(), 30.0)
+
+  Peak1D p = *(c.begin() + 1);
+  TEST_REAL_SIMILAR(p.getMZ(), 501.0)
+  TEST_REAL_SIMILAR(p.getIntensity(), 40.0)
+}
+END_SECTION
+
+START_SECTION(const CoordinateType* getMZData() const)
+{
+  ColumnarSpectrum c(spec);
+  const double* mz = c.getMZData();
+  const float* intensity = c.getIntensityData();
+  TEST_REAL_SIMILAR(mz[2], 502.5)
+  TEST_REAL_SIMILAR(intensity[2], 5.0)
+  TEST_EQUAL(c.getMZArray().size(), 4)
+  TEST_EQUAL(c.getIntensityArray().size(), 4)
+}
+END_SECTION
+
+START_SECTION(void sortByPosition())
+{
+  ColumnarSpectrum c;
+  c.push_back(505.0, 4.0f);
+  c.push_back(500.0, 1.0f);
+  c.push_back(502.0, 3.0f);
+  c.push_back(501.0, 2.0f);
+  TEST_EQUAL(c.isSorted(), false)
+  c.sortByPosition();
+  TEST_EQUAL(c.isSorted(), true)
+  for (Size i = 0; i < c.size(); ++i)
+  {
+    // intensities move together with their m/z
+    TEST_REAL_SIMILAR(c.getIntensity(i), i + 1.0)
+  }
+}
+END_SECTION
+
+START_SECTION(Size findNearest(CoordinateType mz) const)
+{
+  ColumnarSpectrum c(spec);
+  TEST_EQUAL(c.findNearest(400.0), 0)
+  TEST_EQUAL(c.findNearest(500.4), 0)
+  TEST_EQUAL(c.findNearest(500.6), 1)
+  TEST_EQUAL(c.findNearest(502.5), 2)
+  TEST_EQUAL(c.findNearest(600.0), 3)
+  for (double mz = 499.0; mz < 506.0; mz += 0.3)
+  {
+    TEST_EQUAL(c.findNearest(mz), spec.findNearest(mz))
+  }
+
+  ColumnarSpectrum empty;
+  TEST_EXCEPTION(Exception::Precondition, empty.findNearest(500.0))
+}
+END_SECTION
+
+START_SECTION(ConstIterator MZBegin(CoordinateType mz) const)
+{
+  const ColumnarSpectrum c(spec);
+  TEST_EQUAL(c.MZBegin(499.0) - c.begin(), 0)
+  TEST_EQUAL(c.MZBegin(501.0) - c.begin(), 1)
+  TEST_EQUAL(c.MZBegin(501.5) - c.begin(), 2)
+  TEST_EQUAL(c.MZBegin(600.0) == c.end(), true)
+}
+END_SECTION
+
+START_SECTION(ConstIterator MZEnd(CoordinateType mz) const)
+{
+  const ColumnarSpectrum c(spec);
+  TEST_EQUAL(c.MZEnd(499.0) - c.begin(), 0)
+  TEST_EQUAL(c.MZEnd(501.0) - c.begin(), 2)
+  TEST_EQUAL(c.MZEnd(600.0) == c.end(), true)
+}
+END_SECTION
+
+START_SECTION(double calculateTIC() const)
+{
+  ColumnarSpectrum c(spec);
+  TEST_REAL_SIMILAR(c.calculateTIC(), 50.0)
+  TEST_REAL_SIMILAR(ColumnarSpectrum().calculateTIC(), 0.0)
+}
+END_SECTION
+
+/////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////
+END_TEST
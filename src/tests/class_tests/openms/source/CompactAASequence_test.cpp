@@ -0,0 +1,187 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2018.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: Timo Sachsenberg $
+// $Authors: Timo Sachsenberg $
+// --------------------------------------------------------------------------
+
+#include <OpenMS/CONCEPT/ClassTest.h>
+#include <OpenMS/test_config.h>
+
+///////////////////////////
+#include <OpenMS/CHEMISTRY/CompactAASequence.h>
+///////////////////////////
+
+#include <OpenMS/CHEMISTRY/ResidueDB.h>
+#include <OpenMS/CHEMISTRY/Residue.h>
+
+#include <set>
+#include <sstream>
+#include <unordered_set>
+
+using namespace OpenMS;
+using namespace std;
+
+START_TEST(CompactAASequence, "$Id$")
+
+/////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////
+
+CompactAASequence* ptr = nullptr;
+CompactAASequence* null_ptr = nullptr;
+START_SECTION(CompactAASequence())
+{
+  ptr = new CompactAASequence();
+  TEST_NOT_EQUAL(ptr, null_ptr)
+  TEST_EQUAL(ptr->empty(), true)
+  TEST_EQUAL(ptr->isModified(), false)
+}
+END_SECTION
+
+START_SECTION(~CompactAASequence())
+{
+  delete ptr;
+}
+END_SECTION
+
+START_SECTION((explicit CompactAASequence(const AASequence& sequence)))
+{
+  AASequence aa = AASequence::fromString(".(Acetyl)PEPM(Oxidation)TIDEK(Amidated)");
+  CompactAASequence seq(aa);
+  TEST_EQUAL(seq.size(), 9)
+  TEST_EQUAL(seq.toUnmodifiedString(), "PEPMTIDEK")
+  TEST_EQUAL(seq.isModified(), true)
+  TEST_EQUAL(seq.getModifiedResidues().size(), 1)
+  TEST_EQUAL(seq.getModifiedResidues()[0].first, 3)
+  TEST_EQUAL(seq.getModifiedResidues()[0].second, &aa.getResidue(3))
+  TEST_EQUAL(seq.getNTerminalModification(), aa.getNTerminalModification())
+  TEST_EQUAL(seq.getCTerminalModification(), aa.getCTerminalModification())
+}
+END_SECTION
+
+START_SECTION((static CompactAASequence fromString(const String& sequence)))
+{
+  CompactAASequence plain = CompactAASequence::fromString("PEPTIDEK");
+  TEST_EQUAL(plain.isModified(), false)
+  TEST_EQUAL(plain == CompactAASequence(AASequence::fromString("PEPTIDEK")), true)
+
+  CompactAASequence modified = CompactAASequence::fromString("PEPM(Oxidation)TIDEK");
+  TEST_EQUAL(modified.isModified(), true)
+  TEST_EQUAL(modified == CompactAASequence(AASequence::fromString("PEPM(Oxidation)TIDEK")), true)
+  TEST_EQUAL(modified != plain, true)
+
+  TEST_EXCEPTION(Exception::ParseError, CompactAASequence::fromString("blDABCDEF"))
+}
+END_SECTION
+
+START_SECTION((AASequence toAASequence() const))
+{
+  const String s = ".(Acetyl)PEPM(Oxidation)TIDEC(Carbamidomethyl)K";
+  AASequence aa = AASequence::fromString(s);
+  TEST_EQUAL(CompactAASequence(aa).toAASequence() == aa, true)
+  TEST_EQUAL(CompactAASequence::fromString("PEPTIDE").toAASequence() == AASequence::fromString("PEPTIDE"), true)
+}
+END_SECTION
+
+START_SECTION((String toString() const))
+{
+  TEST_STRING_EQUAL(CompactAASequence::fromString("PEPTIDE").toString(), "PEPTIDE")
+  AASequence aa = AASequence::fromString(".(Acetyl)PEPM(Oxidation)TIDEK");
+  TEST_STRING_EQUAL(CompactAASequence(aa).toString(), aa.toString())
+  stringstream ss;
+  ss << CompactAASequence(aa);
+  TEST_STRING_EQUAL(ss.str(), aa.toString())
+}
+END_SECTION
+
+START_SECTION((const Residue* getResidue(Size index) const))
+{
+  AASequence aa = AASequence::fromString("PEPM(Oxidation)TIDEK");
+  CompactAASequence seq(aa);
+  for (Size i = 0; i < aa.size(); ++i)
+  {
+    TEST_EQUAL(seq.getResidue(i), &aa.getResidue(i))
+  }
+  TEST_EQUAL(seq.getResidue(0), ResidueDB::getInstance()->getResidue('P'))
+}
+END_SECTION
+
+START_SECTION((std::size_t getHash() const))
+{
+  CompactAASequence a = CompactAASequence::fromString("PEPM(Oxidation)TIDEK");
+  CompactAASequence b(AASequence::fromString("PEPM(Oxidation)TIDEK"));
+  TEST_EQUAL(a.getHash(), b.getHash())
+  TEST_EQUAL(CompactAASequence::Hash()(a), a.getHash())
+
+  unordered_set<CompactAASequence, CompactAASequence::Hash> seqs;
+  seqs.insert(a);
+  seqs.insert(b);
+  seqs.insert(CompactAASequence::fromString("PEPMTIDEK"));
+  TEST_EQUAL(seqs.size(), 2)
+}
+END_SECTION
+
+START_SECTION((bool operator<(const CompactAASequence& rhs) const))
+{
+  // same order as AASequence
+  const char* strings[] = {"PEPTIDE", "PEPM(Oxidation)TIDE", "PEPMTIDE", ".(Acetyl)PEPMTIDE", "PEPMTIDE(Amidated)", "AAA", "PEPTIDEK", "SEPTIDE"};
+  set<AASequence> aa_set;
+  set<CompactAASequence> compact_set;
+  for (Size i = 0; i < sizeof(strings) / sizeof(strings[0]); ++i)
+  {
+    aa_set.insert(AASequence::fromString(strings[i]));
+    compact_set.insert(CompactAASequence::fromString(strings[i]));
+  }
+  TEST_EQUAL(aa_set.size(), compact_set.size())
+  set<AASequence>::const_iterator it_aa = aa_set.begin();
+  for (set<CompactAASequence>::const_iterator it = compact_set.begin(); it != compact_set.end(); ++it, ++it_aa)
+  {
+    TEST_STRING_EQUAL(it->toString(), it_aa->toString())
+  }
+  TEST_EQUAL(CompactAASequence::fromString("PEPTIDE") < CompactAASequence::fromString("PEPTIDE"), false)
+}
+END_SECTION
+
+START_SECTION((static const CompactAASequence& intern(const CompactAASequence& sequence)))
+{
+  Size before = CompactAASequence::getInternedCount();
+  const CompactAASequence& a = CompactAASequence::intern(CompactAASequence::fromString("PEPM(Oxidation)TIDEK"));
+  const CompactAASequence& b = CompactAASequence::intern(CompactAASequence(AASequence::fromString("PEPM(Oxidation)TIDEK")));
+  const CompactAASequence& c = CompactAASequence::intern(CompactAASequence::fromString("PEPMTIDEK"));
+  TEST_EQUAL(&a, &b)
+  TEST_NOT_EQUAL(&a, &c)
+  TEST_EQUAL(CompactAASequence::getInternedCount(), before + 2)
+  TEST_STRING_EQUAL(a.toString(), "PEPM(Oxidation)TIDEK")
+}
+END_SECTION
+
+/////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////
+END_TEST
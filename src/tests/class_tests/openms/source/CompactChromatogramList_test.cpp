@@ -0,0 +1,169 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry               
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2018.
+// 
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution 
+//    may be used to endorse or promote products derived from this software 
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS. 
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING 
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, 
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, 
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; 
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, 
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR 
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF 
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+// 
+// --------------------------------------------------------------------------
+// $Maintainer: Hannes Roest $
+// $Authors: Hannes Roest $
+// --------------------------------------------------------------------------
+
+#include <OpenMS/CONCEPT/ClassTest.h>
+#include <OpenMS/test_config.h>
+
+///////////////////////////
+#include <OpenMS/ANALYSIS/OPENSWATH/CompactChromatogramList.h>
+///////////////////////////
+
+using namespace OpenMS;
+using namespace std;
+
+START_TEST(CompactChromatogramList, "$Id$")
+
+/////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////
+
+CompactChromatogramList* ptr = nullptr;
+CompactChromatogramList* nullPointer = nullptr;
+
+boost::shared_ptr<const std::vector<double> > rt_axis(new std::vector<double>({10.0, 20.0, 30.0, 40.0, 50.0}));
+
+START_SECTION(CompactChromatogramList())
+{
+  ptr = new CompactChromatogramList();
+  TEST_NOT_EQUAL(ptr, nullPointer)
+  TEST_EQUAL(ptr->size(), 0)
+  TEST_EQUAL(ptr->getRTAxis().size(), 0)
+  TEST_EQUAL(ptr->getChromatograms().size(), 0)
+  delete ptr;
+}
+END_SECTION
+
+START_SECTION(CompactChromatogramList(Size size, const boost::shared_ptr<const std::vector<double> >& rt_axis))
+{
+  CompactChromatogramList list(3, rt_axis);
+  TEST_EQUAL(list.size(), 3)
+  TEST_EQUAL(list.getRTAxis().size(), 5)
+  TEST_EQUAL(&list.getRTAxis(), rt_axis.get())
+  TEST_EQUAL(list.getNrPoints(0), 0)
+  TEST_EQUAL(list.getChromatogram(2)->getTimeArray()->data.size(), 0)
+  TEST_EQUAL(list.getChromatogram(2)->getIntensityArray()->data.size(), 0)
+}
+END_SECTION
+
+START_SECTION(Size size() const)
+{
+  NOT_TESTABLE // tested above
+}
+END_SECTION
+
+START_SECTION(const std::vector<double>& getRTAxis() const)
+{
+  NOT_TESTABLE // tested above
+}
+END_SECTION
+
+START_SECTION(void push_back(Size chrom, Size rt_index, double intensity))
+{
+  CompactChromatogramList list(2, rt_axis);
+  // consecutive data points
+  list.push_back(0, 1, 1.5);
+  list.push_back(0, 2, 2.5);
+  list.push_back(0, 3, 3.5);
+  // a gap (e.g. spectra without data in between)
+  list.push_back(1, 0, 100.0);
+  list.push_back(1, 1, 200.0);
+  list.push_back(1, 4, 300.0);
+  TEST_EQUAL(list.getNrPoints(0), 3)
+  TEST_EQUAL(list.getNrPoints(1), 3)
+
+  OpenSwath::ChromatogramPtr chrom = list.getChromatogram(0);
+  TEST_EQUAL(chrom->getTimeArray()->data.size(), 3)
+  TEST_REAL_SIMILAR(chrom->getTimeArray()->data[0], 20.0)
+  TEST_REAL_SIMILAR(chrom->getTimeArray()->data[1], 30.0)
+  TEST_REAL_SIMILAR(chrom->getTimeArray()->data[2], 40.0)
+  TEST_REAL_SIMILAR(chrom->getIntensityArray()->data[0], 1.5)
+  TEST_REAL_SIMILAR(chrom->getIntensityArray()->data[1], 2.5)
+  TEST_REAL_SIMILAR(chrom->getIntensityArray()->data[2], 3.5)
+
+  chrom = list.getChromatogram(1);
+  TEST_EQUAL(chrom->getTimeArray()->data.size(), 3)
+  TEST_REAL_SIMILAR(chrom->getTimeArray()->data[0], 10.0)
+  TEST_REAL_SIMILAR(chrom->getTimeArray()->data[1], 20.0)
+  TEST_REAL_SIMILAR(chrom->getTimeArray()->data[2], 50.0)
+  TEST_REAL_SIMILAR(chrom->getIntensityArray()->data[0], 100.0)
+  TEST_REAL_SIMILAR(chrom->getIntensityArray()->data[1], 200.0)
+  TEST_REAL_SIMILAR(chrom->getIntensityArray()->data[2], 300.0)
+
+  // intensities are stored in single precision
+  list.push_back(0, 4, 0.1);
+  TEST_EQUAL(list.getChromatogram(0)->getIntensityArray()->data[3], double(0.1f))
+}
+END_SECTION
+
+START_SECTION(Size getNrPoints(Size chrom) const)
+{
+  NOT_TESTABLE // tested above
+}
+END_SECTION
+
+START_SECTION(OpenSwath::ChromatogramPtr getChromatogram(Size chrom) const)
+{
+  NOT_TESTABLE // tested above
+}
+END_SECTION
+
+START_SECTION(std::vector<OpenSwath::ChromatogramPtr> getChromatograms() const)
+{
+  CompactChromatogramList list(2, rt_axis);
+  list.push_back(0, 0, 1.0);
+  list.push_back(1, 3, 2.0);
+  list.push_back(1, 4, 3.0);
+  std::vector<OpenSwath::ChromatogramPtr> chroms = list.getChromatograms();
+  TEST_EQUAL(chroms.size(), 2)
+  TEST_EQUAL(chroms[0]->getTimeArray()->data.size(), 1)
+  TEST_REAL_SIMILAR(chroms[0]->getTimeArray()->data[0], 10.0)
+  TEST_EQUAL(chroms[1]->getTimeArray()->data.size(), 2)
+  TEST_REAL_SIMILAR(chroms[1]->getTimeArray()->data[0], 40.0)
+  TEST_REAL_SIMILAR(chroms[1]->getIntensityArray()->data[1], 3.0)
+}
+END_SECTION
+
+START_SECTION(void clear())
+{
+  CompactChromatogramList list(2, rt_axis);
+  list.push_back(0, 0, 1.0);
+  list.clear();
+  TEST_EQUAL(list.size(), 0)
+  TEST_EQUAL(list.getChromatograms().size(), 0)
+  TEST_EQUAL(list.getRTAxis().size(), 5) // the axis is kept
+}
+END_SECTION
+
+/////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////
+END_TEST
@@ -0,0 +1,191 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2018.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: Chris Bielow $
+// $Authors: Chris Bielow $
+// --------------------------------------------------------------------------
+
+#include <OpenMS/CONCEPT/ClassTest.h>
+#include <OpenMS/test_config.h>
+
+///////////////////////////
+#include <OpenMS/CHEMISTRY/CompactEmpiricalFormula.h>
+///////////////////////////
+
+#include <OpenMS/CHEMISTRY/ElementDB.h>
+#include <OpenMS/CHEMISTRY/Element.h>
+#include <OpenMS/DATASTRUCTURES/ListUtils.h>
+#include <OpenMS/DATASTRUCTURES/String.h>
+
+#include <sstream>
+
+using namespace OpenMS;
+using namespace std;
+
+START_TEST(CompactEmpiricalFormula, "$Id$")
+
+/////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////
+
+CompactEmpiricalFormula* ptr = nullptr;
+CompactEmpiricalFormula* null_ptr = nullptr;
+const ElementDB* db = ElementDB::getInstance();
+
+START_SECTION(CompactEmpiricalFormula())
+{
+  ptr = new CompactEmpiricalFormula();
+  TEST_NOT_EQUAL(ptr, null_ptr)
+  TEST_EQUAL(ptr->isEmpty(), true)
+  TEST_EQUAL(ptr->getCharge(), 0)
+  TEST_REAL_SIMILAR(ptr->getMonoWeight(), 0.0)
+}
+END_SECTION
+
+START_SECTION(~CompactEmpiricalFormula())
+{
+  delete ptr;
+}
+END_SECTION
+
+START_SECTION(explicit CompactEmpiricalFormula(const String& formula))
+{
+  CompactEmpiricalFormula ef("C6H12O6Na+");
+  TEST_EQUAL(ef.getNumberOf(CompactEmpiricalFormula::C), 6)
+  TEST_EQUAL(ef.getNumberOf(CompactEmpiricalFormula::H), 12)
+  TEST_EQUAL(ef.getNumberOf(CompactEmpiricalFormula::O), 6)
+  TEST_EQUAL(ef.getNumberOf(CompactEmpiricalFormula::N), 0)
+  TEST_EQUAL(ef.getNumberOf(db->getElement("Na")), 1)
+  TEST_EQUAL(ef.getNumberOf(db->getElement("C")), 6)
+  TEST_EQUAL(ef.getOtherElements().size(), 1)
+  TEST_EQUAL(ef.hasOnlyCommonElements(), false)
+  TEST_EQUAL(ef.getCharge(), 1)
+  TEST_EXCEPTION(Exception::ParseError, CompactEmpiricalFormula("C6Xx2"))
+}
+END_SECTION
+
+START_SECTION(CompactEmpiricalFormula(SignedSize number, const Element* element, SignedSize charge = 0))
+{
+  CompactEmpiricalFormula ef(4, db->getElement("N"), -1);
+  TEST_EQUAL(ef.getNumberOf(CompactEmpiricalFormula::N), 4)
+  TEST_EQUAL(ef.hasOnlyCommonElements(), true)
+  TEST_EQUAL(ef.getCharge(), -1)
+  CompactEmpiricalFormula ef2(2, db->getElement("Fe"));
+  TEST_EQUAL(ef2.getNumberOf(db->getElement("Fe")), 2)
+  TEST_EQUAL(ef2.getNumberOfAtoms(), 2)
+}
+END_SECTION
+
+START_SECTION((explicit CompactEmpiricalFormula(const EmpiricalFormula& formula)) and (EmpiricalFormula toEmpiricalFormula() const))
+{
+  StringList formulas = ListUtils::create<String>("C6H12O6,C10H15N5O10P2,C3H7NO2S,(13)C6H12O6,C2H5ClHgF-2,H-2O-1");
+  for (const String& f : formulas)
+  {
+    EmpiricalFormula ef(f);
+    CompactEmpiricalFormula compact(ef);
+    TEST_EQUAL(compact.toEmpiricalFormula() == ef, true)
+    TEST_EQUAL(compact.toString(), ef.toString())
+    TEST_REAL_SIMILAR(compact.getMonoWeight(), ef.getMonoWeight())
+    TEST_REAL_SIMILAR(compact.getAverageWeight(), ef.getAverageWeight())
+    TEST_EQUAL(compact.getNumberOfAtoms(), ef.getNumberOfAtoms())
+    TEST_EQUAL(compact.getCharge(), ef.getCharge())
+  }
+}
+END_SECTION
+
+START_SECTION(static const Element* getElement(CommonElement element))
+{
+  TEST_EQUAL(CompactEmpiricalFormula::getElement(CompactEmpiricalFormula::C), db->getElement("C"))
+  TEST_EQUAL(CompactEmpiricalFormula::getElement(CompactEmpiricalFormula::S), db->getElement("S"))
+}
+END_SECTION
+
+START_SECTION(void setNumberOf(CommonElement element, SignedSize number))
+{
+  CompactEmpiricalFormula ef;
+  ef.setNumberOf(CompactEmpiricalFormula::P, 2);
+  ef.setNumberOf(CompactEmpiricalFormula::O, 7);
+  ef.setNumberOf(CompactEmpiricalFormula::H, 4);
+  TEST_EQUAL(ef.toEmpiricalFormula() == EmpiricalFormula("H4P2O7"), true)
+  ef.setCharge(-2);
+  TEST_EQUAL(ef.getCharge(), -2)
+  TEST_REAL_SIMILAR(ef.getMonoWeight(), EmpiricalFormula("H4P2O7-2").getMonoWeight())
+}
+END_SECTION
+
+START_SECTION((CompactEmpiricalFormula operator+(const CompactEmpiricalFormula& rhs) const) and (CompactEmpiricalFormula operator-(const CompactEmpiricalFormula& rhs) const) and (CompactEmpiricalFormula operator*(SignedSize times) const))
+{
+  EmpiricalFormula a("C6H12O6Na"), b("H2OCl"), c("NaCl");
+  CompactEmpiricalFormula ca(a), cb(b), cc(c);
+  TEST_EQUAL((ca + cb).toEmpiricalFormula() == a + b, true)
+  TEST_EQUAL((ca - cb).toEmpiricalFormula() == a - b, true)
+  TEST_EQUAL((ca * 3).toEmpiricalFormula() == a * 3, true)
+  TEST_EQUAL((ca * 0).isEmpty(), true)
+
+  // elements with zero count are removed from the list of other elements
+  CompactEmpiricalFormula d = ca + cb - cc;
+  TEST_EQUAL(d.hasOnlyCommonElements(), true)
+  TEST_EQUAL(d.toEmpiricalFormula() == EmpiricalFormula("C6H14O7"), true)
+  TEST_REAL_SIMILAR(d.getMonoWeight(), EmpiricalFormula("C6H14O7").getMonoWeight())
+
+  CompactEmpiricalFormula e(ca);
+  e += cb;
+  e -= cb;
+  TEST_EQUAL(e == ca, true)
+  e *= 2;
+  TEST_EQUAL(e == ca + ca, true)
+}
+END_SECTION
+
+START_SECTION((bool operator==(const CompactEmpiricalFormula& rhs) const) and (bool operator!=(const CompactEmpiricalFormula& rhs) const) and (bool operator<(const CompactEmpiricalFormula& rhs) const))
+{
+  CompactEmpiricalFormula a("C6H12O6"), b("C6H12O6"), c("C6H12O6+"), d("C6H12O6Na");
+  TEST_EQUAL(a == b, true)
+  TEST_EQUAL(a != c, true)
+  TEST_EQUAL(a != d, true)
+  TEST_EQUAL(a < b || b < a, false)
+  TEST_EQUAL(a < c, true)
+  TEST_EQUAL(c < a, false)
+  TEST_EQUAL(a < d, true)
+  TEST_EQUAL(d < a, false)
+}
+END_SECTION
+
+START_SECTION(std::ostream& operator<<(std::ostream& os, const CompactEmpiricalFormula& formula))
+{
+  std::ostringstream os1, os2;
+  os1 << CompactEmpiricalFormula("C6H12O6Na+");
+  os2 << EmpiricalFormula("C6H12O6Na+");
+  TEST_EQUAL(os1.str(), os2.str())
+}
+END_SECTION
+
+/////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////
+END_TEST
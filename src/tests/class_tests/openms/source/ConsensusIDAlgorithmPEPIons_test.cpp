@@ -70,6 +70,71 @@ START_SECTION(void apply(std::vector<PeptideIdentification>& ids))
 }
 END_SECTION
 
+START_SECTION((void apply(std::vector<std::vector<PeptideIdentification>*>& id_sets, const std::vector<Size>& number_of_runs = std::vector<Size>())))
+{
+  // two spectra with three ID runs each, sharing some sequences:
+  PeptideIdentification temp;
+  temp.setScoreType("Posterior Error Probability");
+  temp.setHigherScoreBetter(false);
+  vector<PeptideIdentification> ids1(3, temp), ids2(3, temp);
+  const char* sequences[] = {"PEPTIDER", "PEPTIDEK", "SAMPLER", "SAMPLEK",
+                             "PEPTLDER", "DFPIANGER"};
+  for (Size i = 0; i < 3; ++i)
+  {
+    vector<PeptideHit> hits(3);
+    for (Size j = 0; j < 3; ++j)
+    {
+      hits[j].setSequence(AASequence::fromString(sequences[(i + j) % 6]));
+      hits[j].setScore(0.1 * (j + 1) + 0.05 * i);
+      hits[j].setCharge(2);
+    }
+    ids1[i].setHits(hits);
+    for (Size j = 0; j < 3; ++j)
+    {
+      hits[j].setSequence(AASequence::fromString(sequences[(2 * i + j + 3) % 6]));
+    }
+    ids2[i].setHits(hits);
+  }
+
+  // results of individual calls:
+  vector<PeptideIdentification> single1 = ids1, single2 = ids2;
+  ConsensusIDAlgorithmPEPIons consensus1;
+  consensus1.apply(single1);
+  consensus1.apply(single2, 4);
+
+  // results of the combined call:
+  ConsensusIDAlgorithmPEPIons consensus2;
+  vector<PeptideIdentification> empty;
+  vector<vector<PeptideIdentification>*> id_sets;
+  id_sets.push_back(&ids1);
+  id_sets.push_back(&empty);
+  id_sets.push_back(&ids2);
+  vector<Size> number_of_runs(3, 0);
+  number_of_runs[2] = 4;
+  consensus2.apply(id_sets, number_of_runs);
+
+  TEST_EQUAL(empty.size(), 0)
+  TEST_EQUAL(ids1.size(), 1)
+  TEST_EQUAL(ids2.size(), 1)
+  ABORT_IF(ids1.size() != 1 || ids2.size() != 1)
+  TEST_EQUAL(ids1[0].getHits().size(), single1[0].getHits().size())
+  for (Size i = 0; i < ids1[0].getHits().size(); ++i)
+  {
+    TEST_EQUAL(ids1[0].getHits()[i].getSequence(), single1[0].getHits()[i].getSequence())
+    TEST_REAL_SIMILAR(ids1[0].getHits()[i].getScore(), single1[0].getHits()[i].getScore())
+  }
+  TEST_EQUAL(ids2[0].getHits().size(), single2[0].getHits().size())
+  for (Size i = 0; i < ids2[0].getHits().size(); ++i)
+  {
+    TEST_EQUAL(ids2[0].getHits()[i].getSequence(), single2[0].getHits()[i].getSequence())
+    TEST_REAL_SIMILAR(ids2[0].getHits()[i].getScore(), single2[0].getHits()[i].getScore())
+    TEST_REAL_SIMILAR(ids2[0].getHits()[i].getMetaValue("consensus_support"), single2[0].getHits()[i].getMetaValue("consensus_support"))
+  }
+
+  TEST_EXCEPTION(Exception::IllegalArgument, consensus2.apply(id_sets, vector<Size>(2, 3)))
+}
+END_SECTION
+
 /////////////////////////////////////////////////////////////
 /////////////////////////////////////////////////////////////
 END_TEST
@@ -79,6 +79,65 @@ START_SECTION((static std::vector<double> computeNormalizationFactors(const Cons
 }
 END_SECTION
 
+// two maps; map 1 has twice the intensities of map 0 and more features
+ConsensusMap cmap;
+cmap.getColumnHeaders()[0].size = 3;
+cmap.getColumnHeaders()[1].size = 4;
+for (Size i = 0; i < 3; ++i)
+{
+  ConsensusFeature cf;
+  cf.setUniqueId(i + 1);
+  FeatureHandle fh;
+  fh.setMapIndex(0); fh.setUniqueId(10 + i); fh.setIntensity(10.0f * (i + 1));
+  cf.insert(fh);
+  fh.setMapIndex(1); fh.setUniqueId(20 + i); fh.setIntensity(20.0f * (i + 1));
+  cf.insert(fh);
+  cmap.push_back(cf);
+}
+
+START_SECTION((static Size computeMedians(const ColumnarConsensusMap &map, std::vector<double> &medians, const std::vector<bool>& use_feature = std::vector<bool>())))
+{
+  ColumnarConsensusMap columnar(cmap);
+  vector<double> medians;
+  TEST_EQUAL(ConsensusMapNormalizerAlgorithmMedian::computeMedians(columnar, medians), 1)
+  TEST_EQUAL(medians.size(), 2)
+  TEST_REAL_SIMILAR(medians[0], 20.0)
+  TEST_REAL_SIMILAR(medians[1], 40.0)
+
+  vector<bool> use_feature(3, false);
+  use_feature[2] = true;
+  ConsensusMapNormalizerAlgorithmMedian::computeMedians(columnar, medians, use_feature);
+  TEST_REAL_SIMILAR(medians[0], 30.0)
+  TEST_REAL_SIMILAR(medians[1], 60.0)
+
+  // same result through the ConsensusMap interface
+  vector<double> medians2;
+  TEST_EQUAL(ConsensusMapNormalizerAlgorithmMedian::computeMedians(cmap, medians2, "", ""), 1)
+  TEST_REAL_SIMILAR(medians2[0], 20.0)
+  TEST_REAL_SIMILAR(medians2[1], 40.0)
+}
+END_SECTION
+
+START_SECTION((static void normalizeMaps(ColumnarConsensusMap &map, NormalizationMethod method, const std::vector<bool>& use_feature = std::vector<bool>())))
+{
+  ColumnarConsensusMap columnar(cmap);
+  ConsensusMapNormalizerAlgorithmMedian::normalizeMaps(columnar, ConsensusMapNormalizerAlgorithmMedian::NM_SCALE);
+  // map 0 is scaled to the median of the largest map (map 1)
+  TEST_REAL_SIMILAR(columnar.getHandleIntensities()[0], 20.0)
+  TEST_REAL_SIMILAR(columnar.getHandleIntensities()[1], 20.0)
+  TEST_REAL_SIMILAR(columnar.getHandleIntensities()[4], 60.0)
+
+  ConsensusMap normalized = cmap;
+  ConsensusMapNormalizerAlgorithmMedian::normalizeMaps(normalized, ConsensusMapNormalizerAlgorithmMedian::NM_SCALE, "", "");
+  TEST_EQUAL(ColumnarConsensusMap(normalized) == columnar, true)
+
+  ColumnarConsensusMap shifted(cmap);
+  ConsensusMapNormalizerAlgorithmMedian::normalizeMaps(shifted, ConsensusMapNormalizerAlgorithmMedian::NM_SHIFT);
+  TEST_REAL_SIMILAR(shifted.getHandleIntensities()[0], 30.0)
+  TEST_REAL_SIMILAR(shifted.getHandleIntensities()[1], 40.0)
+}
+END_SECTION
+
 
 /////////////////////////////////////////////////////////////
 /////////////////////////////////////////////////////////////
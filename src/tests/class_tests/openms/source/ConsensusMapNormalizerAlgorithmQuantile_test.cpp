@@ -67,9 +67,55 @@ START_SECTION((virtual ~ConsensusMapNormalizerAlgorithmQuantile()))
 }
 END_SECTION
 
+// two maps with three features each (map 1 in a different order)
+ConsensusMap cmap;
+cmap.getColumnHeaders()[0].size = 3;
+cmap.getColumnHeaders()[1].size = 3;
+{
+  const float ints0[] = {1.0f, 2.0f, 3.0f};
+  const float ints1[] = {10.0f, 30.0f, 20.0f};
+  for (Size i = 0; i < 3; ++i)
+  {
+    ConsensusFeature cf;
+    FeatureHandle fh;
+    fh.setMapIndex(0); fh.setUniqueId(i); fh.setIntensity(ints0[i]);
+    cf.insert(fh);
+    fh.setMapIndex(1); fh.setUniqueId(i); fh.setIntensity(ints1[i]);
+    cf.insert(fh);
+    cmap.push_back(cf);
+  }
+}
+
 START_SECTION((static void normalizeMaps(ConsensusMap &map)))
 {
-  // TODO
+  ConsensusMap normalized = cmap;
+  ConsensusMapNormalizerAlgorithmQuantile::normalizeMaps(normalized);
+  // reference distribution is (5.5, 11, 16.5), assigned according to the ranks within each map
+  vector<vector<double> > ints;
+  ConsensusMapNormalizerAlgorithmQuantile::extractIntensityVectors(normalized, ints);
+  TEST_EQUAL(ints.size(), 2)
+  TEST_REAL_SIMILAR(ints[0][0], 5.5)
+  TEST_REAL_SIMILAR(ints[0][1], 11.0)
+  TEST_REAL_SIMILAR(ints[0][2], 16.5)
+  TEST_REAL_SIMILAR(ints[1][0], 5.5)
+  TEST_REAL_SIMILAR(ints[1][1], 16.5)
+  TEST_REAL_SIMILAR(ints[1][2], 11.0)
+}
+END_SECTION
+
+START_SECTION((static void normalizeMaps(ColumnarConsensusMap &map)))
+{
+  ColumnarConsensusMap columnar(cmap);
+  ConsensusMapNormalizerAlgorithmQuantile::normalizeMaps(columnar);
+  // handles of each consensus feature are ordered by map index
+  TEST_REAL_SIMILAR(columnar.getHandleIntensities()[0], 5.5)
+  TEST_REAL_SIMILAR(columnar.getHandleIntensities()[1], 5.5)
+  TEST_REAL_SIMILAR(columnar.getHandleIntensities()[3], 16.5)
+  TEST_REAL_SIMILAR(columnar.getHandleIntensities()[5], 11.0)
+
+  ConsensusMap normalized = cmap;
+  ConsensusMapNormalizerAlgorithmQuantile::normalizeMaps(normalized);
+  TEST_EQUAL(ColumnarConsensusMap(normalized) == columnar, true)
 }
 END_SECTION
 
@@ -360,6 +360,60 @@ START_SECTION((void expandToBoundingBox()))
 }
 END_SECTION
 
+START_SECTION((void compact(bool bounding_box_only = false)))
+{
+  ConvexHull2D tmp;
+  tmp.addPoint(DPosition<2>(1.,1.));
+  tmp.addPoint(DPosition<2>(1.,10.));
+  tmp.addPoint(DPosition<2>(2.,1.));
+  tmp.addPoint(DPosition<2>(2.,10.));
+  tmp.addPoint(DPosition<2>(3.,1.));
+  tmp.addPoint(DPosition<2>(3.,10.));
+  tmp.addPoint(DPosition<2>(4.,2.));
+  tmp.addPoint(DPosition<2>(4.,10.));
+  TEST_EQUAL(tmp.isCompact(), false)
+
+  ConvexHull2D compressed(tmp);
+  compressed.compress();
+  ConvexHull2D original(tmp);
+
+  tmp.compact();
+  TEST_EQUAL(tmp.isCompact(), true)
+  TEST_EQUAL(tmp.getHullPoints() == compressed.getHullPoints(), true)
+  TEST_EQUAL(tmp.getBoundingBox() == original.getBoundingBox(), true)
+  TEST_EXCEPTION(Exception::NotImplemented, tmp.encloses(DPosition<2>(2., 5.)))
+  // a second call does not change anything
+  ConvexHull2D compact(tmp);
+  tmp.compact();
+  TEST_EQUAL(tmp == compact, true)
+
+  // bounding box only
+  ConvexHull2D bb(original);
+  bb.compact(true);
+  TEST_EQUAL(bb.isCompact(), true)
+  TEST_EQUAL(bb.getHullPoints().size(), 4)
+  TEST_EQUAL(bb.getBoundingBox() == original.getBoundingBox(), true)
+
+  // empty hull
+  ConvexHull2D empty;
+  empty.compact(true);
+  TEST_EQUAL(empty.getHullPoints().size(), 0)
+  TEST_EQUAL(empty.isCompact(), true)
+}
+END_SECTION
+
+START_SECTION((bool isCompact() const))
+{
+  ConvexHull2D tmp;
+  TEST_EQUAL(tmp.isCompact(), true)
+  tmp.addPoint(DPosition<2>(1.,1.));
+  TEST_EQUAL(tmp.isCompact(), false)
+  ConvexHull2D::PointArrayType points(1, DPosition<2>(1.,1.));
+  tmp.setHullPoints(points);
+  TEST_EQUAL(tmp.isCompact(), true)
+}
+END_SECTION
+
 /////////////////////////////////////////////////////////////
 /////////////////////////////////////////////////////////////
 END_TEST
@@ -110,6 +110,20 @@ START_SECTION(bool getRow(Size row,StringList &list))
 
 END_SECTION
 
+START_SECTION(bool getRow(Size row, std::vector<StringView>& list) const)
+	CsvFile f1(OPENMS_GET_TEST_DATA_PATH("CsvFile_2.csv"), '\t', true);
+	std::vector<StringView> list;
+	TEST_EQUAL(f1.getRow(0, list), true)
+	TEST_EQUAL(list.size(), 2)
+	TEST_EQUAL(list[0].getString(), "hello")
+	TEST_EQUAL(list[1].getString(), "world")
+	f1.getRow(2, list);
+	TEST_EQUAL(list.size(), 2)
+	TEST_EQUAL(list[0].getString(), "spectral")
+	TEST_EQUAL(list[1].getString(), "search")
+	TEST_EXCEPTION(Exception::InvalidIterator, f1.getRow(3, list))
+END_SECTION
+
 START_SECTION(void store(const String& filename))
 	CsvFile f1,f2;
 	StringList list;
@@ -155,6 +155,53 @@ START_SECTION(static void deisotopeAndSingleChargeMSSpectrum(MSSpectrum& in,
 }
 END_SECTION
 
+START_SECTION(static void deisotopeAndSingleCharge(PeakMap& exp,
+                                          double fragment_tolerance, 
+                                          bool fragment_unit_ppm,
+                                          int min_charge = 1, 
+                                          int max_charge = 3,
+                                          bool keep_only_deisotoped = false,
+                                          unsigned int min_isopeaks = 3, 
+                                          unsigned int max_isopeaks = 10,
+                                          bool make_single_charged = true,
+                                          bool annotate_charge = false))
+{
+   MSSpectrum two_patterns;
+   Peak1D p;
+   p.setIntensity(1.0);
+   p.setMZ(200.0);
+   two_patterns.push_back(p);
+   p.setMZ(200.0 + 0.5 * Constants::C13C12_MASSDIFF_U);
+   two_patterns.push_back(p);
+   p.setMZ(200.0 + 2.0 * 0.5 * Constants::C13C12_MASSDIFF_U);
+   two_patterns.push_back(p);
+   p.setMZ(100.0);
+   two_patterns.push_back(p);
+   p.setMZ(100.0 + Constants::C13C12_MASSDIFF_U);
+   two_patterns.push_back(p);
+   p.setMZ(100.0 + 2.0 * Constants::C13C12_MASSDIFF_U);
+   two_patterns.push_back(p);
+
+   // unsorted spectra are sorted first
+   PeakMap exp;
+   for (Size i = 0; i < 10; ++i)
+   {
+     exp.addSpectrum(two_patterns);
+   }
+   Deisotoper::deisotopeAndSingleCharge(exp, 10.0, true, 1, 2, true, 2, 10, true, true);
+
+   TEST_EQUAL(exp.size(), 10)
+   for (Size i = 0; i < exp.size(); ++i)
+   {
+     TEST_EQUAL(exp[i].size(), 2)
+     TEST_REAL_SIMILAR(exp[i][0].getMZ(), 100); 
+     TEST_REAL_SIMILAR(exp[i][1].getMZ(), 400.0 - Constants::PROTON_MASS_U); 
+   }
+
+   TEST_EXCEPTION(Exception::IllegalArgument, Deisotoper::deisotopeAndSingleCharge(exp, 10.0, true, 1, 2, true, 1, 10))
+}
+END_SECTION
+
 
 /////////////////////////////////////////////////////////////
 /////////////////////////////////////////////////////////////
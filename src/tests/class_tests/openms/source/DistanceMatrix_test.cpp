@@ -234,6 +234,29 @@ START_SECTION((void updateMinElement()))
 	std::pair<Size,Size> min = dm.getMinElementCoordinates();
 	TEST_EQUAL(min.first,3)
 	TEST_EQUAL(min.second,2)
+
+	// larger matrix, the first of several minimal elements is reported
+	DistanceMatrix<float> large(40, 1.0f);
+	large.setValueQuick(37, 5, 0.25f);
+	large.setValueQuick(21, 20, 0.25f);
+	large.setValueQuick(21, 13, 0.25f);
+	large.setValueQuick(39, 38, 0.5f);
+	large.updateMinElement();
+	min = large.getMinElementCoordinates();
+	TEST_EQUAL(min.first,21)
+	TEST_EQUAL(min.second,13)
+	large.reduce(13);
+	large.updateMinElement();
+	min = large.getMinElementCoordinates();
+	TEST_EQUAL(min.first,20)
+	TEST_EQUAL(min.second,19)
+	TEST_REAL_SIMILAR(large.getValue(36, 5), 0.25)
+	TEST_REAL_SIMILAR(large.getValue(38, 37), 0.5)
+	large.setValueQuick(38, 37, 0.0f);
+	large.updateMinElement();
+	min = large.getMinElementCoordinates();
+	TEST_EQUAL(min.first,38)
+	TEST_EQUAL(min.second,37)
 }
 END_SECTION
 
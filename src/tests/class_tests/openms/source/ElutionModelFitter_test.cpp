@@ -104,6 +104,12 @@ START_SECTION((void fitElutionModels(FeatureMap& features)))
     TEST_EQUAL(it->metaValueExists("model_EGH_tau"), true);
     TEST_EQUAL(it->metaValueExists("model_EGH_sigma"), true);
   }
+
+  // errors are reported also when fitting in parallel:
+  FeatureXMLFile().load(OPENMS_GET_TEST_DATA_PATH("ElutionModelFitter_test.featureXML"), features);
+  ABORT_IF(features.size() != 25);
+  features[20].getSubordinates().clear();
+  TEST_EXCEPTION(Exception::MissingInformation, emf.fitElutionModels(features));
 }
 END_SECTION
 
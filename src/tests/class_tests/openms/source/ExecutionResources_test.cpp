@@ -0,0 +1,147 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2018.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: Timo Sachsenberg $
+// $Authors: Timo Sachsenberg $
+// --------------------------------------------------------------------------
+
+#include <OpenMS/CONCEPT/ClassTest.h>
+#include <OpenMS/test_config.h>
+
+///////////////////////////
+#include <OpenMS/SYSTEM/ExecutionResources.h>
+///////////////////////////
+
+#include <algorithm>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+using namespace OpenMS;
+using namespace std;
+
+START_TEST(ExecutionResources, "$Id$")
+
+/////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////
+
+START_SECTION(static Int getAvailableCores())
+{
+  TEST_EQUAL(ExecutionResources::getAvailableCores() >= 1, true)
+}
+END_SECTION
+
+START_SECTION(static void setThreads(Int threads))
+{
+  ExecutionResources::setThreads(3);
+  TEST_EQUAL(ExecutionResources::getThreads(), 3)
+#ifdef _OPENMP
+  TEST_EQUAL(omp_get_max_threads(), 3)
+#endif
+  ExecutionResources::setThreads(0);
+  TEST_EQUAL(ExecutionResources::getThreads(), ExecutionResources::getAvailableCores())
+  ExecutionResources::setThreads(-5);
+  TEST_EQUAL(ExecutionResources::getThreads(), ExecutionResources::getAvailableCores())
+}
+END_SECTION
+
+START_SECTION(static Int getThreads())
+{
+  NOT_TESTABLE // tested above
+}
+END_SECTION
+
+START_SECTION(static void setNestedParallelism(bool allow))
+{
+  TEST_EQUAL(ExecutionResources::getNestedParallelism(), false)
+  ExecutionResources::setNestedParallelism(true);
+  TEST_EQUAL(ExecutionResources::getNestedParallelism(), true)
+  ExecutionResources::setNestedParallelism(false);
+  TEST_EQUAL(ExecutionResources::getNestedParallelism(), false)
+}
+END_SECTION
+
+START_SECTION(static bool getNestedParallelism())
+{
+  NOT_TESTABLE // tested above
+}
+END_SECTION
+
+START_SECTION(static Int getThreadsForParallelRegion())
+{
+  ExecutionResources::setThreads(4);
+  TEST_EQUAL(ExecutionResources::getThreadsForParallelRegion(), 4)
+#ifdef _OPENMP
+  Int inner = 0;
+#pragma omp parallel num_threads(2)
+  {
+#pragma omp master
+    inner = ExecutionResources::getThreadsForParallelRegion();
+  }
+  TEST_EQUAL(inner, 1)
+#endif
+}
+END_SECTION
+
+START_SECTION(static std::vector<Int> getCoreOrder(Affinity affinity))
+{
+  vector<Int> compact = ExecutionResources::getCoreOrder(ExecutionResources::AFFINITY_COMPACT);
+  vector<Int> spread = ExecutionResources::getCoreOrder(ExecutionResources::AFFINITY_SPREAD);
+  TEST_EQUAL(compact.size(), ExecutionResources::getAvailableCores())
+  TEST_EQUAL(spread.size(), ExecutionResources::getAvailableCores())
+  // same cores, possibly in a different order
+  sort(compact.begin(), compact.end());
+  sort(spread.begin(), spread.end());
+  TEST_EQUAL(compact == spread, true)
+}
+END_SECTION
+
+START_SECTION(static bool setAffinity(Affinity affinity))
+{
+  ExecutionResources::setThreads(2);
+  if (ExecutionResources::setAffinity(ExecutionResources::AFFINITY_COMPACT))
+  {
+    TEST_EQUAL(ExecutionResources::getAffinity(), ExecutionResources::AFFINITY_COMPACT)
+    TEST_EQUAL(ExecutionResources::setAffinity(ExecutionResources::AFFINITY_NONE), true)
+  }
+  TEST_EQUAL(ExecutionResources::getAffinity(), ExecutionResources::AFFINITY_NONE)
+}
+END_SECTION
+
+START_SECTION(static Affinity getAffinity())
+{
+  NOT_TESTABLE // tested above
+}
+END_SECTION
+
+/////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////
+END_TEST
@@ -37,6 +37,8 @@
 
 ///////////////////////////
 
+#include <fstream>
+#include <iterator>
 #include <string>
 
 #include <OpenMS/FORMAT/FASTAFile.h>
@@ -167,6 +169,43 @@ START_SECTION((void store(const String& filename, const std::vector< FASTAEntry
   TEST_EQUAL(data==data2,true);
 END_SECTION
 
+START_SECTION((void writeNext(const std::vector<FASTAEntry>& proteins)))
+  // more entries than a single formatting block, some with multi-line sequences
+  vector<FASTAFile::FASTAEntry> data, data2;
+  for (Size i = 0; i < 1200; ++i)
+  {
+    data.push_back(FASTAFile::FASTAEntry("P" + String(i), "protein " + String(i), String(i % 200 + 1, 'A' + i % 20)));
+  }
+  String single_filename, batch_filename;
+  NEW_TMP_FILE(single_filename);
+  NEW_TMP_FILE(batch_filename);
+
+  FASTAFile single;
+  single.writeStart(single_filename);
+  for (Size i = 0; i < data.size(); ++i)
+  {
+    single.writeNext(data[i]);
+  }
+  single.writeEnd();
+
+  FASTAFile batch;
+  batch.writeStart(batch_filename);
+  batch.writeNext(vector<FASTAFile::FASTAEntry>(data.begin(), data.begin() + 700));
+  batch.writeNext(vector<FASTAFile::FASTAEntry>());
+  batch.writeNext(vector<FASTAFile::FASTAEntry>(data.begin() + 700, data.end()));
+  batch.writeEnd();
+
+  // byte-identical output
+  std::ifstream is1(single_filename.c_str()), is2(batch_filename.c_str());
+  std::string content1((std::istreambuf_iterator<char>(is1)), std::istreambuf_iterator<char>());
+  std::string content2((std::istreambuf_iterator<char>(is2)), std::istreambuf_iterator<char>());
+  TEST_EQUAL(content1.empty(), false)
+  TEST_EQUAL(content1 == content2, true)
+
+  FASTAFile::load(batch_filename, data2);
+  TEST_EQUAL(data == data2, true)
+END_SECTION
+
 START_SECTION([EXTRA] test_strange_symbols_in_sequence)
   // test if * is read correctly (not changed into something weird like 'X')
   String tmp_filename;
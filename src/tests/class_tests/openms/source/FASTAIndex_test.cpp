@@ -0,0 +1,245 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2018.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: Timo Sachsenberg $
+// $Authors: Timo Sachsenberg $
+// --------------------------------------------------------------------------
+
+#include <OpenMS/CONCEPT/ClassTest.h>
+#include <OpenMS/test_config.h>
+
+///////////////////////////
+
+#include <OpenMS/FORMAT/FASTAIndex.h>
+#include <OpenMS/FORMAT/TextFile.h>
+#include <OpenMS/SYSTEM/File.h>
+
+#include <fstream>
+#include <vector>
+
+///////////////////////////
+
+START_TEST(FASTAIndex, "$Id$")
+
+/////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////
+
+using namespace OpenMS;
+using namespace std;
+
+// a small database with sequences longer than one line (FASTAFile writes 80 residues per line)
+vector<FASTAFile::FASTAEntry> db;
+String long_seq;
+for (Size i = 0; i < 25; ++i) long_seq += "ACDEFGHIKLMNPQRSTVWY"[i % 20] + String("PEPTIDER");
+db.push_back(FASTAFile::FASTAEntry("sp|P01|FIRST", "first protein", long_seq));
+db.push_back(FASTAFile::FASTAEntry("sp|P02|SECOND", "", "PEPTIDE"));
+db.push_back(FASTAFile::FASTAEntry("sp|P03|THIRD", "contains > in the description", long_seq.substr(0, 160)));
+db.push_back(FASTAFile::FASTAEntry("P04", "last", long_seq.substr(0, 81)));
+String fasta_file;
+NEW_TMP_FILE(fasta_file)
+FASTAFile::store(fasta_file, db);
+vector<FASTAFile::FASTAEntry> loaded;
+FASTAFile::load(fasta_file, loaded); // descriptions as read by FASTAFile
+
+FASTAIndex* ptr = nullptr;
+FASTAIndex* nullPointer = nullptr;
+START_SECTION((FASTAIndex()))
+{
+  ptr = new FASTAIndex();
+  TEST_NOT_EQUAL(ptr, nullPointer)
+  TEST_EQUAL(ptr->size(), 0)
+  delete ptr;
+}
+END_SECTION
+
+START_SECTION((void build(const String& fasta_file)))
+{
+  FASTAIndex index;
+  index.build(fasta_file);
+  TEST_EQUAL(index.size(), 4)
+  const vector<FASTAIndex::Entry>& records = index.getIndexEntries();
+  TEST_EQUAL(records[0].name, "sp|P01|FIRST")
+  TEST_EQUAL(records[0].length, 225)
+  TEST_EQUAL(records[0].offset, 28)
+  TEST_EQUAL(records[0].line_bases, 80)
+  TEST_EQUAL(records[0].line_width, 81)
+  TEST_EQUAL(records[1].name, "sp|P02|SECOND")
+  TEST_EQUAL(records[1].length, 7)
+  TEST_EQUAL(records[3].length, 81)
+
+  TEST_EXCEPTION(Exception::FileNotFound, index.build("this_file_does_not_exist.fasta"))
+
+  // lines of different lengths cannot be indexed
+  String irregular;
+  NEW_TMP_FILE(irregular)
+  {
+    ofstream os(irregular.c_str());
+    os << ">A\nPEPTIDE\nPEP\nPEPTIDE\n";
+  }
+  TEST_EXCEPTION(Exception::ParseError, index.build(irregular))
+}
+END_SECTION
+
+START_SECTION((SignedSize find(const String& name) const))
+{
+  FASTAIndex index;
+  index.build(fasta_file);
+  TEST_EQUAL(index.find("sp|P01|FIRST"), 0)
+  TEST_EQUAL(index.find("P04"), 3)
+  TEST_EQUAL(index.find("P05"), -1)
+}
+END_SECTION
+
+START_SECTION((bool getEntry(const String& name, FASTAFile::FASTAEntry& entry) const))
+{
+  FASTAIndex index;
+  index.build(fasta_file);
+  FASTAFile::FASTAEntry entry;
+  for (Size i = 0; i < loaded.size(); ++i)
+  {
+    TEST_EQUAL(index.getEntry(loaded[i].identifier, entry), true)
+    TEST_EQUAL(entry == loaded[i], true)
+  }
+  TEST_EQUAL(entry.sequence, long_seq.substr(0, 81))
+  TEST_EQUAL(index.getEntry("P05", entry), false)
+}
+END_SECTION
+
+START_SECTION((void getEntry(Size index, FASTAFile::FASTAEntry& entry) const))
+{
+  FASTAIndex index;
+  index.build(fasta_file);
+  FASTAFile::FASTAEntry entry;
+  index.getEntry(2, entry);
+  TEST_EQUAL(entry.identifier, "sp|P03|THIRD")
+  TEST_EQUAL(entry.sequence, long_seq.substr(0, 160))
+  TEST_EXCEPTION(Exception::IndexOverflow, index.getEntry(4, entry))
+}
+END_SECTION
+
+START_SECTION((void getEntries(Size first, Size last, std::vector<FASTAFile::FASTAEntry>& entries) const))
+{
+  FASTAIndex index;
+  index.build(fasta_file);
+  vector<FASTAFile::FASTAEntry> entries;
+  index.getEntries(0, index.size(), entries);
+  TEST_EQUAL(entries.size(), loaded.size())
+  TEST_EQUAL(entries == loaded, true)
+
+  index.getEntries(1, 3, entries);
+  TEST_EQUAL(entries.size(), 2)
+  TEST_EQUAL(entries[0] == loaded[1], true)
+  TEST_EQUAL(entries[1] == loaded[2], true)
+
+  index.getEntries(2, 2, entries);
+  TEST_EQUAL(entries.size(), 0)
+  TEST_EXCEPTION(Exception::IndexOverflow, index.getEntries(0, 5, entries))
+
+  // Windows line endings
+  String crlf;
+  NEW_TMP_FILE(crlf)
+  {
+    ofstream os(crlf.c_str(), ios_base::binary);
+    os << ">A first\r\nPEPT\r\nIDE\r\n>B\r\nPEPTIDER";
+  }
+  index.build(crlf);
+  TEST_EQUAL(index.getIndexEntries()[0].line_width, 6)
+  index.getEntries(0, 2, entries);
+  TEST_EQUAL(entries[0].identifier, "A")
+  TEST_EQUAL(entries[0].description, "first")
+  TEST_EQUAL(entries[0].sequence, "PEPTIDE")
+  TEST_EQUAL(entries[1].identifier, "B")
+  TEST_EQUAL(entries[1].sequence, "PEPTIDER")
+}
+END_SECTION
+
+START_SECTION((void store(const String& index_file) const))
+{
+  FASTAIndex index;
+  index.build(fasta_file);
+  String index_file;
+  NEW_TMP_FILE(index_file)
+  index.store(index_file);
+  TextFile tf(index_file);
+  TEST_EQUAL(tf.end() - tf.begin(), 4)
+  TEST_EQUAL(*tf.begin(), "sp|P01|FIRST\t225\t28\t80\t81")
+}
+END_SECTION
+
+START_SECTION((void load(const String& index_file, const String& fasta_file)))
+{
+  FASTAIndex index;
+  index.build(fasta_file);
+  String index_file;
+  NEW_TMP_FILE(index_file)
+  index.store(index_file);
+
+  FASTAIndex index2;
+  index2.load(index_file, fasta_file);
+  TEST_EQUAL(index2.size(), 4)
+  vector<FASTAFile::FASTAEntry> entries;
+  index2.getEntries(0, index2.size(), entries);
+  TEST_EQUAL(entries == loaded, true)
+
+  String broken;
+  NEW_TMP_FILE(broken)
+  {
+    ofstream os(broken.c_str());
+    os << "A\t7\tx\t7\t8\n";
+  }
+  TEST_EXCEPTION(Exception::ParseError, index2.load(broken, fasta_file))
+  TEST_EXCEPTION(Exception::FileNotFound, index2.load("this_file_does_not_exist.fai", fasta_file))
+}
+END_SECTION
+
+START_SECTION((void open(const String& fasta_file, bool store_index = true)))
+{
+  FASTAIndex index;
+  index.open(fasta_file, false);
+  TEST_EQUAL(index.size(), 4)
+  TEST_EQUAL(File::exists(fasta_file + ".fai"), false)
+
+  index.open(fasta_file);
+  TEST_EQUAL(File::exists(fasta_file + ".fai"), true)
+  FASTAIndex index2;
+  index2.open(fasta_file); // reads the stored index
+  TEST_EQUAL(index2.size(), 4)
+  FASTAFile::FASTAEntry entry;
+  TEST_EQUAL(index2.getEntry("sp|P02|SECOND", entry), true)
+  TEST_EQUAL(entry == loaded[1], true)
+  File::remove(fasta_file + ".fai");
+
+  TEST_EXCEPTION(Exception::FileNotFound, index.open("this_file_does_not_exist.fasta"))
+}
+END_SECTION
+
+/////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////
+END_TEST
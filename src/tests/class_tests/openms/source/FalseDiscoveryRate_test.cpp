@@ -235,6 +235,50 @@ START_SECTION((void apply(std::vector<ProteinIdentification>& ids)))
 }
 END_SECTION
 
+START_SECTION((static void calculateFDRs(const std::vector<double> &scores, const std::vector<bool> &is_decoy, bool higher_score_better, bool q_value, std::vector<double> &fdrs)))
+{
+  // targets: 10, 8, 6, 4; decoys: 9, 5, 5
+  double score_array[] = {5, 10, 8, 9, 4, 6, 5};
+  bool decoy_array[] = {true, false, false, true, false, false, true};
+  vector<double> scores(score_array, score_array + 7);
+  vector<bool> is_decoy(decoy_array, decoy_array + 7);
+  vector<double> fdrs;
+
+  // decoys get the value of the closest (on ties: the worse) target score
+  double q_values[] = {0.75, 0.0, 1.0 / 3, 1.0 / 3, 0.75, 1.0 / 3, 0.75};
+  FalseDiscoveryRate::calculateFDRs(scores, is_decoy, true, true, fdrs);
+  TEST_EQUAL(fdrs.size(), 7)
+  for (Size i = 0; i < fdrs.size(); ++i)
+  {
+    TEST_REAL_SIMILAR(fdrs[i], q_values[i])
+  }
+
+  double strict_fdrs[] = {0.75, 0.0, 0.5, 0.5, 0.75, 1.0 / 3, 0.75};
+  FalseDiscoveryRate::calculateFDRs(scores, is_decoy, true, false, fdrs);
+  for (Size i = 0; i < fdrs.size(); ++i)
+  {
+    TEST_REAL_SIMILAR(fdrs[i], strict_fdrs[i])
+  }
+
+  // same with lower scores being better
+  for (Size i = 0; i < scores.size(); ++i)
+  {
+    scores[i] = -scores[i];
+  }
+  FalseDiscoveryRate::calculateFDRs(scores, is_decoy, false, true, fdrs);
+  for (Size i = 0; i < fdrs.size(); ++i)
+  {
+    TEST_REAL_SIMILAR(fdrs[i], q_values[i])
+  }
+
+  FalseDiscoveryRate::calculateFDRs(vector<double>(), vector<bool>(), true, true, fdrs);
+  TEST_EQUAL(fdrs.size(), 0)
+
+  is_decoy.pop_back();
+  TEST_EXCEPTION(Exception::IllegalArgument, FalseDiscoveryRate::calculateFDRs(scores, is_decoy, true, true, fdrs))
+}
+END_SECTION
+
 /////////////////////////////////////////////////////////////
 /////////////////////////////////////////////////////////////
 END_TEST
@@ -246,6 +246,44 @@ START_SECTION([FastLowessSmoothing]void smoothData(const DoubleVector&, const Do
 }
 END_SECTION
 
+START_SECTION((int lowess(const std::vector<double>& x, const std::vector<double>& y, double f, int nsteps, double delta, std::vector<double>& result, LowessWorkspace& workspace)))
+{
+  double xval[] = {1, 2, 3, 4, 5, 6,  6,  6,  6,  6,  6,  6,  6,  6,  6, 8, 10, 12, 14, 50 };
+  double yval[] = { 18, 2, 15, 6, 10, 4, 16, 11, 7, 3, 14, 17, 20, 12, 9, 13, 1, 8, 5, 19};
+  std::vector<double> v_xval(xval, xval + 20), v_yval(yval, yval + 20);
+
+  // the same workspace is used for several fits, results have to be
+  // identical to the ones without workspace
+  FastLowessSmoothing::LowessWorkspace workspace;
+  TOLERANCE_ABSOLUTE(1e-10);
+  for (int nsteps = 0; nsteps < 3; ++nsteps)
+  {
+    for (double delta = 0.0; delta < 4.0; delta += 3.0)
+    {
+      std::vector<double> expected, out;
+      FastLowessSmoothing::lowess(v_xval, v_yval, 0.25, nsteps, delta, expected);
+      FastLowessSmoothing::lowess(v_xval, v_yval, 0.25, nsteps, delta, out, workspace);
+      TEST_EQUAL(out.size(), 20)
+      for (size_t i = 0; i < out.size(); i++)
+      {
+        TEST_REAL_SIMILAR(out[i], expected[i]);
+      }
+    }
+  }
+
+  // shorter input after a longer one
+  std::vector<double> x_short(v_xval.begin(), v_xval.begin() + 5), y_short(v_yval.begin(), v_yval.begin() + 5);
+  std::vector<double> expected, out;
+  FastLowessSmoothing::lowess(x_short, y_short, 0.5, 1, 0.0, expected);
+  FastLowessSmoothing::lowess(x_short, y_short, 0.5, 1, 0.0, out, workspace);
+  TEST_EQUAL(out.size(), 5)
+  for (size_t i = 0; i < out.size(); i++)
+  {
+    TEST_REAL_SIMILAR(out[i], expected[i]);
+  }
+}
+END_SECTION
+
 /////////////////////////////////////////////////////////////
 /////////////////////////////////////////////////////////////
 END_TEST
@@ -61,6 +61,28 @@ START_SECTION(~FeatureFinderIdentificationAlgorithm())
 }
 END_SECTION
 
+START_SECTION((void runCohort(std::vector<PeakMap>& ms_data, const std::vector<std::vector<PeptideIdentification> >& peptides, const std::vector<std::vector<ProteinIdentification> >& proteins, const std::vector<PeptideIdentification>& peptides_ext, const std::vector<ProteinIdentification>& proteins_ext, std::vector<FeatureMap>& features)))
+{
+  FeatureFinderIdentificationAlgorithm ffid;
+  vector<PeakMap> ms_data;
+  vector<vector<PeptideIdentification> > peptides;
+  vector<vector<ProteinIdentification> > proteins;
+  vector<PeptideIdentification> peptides_ext;
+  vector<ProteinIdentification> proteins_ext;
+  vector<FeatureMap> features(3);
+
+  // no runs - no results:
+  ffid.runCohort(ms_data, peptides, proteins, peptides_ext, proteins_ext, features);
+  TEST_EQUAL(features.size(), 0);
+
+  // one set of IDs per run is required:
+  ms_data.resize(2);
+  peptides.resize(2);
+  proteins.resize(1);
+  TEST_EXCEPTION(Exception::IllegalArgument, ffid.runCohort(ms_data, peptides, proteins, peptides_ext, proteins_ext, features));
+}
+END_SECTION
+
 
 /////////////////////////////////////////////////////////////
 /////////////////////////////////////////////////////////////
@@ -36,6 +36,7 @@
 #include <OpenMS/test_config.h>
 
 #include <OpenMS/ANALYSIS/MAPMATCHING/FeatureGroupingAlgorithmKD.h>
+#include <OpenMS/FORMAT/FeatureXMLFile.h>
 
 using namespace OpenMS;
 using namespace std;
@@ -77,6 +78,78 @@ START_SECTION((virtual void group(const std::vector<ConsensusMap>& maps, Consens
   NOT_TESTABLE;
 END_SECTION
 
+START_SECTION((void group(const StringList& feature_files, ConsensusMap& out)))
+{
+  // three maps with slightly shifted copies of the same features (two of
+  // them annotated with a peptide identification in the first map)
+  std::vector<FeatureMap> maps(3);
+  StringList files;
+  for (Size k = 0; k < maps.size(); ++k)
+  {
+    for (Size i = 0; i < 20; ++i)
+    {
+      Feature feature;
+      feature.setRT(100.0 + 50.0 * i + k);
+      feature.setMZ(300.0 + 37.0 * i + 0.0005 * k);
+      feature.setIntensity(1000.0 + 10.0 * i);
+      feature.setCharge(2);
+      feature.setUniqueId(1000 * (k + 1) + i);
+      if (k == 0 && i < 2)
+      {
+        PeptideIdentification pep_id;
+        pep_id.setIdentifier("run1");
+        pep_id.insertHit(PeptideHit(1.0, 1, 2, AASequence::fromString("PEPTIDE")));
+        feature.getPeptideIdentifications().push_back(pep_id);
+      }
+      if (k != 2 || i % 5 != 0) maps[k].push_back(feature); // some features are missing in map 3
+    }
+    if (k == 0)
+    {
+      maps[k].getProteinIdentifications().resize(1);
+      maps[k].getProteinIdentifications()[0].setIdentifier("run1");
+    }
+    maps[k].setUniqueId(k + 1);
+    maps[k].updateRanges();
+    String tmp_file;
+    NEW_TMP_FILE(tmp_file);
+    FeatureXMLFile().store(tmp_file, maps[k]);
+    files.push_back(tmp_file);
+  }
+
+  FeatureGroupingAlgorithmKD fga;
+  Param p = fga.getParameters();
+  p.setValue("warp:enabled", "false");
+  fga.setParameters(p);
+
+  // the out-of-core mode gives the same result as the in-memory mode
+  for (int nr_partitions = 1; nr_partitions <= 10; nr_partitions += 9)
+  {
+    p.setValue("nr_partitions", nr_partitions);
+    fga.setParameters(p);
+    ConsensusMap in_memory, out_of_core;
+    fga.group(maps, in_memory);
+    fga.group(files, out_of_core);
+
+    TEST_EQUAL(out_of_core.size(), 20)
+    TEST_EQUAL(out_of_core.size(), in_memory.size())
+    ABORT_IF(out_of_core.size() != in_memory.size())
+    for (Size i = 0; i < out_of_core.size(); ++i)
+    {
+      TEST_EQUAL(out_of_core[i].size(), in_memory[i].size())
+      TEST_REAL_SIMILAR(out_of_core[i].getRT(), in_memory[i].getRT())
+      TEST_REAL_SIMILAR(out_of_core[i].getMZ(), in_memory[i].getMZ())
+      TEST_EQUAL(out_of_core[i].getPeptideIdentifications().size(), in_memory[i].getPeptideIdentifications().size())
+    }
+    TEST_EQUAL(out_of_core.getColumnHeaders().size(), 3)
+    TEST_EQUAL(out_of_core.getColumnHeaders()[2].size, 16)
+    TEST_EQUAL(out_of_core.getColumnHeaders()[1].unique_id, 2)
+  }
+
+  ConsensusMap dummy;
+  TEST_EXCEPTION(Exception::IllegalArgument, fga.group(StringList(1, files[0]), dummy));
+}
+END_SECTION
+
 /////////////////////////////////////////////////////////////
 /////////////////////////////////////////////////////////////
 
@@ -219,6 +219,28 @@ START_SECTION((FeatureMap(const FeatureMap &source)))
   TEST_EQUAL(map2.getUnassignedPeptideIdentifications().size(),1);
 END_SECTION
 
+START_SECTION((FeatureMap(FeatureMap&& source)))
+  FeatureMap map1;
+  map1.setMetaValue("meta",String("value"));
+  map1.push_back(feature1);
+  map1.push_back(feature2);
+  map1.push_back(feature3);
+  map1.updateRanges();
+  map1.setIdentifier("lsid");
+  map1.getProteinIdentifications().resize(1);
+  FeatureMap map_copy(map1);
+
+  FeatureMap map2(std::move(map1));
+  TEST_EQUAL(map2 == map_copy, true)
+  TEST_EQUAL(map2.size(),3);
+  TEST_STRING_EQUAL(map2.getIdentifier(),"lsid")
+  TEST_EQUAL(map2.getProteinIdentifications().size(),1);
+
+  FeatureMap map3;
+  map3 = std::move(map2);
+  TEST_EQUAL(map3 == map_copy, true)
+END_SECTION
+
 START_SECTION((FeatureMap& operator = (const FeatureMap& rhs)))
 	FeatureMap map1;
   map1.setMetaValue("meta",String("value"));
@@ -733,6 +755,43 @@ START_SECTION((  AnnotationStatistics getAnnotationStatistics() const ))
 
 END_SECTION
 
+START_SECTION((void compactConvexHulls(bool bounding_boxes_only = false)))
+{
+  ConvexHull2D hull;
+  hull.addPoint(DPosition<2>(1.0, 100.0));
+  hull.addPoint(DPosition<2>(1.0, 101.0));
+  hull.addPoint(DPosition<2>(2.0, 100.0));
+  hull.addPoint(DPosition<2>(2.0, 101.0));
+  hull.addPoint(DPosition<2>(3.0, 100.5));
+  hull.addPoint(DPosition<2>(3.0, 101.0));
+  Feature f;
+  f.getConvexHulls().push_back(hull);
+  f.getConvexHulls().push_back(hull);
+  f.getSubordinates().push_back(f);
+  DBoundingBox<2> box = f.getConvexHull().getBoundingBox();
+  TEST_EQUAL(f.encloses(2.0, 100.5), true)
+
+  FeatureMap fm;
+  fm.push_back(f);
+  fm.push_back(f);
+  fm.compactConvexHulls();
+  for (Size i = 0; i < fm.size(); ++i)
+  {
+    TEST_EQUAL(fm[i].getConvexHulls().size(), 2)
+    TEST_EQUAL(fm[i].getConvexHulls()[0].isCompact(), true)
+    TEST_EQUAL(fm[i].getConvexHulls()[0].getHullPoints() == hull.getHullPoints(), true)
+    TEST_EQUAL(fm[i].getSubordinates()[0].getConvexHulls()[1].isCompact(), true)
+    TEST_EQUAL(fm[i].getConvexHull().getBoundingBox() == box, true)
+  }
+  TEST_EXCEPTION(Exception::NotImplemented, fm[0].encloses(2.0, 100.5))
+
+  fm.compactConvexHulls(true);
+  TEST_EQUAL(fm[1].getConvexHulls()[0].getHullPoints().size(), 4)
+  TEST_EQUAL(fm[1].getSubordinates()[0].getConvexHulls()[0].getHullPoints().size(), 4)
+  TEST_EQUAL(fm[1].getConvexHull().getBoundingBox() == box, true)
+}
+END_SECTION
+
 /////////////////////////////////////////////////////////////
 /////////////////////////////////////////////////////////////
 END_TEST
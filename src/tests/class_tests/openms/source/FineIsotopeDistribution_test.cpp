@@ -395,6 +395,65 @@ START_SECTION(( void setAbsolute(bool absolute) ))
 END_SECTION
 
 
+START_SECTION(( std::vector<IsotopeDistribution> run(const std::vector<EmpiricalFormula>& formulas) const ))
+{
+  std::vector<EmpiricalFormula> formulas;
+  formulas.push_back(EmpiricalFormula("C6H12O6"));
+  formulas.push_back(EmpiricalFormula("C520H817N139O147S8"));
+  formulas.push_back(EmpiricalFormula("C6H12O6")); // marginal distributions are reused
+  formulas.push_back(EmpiricalFormula("C10H15N5O10P2"));
+  formulas.push_back(EmpiricalFormula("C2H5Cl"));
+
+  for (bool absolute : {false, true})
+  {
+    FineIsotopePatternGenerator gen(1e-5, absolute);
+    std::vector<IsotopeDistribution> result = gen.run(formulas);
+    TEST_EQUAL(result.size(), formulas.size())
+    for (Size i = 0; i < formulas.size(); ++i)
+    {
+      IsotopeDistribution expected = gen.run(formulas[i]);
+      TEST_EQUAL(result[i].size(), expected.size())
+      for (Size k = 0; k < std::min(result[i].size(), expected.size()); ++k)
+      {
+        TEST_REAL_SIMILAR(result[i][k].getMZ(), expected[k].getMZ())
+        TEST_REAL_SIMILAR(result[i][k].getIntensity(), expected[k].getIntensity())
+      }
+    }
+  }
+
+  // empty input
+  TEST_EQUAL(FineIsotopePatternGenerator().run(std::vector<EmpiricalFormula>()).size(), 0)
+}
+END_SECTION
+
+START_SECTION(( void run(const std::vector<EmpiricalFormula>& formulas, std::vector<double>& masses, std::vector<double>& probabilities, std::vector<Size>& offsets) const ))
+{
+  std::vector<EmpiricalFormula> formulas;
+  formulas.push_back(EmpiricalFormula("C6H12O6"));
+  formulas.push_back(EmpiricalFormula("C520H817N139O147S8"));
+  formulas.push_back(EmpiricalFormula("C10H15N5O10P2"));
+
+  FineIsotopePatternGenerator gen(1e-3);
+  std::vector<double> masses, probabilities;
+  std::vector<Size> offsets;
+  gen.run(formulas, masses, probabilities, offsets);
+  TEST_EQUAL(offsets.size(), formulas.size() + 1)
+  TEST_EQUAL(offsets[0], 0)
+  TEST_EQUAL(offsets.back(), masses.size())
+  TEST_EQUAL(probabilities.size(), masses.size())
+  for (Size i = 0; i < formulas.size(); ++i)
+  {
+    IsotopeDistribution expected = gen.run(formulas[i]);
+    TEST_EQUAL(offsets[i + 1] - offsets[i], expected.size())
+    for (Size k = 0; k < std::min(offsets[i + 1] - offsets[i], expected.size()); ++k)
+    {
+      TEST_REAL_SIMILAR(masses[offsets[i] + k], expected[k].getMZ())
+      TEST_REAL_SIMILAR(probabilities[offsets[i] + k], expected[k].getIntensity())
+    }
+  }
+}
+END_SECTION
+
 /////////////////////////////////////////////////////////////
 /////////////////////////////////////////////////////////////
 END_TEST
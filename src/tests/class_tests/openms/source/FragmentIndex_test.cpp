@@ -0,0 +1,217 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2018.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: Hannes Roest $
+// $Authors: Hannes Roest $
+// --------------------------------------------------------------------------
+
+
+#include <OpenMS/CONCEPT/ClassTest.h>
+#include <OpenMS/test_config.h>
+
+///////////////////////////
+#include <OpenMS/ANALYSIS/ID/FragmentIndex.h>
+///////////////////////////
+
+#include <OpenMS/ANALYSIS/RNPXL/HyperScore.h>
+#include <OpenMS/CHEMISTRY/AASequence.h>
+#include <OpenMS/CHEMISTRY/TheoreticalSpectrumGenerator.h>
+#include <OpenMS/KERNEL/MSSpectrum.h>
+
+using namespace OpenMS;
+using namespace std;
+
+START_TEST(FragmentIndex, "$Id$")
+
+/////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////
+
+FragmentIndex* ptr = nullptr;
+FragmentIndex* nullPointer = nullptr;
+
+START_SECTION(FragmentIndex(double bin_size = 0.05))
+{
+  ptr = new FragmentIndex();
+  TEST_NOT_EQUAL(ptr, nullPointer)
+  TEST_REAL_SIMILAR(ptr->getBinSize(), 0.05)
+  TEST_EQUAL(ptr->size(), 0)
+  TEST_EQUAL(ptr->isBuilt(), false)
+  TEST_EXCEPTION(Exception::IllegalArgument, FragmentIndex(0.0))
+}
+END_SECTION
+
+START_SECTION(~FragmentIndex())
+{
+  delete ptr;
+}
+END_SECTION
+
+TheoreticalSpectrumGenerator tsg;
+Param param(tsg.getParameters());
+param.setValue("add_first_prefix_ion", "true");
+param.setValue("add_metainfo", "true");
+tsg.setParameters(param);
+
+vector<AASequence> peptides;
+peptides.push_back(AASequence::fromString("PEPTIDEK"));
+peptides.push_back(AASequence::fromString("SAMPLER"));
+peptides.push_back(AASequence::fromString("PEPTIDER"));
+peptides.push_back(AASequence::fromString("ELVISLIVESK"));
+
+vector<PeakSpectrum> theo_spectra(peptides.size());
+for (Size i = 0; i < peptides.size(); ++i)
+{
+  tsg.getSpectrum(theo_spectra[i], peptides[i], 1, 1);
+  theo_spectra[i].sortByPosition();
+}
+
+FragmentIndex index;
+
+START_SECTION(Size addPeptide(double precursor_mass, const PeakSpectrum& theo_spectrum))
+{
+  Size nr_fragments = 0;
+  for (Size i = 0; i < peptides.size(); ++i)
+  {
+    TEST_EQUAL(index.addPeptide(peptides[i].getMonoWeight(), theo_spectra[i]), i)
+    nr_fragments += theo_spectra[i].size();
+  }
+  TEST_EQUAL(index.size(), 4)
+  TEST_EQUAL(index.getNumberOfFragments(), nr_fragments)
+  TEST_REAL_SIMILAR(index.getPrecursorMass(1), peptides[1].getMonoWeight())
+}
+END_SECTION
+
+START_SECTION(Size addPeptide(double precursor_mass, const std::vector<TheoreticalSpectrumGenerator::FragmentIon>& fragment_ions))
+{
+  FragmentIndex ion_index;
+  TheoreticalSpectrumGenerator::FragmentIonBuffer buffer;
+  for (Size i = 0; i < peptides.size(); ++i)
+  {
+    tsg.getFragmentIons(buffer, peptides[i], 1, 1);
+    TEST_EQUAL(ion_index.addPeptide(peptides[i].getMonoWeight(), buffer.ions), i)
+  }
+  TEST_EQUAL(ion_index.getNumberOfFragments(), index.getNumberOfFragments())
+  ion_index.build();
+
+  // same theoretical spectra as when adding the spectra
+  PeakSpectrum restored;
+  ion_index.getTheoreticalSpectrum(3, restored);
+  TEST_EQUAL(restored.size(), theo_spectra[3].size())
+  for (Size i = 0; i < restored.size(); ++i)
+  {
+    TEST_REAL_SIMILAR(restored[i].getMZ(), theo_spectra[3][i].getMZ())
+    TEST_EQUAL(restored.getStringDataArrays()[0][i][0], theo_spectra[3].getStringDataArrays()[0][i][0])
+  }
+}
+END_SECTION
+
+START_SECTION(void build())
+{
+  index.build();
+  TEST_EQUAL(index.isBuilt(), true)
+  TEST_EXCEPTION(Exception::IllegalArgument, index.addPeptide(1000.0, theo_spectra[0]))
+
+  FragmentIndex not_built;
+  vector<FragmentIndex::Candidate> candidates;
+  TEST_EXCEPTION(Exception::IllegalArgument, not_built.query(theo_spectra[0], 0.0, 1e6, 10.0, true, 1, candidates))
+}
+END_SECTION
+
+START_SECTION(void getTheoreticalSpectrum(Size peptide, PeakSpectrum& theo_spectrum) const)
+{
+  PeakSpectrum restored;
+  index.getTheoreticalSpectrum(2, restored);
+  TEST_EQUAL(restored.size(), theo_spectra[2].size())
+  TEST_EQUAL(restored.getStringDataArrays().size(), 1)
+  for (Size i = 0; i < restored.size(); ++i)
+  {
+    TEST_REAL_SIMILAR(restored[i].getMZ(), theo_spectra[2][i].getMZ())
+    TEST_EQUAL(restored.getStringDataArrays()[0][i][0], theo_spectra[2].getStringDataArrays()[0][i][0])
+  }
+  // scores are the same as for the original theoretical spectrum
+  TEST_REAL_SIMILAR(HyperScore::compute(10.0, true, theo_spectra[0], restored), HyperScore::compute(10.0, true, theo_spectra[0], theo_spectra[2]))
+}
+END_SECTION
+
+START_SECTION((void query(const PeakSpectrum& spectrum, double precursor_mass_min, double precursor_mass_max, double fragment_mass_tolerance, bool fragment_mass_tolerance_unit_ppm, Size min_matched_peaks, std::vector<Candidate>& candidates) const))
+{
+  // query with the spectrum of PEPTIDEK: PEPTIDER shares all b ions
+  const PeakSpectrum& spectrum = theo_spectra[0];
+  vector<FragmentIndex::Candidate> candidates;
+  index.query(spectrum, 0.0, 1e6, 10.0, true, 1, candidates);
+  TEST_EQUAL(candidates.size() >= 2, true)
+
+  Size matched_self = 0, matched_peptider = 0;
+  for (Size i = 0; i < candidates.size(); ++i)
+  {
+    if (candidates[i].peptide == 0) matched_self = candidates[i].matched_peaks;
+    if (candidates[i].peptide == 2) matched_peptider = candidates[i].matched_peaks;
+    // ordered by precursor mass
+    if (i > 0)
+    {
+      TEST_EQUAL(index.getPrecursorMass(candidates[i - 1].peptide) <= index.getPrecursorMass(candidates[i].peptide), true)
+    }
+  }
+  TEST_EQUAL(matched_self, spectrum.size())
+  TEST_EQUAL(matched_peptider, 7) // b1 - b7
+
+  // restrict to the precursor mass window of PEPTIDEK
+  candidates.clear();
+  double mass = peptides[0].getMonoWeight();
+  index.query(spectrum, mass - 0.01, mass + 0.01, 10.0, true, 1, candidates);
+  TEST_EQUAL(candidates.size(), 1)
+  TEST_EQUAL(candidates[0].peptide, 0)
+
+  // open search window with a minimal number of matched peaks
+  candidates.clear();
+  index.query(spectrum, mass - 500.0, mass + 500.0, 0.02, false, 8, candidates);
+  TEST_EQUAL(candidates.size(), 1)
+  TEST_EQUAL(candidates[0].peptide, 0)
+
+  // mass window without peptides
+  candidates.clear();
+  index.query(spectrum, 5000.0, 6000.0, 10.0, true, 1, candidates);
+  TEST_EQUAL(candidates.size(), 0)
+
+  // agrees with HyperScore: every peptide with a non-zero score is a candidate
+  candidates.clear();
+  index.query(spectrum, 0.0, 1e6, 10.0, true, 1, candidates);
+  for (Size p = 0; p < peptides.size(); ++p)
+  {
+    bool is_candidate = false;
+    for (Size i = 0; i < candidates.size(); ++i) { if (candidates[i].peptide == p) is_candidate = true; }
+    TEST_EQUAL(is_candidate, HyperScore::compute(10.0, true, spectrum, theo_spectra[p]) > 0)
+  }
+}
+END_SECTION
+
+/////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////
+END_TEST
@@ -94,6 +94,41 @@ START_SECTION(void cluster())
     TEST_EQUAL(clustering.getResults().size(), 12);
 END_SECTION
 
+START_SECTION([EXTRA] void cluster() for independent regions)
+    // a second copy of the data, separated from the first one by empty grid cells
+    std::vector<double> grid_spacing_x_wide;
+    for (double i = 0; i <= 30; ++i)
+    {
+        grid_spacing_x_wide.push_back(i);
+    }
+    std::vector<double> data_x_twice(data_x);
+    std::vector<double> data_y_twice(data_y);
+    for (Size i = 0; i < data_x.size(); ++i)
+    {
+        data_x_twice.push_back(data_x[i] + 20);
+        data_y_twice.push_back(data_y[i]);
+    }
+    GridBasedClustering<MultiplexClustering::MultiplexDistance> clustering_twice(metric, data_x_twice, data_y_twice, grid_spacing_x_wide, grid_spacing_y);
+    clustering_twice.cluster();
+    std::map<int, GridBasedCluster> results = clustering_twice.getResults();
+    TEST_EQUAL(results.size(), 24);
+
+    // both copies are clustered the same way
+    for (std::map<int, GridBasedCluster>::const_iterator it = results.begin(); it != results.end() && it->first < 1000; ++it)
+    {
+        std::map<int, GridBasedCluster>::const_iterator copy = results.find(it->first + 1000);
+        TEST_EQUAL(copy != results.end(), true);
+        if (copy == results.end()) continue;
+        TEST_REAL_SIMILAR(copy->second.getCentre().getX(), it->second.getCentre().getX() + 20);
+        TEST_REAL_SIMILAR(copy->second.getCentre().getY(), it->second.getCentre().getY());
+        TEST_EQUAL(copy->second.getPoints().size(), it->second.getPoints().size());
+        for (Size p = 0; p < it->second.getPoints().size(); ++p)
+        {
+            TEST_EQUAL(copy->second.getPoints()[p], it->second.getPoints()[p] + 1000);
+        }
+    }
+END_SECTION
+
 START_SECTION(std::map<int Cluster> getResults() const)
     clustering.cluster();
     TEST_EQUAL(clustering.getResults().size(), 12);
@@ -0,0 +1,143 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2018.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: Hannes Roest $
+// $Authors: Hannes Roest $
+// --------------------------------------------------------------------------
+
+#include <OpenMS/CONCEPT/ClassTest.h>
+#include <OpenMS/test_config.h>
+
+///////////////////////////
+#include <OpenMS/CONCEPT/GroupedTaskScheduler.h>
+///////////////////////////
+
+#include <mutex>
+
+using namespace OpenMS;
+using namespace std;
+
+START_TEST(GroupedTaskScheduler, "$Id$")
+
+/////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////
+
+GroupedTaskScheduler* ptr = nullptr;
+GroupedTaskScheduler* nullPointer = nullptr;
+
+START_SECTION(GroupedTaskScheduler(int max_open_groups = -1))
+{
+  ptr = new GroupedTaskScheduler();
+  TEST_NOT_EQUAL(ptr, nullPointer)
+}
+END_SECTION
+
+START_SECTION(~GroupedTaskScheduler())
+{
+  delete ptr;
+}
+END_SECTION
+
+START_SECTION((template < typename SetupFunction, typename TaskFunction, typename FinishFunction > void run(const std::vector< Size > &tasks_per_group, SetupFunction setup, TaskFunction task, FinishFunction finish)))
+{
+  std::vector<Size> tasks_per_group;
+  tasks_per_group.push_back(3);
+  tasks_per_group.push_back(0);
+  tasks_per_group.push_back(10);
+  tasks_per_group.push_back(1);
+  tasks_per_group.push_back(5);
+
+  for (int max_open = -1; max_open <= 2; ++max_open)
+  {
+    std::mutex mutex;
+    std::vector<int> setups(tasks_per_group.size(), 0);
+    std::vector<int> finishes(tasks_per_group.size(), 0);
+    std::vector<std::vector<int> > executed(tasks_per_group.size());
+    for (Size g = 0; g < tasks_per_group.size(); ++g)
+    {
+      executed[g].resize(tasks_per_group[g], 0);
+    }
+    int open = 0, max_observed_open = 0;
+    bool task_before_setup = false, task_after_finish = false;
+
+    GroupedTaskScheduler scheduler(max_open);
+    scheduler.run(tasks_per_group,
+      [&](Size g)
+      {
+        std::lock_guard<std::mutex> lock(mutex);
+        ++setups[g];
+        ++open;
+        max_observed_open = std::max(open, max_observed_open);
+      },
+      [&](Size g, Size t)
+      {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (setups[g] == 0) task_before_setup = true;
+        if (finishes[g] != 0) task_after_finish = true;
+        ++executed[g][t];
+      },
+      [&](Size g)
+      {
+        std::lock_guard<std::mutex> lock(mutex);
+        ++finishes[g];
+        --open;
+      });
+
+    // every group with tasks is set up and finished exactly once, every task is run once
+    for (Size g = 0; g < tasks_per_group.size(); ++g)
+    {
+      int expected = tasks_per_group[g] > 0 ? 1 : 0;
+      TEST_EQUAL(setups[g], expected)
+      TEST_EQUAL(finishes[g], expected)
+      for (Size t = 0; t < tasks_per_group[g]; ++t)
+      {
+        TEST_EQUAL(executed[g][t], 1)
+      }
+    }
+    TEST_EQUAL(task_before_setup, false)
+    TEST_EQUAL(task_after_finish, false)
+    TEST_EQUAL(open, 0)
+    if (max_open > 0)
+    {
+      TEST_EQUAL(max_observed_open <= max_open, true)
+    }
+  }
+
+  // no groups at all
+  std::vector<Size> empty;
+  int calls = 0;
+  GroupedTaskScheduler().run(empty, [&](Size) { ++calls; }, [&](Size, Size) { ++calls; }, [&](Size) { ++calls; });
+  TEST_EQUAL(calls, 0)
+}
+END_SECTION
+
+/////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////
+END_TEST
@@ -37,8 +37,43 @@
 
 ///////////////////////////
 #include <OpenMS/FORMAT/GzipIfstream.h>
+#include <fstream>
+#include <cstring>
 using namespace OpenMS;
 
+// writes @p data as a BGZF file (blocks of at most @p block_size bytes and the BGZF end-of-file block)
+void writeBGZF(const String& filename, const std::string& data, size_t block_size)
+{
+  std::ofstream os(filename.c_str(), std::ios::binary);
+  for (size_t start = 0; start <= data.size(); start += block_size)
+  {
+    std::string chunk = data.substr(start, block_size); // the final chunk is the (empty) end-of-file block
+    std::string cdata(compressBound((uLong)chunk.size()) + 16, '\0');
+    z_stream zs;
+    memset(&zs, 0, sizeof(zs));
+    deflateInit2(&zs, Z_DEFAULT_COMPRESSION, Z_DEFLATED, -15, 8, Z_DEFAULT_STRATEGY);
+    zs.next_in = (Bytef*)chunk.data();
+    zs.avail_in = (uInt)chunk.size();
+    zs.next_out = (Bytef*)&cdata[0];
+    zs.avail_out = (uInt)cdata.size();
+    deflate(&zs, Z_FINISH);
+    cdata.resize(zs.total_out);
+    deflateEnd(&zs);
+
+    size_t bsize = 18 + cdata.size() + 8 - 1;
+    unsigned long crc = crc32(crc32(0L, Z_NULL, 0), (const Bytef*)chunk.data(), (uInt)chunk.size());
+    unsigned char header[18] = {31, 139, 8, 4, 0, 0, 0, 0, 0, 255, 6, 0, 'B', 'C', 2, 0,
+                                (unsigned char)(bsize & 0xff), (unsigned char)(bsize >> 8)};
+    os.write((const char*)header, 18);
+    os.write(cdata.data(), cdata.size());
+    unsigned char trailer[8];
+    for (int i = 0; i < 4; ++i) trailer[i] = (crc >> (8 * i)) & 0xff;
+    for (int i = 0; i < 4; ++i) trailer[4 + i] = (chunk.size() >> (8 * i)) & 0xff;
+    os.write((const char*)trailer, 8);
+    if (chunk.empty()) break;
+  }
+}
+
 
 
 ///////////////////////////
@@ -141,6 +176,55 @@ START_SECTION(size_t read(char *s, size_t n))
 	TEST_EQUAL(String(buffer), String("Was decompression successful?"))
 END_SECTION
 
+START_SECTION(bool isBlockCompressed() const)
+{
+	GzipIfstream gzip(OPENMS_GET_TEST_DATA_PATH("GzipIfStream_1.gz"));
+	TEST_EQUAL(gzip.isBlockCompressed(), false)
+
+	// many small blocks, decompressed in several batches
+	std::string data;
+	for (Size i = 0; i < 50000; ++i) data += String(i) + (i % 10 == 0 ? "\n" : " ");
+	String bgzf_file;
+	NEW_TMP_FILE(bgzf_file)
+	writeBGZF(bgzf_file, data, 100);
+
+	GzipIfstream bgzf(bgzf_file.c_str());
+	TEST_EQUAL(bgzf.isBlockCompressed(), true)
+	TEST_EQUAL(bgzf.isOpen(), true)
+	TEST_EQUAL(bgzf.streamEnd(), false)
+	std::string result;
+	char buffer[777];
+	while (bgzf.isOpen())
+	{
+		size_t n = bgzf.read(buffer, 777);
+		result.append(buffer, n);
+	}
+	TEST_EQUAL(bgzf.streamEnd(), true)
+	TEST_EQUAL(bgzf.isBlockCompressed(), false)
+	TEST_EQUAL(result.size(), data.size())
+	TEST_EQUAL(result == data, true)
+	TEST_EXCEPTION(Exception::IllegalArgument, bgzf.read(buffer, 10))
+
+	// corrupted data is detected by the checksum
+	std::string corrupt;
+	{
+		std::ifstream is(bgzf_file.c_str(), std::ios::binary);
+		corrupt.assign(std::istreambuf_iterator<char>(is), std::istreambuf_iterator<char>());
+	}
+	corrupt[30] = ~corrupt[30];
+	String corrupt_file;
+	NEW_TMP_FILE(corrupt_file)
+	{
+		std::ofstream os(corrupt_file.c_str(), std::ios::binary);
+		os << corrupt;
+	}
+	GzipIfstream bgzf_corrupt(corrupt_file.c_str());
+	TEST_EQUAL(bgzf_corrupt.isBlockCompressed(), true)
+	TEST_EXCEPTION(Exception::ConversionError, bgzf_corrupt.read(buffer, 10))
+	TEST_EQUAL(bgzf_corrupt.isOpen(), false)
+}
+END_SECTION
+
 START_SECTION(void close())
 	//tested in read
 	NOT_TESTABLE
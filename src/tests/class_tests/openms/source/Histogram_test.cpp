@@ -245,6 +245,34 @@ START_SECTION((BinSizeType centerOfBin(Size bin_index) const))
 	TEST_EXCEPTION(Exception::IndexOverflow, dist.centerOfBin(5))
 END_SECTION
 
+START_SECTION((void merge(const Histogram& histogram)))
+	Histogram<float, float> h1(0, 5, 1);
+	h1.inc(0.5, 1);
+	h1.inc(2.5, 3);
+	Histogram<float, float> h2(0, 5, 1);
+	h2.inc(2.5, 2);
+	h2.inc(4.5, 7);
+	h1.merge(h2);
+	TEST_REAL_SIMILAR(h1[0], 1.0)
+	TEST_REAL_SIMILAR(h1[1], 0.0)
+	TEST_REAL_SIMILAR(h1[2], 5.0)
+	TEST_REAL_SIMILAR(h1[3], 0.0)
+	TEST_REAL_SIMILAR(h1[4], 7.0)
+	// merging is order independent
+	Histogram<float, float> h3(0, 5, 1);
+	h3.inc(2.5, 2);
+	h3.inc(4.5, 7);
+	Histogram<float, float> h4(0, 5, 1);
+	h4.inc(0.5, 1);
+	h4.inc(2.5, 3);
+	h3.merge(h4);
+	TEST_EQUAL(h1 == h3, true)
+	Histogram<float, float> other_size(0, 5, 0.5);
+	TEST_EXCEPTION(Exception::IllegalArgument, h1.merge(other_size))
+	Histogram<float, float> other_range(1, 6, 1);
+	TEST_EXCEPTION(Exception::IllegalArgument, h1.merge(other_range))
+END_SECTION
+
 /////////////////////////////////////////////////////////////
 /////////////////////////////////////////////////////////////
 END_TEST
@@ -38,6 +38,7 @@
 #include <OpenMS/ANALYSIS/RNPXL/HyperScore.h>
 ///////////////////////////
 
+#include <OpenMS/ANALYSIS/RNPXL/TheoreticalSpectrumBatch.h>
 #include <OpenMS/KERNEL/MSSpectrum.h>
 #include <OpenMS/KERNEL/MSExperiment.h>
 #include <OpenMS/CHEMISTRY/TheoreticalSpectrumGenerator.h>
@@ -117,6 +118,57 @@ START_SECTION((static double compute(double fragment_mass_tolerance, bool fragme
 }
 END_SECTION
 
+START_SECTION((static void compute(double fragment_mass_tolerance, bool fragment_mass_tolerance_unit_ppm, const PeakSpectrum &exp_spectrum, const TheoreticalSpectrumBatch &theo_spectra, std::vector< double > &scores)))
+{
+  PeakSpectrum exp_spectrum;
+  tsg.getSpectrum(exp_spectrum, AASequence::fromString("PEPTIDE"), 1, 3);
+  // shift some peaks to get partial matches
+  for (Size i = 0; i < exp_spectrum.size(); i += 3)
+  {
+    exp_spectrum[i].setMZ(exp_spectrum[i].getMZ() + 0.05);
+    exp_spectrum[i].setIntensity(0.5 * (i + 1));
+  }
+  exp_spectrum.sortByPosition();
+
+  vector<PeakSpectrum> theo_spectra(5);
+  tsg.getSpectrum(theo_spectra[0], AASequence::fromString("PEPTIDE"), 1, 3);
+  tsg.getSpectrum(theo_spectra[1], AASequence::fromString("PEPTIDER"), 1, 2);
+  // theo_spectra[2] is empty
+  tsg.getSpectrum(theo_spectra[3], AASequence::fromString("YYYYYY"), 1, 3);
+  tsg.getSpectrum(theo_spectra[4], AASequence::fromString("PEPTID"), 1, 1);
+
+  TheoreticalSpectrumBatch batch;
+  for (const PeakSpectrum& theo_spectrum : theo_spectra)
+  {
+    batch.add(theo_spectrum);
+  }
+
+  vector<double> scores;
+  for (double tolerance : {0.01, 0.1, 0.3})
+  {
+    HyperScore::compute(tolerance, false, exp_spectrum, batch, scores);
+    TEST_EQUAL(scores.size(), theo_spectra.size())
+    for (Size s = 0; s < theo_spectra.size(); ++s)
+    {
+      TEST_REAL_SIMILAR(scores[s], HyperScore::compute(tolerance, false, exp_spectrum, theo_spectra[s]))
+    }
+  }
+
+  HyperScore::compute(100, true, exp_spectrum, batch, scores);
+  for (Size s = 0; s < theo_spectra.size(); ++s)
+  {
+    TEST_REAL_SIMILAR(scores[s], HyperScore::compute(100, true, exp_spectrum, theo_spectra[s]))
+  }
+  TEST_NOT_EQUAL(scores[0], 0.0)
+  TEST_REAL_SIMILAR(scores[2], 0.0)
+
+  // empty experimental spectrum
+  HyperScore::compute(0.1, false, PeakSpectrum(), batch, scores);
+  TEST_EQUAL(scores.size(), theo_spectra.size())
+  TEST_REAL_SIMILAR(scores[0], 0.0)
+}
+END_SECTION
+
 /////////////////////////////////////////////////////////////
 /////////////////////////////////////////////////////////////
 END_TEST
@@ -40,6 +40,7 @@
 #include <OpenMS/METADATA/PeptideIdentification.h>
 #include <OpenMS/METADATA/ProteinIdentification.h>
 #include <OpenMS/FORMAT/IdXMLFile.h>
+#include <OpenMS/SYSTEM/File.h>
 
 #include <vector>
 ///////////////////////////
@@ -88,6 +89,66 @@ START_SECTION((void rip(std::map< String, std::pair< std::vector< ProteinIdentif
 }
 END_SECTION
 
+START_SECTION((StringList ripFile(const String &in_file, const String &output_directory)))
+{
+  // one run with three proteins, peptides from two origins (and one without origin)
+  vector<ProteinIdentification> proteins(1);
+  proteins[0].setIdentifier("run");
+  proteins[0].setScoreType("score");
+  for (Size i = 1; i <= 3; ++i)
+  {
+    ProteinHit hit;
+    hit.setAccession("P" + String(i));
+    proteins[0].insertHit(hit);
+  }
+  // output files are returned in order of their origin names
+  String base = File::getUniqueName();
+  String origin_a = base + "_a.idXML", origin_b = base + "_b.idXML";
+  const String origins[] = {origin_a, origin_b, origin_a, ""};
+  const String accessions[] = {"P1", "P2", "P1", "P3"};
+  vector<PeptideIdentification> peptides(4);
+  for (Size i = 0; i < peptides.size(); ++i)
+  {
+    peptides[i].setIdentifier("run");
+    peptides[i].setRT(10.0 * i);
+    PeptideHit hit(1.0, 1, 2, AASequence::fromString("PEPTIDE"));
+    PeptideEvidence evidence;
+    evidence.setProteinAccession(accessions[i]);
+    hit.addPeptideEvidence(evidence);
+    peptides[i].insertHit(hit);
+    if (!origins[i].empty()) peptides[i].setMetaValue("file_origin", "/some/path/" + origins[i]);
+  }
+  String in_file;
+  NEW_TMP_FILE(in_file);
+  IdXMLFile().store(in_file, proteins, peptides);
+
+  StringList written = IDRipper().ripFile(in_file, File::getTempDirectory());
+  TEST_EQUAL(written.size(), 2)
+  ABORT_IF(written.size() != 2)
+
+  vector<ProteinIdentification> prot_a, prot_b;
+  vector<PeptideIdentification> pep_a, pep_b;
+  IdXMLFile().load(written[0], prot_a, pep_a);
+  IdXMLFile().load(written[1], prot_b, pep_b);
+  File::remove(written[0]);
+  File::remove(written[1]);
+
+  TEST_EQUAL(pep_a.size(), 2)
+  TEST_REAL_SIMILAR(pep_a[0].getRT(), 0.0)
+  TEST_REAL_SIMILAR(pep_a[1].getRT(), 20.0)
+  TEST_EQUAL(pep_a[0].metaValueExists("file_origin"), false)
+  TEST_EQUAL(prot_a.size(), 1)
+  // P1 is referenced twice but written once
+  TEST_EQUAL(prot_a[0].getHits().size(), 1)
+  TEST_EQUAL(prot_a[0].getHits()[0].getAccession(), "P1")
+
+  TEST_EQUAL(pep_b.size(), 1)
+  TEST_REAL_SIMILAR(pep_b[0].getRT(), 10.0)
+  TEST_EQUAL(prot_b[0].getHits().size(), 1)
+  TEST_EQUAL(prot_b[0].getHits()[0].getAccession(), "P2")
+}
+END_SECTION
+
 
 /////////////////////////////////////////////////////////////
 /////////////////////////////////////////////////////////////
@@ -67,7 +67,7 @@ START_SECTION(virtual ~ILPDCWrapper())
 END_SECTION
 
 
-START_SECTION((double compute(const FeatureMap fm, PairsType &pairs, Size verbose_level) const))
+START_SECTION((double compute(const FeatureMap& fm, PairsType &pairs, Size verbose_level) const))
 {
   EmpiricalFormula ef("H1");
   Adduct a(+1, 1, ef.getMonoWeight(), "H1", 0.1, 0, "");
@@ -83,6 +83,20 @@ START_SECTION((double compute(const FeatureMap fm, PairsType &pairs, Size verbos
   // check that it runs without pairs (i.e. all clusters are singletons)
   TEST_EQUAL(pairs.size(), 0);
 
+  // two separate components: all edges are realized and the objective adds up over all slices
+  FeatureMap fm2;
+  fm2.resize(4);
+  Compomer cmp;
+  cmp.add(a, Compomer::RIGHT);
+  ILPDCWrapper::PairsType pairs2;
+  pairs2.push_back(ChargePair(0, 1, 1, 2, cmp, 0, false));
+  pairs2.push_back(ChargePair(2, 3, 1, 2, cmp, 0, false));
+  double score = iw.compute(fm2, pairs2, 1);
+  TEST_EQUAL(pairs2.size(), 2)
+  TEST_EQUAL(pairs2[0].isActive(), true)
+  TEST_EQUAL(pairs2[1].isActive(), true)
+  TEST_REAL_SIMILAR(score, pairs2[0].getEdgeScore() + pairs2[1].getEdgeScore())
+
   // real data test
 
 
@@ -50,6 +50,25 @@ START_TEST(IdXMLFile, "$Id$")
 using namespace OpenMS;
 using namespace std;
 
+// collects everything it consumes, counting the peptide identifications
+class CollectingIDConsumer :
+  public Interfaces::IDConsumer
+{
+public:
+  void consumeProteinID(ProteinIdentification& prot_id) override
+  {
+    protein_ids.push_back(prot_id);
+  }
+
+  void consumePeptideID(PeptideIdentification& pep_id) override
+  {
+    peptide_ids.push_back(pep_id);
+  }
+
+  std::vector<ProteinIdentification> protein_ids;
+  std::vector<PeptideIdentification> peptide_ids;
+};
+
 IdXMLFile* ptr = nullptr;
 IdXMLFile* nullPointer = nullptr;
 START_SECTION((IdXMLFile()))
@@ -203,6 +222,28 @@ START_SECTION(void load(const String& filename, std::vector<ProteinIdentificatio
   TEST_EQUAL(pes4[0].getAAAfter(), PeptideEvidence::UNKNOWN_AA)
 END_SECTION
 
+START_SECTION(void load(const String& filename, Interfaces::IDConsumer& consumer))
+{
+  std::vector<ProteinIdentification> protein_ids;
+  std::vector<PeptideIdentification> peptide_ids;
+  IdXMLFile().load(OPENMS_GET_TEST_DATA_PATH("IdXMLFile_whole.idXML"), protein_ids, peptide_ids);
+
+  CollectingIDConsumer consumer;
+  IdXMLFile().load(OPENMS_GET_TEST_DATA_PATH("IdXMLFile_whole.idXML"), consumer);
+
+  TEST_EQUAL(consumer.protein_ids.size(), 2)
+  TEST_EQUAL(consumer.peptide_ids.size(), 3)
+  TEST_EQUAL(consumer.protein_ids == protein_ids, true)
+  TEST_EQUAL(consumer.peptide_ids == peptide_ids, true)
+
+  // file without <ProteinIdentification> still yields the (empty) run
+  CollectingIDConsumer consumer2;
+  IdXMLFile().load(OPENMS_GET_TEST_DATA_PATH("IdXMLFile_no_proteinhits.idXML"), consumer2);
+  TEST_EQUAL(consumer2.protein_ids.size(), 1)
+  TEST_EQUAL(consumer2.peptide_ids.size(), 10)
+}
+END_SECTION
+
 START_SECTION(void store(String filename, const std::vector<ProteinIdentification>& protein_ids, const std::vector<PeptideIdentification>& peptide_ids, const String& document_id="") )
 
   // load, store, and reload data
@@ -0,0 +1,190 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2018.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: Timo Sachsenberg $
+// $Authors: Timo Sachsenberg $
+// --------------------------------------------------------------------------
+
+#include <OpenMS/CONCEPT/ClassTest.h>
+#include <OpenMS/test_config.h>
+
+///////////////////////////
+#include <OpenMS/FORMAT/InMemoryFileStore.h>
+///////////////////////////
+
+#include <OpenMS/FORMAT/MzMLFile.h>
+#include <OpenMS/FORMAT/FeatureXMLFile.h>
+#include <OpenMS/FORMAT/ConsensusXMLFile.h>
+
+using namespace OpenMS;
+using namespace std;
+
+START_TEST(InMemoryFileStore, "$Id$")
+
+/////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////
+
+PeakMap exp;
+MSSpectrum spec;
+spec.setRT(12.5);
+spec.push_back(Peak1D(100.0, 10.0f));
+spec.push_back(Peak1D(200.0, 20.0f));
+exp.addSpectrum(spec);
+
+FeatureMap features;
+Feature f;
+f.setRT(3.0);
+f.setMZ(400.0);
+features.push_back(f);
+
+ConsensusMap consensus;
+ConsensusFeature cf;
+cf.setRT(5.0);
+consensus.push_back(cf);
+
+START_SECTION(static bool isMemoryPath(const String& filename))
+{
+  TEST_EQUAL(InMemoryFileStore::isMemoryPath("mem:a.mzML"), true)
+  TEST_EQUAL(InMemoryFileStore::isMemoryPath("a.mzML"), false)
+  TEST_EQUAL(InMemoryFileStore::isMemoryPath("/tmp/mem:a.mzML"), false)
+  TEST_EQUAL(InMemoryFileStore::isMemoryPath(""), false)
+}
+END_SECTION
+
+START_SECTION(static void store(const String& filename, const PeakMap& data))
+{
+  InMemoryFileStore::store("mem:a.mzML", exp);
+  TEST_EQUAL(InMemoryFileStore::exists("mem:a.mzML"), true)
+  TEST_EXCEPTION(Exception::UnableToCreateFile, InMemoryFileStore::store("a.mzML", exp))
+}
+END_SECTION
+
+START_SECTION(static void store(const String& filename, const FeatureMap& data))
+{
+  InMemoryFileStore::store("mem:a.featureXML", features);
+  TEST_EQUAL(InMemoryFileStore::exists("mem:a.featureXML"), true)
+}
+END_SECTION
+
+START_SECTION(static void store(const String& filename, const ConsensusMap& data))
+{
+  InMemoryFileStore::store("mem:a.consensusXML", consensus);
+  TEST_EQUAL(InMemoryFileStore::exists("mem:a.consensusXML"), true)
+}
+END_SECTION
+
+START_SECTION(static bool exists(const String& filename))
+{
+  TEST_EQUAL(InMemoryFileStore::exists("mem:a.mzML"), true)
+  TEST_EQUAL(InMemoryFileStore::exists("mem:b.mzML"), false)
+}
+END_SECTION
+
+START_SECTION(static void load(const String& filename, PeakMap& data))
+{
+  PeakMap loaded;
+  InMemoryFileStore::load("mem:a.mzML", loaded);
+  TEST_EQUAL(loaded == exp, true)
+  TEST_EXCEPTION(Exception::FileNotFound, InMemoryFileStore::load("mem:b.mzML", loaded))
+  // wrong type
+  TEST_EXCEPTION(Exception::FileNotFound, InMemoryFileStore::load("mem:a.featureXML", loaded))
+}
+END_SECTION
+
+START_SECTION(static void load(const String& filename, FeatureMap& data))
+{
+  FeatureMap loaded;
+  InMemoryFileStore::load("mem:a.featureXML", loaded);
+  TEST_EQUAL(loaded.size(), 1)
+  TEST_REAL_SIMILAR(loaded[0].getMZ(), 400.0)
+  TEST_EXCEPTION(Exception::FileNotFound, InMemoryFileStore::load("mem:a.mzML", loaded))
+}
+END_SECTION
+
+START_SECTION(static void load(const String& filename, ConsensusMap& data))
+{
+  ConsensusMap loaded;
+  InMemoryFileStore::load("mem:a.consensusXML", loaded);
+  TEST_EQUAL(loaded.size(), 1)
+  TEST_REAL_SIMILAR(loaded[0].getRT(), 5.0)
+}
+END_SECTION
+
+START_SECTION(static std::vector<String> getNames())
+{
+  vector<String> names = InMemoryFileStore::getNames();
+  TEST_EQUAL(names.size(), 3)
+  ABORT_IF(names.size() != 3)
+  TEST_EQUAL(names[0], "mem:a.consensusXML")
+  TEST_EQUAL(names[1], "mem:a.featureXML")
+  TEST_EQUAL(names[2], "mem:a.mzML")
+}
+END_SECTION
+
+START_SECTION(static void remove(const String& filename))
+{
+  InMemoryFileStore::remove("mem:a.featureXML");
+  TEST_EQUAL(InMemoryFileStore::exists("mem:a.featureXML"), false)
+  InMemoryFileStore::remove("mem:does_not_exist.mzML");
+  TEST_EQUAL(InMemoryFileStore::getNames().size(), 2)
+}
+END_SECTION
+
+START_SECTION([EXTRA] file classes use the store for "mem:" file names)
+{
+  PeakMap loaded;
+  MzMLFile().store("mem:out.mzML", exp);
+  TEST_EQUAL(InMemoryFileStore::exists("mem:out.mzML"), true)
+  MzMLFile().load("mem:out.mzML", loaded);
+  TEST_EQUAL(loaded.size(), 1)
+  TEST_EQUAL(loaded[0].size(), 2)
+
+  FeatureMap fm;
+  FeatureXMLFile().store("mem:out.featureXML", features);
+  FeatureXMLFile().load("mem:out.featureXML", fm);
+  TEST_EQUAL(fm.size(), 1)
+
+  ConsensusMap cm;
+  ConsensusXMLFile().store("mem:out.consensusXML", consensus);
+  ConsensusXMLFile().load("mem:out.consensusXML", cm);
+  TEST_EQUAL(cm.size(), 1)
+}
+END_SECTION
+
+START_SECTION(static void clear())
+{
+  InMemoryFileStore::clear();
+  TEST_EQUAL(InMemoryFileStore::getNames().size(), 0)
+}
+END_SECTION
+
+/////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////
+END_TEST
@@ -39,6 +39,8 @@
 #include <OpenMS/FORMAT/HANDLERS/IndexedMzMLDecoder.h>
 ///////////////////////////
 
+#include <fstream>
+
 #define MULTI_LINE_STRING(...) #__VA_ARGS__ 
 
 using namespace OpenMS;
@@ -90,6 +92,26 @@ START_SECTION((std::streampos findIndexListOffset(String filename, int buffersiz
 
 END_SECTION
 
+START_SECTION((int parseOffsets(std::istream& in, std::streampos indexoffset, OffsetVector & spectra_offsets, OffsetVector& chromatograms_offsets)))
+  std::ifstream in(OPENMS_GET_TEST_DATA_PATH("IndexedmzMLFile_1.mzML"));
+  std::streampos res = IndexedMzMLDecoder().findIndexListOffset(in);
+  TEST_EQUAL(res, IndexedMzMLDecoder().findIndexListOffset(OPENMS_GET_TEST_DATA_PATH("IndexedmzMLFile_1.mzML")))
+
+  IndexedMzMLDecoder::OffsetVector spectra_offsets, spectra_offsets_file;
+  IndexedMzMLDecoder::OffsetVector chromatograms_offsets, chromatograms_offsets_file;
+  TEST_EQUAL(IndexedMzMLDecoder().parseOffsets(in, res, spectra_offsets, chromatograms_offsets), 0)
+  IndexedMzMLDecoder().parseOffsets(OPENMS_GET_TEST_DATA_PATH("IndexedmzMLFile_1.mzML"), res, spectra_offsets_file, chromatograms_offsets_file);
+  TEST_EQUAL(spectra_offsets.size(), 2)
+  TEST_EQUAL(chromatograms_offsets.size(), 1)
+  TEST_EQUAL(spectra_offsets == spectra_offsets_file, true)
+  TEST_EQUAL(chromatograms_offsets == chromatograms_offsets_file, true)
+END_SECTION
+
+START_SECTION((std::streampos findIndexListOffset(std::istream& in, int buffersize = 1023)))
+  // tested above
+  NOT_TESTABLE
+END_SECTION
+
     
 
 /////////////////////////////////////////////////////////////
@@ -0,0 +1,223 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2018.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: Timo Sachsenberg $
+// $Authors: Timo Sachsenberg $
+// --------------------------------------------------------------------------
+
+#include <OpenMS/CONCEPT/ClassTest.h>
+#include <OpenMS/test_config.h>
+
+///////////////////////////
+
+#include <OpenMS/FORMAT/HANDLERS/IndexedMzXMLHandler.h>
+
+// for comparison
+#include <OpenMS/KERNEL/MSExperiment.h>
+#include <OpenMS/FORMAT/MzXMLFile.h>
+
+using namespace OpenMS;
+using namespace OpenMS::Internal;
+using namespace std;
+
+///////////////////////////
+
+START_TEST(IndexedMzXMLHandler, "$Id$")
+
+/////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////
+
+// an MS1 scan with two nested MS2 scans, followed by another MS1 scan
+PeakMap exp;
+for (Size i = 0; i < 4; ++i)
+{
+  MSSpectrum spec;
+  spec.setMSLevel((i == 1 || i == 2) ? 2 : 1);
+  spec.setRT(10.0 + i);
+  spec.setNativeID(String("scan=") + (i + 1));
+  for (Size j = 0; j < 10 * (i + 1); ++j)
+  {
+    spec.push_back(Peak1D(100.0 + j + 0.25 * i, 1000.0 * (j + 1)));
+  }
+  if (spec.getMSLevel() == 2)
+  {
+    Precursor prec;
+    prec.setMZ(500.0 + i);
+    prec.setCharge(2);
+    spec.getPrecursors().push_back(prec);
+  }
+  exp.addSpectrum(spec);
+}
+
+String filename;
+NEW_TMP_FILE(filename)
+MzXMLFile().store(filename, exp);
+
+PeakMap reference;
+MzXMLFile().load(filename, reference);
+
+IndexedMzXMLHandler* ptr = nullptr;
+IndexedMzXMLHandler* nullPointer = nullptr;
+START_SECTION((IndexedMzXMLHandler(const String& filename)))
+  ptr = new IndexedMzXMLHandler(filename);
+  TEST_NOT_EQUAL(ptr, nullPointer)
+END_SECTION
+
+START_SECTION((~IndexedMzXMLHandler()))
+  delete ptr;
+END_SECTION
+
+START_SECTION((IndexedMzXMLHandler()))
+  ptr = new IndexedMzXMLHandler();
+  TEST_NOT_EQUAL(ptr, nullPointer)
+  TEST_EQUAL(ptr->getParsingSuccess(), false)
+  TEST_EQUAL(ptr->getNrSpectra(), 0)
+  delete ptr;
+END_SECTION
+
+START_SECTION((IndexedMzXMLHandler(const IndexedMzXMLHandler& source)))
+{
+  IndexedMzXMLHandler file(filename);
+  IndexedMzXMLHandler file2(file);
+
+  TEST_EQUAL(file.getParsingSuccess(), file2.getParsingSuccess())
+  TEST_EQUAL(file.getNrSpectra(), file2.getNrSpectra())
+  ABORT_IF(file.getNrSpectra() != 4)
+  TEST_EQUAL(file.getMSSpectrumById(2) == file2.getMSSpectrumById(2), true)
+}
+END_SECTION
+
+START_SECTION((void openFile(const String& filename)))
+{
+  IndexedMzXMLHandler file;
+  file.openFile(filename);
+  TEST_EQUAL(file.getParsingSuccess(), true)
+
+  TEST_EXCEPTION(Exception::FileNotFound, file.openFile("this_file_does_not_exist.mzXML"))
+
+  // a file without index
+  String no_index;
+  NEW_TMP_FILE(no_index)
+  {
+    ofstream os(no_index.c_str());
+    os << "<?xml version=\"1.0\"?>\n<mzXML>\n<msRun>\n</msRun>\n</mzXML>\n";
+  }
+  file.openFile(no_index);
+  TEST_EQUAL(file.getParsingSuccess(), false)
+  TEST_EQUAL(file.getNrSpectra(), 0)
+}
+END_SECTION
+
+START_SECTION((bool getParsingSuccess() const))
+{
+  IndexedMzXMLHandler file(filename);
+  TEST_EQUAL(file.getParsingSuccess(), true)
+}
+END_SECTION
+
+START_SECTION((size_t getNrSpectra() const))
+{
+  IndexedMzXMLHandler file(filename);
+  TEST_EQUAL(file.getNrSpectra(), 4)
+}
+END_SECTION
+
+START_SECTION((const std::string& getScanNumber(int id) const))
+{
+  IndexedMzXMLHandler file(filename);
+  TEST_EQUAL(file.getScanNumber(0), "1")
+  TEST_EQUAL(file.getScanNumber(3), "4")
+  TEST_EXCEPTION(Exception::IndexOverflow, file.getScanNumber(4))
+}
+END_SECTION
+
+START_SECTION((const MSSpectrum getMSSpectrumById(int id)))
+{
+  IndexedMzXMLHandler file(filename);
+  ABORT_IF(reference.size() != 4)
+
+  // the nested MS2 scans and the scans around them are identical to a full load
+  for (Size i = 0; i < reference.size(); ++i)
+  {
+    MSSpectrum spec = file.getMSSpectrumById((int)i);
+    TEST_EQUAL(spec == reference[i], true)
+    TEST_EQUAL(spec.size(), 10 * (i + 1))
+    TEST_EQUAL(spec.getNativeID(), reference[i].getNativeID())
+    TEST_EQUAL(spec.getMSLevel(), reference[i].getMSLevel())
+    TEST_EQUAL(spec.getPrecursors().size(), reference[i].getPrecursors().size())
+  }
+
+  TEST_EXCEPTION(Exception::IllegalArgument, file.getMSSpectrumById(-1))
+  TEST_EXCEPTION(Exception::IllegalArgument, file.getMSSpectrumById(4))
+
+  IndexedMzXMLHandler empty;
+  TEST_EXCEPTION(Exception::ParseError, empty.getMSSpectrumById(0))
+}
+END_SECTION
+
+START_SECTION((void getMSSpectrumById(int id, MSSpectrum& s)))
+{
+  IndexedMzXMLHandler file(filename);
+  MSSpectrum spec;
+  file.getMSSpectrumById(1, spec);
+  TEST_EQUAL(spec == reference[1], true)
+  TEST_REAL_SIMILAR(spec.getPrecursors()[0].getMZ(), 501.0)
+}
+END_SECTION
+
+START_SECTION((void getMSSpectraByIds(const std::vector<int>& ids, std::vector<MSSpectrum>& spectra)))
+{
+  IndexedMzXMLHandler file(filename);
+
+  // any order, repeated ids are allowed
+  std::vector<int> ids;
+  ids.push_back(3);
+  ids.push_back(1);
+  ids.push_back(0);
+  ids.push_back(1);
+  std::vector<MSSpectrum> spectra;
+  file.getMSSpectraByIds(ids, spectra);
+  ABORT_IF(spectra.size() != ids.size())
+  for (Size i = 0; i < ids.size(); ++i)
+  {
+    TEST_EQUAL(spectra[i] == reference[ids[i]], true)
+  }
+
+  file.getMSSpectraByIds(std::vector<int>(), spectra);
+  TEST_EQUAL(spectra.size(), 0)
+
+  ids.push_back(7);
+  TEST_EXCEPTION(Exception::IllegalArgument, file.getMSSpectraByIds(ids, spectra))
+}
+END_SECTION
+
+/////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////
+END_TEST
@@ -117,7 +117,46 @@ END_SECTION
 
 START_SECTION((IntegerMassDecomposer< ValueType, DecompositionValueType >::decomposition_value_type getNumberOfDecompositions(value_type mass)))
 {
-  // TODO
+  IntegerMassDecomposer<> decomposer(createWeights());
+  Weights weights(createWeights());
+  // some integer mass which has decompositions
+  IntegerMassDecomposer<>::value_type mass = 10 * weights.getWeight(0) + 3 * weights.getWeight(5);
+  TEST_EQUAL(decomposer.getNumberOfDecompositions(mass), decomposer.getAllDecompositions(mass).size())
+  TEST_EQUAL(decomposer.getNumberOfDecompositions(mass) > 0, true)
+}
+END_SECTION
+
+// visitor accepting a limited number of decompositions
+struct BoundedCollector
+{
+  IntegerMassDecomposer<>::decompositions_type decompositions;
+  Size max_decompositions;
+
+  bool operator()(const IntegerMassDecomposer<>::decomposition_type& decomposition)
+  {
+    decompositions.push_back(decomposition);
+    return decompositions.size() < max_decompositions;
+  }
+};
+
+START_SECTION((template <typename Visitor> bool visitDecompositions(value_type mass, Visitor &visitor) const))
+{
+  const IntegerMassDecomposer<> decomposer(createWeights());
+  Weights weights(createWeights());
+  IntegerMassDecomposer<>::value_type mass = 10 * weights.getWeight(0) + 3 * weights.getWeight(5);
+  IntegerMassDecomposer<>::decompositions_type all = IntegerMassDecomposer<>(createWeights()).getAllDecompositions(mass);
+  TEST_EQUAL(all.size() > 2, true)
+
+  BoundedCollector unbounded;
+  unbounded.max_decompositions = all.size() + 1;
+  TEST_EQUAL(decomposer.visitDecompositions(mass, unbounded), true)
+  TEST_EQUAL(unbounded.decompositions == all, true)
+
+  BoundedCollector bounded;
+  bounded.max_decompositions = 2;
+  TEST_EQUAL(decomposer.visitDecompositions(mass, bounded), false)
+  TEST_EQUAL(bounded.decompositions.size(), 2)
+  TEST_EQUAL(equal(bounded.decompositions.begin(), bounded.decompositions.end(), all.begin()), true)
 }
 END_SECTION
 
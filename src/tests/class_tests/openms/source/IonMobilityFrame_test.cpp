@@ -0,0 +1,184 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry               
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2018.
+// 
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution 
+//    may be used to endorse or promote products derived from this software 
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS. 
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING 
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, 
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, 
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; 
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, 
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR 
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF 
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+// 
+// --------------------------------------------------------------------------
+// $Maintainer: Hannes Roest $
+// $Authors: Hannes Roest $
+// --------------------------------------------------------------------------
+
+#include <OpenMS/CONCEPT/ClassTest.h>
+#include <OpenMS/test_config.h>
+
+///////////////////////////
+#include <OpenMS/ANALYSIS/OPENSWATH/IonMobilityFrame.h>
+///////////////////////////
+
+using namespace OpenMS;
+using namespace std;
+
+// a frame of 3 mobility scans (0.8, 0.9, 1.0), as a spectrum in m/z order
+OpenSwath::SpectrumPtr getFrame()
+{
+  OpenSwath::SpectrumPtr spec(new OpenSwath::Spectrum());
+  OpenSwath::BinaryDataArrayPtr mz(new OpenSwath::BinaryDataArray);
+  OpenSwath::BinaryDataArrayPtr intensity(new OpenSwath::BinaryDataArray);
+  OpenSwath::BinaryDataArrayPtr im(new OpenSwath::BinaryDataArray);
+  im->description = "Ion Mobility";
+  mz->data =        {100.0, 100.1, 100.2, 100.3, 100.4, 100.5, 100.6, 100.7};
+  intensity->data = {    1,     2,     4,     8,    16,    32,    64,   128};
+  im->data =        {  0.9,   0.8,   1.0,   0.9,   0.8,   1.0,   0.9,   0.8};
+  spec->setMZArray(mz);
+  spec->setIntensityArray(intensity);
+  spec->getDataArrays().push_back(im);
+  return spec;
+}
+
+START_TEST(IonMobilityFrame, "$Id$")
+
+/////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////
+
+IonMobilityFrame* ptr = nullptr;
+IonMobilityFrame* nullPointer = nullptr;
+
+START_SECTION(IonMobilityFrame())
+{
+  ptr = new IonMobilityFrame();
+  TEST_NOT_EQUAL(ptr, nullPointer)
+  TEST_EQUAL(ptr->size(), 0)
+  TEST_EQUAL(ptr->getNrScans(), 0)
+  TEST_REAL_SIMILAR(ptr->sumIntensity(0.0, 1000.0, 0.0, 2.0), 0.0)
+  TEST_EQUAL(ptr->extractSpectrum(0.0, 2.0)->getMZArray()->data.size(), 0)
+  delete ptr;
+}
+END_SECTION
+
+START_SECTION(explicit IonMobilityFrame(const OpenSwath::SpectrumPtr& spectrum))
+{
+  IonMobilityFrame frame(getFrame());
+  TEST_EQUAL(frame.size(), 8)
+  TEST_EQUAL(frame.getNrScans(), 3)
+  // sorted by mobility, then m/z
+  TEST_REAL_SIMILAR(frame.getMobilities()[0], 0.8)
+  TEST_REAL_SIMILAR(frame.getMZs()[0], 100.1)
+  TEST_REAL_SIMILAR(frame.getMZs()[2], 100.7)
+  TEST_REAL_SIMILAR(frame.getIntensities()[2], 128)
+  TEST_REAL_SIMILAR(frame.getMobilities()[7], 1.0)
+  TEST_REAL_SIMILAR(frame.getMZs()[7], 100.5)
+
+  OpenSwath::SpectrumPtr no_im(new OpenSwath::Spectrum());
+  TEST_EXCEPTION(Exception::IllegalArgument, IonMobilityFrame tmp(no_im))
+}
+END_SECTION
+
+START_SECTION(Size size() const)
+{
+  NOT_TESTABLE // tested above
+}
+END_SECTION
+
+START_SECTION(Size getNrScans() const)
+{
+  NOT_TESTABLE // tested above
+}
+END_SECTION
+
+START_SECTION(const std::vector<double>& getMobilities() const)
+{
+  NOT_TESTABLE // tested above
+}
+END_SECTION
+
+START_SECTION(const std::vector<double>& getMZs() const)
+{
+  NOT_TESTABLE // tested above
+}
+END_SECTION
+
+START_SECTION(const std::vector<double>& getIntensities() const)
+{
+  NOT_TESTABLE // tested above
+}
+END_SECTION
+
+START_SECTION(double sumIntensity(double mz_lower, double mz_upper, double im_lower, double im_upper) const)
+{
+  OpenSwath::SpectrumPtr spec = getFrame();
+  IonMobilityFrame frame(spec);
+  TEST_REAL_SIMILAR(frame.sumIntensity(99.0, 101.0, 0.0, 2.0), 255)
+  TEST_REAL_SIMILAR(frame.sumIntensity(99.0, 101.0, 0.85, 0.95), 1 + 8 + 64)
+  TEST_REAL_SIMILAR(frame.sumIntensity(100.15, 100.65, 0.85, 1.05), 4 + 8 + 32 + 64)
+  // open intervals
+  TEST_REAL_SIMILAR(frame.sumIntensity(100.0, 100.3, 0.8, 1.0), 0)
+  TEST_REAL_SIMILAR(frame.sumIntensity(100.05, 100.35, 0.75, 0.95), 2 + 8)
+
+  // same as a linear scan for all windows
+  const vector<double>& mz = spec->getMZArray()->data;
+  const vector<double>& intensity = spec->getIntensityArray()->data;
+  const vector<double>& im = spec->getDataArrays()[2]->data;
+  Size nr_correct(0), nr_windows(0);
+  for (double mz_lower = 99.95; mz_lower < 100.8; mz_lower += 0.1)
+  {
+    for (double im_lower = 0.75; im_lower < 1.05; im_lower += 0.1)
+    {
+      double expected(0);
+      for (Size i = 0; i < mz.size(); ++i)
+      {
+        if (mz[i] > mz_lower && mz[i] < mz_lower + 0.3 && im[i] > im_lower && im[i] < im_lower + 0.2) expected += intensity[i];
+      }
+      nr_correct += fabs(frame.sumIntensity(mz_lower, mz_lower + 0.3, im_lower, im_lower + 0.2) - expected) < 1e-9;
+      ++nr_windows;
+    }
+  }
+  TEST_EQUAL(nr_correct, nr_windows)
+}
+END_SECTION
+
+START_SECTION(OpenSwath::SpectrumPtr extractSpectrum(double im_lower, double im_upper) const)
+{
+  IonMobilityFrame frame(getFrame());
+  OpenSwath::SpectrumPtr spec = frame.extractSpectrum(0.75, 0.95);
+  ABORT_IF(spec->getMZArray()->data.size() != 6)
+  // m/z order is restored
+  TEST_REAL_SIMILAR(spec->getMZArray()->data[0], 100.0)
+  TEST_REAL_SIMILAR(spec->getMZArray()->data[1], 100.1)
+  TEST_REAL_SIMILAR(spec->getMZArray()->data[5], 100.7)
+  TEST_REAL_SIMILAR(spec->getIntensityArray()->data[1], 2)
+  TEST_REAL_SIMILAR(spec->getIntensityArray()->data[5], 128)
+  TEST_EQUAL(spec->getDriftTimeArray() != nullptr, true)
+  TEST_REAL_SIMILAR(spec->getDriftTimeArray()->data[0], 0.9)
+  TEST_REAL_SIMILAR(spec->getDriftTimeArray()->data[1], 0.8)
+
+  TEST_EQUAL(frame.extractSpectrum(1.05, 2.0)->getMZArray()->data.size(), 0)
+}
+END_SECTION
+
+/////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////
+END_TEST
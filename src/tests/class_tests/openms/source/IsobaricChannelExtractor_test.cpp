@@ -751,6 +751,82 @@ START_SECTION(([EXTRA] TMT 10plex support))
 }
 END_SECTION
 
+START_SECTION(([EXTRA] ExtractionConsumer))
+{
+  // extracting while reading gives the same result as extracting from the complete experiment
+  PeakMap exp_purity;
+  MzMLFile().load(OPENMS_GET_TEST_DATA_PATH("IsobaricChannelExtractor_6.mzML"), exp_purity);
+
+  IsobaricChannelExtractor ice(q_method);
+  Param p = ice.getParameters();
+  p.setValue("select_activation", "");
+  ice.setParameters(p);
+
+  ConsensusMap cm_batch;
+  ice.extractChannels(exp_purity, cm_batch);
+
+  ConsensusMap cm_stream;
+  cm_stream.push_back(ConsensusFeature()); // is cleared
+  IsobaricChannelExtractor::ExtractionConsumer consumer(ice, cm_stream);
+  MzMLFile().transform(OPENMS_GET_TEST_DATA_PATH("IsobaricChannelExtractor_6.mzML"), &consumer, true, true);
+  consumer.finish();
+
+  TEST_EQUAL(cm_stream.size(), cm_batch.size())
+  ABORT_IF(cm_stream.size() != cm_batch.size())
+  TEST_EQUAL(cm_stream.getColumnHeaders().size(), cm_batch.getColumnHeaders().size())
+  TEST_EQUAL(cm_stream.getExperimentType(), "labeled_MS2")
+  for (Size i = 0; i < cm_batch.size(); ++i)
+  {
+    TEST_EQUAL(cm_stream[i].getMetaValue("scan_id"), cm_batch[i].getMetaValue("scan_id"))
+    TEST_REAL_SIMILAR(cm_stream[i].getMetaValue("precursor_purity"), cm_batch[i].getMetaValue("precursor_purity"))
+    TEST_REAL_SIMILAR(cm_stream[i].getRT(), cm_batch[i].getRT())
+    TEST_REAL_SIMILAR(cm_stream[i].getIntensity(), cm_batch[i].getIntensity())
+    TEST_EQUAL(cm_stream[i].size(), cm_batch[i].size())
+  }
+
+  // same for TMT 10plex (with 0 intensity reporters)
+  PeakMap tmt10plex_exp;
+  MzMLFile().load(OPENMS_GET_TEST_DATA_PATH("IsobaricChannelExtractor_8.mzML"), tmt10plex_exp);
+  TMTTenPlexQuantitationMethod tmt10plex;
+  IsobaricChannelExtractor ice_tmt(&tmt10plex);
+  p = ice_tmt.getParameters();
+  p.setValue("reporter_mass_shift", 0.003);
+  ice_tmt.setParameters(p);
+
+  ice_tmt.extractChannels(tmt10plex_exp, cm_batch);
+  IsobaricChannelExtractor::ExtractionConsumer consumer_tmt(ice_tmt, cm_stream);
+  for (Size i = 0; i < tmt10plex_exp.size(); ++i)
+  {
+    consumer_tmt.consumeSpectrum(tmt10plex_exp[i]);
+  }
+  consumer_tmt.finish();
+
+  TEST_EQUAL(cm_stream.size(), 5)
+  ABORT_IF(cm_stream.size() != cm_batch.size())
+  for (Size i = 0; i < cm_batch.size(); ++i)
+  {
+    TEST_EQUAL(cm_stream[i].getMetaValue("scan_id"), cm_batch[i].getMetaValue("scan_id"))
+    ABORT_IF(cm_stream[i].size() != cm_batch[i].size())
+    ConsensusFeature::const_iterator it_stream = cm_stream[i].begin();
+    for (ConsensusFeature::const_iterator it = cm_batch[i].begin(); it != cm_batch[i].end(); ++it, ++it_stream)
+    {
+      TEST_REAL_SIMILAR(it_stream->getIntensity(), it->getIntensity())
+    }
+  }
+
+  // spectra need to be sorted by RT
+  IsobaricChannelExtractor::ExtractionConsumer consumer_unsorted(ice, cm_stream);
+  MSSpectrum s = exp_purity[1];
+  consumer_unsorted.consumeSpectrum(s);
+  s = exp_purity[0];
+  TEST_EXCEPTION(Exception::InvalidParameter, consumer_unsorted.consumeSpectrum(s))
+
+  // no data
+  IsobaricChannelExtractor::ExtractionConsumer consumer_empty(ice, cm_stream);
+  TEST_EXCEPTION(Exception::MissingInformation, consumer_empty.finish())
+}
+END_SECTION
+
 delete q_method;
 
 /////////////////////////////////////////////////////////////
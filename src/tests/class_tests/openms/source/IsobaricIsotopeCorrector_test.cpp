@@ -182,7 +182,45 @@ START_SECTION((IsobaricQuantifierStatistics correctIsotopicImpurities(const Cons
     // TEST_EQUAL(stats.empty_channels[117], 1)
   }
 
-  // 4. test precondition
+  // 4. features with a non-negative exact solution are corrected without NNLS
+  {
+    ConsensusXMLFile cm_file;
+    ConsensusMap cm_in, cm_out;
+    cm_file.load(OPENMS_GET_TEST_DATA_PATH("IsobaricIsotopeCorrector.consensusXML"),cm_in);
+    cm_in.clear(false);
+
+    // b = A * x for a known (positive) x
+    Matrix<double> correction_matrix = quant_meth.getIsotopeCorrectionMatrix();
+    double x[4] = {10.0, 200.0, 30.0, 400.0};
+    double v[4] = {0.0, 0.0, 0.0, 0.0};
+    for (Size row = 0; row < 4; ++row)
+    {
+      for (Size col = 0; col < 4; ++col)
+      {
+        v[row] += correction_matrix(row, col) * x[col];
+      }
+    }
+    cm_in.push_back(getCFWithIntensites(v));
+    cm_in.push_back(getCFWithIntensites(v));
+    cm_out = cm_in;
+
+    IsobaricQuantifierStatistics stats = IsobaricIsotopeCorrector::correctIsotopicImpurities(cm_in, cm_out, &quant_meth);
+    for (Size i = 0; i < cm_out.size(); ++i)
+    {
+      ABORT_IF(cm_out[i].getFeatures().size() != 4)
+      Size index = 0;
+      for (ConsensusFeature::HandleSetType::const_iterator it = cm_out[i].getFeatures().begin(); it != cm_out[i].getFeatures().end(); ++it, ++index)
+      {
+        TEST_REAL_SIMILAR(it->getIntensity(), x[index])
+      }
+      TEST_REAL_SIMILAR(cm_out[i].getIntensity(), 640.0)
+    }
+    TEST_EQUAL(stats.iso_number_ms2_negative, 0)
+    TEST_EQUAL(stats.iso_number_reporter_negative, 0)
+    TEST_EQUAL(stats.iso_number_reporter_different, 0)
+  }
+
+  // 5. test precondition
   {
     ConsensusXMLFile cm_file;
     ConsensusMap cm_in, cm_out;
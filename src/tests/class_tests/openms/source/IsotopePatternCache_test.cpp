@@ -0,0 +1,133 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2018.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: Chris Bielow $
+// $Authors: Hannes Roest $
+// --------------------------------------------------------------------------
+
+
+#include <OpenMS/CONCEPT/ClassTest.h>
+#include <OpenMS/test_config.h>
+
+///////////////////////////
+#include <OpenMS/CHEMISTRY/ISOTOPEDISTRIBUTION/IsotopePatternCache.h>
+///////////////////////////
+
+#include <OpenMS/CHEMISTRY/EmpiricalFormula.h>
+#include <OpenMS/CHEMISTRY/ISOTOPEDISTRIBUTION/CoarseIsotopePatternGenerator.h>
+
+using namespace OpenMS;
+using namespace std;
+
+START_TEST(IsotopePatternCache, "$Id$")
+
+/////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////
+
+IsotopePatternCache* cache = nullptr;
+IsotopePatternCache* null_ptr = nullptr;
+
+START_SECTION((static IsotopePatternCache* getInstance()))
+{
+  cache = IsotopePatternCache::getInstance();
+  TEST_NOT_EQUAL(cache, null_ptr)
+  TEST_EQUAL(IsotopePatternCache::getInstance(), cache)
+  cache->clear();
+  TEST_EQUAL(cache->size(), 0)
+}
+END_SECTION
+
+START_SECTION((static double getMassResolution()))
+{
+  TEST_EQUAL(IsotopePatternCache::getMassResolution() > 0.0, true)
+}
+END_SECTION
+
+START_SECTION((const std::vector<double>& getAveragineIntensities(double mass, Size max_isotope)))
+{
+  double resolution = IsotopePatternCache::getMassResolution();
+  double mass = 1234.5;
+  const vector<double>& intensities = cache->getAveragineIntensities(mass, 4);
+  TEST_EQUAL(intensities.size(), 4)
+  TEST_EQUAL(cache->size(), 1)
+
+  // pattern of the bin center, scaled to a maximum of 1:
+  CoarseIsotopePatternGenerator solver(4);
+  IsotopeDistribution dist = solver.estimateFromPeptideWeight((floor(mass / resolution) + 0.5) * resolution);
+  double max = 0.0;
+  for (Size i = 0; i < dist.size(); ++i) max = std::max(max, double(dist[i].getIntensity()));
+  ABORT_IF(intensities.size() != dist.size())
+  for (Size i = 0; i < dist.size(); ++i)
+  {
+    TEST_REAL_SIMILAR(intensities[i], dist[i].getIntensity() / max)
+  }
+
+  // same bin, same pattern:
+  TEST_EQUAL(&cache->getAveragineIntensities(mass + 0.1 * resolution, 4), &intensities)
+  TEST_EQUAL(cache->size(), 1)
+  // different number of isotopes:
+  TEST_EQUAL(cache->getAveragineIntensities(mass, 3).size(), 3)
+  TEST_EQUAL(cache->size(), 2)
+}
+END_SECTION
+
+START_SECTION((const std::vector<double>& getFormulaIntensities(const EmpiricalFormula& formula, Size max_isotope)))
+{
+  EmpiricalFormula formula("C6H12O6");
+  const vector<double>& intensities = cache->getFormulaIntensities(formula, 3);
+  IsotopeDistribution dist = formula.getIsotopeDistribution(CoarseIsotopePatternGenerator(3));
+  TEST_EQUAL(intensities.size(), dist.size())
+  ABORT_IF(intensities.size() != dist.size())
+  TEST_REAL_SIMILAR(intensities[0], 1.0)
+  for (Size i = 1; i < dist.size(); ++i)
+  {
+    TEST_REAL_SIMILAR(intensities[i], dist[i].getIntensity() / dist[0].getIntensity())
+  }
+  TEST_EQUAL(&cache->getFormulaIntensities(EmpiricalFormula("C6H12O6"), 3), &intensities)
+  TEST_EQUAL(cache->size(), 3)
+}
+END_SECTION
+
+START_SECTION((Size size() const))
+{
+  NOT_TESTABLE // tested above
+}
+END_SECTION
+
+START_SECTION((void clear()))
+{
+  cache->clear();
+  TEST_EQUAL(cache->size(), 0)
+}
+END_SECTION
+
+/////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////
+END_TEST
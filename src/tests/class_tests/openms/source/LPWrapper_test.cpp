@@ -115,6 +115,56 @@ START_SECTION((Int addColumn(std::vector< Int > &column_indices, std::vector< do
 }
 END_SECTION
 
+START_SECTION((Int addRows(const std::vector<Int>& row_starts, const std::vector<Int>& column_indices, const std::vector<double>& values, const std::vector<String>& names, const std::vector<double>& lower_bounds, const std::vector<double>& upper_bounds, const std::vector<Type>& types)))
+{
+  LPWrapper lp_rows;
+  lp_rows.addColumn();
+  lp_rows.addColumn();
+  lp_rows.addRow(indices, values, String("first"));
+  // two rows in CSR format: (0.5, 0.5) and (0, 2)
+  std::vector<Int> row_starts, column_indices;
+  row_starts.push_back(0);
+  row_starts.push_back(2);
+  row_starts.push_back(3);
+  column_indices.push_back(0);
+  column_indices.push_back(1);
+  column_indices.push_back(1);
+  std::vector<double> row_values;
+  row_values.push_back(0.5);
+  row_values.push_back(0.5);
+  row_values.push_back(2.0);
+  std::vector<String> names;
+  names.push_back("bulk1");
+  names.push_back("bulk2");
+  std::vector<double> lower(2, 0.2), upper(2, 1.2);
+  std::vector<LPWrapper::Type> types(2, LPWrapper::DOUBLE_BOUNDED);
+  TEST_EQUAL(lp_rows.addRows(row_starts, column_indices, row_values, names, lower, upper, types), 1)
+  TEST_EQUAL(lp_rows.getNumberOfRows(), 3)
+  TEST_EQUAL(lp_rows.getRowName(1), "bulk1")
+  TEST_EQUAL(lp_rows.getRowName(2), "bulk2")
+  TEST_REAL_SIMILAR(lp_rows.getRowLowerBound(2), 0.2)
+  TEST_REAL_SIMILAR(lp_rows.getRowUpperBound(2), 1.2)
+  TEST_REAL_SIMILAR(lp_rows.getElement(1, 1), 0.5)
+  TEST_REAL_SIMILAR(lp_rows.getElement(2, 1), 2.0)
+  TEST_EQUAL(lp_rows.getNumberOfNonZeroEntriesInRow(2), 1)
+
+  // nothing to add:
+  std::vector<Int> no_starts(1, 0), no_indices;
+  std::vector<double> no_values;
+  std::vector<String> no_names;
+  std::vector<LPWrapper::Type> no_types;
+  TEST_EQUAL(lp_rows.addRows(no_starts, no_indices, no_values, no_names, no_values, no_values, no_types), 3)
+  TEST_EQUAL(lp_rows.getNumberOfRows(), 3)
+
+  // inconsistent input:
+  names.pop_back();
+  TEST_EXCEPTION(Exception::IllegalArgument, lp_rows.addRows(row_starts, column_indices, row_values, names, lower, upper, types))
+  names.push_back("bulk2");
+  row_starts.back() = 2;
+  TEST_EXCEPTION(Exception::IllegalArgument, lp_rows.addRows(row_starts, column_indices, row_values, names, lower, upper, types))
+}
+END_SECTION
+
 START_SECTION((void setColumnName(Int index, const String &name)))
 {
   lp.setColumnName(0,"col1");
@@ -402,6 +452,19 @@ START_SECTION((Int solve(SolverParam &solver_param, const Size verbose_level=0))
   lp3.solve(param3);
   TEST_EQUAL(lp3.getColumnValue(0),2)
   TEST_EQUAL(lp3.getColumnValue(1),2)
+
+  // re-solving (starting from the previous solution, if supported) gives the same result
+  param3.enable_warm_start = true;
+  lp3.solve(param3);
+  TEST_EQUAL(lp3.getColumnValue(0),2)
+  TEST_EQUAL(lp3.getColumnValue(1),2)
+
+  LPWrapper lp5;
+  lp5.readProblem(OPENMS_GET_TEST_DATA_PATH("LPWrapper_test_integer.mps"),"MPS");
+  lp5.setObjectiveSense(LPWrapper::MAX);
+  lp5.solve(param3);
+  TEST_EQUAL(lp5.getColumnValue(0),2)
+  TEST_EQUAL(lp5.getColumnValue(1),2)
 }
 END_SECTION
 
@@ -494,6 +557,7 @@ START_SECTION(([LPWrapper::SolverParam] SolverParam()))
   TEST_EQUAL(sptr->output_delay,10000)
   TEST_EQUAL(sptr->enable_presolve,true)
   TEST_EQUAL(sptr->enable_binarization,true) 
+  TEST_EQUAL(sptr->enable_warm_start,false)
 }
 END_SECTION
 
@@ -0,0 +1,225 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2018.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: Hannes Roest $
+// $Authors: Hannes Roest $
+// --------------------------------------------------------------------------
+
+
+#include <OpenMS/CONCEPT/ClassTest.h>
+#include <OpenMS/test_config.h>
+
+///////////////////////////
+#include <OpenMS/ANALYSIS/OPENSWATH/LightTargetedExperimentIndex.h>
+///////////////////////////
+
+#include <OpenMS/ANALYSIS/OPENSWATH/OpenSwathHelper.h>
+
+using namespace OpenMS;
+using namespace std;
+
+START_TEST(LightTargetedExperimentIndex, "$Id$")
+
+/////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////
+
+OpenSwath::LightTargetedExperiment exp;
+{
+  OpenSwath::LightProtein prot1, prot2;
+  prot1.id = "prot1";
+  prot2.id = "prot2";
+  exp.proteins.push_back(prot1);
+  exp.proteins.push_back(prot2);
+
+  double mz[] = {500.0, 400.0, 600.0, 450.0};
+  double rt[] = {10.0, 30.0, 20.0, 40.0};
+  for (Size i = 0; i < 4; ++i)
+  {
+    OpenSwath::LightCompound c;
+    c.id = String("pep") + String(i);
+    c.rt = rt[i];
+    c.protein_refs.push_back(i < 2 ? "prot1" : "prot2");
+    exp.compounds.push_back(c);
+  }
+  // transitions interleaved with respect to their compounds, one without compound
+  Size peptide[] = {0, 1, 2, 0, 3, 1, 2};
+  for (Size i = 0; i < 7; ++i)
+  {
+    OpenSwath::LightTransition tr;
+    tr.transition_name = String("tr") + String(i);
+    tr.peptide_ref = exp.compounds[peptide[i]].id;
+    tr.precursor_mz = mz[peptide[i]];
+    exp.transitions.push_back(tr);
+  }
+  OpenSwath::LightTransition orphan;
+  orphan.transition_name = "orphan";
+  orphan.peptide_ref = "unknown";
+  orphan.precursor_mz = 550.0;
+  exp.transitions.push_back(orphan);
+}
+
+LightTargetedExperimentIndex* ptr = nullptr;
+LightTargetedExperimentIndex* nullPointer = nullptr;
+
+START_SECTION(LightTargetedExperimentIndex(const OpenSwath::LightTargetedExperiment& experiment))
+{
+  ptr = new LightTargetedExperimentIndex(exp);
+  TEST_NOT_EQUAL(ptr, nullPointer)
+  TEST_EQUAL(&ptr->getExperiment() == &exp, true)
+}
+END_SECTION
+
+START_SECTION((SignedSize getCompoundIndex(const std::string& id) const))
+{
+  TEST_EQUAL(ptr->getCompoundIndex("pep0"), 0)
+  TEST_EQUAL(ptr->getCompoundIndex("pep3"), 3)
+  TEST_EQUAL(ptr->getCompoundIndex("unknown"), -1)
+}
+END_SECTION
+
+START_SECTION((SignedSize getProteinIndex(const std::string& id) const))
+{
+  TEST_EQUAL(ptr->getProteinIndex("prot2"), 1)
+  TEST_EQUAL(ptr->getProteinIndex("unknown"), -1)
+}
+END_SECTION
+
+START_SECTION((SignedSize getTransitionCompound(Size transition_index) const))
+{
+  TEST_EQUAL(ptr->getTransitionCompound(4), 3)
+  TEST_EQUAL(ptr->getTransitionCompound(7), -1)
+}
+END_SECTION
+
+START_SECTION((const std::vector<Size>& getCompoundTransitions(Size compound_index) const))
+{
+  TEST_EQUAL(ptr->getCompoundTransitions(0).size(), 2)
+  TEST_EQUAL(ptr->getCompoundTransitions(0)[0], 0)
+  TEST_EQUAL(ptr->getCompoundTransitions(0)[1], 3)
+  TEST_EQUAL(ptr->getCompoundTransitions(3).size(), 1)
+}
+END_SECTION
+
+START_SECTION((void selectTransitions(double lower, double upper, std::vector<Size>& result) const))
+{
+  std::vector<Size> result;
+  ptr->selectTransitions(420.0, 560.0, result);
+  // library order
+  TEST_EQUAL(result.size(), 4)
+  TEST_EQUAL(result[0], 0)
+  TEST_EQUAL(result[1], 3)
+  TEST_EQUAL(result[2], 4)
+  TEST_EQUAL(result[3], 7)
+
+  // open interval
+  result.clear();
+  ptr->selectTransitions(400.0, 500.0, result);
+  TEST_EQUAL(result.size(), 1)
+  TEST_EQUAL(result[0], 4)
+
+  result.clear();
+  ptr->selectTransitions(700.0, 800.0, result);
+  TEST_EQUAL(result.size(), 0)
+}
+END_SECTION
+
+START_SECTION((void selectTransitions(double lower, double upper, double rt_start, double rt_end, std::vector<Size>& result) const))
+{
+  std::vector<Size> result;
+  ptr->selectTransitions(420.0, 560.0, 5.0, 35.0, result);
+  TEST_EQUAL(result.size(), 2)
+  TEST_EQUAL(result[0], 0)
+  TEST_EQUAL(result[1], 3)
+}
+END_SECTION
+
+START_SECTION((void selectCompounds(double rt_start, double rt_end, std::vector<Size>& result) const))
+{
+  std::vector<Size> result;
+  ptr->selectCompounds(20.0, 40.0, result);
+  TEST_EQUAL(result.size(), 3)
+  TEST_EQUAL(result[0], 1)
+  TEST_EQUAL(result[1], 2)
+  TEST_EQUAL(result[2], 3)
+}
+END_SECTION
+
+START_SECTION((void selectCompoundTransitions(const std::vector<Size>& compound_indices, std::vector<Size>& result) const))
+{
+  std::vector<Size> compounds;
+  compounds.push_back(2);
+  compounds.push_back(0);
+  std::vector<Size> result;
+  ptr->selectCompoundTransitions(compounds, result);
+  TEST_EQUAL(result.size(), 4)
+  TEST_EQUAL(result[0], 0)
+  TEST_EQUAL(result[1], 2)
+  TEST_EQUAL(result[2], 3)
+  TEST_EQUAL(result[3], 6)
+}
+END_SECTION
+
+START_SECTION([EXTRA] OpenSwathHelper::selectSwathTransitions with index)
+{
+  // the index-based selection gives the same result as the linear scan
+  double windows[][2] = { {420.0, 560.0}, {300.0, 700.0}, {450.0, 500.0}, {700.0, 800.0} };
+  for (Size w = 0; w < 4; ++w)
+  {
+    OpenSwath::LightTargetedExperiment scan, indexed;
+    OpenSwathHelper::selectSwathTransitions(exp, scan, 1.0, windows[w][0], windows[w][1]);
+    OpenSwathHelper::selectSwathTransitions(*ptr, indexed, 1.0, windows[w][0], windows[w][1]);
+    TEST_EQUAL(indexed.transitions.size(), scan.transitions.size())
+    for (Size i = 0; i < scan.transitions.size(); ++i)
+    {
+      TEST_EQUAL(indexed.transitions[i].transition_name, scan.transitions[i].transition_name)
+    }
+    TEST_EQUAL(indexed.compounds.size(), scan.compounds.size())
+    for (Size i = 0; i < scan.compounds.size(); ++i)
+    {
+      TEST_EQUAL(indexed.compounds[i].id, scan.compounds[i].id)
+    }
+    TEST_EQUAL(indexed.proteins.size(), scan.proteins.size())
+    for (Size i = 0; i < scan.proteins.size(); ++i)
+    {
+      TEST_EQUAL(indexed.proteins[i].id, scan.proteins[i].id)
+    }
+  }
+}
+END_SECTION
+
+START_SECTION(~LightTargetedExperimentIndex())
+{
+  delete ptr;
+}
+END_SECTION
+
+/////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////
+END_TEST
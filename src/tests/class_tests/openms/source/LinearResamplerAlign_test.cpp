@@ -39,6 +39,7 @@
 #include <OpenMS/KERNEL/ChromatogramPeak.h>
 #include <OpenMS/KERNEL/MSSpectrum.h>
 #include <OpenMS/KERNEL/MSChromatogram.h>
+#include <OpenMS/KERNEL/MSExperiment.h>
 
 #include <OpenMS/FILTERING/TRANSFORMERS/LinearResamplerAlign.h>
 
@@ -573,6 +574,74 @@ START_SECTION([EXTRA] test_linear_res_align_input)
 }
 END_SECTION
 
+START_SECTION((template <typename MZIterator, typename IntensityIterator, typename OutputIterator> static void rasterUniform(MZIterator mz_raw_it, MZIterator mz_raw_end, IntensityIterator int_raw_it, double start_pos, double spacing, OutputIterator int_resample_it, OutputIterator int_resample_end)))
+{
+  std::vector<double> mz_data(5);
+  std::vector<double> int_data(5);
+  for (Size i = 0; i < input_spectrum.size(); ++i)
+  {
+    mz_data[i] = input_spectrum[i].getMZ();
+    int_data[i] = input_spectrum[i].getIntensity();
+  }
+
+  // resample at 0, 0.75, 1.5 and 2.25 (same as raster above)
+  std::vector<double> int_res_data(4, 0.0);
+  LinearResamplerAlign::rasterUniform(mz_data.begin(), mz_data.end(), int_data.begin(), 0.0, default_spacing,
+                                      int_res_data.begin(), int_res_data.end());
+  TEST_REAL_SIMILAR(int_res_data[0], 3+2);
+  TEST_REAL_SIMILAR(int_res_data[1], 4+2.0/3*8);
+  TEST_REAL_SIMILAR(int_res_data[2], 1.0/3*8+2+1.0/3);
+  TEST_REAL_SIMILAR(int_res_data[3], 2.0 / 3);
+
+  // intensities are added, data outside of the raster goes to the first / last point
+  LinearResamplerAlign::rasterUniform(mz_data.begin(), mz_data.end(), int_data.begin(), 0.5, 0.5,
+                                      int_res_data.begin(), int_res_data.begin() + 2);
+  TEST_REAL_SIMILAR(int_res_data[0], 3+2 + 3+6);
+  TEST_REAL_SIMILAR(int_res_data[1], 4+2.0/3*8 + 8+2+1);
+  TEST_REAL_SIMILAR(int_res_data[2], 1.0/3*8+2+1.0/3);
+
+  // the same as raster with an explicit raster
+  std::vector<double> mz_res_data(7);
+  std::vector<double> int_expected(7, 0.0);
+  for (Size i = 0; i < mz_res_data.size(); ++i)
+  {
+    mz_res_data[i] = -0.1 + i * 0.3;
+  }
+  LinearResamplerAlign lr;
+  lr.raster(mz_data.begin(), mz_data.end(), int_data.begin(), int_data.end(),
+    mz_res_data.begin(), mz_res_data.end(), int_expected.begin(), int_expected.end());
+  std::vector<double> int_uniform(7, 0.0);
+  LinearResamplerAlign::rasterUniform(mz_data.begin(), mz_data.end(), int_data.begin(), -0.1, 0.3,
+                                      int_uniform.begin(), int_uniform.end());
+  for (Size i = 0; i < int_expected.size(); ++i)
+  {
+    TEST_REAL_SIMILAR(int_uniform[i], int_expected[i])
+  }
+}
+END_SECTION
+
+START_SECTION((void rasterExperiment(PeakMap& exp, double start_pos, double end_pos)))
+{
+  PeakMap exp;
+  for (Size i = 0; i < 5; ++i)
+  {
+    exp.addSpectrum(input_spectrum);
+  }
+
+  LinearResamplerAlign lr;
+  Param param;
+  param.setValue("spacing", default_spacing);
+  lr.setParameters(param);
+  lr.rasterExperiment(exp, 0, 1.8);
+
+  TEST_EQUAL(exp.size(), 5)
+  for (Size i = 0; i < exp.size(); ++i)
+  {
+    check_results(exp[i]);
+  }
+}
+END_SECTION
+
 #endif
 
 /////////////////////////////////////////////////////////////
@@ -48,6 +48,8 @@
 
 #include <boost/regex.hpp>
 
+#include <algorithm>
+
 // OpenMP support
 #ifdef _OPENMP
 	#include <omp.h>
@@ -110,6 +112,66 @@ START_SECTION(([EXTRA] OpenMP - test))
 }
 END_SECTION
 
+START_SECTION(([EXTRA] OpenMP - lines of different threads are not mixed))
+{
+  ostringstream stream_by_logger;
+  {
+    LogStream l1(new LogStreamBuf());
+    l1.insert(stream_by_logger);
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
+    for (int i = 0; i < 10000; ++i)
+    {
+      l1 << "line " << i << "\n";
+      l1 << "line " << i << " again" << endl;
+    }
+  }
+  std::istringstream lines(stream_by_logger.str());
+  std::string line;
+  Size count(0), broken(0);
+  while (std::getline(lines, line))
+  {
+    ++count;
+    if (!String(line).hasPrefix("line ")) ++broken;
+  }
+  TEST_EQUAL(count, 20000)
+  TEST_EQUAL(broken, 0)
+}
+END_SECTION
+
+START_SECTION((void setAsynchronous(bool async)))
+{
+  ostringstream stream_by_logger;
+  LogStream l1(new LogStreamBuf());
+  l1.insert(stream_by_logger);
+  TEST_EQUAL(l1->isAsynchronous(), false)
+  l1.setAsynchronous(true);
+  TEST_EQUAL(l1->isAsynchronous(), true)
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
+  for (int i = 0; i < 1000; ++i)
+  {
+    l1 << "async " << i << endl;
+  }
+  // disabling writes all queued lines
+  l1.setAsynchronous(false);
+  TEST_EQUAL(l1->isAsynchronous(), false)
+  std::string written = stream_by_logger.str();
+  TEST_EQUAL(std::count(written.begin(), written.end(), '\n'), 1000)
+
+  // streams can be changed in asynchronous mode
+  l1.setAsynchronous(true);
+  ostringstream stream2;
+  l1.insert(stream2);
+  l1 << "to both" << endl;
+  l1.remove(stream2);
+  TEST_EQUAL(stream2.str(), "to both\n")
+  l1 << "pending" << endl;
+}
+END_SECTION
+
 LogStream* nullPointer = nullptr;
 
 START_SECTION(LogStream(LogStreamBuf *buf=0, bool delete_buf=true, std::ostream* stream))
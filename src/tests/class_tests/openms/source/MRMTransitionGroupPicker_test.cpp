@@ -497,6 +497,94 @@ START_SECTION((template < typename SpectrumT, typename TransitionT > void pickTr
 }
 END_SECTION
 
+START_SECTION((template < typename SpectrumT, typename TransitionT > void pickTransitionGroups(const std::vector< MRMTransitionGroup< SpectrumT, TransitionT > * > &transition_groups) const))
+{
+  MRMTransitionGroupPicker trgroup_picker;
+  Param picker_param = trgroup_picker.getDefaults();
+  picker_param.setValue("PeakPickerMRM:method", "legacy"); // old parameters
+  picker_param.setValue("PeakPickerMRM:peak_width", 40.0); // old parameters
+  trgroup_picker.setParameters(picker_param);
+
+  // reference: pick one group at a time
+  MRMTransitionGroupType reference;
+  setup_transition_group(reference);
+  trgroup_picker.pickTransitionGroup(reference);
+
+  std::vector<MRMTransitionGroupType> groups(5);
+  std::vector<MRMTransitionGroupType*> group_ptrs;
+  for (Size i = 0; i < groups.size(); ++i)
+  {
+    setup_transition_group(groups[i]);
+    group_ptrs.push_back(&groups[i]);
+  }
+  trgroup_picker.pickTransitionGroups(group_ptrs);
+
+  for (Size i = 0; i < groups.size(); ++i)
+  {
+    TEST_EQUAL(groups[i].getFeatures().size(), reference.getFeatures().size())
+    TEST_REAL_SIMILAR(groups[i].getFeatures()[0].getRT(), reference.getFeatures()[0].getRT())
+    TEST_REAL_SIMILAR(groups[i].getFeatures()[0].getIntensity(), reference.getFeatures()[0].getIntensity())
+    TEST_REAL_SIMILAR(groups[i].getFeatures()[0].getMetaValue("leftWidth"), reference.getFeatures()[0].getMetaValue("leftWidth"))
+    TEST_REAL_SIMILAR(groups[i].getFeatures()[0].getMetaValue("rightWidth"), reference.getFeatures()[0].getMetaValue("rightWidth"))
+  }
+
+  // empty input is fine
+  std::vector<MRMTransitionGroupType*> no_groups;
+  trgroup_picker.pickTransitionGroups(no_groups);
+}
+END_SECTION
+
+START_SECTION((template < typename SpectrumT, typename TransitionT > void resampleToCommonGrid(MRMTransitionGroup< SpectrumT, TransitionT > &transition_group) const))
+{
+  MRMTransitionGroupPicker trgroup_picker;
+  MRMTransitionGroupType transition_group;
+  setup_transition_group(transition_group);
+
+  double total_int_2 = 0.0, total_int_ms1 = 0.0;
+  for (Size i = 0; i < transition_group.getChromatograms()[1].size(); ++i) total_int_2 += transition_group.getChromatograms()[1][i].getIntensity();
+  for (Size i = 0; i < transition_group.getPrecursorChromatograms()[0].size(); ++i) total_int_ms1 += transition_group.getPrecursorChromatograms()[0][i].getIntensity();
+
+  trgroup_picker.resampleToCommonGrid(transition_group);
+
+  // both traces have 18 points, the first one provides the grid
+  const RichPeakChromatogram& grid = transition_group.getChromatograms()[0];
+  TEST_EQUAL(grid.size(), 18)
+  TEST_REAL_SIMILAR(grid[0].getRT(), 1474.34)
+  TEST_REAL_SIMILAR(grid[0].getIntensity(), 3.26958)
+
+  const RichPeakChromatogram& chrom_2 = transition_group.getChromatograms()[1];
+  const RichPeakChromatogram& ms1 = transition_group.getPrecursorChromatograms()[0];
+  TEST_EQUAL(chrom_2.size(), grid.size())
+  TEST_EQUAL(ms1.size(), grid.size())
+  TEST_EQUAL(chrom_2.getNativeID(), "2")
+  TEST_EQUAL(ms1.getNativeID(), "Precursor_i0")
+
+  double resampled_int_2 = 0.0, resampled_int_ms1 = 0.0;
+  for (Size i = 0; i < grid.size(); ++i)
+  {
+    TEST_REAL_SIMILAR(chrom_2[i].getRT(), grid[i].getRT())
+    TEST_REAL_SIMILAR(ms1[i].getRT(), grid[i].getRT())
+    resampled_int_2 += chrom_2[i].getIntensity();
+    resampled_int_ms1 += ms1[i].getIntensity();
+  }
+  // the resampling conserves the total intensity
+  TEST_REAL_SIMILAR(resampled_int_2, total_int_2)
+  TEST_REAL_SIMILAR(resampled_int_ms1, total_int_ms1)
+
+  // picking after resampling still finds the peak
+  Param picker_param = trgroup_picker.getDefaults();
+  picker_param.setValue("PeakPickerMRM:method", "legacy"); // old parameters
+  picker_param.setValue("PeakPickerMRM:peak_width", 40.0); // old parameters
+  picker_param.setValue("resample_to_common_grid", "true");
+  trgroup_picker.setParameters(picker_param);
+  MRMTransitionGroupType transition_group_2;
+  setup_transition_group(transition_group_2);
+  trgroup_picker.pickTransitionGroup(transition_group_2);
+  TEST_EQUAL(transition_group_2.getFeatures().size(), 1)
+  TEST_REAL_SIMILAR(transition_group_2.getChromatograms()[1][0].getRT(), 1474.34)
+}
+END_SECTION
+
 START_SECTION((template <typename SpectrumT, typename TransitionT> MRMFeature createMRMFeature(MRMTransitionGroup<SpectrumT, TransitionT>& transition_group, std::vector<SpectrumT>& picked_chroms, std::vector<SpectrumT>& smoothed_chroms, int& chr_idx, int& peak_idx)))
 {
   MRMTransitionGroupType transition_group;
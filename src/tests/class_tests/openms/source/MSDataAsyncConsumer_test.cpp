@@ -0,0 +1,200 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2018.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: Hannes Roest $
+// $Authors: Hannes Roest $
+// --------------------------------------------------------------------------
+
+#include <OpenMS/CONCEPT/ClassTest.h>
+#include <OpenMS/test_config.h>
+
+///////////////////////////
+#include <OpenMS/FORMAT/DATAACCESS/MSDataAsyncConsumer.h>
+///////////////////////////
+
+#include <OpenMS/FORMAT/DATAACCESS/MSDataStoringConsumer.h>
+#include <OpenMS/FORMAT/DATAACCESS/MSDataTransformingConsumer.h>
+#include <OpenMS/FORMAT/DATAACCESS/MSDataChainingConsumer.h>
+#include <OpenMS/KERNEL/MSSpectrum.h>
+#include <OpenMS/KERNEL/MSExperiment.h>
+
+using namespace OpenMS;
+
+START_TEST(MSDataAsyncConsumer, "$Id$")
+
+/////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////
+
+MSDataAsyncConsumer* ptr = nullptr;
+MSDataAsyncConsumer* nullPointer = nullptr;
+
+// some spectra and chromatograms with their index as RT
+PeakMap expc;
+for (Size i = 0; i < 200; ++i)
+{
+  MSSpectrum s;
+  s.setRT(i);
+  Peak1D p;
+  p.setMZ(100.0 + i);
+  p.setIntensity(1.0);
+  s.push_back(p);
+  expc.addSpectrum(s);
+}
+for (Size i = 0; i < 10; ++i)
+{
+  MSChromatogram c;
+  c.setNativeID(String("chrom_") + i);
+  ChromatogramPeak p;
+  p.setRT(i);
+  p.setIntensity(1.0);
+  c.push_back(p);
+  expc.addChromatogram(c);
+}
+
+START_SECTION((MSDataAsyncConsumer(Interfaces::IMSDataConsumer* consumer, Size max_queue_size = 0, int threads = 1)))
+{
+  MSDataStoringConsumer storing_consumer;
+  ptr = new MSDataAsyncConsumer(&storing_consumer);
+  TEST_NOT_EQUAL(ptr, nullPointer)
+  TEST_EQUAL(ptr->getMaxQueueSize() > 0, true)
+  delete ptr;
+
+  MSDataAsyncConsumer consumer(&storing_consumer, 5, 2);
+  TEST_EQUAL(consumer.getMaxQueueSize(), 5)
+}
+END_SECTION
+
+START_SECTION((~MSDataAsyncConsumer()))
+{
+  // destructor writes the remaining data
+  MSDataStoringConsumer storing_consumer;
+  {
+    MSDataAsyncConsumer consumer(&storing_consumer);
+    PeakMap exp = expc;
+    for (Size i = 0; i < exp.size(); ++i)
+    {
+      consumer.consumeSpectrum(exp.getSpectrum(i));
+    }
+  }
+  TEST_EQUAL(storing_consumer.getData().size(), 200)
+}
+END_SECTION
+
+START_SECTION((void consumeSpectrum(SpectrumType& s)))
+{
+  // a small queue: the caller has to wait for the writer, order is retained
+  MSDataStoringConsumer storing_consumer;
+  MSDataAsyncConsumer consumer(&storing_consumer, 3);
+  PeakMap exp = expc;
+  for (Size i = 0; i < exp.size(); ++i)
+  {
+    consumer.consumeSpectrum(exp.getSpectrum(i));
+  }
+  consumer.flush();
+  TEST_EQUAL(storing_consumer.getData().size(), 200)
+  bool in_order = true;
+  for (Size i = 0; i < storing_consumer.getData().size(); ++i)
+  {
+    in_order &= (storing_consumer.getData()[i].getRT() == double(i));
+  }
+  TEST_EQUAL(in_order, true)
+  // the input is not modified
+  TEST_EQUAL(exp.getSpectrum(0).size(), 1)
+}
+END_SECTION
+
+START_SECTION((void consumeChromatogram(ChromatogramType& c)))
+{
+  MSDataStoringConsumer storing_consumer;
+  MSDataAsyncConsumer consumer(&storing_consumer, 2);
+  PeakMap exp = expc;
+  consumer.consumeSpectrum(exp.getSpectrum(0));
+  for (Size i = 0; i < exp.getNrChromatograms(); ++i)
+  {
+    consumer.consumeChromatogram(exp.getChromatogram(i));
+  }
+  consumer.flush();
+  TEST_EQUAL(storing_consumer.getData().size(), 1)
+  TEST_EQUAL(storing_consumer.getData().getNrChromatograms(), 10)
+  TEST_EQUAL(storing_consumer.getData().getChromatograms()[9].getNativeID(), "chrom_9")
+}
+END_SECTION
+
+START_SECTION((void setExpectedSize(Size expectedSpectra, Size expectedChromatograms)))
+{
+  MSDataStoringConsumer storing_consumer;
+  MSDataAsyncConsumer consumer(&storing_consumer);
+  consumer.setExpectedSize(200, 10);
+  NOT_TESTABLE // only passed on
+}
+END_SECTION
+
+START_SECTION((void setExperimentalSettings(const ExperimentalSettings& exp)))
+{
+  MSDataStoringConsumer storing_consumer;
+  MSDataAsyncConsumer consumer(&storing_consumer);
+  ExperimentalSettings settings;
+  settings.setComment("async");
+  consumer.setExperimentalSettings(settings);
+  TEST_EQUAL(storing_consumer.getData().getComment(), "async")
+}
+END_SECTION
+
+START_SECTION((void flush()))
+{
+  // errors of the wrapped consumer are re-thrown in the calling thread
+  MSDataTransformingConsumer failing_consumer;
+  failing_consumer.setSpectraProcessingFunc([](MSSpectrum& s)
+    {
+      if (s.getRT() == 10.0) throw Exception::IllegalArgument(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "failing");
+    });
+  MSDataStoringConsumer storing_consumer;
+  std::vector<Interfaces::IMSDataConsumer*> stages;
+  stages.push_back(&failing_consumer);
+  stages.push_back(&storing_consumer);
+  MSDataChainingConsumer chain(stages);
+
+  MSDataAsyncConsumer consumer(&chain, 1000);
+  PeakMap exp = expc;
+  // the last spectrum fails (earlier calls cannot see the error yet)
+  for (Size i = 0; i <= 10; ++i)
+  {
+    consumer.consumeSpectrum(exp.getSpectrum(i));
+  }
+  TEST_EXCEPTION(Exception::IllegalArgument, consumer.flush())
+  TEST_EQUAL(storing_consumer.getData().size(), 10)
+  // the error is reported again, no further data is accepted
+  TEST_EXCEPTION(Exception::IllegalArgument, consumer.consumeSpectrum(exp.getSpectrum(0)))
+}
+END_SECTION
+
+/////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////
+END_TEST
@@ -0,0 +1,167 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2018.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: Hannes Roest $
+// $Authors: Hannes Roest $
+// --------------------------------------------------------------------------
+
+#include <OpenMS/CONCEPT/ClassTest.h>
+#include <OpenMS/test_config.h>
+
+///////////////////////////
+#include <OpenMS/FORMAT/DATAACCESS/MSDataBlockMergingConsumer.h>
+///////////////////////////
+
+#include <OpenMS/FORMAT/DATAACCESS/MSDataStoringConsumer.h>
+#include <OpenMS/FILTERING/TRANSFORMERS/SpectraMerger.h>
+#include <OpenMS/KERNEL/MSSpectrum.h>
+#include <OpenMS/KERNEL/MSExperiment.h>
+
+using namespace OpenMS;
+
+START_TEST(MSDataBlockMergingConsumer, "$Id$")
+
+/////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////
+
+MSDataBlockMergingConsumer* ptr = nullptr;
+MSDataBlockMergingConsumer* nullPointer = nullptr;
+
+// every third spectrum is an MS1 spectrum, the index is used as RT
+PeakMap expc;
+for (Size i = 0; i < 12; ++i)
+{
+  MSSpectrum s;
+  s.setRT(i);
+  s.setMSLevel(i % 3 == 0 ? 1 : 2);
+  s.setNativeID(String("spec_") + i);
+  Peak1D p;
+  p.setMZ(100.0);
+  p.setIntensity(1.0);
+  s.push_back(p);
+  p.setMZ(200.0 + i);
+  s.push_back(p);
+  expc.addSpectrum(s);
+}
+
+SpectraMerger merger;
+Param p = merger.getParameters();
+p.setValue("mz_binning_width", 0.01);
+p.setValue("mz_binning_width_unit", "Da");
+p.setValue("block_method:rt_block_size", 2);
+p.setValue("block_method:ms_levels", ListUtils::create<Int>("1"));
+merger.setParameters(p);
+
+START_SECTION((MSDataBlockMergingConsumer(Interfaces::IMSDataConsumer* next_consumer, const SpectraMerger& merger)))
+{
+  MSDataStoringConsumer storage;
+  ptr = new MSDataBlockMergingConsumer(&storage, merger);
+  TEST_NOT_EQUAL(ptr, nullPointer)
+  delete ptr;
+}
+END_SECTION
+
+START_SECTION((~MSDataBlockMergingConsumer()))
+{
+  // remaining blocks are passed on by the destructor
+  MSDataStoringConsumer storage;
+  {
+    MSDataBlockMergingConsumer merging_consumer(&storage, merger);
+    MSSpectrum s = expc[0];
+    merging_consumer.consumeSpectrum(s);
+    TEST_EQUAL(storage.getData().size(), 0)
+  }
+  TEST_EQUAL(storage.getData().size(), 1)
+}
+END_SECTION
+
+START_SECTION((void consumeSpectrum(SpectrumType& s)))
+{
+  MSDataStoringConsumer storage;
+  MSDataBlockMergingConsumer merging_consumer(&storage, merger);
+  for (Size i = 0; i < expc.size(); ++i)
+  {
+    MSSpectrum s = expc[i];
+    merging_consumer.consumeSpectrum(s);
+  }
+  merging_consumer.flush();
+
+  // MS1 spectra 0+3 and 6+9 are merged, MS2 spectra are kept in order
+  const PeakMap& res = storage.getData();
+  TEST_EQUAL(res.size(), 10)
+  ABORT_IF(res.size() != 10)
+  TEST_EQUAL(res[0].getNativeID(), "spec_0")
+  TEST_EQUAL(res[0].getMSLevel(), 1)
+  TEST_REAL_SIMILAR(res[0].getRT(), 1.5)
+  TEST_EQUAL(res[0].size(), 3)
+  TEST_REAL_SIMILAR(res[0][0].getIntensity(), 2.0)
+  TEST_EQUAL(res[1].getNativeID(), "spec_1")
+  TEST_EQUAL(res[2].getNativeID(), "spec_2")
+  TEST_EQUAL(res[3].getNativeID(), "spec_4")
+  TEST_EQUAL(res[4].getNativeID(), "spec_5")
+  TEST_EQUAL(res[5].getNativeID(), "spec_6")
+  TEST_REAL_SIMILAR(res[5].getRT(), 7.5)
+  TEST_EQUAL(res[6].getNativeID(), "spec_7")
+  TEST_EQUAL(res[9].getNativeID(), "spec_11")
+}
+END_SECTION
+
+START_SECTION((void consumeChromatogram(ChromatogramType& c)))
+{
+  MSDataStoringConsumer storage;
+  MSDataBlockMergingConsumer merging_consumer(&storage, merger);
+  MSChromatogram c;
+  merging_consumer.consumeChromatogram(c);
+  TEST_EQUAL(storage.getData().getNrChromatograms(), 1)
+}
+END_SECTION
+
+START_SECTION((void flush()))
+{
+  MSDataStoringConsumer storage;
+  MSDataBlockMergingConsumer merging_consumer(&storage, merger);
+  for (Size i = 0; i < 4; ++i)
+  {
+    MSSpectrum s = expc[i];
+    merging_consumer.consumeSpectrum(s);
+  }
+  // the first block is still open
+  TEST_EQUAL(storage.getData().size(), 0)
+  merging_consumer.flush();
+  TEST_EQUAL(storage.getData().size(), 3)
+  merging_consumer.flush();
+  TEST_EQUAL(storage.getData().size(), 3)
+}
+END_SECTION
+
+/////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////
+END_TEST
+
@@ -0,0 +1,247 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2018.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: Hannes Roest $
+// $Authors: Hannes Roest $
+// --------------------------------------------------------------------------
+
+
+#include <OpenMS/CONCEPT/ClassTest.h>
+#include <OpenMS/test_config.h>
+
+///////////////////////////
+#include <OpenMS/FORMAT/DATAACCESS/MSDataParallelTransformingConsumer.h>
+///////////////////////////
+
+#include <OpenMS/FORMAT/DATAACCESS/MSDataStoringConsumer.h>
+#include <OpenMS/KERNEL/MSSpectrum.h>
+#include <OpenMS/KERNEL/MSExperiment.h>
+
+using namespace OpenMS;
+
+START_TEST(MSDataParallelTransformingConsumer, "$Id$")
+
+/////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////
+
+MSDataParallelTransformingConsumer* ptr = nullptr;
+MSDataParallelTransformingConsumer* nullPointer = nullptr;
+
+// some spectra and chromatograms with their index as RT
+PeakMap expc;
+for (Size i = 0; i < 50; ++i)
+{
+  MSSpectrum s;
+  s.setRT(i);
+  Peak1D p;
+  p.setMZ(100.0 + i);
+  p.setIntensity(1.0);
+  s.push_back(p);
+  expc.addSpectrum(s);
+}
+for (Size i = 0; i < 10; ++i)
+{
+  MSChromatogram c;
+  c.setNativeID(String("chrom_") + i);
+  ChromatogramPeak p;
+  p.setRT(i);
+  p.setIntensity(1.0);
+  c.push_back(p);
+  expc.addChromatogram(c);
+}
+
+START_SECTION((MSDataParallelTransformingConsumer(Interfaces::IMSDataConsumer* next_consumer, Size batch_size = 0)))
+{
+  MSDataStoringConsumer storing_consumer;
+  ptr = new MSDataParallelTransformingConsumer(&storing_consumer);
+  TEST_NOT_EQUAL(ptr, nullPointer)
+  TEST_EQUAL(ptr->getBatchSize() > 0, true)
+  delete ptr;
+
+  MSDataParallelTransformingConsumer consumer(&storing_consumer, 7);
+  TEST_EQUAL(consumer.getBatchSize(), 7)
+}
+END_SECTION
+
+START_SECTION((~MSDataParallelTransformingConsumer()))
+{
+  // destructor flushes the remaining data
+  MSDataStoringConsumer storing_consumer;
+  {
+    MSDataParallelTransformingConsumer consumer(&storing_consumer, 100);
+    PeakMap exp = expc;
+    consumer.consumeSpectrum(exp.getSpectrum(0));
+    consumer.consumeSpectrum(exp.getSpectrum(1));
+    TEST_EQUAL(storing_consumer.getData().size(), 0)
+  }
+  TEST_EQUAL(storing_consumer.getData().size(), 2)
+}
+END_SECTION
+
+START_SECTION((void consumeSpectrum(SpectrumType& s)))
+{
+  for (Size batch_size = 1; batch_size <= 16; batch_size *= 2)
+  {
+    MSDataStoringConsumer storing_consumer;
+    MSDataParallelTransformingConsumer consumer(&storing_consumer, batch_size);
+    consumer.setSpectraProcessingFunc([](MSSpectrum& s)
+      {
+        s[0].setIntensity(s.getRT() * 2.0);
+      });
+
+    PeakMap exp = expc;
+    consumer.setExpectedSize(exp.size(), 0);
+    for (Size i = 0; i < exp.size(); ++i)
+    {
+      consumer.consumeSpectrum(exp.getSpectrum(i));
+    }
+    TEST_EQUAL(storing_consumer.getData().size() <= exp.size(), true)
+    consumer.flush();
+
+    // all spectra are transformed and arrive in their original order
+    const PeakMap& result = storing_consumer.getData();
+    TEST_EQUAL(result.size(), exp.size())
+    for (Size i = 0; i < result.size(); ++i)
+    {
+      TEST_REAL_SIMILAR(result[i].getRT(), i)
+      TEST_REAL_SIMILAR(result[i][0].getIntensity(), i * 2.0)
+    }
+  }
+}
+END_SECTION
+
+START_SECTION((void consumeChromatogram(ChromatogramType& c)))
+{
+  MSDataStoringConsumer storing_consumer;
+  MSDataParallelTransformingConsumer consumer(&storing_consumer, 3);
+  consumer.setChromatogramProcessingFunc([](MSChromatogram& c)
+    {
+      c[0].setIntensity(c[0].getRT() + 5.0);
+    });
+
+  PeakMap exp = expc;
+  for (Size i = 0; i < exp.getNrChromatograms(); ++i)
+  {
+    consumer.consumeChromatogram(exp.getChromatogram(i));
+  }
+  consumer.flush();
+
+  const PeakMap& result = storing_consumer.getData();
+  TEST_EQUAL(result.getNrChromatograms(), exp.getNrChromatograms())
+  for (Size i = 0; i < result.getNrChromatograms(); ++i)
+  {
+    TEST_EQUAL(result.getChromatograms()[i].getNativeID(), String("chrom_") + i)
+    TEST_REAL_SIMILAR(result.getChromatograms()[i][0].getIntensity(), i + 5.0)
+  }
+}
+END_SECTION
+
+START_SECTION((void setExpectedSize(Size expectedSpectra, Size expectedChromatograms)))
+{
+  NOT_TESTABLE // tested above
+}
+END_SECTION
+
+START_SECTION((void setExperimentalSettings(const ExperimentalSettings& exp)))
+{
+  MSDataStoringConsumer storing_consumer;
+  MSDataParallelTransformingConsumer consumer(&storing_consumer);
+  ExperimentalSettings s;
+  s.setComment("parallel");
+  consumer.setExperimentalSettings(s);
+  TEST_EQUAL(storing_consumer.getData().getComment(), "parallel")
+}
+END_SECTION
+
+START_SECTION((void setSpectraProcessingFunc(std::function<void (SpectrumType&)> f_spec)))
+{
+  // no function: data is passed on unchanged
+  MSDataStoringConsumer storing_consumer;
+  MSDataParallelTransformingConsumer consumer(&storing_consumer, 4);
+  PeakMap exp = expc;
+  for (Size i = 0; i < exp.size(); ++i)
+  {
+    consumer.consumeSpectrum(exp.getSpectrum(i));
+  }
+  consumer.flush();
+  TEST_EQUAL(storing_consumer.getData().size(), exp.size())
+  TEST_EQUAL(storing_consumer.getData()[10] == expc[10], true)
+}
+END_SECTION
+
+START_SECTION((void setChromatogramProcessingFunc(std::function<void (ChromatogramType&)> f_chrom)))
+{
+  NOT_TESTABLE // tested above
+}
+END_SECTION
+
+START_SECTION((void flush()))
+{
+  // interleaved spectra and chromatograms keep their relative order
+  MSDataStoringConsumer storing_consumer;
+  MSDataParallelTransformingConsumer consumer(&storing_consumer, 10);
+  PeakMap exp = expc;
+  consumer.consumeSpectrum(exp.getSpectrum(0));
+  consumer.consumeSpectrum(exp.getSpectrum(1));
+  TEST_EQUAL(storing_consumer.getData().size(), 0)
+  consumer.consumeChromatogram(exp.getChromatogram(0));
+  TEST_EQUAL(storing_consumer.getData().size(), 2)
+  TEST_EQUAL(storing_consumer.getData().getNrChromatograms(), 0)
+  consumer.consumeSpectrum(exp.getSpectrum(2));
+  TEST_EQUAL(storing_consumer.getData().getNrChromatograms(), 1)
+  consumer.flush();
+  TEST_EQUAL(storing_consumer.getData().size(), 3)
+
+  // exceptions thrown during processing are passed on
+  MSDataStoringConsumer storing_consumer2;
+  MSDataParallelTransformingConsumer consumer2(&storing_consumer2, 100);
+  consumer2.setSpectraProcessingFunc([](MSSpectrum& s)
+    {
+      if (s.getRT() > 20) throw Exception::InvalidValue(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "RT too large", String(s.getRT()));
+    });
+  for (Size i = 0; i < exp.size(); ++i)
+  {
+    consumer2.consumeSpectrum(exp.getSpectrum(i));
+  }
+  TEST_EXCEPTION(Exception::InvalidValue, consumer2.flush())
+  TEST_EQUAL(storing_consumer2.getData().size(), 0)
+  consumer2.flush(); // nothing left
+}
+END_SECTION
+
+START_SECTION((Size getBatchSize() const))
+{
+  NOT_TESTABLE // tested above
+}
+END_SECTION
+
+/////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////
+END_TEST
@@ -0,0 +1,259 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2018.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: Hannes Roest $
+// $Authors: Hannes Roest $
+// --------------------------------------------------------------------------
+
+#include <OpenMS/CONCEPT/ClassTest.h>
+#include <OpenMS/test_config.h>
+
+///////////////////////////
+#include <OpenMS/FORMAT/DATAACCESS/MSDataPipelineConsumer.h>
+///////////////////////////
+
+#include <OpenMS/FORMAT/DATAACCESS/MSDataStoringConsumer.h>
+#include <OpenMS/FORMAT/DATAACCESS/MSDataTransformingConsumer.h>
+#include <OpenMS/KERNEL/MSSpectrum.h>
+#include <OpenMS/KERNEL/MSExperiment.h>
+
+using namespace OpenMS;
+
+START_TEST(MSDataPipelineConsumer, "$Id$")
+
+/////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////
+
+MSDataPipelineConsumer* ptr = nullptr;
+MSDataPipelineConsumer* nullPointer = nullptr;
+
+// some spectra and chromatograms with their index as RT
+PeakMap expc;
+for (Size i = 0; i < 50; ++i)
+{
+  MSSpectrum s;
+  s.setRT(i);
+  Peak1D p;
+  p.setMZ(100.0 + i);
+  p.setIntensity(1.0);
+  s.push_back(p);
+  expc.addSpectrum(s);
+}
+for (Size i = 0; i < 10; ++i)
+{
+  MSChromatogram c;
+  c.setNativeID(String("chrom_") + i);
+  ChromatogramPeak p;
+  p.setRT(i);
+  p.setIntensity(1.0);
+  c.push_back(p);
+  expc.addChromatogram(c);
+}
+
+START_SECTION((MSDataPipelineConsumer(Size batch_size = 0)))
+{
+  ptr = new MSDataPipelineConsumer();
+  TEST_NOT_EQUAL(ptr, nullPointer)
+  TEST_EQUAL(ptr->getBatchSize() > 0, true)
+  TEST_EQUAL(ptr->getNumberOfStages(), 0)
+  delete ptr;
+
+  MSDataPipelineConsumer consumer(7);
+  TEST_EQUAL(consumer.getBatchSize(), 7)
+}
+END_SECTION
+
+START_SECTION((~MSDataPipelineConsumer()))
+{
+  // destructor flushes the remaining data
+  MSDataStoringConsumer storing_consumer;
+  {
+    MSDataPipelineConsumer consumer(100);
+    consumer.appendStage(&storing_consumer, false);
+    PeakMap exp = expc;
+    consumer.consumeSpectrum(exp.getSpectrum(0));
+    consumer.consumeSpectrum(exp.getSpectrum(1));
+    TEST_EQUAL(storing_consumer.getData().size(), 0)
+  }
+  TEST_EQUAL(storing_consumer.getData().size(), 2)
+}
+END_SECTION
+
+START_SECTION((void appendStage(Interfaces::IMSDataConsumer* consumer, bool parallel_safe)))
+{
+  MSDataStoringConsumer storing_consumer;
+  MSDataTransformingConsumer transforming_consumer;
+  MSDataPipelineConsumer consumer;
+  consumer.appendStage(&transforming_consumer, true);
+  consumer.appendStage(&storing_consumer, false);
+  TEST_EQUAL(consumer.getNumberOfStages(), 2)
+}
+END_SECTION
+
+START_SECTION((Size getNumberOfStages() const))
+{
+  NOT_TESTABLE // tested above
+}
+END_SECTION
+
+START_SECTION((void consumeSpectrum(SpectrumType& s)))
+{
+  for (Size batch_size = 1; batch_size <= 16; batch_size *= 2)
+  {
+    // parallel stages, a sequential stage relying on the order, another parallel stage and the sink
+    MSDataTransformingConsumer times_two, plus_one, running_index, minus_rt;
+    times_two.setSpectraProcessingFunc([](MSSpectrum& s) { s[0].setIntensity(s.getRT() * 2.0); });
+    plus_one.setSpectraProcessingFunc([](MSSpectrum& s) { s[0].setIntensity(s[0].getIntensity() + 1.0); });
+    Size counter = 0;
+    running_index.setSpectraProcessingFunc([&counter](MSSpectrum& s) { s.setMetaValue("index", counter++); });
+    minus_rt.setSpectraProcessingFunc([](MSSpectrum& s) { s[0].setMZ(s[0].getMZ() - s.getRT()); });
+    MSDataStoringConsumer storing_consumer;
+
+    MSDataPipelineConsumer consumer(batch_size);
+    consumer.appendStage(&times_two, true);
+    consumer.appendStage(&plus_one, true);
+    consumer.appendStage(&running_index, false);
+    consumer.appendStage(&minus_rt, true);
+    consumer.appendStage(&storing_consumer, false);
+
+    PeakMap exp = expc;
+    consumer.setExpectedSize(exp.size(), 0);
+    for (Size i = 0; i < exp.size(); ++i)
+    {
+      consumer.consumeSpectrum(exp.getSpectrum(i));
+    }
+    TEST_EQUAL(storing_consumer.getData().size() <= exp.size(), true)
+    consumer.flush();
+
+    // all stages are applied in order and the spectra arrive in their original order
+    const PeakMap& result = storing_consumer.getData();
+    TEST_EQUAL(result.size(), exp.size())
+    for (Size i = 0; i < result.size(); ++i)
+    {
+      TEST_REAL_SIMILAR(result[i].getRT(), i)
+      TEST_REAL_SIMILAR(result[i][0].getIntensity(), i * 2.0 + 1.0)
+      TEST_EQUAL(result[i].getMetaValue("index"), i)
+      TEST_REAL_SIMILAR(result[i][0].getMZ(), 100.0)
+    }
+  }
+}
+END_SECTION
+
+START_SECTION((void consumeChromatogram(ChromatogramType& c)))
+{
+  MSDataTransformingConsumer plus_five;
+  plus_five.setChromatogramProcessingFunc([](MSChromatogram& c) { c[0].setIntensity(c[0].getRT() + 5.0); });
+  MSDataStoringConsumer storing_consumer;
+  MSDataPipelineConsumer consumer(3);
+  consumer.appendStage(&plus_five, true);
+  consumer.appendStage(&storing_consumer, false);
+
+  PeakMap exp = expc;
+  for (Size i = 0; i < exp.getNrChromatograms(); ++i)
+  {
+    consumer.consumeChromatogram(exp.getChromatogram(i));
+  }
+  consumer.flush();
+
+  const PeakMap& result = storing_consumer.getData();
+  TEST_EQUAL(result.getNrChromatograms(), exp.getNrChromatograms())
+  for (Size i = 0; i < result.getNrChromatograms(); ++i)
+  {
+    TEST_EQUAL(result.getChromatograms()[i].getNativeID(), String("chrom_") + i)
+    TEST_REAL_SIMILAR(result.getChromatograms()[i][0].getIntensity(), i + 5.0)
+  }
+}
+END_SECTION
+
+START_SECTION((void setExpectedSize(Size expectedSpectra, Size expectedChromatograms)))
+{
+  NOT_TESTABLE // tested above
+}
+END_SECTION
+
+START_SECTION((void setExperimentalSettings(const ExperimentalSettings& exp)))
+{
+  MSDataStoringConsumer storing_consumer;
+  MSDataPipelineConsumer consumer;
+  consumer.appendStage(&storing_consumer, false);
+  ExperimentalSettings s;
+  s.setComment("pipeline");
+  consumer.setExperimentalSettings(s);
+  TEST_EQUAL(storing_consumer.getData().getComment(), "pipeline")
+}
+END_SECTION
+
+START_SECTION((void flush()))
+{
+  // interleaved spectra and chromatograms keep their relative order
+  MSDataStoringConsumer storing_consumer;
+  MSDataPipelineConsumer consumer(10);
+  consumer.appendStage(&storing_consumer, false);
+  PeakMap exp = expc;
+  consumer.consumeSpectrum(exp.getSpectrum(0));
+  consumer.consumeSpectrum(exp.getSpectrum(1));
+  TEST_EQUAL(storing_consumer.getData().size(), 0)
+  consumer.consumeChromatogram(exp.getChromatogram(0));
+  TEST_EQUAL(storing_consumer.getData().size(), 2)
+  TEST_EQUAL(storing_consumer.getData().getNrChromatograms(), 0)
+  consumer.consumeSpectrum(exp.getSpectrum(2));
+  TEST_EQUAL(storing_consumer.getData().getNrChromatograms(), 1)
+  consumer.flush();
+  TEST_EQUAL(storing_consumer.getData().size(), 3)
+
+  // exceptions thrown by parallel stages are passed on, the batch does not reach later stages
+  MSDataTransformingConsumer failing;
+  failing.setSpectraProcessingFunc([](MSSpectrum& s)
+    {
+      if (s.getRT() > 20) throw Exception::InvalidValue(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "RT too large", String(s.getRT()));
+    });
+  MSDataStoringConsumer storing_consumer2;
+  MSDataPipelineConsumer consumer2(100);
+  consumer2.appendStage(&failing, true);
+  consumer2.appendStage(&storing_consumer2, false);
+  for (Size i = 0; i < exp.size(); ++i)
+  {
+    consumer2.consumeSpectrum(exp.getSpectrum(i));
+  }
+  TEST_EXCEPTION(Exception::InvalidValue, consumer2.flush())
+  TEST_EQUAL(storing_consumer2.getData().size(), 0)
+  consumer2.flush(); // nothing left
+}
+END_SECTION
+
+START_SECTION((Size getBatchSize() const))
+{
+  NOT_TESTABLE // tested above
+}
+END_SECTION
+
+/////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////
+END_TEST
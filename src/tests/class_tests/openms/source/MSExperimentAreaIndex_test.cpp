@@ -0,0 +1,218 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2018.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: Timo Sachsenberg$
+// $Authors: Timo Sachsenberg $
+// --------------------------------------------------------------------------
+
+#include <OpenMS/CONCEPT/ClassTest.h>
+
+///////////////////////////
+#include <OpenMS/KERNEL/MSExperimentAreaIndex.h>
+///////////////////////////
+
+#include <OpenMS/KERNEL/MSExperiment.h>
+#include <OpenMS/KERNEL/Peak2D.h>
+
+using namespace OpenMS;
+using namespace std;
+
+// peaks visited by the area iterator
+void getAreaPeaks(const PeakMap& exp, double min_rt, double max_rt, double min_mz, double max_mz, vector<PeakIndex>& peaks)
+{
+  peaks.clear();
+  for (PeakMap::ConstAreaIterator it = exp.areaBeginConst(min_rt, max_rt, min_mz, max_mz); it != exp.areaEndConst(); ++it)
+  {
+    peaks.push_back(it.getPeakIndex());
+  }
+}
+
+START_TEST(MSExperimentAreaIndex, "$Id$")
+
+/////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////
+
+// 40 spectra (every fifth one is MS2), RT 10, 11, ...; 30 peaks each
+PeakMap exp;
+for (Size s = 0; s < 40; ++s)
+{
+  MSSpectrum spec;
+  spec.setRT(10.0 + s);
+  spec.setMSLevel(s % 5 == 4 ? 2 : 1);
+  for (Size p = 0; p < 30; ++p)
+  {
+    Peak1D peak;
+    peak.setMZ(100.0 + p * 1.7 + s * 0.01);
+    peak.setIntensity(1.0 + p + s * 10);
+    spec.push_back(peak);
+  }
+  exp.addSpectrum(spec);
+}
+
+MSExperimentAreaIndex* ptr = nullptr;
+MSExperimentAreaIndex* nullPointer = nullptr;
+START_SECTION(MSExperimentAreaIndex())
+{
+  ptr = new MSExperimentAreaIndex();
+  TEST_NOT_EQUAL(ptr, nullPointer)
+  TEST_EQUAL(ptr->size(), 0)
+  vector<PeakIndex> peaks;
+  ptr->getPeaks(0.0, 100.0, 0.0, 1000.0, peaks);
+  TEST_EQUAL(peaks.size(), 0)
+  TEST_EQUAL(ptr->getIntensitySum(0.0, 100.0, 0.0, 1000.0), 0.0)
+}
+END_SECTION
+
+START_SECTION(~MSExperimentAreaIndex())
+{
+  delete ptr;
+}
+END_SECTION
+
+START_SECTION((MSExperimentAreaIndex(const MSExperiment& exp, double mz_bin_width = 1.0, Size spectra_per_block = 32, UInt ms_level = 1)))
+{
+  MSExperimentAreaIndex index(exp, 2.5, 4);
+  TEST_EQUAL(index.getNumberOfSpectra(), 32)
+  TEST_EQUAL(index.size(), 32 * 30)
+
+  MSExperimentAreaIndex all(exp, 2.5, 4, 0);
+  TEST_EQUAL(all.getNumberOfSpectra(), 40)
+  TEST_EQUAL(all.size(), 40 * 30)
+
+  TEST_EXCEPTION(Exception::IllegalArgument, MSExperimentAreaIndex(exp, 0.0))
+  TEST_EXCEPTION(Exception::IllegalArgument, MSExperimentAreaIndex(exp, 1.0, 0))
+
+  PeakMap unsorted = exp;
+  unsorted[3].setRT(1.0);
+  TEST_EXCEPTION(Exception::IllegalArgument, MSExperimentAreaIndex(unsorted))
+}
+END_SECTION
+
+START_SECTION((void getPeaks(double min_rt, double max_rt, double min_mz, double max_mz, std::vector<PeakIndex>& peaks) const))
+{
+  MSExperimentAreaIndex index(exp, 2.5, 4);
+  vector<PeakIndex> peaks, expected;
+
+  // areas covering tile borders, single bins, the whole map and nothing
+  double areas[][4] =
+  {
+    {12.0, 20.0, 105.0, 112.3},
+    {10.5, 11.5, 100.0, 100.5},
+    {0.0, 100.0, 0.0, 1000.0},
+    {13.0, 13.0, 103.4, 103.45},
+    {22.0, 37.5, 140.0, 140.0},
+    {30.0, 20.0, 100.0, 200.0},
+    {20.0, 30.0, 200.0, 100.0},
+    {100.0, 200.0, 100.0, 200.0},
+    {10.0, 49.0, 300.0, 400.0}
+  };
+  for (Size i = 0; i < sizeof(areas) / sizeof(areas[0]); ++i)
+  {
+    index.getPeaks(areas[i][0], areas[i][1], areas[i][2], areas[i][3], peaks);
+    if (areas[i][0] <= areas[i][1] && areas[i][2] <= areas[i][3])
+    {
+      getAreaPeaks(exp, areas[i][0], areas[i][1], areas[i][2], areas[i][3], expected);
+    }
+    else
+    {
+      expected.clear();
+    }
+    TEST_EQUAL(peaks.size(), expected.size())
+    TEST_EQUAL(peaks == expected, true)
+  }
+
+  index.getPeaks(0.0, 100.0, 0.0, 1000.0, peaks);
+  TEST_EQUAL(peaks.size(), 32 * 30)
+
+  // all MS levels
+  MSExperimentAreaIndex all(exp, 2.5, 4, 0);
+  all.getPeaks(14.0, 14.0, 0.0, 1000.0, peaks);
+  TEST_EQUAL(peaks.size(), 30)
+  TEST_EQUAL(peaks[0].spectrum, 4)
+  TEST_EQUAL(peaks[29].peak, 29)
+}
+END_SECTION
+
+START_SECTION((double getIntensitySum(double min_rt, double max_rt, double min_mz, double max_mz) const))
+{
+  MSExperimentAreaIndex index(exp, 2.5, 4);
+  double expected = 0.0;
+  for (PeakMap::ConstAreaIterator it = exp.areaBeginConst(12.0, 27.0, 105.0, 130.0); it != exp.areaEndConst(); ++it)
+  {
+    expected += it->getIntensity();
+  }
+  TEST_REAL_SIMILAR(index.getIntensitySum(12.0, 27.0, 105.0, 130.0), expected)
+  TEST_EQUAL(index.getIntensitySum(12.0, 27.0, 300.0, 400.0), 0.0)
+}
+END_SECTION
+
+START_SECTION((void getPeaks(const std::vector<AreaType>& areas, std::vector<std::vector<PeakIndex> >& peaks) const))
+{
+  MSExperimentAreaIndex index(exp, 2.5, 4);
+  vector<MSExperimentAreaIndex::AreaType> areas;
+  for (Size i = 0; i < 50; ++i)
+  {
+    areas.push_back(MSExperimentAreaIndex::AreaType(10.0 + i * 0.6, 100.0 + i, 14.0 + i * 0.6, 103.0 + i));
+  }
+  vector<vector<PeakIndex> > peaks;
+  index.getPeaks(areas, peaks);
+  TEST_EQUAL(peaks.size(), areas.size())
+  vector<PeakIndex> expected;
+  for (Size i = 0; i < areas.size(); ++i)
+  {
+    getAreaPeaks(exp, areas[i].minPosition()[Peak2D::RT], areas[i].maxPosition()[Peak2D::RT],
+                 areas[i].minPosition()[Peak2D::MZ], areas[i].maxPosition()[Peak2D::MZ], expected);
+    TEST_EQUAL(peaks[i] == expected, true)
+  }
+}
+END_SECTION
+
+START_SECTION((void getIntensitySums(const std::vector<AreaType>& areas, std::vector<double>& sums) const))
+{
+  MSExperimentAreaIndex index(exp, 2.5, 4);
+  vector<MSExperimentAreaIndex::AreaType> areas;
+  for (Size i = 0; i < 50; ++i)
+  {
+    areas.push_back(MSExperimentAreaIndex::AreaType(10.0 + i * 0.6, 100.0 + i, 14.0 + i * 0.6, 103.0 + i));
+  }
+  vector<double> sums;
+  index.getIntensitySums(areas, sums);
+  TEST_EQUAL(sums.size(), areas.size())
+  for (Size i = 0; i < areas.size(); ++i)
+  {
+    TEST_REAL_SIMILAR(sums[i], index.getIntensitySum(areas[i].minPosition()[Peak2D::RT], areas[i].maxPosition()[Peak2D::RT],
+                                                     areas[i].minPosition()[Peak2D::MZ], areas[i].maxPosition()[Peak2D::MZ]))
+  }
+}
+END_SECTION
+
+/////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////
+END_TEST
@@ -319,6 +319,81 @@ START_SECTION((template <bool add_mass_traces, class Container> void set2DData(c
 
 END_SECTION
 
+START_SECTION((void getPeakArrays(std::vector<double>& mz, std::vector<float>& intensity, std::vector<Size>& offsets) const))
+{
+  PeakMap exp;
+  exp.resize(3);
+  exp[0].push_back(Peak1D(100.0, 1.0f));
+  exp[0].push_back(Peak1D(200.0, 2.0f));
+  exp[2].push_back(Peak1D(300.0, 3.0f));
+  std::vector<double> mz;
+  std::vector<float> intensity;
+  std::vector<Size> offsets;
+  exp.getPeakArrays(mz, intensity, offsets);
+  TEST_EQUAL(offsets.size(), 4)
+  TEST_EQUAL(offsets[0], 0)
+  TEST_EQUAL(offsets[1], 2)
+  TEST_EQUAL(offsets[2], 2)
+  TEST_EQUAL(offsets[3], 3)
+  TEST_EQUAL(mz.size(), 3)
+  TEST_REAL_SIMILAR(mz[1], 200.0)
+  TEST_REAL_SIMILAR(mz[2], 300.0)
+  TEST_REAL_SIMILAR(intensity[0], 1.0)
+  TEST_REAL_SIMILAR(intensity[2], 3.0)
+
+  PeakMap empty;
+  empty.getPeakArrays(mz, intensity, offsets);
+  TEST_EQUAL(offsets.size(), 1)
+  TEST_EQUAL(mz.size(), 0)
+}
+END_SECTION
+
+START_SECTION((void setPeakArrays(const std::vector<double>& mz, const std::vector<float>& intensity, const std::vector<Size>& offsets)))
+{
+  PeakMap exp;
+  exp.resize(2);
+  exp[0].setRT(5.0);
+  exp[0].push_back(Peak1D(100.0, 1.0f));
+  exp[0].getFloatDataArrays().resize(1);
+  exp[0].getFloatDataArrays()[0].push_back(0.5f);
+  exp[1].push_back(Peak1D(110.0, 1.0f));
+  exp[1].getFloatDataArrays().resize(1);
+  exp[1].getFloatDataArrays()[0].push_back(0.5f);
+
+  std::vector<double> mz = {10.0, 20.0, 30.0};
+  std::vector<float> intensity = {4.0f, 5.0f, 6.0f};
+  std::vector<Size> offsets = {0, 1, 3};
+  exp.setPeakArrays(mz, intensity, offsets);
+  TEST_EQUAL(exp[0].size(), 1)
+  TEST_EQUAL(exp[1].size(), 2)
+  TEST_REAL_SIMILAR(exp[0].getRT(), 5.0)
+  TEST_REAL_SIMILAR(exp[0][0].getMZ(), 10.0)
+  TEST_REAL_SIMILAR(exp[1][1].getMZ(), 30.0)
+  TEST_REAL_SIMILAR(exp[1][1].getIntensity(), 6.0)
+  // data arrays are kept only if the number of peaks did not change
+  TEST_EQUAL(exp[0].getFloatDataArrays().size(), 1)
+  TEST_EQUAL(exp[1].getFloatDataArrays().size(), 0)
+
+  // round trip
+  std::vector<double> mz_out;
+  std::vector<float> intensity_out;
+  std::vector<Size> offsets_out;
+  exp.getPeakArrays(mz_out, intensity_out, offsets_out);
+  TEST_EQUAL(mz_out == mz, true)
+  TEST_EQUAL(intensity_out == intensity, true)
+  TEST_EQUAL(offsets_out == offsets, true)
+
+  std::vector<Size> wrong_count = {0, 3};
+  TEST_EXCEPTION(Exception::InvalidParameter, exp.setPeakArrays(mz, intensity, wrong_count))
+  std::vector<Size> wrong_end = {0, 1, 2};
+  TEST_EXCEPTION(Exception::InvalidParameter, exp.setPeakArrays(mz, intensity, wrong_end))
+  std::vector<Size> decreasing = {0, 4, 3};
+  TEST_EXCEPTION(Exception::InvalidParameter, exp.setPeakArrays(mz, intensity, decreasing))
+  std::vector<float> short_intensity = {4.0f};
+  TEST_EXCEPTION(Exception::InvalidParameter, exp.setPeakArrays(mz, short_intensity, offsets))
+}
+END_SECTION
+
 START_SECTION(([EXTRA] PeakMap()))
 	PeakMap tmp;
 	tmp.resize(1);
@@ -569,6 +644,51 @@ START_SECTION((void updateRanges(Int ms_level)))
 
 END_SECTION
 
+START_SECTION((void updateRanges(const std::vector<Size>& modified_spectra, Int ms_level = -1)))
+	PeakMap tmp;
+	MSSpectrum s;
+	Peak1D p;
+
+	for (Size i = 0; i < 3; ++i)
+	{
+		s.clear(true);
+		s.setMSLevel(1);
+		s.setRT(10.0 * (i + 1));
+		p.getPosition()[0] = 100.0 + i;
+		p.setIntensity(1.0f + i);
+		s.push_back(p);
+		tmp.addSpectrum(s);
+	}
+	tmp.updateRanges();
+	TEST_REAL_SIMILAR(tmp.getMaxMZ(), 102.0)
+
+	// extend the second spectrum, only that one is recomputed
+	p.getPosition()[0] = 500.0;
+	p.setIntensity(50.0f);
+	tmp[1].push_back(p);
+	tmp.updateRanges(std::vector<Size>(1, 1));
+	TEST_REAL_SIMILAR(tmp.getMinMZ(), 100.0)
+	TEST_REAL_SIMILAR(tmp.getMaxMZ(), 500.0)
+	TEST_REAL_SIMILAR(tmp.getMinInt(), 1.0)
+	TEST_REAL_SIMILAR(tmp.getMaxInt(), 50.0)
+	TEST_REAL_SIMILAR(tmp.getMinRT(), 10.0)
+	TEST_REAL_SIMILAR(tmp.getMaxRT(), 30.0)
+	TEST_EQUAL(tmp.getSize(), 4)
+
+	// shrink it again: the result equals a full update
+	tmp[1].pop_back();
+	tmp.updateRanges(std::vector<Size>(1, 1));
+	TEST_REAL_SIMILAR(tmp.getMaxMZ(), 102.0)
+	TEST_REAL_SIMILAR(tmp.getMaxInt(), 3.0)
+	TEST_EQUAL(tmp.getSize(), 3)
+	PeakMap full = tmp;
+	full.updateRanges();
+	TEST_REAL_SIMILAR(tmp.getMinMZ(), full.getMinMZ())
+	TEST_REAL_SIMILAR(tmp.getMaxMZ(), full.getMaxMZ())
+
+	TEST_EXCEPTION(Exception::IndexOverflow, tmp.updateRanges(std::vector<Size>(1, 3)))
+END_SECTION
+
 START_SECTION((ConstAreaIterator areaEndConst() const))
 NOT_TESTABLE
 END_SECTION
@@ -789,6 +909,37 @@ START_SECTION((void sortSpectra(bool sort_mz = true)))
 	TEST_REAL_SIMILAR(exp[1][1].getMZ(),14.0);
 END_SECTION
 
+START_SECTION(Size shareSpectrumMetaData())
+{
+  PeakMap exp;
+  exp.resize(4);
+  exp[0].setMSLevel(1);
+  exp[1].setMSLevel(2);
+  exp[2].setMSLevel(1);
+  exp[3].setMSLevel(2);
+  for (Size i = 0; i < exp.size(); ++i)
+  {
+    exp[i].getInstrumentSettings().setPolarity(IonSource::POSITIVE);
+    exp[i].getAcquisitionInfo().setMethodOfCombination(String("acq") + exp[i].getMSLevel());
+  }
+  PeakMap copy = exp;
+
+  TEST_EQUAL(exp.shareSpectrumMetaData(), 3)
+  TEST_EQUAL(exp == copy, true)
+
+  const PeakMap& cexp = exp;
+  TEST_EQUAL(&cexp[0].getInstrumentSettings() == &cexp[3].getInstrumentSettings(), true)
+  // acquisition info is only shared within the same MS level
+  TEST_EQUAL(&cexp[0].getAcquisitionInfo() == &cexp[2].getAcquisitionInfo(), true)
+  TEST_EQUAL(&cexp[1].getAcquisitionInfo() == &cexp[3].getAcquisitionInfo(), true)
+  TEST_EQUAL(&cexp[0].getAcquisitionInfo() == &cexp[1].getAcquisitionInfo(), false)
+
+  // modifications remain local to one spectrum
+  exp[3].getAcquisitionInfo().setMethodOfCombination("modified");
+  TEST_EQUAL(exp[1].getAcquisitionInfo().getMethodOfCombination(), "acq2")
+}
+END_SECTION
+
 START_SECTION(bool isSorted(bool check_mz = true ) const)
 	//make test dataset
 	PeakMap exp;
@@ -1032,6 +1183,39 @@ START_SECTION((void setChromatograms(const std::vector< MSChromatogram > &chroma
 	TEST_EQUAL(exp.getChromatograms()[1] == chrom2, true)
 END_SECTION
 
+START_SECTION((void setChromatograms(std::vector< MSChromatogram > &&chromatograms)))
+	PeakMap exp;
+	MSChromatogram chrom1, chrom2;
+	ChromatogramPeak p1;
+	p1.setRT(0.1);
+	p1.setIntensity(10.0f);
+	chrom1.push_back(p1);
+	chrom1.setNativeID("chrom1");
+	chrom2.setNativeID("chrom2");
+	vector<MSChromatogram > chroms;
+	chroms.push_back(chrom1);
+	chroms.push_back(chrom2);
+	exp.setChromatograms(std::move(chroms));
+	TEST_EQUAL(exp.getChromatograms().size(), 2)
+	TEST_EQUAL(exp.getChromatograms()[0] == chrom1, true)
+	TEST_EQUAL(exp.getChromatograms()[1] == chrom2, true)
+END_SECTION
+
+START_SECTION((void setSpectra(std::vector< MSSpectrum > &&spectra)))
+	PeakMap exp;
+	MSSpectrum spec1, spec2;
+	spec1.push_back(Peak1D(100.0, 1.0f));
+	spec1.setRT(1.0);
+	spec2.setRT(2.0);
+	vector<MSSpectrum> spectra;
+	spectra.push_back(spec1);
+	spectra.push_back(spec2);
+	exp.setSpectra(std::move(spectra));
+	TEST_EQUAL(exp.size(), 2)
+	TEST_EQUAL(exp[0] == spec1, true)
+	TEST_EQUAL(exp[1] == spec2, true)
+END_SECTION
+
 START_SECTION((void addChromatogram(const MSChromatogram &chromatogram)))
   PeakMap exp;
   MSChromatogram chrom1, chrom2;
@@ -399,6 +399,64 @@ START_SECTION([EXTRA] test_large_SLOF)
 }
 END_SECTION
 
+START_SECTION([EXTRA] test_LINEAR_all_int_sizes)
+{
+  // second differences of all encoded lengths (1 to 9 half bytes), positive
+  // and negative, such that the data ends on every half-byte position
+  std::vector<double> in;
+  in.push_back(1000000.0);
+  in.push_back(1000000.0);
+  double slope = 0;
+  for (Size i = 0; i < 200; ++i)
+  {
+    double diff = std::pow(16.0, (double)((i / 2) % 8)) * (1 + (i / 2) % 3);
+    slope += (i % 2 == 0) ? diff : -diff;
+    in.push_back(in.back() + slope);
+  }
+
+  MSNumpressCoder::NumpressConfig config;
+  config.np_compression = MSNumpressCoder::LINEAR;
+  config.estimate_fixed_point = false;
+  config.numpressFixedPoint = 1.0; // integers are encoded without loss
+
+  for (Size size = 3; size <= in.size(); size += 17)
+  {
+    std::vector<double> part(in.begin(), in.begin() + size);
+    String base64_string;
+    std::vector<double> result;
+    MSNumpressCoder().encodeNP(part, base64_string, false, config);
+    MSNumpressCoder().decodeNP(base64_string, result, false, config);
+    TEST_EQUAL(result == part, true)
+  }
+}
+END_SECTION
+
+START_SECTION([EXTRA] test_large_LINEAR_mass_accuracy)
+{
+  std::vector< double > in = setup_test_vec2();
+  String base64_string;
+  std::vector<double> result;
+
+  MSNumpressCoder::NumpressConfig config;
+  config.np_compression = MSNumpressCoder::LINEAR;
+  config.estimate_fixed_point = true;
+  config.linear_fp_mass_acc = 1e-4; // achievable: fixed point of 5000
+
+  MSNumpressCoder().encodeNP(in, base64_string, false, config);
+  MSNumpressCoder().decodeNP(base64_string, result, false, config);
+  TEST_EQUAL(result.size(), 100)
+  TEST_EQUAL(check_vec2_abs(result, 2e-4), true)
+
+  // not achievable: falls back to the maximal fixed point (same as without mass accuracy)
+  String base64_string_max;
+  config.linear_fp_mass_acc = 1e-20;
+  MSNumpressCoder().encodeNP(in, base64_string, false, config);
+  config.linear_fp_mass_acc = -1;
+  MSNumpressCoder().encodeNP(in, base64_string_max, false, config);
+  TEST_EQUAL(base64_string, base64_string_max)
+}
+END_SECTION
+
 /////////////////////////////////////////////////////////////
 /////////////////////////////////////////////////////////////
 END_TEST
@@ -38,6 +38,7 @@
 #include <OpenMS/ANALYSIS/MAPMATCHING/MapAlignmentAlgorithmPoseClustering.h>
 #include <OpenMS/ANALYSIS/MAPMATCHING/TransformationModelLinear.h>
 #include <OpenMS/FORMAT/MzMLFile.h>
+#include <OpenMS/KERNEL/ConversionHelper.h>
 
 #include <OpenMS/CONCEPT/Factory.h>
 
@@ -111,6 +112,41 @@ START_SECTION((void align(const ConsensusMap& map, TransformationDescription& tr
 }
 END_SECTION
 
+START_SECTION((void align(const std::vector<FeatureMap>& maps, std::vector<TransformationDescription>& trafos)))
+{
+  MzMLFile f;
+  std::vector<PeakMap > peak_maps(2);
+  f.load(OPENMS_GET_TEST_DATA_PATH("MapAlignmentAlgorithmPoseClustering_in1.mzML.gz"), peak_maps[0]);
+  f.load(OPENMS_GET_TEST_DATA_PATH("MapAlignmentAlgorithmPoseClustering_in2.mzML.gz"), peak_maps[1]);
+
+  // the batch variant must give the same result as aligning the maps one by one
+  std::vector<ConsensusMap> maps(3);
+  MapConversion::convert(0, peak_maps[1], maps[0], 400);
+  MapConversion::convert(0, peak_maps[0], maps[1], 400);
+  MapConversion::convert(0, peak_maps[1], maps[2], 200);
+
+  MapAlignmentAlgorithmPoseClustering aligner;
+  aligner.setReference(peak_maps[0]);
+
+  std::vector<TransformationDescription> trafos;
+  aligner.align(maps, trafos);
+  TEST_EQUAL(trafos.size(), 3);
+  for (Size i = 0; i < maps.size(); ++i)
+  {
+    TransformationDescription single;
+    aligner.align(maps[i], single);
+    TEST_EQUAL(trafos[i].getModelType(), single.getModelType());
+    TEST_EQUAL(trafos[i].getDataPoints().size(), single.getDataPoints().size());
+    TEST_REAL_SIMILAR(trafos[i].apply(100.0), single.apply(100.0));
+    TEST_REAL_SIMILAR(trafos[i].apply(1000.0), single.apply(1000.0));
+  }
+
+  std::vector<ConsensusMap> no_maps;
+  aligner.align(no_maps, trafos);
+  TEST_EQUAL(trafos.size(), 0);
+}
+END_SECTION
+
 /////////////////////////////////////////////////////////////
 /////////////////////////////////////////////////////////////
 END_TEST
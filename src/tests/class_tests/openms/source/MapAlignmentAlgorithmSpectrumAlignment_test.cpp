@@ -126,6 +126,36 @@ START_SECTION((virtual void align(std::vector<PeakMap >&, std::vector<Transforma
 }
 END_SECTION
 
+START_SECTION(([EXTRA] align with a larger band))
+{
+  // distinct spectra, only the spectra with the same index are similar
+  MapAlignmentAlgorithmSpectrumAlignment ma;
+  std::vector<PeakMap > maps(2);
+  for (UInt i = 0; i < 80; ++i)
+  {
+    PeakSpectrum spectrum;
+    spectrum.setMSLevel(1);
+    for (float mz = 500.0; mz <= 900; mz += 100.0)
+    {
+      spectrum.push_back(Peak1D(mz + 2 * i, mz + i));
+    }
+    spectrum.setRT(i);
+    maps[0].addSpectrum(spectrum);
+    spectrum.setRT(i * 1.2 + 200);
+    maps[1].addSpectrum(spectrum);
+  }
+  std::vector<TransformationDescription> transformations;
+  ma.align(maps, transformations);
+  TEST_EQUAL(transformations.size(), 2)
+  const TransformationDescription::DataPoints& data = transformations[1].getDataPoints();
+  TEST_EQUAL(data.empty(), false)
+  for (Size i = 0; i < data.size(); ++i)
+  {
+    TEST_REAL_SIMILAR((data[i].first - 200) / 1.2, data[i].second)
+  }
+}
+END_SECTION
+
 /////////////////////////////////////////////////////////////
 /////////////////////////////////////////////////////////////
 END_TEST
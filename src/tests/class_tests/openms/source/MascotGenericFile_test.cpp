@@ -42,6 +42,8 @@
 
 #include <OpenMS/KERNEL/MSSpectrum.h>
 #include <OpenMS/KERNEL/MSExperiment.h>
+#include <OpenMS/FORMAT/DATAACCESS/MSDataStoringConsumer.h>
+#include <fstream>
 
 using namespace OpenMS;
 using namespace std;
@@ -78,6 +80,103 @@ START_SECTION((template < typename MapType > void load(const String &filename, M
 }
 END_SECTION
 
+START_SECTION([EXTRA] load with several spectra)
+{
+  String tmp_name;
+  NEW_TMP_FILE(tmp_name)
+  ofstream out(tmp_name.c_str());
+  out << "COM=header\n"
+         "BEGIN IONS\n"
+         "TITLE=first\n"
+         "PEPMASS=500.5 1000\n"
+         "CHARGE=2+\n"
+         "RTINSECONDS=60.5\n"
+         "100.5 10\n"
+         "200.25\t20\n"
+         "300  30 1\r\n"
+         "END IONS\n"
+         "\n"
+         " BEGIN IONS\r\n"
+         "PEPMASS=600.5\n"
+         "400 40\n"
+         "END IONS";
+  out.close();
+
+  PeakMap exp;
+  MascotGenericFile().load(tmp_name, exp);
+  TEST_EQUAL(exp.size(), 2)
+  ABORT_IF(exp.size() != 2)
+  TEST_EQUAL(exp[0].getNativeID(), "index=0")
+  TEST_EQUAL(exp[0].getMSLevel(), 2)
+  TEST_EQUAL(String(exp[0].getMetaValue("TITLE")), "first")
+  TEST_REAL_SIMILAR(exp[0].getRT(), 60.5)
+  TEST_REAL_SIMILAR(exp[0].getPrecursors()[0].getMZ(), 500.5)
+  TEST_REAL_SIMILAR(exp[0].getPrecursors()[0].getIntensity(), 1000.0)
+  TEST_EQUAL(exp[0].getPrecursors()[0].getCharge(), 2)
+  TEST_EQUAL(exp[0].size(), 3)
+  TEST_REAL_SIMILAR(exp[0][1].getMZ(), 200.25)
+  TEST_REAL_SIMILAR(exp[0][2].getIntensity(), 30.0)
+
+  // values not given for the second spectrum are carried over from the first
+  TEST_EQUAL(exp[1].getNativeID(), "index=1")
+  TEST_EQUAL(exp[1].metaValueExists("TITLE"), false)
+  TEST_REAL_SIMILAR(exp[1].getPrecursors()[0].getMZ(), 600.5)
+  TEST_REAL_SIMILAR(exp[1].getPrecursors()[0].getIntensity(), 1000.0)
+  TEST_EQUAL(exp[1].getPrecursors()[0].getCharge(), 2)
+  TEST_REAL_SIMILAR(exp[1].getRT(), 60.5)
+  TEST_EQUAL(exp[1].size(), 1)
+
+  // parse errors report the line number
+  out.open(tmp_name.c_str());
+  out << "BEGIN IONS\n100 10\nEND IONS\nBEGIN IONS\nPEPMASS=500\n100 abc\nEND IONS\n";
+  out.close();
+  TEST_EXCEPTION_WITH_MESSAGE(Exception::ParseError, MascotGenericFile().load(tmp_name, exp), " in: The content '100 abc' at line #6 could not be converted to a number! Expected two (m/z int) or three (m/z int charge) numbers separated by whitespace (space or tab).")
+
+  out.open(tmp_name.c_str());
+  out << "BEGIN IONS\n100 10\n";
+  out.close();
+  TEST_EXCEPTION(Exception::ParseError, MascotGenericFile().load(tmp_name, exp))
+
+  // empty file
+  out.open(tmp_name.c_str());
+  out.close();
+  MascotGenericFile().load(tmp_name, exp);
+  TEST_EQUAL(exp.size(), 0)
+
+  TEST_EXCEPTION(Exception::FileNotFound, MascotGenericFile().load("this_file_does_not_exist.mgf", exp))
+}
+END_SECTION
+
+START_SECTION((void transform(const String& filename, Interfaces::IMSDataConsumer* consumer)))
+{
+  String tmp_name;
+  NEW_TMP_FILE(tmp_name)
+  ofstream out(tmp_name.c_str());
+  for (Size i = 0; i < 2500; ++i)
+  {
+    out << "BEGIN IONS\nPEPMASS=" << (400 + i) << "\n" << (100 + i) << " 5\n" << (200 + i) << " 6\nEND IONS\n";
+  }
+  out.close();
+
+  MSDataStoringConsumer consumer;
+  MascotGenericFile().transform(tmp_name, &consumer);
+  const PeakMap& exp = consumer.getData();
+  TEST_EQUAL(exp.size(), 2500)
+  ABORT_IF(exp.size() != 2500)
+  bool in_order = true;
+  for (Size i = 0; i < exp.size(); ++i)
+  {
+    in_order &= exp[i].getNativeID() == "index=" + String(i) && exp[i].size() == 2 &&
+                exp[i][0].getMZ() == 100.0 + i && exp[i].getPrecursors()[0].getMZ() == 400.0 + i;
+  }
+  TEST_EQUAL(in_order, true)
+
+  PeakMap exp2;
+  MascotGenericFile().load(tmp_name, exp2);
+  TEST_EQUAL(exp2 == exp, true)
+}
+END_SECTION
+
 START_SECTION((void store(std::ostream &os, const String &filename, const PeakMap &experiment, bool compact = false)))
 {
   PeakMap exp;
@@ -173,6 +272,51 @@ START_SECTION((void store(const String &filename, const PeakMap &experiment, boo
 END_SECTION
 
 
+START_SECTION([EXTRA] store keeps the spectrum order)
+{
+  PeakMap exp;
+  for (Size i = 0; i < 2500; ++i)
+  {
+    MSSpectrum spec;
+    spec.setMSLevel(i % 10 == 0 ? 1 : 2); // MS1 spectra are not written
+    spec.setNativeID("index=" + String(i));
+    spec.setRT(i);
+    Precursor prec;
+    prec.setMZ(400.0 + i);
+    spec.getPrecursors().push_back(prec);
+    Peak1D peak;
+    peak.setMZ(100.0 + i);
+    peak.setIntensity(5.0);
+    spec.push_back(peak);
+    exp.addSpectrum(spec);
+  }
+  stringstream ss;
+  MascotGenericFile f;
+  Param params = f.getParameters();
+  params.setValue("internal:content", "peaklist_only");
+  f.setParameters(params);
+  f.store(ss, "test", exp);
+
+  String tmp_name;
+  NEW_TMP_FILE(tmp_name)
+  ofstream out(tmp_name.c_str());
+  out << ss.str();
+  out.close();
+
+  PeakMap exp2;
+  f.load(tmp_name, exp2);
+  TEST_EQUAL(exp2.size(), 2250)
+  bool in_order = true;
+  for (Size i = 0, j = 0; i < exp.size(); ++i)
+  {
+    if (exp[i].getMSLevel() != 2) continue;
+    in_order &= exp2[j].getRT() == exp[i].getRT() && exp2[j][0].getMZ() == exp[i][0].getMZ();
+    ++j;
+  }
+  TEST_EQUAL(in_order, true)
+}
+END_SECTION
+
 /////////////////////////////////////////////////////////////
 /////////////////////////////////////////////////////////////
 END_TEST
@@ -63,7 +63,7 @@ START_SECTION(virtual ~MassDecompositionAlgorithm())
 }
 END_SECTION
 
-START_SECTION((void getDecompositions(std::vector<MassDecomposition>& decomps, double weight)))
+START_SECTION((void getDecompositions(std::vector<MassDecomposition>& decomps, double weight) const))
 {
   vector<MassDecomposition> decomps;
   double mass = AASequence::fromString("DFPIANGER").getMonoWeight(Residue::Internal);
@@ -85,6 +85,61 @@ START_SECTION((void getDecompositions(std::vector<MassDecomposition>& decomps, d
 }
 END_SECTION
 
+START_SECTION((void getDecompositions(std::vector<MassDecomposition>& decomps, double weight, double tolerance) const))
+{
+  double mass = AASequence::fromString("DFPIANGER").getMonoWeight(Residue::Internal);
+
+  // the explicit tolerance overrides the "tolerance" parameter
+  MassDecompositionAlgorithm mda;
+  vector<MassDecomposition> decomps;
+  mda.getDecompositions(decomps, mass, 0.0001);
+  TEST_EQUAL(decomps.size(), 842)
+  decomps.clear();
+  mda.getDecompositions(decomps, mass, 0.001);
+  TEST_EQUAL(decomps.size(), 911)
+}
+END_SECTION
+
+START_SECTION((void getDecompositions(std::vector<std::vector<MassDecomposition> >& decomps, const std::vector<double>& weights) const))
+{
+  vector<double> masses;
+  masses.push_back(AASequence::fromString("DFPIANGER").getMonoWeight(Residue::Internal));
+  masses.push_back(AASequence::fromString("GAS").getMonoWeight(Residue::Internal));
+  masses.push_back(AASequence::fromString("DFPIANGER").getMonoWeight(Residue::Internal));
+
+  MassDecompositionAlgorithm mda;
+  Param p(mda.getParameters());
+  p.setValue("tolerance", 0.0001);
+  mda.setParameters(p);
+
+  vector<vector<MassDecomposition> > decomps(1);
+  mda.getDecompositions(decomps, masses);
+  TEST_EQUAL(decomps.size(), 3)
+  TEST_EQUAL(decomps[0].size(), 842)
+  TEST_EQUAL(decomps[2].size(), 842)
+  for (Size i = 0; i < masses.size(); ++i)
+  {
+    vector<MassDecomposition> single;
+    mda.getDecompositions(single, masses[i]);
+    TEST_EQUAL(decomps[i].size(), single.size())
+    for (Size j = 0; j < single.size(); ++j)
+    {
+      TEST_STRING_EQUAL(decomps[i][j].toString(), single[j].toString())
+    }
+  }
+
+  // a second instance with the same alphabet reuses the decomposer
+  MassDecompositionAlgorithm mda2;
+  mda2.setParameters(p);
+  vector<MassDecomposition> single;
+  mda2.getDecompositions(single, masses[0]);
+  TEST_EQUAL(single.size(), 842)
+
+  mda.getDecompositions(decomps, vector<double>());
+  TEST_EQUAL(decomps.size(), 0)
+}
+END_SECTION
+
 
 /////////////////////////////////////////////////////////////
 /////////////////////////////////////////////////////////////
@@ -172,6 +172,26 @@ START_SECTION((void run(const PeakMap &, std::vector< MassTrace > &)))
       }
 
     }
+
+    // partitioned detection gives the same traces
+    {
+      MassTraceDetection partitioned_mtd;
+      Param p_partitioned = p_mtd;
+      p_partitioned.setValue("num_mz_slabs", 3);
+      partitioned_mtd.setParameters(p_partitioned);
+      output_mt.clear();
+      partitioned_mtd.run(input, output_mt);
+      TEST_EQUAL(output_mt.size(), 3);
+
+      for (Size i = 0; i < output_mt.size(); ++i)
+      {
+          TEST_EQUAL(output_mt[i].getLabel(), "T" + String(i + 1));
+          TEST_EQUAL(output_mt[i].getSize(), exp_mt_lengths[i]);
+          TEST_REAL_SIMILAR(output_mt[i].getCentroidRT(), exp_mt_rts[i]);
+          TEST_REAL_SIMILAR(output_mt[i].getCentroidMZ(), exp_mt_mzs[i]);
+          TEST_REAL_SIMILAR(output_mt[i].computePeakArea(), exp_mt_ints[i]);
+      }
+    }
 }
 END_SECTION
 
@@ -243,6 +243,69 @@ START_SECTION((void removeValue(const String& name)))
 	i.removeValue("icon");
 END_SECTION
 
+START_SECTION((void setValue(UInt index, DataValue&& value)))
+	MetaInfo i;
+	DataValue v(String("moved"));
+	i.setValue(3, std::move(v));
+	TEST_EQUAL(i.getValue(3), "moved")
+	i.setValue(3, DataValue(5));
+	TEST_EQUAL((Int)i.getValue(3), 5)
+	i.setValue("label", DataValue(String("bla")));
+	TEST_EQUAL(i.getValue("label"), "bla")
+END_SECTION
+
+START_SECTION(([EXTRA] storage beyond the inline capacity))
+	MetaInfo i;
+	const UInt n = 3 * MetaInfo::INLINE_CAPACITY + 1;
+	// insert in scrambled order, keys need to come out sorted
+	for (UInt k = 0; k < n; ++k)
+	{
+		UInt key = (k * 7) % n;
+		i.setValue(key, String("v") + key);
+	}
+	std::vector<UInt> keys;
+	i.getKeys(keys);
+	TEST_EQUAL(keys.size(), n)
+	for (UInt k = 0; k < n; ++k)
+	{
+		TEST_EQUAL(keys[k], k)
+		TEST_EQUAL(i.getValue(k), String("v") + k)
+	}
+
+	// copies and moves keep all values
+	MetaInfo copy(i);
+	TEST_EQUAL(copy == i, true)
+	MetaInfo moved(std::move(copy));
+	TEST_EQUAL(moved == i, true)
+	TEST_EQUAL(copy.empty(), true)
+
+	// remove all but a few values again
+	for (UInt k = 2; k < n; ++k)
+	{
+		i.removeValue(k);
+	}
+	i.getKeys(keys);
+	TEST_EQUAL(keys.size(), 2)
+	TEST_EQUAL(i.getValue(1), "v1")
+	TEST_EQUAL(i.exists(5), false)
+	i.removeValue(0);
+	i.removeValue(1);
+	TEST_EQUAL(i.empty(), true)
+
+	// references to own values are safe to use when setting a new value
+	MetaInfo j;
+	for (UInt k = 0; k < MetaInfo::INLINE_CAPACITY; ++k)
+	{
+		j.setValue(2 * k + 1, String("x") + k);
+	}
+	j.setValue(0, j.getValue(1));
+	TEST_EQUAL(j.getValue(0), "x0")
+	j.clear();
+	TEST_EQUAL(j.empty(), true)
+	j.setValue(1, 1);
+	TEST_EQUAL(j.empty(), false)
+END_SECTION
+
 /////////////////////////////////////////////////////////////
 /////////////////////////////////////////////////////////////
 END_TEST
@@ -67,7 +67,7 @@ START_SECTION((virtual ~MetaboliteSpectralMatching()))
 }
 END_SECTION
 
-START_SECTION((double computeHyperScore(MSSpectrum, MSSpectrum, const double &, const double &)))
+START_SECTION((double computeHyperScore(const MSSpectrum&, const MSSpectrum&, const double &, const double &) const))
 {
   // TODO
 }
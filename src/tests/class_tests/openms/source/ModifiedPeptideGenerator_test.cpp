@@ -278,6 +278,96 @@ START_SECTION((static void applyVariableModifications(const std::vector< Residue
 END_SECTION
 
 
+START_SECTION((static void getVariableModificationSites(const std::vector<ResidueModification>::const_iterator& var_mods_begin, const std::vector<ResidueModification>::const_iterator& var_mods_end, const AASequence& peptide, VariableModificationSites& sites)))
+{
+  vector<ResidueModification> var_mods;
+  var_mods.push_back(ModificationsDB::getInstance()->getModification("Oxidation (M)"));
+  var_mods.push_back(ModificationsDB::getInstance()->getModification("Carbamyl (N-term)"));
+
+  ModifiedPeptideGenerator::VariableModificationSites sites;
+  ModifiedPeptideGenerator::getVariableModificationSites(var_mods.begin(), var_mods.end(), AASequence::fromString("MAAM(Oxidation)AMK"), sites);
+  TEST_EQUAL(sites.positions.size(), 3)
+  TEST_EQUAL(sites.positions[0], ModifiedPeptideGenerator::N_TERM_MODIFICATION_INDEX)
+  TEST_EQUAL(sites.positions[1], 0)
+  TEST_EQUAL(sites.positions[2], 5)
+  TEST_EQUAL(sites.modifications[1].size(), 1)
+  TEST_EQUAL(sites.modifications[1][0].getId(), "Oxidation")
+}
+END_SECTION
+
+START_SECTION((static void enumerateVariableModifications(const AASequence& peptide, const VariableModificationSites& sites, Size max_variable_mods_per_peptide, std::vector<ModifiedPeptideMass>& candidates, bool keep_original = true, double min_mass = -std::numeric_limits<double>::max(), double max_mass = std::numeric_limits<double>::max())))
+{
+  vector<ResidueModification> var_mods;
+  var_mods.push_back(ModificationsDB::getInstance()->getModification("Oxidation (M)"));
+  var_mods.push_back(ModificationsDB::getInstance()->getModification("Carbamidomethyl (C)"));
+  var_mods.push_back(ModificationsDB::getInstance()->getModification("Carbamyl (N-term)"));
+  AASequence seq = AASequence::fromString("MAACAMCAMK");
+
+  vector<AASequence> modified_peptides;
+  ModifiedPeptideGenerator::applyVariableModifications(var_mods.begin(), var_mods.end(), seq, 3, modified_peptides, true);
+
+  ModifiedPeptideGenerator::VariableModificationSites sites;
+  ModifiedPeptideGenerator::getVariableModificationSites(var_mods.begin(), var_mods.end(), seq, sites);
+  vector<ModifiedPeptideGenerator::ModifiedPeptideMass> candidates;
+  ModifiedPeptideGenerator::enumerateVariableModifications(seq, sites, 3, candidates, true);
+
+  // same combinations as applyVariableModifications(), sorted by weight
+  TEST_EQUAL(candidates.size(), modified_peptides.size())
+  set<String> expected, generated;
+  for (Size i = 0; i < modified_peptides.size(); ++i)
+  {
+    expected.insert(modified_peptides[i].toString());
+  }
+  for (Size i = 0; i < candidates.size(); ++i)
+  {
+    AASequence peptide = ModifiedPeptideGenerator::createModifiedPeptide(seq, sites, candidates[i]);
+    TEST_REAL_SIMILAR(peptide.getMonoWeight(), candidates[i].mono_weight)
+    generated.insert(peptide.toString());
+  }
+  TEST_EQUAL(generated == expected, true)
+  for (Size i = 1; i < candidates.size(); ++i)
+  {
+    TEST_EQUAL(candidates[i - 1].mono_weight <= candidates[i].mono_weight, true)
+  }
+
+  // only the candidates inside the window are reported
+  const double unmodified_weight = seq.getMonoWeight();
+  const double min_mass = unmodified_weight + 50.0;
+  const double max_mass = unmodified_weight + 80.0;
+  ModifiedPeptideGenerator::enumerateVariableModifications(seq, sites, 3, candidates, true, min_mass, max_mass);
+  Size in_window(0);
+  for (Size i = 0; i < modified_peptides.size(); ++i)
+  {
+    if (modified_peptides[i].getMonoWeight() >= min_mass && modified_peptides[i].getMonoWeight() <= max_mass) ++in_window;
+  }
+  TEST_EQUAL(candidates.size(), in_window)
+  TEST_EQUAL(candidates.empty(), false)
+
+  // no variable modifications allowed
+  ModifiedPeptideGenerator::enumerateVariableModifications(seq, sites, 0, candidates, true);
+  TEST_EQUAL(candidates.size(), 1)
+  TEST_EQUAL(candidates[0].site_mask, 0)
+  ModifiedPeptideGenerator::enumerateVariableModifications(seq, sites, 0, candidates, false);
+  TEST_EQUAL(candidates.size(), 0)
+}
+END_SECTION
+
+START_SECTION((static AASequence createModifiedPeptide(const AASequence& peptide, const VariableModificationSites& sites, const ModifiedPeptideMass& candidate)))
+{
+  vector<ResidueModification> var_mods;
+  var_mods.push_back(ModificationsDB::getInstance()->getModification("Oxidation (M)"));
+  var_mods.push_back(ModificationsDB::getInstance()->getModification("Carbamyl (N-term)"));
+  AASequence seq = AASequence::fromString("KAAMAAM");
+  ModifiedPeptideGenerator::VariableModificationSites sites;
+  ModifiedPeptideGenerator::getVariableModificationSites(var_mods.begin(), var_mods.end(), seq, sites);
+
+  ModifiedPeptideGenerator::ModifiedPeptideMass candidate = {0.0, 5, 0}; // N-term and second M
+  TEST_EQUAL(ModifiedPeptideGenerator::createModifiedPeptide(seq, sites, candidate).toString(), ".(Carbamyl)KAAMAAM(Oxidation)")
+  candidate.site_mask = 0;
+  TEST_EQUAL(ModifiedPeptideGenerator::createModifiedPeptide(seq, sites, candidate).toString(), "KAAMAAM")
+}
+END_SECTION
+
 
 /////////////////////////////////////////////////////////////
 /////////////////////////////////////////////////////////////
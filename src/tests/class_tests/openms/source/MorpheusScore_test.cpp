@@ -38,6 +38,7 @@
 #include <OpenMS/ANALYSIS/RNPXL/MorpheusScore.h>
 ///////////////////////////
 
+#include <OpenMS/ANALYSIS/RNPXL/TheoreticalSpectrumBatch.h>
 #include <OpenMS/KERNEL/MSSpectrum.h>
 #include <OpenMS/KERNEL/MSExperiment.h>
 #include <OpenMS/CHEMISTRY/TheoreticalSpectrumGenerator.h>
@@ -126,6 +127,66 @@ START_SECTION((static MorpheusScore::Result compute(
 }
 END_SECTION
 
+START_SECTION((static void compute(double fragment_mass_tolerance, bool fragment_mass_tolerance_unit_ppm, const PeakSpectrum &exp_spectrum, const TheoreticalSpectrumBatch &theo_spectra, std::vector< Result > &results)))
+{
+  PeakSpectrum exp_spectrum;
+  tsg.getSpectrum(exp_spectrum, AASequence::fromString("PEPTIDE"), 1, 3);
+  // shift some peaks to get partial matches and experimental peaks matching several theoretical peaks
+  for (Size i = 0; i < exp_spectrum.size(); i += 3)
+  {
+    exp_spectrum[i].setMZ(exp_spectrum[i].getMZ() + 0.05);
+    exp_spectrum[i].setIntensity(0.5 * (i + 1));
+  }
+  exp_spectrum.sortByPosition();
+
+  vector<PeakSpectrum> theo_spectra(5);
+  tsg.getSpectrum(theo_spectra[0], AASequence::fromString("PEPTIDE"), 1, 3);
+  tsg.getSpectrum(theo_spectra[1], AASequence::fromString("PEPTIDER"), 1, 2);
+  // theo_spectra[2] is empty
+  tsg.getSpectrum(theo_spectra[3], AASequence::fromString("EDITPEP"), 1, 1);
+  tsg.getSpectrum(theo_spectra[4], AASequence::fromString("PEPTID"), 1, 1);
+
+  TheoreticalSpectrumBatch batch;
+  for (const PeakSpectrum& theo_spectrum : theo_spectra)
+  {
+    batch.add(theo_spectrum);
+  }
+
+  vector<MorpheusScore::Result> results;
+  for (double tolerance : {0.01, 0.1, 0.5, 2.0})
+  {
+    MorpheusScore::compute(tolerance, false, exp_spectrum, batch, results);
+    TEST_EQUAL(results.size(), theo_spectra.size())
+    for (Size s = 0; s < theo_spectra.size(); ++s)
+    {
+      MorpheusScore::Result r = MorpheusScore::compute(tolerance, false, exp_spectrum, theo_spectra[s]);
+      TEST_EQUAL(results[s].matches, r.matches)
+      TEST_EQUAL(results[s].n_peaks, r.n_peaks)
+      TEST_REAL_SIMILAR(results[s].score, r.score)
+      TEST_REAL_SIMILAR(results[s].MIC, r.MIC)
+      TEST_REAL_SIMILAR(results[s].TIC, r.TIC)
+      TEST_REAL_SIMILAR(results[s].err, r.err)
+    }
+  }
+
+  MorpheusScore::compute(100, true, exp_spectrum, batch, results);
+  for (Size s = 0; s < theo_spectra.size(); ++s)
+  {
+    MorpheusScore::Result r = MorpheusScore::compute(100, true, exp_spectrum, theo_spectra[s]);
+    TEST_EQUAL(results[s].matches, r.matches)
+    TEST_REAL_SIMILAR(results[s].score, r.score)
+    TEST_REAL_SIMILAR(results[s].err, r.err)
+  }
+  TEST_EQUAL(results[0].matches, 33)
+  TEST_EQUAL(results[2].n_peaks, 0)
+
+  // empty experimental spectrum
+  MorpheusScore::compute(0.1, false, PeakSpectrum(), batch, results);
+  TEST_EQUAL(results.size(), theo_spectra.size())
+  TEST_REAL_SIMILAR(results[0].score, 0.0)
+}
+END_SECTION
+
 /////////////////////////////////////////////////////////////
 /////////////////////////////////////////////////////////////
 END_TEST
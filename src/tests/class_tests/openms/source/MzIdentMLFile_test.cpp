@@ -128,6 +128,37 @@ START_SECTION(void load(const String& filename, std::vector<ProteinIdentificatio
 }
 END_SECTION
 
+START_SECTION(void load(const String& filename, std::vector<ProteinIdentification>& poid, const std::function<void(PeptideIdentification&)>& consumer))
+{
+  StringList files = ListUtils::create<String>("MzIdentMLFile_msgf_mini.mzid,MzIdentMLFile_whole.mzid,MzIdentML_3runs.mzid,MzIdentML_XLMS_labelled.mzid");
+  for (Size f = 0; f < files.size(); ++f)
+  {
+    std::vector<ProteinIdentification> protein_ids, protein_ids2;
+    std::vector<PeptideIdentification> peptide_ids, peptide_ids2;
+    String input_path = OPENMS_GET_TEST_DATA_PATH(files[f]);
+    MzIdentMLFile().load(input_path, protein_ids, peptide_ids);
+    MzIdentMLFile().load(input_path, protein_ids2, [&peptide_ids2](PeptideIdentification& pep_id) { peptide_ids2.push_back(pep_id); });
+
+    // run identifiers are generated, compare the content
+    TEST_EQUAL(protein_ids2.size(), protein_ids.size())
+    ABORT_IF(protein_ids2.size() != protein_ids.size())
+    for (Size i = 0; i < protein_ids.size(); ++i)
+    {
+      TEST_EQUAL(protein_ids2[i].getSearchEngine(), protein_ids[i].getSearchEngine())
+      TEST_EQUAL(protein_ids2[i].getSearchParameters() == protein_ids[i].getSearchParameters(), true)
+      TEST_EQUAL(protein_ids2[i].getHits() == protein_ids[i].getHits(), true)
+    }
+    TEST_EQUAL(peptide_ids2.size(), peptide_ids.size())
+    ABORT_IF(peptide_ids2.size() != peptide_ids.size())
+    for (Size i = 0; i < peptide_ids.size(); ++i)
+    {
+      TEST_EQUAL(peptide_ids2[i].getMetaValue("spectrum_reference"), peptide_ids[i].getMetaValue("spectrum_reference"))
+      TEST_EQUAL(peptide_ids2[i].getHits() == peptide_ids[i].getHits(), true)
+    }
+  }
+}
+END_SECTION
+
 START_SECTION(void store(String filename, const std::vector<ProteinIdentification>& protein_ids, const std::vector<PeptideIdentification>& peptide_ids) )
 {
   //store and load data from various sources, starting with idxml, contents already checked above, so checking integrity of the data over repeated r/w
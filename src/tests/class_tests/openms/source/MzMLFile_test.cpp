@@ -41,6 +41,7 @@
 
 #include <OpenMS/FORMAT/FileTypes.h>
 #include <OpenMS/KERNEL/MSExperiment.h>
+#include <OpenMS/SYSTEM/File.h>
 
 using namespace OpenMS;
 using namespace std;
@@ -1228,6 +1229,114 @@ START_SECTION(void transform(const String& filename_in, Interfaces::IMSDataConsu
 }
 END_SECTION
 
+START_SECTION([EXTRA] store in several batches)
+{
+  // spectra and chromatograms are encoded in batches of MaxDataPoolSize,
+  // the output (including the index) must not depend on the batch size
+  PeakMap exp_original;
+  for (Size i = 0; i < 7; ++i)
+  {
+    MSSpectrum spec;
+    spec.setRT(10.0 * i);
+    spec.setMSLevel(1 + i % 2);
+    spec.setNativeID(String("scan=") + (i + 1));
+    for (Size j = 0; j < 5 + i; ++j)
+    {
+      spec.push_back(Peak1D(100.0 + j * 1.5, 10.0 * (i + j)));
+    }
+    exp_original.addSpectrum(spec);
+  }
+  for (Size i = 0; i < 5; ++i)
+  {
+    MSChromatogram chrom;
+    chrom.setNativeID(String("chrom_") + i);
+    for (Size j = 0; j < 3 + i; ++j)
+    {
+      chrom.push_back(ChromatogramPeak(j * 2.0, 5.0 * (i + j)));
+    }
+    exp_original.addChromatogram(chrom);
+  }
+
+  MzMLFile file;
+  std::string reference;
+  file.storeBuffer(reference, exp_original);
+
+  for (Size pool_size = 1; pool_size <= 3; ++pool_size)
+  {
+    file.getOptions().setMaxDataPoolSize(pool_size);
+    std::string out;
+    file.storeBuffer(out, exp_original);
+    TEST_EQUAL(out == reference, true)
+  }
+
+  file.getOptions().setMaxDataPoolSize(2);
+  std::string tmp_filename;
+  NEW_TMP_FILE(tmp_filename);
+  file.store(tmp_filename, exp_original);
+  PeakMap exp;
+  file.load(tmp_filename, exp);
+  ABORT_IF(exp.size() != exp_original.size())
+  for (Size i = 0; i < exp.size(); ++i)
+  {
+    TEST_EQUAL(exp[i].getNativeID(), exp_original[i].getNativeID())
+    TEST_EQUAL(exp[i].size(), exp_original[i].size())
+  }
+  ABORT_IF(exp.getChromatograms().size() != exp_original.getChromatograms().size())
+  for (Size i = 0; i < exp.getChromatograms().size(); ++i)
+  {
+    TEST_EQUAL(exp.getChromatograms()[i].getNativeID(), exp_original.getChromatograms()[i].getNativeID())
+    TEST_EQUAL(exp.getChromatograms()[i].size(), exp_original.getChromatograms()[i].size())
+  }
+}
+END_SECTION
+
+START_SECTION([EXTRA] load with indexed selection)
+{
+  // selecting the spectra through the index must give the same result as filtering while parsing
+  PeakMap exp_original;
+  for (Size i = 0; i < 9; ++i)
+  {
+    MSSpectrum spec;
+    spec.setRT(10.0 * i);
+    spec.setMSLevel(1 + i % 3);
+    spec.setNativeID(String("scan=") + (i + 1));
+    for (Size j = 0; j < 3 + i; ++j)
+    {
+      spec.push_back(Peak1D(100.0 + j * 1.5, 10.0 * (i + j)));
+    }
+    exp_original.addSpectrum(spec);
+  }
+  MSChromatogram chrom;
+  chrom.setNativeID("TIC");
+  chrom.push_back(ChromatogramPeak(1.0, 5.0));
+  exp_original.addChromatogram(chrom);
+
+  std::string tmp_filename;
+  NEW_TMP_FILE(tmp_filename);
+  MzMLFile().store(tmp_filename, exp_original);
+
+  MzMLFile full, selective;
+  full.getOptions().setMSLevels(vector<Int>(1, 2));
+  full.getOptions().setRTRange(makeRange(5.0, 75.0));
+  selective.getOptions() = full.getOptions();
+  selective.getOptions().setUseIndexedSelection(true);
+
+  PeakMap exp_full, exp_selective;
+  full.load(tmp_filename, exp_full);
+  selective.load(tmp_filename, exp_selective);
+  TEST_EQUAL(exp_full.size(), 3)
+  ABORT_IF(exp_selective.size() != exp_full.size())
+  for (Size i = 0; i < exp_full.size(); ++i)
+  {
+    TEST_EQUAL(exp_selective[i].getNativeID(), exp_full[i].getNativeID())
+    TEST_REAL_SIMILAR(exp_selective[i].getRT(), exp_full[i].getRT())
+    TEST_EQUAL(exp_selective[i].size(), exp_full[i].size())
+  }
+  TEST_EQUAL(exp_selective.getChromatograms().size(), exp_full.getChromatograms().size())
+  File::remove(tmp_filename + ".smi");
+}
+END_SECTION
+
 /////////////////////////////////////////////////////////////
 /////////////////////////////////////////////////////////////
 END_TEST
@@ -0,0 +1,199 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2018.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: Timo Sachsenberg $
+// $Authors: $
+// --------------------------------------------------------------------------
+
+#include <OpenMS/CONCEPT/ClassTest.h>
+#include <OpenMS/test_config.h>
+
+///////////////////////////
+#include <OpenMS/FORMAT/MzMLSpectrumMetaIndex.h>
+///////////////////////////
+
+#include <OpenMS/FORMAT/MzMLFile.h>
+#include <OpenMS/KERNEL/MSExperiment.h>
+#include <OpenMS/SYSTEM/File.h>
+
+using namespace OpenMS;
+using namespace std;
+
+///////////////////////////
+
+START_TEST(MzMLSpectrumMetaIndex, "$Id$")
+
+/////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////
+
+// six spectra alternating between MS1 and MS2 (RT 10, 20, ..., 60)
+PeakMap exp;
+for (Size i = 0; i < 6; ++i)
+{
+  MSSpectrum spec;
+  spec.setRT(10.0 * (i + 1));
+  spec.setMSLevel(i % 2 + 1);
+  spec.setNativeID(String("scan=") + String(i + 1));
+  if (spec.getMSLevel() == 2)
+  {
+    Precursor prec;
+    prec.setMZ(400.0 + i);
+    spec.setPrecursors(vector<Precursor>(1, prec));
+  }
+  Peak1D p;
+  p.setMZ(100.0 + i);
+  p.setIntensity(10.0f * (i + 1));
+  spec.push_back(p);
+  exp.addSpectrum(spec);
+}
+String mzml_file;
+NEW_TMP_FILE(mzml_file);
+MzMLFile().store(mzml_file, exp);
+
+MzMLSpectrumMetaIndex* ptr = nullptr;
+MzMLSpectrumMetaIndex* null_ptr = nullptr;
+START_SECTION(MzMLSpectrumMetaIndex())
+{
+  ptr = new MzMLSpectrumMetaIndex();
+  TEST_NOT_EQUAL(ptr, null_ptr)
+  TEST_EQUAL(ptr->size(), 0)
+}
+END_SECTION
+
+START_SECTION(~MzMLSpectrumMetaIndex())
+{
+  delete ptr;
+}
+END_SECTION
+
+START_SECTION(void build(const String& mzml_file))
+{
+  MzMLSpectrumMetaIndex index;
+  index.build(mzml_file);
+  TEST_EQUAL(index.size(), 6)
+  TEST_REAL_SIMILAR(index.getIndexEntries()[0].rt, 10.0)
+  TEST_EQUAL(index.getIndexEntries()[0].ms_level, 1)
+  TEST_REAL_SIMILAR(index.getIndexEntries()[0].precursor_mz, 0.0)
+  TEST_REAL_SIMILAR(index.getIndexEntries()[5].rt, 60.0)
+  TEST_EQUAL(index.getIndexEntries()[5].ms_level, 2)
+  TEST_REAL_SIMILAR(index.getIndexEntries()[5].precursor_mz, 405.0)
+
+  TEST_EXCEPTION(Exception::FileNotFound, index.build("this_file_does_not_exist.mzML"))
+}
+END_SECTION
+
+START_SECTION(Size size() const)
+{
+  NOT_TESTABLE // tested above
+}
+END_SECTION
+
+START_SECTION(const std::vector<Entry>& getIndexEntries() const)
+{
+  NOT_TESTABLE // tested above
+}
+END_SECTION
+
+START_SECTION(std::vector<Size> select(const PeakFileOptions& options) const)
+{
+  MzMLSpectrumMetaIndex index;
+  index.build(mzml_file);
+
+  PeakFileOptions options;
+  TEST_EQUAL(index.select(options).size(), 6)
+
+  options.setMSLevels(vector<Int>(1, 2));
+  vector<Size> selected = index.select(options);
+  TEST_EQUAL(selected.size(), 3)
+  TEST_EQUAL(selected[0], 1)
+  TEST_EQUAL(selected[2], 5)
+
+  options.setRTRange(DRange<1>(DPosition<1>(15.0), DPosition<1>(45.0)));
+  selected = index.select(options);
+  TEST_EQUAL(selected.size(), 2)
+  TEST_EQUAL(selected[0], 1)
+  TEST_EQUAL(selected[1], 3)
+}
+END_SECTION
+
+START_SECTION(void store(const String& index_file) const)
+{
+  MzMLSpectrumMetaIndex index;
+  index.build(mzml_file);
+  String index_file;
+  NEW_TMP_FILE(index_file);
+  index.store(index_file);
+
+  MzMLSpectrumMetaIndex reloaded;
+  reloaded.load(index_file);
+  TEST_EQUAL(reloaded.size(), index.size())
+  for (Size i = 0; i < index.size(); ++i)
+  {
+    TEST_REAL_SIMILAR(reloaded.getIndexEntries()[i].rt, index.getIndexEntries()[i].rt)
+    TEST_EQUAL(reloaded.getIndexEntries()[i].ms_level, index.getIndexEntries()[i].ms_level)
+    TEST_REAL_SIMILAR(reloaded.getIndexEntries()[i].precursor_mz, index.getIndexEntries()[i].precursor_mz)
+  }
+}
+END_SECTION
+
+START_SECTION(void load(const String& index_file))
+{
+  MzMLSpectrumMetaIndex index;
+  TEST_EXCEPTION(Exception::FileNotFound, index.load("this_file_does_not_exist.smi"))
+  // an mzML file is not a valid index
+  TEST_EXCEPTION(Exception::ParseError, index.load(mzml_file))
+}
+END_SECTION
+
+START_SECTION(void open(const String& mzml_file, bool store_index = true))
+{
+  MzMLSpectrumMetaIndex index;
+  index.open(mzml_file, false);
+  TEST_EQUAL(index.size(), 6)
+  TEST_EQUAL(File::exists(mzml_file + ".smi"), false)
+
+  index.open(mzml_file);
+  TEST_EQUAL(index.size(), 6)
+  TEST_EQUAL(File::exists(mzml_file + ".smi"), true)
+
+  // reuses the stored index
+  MzMLSpectrumMetaIndex reopened;
+  reopened.open(mzml_file);
+  TEST_EQUAL(reopened.size(), 6)
+  TEST_EQUAL(reopened.getIndexEntries()[3].ms_level, 2)
+  File::remove(mzml_file + ".smi");
+
+  TEST_EXCEPTION(Exception::FileNotFound, index.open("this_file_does_not_exist.mzML"))
+}
+END_SECTION
+
+/////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////
+END_TEST
@@ -0,0 +1,195 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2018.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: Timo Sachsenberg $
+// $Authors: Timo Sachsenberg $
+// --------------------------------------------------------------------------
+
+#include <OpenMS/CONCEPT/ClassTest.h>
+#include <OpenMS/test_config.h>
+
+///////////////////////////
+
+#include <OpenMS/FORMAT/MzMLTailReader.h>
+
+///////////////////////////
+
+#include <OpenMS/FORMAT/DATAACCESS/MSDataStoringConsumer.h>
+#include <OpenMS/FORMAT/MzMLFile.h>
+
+#include <fstream>
+#include <sstream>
+
+using namespace OpenMS;
+using namespace std;
+
+START_TEST(MzMLTailReader, "$Id$")
+
+/////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////
+
+// a complete mzML file which is written in two steps below
+PeakMap exp;
+exp.getInstrument().setName("tail_instrument");
+for (Size i = 0; i < 3; ++i)
+{
+  MSSpectrum s;
+  s.setRT(10.0 * (i + 1));
+  s.setMSLevel(1);
+  s.setNativeID(String("spectrum=") + i);
+  Peak1D p;
+  p.setMZ(100.0 + i);
+  p.setIntensity(1000.0);
+  s.push_back(p);
+  p.setMZ(200.0 + i);
+  s.push_back(p);
+  exp.addSpectrum(s);
+}
+MSChromatogram chrom;
+chrom.setNativeID("tic");
+ChromatogramPeak cp;
+cp.setRT(10.0);
+cp.setIntensity(2000.0);
+chrom.push_back(cp);
+exp.addChromatogram(chrom);
+
+String complete_file;
+NEW_TMP_FILE(complete_file)
+MzMLFile().store(complete_file, exp);
+string content;
+{
+  ifstream ifs(complete_file.c_str(), ios::binary);
+  stringstream ss;
+  ss << ifs.rdbuf();
+  content = ss.str();
+}
+// split in the middle of the second spectrum
+Size split = content.find("<spectrum ", content.find("<spectrum ") + 1) + 20;
+
+MzMLTailReader* ptr = nullptr;
+MzMLTailReader* null_ptr = nullptr;
+START_SECTION((MzMLTailReader(const String& filename, Interfaces::IMSDataConsumer* consumer)))
+{
+  ptr = new MzMLTailReader("not_yet_existing.mzML", nullptr);
+  TEST_NOT_EQUAL(ptr, null_ptr)
+  TEST_EQUAL(ptr->isFinished(), false)
+}
+END_SECTION
+
+START_SECTION((~MzMLTailReader()))
+{
+  delete ptr;
+}
+END_SECTION
+
+START_SECTION((Size poll()))
+{
+  String tail_file;
+  NEW_TMP_FILE(tail_file)
+  MSDataStoringConsumer consumer;
+  MzMLTailReader reader(tail_file, &consumer);
+
+  // file does not exist yet
+  TEST_EQUAL(reader.poll(), 0)
+
+  {
+    ofstream ofs(tail_file.c_str(), ios::binary);
+    ofs << content.substr(0, split);
+  }
+  TEST_EQUAL(reader.poll(), 1)
+  TEST_EQUAL(reader.poll(), 0)
+  TEST_EQUAL(reader.isFinished(), false)
+  TEST_EQUAL(consumer.getData().getInstrument().getName(), "tail_instrument")
+  TEST_EQUAL(consumer.getData().size(), 1)
+
+  {
+    ofstream ofs(tail_file.c_str(), ios::binary | ios::app);
+    ofs << content.substr(split);
+  }
+  TEST_EQUAL(reader.poll(), 3)
+  TEST_EQUAL(reader.isFinished(), true)
+  TEST_EQUAL(reader.getNrSpectra(), 3)
+  TEST_EQUAL(reader.getNrChromatograms(), 1)
+
+  const PeakMap& result = consumer.getData();
+  ABORT_IF(result.size() != 3)
+  for (Size i = 0; i < 3; ++i)
+  {
+    TEST_REAL_SIMILAR(result[i].getRT(), 10.0 * (i + 1))
+    TEST_EQUAL(result[i].getNativeID(), String("spectrum=") + i)
+    ABORT_IF(result[i].size() != 2)
+    TEST_REAL_SIMILAR(result[i][0].getMZ(), 100.0 + i)
+    TEST_REAL_SIMILAR(result[i][1].getMZ(), 200.0 + i)
+  }
+  ABORT_IF(result.getChromatograms().size() != 1)
+  TEST_EQUAL(result.getChromatograms()[0].getNativeID(), "tic")
+  TEST_EQUAL(result.getChromatograms()[0].size(), 1)
+
+  // nothing more to read
+  TEST_EQUAL(reader.poll(), 0)
+}
+END_SECTION
+
+START_SECTION((bool isFinished() const))
+{
+  NOT_TESTABLE // tested above
+}
+END_SECTION
+
+START_SECTION((Size getNrSpectra() const))
+{
+  NOT_TESTABLE // tested above
+}
+END_SECTION
+
+START_SECTION((Size getNrChromatograms() const))
+{
+  NOT_TESTABLE // tested above
+}
+END_SECTION
+
+START_SECTION((PeakFileOptions& getOptions()))
+{
+  MzMLTailReader reader("dummy.mzML", nullptr);
+  reader.getOptions().setMSLevels(std::vector<Int>(1, 2));
+  TEST_EQUAL(reader.getOptions().getMSLevels().size(), 1)
+}
+END_SECTION
+
+START_SECTION((const PeakFileOptions& getOptions() const))
+{
+  const MzMLTailReader reader("dummy.mzML", nullptr);
+  TEST_EQUAL(reader.getOptions().hasMSLevels(), false)
+}
+END_SECTION
+
+/////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////
+END_TEST
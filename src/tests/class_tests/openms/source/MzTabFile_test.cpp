@@ -121,6 +121,42 @@ START_SECTION(void store(const String& filename, MzTab& mzTab) )
 }
 END_SECTION
 
+START_SECTION(void store(const String& filename, const MzTab& mz_tab, Size n_psm_items, const PSMRowGenerator& psm_row_generator) const)
+{
+  std::vector<String> files_to_test;
+  files_to_test.push_back("MzTabFile_SILAC.mzTab");
+  files_to_test.push_back("MzTabFile_labelfree.mzTab");
+  files_to_test.push_back("MzTabFile_iTRAQ.mzTab");
+  files_to_test.push_back("MzTabFile_Cytidine.mzTab");
+
+  for (std::vector<String>::const_iterator sit = files_to_test.begin(); sit != files_to_test.end(); ++sit)
+  {
+    MzTab mzTab;
+    MzTabFile().load(OPENMS_GET_TEST_DATA_PATH(*sit), mzTab);
+    // comment and empty rows are not written by the streaming store
+    mzTab.setEmptyRows(std::vector<Size>());
+    mzTab.setCommentRows(std::map<Size, String>());
+
+    String stored_mzTab;
+    NEW_TMP_FILE(stored_mzTab)
+    MzTabFile().store(stored_mzTab, mzTab);
+
+    // generate the PSM section from the loaded rows (two rows per item to test item grouping)
+    const MzTabPSMSectionRows& psm_rows = mzTab.getPSMSectionRows();
+    MzTabFile::PSMRowGenerator generator = [&psm_rows](Size i, MzTabPSMSectionRows& rows)
+    {
+      rows.push_back(psm_rows[2 * i]);
+      if (2 * i + 1 < psm_rows.size()) rows.push_back(psm_rows[2 * i + 1]);
+    };
+
+    String streamed_mzTab;
+    NEW_TMP_FILE(streamed_mzTab)
+    MzTabFile().store(streamed_mzTab, mzTab, (psm_rows.size() + 1) / 2, generator);
+    TEST_FILE_EQUAL(streamed_mzTab.c_str(), stored_mzTab.c_str())
+  }
+}
+END_SECTION
+
 START_SECTION(~MzTabFile())
 {
   delete ptr;
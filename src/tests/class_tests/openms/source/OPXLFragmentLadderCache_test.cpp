@@ -0,0 +1,115 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2018.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: Eugen Netz $
+// $Authors: Eugen Netz $
+// --------------------------------------------------------------------------
+
+#include <OpenMS/CONCEPT/ClassTest.h>
+#include <OpenMS/test_config.h>
+
+///////////////////////////
+
+#include <OpenMS/ANALYSIS/XLMS/OPXLFragmentLadderCache.h>
+
+using namespace OpenMS;
+using namespace std;
+
+START_TEST(OPXLFragmentLadderCache, "$Id$")
+
+/////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////
+
+TheoreticalSpectrumGeneratorXLMS spec_gen;
+AASequence peptide = AASequence::fromString("PEPTIDE");
+
+OPXLFragmentLadderCache* ptr = nullptr;
+OPXLFragmentLadderCache* null_ptr = nullptr;
+START_SECTION(explicit OPXLFragmentLadderCache(const TheoreticalSpectrumGeneratorXLMS& generator, Size max_size = 10000))
+  ptr = new OPXLFragmentLadderCache(spec_gen);
+  TEST_NOT_EQUAL(ptr, null_ptr)
+  TEST_EQUAL(ptr->size(), 0)
+  delete ptr;
+END_SECTION
+
+START_SECTION(LadderPtr getLinearIonSpectrum(const AASequence& peptide, Size link_pos, bool frag_alpha, int charge = 1, Size link_pos_2 = 0))
+  OPXLFragmentLadderCache cache(spec_gen);
+
+  PeakSpectrum expected;
+  spec_gen.getLinearIonSpectrum(expected, peptide, 3, true, 2);
+
+  OPXLFragmentLadderCache::LadderPtr ladder = cache.getLinearIonSpectrum(peptide, 3, true, 2);
+  TEST_EQUAL(ladder->size(), 18)
+  TEST_EQUAL(*ladder == expected, true)
+  TEST_EQUAL(cache.size(), 1)
+
+  // the cached ladder is returned for the same input
+  OPXLFragmentLadderCache::LadderPtr ladder2 = cache.getLinearIonSpectrum(peptide, 3, true, 2);
+  TEST_EQUAL(ladder2 == ladder, true)
+  TEST_EQUAL(cache.size(), 1)
+
+  // every parameter is part of the key
+  TEST_EQUAL(cache.getLinearIonSpectrum(peptide, 3, false, 2) == ladder, false)
+  TEST_EQUAL(cache.getLinearIonSpectrum(peptide, 3, true, 3) == ladder, false)
+  TEST_EQUAL(cache.getLinearIonSpectrum(peptide, 2, true, 2) == ladder, false)
+  TEST_EQUAL(cache.getLinearIonSpectrum(peptide, 1, true, 2, 4) == ladder, false)
+  TEST_EQUAL(cache.getLinearIonSpectrum(AASequence::fromString("PEPTIDEK"), 3, true, 2) == ladder, false)
+  TEST_EQUAL(cache.size(), 6)
+
+  PeakSpectrum expected_beta;
+  spec_gen.getLinearIonSpectrum(expected_beta, peptide, 3, false, 2);
+  TEST_EQUAL(*cache.getLinearIonSpectrum(peptide, 3, false, 2) == expected_beta, true)
+
+  // the cache is cleared when it is full, ladders handed out before stay valid
+  OPXLFragmentLadderCache small_cache(spec_gen, 2);
+  OPXLFragmentLadderCache::LadderPtr first = small_cache.getLinearIonSpectrum(peptide, 3, true, 2);
+  small_cache.getLinearIonSpectrum(peptide, 2, true, 2);
+  TEST_EQUAL(small_cache.size(), 2)
+  small_cache.getLinearIonSpectrum(peptide, 1, true, 2);
+  TEST_EQUAL(small_cache.size(), 1)
+  TEST_EQUAL(*first == expected, true)
+END_SECTION
+
+START_SECTION(Size size() const)
+  NOT_TESTABLE // tested above
+END_SECTION
+
+START_SECTION(void clear())
+  OPXLFragmentLadderCache cache(spec_gen);
+  cache.getLinearIonSpectrum(peptide, 3, true, 2);
+  cache.getLinearIonSpectrum(peptide, 3, false, 2);
+  TEST_EQUAL(cache.size(), 2)
+  cache.clear();
+  TEST_EQUAL(cache.size(), 0)
+END_SECTION
+
+/////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////
+END_TEST
@@ -161,6 +161,34 @@ START_SECTION(static std::vector<OPXLDataStructs::XLPrecursor> enumerateCrossLin
     }
   }
 
+  // only the pairs within the precursor window are enumerated, but none of them is missed
+  std::vector< double > sorted_precursors;
+  for (Size i = 0; i < 20; ++i)
+  {
+    sorted_precursors.push_back(2500.0 + i * 50.3);
+  }
+  std::vector< int > sorted_positions;
+  std::vector<OPXLDataStructs::XLPrecursor> window_precursors = OPXLHelper::enumerateCrossLinksAndMasses(peptides, cross_link_mass, cross_link_mass_mono_link, cross_link_residue1, cross_link_residue2, sorted_precursors, sorted_positions, precursor_mass_tolerance, precursor_mass_tolerance_unit_ppm);
+  Size enumerated_pairs = 0;
+  for (Size i = 0; i < window_precursors.size(); ++i)
+  {
+    if (window_precursors[i].beta_index < peptides.size()) ++enumerated_pairs;
+  }
+  Size expected_pairs = 0;
+  for (Size p1 = 0; p1 < peptides.size(); ++p1)
+  {
+    for (Size p2 = p1; p2 < peptides.size(); ++p2)
+    {
+      double mass = peptides[p1].peptide_mass + peptides[p2].peptide_mass + cross_link_mass;
+      double allowed_error = mass * precursor_mass_tolerance * 1e-6;
+      std::vector< double >::const_iterator low_it = std::lower_bound(sorted_precursors.begin(), sorted_precursors.end(), mass - allowed_error);
+      if (low_it != sorted_precursors.end() && *low_it <= mass + allowed_error) ++expected_pairs;
+    }
+  }
+  TEST_EQUAL(enumerated_pairs > 0, true)
+  TEST_EQUAL(enumerated_pairs, expected_pairs)
+  TEST_EQUAL(sorted_positions.size(), window_precursors.size())
+
 END_SECTION
 
 // building more data structures required in the following test
@@ -268,7 +296,7 @@ START_SECTION(static void buildFragmentAnnotations(std::vector<PeptideHit::PeakA
 
 END_SECTION
 
-START_SECTION(static std::vector <OPXLDataStructs::ProteinProteinCrossLink> OPXLHelper::collectPrecursorCandidates(IntList precursor_correction_steps, double precursor_mass, double precursor_mass_tolerance, bool precursor_mass_tolerance_unit_ppm, std::vector<OPXLDataStructs::AASeqWithMass> filtered_peptide_masses, double cross_link_mass, DoubleList cross_link_mass_mono_link, StringList cross_link_residue1, StringList cross_link_residue2, String cross_link_name))
+START_SECTION(static std::vector <OPXLDataStructs::ProteinProteinCrossLink> OPXLHelper::collectPrecursorCandidates(const IntList& precursor_correction_steps, double precursor_mass, double precursor_mass_tolerance, bool precursor_mass_tolerance_unit_ppm, const std::vector<OPXLDataStructs::AASeqWithMass>& filtered_peptide_masses, double cross_link_mass, const DoubleList& cross_link_mass_mono_link, const StringList& cross_link_residue1, const StringList& cross_link_residue2, const String& cross_link_name))
 
   IntList precursor_correction_steps;
   precursor_correction_steps.push_back(2);
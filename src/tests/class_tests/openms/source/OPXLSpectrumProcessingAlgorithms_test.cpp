@@ -66,7 +66,7 @@ specGen.getLinearIonSpectrum(exp_spec_2, peptedi, 3, true, 3);
 specGen.getLinearIonSpectrum(theo_spec_1, peptide, 3, true, 3);
 specGen.getLinearIonSpectrum(theo_spec_2, peptedi, 4, true, 3);
 
-START_SECTION(static PeakSpectrum mergeAnnotatedSpectra(PeakSpectrum & first_spectrum, PeakSpectrum & second_spectrum))
+START_SECTION(static PeakSpectrum mergeAnnotatedSpectra(const PeakSpectrum & first_spectrum, const PeakSpectrum & second_spectrum))
 
   PeakSpectrum merged_spec = OPXLSpectrumProcessingAlgorithms::mergeAnnotatedSpectra(theo_spec_1, theo_spec_2);
 
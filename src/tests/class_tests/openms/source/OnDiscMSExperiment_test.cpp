@@ -198,6 +198,60 @@ START_SECTION((MSSpectrum getSpectrum(Size id)))
 }
 END_SECTION
 
+START_SECTION(boost::shared_ptr<const MSSpectrum> getCachedSpectrum(Size id))
+{
+  OnDiscPeakMap tmp; tmp.openFile(OPENMS_GET_TEST_DATA_PATH("IndexedmzMLFile_1.mzML"));
+  TEST_EQUAL(tmp.getNrCachedSpectra(), 0);
+  boost::shared_ptr<const MSSpectrum> s = tmp.getCachedSpectrum(0);
+  TEST_EQUAL(s->size(), 19914);
+  TEST_EQUAL(*s == tmp.getSpectrum(0), true);
+  TEST_EQUAL(tmp.getNrCachedSpectra(), 1);
+  // decoded only once
+  TEST_EQUAL(tmp.getCachedSpectrum(0).get() == s.get(), true);
+  // copies share the decoded spectra
+  OnDiscPeakMap copy(tmp);
+  TEST_EQUAL(copy.getCachedSpectrum(0).get() == s.get(), true);
+  TEST_EXCEPTION(Exception::IndexOverflow, tmp.getCachedSpectrum(2));
+
+  // concurrent first accesses
+  OnDiscPeakMap concurrent; concurrent.openFile(OPENMS_GET_TEST_DATA_PATH("IndexedmzMLFile_1.mzML"));
+  std::vector<const MSSpectrum*> first(20);
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
+  for (int k = 0; k < 20; k++)
+  {
+    first[k] = concurrent.getCachedSpectrum(k % 2).get();
+  }
+  Size nr_same(0);
+  for (Size k = 0; k < first.size(); k++)
+  {
+    nr_same += first[k] == first[k % 2];
+  }
+  TEST_EQUAL(nr_same, 20);
+  TEST_EQUAL(concurrent.getNrCachedSpectra(), 2);
+}
+END_SECTION
+
+START_SECTION(void clearSpectrumCache())
+{
+  OnDiscPeakMap tmp; tmp.openFile(OPENMS_GET_TEST_DATA_PATH("IndexedmzMLFile_1.mzML"));
+  boost::shared_ptr<const MSSpectrum> s = tmp.getCachedSpectrum(1);
+  TEST_EQUAL(tmp.getNrCachedSpectra(), 1);
+  tmp.clearSpectrumCache();
+  TEST_EQUAL(tmp.getNrCachedSpectra(), 0);
+  // still valid
+  TEST_EQUAL(s->empty(), false);
+  TEST_EQUAL(tmp.getCachedSpectrum(1)->size(), s->size());
+}
+END_SECTION
+
+START_SECTION(Size getNrCachedSpectra() const)
+{
+  NOT_TESTABLE // tested above
+}
+END_SECTION
+
 START_SECTION(OpenMS::Interfaces::SpectrumPtr getSpectrumById(Size id))
 {
   OnDiscPeakMap tmp; tmp.openFile(OPENMS_GET_TEST_DATA_PATH("IndexedmzMLFile_1.mzML"));
@@ -233,6 +287,35 @@ START_SECTION(OpenMS::Interfaces::ChromatogramPtr getChromatogramById(Size id))
 }
 END_SECTION
 
+START_SECTION(([EXTRA] concurrent access from multiple threads))
+{
+  OnDiscPeakMap tmp; tmp.openFile(OPENMS_GET_TEST_DATA_PATH("IndexedmzMLFile_1.mzML"));
+  TEST_EQUAL(tmp.getNrSpectra(), 2);
+
+  std::vector<Size> spectrum_sizes = {tmp.getSpectrum(0).size(), tmp.getSpectrum(1).size()};
+  TEST_EQUAL(spectrum_sizes[0], 19914);
+
+  // read the same spectra and chromatograms many times from one shared object
+  int nr_iterations (100), nr_correct (0);
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
+  for (int k = 0; k < nr_iterations; k++)
+  {
+    MSSpectrum s = tmp.getSpectrum(k % 2);
+    MSChromatogram c = tmp.getChromatogram(0);
+    bool correct = s.size() == spectrum_sizes[k % 2] && c.size() == 48;
+#ifdef _OPENMP
+#pragma omp critical (add_test)
+#endif
+    {
+      nr_correct += correct;
+    }
+  }
+  TEST_EQUAL(nr_correct, nr_iterations)
+}
+END_SECTION
+
 /////////////////////////////////////////////////////////////
 /////////////////////////////////////////////////////////////
 END_TEST
@@ -0,0 +1,240 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2018.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: Hannes Roest $
+// $Authors: Hannes Roest $
+// --------------------------------------------------------------------------
+
+
+#include <OpenMS/CONCEPT/ClassTest.h>
+#include <OpenMS/test_config.h>
+
+///////////////////////////
+#include <OpenMS/ANALYSIS/OPENSWATH/OpenSwathLibraryCache.h>
+///////////////////////////
+
+#include <OpenMS/ANALYSIS/OPENSWATH/DIAScoring.h>
+#include <OpenMS/CHEMISTRY/AASequence.h>
+
+#include <fstream>
+
+using namespace OpenMS;
+using namespace std;
+
+START_TEST(OpenSwathLibraryCache, "$Id$")
+
+/////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////
+
+OpenSwath::LightTargetedExperiment library;
+{
+  OpenSwath::LightCompound peptide;
+  peptide.id = "PEPTIDE_2";
+  peptide.sequence = "PEPTIDE";
+  peptide.charge = 2;
+  library.compounds.push_back(peptide);
+
+  OpenSwath::LightCompound metabolite;
+  metabolite.id = "Glucose";
+  metabolite.compound_name = "Glucose";
+  metabolite.sum_formula = "C6H12O6";
+  library.compounds.push_back(metabolite);
+
+  OpenSwath::LightTransition tr1;
+  tr1.transition_name = "tr1";
+  tr1.peptide_ref = "PEPTIDE_2";
+  tr1.product_mz = 500.0;
+  tr1.fragment_charge = 1;
+  library.transitions.push_back(tr1);
+
+  OpenSwath::LightTransition tr2;
+  tr2.transition_name = "tr2";
+  tr2.peptide_ref = "PEPTIDE_2";
+  tr2.product_mz = 600.0;
+  tr2.fragment_charge = 2;
+  library.transitions.push_back(tr2);
+
+  OpenSwath::LightTransition tr3;
+  tr3.transition_name = "tr3";
+  tr3.peptide_ref = "Glucose";
+  tr3.product_mz = 181.07;
+  library.transitions.push_back(tr3);
+}
+DIAScoring diascoring;
+
+OpenSwathLibraryCache* ptr = nullptr;
+OpenSwathLibraryCache* nullPointer = nullptr;
+
+START_SECTION(OpenSwathLibraryCache())
+{
+  ptr = new OpenSwathLibraryCache();
+  TEST_NOT_EQUAL(ptr, nullPointer)
+  TEST_EQUAL(ptr->empty(), true)
+  TEST_EQUAL(ptr->getCompound("PEPTIDE_2") == nullptr, true)
+  TEST_EQUAL(ptr->getIsotopePattern("tr1") == nullptr, true)
+  delete ptr;
+}
+END_SECTION
+
+START_SECTION(void compute(const OpenSwath::LightTargetedExperiment& library, const DIAScoring& diascoring))
+{
+  OpenSwathLibraryCache cache;
+  cache.compute(library, diascoring);
+  TEST_EQUAL(cache.empty(), false)
+  TEST_EQUAL(cache.getNrIsotopes(), 4)
+
+  // b/y series are only available for peptides and are the same as computed by DIAScoring
+  std::vector<double> bseries, yseries;
+  diascoring.getBYSeries(AASequence::fromString("PEPTIDE"), 1, bseries, yseries);
+  const OpenSwathLibraryCache::CompoundEntry* entry = cache.getCompound("PEPTIDE_2");
+  TEST_EQUAL(entry != nullptr, true)
+  TEST_EQUAL(cache.getCompound("Glucose") == nullptr, true)
+  ABORT_IF(entry == nullptr)
+  TEST_EQUAL(entry->bseries.size(), bseries.size())
+  TEST_EQUAL(entry->yseries.size(), yseries.size())
+  for (Size i = 0; i < bseries.size(); ++i)
+  {
+    TEST_REAL_SIMILAR(entry->bseries[i], bseries[i])
+  }
+  for (Size i = 0; i < yseries.size(); ++i)
+  {
+    TEST_REAL_SIMILAR(entry->yseries[i], yseries[i])
+  }
+
+  // isotope patterns use the fragment charge (1 if not set)
+  std::vector<double> expected;
+  const std::vector<double>* pattern = cache.getIsotopePattern("tr2");
+  diascoring.getTheoreticalIsotopePattern(600.0, 2, expected);
+  TEST_EQUAL(pattern != nullptr, true)
+  ABORT_IF(pattern == nullptr)
+  TEST_EQUAL(pattern->size(), expected.size())
+  for (Size i = 0; i < expected.size(); ++i)
+  {
+    TEST_REAL_SIMILAR((*pattern)[i], expected[i])
+  }
+  pattern = cache.getIsotopePattern("tr3");
+  diascoring.getTheoreticalIsotopePattern(181.07, 1, expected);
+  TEST_EQUAL(pattern != nullptr, true)
+  ABORT_IF(pattern == nullptr)
+  TEST_EQUAL(pattern->size(), expected.size())
+  TEST_REAL_SIMILAR((*pattern)[0], expected[0])
+  TEST_EQUAL(cache.getIsotopePattern("tr4") == nullptr, true)
+}
+END_SECTION
+
+START_SECTION(bool matches(const OpenSwath::LightTargetedExperiment& library, const DIAScoring& diascoring) const)
+{
+  OpenSwathLibraryCache cache;
+  TEST_EQUAL(cache.matches(library, diascoring), false)
+  cache.compute(library, diascoring);
+  TEST_EQUAL(cache.matches(library, diascoring), true)
+
+  // different library
+  OpenSwath::LightTargetedExperiment library2 = library;
+  library2.transitions[1].product_mz = 601.0;
+  TEST_EQUAL(cache.matches(library2, diascoring), false)
+
+  // different scoring parameters
+  DIAScoring diascoring2;
+  Param p = diascoring2.getDefaults();
+  p.setValue("dia_nr_isotopes", 3);
+  diascoring2.setParameters(p);
+  TEST_EQUAL(cache.matches(library, diascoring2), false)
+}
+END_SECTION
+
+START_SECTION(void store(const String& filename) const)
+{
+  NOT_TESTABLE // tested with load
+}
+END_SECTION
+
+START_SECTION(void load(const String& filename))
+{
+  OpenSwathLibraryCache cache;
+  cache.compute(library, diascoring);
+
+  std::string tmp_filename;
+  NEW_TMP_FILE(tmp_filename);
+  cache.store(tmp_filename);
+
+  OpenSwathLibraryCache loaded;
+  loaded.load(tmp_filename);
+  TEST_EQUAL(loaded.matches(library, diascoring), true)
+  TEST_EQUAL(loaded.getNrIsotopes(), cache.getNrIsotopes())
+  TEST_EQUAL(loaded.getCompound("PEPTIDE_2") != nullptr, true)
+  ABORT_IF(loaded.getCompound("PEPTIDE_2") == nullptr)
+  TEST_EQUAL(loaded.getCompound("PEPTIDE_2")->bseries == cache.getCompound("PEPTIDE_2")->bseries, true)
+  TEST_EQUAL(loaded.getCompound("PEPTIDE_2")->yseries == cache.getCompound("PEPTIDE_2")->yseries, true)
+  TEST_EQUAL(*loaded.getIsotopePattern("tr1") == *cache.getIsotopePattern("tr1"), true)
+  TEST_EQUAL(*loaded.getIsotopePattern("tr3") == *cache.getIsotopePattern("tr3"), true)
+
+  TEST_EXCEPTION(Exception::FileNotFound, loaded.load("this_file_does_not_exist.cache"))
+
+  // not a cache file
+  std::string tmp_filename2;
+  NEW_TMP_FILE(tmp_filename2);
+  {
+    std::ofstream ofs(tmp_filename2.c_str());
+    ofs << "not a cache file";
+  }
+  TEST_EXCEPTION(Exception::ParseError, loaded.load(tmp_filename2))
+  // a failed load leaves the cache unchanged
+  TEST_EQUAL(loaded.matches(library, diascoring), true)
+}
+END_SECTION
+
+START_SECTION(const CompoundEntry* getCompound(const std::string& compound_id) const)
+{
+  NOT_TESTABLE // tested above
+}
+END_SECTION
+
+START_SECTION(const std::vector<double>* getIsotopePattern(const std::string& transition_id) const)
+{
+  NOT_TESTABLE // tested above
+}
+END_SECTION
+
+START_SECTION(Int getNrIsotopes() const)
+{
+  TEST_EQUAL(OpenSwathLibraryCache().getNrIsotopes(), -1)
+}
+END_SECTION
+
+START_SECTION(bool empty() const)
+{
+  NOT_TESTABLE // tested above
+}
+END_SECTION
+
+/////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////
+END_TEST
@@ -292,6 +292,11 @@ START_SECTION(([Param::ParamNode] ParamEntry* findEntryRecursive(const String& n
 	TEST_EQUAL(pn.findEntryRecursive("H:X"),pe_nullPointer)
 	TEST_EQUAL(pn.findEntryRecursive("H:C:X"),pe_nullPointer)
 	TEST_EQUAL(pn.findEntryRecursive("H:C:"),pe_nullPointer)
+	// names which are prefixes or extensions of existing names
+	TEST_EQUAL(pn.findEntryRecursive("C:"),pe_nullPointer)
+	TEST_EQUAL(pn.findEntryRecursive("C:DD"),pe_nullPointer)
+	TEST_EQUAL(pn.findEntryRecursive("CC:D"),pe_nullPointer)
+	TEST_EQUAL(pn.findEntryRecursive(":C:D"),pe_nullPointer)
 END_SECTION
 
 //Dummy Tree:
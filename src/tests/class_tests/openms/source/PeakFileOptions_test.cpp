@@ -246,6 +246,23 @@ START_SECTION(void setMaxDataPoolSize(Size size))
 }
 END_SECTION
 
+START_SECTION(bool getUseIndexedSelection() const)
+{
+	PeakFileOptions tmp;
+	TEST_EQUAL(tmp.getUseIndexedSelection(), false);
+}
+END_SECTION
+
+START_SECTION(void setUseIndexedSelection(bool use))
+{
+	PeakFileOptions tmp;
+	tmp.setUseIndexedSelection(true);
+	TEST_EQUAL(tmp.getUseIndexedSelection(), true);
+	PeakFileOptions copy(tmp);
+	TEST_EQUAL(copy.getUseIndexedSelection(), true);
+}
+END_SECTION
+
 
 /////////////////////////////////////////////////////////////
 /////////////////////////////////////////////////////////////
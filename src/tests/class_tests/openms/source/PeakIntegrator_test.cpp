@@ -942,6 +942,87 @@ START_SECTION(PeakShapeMetrics calculatePeakShapeMetrics(
 }
 END_SECTION
 
+START_SECTION(void integratePeaks(
+  const std::vector<PeakIntegrationJob>& jobs,
+  std::vector<PeakArea>& areas,
+  std::vector<PeakBackground>& backgrounds,
+  const bool compute_hull_points = false
+) const)
+{
+  // boundaries covering odd / even / one / two points, the batch has to agree with the single peak methods
+  std::vector<std::pair<double, double> > boundaries;
+  boundaries.push_back(std::make_pair(left, right));
+  boundaries.push_back(std::make_pair(left, 3.011416667));
+  boundaries.push_back(std::make_pair(left, 2.478));
+  boundaries.push_back(std::make_pair(left, 2.489));
+  boundaries.push_back(std::make_pair(left_few, right_few));
+  boundaries.push_back(std::make_pair(position.front(), position.back()));
+
+  std::vector<PeakIntegrator::PeakIntegrationJob> jobs;
+  for (Size i = 0; i < boundaries.size(); ++i)
+  {
+    PeakIntegrator::PeakIntegrationJob job;
+    job.pos = &position[0];
+    job.intensity = &intensity[0];
+    job.size = position.size();
+    job.left = boundaries[i].first;
+    job.right = boundaries[i].second;
+    jobs.push_back(job);
+  }
+
+  std::vector<String> integration_types = ListUtils::create<String>(String(INTEGRATION_TYPE_INTENSITYSUM) + "," + INTEGRATION_TYPE_TRAPEZOID + "," + INTEGRATION_TYPE_SIMPSON);
+  std::vector<String> baseline_types = ListUtils::create<String>(String(BASELINE_TYPE_BASETOBASE) + "," + BASELINE_TYPE_VERTICALDIVISION_MIN + "," + BASELINE_TYPE_VERTICALDIVISION_MAX);
+  Param params = ptr->getParameters();
+  std::vector<PeakIntegrator::PeakArea> areas;
+  std::vector<PeakIntegrator::PeakBackground> backgrounds;
+  for (Size t = 0; t < integration_types.size(); ++t)
+  {
+    for (Size b = 0; b < baseline_types.size(); ++b)
+    {
+      STATUS("Integration type: " + integration_types[t] + ", baseline type: " + baseline_types[b])
+      params.setValue("integration_type", integration_types[t]);
+      params.setValue("baseline_type", baseline_types[b]);
+      ptr->setParameters(params);
+      ptr->integratePeaks(jobs, areas, backgrounds, true);
+      TEST_EQUAL(areas.size(), jobs.size())
+      TEST_EQUAL(backgrounds.size(), jobs.size())
+      for (Size i = 0; i < jobs.size(); ++i)
+      {
+        PeakIntegrator::PeakArea pa = ptr->integratePeak(chromatogram, jobs[i].left, jobs[i].right);
+        PeakIntegrator::PeakBackground pb = ptr->estimateBackground(chromatogram, jobs[i].left, jobs[i].right, pa.apex_pos);
+        TEST_REAL_SIMILAR(areas[i].area, pa.area)
+        TEST_REAL_SIMILAR(areas[i].height, pa.height)
+        TEST_REAL_SIMILAR(areas[i].apex_pos, pa.apex_pos)
+        TEST_EQUAL(areas[i].hull_points.size(), pa.hull_points.size())
+        // a single point has no extent, the background is not defined there
+        if (pa.hull_points.size() < 2) continue;
+        TEST_REAL_SIMILAR(backgrounds[i].area, pb.area)
+        TEST_REAL_SIMILAR(backgrounds[i].height, pb.height)
+      }
+    }
+  }
+
+  // hull points are only computed on request
+  ptr->integratePeaks(jobs, areas, backgrounds);
+  TEST_EQUAL(areas[0].hull_points.empty(), true)
+
+  // no point within the boundaries
+  PeakIntegrator::PeakIntegrationJob empty_job = jobs[0];
+  empty_job.left = 10.0;
+  empty_job.right = 11.0;
+  ptr->integratePeaks(std::vector<PeakIntegrator::PeakIntegrationJob>(1, empty_job), areas, backgrounds);
+  TEST_EQUAL(areas.size(), 1)
+  TEST_REAL_SIMILAR(areas[0].area, 0.0)
+  TEST_REAL_SIMILAR(areas[0].height, 0.0)
+  TEST_REAL_SIMILAR(areas[0].apex_pos, 10.5)
+  TEST_REAL_SIMILAR(backgrounds[0].area, 0.0)
+
+  params.setValue("integration_type", INTEGRATION_TYPE_INTENSITYSUM);
+  params.setValue("baseline_type", BASELINE_TYPE_BASETOBASE);
+  ptr->setParameters(params);
+}
+END_SECTION
+
 START_SECTION([EXTRA]  template <typename PeakContainerConstIteratorT> double findPosAtPeakHeightPercent_(...))
 {
   PeakIntegratorTest pit;
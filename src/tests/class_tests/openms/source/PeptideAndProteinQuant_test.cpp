@@ -258,6 +258,41 @@ START_SECTION((const ProteinQuant& getProteinResults()))
 }
 END_SECTION
 
+START_SECTION((PeptideMatrix getPeptideMatrix() const))
+{
+  PeptideAndProteinQuant::PeptideMatrix matrix =
+    quantifier_consensus.getPeptideMatrix();
+  TEST_EQUAL(matrix.peptides.size(), 4);
+  TEST_EQUAL(matrix.samples.size(), 3);
+  TEST_EQUAL(matrix.abundances.size(), 12);
+  ABORT_IF(matrix.abundances.size() != 12);
+  TEST_EQUAL(matrix.peptides[0], AASequence::fromString("AAA"));
+  TEST_EQUAL(matrix.peptides[3], AASequence::fromString("GGG"));
+  TEST_EQUAL(matrix.samples[0], 0);
+  TEST_EQUAL(matrix.samples[2], 2);
+  TEST_REAL_SIMILAR(matrix(0, 0), 1000);
+  TEST_REAL_SIMILAR(matrix(0, 1), 0);
+  TEST_REAL_SIMILAR(matrix(0, 2), 1000);
+  TEST_REAL_SIMILAR(matrix(1, 1), 200);
+  TEST_REAL_SIMILAR(matrix(2, 2), 30);
+  TEST_REAL_SIMILAR(matrix(3, 0), 4);
+  TEST_REAL_SIMILAR(matrix(3, 2), 0);
+
+  // peptides that are only identified (not quantified) are skipped:
+  matrix = quantifier_features.getPeptideMatrix();
+  TEST_EQUAL(matrix.samples.size(), 1);
+  TEST_EQUAL(matrix.abundances.size(), matrix.peptides.size());
+  TEST_EQUAL(find(matrix.peptides.begin(), matrix.peptides.end(),
+                  AASequence::fromString("EEEEE")) == matrix.peptides.end(),
+             true);
+
+  PeptideAndProteinQuant empty;
+  matrix = empty.getPeptideMatrix();
+  TEST_EQUAL(matrix.peptides.empty(), true);
+  TEST_EQUAL(matrix.samples.empty(), true);
+}
+END_SECTION
+
 START_SECTION(([PeptideAndProteinQuant::PeptideData] PeptideData()))
 {
   PeptideAndProteinQuant::PeptideData data;
@@ -0,0 +1,172 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2018.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: Hannes Roest $
+// $Authors: Hannes Roest $
+// --------------------------------------------------------------------------
+
+
+#include <OpenMS/CONCEPT/ClassTest.h>
+#include <OpenMS/test_config.h>
+
+///////////////////////////
+#include <OpenMS/FORMAT/PeptideDatabaseFile.h>
+///////////////////////////
+
+#include <OpenMS/CHEMISTRY/AASequence.h>
+
+using namespace OpenMS;
+using namespace std;
+
+START_TEST(PeptideDatabaseFile, "$Id$")
+
+/////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////
+
+PeptideDatabaseFile* ptr = nullptr;
+PeptideDatabaseFile* nullPointer = nullptr;
+
+START_SECTION(PeptideDatabaseFile())
+{
+  ptr = new PeptideDatabaseFile();
+  TEST_NOT_EQUAL(ptr, nullPointer)
+  TEST_EQUAL(ptr->getNrProteins(), 0)
+  TEST_EQUAL(ptr->getNrVariants(), 0)
+}
+END_SECTION
+
+START_SECTION(~PeptideDatabaseFile())
+{
+  delete ptr;
+}
+END_SECTION
+
+vector<FASTAFile::FASTAEntry> proteins(3);
+proteins[0].identifier = "P1";
+proteins[0].sequence = "MSAMPLERVALIDEKGGGGGGGGK";
+proteins[1].identifier = "P2";
+proteins[1].sequence = "AAAAAAAKVALIDEK";
+proteins[2].identifier = "DECOY_P3";
+proteins[2].sequence = "XXXXXXXXRMMMMMMMK";
+
+PeptideDatabaseFile::Settings settings;
+settings.missed_cleavages = 0;
+settings.min_length = 7;
+settings.max_length = 40;
+settings.variable_modifications.push_back("Oxidation (M)");
+settings.max_variable_mods_per_peptide = 1;
+
+String tmp_filename;
+NEW_TMP_FILE(tmp_filename)
+
+START_SECTION((static void store(const String& filename, const std::vector<FASTAFile::FASTAEntry>& proteins, const Settings& settings)))
+{
+  PeptideDatabaseFile::store(tmp_filename, proteins, settings);
+  NOT_TESTABLE // tested with load
+}
+END_SECTION
+
+START_SECTION(void load(const String& filename))
+{
+  PeptideDatabaseFile db;
+  db.load(tmp_filename);
+  TEST_EQUAL(db.getNrProteins(), 3)
+  TEST_EQUAL(db.getProteinAccession(2), "DECOY_P3")
+
+  // peptides: MSAMPLER, VALIDEK, GGGGGGGGK, AAAAAAAK, MMMMMMMK (XXXXXXXXR is skipped)
+  TEST_EQUAL(db.getNrPeptides(), 5)
+  TEST_EQUAL(db.getPeptideSequence(1).getString(), "VALIDEK")
+
+  // MSAMPLER has two variants with one oxidation and MMMMMMMK seven
+  TEST_EQUAL(db.getNrVariants(), 5 + 2 + 7)
+  for (Size v = 1; v < db.getNrVariants(); ++v)
+  {
+    TEST_EQUAL(db.getVariantMass(v - 1) <= db.getVariantMass(v), true)
+  }
+  for (Size v = 0; v < db.getNrVariants(); ++v)
+  {
+    AASequence aas = AASequence::fromString(db.getVariantSequence(v).getString());
+    TEST_REAL_SIMILAR(aas.getMonoWeight(), db.getVariantMass(v))
+    TEST_EQUAL(aas.toUnmodifiedString(), db.getPeptideSequence(db.getVariantPeptide(v)).getString())
+  }
+
+  TEST_EQUAL(db.getSettings() == settings, true)
+  PeptideDatabaseFile::Settings other = settings;
+  other.missed_cleavages = 1;
+  TEST_EQUAL(db.getSettings() != other, true)
+
+  TEST_EXCEPTION(Exception::FileNotFound, db.load("this_file_does_not_exist.pepdb"))
+  TEST_EXCEPTION(Exception::ParseError, db.load(OPENMS_GET_TEST_DATA_PATH("FASTAFile_test.fasta")))
+}
+END_SECTION
+
+START_SECTION((void getPeptideReferences(Size peptide, std::vector<PeptideReference>& references) const))
+{
+  PeptideDatabaseFile db;
+  db.load(tmp_filename);
+  vector<PeptideDatabaseFile::PeptideReference> refs;
+  db.getPeptideReferences(1, refs); // VALIDEK
+  TEST_EQUAL(refs.size(), 2)
+  TEST_EQUAL(refs[0].protein, 0)
+  TEST_EQUAL(refs[0].start, 8)
+  TEST_EQUAL(refs[0].aa_before, 'R')
+  TEST_EQUAL(refs[0].aa_after, 'G')
+  TEST_EQUAL(refs[1].protein, 1)
+  TEST_EQUAL(refs[1].start, 8)
+  TEST_EQUAL(refs[1].aa_before, 'K')
+  TEST_EQUAL(refs[1].aa_after, ']')
+
+  db.getPeptideReferences(0, refs); // MSAMPLER
+  TEST_EQUAL(refs.size(), 1)
+  TEST_EQUAL(refs[0].aa_before, '[')
+}
+END_SECTION
+
+START_SECTION((std::pair<Size, Size> getVariantRange(double mass_min, double mass_max) const))
+{
+  PeptideDatabaseFile db;
+  db.load(tmp_filename);
+  double mass = AASequence::fromString("VALIDEK").getMonoWeight();
+  pair<Size, Size> range = db.getVariantRange(mass - 0.01, mass + 0.01);
+  TEST_EQUAL(range.second - range.first, 1)
+  TEST_EQUAL(db.getVariantSequence(range.first).getString(), "VALIDEK")
+
+  range = db.getVariantRange(0.0, 1e6);
+  TEST_EQUAL(range.first, 0)
+  TEST_EQUAL(range.second, db.getNrVariants())
+
+  range = db.getVariantRange(1e5, 1e6);
+  TEST_EQUAL(range.first, range.second)
+}
+END_SECTION
+
+/////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////
+END_TEST
@@ -206,6 +206,54 @@ START_SECTION((void fit( std::vector<double>& search_engine_scores, std::vector<
 
 END_SECTION
 
+START_SECTION([EXTRA] fit on a histogram of the scores (fit_bins))
+{
+	vector<double> scores;
+	CsvFile gauss_mix (OPENMS_GET_TEST_DATA_PATH("GaussMix_2_1D.csv"), ';');
+	StringList gauss_mix_strings;
+	gauss_mix.getRow(0, gauss_mix_strings);
+	for (StringList::const_iterator it = gauss_mix_strings.begin(); it != gauss_mix_strings.end(); ++it)
+	{
+		if (!it->empty()) scores.push_back(it->toDouble());
+	}
+	vector<double> binned_scores = scores;
+
+	PosteriorErrorProbabilityModel full, binned;
+	Param param;
+	param.setValue("incorrectly_assigned", "Gauss");
+	full.setParameters(param);
+	param.setValue("fit_bins", 500);
+	binned.setParameters(param);
+
+	vector<double> full_probabilities, binned_probabilities;
+	TEST_EQUAL(full.fit(scores, full_probabilities), true)
+	TEST_EQUAL(binned.fit(binned_scores, binned_probabilities), true)
+
+	// the fit on the histogram is close to the fit on all scores
+	TOLERANCE_ABSOLUTE(0.05)
+	TEST_REAL_SIMILAR(binned.getCorrectlyAssignedFitResult().x0, full.getCorrectlyAssignedFitResult().x0)
+	TEST_REAL_SIMILAR(binned.getCorrectlyAssignedFitResult().sigma, full.getCorrectlyAssignedFitResult().sigma)
+	TEST_REAL_SIMILAR(binned.getIncorrectlyAssignedFitResult().x0, full.getIncorrectlyAssignedFitResult().x0)
+	TEST_REAL_SIMILAR(binned.getIncorrectlyAssignedFitResult().sigma, full.getIncorrectlyAssignedFitResult().sigma)
+	TEST_REAL_SIMILAR(binned.getNegativePrior(), full.getNegativePrior())
+	TEST_EQUAL(binned_probabilities.size(), full_probabilities.size())
+	for (Size i = 0; i < full_probabilities.size(); i += 100)
+	{
+		TEST_REAL_SIMILAR(binned_probabilities[i], full_probabilities[i])
+	}
+
+	// more bins than scores: all scores are used
+	PosteriorErrorProbabilityModel many_bins;
+	param.setValue("fit_bins", 5000);
+	many_bins.setParameters(param);
+	vector<double> many_scores = scores;
+	many_bins.fit(many_scores);
+	TOLERANCE_ABSOLUTE(1e-6)
+	TEST_REAL_SIMILAR(many_bins.getCorrectlyAssignedFitResult().x0, full.getCorrectlyAssignedFitResult().x0)
+	TEST_REAL_SIMILAR(many_bins.getNegativePrior(), full.getNegativePrior())
+}
+END_SECTION
+
 START_SECTION((void fillDensities(std::vector<double>& x_scores,std::vector<double>& incorrect_density,std::vector<double>& correct_density)))
 NOT_TESTABLE
 //tested in fit
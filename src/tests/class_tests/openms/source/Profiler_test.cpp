@@ -0,0 +1,166 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry               
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2018.
+// 
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution 
+//    may be used to endorse or promote products derived from this software 
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS. 
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING 
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, 
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, 
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; 
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, 
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR 
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF 
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+// 
+// --------------------------------------------------------------------------
+// $Maintainer: Chris Bielow $
+// $Authors: Chris Bielow $
+// --------------------------------------------------------------------------
+
+#include <OpenMS/CONCEPT/ClassTest.h>
+#include <OpenMS/test_config.h>
+
+///////////////////////////
+
+#include <OpenMS/SYSTEM/Profiler.h>
+#include <fstream>
+#include <iterator>
+#include <sstream>
+/////////////////////////////////////////////////////////////
+
+using namespace OpenMS;
+
+void busy(int ms)
+{
+  Int64 end = Profiler::now() + Int64(ms) * 1000000;
+  while (Profiler::now() < end) {}
+}
+
+START_TEST(Profiler, "$Id$")
+
+/////////////////////////////////////////////////////////////
+
+START_SECTION((static bool isEnabled()))
+  TEST_EQUAL(Profiler::isEnabled(), false)
+  {
+    OPENMS_PROFILE_SCOPE("disabled");
+    Profiler::addCount("disabled");
+  }
+  TEST_EQUAL(Profiler::getEvents().size(), 0)
+  TEST_EQUAL(Profiler::getCounts().size(), 0)
+END_SECTION
+
+START_SECTION((static void setEnabled(bool enabled)))
+  Profiler::setEnabled(true);
+  TEST_EQUAL(Profiler::isEnabled(), true)
+  Profiler::setEnabled(false);
+  TEST_EQUAL(Profiler::isEnabled(), false)
+END_SECTION
+
+START_SECTION((static std::vector<Event> getEvents()))
+  Profiler::setEnabled(true);
+  {
+    OPENMS_PROFILE_SCOPE("outer");
+    busy(2);
+    {
+      OPENMS_PROFILE_SCOPE("inner");
+      busy(5);
+    }
+  }
+  Profiler::setEnabled(false);
+  std::vector<Profiler::Event> events = Profiler::getEvents();
+  TEST_EQUAL(events.size(), 2)
+  // ordered by end time: the nested region comes first
+  TEST_EQUAL(String(events[0].name), "inner")
+  TEST_EQUAL(events[0].depth, 1)
+  TEST_EQUAL(events[0].self, events[0].duration)
+  TEST_EQUAL(String(events[1].name), "outer")
+  TEST_EQUAL(events[1].depth, 0)
+  TEST_EQUAL(events[1].self, events[1].duration - events[0].duration)
+  TEST_EQUAL(events[1].start <= events[0].start, true)
+  TEST_EQUAL(events[0].duration >= 5000000, true)
+END_SECTION
+
+START_SECTION((static void addCount(const char* name, double value = 1.0)))
+  Profiler::setEnabled(true);
+  Profiler::addCount("spectra");
+  Profiler::addCount("spectra", 2.0);
+  Profiler::addCount("bytes", 10.0);
+  Profiler::setEnabled(false);
+  std::vector<std::pair<String, double> > counts = Profiler::getCounts();
+  TEST_EQUAL(counts.size(), 2)
+  TEST_EQUAL(counts[0].first, "bytes")
+  TEST_REAL_SIMILAR(counts[0].second, 10.0)
+  TEST_EQUAL(counts[1].first, "spectra")
+  TEST_REAL_SIMILAR(counts[1].second, 3.0)
+END_SECTION
+
+START_SECTION((static std::vector<RegionSummary> getSummary()))
+  Profiler::setEnabled(true);
+  for (Size i = 0; i < 3; ++i)
+  {
+    OPENMS_PROFILE_SCOPE("inner");
+  }
+  Profiler::setEnabled(false);
+  std::vector<Profiler::RegionSummary> summary = Profiler::getSummary();
+  TEST_EQUAL(summary.size(), 2)
+  // sorted by total time
+  TEST_EQUAL(summary[0].name, "outer")
+  TEST_EQUAL(summary[0].calls, 1)
+  TEST_EQUAL(summary[1].name, "inner")
+  TEST_EQUAL(summary[1].calls, 4)
+  TEST_EQUAL(summary[0].self <= summary[0].total, true)
+  TEST_EQUAL(summary[1].max <= summary[1].total, true)
+END_SECTION
+
+START_SECTION((static void printSummary(std::ostream& os)))
+  std::stringstream ss;
+  Profiler::printSummary(ss);
+  TEST_EQUAL(ss.str().find("outer") != std::string::npos, true)
+  TEST_EQUAL(ss.str().find("spectra") != std::string::npos, true)
+END_SECTION
+
+START_SECTION((static void storeChromeTrace(const String& filename)))
+  String tmp_file;
+  NEW_TMP_FILE(tmp_file)
+  Profiler::storeChromeTrace(tmp_file);
+  std::ifstream is(tmp_file.c_str());
+  String content((std::istreambuf_iterator<char>(is)), std::istreambuf_iterator<char>());
+  TEST_EQUAL(content.hasPrefix("{\"traceEvents\""), true)
+  TEST_EQUAL(content.hasSubstring("\"name\":\"outer\""), true)
+  TEST_EQUAL(content.hasSubstring("\"ph\":\"X\""), true)
+
+  TEST_EXCEPTION(Exception::UnableToCreateFile, Profiler::storeChromeTrace("/does/not/exist/trace.json"))
+END_SECTION
+
+START_SECTION((static void clear()))
+  Profiler::clear();
+  TEST_EQUAL(Profiler::getEvents().size(), 0)
+  TEST_EQUAL(Profiler::getCounts().size(), 0)
+  TEST_EQUAL(Profiler::getSummary().size(), 0)
+END_SECTION
+
+START_SECTION((static Int64 now()))
+  Int64 t1 = Profiler::now();
+  busy(1);
+  TEST_EQUAL(Profiler::now() > t1, true)
+END_SECTION
+
+/////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////
+END_TEST
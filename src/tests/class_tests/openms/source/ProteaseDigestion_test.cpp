@@ -255,6 +255,58 @@ START_SECTION((Size digest(const AASequence& protein, std::vector<AASequence>& o
     TEST_EQUAL(out.size(), 4*3/2)
 END_SECTION
 
+START_SECTION((template <typename TBackend> Size digestChunk(const FASTAContainer<TBackend>& proteins, std::vector<DigestionProduct>& output, Size min_length = 1, Size max_length = 0, double min_mass = 0, double max_mass = 0) const))
+    vector<FASTAFile::FASTAEntry> entries;
+    entries.push_back(FASTAFile::FASTAEntry("P1", "", "ACKDERPLLKAAGGRK"));
+    entries.push_back(FASTAFile::FASTAEntry("P2", "", "MKWVTFISLLLLFSSAYSRGVFRR"));
+    entries.push_back(FASTAFile::FASTAEntry("P3", "", "PEPTIDEK"));
+    FASTAContainer<TFI_Vector> proteins(entries);
+    proteins.activateCache();
+
+    ProteaseDigestion pd;
+    pd.setMissedCleavages(2);
+    vector<ProteaseDigestion::DigestionProduct> products;
+    Size discarded = pd.digestChunk(proteins, products, 2, 10);
+
+    // same peptides (and order) as digest() on every protein
+    vector<AASequence> expected;
+    Size expected_discarded(0), k(0);
+    for (Size i = 0; i < entries.size(); ++i)
+    {
+      vector<AASequence> out;
+      expected_discarded += pd.digest(AASequence::fromString(entries[i].sequence), out, 2, 10);
+      for (Size j = 0; j < out.size(); ++j, ++k)
+      {
+        ABORT_IF(k >= products.size())
+        TEST_EQUAL(products[k].protein_index, i)
+        TEST_EQUAL(entries[i].sequence.substr(products[k].start, products[k].length), out[j].toString())
+        TEST_REAL_SIMILAR(products[k].mono_weight, out[j].getMonoWeight())
+      }
+    }
+    TEST_EQUAL(products.size(), k)
+    TEST_EQUAL(discarded, expected_discarded)
+
+    // weight filter is applied before sequence objects are built
+    discarded = pd.digestChunk(proteins, products, 1, 0, 500.0, 1000.0);
+    TEST_EQUAL(products.empty(), false)
+    for (Size i = 0; i < products.size(); ++i)
+    {
+      TEST_EQUAL(products[i].mono_weight >= 500.0 && products[i].mono_weight <= 1000.0, true)
+    }
+
+    // unknown residues: peptide is discarded
+    entries.clear();
+    entries.push_back(FASTAFile::FASTAEntry("P4", "", "AC#KDE"));
+    FASTAContainer<TFI_Vector> unknown(entries);
+    unknown.activateCache();
+    pd.setMissedCleavages(0);
+    discarded = pd.digestChunk(unknown, products);
+    TEST_EQUAL(products.size(), 1)
+    TEST_EQUAL(products[0].start, 4)
+    TEST_EQUAL(products[0].length, 2)
+    TEST_EQUAL(discarded, 1)
+END_SECTION
+
 START_SECTION((bool isValidProduct(const String& protein, int pep_pos, int pep_length, bool ignore_missed_cleavages, bool allow_nterm_protein_cleavage, bool allow_random_asp_pro_cleavage)))
     NOT_TESTABLE // tested by overload below
 END_SECTION
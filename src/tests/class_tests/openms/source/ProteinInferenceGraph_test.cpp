@@ -0,0 +1,225 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2018.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: Julianus Pfeuffer $
+// $Authors: Hannes Roest $
+// --------------------------------------------------------------------------
+
+
+#include <OpenMS/CONCEPT/ClassTest.h>
+#include <OpenMS/test_config.h>
+
+///////////////////////////
+#include <OpenMS/ANALYSIS/ID/ProteinInferenceGraph.h>
+///////////////////////////
+
+using namespace OpenMS;
+using namespace std;
+
+START_TEST(ProteinInferenceGraph, "$Id$")
+
+/////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////
+
+// proteins A-E; peptides (PEP): PEPTMIDEA (0.1, 0.3, 0.4) -> A, PEPTIDEB (0.2) -> A, B,
+// PEPTIDEC (0.5) -> B, C, D, PEPTIDEE (0.05) -> E
+ProteinIdentification protein;
+const char* accessions[] = {"A", "B", "C", "D", "E"};
+for (Size i = 0; i < 5; ++i)
+{
+  ProteinHit hit;
+  hit.setAccession(accessions[i]);
+  protein.insertHit(hit);
+}
+
+vector<PeptideIdentification> peptides;
+const char* sequences[] = {"PEPTM(Oxidation)IDEA", "PEPTIDEB", "PEPTIDEC", "PEPTIDEE", "PEPTMIDEA", "PEPTMIDEA"};
+const char* proteins[] = {"A", "AB", "BCD", "E", "A", "A"};
+double scores[] = {0.1, 0.2, 0.5, 0.05, 0.3, 0.4};
+for (Size i = 0; i < 6; ++i)
+{
+  PeptideHit hit;
+  hit.setSequence(AASequence::fromString(sequences[i]));
+  hit.setScore(scores[i]);
+  for (const char* acc = proteins[i]; *acc; ++acc)
+  {
+    PeptideEvidence evidence;
+    evidence.setProteinAccession(String(*acc));
+    hit.addPeptideEvidence(evidence);
+  }
+  // unknown protein, ignored:
+  PeptideEvidence evidence;
+  evidence.setProteinAccession("X");
+  hit.addPeptideEvidence(evidence);
+
+  PeptideIdentification pep_id;
+  pep_id.setScoreType("Posterior Error Probability");
+  pep_id.setHigherScoreBetter(false);
+  pep_id.insertHit(hit);
+  peptides.push_back(pep_id);
+}
+peptides.push_back(PeptideIdentification()); // no hits
+
+ProteinInferenceGraph* ptr = nullptr;
+ProteinInferenceGraph* null_ptr = nullptr;
+START_SECTION(ProteinInferenceGraph())
+{
+  ptr = new ProteinInferenceGraph();
+  TEST_NOT_EQUAL(ptr, null_ptr)
+  TEST_EQUAL(ptr->getNumberOfProteins(), 0)
+  TEST_EQUAL(ptr->getNumberOfPeptides(), 0)
+  TEST_EQUAL(ptr->getNumberOfComponents(), 0)
+  delete ptr;
+}
+END_SECTION
+
+ProteinInferenceGraph graph;
+
+START_SECTION((void build(const ProteinIdentification& protein, const std::vector<PeptideIdentification>& peptides)))
+{
+  graph.build(protein, peptides);
+  TEST_EQUAL(graph.getNumberOfProteins(), 5)
+  TEST_EQUAL(graph.getNumberOfPeptides(), 4)
+  TEST_EQUAL(graph.getNumberOfComponents(), 2)
+}
+END_SECTION
+
+START_SECTION((Size getNumberOfProteins() const))
+{
+  NOT_TESTABLE // tested above
+}
+END_SECTION
+
+START_SECTION((Size getNumberOfPeptides() const))
+{
+  NOT_TESTABLE // tested above
+}
+END_SECTION
+
+START_SECTION((Size getNumberOfComponents() const))
+{
+  NOT_TESTABLE // tested above
+}
+END_SECTION
+
+START_SECTION((Size getComponent(Size protein) const))
+{
+  TEST_EQUAL(graph.getComponent(0), 0)
+  TEST_EQUAL(graph.getComponent(1), 0)
+  TEST_EQUAL(graph.getComponent(2), 0)
+  TEST_EQUAL(graph.getComponent(3), 0)
+  TEST_EQUAL(graph.getComponent(4), 1)
+}
+END_SECTION
+
+START_SECTION((const String& getPeptideSequence(Size peptide) const))
+{
+  TEST_EQUAL(graph.getPeptideSequence(0), "PEPTMIDEA")
+  TEST_EQUAL(graph.getPeptideSequence(3), "PEPTIDEE")
+}
+END_SECTION
+
+START_SECTION((double getPeptideProbability(Size peptide) const))
+{
+  TEST_REAL_SIMILAR(graph.getPeptideProbability(0), 0.9) // best of three
+  TEST_REAL_SIMILAR(graph.getPeptideProbability(1), 0.8)
+  TEST_REAL_SIMILAR(graph.getPeptideProbability(2), 0.5)
+  TEST_REAL_SIMILAR(graph.getPeptideProbability(3), 0.95)
+}
+END_SECTION
+
+START_SECTION((void getPeptides(Size protein, std::vector<Size>& peptides) const))
+{
+  vector<Size> result;
+  graph.getPeptides(1, result);
+  TEST_EQUAL(result.size(), 2)
+  ABORT_IF(result.size() != 2)
+  TEST_EQUAL(result[0], 1)
+  TEST_EQUAL(result[1], 2)
+}
+END_SECTION
+
+START_SECTION((void getProteins(Size peptide, std::vector<Size>& proteins) const))
+{
+  vector<Size> result;
+  graph.getProteins(2, result);
+  TEST_EQUAL(result.size(), 3)
+  ABORT_IF(result.size() != 3)
+  TEST_EQUAL(result[0], 1)
+  TEST_EQUAL(result[1], 2)
+  TEST_EQUAL(result[2], 3)
+}
+END_SECTION
+
+START_SECTION((void infer(ProteinIdentification& protein, InferenceMethod method, Size max_iterations = 100, double tolerance = 1e-6) const))
+{
+  ProteinIdentification result = protein;
+  graph.infer(result, ProteinInferenceGraph::PARSIMONY);
+  TEST_EQUAL(result.isHigherScoreBetter(), true)
+  // A is selected first (more evidence than B), then B (before C/D by order):
+  TEST_REAL_SIMILAR(result.getHits()[0].getScore(), 1.0)
+  TEST_REAL_SIMILAR(result.getHits()[1].getScore(), 1.0)
+  TEST_REAL_SIMILAR(result.getHits()[2].getScore(), 0.0)
+  TEST_REAL_SIMILAR(result.getHits()[3].getScore(), 0.0)
+  TEST_REAL_SIMILAR(result.getHits()[4].getScore(), 1.0)
+  TEST_EQUAL(result.getIndistinguishableProteins().size(), 4)
+  TEST_EQUAL(result.getProteinGroups().size(), 3)
+  ABORT_IF(result.getIndistinguishableProteins().size() != 4)
+  TEST_EQUAL(result.getIndistinguishableProteins()[2].accessions.size(), 2)
+  TEST_EQUAL(result.getIndistinguishableProteins()[2].accessions[0], "C")
+  TEST_EQUAL(result.getIndistinguishableProteins()[2].accessions[1], "D")
+
+  result = protein;
+  graph.infer(result, ProteinInferenceGraph::BAYESIAN);
+  TEST_EQUAL(result.getScoreType(), "Posterior Probability")
+  TEST_EQUAL(result.getProteinGroups().size(), 4)
+  TEST_REAL_SIMILAR(result.getHits()[0].getScore(), 0.946997)
+  TEST_REAL_SIMILAR(result.getHits()[1].getScore(), 0.665013)
+  TEST_EQUAL(result.getHits()[2].getScore() < 1e-5, true)
+  TEST_EQUAL(result.getHits()[2].getScore(), result.getHits()[3].getScore())
+  TEST_REAL_SIMILAR(result.getHits()[4].getScore(), 0.95)
+
+  ProteinIdentification empty;
+  TEST_EXCEPTION(Exception::IllegalArgument, graph.infer(empty, ProteinInferenceGraph::PARSIMONY))
+
+  // scores that are not probabilities:
+  vector<PeptideIdentification> other = peptides;
+  other[0].getHits()[0].setScore(12.3);
+  ProteinInferenceGraph other_graph;
+  other_graph.build(protein, other);
+  result = protein;
+  other_graph.infer(result, ProteinInferenceGraph::PARSIMONY);
+  TEST_EXCEPTION(Exception::InvalidValue, other_graph.infer(result, ProteinInferenceGraph::BAYESIAN))
+}
+END_SECTION
+
+/////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////
+END_TEST
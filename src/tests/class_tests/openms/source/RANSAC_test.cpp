@@ -61,6 +61,43 @@ START_SECTION((static std::vector<std::pair<double, double> > ransac(const std::
 }
 END_SECTION
 
+START_SECTION((static std::vector<std::pair<double, double> > ransacParallel(const std::vector<std::pair<double, double> >& pairs, size_t n, size_t k, double t, size_t d, bool relative_d = false, double confidence = 0, unsigned int seed = 0)))
+{
+  // 80 points on a line, 20 outliers
+  std::vector<std::pair<double, double> > pairs;
+  for (Size i = 0; i < 100; ++i)
+  {
+    double x = i;
+    pairs.push_back(std::make_pair(x, 2 * x + 1 + (i % 5 == 4 ? 50.0 : 0.0)));
+  }
+
+  std::vector<std::pair<double, double> > inliers = Math::RANSAC<Math::RansacModelLinear>::ransacParallel(pairs, 2, 200, 1.0, 10);
+  TEST_EQUAL(inliers.size(), 80)
+  for (Size i = 0; i < inliers.size(); ++i)
+  {
+    TEST_REAL_SIMILAR(inliers[i].second, 2 * inliers[i].first + 1)
+  }
+
+  // same seed -> same result
+  std::vector<std::pair<double, double> > inliers2 = Math::RANSAC<Math::RansacModelLinear>::ransacParallel(pairs, 2, 200, 1.0, 10);
+  TEST_EQUAL(inliers2 == inliers, true)
+
+  // adaptive termination
+  inliers = Math::RANSAC<Math::RansacModelLinear>::ransacParallel(pairs, 2, 1000000, 1.0, 10, false, 0.99, 42);
+  TEST_EQUAL(inliers.size(), 80)
+
+  // via parameters (no custom RNG)
+  Math::RANSACParam p(2, 200, 1.0, 10, true);
+  p.confidence = 0.99;
+  p.seed = 42;
+  inliers2 = Math::RANSAC<Math::RansacModelLinear>().ransac(pairs, p);
+  TEST_EQUAL(inliers2 == inliers, true)
+
+  TEST_EXCEPTION(Exception::Precondition, Math::RANSAC<Math::RansacModelLinear>::ransacParallel(pairs, 2, 200, 1.0, 10, false, 1.0))
+  TEST_EXCEPTION(Exception::Precondition, Math::RANSAC<Math::RansacModelLinear>::ransacParallel(std::vector<std::pair<double, double> >(2), 2, 200, 1.0, 10))
+}
+END_SECTION
+
 /////////////////////////////////////////////////////////////
 /////////////////////////////////////////////////////////////
 END_TEST
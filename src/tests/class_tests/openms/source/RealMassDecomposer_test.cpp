@@ -99,21 +99,83 @@ START_SECTION(~RealMassDecomposer())
 END_SECTION
 
 
-START_SECTION((decompositions_type getDecompositions(double mass, double error)))
+START_SECTION((decompositions_type getDecompositions(double mass, double error) const))
 {
-  // TODO
+  RealMassDecomposer decomposer(createWeights());
+  Weights weights(createWeights());
+  RealMassDecomposer::decompositions_type decomps = decomposer.getDecompositions(998.5, 0.05);
+  TEST_EQUAL(decomps.empty(), false)
+  for (Size i = 0; i < decomps.size(); ++i)
+  {
+    TEST_EQUAL(fabs(weights.getParentMass(decomps[i]) - 998.5) <= 0.05, true)
+  }
+}
+END_SECTION
+
+START_SECTION((decompositions_type getDecompositions(double mass, double error, const constraints_type &constraints) const))
+{
+  RealMassDecomposer decomposer(createWeights());
+  RealMassDecomposer::decompositions_type all = decomposer.getDecompositions(998.5, 0.05);
+  RealMassDecomposer::constraints_type constraints;
+  constraints[0] = make_pair(1u, 2u);
+  RealMassDecomposer::decompositions_type decomps = decomposer.getDecompositions(998.5, 0.05, constraints);
+  Size expected = 0;
+  for (Size i = 0; i < all.size(); ++i)
+  {
+    if (all[i][0] >= 1 && all[i][0] <= 2) ++expected;
+  }
+  TEST_EQUAL(decomps.size(), expected)
+  TEST_EQUAL(decomps.size() < all.size(), true)
+}
+END_SECTION
+
+START_SECTION((decompositions_type getDecompositions(double mass, double error, number_of_decompositions_type max_decompositions) const))
+{
+  RealMassDecomposer decomposer(createWeights());
+  RealMassDecomposer::decompositions_type all = decomposer.getDecompositions(998.5, 0.05);
+  RealMassDecomposer::decompositions_type decomps = decomposer.getDecompositions(998.5, 0.05, 3ull);
+  TEST_EQUAL(decomps.size(), 3)
+  TEST_EQUAL(equal(decomps.begin(), decomps.end(), all.begin()), true)
+  TEST_EQUAL(decomposer.getDecompositions(998.5, 0.05, 0ull).size(), 0)
+  TEST_EQUAL(decomposer.getDecompositions(998.5, 0.05, 1000000ull).size(), all.size())
+}
+END_SECTION
+
+START_SECTION((std::vector<decompositions_type> getDecompositions(const std::vector<double> &masses, double error) const))
+{
+  RealMassDecomposer decomposer(createWeights());
+  // peptide-like masses, i.e. with the mass defect of glycine added
+  vector<double> masses;
+  for (Size i = 0; i < 10; ++i)
+  {
+    masses.push_back(215.09 + i * 57.02146);
+  }
+  vector<RealMassDecomposer::decompositions_type> decomps = decomposer.getDecompositions(masses, 0.05);
+  TEST_EQUAL(decomps.size(), masses.size())
+  for (Size i = 0; i < masses.size(); ++i)
+  {
+    TEST_EQUAL(decomps[i] == decomposer.getDecompositions(masses[i], 0.05), true)
+  }
+  TEST_EQUAL(decomposer.getDecompositions(vector<double>(), 0.05).size(), 0)
 }
 END_SECTION
 
-START_SECTION((decompositions_type getDecompositions(double mass, double error, const constraints_type &constraints)))
+START_SECTION((number_of_decompositions_type getNumberOfDecompositions(double mass, double error) const))
 {
-  // TODO
+  RealMassDecomposer decomposer(createWeights());
+  TEST_EQUAL(decomposer.getNumberOfDecompositions(998.5, 0.05), decomposer.getDecompositions(998.5, 0.05).size())
+  TEST_EQUAL(decomposer.getNumberOfDecompositions(1094.4, 0.01), decomposer.getDecompositions(1094.4, 0.01).size())
 }
 END_SECTION
 
-START_SECTION((number_of_decompositions_type getNumberOfDecompositions(double mass, double error)))
+START_SECTION((number_of_decompositions_type getNumberOfDecompositions(double mass, double error, number_of_decompositions_type max_decompositions) const))
 {
-  // TODO
+  RealMassDecomposer decomposer(createWeights());
+  RealMassDecomposer::number_of_decompositions_type all = decomposer.getNumberOfDecompositions(998.5, 0.05);
+  TEST_EQUAL(all > 5, true)
+  TEST_EQUAL(decomposer.getNumberOfDecompositions(998.5, 0.05, 5), 5)
+  TEST_EQUAL(decomposer.getNumberOfDecompositions(998.5, 0.05, all + 10), all)
+  TEST_EQUAL(decomposer.getNumberOfDecompositions(998.5, 0.05, 0), 0)
 }
 END_SECTION
 
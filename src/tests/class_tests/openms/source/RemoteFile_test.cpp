@@ -0,0 +1,437 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2018.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: Timo Sachsenberg $
+// $Authors: Timo Sachsenberg $
+// --------------------------------------------------------------------------
+
+#include <OpenMS/CONCEPT/ClassTest.h>
+#include <OpenMS/test_config.h>
+
+/////////////////////////////////////////////////////////////
+
+#include <OpenMS/SYSTEM/RemoteFile.h>
+
+#include <OpenMS/FORMAT/HANDLERS/IndexedMzMLHandler.h>
+#include <OpenMS/KERNEL/OnDiscMSExperiment.h>
+
+#include <QtCore/QCoreApplication>
+#include <QtNetwork/QHostAddress>
+#include <QtNetwork/QNetworkProxy>
+#include <QtNetwork/QTcpServer>
+#include <QtNetwork/QTcpSocket>
+
+#include <fstream>
+#include <iterator>
+#include <map>
+
+using namespace OpenMS;
+using namespace std;
+
+/**
+  Minimal HTTP server answering range requests on a file in memory.
+
+  It runs in the main thread: RemoteFile processes the events of the
+  thread while it waits for its requests.
+*/
+class RangeServer
+{
+public:
+  explicit RangeServer(const std::string& data) :
+    range_support(true),
+    data_(data),
+    requests_(0)
+  {
+    QObject::connect(&server_, &QTcpServer::newConnection, [this]()
+    {
+      while (QTcpSocket* socket = server_.nextPendingConnection())
+      {
+        QObject::connect(socket, &QTcpSocket::readyRead, [this, socket]() { handle_(socket); });
+        QObject::connect(socket, &QTcpSocket::disconnected, [this, socket]()
+        {
+          buffers_.erase(socket);
+          socket->deleteLater();
+        });
+      }
+    });
+    server_.listen(QHostAddress::LocalHost);
+  }
+
+  /// URL of the file (other paths do not exist)
+  String url(const String& path = "file.mzML") const
+  {
+    return "http://127.0.0.1:" + String(server_.serverPort()) + "/" + path;
+  }
+
+  /// number of requests answered so far
+  Size requests() const
+  {
+    return requests_;
+  }
+
+  /// answer range requests with the whole file (200) if false
+  bool range_support;
+
+private:
+  void handle_(QTcpSocket* socket)
+  {
+    QByteArray& buffer = buffers_[socket];
+    buffer += socket->readAll();
+    int header_end;
+    while ((header_end = buffer.indexOf("\r\n\r\n")) >= 0)
+    {
+      const String request(buffer.left(header_end).constData());
+      buffer.remove(0, header_end + 4);
+      ++requests_;
+
+      std::vector<String> lines;
+      request.split("\r\n", lines);
+      bool has_range = false;
+      Size begin = 0, end = data_.size() - 1;
+      for (const String& line : lines)
+      {
+        String lower(line);
+        lower.toLower();
+        if (lower.hasPrefix("range: bytes="))
+        {
+          const String range = line.substr(13);
+          begin = range.prefix('-').toInt();
+          if (!range.hasSuffix("-")) end = range.suffix('-').toInt();
+          has_range = true;
+        }
+      }
+
+      QByteArray response;
+      if (lines.empty() || !lines[0].hasPrefix("GET /file.mzML "))
+      {
+        response = "HTTP/1.1 404 Not Found\r\nContent-Length: 0\r\n\r\n";
+      }
+      else if (!has_range || !range_support)
+      {
+        response = QByteArray("HTTP/1.1 200 OK\r\nContent-Length: ") + QByteArray::number((int)data_.size()) + "\r\n\r\n" + QByteArray(data_.data(), (int)data_.size());
+      }
+      else if (begin >= data_.size())
+      {
+        response = QByteArray("HTTP/1.1 416 Range Not Satisfiable\r\nContent-Range: bytes */") + QByteArray::number((int)data_.size()) + "\r\nContent-Length: 0\r\n\r\n";
+      }
+      else
+      {
+        end = std::min(end, data_.size() - 1);
+        const Size length = end + 1 - begin;
+        response = QByteArray("HTTP/1.1 206 Partial Content\r\nContent-Range: bytes ") + QByteArray::number((int)begin) + "-" + QByteArray::number((int)end) + "/" + QByteArray::number((int)data_.size())
+          + "\r\nContent-Length: " + QByteArray::number((int)length) + "\r\n\r\n" + QByteArray(data_.data() + begin, (int)length);
+      }
+      socket->write(response);
+    }
+  }
+
+  std::string data_;
+  QTcpServer server_;
+  std::map<QTcpSocket*, QByteArray> buffers_;
+  Size requests_;
+};
+
+///////////////////////////
+
+START_TEST(RemoteFile, "$Id$")
+
+/////////////////////////////////////////////////////////////
+
+// the server needs an event dispatcher, no proxy for the local connections
+int argc = 1;
+char name[] = "RemoteFile_test";
+char* argv[] = { name, nullptr };
+QCoreApplication app(argc, argv);
+QNetworkProxy::setApplicationProxy(QNetworkProxy::NoProxy);
+
+const String local_file = OPENMS_GET_TEST_DATA_PATH("IndexedmzMLFile_1.mzML");
+std::ifstream ifs(local_file.c_str(), std::ios::binary);
+const std::string data((std::istreambuf_iterator<char>(ifs)), std::istreambuf_iterator<char>());
+RangeServer server(data);
+
+// small blocks, so the test file consists of many of them
+RemoteFile::Options small_blocks;
+small_blocks.block_size = 256;
+small_blocks.read_ahead = 0;
+
+START_SECTION((static bool isRemote(const String& filename)))
+  TEST_EQUAL(RemoteFile::isRemote("http://example.org/file.mzML"), true)
+  TEST_EQUAL(RemoteFile::isRemote("https://bucket.example.org/data/file.mzML"), true)
+  TEST_EQUAL(RemoteFile::isRemote("HTTPS://example.org/file.mzML"), true)
+  TEST_EQUAL(RemoteFile::isRemote("ftp://example.org/file.mzML"), false)
+  TEST_EQUAL(RemoteFile::isRemote("/data/http://file.mzML"), false)
+  TEST_EQUAL(RemoteFile::isRemote(local_file), false)
+  TEST_EQUAL(RemoteFile::isRemote(""), false)
+END_SECTION
+
+START_SECTION((static Size parseContentRange(const String& content_range)))
+  TEST_EQUAL(RemoteFile::parseContentRange("bytes 0-0/1234"), 1234)
+  // larger than 2^31 and 2^32 (e.g. large mzML files)
+  TEST_EQUAL(RemoteFile::parseContentRange("bytes 0-0/2147483648"), 2147483648ULL)
+  TEST_EQUAL(RemoteFile::parseContentRange("bytes 0-0/42949672960"), 42949672960ULL)
+  TEST_EQUAL(RemoteFile::parseContentRange("bytes */0"), 0)
+  TEST_EXCEPTION(Exception::ParseError, RemoteFile::parseContentRange("bytes 0-0/*"))
+  TEST_EXCEPTION(Exception::ParseError, RemoteFile::parseContentRange("bytes 0-0"))
+  TEST_EXCEPTION(Exception::ParseError, RemoteFile::parseContentRange("bytes 0-0/-1"))
+  TEST_EXCEPTION(Exception::ParseError, RemoteFile::parseContentRange("bytes 0-0/1e3"))
+  TEST_EXCEPTION(Exception::ParseError, RemoteFile::parseContentRange("bytes 0-0/123456789012345678901234567890"))
+  TEST_EXCEPTION(Exception::ParseError, RemoteFile::parseContentRange(""))
+END_SECTION
+
+START_SECTION((Options()))
+  RemoteFile::Options options;
+  TEST_EQUAL(options.block_size, 1 << 20)
+  TEST_EQUAL(options.cache_blocks, 256)
+  TEST_EQUAL(options.read_ahead, 4)
+  TEST_EQUAL(options.max_concurrent, 8)
+  TEST_EQUAL(options.timeout, 60)
+  TEST_EQUAL(options.retries, 3)
+END_SECTION
+
+START_SECTION((explicit RemoteFile(const String& url, const Options& options = Options())))
+  TEST_EQUAL(data.size() > 12 * small_blocks.block_size, true)
+  RemoteFile file(server.url(), small_blocks);
+  TEST_EQUAL(file.size(), data.size())
+  TEST_EQUAL(file.getURL(), server.url())
+
+  TEST_EXCEPTION(Exception::FileNotFound, RemoteFile(server.url("missing.mzML")))
+
+  server.range_support = false;
+  TEST_EXCEPTION(Exception::IllegalArgument, RemoteFile(server.url()))
+  server.range_support = true;
+
+  RemoteFile::Options options;
+  options.block_size = 0;
+  TEST_EXCEPTION(Exception::IllegalArgument, RemoteFile(server.url(), options))
+END_SECTION
+
+START_SECTION((Size size() const))
+  NOT_TESTABLE // tested above
+END_SECTION
+
+START_SECTION((const String& getURL() const))
+  NOT_TESTABLE // tested above
+END_SECTION
+
+START_SECTION((Size read(Size offset, Size length, char* buffer)))
+  RemoteFile file(server.url(), small_blocks);
+
+  // spans three blocks
+  std::vector<char> buffer(400);
+  TEST_EQUAL(file.read(200, 400, buffer.data()), 400)
+  TEST_EQUAL(std::string(buffer.begin(), buffer.end()), data.substr(200, 400))
+  TEST_EQUAL(file.getStatistics().requests, 3)
+  TEST_EQUAL(file.getStatistics().cache_misses, 3)
+  TEST_EQUAL(file.getStatistics().bytes_fetched, 3 * 256)
+
+  // served from the cache
+  TEST_EQUAL(file.read(300, 10, buffer.data()), 10)
+  TEST_EQUAL(std::string(buffer.begin(), buffer.begin() + 10), data.substr(300, 10))
+  TEST_EQUAL(file.getStatistics().requests, 3)
+  TEST_EQUAL(file.getStatistics().cache_hits, 1)
+
+  // end of the file
+  TEST_EQUAL(file.read(data.size() - 5, 100, buffer.data()), 5)
+  TEST_EQUAL(std::string(buffer.begin(), buffer.begin() + 5), data.substr(data.size() - 5))
+  TEST_EQUAL(file.read(data.size(), 100, buffer.data()), 0)
+  TEST_EQUAL(file.read(0, 0, buffer.data()), 0)
+END_SECTION
+
+START_SECTION((std::string read(Size offset, Size length)))
+  RemoteFile file(server.url(), small_blocks);
+  TEST_EQUAL(file.read(0, data.size()), data)
+  TEST_EQUAL(file.read(1000, 1), data.substr(1000, 1))
+  TEST_EQUAL(file.read(data.size() - 10, 1000), data.substr(data.size() - 10))
+  TEST_EQUAL(file.read(data.size() + 1, 1), "")
+END_SECTION
+
+START_SECTION(([EXTRA] least recently used blocks are evicted))
+  RemoteFile::Options options = small_blocks;
+  options.cache_blocks = 2;
+  RemoteFile file(server.url(), options);
+  file.read(0, 1); // block 0
+  file.read(256, 1); // block 1
+  file.read(0, 1); // hit
+  file.read(512, 1); // block 2, evicts block 1
+  file.read(0, 1); // hit
+  TEST_EQUAL(file.getStatistics().requests, 3)
+  TEST_EQUAL(file.getStatistics().cache_hits, 2)
+  TEST_EQUAL(file.read(256, 10), data.substr(256, 10)) // block 1 again
+  TEST_EQUAL(file.getStatistics().requests, 4)
+  TEST_EQUAL(file.getStatistics().cache_misses, 4)
+END_SECTION
+
+START_SECTION(([EXTRA] read-ahead on sequential access))
+  RemoteFile::Options options = small_blocks;
+  options.read_ahead = 2;
+  RemoteFile file(server.url(), options);
+  TEST_EQUAL(file.read(0, 10), data.substr(0, 10)) // blocks 0 to 2
+  TEST_EQUAL(file.getStatistics().requests, 3)
+  TEST_EQUAL(file.read(256, 10), data.substr(256, 10))
+  TEST_EQUAL(file.read(512, 10), data.substr(512, 10))
+  TEST_EQUAL(file.getStatistics().requests, 3)
+  TEST_EQUAL(file.getStatistics().cache_hits, 2)
+  TEST_EQUAL(file.read(768, 10), data.substr(768, 10)) // blocks 3 to 5
+  TEST_EQUAL(file.getStatistics().requests, 6)
+  // no read-ahead on random access
+  TEST_EQUAL(file.read(2560, 10), data.substr(2560, 10))
+  TEST_EQUAL(file.getStatistics().requests, 7)
+  TEST_EQUAL(file.getStatistics().cache_misses, 3)
+END_SECTION
+
+START_SECTION((void prefetch(const std::vector<std::pair<Size, Size> >& ranges)))
+  RemoteFile file(server.url(), small_blocks);
+  std::vector<std::pair<Size, Size> > ranges;
+  ranges.push_back(std::make_pair(0, 600)); // blocks 0 to 2
+  ranges.push_back(std::make_pair(1300, 1301)); // block 5
+  ranges.push_back(std::make_pair(500, 520)); // block 1 (again)
+  ranges.push_back(std::make_pair(data.size(), data.size() + 5)); // beyond the end
+  file.prefetch(ranges);
+  TEST_EQUAL(file.getStatistics().requests, 4)
+  TEST_EQUAL(file.read(0, 600), data.substr(0, 600))
+  TEST_EQUAL(file.read(1300, 1), data.substr(1300, 1))
+  TEST_EQUAL(file.getStatistics().requests, 4)
+  TEST_EQUAL(file.getStatistics().cache_misses, 0)
+
+  // cached blocks are not requested again
+  file.prefetch(ranges);
+  TEST_EQUAL(file.getStatistics().requests, 4)
+END_SECTION
+
+START_SECTION((Statistics getStatistics() const))
+  NOT_TESTABLE // tested above
+END_SECTION
+
+START_SECTION(([RemoteFileStream] RemoteFileStream(const boost::shared_ptr<RemoteFile>& file, Size buffer_size = 1 << 16)))
+  boost::shared_ptr<RemoteFile> file(new RemoteFile(server.url(), small_blocks));
+  RemoteFileStream in(file, 100);
+  const std::string content((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+  TEST_EQUAL(content, data)
+
+  // seeking (tellg inside of the buffer, relative and from the end)
+  in.clear();
+  in.seekg(123);
+  TEST_EQUAL(in.tellg(), std::streampos(123))
+  std::string text(10, ' ');
+  in.read(&text[0], 10);
+  TEST_EQUAL(text, data.substr(123, 10))
+  TEST_EQUAL(in.tellg(), std::streampos(133))
+  in.seekg(-3, std::ios_base::cur);
+  in.read(&text[0], 10);
+  TEST_EQUAL(text, data.substr(130, 10))
+  in.seekg(-50, std::ios_base::end);
+  std::string tail(50, ' ');
+  in.read(&tail[0], 50);
+  TEST_EQUAL(tail, data.substr(data.size() - 50))
+  TEST_EQUAL(in.good(), true)
+
+  // beyond the end of the file
+  in.seekg(data.size() + 1);
+  TEST_EQUAL(in.fail(), true)
+END_SECTION
+
+START_SECTION(([EXTRA] IndexedMzMLHandler on a remote file))
+  Internal::IndexedMzMLHandler local(local_file);
+  Internal::IndexedMzMLHandler remote(server.url());
+  TEST_EQUAL(local.getParsingSuccess(), true)
+  TEST_EQUAL(remote.getParsingSuccess(), true)
+  TEST_EQUAL(local.isRemote(), false)
+  TEST_EQUAL(remote.isRemote(), true)
+  TEST_EQUAL(remote.getNrSpectra(), local.getNrSpectra())
+  TEST_EQUAL(remote.getNrChromatograms(), local.getNrChromatograms())
+  ABORT_IF(remote.getNrSpectra() != 2)
+
+  std::vector<int> spectra;
+  spectra.push_back(0);
+  spectra.push_back(1);
+  spectra.push_back(5); // ignored
+  remote.prefetch(spectra, std::vector<int>(1, 0));
+
+  for (Size i = 0; i < local.getNrSpectra(); ++i)
+  {
+    TEST_EQUAL(remote.getMSSpectrumById(i) == local.getMSSpectrumById(i), true)
+    MSSpectrum s_local, s_remote;
+    local.getMSSpectrumWithMetaDataById(i, s_local);
+    remote.getMSSpectrumWithMetaDataById(i, s_remote);
+    TEST_EQUAL(s_remote == s_local, true)
+    TEST_EQUAL(s_remote.getNativeID(), s_local.getNativeID())
+    TEST_EQUAL(s_remote.size(), s_local.size())
+  }
+  for (Size i = 0; i < local.getNrChromatograms(); ++i)
+  {
+    TEST_EQUAL(remote.getMSChromatogramById(i) == local.getMSChromatogramById(i), true)
+    MSChromatogram c_local, c_remote;
+    local.getMSChromatogramWithMetaDataById(i, c_local);
+    remote.getMSChromatogramWithMetaDataById(i, c_remote);
+    TEST_EQUAL(c_remote == c_local, true)
+  }
+
+  // copies share the remote file
+  Internal::IndexedMzMLHandler copy(remote);
+  TEST_EQUAL(copy.isRemote(), true)
+  TEST_EQUAL(copy.getMSSpectrumById(1) == local.getMSSpectrumById(1), true)
+END_SECTION
+
+START_SECTION(([EXTRA] OnDiscMSExperiment on a remote file))
+  OnDiscMSExperiment local, remote;
+  TEST_EQUAL(local.openFile(local_file), true)
+  TEST_EQUAL(remote.openFile(server.url()), true)
+  TEST_EQUAL(remote.getNrSpectra(), local.getNrSpectra())
+  TEST_EQUAL(remote.getNrChromatograms(), local.getNrChromatograms())
+
+  // no made-up meta data
+  TEST_EQUAL(remote.getMetaData().get() == nullptr, true)
+  TEST_EXCEPTION(Exception::IllegalArgument, remote.isSortedByRT())
+  TEST_EQUAL(remote.getExperimentalSettings().get() != nullptr, true)
+  TEST_EQUAL(remote.getExperimentalSettings()->getInstrument().getName(), local.getExperimentalSettings()->getInstrument().getName())
+
+  remote.prefetchSpectra(std::vector<int>(1, 1));
+  for (Size i = 0; i < local.getNrSpectra(); ++i)
+  {
+    const MSSpectrum s_local = local.getSpectrum(i);
+    const MSSpectrum s_remote = remote.getSpectrum(i);
+    TEST_EQUAL(s_remote == s_local, true)
+    TEST_REAL_SIMILAR(s_remote.getRT(), s_local.getRT())
+    TEST_EQUAL(s_remote.getMSLevel(), s_local.getMSLevel())
+    TEST_EQUAL(s_remote.getPrecursors().size(), s_local.getPrecursors().size())
+    TEST_EQUAL(s_remote.getNativeID(), s_local.getNativeID())
+  }
+  for (Size i = 0; i < local.getNrChromatograms(); ++i)
+  {
+    const MSChromatogram c_local = local.getChromatogram(i);
+    const MSChromatogram c_remote = remote.getChromatogram(i);
+    TEST_EQUAL(c_remote == c_local, true)
+    TEST_EQUAL(c_remote.getNativeID(), c_local.getNativeID())
+  }
+END_SECTION
+
+/////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////
+END_TEST
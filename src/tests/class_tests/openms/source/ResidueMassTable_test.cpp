@@ -0,0 +1,210 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2018.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: Timo Sachsenberg $
+// $Authors: Timo Sachsenberg $
+// --------------------------------------------------------------------------
+
+#include <OpenMS/CONCEPT/ClassTest.h>
+#include <OpenMS/test_config.h>
+
+///////////////////////////
+#include <OpenMS/CHEMISTRY/ResidueMassTable.h>
+///////////////////////////
+
+#include <OpenMS/ANALYSIS/RNPXL/ModifiedPeptideGenerator.h>
+#include <OpenMS/CHEMISTRY/AASequence.h>
+#include <OpenMS/CHEMISTRY/ModificationsDB.h>
+
+using namespace OpenMS;
+using namespace std;
+
+START_TEST(ResidueMassTable, "$Id$")
+
+/////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////
+
+ResidueMassTable* ptr = nullptr;
+ResidueMassTable* null_ptr = nullptr;
+
+START_SECTION(ResidueMassTable(const StringList& modifications = StringList()))
+{
+  ptr = new ResidueMassTable();
+  TEST_NOT_EQUAL(ptr, null_ptr)
+  TEST_EQUAL(ptr->getNumberOfModifications(), 0)
+  TEST_EQUAL(ptr->getNumberOfResidues() >= 20, true)
+  TEST_EXCEPTION(Exception::ElementNotFound, ResidueMassTable(ListUtils::create<String>("NoSuchModification")))
+}
+END_SECTION
+
+START_SECTION(~ResidueMassTable())
+{
+  delete ptr;
+}
+END_SECTION
+
+StringList fixed_names = ListUtils::create<String>("Carbamidomethyl (C)");
+StringList variable_names = ListUtils::create<String>("Oxidation (M),Acetyl (N-term),Phospho (S),Phospho (T)");
+StringList all_names(fixed_names);
+all_names.insert(all_names.end(), variable_names.begin(), variable_names.end());
+ResidueMassTable table(all_names);
+
+vector<Size> fixed_indices, variable_indices;
+for (const String& name : fixed_names) { fixed_indices.push_back(table.getModificationIndex(name)); }
+for (const String& name : variable_names) { variable_indices.push_back(table.getModificationIndex(name)); }
+
+vector<ResidueModification> fixed_mods, variable_mods;
+for (const String& name : fixed_names) { fixed_mods.push_back(ModificationsDB::getInstance()->getModification(name)); }
+for (const String& name : variable_names) { variable_mods.push_back(ModificationsDB::getInstance()->getModification(name)); }
+
+START_SECTION((Int getModificationIndex(const String& modification) const))
+{
+  TEST_EQUAL(table.getNumberOfModifications(), 5)
+  TEST_EQUAL(table.getModificationIndex("Carbamidomethyl (C)"), 0)
+  TEST_EQUAL(table.getModificationIndex("Phospho (T)"), 4)
+  TEST_EQUAL(table.getModificationIndex("Oxidation (Y)"), -1)
+  TEST_REAL_SIMILAR(table.getModificationMass(1), ModificationsDB::getInstance()->getModification("Oxidation (M)").getDiffMonoMass())
+}
+END_SECTION
+
+START_SECTION((bool encode(const String& sequence, EncodedSequence& encoded) const))
+{
+  ResidueMassTable::EncodedSequence encoded;
+  TEST_EQUAL(table.encode("PEPTIDEK", encoded), true)
+  TEST_EQUAL(encoded.residues.size(), 8)
+  TEST_EQUAL(table.getOneLetterCode(encoded.residues[3]), 'T')
+  TEST_EQUAL(table.getResidueModification(encoded.residues[3]), -1)
+  TEST_EQUAL(encoded.n_term_modification, -1)
+  TEST_EQUAL(table.encode("PEPTXDEK", encoded), false)
+}
+END_SECTION
+
+START_SECTION((bool getModifiedResidue(ResidueCode code, Size modification, ResidueCode& modified) const))
+{
+  ResidueMassTable::EncodedSequence encoded;
+  table.encode("MS", encoded);
+  ResidueMassTable::ResidueCode modified;
+  TEST_EQUAL(table.getModifiedResidue(encoded.residues[0], 1, modified), true)
+  TEST_EQUAL(table.getOneLetterCode(modified), 'M')
+  TEST_EQUAL(table.getResidueModification(modified), 1)
+  TEST_REAL_SIMILAR(table.getResidueMass(modified) - table.getResidueMass(encoded.residues[0]), table.getModificationMass(1))
+  TEST_EQUAL(table.getModifiedResidue(encoded.residues[1], 1, modified), false)
+  TEST_EQUAL(table.getModifiedResidue(encoded.residues[1], 3, modified), true)
+  // already modified
+  ResidueMassTable::ResidueCode twice;
+  TEST_EQUAL(table.getModifiedResidue(modified, 3, twice), false)
+}
+END_SECTION
+
+START_SECTION((double getMonoWeight(const EncodedSequence& encoded, Int charge = 0) const))
+{
+  ResidueMassTable::EncodedSequence encoded;
+  StringList sequences = ListUtils::create<String>("PEPTIDEK,SAMPLER,C,ACDEFGHIKLMNPQRSTVWY");
+  for (const String& sequence : sequences)
+  {
+    table.encode(sequence, encoded);
+    const AASequence peptide = AASequence::fromString(sequence);
+    TEST_REAL_SIMILAR(table.getMonoWeight(encoded), peptide.getMonoWeight())
+    TEST_REAL_SIMILAR(table.getMonoWeight(encoded, 2), peptide.getMonoWeight(Residue::Full, 2))
+  }
+  TEST_EQUAL(table.getMonoWeight(ResidueMassTable::EncodedSequence()), 0.0)
+}
+END_SECTION
+
+START_SECTION((void encode(const AASequence& peptide, EncodedSequence& encoded) const))
+{
+  ResidueMassTable::EncodedSequence encoded;
+  const AASequence peptide = AASequence::fromString(".(Acetyl)PEPM(Oxidation)TC(Carbamidomethyl)IDES(Phospho)K");
+  table.encode(peptide, encoded);
+  TEST_EQUAL(encoded.residues.size(), peptide.size())
+  TEST_EQUAL(encoded.n_term_modification, 2)
+  TEST_EQUAL(encoded.c_term_modification, -1)
+  TEST_EQUAL(table.getResidueModification(encoded.residues[3]), 1)
+  TEST_REAL_SIMILAR(table.getMonoWeight(encoded), peptide.getMonoWeight())
+
+  TEST_EXCEPTION(Exception::ElementNotFound, table.encode(AASequence::fromString("PEPM(Oxidation)Y(Phospho)K"), encoded))
+}
+END_SECTION
+
+START_SECTION((void applyFixedModifications(const std::vector<Size>& modifications, EncodedSequence& encoded) const))
+{
+  ResidueMassTable::EncodedSequence encoded;
+  StringList sequences = ListUtils::create<String>("PEPTCIDEK,CCMK,SAMPLER");
+  for (const String& sequence : sequences)
+  {
+    AASequence peptide = AASequence::fromString(sequence);
+    ModifiedPeptideGenerator::applyFixedModifications(fixed_mods.begin(), fixed_mods.end(), peptide);
+    table.encode(sequence, encoded);
+    table.applyFixedModifications(fixed_indices, encoded);
+    TEST_REAL_SIMILAR(table.getMonoWeight(encoded), peptide.getMonoWeight())
+
+    ResidueMassTable::EncodedSequence expected;
+    table.encode(peptide, expected);
+    TEST_EQUAL(encoded.residues == expected.residues, true)
+  }
+}
+END_SECTION
+
+START_SECTION((void getMassRange(const EncodedSequence& encoded, const std::vector<Size>& modifications, Size max_variable_mods, double& min_mass, double& max_mass) const))
+{
+  ResidueMassTable::EncodedSequence encoded;
+  StringList sequences = ListUtils::create<String>("PEPTCIDEK,MMSSTK,SAMPLER,GGSK");
+  for (const String& sequence : sequences)
+  {
+    for (Size max_mods = 0; max_mods <= 3; ++max_mods)
+    {
+      AASequence peptide = AASequence::fromString(sequence);
+      ModifiedPeptideGenerator::applyFixedModifications(fixed_mods.begin(), fixed_mods.end(), peptide);
+      vector<AASequence> variants;
+      ModifiedPeptideGenerator::applyVariableModifications(variable_mods.begin(), variable_mods.end(), peptide, max_mods, variants);
+
+      table.encode(sequence, encoded);
+      table.applyFixedModifications(fixed_indices, encoded);
+      double min_mass, max_mass;
+      table.getMassRange(encoded, variable_indices, max_mods, min_mass, max_mass);
+
+      // all variants are in range, the range is tight for these modifications
+      double min_variant = variants[0].getMonoWeight(), max_variant = min_variant;
+      for (const AASequence& variant : variants)
+      {
+        TEST_EQUAL(variant.getMonoWeight() >= min_mass - 1e-6 && variant.getMonoWeight() <= max_mass + 1e-6, true)
+        min_variant = min(min_variant, variant.getMonoWeight());
+        max_variant = max(max_variant, variant.getMonoWeight());
+      }
+      TEST_REAL_SIMILAR(min_mass, min_variant)
+      TEST_REAL_SIMILAR(max_mass, max_variant)
+    }
+  }
+}
+END_SECTION
+
+/////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////
+END_TEST
@@ -499,6 +499,81 @@ START_SECTION((void predict(const SVMData &problem, std::vector< double > &resul
 	svm2.train(problem);
 	svm2.predict(problem, predicted_labels);
 	TEST_NOT_EQUAL(predicted_labels.size(), 0)
+
+	// only the kernel values of the support vectors are computed, the result
+	// has to be the same as on the full kernel matrix
+	vector<double> expected_labels;
+	svm_problem* kernel_matrix = svm2.computeKernelMatrix(problem, problem);
+	svm2.predict(kernel_matrix, expected_labels);
+	TEST_EQUAL(predicted_labels.size(), expected_labels.size())
+	for (Size i = 0; i < predicted_labels.size(); ++i)
+	{
+		TEST_REAL_SIMILAR(predicted_labels[i], expected_labels[i])
+	}
+END_SECTION
+
+START_SECTION((void predict(const std::vector<svm_node*>& vectors, std::vector<double>& predicted_rts)))
+	// a linear kernel model is evaluated with a single weight vector, compare
+	// against a polynomial kernel of degree 1 (which is the same kernel but
+	// evaluated support vector by support vector)
+	LibSVMEncoder encoder;
+	vector< vector< pair<Int, double> > > vectors;
+	vector< pair<Int, double> > temp_vector;
+	vector<svm_node*> encoded_vectors;
+	UInt count = 8;
+	vector<double> labels;
+	vector<double> linear_labels, poly_labels;
+
+	for (UInt j = 0; j < count; j++)
+	{
+		temp_vector.clear();
+		for (UInt i = 1; i < 6; i++)
+		{
+			temp_vector.push_back(make_pair(i * 2, ((double) i) * j * 0.3 + (i == j ? 1.0 : 0.0)));
+		}
+		vectors.push_back(temp_vector);
+	}
+	encoder.encodeLibSVMVectors(vectors, encoded_vectors);
+	for (Size i = 0; i < count; i++)
+	{
+		labels.push_back(((double) i * 2) / 3 + 0.03);
+	}
+	svm_problem* problem = encoder.encodeLibSVMProblem(encoded_vectors, labels);
+
+	SVMWrapper svm_linear, svm_poly;
+	svm_linear.setParameter(SVMWrapper::SVM_TYPE, EPSILON_SVR);
+	svm_linear.setParameter(SVMWrapper::KERNEL_TYPE, LINEAR);
+	svm_poly.setParameter(SVMWrapper::SVM_TYPE, EPSILON_SVR);
+	svm_poly.setParameter(SVMWrapper::KERNEL_TYPE, POLY);
+	svm_poly.setParameter(SVMWrapper::DEGREE, 1);
+	svm_poly.setParameter(SVMWrapper::GAMMA, 1.0);
+	svm_linear.train(problem);
+	svm_poly.train(problem);
+	svm_linear.predict(encoded_vectors, linear_labels);
+	svm_poly.predict(encoded_vectors, poly_labels);
+	TEST_EQUAL(linear_labels.size(), count)
+	TEST_EQUAL(poly_labels.size(), count)
+	for (Size i = 0; i < count; ++i)
+	{
+		TEST_REAL_SIMILAR(linear_labels[i], poly_labels[i])
+	}
+
+	// two-class classification
+	labels.clear();
+	labels.resize(4, 1);
+	labels.resize(8, -1);
+	problem = encoder.encodeLibSVMProblem(encoded_vectors, labels);
+	svm_linear.setParameter(SVMWrapper::SVM_TYPE, C_SVC);
+	svm_poly.setParameter(SVMWrapper::SVM_TYPE, C_SVC);
+	svm_linear.train(problem);
+	svm_poly.train(problem);
+	svm_linear.predict(encoded_vectors, linear_labels);
+	svm_poly.predict(encoded_vectors, poly_labels);
+	TEST_EQUAL(linear_labels.size(), count)
+	for (Size i = 0; i < count; ++i)
+	{
+		TEST_EQUAL(linear_labels[i], poly_labels[i])
+	}
 END_SECTION
 
 START_SECTION((svm_problem* computeKernelMatrix(svm_problem* problem1, svm_problem* problem2)))
@@ -157,6 +157,71 @@ START_SECTION((template <typename PeakType> void filterExperiment(MSExperiment<P
 
 END_SECTION
 
+START_SECTION((void filterBatch(std::vector<double>& intensities, Size nr_traces) const))
+{
+  TOLERANCE_ABSOLUTE(0.01)
+
+  // the same chromatograms as spectra above, smoothed one by one, as a batch and within an experiment
+  const double ints[] = {0.0, 0.0, 0.0, 1.0, 0.8, 1.2, 0.0, 0.0, 0.0};
+  const double scale[] = {1.0, 2.0, 0.5};
+
+  PeakMap exp;
+  std::vector<double> batch(9 * 3);
+  for (Size t = 0; t < 3; ++t)
+  {
+    MSChromatogram chrom;
+    for (Size k = 0; k < 9; ++k)
+    {
+      ChromatogramPeak cp(k, ints[k] * scale[t]);
+      chrom.push_back(cp);
+      batch[k * 3 + t] = ints[k] * scale[t];
+    }
+    exp.addChromatogram(chrom);
+  }
+  // a chromatogram of another length and one shorter than the frame
+  MSChromatogram chrom;
+  for (Size k = 0; k < 7; ++k)
+  {
+    chrom.push_back(ChromatogramPeak(k, ints[k + 1]));
+  }
+  exp.addChromatogram(chrom);
+  chrom.resize(2);
+  exp.addChromatogram(chrom);
+
+  SavitzkyGolayFilter sgolay;
+  sgolay.setParameters(param);
+
+  MSChromatogram single = exp.getChromatogram(1);
+  sgolay.filter(single);
+  TEST_REAL_SIMILAR(single[3].getIntensity(), 2.0 * 0.657143)
+
+  sgolay.filterBatch(batch, 3);
+  PeakMap single_exp = exp;
+  for (Size i = 0; i < single_exp.getChromatograms().size(); ++i)
+  {
+    sgolay.filter(single_exp.getChromatogram(i));
+  }
+  sgolay.filterExperiment(exp);
+
+  for (Size t = 0; t < 3; ++t)
+  {
+    for (Size k = 0; k < 9; ++k)
+    {
+      TEST_REAL_SIMILAR(batch[k * 3 + t], single_exp.getChromatogram(t)[k].getIntensity())
+      TEST_REAL_SIMILAR(exp.getChromatogram(t)[k].getIntensity(), single_exp.getChromatogram(t)[k].getIntensity())
+    }
+  }
+  for (Size k = 0; k < 7; ++k)
+  {
+    TEST_REAL_SIMILAR(exp.getChromatogram(3)[k].getIntensity(), single_exp.getChromatogram(3)[k].getIntensity())
+  }
+  TEST_REAL_SIMILAR(exp.getChromatogram(4)[1].getIntensity(), 0.0)
+
+  std::vector<double> wrong_size(10);
+  TEST_EXCEPTION(Exception::IllegalArgument, sgolay.filterBatch(wrong_size, 3))
+}
+END_SECTION
+
 /////////////////////////////////////////////////////////////
 /////////////////////////////////////////////////////////////
 END_TEST
@@ -0,0 +1,155 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry               
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2018.
+// 
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution 
+//    may be used to endorse or promote products derived from this software 
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS. 
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING 
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, 
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, 
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; 
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, 
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR 
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF 
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+// 
+// --------------------------------------------------------------------------
+// $Maintainer: Timo Sachsenberg $
+// $Authors: Timo Sachsenberg $
+// --------------------------------------------------------------------------
+
+#include <OpenMS/CONCEPT/ClassTest.h>
+#include <OpenMS/test_config.h>
+
+///////////////////////////
+#include <OpenMS/ANALYSIS/ID/SearchEngineChunks.h>
+///////////////////////////
+
+using namespace OpenMS;
+using namespace std;
+
+START_TEST(SearchEngineChunks, "$Id$")
+
+/////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////
+
+START_SECTION(static Size getNumberOfChunks(Size requested, Size nr_spectra))
+{
+  TEST_EQUAL(SearchEngineChunks::getNumberOfChunks(1, 100), 1)
+  TEST_EQUAL(SearchEngineChunks::getNumberOfChunks(8, 100), 8)
+  TEST_EQUAL(SearchEngineChunks::getNumberOfChunks(8, 3), 3)
+  TEST_EQUAL(SearchEngineChunks::getNumberOfChunks(0, 100), 1)
+  TEST_EQUAL(SearchEngineChunks::getNumberOfChunks(8, 0), 1)
+}
+END_SECTION
+
+START_SECTION(static Int getThreadsPerChunk(Size nr_chunks, Int threads))
+{
+  TEST_EQUAL(SearchEngineChunks::getThreadsPerChunk(1, 128), 128)
+  TEST_EQUAL(SearchEngineChunks::getThreadsPerChunk(16, 128), 8)
+  TEST_EQUAL(SearchEngineChunks::getThreadsPerChunk(3, 8), 2)
+  TEST_EQUAL(SearchEngineChunks::getThreadsPerChunk(16, 4), 1)
+}
+END_SECTION
+
+START_SECTION(static std::vector<PeakMap> split(const PeakMap& exp, Size nr_chunks))
+{
+  PeakMap exp;
+  exp.setComment("comment");
+  for (Size i = 0; i < 10; ++i)
+  {
+    MSSpectrum spec;
+    spec.setRT(double(i));
+    spec.setNativeID("scan=" + String(i));
+    exp.addSpectrum(spec);
+  }
+
+  vector<PeakMap> chunks = SearchEngineChunks::split(exp, 3);
+  TEST_EQUAL(chunks.size(), 3)
+  TEST_EQUAL(chunks[0].size(), 4)
+  TEST_EQUAL(chunks[1].size(), 3)
+  TEST_EQUAL(chunks[2].size(), 3)
+  TEST_EQUAL(chunks[0][0].getNativeID(), "scan=0")
+  TEST_EQUAL(chunks[0][3].getNativeID(), "scan=3")
+  TEST_EQUAL(chunks[1][0].getNativeID(), "scan=4")
+  TEST_EQUAL(chunks[2][2].getNativeID(), "scan=9")
+  TEST_EQUAL(chunks[2].getComment(), "comment")
+
+  chunks = SearchEngineChunks::split(exp, 1);
+  TEST_EQUAL(chunks.size(), 1)
+  TEST_EQUAL(chunks[0].size(), 10)
+
+  TEST_EXCEPTION(Exception::InvalidValue, SearchEngineChunks::split(exp, 0))
+  TEST_EXCEPTION(Exception::InvalidValue, SearchEngineChunks::split(exp, 11))
+}
+END_SECTION
+
+START_SECTION(static void merge(std::vector<std::vector<ProteinIdentification> >& chunk_proteins, std::vector<std::vector<PeptideIdentification> >& chunk_peptides, std::vector<ProteinIdentification>& proteins, std::vector<PeptideIdentification>& peptides))
+{
+  vector<vector<ProteinIdentification> > chunk_proteins(2, vector<ProteinIdentification>(1));
+  vector<vector<PeptideIdentification> > chunk_peptides(2);
+  for (Size c = 0; c < 2; ++c)
+  {
+    chunk_proteins[c][0].setIdentifier("run_" + String(c));
+    chunk_proteins[c][0].setSearchEngine("engine_" + String(c));
+    ProteinHit hit;
+    hit.setAccession("shared");
+    chunk_proteins[c][0].insertHit(hit);
+    hit.setAccession("only_" + String(c));
+    chunk_proteins[c][0].insertHit(hit);
+
+    PeptideIdentification pep;
+    pep.setIdentifier("run_" + String(c));
+    pep.setRT(double(c));
+    chunk_peptides[c].push_back(pep);
+    pep.setRT(double(c) + 0.5);
+    chunk_peptides[c].push_back(pep);
+  }
+
+  vector<ProteinIdentification> proteins;
+  vector<PeptideIdentification> peptides;
+  SearchEngineChunks::merge(chunk_proteins, chunk_peptides, proteins, peptides);
+  TEST_EQUAL(chunk_proteins.size(), 0)
+  TEST_EQUAL(chunk_peptides.size(), 0)
+
+  TEST_EQUAL(proteins.size(), 1)
+  TEST_EQUAL(proteins[0].getIdentifier(), "run_0")
+  TEST_EQUAL(proteins[0].getSearchEngine(), "engine_0")
+  ABORT_IF(proteins[0].getHits().size() != 3)
+  TEST_EQUAL(proteins[0].getHits()[0].getAccession(), "shared")
+  TEST_EQUAL(proteins[0].getHits()[1].getAccession(), "only_0")
+  TEST_EQUAL(proteins[0].getHits()[2].getAccession(), "only_1")
+
+  ABORT_IF(peptides.size() != 4)
+  for (Size i = 0; i < peptides.size(); ++i)
+  {
+    TEST_EQUAL(peptides[i].getIdentifier(), "run_0")
+  }
+  TEST_REAL_SIMILAR(peptides[0].getRT(), 0.0)
+  TEST_REAL_SIMILAR(peptides[1].getRT(), 0.5)
+  TEST_REAL_SIMILAR(peptides[2].getRT(), 1.0)
+  TEST_REAL_SIMILAR(peptides[3].getRT(), 1.5)
+
+  chunk_proteins.resize(2);
+  chunk_peptides.resize(1);
+  TEST_EXCEPTION(Exception::InvalidValue, SearchEngineChunks::merge(chunk_proteins, chunk_peptides, proteins, peptides))
+}
+END_SECTION
+
+/////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////
+END_TEST
@@ -0,0 +1,175 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2018.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: Timo Sachsenberg $
+// $Authors: Timo Sachsenberg $
+// --------------------------------------------------------------------------
+//
+
+#include <OpenMS/CONCEPT/ClassTest.h>
+#include <OpenMS/test_config.h>
+
+///////////////////////////
+
+#include <OpenMS/FILTERING/TRANSFORMERS/SpectraFilterPipeline.h>
+#include <OpenMS/FILTERING/TRANSFORMERS/NLargest.h>
+#include <OpenMS/FILTERING/TRANSFORMERS/Normalizer.h>
+#include <OpenMS/FILTERING/TRANSFORMERS/SqrtMower.h>
+#include <OpenMS/FORMAT/DTAFile.h>
+
+using namespace OpenMS;
+using namespace std;
+
+///////////////////////////
+
+START_TEST(SpectraFilterPipeline, "$Id$")
+
+/////////////////////////////////////////////////////////////
+
+SpectraFilterPipeline* e_ptr = nullptr;
+SpectraFilterPipeline* e_nullPointer = nullptr;
+
+START_SECTION((SpectraFilterPipeline()))
+  e_ptr = new SpectraFilterPipeline;
+  TEST_NOT_EQUAL(e_ptr, e_nullPointer)
+  TEST_EQUAL(e_ptr->size(), 0)
+END_SECTION
+
+START_SECTION((~SpectraFilterPipeline()))
+  delete e_ptr;
+END_SECTION
+
+START_SECTION((static StringList getFilterNames()))
+  StringList names = SpectraFilterPipeline::getFilterNames();
+  TEST_EQUAL(names.size(), 8)
+  TEST_EQUAL(ListUtils::contains(names, "NLargest"), true)
+  TEST_EQUAL(ListUtils::contains(names, "WindowMower"), true)
+END_SECTION
+
+START_SECTION((static Param getFilterDefaults(const String& name)))
+  TEST_EQUAL(SpectraFilterPipeline::getFilterDefaults("NLargest"), NLargest().getDefaults())
+  TEST_EQUAL(SpectraFilterPipeline::getFilterDefaults("SqrtMower").empty(), true)
+  TEST_EXCEPTION(Exception::InvalidValue, SpectraFilterPipeline::getFilterDefaults("NoSuchFilter"))
+END_SECTION
+
+START_SECTION((void addFilter(const String& name, const Param& param = Param())))
+  SpectraFilterPipeline pipeline;
+  Param p;
+  p.setValue("n", 10);
+  pipeline.addFilter("NLargest", p);
+  pipeline.addFilter("SqrtMower");
+  TEST_EQUAL(pipeline.size(), 2)
+  TEST_EXCEPTION(Exception::InvalidValue, pipeline.addFilter("NoSuchFilter"))
+  TEST_EQUAL(pipeline.size(), 2)
+END_SECTION
+
+START_SECTION((StringList getFilters() const))
+  SpectraFilterPipeline pipeline;
+  pipeline.addFilter("SqrtMower");
+  pipeline.addFilter("NLargest");
+  pipeline.addFilter("SqrtMower");
+  TEST_EQUAL(ListUtils::concatenate(pipeline.getFilters(), ","), "SqrtMower,NLargest,SqrtMower")
+END_SECTION
+
+START_SECTION((Size size() const))
+  NOT_TESTABLE // tested above
+END_SECTION
+
+START_SECTION((void clear()))
+  SpectraFilterPipeline pipeline;
+  pipeline.addFilter("SqrtMower");
+  pipeline.clear();
+  TEST_EQUAL(pipeline.size(), 0)
+END_SECTION
+
+DTAFile dta_file;
+PeakSpectrum input;
+dta_file.load(OPENMS_GET_TEST_DATA_PATH("Transformers_tests.dta"), input);
+
+// reference: the filters applied one after the other
+Param nlargest_param;
+nlargest_param.setValue("n", 10);
+PeakSpectrum reference = input;
+{
+  NLargest nlargest;
+  nlargest.setParameters(nlargest_param);
+  nlargest.filterPeakSpectrum(reference);
+  SqrtMower sqrt_mower;
+  sqrt_mower.filterPeakSpectrum(reference);
+  Normalizer normalizer;
+  normalizer.filterPeakSpectrum(reference);
+}
+
+SpectraFilterPipeline pipeline;
+pipeline.addFilter("NLargest", nlargest_param);
+pipeline.addFilter("SqrtMower");
+pipeline.addFilter("Normalizer");
+
+START_SECTION((void filterPeakSpectrum(PeakSpectrum& spectrum) const))
+  PeakSpectrum spec = input;
+  TEST_EQUAL(spec.size(), 121)
+  pipeline.filterPeakSpectrum(spec);
+  TEST_EQUAL(spec.size(), 10)
+  ABORT_IF(spec.size() != reference.size())
+  for (Size i = 0; i < spec.size(); ++i)
+  {
+    TEST_REAL_SIMILAR(spec[i].getMZ(), reference[i].getMZ())
+    TEST_REAL_SIMILAR(spec[i].getIntensity(), reference[i].getIntensity())
+  }
+END_SECTION
+
+START_SECTION((void filterPeakMap(PeakMap& exp) const))
+  PeakMap pm;
+  for (Size i = 0; i < 100; ++i)
+  {
+    pm.addSpectrum(input);
+  }
+  pipeline.filterPeakMap(pm);
+  ABORT_IF(pm.size() != 100)
+  for (Size s = 0; s < pm.size(); ++s)
+  {
+    ABORT_IF(pm[s].size() != reference.size())
+    for (Size i = 0; i < pm[s].size(); ++i)
+    {
+      TEST_REAL_SIMILAR(pm[s][i].getMZ(), reference[i].getMZ())
+      TEST_REAL_SIMILAR(pm[s][i].getIntensity(), reference[i].getIntensity())
+    }
+  }
+
+  // empty pipeline does not change the data
+  PeakMap pm2;
+  pm2.addSpectrum(input);
+  SpectraFilterPipeline().filterPeakMap(pm2);
+  TEST_EQUAL(pm2[0].size(), input.size())
+END_SECTION
+
+/////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////
+END_TEST
@@ -114,6 +114,84 @@ START_SECTION((template < typename MapType > void mergeSpectraBlockWise(MapType
 
 END_SECTION
 
+START_SECTION((void mergeSpectraBlockWiseBinned(PeakMap& exp)))
+  PeakMap exp, exp2;
+  MzMLFile().load(OPENMS_GET_TEST_DATA_PATH("SpectraMerger_input_2.mzML"), exp);
+  TEST_EQUAL(exp.size(), 144)
+
+  exp2 = exp;
+
+  // same blocks as mergeSpectraBlockWise
+  SpectraMerger merger;
+  Param p;
+  p.setValue("mz_binning_width", 0.0001);
+  p.setValue("mz_binning_width_unit", "Da");
+
+  p.setValue("block_method:rt_block_size", 5);
+  p.setValue("block_method:ms_levels", ListUtils::create<Int>("1"));
+  merger.setParameters(p);
+  merger.mergeSpectraBlockWiseBinned(exp);
+  TEST_EQUAL(exp.size(), 130);
+  exp=exp2;
+
+  p.setValue("block_method:rt_block_size", 4);
+  p.setValue("block_method:ms_levels", ListUtils::create<Int>("2"));
+  merger.setParameters(p);
+  merger.mergeSpectraBlockWiseBinned(exp);
+  TEST_EQUAL(exp.size(), 50);
+  TEST_REAL_SIMILAR(exp[0].getRT(),201.0275)
+  TEST_REAL_SIMILAR(exp[1].getRT(),204.34075)
+  TEST_EQUAL(exp[1].getMSLevel(), 2);
+  TEST_EQUAL(exp[2].getMSLevel(), 1);
+  exp=exp2;
+
+  p.setValue("block_method:rt_block_size", 4);
+  p.setValue("block_method:ms_levels", ListUtils::create<Int>("1,2"));
+  merger.setParameters(p);
+  merger.mergeSpectraBlockWiseBinned(exp);
+  TEST_EQUAL(exp.size(), 37);
+END_SECTION
+
+START_SECTION((static void mergeBlockBinned(const std::vector<const MSSpectrum*>& block, UInt ms_level, double mz_binning_width, bool ppm, MSSpectrum& merged)))
+  MSSpectrum s1, s2, s3, merged;
+  Peak1D pk;
+  s1.setRT(10.0);
+  s1.setNativeID("s1");
+  pk.setMZ(100.0); pk.setIntensity(1.0); s1.push_back(pk);
+  pk.setMZ(200.0); pk.setIntensity(2.0); s1.push_back(pk);
+  s2.setRT(20.0);
+  pk.setMZ(100.1); pk.setIntensity(3.0); s2.push_back(pk);
+  pk.setMZ(300.0); pk.setIntensity(4.0); s2.push_back(pk);
+  s3.setRT(30.0);
+  pk.setMZ(200.05); pk.setIntensity(2.0); s3.push_back(pk);
+  pk.setMZ(200.3); pk.setIntensity(1.0); s3.push_back(pk);
+
+  std::vector<const MSSpectrum*> block;
+  block.push_back(&s1);
+  block.push_back(&s2);
+  block.push_back(&s3);
+  SpectraMerger::mergeBlockBinned(block, 1, 0.2, false, merged);
+  TEST_EQUAL(merged.size(), 4)
+  TEST_EQUAL(merged.getNativeID(), "s1")
+  TEST_EQUAL(merged.getMSLevel(), 1)
+  TEST_REAL_SIMILAR(merged.getRT(), 20.0)
+  ABORT_IF(merged.size() != 4)
+  TEST_REAL_SIMILAR(merged[0].getMZ(), 100.075)
+  TEST_REAL_SIMILAR(merged[0].getIntensity(), 4.0)
+  TEST_REAL_SIMILAR(merged[1].getMZ(), 200.025)
+  TEST_REAL_SIMILAR(merged[1].getIntensity(), 4.0)
+  TEST_REAL_SIMILAR(merged[2].getMZ(), 200.3)
+  TEST_REAL_SIMILAR(merged[3].getMZ(), 300.0)
+  TEST_EQUAL(merged.isSorted(), true)
+
+  // relative tolerance: 10 ppm of 100 Th does not include 100.1
+  SpectraMerger::mergeBlockBinned(block, 1, 10.0, true, merged);
+  TEST_EQUAL(merged.size(), 6)
+
+  block.clear();
+  TEST_EXCEPTION(Exception::IllegalArgument, SpectraMerger::mergeBlockBinned(block, 1, 0.2, false, merged))
+END_SECTION
+
 START_SECTION((template < typename MapType > void mergeSpectraPrecursors(MapType &exp)))
 	PeakMap exp;
 	MzMLFile().load(OPENMS_GET_TEST_DATA_PATH("SpectraMerger_input_precursor.mzML"), exp);
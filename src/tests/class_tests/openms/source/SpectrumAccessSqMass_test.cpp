@@ -249,6 +249,97 @@ START_SECTION(void getAllSpectra(std::vector< OpenSwath::SpectrumPtr > & spectra
 }
 END_SECTION
 
+START_SECTION(std::vector<OpenSwath::SpectrumPtr> getSpectraByIds(const std::vector<std::size_t>& ids))
+{
+  OpenMS::Internal::MzMLSqliteHandler handler(OPENMS_GET_TEST_DATA_PATH("SqliteMassFile_1.sqMass"));
+  ptr = new SpectrumAccessSqMass(handler);
+
+  std::vector<std::size_t> ids;
+  ids.push_back(1);
+  ids.push_back(0);
+  std::vector<OpenSwath::SpectrumPtr> spectra = ptr->getSpectraByIds(ids);
+  TEST_EQUAL(spectra.size(), 2)
+
+  // results are returned in the order of the requested ids
+  for (Size k = 0; k < ids.size(); k++)
+  {
+    OpenSwath::SpectrumPtr single = ptr->getSpectrumById(ids[k]);
+    TEST_EQUAL(spectra[k]->getMZArray()->data.size(), single->getMZArray()->data.size())
+    TEST_EQUAL(spectra[k]->getMZArray()->data == single->getMZArray()->data, true)
+    TEST_EQUAL(spectra[k]->getIntensityArray()->data == single->getIntensityArray()->data, true)
+  }
+
+  TEST_EQUAL(ptr->getSpectraByIds(std::vector<std::size_t>()).size(), 0)
+}
+END_SECTION
+
+START_SECTION(OpenSwath::ChromatogramPtr getChromatogramById(int id))
+{
+  OpenMS::Internal::MzMLSqliteHandler handler(OPENMS_GET_TEST_DATA_PATH("SqliteMassFile_1.sqMass"));
+  ptr = new SpectrumAccessSqMass(handler);
+  TEST_EQUAL(ptr->getNrChromatograms(), 1)
+
+  std::vector<MSChromatogram> chroms;
+  handler.readChromatograms(chroms, std::vector<int>(1, 0));
+  TEST_EQUAL(chroms.size(), 1)
+
+  OpenSwath::ChromatogramPtr chrom = ptr->getChromatogramById(0);
+  TEST_EQUAL(chrom->getTimeArray()->data.size(), chroms[0].size())
+  TEST_EQUAL(chrom->getIntensityArray()->data.size(), chroms[0].size())
+  for (Size k = 0; k < chroms[0].size(); k++)
+  {
+    TEST_REAL_SIMILAR(chrom->getTimeArray()->data[k], chroms[0][k].getRT())
+    TEST_REAL_SIMILAR(chrom->getIntensityArray()->data[k], chroms[0][k].getIntensity())
+  }
+  delete ptr;
+}
+END_SECTION
+
+START_SECTION(std::vector<OpenSwath::ChromatogramPtr> getChromatogramsByRTRange(const std::vector<std::size_t>& ids, double rt_min, double rt_max) const)
+{
+  OpenMS::Internal::MzMLSqliteHandler handler(OPENMS_GET_TEST_DATA_PATH("SqliteMassFile_1.sqMass"));
+  ptr = new SpectrumAccessSqMass(handler);
+
+  std::vector<std::size_t> ids(1, 0);
+  OpenSwath::ChromatogramPtr full = ptr->getChromatogramById(0);
+  const std::vector<double>& rt = full->getTimeArray()->data;
+  TEST_EQUAL(rt.size() > 2, true)
+
+  // restrict to the inner data points
+  double rt_min = rt[1];
+  double rt_max = rt[rt.size() - 2];
+  std::vector<OpenSwath::ChromatogramPtr> res = ptr->getChromatogramsByRTRange(ids, rt_min, rt_max);
+  TEST_EQUAL(res.size(), 1)
+  TEST_EQUAL(res[0]->getTimeArray()->data.size(), rt.size() - 2)
+  TEST_EQUAL(res[0]->getIntensityArray()->data.size(), rt.size() - 2)
+  TEST_REAL_SIMILAR(res[0]->getTimeArray()->data.front(), rt_min)
+  TEST_REAL_SIMILAR(res[0]->getTimeArray()->data.back(), rt_max)
+  TEST_REAL_SIMILAR(res[0]->getIntensityArray()->data.front(), full->getIntensityArray()->data[1])
+
+  // an empty range returns empty chromatograms
+  res = ptr->getChromatogramsByRTRange(ids, rt.back() + 1.0, rt.back() + 2.0);
+  TEST_EQUAL(res.size(), 1)
+  TEST_EQUAL(res[0]->getTimeArray()->data.size(), 0)
+
+  TEST_EQUAL(ptr->getChromatogramsByRTRange(std::vector<std::size_t>(), rt_min, rt_max).size(), 0)
+  TEST_EXCEPTION(Exception::IllegalArgument, ptr->getChromatogramsByRTRange(ids, rt_max, rt_min))
+  delete ptr;
+}
+END_SECTION
+
+START_SECTION(void prefetchSpectraByRT(double RT, double deltaRT))
+{
+  OpenMS::Internal::MzMLSqliteHandler handler(OPENMS_GET_TEST_DATA_PATH("SqliteMassFile_1.sqMass"));
+  ptr = new SpectrumAccessSqMass(handler);
+
+  // a prefetch hint must not change what is returned afterwards
+  OpenSwath::SpectrumPtr before = ptr->getSpectrumById(0);
+  ptr->prefetchSpectraByRT(0.0, 1e6);
+  OpenSwath::SpectrumPtr after = ptr->getSpectrumById(0);
+  TEST_EQUAL(before->getMZArray()->data == after->getMZArray()->data, true)
+}
+END_SECTION
+
 /////////////////////////////////////////////////////////////
 /////////////////////////////////////////////////////////////
 END_TEST
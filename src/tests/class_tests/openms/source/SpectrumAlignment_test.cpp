@@ -193,6 +193,69 @@ START_SECTION(template <typename SpectrumType> void getSpectrumAlignment(std::ve
 
 END_SECTION
 
+START_SECTION((template <typename SpectrumType1, typename SpectrumType2> static void getNearestPeakMatches(std::vector<std::pair<Size, Size> > &alignment, const SpectrumType1 &s1, const SpectrumType2 &s2, double tolerance, bool is_relative_tolerance, bool one_to_one=false)))
+{
+  PeakSpectrum s1, s2;
+  s1.push_back(Peak1D(100.0, 1));
+  s1.push_back(Peak1D(200.0, 1));
+  s1.push_back(Peak1D(200.25, 1));
+  s1.push_back(Peak1D(300.0, 1));
+  s1.push_back(Peak1D(401.0, 1));
+  s2.push_back(Peak1D(99.5, 1));
+  s2.push_back(Peak1D(100.5, 1));
+  s2.push_back(Peak1D(200.1, 1));
+  s2.push_back(Peak1D(300.2, 1));
+  s2.push_back(Peak1D(400.0, 1));
+
+  vector<pair<Size, Size > > alignment;
+  // tie between 99.5 and 100.5 -> lower m/z, both s1 peaks at 200 match 200.1, 401.0 outside
+  SpectrumAlignment::getNearestPeakMatches(alignment, s1, s2, 0.5, false);
+  TEST_EQUAL(alignment.size(), 4)
+  ABORT_IF(alignment.size() != 4)
+  TEST_EQUAL(alignment[0].first, 0)
+  TEST_EQUAL(alignment[0].second, 0)
+  TEST_EQUAL(alignment[1].first, 1)
+  TEST_EQUAL(alignment[1].second, 2)
+  TEST_EQUAL(alignment[2].first, 2)
+  TEST_EQUAL(alignment[2].second, 2)
+  TEST_EQUAL(alignment[3].first, 3)
+  TEST_EQUAL(alignment[3].second, 3)
+
+  // one-to-one: 200.0 is closer to 200.1 than 200.25
+  SpectrumAlignment::getNearestPeakMatches(alignment, s1, s2, 0.5, false, true);
+  TEST_EQUAL(alignment.size(), 3)
+  ABORT_IF(alignment.size() != 3)
+  TEST_EQUAL(alignment[1].first, 1)
+  TEST_EQUAL(alignment[1].second, 2)
+  TEST_EQUAL(alignment[2].first, 3)
+
+  // same result as findNearest based matching for ppm tolerances
+  SpectrumAlignment::getNearestPeakMatches(alignment, s1, s2, 1000.0, true);
+  TEST_EQUAL(alignment.size(), 3)
+  ABORT_IF(alignment.size() != 3)
+  TEST_EQUAL(alignment[2].first, 3)
+  TEST_EQUAL(alignment[2].second, 3)
+
+  // empty spectra
+  PeakSpectrum empty;
+  SpectrumAlignment::getNearestPeakMatches(alignment, s1, empty, 0.5, false);
+  TEST_EQUAL(alignment.size(), 0)
+  SpectrumAlignment::getNearestPeakMatches(alignment, empty, s2, 0.5, false);
+  TEST_EQUAL(alignment.size(), 0)
+
+  // same matching through the parameters
+  SpectrumAlignment sa;
+  Param p(sa.getParameters());
+  p.setValue("tolerance", 0.5);
+  p.setValue("matching_method", "nearest_peak");
+  p.setValue("one_to_one", "true");
+  sa.setParameters(p);
+  SpectrumAlignment sa_copy(sa);
+  sa_copy.getSpectrumAlignment(alignment, s1, s2);
+  TEST_EQUAL(alignment.size(), 3)
+}
+END_SECTION
+
 ptr = new SpectrumAlignment();
 
 /////////////////////////////////////////////////////////////
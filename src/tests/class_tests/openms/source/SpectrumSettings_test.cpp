@@ -506,6 +506,41 @@ START_SECTION((void unify(const SpectrumSettings &rhs)))
 }
 END_SECTION
 
+START_SECTION((Size shareMetaData(const SpectrumSettings &other)))
+{
+  SpectrumSettings s1, s2;
+  // default-constructed sub-objects are always equal
+  TEST_EQUAL(s1.shareMetaData(s2), 3)
+
+  s1.getInstrumentSettings().setPolarity(IonSource::POSITIVE);
+  s1.getAcquisitionInfo().setMethodOfCombination("sum");
+  s2.getInstrumentSettings().setPolarity(IonSource::POSITIVE);
+  s2.getAcquisitionInfo().setMethodOfCombination("other");
+  TEST_EQUAL(s2.shareMetaData(s1), 2) // instrument settings and source file
+  const SpectrumSettings& c1 = s1;
+  const SpectrumSettings& c2 = s2;
+  TEST_EQUAL(&c1.getInstrumentSettings() == &c2.getInstrumentSettings(), true)
+  TEST_EQUAL(s2.getAcquisitionInfo().getMethodOfCombination(), "other")
+
+  // copy-on-write: modifying one spectrum does not affect the other
+  s2.getInstrumentSettings().setPolarity(IonSource::NEGATIVE);
+  TEST_EQUAL(s1.getInstrumentSettings().getPolarity(), IonSource::POSITIVE)
+  TEST_EQUAL(s2.getInstrumentSettings().getPolarity(), IonSource::NEGATIVE)
+
+  // the same holds for copies
+  SpectrumSettings s3(s1);
+  s3.getAcquisitionInfo().setMethodOfCombination("changed");
+  s3.setSourceFile(SourceFile());
+  s3.getSourceFile().setNameOfFile("file.mzML");
+  TEST_EQUAL(s1.getAcquisitionInfo().getMethodOfCombination(), "sum")
+  TEST_EQUAL(s1.getSourceFile().getNameOfFile(), "")
+  TEST_EQUAL(s3.getSourceFile().getNameOfFile(), "file.mzML")
+  TEST_EQUAL(s1 == s3, false)
+  s3 = s1;
+  TEST_EQUAL(s1 == s3, true)
+}
+END_SECTION
+
 /////////////////////////////////////////////////////////////
 /////////////////////////////////////////////////////////////
 END_TEST
@@ -0,0 +1,243 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2018.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: Timo Sachsenberg$
+// $Authors: Timo Sachsenberg $
+// --------------------------------------------------------------------------
+
+#include <OpenMS/CONCEPT/ClassTest.h>
+#include <OpenMS/test_config.h>
+
+///////////////////////////
+#include <OpenMS/DATASTRUCTURES/StaticKDTree.h>
+///////////////////////////
+
+#include <cmath>
+
+using namespace OpenMS;
+using namespace std;
+
+typedef StaticKDTree<2> Tree;
+
+// brute force references
+vector<Size> rangeReference(const vector<Tree::PositionType>& points, const Tree::PositionType& low, const Tree::PositionType& high)
+{
+  vector<Size> result;
+  for (Size i = 0; i < points.size(); ++i)
+  {
+    if (points[i][0] >= low[0] && points[i][0] <= high[0] && points[i][1] >= low[1] && points[i][1] <= high[1]) result.push_back(i);
+  }
+  return result;
+}
+
+vector<Size> nnReference(const vector<Tree::PositionType>& points, const Tree::PositionType& position, Size k)
+{
+  vector<pair<double, Size> > distances;
+  for (Size i = 0; i < points.size(); ++i)
+  {
+    double dx = points[i][0] - position[0];
+    double dy = points[i][1] - position[1];
+    distances.push_back(make_pair(dx * dx + dy * dy, i));
+  }
+  sort(distances.begin(), distances.end());
+  vector<Size> result;
+  for (Size i = 0; i < min(k, distances.size()); ++i)
+  {
+    result.push_back(distances[i].second);
+  }
+  return result;
+}
+
+START_TEST(StaticKDTree, "$Id$")
+
+/////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////
+
+// grid-like points (many ties) and irregular points
+vector<Tree::PositionType> points;
+for (Size i = 0; i < 1000; ++i)
+{
+  Tree::PositionType p;
+  p[0] = (i * 37) % 101;
+  p[1] = i % 13 + 0.01 * ((i * 7) % 5);
+  points.push_back(p);
+}
+
+Tree* ptr = nullptr;
+Tree* null_ptr = nullptr;
+START_SECTION((StaticKDTree()))
+{
+  ptr = new Tree();
+  TEST_NOT_EQUAL(ptr, null_ptr)
+  TEST_EQUAL(ptr->size(), 0)
+  TEST_EQUAL(ptr->empty(), true)
+}
+END_SECTION
+
+START_SECTION((~StaticKDTree()))
+{
+  delete ptr;
+}
+END_SECTION
+
+START_SECTION((StaticKDTree(const std::vector<PositionType>& points)))
+{
+  Tree tree(points);
+  TEST_EQUAL(tree.size(), 1000)
+  TEST_EQUAL(tree.empty(), false)
+}
+END_SECTION
+
+START_SECTION((void build(const std::vector<PositionType>& points)))
+{
+  Tree tree;
+  tree.build(points);
+  TEST_EQUAL(tree.size(), 1000)
+  vector<Tree::PositionType> few(points.begin(), points.begin() + 3);
+  tree.build(few);
+  TEST_EQUAL(tree.size(), 3)
+  vector<Size> result;
+  tree.queryRange(Tree::PositionType(-1000, -1000), Tree::PositionType(1000, 1000), result);
+  TEST_EQUAL(result.size(), 3)
+}
+END_SECTION
+
+START_SECTION((Size size() const))
+{
+  NOT_TESTABLE // tested above
+}
+END_SECTION
+
+START_SECTION((bool empty() const))
+{
+  NOT_TESTABLE // tested above
+}
+END_SECTION
+
+START_SECTION((void clear()))
+{
+  Tree tree(points);
+  tree.clear();
+  TEST_EQUAL(tree.size(), 0)
+  vector<Size> result(1, 5);
+  tree.queryRange(Tree::PositionType(-1000, -1000), Tree::PositionType(1000, 1000), result);
+  TEST_EQUAL(result.empty(), true)
+}
+END_SECTION
+
+Tree tree(points);
+
+START_SECTION((void queryRange(const PositionType& low, const PositionType& high, std::vector<Size>& result_indices) const))
+{
+  vector<Size> result;
+  for (Size q = 0; q < 50; ++q)
+  {
+    Tree::PositionType low((q * 17) % 90, (q * 3) % 11);
+    Tree::PositionType high(low[0] + q % 20, low[1] + q % 4 + 0.02);
+    tree.queryRange(low, high, result);
+    vector<Size> expected = rangeReference(points, low, high);
+    TEST_EQUAL(result.size(), expected.size())
+    TEST_EQUAL(result == expected, true)
+  }
+  // boundaries are inclusive
+  tree.queryRange(points[10], points[10], result);
+  TEST_EQUAL(find(result.begin(), result.end(), 10) != result.end(), true)
+  // empty range
+  tree.queryRange(Tree::PositionType(20, 5), Tree::PositionType(10, 6), result);
+  TEST_EQUAL(result.empty(), true)
+}
+END_SECTION
+
+START_SECTION((void queryRanges(const std::vector<RangeType>& ranges, std::vector<std::vector<Size> >& result_indices) const))
+{
+  vector<Tree::RangeType> ranges;
+  for (Size q = 0; q < 200; ++q)
+  {
+    Tree::PositionType low((q * 13) % 95, (q * 5) % 12);
+    ranges.push_back(make_pair(low, Tree::PositionType(low[0] + q % 7, low[1] + 1)));
+  }
+  vector<vector<Size> > results;
+  tree.queryRanges(ranges, results);
+  TEST_EQUAL(results.size(), ranges.size())
+  for (Size q = 0; q < ranges.size(); ++q)
+  {
+    TEST_EQUAL(results[q] == rangeReference(points, ranges[q].first, ranges[q].second), true)
+  }
+}
+END_SECTION
+
+START_SECTION((void nearestNeighbours(const PositionType& position, Size k, std::vector<Size>& result_indices, std::vector<CoordinateType>* squared_distances = nullptr) const))
+{
+  vector<Size> result;
+  vector<double> distances;
+  for (Size q = 0; q < 50; ++q)
+  {
+    Tree::PositionType position((q * 7.3), (q * 0.37));
+    Size k = 1 + q % 10;
+    tree.nearestNeighbours(position, k, result, &distances);
+    TEST_EQUAL(result.size(), k)
+    TEST_EQUAL(distances.size(), k)
+    TEST_EQUAL(result == nnReference(points, position, k), true)
+    for (Size i = 0; i < result.size(); ++i)
+    {
+      double dx = points[result[i]][0] - position[0];
+      double dy = points[result[i]][1] - position[1];
+      TEST_REAL_SIMILAR(distances[i], dx * dx + dy * dy)
+    }
+  }
+  // at most size() neighbours
+  Tree small(vector<Tree::PositionType>(points.begin(), points.begin() + 5));
+  small.nearestNeighbours(Tree::PositionType(0, 0), 10, result);
+  TEST_EQUAL(result.size(), 5)
+  small.nearestNeighbours(Tree::PositionType(0, 0), 0, result);
+  TEST_EQUAL(result.empty(), true)
+}
+END_SECTION
+
+START_SECTION((void nearestNeighbours(const std::vector<PositionType>& positions, Size k, std::vector<std::vector<Size> >& result_indices) const))
+{
+  vector<Tree::PositionType> positions;
+  for (Size q = 0; q < 200; ++q)
+  {
+    positions.push_back(Tree::PositionType(q * 0.51, (q * 7) % 13 + 0.5));
+  }
+  vector<vector<Size> > results;
+  tree.nearestNeighbours(positions, 3, results);
+  TEST_EQUAL(results.size(), positions.size())
+  for (Size q = 0; q < positions.size(); ++q)
+  {
+    TEST_EQUAL(results[q] == nnReference(points, positions[q], 3), true)
+  }
+}
+END_SECTION
+
+/////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////
+END_TEST
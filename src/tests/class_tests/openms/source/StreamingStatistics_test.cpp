@@ -0,0 +1,223 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry               
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2018.
+// 
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution 
+//    may be used to endorse or promote products derived from this software 
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS. 
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING 
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, 
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, 
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; 
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, 
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR 
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF 
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+// 
+// --------------------------------------------------------------------------
+// $Maintainer: Timo Sachsenberg $
+// $Authors: Timo Sachsenberg $
+// --------------------------------------------------------------------------
+
+#include <OpenMS/CONCEPT/ClassTest.h>
+#include <OpenMS/test_config.h>
+
+///////////////////////////
+
+#include <OpenMS/MATH/STATISTICS/StreamingStatistics.h>
+#include <OpenMS/MATH/STATISTICS/StatisticFunctions.h>
+#include <vector>
+
+using namespace OpenMS;
+using namespace OpenMS::Math;
+using namespace std;
+
+///////////////////////////
+
+START_TEST(StreamingStatistics, "$Id$")
+
+/////////////////////////////////////////////////////////////
+
+// a permutation of 0, ..., 9999
+vector<double> data;
+for (Size i = 0; i < 10000; ++i)
+{
+  data.push_back(double((i * 7919) % 10000));
+}
+
+START_SECTION((RunningStatistics()))
+{
+  RunningStatistics stats;
+  TEST_EQUAL(stats.count(), 0)
+  TEST_REAL_SIMILAR(stats.mean(), 0.0)
+  TEST_REAL_SIMILAR(stats.variance(), 0.0)
+}
+END_SECTION
+
+START_SECTION((void add(double value)))
+{
+  double x[] = {3, 1, 4, 1, 5, 9, 2, 6};
+  RunningStatistics stats;
+  for (Size i = 0; i < 8; ++i) stats.add(x[i]);
+  TEST_EQUAL(stats.count(), 8)
+  TEST_REAL_SIMILAR(stats.mean(), Math::mean(x, x + 8))
+  TEST_REAL_SIMILAR(stats.variance(), Math::variance(x, x + 8))
+  TEST_REAL_SIMILAR(stats.sd(), Math::sd(x, x + 8))
+  TEST_REAL_SIMILAR(stats.sum(), 31.0)
+  TEST_REAL_SIMILAR(stats.min(), 1.0)
+  TEST_REAL_SIMILAR(stats.max(), 9.0)
+  stats.clear();
+  TEST_EQUAL(stats.count(), 0)
+  stats.add(-2.0);
+  TEST_REAL_SIMILAR(stats.min(), -2.0)
+  TEST_REAL_SIMILAR(stats.max(), -2.0)
+  TEST_REAL_SIMILAR(stats.variance(), 0.0)
+}
+END_SECTION
+
+START_SECTION((void merge(const RunningStatistics& other)))
+{
+  RunningStatistics all;
+  all.add(data.begin(), data.end());
+  vector<RunningStatistics> parts(3);
+  for (Size i = 0; i < data.size(); ++i) parts[i % 3].add(data[i]);
+  RunningStatistics merged;
+  merged.merge(RunningStatistics()); // empty
+  for (Size i = 0; i < parts.size(); ++i) merged.merge(parts[i]);
+  TEST_EQUAL(merged.count(), all.count())
+  TEST_REAL_SIMILAR(merged.mean(), 4999.5)
+  TEST_REAL_SIMILAR(merged.variance(), Math::variance(data.begin(), data.end()))
+  TEST_REAL_SIMILAR(merged.variance(), all.variance())
+  TEST_REAL_SIMILAR(merged.min(), 0.0)
+  TEST_REAL_SIMILAR(merged.max(), 9999.0)
+}
+END_SECTION
+
+START_SECTION((QuantileSketch(double compression = 100.0)))
+{
+  QuantileSketch sketch;
+  TEST_EQUAL(sketch.empty(), true)
+  TEST_REAL_SIMILAR(sketch.getCompression(), 100.0)
+  TEST_EXCEPTION(Exception::InvalidRange, sketch.quantile(0.5))
+  TEST_EXCEPTION(Exception::InvalidValue, QuantileSketch(1.0))
+}
+END_SECTION
+
+START_SECTION((double quantile(double q) const))
+{
+  // few values: exact, interpolated like Math::median
+  double x[] = {3, 1, 4, 1, 5, 9, 2, 6};
+  QuantileSketch sketch;
+  sketch.add(x, x + 8);
+  TEST_EQUAL(sketch.centroidCount(), 8)
+  TEST_REAL_SIMILAR(sketch.median(), 3.5)
+  TEST_REAL_SIMILAR(sketch.quantile(0.25), 1.5)
+  TEST_REAL_SIMILAR(sketch.quantile(0.0), 1.0)
+  TEST_REAL_SIMILAR(sketch.quantile(1.0), 9.0)
+  TEST_EXCEPTION(Exception::InvalidValue, sketch.quantile(1.5))
+  TEST_EXCEPTION(Exception::InvalidValue, sketch.quantile(-0.1))
+
+  double y[] = {5, 3, 1, 4, 2};
+  QuantileSketch odd;
+  odd.add(y, y + 5);
+  TEST_REAL_SIMILAR(odd.median(), 3.0)
+
+  // many values: approximate with bounded memory
+  QuantileSketch large;
+  large.add(data.begin(), data.end());
+  TEST_REAL_SIMILAR(large.count(), 10000.0)
+  TEST_EQUAL(large.centroidCount() <= 200, true)
+  TOLERANCE_ABSOLUTE(10.0)
+  TEST_REAL_SIMILAR(large.quantile(0.01), 99.0)
+  TEST_REAL_SIMILAR(large.quantile(0.25), 2500.0)
+  TEST_REAL_SIMILAR(large.median(), 5000.0)
+  TEST_REAL_SIMILAR(large.quantile(0.99), 9900.0)
+  TOLERANCE_ABSOLUTE(1e-5)
+  TEST_REAL_SIMILAR(large.quantile(0.0), 0.0)
+  TEST_REAL_SIMILAR(large.quantile(1.0), 9999.0)
+
+  // weighted values
+  QuantileSketch weighted;
+  weighted.add(1.0, 3.0);
+  weighted.add(10.0, 1.0);
+  weighted.add(5.0, 0.0); // ignored
+  TEST_REAL_SIMILAR(weighted.count(), 4.0)
+  TEST_REAL_SIMILAR(weighted.quantile(0.25), 1.0)
+}
+END_SECTION
+
+START_SECTION((void merge(const QuantileSketch& other)))
+{
+  vector<QuantileSketch> parts(4);
+  for (Size i = 0; i < data.size(); ++i) parts[i % 4].add(data[i]);
+  QuantileSketch merged;
+  for (Size i = 0; i < parts.size(); ++i) merged.merge(parts[i]);
+  TEST_REAL_SIMILAR(merged.count(), 10000.0)
+  TEST_REAL_SIMILAR(merged.min(), 0.0)
+  TEST_REAL_SIMILAR(merged.max(), 9999.0)
+  TOLERANCE_ABSOLUTE(10.0)
+  TEST_REAL_SIMILAR(merged.quantile(0.01), 99.0)
+  TEST_REAL_SIMILAR(merged.median(), 5000.0)
+  TEST_REAL_SIMILAR(merged.quantile(0.99), 9900.0)
+  TOLERANCE_ABSOLUTE(1e-5)
+
+  // same partition and merge order gives the same result
+  QuantileSketch merged2;
+  for (Size i = 0; i < parts.size(); ++i) merged2.merge(parts[i]);
+  TEST_EQUAL(merged.median() == merged2.median(), true)
+
+  // merging with itself doubles the weight
+  QuantileSketch self;
+  double x[] = {1, 2, 3};
+  self.add(x, x + 3);
+  self.merge(self);
+  TEST_REAL_SIMILAR(self.count(), 6.0)
+  TEST_REAL_SIMILAR(self.median(), 2.0)
+
+  merged.clear();
+  TEST_EQUAL(merged.empty(), true)
+}
+END_SECTION
+
+START_SECTION([EXTRA](SummaryStatistics(const RunningStatistics& stats, const QuantileSketch& sketch)))
+{
+  vector<double> x;
+  x.push_back(3); x.push_back(1); x.push_back(4); x.push_back(1);
+  x.push_back(5); x.push_back(9); x.push_back(2); x.push_back(6);
+  RunningStatistics stats;
+  QuantileSketch sketch;
+  stats.add(x.begin(), x.end());
+  sketch.add(x.begin(), x.end());
+  SummaryStatistics<vector<double> > streamed(stats, sketch);
+  SummaryStatistics<vector<double> > exact(x);
+  TEST_EQUAL(streamed.count, exact.count)
+  TEST_REAL_SIMILAR(streamed.mean, exact.mean)
+  TEST_REAL_SIMILAR(streamed.variance, exact.variance)
+  TEST_REAL_SIMILAR(streamed.min, exact.min)
+  TEST_REAL_SIMILAR(streamed.lowerq, exact.lowerq)
+  TEST_REAL_SIMILAR(streamed.median, exact.median)
+  TEST_REAL_SIMILAR(streamed.upperq, exact.upperq)
+  TEST_REAL_SIMILAR(streamed.max, exact.max)
+
+  SummaryStatistics<vector<double> > empty((RunningStatistics()), QuantileSketch());
+  TEST_EQUAL(empty.count, 0)
+  TEST_REAL_SIMILAR(empty.median, 0.0)
+}
+END_SECTION
+
+/////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////
+END_TEST
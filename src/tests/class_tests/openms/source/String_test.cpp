@@ -1019,6 +1019,60 @@ START_SECTION((String& operator+= (const std::string& s)))
 	TEST_EQUAL(s, "test7")
 END_SECTION
 
+START_SECTION((StringView StringView::trim() const))
+	String s(" \t test \r\n");
+	TEST_EQUAL(StringView(s).trim().getString(), "test")
+	TEST_EQUAL(StringView(s).trim().data() == s.data() + 3, true)
+	s = "  \t ";
+	TEST_EQUAL(StringView(s).trim().empty(), true)
+	s = "";
+	TEST_EQUAL(StringView(s).trim().empty(), true)
+END_SECTION
+
+START_SECTION((bool StringView::split(const char splitter, std::vector<StringView>& substrings) const))
+	std::vector<StringView> views;
+	std::vector<String> strings;
+	String s("1.5\t2\t\t\"x\"\t");
+	TEST_EQUAL(StringView(s).split('\t', views), s.split('\t', strings))
+	ABORT_IF(views.size() != strings.size())
+	for (Size i = 0; i < views.size(); ++i)
+	{
+		TEST_EQUAL(views[i].getString(), strings[i])
+	}
+	TEST_EQUAL(views.size(), 5)
+	s = "no_splitter";
+	TEST_EQUAL(StringView(s).split('\t', views), false)
+	TEST_EQUAL(views.size(), 1)
+	TEST_EQUAL(views[0] == StringView(s), true)
+	s = "";
+	TEST_EQUAL(StringView(s).split('\t', views), false)
+	TEST_EQUAL(views.size(), 0)
+END_SECTION
+
+START_SECTION((Int StringView::toInt() const))
+	String s("123 456");
+	TEST_EQUAL(StringView(s).substr(0, 3).toInt(), 123)
+	TEST_EQUAL(StringView(s).substr(3, 4).toInt(), 456)
+	TEST_EXCEPTION(Exception::ConversionError, StringView(s).toInt())
+	TEST_EXCEPTION(Exception::ConversionError, StringView().toInt())
+END_SECTION
+
+START_SECTION((float StringView::toFloat() const))
+	String s("1.5e3x");
+	TEST_REAL_SIMILAR(StringView(s).substr(0, 5).toFloat(), 1500.0)
+	TEST_EXCEPTION(Exception::ConversionError, StringView(s).toFloat())
+END_SECTION
+
+START_SECTION((double StringView::toDouble() const))
+	String s("  -2.25\t7");
+	std::vector<StringView> views;
+	StringView(s).split('\t', views);
+	TEST_REAL_SIMILAR(views[0].toDouble(), -2.25)
+	TEST_REAL_SIMILAR(views[1].toDouble(), 7.0)
+	TEST_EXCEPTION(Exception::ConversionError, StringView(s).toDouble())
+	TEST_REAL_SIMILAR(StringView(s).substr(0, 7).toDouble(), -2.25)
+END_SECTION
+
 /////////////////////////////////////////////////////////////
 /////////////////////////////////////////////////////////////
 END_TEST
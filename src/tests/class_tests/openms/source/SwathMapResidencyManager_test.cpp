@@ -0,0 +1,225 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2018.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: Hannes Roest $
+// $Authors: Hannes Roest $
+// --------------------------------------------------------------------------
+
+
+#include <OpenMS/CONCEPT/ClassTest.h>
+#include <OpenMS/test_config.h>
+
+///////////////////////////
+#include <OpenMS/ANALYSIS/OPENSWATH/DATAACCESS/SwathMapResidencyManager.h>
+///////////////////////////
+
+#include <OpenMS/ANALYSIS/OPENSWATH/DATAACCESS/SpectrumAccessOpenMS.h>
+#include <OpenMS/KERNEL/MSExperiment.h>
+
+#include <chrono>
+#include <thread>
+
+using namespace OpenMS;
+using namespace std;
+
+namespace
+{
+  OpenSwath::SpectrumAccessPtr createMap(double rt_offset)
+  {
+    boost::shared_ptr<PeakMap> exp(new PeakMap);
+    for (Size i = 0; i < 10; ++i)
+    {
+      MSSpectrum spec;
+      spec.setRT(rt_offset + i);
+      spec.setMSLevel(2);
+      for (Size j = 0; j < 100; ++j)
+      {
+        spec.push_back(Peak1D(400.0 + j, 100.0));
+      }
+      exp->addSpectrum(spec);
+    }
+    return OpenSwath::SpectrumAccessPtr(new SpectrumAccessOpenMS(exp));
+  }
+
+  // waits (at most a few seconds) until the prefetch thread has loaded the map
+  bool waitResident(const SwathMapResidencyManager& manager, const OpenSwath::SpectrumAccessPtr& map)
+  {
+    for (Size i = 0; i < 500 && !manager.isResident(map); ++i)
+    {
+      std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    return manager.isResident(map);
+  }
+}
+
+START_TEST(SwathMapResidencyManager, "$Id$")
+
+/////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////
+
+SwathMapResidencyManager* ptr = nullptr;
+SwathMapResidencyManager* nullPointer = nullptr;
+
+OpenSwath::SpectrumAccessPtr map1 = createMap(0.0);
+OpenSwath::SpectrumAccessPtr map2 = createMap(100.0);
+OpenSwath::SpectrumAccessPtr map3 = createMap(200.0);
+UInt64 map_size = 0;
+
+START_SECTION(SwathMapResidencyManager(UInt64 memory_budget))
+{
+  ptr = new SwathMapResidencyManager(1000);
+  TEST_NOT_EQUAL(ptr, nullPointer)
+  TEST_EQUAL(ptr->getMemoryBudget(), 1000)
+  TEST_EQUAL(ptr->getResidentBytes(), 0)
+}
+END_SECTION
+
+START_SECTION(~SwathMapResidencyManager())
+{
+  delete ptr;
+}
+END_SECTION
+
+START_SECTION((static UInt64 getMemoryUsage(OpenSwath::ISpectrumAccess& map)))
+{
+  map_size = SwathMapResidencyManager::getMemoryUsage(*map1);
+  // at least the m/z and intensity values
+  TEST_EQUAL(map_size >= 10 * 100 * 2 * sizeof(double), true)
+  TEST_EQUAL(SwathMapResidencyManager::getMemoryUsage(*map2), map_size)
+}
+END_SECTION
+
+START_SECTION((OpenSwath::SpectrumAccessPtr acquire(const OpenSwath::SpectrumAccessPtr& map)))
+{
+  // fits into the budget: in-memory copy with the same data
+  SwathMapResidencyManager manager(10 * map_size);
+  OpenSwath::SpectrumAccessPtr resident = manager.acquire(map1);
+  TEST_NOT_EQUAL(resident.get(), map1.get())
+  TEST_EQUAL(resident->getNrSpectra(), map1->getNrSpectra())
+  TEST_REAL_SIMILAR(resident->getSpectrumMetaById(5).RT, 5.0)
+  TEST_EQUAL(resident->getSpectrumById(5)->getMZArray()->data.size(), 100)
+  TEST_EQUAL(manager.isResident(map1), true)
+  TEST_EQUAL(manager.getResidentBytes(), map_size)
+
+  // the same copy is shared between users
+  OpenSwath::SpectrumAccessPtr resident2 = manager.acquire(map1);
+  TEST_EQUAL(resident2.get(), resident.get())
+  manager.release(map1);
+  manager.release(map1);
+
+  // does not fit into the budget: original map
+  SwathMapResidencyManager small(map_size / 2);
+  TEST_EQUAL(small.acquire(map1).get(), map1.get())
+  TEST_EQUAL(small.isResident(map1), false)
+  TEST_EQUAL(small.getResidentBytes(), 0)
+  small.release(map1);
+}
+END_SECTION
+
+START_SECTION((void release(const OpenSwath::SpectrumAccessPtr& map)))
+{
+  // room for two maps, least recently used maps are evicted first
+  SwathMapResidencyManager manager(2 * map_size + map_size / 2);
+  manager.acquire(map1);
+  manager.release(map1);
+  manager.acquire(map2);
+  manager.release(map2);
+  manager.acquire(map1);
+  manager.release(map1);
+  TEST_EQUAL(manager.isResident(map1), true)
+  TEST_EQUAL(manager.isResident(map2), true)
+
+  OpenSwath::SpectrumAccessPtr resident3 = manager.acquire(map3);
+  TEST_NOT_EQUAL(resident3.get(), map3.get())
+  TEST_EQUAL(manager.isResident(map1), true)
+  TEST_EQUAL(manager.isResident(map2), false)
+  TEST_EQUAL(manager.isResident(map3), true)
+
+  // maps in use are not evicted
+  manager.acquire(map1);
+  TEST_EQUAL(manager.acquire(map2).get(), map2.get())
+  TEST_EQUAL(manager.isResident(map1), true)
+  TEST_EQUAL(manager.isResident(map3), true)
+  TEST_EQUAL(manager.getResidentBytes() <= manager.getMemoryBudget(), true)
+  manager.release(map2);
+  manager.release(map1);
+  manager.release(map3);
+}
+END_SECTION
+
+START_SECTION((void clear()))
+{
+  SwathMapResidencyManager manager(10 * map_size);
+  manager.acquire(map1);
+  manager.acquire(map2);
+  manager.release(map2);
+  manager.clear();
+  // only unused maps are removed
+  TEST_EQUAL(manager.isResident(map1), true)
+  TEST_EQUAL(manager.isResident(map2), false)
+  TEST_EQUAL(manager.getResidentBytes(), map_size)
+  manager.release(map1);
+}
+END_SECTION
+
+START_SECTION((void setSchedule(const std::vector<OpenSwath::SpectrumAccessPtr>& schedule)))
+{
+  SwathMapResidencyManager manager(2 * map_size + map_size / 2);
+  // sizes are only estimated once a map has been loaded
+  manager.acquire(map1);
+  manager.release(map1);
+  manager.clear();
+
+  std::vector<OpenSwath::SpectrumAccessPtr> schedule;
+  schedule.push_back(map1);
+  schedule.push_back(map2);
+  schedule.push_back(map3);
+  manager.setSchedule(schedule);
+  TEST_EQUAL(waitResident(manager, map1), true)
+  TEST_EQUAL(waitResident(manager, map2), true)
+  // prefetched maps are not evicted for further prefetching
+  TEST_EQUAL(manager.isResident(map3), false)
+
+  OpenSwath::SpectrumAccessPtr resident = manager.acquire(map1);
+  TEST_NOT_EQUAL(resident.get(), map1.get())
+  manager.release(map1);
+  resident.reset();
+
+  // once map1 is done, it makes room for map3
+  TEST_EQUAL(waitResident(manager, map3), true)
+  TEST_EQUAL(manager.isResident(map1), false)
+  TEST_EQUAL(manager.isResident(map2), true)
+  manager.setSchedule(std::vector<OpenSwath::SpectrumAccessPtr>());
+}
+END_SECTION
+
+/////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////
+END_TEST
@@ -75,4 +75,41 @@ START_SECTION(static bool getProcessMemoryConsumption(size_t& mem_virtual))
 }
 END_SECTION
 
+START_SECTION(static bool getProcessPeakMemoryConsumption(size_t& mem_virtual))
+{
+  size_t peak(0), current(0);
+  if (SysInfo::getProcessPeakMemoryConsumption(peak))
+  {
+    SysInfo::getProcessMemoryConsumption(current);
+    std::cout << "Peak memory consumed: " << peak << " KB" << std::endl;
+    // the file loaded above was in memory at some point
+    TEST_EQUAL(peak > 10000, true)
+    TEST_EQUAL(peak + 1024 >= current, true) // allow for rounding of the different sources
+  }
+  else
+  {
+    TEST_EQUAL(peak, 0)
+  }
+}
+END_SECTION
+
+START_SECTION(static bool getProcessIOCounters(size_t& bytes_read, size_t& bytes_written))
+{
+  size_t read_before(0), written_before(0), read_after(0), written_after(0);
+  if (SysInfo::getProcessIOCounters(read_before, written_before))
+  {
+    PeakMap exp;
+    MzMLFile().load(OPENMS_GET_TEST_DATA_PATH("MzMLFile_5_long.mzML"), exp);
+    TEST_EQUAL(SysInfo::getProcessIOCounters(read_after, written_after), true)
+    TEST_EQUAL(read_after - read_before > 10000000, true)
+    TEST_EQUAL(written_after >= written_before, true)
+  }
+  else
+  {
+    TEST_EQUAL(read_before, 0)
+    TEST_EQUAL(written_before, 0)
+  }
+}
+END_SECTION
+
 END_TEST
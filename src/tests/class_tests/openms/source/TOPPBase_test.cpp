@@ -393,6 +393,36 @@ public:
   }
 };
 
+// Test class for batch mode: records the jobs it ran
+class TOPPBaseBatchTest
+  : public TOPPBase
+{
+public:
+  TOPPBaseBatchTest()
+    : TOPPBase("TOPPBaseBatchTest", "A test class for batch mode", false)
+  {
+  }
+
+  void registerOptionsAndFlags_() override
+  {
+    registerStringOption_("stringoption", "<string>", "", "string description", false);
+    registerIntOption_("fail", "<int>", 0, "exit code to return", false);
+  }
+
+  ExitCodes main_(int /*argc*/ , const char** /*argv*/) override
+  {
+    jobs.push_back(getStringOption_("stringoption"));
+    return ExitCodes(getIntOption_("fail"));
+  }
+
+  ExitCodes run(int argc , const char** argv)
+  {
+    return main(argc, argv);
+  }
+
+  StringList jobs;
+};
+
 /////////////////////////////////////////////////////////////
 
   START_TEST(TOPPBase, "$Id$");
@@ -823,6 +853,34 @@ START_SECTION(([EXTRA] test subsection parameters))
 }
 END_SECTION
 
+START_SECTION(([EXTRA] batch mode))
+{
+  String batch_file;
+  NEW_TMP_FILE(batch_file)
+  {
+    ofstream batch(batch_file.c_str());
+    batch << "# comment\n"
+          << "-stringoption first -test\n"
+          << "\n"
+          << "  -stringoption \"with space\" -test  \n"
+          << "-stringoption failing -fail 8 -test\n"
+          << "-unknown_option -test\n"
+          << "-stringoption last -test\n"
+          << "quit\n"
+          << "-stringoption ignored -test\n";
+  }
+  const char* batch_cl[3] = {"TOPPBaseBatchTest", "-batch", batch_file.c_str()};
+  TOPPBaseBatchTest tool;
+  TEST_EQUAL(tool.run(3, batch_cl), TOPPBase::UNKNOWN_ERROR) // exit code of the first failing job
+  TEST_EQUAL(ListUtils::concatenate(tool.jobs, "|"), "first|with space|failing|last")
+
+  const char* missing_cl[3] = {"TOPPBaseBatchTest", "-batch", "this_file_does_not_exist.txt"};
+  TOPPBaseBatchTest tool2;
+  TEST_EQUAL(tool2.run(3, missing_cl), TOPPBase::INPUT_FILE_NOT_READABLE)
+  TEST_EQUAL(tool2.jobs.size(), 0)
+}
+END_SECTION
+
 /////////////////////////////////////////////////////////////
 /////////////////////////////////////////////////////////////
 END_TEST
@@ -0,0 +1,168 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2018.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: Timo Sachsenberg $
+// $Authors: Timo Sachsenberg $
+// --------------------------------------------------------------------------
+
+#include <OpenMS/CONCEPT/ClassTest.h>
+#include <OpenMS/test_config.h>
+
+///////////////////////////
+#include <OpenMS/APPLICATIONS/TOPPPipeline.h>
+///////////////////////////
+
+#include <OpenMS/FORMAT/InMemoryFileStore.h>
+#include <OpenMS/FORMAT/MzMLFile.h>
+
+using namespace OpenMS;
+using namespace std;
+
+// scales all intensities of '-in' by '-factor' and writes them to '-out'
+class TOPPPipelineTestScaler
+  : public TOPPBase
+{
+public:
+  TOPPPipelineTestScaler()
+    : TOPPBase("TOPPPipelineTestScaler", "A test class", false)
+  {
+  }
+
+  void registerOptionsAndFlags_() override
+  {
+    registerInputFile_("in", "<file>", "", "input file");
+    registerOutputFile_("out", "<file>", "", "output file");
+    registerDoubleOption_("factor", "<value>", 2.0, "scaling factor", false);
+  }
+
+  ExitCodes main_(int /*argc*/ , const char** /*argv*/) override
+  {
+    PeakMap exp;
+    MzMLFile().load(getStringOption_("in"), exp);
+    for (MSSpectrum& spec : exp)
+    {
+      for (Peak1D& p : spec)
+      {
+        p.setIntensity(p.getIntensity() * getDoubleOption_("factor"));
+      }
+    }
+    MzMLFile().store(getStringOption_("out"), exp);
+    return EXECUTION_OK;
+  }
+};
+
+START_TEST(TOPPPipeline, "$Id$")
+
+/////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////
+
+TOPPPipeline* ptr = nullptr;
+TOPPPipeline* null_ptr = nullptr;
+START_SECTION(TOPPPipeline())
+{
+  ptr = new TOPPPipeline();
+  TEST_NOT_EQUAL(ptr, null_ptr)
+}
+END_SECTION
+
+START_SECTION(~TOPPPipeline())
+{
+  delete ptr;
+}
+END_SECTION
+
+PeakMap exp;
+MSSpectrum spec;
+spec.push_back(Peak1D(100.0, 10.0f));
+exp.addSpectrum(spec);
+InMemoryFileStore::store("mem:raw.mzML", exp);
+
+START_SECTION(void addStage(TOPPBase* tool, const StringList& arguments))
+{
+  TOPPPipeline pipeline;
+  pipeline.addStage(new TOPPPipelineTestScaler(), ListUtils::create<String>("-in,mem:raw.mzML,-out,mem:x2.mzML"));
+  TEST_EQUAL(pipeline.size(), 1)
+  TEST_EXCEPTION(Exception::MissingInformation, pipeline.addStage(nullptr, StringList()))
+}
+END_SECTION
+
+START_SECTION(Size size() const)
+{
+  TOPPPipeline pipeline;
+  TEST_EQUAL(pipeline.size(), 0)
+}
+END_SECTION
+
+START_SECTION(void keep(const String& name))
+{
+  NOT_TESTABLE // tested below
+}
+END_SECTION
+
+START_SECTION(TOPPBase::ExitCodes run())
+{
+  TOPPPipeline pipeline;
+  pipeline.addStage(new TOPPPipelineTestScaler(), ListUtils::create<String>("-in,mem:raw.mzML,-out,mem:x2.mzML"));
+  pipeline.addStage(new TOPPPipelineTestScaler(), ListUtils::create<String>("-in,mem:x2.mzML,-out,mem:x6.mzML,-factor,3"));
+  pipeline.keep("mem:raw.mzML");
+  pipeline.keep("mem:x6.mzML");
+  TEST_EQUAL(pipeline.run(), TOPPBase::EXECUTION_OK)
+  TEST_EQUAL(pipeline.getFailedStage(), 2)
+
+  // intermediate result was released, kept ones are available
+  TEST_EQUAL(InMemoryFileStore::exists("mem:x2.mzML"), false)
+  TEST_EQUAL(InMemoryFileStore::exists("mem:raw.mzML"), true)
+  PeakMap result;
+  InMemoryFileStore::load("mem:x6.mzML", result);
+  TEST_EQUAL(result.size(), 1)
+  TEST_REAL_SIMILAR(result[0][0].getIntensity(), 60.0)
+  InMemoryFileStore::remove("mem:x6.mzML");
+
+  // a missing input stops the pipeline
+  TOPPPipeline failing;
+  failing.addStage(new TOPPPipelineTestScaler(), ListUtils::create<String>("-in,mem:missing.mzML,-out,mem:y.mzML"));
+  failing.addStage(new TOPPPipelineTestScaler(), ListUtils::create<String>("-in,mem:y.mzML,-out,mem:z.mzML"));
+  TEST_EQUAL(failing.run(), TOPPBase::INPUT_FILE_NOT_FOUND)
+  TEST_EQUAL(failing.getFailedStage(), 0)
+  TEST_EQUAL(InMemoryFileStore::exists("mem:z.mzML"), false)
+}
+END_SECTION
+
+START_SECTION(Size getFailedStage() const)
+{
+  NOT_TESTABLE // tested above
+}
+END_SECTION
+
+InMemoryFileStore::clear();
+
+/////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////
+END_TEST
@@ -38,7 +38,10 @@
 ///////////////////////////
 
 #include <OpenMS/FORMAT/TextFile.h>
+#include <algorithm>
+#include <fstream>
 #include <iostream>
+#include <zlib.h>
 #include <vector>
 
 using namespace OpenMS;
@@ -157,6 +160,48 @@ START_SECTION((void load(const String& filename, bool trim_lines = false, Int fi
   TEST_EQUAL(String(*file_it).trim() == "space_line", true)
   ++file_it;
   TEST_EQUAL(String(*file_it).trim() == "tab_line", true)
+
+  // all kinds of line endings are handled the same when reading the whole file and when reading only the first lines
+  {
+    String mixed_file;
+    NEW_TMP_FILE(mixed_file)
+    {
+      std::ofstream os(mixed_file.c_str(), std::ios::binary);
+      os << "unix\nwindows\r\nmac\r\n\r\r\nend\r";
+    }
+    TextFile whole(mixed_file);
+    TextFile first(mixed_file, false, 100);
+    TEST_EQUAL(whole.end() - whole.begin(), 6)
+    TEST_EQUAL(first.end() - first.begin(), 6)
+    TEST_EQUAL(std::equal(whole.begin(), whole.end(), first.begin()), true)
+    TEST_EQUAL(*(whole.begin() + 1), "windows")
+    TEST_EQUAL(*(whole.begin() + 3), "")
+    TEST_EQUAL(*(whole.begin() + 5), "end")
+    whole.load(mixed_file, false, -1, true);
+    TEST_EQUAL(whole.end() - whole.begin(), 4)
+  }
+
+  // gzip compressed input is decompressed transparently
+  {
+    String gz_file;
+    NEW_TMP_FILE(gz_file)
+    std::string content = "first_line\r\nsecond_line\n\nlast_line";
+    gzFile gz = gzopen(gz_file.c_str(), "wb");
+    gzwrite(gz, content.data(), (unsigned)content.size());
+    gzclose(gz);
+
+    TextFile gz_text(gz_file);
+    TEST_EQUAL(gz_text.end() - gz_text.begin(), 4)
+    TEST_EQUAL(*gz_text.begin(), "first_line")
+    TEST_EQUAL(*(gz_text.begin() + 1), "second_line")
+    TEST_EQUAL(*(gz_text.begin() + 2), "")
+    TEST_EQUAL(*(gz_text.begin() + 3), "last_line")
+
+    gz_text.load(gz_file, false, 2);
+    TEST_EQUAL(gz_text.end() - gz_text.begin(), 2)
+    gz_text.load(gz_file, false, -1, true);
+    TEST_EQUAL(gz_text.end() - gz_text.begin(), 3)
+  }
 END_SECTION
 
 START_SECTION((void store(const String& filename) ))
@@ -0,0 +1,182 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2018.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: Timo Sachsenberg $
+// $Authors: Timo Sachsenberg $
+// --------------------------------------------------------------------------
+
+#include <OpenMS/CONCEPT/ClassTest.h>
+#include <OpenMS/test_config.h>
+
+///////////////////////////
+#include <OpenMS/ANALYSIS/RNPXL/TheoreticalSpectrumBatch.h>
+///////////////////////////
+
+#include <OpenMS/KERNEL/MSSpectrum.h>
+#include <OpenMS/CHEMISTRY/TheoreticalSpectrumGenerator.h>
+
+using namespace OpenMS;
+using namespace std;
+
+START_TEST(TheoreticalSpectrumBatch, "$Id$")
+
+/////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////
+
+TheoreticalSpectrumBatch* ptr = nullptr;
+TheoreticalSpectrumBatch* null_ptr = nullptr;
+
+TheoreticalSpectrumGenerator tsg;
+Param param = tsg.getParameters();
+param.setValue("add_metainfo", "true");
+tsg.setParameters(param);
+
+START_SECTION(TheoreticalSpectrumBatch())
+{
+  ptr = new TheoreticalSpectrumBatch();
+  TEST_NOT_EQUAL(ptr, null_ptr)
+  TEST_EQUAL(ptr->size(), 0)
+  TEST_EQUAL(ptr->empty(), true)
+  TEST_EQUAL(ptr->getNumberOfPeaks(), 0)
+  TEST_EQUAL(ptr->getOffsets().size(), 1)
+}
+END_SECTION
+
+START_SECTION(~TheoreticalSpectrumBatch())
+{
+  delete ptr;
+}
+END_SECTION
+
+TheoreticalSpectrumBatch batch;
+PeakSpectrum spec1, spec2;
+tsg.getSpectrum(spec1, AASequence::fromString("PEPTIDE"), 1, 1);
+spec2.push_back(Peak1D(100.0, 2.0));
+spec2.push_back(Peak1D(200.0, 3.0));
+
+START_SECTION((Size add(const PeakSpectrum &theo_spectrum)))
+{
+  TEST_EQUAL(batch.add(spec1), 0)
+  TEST_EQUAL(batch.add(PeakSpectrum()), 1)
+  TEST_EQUAL(batch.add(spec2), 2)
+  TEST_EQUAL(batch.size(), 3)
+  TEST_EQUAL(batch.empty(), false)
+  TEST_EQUAL(batch.getNumberOfPeaks(), spec1.size() + 2)
+}
+END_SECTION
+
+START_SECTION((Size add(const std::vector<TheoreticalSpectrumGenerator::FragmentIon>& fragment_ions)))
+{
+  TheoreticalSpectrumGenerator::FragmentIonBuffer buffer;
+  tsg.getFragmentIons(buffer, AASequence::fromString("PEPTIDE"), 1, 1);
+
+  TheoreticalSpectrumBatch ion_batch;
+  TEST_EQUAL(ion_batch.add(buffer.ions), 0)
+  TEST_EQUAL(ion_batch.getNumberOfPeaks(), spec1.size())
+  TEST_EQUAL(ion_batch.isAnnotated(0), true)
+  for (Size i = 0; i < spec1.size(); ++i)
+  {
+    TEST_REAL_SIMILAR(ion_batch.getMZArray()[i], spec1[i].getMZ())
+    TEST_EQUAL(ion_batch.getIonTypeArray()[i], batch.getIonTypeArray()[i])
+  }
+}
+END_SECTION
+
+START_SECTION((const std::vector<Size>& getOffsets() const))
+{
+  TEST_EQUAL(batch.getOffsets().size(), 4)
+  TEST_EQUAL(batch.getOffsets()[0], 0)
+  TEST_EQUAL(batch.getOffsets()[1], spec1.size())
+  TEST_EQUAL(batch.getOffsets()[2], spec1.size())
+  TEST_EQUAL(batch.getOffsets()[3], spec1.size() + 2)
+}
+END_SECTION
+
+START_SECTION((const std::vector<double>& getMZArray() const))
+{
+  TEST_REAL_SIMILAR(batch.getMZArray()[0], spec1[0].getMZ())
+  TEST_REAL_SIMILAR(batch.getMZArray()[spec1.size()], 100.0)
+  TEST_REAL_SIMILAR(batch.getMZArray()[spec1.size() + 1], 200.0)
+}
+END_SECTION
+
+START_SECTION((const std::vector<float>& getIntensityArray() const))
+{
+  TEST_REAL_SIMILAR(batch.getIntensityArray()[0], spec1[0].getIntensity())
+  TEST_REAL_SIMILAR(batch.getIntensityArray()[spec1.size() + 1], 3.0)
+}
+END_SECTION
+
+START_SECTION((const std::vector<char>& getIonTypeArray() const))
+{
+  const PeakSpectrum::StringDataArray& names = spec1.getStringDataArrays()[0];
+  for (Size i = 0; i < spec1.size(); ++i)
+  {
+    TEST_EQUAL(batch.getIonTypeArray()[i], names[i][0])
+  }
+  TEST_EQUAL(batch.getIonTypeArray()[spec1.size()], 0)
+}
+END_SECTION
+
+START_SECTION((bool isAnnotated(Size index) const))
+{
+  TEST_EQUAL(batch.isAnnotated(0), true)
+  TEST_EQUAL(batch.isAnnotated(1), false)
+  TEST_EQUAL(batch.isAnnotated(2), false)
+}
+END_SECTION
+
+START_SECTION((template <typename Predicate> static Size partitionPoint(const double* first, Size n, Predicate pred)))
+{
+  vector<double> values = {1.0, 2.0, 2.0, 3.0, 5.0, 8.0, 13.0};
+  for (double x : {0.0, 1.0, 1.5, 2.0, 2.5, 7.9, 8.0, 13.0, 20.0})
+  {
+    Size expected = lower_bound(values.begin(), values.end(), x) - values.begin();
+    TEST_EQUAL(TheoreticalSpectrumBatch::partitionPoint(values.data(), values.size(), [x](double v) { return v < x; }), expected)
+  }
+  TEST_EQUAL(TheoreticalSpectrumBatch::partitionPoint(values.data(), 1, [](double v) { return v < 5.0; }), 1)
+  TEST_EQUAL(TheoreticalSpectrumBatch::partitionPoint(values.data(), 1, [](double v) { return v < 0.5; }), 0)
+}
+END_SECTION
+
+START_SECTION((void clear()))
+{
+  batch.clear();
+  TEST_EQUAL(batch.size(), 0)
+  TEST_EQUAL(batch.getNumberOfPeaks(), 0)
+  TEST_EQUAL(batch.getOffsets().size(), 1)
+  TEST_EQUAL(batch.add(spec2), 0)
+  TEST_EQUAL(batch.getOffsets()[1], 2)
+}
+END_SECTION
+
+/////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////
+END_TEST
@@ -356,6 +356,75 @@ START_SECTION(void getSpectrum(PeakSpectrum& spec, const AASequence& peptide, In
 
 END_SECTION
 
+START_SECTION((void getFragmentIons(FragmentIonBuffer &buffer, const AASequence &peptide, Int min_charge, Int max_charge) const))
+{
+  TheoreticalSpectrumGenerator t_gen;
+  Param params = t_gen.getParameters();
+  params.setValue("add_metainfo", "true");
+
+  TheoreticalSpectrumGenerator::FragmentIonBuffer buffer;
+
+  // same ions as getSpectrum() for all ion types, charges and terminal modifications
+  vector<AASequence> peptides;
+  peptides.push_back(AASequence::fromString("IFSQVGK"));
+  peptides.push_back(AASequence::fromString("PEPTIDER"));
+  peptides.push_back(AASequence::fromString(".(Acetyl)PEPTM(Oxidation)IDEK"));
+  peptides.push_back(AASequence::fromString("GG"));
+  peptides.push_back(AASequence::fromString("K"));
+  for (const String& ion_types : ListUtils::create<String>("by,acxz,abcxyz"))
+  {
+    for (const String& type : ListUtils::create<String>("a,b,c,x,y,z"))
+    {
+      params.setValue("add_" + type + "_ions", ion_types.hasSubstring(type) ? "true" : "false");
+    }
+    for (const String& first_prefix_ion : ListUtils::create<String>("true,false"))
+    {
+      params.setValue("add_first_prefix_ion", first_prefix_ion);
+      t_gen.setParameters(params);
+      for (const AASequence& pep : peptides)
+      {
+        if (pep.size() < 2 && ion_types.hasSubstring("c"))
+        {
+          TEST_EXCEPTION(Exception::InvalidSize, t_gen.getFragmentIons(buffer, pep, 1, 1))
+          continue;
+        }
+        for (Int max_charge = 1; max_charge <= 3; ++max_charge)
+        {
+          PeakSpectrum spec;
+          t_gen.getSpectrum(spec, pep, 1, max_charge);
+          t_gen.getFragmentIons(buffer, pep, 1, max_charge);
+          TEST_EQUAL(buffer.ions.size(), spec.size())
+          ABORT_IF(buffer.ions.size() != spec.size())
+          for (Size i = 0; i < spec.size(); ++i)
+          {
+            TEST_REAL_SIMILAR(buffer.ions[i].mz, spec[i].getMZ())
+            TEST_REAL_SIMILAR(buffer.ions[i].intensity, spec[i].getIntensity())
+            TEST_EQUAL(buffer.ions[i].charge, spec.getIntegerDataArrays()[0][i])
+            TEST_EQUAL(String(buffer.ions[i].ion_type) + String(buffer.ions[i].ion_number) + String(buffer.ions[i].charge, '+'), spec.getStringDataArrays()[0][i])
+          }
+        }
+      }
+    }
+  }
+
+  // sorted output
+  params.setValue("add_a_ions", "true");
+  params.setValue("add_y_ions", "true");
+  t_gen.setParameters(params);
+  t_gen.getFragmentIons(buffer, AASequence::fromString("PEPTIDEKPEPTIDER"), 1, 4);
+  for (Size i = 1; i < buffer.ions.size(); ++i)
+  {
+    TEST_EQUAL(buffer.ions[i - 1].mz <= buffer.ions[i].mz, true)
+  }
+
+  // empty peptide and empty charge range
+  t_gen.getFragmentIons(buffer, AASequence(), 1, 2);
+  TEST_EQUAL(buffer.ions.size(), 0)
+  t_gen.getFragmentIons(buffer, peptide, 2, 1);
+  TEST_EQUAL(buffer.ions.size(), 0)
+}
+END_SECTION
+
 START_SECTION(([EXTRA] bugfix test where losses lead to formulae with negative element frequencies))
 {
   AASequence tmp_aa = AASequence::fromString("RDAGGPALKK");
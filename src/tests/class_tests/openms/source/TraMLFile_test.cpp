@@ -138,6 +138,68 @@ START_SECTION((void store(const String &filename, const TargetedExperiment &id)
 }
 END_SECTION
 
+START_SECTION((void load(const String &filename, TargetedExperiment &exp, const TransitionConsumer &consumer)))
+{
+  TraMLFile file;
+  TargetedExperiment exp_original;
+  file.load(OPENMS_GET_TEST_DATA_PATH("ToyExample1.traML"), exp_original);
+
+  TargetedExperiment exp;
+  std::vector<ReactionMonitoringTransition> transitions;
+  Size nr_peptides_seen = 0;
+  file.load(OPENMS_GET_TEST_DATA_PATH("ToyExample1.traML"), exp, [&](const ReactionMonitoringTransition& tr)
+    {
+      transitions.push_back(tr);
+      nr_peptides_seen = exp.getPeptides().size();
+    });
+
+  // transitions are not stored, everything else is
+  TEST_EQUAL(exp.getTransitions().size(), 0)
+  TEST_EQUAL(transitions.size(), exp_original.getTransitions().size())
+  TEST_EQUAL(transitions == exp_original.getTransitions(), true)
+  TEST_EQUAL(exp.getPeptides() == exp_original.getPeptides(), true)
+  TEST_EQUAL(exp.getProteins() == exp_original.getProteins(), true)
+  // the peptides are available before the transitions are reported
+  TEST_EQUAL(nr_peptides_seen, exp_original.getPeptides().size())
+
+  exp.setTransitions(transitions);
+  TEST_EQUAL(exp == exp_original, true)
+}
+END_SECTION
+
+START_SECTION((void store(const String &filename, const TargetedExperiment &exp, const TransitionSupplier &supplier) const))
+{
+  TraMLFile file;
+  TargetedExperiment exp_original;
+  file.load(OPENMS_GET_TEST_DATA_PATH("ToyExample1.traML"), exp_original);
+
+  TargetedExperiment exp_no_transitions = exp_original;
+  exp_no_transitions.setTransitions(std::vector<ReactionMonitoringTransition>());
+
+  Size idx = 0;
+  std::string tmp_filename;
+  NEW_TMP_FILE(tmp_filename);
+  file.store(tmp_filename, exp_no_transitions, [&](ReactionMonitoringTransition& tr)
+    {
+      if (idx >= exp_original.getTransitions().size()) return false;
+      tr = exp_original.getTransitions()[idx++];
+      return true;
+    });
+
+  TargetedExperiment exp;
+  file.load(tmp_filename, exp);
+  TEST_EQUAL(exp == exp_original, true)
+
+  // no transitions supplied
+  NEW_TMP_FILE(tmp_filename);
+  file.store(tmp_filename, exp_no_transitions, [](ReactionMonitoringTransition&) { return false; });
+  TargetedExperiment exp_empty;
+  file.load(tmp_filename, exp_empty);
+  TEST_EQUAL(exp_empty.getTransitions().size(), 0)
+  TEST_EQUAL(exp_empty.getPeptides() == exp_original.getPeptides(), true)
+}
+END_SECTION
+
 START_SECTION((void equal()))
 {
   TraMLFile file;
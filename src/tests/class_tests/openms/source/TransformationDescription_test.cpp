@@ -143,6 +143,50 @@ START_SECTION((double apply(double value) const))
 }
 END_SECTION
 
+START_SECTION((void apply(const std::vector<double>& values, std::vector<double>& results) const))
+{
+  // sorted, reverse sorted and unsorted values, including extrapolation
+  vector<double> values;
+  for (Size i = 0; i <= 10000; ++i) values.push_back(-0.5 + i * 0.0002);
+  for (Size i = 0; i <= 5000; ++i) values.push_back(1.5 - i * 0.0004);
+  for (Size i = 0; i < 5000; ++i) values.push_back(-0.5 + ((i * 7919) % 5000) * 0.0004);
+  values.push_back(0.0);
+  values.push_back(1.0);
+
+  StringList models = ListUtils::create<String>("none,linear,interpolated,interpolated,interpolated,b_spline,lowess");
+  StringList interpolation_types = ListUtils::create<String>("cspline,cspline,linear,cspline,akima,cspline,linear");
+  for (Size m = 0; m < models.size(); ++m)
+  {
+    TransformationDescription td(data_nonlinear);
+    Param params;
+    if (models[m] == "interpolated" || models[m] == "lowess")
+    {
+      params.setValue("interpolation_type", interpolation_types[m]);
+    }
+    td.fitModel(models[m], params);
+
+    vector<double> results;
+    td.apply(values, results);
+    TEST_EQUAL(results.size(), values.size());
+    Size mismatches = 0;
+    for (Size i = 0; i < values.size(); ++i)
+    {
+      if (results[i] != td.apply(values[i])) ++mismatches;
+    }
+    TEST_EQUAL(mismatches, 0);
+
+    // in-place transformation
+    vector<double> in_place = values;
+    td.apply(in_place, in_place);
+    TEST_EQUAL(in_place == results, true);
+  }
+
+  vector<double> empty, results(3);
+  TransformationDescription().apply(empty, results);
+  TEST_EQUAL(results.empty(), true);
+}
+END_SECTION
+
 START_SECTION((const String& getModelType() const))
 {
 	TransformationDescription td;
@@ -39,6 +39,8 @@
 #include <boost/assign/std/vector.hpp>
 #include <boost/assign/list_of.hpp>
 
+#include <fstream>
+
 ///////////////////////////
 #include <OpenMS/ANALYSIS/OPENSWATH/TransitionPQPFile.h>
 ///////////////////////////
@@ -81,6 +83,54 @@ START_SECTION( void convertPQPToTargetedExperiment(const char * filename, OpenMS
 }
 END_SECTION
 
+START_SECTION( void convertPQPToTargetedExperiment(const char * filename, OpenSwath::LightTargetedExperiment & targeted_exp, bool legacy_traml_id, const std::vector<std::pair<double, double> > & precursor_ranges))
+{
+  // write a small transition list and convert it to PQP
+  String tsv_file, pqp_file;
+  NEW_TMP_FILE(tsv_file)
+  NEW_TMP_FILE(pqp_file)
+  {
+    std::ofstream os(tsv_file.c_str());
+    os << "PrecursorMz\tProductMz\tPrecursorCharge\tProductCharge\tLibraryIntensity\tNormalizedRetentionTime\tPeptideSequence\tModifiedPeptideSequence\tProteinId\tTransitionGroupId\tTransitionId\tDecoy\n";
+    os << "500.0\t600.0\t2\t1\t100\t10\tPEPTIDEK\tPEPTIDEK\tProt1\tgroup_1\ttr_1\t0\n";
+    os << "500.0\t700.0\t2\t1\t50\t10\tPEPTIDEK\tPEPTIDEK\tProt1\tgroup_1\ttr_2\t0\n";
+    os << "700.0\t800.0\t2\t1\t100\t20\tELVISK\tELVISK\tProt1\tgroup_2\ttr_3\t0\n";
+    os << "700.0\t900.0\t2\t1\t50\t20\tELVISK\tELVISK\tProt1\tgroup_2\ttr_4\t0\n";
+  }
+  TransitionPQPFile pqp;
+  TargetedExperiment exp;
+  pqp.convertTSVToTargetedExperiment(tsv_file.c_str(), FileTypes::TSV, exp);
+  pqp.convertTargetedExperimentToPQP(pqp_file.c_str(), exp);
+
+  OpenSwath::LightTargetedExperiment all;
+  pqp.convertPQPToTargetedExperiment(pqp_file.c_str(), all, true);
+  TEST_EQUAL(all.transitions.size(), 4)
+  TEST_EQUAL(all.compounds.size(), 2)
+  TEST_EQUAL(all.proteins.size(), 1)
+
+  // only load the transitions of the second precursor
+  OpenSwath::LightTargetedExperiment window;
+  std::vector<std::pair<double, double> > ranges(1, std::make_pair(600.0, 800.0));
+  pqp.convertPQPToTargetedExperiment(pqp_file.c_str(), window, true, ranges);
+  TEST_EQUAL(window.transitions.size(), 2)
+  TEST_EQUAL(window.compounds.size(), 1)
+  TEST_EQUAL(window.proteins.size(), 1)
+  for (Size i = 0; i < window.transitions.size(); ++i)
+  {
+    TEST_REAL_SIMILAR(window.transitions[i].precursor_mz, 700.0)
+    TEST_EQUAL(window.transitions[i].peptide_ref, "group_2")
+  }
+  TEST_EQUAL(window.compounds[0].id, "group_2")
+
+  // no precursor in range
+  OpenSwath::LightTargetedExperiment none;
+  ranges[0] = std::make_pair(100.0, 200.0);
+  pqp.convertPQPToTargetedExperiment(pqp_file.c_str(), none, true, ranges);
+  TEST_EQUAL(none.transitions.size(), 0)
+  TEST_EQUAL(none.compounds.size(), 0)
+}
+END_SECTION
+
 START_SECTION( void validateTargetedExperiment(OpenMS::TargetedExperiment & targeted_exp))
 {
   NOT_TESTABLE
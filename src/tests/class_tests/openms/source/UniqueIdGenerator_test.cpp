@@ -145,6 +145,37 @@ START_SECTION((static void setSeed(UInt seed)))
 }
 END_SECTION
 
+START_SECTION(([EXTRA] getUniqueId() in parallel))
+{
+  // per-thread streams: no collisions and reproducible with a static schedule
+  std::vector<OpenMS::UInt64> ids(nofIdsToGenerate), ids2(nofIdsToGenerate);
+  OpenMS::UniqueIdGenerator::setSeed(546666321);
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static)
+#endif
+  for (SignedSize i = 0; i < (SignedSize)nofIdsToGenerate; ++i)
+  {
+    ids[i] = OpenMS::UniqueIdGenerator::getUniqueId();
+  }
+  OpenMS::UniqueIdGenerator::setSeed(546666321);
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static)
+#endif
+  for (SignedSize i = 0; i < (SignedSize)nofIdsToGenerate; ++i)
+  {
+    ids2[i] = OpenMS::UniqueIdGenerator::getUniqueId();
+  }
+  TEST_EQUAL(ids == ids2, true)
+
+  std::sort(ids.begin(), ids.end());
+  TEST_EQUAL(std::adjacent_find(ids.begin(), ids.end()) == ids.end(), true)
+
+  // the sequential sequence is not affected by parallel use
+  OpenMS::UniqueIdGenerator::setSeed(546666321);
+  TEST_EQUAL(OpenMS::UniqueIdGenerator::getUniqueId(), 4039984684862977299U)
+}
+END_SECTION
+
 /////////////////////////////////////////////////////////////
 /////////////////////////////////////////////////////////////
 END_TEST
@@ -0,0 +1,177 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2018.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: Timo Sachsenberg $
+// $Authors: Timo Sachsenberg $
+// --------------------------------------------------------------------------
+
+#include <OpenMS/CONCEPT/ClassTest.h>
+
+///////////////////////////
+
+#include <OpenMS/VISUAL/PeakMapIntensityPyramid.h>
+
+#include <fstream>
+///////////////////////////
+
+using namespace OpenMS;
+using namespace std;
+
+START_TEST(PeakMapIntensityPyramid, "$Id$")
+
+/////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////
+
+// four MS1 spectra and one MS2 spectrum (which is ignored)
+PeakMap exp;
+double rts[5] = {10.0, 20.0, 25.0, 30.0, 40.0};
+for (Size i = 0; i < 5; ++i)
+{
+  MSSpectrum spec;
+  spec.setRT(rts[i]);
+  spec.setMSLevel(i == 2 ? 2 : 1);
+  exp.addSpectrum(spec);
+}
+exp[0].push_back(Peak1D(100.0, 5.0f));
+exp[0].push_back(Peak1D(550.0, 7.0f));
+exp[1].push_back(Peak1D(1000.0, 3.0f));
+exp[2].push_back(Peak1D(500.0, 1000.0f));
+exp[3].push_back(Peak1D(300.0, 11.0f));
+exp[4].push_back(Peak1D(900.0, 2.0f));
+
+PeakMapIntensityPyramid* ptr = nullptr;
+PeakMapIntensityPyramid* null_ptr = nullptr;
+START_SECTION((PeakMapIntensityPyramid()))
+{
+  ptr = new PeakMapIntensityPyramid();
+  TEST_NOT_EQUAL(ptr, null_ptr)
+  TEST_EQUAL(ptr->empty(), true)
+  TEST_EQUAL(ptr->getLevelCount(), 0)
+  Size level = 0;
+  TEST_EQUAL(ptr->findLevel(1000.0, 1000.0, level), false)
+  TEST_EQUAL(ptr->getMaxIntensity(0, 0.0, 100.0, 0.0, 2000.0), -1.0f)
+  delete ptr;
+}
+END_SECTION
+
+START_SECTION((void build(const PeakMap& map, Size rt_bins = 2048, Size mz_bins = 8192)))
+{
+  PeakMapIntensityPyramid pyramid;
+  pyramid.build(exp, 4, 8);
+  TEST_EQUAL(pyramid.empty(), false)
+  TEST_EQUAL(pyramid.getLevelCount(), 4)
+  TEST_EQUAL(pyramid.getRTBins(0), 4)
+  TEST_EQUAL(pyramid.getMZBins(0), 8)
+  TEST_EQUAL(pyramid.getRTBins(1), 2)
+  TEST_EQUAL(pyramid.getMZBins(1), 4)
+  TEST_EQUAL(pyramid.getRTBins(3), 1)
+  TEST_EQUAL(pyramid.getMZBins(3), 1)
+
+  // the number of RT tiles is limited by the number of MS1 spectra
+  pyramid.build(exp);
+  TEST_EQUAL(pyramid.getRTBins(0), 4)
+  TEST_EQUAL(pyramid.getMZBins(0), 8192)
+
+  // no MS1 data
+  pyramid.build(PeakMap());
+  TEST_EQUAL(pyramid.empty(), true)
+}
+END_SECTION
+
+START_SECTION((bool findLevel(double rt_size, double mz_size, Size& level) const))
+{
+  PeakMapIntensityPyramid pyramid;
+  pyramid.build(exp, 4, 8);
+  Size level = 10;
+  TEST_EQUAL(pyramid.findLevel(100.0, 10000.0, level), true)
+  TEST_EQUAL(level, 3)
+  // level 0 tiles are 7.5 x 112.5
+  TEST_EQUAL(pyramid.findLevel(8.0, 113.0, level), true)
+  TEST_EQUAL(level, 0)
+  TEST_EQUAL(pyramid.findLevel(1.0, 1.0, level), false)
+}
+END_SECTION
+
+START_SECTION((float getMaxIntensity(Size level, double rt_start, double rt_end, double mz_start, double mz_end) const))
+{
+  PeakMapIntensityPyramid pyramid;
+  pyramid.build(exp, 4, 8);
+  for (Size level = 0; level < pyramid.getLevelCount(); ++level)
+  {
+    // MS2 peaks are not contained
+    TEST_EQUAL(pyramid.getMaxIntensity(level, 0.0, 100.0, 0.0, 2000.0), 11.0f)
+  }
+  TEST_EQUAL(pyramid.getMaxIntensity(0, 9.0, 11.0, 50.0, 200.0), 5.0f)
+  TEST_EQUAL(pyramid.getMaxIntensity(0, 9.0, 11.0, 500.0, 600.0), 7.0f)
+  TEST_EQUAL(pyramid.getMaxIntensity(0, 9.0, 11.0, 700.0, 800.0), -1.0f)
+  TEST_EQUAL(pyramid.getMaxIntensity(0, 35.0, 45.0, 0.0, 2000.0), 2.0f)
+  // outside of the data range
+  TEST_EQUAL(pyramid.getMaxIntensity(0, 100.0, 200.0, 0.0, 2000.0), -1.0f)
+  TEST_EQUAL(pyramid.getMaxIntensity(0, 0.0, 100.0, 2000.0, 3000.0), -1.0f)
+  // invalid level
+  TEST_EQUAL(pyramid.getMaxIntensity(4, 0.0, 100.0, 0.0, 2000.0), -1.0f)
+}
+END_SECTION
+
+START_SECTION((void store(const String& filename) const))
+{
+  NOT_TESTABLE // tested below
+}
+END_SECTION
+
+START_SECTION((void load(const String& filename)))
+{
+  PeakMapIntensityPyramid pyramid, loaded;
+  pyramid.build(exp, 4, 8);
+  String filename;
+  NEW_TMP_FILE(filename)
+  pyramid.store(filename);
+  loaded.load(filename);
+  TEST_EQUAL(loaded.getLevelCount(), pyramid.getLevelCount())
+  TEST_EQUAL(loaded.getRTBins(0), 4)
+  TEST_EQUAL(loaded.getMZBins(0), 8)
+  TEST_EQUAL(loaded.getMaxIntensity(0, 9.0, 11.0, 50.0, 200.0), 5.0f)
+  TEST_EQUAL(loaded.getMaxIntensity(2, 0.0, 100.0, 0.0, 2000.0), 11.0f)
+
+  TEST_EXCEPTION(Exception::FileNotFound, loaded.load("this_file_does_not_exist.lod"))
+
+  String garbage;
+  NEW_TMP_FILE(garbage)
+  {
+    ofstream os(garbage.c_str());
+    os << "no pyramid";
+  }
+  TEST_EXCEPTION(Exception::ParseError, loaded.load(garbage))
+}
+END_SECTION
+
+/////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////
+END_TEST
@@ -252,6 +252,45 @@ BOOST_AUTO_TEST_CASE(test_MRMFeatureScoring_normalizedCrossCorrelation)
 }
 END_SECTION
 
+BOOST_AUTO_TEST_CASE(test_normalizedCrossCorrelationMatrix)
+//START_SECTION((int normalizedCrossCorrelationMatrix(std::vector<std::vector<double> >& data1, std::vector<std::vector<double> >& data2, int maxdelay, bool upper_triangle, std::vector<double>& result)))
+{
+  static const double arr1[] = {0,1,3,5,2,0};
+  static const double arr2[] = {1,3,5,2,0,0};
+  std::vector<std::vector<double> > data;
+  data.push_back(std::vector<double>(arr1, arr1 + sizeof(arr1) / sizeof(arr1[0])));
+  data.push_back(std::vector<double>(arr2, arr2 + sizeof(arr2) / sizeof(arr2[0])));
+
+  // restricted delay window, same values as normalizedCrossCorrelation
+  std::vector<double> result;
+  int maxdelay = Scoring::normalizedCrossCorrelationMatrix(data, data, 2, true, result);
+  TEST_EQUAL (maxdelay, 2)
+  TEST_EQUAL (result.size(), 2 * 2 * 5)
+  const double* xcorr_0_1 = &result[(0 * 2 + 1) * 5];
+  TEST_REAL_SIMILAR (xcorr_0_1[4], -0.7374631);  // delay  2
+  TEST_REAL_SIMILAR (xcorr_0_1[3], -0.567846);   // delay  1
+  TEST_REAL_SIMILAR (xcorr_0_1[2],  0.4159292);  // delay  0
+  TEST_REAL_SIMILAR (xcorr_0_1[1],  0.8215339);  // delay -1
+  TEST_REAL_SIMILAR (xcorr_0_1[0],  0.15634218); // delay -2
+  TEST_REAL_SIMILAR (result[(0 * 2 + 0) * 5 + 2], 1.0); // auto-correlation at delay 0
+  TEST_REAL_SIMILAR (result[(1 * 2 + 1) * 5 + 2], 1.0);
+  TEST_REAL_SIMILAR (result[(1 * 2 + 0) * 5 + 2], 0.0); // lower triangle is not computed
+
+  // full delay range, compared to normalizedCrossCorrelation
+  std::vector<std::vector<double> > data1(1, std::vector<double>(arr1, arr1 + 6));
+  std::vector<std::vector<double> > data2(1, std::vector<double>(arr2, arr2 + 6));
+  maxdelay = Scoring::normalizedCrossCorrelationMatrix(data1, data2, -1, false, result);
+  TEST_EQUAL (maxdelay, 6)
+  TEST_EQUAL (result.size(), 13)
+  std::vector<double> single1(arr1, arr1 + 6), single2(arr2, arr2 + 6);
+  OpenSwath::Scoring::XCorrArrayType expected = Scoring::normalizedCrossCorrelation(single1, single2, 6, 1);
+  for (std::size_t k = 0; k < expected.data.size(); ++k)
+  {
+    TEST_REAL_SIMILAR (result[k], expected.data[k].second)
+  }
+}
+END_SECTION
+
 BOOST_AUTO_TEST_CASE(test_MRMFeatureScoring_calcxcorr_legacy_mquest_)
 //START_SECTION((MRMFeatureScoring::XCorrArrayType MRMFeatureScoring::calcxcorr(std::vector<double>& data1, std::vector<double>& data2, bool normalize)))
 {
@@ -353,6 +392,54 @@ m1 = mi(x_ranking,y_ranking)
 }
 END_SECTION
 
+BOOST_AUTO_TEST_CASE(test_rankedMutualInformation_scratch)
+{
+  static const double arr1[] =
+  {
+    5.97543668746948, 4.2749171257019, 3.3301842212677, 4.08597040176392, 5.50307035446167, 5.24326848983765,
+    8.40812492370605, 2.83419919013977, 6.94378805160522, 7.69957494735718, 4.08597040176392
+  };
+  static const double arr2[] =
+  {
+    15.8951349258423, 41.5446395874023, 76.0746307373047, 109.069435119629, 111.90364074707, 169.79216003418,
+    121.043930053711, 63.0136985778809, 44.6150207519531, 21.4926776885986, 7.93575811386108
+  };
+  std::vector<double> data1 (arr1, arr1 + sizeof(arr1) / sizeof(arr1[0]) );
+  std::vector<double> data2 (arr2, arr2 + sizeof(arr2) / sizeof(arr2[0]) );
+
+  // rank into a reused buffer gives the same ranks
+  std::vector<uint> ranks1, ranks2;
+  std::vector<std::pair<float, unsigned int> > sort_buffer;
+  Scoring::computeRank(data1, ranks1, sort_buffer);
+  Scoring::computeRank(data2, ranks2, sort_buffer);
+  std::vector<uint> expected1 = Scoring::computeRank(data1);
+  std::vector<uint> expected2 = Scoring::computeRank(data2);
+  TEST_EQUAL (ranks1.size(), expected1.size());
+  TEST_EQUAL (ranks2.size(), expected2.size());
+  for (std::size_t i = 0; i < expected1.size(); i++)
+  {
+    TEST_EQUAL (ranks1[i], expected1[i]);
+    TEST_EQUAL (ranks2[i], expected2[i]);
+  }
+
+  Scoring::RankedMIScratch scratch;
+  double expected = Scoring::rankedMutualInformation(data1, data2);
+  TEST_REAL_SIMILAR (Scoring::rankedMutualInformation(data1, data2, scratch), expected);
+  TEST_REAL_SIMILAR (Scoring::rankedMutualInformation(ranks1, ranks2, scratch), expected);
+  TEST_REAL_SIMILAR (Scoring::rankedMutualInformation(ranks1, ranks2, scratch), 3.2776);
+
+  // the scratch can be reused for data of a different length
+  std::vector<double> short1(data1.begin(), data1.begin() + 5);
+  std::vector<double> short2(data2.begin(), data2.begin() + 5);
+  TEST_REAL_SIMILAR (Scoring::rankedMutualInformation(short1, short2, scratch),
+                     Scoring::rankedMutualInformation(short1, short2));
+
+  // identical data: MI equals the entropy of the ranks
+  TEST_REAL_SIMILAR (Scoring::rankedMutualInformation(ranks1, ranks1, scratch),
+                     Scoring::rankedMutualInformation(data1, data1));
+}
+END_SECTION
+
 /////////////////////////////////////////////////////////////
 /////////////////////////////////////////////////////////////
 END_TEST
@@ -34,6 +34,8 @@
 
 #include <OpenMS/APPLICATIONS/TOPPBase.h>
 
+#include <OpenMS/ANALYSIS/ID/SearchEngineChunks.h>
+
 #include <OpenMS/FORMAT/MzMLFile.h>
 #include <OpenMS/FORMAT/PepXMLFile.h>
 #include <OpenMS/FORMAT/IdXMLFile.h>
@@ -41,6 +43,7 @@
 #include <OpenMS/CHEMISTRY/ProteaseDB.h>
 #include <OpenMS/CHEMISTRY/ResidueDB.h>
 #include <OpenMS/CHEMISTRY/ResidueModification.h>
+#include <OpenMS/SYSTEM/ExecutionResources.h>
 #include <OpenMS/SYSTEM/File.h>
 
 #include <fstream>
@@ -226,6 +229,9 @@ protected:
     registerIntOption_("max_variable_mods_in_peptide", "<num>", 5, "Set a maximum number of variable modifications per peptide", false, true);
     registerStringOption_("require_variable_mod", "<bool>", "false", "If true, requires at least one variable modification per peptide", false, true);
     setValidStrings_("require_variable_mod", ListUtils::create<String>("true,false"));
+
+    registerIntOption_("chunks", "<num>", 1, "Split the spectra into this many chunks and search them with as many Comet instances at the same time, each using its share of the threads", false, true);
+    setMinInt_("chunks", 1);
   }
 
   vector<ResidueModification> getModifications_(StringList modNames)
@@ -246,14 +252,14 @@ protected:
     return modifications;
   }
 
-  void createParamFile_(ostream& os)
+  void createParamFile_(ostream& os, Int threads)
   {
     os << "# comet_version " << getStringOption_("comet_version") << "\n";               //required as first line in the param file
     os << "# Comet MS/MS search engine parameters file.\n";
     os << "# Everything following the '#' symbol is treated as a comment.\n";
     os << "database_name = " << getStringOption_("database") << "\n";
     os << "decoy_search = " << 0 << "\n"; // 0=no (default), 1=concatenated search, 2=separate search
-    os << "num_threads = " << getIntOption_("threads") << "\n";  // 0=poll CPU to set num threads; else specify num threads directly (max 64)
+    os << "num_threads = " << threads << "\n";  // 0=poll CPU to set num threads; else specify num threads directly (max 64)
 
     // masses
     map<String,int> precursor_error_units;
@@ -541,23 +547,7 @@ protected:
 
     //tmp_dir
     String tmp_dir = makeAutoRemoveTempDirectory_();
-    String tmp_pepxml = tmp_dir + "result.pep.xml";
-    String tmp_pin = tmp_dir + "result.pin";
     String default_params = getStringOption_("default_params_file");
-    String tmp_file;
-
-    //default params given or to be written
-    if (default_params.empty())
-    {
-        tmp_file = tmp_dir + "param.txt";
-        ofstream os(tmp_file.c_str());
-        createParamFile_(os);
-        os.close();
-    }
-    else
-    {
-        tmp_file = default_params;
-    }
 
     PeakMap exp;
     MzMLFile mzml_file;
@@ -581,19 +571,54 @@ protected:
       }
     }
 
+    // search the whole input with one Comet instance or chunks of it with several instances at the same time
+    Size nr_chunks = SearchEngineChunks::getNumberOfChunks(getIntOption_("chunks"), exp.size());
+    vector<String> inputs(1, inputfile_name);
+    if (nr_chunks > 1)
+    {
+      vector<PeakMap> chunks = SearchEngineChunks::split(exp, nr_chunks);
+      inputs.resize(nr_chunks);
+      for (Size i = 0; i < nr_chunks; ++i)
+      {
+        inputs[i] = tmp_dir + "chunk_" + String(i) + ".mzML";
+        mzml_file.store(inputs[i], chunks[i]);
+      }
+    }
+
+    String tmp_file;
+    //default params given or to be written
+    if (default_params.empty())
+    {
+        tmp_file = tmp_dir + "param.txt";
+        ofstream os(tmp_file.c_str());
+        createParamFile_(os, SearchEngineChunks::getThreadsPerChunk(nr_chunks, ExecutionResources::getThreads()));
+        os.close();
+    }
+    else
+    {
+        tmp_file = default_params;
+    }
+
     //-------------------------------------------------------------
     // calculations
     //-------------------------------------------------------------
     String paramP = "-P" + tmp_file;
-    String paramN = "-N" + File::removeExtension(File::removeExtension(tmp_pepxml));
-    QStringList arguments;
-    arguments << paramP.toQString() << paramN.toQString() << inputfile_name.toQString();
+    vector<String> tmp_pepxmls(nr_chunks), tmp_pins(nr_chunks);
+    vector<QStringList> arguments(nr_chunks);
+    for (Size i = 0; i < nr_chunks; ++i)
+    {
+      String result_name = tmp_dir + "result" + (nr_chunks > 1 ? "_" + String(i) : "");
+      tmp_pepxmls[i] = result_name + ".pep.xml";
+      tmp_pins[i] = result_name + ".pin";
+      String paramN = "-N" + result_name;
+      arguments[i] << paramP.toQString() << paramN.toQString() << inputs[i].toQString();
+    }
 
     //-------------------------------------------------------------
     // run comet
     //-------------------------------------------------------------
     // Comet execution with the executable and the arguments StringList
-    TOPPBase::ExitCodes exit_code = runExternalProcess_(comet_executable.toQString(), arguments);
+    TOPPBase::ExitCodes exit_code = runExternalProcesses_(comet_executable.toQString(), arguments, nr_chunks);
     if (exit_code != EXECUTION_OK)
     {
       return exit_code;
@@ -604,11 +629,17 @@ protected:
 
     // read the pep.xml put of Comet and write it to idXML
 
-    vector<PeptideIdentification> peptide_identifications;
-    vector<ProteinIdentification> protein_identifications;
+    vector<vector<PeptideIdentification> > chunk_peptide_identifications(nr_chunks);
+    vector<vector<ProteinIdentification> > chunk_protein_identifications(nr_chunks);
 
     writeDebug_("load PepXMLFile", 1);
-    PepXMLFile().load(tmp_pepxml, protein_identifications, peptide_identifications);
+    for (Size i = 0; i < nr_chunks; ++i)
+    {
+      PepXMLFile().load(tmp_pepxmls[i], chunk_protein_identifications[i], chunk_peptide_identifications[i]);
+    }
+    vector<PeptideIdentification> peptide_identifications;
+    vector<ProteinIdentification> protein_identifications;
+    SearchEngineChunks::merge(chunk_protein_identifications, chunk_peptide_identifications, protein_identifications, peptide_identifications);
     writeDebug_("write idXMLFile", 1);
     writeDebug_(out, 1);
     IdXMLFile().store(out, protein_identifications, peptide_identifications);
@@ -619,10 +650,30 @@ protected:
 
     String pin_out = getStringOption_("pin_out");
     if (!pin_out.empty())
-    { // move the temporary file to the actual destination:
-      if (!File::rename(tmp_pin, pin_out))
-      {
-        return CANNOT_WRITE_OUTPUT_FILE;
+    {
+      if (nr_chunks == 1)
+      { // move the temporary file to the actual destination:
+        if (!File::rename(tmp_pins[0], pin_out))
+        {
+          return CANNOT_WRITE_OUTPUT_FILE;
+        }
+      }
+      else
+      { // concatenate the files of the chunks (keeping only the first header line)
+        ofstream pin_stream(pin_out.c_str());
+        for (Size i = 0; i < nr_chunks; ++i)
+        {
+          ifstream chunk_stream(tmp_pins[i].c_str());
+          String line;
+          for (Size line_nr = 0; getline(chunk_stream, line); ++line_nr)
+          {
+            if (i == 0 || line_nr > 0) pin_stream << line << "\n";
+          }
+        }
+        if (!pin_stream)
+        {
+          return CANNOT_WRITE_OUTPUT_FILE;
+        }
       }
     }
 
@@ -250,7 +250,11 @@ protected:
       id_mapping[input_map.getProteinIdentifications()[i].getIdentifier()] = i;
     }
 
-    // compute consensus:
+    // compute consensus (for all features at once):
+    vector<vector<PeptideIdentification>*> id_sets;
+    vector<Size> runs_per_set;
+    id_sets.reserve(input_map.size());
+    runs_per_set.reserve(input_map.size());
     for (typename MapType::Iterator map_it = input_map.begin();
          map_it != input_map.end(); ++map_it)
     {
@@ -263,8 +267,10 @@ protected:
       }
       Size n_repeats = *max_element(times_seen.begin(), times_seen.end());
 
-      consensus->apply(ids, number_of_runs * n_repeats);
+      id_sets.push_back(&ids);
+      runs_per_set.push_back(number_of_runs * n_repeats);
     }
+    consensus->apply(id_sets, runs_per_set);
 
     // create new identification run:
     setProteinIdentifications_(input_map.getProteinIdentifications());
@@ -375,12 +381,20 @@ protected:
       ConsensusMap grouping;
       linker.group(maps, grouping);
 
-      // compute consensus
+      // compute consensus (for all groups at once)
       pep_ids.clear();
+      vector<vector<PeptideIdentification>*> id_sets;
+      id_sets.reserve(grouping.size());
+      for (ConsensusMap::Iterator it = grouping.begin(); it != grouping.end();
+           ++it)
+      {
+        id_sets.push_back(&it->getPeptideIdentifications());
+      }
+      consensus->apply(id_sets, vector<Size>(id_sets.size(), prot_ids.size()));
+
       for (ConsensusMap::Iterator it = grouping.begin(); it != grouping.end();
            ++it)
       {
-        consensus->apply(it->getPeptideIdentifications(), prot_ids.size());
         if (!it->getPeptideIdentifications().empty())
         {
           PeptideIdentification& pep_id = it->getPeptideIdentifications()[0];
@@ -41,6 +41,7 @@
 #include <OpenMS/CHEMISTRY/ResidueModification.h>
 #include <OpenMS/KERNEL/StandardTypes.h>
 #include <OpenMS/APPLICATIONS/TOPPBase.h>
+#include <OpenMS/SYSTEM/ExecutionResources.h>
 #include <OpenMS/SYSTEM/File.h>
 #include <OpenMS/FORMAT/FileHandler.h>
 #include <OpenMS/DATASTRUCTURES/String.h>
@@ -284,7 +285,7 @@ protected:
     // create index
     {
       String tool = "tide-index";
-      String params = "--overwrite T --peptide-list T --num-threads " + String(getIntOption_("threads"));
+      String params = "--overwrite T --peptide-list T --num-threads " + String(ExecutionResources::getThreads());
       params += " --missed-cleavages " + String(getIntOption_("allowed_missed_cleavages"));
       params += " --digestion " + getStringOption_("digestion");
       params += " --decoy-format " + getStringOption_("decoy-format");
@@ -325,7 +326,7 @@ protected:
     // run crux tide-search
     {
       String tool = "tide-search";
-      String params = "--overwrite T --file-column F --num-threads " + String(getIntOption_("threads"));
+      String params = "--overwrite T --file-column F --num-threads " + String(ExecutionResources::getThreads());
       params += " --output-dir " + output_dir;
       String debug_args = " --verbosity 30 ";
       if (debug_level_ > 5) debug_args = " --verbosity 60 ";
@@ -78,6 +78,12 @@ using namespace std;
  impossible for reasonably large datasets using other aligners, as these
  datasets tend to be too dense and hence cannot be partitioned.
 
+ For very large numbers of input maps, the flag @p -out_of_core can be set
+ (featureXML input only): the input files are then read one at a time and
+ their features are distributed to temporary files, one per m/z partition
+ (see @p -algorithm:nr_partitions). The partitions are linked independently
+ and in parallel, so that not all input maps have to be kept in memory.
+
  Prior to feature linking, this tool performs an (optional) retention time
  transformation on the features using LOWESS regression in order to minimize
  retention time differences between corresponding features across different
@@ -109,6 +115,7 @@ protected:
   void registerOptionsAndFlags_() override
   {
     TOPPFeatureLinkerBase::registerOptionsAndFlags_();
+    registerFlag_("out_of_core", "Do not load all input maps into memory, but distribute their features to temporary partition files first (featureXML input only, no fractionated design).", true);
     registerSubsection_("algorithm", "Algorithm parameters section");
   }
 
@@ -122,9 +129,58 @@ protected:
   ExitCodes main_(int, const char **) override
   {
     FeatureGroupingAlgorithmKD algo;
+    if (getFlag_("out_of_core"))
+    {
+      return outOfCoreMain_(algo);
+    }
     return TOPPFeatureLinkerBase::common_main_(&algo);
   }
 
+  ExitCodes outOfCoreMain_(FeatureGroupingAlgorithmKD& algo)
+  {
+    StringList ins = getStringList_("in");
+    String out = getStringOption_("out");
+
+    for (Size i = 0; i < ins.size(); ++i)
+    {
+      if (FileHandler::getType(ins[i]) != FileTypes::FEATUREXML)
+      {
+        writeLog_("Error: The out-of-core mode requires featureXML input files!");
+        return ILLEGAL_PARAMETERS;
+      }
+    }
+    if (!getStringOption_("design").empty())
+    {
+      writeLog_("Error: A fractionated design is not supported in the out-of-core mode!");
+      return ILLEGAL_PARAMETERS;
+    }
+
+    Param algorithm_param = getParam_().copy("algorithm:", true);
+    writeDebug_("Used algorithm parameters", algorithm_param, 3);
+    algo.setParameters(algorithm_param);
+
+    LOG_INFO << "Linking " << ins.size() << " featureXMLs (out-of-core)." << endl;
+    ConsensusMap out_map;
+    algo.group(ins, out_map);
+
+    // assign unique ids
+    out_map.applyMemberFunction(&UniqueIdInterface::setUniqueId);
+
+    // annotate output with data processing info
+    addDataProcessing_(out_map,
+                       getProcessingInfo_(DataProcessing::FEATURE_GROUPING));
+
+    // sort list of peptide identifications in each consensus feature by map index
+    out_map.sortPeptideIdentificationsByMapIndex();
+
+    // write output
+    ConsensusXMLFile().store(out, out_map);
+
+    LOG_INFO << "Number of consensus features: " << out_map.size() << endl;
+
+    return EXECUTION_OK;
+  }
+
 };
 
 
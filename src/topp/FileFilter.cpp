@@ -637,6 +637,8 @@ protected:
       f.getOptions().setMZRange(DRange<1>(mz_l, mz_u));
       f.getOptions().setIntensityRange(DRange<1>(it_l, it_u));
       f.getOptions().setMSLevels(levels);
+      // for indexed mzML, only parse the spectra passing the RT/MS level filters
+      f.getOptions().setUseIndexedSelection(true);
 
       // set precision options
       if (mz32 == 32) { f.getOptions().setMz32Bit(true); } else if (mz32 == 64) { f.getOptions().setMz32Bit(false); }
@@ -656,13 +658,12 @@ protected:
       // remove spectra with meta values:
       if (remove_meta_enabled)
       {
-        MapType exp_tmp;
-        for (MapType::ConstIterator it = exp.begin(); it != exp.end(); ++it)
+        std::vector<MSSpectrum> kept;
+        for (MapType::Iterator it = exp.begin(); it != exp.end(); ++it)
         {
-          if (checkMetaOk(*it, meta_info)) exp_tmp.addSpectrum(*it);
+          if (checkMetaOk(*it, meta_info)) kept.push_back(std::move(*it));
         }
-        exp.clear(false);
-        exp.getSpectra().insert(exp.begin(), exp_tmp.begin(), exp_tmp.end());
+        exp.setSpectra(std::move(kept));
       }
 
 
@@ -1222,19 +1223,18 @@ protected:
     }
 
 
-    PeakMap exp2 = exp;
-    exp2.clear(false);
-
+    // move the remaining spectra instead of copying the whole experiment
+    std::vector<MSSpectrum> kept;
     for (Size i = 0; i != exp.size(); ++i)
     {
       if (find(blacklist_idx.begin(), blacklist_idx.end(), i) ==
           blacklist_idx.end())
       {
-        exp2.addSpectrum(exp[i]);
+        kept.push_back(std::move(exp[i]));
       }
     }
 
-    exp = exp2;
+    exp.setSpectra(std::move(kept));
     return EXECUTION_OK;
   }
 
@@ -1288,9 +1288,8 @@ protected:
       }
     }
 
-    // create new experiment
-    PeakMap exp2;
-    exp2.getExperimentalSettings() = (ExperimentalSettings)exp.getExperimentalSettings(); // copy meta data
+    // move the selected spectra instead of copying the whole experiment
+    std::vector<MSSpectrum> kept;
 
     for (Size i = 0; i != exp.size(); ++i)
     {
@@ -1300,19 +1299,23 @@ protected:
         // blacklist: add all spectra not contained in list
         if (find(list_idx.begin(), list_idx.end(), i) == list_idx.end())
         {
-          exp2.addSpectrum(exp[i]);
+          kept.push_back(std::move(exp[i]));
         }
       }
       else   // whitelist: add all non MS2 spectra, and MS2 only if in list
       {
         if (exp[i].getMSLevel() != 2 || find(list_idx.begin(), list_idx.end(), i) != list_idx.end())
         {
-          exp2.addSpectrum(exp[i]);
+          kept.push_back(std::move(exp[i]));
         }
       }
     }
 
-    exp = exp2;
+    // new experiment with the meta data and the selected spectra only (no chromatograms)
+    ExperimentalSettings settings = exp.getExperimentalSettings();
+    exp.clear(true);
+    exp.getExperimentalSettings() = settings;
+    exp.setSpectra(std::move(kept));
     return EXECUTION_OK;
   }
 
@@ -1364,9 +1367,8 @@ protected:
       }
     }
 
-    // create new experiment
-    PeakMap exp2 = exp; // copy meta data
-    exp2.clear(false); // clear spectra
+    // move the selected spectra instead of copying the whole experiment
+    std::vector<MSSpectrum> kept;
 
     for (Size i = 0; i != exp.size(); ++i)
     {
@@ -1376,19 +1378,19 @@ protected:
         // blacklist: add all spectra not contained in list
         if (find(list_idx.begin(), list_idx.end(), i) == list_idx.end())
         {
-          exp2.addSpectrum(exp[i]);
+          kept.push_back(std::move(exp[i]));
         }
       }
       else   // whitelist: add all non-MS2 spectra + matched MS2 spectra
       {
         if (exp[i].getMSLevel() != 2 || find(list_idx.begin(), list_idx.end(), i) != list_idx.end())
         {
-          exp2.addSpectrum(exp[i]);
+          kept.push_back(std::move(exp[i]));
         }
       }
     }
 
-    exp = exp2;
+    exp.setSpectra(std::move(kept));
     return EXECUTION_OK;
   }
 
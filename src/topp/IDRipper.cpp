@@ -150,45 +150,12 @@ protected:
     // calculations
     //-------------------------------------------------------------
 
-    vector<ProteinIdentification> proteins;
-    vector<PeptideIdentification> peptides;
-    IdXMLFile().load(file_name, proteins, peptides);
-
-    //ensure protein and peptide identifications are presented, otherwise we don't have to rip anything anyhow
-    if (proteins.empty() || peptides.empty())
-    {
-      throw Exception::Precondition(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "idXML file has to store protein and peptide identifications!");
-    }
-
-    map<String, pair<vector<ProteinIdentification>, vector<PeptideIdentification> > > ripped;
-
-    // rip the idXML-file into several idXML according to the annotated file origin
+    // the input is streamed, peptide identifications are written to their output files as they are read
     IDRipper ripper;
-    ripper.rip(ripped, proteins, peptides);
-
-    //-------------------------------------------------------------
-    // writing output
-    //-------------------------------------------------------------
-
-    map<String, pair<vector<ProteinIdentification>, vector<PeptideIdentification> > >::iterator it;
-    for (it = ripped.begin(); it != ripped.end(); ++it)
+    StringList written = ripper.ripFile(file_name, output_directory);
+    for (StringList::const_iterator it = written.begin(); it != written.end(); ++it)
     {
-      QString output = output_directory.toQString();
-      // create full absolute path with filename
-      String out = QDir::toNativeSeparators(output.append(QString("/")).append(it->first.toQString())).toStdString();
-      LOG_INFO << "Storing file: '" << out << "'." << std::endl;
-
-      QDir dir(output_directory.toQString());
-      if (!dir.exists())
-      {
-        if (!File::writable(output_directory))
-        {
-          LOG_WARN << "Warning: Cannot create folder: '" << output_directory << "'." << std::endl;
-          return CANNOT_WRITE_OUTPUT_FILE;
-        }
-        dir.mkpath(".");
-      }
-      IdXMLFile().store(out, it->second.first, it->second.second);
+      LOG_INFO << "Stored file: '" << *it << "'." << std::endl;
     }
     return EXECUTION_OK;
   }
@@ -50,6 +50,7 @@
 #include <OpenMS/SYSTEM/File.h>
 
 #include <OpenMS/FORMAT/ConsensusXMLFile.h>
+#include <OpenMS/FORMAT/InMemoryFileStore.h>
 #include <OpenMS/FORMAT/MzMLFile.h>
 #include <OpenMS/FORMAT/MzQuantMLFile.h>
 
@@ -262,15 +263,6 @@ protected:
     String in = getStringOption_("in");
     String out = getStringOption_("out");
 
-    //-------------------------------------------------------------
-    // loading input
-    //-------------------------------------------------------------
-
-    MzMLFile mz_data_file;
-    PeakMap exp;
-    mz_data_file.setLogType(log_type_);
-    mz_data_file.load(in, exp);
-
     //-------------------------------------------------------------
     // init quant method
     //-------------------------------------------------------------
@@ -288,8 +280,24 @@ protected:
 
     ConsensusMap consensus_map_raw, consensus_map_quant;
 
-    // extract channel information
-    channel_extractor.extractChannels(exp, consensus_map_raw);
+    //-------------------------------------------------------------
+    // loading input / extract channel information
+    //-------------------------------------------------------------
+    MzMLFile mz_data_file;
+    mz_data_file.setLogType(log_type_);
+    if (InMemoryFileStore::isMemoryPath(in))
+    {
+      PeakMap exp;
+      mz_data_file.load(in, exp);
+      channel_extractor.extractChannels(exp, consensus_map_raw);
+    }
+    else
+    {
+      // extract while reading, only the current MS1 window is kept in memory
+      IsobaricChannelExtractor::ExtractionConsumer consumer(channel_extractor, consensus_map_raw);
+      mz_data_file.transform(in, &consumer, true, true);
+      consumer.finish();
+    }
 
     IsobaricQuantifier quantifier(quant_method);
     Param quant_param(getParam_().copy("quantification:", true));
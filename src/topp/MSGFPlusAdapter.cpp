@@ -34,15 +34,18 @@
 
 #include <OpenMS/APPLICATIONS/TOPPBase.h>
 
+#include <OpenMS/ANALYSIS/ID/SearchEngineChunks.h>
 #include <OpenMS/CHEMISTRY/ModificationsDB.h>
 #include <OpenMS/CHEMISTRY/ProteaseDB.h>
 #include <OpenMS/DATASTRUCTURES/String.h>
 #include <OpenMS/FORMAT/CsvFile.h>
+#include <OpenMS/FORMAT/FileHandler.h>
 #include <OpenMS/FORMAT/IdXMLFile.h>
 #include <OpenMS/FORMAT/MzMLFile.h>
 #include <OpenMS/FORMAT/MzIdentMLFile.h>
 #include <OpenMS/METADATA/ProteinIdentification.h>
 #include <OpenMS/METADATA/SpectrumMetaDataLookup.h>
+#include <OpenMS/SYSTEM/ExecutionResources.h>
 #include <OpenMS/SYSTEM/File.h>
 #include <OpenMS/SYSTEM/JavaInfo.h>
 
@@ -199,6 +202,9 @@ protected:
     registerInputFile_("java_executable", "<file>", "java", "The Java executable. Usually Java is on the system PATH. If Java is not found, use this parameter to specify the full path to Java", false, false, ListUtils::create<String>("skipexists"));
     registerIntOption_("java_memory", "<num>", 3500, "Maximum Java heap size (in MB)", false);
     registerIntOption_("java_permgen", "<num>", 0, "Maximum Java permanent generation space (in MB); only for Java 7 and below", false, true);
+
+    registerIntOption_("chunks", "<num>", 1, "Split the spectra into this many chunks and search them with as many MS-GF+ instances at the same time, each using its share of the threads and 'java_memory' (MS-GF+ does not scale to many threads). Only for mzML input, cannot be combined with 'mzid_out' or 'legacy_conversion'.", false, true);
+    setMinInt_("chunks", 1);
   }
 
   // The following sequence modification methods are used to modify the sequence stored in the TSV such that it can be used by AASequence
@@ -496,12 +502,43 @@ protected:
       executable = qmsgfpath;
     }
 
+    // search the whole input with one MS-GF+ instance or chunks of it with several instances at the same time
+    Size nr_chunks = 1;
+    vector<String> inputs(1, in), mzid_temps(1, mzid_temp);
+    if (getIntOption_("chunks") > 1)
+    {
+      if (!mzid_out.empty() || getFlag_("legacy_conversion"))
+      {
+        writeLog_("Fatal error: the search cannot be split into chunks ('chunks') if 'mzid_out' or 'legacy_conversion' is used");
+        return ILLEGAL_PARAMETERS;
+      }
+      if (FileHandler::getType(in) != FileTypes::MZML)
+      {
+        writeLog_("Fatal error: the search can only be split into chunks ('chunks') for mzML input");
+        return ILLEGAL_PARAMETERS;
+      }
+      PeakMap exp;
+      MzMLFile mzml_file;
+      mzml_file.getOptions().setMSLevels({2});
+      mzml_file.setLogType(log_type_);
+      mzml_file.load(in, exp);
+      nr_chunks = SearchEngineChunks::getNumberOfChunks(getIntOption_("chunks"), exp.size());
+      if (nr_chunks > 1)
+      {
+        vector<PeakMap> chunks = SearchEngineChunks::split(exp, nr_chunks);
+        inputs.resize(nr_chunks);
+        mzid_temps.resize(nr_chunks);
+        for (Size i = 0; i < nr_chunks; ++i)
+        {
+          inputs[i] = temp_dir + "chunk_" + String(i) + ".mzML";
+          mzid_temps[i] = temp_dir + "msgfplus_output_" + String(i) + ".mzid";
+          mzml_file.store(inputs[i], chunks[i]);
+        }
+      }
+    }
+
     QStringList process_params; // the actual process is Java, not MS-GF+!
-    process_params << java_memory
-                   << "-jar" << executable
-                   << "-s" << in.toQString()
-                   << "-o" << mzid_temp.toQString()
-                   << "-d" << db_name.toQString()
+    process_params << "-d" << db_name.toQString()
                    << "-t" << QString::number(precursor_mass_tol) + precursor_error_units.toQString()
                    << "-ti" << getStringOption_("isotope_error_range").toQString()
                    << "-tda" << QString::number(int(getFlag_("add_decoys")))
@@ -516,13 +553,23 @@ protected:
                    << "-maxCharge" << QString::number(max_precursor_charge)
                    << "-n" << QString::number(getIntOption_("matches_per_spec"))
                    << "-addFeatures" << QString::number(int((getParam_().getValue("add_features") == "true")))
-                   << "-thread" << QString::number(getIntOption_("threads"));
+                   << "-thread" << QString::number(SearchEngineChunks::getThreadsPerChunk(nr_chunks, ExecutionResources::getThreads()));
 
     if (!mod_file.empty())
     {
       process_params << "-mod" << mod_file.toQString();
     }
 
+    vector<QStringList> chunk_params(nr_chunks);
+    for (Size i = 0; i < nr_chunks; ++i)
+    {
+      chunk_params[i] << java_memory
+                      << "-jar" << executable
+                      << "-s" << inputs[i].toQString()
+                      << "-o" << mzid_temps[i].toQString()
+                      << process_params;
+    }
+
     //-------------------------------------------------------------
     // execute MS-GF+
     //-------------------------------------------------------------
@@ -530,7 +577,7 @@ protected:
     // run MS-GF+ process and create the .mzid file
 
     writeLog_("Running MSGFPlus search...");
-    TOPPBase::ExitCodes exit_code = runExternalProcess_(java_executable.toQString(), process_params);
+    TOPPBase::ExitCodes exit_code = runExternalProcesses_(java_executable.toQString(), chunk_params, nr_chunks);
     if (exit_code != EXECUTION_OK)
     {
       return exit_code;
@@ -731,9 +778,22 @@ protected:
       }
       else
       {
+        vector<vector<ProteinIdentification> > chunk_protein_ids(nr_chunks);
+        vector<vector<PeptideIdentification> > chunk_peptide_ids(nr_chunks);
+        for (Size i = 0; i < nr_chunks; ++i)
+        {
+          MzIdentMLFile().load(mzid_temps[i], chunk_protein_ids[i], chunk_peptide_ids[i]);
+        }
         vector<ProteinIdentification> protein_ids;
         vector<PeptideIdentification> peptide_ids;
-        MzIdentMLFile().load(mzid_temp, protein_ids, peptide_ids);
+        SearchEngineChunks::merge(chunk_protein_ids, chunk_peptide_ids, protein_ids, peptide_ids);
+        if (nr_chunks > 1) // refer to the actual input instead of the first chunk
+        {
+          for (vector<ProteinIdentification>::iterator prot_it = protein_ids.begin(); prot_it != protein_ids.end(); ++prot_it)
+          {
+            prot_it->setPrimaryMSRunPath(StringList(1, File::absolutePath(in)));
+          }
+        }
         // set the MS-GF+ spectral e-value as new peptide identification score
         for (vector<PeptideIdentification>::iterator pep_it = peptide_ids.begin(); pep_it != peptide_ids.end(); ++pep_it)
         {
@@ -37,6 +37,10 @@
 #include <OpenMS/METADATA/ExperimentalDesign.h>
 #include <OpenMS/FORMAT/ExperimentalDesignFile.h>
 
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
 using namespace OpenMS;
 using namespace std;
 
@@ -123,12 +127,40 @@ private:
     ProgressLogger progresslogger;
     progresslogger.setLogType(TOPPMapAlignerBase::log_type_);
     progresslogger.startProgress(0, ins.size(), "loading input files");
-    for (Size i = 0; i < ins.size(); ++i)
+    Size progress(0); // thread-safe progress
+    Size err_count(0);
+    std::exception_ptr err;
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic, 1)
+#endif
+    for (SignedSize i = 0; i < SignedSize(ins.size()); ++i)
     {
-      progresslogger.setProgress(i);
-      input_file.load(ins[i], maps[i]);
+      try
+      {
+        // use a temporary file object since loading is not thread-safe:
+        FileType input_file_tmp;
+        input_file_tmp.getOptions() = input_file.getOptions();
+        input_file_tmp.load(ins[i], maps[i]);
+      }
+      catch (...)
+      {
+#ifdef _OPENMP
+#pragma omp critical (MAIdentification_error)
+#endif
+        {
+          ++err_count;
+          err = std::current_exception();
+        }
+      }
+#ifdef _OPENMP
+#pragma omp critical (MAIdentification_Progress)
+#endif
+      {
+        progresslogger.setProgress(++progress); // thread safe progress counter
+      }
     }
     progresslogger.endProgress();
+    if (err_count != 0) std::rethrow_exception(err);
   }
 
   // helper function to avoid code duplication between consensusXML and
@@ -166,11 +198,30 @@ private:
     if (model_type != "none")
     {
       model_params = model_params.copy(model_type + ":", true);
-      for (vector<TransformationDescription>::iterator it =
-             transformations.begin(); it != transformations.end(); ++it)
+      // the models are independent of each other, fit them in parallel:
+      Size err_count(0);
+      std::exception_ptr err;
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic, 1)
+#endif
+      for (SignedSize i = 0; i < SignedSize(transformations.size()); ++i)
       {
-        it->fitModel(model_type, model_params);
+        try
+        {
+          transformations[i].fitModel(model_type, model_params);
+        }
+        catch (...)
+        {
+#ifdef _OPENMP
+#pragma omp critical (MAIdentification_error)
+#endif
+          {
+            ++err_count;
+            err = std::current_exception();
+          }
+        }
       }
+      if (err_count != 0) std::rethrow_exception(err);
     }
   }
 
@@ -417,12 +468,38 @@ private:
       progresslogger.setLogType(log_type_);
       progresslogger.startProgress(0, input_files.size(),
                                    "loading input files");
-      for (Size i = 0; i < input_files.size(); ++i)
+      Size progress(0); // thread-safe progress
+      Size err_count(0);
+      std::exception_ptr err;
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic, 1)
+#endif
+      for (SignedSize i = 0; i < SignedSize(input_files.size()); ++i)
       {
-        progresslogger.setProgress(i);
-        idxml_file.load(input_files[i], protein_ids[i], peptide_ids[i]);
+        try
+        {
+          // use a temporary file object since loading is not thread-safe:
+          IdXMLFile().load(input_files[i], protein_ids[i], peptide_ids[i]);
+        }
+        catch (...)
+        {
+#ifdef _OPENMP
+#pragma omp critical (MAIdentification_error)
+#endif
+          {
+            ++err_count;
+            err = std::current_exception();
+          }
+        }
+#ifdef _OPENMP
+#pragma omp critical (MAIdentification_Progress)
+#endif
+        {
+          progresslogger.setProgress(++progress); // thread safe progress counter
+        }
       }
       progresslogger.endProgress();
+      if (err_count != 0) std::rethrow_exception(err);
 
       performAlignment_(algorithm, peptide_ids, transformations,
                         reference_index);
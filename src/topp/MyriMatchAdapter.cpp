@@ -45,6 +45,7 @@
 #include <OpenMS/DATASTRUCTURES/ListUtils.h>
 #include <OpenMS/DATASTRUCTURES/ListUtilsIO.h>
 
+#include <OpenMS/SYSTEM/ExecutionResources.h>
 #include <OpenMS/SYSTEM/File.h>
 #include <fstream>
 #include <iostream>
@@ -410,7 +411,7 @@ protected:
     parameters << "-NumIntensityClasses" << getIntOption_("NumIntensityClasses");
     parameters << "-ClassSizeMultiplier" << getDoubleOption_("ClassSizeMultiplier");
     parameters << "-MonoisotopeAdjustmentSet" << getStringOption_("MonoisotopeAdjustmentSet");
-    parameters << "-cpus" << getIntOption_("threads");
+    parameters << "-cpus" << ExecutionResources::getThreads();
 
 
     // Constant parameters
@@ -459,16 +459,32 @@ protected:
       return mztab;
     }
 
-    static MzTab exportIdentificationsToMzTab(const vector<ProteinIdentification>& prot_ids, const vector<PeptideIdentification>& peptide_ids, const String& filename)
+    /// Information shared by all PSM rows of an identification export
+    struct PSMExportContext
+    {
+      /// run identifier to (1-based) MS run index
+      map<String, size_t> map_id_to_run;
+      MzTabString db;
+      MzTabString db_version;
+      String search_engine;
+      String search_engine_version;
+    };
+
+    /**
+      @brief Exports meta data and protein section of identifications (everything but the PSM section)
+
+      @p context is filled with the information needed to generate the PSM rows with addPSMRows().
+    */
+    static MzTab exportIdentificationSummaryToMzTab(const vector<ProteinIdentification>& prot_ids, const String& filename, PSMExportContext& context)
     {
       LOG_INFO << "exporting identifications: \"" << filename << "\" to mzTab: " << std::endl;
-      vector<PeptideIdentification> pep_ids = peptide_ids;
       MzTab mztab;
       MzTabMetaData meta_data;
       vector<String> var_mods, fixed_mods;
-      MzTabString db, db_version;
-      String search_engine;
-      String search_engine_version;
+      MzTabString& db = context.db;
+      MzTabString& db_version = context.db_version;
+      String& search_engine = context.search_engine;
+      String& search_engine_version = context.search_engine_version;
 
       if (!prot_ids.empty())
       {
@@ -476,27 +492,13 @@ protected:
         search_engine_version = prot_ids[0].getSearchEngineVersion();
       }
 
-      // helper to map between peptide identifications and MS run
-      map<size_t, size_t> map_pep_idx_2_run;
-
       if (!prot_ids.empty())
       {
-        // map peptide ids back to their MS run
-        map<String, size_t> map_id_to_run;
-
-        // first: map run identifier to run index
+        // map run identifier to run index (used to link peptide ids back to their MS run)
         size_t run_index(1);
         for (auto it = prot_ids.begin(); it != prot_ids.end(); ++it, ++run_index)
         {
-          map_id_to_run[it->getIdentifier()] = run_index;
-        }
-
-        // second: map peptide index to run index
-        size_t psm_idx(0);
-        for (auto it = peptide_ids.begin(); it != peptide_ids.end(); ++it, ++psm_idx)
-        {          
-          size_t run_idx = map_id_to_run[it->getIdentifier()];
-          map_pep_idx_2_run[psm_idx] = run_idx;
+          context.map_id_to_run[it->getIdentifier()] = run_index;
         }
 
         MzTabParameter protein_score_type;
@@ -655,85 +657,93 @@ protected:
 
       mztab.setMetaData(meta_data);
 
-      MzTabPSMSectionRows rows;
-      Size psm_id(0);
-      for (auto it = pep_ids.begin(); it != pep_ids.end(); ++it, ++psm_id)
-      {
-        // skip empty peptide identification objects
-        if (it->getHits().empty())
-        {
-          continue;
-        }
-
-        // sort by rank
-        it->assignRanks();
-
-        MzTabPSMSectionRow row;
-
-        // link to MS run
-        size_t run_index = map_pep_idx_2_run[psm_id];
-        String spectrum_nativeID = it->getMetaValue("spectrum_reference").toString();
-
-        MzTabSpectraRef spec_ref;
-        row.spectra_ref.setMSFile(run_index);
-        row.spectra_ref.setSpecRef(spectrum_nativeID);
-
-        // only consider best peptide hit for export
-        const PeptideHit& best_ph = it->getHits()[0];
-        const AASequence& aas = best_ph.getSequence();
-        row.sequence = MzTabString(aas.toUnmodifiedString());
-
-        // extract all modifications in the current sequence for reporting. In contrast to peptide and protein section all modifications are reported.
-        row.modifications = extractModificationListFromAASequence(aas);
-
-        row.PSM_ID = MzTabInteger(psm_id);
-        row.database = db;
-        row.database_version = db_version;
-        MzTabParameterList search_engines;
-        search_engines.fromCellString("[,," + search_engine + "," + search_engine_version + "]");
-        row.search_engine = search_engines;
-
-        row.search_engine_score[1] = MzTabDouble(best_ph.getScore());
-
-        vector<MzTabDouble> rts_vector;
-        rts_vector.push_back(MzTabDouble(it->getRT()));
-
-        MzTabDoubleList rts;
-        rts.set(rts_vector);
-        row.retention_time = rts;
-        row.charge = MzTabInteger(best_ph.getCharge());
-        row.exp_mass_to_charge = MzTabDouble(it->getMZ());
-        row.calc_mass_to_charge = best_ph.getCharge() != 0 ? MzTabDouble(aas.getMonoWeight(Residue::Full, best_ph.getCharge()) / best_ph.getCharge()) : MzTabDouble();
-
-        // add opt_global_modified_sequence in opt_ and set it to the OpenMS amino acid string (easier human readable than unimod accessions)
-        MzTabOptionalColumnEntry opt_entry;
-        opt_entry.first = String("opt_global_modified_sequence");
-        opt_entry.second = MzTabString(aas.toString());
-        row.opt_.push_back(opt_entry);
-
-        // currently write all keys
-        // TODO: percentage procedure with MetaInfoInterfaceUtils
-        vector<String> ph_keys;
-        best_ph.getKeys(ph_keys);
-        // TODO: no conversion but make function on collections
-        set<String> ph_key_set(ph_keys.begin(), ph_keys.end());
-        addMetaInfoToOptionalColumns(ph_key_set, row.opt_, String("global"), best_ph);
-
-        // TODO Think about if the uniqueness can be determined by # of peptide evidences
-        // b/c this would only differ when evidences come from different DBs
-        const set<String>& accessions = best_ph.extractProteinAccessionsSet();
-        row.unique = accessions.size() == 1 ? MzTabBoolean(true) : MzTabBoolean(false);
+      return mztab;
+    }
 
-        // create row for every PeptideEvidence entry (mapping to a protein)
-        const vector<PeptideEvidence> peptide_evidences = best_ph.getPeptideEvidences();
+    /**
+      @brief Appends the PSM rows (one per peptide evidence of the best hit) of a peptide identification
 
-        // pass common row entries and create rows for all peptide evidences
-        addPepEvidenceToRows(peptide_evidences, row, rows);
+      Does not modify shared state and can be called concurrently.
+    */
+    static void addPSMRows(const PeptideIdentification& pep_id, Size psm_id, const PSMExportContext& context, MzTabPSMSectionRows& rows)
+    {
+      // skip empty peptide identification objects
+      if (pep_id.getHits().empty())
+      {
+        return;
       }
 
-      mztab.setPSMSectionRows(rows);
-
-      return mztab;
+      const MzTabString& db = context.db;
+      const MzTabString& db_version = context.db_version;
+      const String& search_engine = context.search_engine;
+      const String& search_engine_version = context.search_engine_version;
+
+      // sort by rank (on a copy, the input is shared between threads)
+      PeptideIdentification id = pep_id;
+      id.assignRanks();
+
+      MzTabPSMSectionRow row;
+
+      // link to MS run
+      map<String, size_t>::const_iterator run_it = context.map_id_to_run.find(id.getIdentifier());
+      size_t run_index = run_it != context.map_id_to_run.end() ? run_it->second : 0;
+      String spectrum_nativeID = id.getMetaValue("spectrum_reference").toString();
+
+      MzTabSpectraRef spec_ref;
+      row.spectra_ref.setMSFile(run_index);
+      row.spectra_ref.setSpecRef(spectrum_nativeID);
+
+      // only consider best peptide hit for export
+      const PeptideHit& best_ph = id.getHits()[0];
+      const AASequence& aas = best_ph.getSequence();
+      row.sequence = MzTabString(aas.toUnmodifiedString());
+
+      // extract all modifications in the current sequence for reporting. In contrast to peptide and protein section all modifications are reported.
+      row.modifications = extractModificationListFromAASequence(aas);
+
+      row.PSM_ID = MzTabInteger(psm_id);
+      row.database = db;
+      row.database_version = db_version;
+      MzTabParameterList search_engines;
+      search_engines.fromCellString("[,," + search_engine + "," + search_engine_version + "]");
+      row.search_engine = search_engines;
+
+      row.search_engine_score[1] = MzTabDouble(best_ph.getScore());
+
+      vector<MzTabDouble> rts_vector;
+      rts_vector.push_back(MzTabDouble(id.getRT()));
+
+      MzTabDoubleList rts;
+      rts.set(rts_vector);
+      row.retention_time = rts;
+      row.charge = MzTabInteger(best_ph.getCharge());
+      row.exp_mass_to_charge = MzTabDouble(id.getMZ());
+      row.calc_mass_to_charge = best_ph.getCharge() != 0 ? MzTabDouble(aas.getMonoWeight(Residue::Full, best_ph.getCharge()) / best_ph.getCharge()) : MzTabDouble();
+
+      // add opt_global_modified_sequence in opt_ and set it to the OpenMS amino acid string (easier human readable than unimod accessions)
+      MzTabOptionalColumnEntry opt_entry;
+      opt_entry.first = String("opt_global_modified_sequence");
+      opt_entry.second = MzTabString(aas.toString());
+      row.opt_.push_back(opt_entry);
+
+      // currently write all keys
+      // TODO: percentage procedure with MetaInfoInterfaceUtils
+      vector<String> ph_keys;
+      best_ph.getKeys(ph_keys);
+      // TODO: no conversion but make function on collections
+      set<String> ph_key_set(ph_keys.begin(), ph_keys.end());
+      addMetaInfoToOptionalColumns(ph_key_set, row.opt_, String("global"), best_ph);
+
+      // TODO Think about if the uniqueness can be determined by # of peptide evidences
+      // b/c this would only differ when evidences come from different DBs
+      const set<String>& accessions = best_ph.extractProteinAccessionsSet();
+      row.unique = accessions.size() == 1 ? MzTabBoolean(true) : MzTabBoolean(false);
+
+      // create row for every PeptideEvidence entry (mapping to a protein)
+      const vector<PeptideEvidence> peptide_evidences = best_ph.getPeptideEvidences();
+
+      // pass common row entries and create rows for all peptide evidences
+      addPepEvidenceToRows(peptide_evidences, row, rows);
     }
 
     // Generate MzTab style list of PTMs from AASequence object. 
@@ -1016,6 +1026,18 @@ protected:
       return mztab;
     }
 
+    /// stores identifications, the PSM section is generated while writing
+    ExitCodes storeIdentifications_(const String& out, const vector<ProteinIdentification>& prot_ids, const vector<PeptideIdentification>& pep_ids, const String& in)
+    {
+      PSMExportContext context;
+      MzTab mztab = exportIdentificationSummaryToMzTab(prot_ids, in, context);
+      MzTabFile().store(out, mztab, pep_ids.size(), [&pep_ids, &context](Size psm_id, MzTabPSMSectionRows& rows)
+      {
+        addPSMRows(pep_ids[psm_id], psm_id, context, rows);
+      });
+      return EXECUTION_OK;
+    }
+
     ExitCodes main_(int, const char**) override
     {
       // parameter handling
@@ -1071,7 +1093,7 @@ protected:
         vector<ProteinIdentification> prot_ids;
         vector<PeptideIdentification> pep_ids;
         IdXMLFile().load(in, prot_ids, pep_ids, document_id);
-        mztab = exportIdentificationsToMzTab(prot_ids, pep_ids, in); 
+        return storeIdentifications_(out, prot_ids, pep_ids, in);
       }
 
       // export identification data from mzIdentML
@@ -1081,7 +1103,7 @@ protected:
         vector<ProteinIdentification> prot_ids;
         vector<PeptideIdentification> pep_ids;
         MzIdentMLFile().load(in, prot_ids, pep_ids);
-        mztab = exportIdentificationsToMzTab(prot_ids, pep_ids, in); 
+        return storeIdentifications_(out, prot_ids, pep_ids, in);
       }
 
       // export quantification data
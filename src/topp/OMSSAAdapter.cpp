@@ -46,6 +46,7 @@
 #include <OpenMS/FORMAT/OMSSAXMLFile.h>
 #include <OpenMS/FORMAT/TextFile.h>
 #include <OpenMS/KERNEL/StandardTypes.h>
+#include <OpenMS/SYSTEM/ExecutionResources.h>
 #include <OpenMS/SYSTEM/File.h>
 
 #include <fstream>
@@ -544,7 +545,7 @@ protected:
     parameters << "-is" << String(getDoubleOption_("is"));
     parameters << "-ir" << String(getDoubleOption_("ir"));
     parameters << "-ii" << String(getDoubleOption_("ii"));
-    parameters << "-nt" << String(getIntOption_("threads"));
+    parameters << "-nt" << String(ExecutionResources::getThreads());
 
     if (getFlag_("mnm"))
     {
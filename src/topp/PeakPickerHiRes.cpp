@@ -37,6 +37,8 @@
 #include <OpenMS/APPLICATIONS/TOPPBase.h>
 
 #include <OpenMS/FORMAT/DATAACCESS/MSDataWritingConsumer.h>
+#include <OpenMS/FORMAT/DATAACCESS/MSDataTransformingConsumer.h>
+#include <OpenMS/FORMAT/DATAACCESS/MSDataPipelineConsumer.h>
 
 using namespace OpenMS;
 using namespace std;
@@ -123,44 +125,6 @@ public:
 
 protected:
 
-  /**
-    @brief Helper class for the Low Memory peak-picking
-  */
-  class PPHiResMzMLConsumer :
-    public MSDataWritingConsumer
-  {
-
-  public:
-
-    PPHiResMzMLConsumer(String filename, const PeakPickerHiRes& pp) :
-      MSDataWritingConsumer(filename),
-      ms_levels_(pp.getParameters().getValue("ms_levels").toIntList())
-    {
-      pp_ = pp;
-    }
-
-    void processSpectrum_(MapType::SpectrumType& s) override
-    {
-      if (!ListUtils::contains(ms_levels_, s.getMSLevel())) {return;}
-
-      MapType::SpectrumType sout;
-      pp_.pick(s, sout);
-      s = sout;  // todo: swap? (requires implementation)
-    }
-
-    void processChromatogram_(MapType::ChromatogramType & c) override
-    {
-      MapType::ChromatogramType c_out;
-      pp_.pick(c, c_out);
-      c = c_out;
-    }
-
-  private:
-
-    PeakPickerHiRes pp_;
-    std::vector<Int> ms_levels_;
-  };
-
   void registerOptionsAndFlags_() override
   {
     registerInputFile_("in", "<file>", "", "input profile data file ");
@@ -182,17 +146,39 @@ protected:
   ExitCodes doLowMemAlgorithm(const PeakPickerHiRes& pp)
   {
     ///////////////////////////////////
-    // Create the consumer object, add data processing
+    // Create the pipeline: pick in parallel, write sequentially
     ///////////////////////////////////
-    PPHiResMzMLConsumer pp_consumer(out, pp);
-    pp_consumer.addDataProcessing(getProcessingInfo_(DataProcessing::PEAK_PICKING));
+    std::vector<Int> ms_levels = pp.getParameters().getValue("ms_levels").toIntList();
+    MSDataTransformingConsumer picking_consumer;
+    picking_consumer.setSpectraProcessingFunc([&pp, &ms_levels](MSSpectrum& s)
+      {
+        if (!ListUtils::contains(ms_levels, s.getMSLevel())) {return;}
+
+        MSSpectrum sout;
+        pp.pick(s, sout);
+        s = sout;
+      });
+    picking_consumer.setChromatogramProcessingFunc([&pp](MSChromatogram& c)
+      {
+        MSChromatogram c_out;
+        pp.pick(c, c_out);
+        c = c_out;
+      });
+
+    PlainMSDataWritingConsumer writing_consumer(out);
+    writing_consumer.addDataProcessing(getProcessingInfo_(DataProcessing::PEAK_PICKING));
+
+    MSDataPipelineConsumer pipeline;
+    pipeline.appendStage(&picking_consumer, true);
+    pipeline.appendStage(&writing_consumer, false);
 
     ///////////////////////////////////
     // Create new MSDataReader and set our consumer
     ///////////////////////////////////
     MzMLFile mz_data_file;
     mz_data_file.setLogType(log_type_);
-    mz_data_file.transform(in, &pp_consumer);
+    mz_data_file.transform(in, &pipeline);
+    pipeline.flush();
 
     return EXECUTION_OK;
   }
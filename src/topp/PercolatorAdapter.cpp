@@ -42,9 +42,13 @@
 #include <OpenMS/FORMAT/IdXMLFile.h>
 #include <OpenMS/FORMAT/MzIdentMLFile.h>
 #include <OpenMS/FORMAT/OSWFile.h>
+#include <OpenMS/FORMAT/TextFile.h>
 #include <OpenMS/SYSTEM/File.h>
 #include <OpenMS/CONCEPT/Constants.h>
 
+#include <algorithm>
+#include <exception>
+#include <fstream>
 #include <iostream>
 #include <cmath>
 #include <string>
@@ -52,6 +56,11 @@
 //#include <typeinfo>
 
 #include <boost/algorithm/clamp.hpp>
+#include <boost/unordered_map.hpp>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
 
 using namespace OpenMS;
 using namespace std;
@@ -401,135 +410,207 @@ protected:
   }
 
   //id <tab> label <tab> scannr <tab> calcmass <tab> expmass <tab> feature1 <tab> ... <tab> featureN <tab> peptide <tab> proteinId1 <tab> .. <tab> proteinIdM
-  void preparePin_(vector<PeptideIdentification>& peptide_ids, StringList& feature_set, std::string& enz, TextFile& txt, int min_charge, int max_charge)
+  // Rows are formatted in parallel (in blocks of peptide identifications) and
+  // written to @p os in input order, without keeping the whole file in memory.
+  void preparePin_(vector<PeptideIdentification>& peptide_ids, StringList& feature_set, std::string& enz, std::ostream& os, int min_charge, int max_charge)
   {
+    // scan identifiers are assigned sequentially (they may depend on the position and log warnings)
+    vector<String> scan_identifiers(peptide_ids.size());
     for (vector<PeptideIdentification>::iterator it = peptide_ids.begin(); it != peptide_ids.end(); ++it)
     {
-      String scan_identifier = getScanIdentifier_(it, peptide_ids.begin());
-      Int scan_number = getScanNumber_(scan_identifier);
-      
-      double exp_mass = it->getMZ();
-      for (vector<PeptideHit>::const_iterator jt = it->getHits().begin(); jt != it->getHits().end(); ++jt)
+      scan_identifiers[it - peptide_ids.begin()] = getScanIdentifier_(it, peptide_ids.begin());
+    }
+
+    const SignedSize block_size = 10000;
+    vector<String> rows(std::min(Size(block_size), peptide_ids.size()));
+    Size nr_without_evidence = 0;
+    for (SignedSize block_start = 0; block_start < SignedSize(peptide_ids.size()); block_start += block_size)
+    {
+      const SignedSize block_end = std::min(block_start + block_size, SignedSize(peptide_ids.size()));
+      Size err_count = 0;
+      std::exception_ptr err;
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic, 100) reduction(+: nr_without_evidence)
+#endif
+      for (SignedSize i = block_start; i < block_end; ++i)
       {
-        if (jt->getPeptideEvidences().empty())
-        {
-          LOG_WARN << "PSM (PeptideHit) without protein reference found. " 
-                   << "This may indicate incomplete mapping during PeptideIndexing (e.g., wrong enzyme settings)." 
-                   << "Will skip this PSM." << endl;
-          continue;
-        }
-        PeptideHit hit(*jt); // make a copy of the hit to store temporary features
-        hit.setMetaValue("SpecId", scan_identifier);
-        hit.setMetaValue("ScanNr", scan_number);
-        
-        if (!hit.metaValueExists("target_decoy") 
-          || hit.getMetaValue("target_decoy").toString().empty()) 
+        try
         {
-          continue;
+          rows[i - block_start] = preparePinRows_(peptide_ids[i], scan_identifiers[i], feature_set, enz, min_charge, max_charge, nr_without_evidence);
         }
-        
-        int label = 1;
-        if (hit.getMetaValue("target_decoy") == "decoy")
+        catch (...)
         {
-          label = -1;
+#ifdef _OPENMP
+#pragma omp critical (PercolatorAdapter_preparePin)
+#endif
+          {
+            if (err_count++ == 0) err = std::current_exception();
+          }
         }
-        hit.setMetaValue("Label", label);
-        
-        int charge = hit.getCharge();
-        String unmodified_sequence = hit.getSequence().toUnmodifiedString();
-        
-        double calc_mass = hit.getSequence().getMonoWeight(Residue::Full, charge)/charge;
-        hit.setMetaValue("CalcMass", calc_mass);
+      }
+      if (err_count > 0)
+      {
+        std::rethrow_exception(err);
+      }
+      for (SignedSize i = block_start; i < block_end; ++i)
+      {
+        os << rows[i - block_start];
+      }
+    }
+    if (nr_without_evidence > 0)
+    {
+      LOG_WARN << nr_without_evidence << " PSMs (PeptideHits) without protein reference found. "
+               << "This may indicate incomplete mapping during PeptideIndexing (e.g., wrong enzyme settings)." 
+               << "Skipped these PSMs." << endl;
+    }
+  }
 
-        if (hit.metaValueExists("IsotopeError"))  // MSGFPlus
-        {
-          float isoErr = hit.getMetaValue("IsotopeError").toString().toFloat();
-          exp_mass = exp_mass - (isoErr * Constants::C13C12_MASSDIFF_U) / charge;
-        }
-        else if (hit.metaValueExists("isotope_error")) // e.g. SimpleSearchEngine /RNPxlSearch
-        {
-          float isoErr = hit.getMetaValue("isotope_error").toString().toFloat();
-          exp_mass = exp_mass - (isoErr * Constants::C13C12_MASSDIFF_U) / charge;
-        }
-                
-        hit.setMetaValue("ExpMass", exp_mass);
-        hit.setMetaValue("mass", exp_mass);
-        
-        double score = hit.getScore();
-        hit.setMetaValue("score", score);
-        
-        int peptide_length = unmodified_sequence.size();
-        hit.setMetaValue("peplen", peptide_length);
-        
-        for (int i = min_charge; i <= max_charge; ++i)
-        {
-           hit.setMetaValue("charge" + String(i), charge == i);
-        }
+  // Formats the rows of all PSMs of @p pep_id (one line per PSM, each terminated by a newline)
+  String preparePinRows_(const PeptideIdentification& pep_id, const String& scan_identifier, const StringList& feature_set, const std::string& enz, int min_charge, int max_charge, Size& nr_without_evidence)
+  {
+    String rows;
+    std::string enz_copy(enz);
+    Int scan_number = getScanNumber_(scan_identifier);
 
-        // just first peptide evidence
-        char aa_before = hit.getPeptideEvidences().front().getAABefore();
-        char aa_after = hit.getPeptideEvidences().front().getAAAfter();
+    double exp_mass = pep_id.getMZ();
+    for (vector<PeptideHit>::const_iterator jt = pep_id.getHits().begin(); jt != pep_id.getHits().end(); ++jt)
+    {
+      if (jt->getPeptideEvidences().empty())
+      {
+        ++nr_without_evidence;
+        continue;
+      }
+      const PeptideHit& hit = *jt;
+      // features computed here (take precedence over meta values of the hit with the same name)
+      std::map<String, DataValue> computed;
+      computed["SpecId"] = DataValue(scan_identifier);
+      computed["ScanNr"] = DataValue(scan_number);
+      
+      if (!hit.metaValueExists("target_decoy") 
+        || hit.getMetaValue("target_decoy").toString().empty()) 
+      {
+        continue;
+      }
+      
+      int label = 1;
+      if (hit.getMetaValue("target_decoy") == "decoy")
+      {
+        label = -1;
+      }
+      computed["Label"] = DataValue(label);
+      
+      int charge = hit.getCharge();
+      String unmodified_sequence = hit.getSequence().toUnmodifiedString();
+      
+      double calc_mass = hit.getSequence().getMonoWeight(Residue::Full, charge)/charge;
+      computed["CalcMass"] = DataValue(calc_mass);
 
-        bool enzN = isEnz_(aa_before, unmodified_sequence.prefix(1)[0], enz);
-        hit.setMetaValue("enzN", enzN);
-        bool enzC = isEnz_(unmodified_sequence.suffix(1)[0], aa_after, enz);
-        hit.setMetaValue("enzC", enzC);
-        int enzInt = countEnzymatic_(unmodified_sequence, enz);
-        hit.setMetaValue("enzInt", enzInt);
-        
-        double delta_mass = exp_mass - calc_mass;
-        hit.setMetaValue("dm", delta_mass);
-        
-        double abs_delta_mass = abs(delta_mass);
-        hit.setMetaValue("absdm", abs_delta_mass);
-        
-        //peptide
-        String sequence = "";
+      if (hit.metaValueExists("IsotopeError"))  // MSGFPlus
+      {
+        float isoErr = hit.getMetaValue("IsotopeError").toString().toFloat();
+        exp_mass = exp_mass - (isoErr * Constants::C13C12_MASSDIFF_U) / charge;
+      }
+      else if (hit.metaValueExists("isotope_error")) // e.g. SimpleSearchEngine /RNPxlSearch
+      {
+        float isoErr = hit.getMetaValue("isotope_error").toString().toFloat();
+        exp_mass = exp_mass - (isoErr * Constants::C13C12_MASSDIFF_U) / charge;
+      }
+              
+      computed["ExpMass"] = DataValue(exp_mass);
+      computed["mass"] = DataValue(exp_mass);
+      
+      double score = hit.getScore();
+      computed["score"] = DataValue(score);
+      
+      int peptide_length = unmodified_sequence.size();
+      computed["peplen"] = DataValue(peptide_length);
+      
+      for (int i = min_charge; i <= max_charge; ++i)
+      {
+         computed["charge" + String(i)] = DataValue(charge == i);
+      }
 
-        aa_before = aa_before == '[' ? '-' : aa_before;
-        aa_after = aa_after == ']' ? '-' : aa_after;
+      // just first peptide evidence
+      char aa_before = hit.getPeptideEvidences().front().getAABefore();
+      char aa_after = hit.getPeptideEvidences().front().getAAAfter();
 
-        sequence += aa_before;
-        sequence += "."; 
-        sequence += hit.getSequence().toString();
-        sequence += "."; 
-        sequence += aa_after;
-        
-        hit.setMetaValue("Peptide", sequence);
-        
-        //proteinId1
-        StringList proteins;
-        for (vector<PeptideEvidence>::const_iterator kt = hit.getPeptideEvidences().begin(); kt != hit.getPeptideEvidences().end(); ++kt)
+      bool enzN = isEnz_(aa_before, unmodified_sequence.prefix(1)[0], enz_copy);
+      computed["enzN"] = DataValue(enzN);
+      bool enzC = isEnz_(unmodified_sequence.suffix(1)[0], aa_after, enz_copy);
+      computed["enzC"] = DataValue(enzC);
+      int enzInt = countEnzymatic_(unmodified_sequence, enz_copy);
+      computed["enzInt"] = DataValue(enzInt);
+      
+      double delta_mass = exp_mass - calc_mass;
+      computed["dm"] = DataValue(delta_mass);
+      
+      double abs_delta_mass = abs(delta_mass);
+      computed["absdm"] = DataValue(abs_delta_mass);
+      
+      //peptide
+      String sequence = "";
+
+      aa_before = aa_before == '[' ? '-' : aa_before;
+      aa_after = aa_after == ']' ? '-' : aa_after;
+
+      sequence += aa_before;
+      sequence += "."; 
+      sequence += hit.getSequence().toString();
+      sequence += "."; 
+      sequence += aa_after;
+      
+      computed["Peptide"] = DataValue(sequence);
+      
+      //proteinId1
+      StringList proteins;
+      for (vector<PeptideEvidence>::const_iterator kt = hit.getPeptideEvidences().begin(); kt != hit.getPeptideEvidences().end(); ++kt)
+      {
+        proteins.push_back(kt->getProteinAccession());
+      }
+      computed["Proteins"] = DataValue(ListUtils::concatenate(proteins, '\t'));
+      
+      StringList feats;
+      for (vector<String>::const_iterator feat = feature_set.begin(); feat != feature_set.end(); ++feat)
+      {
+      // Some Hits have no NumMatchedMainIons, and MeanError, etc. values. Have to ignore them!
+        std::map<String, DataValue>::const_iterator value = computed.find(*feat);
+        if (value != computed.end())
         {
-          proteins.push_back(kt->getProteinAccession());
+          feats.push_back(value->second.toString());
         }
-        hit.setMetaValue("Proteins", ListUtils::concatenate(proteins, '\t'));
-        
-        StringList feats;
-        for (vector<String>::const_iterator feat = feature_set.begin(); feat != feature_set.end(); ++feat)
+        else if (hit.metaValueExists(*feat))
         {
-        // Some Hits have no NumMatchedMainIons, and MeanError, etc. values. Have to ignore them!
-          if (hit.metaValueExists(*feat))
-          {
-            feats.push_back(hit.getMetaValue(*feat).toString());
-          }
-        }
-        if (feats.size() == feature_set.size())
-        { // only if all feats were present add
-          txt.addLine(ListUtils::concatenate(feats, '\t'));
+          feats.push_back(hit.getMetaValue(*feat).toString());
         }
       }
+      if (feats.size() == feature_set.size())
+      { // only if all feats were present add
+        rows += ListUtils::concatenate(feats, '\t');
+        rows += '\n';
+      }
     }
+    return rows;
   }
   
-  void readPoutAsMap_(String pout_file, std::map<String, PercolatorResult>& pep_map)
+  typedef boost::unordered_map<String, PercolatorResult> PercolatorResultMap;
+  typedef boost::unordered_map<String, PercolatorProteinResult> PercolatorProteinResultMap;
+
+  // reads the file line by line (instead of loading it into memory first)
+  void readPoutAsMap_(String pout_file, PercolatorResultMap& pep_map)
   {
-    CsvFile csv_file(pout_file, '\t');
+    ifstream is(pout_file.c_str(), ios::binary);
+    if (!is)
+    {
+      throw Exception::FileNotFound(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, pout_file);
+    }
+    std::string line;
     StringList row;
 
-    for (Size i = 1; i < csv_file.rowCount(); ++i)
+    TextFile::getLine(is, line); // skip header line
+    while (TextFile::getLine(is, line))
     {
-      csv_file.getRow(i, row);
+      if (line.empty()) continue;
+      String(line).split('\t', row);
       PercolatorResult res(row);
       String spec_ref = res.PSMId + res.peptide;
       writeDebug_("PSM identifier in pout file: " + spec_ref, 10);
@@ -537,12 +618,12 @@ protected:
       // retain only the best result in the unlikely case that a PSMId+peptide combination occurs multiple times
       if (pep_map.find(spec_ref) == pep_map.end())
       {
-        pep_map.insert( map<String, PercolatorResult>::value_type ( spec_ref, res ) );
+        pep_map.insert( PercolatorResultMap::value_type ( spec_ref, res ) );
       }
     }
   }
   
-  void readProteinPoutAsMap_(String pout_protein_file, std::map<String, PercolatorProteinResult>& protein_map)
+  void readProteinPoutAsMap_(String pout_protein_file, PercolatorProteinResultMap& protein_map)
   {
     CsvFile csv_file(pout_protein_file, '\t');
     StringList row;
@@ -556,7 +637,7 @@ protected:
       double posterior_error_prob = row[3].toDouble();
       for (StringList::iterator it = protein_accessions.begin(); it != protein_accessions.end(); ++it) 
       {
-        protein_map.insert( map<String, PercolatorProteinResult>::value_type ( *it, PercolatorProteinResult(*it, qvalue, posterior_error_prob ) ) );
+        protein_map.insert( PercolatorProteinResultMap::value_type ( *it, PercolatorProteinResult(*it, qvalue, posterior_error_prob ) ) );
       }
     }
   }
@@ -909,10 +990,18 @@ protected:
       feature_set.push_back("Proteins");
       
       LOG_DEBUG << "Writing percolator input file." << endl;
-      TextFile txt;  
-      txt.addLine(ListUtils::concatenate(feature_set, '\t'));
-      preparePin_(all_peptide_ids, feature_set, enz_str, txt, min_charge, max_charge);
-      txt.store(pin_file);
+      ofstream pin_stream(pin_file.c_str(), ios::binary);
+      if (!pin_stream)
+      {
+        throw Exception::UnableToCreateFile(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, pin_file);
+      }
+      pin_stream << ListUtils::concatenate(feature_set, '\t') << '\n';
+      preparePin_(all_peptide_ids, feature_set, enz_str, pin_stream, min_charge, max_charge);
+      pin_stream.close();
+      if (!pin_stream)
+      {
+        throw Exception::UnableToCreateFile(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, pin_file);
+      }
     }
     // OSW input
     else
@@ -1010,7 +1099,7 @@ protected:
     //-------------------------------------------------------------
     // when percolator finished calculation, it stores the results -r option (with or without -U) or -m (which seems to be not working)
     //  WARNING: The -r option cannot be used in conjunction with -U: no peptide level statistics are calculated, redirecting PSM level statistics to provided file instead.
-    map<String, PercolatorResult> pep_map;
+    PercolatorResultMap pep_map;
     if (peptide_level_fdrs)
     {
       readPoutAsMap_(pout_target_file_peptides, pep_map);
@@ -1022,7 +1111,7 @@ protected:
       readPoutAsMap_(pout_decoy_file, pep_map);
     }
     
-    map<String, PercolatorProteinResult> protein_map;
+    PercolatorProteinResultMap protein_map;
     if (protein_level_fdrs)
     {
       readProteinPoutAsMap_(pout_target_file_proteins, protein_map);
@@ -1054,7 +1143,7 @@ protected:
           
           writeDebug_("PSM identifier in PeptideHit: " + psm_identifier, 10);        
  
-          map<String, PercolatorResult>::iterator pr = pep_map.find(psm_identifier);
+          PercolatorResultMap::iterator pr = pep_map.find(psm_identifier);
           if (pr != pep_map.end())
           {
             hit->setMetaValue("MS:1001492", pr->second.score);  // svm score
@@ -1106,7 +1195,7 @@ protected:
           for (vector<ProteinHit>::iterator hit = it->getHits().begin(); hit != it->getHits().end(); ++hit)
           {
             String protein_accession = hit->getAccession();        
-            map<String, PercolatorProteinResult>::iterator pr = protein_map.find(protein_accession);
+            PercolatorProteinResultMap::iterator pr = protein_map.find(protein_accession);
             if (pr != protein_map.end())
             {
               hit->setMetaValue("MS:1001491", pr->second.qvalue);  // percolator q value
@@ -1166,13 +1255,22 @@ protected:
     }
     else
     {
-      std::map< std::string, std::vector<double> > features;
+      // visit the results in key order (the hash map is unordered)
+      std::vector<const PercolatorResultMap::value_type*> results;
+      results.reserve(pep_map.size());
       for (auto const &feat : pep_map)
       {
+        results.push_back(&feat);
+      }
+      std::sort(results.begin(), results.end(),
+        [](const PercolatorResultMap::value_type* a, const PercolatorResultMap::value_type* b) { return a->first < b->first; });
 
-        features[feat.second.PSMId].push_back(feat.second.score);
-        features[feat.second.PSMId].push_back(feat.second.qvalue);
-        features[feat.second.PSMId].push_back(feat.second.posterior_error_prob);
+      std::map< std::string, std::vector<double> > features;
+      for (auto const feat : results)
+      {
+        features[feat->second.PSMId].push_back(feat->second.score);
+        features[feat->second.PSMId].push_back(feat->second.qvalue);
+        features[feat->second.PSMId].push_back(feat->second.posterior_error_prob);
       }
       OSWFile().write(out, osw_level, features);
     }
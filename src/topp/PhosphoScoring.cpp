@@ -40,6 +40,8 @@
 #include <OpenMS/ANALYSIS/ID/AScore.h>
 #include <OpenMS/METADATA/SpectrumMetaDataLookup.h>
 
+#include <exception>
+
 using namespace OpenMS;
 using namespace std;
 
@@ -313,28 +315,59 @@ protected:
     SpectrumLookup lookup;
     lookup.readSpectra(exp.getSpectra());
 
-    for (vector<PeptideIdentification>::iterator pep_id = pep_ids.begin(); pep_id != pep_ids.end(); ++pep_id)
+    // AScore sorts unsorted spectra - do this up front, so that the spectra
+    // are not modified while they are scored in parallel
+    for (PeakMap::Iterator spec_it = exp.begin(); spec_it != exp.end(); ++spec_it)
+    {
+      if (!spec_it->isSorted()) spec_it->sortByPosition();
+    }
+
+    // score the peptide IDs in parallel (the results keep the input order)
+    pep_out.resize(pep_ids.size());
+    Size err_count(0);
+    std::exception_ptr err;
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic)
+#endif
+    for (SignedSize i = 0; i < SignedSize(pep_ids.size()); ++i)
     {
-      Size scan_id = lookup.findByRT(pep_id->getRT());
-      PeakSpectrum& temp = exp.getSpectrum(scan_id);
-      
-      vector<PeptideHit> scored_peptides;
-      for (vector<PeptideHit>::const_iterator hit = pep_id->getHits().begin(); hit < pep_id->getHits().end(); ++hit)
+      try
       {
-        PeptideHit scored_hit = *hit;
-        addScoreToMetaValues_(scored_hit, pep_id->getScoreType()); // backup score value
+        const PeptideIdentification& pep_id = pep_ids[i];
+        Size scan_id = lookup.findByRT(pep_id.getRT());
+        PeakSpectrum& temp = exp.getSpectrum(scan_id);
         
-        LOG_DEBUG << "starting to compute AScore RT=" << pep_id->getRT() << " SEQUENCE: " << scored_hit.getSequence().toString() << std::endl;
-        
-        PeptideHit phospho_sites = ascore.compute(scored_hit, temp);
-        scored_peptides.push_back(phospho_sites);
-      }
+        vector<PeptideHit> scored_peptides;
+        for (vector<PeptideHit>::const_iterator hit = pep_id.getHits().begin(); hit < pep_id.getHits().end(); ++hit)
+        {
+          PeptideHit scored_hit = *hit;
+          addScoreToMetaValues_(scored_hit, pep_id.getScoreType()); // backup score value
+          
+          LOG_DEBUG << "starting to compute AScore RT=" << pep_id.getRT() << " SEQUENCE: " << scored_hit.getSequence().toString() << std::endl;
+          
+          PeptideHit phospho_sites = ascore.compute(scored_hit, temp);
+          scored_peptides.push_back(phospho_sites);
+        }
 
-      PeptideIdentification new_pep_id(*pep_id);
-      new_pep_id.setScoreType("PhosphoScore");
-      new_pep_id.setHigherScoreBetter(true);
-      new_pep_id.setHits(scored_peptides);
-      pep_out.push_back(new_pep_id);
+        PeptideIdentification new_pep_id(pep_id);
+        new_pep_id.setScoreType("PhosphoScore");
+        new_pep_id.setHigherScoreBetter(true);
+        new_pep_id.setHits(scored_peptides);
+        pep_out[i] = new_pep_id;
+      }
+      catch (...)
+      {
+#ifdef _OPENMP
+#pragma omp critical (PhosphoScoring_error)
+#endif
+        {
+          if (err_count++ == 0) err = std::current_exception();
+        }
+      }
+    }
+    if (err_count > 0)
+    {
+      std::rethrow_exception(err);
     }
     
     //-------------------------------------------------------------
@@ -526,31 +526,34 @@ protected:
       }
       Size n_peptide = q_it->second.abundances.size();
       out << n_peptide;
-      // make a copy to allow using "operator[]" below:
-      SampleAbundances total_abundances = q_it->second.total_abundances;
+      // look up abundances once per sample (missing values are written as 0):
+      vector<double> total_abundances;
+      total_abundances.reserve(files_.size());
       for (ConsensusMap::ColumnHeaders::iterator file_it = files_.begin();
            file_it != files_.end(); ++file_it)
       {
-        out << total_abundances[file_it->first];
+        SampleAbundances::const_iterator pos =
+          q_it->second.total_abundances.find(file_it->first);
+        total_abundances.push_back(pos != q_it->second.total_abundances.end() ?
+                                   pos->second : 0.0);
+        out << total_abundances.back();
       }
       // if ratios-flag is set, print log2-ratios. ab1/ab0, ab2/ab0, ... , ab'n/ab0
       if (print_ratios)
       {
         double log2 = log(2.0);
-        double ref_abundance = total_abundances[files_.begin()->first];
-        for (ConsensusMap::ColumnHeaders::iterator file_it = files_.begin();
-             file_it != files_.end(); ++file_it)
+        double ref_abundance = total_abundances[0];
+        for (Size i = 0; i < total_abundances.size(); ++i)
         {
-          out << log(total_abundances[file_it->first] / ref_abundance) / log2;
+          out << log(total_abundances[i] / ref_abundance) / log2;
         }
       }
       // if ratiosSILAC-flag is set, print log2-SILACratios. Only if three maps are provided (triple SILAC).
       if (print_SILACratios && files_.size() == 3)
       {
-        ConsensusMap::ColumnHeaders::iterator file_it = files_.begin();
-        double light = total_abundances[file_it->first]; ++file_it;
-        double middle = total_abundances[file_it->first]; ++file_it;
-        double heavy = total_abundances[file_it->first];
+        double light = total_abundances[0];
+        double middle = total_abundances[1];
+        double heavy = total_abundances[2];
         double log2 = log(2.0);
 
         out << log(heavy / light) / log2
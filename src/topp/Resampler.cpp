@@ -137,17 +137,16 @@ protected:
     {
       LinearResampler lin_resampler;
       lin_resampler.setParameters(resampler_param);
+      lin_resampler.setLogType(log_type_);
 
       // resample every scan
-      for (Size i = 0; i < exp.size(); ++i)
-      {
-        lin_resampler.raster(exp[i]);
-      }
+      lin_resampler.rasterExperiment(exp);
     }
     else
     {
       LinearResamplerAlign lin_resampler;
       lin_resampler.setParameters(resampler_param);
+      lin_resampler.setLogType(log_type_);
 
       bool start_pos_set = false;
       bool end_pos_set = false;
@@ -174,10 +173,7 @@ protected:
         start_pos = std::floor(start_pos);
 
         // resample every scan
-        for (Size i = 0; i < exp.size(); ++i)
-        {
-          lin_resampler.raster_align(exp[i], start_pos, end_pos);
-        }
+        lin_resampler.rasterExperiment(exp, start_pos, end_pos);
       }
     }
 
@@ -137,6 +137,12 @@ protected:
     PeakSpectrumCompareFunctor::registerChildren();
     setValidStrings_("compare_function", Factory<PeakSpectrumCompareFunctor>::registeredProducts());
 
+    registerTOPPSubsection_("prefilter", "Candidate prefilter options");
+    registerIntOption_("prefilter:top_n", "<num>", 0, "Only score the <num> library spectra in the precursor window that share the most binned peaks with the query spectrum (0 = score all candidates).", false, true);
+    setMinInt_("prefilter:top_n", 0);
+    registerDoubleOption_("prefilter:bin_size", "<Th>", BinnedSpectrum::DEFAULT_BIN_WIDTH_LOWRES, "Bin width used to count shared peaks.", false, true);
+    setMinFloat_("prefilter:bin_size", 0.0001);
+
     registerTOPPSubsection_("report", "Reporting Options");
     registerIntOption_("report:top_hits", "<num>", 10, "Maximum number of top scoring hits per spectrum that are reported.", false, true);
 
@@ -160,8 +166,39 @@ protected:
     addEmptyLine_();
   }
 
-  using MapLibraryPrecursorToLibrarySpectrum = multimap<double, PeakSpectrum>;
-    
+  /// library spectra sorted by precursor m/z (stable, i.e. in library order for equal m/z)
+  using MapLibraryPrecursorToLibrarySpectrum = vector<pair<double, PeakSpectrum> >;
+
+  static bool precursorLess_(const pair<double, PeakSpectrum>& a, const pair<double, PeakSpectrum>& b)
+  {
+    return a.first < b.first;
+  }
+
+  /// number of bins occupied in both binned spectra
+  static Size countSharedBins_(const BinnedSpectrum& a, const BinnedSpectrum& b)
+  {
+    Size shared = 0;
+    BinnedSpectrum::SparseVectorIteratorType it_a(a.getBins()), it_b(b.getBins());
+    while (it_a && it_b)
+    {
+      if (it_a.index() < it_b.index())
+      {
+        ++it_a;
+      }
+      else if (it_b.index() < it_a.index())
+      {
+        ++it_b;
+      }
+      else
+      {
+        ++shared;
+        ++it_a;
+        ++it_b;
+      }
+    }
+    return shared;
+  }
+
   MapLibraryPrecursorToLibrarySpectrum annotateIdentificationsToSpectra_(const vector<PeptideIdentification>& ids, 
     const PeakMap& library, 
     StringList variable_modifications, 
@@ -260,8 +297,9 @@ protected:
            lib_entry.push_back(peak);
          }
        }
-       annotated_lib.insert(make_pair(precursor_MZ, lib_entry));
+       annotated_lib.push_back(make_pair(precursor_MZ, lib_entry));
      }
+    std::stable_sort(annotated_lib.begin(), annotated_lib.end(), precursorLess_);
     return annotated_lib;
   }
 
@@ -297,6 +335,9 @@ protected:
     StringList fixed_modifications = getStringList_("modifications:fixed");
     StringList variable_modifications = getStringList_("modifications:variable");
 
+    Size prefilter_top_n = getIntOption_("prefilter:top_n");
+    float prefilter_bin_size = getDoubleOption_("prefilter:bin_size");
+
     if (top_hits < -1)
     {
       writeLog_("top_hits (should be  >= -1 )");
@@ -351,6 +392,20 @@ protected:
 
     MapLibraryPrecursorToLibrarySpectrum mslib = annotateIdentificationsToSpectra_(ids, library, variable_modifications, fixed_modifications, remove_peaks_below_threshold);
 
+    // binned library spectra for the shared peak prefilter
+    vector<BinnedSpectrum> mslib_binned;
+    if (prefilter_top_n > 0)
+    {
+      mslib_binned.resize(mslib.size());
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic, 100)
+#endif
+      for (SignedSize i = 0; i < (SignedSize)mslib.size(); ++i)
+      {
+        mslib_binned[i] = BinnedSpectrum(mslib[i].second, prefilter_bin_size, false, 0, BinnedSpectrum::DEFAULT_BIN_OFFSET_LOWRES);
+      }
+    }
+
     time_t end_build_time = time(nullptr);
     LOG_INFO << "Time needed for preprocessing data: " << (end_build_time - start_build_time) << "\n";
 
@@ -360,7 +415,6 @@ protected:
    //-------------------------------------------------------------
     // calculations
     //-------------------------------------------------------------
-    double score;
     StringList::iterator in, out_file;
     for (in  = in_spec.begin(), out_file  = out.begin(); in < in_spec.end(); ++in, ++out_file)
     {
@@ -400,179 +454,249 @@ protected:
       /***********SEARCH**********/
       for (UInt j = 0; j < query.size(); ++j)
       {
-        //Set identifier for each identifications
-        PeptideIdentification pid;
-        pid.setIdentifier("test");
-        pid.setScoreType(compare_function);
         ProteinHit pr_hit;
         pr_hit.setAccession(j);
         prot_id.insertHit(pr_hit);
+      }
 
-        // proper MS2?
-        if (query[j].empty() || query[j].getMSLevel() != 2) {continue; }
-
-        if (query[j].getPrecursors().empty())
+      // query spectra are searched independently (and in parallel), results are reported in query order
+      vector<PeptideIdentification> query_ids(query.size());
+      vector<char> has_id(query.size(), false);
+      Size err_count = 0;
+      std::exception_ptr err;
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic)
+#endif
+      for (SignedSize j = 0; j < (SignedSize)query.size(); ++j)
+      {
+        if (err_count) continue;
+        try
         {
-          writeLog_("Warning MS2 spectrum without precursor information");
-          continue;
-        }
+          //Set identifier for each identifications
+          PeptideIdentification& pid = query_ids[j];
+          pid.setIdentifier("test");
+          pid.setScoreType(compare_function);
+          const String accession(j);
 
-        // filter query spectrum
-        double max_intensity = std::max_element(query[j].begin(), query[j].end(), 
-                                [](const Peak1D& l, const Peak1D& r) 
-                                { 
-                                  return (l.getIntensity() < r.getIntensity()); 
-                                })->getIntensity();
+          // proper MS2?
+          if (query[j].empty() || query[j].getMSLevel() != 2) {continue; }
 
-        double min_high_intensity = max_intensity / cut_peaks_below;
+          if (query[j].getPrecursors().empty())
+          {
+#ifdef _OPENMP
+#pragma omp critical (SpecLibSearcher_log)
+#endif
+            writeLog_("Warning MS2 spectrum without precursor information");
+            continue;
+          }
 
-        PeakSpectrum filtered_query;
-        for (UInt k = 0; k < query[j].size(); ++k)
-        {
-          if (query[j][k].getIntensity() >= remove_peaks_below_threshold 
-           && query[j][k].getIntensity() >= min_high_intensity)
+          // filter query spectrum
+          double max_intensity = std::max_element(query[j].begin(), query[j].end(), 
+                                  [](const Peak1D& l, const Peak1D& r) 
+                                  { 
+                                    return (l.getIntensity() < r.getIntensity()); 
+                                  })->getIntensity();
+
+          double min_high_intensity = max_intensity / cut_peaks_below;
+
+          PeakSpectrum filtered_query;
+          for (UInt k = 0; k < query[j].size(); ++k)
+          {
+            if (query[j][k].getIntensity() >= remove_peaks_below_threshold 
+             && query[j][k].getIntensity() >= min_high_intensity)
+            {
+              Peak1D peak;
+              peak.setIntensity(sqrt(query[j][k].getIntensity()));
+              peak.setMZ(query[j][k].getMZ());
+              filtered_query.push_back(peak);
+            }
+          }
+
+          // retain only top N peaks
+          if (filtered_query.size() > max_peaks)
           {
-            Peak1D peak;
-            peak.setIntensity(sqrt(query[j][k].getIntensity()));
-            peak.setMZ(query[j][k].getMZ());
-            filtered_query.push_back(peak);
+            filtered_query.sortByIntensity(true);
+            filtered_query.resize(max_peaks);
+            filtered_query.sortByPosition();
           }
-        }
 
-        // retain only top N peaks
-        if (filtered_query.size() > max_peaks)
-        {
-          filtered_query.sortByIntensity(true);
-          filtered_query.resize(max_peaks);
-          filtered_query.sortByPosition();
-        }
+          if (filtered_query.size() < min_peaks) { continue; }
 
-        if (filtered_query.size() < min_peaks) { continue; }
+          // binned query for the prefilter, computed on demand
+          BinnedSpectrum binned_query;
 
-        const double& query_rt = query[j].getRT();
-        const int& query_charge = query[j].getPrecursors()[0].getCharge();
-        const double query_mz = query[j].getPrecursors()[0].getMZ();
+          const double& query_rt = query[j].getRT();
+          const int& query_charge = query[j].getPrecursors()[0].getCharge();
+          const double query_mz = query[j].getPrecursors()[0].getMZ();
         
-        if (query_charge > 0 && (query_charge < pc_min_charge || query_charge > pc_max_charge)) { continue; } 
+          if (query_charge > 0 && (query_charge < pc_min_charge || query_charge > pc_max_charge)) { continue; } 
 
-        for (auto const & iso : isotopes)
-        {
-          // isotopic misassignment corrected query
-          const double ic_query_mz = query_mz - iso * Constants::C13C12_MASSDIFF_U;
+          for (auto const & iso : isotopes)
+          {
+            // isotopic misassignment corrected query
+            const double ic_query_mz = query_mz - iso * Constants::C13C12_MASSDIFF_U;
 
-          // if tolerance unit is ppm convert to m/z
-          const double precursor_mass_tolerance_mz = precursor_mass_tolerance_unit_ppm ? ic_query_mz * precursor_mass_tolerance * 1e-6 : precursor_mass_tolerance;
+            // if tolerance unit is ppm convert to m/z
+            const double precursor_mass_tolerance_mz = precursor_mass_tolerance_unit_ppm ? ic_query_mz * precursor_mass_tolerance * 1e-6 : precursor_mass_tolerance;
 
-          // skip matching of isotopic misassignments if charge not annotated
-          if (iso != 0 && query_charge == 0) { continue; }
+            // skip matching of isotopic misassignments if charge not annotated
+            if (iso != 0 && query_charge == 0) { continue; }
 
-          // skip matching of isotopic misassignments if search windows around isotopic peaks would overlap (resulting in more than one report of the same hit)
-          const double isotopic_peak_distance_mz = Constants::C13C12_MASSDIFF_U / query_charge;
-          if (iso != 0 && precursor_mass_tolerance_mz >= 0.5 * isotopic_peak_distance_mz) { continue; }
+            // skip matching of isotopic misassignments if search windows around isotopic peaks would overlap (resulting in more than one report of the same hit)
+            const double isotopic_peak_distance_mz = Constants::C13C12_MASSDIFF_U / query_charge;
+            if (iso != 0 && precursor_mass_tolerance_mz >= 0.5 * isotopic_peak_distance_mz) { continue; }
 
-          /* TODO: remove old code for charge estimation?
-          bool charge_one = false;
-          Int percent = (Int) Math::round((query[j].size() / 100.0) * 3.0);
-          Int margin  = (Int) Math::round((query[j].size() / 100.0) * 1.0);
-          for (vector<Peak1D>::iterator peak = query[j].end() - 1; percent >= 0; --peak, --percent)
-          {
-            if (peak->getMZ() < query_MZ)
+            /* TODO: remove old code for charge estimation?
+            bool charge_one = false;
+            Int percent = (Int) Math::round((query[j].size() / 100.0) * 3.0);
+            Int margin  = (Int) Math::round((query[j].size() / 100.0) * 1.0);
+            for (vector<Peak1D>::iterator peak = query[j].end() - 1; percent >= 0; --peak, --percent)
             {
-              break;
+              if (peak->getMZ() < query_MZ)
+              {
+                break;
+              }
             }
-          }
-          if (percent > margin)
-          {
-            charge_one = true;
-          }
-          */
+            if (percent > margin)
+            {
+              charge_one = true;
+            }
+            */
 
 
-          // determine MS2 precursors that match to the current peptide mass
-          MapLibraryPrecursorToLibrarySpectrum::const_iterator low_it, up_it;
+            // determine MS2 precursors that match to the current peptide mass
+            MapLibraryPrecursorToLibrarySpectrum::const_iterator low_it, up_it;
         
-          low_it = mslib.lower_bound(ic_query_mz - 0.5 * precursor_mass_tolerance_mz);
-          up_it = mslib.upper_bound(ic_query_mz + 0.5 * precursor_mass_tolerance_mz);
+            low_it = std::lower_bound(mslib.begin(), mslib.end(), make_pair(ic_query_mz - 0.5 * precursor_mass_tolerance_mz, PeakSpectrum()), precursorLess_);
+            up_it = std::upper_bound(mslib.begin(), mslib.end(), make_pair(ic_query_mz + 0.5 * precursor_mass_tolerance_mz, PeakSpectrum()), precursorLess_);
         
-          // no matching precursor in data
-          if (low_it == up_it) { continue; }
-       
-          for (; low_it != up_it; ++low_it)
-          {
-            const PeakSpectrum& lib_spec = low_it->second;;
-            PeptideHit hit = lib_spec.getPeptideIdentifications()[0].getHits()[0];
-            const int& lib_charge = hit.getCharge();  
-
-            // check if charge state between library and experimental spectrum match
-            if (query_charge > 0 && lib_charge != query_charge) { continue; }
+            // no matching precursor in data
+            if (low_it == up_it) { continue; }
 
-            // Special treatment for SpectraST score as it computes a score based on the whole library
-            if (compare_function == "SpectraSTSimilarityScore")
+            // candidates (indices into the library) that get scored
+            vector<Size> candidates;
+            for (MapLibraryPrecursorToLibrarySpectrum::const_iterator it = low_it; it != up_it; ++it)
             {
-              SpectraSTSimilarityScore* sp = static_cast<SpectraSTSimilarityScore*>(comparor);
-              BinnedSpectrum quer_bin_spec = sp->transform(filtered_query);
-              BinnedSpectrum lib_bin_spec = sp->transform(lib_spec);
-              score = (*sp)(filtered_query, lib_spec); //(*sp)(quer_bin,librar_bin);
-              double dot_bias = sp->dot_bias(quer_bin_spec, lib_bin_spec, score);
-              hit.setMetaValue("DOTBIAS", dot_bias);
+              candidates.push_back(it - mslib.begin());
             }
-            else
+
+            // keep only the top N candidates with most shared peaks (ties in library order)
+            if (prefilter_top_n > 0 && candidates.size() > prefilter_top_n)
             {
-              score = (*comparor)(filtered_query, lib_spec);
+              if (binned_query.getBins().nonZeros() == 0)
+              {
+                binned_query = BinnedSpectrum(filtered_query, prefilter_bin_size, false, 0, BinnedSpectrum::DEFAULT_BIN_OFFSET_LOWRES);
+              }
+              vector<pair<Size, Size> > shared; // (shared peaks, candidate)
+              for (Size c : candidates)
+              {
+                shared.push_back(make_pair(countSharedBins_(binned_query, mslib_binned[c]), c));
+              }
+              std::stable_sort(shared.begin(), shared.end(), [](const pair<Size, Size>& a, const pair<Size, Size>& b) { return a.first > b.first; });
+              shared.resize(prefilter_top_n);
+              candidates.clear();
+              for (const pair<Size, Size>& sc : shared)
+              {
+                candidates.push_back(sc.second);
+              }
+              std::sort(candidates.begin(), candidates.end());
             }
+       
+            for (Size c : candidates)
+            {
+              const PeakSpectrum& lib_spec = mslib[c].second;
+              PeptideHit hit = lib_spec.getPeptideIdentifications()[0].getHits()[0];
+              const int& lib_charge = hit.getCharge();  
+              double score;
+
+              // check if charge state between library and experimental spectrum match
+              if (query_charge > 0 && lib_charge != query_charge) { continue; }
+
+              // Special treatment for SpectraST score as it computes a score based on the whole library
+              if (compare_function == "SpectraSTSimilarityScore")
+              {
+                SpectraSTSimilarityScore* sp = static_cast<SpectraSTSimilarityScore*>(comparor);
+                BinnedSpectrum quer_bin_spec = sp->transform(filtered_query);
+                BinnedSpectrum lib_bin_spec = sp->transform(lib_spec);
+                score = (*sp)(filtered_query, lib_spec); //(*sp)(quer_bin,librar_bin);
+                double dot_bias = sp->dot_bias(quer_bin_spec, lib_bin_spec, score);
+                hit.setMetaValue("DOTBIAS", dot_bias);
+              }
+              else
+              {
+                score = (*comparor)(filtered_query, lib_spec);
+              }
 
-            DataValue RT(lib_spec.getRT());
-            DataValue MZ(lib_spec.getPrecursors()[0].getMZ());
-            hit.setMetaValue("lib:RT", RT);
-            hit.setMetaValue("lib:MZ", MZ);
-            hit.setMetaValue("isotope_error", iso);
-            hit.setScore(score);
-            PeptideEvidence pe;
-            pe.setProteinAccession(pr_hit.getAccession());
-            hit.addPeptideEvidence(pe);
-            pid.insertHit(hit);
+              DataValue RT(lib_spec.getRT());
+              DataValue MZ(lib_spec.getPrecursors()[0].getMZ());
+              hit.setMetaValue("lib:RT", RT);
+              hit.setMetaValue("lib:MZ", MZ);
+              hit.setMetaValue("isotope_error", iso);
+              hit.setScore(score);
+              PeptideEvidence pe;
+              pe.setProteinAccession(accession);
+              hit.addPeptideEvidence(pe);
+              pid.insertHit(hit);
+            }
           }
-        }
 
-        pid.setHigherScoreBetter(true);
-        pid.sort();
+          pid.setHigherScoreBetter(true);
+          pid.sort();
 
-        if (compare_function == "SpectraSTSimilarityScore")
-        {
-          if (!pid.empty() && !pid.getHits().empty())
+          if (compare_function == "SpectraSTSimilarityScore")
           {
-            vector<PeptideHit> final_hits;
-            final_hits.resize(pid.getHits().size());
-            SpectraSTSimilarityScore* sp = static_cast<SpectraSTSimilarityScore*>(comparor);
-            Size runner_up = 1;
-            for (; runner_up < pid.getHits().size(); ++runner_up)
+            if (!pid.empty() && !pid.getHits().empty())
             {
-              if (pid.getHits()[0].getSequence().toUnmodifiedString() != pid.getHits()[runner_up].getSequence().toUnmodifiedString() 
-               || runner_up > 5)
+              vector<PeptideHit> final_hits;
+              final_hits.resize(pid.getHits().size());
+              SpectraSTSimilarityScore* sp = static_cast<SpectraSTSimilarityScore*>(comparor);
+              Size runner_up = 1;
+              for (; runner_up < pid.getHits().size(); ++runner_up)
               {
-                break;
+                if (pid.getHits()[0].getSequence().toUnmodifiedString() != pid.getHits()[runner_up].getSequence().toUnmodifiedString() 
+                 || runner_up > 5)
+                {
+                  break;
+                }
               }
+              double delta_D = sp->delta_D(pid.getHits()[0].getScore(), pid.getHits()[runner_up].getScore());
+              for (Size s = 0; s < pid.getHits().size(); ++s)
+              {
+                final_hits[s] = pid.getHits()[s];
+                final_hits[s].setMetaValue("delta D", delta_D);
+                final_hits[s].setMetaValue("dot product", pid.getHits()[s].getScore());
+                final_hits[s].setScore(sp->compute_F(pid.getHits()[s].getScore(), delta_D, pid.getHits()[s].getMetaValue("DOTBIAS")));
+              }
+              pid.setHits(final_hits);
+              pid.sort();
+              pid.setMZ(query[j].getPrecursors()[0].getMZ());
+              pid.setRT(query_rt);
             }
-            double delta_D = sp->delta_D(pid.getHits()[0].getScore(), pid.getHits()[runner_up].getScore());
-            for (Size s = 0; s < pid.getHits().size(); ++s)
-            {
-              final_hits[s] = pid.getHits()[s];
-              final_hits[s].setMetaValue("delta D", delta_D);
-              final_hits[s].setMetaValue("dot product", pid.getHits()[s].getScore());
-              final_hits[s].setScore(sp->compute_F(pid.getHits()[s].getScore(), delta_D, pid.getHits()[s].getMetaValue("DOTBIAS")));
-            }
-            pid.setHits(final_hits);
-            pid.sort();
-            pid.setMZ(query[j].getPrecursors()[0].getMZ());
-            pid.setRT(query_rt);
           }
-        }
 
-        if (top_hits != -1 && (UInt)top_hits < pid.getHits().size())
+          if (top_hits != -1 && (UInt)top_hits < pid.getHits().size())
+          {
+            pid.getHits().resize(top_hits);
+          }
+          has_id[j] = true;
+        }
+        catch (...)
         {
-          pid.getHits().resize(top_hits);
+#ifdef _OPENMP
+#pragma omp critical (SpecLibSearcher_error)
+#endif
+          {
+            if (err_count++ == 0) err = std::current_exception();
+          }
         }
-        peptide_ids.push_back(pid);
+      }
+      if (err_count > 0)
+      {
+        std::rethrow_exception(err);
+      }
+      for (Size j = 0; j < query.size(); ++j)
+      {
+        if (has_id[j]) peptide_ids.push_back(query_ids[j]);
       }
       protein_ids.push_back(prot_id);
 
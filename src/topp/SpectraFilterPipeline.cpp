@@ -0,0 +1,174 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2018.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: Timo Sachsenberg $
+// $Authors: Timo Sachsenberg $
+// --------------------------------------------------------------------------
+
+#include <OpenMS/APPLICATIONS/TOPPBase.h>
+#include <OpenMS/FILTERING/TRANSFORMERS/SpectraFilterPipeline.h>
+#include <OpenMS/FORMAT/MzMLFile.h>
+
+using namespace OpenMS;
+using namespace std;
+
+/**
+  @page TOPP_SpectraFilterPipeline SpectraFilterPipeline
+
+  @brief Applies several spectrum filters in a single pass over the data
+
+  <CENTER>
+  <table>
+  <tr>
+  <td ALIGN = "center" BGCOLOR="#EBEBEB"> pot. predecessor tools </td>
+  <td VALIGN="middle" ROWSPAN=2> \f$ \longrightarrow \f$ SpectraFilter \f$ \longrightarrow \f$</td>
+  <td ALIGN = "center" BGCOLOR="#EBEBEB"> pot. successor tools </td>
+  </tr>
+  <tr>
+  <td VALIGN="middle" ALIGN = "center" ROWSPAN=1> @ref TOPP_PeakPickerWavelet </td>
+  <td VALIGN="middle" ALIGN = "center" ROWSPAN=1> any tool operating on MS peak data @n (in mzML format)</td>
+  </tr>
+  </table>
+  </CENTER>
+
+  The filters given by @p filters are applied to each spectrum in the given
+  order (a filter may be given more than once). This yields the same result
+  as a chain of the corresponding SpectraFilter* tools, but the data is only
+  loaded and stored once. The parameters of the filters are set in the
+  subsection of the same name.
+
+  <B>The command line parameters of this tool are:</B>
+  @verbinclude TOPP_SpectraFilterPipeline.cli
+  <B>INI file documentation of this tool:</B>
+  @htmlinclude TOPP_SpectraFilterPipeline.html
+*/
+
+
+// We do not want this class to show up in the docu:
+/// @cond TOPPCLASSES
+
+class TOPPSpectraFilterPipeline :
+  public TOPPBase
+{
+public:
+  TOPPSpectraFilterPipeline() :
+    TOPPBase("SpectraFilterPipeline", "Applies several spectrum filters in a single pass.")
+  {
+  }
+
+protected:
+
+  void registerOptionsAndFlags_() override
+  {
+    registerInputFile_("in", "<file>", "", "input file ");
+    setValidFormats_("in", ListUtils::create<String>("mzML"));
+    registerOutputFile_("out", "<file>", "", "output file ");
+    setValidFormats_("out", ListUtils::create<String>("mzML"));
+    registerStringList_("filters", "<names>", StringList(), "Filters to apply, in order of application.");
+    setValidStrings_("filters", SpectraFilterPipeline::getFilterNames());
+
+    // register one section for each filter with parameters
+    StringList names = SpectraFilterPipeline::getFilterNames();
+    for (Size i = 0; i < names.size(); ++i)
+    {
+      if (!SpectraFilterPipeline::getFilterDefaults(names[i]).empty())
+      {
+        registerSubsection_(names[i], "Parameters of the " + names[i] + " filter.");
+      }
+    }
+  }
+
+  Param getSubsectionDefaults_(const String & section) const override
+  {
+    return SpectraFilterPipeline::getFilterDefaults(section);
+  }
+
+  ExitCodes main_(int, const char **) override
+  {
+    //-------------------------------------------------------------
+    // parameter handling
+    //-------------------------------------------------------------
+
+    //input/output files
+    String in(getStringOption_("in"));
+    String out(getStringOption_("out"));
+    StringList filters = getStringList_("filters");
+
+    SpectraFilterPipeline pipeline;
+    for (Size i = 0; i < filters.size(); ++i)
+    {
+      Param filter_param = getParam_().copy(filters[i] + ":", true);
+      writeDebug_("Used " + filters[i] + " parameters", filter_param, 3);
+      pipeline.addFilter(filters[i], filter_param);
+    }
+
+    //-------------------------------------------------------------
+    // loading input
+    //-------------------------------------------------------------
+
+    PeakMap exp;
+    MzMLFile f;
+    f.setLogType(log_type_);
+    f.load(in, exp);
+
+    //-------------------------------------------------------------
+    // if meta data arrays are present, remove them and warn
+    //-------------------------------------------------------------
+    if (exp.clearMetaDataArrays())
+    {
+      writeLog_("Warning: Spectrum meta data arrays cannot be sorted. They are deleted.");
+    }
+
+    //-------------------------------------------------------------
+    // filter
+    //-------------------------------------------------------------
+    pipeline.filterPeakMap(exp);
+
+    //-------------------------------------------------------------
+    // writing output
+    //-------------------------------------------------------------
+
+    //annotate output with data processing info
+    addDataProcessing_(exp, getProcessingInfo_(DataProcessing::FILTERING));
+
+    f.store(out, exp);
+
+    return EXECUTION_OK;
+  }
+
+};
+
+int main(int argc, const char ** argv)
+{
+  TOPPSpectraFilterPipeline tool;
+  return tool.main(argc, argv);
+}
+
+/// @endcond
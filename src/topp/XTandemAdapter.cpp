@@ -34,6 +34,7 @@
 
 #include <OpenMS/APPLICATIONS/TOPPBase.h>
 
+#include <OpenMS/ANALYSIS/ID/SearchEngineChunks.h>
 #include <OpenMS/CHEMISTRY/ProteaseDB.h>
 #include <OpenMS/CHEMISTRY/ModificationDefinitionsSet.h>
 #include <OpenMS/CHEMISTRY/ModificationsDB.h>
@@ -45,6 +46,7 @@
 #include <OpenMS/FORMAT/XTandemXMLFile.h>
 #include <OpenMS/KERNEL/StandardTypes.h>
 #include <OpenMS/METADATA/SpectrumLookup.h>
+#include <OpenMS/SYSTEM/ExecutionResources.h>
 #include <OpenMS/SYSTEM/File.h>
 
 #include <fstream>
@@ -178,6 +180,9 @@ protected:
     setValidStrings_("output_results", valid_strings);
 
     registerDoubleOption_("max_valid_expect", "<value>", 0.1, "Maximal E-Value of a hit to be reported (only evaluated if 'output_result' is 'valid' or 'stochastic')", false);
+
+    registerIntOption_("chunks", "<number>", 1, "Split the spectra into this many chunks and search them with as many X! Tandem instances at the same time, each using its share of the threads (X! Tandem does not scale to many threads). Cannot be combined with 'xml_out'.", false, true);
+    setMinInt_("chunks", 1);
   }
 
   ExitCodes main_(int, const char**) override
@@ -197,9 +202,6 @@ protected:
 
     // write input xml file
     String temp_directory = makeAutoRemoveTempDirectory_();
-    String input_filename = temp_directory + "tandem_input.xml";
-    String tandem_input_filename = in;
-    String tandem_output_filename = temp_directory + "tandem_output.xml";
     String tandem_taxonomy_filename = temp_directory + "tandem_taxonomy.xml";
 
     //-------------------------------------------------------------
@@ -244,6 +246,25 @@ protected:
       }
     }
 
+    // search the whole input with one X! Tandem instance or chunks of it with several instances at the same time
+    Size nr_chunks = SearchEngineChunks::getNumberOfChunks(getIntOption_("chunks"), exp.size());
+    if (nr_chunks > 1 && !xml_out.empty())
+    {
+      writeLog_("Fatal error: the raw X! Tandem output ('xml_out') cannot be written if the search is split into chunks ('chunks')");
+      return ILLEGAL_PARAMETERS;
+    }
+    vector<String> tandem_input_filenames(1, in);
+    if (nr_chunks > 1)
+    {
+      vector<PeakMap> chunks = SearchEngineChunks::split(exp, nr_chunks);
+      tandem_input_filenames.resize(nr_chunks);
+      for (Size i = 0; i < nr_chunks; ++i)
+      {
+        tandem_input_filenames[i] = temp_directory + "chunk_" + String(i) + ".mzML";
+        mzml_file.store(tandem_input_filenames[i], chunks[i]);
+      }
+    }
+
     ofstream tax_out(tandem_taxonomy_filename.c_str());
     tax_out << "<?xml version=\"1.0\"?>" << "\n";
     tax_out << "\t<bioml label=\"x! taxon-to-file matching list\">" << "\n";
@@ -257,8 +278,6 @@ protected:
     //  Prepare the XML configuration file
     //
     XTandemInfile infile;
-    infile.setInputFilename(tandem_input_filename);
-    infile.setOutputFilename(tandem_output_filename);
     infile.setTaxonomyFilename(tandem_taxonomy_filename); // contains the FASTA name
 
     if (getStringOption_("precursor_error_units") == "Da")
@@ -284,7 +303,7 @@ protected:
     infile.setPrecursorMassToleranceMinus(precursor_mass_tolerance);
     infile.setFragmentMassTolerance(getDoubleOption_("fragment_mass_tolerance"));
     infile.setMaxPrecursorCharge(getIntOption_("max_precursor_charge"));
-    infile.setNumberOfThreads(getIntOption_("threads"));
+    infile.setNumberOfThreads(SearchEngineChunks::getThreadsPerChunk(nr_chunks, ExecutionResources::getThreads()));
     infile.setModifications(ModificationDefinitionsSet(getStringList_("fixed_modifications"), getStringList_("variable_modifications")));
     infile.setTaxon("OpenMS_dummy_taxonomy");
     String output_results = getStringOption_("output_results");
@@ -305,31 +324,50 @@ protected:
       infile.setDefaultParametersFilename(default_XML_config);
     }
 
-    infile.write(input_filename, getFlag_("ignore_adapter_param"),
-                 getFlag_("force"));
+    // one configuration file (with its own output file) per X! Tandem instance
+    vector<String> tandem_output_filenames(nr_chunks);
+    vector<QStringList> arguments(nr_chunks);
+    for (Size i = 0; i < nr_chunks; ++i)
+    {
+      String suffix = (nr_chunks > 1 ? "_" + String(i) : "");
+      String input_filename = temp_directory + "tandem_input" + suffix + ".xml";
+      tandem_output_filenames[i] = temp_directory + "tandem_output" + suffix + ".xml";
+      infile.setInputFilename(tandem_input_filenames[i]);
+      infile.setOutputFilename(tandem_output_filenames[i]);
+      infile.write(input_filename, getFlag_("ignore_adapter_param"),
+                   getFlag_("force"));
+      arguments[i] = QStringList(input_filename.toQString());
+    }
 
     //-------------------------------------------------------------
     // calculations
     //-------------------------------------------------------------
 
     String xtandem_executable(getStringOption_("xtandem_executable"));
-    TOPPBase::ExitCodes exit_code = runExternalProcess_(xtandem_executable.toQString(), QStringList(input_filename.toQString())); // does automatic escaping etc...
+    TOPPBase::ExitCodes exit_code = runExternalProcesses_(xtandem_executable.toQString(), arguments, nr_chunks); // does automatic escaping etc...
     if (exit_code != EXECUTION_OK)
     {
       return exit_code;
     }
 
-    vector<ProteinIdentification> protein_ids;
-    ProteinIdentification protein_id;
     StringList ms_runs;
     exp.getPrimaryMSRunPath(ms_runs);
-    protein_id.setPrimaryMSRunPath(ms_runs);
-    vector<PeptideIdentification> peptide_ids;
 
-    // read the output of X! Tandem and write it to idXML
+    // read the output of X! Tandem (of all instances) and write it to idXML
     XTandemXMLFile tandem_output;
     ModificationDefinitionsSet mod_def_set(getStringList_("fixed_modifications"), getStringList_("variable_modifications"));
-    tandem_output.load(tandem_output_filename, protein_id, peptide_ids, mod_def_set);
+    vector<vector<ProteinIdentification> > chunk_protein_ids(nr_chunks, vector<ProteinIdentification>(1));
+    vector<vector<PeptideIdentification> > chunk_peptide_ids(nr_chunks);
+    for (Size i = 0; i < nr_chunks; ++i)
+    {
+      chunk_protein_ids[i][0].setPrimaryMSRunPath(ms_runs);
+      tandem_output.load(tandem_output_filenames[i], chunk_protein_ids[i][0], chunk_peptide_ids[i], mod_def_set);
+    }
+    vector<ProteinIdentification> merged_protein_ids;
+    vector<PeptideIdentification> peptide_ids;
+    SearchEngineChunks::merge(chunk_protein_ids, chunk_peptide_ids, merged_protein_ids, peptide_ids);
+    ProteinIdentification protein_id = merged_protein_ids[0];
+    vector<ProteinIdentification> protein_ids;
 
     // add RT and precursor m/z to the peptide IDs (look them up in the spectra):
     SpectrumLookup lookup;
@@ -359,7 +397,7 @@ protected:
 
     if (!xml_out.empty())
     { // move the temporary file to the actual destination:
-      if (!File::rename(tandem_output_filename, xml_out))
+      if (!File::rename(tandem_output_filenames[0], xml_out))
       {
         return CANNOT_WRITE_OUTPUT_FILE;
       }
@@ -92,6 +92,7 @@ SpectraFilterMarkerMower
 SpectraFilterNLargest
 SpectraFilterNormalizer
 SpectraFilterParentPeakMower
+SpectraFilterPipeline
 SpectraFilterScaler
 SpectraFilterSqrtMower
 SpectraFilterThresholdMower
@@ -41,6 +41,11 @@
 #include <OpenMS/ANALYSIS/OPENSWATH/MRMDecoy.h>
 #include <OpenMS/CHEMISTRY/DigestionEnzyme.h>
 #include <OpenMS/APPLICATIONS/TOPPBase.h>
+#include <OpenMS/DATASTRUCTURES/FASTAContainer.h>
+
+#include <boost/random/mersenne_twister.hpp>
+
+#include <exception>
 
 
 using namespace OpenMS;
@@ -72,6 +77,9 @@ using namespace std;
 
   The tool will keep track of all protein identifiers and report duplicates.
 
+  The input is processed in chunks of proteins, decoys of a chunk are generated and written in parallel (if OpenMP is enabled).
+  The output does not depend on the number of threads.
+
   <B>The command line parameters of this tool are:</B>
   @verbinclude UTILS_DecoyDatabase.cli
   <B>INI file documentation of this tool:</B>
@@ -181,7 +189,6 @@ protected:
 
     FASTAFile f;
     f.writeStart(out);
-    FASTAFile::FASTAEntry protein;
 
     // Configure Enzymatic digestion
     // TODO: allow user-specified regex
@@ -195,82 +202,128 @@ protected:
     MRMDecoy m;
     m.setParameters(decoy_param);
 
+    // number of proteins read, converted and written at a time
+    const int chunk_size = 50000;
+
     for (Size i = 0; i < in.size(); ++i)
     {
-      f.readStart(in[i]);
+      FASTAContainer<TFI_File> proteins(in[i]);
 
-      //-------------------------------------------------------------
-      // calculations
-      //-------------------------------------------------------------
-      while (f.readNext(protein))
+      while (true)
       {
-        if (identifiers.find(protein.identifier) != identifiers.end())
-        {
-          LOG_WARN << "DecoyDatabase: Warning, identifier '" << protein.identifier << "' occurs more than once!" << endl;
-        }
-        identifiers.insert(protein.identifier);
+        proteins.cacheChunk(chunk_size);
+        if (!proteins.activateCache()) break;
+        const SignedSize protein_count = (SignedSize)proteins.chunkSize();
 
-        if (append)
+        for (SignedSize k = 0; k < protein_count; ++k)
         {
-          f.writeNext(protein);
+          const String& identifier = proteins.chunkAt(k).identifier;
+          if (identifiers.find(identifier) != identifiers.end())
+          {
+            LOG_WARN << "DecoyDatabase: Warning, identifier '" << identifier << "' occurs more than once!" << endl;
+          }
+          identifiers.insert(identifier);
         }
 
-        // identifier
-        protein.identifier = getIdentifier_(protein.identifier, decoy_string, decoy_string_position_prefix);
-
-        // if (terminal_aminos != "none")
-        if (enzyme != "no cleavage" && (keepN || keepC))
+        //-------------------------------------------------------------
+        // calculations
+        //-------------------------------------------------------------
+        vector<FASTAFile::FASTAEntry> decoys(protein_count);
+        Size err_count = 0;
+        std::exception_ptr err;
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic, 64)
+#endif
+        for (SignedSize k = 0; k < protein_count; ++k)
         {
-          std::vector<AASequence> peptides;
-          digestion.digest(AASequence::fromString(protein.sequence), peptides);
-          String new_sequence = "";
-          for (auto const& peptide : peptides)
+          try
           {
-            if (shuffle)
+            FASTAFile::FASTAEntry& protein = decoys[k];
+            protein = proteins.chunkAt(k);
+
+            // identifier
+            protein.identifier = getIdentifier_(protein.identifier, decoy_string, decoy_string_position_prefix);
+
+            // if (terminal_aminos != "none")
+            if (enzyme != "no cleavage" && (keepN || keepC))
             {
-              OpenMS::TargetedExperiment::Peptide p;
-              p.sequence = peptide.toString();
-              OpenMS::TargetedExperiment::Peptide decoy_p = m.shufflePeptide(p, identity_threshold, seed, max_attempts);
-              new_sequence += decoy_p.sequence;
+              std::vector<AASequence> peptides;
+              digestion.digest(AASequence::fromString(protein.sequence), peptides);
+              String new_sequence = "";
+              for (auto const& peptide : peptides)
+              {
+                if (shuffle)
+                {
+                  OpenMS::TargetedExperiment::Peptide p;
+                  p.sequence = peptide.toString();
+                  OpenMS::TargetedExperiment::Peptide decoy_p = m.shufflePeptide(p, identity_threshold, seed, max_attempts);
+                  new_sequence += decoy_p.sequence;
+                }
+                else
+                {
+                  OpenMS::TargetedExperiment::Peptide p;
+                  p.sequence = peptide.toString();
+                  OpenMS::TargetedExperiment::Peptide decoy_p = MRMDecoy::reversePeptide(p, keepN, keepC, keep_const_pattern);
+                  new_sequence += decoy_p.sequence;
+                }
+              }
+              protein.sequence = new_sequence;
             }
             else
             {
-              OpenMS::TargetedExperiment::Peptide p;
-              p.sequence = peptide.toString();
-              OpenMS::TargetedExperiment::Peptide decoy_p = MRMDecoy::reversePeptide(p, keepN, keepC, keep_const_pattern);
-              new_sequence += decoy_p.sequence;
+              // sequence
+              if (shuffle)
+              {
+                String temp;
+                Size x = protein.sequence.size();
+                boost::mt19937 generator(seed); // identical proteins are shuffled the same way
+                while (x != 0)
+                {
+                  Size y = generator() % x;
+                  temp += protein.sequence[y];
+                  --x;
+                  protein.sequence[y] = protein.sequence[x]; // overwrite consumed position with last position (about to go out of scope for next dice roll)
+                }
+                protein.sequence = temp;
+              }
+              else // reverse
+              {
+                protein.sequence.reverse();
+              }
             }
           }
-          protein.sequence = new_sequence;
-        }
-        else
-        {
-          // sequence
-          if (shuffle)
+          catch (...)
           {
-            String temp;
-            Size x = protein.sequence.size();
-            srand(seed); // identical proteins are shuffled the same way
-            while (x != 0)
+#ifdef _OPENMP
+#pragma omp critical (DecoyDatabase_main)
+#endif
             {
-              Size y = rand() % x;
-              temp += protein.sequence[y];
-              --x;
-              protein.sequence[y] = protein.sequence[x]; // overwrite consumed position with last position (about to go out of scope for next dice roll)
+              if (err_count++ == 0) err = std::current_exception();
             }
           }
-          else // reverse
-          {
-            protein.sequence.reverse();
-          }
         }
+        if (err_count != 0) std::rethrow_exception(err);
 
         //-------------------------------------------------------------
         // writing output
         //-------------------------------------------------------------
-        f.writeNext(protein);
-
-      } // next protein
+        if (append)
+        {
+          // target and decoy sequences are written interleaved
+          vector<FASTAFile::FASTAEntry> entries;
+          entries.reserve(2 * protein_count);
+          for (SignedSize k = 0; k < protein_count; ++k)
+          {
+            entries.push_back(proteins.chunkAt(k));
+            entries.push_back(std::move(decoys[k]));
+          }
+          f.writeNext(entries);
+        }
+        else
+        {
+          f.writeNext(decoys);
+        }
+      } // next chunk
     } // input files
 
     return EXECUTION_OK;
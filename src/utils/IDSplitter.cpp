@@ -83,22 +83,34 @@ protected:
   {
     // there is no "PeptideIdentification::operator<", so we can't use a set
     // or sort + unique to filter out duplicates...
-    // just use the naive O(n²) algorithm
+    // duplicates share position and number of hits, so only peptide IDs
+    // within the same bucket need to be compared
+    typedef std::pair<std::pair<double, double>, Size> BucketKey;
+    std::map<BucketKey, vector<Size> > buckets;
     vector<PeptideIdentification> unique;
     for (vector<PeptideIdentification>::iterator in_it = peptides.begin();
          in_it != peptides.end(); ++in_it)
     {
+      // missing RT/MZ (NaN) can't be used as a map key
+      BucketKey key(std::make_pair(in_it->hasRT() ? in_it->getRT() : 0.0,
+                                   in_it->hasMZ() ? in_it->getMZ() : 0.0),
+                    in_it->getHits().size());
+      vector<Size>& bucket = buckets[key];
       bool duplicate = false;
-      for (vector<PeptideIdentification>::iterator out_it = unique.begin();
-           out_it != unique.end(); ++out_it)
+      for (vector<Size>::const_iterator out_it = bucket.begin();
+           out_it != bucket.end(); ++out_it)
       {
-        if (*in_it == *out_it)
+        if (*in_it == unique[*out_it])
         {
           duplicate = true;
           break;
         }
       }
-      if (!duplicate) unique.push_back(*in_it);
+      if (!duplicate)
+      {
+        bucket.push_back(unique.size());
+        unique.push_back(*in_it);
+      }
     }
     peptides.swap(unique);
   }
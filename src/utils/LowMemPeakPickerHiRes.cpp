@@ -40,6 +40,7 @@ using namespace OpenMS;
 using namespace std;
 
 #include <OpenMS/FORMAT/DATAACCESS/MSDataWritingConsumer.h>
+#include <OpenMS/FORMAT/DATAACCESS/MSDataParallelTransformingConsumer.h>
 
 //-------------------------------------------------------------
 //Doxygen docu
@@ -120,38 +121,6 @@ public:
 
 protected:
 
-  class PPHiResMzMLConsumer :
-    public MSDataWritingConsumer
-  {
-
-  public:
-
-    PPHiResMzMLConsumer(String filename, PeakPickerHiRes pp) :
-      MSDataWritingConsumer(filename),
-      ms1_levels_(pp.getParameters().getValue("ms_levels").toIntList())
-    {
-      pp_ = pp;
-    }
-
-    void processSpectrum_(MapType::SpectrumType & s) override
-    {
-      if (!ListUtils::contains(ms1_levels_, s.getMSLevel())) {return;}
-
-      MapType::SpectrumType sout;
-      pp_.pick(s, sout);
-      s = sout;
-    }
-
-    void processChromatogram_(MapType::ChromatogramType & /* c */) override
-    {
-      throw Exception::IllegalArgument(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION,
-        "Cannot handle chromatograms yet.");
-    }
-
-    PeakPickerHiRes pp_;
-    std::vector<Int> ms1_levels_;
-  };
-
   void registerOptionsAndFlags_() override
   {
     registerInputFile_("in", "<file>", "", "input profile data file ");
@@ -227,7 +196,8 @@ protected:
     //-------------------------------------------------------------
 
     ///////////////////////////////////
-    // Create PeakPickerHiRes and hand it to the PPHiResMzMLConsumer
+    // Create PeakPickerHiRes and a consumer which picks batches of spectra
+    // in parallel and writes them in their original order
     ///////////////////////////////////
     Param pepi_param = getParam_().copy("algorithm:", true);
     writeDebug_("Parameters passed to LowMemPeakPickerHiRes", pepi_param, 3);
@@ -235,16 +205,32 @@ protected:
     PeakPickerHiRes pp;
     pp.setLogType(log_type_);
     pp.setParameters(pepi_param);
-    PPHiResMzMLConsumer * ppConsumer = new PPHiResMzMLConsumer(out, pp);
-    ppConsumer->addDataProcessing(getProcessingInfo_(DataProcessing::PEAK_PICKING));
+    const std::vector<Int> ms_levels = pp.getParameters().getValue("ms_levels").toIntList();
+
+    PlainMSDataWritingConsumer writer(out);
+    writer.addDataProcessing(getProcessingInfo_(DataProcessing::PEAK_PICKING));
+
+    MSDataParallelTransformingConsumer pp_consumer(&writer);
+    pp_consumer.setSpectraProcessingFunc([&pp, &ms_levels](MSSpectrum& s)
+      {
+        if (!ListUtils::contains(ms_levels, s.getMSLevel())) {return;}
+
+        MSSpectrum sout;
+        pp.pick(s, sout);
+        s = sout;
+      });
+    pp_consumer.setChromatogramProcessingFunc([](MSChromatogram& /* c */)
+      {
+        throw Exception::IllegalArgument(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION,
+          "Cannot handle chromatograms yet.");
+      });
 
     ///////////////////////////////////
     // Create new MSDataReader and set our consumer
     ///////////////////////////////////
     MzMLFile mz_data_file;
-    mz_data_file.transform(in, ppConsumer);
-
-    delete ppConsumer;
+    mz_data_file.transform(in, &pp_consumer);
+    pp_consumer.flush();
 
     return EXECUTION_OK;
   }
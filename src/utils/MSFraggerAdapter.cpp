@@ -36,6 +36,7 @@
 #include <OpenMS/FORMAT/IdXMLFile.h>
 #include <OpenMS/FORMAT/PepXMLFile.h>
 #include <OpenMS/CHEMISTRY/ProteaseDB.h>
+#include <OpenMS/SYSTEM/ExecutionResources.h>
 #include <OpenMS/SYSTEM/JavaInfo.h>
 #include <QtCore/QDir>
 #include <QtCore/QProcess>
@@ -535,7 +536,7 @@ protected:
 
       // Write all the parameters into the file
       os << "database_name = " << String(database)
-                               << "\nnum_threads = " << this->getIntOption_("threads")
+                               << "\nnum_threads = " << ExecutionResources::getThreads()
                                << "\n\nprecursor_mass_tolerance = " << arg_precursor_mass_tolerance
                                << "\nprecursor_mass_units = " << (arg_precursor_mass_unit == "Da" ? 0 : 1)
                                << "\nprecursor_true_tolerance = " << arg_precursor_true_tolerance
@@ -38,6 +38,9 @@
 
 #include <QFile>
 
+#include <exception>
+#include <iterator>
+
 using namespace OpenMS;
 using namespace std;
 
@@ -54,6 +57,8 @@ using namespace std;
 
     Alternatively to setting the number of parts directly, a target maximum file size for the parts can be specified (parameters @p size and @p unit). The number of parts is then calculated by dividing the original file size by the target and rounding up. Note that the resulting parts may actually be bigger than the target size (due to meta data that is included in every part) or that more parts than necessary may be produced (if spectra or chromatograms are removed via @p no_spec/@p no_chrom).
 
+    The parts are written in parallel (if OpenMP is enabled), the output does not depend on the number of threads.
+
     This tool cannot be used as part of a TOPPAS workflow, because the number of output files is variable.
 
     <B>The command line parameters of this tool are:</B>
@@ -156,44 +161,53 @@ protected:
     writeLog_("Total spectra: " + String(spectra.size()));
     writeLog_("Total chromatograms: " + String(chromatograms.size()));
 
-    Size spec_start = 0, chrom_start = 0;
-    Size width = String(parts).size();
+    // distribute spectra and chromatograms over the parts
+    vector<Size> spec_starts(1, 0), chrom_starts(1, 0);
     for (Size counter = 1; counter <= parts; ++counter)
     {
-      ostringstream out_name;
-      out_name << out << "_part" << setw(width) << setfill('0') << counter
-               << "of" << parts << ".mzML";
-      PeakMap part = experiment;
-      addDataProcessing_(part, getProcessingInfo_(DataProcessing::FILTERING));
-
       Size remaining = parts - counter + 1;
-      Size n_spec = ceil((spectra.size() - spec_start) / double(remaining));
-      if (n_spec > 0)
+      Size n_spec = ceil((spectra.size() - spec_starts.back()) / double(remaining));
+      Size n_chrom = ceil((chromatograms.size() - chrom_starts.back()) /
+                          double(remaining));
+      spec_starts.push_back(spec_starts.back() + n_spec);
+      chrom_starts.push_back(chrom_starts.back() + n_chrom);
+      writeLog_("Part " + String(counter) + ": " + String(n_spec) + 
+                " spectra, " + String(n_chrom) + " chromatograms");
+    }
+
+    // the parts are independent: assemble (moving the data, as every
+    // spectrum/chromatogram goes to exactly one part) and write them in parallel
+    DataProcessing dp = getProcessingInfo_(DataProcessing::FILTERING);
+    Size width = String(parts).size();
+    Size err_count = 0;
+    std::exception_ptr err;
+#pragma omp parallel for schedule(dynamic, 1)
+    for (SignedSize p = 0; p < (SignedSize)parts; ++p)
+    {
+      try
       {
-        part.reserveSpaceSpectra(n_spec);
-        for (Size i = spec_start; i < spec_start + n_spec; ++i)
-        {
-          part.addSpectrum(spectra[i]);
-        }
+        Size counter = p + 1;
+        ostringstream out_name;
+        out_name << out << "_part" << setw(width) << setfill('0') << counter
+                 << "of" << parts << ".mzML";
+        PeakMap part = experiment;
+        addDataProcessing_(part, dp);
+
+        part.getSpectra().assign(make_move_iterator(spectra.begin() + spec_starts[p]),
+                                 make_move_iterator(spectra.begin() + spec_starts[p + 1]));
+        part.getChromatograms().assign(make_move_iterator(chromatograms.begin() + chrom_starts[p]),
+                                       make_move_iterator(chromatograms.begin() + chrom_starts[p + 1]));
+        MzMLFile().store(out_name.str(), part);
       }
-      spec_start += n_spec;
-
-      Size n_chrom = ceil((chromatograms.size() - chrom_start) /
-                          double(remaining));
-      if (n_chrom > 0)
+      catch (...)
       {
-        part.reserveSpaceChromatograms(n_chrom);
-        for (Size i = chrom_start; i < chrom_start + n_chrom; ++i)
+#pragma omp critical (MzMLSplitter_main)
         {
-          part.addChromatogram(chromatograms[i]);
+          if (err_count++ == 0) err = std::current_exception();
         }
       }
-      chrom_start += n_chrom;
-
-      writeLog_("Part " + String(counter) + ": " + String(n_spec) + 
-                " spectra, " + String(n_chrom) + " chromatograms");
-      MzMLFile().store(out_name.str(), part);
     }
+    if (err_count != 0) std::rethrow_exception(err);
 
     return EXECUTION_OK;
   }
@@ -51,6 +51,8 @@
 #include <OpenMS/ANALYSIS/OPENSWATH/TransitionPQPFile.h>
 #include <OpenMS/ANALYSIS/OPENSWATH/OpenSwathTSVWriter.h>
 #include <OpenMS/ANALYSIS/OPENSWATH/OpenSwathOSWWriter.h>
+#include <OpenMS/ANALYSIS/OPENSWATH/OpenSwathLibraryCache.h>
+#include <OpenMS/ANALYSIS/OPENSWATH/DIAScoring.h>
 #include <OpenMS/SYSTEM/File.h>
 
 // Kernel and implementations
@@ -58,6 +60,7 @@
 #include <OpenMS/ANALYSIS/OPENSWATH/DATAACCESS/SpectrumAccessOpenMS.h>
 #include <OpenMS/ANALYSIS/OPENSWATH/DATAACCESS/SpectrumAccessTransforming.h>
 #include <OpenMS/ANALYSIS/OPENSWATH/DATAACCESS/SpectrumAccessOpenMSInMemory.h>
+#include <OpenMS/ANALYSIS/OPENSWATH/DATAACCESS/SwathMapResidencyManager.h>
 #include <OpenMS/OPENSWATHALGO/DATAACCESS/SwathMap.h>
 
 // Helpers
@@ -140,6 +143,9 @@ using namespace OpenMS;
   whole file into memory but rather cache it somewhere on the disk using a
   fast-access data format. This can be specified using the -readOptions cache
   parameter (this is recommended!).
+  Using the -memory_budget parameter, the data is cached on disk and as many
+  SWATH maps as fit into the given amount of memory are kept in memory while
+  processing.
 
   The assay library (transition list) is provided through the @p -tr parameter and can be in one of the following formats:
   
@@ -469,6 +475,7 @@ protected:
 
     registerFlag_("use_ms1_traces", "Extract the precursor ion trace(s) and use for scoring", true);
     registerFlag_("enable_uis_scoring", "Enable additional scoring of identification assays", true);
+    registerFlag_("compact_chromatograms", "Keep extracted chromatograms in single precision on a shared retention time axis until they are scored (reduces memory usage for large assay libraries, intensities are rounded to single precision)", true);
 
     // one of the following two needs to be set
     registerOutputFile_("out_features", "<file>", "", "output file", false);
@@ -486,11 +493,15 @@ protected:
     // additional QC data
     registerOutputFile_("out_qc", "<file>", "", "Optional QC meta data (charge distribution in MS1). Only works with mzML input files.", false, true);
     setValidFormats_("out_qc", ListUtils::create<String>("json"));
+
+    // precomputed library-dependent scoring values (reused across runs)
+    registerStringOption_("library_cache", "<file>", "", "Optional cache file for library-dependent scoring values (theoretical b/y ion series and isotope patterns). If the file exists and was created for the same library and scoring parameters, it is used; otherwise it is (re-)created from the assay library. Useful when analyzing many runs with the same library.", false, true);
     
 
     // misc options
     registerDoubleOption_("min_upper_edge_dist", "<double>", 0.0, "Minimal distance to the upper edge of a Swath window to still consider a precursor, in Thomson", false, true);
     registerFlag_("sonar", "data is scanning SWATH data");
+    registerFlag_("sonar_streaming", "For scanning SWATH data: read each map only once and extract all overlapping windows from it, instead of reading (and loading into memory) the overlapping maps for each window. Greatly reduces memory usage for data with many windows.", true);
 
     // RT, mz and IM windows
     registerDoubleOption_("rt_extraction_window", "<double>", 600.0, "Only extract RT around this value (-1 means extract over the whole range, a value of 600 means to extract around +/- 300 s of the expected elution).", false);
@@ -528,6 +539,8 @@ protected:
 
     registerStringOption_("readOptions", "<name>", "normal", "Whether to run OpenSWATH directly on the input data, cache data to disk first or to perform a datareduction step first. If you choose cache, make sure to also set tempDirectory", false, true);
     setValidStrings_("readOptions", ListUtils::create<String>("normal,cache,cacheWorkingInMemory,workingInMemory"));
+    registerDoubleOption_("memory_budget", "<GB>", 0.0, "If set, cache all data to disk (as with readOptions cache) and keep as many SWATH maps in memory as fit into this amount of memory (in GB); maps not used recently are evicted first and upcoming maps are loaded ahead of time. Overrides the in-memory behavior of readOptions. Make sure to also set tempDirectory.", false, true);
+    setMinFloat_("memory_budget", 0.0);
 
     registerStringOption_("mz_correction_function", "<name>", "none", "Use the retention time normalization peptide MS2 masses to perform a mass correction (linear, weighted by intensity linear or quadratic) of all spectra.", false, true);
     setValidStrings_("mz_correction_function", ListUtils::create<String>("none,regression_delta_ppm,unweighted_regression,weighted_regression,quadratic_regression,weighted_quadratic_regression,weighted_quadratic_regression_delta_ppm,quadratic_regression_delta_ppm"));
@@ -539,7 +552,7 @@ protected:
 
     registerIntOption_("batchSize", "<number>", 250, "The batch size of chromatograms to process (0 means to only have one batch, sensible values are around 250-1000)", false, true);
     setMinInt_("batchSize", 0);
-    registerIntOption_("outer_loop_threads", "<number>", -1, "How many threads should be used for the outer loop (-1 use all threads, use 4 to analyze 4 SWATH windows in memory at once).", false, true);
+    registerIntOption_("outer_loop_threads", "<number>", -1, "How many SWATH windows should be analyzed (and kept in memory) at once (-1 for no limit). All threads are used independent of this setting.", false, true);
 
     registerIntOption_("ms1_isotopes", "<number>", 0, "The number of MS1 isotopes used for extraction", false, true);
     setMinInt_("ms1_isotopes", 0);
@@ -686,6 +699,7 @@ protected:
     bool use_emg_score = getFlag_("use_elution_model_score");
     bool force = getFlag_("force");
     bool sonar = getFlag_("sonar");
+    bool sonar_streaming = getFlag_("sonar_streaming");
     bool sort_swath_maps = getFlag_("sort_swath_maps");
     bool use_ms1_traces = getFlag_("use_ms1_traces");
     bool enable_uis_scoring = getFlag_("enable_uis_scoring");
@@ -710,8 +724,13 @@ protected:
     // Parameter validation
     ///////////////////////////////////
 
+    double memory_budget = getDoubleOption_("memory_budget");
     bool load_into_memory = false;
-    if (readoptions == "cacheWorkingInMemory")
+    if (memory_budget > 0.0)
+    {
+      readoptions = "cache";
+    }
+    else if (readoptions == "cacheWorkingInMemory")
     {
       readoptions = "cache";
       load_into_memory = true;
@@ -769,6 +788,7 @@ protected:
     cp.im_extraction_window  = getDoubleOption_("ion_mobility_window");
     cp.extraction_function   = getStringOption_("extraction_function");
     cp.extra_rt_extract      = getDoubleOption_("extra_rt_extraction_window");
+    cp.compact_chromatograms = getFlag_("compact_chromatograms");
 
     ChromExtractParams cp_irt = cp;
     cp_irt.rt_extraction_window = -1; // extract the whole RT range for iRT measurements
@@ -852,6 +872,14 @@ protected:
     }
 
 
+    // decides which SWATH maps to keep in memory (if a memory budget is given)
+    boost::shared_ptr<SwathMapResidencyManager> residency_manager;
+    if (memory_budget > 0.0)
+    {
+      residency_manager.reset(new SwathMapResidencyManager(static_cast<UInt64>(memory_budget * 1024.0 * 1024.0 * 1024.0)));
+      std::cout << "Will keep SWATH maps in memory up to " << memory_budget << " GB" << std::endl;
+    }
+
     ///////////////////////////////////
     // Get the transformation information (using iRT peptides)
     ///////////////////////////////////
@@ -865,7 +893,7 @@ protected:
                                         min_rsq, min_coverage, feature_finder_param,
                                         cp_irt, irt_detection_param, mz_correction_function,
                                         debug_level, sonar, load_into_memory,
-                                        irt_trafo_out, irt_mzml_out);
+                                        irt_trafo_out, irt_mzml_out, residency_manager.get());
     }
     else
     {
@@ -879,7 +907,7 @@ protected:
                                         min_rsq, min_coverage, feature_finder_param,
                                         cp_irt, linear_irt, "none",
                                         debug_level, sonar, load_into_memory,
-                                        irt_trafo_out, irt_mzml_out);
+                                        irt_trafo_out, irt_mzml_out, residency_manager.get());
 
       cp_irt.rt_extraction_window = 900; // extract some substantial part of the RT range (should be covered by linear correction)
       cp_irt.rt_extraction_window = 600; // extract some substantial part of the RT range (should be covered by linear correction)
@@ -893,6 +921,7 @@ protected:
       std::vector< OpenMS::MSChromatogram > chromatograms;
       OpenSwathCalibrationWorkflow wf;
       wf.setLogType(log_type_);
+      wf.setResidencyManager(residency_manager.get());
       wf.simpleExtractChromatograms_(swath_maps, transition_exp_nl, chromatograms,
                                     trafo_rtnorm, cp_irt, sonar, load_into_memory);
 
@@ -917,6 +946,40 @@ protected:
     OpenSwathTSVWriter tsvwriter(out_tsv, file_list[0], use_ms1_traces, sonar, enable_uis_scoring); // only active if filename not empty
     OpenSwathOSWWriter oswwriter(out_osw, file_list[0], use_ms1_traces, sonar, enable_uis_scoring); // only active if filename not empty
 
+    ///////////////////////////////////
+    // Prepare library-dependent scoring values
+    ///////////////////////////////////
+    OpenSwathLibraryCache library_cache;
+    String library_cache_file = getStringOption_("library_cache");
+    if (!library_cache_file.empty())
+    {
+      DIAScoring diascoring;
+      diascoring.setParameters(feature_finder_param.copy("DIAScoring:", true));
+      bool cache_valid = false;
+      if (File::exists(library_cache_file))
+      {
+        try
+        {
+          library_cache.load(library_cache_file);
+          cache_valid = library_cache.matches(transition_exp, diascoring);
+        }
+        catch (Exception::ParseError& e)
+        {
+          LOG_WARN << "Could not read library cache " << library_cache_file << ": " << e.what() << std::endl;
+        }
+      }
+      if (cache_valid)
+      {
+        LOG_INFO << "Using library cache " << library_cache_file << std::endl;
+      }
+      else
+      {
+        LOG_INFO << "Creating library cache " << library_cache_file << std::endl;
+        library_cache.compute(transition_exp, diascoring);
+        library_cache.store(library_cache_file);
+      }
+    }
+
     ///////////////////////////////////
     // Extract and score
     ///////////////////////////////////
@@ -924,6 +987,9 @@ protected:
     {
       OpenSwathWorkflowSonar wf(use_ms1_traces);
       wf.setLogType(log_type_);
+      wf.setStreaming(sonar_streaming);
+      if (!library_cache_file.empty()) wf.setLibraryCache(&library_cache);
+      wf.setResidencyManager(residency_manager.get());
       wf.performExtractionSonar(swath_maps, trafo_rtnorm, cp, cp_ms1, feature_finder_param, transition_exp,
           out_featureFile, !out.empty(), tsvwriter, oswwriter, chromatogramConsumer, batchSize, load_into_memory);
     }
@@ -931,6 +997,8 @@ protected:
     {
       OpenSwathWorkflow wf(use_ms1_traces, use_ms1_im, outer_loop_threads);
       wf.setLogType(log_type_);
+      if (!library_cache_file.empty()) wf.setLibraryCache(&library_cache);
+      wf.setResidencyManager(residency_manager.get());
       wf.performExtraction(swath_maps, trafo_rtnorm, cp, cp_ms1, feature_finder_param, transition_exp,
           out_featureFile, !out.empty(), tsvwriter, oswwriter, chromatogramConsumer, batchSize, ms1_isotopes, load_into_memory);
     }
@@ -0,0 +1,150 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2018.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: Hannes Roest $
+// $Authors: Hannes Roest $
+// --------------------------------------------------------------------------
+
+
+#include <OpenMS/APPLICATIONS/TOPPBase.h>
+#include <OpenMS/CHEMISTRY/ModificationsDB.h>
+#include <OpenMS/CHEMISTRY/ProteaseDB.h>
+#include <OpenMS/FORMAT/FASTAFile.h>
+#include <OpenMS/FORMAT/PeptideDatabaseFile.h>
+
+using namespace OpenMS;
+using namespace std;
+
+//-------------------------------------------------------------
+//Doxygen docu
+//-------------------------------------------------------------
+
+/**
+    @page UTILS_PeptideDatabaseBuilder PeptideDatabaseBuilder
+
+    @brief Digests and modifies a protein database once for repeated searches.
+
+    Search engines spend a considerable amount of time on reading the
+    protein database, digesting it and generating all modified variants of
+    all peptides, which is repeated for every search. This tool does it once
+    and stores the unique peptides with all their modified variants (sorted
+    by mass) and their protein references in a binary, memory-mappable file
+    (see PeptideDatabaseFile). The file can be passed to @ref
+    UTILS_SimpleSearchEngine as 'peptide_database', the digestion and
+    modification settings of the search need to be the same as used here.
+
+    Processes on the same machine that load the same file share its memory.
+
+    <B>The command line parameters of this tool are:</B>
+    @verbinclude UTILS_PeptideDatabaseBuilder.cli
+    <B>INI file documentation of this tool:</B>
+    @htmlinclude UTILS_PeptideDatabaseBuilder.html
+*/
+
+// We do not want this class to show up in the docu:
+/// @cond TOPPCLASSES
+
+class TOPPPeptideDatabaseBuilder :
+  public TOPPBase
+{
+public:
+  TOPPPeptideDatabaseBuilder() :
+    TOPPBase("PeptideDatabaseBuilder", "Digests and modifies a protein database once for repeated searches.", false)
+  {
+  }
+
+protected:
+  void registerOptionsAndFlags_() override
+  {
+    registerInputFile_("in", "<file>", "", "Protein database");
+    setValidFormats_("in", ListUtils::create<String>("fasta"));
+    registerOutputFile_("out", "<file>", "", "Peptide database (binary)");
+
+    vector<String> all_enzymes;
+    ProteaseDB::getInstance()->getAllNames(all_enzymes);
+    registerStringOption_("enzyme", "<cleavage site>", "Trypsin", "The enzyme used for peptide digestion.", false);
+    setValidStrings_("enzyme", all_enzymes);
+
+    registerTOPPSubsection_("peptide", "Peptide Options");
+    registerIntOption_("peptide:min_size", "<num>", 7, "Minimum size a peptide must have after digestion to be considered in the search.", false, true);
+    registerIntOption_("peptide:max_size", "<num>", 40, "Maximum size a peptide must have after digestion to be considered in the search (0 = disabled).", false, true);
+    registerIntOption_("peptide:missed_cleavages", "<num>", 1, "Number of missed cleavages.", false, false);
+
+    registerTOPPSubsection_("modifications", "Modifications Options");
+    vector<String> all_mods;
+    ModificationsDB::getInstance()->getAllSearchModifications(all_mods);
+    registerStringList_("modifications:fixed", "<mods>", ListUtils::create<String>(""), "Fixed modifications, specified using UniMod (www.unimod.org) terms, e.g. 'Carbamidomethyl (C)'", false);
+    setValidStrings_("modifications:fixed", all_mods);
+    registerStringList_("modifications:variable", "<mods>", ListUtils::create<String>(""), "Variable modifications, specified using UniMod (www.unimod.org) terms, e.g. 'Oxidation (M)'", false);
+    setValidStrings_("modifications:variable", all_mods);
+    registerIntOption_("modifications:variable_max_per_peptide", "<num>", 2, "Maximum number of residues carrying a variable modification per candidate peptide", false, false);
+  }
+
+  ExitCodes main_(int, const char**) override
+  {
+    PeptideDatabaseFile::Settings settings;
+    settings.enzyme = getStringOption_("enzyme");
+    settings.missed_cleavages = getIntOption_("peptide:missed_cleavages");
+    settings.min_length = getIntOption_("peptide:min_size");
+    settings.max_length = getIntOption_("peptide:max_size");
+    settings.fixed_modifications = getStringList_("modifications:fixed");
+    settings.variable_modifications = getStringList_("modifications:variable");
+    settings.max_variable_mods_per_peptide = getIntOption_("modifications:variable_max_per_peptide");
+
+    ProgressLogger progresslogger;
+    progresslogger.setLogType(log_type_);
+    progresslogger.startProgress(0, 1, "Load database from FASTA file...");
+    vector<FASTAFile::FASTAEntry> fasta_db;
+    FASTAFile().load(getStringOption_("in"), fasta_db);
+    progresslogger.endProgress();
+
+    progresslogger.startProgress(0, 1, "Digesting and modifying proteins...");
+    const String out = getStringOption_("out");
+    PeptideDatabaseFile::store(out, fasta_db, settings);
+    progresslogger.endProgress();
+
+    PeptideDatabaseFile db;
+    db.load(out);
+    LOG_INFO << "Proteins: " << db.getNrProteins() << endl;
+    LOG_INFO << "Peptides: " << db.getNrPeptides() << endl;
+    LOG_INFO << "Modified variants: " << db.getNrVariants() << endl;
+
+    return EXECUTION_OK;
+  }
+
+};
+
+int main(int argc, const char** argv)
+{
+  TOPPPeptideDatabaseBuilder tool;
+  return tool.main(argc, argv);
+}
+
+/// @endcond
@@ -43,6 +43,7 @@
 #include <OpenMS/KERNEL/MSExperiment.h>
 #include <OpenMS/FORMAT/ConsensusXMLFile.h>
 #include <OpenMS/FORMAT/MzMLFile.h>
+#include <OpenMS/INTERFACES/IMSDataConsumer.h>
 #include <OpenMS/FORMAT/QcMLFile.h>
 #include <OpenMS/MATH/MISC/MathFunctions.h>
 #include <OpenMS/MATH/STATISTICS/StatisticFunctions.h>
@@ -54,6 +55,7 @@
 
 #include <vector>
 #include <map>
+#include <limits>
 
 using namespace OpenMS;
 using namespace std;
@@ -111,6 +113,213 @@ using namespace std;
 #pragma clang diagnostic push
 #pragma clang diagnostic ignored "-Wshadow"
 
+/**
+  @brief Collects the MS acquisition metrics of a run in a single pass
+
+  Used with MzMLFile::transform, so the spectra and chromatograms do not have
+  to be held in memory while the metrics are computed.
+*/
+class QCAcquisitionConsumer :
+  public Interfaces::IMSDataConsumer
+{
+public:
+  typedef PeakMap::SpectrumType SpectrumType;
+  typedef PeakMap::ChromatogramType ChromatogramType;
+
+  ExperimentalSettings settings;
+  Size nr_spectra;
+  Size nr_chromatograms;
+  std::map<Size, UInt> mslevelcounts;
+  double first_rt;
+  double last_rt;
+  UInt min_mz;
+  UInt max_mz;
+
+  /// RT, m/z, charge, S/N and peak count of each MS2 precursor
+  std::vector<std::vector<String> > precursor_rows;
+  /// RT and intensity of the first TIC chromatogram
+  std::vector<std::vector<String> > tic_rows;
+  Size tic_below_10k;
+  /// RT, intensity sum, S/N and peak count of each MS1 spectrum
+  std::vector<std::vector<String> > ric_rows;
+  Size ric_below_10k;
+  Size ric_jumps;
+  Size ric_drops;
+  /// RT and injection time of each MSn spectrum
+  std::vector<std::vector<String> > injection_rows;
+
+  QCAcquisitionConsumer() :
+    nr_spectra(0),
+    nr_chromatograms(0),
+    first_rt(0.0),
+    last_rt(0.0),
+    min_mz(std::numeric_limits<UInt>::max()),
+    max_mz(0),
+    tic_below_10k(0),
+    ric_below_10k(0),
+    ric_jumps(0),
+    ric_drops(0),
+    tic_found_(false),
+    ric_prev_(0)
+  {
+  }
+
+  static float calculateSNmedian(MSSpectrum& spec, bool norm = true)
+  {
+    if (spec.size() == 0) return 0;
+    float median = 0;
+    float maxi = 0;
+    spec.sortByIntensity();
+    
+    if (spec.size() % 2 == 0)
+    {
+      median = (spec[spec.size() / 2 - 1].getIntensity() + spec[spec.size() / 2].getIntensity()) / 2;
+    }
+    else
+    {
+      median = spec[spec.size() / 2].getIntensity();
+    }
+    maxi = spec.back().getIntensity();
+    if (!norm)
+    {
+      float sn_by_max2median = maxi / median;
+      return sn_by_max2median;
+    }
+
+    float sign_int= 0;
+    float nois_int = 0;
+    size_t sign_cnt= 0;
+    size_t nois_cnt = 0;
+    for (MSSpectrum::const_iterator pt = spec.begin(); pt != spec.end(); ++pt)
+    {
+      if (pt->getIntensity() <= median)
+      {
+        ++nois_cnt;
+        nois_int += pt->getIntensity();
+      }
+      else
+      {
+        ++sign_cnt;
+        sign_int += pt->getIntensity();
+      }
+    }
+    float sn_by_max2median_norm = (sign_int / sign_cnt) / (nois_int / nois_cnt);
+
+    return sn_by_max2median_norm;
+  }
+
+  void consumeSpectrum(SpectrumType& s) override
+  {
+    if (nr_spectra == 0)
+    {
+      first_rt = s.getRT();
+    }
+    last_rt = s.getRT();
+    ++nr_spectra;
+    mslevelcounts[s.getMSLevel()]++;
+
+    if (s.getMSLevel() == 2 && !s.getPrecursors().empty())
+    {
+      const Precursor& prec = s.getPrecursors().front();
+      if (prec.getMZ() < min_mz)
+      {
+        min_mz = prec.getMZ();
+      }
+      if (prec.getMZ() > max_mz)
+      {
+        max_mz = prec.getMZ();
+      }
+      std::vector<String> row;
+      row.push_back(s.getRT());
+      row.push_back(prec.getMZ());
+      row.push_back(prec.getCharge());
+      row.push_back(calculateSNmedian(s));
+      row.push_back(s.size());
+      precursor_rows.push_back(row);
+    }
+
+    // reconstructed TIC (RIC) from the MS1 intensities
+    if (s.getMSLevel() == 1)
+    {
+      const Size fact = 10;
+      UInt sum = 0;
+      for (Size j = 0; j < s.size(); ++j)
+      {
+        sum += s[j].getIntensity();
+      }
+      if (ric_prev_ > 0 && sum > fact * ric_prev_)  // no jumps after complete drops (or [re]starts)
+      {
+        ++ric_jumps;
+      }
+      else if (sum < fact * ric_prev_)
+      {
+        ++ric_drops;
+      }
+      if (sum < 10000)
+      {
+        ++ric_below_10k;
+      }
+      ric_prev_ = sum;
+      std::vector<String> row;
+      row.push_back(s.getRT());
+      row.push_back(sum);
+      row.push_back(calculateSNmedian(s));
+      row.push_back(s.size());
+      ric_rows.push_back(row);
+    }
+
+    // injection times MSn
+    if (s.getMSLevel() > 1)
+    {
+      for (Size j = 0; j < s.getAcquisitionInfo().size(); ++j)
+      {
+        if (s.getAcquisitionInfo()[j].metaValueExists("MS:1000927"))
+        {
+          std::vector<String> row;
+          row.push_back(String(s.getRT()));
+          row.push_back(s.getAcquisitionInfo()[j].getMetaValue("MS:1000927"));
+          injection_rows.push_back(row);
+        }
+      }
+    }
+  }
+
+  void consumeChromatogram(ChromatogramType& c) override
+  {
+    ++nr_chromatograms;
+    // only the first TIC (there should generally not be more than one)
+    if (tic_found_ || c.getChromatogramType() != ChromatogramSettings::TOTAL_ION_CURRENT_CHROMATOGRAM)
+    {
+      return;
+    }
+    tic_found_ = true;
+    for (Size i = 0; i < c.size(); ++i)
+    {
+      double sum = c[i].getIntensity();
+      if (sum < 10000)
+      {
+        ++tic_below_10k;
+      }
+      std::vector<String> row;
+      row.push_back(c[i].getRT() * 60);
+      row.push_back(sum);
+      tic_rows.push_back(row);
+    }
+  }
+
+  void setExpectedSize(Size /* expectedSpectra */, Size /* expectedChromatograms */) override {}
+
+  void setExperimentalSettings(const ExperimentalSettings& exp) override
+  {
+    settings = exp;
+  }
+
+protected:
+  bool tic_found_;
+  Size ric_prev_;
+};
+
+
 class TOPPQCCalculator :
   public TOPPBase
 {
@@ -160,50 +369,6 @@ protected:
     // TODO
 //  }
 
-  float calculateSNmedian (MSSpectrum& spec, bool norm = true)
-  {
-    if (spec.size() == 0) return 0;
-    float median = 0;
-    float maxi = 0;
-    spec.sortByIntensity();
-    
-    if (spec.size() % 2 == 0)
-    {
-      median = (spec[spec.size() / 2 - 1].getIntensity() + spec[spec.size() / 2].getIntensity()) / 2;
-    }
-    else
-    {
-      median = spec[spec.size() / 2].getIntensity();
-    }
-    maxi = spec.back().getIntensity();
-    if (!norm)
-    {
-      float sn_by_max2median = maxi / median;
-      return sn_by_max2median;
-    }
-
-    float sign_int= 0;
-    float nois_int = 0;
-    size_t sign_cnt= 0;
-    size_t nois_cnt = 0;
-    for (MSSpectrum::const_iterator pt = spec.begin(); pt != spec.end(); ++pt)
-    {
-      if (pt->getIntensity() <= median)
-      {
-        ++nois_cnt;
-        nois_int += pt->getIntensity();
-      }
-      else
-      {
-        ++sign_cnt;
-        sign_int += pt->getIntensity();
-      }
-    }
-    float sn_by_max2median_norm = (sign_int / sign_cnt) / (nois_int / nois_cnt);
-
-    return sn_by_max2median_norm;
-  }
-
   ExitCodes main_(int, const char**) override
   {
     vector<ProteinIdentification> prot_ids;
@@ -236,15 +401,11 @@ protected:
     //------------------------------------------------------------
     String base_name = QFileInfo(QString::fromStdString(inputfile_raw)).baseName();
 
+    // all acquisition metrics are collected in a single pass over the file
     cout << "Reading mzML file..." << endl;
-    PeakMap exp;
-    MzMLFile().load(inputfile_raw, exp);
-    
-    //---prep input
-    exp.sortSpectra();
-    UInt min_mz = std::numeric_limits<UInt>::max();
-    UInt max_mz = 0;
-    std::map<Size, UInt> mslevelcounts;
+    QCAcquisitionConsumer acquisition;
+    MzMLFile().transform(inputfile_raw, &acquisition, true);
+    std::map<Size, UInt>& mslevelcounts = acquisition.mslevelcounts;
     
     qcmlfile.registerRun(base_name,base_name); //TODO use UIDs
     
@@ -279,7 +440,7 @@ protected:
     qp.id = base_name + "_instrument_name"; ///< Identifier
     qp.cvRef = "MS"; ///< cv reference
     qp.cvAcc = "MS:1000031";
-    qp.value = exp.getInstrument().getName();
+    qp.value = acquisition.settings.getInstrument().getName();
     qcmlfile.addRunQualityParameter(base_name, qp);    
 
     qp = QcMLFile::QualityParameter();
@@ -287,7 +448,7 @@ protected:
     qp.id = base_name + "_date"; ///< Identifier
     qp.cvRef = "MS"; ///< cv reference
     qp.cvAcc = "MS:1000747";
-    qp.value = exp.getDateTime().getDate();
+    qp.value = acquisition.settings.getDateTime().getDate();
     qcmlfile.addRunQualityParameter(base_name, qp);
 
     //---precursors and SN
@@ -311,28 +472,7 @@ protected:
     at.colTypes.push_back("MS:1000041");  // charge
     at.colTypes.push_back("S/N");  // S/N
     at.colTypes.push_back("peak count");  // peak count
-    for (Size i = 0; i < exp.size(); ++i)
-    {
-      mslevelcounts[exp[i].getMSLevel()]++;
-      if (exp[i].getMSLevel() == 2)
-      {
-        if (exp[i].getPrecursors().front().getMZ() < min_mz)
-        {
-          min_mz = exp[i].getPrecursors().front().getMZ();
-        }
-        if (exp[i].getPrecursors().front().getMZ() > max_mz)
-        {
-          max_mz = exp[i].getPrecursors().front().getMZ();
-        }
-        std::vector<String> row;
-        row.push_back(exp[i].getRT());
-        row.push_back(exp[i].getPrecursors().front().getMZ());
-        row.push_back(exp[i].getPrecursors().front().getCharge());
-        row.push_back(calculateSNmedian(exp[i]));
-        row.push_back(exp[i].size());
-        at.tableRows.push_back(row);
-      }
-    }
+    at.tableRows = acquisition.precursor_rows;
     qcmlfile.addRunAttachment(base_name, at);
 
     //---aquisition results qp
@@ -373,7 +513,7 @@ protected:
     qp.cvRef = "QC"; ///< cv reference
     qp.cvAcc = "QC:0000008"; ///< cv accession for "aquisition results"
     qp.id = base_name + "_Chromaquisition"; ///< Identifier
-    qp.value = String(exp.getChromatograms().size());
+    qp.value = String(acquisition.nr_chromatograms);
     try
     {
       const ControlledVocabulary::CVTerm& term = cv.getTerm(qp.cvAcc);
@@ -403,8 +543,8 @@ protected:
     at.colTypes.push_back("QC:0000010"); //MZ
     at.colTypes.push_back("QC:0000011"); //MZ
     std::vector<String> rowmz;
-    rowmz.push_back(String(min_mz));
-    rowmz.push_back(String(max_mz));
+    rowmz.push_back(String(acquisition.min_mz));
+    rowmz.push_back(String(acquisition.max_mz));
     at.tableRows.push_back(rowmz);
     qcmlfile.addRunAttachment(base_name, at);
 
@@ -426,8 +566,8 @@ protected:
     at.colTypes.push_back("QC:0000013"); //MZ
     at.colTypes.push_back("QC:0000014"); //MZ
     std::vector<String> rowrt;
-    rowrt.push_back(String(exp.begin()->getRT()));
-    rowrt.push_back(String(exp.getSpectra().back().getRT()));
+    rowrt.push_back(String(acquisition.first_rt));
+    rowrt.push_back(String(acquisition.last_rt));
     at.tableRows.push_back(rowrt);
     qcmlfile.addRunAttachment(base_name, at);
     
@@ -450,36 +590,16 @@ protected:
 
     at.colTypes.push_back("MS:1000894_[sec]");
     at.colTypes.push_back("MS:1000285");
-    Size below_10k = 0;
-    std::vector<OpenMS::Chromatogram> chroms = exp.getChromatograms();
-    if (!chroms.empty()) //real TIC from the mzML
+    if (acquisition.nr_chromatograms > 0) //real TIC from the mzML
     {
-      for (Size t = 0; t < chroms.size(); ++t)
-      {
-        if (chroms[t].getChromatogramType() == ChromatogramSettings::TOTAL_ION_CURRENT_CHROMATOGRAM)
-        {
-          for (Size i = 0; i < chroms[t].size(); ++i)
-          {
-            double sum = chroms[t][i].getIntensity();
-            if (sum < 10000)
-            {
-              ++below_10k;
-            }
-            std::vector<String> row;
-            row.push_back(chroms[t][i].getRT() * 60);
-            row.push_back(sum);
-            at.tableRows.push_back(row);
-          }
-          break;  // what if there are more than one? should generally not be though ...
-        }
-      }
+      at.tableRows = acquisition.tic_rows;
       qcmlfile.addRunAttachment(base_name, at);
 
       qp = QcMLFile::QualityParameter();
       qp.id = base_name + "_ticslump"; ///< Identifier
       qp.cvRef = "QC"; ///< cv reference
       qp.cvAcc = "QC:0000023";
-      qp.value = String((100 / exp.size()) * below_10k);
+      qp.value = String(acquisition.nr_spectra == 0 ? 0 : (100 / acquisition.nr_spectra) * acquisition.tic_below_10k);
       try
       {
         const ControlledVocabulary::CVTerm& term = cv.getTerm(qp.cvAcc);
@@ -512,48 +632,14 @@ protected:
     at.colTypes.push_back("MS:1000285");
     at.colTypes.push_back("S/N");
     at.colTypes.push_back("peak count");
-    Size prev = 0;
-    below_10k = 0;
-    Size jumps = 0;
-    Size drops = 0;
-    Size fact = 10;
-    for (Size i = 0; i < exp.size(); ++i)
-    {
-      if (exp[i].getMSLevel() == 1)
-      {
-        UInt sum = 0;
-        for (Size j = 0; j < exp[i].size(); ++j)
-        {
-          sum += exp[i][j].getIntensity();
-        }
-        if (prev > 0 && sum > fact * prev)  // no jumps after complete drops (or [re]starts)
-        {
-          ++jumps;
-        }
-        else if (sum < fact*prev)
-        {
-          ++drops;
-        }
-        if (sum < 10000)
-        {
-          ++below_10k;
-        }
-        prev = sum;
-        std::vector<String> row;
-        row.push_back(exp[i].getRT());
-        row.push_back(sum);
-        row.push_back(calculateSNmedian(exp[i]));
-        row.push_back(exp[i].size());
-        at.tableRows.push_back(row);
-      }
-    }
+    at.tableRows = acquisition.ric_rows;
     qcmlfile.addRunAttachment(base_name, at);
 
     qp = QcMLFile::QualityParameter();
     qp.id = base_name + "_ricslump"; ///< Identifier
     qp.cvRef = "QC"; ///< cv reference
     qp.cvAcc = "QC:0000057";
-    qp.value = String((100 / exp.size()) * below_10k);
+    qp.value = String(acquisition.nr_spectra == 0 ? 0 : (100 / acquisition.nr_spectra) * acquisition.ric_below_10k);
     try
     {
       const ControlledVocabulary::CVTerm& term = cv.getTerm(qp.cvAcc);
@@ -569,7 +655,7 @@ protected:
     qp.id = base_name + "_ricjump"; ///< Identifier
     qp.cvRef = "QC"; ///< cv reference
     qp.cvAcc = "QC:0000059";
-    qp.value = String(jumps);
+    qp.value = String(acquisition.ric_jumps);
     try
     {
       const ControlledVocabulary::CVTerm& term = cv.getTerm(qp.cvAcc);
@@ -585,7 +671,7 @@ protected:
     qp.id = base_name + "_ricdump"; ///< Identifier
     qp.cvRef = "QC"; ///< cv reference
     qp.cvAcc = "QC:0000060";
-    qp.value = String(drops);
+    qp.value = String(acquisition.ric_drops);
     try
     {
       const ControlledVocabulary::CVTerm& term = cv.getTerm(qp.cvAcc);
@@ -615,22 +701,7 @@ protected:
 
     at.colTypes.push_back("MS:1000894_[sec]");
     at.colTypes.push_back("MS:1000927");
-    for (Size i = 0; i < exp.size(); ++i)
-    {
-      if (exp[i].getMSLevel() > 1 && !exp[i].getAcquisitionInfo().empty())
-      {
-        for (Size j = 0; j < exp[i].getAcquisitionInfo().size(); ++j)
-        {
-          if (exp[i].getAcquisitionInfo()[j].metaValueExists("MS:1000927"))
-          {
-            std::vector<String> row;
-            row.push_back(String(exp[i].getRT()));
-            row.push_back(exp[i].getAcquisitionInfo()[j].getMetaValue("MS:1000927"));
-            at.tableRows.push_back(row);
-          }
-        }
-      }
-    }
+    at.tableRows = acquisition.injection_rows;
     if (!at.tableRows.empty())
     {
       qcmlfile.addRunAttachment(base_name, at);
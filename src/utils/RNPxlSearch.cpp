@@ -366,6 +366,18 @@ protected:
     }
   };
 
+  /// Scores of a spectrum against the unshifted (total loss) fragments of a peptide, independent of the cross-linked nucleotide
+  struct TotalLossScores_
+  {
+    float score = 0;
+    float MIC = 0;
+    float err = 0;
+    float Morph = 0;
+    float immonium_score = 0;
+    float precursor_score = 0;
+    float a_ion_score = 0;
+  };
+
 
 
   /* @brief Filter spectra to remove noise.
@@ -496,6 +508,24 @@ protected:
                                      const vector<FragmentAdductDefinition_>& partial_loss_modification,
                                      const TheoreticalSpectrumGenerator& partial_loss_spectrum_generator,
                                      PeakSpectrum& partial_loss_spectrum);
+
+    // same as above, but shifts the unshifted a,b,y ion series of charge 1..precursor_charge (see generateUnshiftedSeries)
+    // that only depend on the peptide and can be generated once for all precursor and fragment adducts
+    static void generatePartialLossSpectrum(const String& unmodified_sequence,
+                                     const double& fixed_and_variable_modified_peptide_weight,
+                                     const String& precursor_rna_adduct,
+                                     const double& precursor_rna_weight,
+                                     const int& precursor_charge,
+                                     const vector<FragmentAdductDefinition_>& partial_loss_modification,
+                                     const vector<PeakSpectrum>& unshifted_series,
+                                     PeakSpectrum& partial_loss_spectrum);
+
+    // generate the unshifted a,b,y ion series (and MS2 precursor ions) of charge z at index z-1 for z = 1..max_charge
+    static void generateUnshiftedSeries(const AASequence& fixed_and_variable_modified_peptide,
+                                     const int max_charge,
+                                     const TheoreticalSpectrumGenerator& partial_loss_spectrum_generator,
+                                     vector<PeakSpectrum>& unshifted_series);
+
     static void addPrecursorWithCompleteRNA_(const double fixed_and_variable_modified_peptide_weight,
                                       const String & precursor_rna_adduct,
                                       const double precursor_rna_weight,
@@ -1842,6 +1872,9 @@ protected:
                        precursor_sub_score_spectrum,
                        marker_ions_sub_score_spectrum;
 
+          // unshifted ion series of charge 1 and 2, shifted by every fragment adduct of every precursor adduct
+          vector<PeakSpectrum> unshifted_partial_loss_series;
+
           // iterate over all RNA sequences, calculate peptide mass and generate complete loss spectrum only once as this can potentially be reused
           Size rna_mod_index = 0;
 
@@ -1977,6 +2010,41 @@ protected:
               }
               else  // score peptide with RNA adduct
               {
+                // the total loss scores do not depend on the cross-linked nucleotide: score every matching spectrum only once
+                vector<TotalLossScores_> total_loss_scores;
+                bool has_total_loss_hit(false);
+                for (auto l = low_it; l != up_it; ++l)
+                {
+                  const PeakSpectrum& exp_spectrum = spectra[l->second.first];
+                  const int & exp_pc_charge = exp_spectrum.getPrecursors()[0].getCharge();
+                  PeakSpectrum & total_loss_spectrum = (exp_pc_charge < 3) ? total_loss_spectrum_z1 : total_loss_spectrum_z2;
+
+                  TotalLossScores_ tls;
+                  scoreTotalLossFragments_(exp_spectrum,
+                                           total_loss_spectrum,
+                                           fragment_mass_tolerance, fragment_mass_tolerance_unit_ppm,
+                                           a_ion_sub_score_spectrum,
+                                           precursor_sub_score_spectrum,
+                                           immonium_sub_score_spectrum,
+                                           tls.score,
+                                           tls.MIC,
+                                           tls.err,
+                                           tls.Morph,
+                                           tls.immonium_score,
+                                           tls.precursor_score,
+                                           tls.a_ion_score);
+                  total_loss_scores.push_back(tls);
+                  if (tls.score >= 0.001) { has_total_loss_hit = true; }
+                }
+
+                // no good hit for any nucleotide: no need to generate the shifted spectra
+                if (!has_total_loss_hit) { continue; }
+
+                if (unshifted_partial_loss_series.empty())
+                {
+                  RNPxlFragmentIonGenerator::generateUnshiftedSeries(fixed_and_variable_modified_peptide, 2, partial_loss_spectrum_generator, unshifted_partial_loss_series);
+                }
+
                 // generate all partial loss spectra (excluding the complete loss spectrum) merged into one spectrum
                 // get RNA fragment shifts in the MS2 (based on the precursor RNA/DNA)
                 const vector<NucleotideToFeasibleFragmentAdducts>& feasible_MS2_adducts = all_feasible_fragment_adducts.at(precursor_rna_adduct).feasible_adducts;
@@ -2003,24 +2071,22 @@ protected:
                     // shifted b- / y- / a-ions
                     // generate shifted_immonium_ions_sub_score_spectrum.empty
                     RNPxlFragmentIonGenerator::generatePartialLossSpectrum(unmodified_sequence,
-                                                fixed_and_variable_modified_peptide,
                                                 current_peptide_mass_without_RNA,
                                                 precursor_rna_adduct,
                                                 precursor_rna_weight,
                                                 1,
                                                 partial_loss_modification,
-                                                partial_loss_spectrum_generator,
+                                                unshifted_partial_loss_series,
                                                 partial_loss_spectrum_z1);
                     for (auto& n : partial_loss_spectrum_z1.getStringDataArrays()[0]) { n[0] = 'y'; } // hyperscore hack
 
                     RNPxlFragmentIonGenerator::generatePartialLossSpectrum(unmodified_sequence,
-                                                fixed_and_variable_modified_peptide,
                                                 current_peptide_mass_without_RNA,
                                                 precursor_rna_adduct,
                                                 precursor_rna_weight,
                                                 2, // don't know the charge of the precursor at that point
                                                 partial_loss_modification,
-                                                partial_loss_spectrum_generator,
+                                                unshifted_partial_loss_series,
                                                 partial_loss_spectrum_z2);
                     for (auto& n : partial_loss_spectrum_z2.getStringDataArrays()[0]) { n[0] = 'y'; } // hyperscore hack
                   }
@@ -2034,33 +2100,22 @@ protected:
                     marker_ions_sub_score_spectrum_z1.getIntegerDataArrays()[0],
                     marker_ions_sub_score_spectrum_z1.getStringDataArrays()[0]);
 
-                  for (auto l = low_it; l != up_it; ++l)
+                  Size total_loss_index = 0;
+                  for (auto l = low_it; l != up_it; ++l, ++total_loss_index)
                   {
+                    const TotalLossScores_& tls = total_loss_scores[total_loss_index];
+
+                    // no good hit
+                    if (tls.score < 0.001) { continue; }
+
                     //const double exp_pc_mass = l->first;
                     const Size& scan_index = l->second.first;
                     const int& isotope_error = l->second.second;
                     const PeakSpectrum& exp_spectrum = spectra[scan_index];
-                    float tlss_MIC(0), tlss_err(0), tlss_Morph(0),
-                      immonium_sub_score(0), precursor_sub_score(0),
-                      a_ion_sub_score(0), partial_loss_sub_score(0), marker_ions_sub_score(0),
-                      plss_MIC(0), plss_err(0), plss_Morph(0), score;
-
-                    const int & exp_pc_charge = exp_spectrum.getPrecursors()[0].getCharge();
-                    PeakSpectrum & total_loss_spectrum = (exp_pc_charge < 3) ? total_loss_spectrum_z1 : total_loss_spectrum_z2;
-
-                    scoreTotalLossFragments_(exp_spectrum,
-                                             total_loss_spectrum,
-                                             fragment_mass_tolerance, fragment_mass_tolerance_unit_ppm,
-                                             a_ion_sub_score_spectrum,
-                                             precursor_sub_score_spectrum,
-                                             immonium_sub_score_spectrum,
-                                             score,
-                                             tlss_MIC,
-                                             tlss_err,
-                                             tlss_Morph,
-                                             immonium_sub_score,
-                                             precursor_sub_score,
-                                             a_ion_sub_score);
+                    float tlss_MIC(tls.MIC), tlss_err(tls.err), tlss_Morph(tls.Morph),
+                      immonium_sub_score(tls.immonium_score), precursor_sub_score(tls.precursor_score),
+                      a_ion_sub_score(tls.a_ion_score), partial_loss_sub_score(0), marker_ions_sub_score(0),
+                      plss_MIC(0), plss_err(0), plss_Morph(0), score(tls.score);
 
                     scorePartialLossFragments_(exp_spectrum,
                                                fragment_mass_tolerance, fragment_mass_tolerance_unit_ppm,
@@ -2070,9 +2125,6 @@ protected:
                                                marker_ions_sub_score,
                                                plss_MIC, plss_err, plss_Morph);
 
-                    // no good hit
-                    if (score < 0.001) { continue; }
-
                     // add peptide hit
                     AnnotatedHit ah;
                     ah.sequence = *cit; // copy StringView
@@ -2915,6 +2967,43 @@ void RNPxlSearch::RNPxlFragmentIonGenerator::generatePartialLossSpectrum(const S
                                                                          const TheoreticalSpectrumGenerator &partial_loss_spectrum_generator,
                                                                          PeakSpectrum &partial_loss_spectrum)
 {
+  vector<PeakSpectrum> unshifted_series;
+  generateUnshiftedSeries(fixed_and_variable_modified_peptide, precursor_charge, partial_loss_spectrum_generator, unshifted_series);
+  generatePartialLossSpectrum(unmodified_sequence,
+                              fixed_and_variable_modified_peptide_weight,
+                              precursor_rna_adduct,
+                              precursor_rna_weight,
+                              precursor_charge,
+                              partial_loss_modification,
+                              unshifted_series,
+                              partial_loss_spectrum);
+}
+
+void RNPxlSearch::RNPxlFragmentIonGenerator::generateUnshiftedSeries(const AASequence &fixed_and_variable_modified_peptide,
+                                                                     const int max_charge,
+                                                                     const TheoreticalSpectrumGenerator &partial_loss_spectrum_generator,
+                                                                     vector<PeakSpectrum> &unshifted_series)
+{
+  unshifted_series.resize(std::max(max_charge, 0));
+  for (int z = 1; z <= max_charge; ++z)
+  {
+    PeakSpectrum& series = unshifted_series[z - 1];
+    series.clear(true);
+    partial_loss_spectrum_generator.getSpectrum(series, fixed_and_variable_modified_peptide, z, z);
+  }
+}
+
+void RNPxlSearch::RNPxlFragmentIonGenerator::generatePartialLossSpectrum(const String &unmodified_sequence,
+                                                                         const double &fixed_and_variable_modified_peptide_weight,
+                                                                         const String &precursor_rna_adduct,
+                                                                         const double &precursor_rna_weight,
+                                                                         const int &precursor_charge,
+                                                                         const vector<RNPxlSearch::FragmentAdductDefinition_> &partial_loss_modification,
+                                                                         const vector<PeakSpectrum> &unshifted_series,
+                                                                         PeakSpectrum &partial_loss_spectrum)
+{
+  OPENMS_PRECONDITION(unshifted_series.size() >= static_cast<Size>(std::max(precursor_charge, 0)), "Unshifted ion series missing for some charges.");
+
   partial_loss_spectrum.getIntegerDataArrays().resize(1);
   PeakSpectrum::IntegerDataArray& partial_loss_spectrum_charge = partial_loss_spectrum.getIntegerDataArrays()[0];
 
@@ -2959,9 +3048,8 @@ void RNPxlSearch::RNPxlFragmentIonGenerator::generatePartialLossSpectrum(const S
     // For every charge state
     for (int z = 1; z <= precursor_charge; ++z)
     {
-      // 1. create unshifted peaks (a,b,y, MS2 precursor ions up to pc charge)
-      PeakSpectrum tmp_shifted_series_peaks;
-      partial_loss_spectrum_generator.getSpectrum(tmp_shifted_series_peaks, fixed_and_variable_modified_peptide, z, z);
+      // 1. copy unshifted peaks (a,b,y, MS2 precursor ions up to pc charge)
+      PeakSpectrum tmp_shifted_series_peaks = unshifted_series[z - 1];
 
       PeakSpectrum::StringDataArray& tmp_shifted_series_annotations = tmp_shifted_series_peaks.getStringDataArrays()[0];
       PeakSpectrum::IntegerDataArray& tmp_shifted_series_charges = tmp_shifted_series_peaks.getIntegerDataArrays()[0];
@@ -34,11 +34,14 @@
 
 #include <OpenMS/APPLICATIONS/TOPPBase.h>
 
+#include <OpenMS/ANALYSIS/ID/FragmentIndex.h>
 #include <OpenMS/ANALYSIS/ID/PeptideIndexing.h>
 #include <OpenMS/ANALYSIS/RNPXL/ModifiedPeptideGenerator.h>
 #include <OpenMS/ANALYSIS/RNPXL/HyperScore.h>
+#include <OpenMS/ANALYSIS/RNPXL/TheoreticalSpectrumBatch.h>
 
 #include <OpenMS/CHEMISTRY/ModificationsDB.h>
+#include <OpenMS/CHEMISTRY/ResidueMassTable.h>
 #include <OpenMS/CHEMISTRY/TheoreticalSpectrumGenerator.h>
 #include <OpenMS/CHEMISTRY/ResidueModification.h>
 
@@ -58,6 +61,7 @@
 #include <OpenMS/FORMAT/MzMLFile.h>
 #include <OpenMS/FORMAT/FASTAFile.h>
 #include <OpenMS/FORMAT/MzMLFile.h>
+#include <OpenMS/FORMAT/PeptideDatabaseFile.h>
 
 #include <OpenMS/KERNEL/MSSpectrum.h>
 #include <OpenMS/KERNEL/MSExperiment.h>
@@ -68,6 +72,7 @@
 
 #include <map>
 #include <algorithm>
+#include <tuple>
 
 #ifdef _OPENMP
   #include <omp.h>
@@ -87,7 +92,8 @@ class SimpleSearchEngine :
   struct AnnotatedHit
   {
     StringView sequence;
-    SignedSize peptide_mod_index; // enumeration index of the non-RNA peptide modification
+    SignedSize peptide_mod_index; // enumeration index of the non-RNA peptide modification (-1: sequence is already modified)
+    SignedSize database_peptide = -1; // index of the unmodified peptide in the peptide database (if used)
     double score = 0; // main score
     std::vector<PeptideHit::PeakAnnotation> fragment_annotations;
 
@@ -111,9 +117,11 @@ class SimpleSearchEngine :
       registerInputFile_("in", "<file>", "", "input file ");
       setValidFormats_("in", ListUtils::create<String>("mzML"));
 
-      registerInputFile_("database", "<file>", "", "input file ");
+      registerInputFile_("database", "<file>", "", "input file (not needed if 'peptide_database' is given)", false);
       setValidFormats_("database", ListUtils::create<String>("fasta"));
 
+      registerInputFile_("peptide_database", "<file>", "", "Digested and modified peptides created with PeptideDatabaseBuilder (instead of 'database'), the 'enzyme', 'peptide' and 'modifications' settings need to match the ones used to create it.", false);
+
       registerOutputFile_("out", "<file>", "", "output file ");
       setValidFormats_("out", ListUtils::create<String>("idXML"));
 
@@ -134,6 +142,9 @@ class SimpleSearchEngine :
       IntList isotopes = {0, 1};
       registerIntList_("precursor:isotopes", "<num>", isotopes, "Corrects for mono-isotopic peak misassignments. (E.g.: 1 = prec. may be misassigned to first isotopic peak)", false, false);
 
+      DoubleList mass_offsets = {0.0};
+      registerDoubleList_("precursor:mass_offsets", "<Da>", mass_offsets, "Mass offsets (precursor mass minus peptide mass) to consider, e.g. for unspecified modifications. Use together with 'fragment_index:enabled' for fast searches with many offsets.", false, true);
+
       registerTOPPSubsection_("fragment", "Fragments (Product Ion) Options");
       registerDoubleOption_("fragment:mass_tolerance", "<tolerance>", 10.0, "Fragment mass tolerance", false);
 
@@ -164,6 +175,15 @@ class SimpleSearchEngine :
       registerIntOption_("peptide:missed_cleavages", "<num>", 1, "Number of missed cleavages.", false, false);
       registerStringOption_("peptide:motif", "<regex>", "", "If set, only peptides that contain this motif (provided as RegEx) will be considered.", false);
 
+      registerTOPPSubsection_("fragment_index", "Fragment Ion Index Options");
+      registerFlag_("fragment_index:enabled", "Index the fragment ions of all peptides once and only score peptides with enough fragments matching the peaks of a spectrum. Much faster for wide precursor mass tolerances (open searches) and many mass offsets.", false);
+      registerDoubleOption_("fragment_index:bin_size", "<Th>", 0.05, "Width of the fragment m/z bins of the index.", false, true);
+      setMinFloat_("fragment_index:bin_size", 0.001);
+      registerIntOption_("fragment_index:min_matched_peaks", "<num>", 1, "Minimum number of spectrum peaks matching a fragment ion of a peptide for the peptide to be scored (1 = same results as without the index).", false, true);
+      setMinInt_("fragment_index:min_matched_peaks", 1);
+      registerIntOption_("fragment_index:max_candidates", "<num>", 0, "Maximum number of peptides (with the most matching peaks) scored per spectrum (0 = all).", false, true);
+      setMinInt_("fragment_index:max_candidates", 0);
+
       registerTOPPSubsection_("report", "Reporting Options");
       registerIntOption_("report:top_hits", "<num>", 1, "Maximum number of top scoring hits per spectrum that are reported.", false, true);
     }
@@ -237,8 +257,12 @@ class SimpleSearchEngine :
       Size top_hits,
       const vector<ResidueModification>& fixed_modifications, 
       const vector<ResidueModification>& variable_modifications, 
-      Size max_variable_mods_per_peptide)
+      Size max_variable_mods_per_peptide,
+      const PeptideDatabaseFile* peptide_db = nullptr)
     {
+      // accessions of all proteins referenced by hits (only with a peptide database)
+      set<String> referenced_proteins;
+
       // remove all but top n scoring
 #ifdef _OPENMP
 #pragma omp parallel for
@@ -275,18 +299,42 @@ class SimpleSearchEngine :
             PeptideHit ph;
             ph.setCharge(charge);
 
-            // get unmodified string
+            // get unmodified string (or modified string from the peptide database)
             AASequence aas = AASequence::fromString(a_it->sequence.getString());
 
-            // reapply modifications (because for memory reasons we only stored the index and recreation is fast)
-            vector<AASequence> all_modified_peptides;
-            ModifiedPeptideGenerator::applyFixedModifications(fixed_modifications.begin(), fixed_modifications.end(), aas);
-            ModifiedPeptideGenerator::applyVariableModifications(variable_modifications.begin(), variable_modifications.end(), aas, max_variable_mods_per_peptide, all_modified_peptides);
+            if (a_it->peptide_mod_index >= 0)
+            {
+              // reapply modifications (because for memory reasons we only stored the index and recreation is fast)
+              vector<AASequence> all_modified_peptides;
+              ModifiedPeptideGenerator::applyFixedModifications(fixed_modifications.begin(), fixed_modifications.end(), aas);
+              ModifiedPeptideGenerator::applyVariableModifications(variable_modifications.begin(), variable_modifications.end(), aas, max_variable_mods_per_peptide, all_modified_peptides);
 
-            // reannotate much more memory heavy AASequence object
-            AASequence fixed_and_variable_modified_peptide = all_modified_peptides[a_it->peptide_mod_index]; 
+              // reannotate much more memory heavy AASequence object
+              aas = all_modified_peptides[a_it->peptide_mod_index];
+            }
             ph.setScore(a_it->score);
-            ph.setSequence(fixed_and_variable_modified_peptide);
+            ph.setSequence(aas);
+
+            // the peptide database knows the proteins, no need to run PeptideIndexing
+            if (peptide_db != nullptr && a_it->database_peptide >= 0)
+            {
+              vector<PeptideDatabaseFile::PeptideReference> references;
+              peptide_db->getPeptideReferences(a_it->database_peptide, references);
+              bool target = false, decoy = false;
+              for (const PeptideDatabaseFile::PeptideReference& ref : references)
+              {
+                const String accession = peptide_db->getProteinAccession(ref.protein);
+                ph.addPeptideEvidence(PeptideEvidence(accession, ref.start, ref.start + aas.size() - 1, ref.aa_before, ref.aa_after));
+                (accession.hasPrefix("DECOY_") ? decoy : target) = true;
+#ifdef _OPENMP
+#pragma omp critical (referenced_proteins_access)
+#endif
+                {
+                  referenced_proteins.insert(accession);
+                }
+              }
+              ph.setMetaValue("target_decoy", target ? (decoy ? "target+decoy" : "target") : "decoy");
+            }
             phs.push_back(ph);
         }
         pi.setHits(phs);
@@ -306,9 +354,16 @@ class SimpleSearchEngine :
     protein_ids[0].setDateTime(DateTime::now());
     protein_ids[0].setSearchEngine("SimpleSearchEngine");
     protein_ids[0].setSearchEngineVersion(VersionInfo::getVersion());
+    for (const String& accession : referenced_proteins)
+    {
+      ProteinHit hit;
+      hit.setAccession(accession);
+      hit.setMetaValue("target_decoy", accession.hasPrefix("DECOY_") ? "decoy" : "target");
+      protein_ids[0].insertHit(hit);
+    }
 
     ProteinIdentification::SearchParameters search_parameters;
-    search_parameters.db = getStringOption_("database");
+    search_parameters.db = peptide_db != nullptr ? getStringOption_("peptide_database") : getStringOption_("database");
     search_parameters.charges = String(getIntOption_("precursor:min_charge")) + ":" + String(getIntOption_("precursor:max_charge"));
 
     ProteinIdentification::PeakMassType mass_type = ProteinIdentification::MONOISOTOPIC;
@@ -339,6 +394,7 @@ class SimpleSearchEngine :
       double precursor_mass_tolerance = getDoubleOption_("precursor:mass_tolerance");
       bool precursor_mass_tolerance_unit_ppm = (getStringOption_("precursor:mass_tolerance_unit") == "ppm");
       IntList precursor_isotopes = getIntList_("precursor:isotopes");
+      DoubleList precursor_mass_offsets = getDoubleList_("precursor:mass_offsets");
 
       double fragment_mass_tolerance = getDoubleOption_("fragment:mass_tolerance");
       bool fragment_mass_tolerance_unit_ppm = (getStringOption_("fragment:mass_tolerance_unit") == "ppm");
@@ -366,8 +422,46 @@ class SimpleSearchEngine :
       vector<ResidueModification> variable_modifications = getModifications_(varModNames);
       Size max_variable_mods_per_peptide = getIntOption_("modifications:variable_max_per_peptide");
 
+      // residue and modification masses for lock-free mass computations in the digestion loop
+      StringList all_mod_names(fixedModNames);
+      all_mod_names.insert(all_mod_names.end(), varModNames.begin(), varModNames.end());
+      ResidueMassTable residue_masses(all_mod_names);
+      vector<Size> fixed_mod_indices, variable_mod_indices;
+      for (const String& name : fixedModNames) { fixed_mod_indices.push_back(residue_masses.getModificationIndex(name)); }
+      for (const String& name : varModNames) { variable_mod_indices.push_back(residue_masses.getModificationIndex(name)); }
+
       size_t top_hits = static_cast<size_t>(getIntOption_("report:top_hits"));
 
+      // use precomputed peptides if available
+      const String in_peptide_db = getStringOption_("peptide_database");
+      PeptideDatabaseFile peptide_db;
+      if (!in_peptide_db.empty())
+      {
+        peptide_db.load(in_peptide_db);
+        PeptideDatabaseFile::Settings settings;
+        settings.enzyme = getStringOption_("enzyme");
+        settings.missed_cleavages = getIntOption_("peptide:missed_cleavages");
+        settings.min_length = getIntOption_("peptide:min_size");
+        settings.max_length = getIntOption_("peptide:max_size");
+        settings.fixed_modifications = fixedModNames;
+        settings.variable_modifications = varModNames;
+        settings.max_variable_mods_per_peptide = max_variable_mods_per_peptide;
+        if (peptide_db.getSettings() != settings)
+        {
+          LOG_ERROR << "Error: The peptide database '" << in_peptide_db << "' was created with different enzyme, peptide or modification settings." << endl;
+          return ILLEGAL_PARAMETERS;
+        }
+      }
+      else if (in_db.empty())
+      {
+        LOG_ERROR << "Error: Either 'database' or 'peptide_database' needs to be given." << endl;
+        return ILLEGAL_PARAMETERS;
+      }
+
+      const bool use_fragment_index = getFlag_("fragment_index:enabled");
+      const Size min_matched_peaks = getIntOption_("fragment_index:min_matched_peaks");
+      const Size max_candidates = getIntOption_("fragment_index:max_candidates");
+
       // load MS2 map
       PeakMap spectra;
       MzMLFile f;
@@ -386,10 +480,11 @@ class SimpleSearchEngine :
 
       // build multimap of precursor mass to scan index
       multimap<double, Size> multimap_mass_2_scan_index;
+      vector<vector<double> > scan_precursor_masses(spectra.size());
       for (PeakMap::ConstIterator s_it = spectra.begin(); s_it != spectra.end(); ++s_it)
       {
         int scan_index = s_it - spectra.begin();
-        vector<Precursor> precursor = s_it->getPrecursors();
+        const vector<Precursor>& precursor = s_it->getPrecursors();
 
         // there should only one precursor and MS2 should contain at least a few peaks to be considered (e.g. at least for every AA in the peptide)
         if (precursor.size() == 1 && s_it->size() >= peptide_min_size)
@@ -403,7 +498,7 @@ class SimpleSearchEngine :
 
           double precursor_mz = precursor[0].getMZ();
 
-          // calculate precursor mass (optionally corrected for misassignment) and map it to MS scan index
+          // calculate precursor mass (optionally corrected for misassignment and mass offsets) and map it to MS scan index
           for (int isotope_number : precursor_isotopes)
           {
             double precursor_mass = (double) precursor_charge * precursor_mz - (double) precursor_charge * Constants::PROTON_MASS_U;
@@ -411,7 +506,11 @@ class SimpleSearchEngine :
             // correct for monoisotopic misassignments of the precursor annotation
             if (isotope_number != 0) { precursor_mass -= isotope_number * Constants::C13C12_MASSDIFF_U; }
 
-            multimap_mass_2_scan_index.insert(make_pair(precursor_mass, scan_index));
+            for (double mass_offset : precursor_mass_offsets)
+            {
+              multimap_mass_2_scan_index.insert(make_pair(precursor_mass - mass_offset, scan_index));
+              scan_precursor_masses[scan_index].push_back(precursor_mass - mass_offset);
+            }
           }
         }
       }
@@ -433,22 +532,119 @@ class SimpleSearchEngine :
       for (size_t i = 0; i != annotated_hits_lock.size(); i++) { omp_init_lock(&(annotated_hits_lock[i])); }
 #endif
 
-      progresslogger.startProgress(0, 1, "Load database from FASTA file...");
+      // the peptide database replaces the FASTA file
       FASTAFile fastaFile;
       vector<FASTAFile::FASTAEntry> fasta_db;
-      fastaFile.load(in_db, fasta_db);
-      progresslogger.endProgress();
+      if (in_peptide_db.empty())
+      {
+        progresslogger.startProgress(0, 1, "Load database from FASTA file...");
+        fastaFile.load(in_db, fasta_db);
+        progresslogger.endProgress();
+      }
 
       const Size missed_cleavages = getIntOption_("peptide:missed_cleavages");
       ProteaseDigestion digestor;
       digestor.setEnzyme(getStringOption_("enzyme"));
       digestor.setMissedCleavages(missed_cleavages);
 
-      progresslogger.startProgress(0, (Size)(fasta_db.end() - fasta_db.begin()), "Scoring peptide models against spectra...");
-
       // lookup for processed peptides. must be defined outside of omp section and synchronized
       set<StringView> processed_petides;
 
+      // fragment ion index and the peptides it contains (only used with fragment_index:enabled)
+      FragmentIndex fragment_index(getDoubleOption_("fragment_index:bin_size"));
+      vector<AnnotatedHit> indexed_peptides;
+#ifdef _OPENMP
+      vector<TheoreticalSpectrumGenerator::FragmentIonBuffer> fragment_ion_buffers(omp_get_max_threads());
+#else
+      vector<TheoreticalSpectrumGenerator::FragmentIonBuffer> fragment_ion_buffers(1);
+#endif
+
+      // determine MS2 precursors that match to a peptide mass
+      auto matchingPrecursors = [&](double current_peptide_mass)
+      {
+        if (precursor_mass_tolerance_unit_ppm) // ppm
+        {
+          return make_pair(multimap_mass_2_scan_index.lower_bound(current_peptide_mass - 0.5 * current_peptide_mass * precursor_mass_tolerance * 1e-6),
+                           multimap_mass_2_scan_index.upper_bound(current_peptide_mass + 0.5 * current_peptide_mass * precursor_mass_tolerance * 1e-6));
+        }
+        else // Dalton
+        {
+          return make_pair(multimap_mass_2_scan_index.lower_bound(current_peptide_mass - 0.5 * precursor_mass_tolerance),
+                           multimap_mass_2_scan_index.upper_bound(current_peptide_mass + 0.5 * precursor_mass_tolerance));
+        }
+      };
+
+      // score a candidate against all matching spectra (or add it to the fragment ion index), ah identifies the candidate
+      auto processCandidate = [&](const AASequence& candidate, double current_peptide_mass, AnnotatedHit ah)
+      {
+        multimap<double, Size>::const_iterator low_it, up_it;
+        std::tie(low_it, up_it) = matchingPrecursors(current_peptide_mass);
+
+        // no matching precursor in data
+        if (low_it == up_it) { return; }
+
+        // only index the peptide, spectra are searched once all peptides are known
+        if (use_fragment_index)
+        {
+          // only the b and y ions are needed, generate them into the (reused) buffer of this thread
+#ifdef _OPENMP
+          TheoreticalSpectrumGenerator::FragmentIonBuffer& fragment_ions = fragment_ion_buffers[omp_get_thread_num()];
+#else
+          TheoreticalSpectrumGenerator::FragmentIonBuffer& fragment_ions = fragment_ion_buffers[0];
+#endif
+          spectrum_generator.getFragmentIons(fragment_ions, candidate, 1, 1);
+#ifdef _OPENMP
+#pragma omp critical (fragment_index_access)
+#endif
+          {
+            fragment_index.addPeptide(current_peptide_mass, fragment_ions.ions);
+            indexed_peptides.push_back(ah);
+          }
+          return;
+        }
+
+        // create theoretical spectrum
+        PeakSpectrum theo_spectrum;
+
+        // add peaks for b and y ions with charge 1
+        spectrum_generator.getSpectrum(theo_spectrum, candidate, 1, 1);
+
+        // sort by mz
+        theo_spectrum.sortByPosition();
+
+        for (; low_it != up_it; ++low_it)
+        {
+          const Size& scan_index = low_it->second;
+          const PeakSpectrum& exp_spectrum = spectra[scan_index];
+          // const int& charge = exp_spectrum.getPrecursors()[0].getCharge();
+          const double& score = HyperScore::compute(fragment_mass_tolerance, fragment_mass_tolerance_unit_ppm, exp_spectrum, theo_spectrum);
+
+          if (score == 0) { continue; } // no hit?
+
+          // add peptide hit
+          ah.score = score;
+
+#ifdef _OPENMP
+          omp_set_lock(&(annotated_hits_lock[scan_index]));
+          {
+#endif
+            annotated_hits[scan_index].push_back(ah);
+
+            // prevent vector from growing indefinitly (memory) but don't shrink the vector every time
+            if (annotated_hits[scan_index].size() >= 2 * top_hits)
+            {
+              std::partial_sort(annotated_hits[scan_index].begin(), annotated_hits[scan_index].begin() + top_hits, annotated_hits[scan_index].end(), AnnotatedHit::hasBetterScore);
+              annotated_hits[scan_index].resize(top_hits); 
+            }
+#ifdef _OPENMP
+          }
+          omp_unset_lock(&(annotated_hits_lock[scan_index]));
+#endif
+        }
+      };
+
+      progresslogger.startProgress(0, (Size)(fasta_db.end() - fasta_db.begin()), "Scoring peptide models against spectra...");
+
       // set minimum / maximum size of peptide after digestion
       Size min_peptide_length = getIntOption_("peptide:min_size");
       Size max_peptide_length = getIntOption_("peptide:max_size");
@@ -472,6 +668,8 @@ class SimpleSearchEngine :
         vector<StringView> current_digest;
         digestor.digestUnmodified(fasta_db[fasta_index].sequence, current_digest, min_peptide_length, max_peptide_length);
 
+        ResidueMassTable::EncodedSequence encoded_peptide;
+
         for (auto const & c : current_digest)
         { 
           const String current_peptide = c.getString();
@@ -507,6 +705,17 @@ class SimpleSearchEngine :
 #endif
           ++count_peptides;
 
+          // skip peptides without any (modified) variant matching a precursor mass before creating AASequence
+          // objects (requires locking, see below); the mass range is computed from mass differences and might
+          // deviate slightly from the masses of the AASequence variants
+          if (residue_masses.encode(current_peptide, encoded_peptide))
+          {
+            double min_mass, max_mass;
+            residue_masses.applyFixedModifications(fixed_mod_indices, encoded_peptide);
+            residue_masses.getMassRange(encoded_peptide, variable_mod_indices, max_variable_mods_per_peptide, min_mass, max_mass);
+            if (matchingPrecursors(min_mass - 1e-3).first == matchingPrecursors(max_mass + 1e-3).second) { continue; }
+          }
+
           vector<AASequence> all_modified_peptides;
 
           // this critial section is because ResidueDB is not thread safe and new residues are created based on the PTMs
@@ -522,71 +731,165 @@ class SimpleSearchEngine :
           for (SignedSize mod_pep_idx = 0; mod_pep_idx < (SignedSize)all_modified_peptides.size(); ++mod_pep_idx)
           {
             const AASequence& candidate = all_modified_peptides[mod_pep_idx];
-            double current_peptide_mass = candidate.getMonoWeight();
 
-            // determine MS2 precursors that match to the current peptide mass
-            multimap<double, Size>::const_iterator low_it;
-            multimap<double, Size>::const_iterator up_it;
+            AnnotatedHit ah;
+            ah.sequence = c;
+            ah.peptide_mod_index = mod_pep_idx;
+            processCandidate(candidate, candidate.getMonoWeight(), ah);
+          }
+        }
+      }
+      progresslogger.endProgress();
+
+      // peptides and masses are precomputed, only candidates matching a precursor need to be processed
+      if (!in_peptide_db.empty())
+      {
+        count_proteins = peptide_db.getNrProteins();
+        progresslogger.startProgress(0, peptide_db.getNrVariants(), "Scoring peptide models from peptide database against spectra...");
+        Size count_variants(0);
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic, 1000)
+#endif
+        for (SignedSize variant = 0; variant < (SignedSize)peptide_db.getNrVariants(); ++variant)
+        {
+#ifdef _OPENMP
+#pragma omp atomic
+#endif
+          ++count_variants;
+
+          IF_MASTERTHREAD
+          {
+            progresslogger.setProgress(count_variants);
+          }
+
+          const double current_peptide_mass = peptide_db.getVariantMass(variant);
+          const auto precursor_range = matchingPrecursors(current_peptide_mass);
+          if (precursor_range.first == precursor_range.second) { continue; }
+
+          const Size peptide = peptide_db.getVariantPeptide(variant);
 
+          // if a peptide motif is provided skip all peptides without match
+          if (!peptide_motif.empty() && !boost::regex_match(peptide_db.getPeptideSequence(peptide).getString(), peptide_motif_regex)) { continue; }
+
+#ifdef _OPENMP
+#pragma omp atomic
+#endif
+          ++count_peptides;
+
+          AnnotatedHit ah;
+          ah.sequence = peptide_db.getVariantSequence(variant);
+          ah.peptide_mod_index = -1;
+          ah.database_peptide = peptide;
+
+          AASequence candidate;
+          // this critial section is because ResidueDB is not thread safe and new residues are created based on the PTMs
+#ifdef _OPENMP
+#pragma omp critical (residuedb_access)
+#endif
+          {
+            candidate = AASequence::fromString(ah.sequence.getString());
+          }
+          processCandidate(candidate, current_peptide_mass, ah);
+        }
+        progresslogger.endProgress();
+      }
+
+      if (use_fragment_index)
+      {
+        progresslogger.startProgress(0, 1, "Building fragment ion index...");
+        fragment_index.build();
+        progresslogger.endProgress();
+        LOG_INFO << "Indexed peptides: " << fragment_index.size() << " with " << fragment_index.getNumberOfFragments() << " fragment ions" << endl;
+
+        progresslogger.startProgress(0, spectra.size(), "Searching spectra against fragment ion index...");
+        Size count_spectra(0);
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic)
+#endif
+        for (SignedSize scan_index = 0; scan_index < (SignedSize)spectra.size(); ++scan_index)
+        {
+#ifdef _OPENMP
+#pragma omp atomic
+#endif
+          ++count_spectra;
+
+          IF_MASTERTHREAD
+          {
+            progresslogger.setProgress(count_spectra);
+          }
+
+          if (scan_precursor_masses[scan_index].empty()) { continue; }
+
+          // peptide mass windows matching the precursor masses (the inverse of the tolerance window used above), merged if overlapping
+          vector<pair<double, double> > mass_windows;
+          for (double precursor_mass : scan_precursor_masses[scan_index])
+          {
             if (precursor_mass_tolerance_unit_ppm) // ppm
             {
-              low_it = multimap_mass_2_scan_index.lower_bound(current_peptide_mass - 0.5 * current_peptide_mass * precursor_mass_tolerance * 1e-6);
-              up_it = multimap_mass_2_scan_index.upper_bound(current_peptide_mass + 0.5 * current_peptide_mass * precursor_mass_tolerance * 1e-6);
+              mass_windows.push_back(make_pair(precursor_mass / (1.0 + 0.5 * precursor_mass_tolerance * 1e-6),
+                                               precursor_mass / (1.0 - 0.5 * precursor_mass_tolerance * 1e-6)));
             }
             else // Dalton
             {
-              low_it = multimap_mass_2_scan_index.lower_bound(current_peptide_mass - 0.5 * precursor_mass_tolerance);
-              up_it = multimap_mass_2_scan_index.upper_bound(current_peptide_mass + 0.5 * precursor_mass_tolerance);
+              mass_windows.push_back(make_pair(precursor_mass - 0.5 * precursor_mass_tolerance, precursor_mass + 0.5 * precursor_mass_tolerance));
             }
+          }
+          sort(mass_windows.begin(), mass_windows.end());
 
-            // no matching precursor in data
-            if (low_it == up_it) { continue; }
-
-            // create theoretical spectrum
-            PeakSpectrum theo_spectrum;
-
-            // add peaks for b and y ions with charge 1
-            spectrum_generator.getSpectrum(theo_spectrum, candidate, 1, 1);
+          const PeakSpectrum& exp_spectrum = spectra[scan_index];
+          vector<FragmentIndex::Candidate> candidates;
+          for (Size w = 0; w < mass_windows.size(); )
+          {
+            pair<double, double> window = mass_windows[w];
+            for (++w; w < mass_windows.size() && mass_windows[w].first <= window.second; ++w)
+            {
+              window.second = max(window.second, mass_windows[w].second);
+            }
+            fragment_index.query(exp_spectrum, window.first, window.second, fragment_mass_tolerance, fragment_mass_tolerance_unit_ppm, min_matched_peaks, candidates);
+          }
 
-            // sort by mz
-            theo_spectrum.sortByPosition();
+          // only score the candidates with most matching peaks
+          if (max_candidates > 0 && candidates.size() > max_candidates)
+          {
+            stable_sort(candidates.begin(), candidates.end(), [](const FragmentIndex::Candidate& a, const FragmentIndex::Candidate& b)
+              {
+                return a.matched_peaks > b.matched_peaks;
+              });
+            candidates.resize(max_candidates);
+          }
 
-            for (; low_it != up_it; ++low_it)
-            {
-              const Size& scan_index = low_it->second;
-              const PeakSpectrum& exp_spectrum = spectra[scan_index];
-              // const int& charge = exp_spectrum.getPrecursors()[0].getCharge();
-              const double& score = HyperScore::compute(fragment_mass_tolerance, fragment_mass_tolerance_unit_ppm, exp_spectrum, theo_spectrum);
+          // score all candidates of this spectrum at once
+          PeakSpectrum theo_spectrum;
+          TheoreticalSpectrumBatch theo_batch;
+          vector<double> batch_scores;
+          for (const FragmentIndex::Candidate& candidate : candidates)
+          {
+            fragment_index.getTheoreticalSpectrum(candidate.peptide, theo_spectrum);
+            theo_batch.add(theo_spectrum);
+          }
+          HyperScore::compute(fragment_mass_tolerance, fragment_mass_tolerance_unit_ppm, exp_spectrum, theo_batch, batch_scores);
 
-              if (score == 0) { continue; } // no hit?
+          for (Size c = 0; c < candidates.size(); ++c)
+          {
+            const double score = batch_scores[c];
 
-              // add peptide hit
-              AnnotatedHit ah;
-              ah.sequence = c;
-              ah.peptide_mod_index = mod_pep_idx;
-              ah.score = score;
+            if (score == 0) { continue; } // no hit?
 
-#ifdef _OPENMP
-              omp_set_lock(&(annotated_hits_lock[scan_index]));
-              {
-#endif
-                annotated_hits[scan_index].push_back(ah);
+            // add peptide hit (each spectrum is processed by a single thread, no locking needed)
+            AnnotatedHit ah = indexed_peptides[candidates[c].peptide];
+            ah.score = score;
+            annotated_hits[scan_index].push_back(ah);
 
-                // prevent vector from growing indefinitly (memory) but don't shrink the vector every time
-                if (annotated_hits[scan_index].size() >= 2 * top_hits)
-                {
-                  std::partial_sort(annotated_hits[scan_index].begin(), annotated_hits[scan_index].begin() + top_hits, annotated_hits[scan_index].end(), AnnotatedHit::hasBetterScore);
-                  annotated_hits[scan_index].resize(top_hits); 
-                }
-#ifdef _OPENMP
-              }
-              omp_unset_lock(&(annotated_hits_lock[scan_index]));
-#endif
-	    }
+            // prevent vector from growing indefinitly (memory) but don't shrink the vector every time
+            if (annotated_hits[scan_index].size() >= 2 * top_hits)
+            {
+              std::partial_sort(annotated_hits[scan_index].begin(), annotated_hits[scan_index].begin() + top_hits, annotated_hits[scan_index].end(), AnnotatedHit::hasBetterScore);
+              annotated_hits[scan_index].resize(top_hits);
+            }
           }
         }
+        progresslogger.endProgress();
       }
-      progresslogger.endProgress();
 
       LOG_INFO << "Proteins: " << count_proteins << endl;
       LOG_INFO << "Peptides: " << count_peptides << endl;
@@ -603,7 +906,8 @@ class SimpleSearchEngine :
         top_hits,
         fixed_modifications, 
         variable_modifications, 
-        max_variable_mods_per_peptide
+        max_variable_mods_per_peptide,
+        in_peptide_db.empty() ? nullptr : &peptide_db
         );
       progresslogger.endProgress();
 
@@ -612,34 +916,37 @@ class SimpleSearchEngine :
       spectra.getPrimaryMSRunPath(ms_runs);
       protein_ids[0].setPrimaryMSRunPath(ms_runs);
 
-      // reindex peptides to proteins
-      PeptideIndexing indexer;
-      Param param_pi = indexer.getParameters();
-      param_pi.setValue("decoy_string", "DECOY_");
-      param_pi.setValue("decoy_string_position", "prefix");
-      param_pi.setValue("enzyme:name", getStringOption_("enzyme"));
-      param_pi.setValue("enzyme:specificity", "full");
-      param_pi.setValue("missing_decoy_action", "silent");
-      indexer.setParameters(param_pi);
-
-      PeptideIndexing::ExitCodes indexer_exit = indexer.run(fasta_db, protein_ids, peptide_ids);
-
-      if ((indexer_exit != PeptideIndexing::EXECUTION_OK) &&
-          (indexer_exit != PeptideIndexing::PEPTIDE_IDS_EMPTY))
+      // reindex peptides to proteins (protein references are already known with a peptide database)
+      if (in_peptide_db.empty())
       {
-        if (indexer_exit == PeptideIndexing::DATABASE_EMPTY)
+        PeptideIndexing indexer;
+        Param param_pi = indexer.getParameters();
+        param_pi.setValue("decoy_string", "DECOY_");
+        param_pi.setValue("decoy_string_position", "prefix");
+        param_pi.setValue("enzyme:name", getStringOption_("enzyme"));
+        param_pi.setValue("enzyme:specificity", "full");
+        param_pi.setValue("missing_decoy_action", "silent");
+        indexer.setParameters(param_pi);
+
+        PeptideIndexing::ExitCodes indexer_exit = indexer.run(fasta_db, protein_ids, peptide_ids);
+
+        if ((indexer_exit != PeptideIndexing::EXECUTION_OK) &&
+            (indexer_exit != PeptideIndexing::PEPTIDE_IDS_EMPTY))
         {
-          return INPUT_FILE_EMPTY;       
-        }
-        else if (indexer_exit == PeptideIndexing::UNEXPECTED_RESULT)
-        {
-          return UNEXPECTED_RESULT;
-        }
-        else
-        {
-          return UNKNOWN_ERROR;
+          if (indexer_exit == PeptideIndexing::DATABASE_EMPTY)
+          {
+            return INPUT_FILE_EMPTY;
+          }
+          else if (indexer_exit == PeptideIndexing::UNEXPECTED_RESULT)
+          {
+            return UNEXPECTED_RESULT;
+          }
+          else
+          {
+            return UNKNOWN_ERROR;
+          }
         }
-      } 
+      }
 
       // write ProteinIdentifications and PeptideIdentifications to IdXML
       IdXMLFile().store(out_idxml, protein_ids, peptide_ids);
@@ -42,6 +42,7 @@
 #include <OpenMS/ANALYSIS/QUANTITATION/KDTreeFeatureMaps.h>
 #include <OpenMS/CHEMISTRY/EmpiricalFormula.h>
 #include <OpenMS/CHEMISTRY/Element.h>
+#include <OpenMS/SYSTEM/ExecutionResources.h>
 #include <OpenMS/SYSTEM/File.h>
 
 #include <QtCore/QProcess>
@@ -51,6 +52,7 @@
 
 #include <OpenMS/DATASTRUCTURES/ListUtils.h>
 #include <fstream>
+#include <memory>
 
 using namespace OpenMS;
 using namespace std;
@@ -152,6 +154,8 @@ protected:
     registerIntOption_("isotope_pattern_iterations", "<num>", 3, "Number of iterations that should be performed to extract the C13 isotope pattern. If no peak is found (C13 distance) the function will abort. Be careful with noisy data - since this can lead to wrong isotope patterns.", false, true);
     registerFlag_("no_masstrace_info_isotope_pattern", "Use this flag if the masstrace information from a feature should be discarded and the isotope_pattern_iterations should be used instead.", true);
     registerFlag_("converter_mode", "Use this flag in combination with the out_ms file to only convert the input mzML and featureXML to an .ms file. Without further SIRIUS processing.", true);
+    registerIntOption_("sirius_instances", "<num>", 1, "Number of SIRIUS instances that run in parallel on equal parts of the compounds. The available threads are split between the instances.", false, true);
+    setMinInt_("sirius_instances", 1);
 
     // internal sirius parameters
     registerStringOption_("profile", "<choice>", "qtof", "Specify the used analysis profile", false);
@@ -225,7 +229,8 @@ protected:
     bool ion_tree = getFlag_("ion_tree");
     bool most_intense_ms2 = getFlag_("most_intense_ms2");
    
-    int threads = getIntOption_("threads");
+    int threads = ExecutionResources::getThreads();
+    const Size sirius_instances = getIntOption_("sirius_instances");
       
     //-------------------------------------------------------------
     // Determination of the Executable
@@ -307,18 +312,40 @@ protected:
       }
     }
 
-    // write msfile
-    SiriusMSFile::store(spectra, tmp_ms_file, feature_mapping, feature_only, isotope_pattern_iterations, no_mt_info);
-
     // converter_mode enabled 
     if (!out_ms.empty() && converter_mode)
     {
+      // write msfile
+      SiriusMSFile::store(spectra, tmp_ms_file, feature_mapping, feature_only, isotope_pattern_iterations, no_mt_info);
       QFile::copy(tmp_ms_file.toQString(), out_ms.toQString());
       LOG_WARN << "SiriusAdapter was used in converter mode and is terminated after openms preprocessing. \n"
                   "If you would like to run SIRIUS internally please disable the converter mode." << std::endl; 
       return EXECUTION_OK;
     }
 
+    // one .ms file and output folder per SIRIUS instance
+    std::vector<String> tmp_ms_files;
+    std::vector<String> out_dirs;
+    if (sirius_instances == 1)
+    {
+      tmp_ms_files.push_back(tmp_ms_file);
+      out_dirs.push_back(out_dir);
+    }
+    else
+    {
+      for (Size i = 0; i < sirius_instances; ++i)
+      {
+        tmp_ms_files.push_back(tmp_ms_file.prefix(tmp_ms_file.size() - 3) + "_" + String(i) + ".ms");
+        out_dirs.push_back(out_dir + "_" + String(i));
+      }
+    }
+
+    // write msfile(s)
+    SiriusMSFile::store(spectra, tmp_ms_files, feature_mapping, feature_only, isotope_pattern_iterations, no_mt_info);
+
+    // the threads are split between the SIRIUS instances
+    const int instance_threads = std::max(1, threads / static_cast<int>(sirius_instances));
+
     // assemble SIRIUS parameters
     QStringList process_params;
     process_params << "-p" << profile
@@ -330,9 +357,8 @@ protected:
                    << "--ppm-max" << ppm_max
                    << "--compound-timeout" << compound_timeout
                    << "--tree-timeout" << tree_timeout
-                   << "--processors" << QString::number(threads) 
-                   << "--quiet"
-                   << "--output" << out_dir.toQString(); //internal output folder for temporary SIRIUS output file storage
+                   << "--processors" << QString::number(instance_threads) 
+                   << "--quiet";
 
     // add flags 
     if (no_recalibration)
@@ -356,49 +382,81 @@ protected:
       process_params << "--mostintense-ms2";
     }
 
-    process_params << tmp_ms_file.toQString();
-
-    // the actual process
-    QProcess qp;
-    qp.setWorkingDirectory(path_to_executable); //since library paths are relative to sirius executable path
-    qp.start(executable, process_params); // does automatic escaping etc... start
-    std::stringstream ss;
-    ss << "COMMAND: " << executable.toStdString();
-    for (QStringList::const_iterator it = process_params.begin(); it != process_params.end(); ++it)
+    // start all SIRIUS instances (empty parts are skipped)
+    std::vector<std::unique_ptr<QProcess> > processes(tmp_ms_files.size());
+    for (Size i = 0; i < tmp_ms_files.size(); ++i)
     {
-        ss << " " << it->toStdString();
+      if (File::empty(tmp_ms_files[i]))
+      {
+        continue;
+      }
+
+      QStringList instance_params = process_params;
+      instance_params << "--output" << out_dirs[i].toQString(); //internal output folder for temporary SIRIUS output file storage
+      instance_params << tmp_ms_files[i].toQString();
+
+      // the actual process
+      processes[i].reset(new QProcess());
+      QProcess& qp = *processes[i];
+      qp.setWorkingDirectory(path_to_executable); //since library paths are relative to sirius executable path
+      qp.start(executable, instance_params); // does automatic escaping etc... start
+      std::stringstream ss;
+      ss << "COMMAND: " << executable.toStdString();
+      for (QStringList::const_iterator it = instance_params.begin(); it != instance_params.end(); ++it)
+      {
+          ss << " " << it->toStdString();
+      }
+      LOG_DEBUG << ss.str() << endl;
+      writeLog_("Executing: " + String(executable));
+      writeLog_("Working Dir is: " + path_to_executable);
     }
-    LOG_DEBUG << ss.str() << endl;
-    writeLog_("Executing: " + String(executable));
-    writeLog_("Working Dir is: " + path_to_executable);
-    const bool success = qp.waitForFinished(-1); // wait till job is finished
 
-    if (!success || qp.exitStatus() != 0 || qp.exitCode() != 0)
+    // collect the output of each instance as soon as it has finished
+    for (Size i = 0; i < processes.size(); ++i)
     {
-      writeLog_( "FATAL: External invocation of Sirius failed. Standard output and error were:");
-      const QString sirius_stdout(qp.readAllStandardOutput());
-      const QString sirius_stderr(qp.readAllStandardError());
-      writeLog_(sirius_stdout);
-      writeLog_(sirius_stderr);
-      writeLog_(String(qp.exitCode()));
+      if (!processes[i])
+      {
+        continue;
+      }
+      QProcess& qp = *processes[i];
+      const bool success = qp.waitForFinished(-1); // wait till job is finished
+
+      if (!success || qp.exitStatus() != 0 || qp.exitCode() != 0)
+      {
+        writeLog_( "FATAL: External invocation of Sirius failed. Standard output and error were:");
+        const QString sirius_stdout(qp.readAllStandardOutput());
+        const QString sirius_stderr(qp.readAllStandardError());
+        writeLog_(sirius_stdout);
+        writeLog_(sirius_stderr);
+        writeLog_(String(qp.exitCode()));
+        qp.close();
+
+        // stop the remaining instances
+        for (Size j = i + 1; j < processes.size(); ++j)
+        {
+          if (processes[j])
+          {
+            processes[j]->kill();
+            processes[j]->waitForFinished(-1);
+          }
+        }
+        return EXTERNAL_PROGRAM_ERROR;
+      }
+
       qp.close();
 
-      return EXTERNAL_PROGRAM_ERROR;
+      // extract path to subfolders (sirius internal folder structure)
+      QDirIterator it(out_dirs[i].toQString(), QDir::Dirs | QDir::NoDotAndDotDot, QDirIterator::NoIteratorFlags);
+      while (it.hasNext())
+      {
+        subdirs.push_back(it.next());
+      }
     }
 
-    qp.close();
-
     //-------------------------------------------------------------
     // writing output
     //-------------------------------------------------------------
 
-    // extract path to subfolders (sirius internal folder structure)
-    QDirIterator it(out_dir.toQString(), QDir::Dirs | QDir::NoDotAndDotDot, QDirIterator::NoIteratorFlags);
-    while (it.hasNext())
-    {
-      subdirs.push_back(it.next());
-    }
-
     // sort vector path list
     std::sort(subdirs.begin(), subdirs.end(), extractAndCompareScanIndexLess_);
 
@@ -439,7 +497,20 @@ protected:
     // should the ms file be retained (non-converter mode)
     if (!out_ms.empty())
     {  
-      QFile::copy(tmp_ms_file.toQString(), out_ms.toQString());
+      if (tmp_ms_files.size() == 1)
+      {
+        QFile::copy(tmp_ms_file.toQString(), out_ms.toQString());
+      }
+      else
+      {
+        // the parts are contiguous, their concatenation is the complete .ms file
+        std::ofstream os(out_ms.c_str(), std::ios::binary);
+        for (const String& part : tmp_ms_files)
+        {
+          std::ifstream is(part.c_str(), std::ios::binary);
+          os << is.rdbuf();
+        }
+      }
       LOG_INFO << "Preprocessed .ms files was moved to " << out_ms << std::endl; 
     }
 
@@ -455,10 +526,13 @@ protected:
         writeDebug_("Deleting temporary directory '" + String(tmp_dir) + "'. Set debug level to 2 or higher to keep it.", 0);
         File::removeDir(tmp_dir);
       }
-      if (tmp_ms_file.empty() == false)
+      for (const String& part : tmp_ms_files)
       {
-        writeDebug_("Deleting temporary msfile '" + tmp_ms_file + "'. Set debug level to 2 or higher to keep it.", 0);
-        File::remove(tmp_ms_file); // remove msfile
+        if (part.empty() == false)
+        {
+          writeDebug_("Deleting temporary msfile '" + part + "'. Set debug level to 2 or higher to keep it.", 0);
+          File::remove(part); // remove msfile
+        }
       }
     }
 
@@ -37,6 +37,7 @@
 #include <OpenMS/FORMAT/MzDataFile.h>
 #include <OpenMS/FORMAT/MzMLFile.h>
 #include <OpenMS/FORMAT/FileHandler.h>
+#include <OpenMS/SYSTEM/ExecutionResources.h>
 #include <OpenMS/SYSTEM/File.h>
 #include <QtCore/QProcess>
 #include <QDir>
@@ -198,7 +199,7 @@ protected:
      }
 
      // Set the number of threads in SpectraST
-     Int threads = getIntOption_("threads");
+     Int threads = ExecutionResources::getThreads();
      arguments << (threads > 1 ?  QString::number(threads).prepend("-sP") : "-sP!");
 
      // Set the search file
@@ -36,6 +36,10 @@
 
 #include <OpenMS/FORMAT/FileTypes.h>
 #include <OpenMS/FORMAT/MzMLFile.h>
+#include <OpenMS/FORMAT/MzXMLFile.h>
+#include <OpenMS/FORMAT/SqMassFile.h>
+#include <OpenMS/FORMAT/TextFile.h>
+#include <OpenMS/FORMAT/HANDLERS/MzMLSqliteHandler.h>
 #include <OpenMS/FORMAT/CachedMzML.h>
 #include <OpenMS/FORMAT/HANDLERS/CachedMzMLHandler.h>
 #include <OpenMS/FORMAT/OPTIONS/PeakFileOptions.h>
@@ -47,9 +51,19 @@
 #include <OpenMS/FORMAT/DATAACCESS/MSDataWritingConsumer.h>
 #include <OpenMS/FORMAT/IndexedMzMLFileLoader.h>
 
+#include <OpenMS/SYSTEM/ExecutionResources.h>
+#include <OpenMS/SYSTEM/File.h>
+#include <OpenMS/SYSTEM/StopWatch.h>
 #include <OpenMS/SYSTEM/SysInfo.h>
 #include <OpenMS/INTERFACES/IMSDataConsumer.h>
+#include <OpenMS/MATH/STATISTICS/StatisticFunctions.h>
 
+#include <boost/random/mersenne_twister.hpp>
+
+#include <QtCore/QStringList>
+
+#include <algorithm>
+#include <fstream>
 #include <numeric>
 
 using namespace OpenMS;
@@ -70,6 +84,20 @@ using namespace OpenSwath;
   different methods as well as benchmarking external tools. Of course you can
   also calculate the TIC with this tool.
 
+  With @p read_method 'all', an (indexed) mzML input is converted to
+  cachedMzML, sqMass and mzXML and every read method is run on the
+  respective file, once for each number of threads given in
+  @p benchmark_threads. For every run, the report written to @p out (TSV)
+  contains the throughput (MB/s and spectra/s of a full pass over all
+  spectra), the bytes read by the process, the latency of reading single
+  randomly chosen spectra (for the random access methods) and the memory
+  consumption. If there is more than one run ('all' or several
+  @p benchmark_threads), each run is executed in a separate process of this
+  tool, thus the process counters (bytes read, memory and peak memory) only
+  cover the respective run and do not include the conversion.
+  Note that only the first run on a file reads it from cold storage (later
+  runs may be served from the page cache).
+
   <B>The command line parameters of this tool are:</B>
   @verbinclude UTILS_TICCalculator.cli
   <B>INI file documentation of this tool:</B>
@@ -152,6 +180,22 @@ private:
   std::ifstream ifs_;
 };
 
+/// result of one benchmark run (one read method at one number of threads)
+struct TICBenchmarkResult
+{
+  String method;
+  Int threads = 1;
+  Size nr_spectra = 0;
+  long int nr_peaks = 0;
+  double TIC = 0.0;
+  Size file_size = 0; ///< size of the file read (bytes)
+  double seconds = 0.0; ///< wall time for reading (and summing) all spectra
+  size_t bytes_read = 0; ///< bytes read by the process during the run (0 if not supported)
+  size_t memory = 0; ///< memory consumption after the run (KB)
+  size_t peak_memory = 0; ///< peak memory consumption of the process so far (KB)
+  std::vector<double> latencies; ///< wall time of the random single spectrum accesses (seconds)
+};
+
 class TOPPTICCalculator :
   public TOPPBase
 {
@@ -167,29 +211,52 @@ protected:
   {
     registerInputFile_("in", "<file>", "", "Input file to convert.");
     registerStringOption_("in_type", "<type>", "", "Input file type -- default: determined from file extension or content\n", false);
-    String formats("mzData,mzXML,mzML,cachedMzML,dta,dta2d,mgf,featureXML,consensusXML,ms2,fid,tsv,peplist,kroenik,edta");
+    String formats("mzData,mzXML,mzML,cachedMzML,sqMass,dta,dta2d,mgf,featureXML,consensusXML,ms2,fid,tsv,peplist,kroenik,edta");
     setValidFormats_("in", ListUtils::create<String>(formats));
     setValidStrings_("in_type", ListUtils::create<String>(formats));
     
-    registerStringOption_("read_method", "<method>", "regular", "Method to read the file", false);
-    String method("regular,indexed,indexed_parallel,streaming,cached,cached_parallel");
+    registerStringOption_("read_method", "<method>", "regular", "Method to read the file. 'all' benchmarks every method, it expects an (indexed) mzML file as input and converts it to cachedMzML, sqMass and mzXML first.", false);
+    String method("regular,indexed,indexed_parallel,streaming,cached,cached_parallel,sqmass,mzxml,all");
     setValidStrings_("read_method", ListUtils::create<String>(method));
 
     registerStringOption_("loadData", "<method>", "true", "Whether to actually load and decode the binary data (or whether to skip decoding the binary data)", false);
     String loadData("true,false");
     setValidStrings_("loadData", ListUtils::create<String>(loadData));
+
+    registerOutputFile_("out", "<file>", "", "Optional benchmark report (one line per read method and number of threads: throughput, random access latency and memory consumption)", false);
+    setValidFormats_("out", ListUtils::create<String>("tsv"));
+    registerIntList_("benchmark_threads", "<threads>", IntList(), "Numbers of threads to run each read method with (default: the value of 'threads')", false, true);
+    registerIntOption_("random_access", "<num>", 100, "Number of randomly chosen spectra that are read one by one to measure the access latency (only for the random access methods: indexed, cached and sqmass)", false, true);
+    setMinInt_("random_access", 0);
   }
 
-  ExitCodes main_(int, const char**) override
+  /// size of a file in bytes
+  static Size fileSize_(const String& filename)
   {
-    //-------------------------------------------------------------
-    // parameter handling
-    //-------------------------------------------------------------
+    std::ifstream ifs(filename.c_str(), std::ios::binary | std::ios::ate);
+    return ifs ? (Size)ifs.tellg() : 0;
+  }
 
-    //input file names
-    String in = getStringOption_("in");
-    String read_method = getStringOption_("read_method");
-    bool load_data = getStringOption_("loadData") == "true";
+  /// checks the name of a cached file (ends in .cachedMzML)
+  bool checkCachedFile_(const String& in) const
+  {
+    std::vector<String> split_out;
+    in.split(".cachedMzML", split_out);
+    if (split_out.size() != 2)
+    {
+      LOG_ERROR << "Cannot deduce base path from input '" << in << 
+        "' (note that '.cachedMzML' should only occur once as the final ending)" << std::endl;
+      return false;
+    }
+    return true;
+  }
+
+  /// reads all spectra of @p in with @p read_method and computes the TIC
+  ExitCodes readFile_(const String& read_method, const String& in, bool load_data, TICBenchmarkResult& result)
+  {
+    double TIC = 0.0;
+    long int nr_peaks = 0;
+    Size nr_spectra = 0;
 
     if (read_method == "streaming")
     {
@@ -208,11 +275,9 @@ protected:
       mzml.setOptions(opt);
       mzml.transform(in, &consumer, true, true);
 
-      std::cout << "There are " << consumer.nr_spectra << " spectra and " << consumer.nr_peaks << " peaks in the input file." << std::endl;
-      std::cout << "The total ion current is " << consumer.TIC << std::endl;
-      size_t after;
-      SysInfo::getProcessMemoryConsumption(after);
-      std::cout << " Memory consumption after " << after << std::endl;
+      TIC = consumer.TIC;
+      nr_peaks = consumer.nr_peaks;
+      nr_spectra = consumer.nr_spectra;
     }
     else if (read_method == "regular")
     {
@@ -226,8 +291,6 @@ protected:
       mzml.setOptions(opt);
       PeakMap map;
       mzml.load(in, map);
-      double TIC = 0.0;
-      long int nr_peaks = 0;
       for (Size i =0; i < map.size(); i++)
       {
         nr_peaks += map[i].size();
@@ -236,12 +299,7 @@ protected:
           TIC += map[i][j].getIntensity();
         }
       }
-
-      std::cout << "There are " << map.size() << " spectra and " << nr_peaks << " peaks in the input file." << std::endl;
-      std::cout << "The total ion current is " << TIC << std::endl;
-      size_t after;
-      SysInfo::getProcessMemoryConsumption(after);
-      std::cout << " Memory consumption after " << after << std::endl;
+      nr_spectra = map.size();
     }
     else if (read_method == "indexed")
     {
@@ -251,8 +309,6 @@ protected:
       // load data from an indexed MzML file
       OnDiscPeakMap map;
       imzml.load(in, map);
-      double TIC = 0.0;
-      long int nr_peaks = 0;
       if (load_data)
       {
         for (Size i =0; i < map.getNrSpectra(); i++)
@@ -263,12 +319,7 @@ protected:
           TIC += std::accumulate(sptr->getIntensityArray()->data.begin(), sptr->getIntensityArray()->data.end(), 0.0);
         }
       }
-
-      std::cout << "There are " << map.getNrSpectra() << " spectra and " << nr_peaks << " peaks in the input file." << std::endl;
-      std::cout << "The total ion current is " << TIC << std::endl;
-      size_t after;
-      SysInfo::getProcessMemoryConsumption(after);
-      std::cout << " Memory consumption after " << after << std::endl;
+      nr_spectra = map.getNrSpectra();
     }
     else if (read_method == "indexed_parallel")
     {
@@ -284,9 +335,6 @@ protected:
       map.openFile(in, true);
       map.setSkipXMLChecks(true);
 
-      double TIC = 0.0;
-      long int nr_peaks = 0;
-
       if (load_data)
       {
 
@@ -310,12 +358,7 @@ protected:
         }
 
       }
-
-      std::cout << "There are " << map.getNrSpectra() << " spectra and " << nr_peaks << " peaks in the input file." << std::endl;
-      std::cout << "The total ion current is " << TIC << std::endl;
-      size_t after;
-      SysInfo::getProcessMemoryConsumption(after);
-      std::cout << " Memory consumption after " << after << std::endl;
+      nr_spectra = map.getNrSpectra();
     }
     else if (read_method == "cached")
     {
@@ -323,18 +366,7 @@ protected:
 
       // Special handling of cached mzML as input types: 
       // we expect two paired input files which we should read into exp
-      std::vector<String> split_out;
-      in.split(".cachedMzML", split_out);
-      if (split_out.size() != 2)
-      {
-        LOG_ERROR << "Cannot deduce base path from input '" << in << 
-          "' (note that '.cachedMzML' should only occur once as the final ending)" << std::endl;
-        return ILLEGAL_PARAMETERS;
-      }
-      String in_meta = split_out[0] + ".mzML";
-
-      MzMLFile f;
-      f.setLogType(log_type_);
+      if (!checkCachedFile_(in)) return ILLEGAL_PARAMETERS;
 
       Internal::CachedMzMLHandler cache;
       cache.createMemdumpIndex(in);
@@ -343,8 +375,6 @@ protected:
       std::ifstream ifs_;
       ifs_.open(in.c_str(), std::ios::binary);
 
-      double TIC = 0.0;
-      long int nr_peaks = 0;
       for (Size i=0; i < spectra_index.size(); ++i)
       {
 
@@ -361,12 +391,7 @@ protected:
           TIC += intensity_array->data[j];
         }
       }
-
-      std::cout << "There are " << spectra_index.size() << " spectra and " << nr_peaks << " peaks in the input file." << std::endl;
-      std::cout << "The total ion current is " << TIC << std::endl;
-      size_t after;
-      SysInfo::getProcessMemoryConsumption(after);
-      std::cout << " Memory consumption after " << after << std::endl;
+      nr_spectra = spectra_index.size();
     }
     else if (read_method == "cached_parallel")
     {
@@ -374,18 +399,7 @@ protected:
 
       // Special handling of cached mzML as input types: 
       // we expect two paired input files which we should read into exp
-      std::vector<String> split_out;
-      in.split(".cachedMzML", split_out);
-      if (split_out.size() != 2)
-      {
-        LOG_ERROR << "Cannot deduce base path from input '" << in << 
-          "' (note that '.cachedMzML' should only occur once as the final ending)" << std::endl;
-        return ILLEGAL_PARAMETERS;
-      }
-      String in_meta = split_out[0] + ".mzML";
-
-      MzMLFile f;
-      f.setLogType(log_type_);
+      if (!checkCachedFile_(in)) return ILLEGAL_PARAMETERS;
 
       Internal::CachedMzMLHandler cache;
       cache.createMemdumpIndex(in);
@@ -393,8 +407,6 @@ protected:
 
       FileAbstraction filestream(in);
 
-      double TIC = 0.0;
-      long int nr_peaks = 0;
 #ifdef _OPENMP
 #pragma omp parallel for firstprivate(filestream) 
 #endif
@@ -418,12 +430,310 @@ protected:
           nr_peaks += nr_peaks_l;
         }
       }
+      nr_spectra = spectra_index.size();
+    }
+    else if (read_method == "sqmass")
+    {
+      std::cout << "Read method: sqMass" << std::endl;
+
+      TICConsumer consumer;
+      SqMassFile sqmass;
+      sqmass.transform(in, &consumer, true, true);
+
+      TIC = consumer.TIC;
+      nr_peaks = consumer.nr_peaks;
+      nr_spectra = consumer.nr_spectra;
+    }
+    else if (read_method == "mzxml")
+    {
+      std::cout << "Read method: mzXML" << std::endl;
+
+      TICConsumer consumer;
+      MzXMLFile mzxml;
+      mzxml.setLogType(log_type_);
+      PeakFileOptions opt = mzxml.getOptions();
+      opt.setFillData(load_data); // whether to actually load any data
+      mzxml.setOptions(opt);
+      mzxml.transform(in, &consumer, true);
+
+      TIC = consumer.TIC;
+      nr_peaks = consumer.nr_peaks;
+      nr_spectra = consumer.nr_spectra;
+    }
+
+    std::cout << "There are " << nr_spectra << " spectra and " << nr_peaks << " peaks in the input file." << std::endl;
+    std::cout << "The total ion current is " << TIC << std::endl;
+    size_t after;
+    SysInfo::getProcessMemoryConsumption(after);
+    std::cout << " Memory consumption after " << after << std::endl;
+
+    result.TIC = TIC;
+    result.nr_peaks = nr_peaks;
+    result.nr_spectra = nr_spectra;
+    return EXECUTION_OK;
+  }
+
+  /**
+    @brief Reads @p count randomly chosen single spectra and records the wall time of each access
+
+    Only for the random access methods (indexed, cached, sqmass), the
+    indices are drawn with a fixed seed, thus all methods and runs access the
+    same spectra.
+  */
+  void randomAccess_(const String& read_method, const String& in, Size nr_spectra, Size count, std::vector<double>& latencies)
+  {
+    latencies.clear();
+    if (nr_spectra == 0 || count == 0) return;
+
+    boost::mt19937 generator(42);
+    std::vector<int> indices;
+    for (Size i = 0; i < count; ++i)
+    {
+      indices.push_back(generator() % nr_spectra);
+    }
+
+    StopWatch sw;
+    if (read_method == "indexed" || read_method == "indexed_parallel")
+    {
+      OnDiscPeakMap map;
+      map.openFile(in, true);
+      map.setSkipXMLChecks(true);
+      for (int idx : indices)
+      {
+        sw.reset();
+        sw.start();
+        OpenMS::Interfaces::SpectrumPtr sptr = map.getSpectrumById(idx);
+        sw.stop();
+        latencies.push_back(sw.getClockTime());
+      }
+    }
+    else if (read_method == "cached" || read_method == "cached_parallel")
+    {
+      Internal::CachedMzMLHandler cache;
+      cache.createMemdumpIndex(in);
+      const std::vector<std::streampos> spectra_index = cache.getSpectraIndex();
+      std::ifstream ifs(in.c_str(), std::ios::binary);
+      for (int idx : indices)
+      {
+        sw.reset();
+        sw.start();
+        BinaryDataArrayPtr mz_array(new BinaryDataArray);
+        BinaryDataArrayPtr intensity_array(new BinaryDataArray);
+        int ms_level = -1;
+        double rt = -1.0;
+        ifs.seekg(spectra_index[idx]);
+        Internal::CachedMzMLHandler::readSpectrumFast(mz_array, intensity_array, ifs, ms_level, rt);
+        sw.stop();
+        latencies.push_back(sw.getClockTime());
+      }
+    }
+    else if (read_method == "sqmass")
+    {
+      Internal::MzMLSqliteHandler handler(in);
+      for (int idx : indices)
+      {
+        sw.reset();
+        sw.start();
+        std::vector<MSSpectrum> spectra;
+        handler.readSpectra(spectra, std::vector<int>(1, idx));
+        sw.stop();
+        latencies.push_back(sw.getClockTime());
+      }
+    }
+  }
+
+  /// header line of the benchmark report
+  static String reportHeader_()
+  {
+    return "method\tthreads\tspectra\tpeaks\tTIC\tfile_bytes\tseconds\tMB_per_second\tspectra_per_second\tbytes_read\tmemory_KB\tpeak_memory_KB"
+           "\trandom_accesses\tlatency_mean_ms\tlatency_median_ms\tlatency_max_ms";
+  }
+
+  /**
+    @brief runs each read method on its file in a separate process of this tool (one per number of threads)
+
+    The report lines of the child processes are returned in @p report_lines.
+  */
+  ExitCodes runChildProcesses_(const std::vector<std::pair<String, String> >& runs, const IntList& benchmark_threads, bool load_data,
+                               Size random_access, const String& tmp_base, std::vector<String>& report_lines) const
+  {
+    const QString executable = (File::getExecutablePath() + "TICCalculator").toQString();
+    for (Int t : benchmark_threads)
+    {
+      for (Size r = 0; r < runs.size(); ++r)
+      {
+        const String child_report = tmp_base + "_" + runs[r].first + "_" + String(t) + ".tsv";
+        QStringList arguments;
+        arguments << "-in" << runs[r].second.toQString()
+                  << "-read_method" << runs[r].first.toQString()
+                  << "-loadData" << (load_data ? "true" : "false")
+                  << "-random_access" << String(random_access).toQString()
+                  << "-benchmark_threads" << String(t).toQString()
+                  << "-out" << child_report.toQString();
+        ExitCodes ret = runExternalProcess_(executable, arguments);
+        if (ret != EXECUTION_OK)
+        {
+          File::remove(child_report);
+          return ret;
+        }
+
+        TextFile report(child_report);
+        for (TextFile::ConstIterator it = report.begin(); it != report.end(); ++it)
+        {
+          if (it == report.begin() || it->empty()) continue; // skip the header
+          report_lines.push_back(*it);
+          std::cout << *it << std::endl;
+        }
+        File::remove(child_report);
+      }
+    }
+    return EXECUTION_OK;
+  }
+
+  /// writes the benchmark report (tab-separated, one line per run)
+  void writeReport_(const String& out, const std::vector<TICBenchmarkResult>& results) const
+  {
+    std::ofstream os(out.c_str());
+    if (!os)
+    {
+      throw Exception::UnableToCreateFile(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, out);
+    }
+    os.precision(writtenDigits(double()));
+    os << reportHeader_() << "\n";
+    for (const TICBenchmarkResult& r : results)
+    {
+      const double mb_per_s = r.seconds > 0 ? r.file_size / r.seconds / 1e6 : 0.0;
+      const double spectra_per_s = r.seconds > 0 ? r.nr_spectra / r.seconds : 0.0;
+      os << r.method << "\t" << r.threads << "\t" << r.nr_spectra << "\t" << r.nr_peaks << "\t" << r.TIC << "\t"
+         << r.file_size << "\t" << r.seconds << "\t" << mb_per_s << "\t" << spectra_per_s << "\t"
+         << r.bytes_read << "\t" << r.memory << "\t" << r.peak_memory << "\t" << r.latencies.size();
+      if (r.latencies.empty())
+      {
+        os << "\tNA\tNA\tNA\n";
+      }
+      else
+      {
+        std::vector<double> sorted(r.latencies);
+        std::sort(sorted.begin(), sorted.end());
+        const double mean = std::accumulate(sorted.begin(), sorted.end(), 0.0) / sorted.size();
+        os << "\t" << mean * 1e3 << "\t" << Math::median(sorted.begin(), sorted.end(), true) * 1e3 << "\t" << sorted.back() * 1e3 << "\n";
+      }
+    }
+  }
+
+  ExitCodes main_(int, const char**) override
+  {
+    //-------------------------------------------------------------
+    // parameter handling
+    //-------------------------------------------------------------
+
+    //input file names
+    String in = getStringOption_("in");
+    String read_method = getStringOption_("read_method");
+    bool load_data = getStringOption_("loadData") == "true";
+    String out = getStringOption_("out");
+    IntList benchmark_threads = getIntList_("benchmark_threads");
+    Size random_access = getIntOption_("random_access");
+
+    const Int threads = ExecutionResources::getThreads();
+    if (benchmark_threads.empty())
+    {
+      benchmark_threads.push_back(threads);
+    }
+
+    // the read methods and the file each of them reads
+    std::vector<std::pair<String, String> > runs;
+    std::vector<String> tmp_files;
+    const String tmp_base = File::getTempDirectory() + "/" + File::getUniqueName();
+    if (read_method == "all")
+    {
+      // convert the input to the other formats
+      MzMLFile mzml;
+      mzml.setLogType(log_type_);
+      PeakMap map;
+      mzml.load(in, map);
+
+      const String cached_file = tmp_base + ".cachedMzML";
+      const String sqmass_file = tmp_base + ".sqMass";
+      const String mzxml_file = tmp_base + ".mzXML";
+      Internal::CachedMzMLHandler().writeMemdump(map, cached_file);
+      SqMassFile().store(sqmass_file, map);
+      MzXMLFile().store(mzxml_file, map);
+      tmp_files.push_back(cached_file);
+      tmp_files.push_back(sqmass_file);
+      tmp_files.push_back(mzxml_file);
+
+      runs.push_back(std::make_pair(String("regular"), in));
+      runs.push_back(std::make_pair(String("streaming"), in));
+      runs.push_back(std::make_pair(String("indexed"), in));
+      runs.push_back(std::make_pair(String("indexed_parallel"), in));
+      runs.push_back(std::make_pair(String("cached"), cached_file));
+      runs.push_back(std::make_pair(String("cached_parallel"), cached_file));
+      runs.push_back(std::make_pair(String("sqmass"), sqmass_file));
+      runs.push_back(std::make_pair(String("mzxml"), mzxml_file));
+    }
+    else
+    {
+      runs.push_back(std::make_pair(read_method, in));
+    }
+
+    if (runs.size() * benchmark_threads.size() > 1)
+    {
+      // the process counters (in particular the peak memory) would include
+      // the conversion and all previous runs, thus each run gets its own process
+      std::vector<String> report_lines;
+      ExitCodes ret = runChildProcesses_(runs, benchmark_threads, load_data, random_access, tmp_base, report_lines);
+      for (const String& tmp_file : tmp_files)
+      {
+        File::remove(tmp_file);
+      }
+      if (ret != EXECUTION_OK) return ret;
+
+      if (!out.empty())
+      {
+        std::ofstream os(out.c_str());
+        if (!os)
+        {
+          throw Exception::UnableToCreateFile(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, out);
+        }
+        os << reportHeader_() << "\n";
+        for (const String& line : report_lines)
+        {
+          os << line << "\n";
+        }
+      }
+      return EXECUTION_OK;
+    }
 
-      std::cout << "There are " << spectra_index.size() << " spectra and " << nr_peaks << " peaks in the input file." << std::endl;
-      std::cout << "The total ion current is " << TIC << std::endl;
-      size_t after;
-      SysInfo::getProcessMemoryConsumption(after);
-      std::cout << " Memory consumption after " << after << std::endl;
+    // a single run in this process
+    ExecutionResources::setThreads(benchmark_threads[0]);
+    TICBenchmarkResult result;
+    result.method = read_method;
+    result.threads = ExecutionResources::getThreads();
+    result.file_size = fileSize_(in);
+
+    size_t bytes_read_before, bytes_written;
+    SysInfo::getProcessIOCounters(bytes_read_before, bytes_written);
+    StopWatch sw;
+    sw.start();
+    ExitCodes ret = readFile_(read_method, in, load_data, result);
+    sw.stop();
+    result.seconds = sw.getClockTime();
+    size_t bytes_read_after;
+    SysInfo::getProcessIOCounters(bytes_read_after, bytes_written);
+    result.bytes_read = bytes_read_after - bytes_read_before;
+
+    randomAccess_(read_method, in, result.nr_spectra, random_access, result.latencies);
+
+    SysInfo::getProcessMemoryConsumption(result.memory);
+    SysInfo::getProcessPeakMemoryConsumption(result.peak_memory);
+    ExecutionResources::setThreads(threads);
+
+    if (ret != EXECUTION_OK) return ret;
+
+    if (!out.empty())
+    {
+      writeReport_(out, std::vector<TICBenchmarkResult>(1, result));
     }
 
     return EXECUTION_OK;
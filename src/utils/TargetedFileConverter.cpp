@@ -152,6 +152,15 @@ protected:
     //--------------------------------------------------------------------------- 
     // Start Conversion
     //--------------------------------------------------------------------------- 
+    if (in_type == FileTypes::TRAML && out_type == FileTypes::TSV)
+    {
+      // stream the transitions, only proteins and compounds are kept in memory
+      TransitionTSVFile tsv_writer = TransitionTSVFile();
+      tsv_writer.setLogType(log_type_);
+      tsv_writer.convertTraMLToTSV(in, out.c_str());
+      return EXECUTION_OK;
+    }
+
     TargetedExperiment targeted_exp;
     if (in_type == FileTypes::TSV || in_type == FileTypes::MRM)
     {
@@ -40,6 +40,7 @@ NovorAdapter
 OpenMSInfo
 OpenPepXL
 OpenPepXLLF
+PeptideDatabaseBuilder
 PeakPickerIterative
 PSMFeatureExtractor
 QCCalculator